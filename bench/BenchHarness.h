@@ -0,0 +1,917 @@
+/**
+ * @file BenchHarness.h
+ * @brief Headless render benchmark shared by every synth_bench executable
+ *
+ * Each plugins/synths engine gets its own small executable (the engines
+ * all use the same class names in the global namespace, so they can't be
+ * linked into one binary). The executable only says how to start sound;
+ * this header sweeps voice counts, block sizes and sample rates, times
+ * every renderBlock() call and writes one JSON report.
+ *
+ * Timing follows sst-basic-blocks' tests/perf/perfutils.h: wall clock
+ * around the render, reported against the audio time rendered.
+ *
+ * --latency switches to the worst-case mode instead (bench/wasm/wasm_bench.mjs
+ * runs the same scenarios against the web builds): dropouts come from
+ * the slowest blocks (steals, filter blowups, release tails), not the
+ * average, so it runs scripted scenarios at full polyphony, keeps every
+ * block's time and reports p50 / p99 / p99.9 / max against the block's
+ * real-time budget, per buffer size.
+ *
+ * --scaling sweeps sample rate against block size at full polyphony and
+ * writes the CPU load as a rates x blocks matrix: buffers sized by the
+ * rate and per-sample coefficient math show up down the rows, per-block
+ * overhead (control-rate updates, effect chunking) across the columns.
+ *
+ * --startup times what a session load pays per instance instead: the
+ * constructor, prepare(), and the wait from the first note to the first
+ * audible block, for the first instance in the process (which builds the
+ * shared tables) and for the ones after it.
+ *
+ * Usage: synth_bench_<Plugin> [--out DIR] [--seconds S] [--quick] [--voice-threads N]
+ *                             [--latency | --scaling | --startup [--repeats N]]
+ *                             [--block N]... [--rate SR]...
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define SYNTH_BENCH_HAS_MXCSR 1
+#endif
+
+namespace bench
+{
+
+/** One point in the sweep */
+struct Config
+{
+    int voices = 1;
+    int blockSize = 128;
+    double sampleRate = 48000.0;
+};
+
+/** Timing for one Config */
+struct Result
+{
+    Config config;
+    double nsPerSample = 0.0;     // Wall time per rendered stereo frame
+    double realtimeFactor = 0.0;  // Audio seconds rendered per wall second
+    double meanBlockUs = 0.0;
+    double worstBlockUs = 0.0;
+    double blockBudgetUs = 0.0;   // Real-time deadline for one block
+    float peak = 0.0f;            // Sanity check that the engine made sound
+    long nonFinite = 0;           // NaN/inf samples - timings are suspect if > 0
+};
+
+struct Options
+{
+    double seconds = 2.0;  // Audio rendered per Config (after warm-up), or per scenario with --latency
+    int voiceThreads = 1;  // setRenderThreads() for engines that have it
+    bool latency = false;  // Worst-case scenarios instead of the throughput sweep
+    bool scaling = false;  // Rate x block matrix at full polyphony instead of the sweep
+    bool startup = false;  // Construct / prepare / first audio times instead of the sweep
+    int repeats = 20;      // Instances timed with --startup
+    std::string outDir = "bench";
+    std::vector<int> voiceCounts{1, 4, 8, 16};
+    std::vector<int> blockSizes{32, 128, 512};
+    std::vector<double> sampleRates{44100.0, 48000.0, 96000.0};
+};
+
+inline Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    bool quick = false, seconds = false, blocks = false, rates = false, repeats = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            options.outDir = argv[++i];
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            options.seconds = std::max(0.05, std::atof(argv[++i]));
+            seconds = true;
+        }
+        else if (std::strcmp(argv[i], "--voice-threads") == 0 && i + 1 < argc)
+            options.voiceThreads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--block") == 0 && i + 1 < argc)
+        {
+            if (!blocks)
+                options.blockSizes.clear();
+            options.blockSizes.push_back(std::max(1, std::atoi(argv[++i])));
+            blocks = true;
+        }
+        else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+        {
+            if (!rates)
+                options.sampleRates.clear();
+            options.sampleRates.push_back(std::max(8000.0, std::atof(argv[++i])));
+            rates = true;
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0)
+            options.latency = true;
+        else if (std::strcmp(argv[i], "--scaling") == 0)
+            options.scaling = true;
+        else if (std::strcmp(argv[i], "--startup") == 0)
+            options.startup = true;
+        else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+        {
+            options.repeats = std::max(2, std::atoi(argv[++i]));
+            repeats = true;
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    // Defaults the flags above didn't override. p99.9 needs thousands of
+    // blocks, hence the longer runs for --latency; --scaling has 40 cells.
+    if (options.latency)
+        options.scaling = false;
+    if (options.latency || options.scaling)
+        options.startup = false;
+    if (options.startup && quick && !repeats)
+        options.repeats = 5;
+    if (!seconds)
+        options.seconds = quick ? 0.25 : (options.latency ? 20.0 : options.scaling ? 1.0 : 2.0);
+    if (!blocks)
+    {
+        if (options.scaling)
+            options.blockSizes = quick ? std::vector<int>{32, 512} : std::vector<int>{16, 32, 64, 128, 256, 512, 1024, 2048};
+        else
+            options.blockSizes = quick || options.startup ? std::vector<int>{128}
+                               : options.latency ? std::vector<int>{32, 64, 128, 256, 512} : options.blockSizes;
+    }
+    if (!rates)
+    {
+        if (options.scaling)
+            options.sampleRates = quick ? std::vector<double>{48000.0, 96000.0}
+                                        : std::vector<double>{44100.0, 48000.0, 88200.0, 96000.0, 192000.0};
+        else if (quick || options.latency || options.startup)
+            options.sampleRates = {48000.0};
+    }
+    return options;
+}
+
+/**
+ * @brief Flush denormals to zero, as the plugin hosts do
+ *
+ * The processors rely on juce::ScopedNoDenormals; without it decaying
+ * tails would benchmark the FPU's denormal path instead of the DSP.
+ */
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals()
+    {
+#ifdef SYNTH_BENCH_HAS_MXCSR
+        saved = _mm_getcsr();
+        _mm_setcsr(saved | 0x8040);  // FTZ | DAZ
+#endif
+    }
+
+    ~ScopedFlushDenormals()
+    {
+#ifdef SYNTH_BENCH_HAS_MXCSR
+        _mm_setcsr(saved);
+#endif
+    }
+
+private:
+#ifdef SYNTH_BENCH_HAS_MXCSR
+    unsigned int saved = 0;
+#endif
+};
+
+/**
+ * @brief Hold a chord of `voices` notes, spread over a few octaves
+ *
+ * Works for any engine with noteOn(note, velocity).
+ */
+inline int chordNote(int voice, int lowestNote)
+{
+    static constexpr int intervals[] = {0, 7, 12, 16, 19, 24, 28, 31};
+    return std::min(lowestNote + intervals[voice % 8] + 36 * (voice / 8), 120);
+}
+
+template <typename Engine>
+void playChord(Engine& engine, int voices, int lowestNote = 36)
+{
+    for (int v = 0; v < voices; ++v)
+        engine.noteOn(chordNote(v, lowestNote), 0.8f);
+}
+
+/** Release what playChord(engine, voices, lowestNote) played */
+template <typename Engine>
+void releaseChord(Engine& engine, int voices, int lowestNote = 36)
+{
+    for (int v = 0; v < voices; ++v)
+        engine.noteOff(chordNote(v, lowestNote));
+}
+
+/**
+ * @brief Set the engine's filter, whatever its setters are called
+ * @return False if the engine has no cutoff / resonance setters
+ */
+template <typename Engine>
+bool setFilter(Engine& engine, float cutoffHz, float resonance)
+{
+    if constexpr (requires { engine.setFilterCutoff(1.0f); engine.setFilterResonance(1.0f); })
+    {
+        engine.setFilterCutoff(cutoffHz);
+        engine.setFilterResonance(resonance);
+        return true;
+    }
+    else if constexpr (requires { engine.setFilterCutoff(1.0f); engine.setFilterReso(1.0f); })
+    {
+        engine.setFilterCutoff(cutoffHz);
+        engine.setFilterReso(resonance);
+        return true;
+    }
+    else if constexpr (requires { engine.setVCFCutoff(1.0f); engine.setVCFResonance(1.0f); })
+    {
+        engine.setVCFCutoff(cutoffHz);
+        engine.setVCFResonance(resonance);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Time one Config
+ * @param start Called as start(engine, voices) at the top of the run and
+ *              again every half second, so decaying engines keep working
+ */
+template <typename Engine, typename StartFn>
+Result runConfig(const Config& config, const Options& options, StartFn& start)
+{
+    using Clock = std::chrono::steady_clock;
+    const double seconds = options.seconds;
+
+    auto engine = std::make_unique<Engine>();
+    engine->prepare(config.sampleRate, config.blockSize);
+    if constexpr (requires { engine->setRenderThreads(1); })
+        engine->setRenderThreads(options.voiceThreads);
+
+    std::vector<float> left(static_cast<size_t>(config.blockSize));
+    std::vector<float> right(static_cast<size_t>(config.blockSize));
+
+    const int retrigger = static_cast<int>(config.sampleRate * 0.5);
+    const int warmupBlocks = std::max(1, static_cast<int>(config.sampleRate * 0.1) / config.blockSize);
+    const int timedBlocks = std::max(1, static_cast<int>(config.sampleRate * seconds) / config.blockSize);
+
+    Result result;
+    result.config = config;
+    result.blockBudgetUs = 1.0e6 * config.blockSize / config.sampleRate;
+
+    start(*engine, config.voices);
+    int sinceTrigger = 0;
+    double totalNs = 0.0;
+    double worstNs = 0.0;
+
+    for (int b = 0; b < warmupBlocks + timedBlocks; ++b)
+    {
+        if (sinceTrigger >= retrigger)
+        {
+            start(*engine, config.voices);
+            sinceTrigger = 0;
+        }
+
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+
+        auto t0 = Clock::now();
+        engine->renderBlock(left.data(), right.data(), config.blockSize);
+        auto t1 = Clock::now();
+
+        sinceTrigger += config.blockSize;
+        if (b < warmupBlocks)
+            continue;
+
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        totalNs += ns;
+        worstNs = std::max(worstNs, ns);
+
+        for (int i = 0; i < config.blockSize; ++i)
+        {
+            const float l = left[static_cast<size_t>(i)];
+            const float r = right[static_cast<size_t>(i)];
+
+            if (!std::isfinite(l) || !std::isfinite(r))
+                ++result.nonFinite;
+            else
+                result.peak = std::max(result.peak, std::max(std::abs(l), std::abs(r)));
+        }
+    }
+
+    const double frames = static_cast<double>(timedBlocks) * config.blockSize;
+    result.nsPerSample = totalNs / frames;
+    result.realtimeFactor = totalNs > 0.0 ? (frames / config.sampleRate) / (totalNs * 1.0e-9) : 0.0;
+    result.meanBlockUs = totalNs / timedBlocks * 1.0e-3;
+    result.worstBlockUs = worstNs * 1.0e-3;
+    return result;
+}
+
+inline void writeJson(const std::string& path, const std::string& name, int maxVoices,
+                      const Options& options, const std::vector<Result>& results)
+{
+    std::ofstream out(path);
+    char line[512];
+
+    out << "{\n";
+    out << "  \"engine\": \"" << name << "\",\n";
+    out << "  \"maxVoices\": " << maxVoices << ",\n";
+    out << "  \"secondsPerConfig\": " << options.seconds << ",\n";
+    out << "  \"voiceThreads\": " << options.voiceThreads << ",\n";
+    out << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "    {\"voices\": %d, \"blockSize\": %d, \"sampleRate\": %.0f, "
+                      "\"nsPerSample\": %.2f, \"realtimeFactor\": %.2f, \"meanBlockUs\": %.3f, "
+                      "\"worstBlockUs\": %.3f, \"blockBudgetUs\": %.3f, \"peak\": %.4f, \"nonFinite\": %ld}%s\n",
+                      r.config.voices, r.config.blockSize, r.config.sampleRate, r.nsPerSample,
+                      r.realtimeFactor, r.meanBlockUs, r.worstBlockUs, r.blockBudgetUs,
+                      static_cast<double>(r.peak), r.nonFinite, i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+
+    out << "  ]\n}\n";
+}
+
+//==============================================================================
+// Worst-case latency (--latency)
+//==============================================================================
+
+/** Scripted load for the latency mode */
+enum class Scenario
+{
+    Playing,         // The adapter's start() every half second: held chords, or sequencer steps
+    ChordStabs,      // Full-polyphony chords 8 times a second, each stealing the last's releases
+    ResonanceSweep,  // Held chord under a 40 Hz - 18 kHz cutoff sweep at high resonance
+    ReleaseTails     // A short chord every two seconds, then its release tails to silence
+};
+
+inline const char* getScenarioName(Scenario scenario)
+{
+    switch (scenario)
+    {
+        case Scenario::Playing: return "playing";
+        case Scenario::ChordStabs: return "chordStabs";
+        case Scenario::ResonanceSweep: return "resonanceSweep";
+        case Scenario::ReleaseTails: return "releaseTails";
+    }
+    return "";
+}
+
+/** Block-time distribution for one scenario at one block size */
+struct LatencyResult
+{
+    Scenario scenario = Scenario::Playing;
+    int blockSize = 128;
+    double sampleRate = 48000.0;
+    long blocks = 0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+    double blockBudgetUs = 0.0;
+    long overBudget = 0;  // Blocks that would have dropped out
+    long nonFinite = 0;
+};
+
+/** The q-quantile (0-1) of sorted times, nearest rank */
+inline double percentile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    const auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+/**
+ * @brief Time every block of one scenario
+ *
+ * Events land at block starts, where the processor would apply them.
+ * Returns blocks == 0 if the scenario doesn't apply (a sweep without a filter).
+ */
+template <typename Engine, typename StartFn>
+LatencyResult runScenario(Scenario scenario, int blockSize, double sampleRate, int maxVoices,
+                          const Options& options, StartFn& start)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto engine = std::make_unique<Engine>();
+    engine->prepare(sampleRate, blockSize);
+    if constexpr (requires { engine->setRenderThreads(1); })
+        engine->setRenderThreads(options.voiceThreads);
+
+    LatencyResult result;
+    result.scenario = scenario;
+    result.blockSize = blockSize;
+    result.sampleRate = sampleRate;
+    result.blockBudgetUs = 1.0e6 * blockSize / sampleRate;
+
+    // Engines played only by their own clock (Subharmonicon) have no notes to stab or release
+    constexpr bool hasNotes = requires(Engine& e) { e.noteOn(60, 0.8f); e.noteOff(60); };
+    const bool usesNotes = scenario == Scenario::ChordStabs || scenario == Scenario::ReleaseTails;
+
+    if ((usesNotes && !hasNotes) || (scenario == Scenario::ResonanceSweep && !setFilter(*engine, 1000.0f, 0.95f)))
+        return result;
+
+    std::vector<float> left(static_cast<size_t>(blockSize));
+    std::vector<float> right(static_cast<size_t>(blockSize));
+
+    const auto samples = [&](double seconds) { return std::max<long>(1, std::lround(sampleRate * seconds)); };
+    const long retrigger = samples(0.5);
+    const long stab = samples(0.125);
+    const long tailPeriod = samples(2.0);
+    const long tailNoteLength = samples(0.1);
+    const long sweepPeriod = samples(2.0);
+
+    // Did the sample position 'at' fall inside this block (period-wise)?
+    long pos = 0;
+    const auto crosses = [&](long period, long at = 0) {
+        const long phase = pos % period;
+        return phase <= at && at < phase + blockSize;
+    };
+
+    const int warmupBlocks = std::max(1, static_cast<int>(sampleRate * 0.1) / blockSize);
+    const int timedBlocks = std::max(1, static_cast<int>(sampleRate * options.seconds) / blockSize);
+    std::vector<double> times;
+    times.reserve(static_cast<size_t>(timedBlocks));
+    int stabs = 0;
+
+    for (int b = 0; b < warmupBlocks + timedBlocks; ++b, pos += blockSize)
+    {
+        // Events first, inside the timing: the processor does them in the block too
+        auto t0 = Clock::now();
+        switch (scenario)
+        {
+            case Scenario::Playing:
+                if (crosses(retrigger))
+                    start(*engine, maxVoices);
+                break;
+
+            case Scenario::ChordStabs:
+                if constexpr (hasNotes)
+                {
+                    if (crosses(stab))
+                    {
+                        // Alternate roots, so the new chord steals voices still releasing
+                        if (stabs > 0)
+                            releaseChord(*engine, maxVoices, (stabs - 1) % 2 == 0 ? 36 : 41);
+                        playChord(*engine, maxVoices, stabs % 2 == 0 ? 36 : 41);
+                        ++stabs;
+                    }
+                }
+                break;
+
+            case Scenario::ResonanceSweep:
+            {
+                if (crosses(retrigger))
+                    start(*engine, maxVoices);
+                const double phase = static_cast<double>(pos % sweepPeriod) / static_cast<double>(sweepPeriod);
+                const double triangle = phase < 0.5 ? 2.0 * phase : 2.0 - 2.0 * phase;
+                setFilter(*engine, static_cast<float>(40.0 * std::pow(450.0, triangle)), 0.95f);
+                break;
+            }
+
+            case Scenario::ReleaseTails:
+                if constexpr (hasNotes)
+                {
+                    if (crosses(tailPeriod))
+                        playChord(*engine, maxVoices);
+                    if (crosses(tailPeriod, tailNoteLength))
+                        releaseChord(*engine, maxVoices);
+                }
+                break;
+        }
+
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        engine->renderBlock(left.data(), right.data(), blockSize);
+        auto t1 = Clock::now();
+
+        if (b < warmupBlocks)
+            continue;
+
+        times.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()) * 1.0e-3);
+        for (int i = 0; i < blockSize; ++i)
+            if (!std::isfinite(left[static_cast<size_t>(i)]) || !std::isfinite(right[static_cast<size_t>(i)]))
+                ++result.nonFinite;
+    }
+
+    std::sort(times.begin(), times.end());
+    result.blocks = static_cast<long>(times.size());
+    result.p50Us = percentile(times, 0.5);
+    result.p99Us = percentile(times, 0.99);
+    result.p999Us = percentile(times, 0.999);
+    result.maxUs = times.back();
+    result.overBudget = static_cast<long>(times.end() - std::upper_bound(times.begin(), times.end(), result.blockBudgetUs));
+    return result;
+}
+
+inline void writeLatencyJson(const std::string& path, const std::string& name, int maxVoices,
+                             const Options& options, const std::vector<LatencyResult>& results)
+{
+    std::ofstream out(path);
+    char line[512];
+
+    out << "{\n";
+    out << "  \"engine\": \"" << name << "\",\n";
+    out << "  \"maxVoices\": " << maxVoices << ",\n";
+    out << "  \"secondsPerScenario\": " << options.seconds << ",\n";
+    out << "  \"voiceThreads\": " << options.voiceThreads << ",\n";
+    out << "  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const LatencyResult& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "    {\"scenario\": \"%s\", \"blockSize\": %d, \"sampleRate\": %.0f, \"blocks\": %ld, "
+                      "\"p50Us\": %.3f, \"p99Us\": %.3f, \"p999Us\": %.3f, \"maxUs\": %.3f, "
+                      "\"blockBudgetUs\": %.3f, \"overBudget\": %ld, \"nonFinite\": %ld}%s\n",
+                      getScenarioName(r.scenario), r.blockSize, r.sampleRate, r.blocks, r.p50Us, r.p99Us,
+                      r.p999Us, r.maxUs, r.blockBudgetUs, r.overBudget, r.nonFinite,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+
+    out << "  ]\n}\n";
+}
+
+/** Every scenario at every block size, to <outDir>/<name>.latency.json */
+template <typename Engine, typename StartFn>
+int runLatency(const Options& options, const std::string& name, int maxVoices, StartFn& start)
+{
+    static constexpr Scenario scenarios[] = {Scenario::Playing, Scenario::ChordStabs,
+                                             Scenario::ResonanceSweep, Scenario::ReleaseTails};
+
+    std::vector<LatencyResult> results;
+    for (double sampleRate : options.sampleRates)
+    {
+        for (int blockSize : options.blockSizes)
+        {
+            for (Scenario scenario : scenarios)
+            {
+                LatencyResult r = runScenario<Engine>(scenario, blockSize, sampleRate, maxVoices, options, start);
+                if (r.blocks == 0)
+                    continue;
+                results.push_back(r);
+
+                // Percentiles as a share of the budget: p99.9 near 100% drops out under load
+                std::printf("%-14s %-14s block=%4d sr=%6.0f  p50 %5.1f%%  p99 %5.1f%%  p99.9 %5.1f%%  max %6.1f%%  "
+                            "(budget %8.2f us, %ld over)\n",
+                            name.c_str(), getScenarioName(scenario), blockSize, sampleRate,
+                            100.0 * r.p50Us / r.blockBudgetUs, 100.0 * r.p99Us / r.blockBudgetUs,
+                            100.0 * r.p999Us / r.blockBudgetUs, 100.0 * r.maxUs / r.blockBudgetUs,
+                            r.blockBudgetUs, r.overBudget);
+                if (r.nonFinite > 0)
+                    std::printf("%-14s   warning: %ld non-finite samples\n", name.c_str(), r.nonFinite);
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outDir, ec);
+    const std::string path = options.outDir + "/" + name + ".latency.json";
+    writeLatencyJson(path, name, maxVoices, options, results);
+    std::cout << "Wrote " << path << std::endl;
+
+    return 0;
+}
+
+//==============================================================================
+// Rate x block scaling (--scaling)
+//==============================================================================
+
+/** One row per sample rate, one column per block size, as a JSON array of arrays */
+inline void writeMatrix(std::ofstream& out, const char* key, const std::vector<Result>& results, size_t columns,
+                        double (*value)(const Result&), bool last = false)
+{
+    char cell[32];
+    out << "  \"" << key << "\": [\n";
+    for (size_t row = 0; row * columns < results.size(); ++row)
+    {
+        out << "    [";
+        for (size_t c = 0; c < columns; ++c)
+        {
+            std::snprintf(cell, sizeof(cell), "%s%.3f", c > 0 ? ", " : "", value(results[row * columns + c]));
+            out << cell;
+        }
+        out << ((row + 1) * columns < results.size() ? "],\n" : "]\n");
+    }
+    out << (last ? "  ]\n" : "  ],\n");
+}
+
+/** CPU load: wall time as a share of the audio time rendered */
+inline double cpuPercent(const Result& r)
+{
+    return r.realtimeFactor > 0.0 ? 100.0 / r.realtimeFactor : 0.0;
+}
+
+/** Every rate x block at full polyphony, to <outDir>/<name>.scaling.json */
+template <typename Engine, typename StartFn>
+int runScaling(const Options& options, const std::string& name, int maxVoices, StartFn& start)
+{
+    // Rows (rates) outer, columns (blocks) inner: the matrices index results this way
+    std::vector<Result> results;
+    for (double sampleRate : options.sampleRates)
+        for (int blockSize : options.blockSizes)
+            results.push_back(runConfig<Engine>({maxVoices, blockSize, sampleRate}, options, start));
+
+    std::printf("%-14s CPU %% at %d voices (rows: sample rate, columns: block size)\n         ", name.c_str(), maxVoices);
+    for (int blockSize : options.blockSizes)
+        std::printf(" %7d", blockSize);
+    std::printf("\n");
+    for (size_t row = 0; row < options.sampleRates.size(); ++row)
+    {
+        std::printf("%8.0f ", options.sampleRates[row]);
+        for (size_t c = 0; c < options.blockSizes.size(); ++c)
+            std::printf(" %7.2f", cpuPercent(results[row * options.blockSizes.size() + c]));
+        std::printf("\n");
+    }
+    for (const Result& r : results)
+        if (r.nonFinite > 0)
+            std::printf("%-14s   warning: %ld non-finite samples at block=%d sr=%.0f\n", name.c_str(), r.nonFinite,
+                        r.config.blockSize, r.config.sampleRate);
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outDir, ec);
+    const std::string path = options.outDir + "/" + name + ".scaling.json";
+    std::ofstream out(path);
+
+    out << "{\n";
+    out << "  \"engine\": \"" << name << "\",\n";
+    out << "  \"voices\": " << maxVoices << ",\n";
+    out << "  \"secondsPerConfig\": " << options.seconds << ",\n";
+    out << "  \"voiceThreads\": " << options.voiceThreads << ",\n";
+    out << "  \"sampleRates\": [";
+    for (size_t i = 0; i < options.sampleRates.size(); ++i)
+        out << (i > 0 ? ", " : "") << options.sampleRates[i];
+    out << "],\n  \"blockSizes\": [";
+    for (size_t i = 0; i < options.blockSizes.size(); ++i)
+        out << (i > 0 ? ", " : "") << options.blockSizes[i];
+    out << "],\n";
+
+    const size_t columns = options.blockSizes.size();
+    writeMatrix(out, "cpuPercent", results, columns, cpuPercent);
+    writeMatrix(out, "nsPerSample", results, columns, [](const Result& r) { return r.nsPerSample; });
+    writeMatrix(out, "worstBlockPercent", results, columns,
+                [](const Result& r) { return r.blockBudgetUs > 0.0 ? 100.0 * r.worstBlockUs / r.blockBudgetUs : 0.0; });
+    writeMatrix(out, "peak", results, columns, [](const Result& r) { return static_cast<double>(r.peak); }, true);
+    out << "}\n";
+    std::cout << "Wrote " << path << std::endl;
+
+    return 0;
+}
+
+//==============================================================================
+// Instantiation and first audio (--startup)
+//==============================================================================
+
+/** One instance from construction to its first audible block */
+struct StartupSample
+{
+    double constructUs = 0.0;
+    double prepareUs = 0.0;
+    double firstAudioUs = 0.0;  // Wall time from the first note to the end of the first audible block
+    long firstAudioFrames = -1; // Output frames before that block ended; -1 if it stayed silent
+};
+
+/** One phase over the instances: the first (cold) one, then the rest */
+struct StartupPhase
+{
+    double coldUs = 0.0;
+    double medianUs = 0.0;
+    double maxUs = 0.0;
+};
+
+/** Startup times for one block size and rate */
+struct StartupResult
+{
+    Config config;
+    int repeats = 0;
+    StartupPhase construct;
+    StartupPhase prepare;
+    StartupPhase firstAudio;
+    long firstAudioFrames = -1;  // Of the cold instance; the same for the others unless the engine is random
+};
+
+/**
+ * @brief Time one instance: construct, prepare, then start and render until audible
+ *
+ * Audible is a sample over -80 dBFS; the render gives up after two
+ * seconds of audio (firstAudioFrames stays -1).
+ */
+template <typename Engine, typename StartFn>
+StartupSample timeStartup(const Config& config, const Options& options, StartFn& start)
+{
+    using Clock = std::chrono::steady_clock;
+    auto us = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    };
+    static constexpr float AUDIBLE = 1.0e-4f;
+
+    StartupSample sample;
+    std::vector<float> left(static_cast<size_t>(config.blockSize));
+    std::vector<float> right(static_cast<size_t>(config.blockSize));
+
+    auto t0 = Clock::now();
+    auto engine = std::make_unique<Engine>();
+    auto t1 = Clock::now();
+    engine->prepare(config.sampleRate, config.blockSize);
+    if constexpr (requires { engine->setRenderThreads(1); })
+        engine->setRenderThreads(options.voiceThreads);
+    auto t2 = Clock::now();
+
+    start(*engine, config.voices);
+    const long limit = static_cast<long>(config.sampleRate * 2.0);
+    for (long frames = 0; frames < limit;)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        engine->renderBlock(left.data(), right.data(), config.blockSize);
+        frames += config.blockSize;
+
+        bool audible = false;
+        for (size_t i = 0; i < left.size() && !audible; ++i)
+            audible = std::abs(left[i]) > AUDIBLE || std::abs(right[i]) > AUDIBLE;
+        if (audible)
+        {
+            sample.firstAudioFrames = frames;
+            break;
+        }
+    }
+    auto t3 = Clock::now();
+
+    sample.constructUs = us(t0, t1);
+    sample.prepareUs = us(t1, t2);
+    sample.firstAudioUs = us(t2, t3);
+    return sample;
+}
+
+/** Cold, median and worst of one phase; samples[0] is the cold instance */
+template <typename Get>
+StartupPhase summarisePhase(const std::vector<StartupSample>& samples, Get get)
+{
+    StartupPhase phase;
+    phase.coldUs = get(samples.front());
+
+    std::vector<double> warm;
+    for (size_t i = 1; i < samples.size(); ++i)
+        warm.push_back(get(samples[i]));
+    std::sort(warm.begin(), warm.end());
+    if (!warm.empty())
+    {
+        phase.medianUs = warm[warm.size() / 2];
+        phase.maxUs = warm.back();
+    }
+    return phase;
+}
+
+/** Every instance is destroyed before the next is built, as when a host reloads a session */
+template <typename Engine, typename StartFn>
+StartupResult runStartup(const Config& config, const Options& options, StartFn& start)
+{
+    std::vector<StartupSample> samples;
+    for (int i = 0; i < options.repeats; ++i)
+        samples.push_back(timeStartup<Engine>(config, options, start));
+
+    StartupResult result;
+    result.config = config;
+    result.repeats = options.repeats;
+    result.construct = summarisePhase(samples, [](const StartupSample& s) { return s.constructUs; });
+    result.prepare = summarisePhase(samples, [](const StartupSample& s) { return s.prepareUs; });
+    result.firstAudio = summarisePhase(samples, [](const StartupSample& s) { return s.firstAudioUs; });
+    result.firstAudioFrames = samples.front().firstAudioFrames;
+    return result;
+}
+
+/** Each rate x block at full polyphony, to <outDir>/<name>.startup.json */
+template <typename Engine, typename StartFn>
+int runStartupMain(const Options& options, const std::string& name, int maxVoices, StartFn& start)
+{
+    std::vector<StartupResult> results;
+    for (double sampleRate : options.sampleRates)
+    {
+        for (int blockSize : options.blockSizes)
+        {
+            // The first config in the process is the only truly cold one
+            StartupResult r = runStartup<Engine>({maxVoices, blockSize, sampleRate}, options, start);
+            results.push_back(r);
+
+            std::printf("%-14s block=%4d sr=%6.0f  construct %8.1f us (cold %8.1f)  prepare %8.1f us (cold %8.1f)  "
+                        "first audio %8.1f us (cold %8.1f, %ld frames)\n",
+                        name.c_str(), blockSize, sampleRate, r.construct.medianUs, r.construct.coldUs,
+                        r.prepare.medianUs, r.prepare.coldUs, r.firstAudio.medianUs, r.firstAudio.coldUs,
+                        r.firstAudioFrames);
+            if (r.firstAudioFrames < 0)
+                std::printf("%-14s   warning: no audible output within 2 s\n", name.c_str());
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outDir, ec);
+    const std::string path = options.outDir + "/" + name + ".startup.json";
+    std::ofstream out(path);
+    char line[640];
+
+    out << "{\n";
+    out << "  \"engine\": \"" << name << "\",\n";
+    out << "  \"voices\": " << maxVoices << ",\n";
+    out << "  \"repeats\": " << options.repeats << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const StartupResult& r = results[i];
+        auto phase = [](const StartupPhase& p) {
+            char text[128];
+            std::snprintf(text, sizeof(text), "{\"coldUs\": %.3f, \"medianUs\": %.3f, \"maxUs\": %.3f}", p.coldUs,
+                          p.medianUs, p.maxUs);
+            return std::string(text);
+        };
+        std::snprintf(line, sizeof(line),
+                      "    {\"blockSize\": %d, \"sampleRate\": %.0f, \"construct\": %s, \"prepare\": %s, "
+                      "\"firstAudio\": %s, \"firstAudioFrames\": %ld}%s\n",
+                      r.config.blockSize, r.config.sampleRate, phase(r.construct).c_str(), phase(r.prepare).c_str(),
+                      phase(r.firstAudio).c_str(), r.firstAudioFrames, i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+    std::cout << "Wrote " << path << std::endl;
+
+    return 0;
+}
+
+/**
+ * @brief Benchmark entry point for one engine
+ * @param name Plugin name, used for the report file (<outDir>/<name>.json)
+ * @param maxVoices Engine polyphony; voice counts above it are skipped
+ * @param start How to make the engine play `voices` voices
+ * @return Process exit code
+ */
+template <typename Engine, typename StartFn>
+int runMain(int argc, char** argv, const std::string& name, int maxVoices, StartFn start)
+{
+    ScopedFlushDenormals noDenormals;
+    Options options = parseOptions(argc, argv);
+
+    if (options.latency)
+        return runLatency<Engine>(options, name, maxVoices, start);
+    if (options.scaling)
+        return runScaling<Engine>(options, name, maxVoices, start);
+    if (options.startup)
+        return runStartupMain<Engine>(options, name, maxVoices, start);
+
+    // Voice counts the engine supports, always including its maximum
+    std::vector<int> voiceCounts;
+    for (int v : options.voiceCounts)
+        if (v <= maxVoices)
+            voiceCounts.push_back(v);
+    if (voiceCounts.empty() || voiceCounts.back() != maxVoices)
+        voiceCounts.push_back(maxVoices);
+
+    std::vector<Result> results;
+    for (double sampleRate : options.sampleRates)
+    {
+        for (int blockSize : options.blockSizes)
+        {
+            for (int voices : voiceCounts)
+            {
+                Result r = runConfig<Engine>({voices, blockSize, sampleRate}, options, start);
+                results.push_back(r);
+
+                std::printf("%-14s voices=%2d block=%4d sr=%6.0f  %8.2f ns/sample  %8.1fx RT  worst %8.2f us (budget %8.2f)\n",
+                            name.c_str(), voices, blockSize, sampleRate, r.nsPerSample,
+                            r.realtimeFactor, r.worstBlockUs, r.blockBudgetUs);
+                if (r.nonFinite > 0)
+                    std::printf("%-14s   warning: %ld non-finite samples\n", name.c_str(), r.nonFinite);
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.outDir, ec);
+    const std::string path = options.outDir + "/" + name + ".json";
+    writeJson(path, name, maxVoices, options, results);
+    std::cout << "Wrote " << path << std::endl;
+
+    return 0;
+}
+
+} // namespace bench
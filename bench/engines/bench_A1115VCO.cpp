@@ -0,0 +1,10 @@
+// synth_bench adapter for A1115VCO: hold a chord of up to MAX_VOICES notes
+
+#include "BenchHarness.h"
+#include "SynthEngine.h"
+
+int main(int argc, char** argv)
+{
+    return bench::runMain<SynthEngine>(argc, argv, "A1115VCO", SynthEngine::MAX_VOICES,
+                                       [](SynthEngine& engine, int voices) { bench::playChord(engine, voices); });
+}
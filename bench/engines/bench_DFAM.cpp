@@ -0,0 +1,10 @@
+// synth_bench adapter for DFAM: the sequencer drives the single voice
+
+#include "BenchHarness.h"
+#include "SynthEngine.h"
+
+int main(int argc, char** argv)
+{
+    return bench::runMain<SynthEngine>(argc, argv, "DFAM", 1,
+                                       [](SynthEngine& engine, int) { engine.setRunning(true); });
+}
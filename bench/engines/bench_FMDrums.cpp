@@ -0,0 +1,15 @@
+// synth_bench adapter for FMDrums: "voices" is the number of drums hit together
+
+#include "BenchHarness.h"
+#include "DrumEngine.h"
+
+int main(int argc, char** argv)
+{
+    return bench::runMain<DrumEngine>(argc, argv, "FMDrums", 4,
+                                      [](DrumEngine& engine, int voices) {
+                                          static constexpr int drums[] = {DrumEngine::NOTE_KICK, DrumEngine::NOTE_SNARE,
+                                                                          DrumEngine::NOTE_HAT_CLOSED, DrumEngine::NOTE_HAT_OPEN};
+                                          for (int v = 0; v < voices; ++v)
+                                              engine.noteOn(drums[v], 0.8f);
+                                      });
+}
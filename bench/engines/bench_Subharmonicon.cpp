@@ -0,0 +1,10 @@
+// synth_bench adapter for Subharmonicon: the rhythm generators drive the voice
+
+#include "BenchHarness.h"
+#include "SynthEngine.h"
+
+int main(int argc, char** argv)
+{
+    return bench::runMain<SubharmoniconEngine>(argc, argv, "Subharmonicon", 1,
+                                               [](SubharmoniconEngine& engine, int) { engine.setRunning(true); });
+}
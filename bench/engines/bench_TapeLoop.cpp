@@ -0,0 +1,10 @@
+// synth_bench adapter for TapeLoop: one held note keeps the tape recording
+
+#include "BenchHarness.h"
+#include "TapeLoopEngine.h"
+
+int main(int argc, char** argv)
+{
+    return bench::runMain<TapeLoopEngine>(argc, argv, "TapeLoop", 1,
+                                          [](TapeLoopEngine& engine, int) { engine.noteOn(48, 0.8f); });
+}
@@ -0,0 +1,196 @@
+/**
+ * @file bench_fastmath.cpp
+ * @brief Error and speed of each FastMath function at each accuracy tier
+ *
+ * Every function is swept over the range its call sites use, against the
+ * double-precision libm result, and timed over the same inputs: scalar,
+ * and four lanes per call for the SIMD overloads (reported per value).
+ * The Exact rows are the platform's libm, so the speedups are against
+ * what the engines called before.
+ *
+ * Usage: synth_bench_fastmath [--out DIR] [--quick]
+ */
+
+#include "FastMath.h"
+
+#include "BenchHarness.h"  // ScopedFlushDenormals
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+using FastMath::Accuracy;
+
+struct Result
+{
+    std::string function;
+    const char* tier;
+    double low = 0.0, high = 0.0;
+    const char* errorKind = "absolute";
+    double maxError = 0.0;
+    double nsScalar = 0.0;
+    double nsSimd = 0.0;  // Per value, four per call
+};
+
+struct Function
+{
+    std::string name;
+    double low, high;
+    std::function<double(double)> reference;
+    bool relative;  // Error relative to the value (exp) rather than absolute
+};
+
+template <Accuracy A>
+constexpr const char* tierName()
+{
+    return A == Accuracy::Exact ? "exact" : (A == Accuracy::Audio ? "audio" : "control");
+}
+
+std::vector<float> sweep(double low, double high, int n)
+{
+    std::vector<float> x(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+        x[static_cast<size_t>(i)] = static_cast<float>(low + (high - low) * i / (n - 1));
+    return x;
+}
+
+/** Time fn over x, repeated, in ns per value; the sum keeps the calls alive */
+template <typename Fn>
+double timeScalar(const std::vector<float>& x, int repeats, Fn&& fn)
+{
+    volatile float sink = 0.0f;
+    float sum = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+        for (float v : x)
+            sum += fn(v);
+    const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    sink = sum;
+    (void)sink;
+    return ns / (static_cast<double>(x.size()) * repeats);
+}
+
+template <typename Fn>
+double timeSimd(const std::vector<float>& x, int repeats, Fn&& fn)
+{
+    volatile float sink = 0.0f;
+    auto sum = SIMD_MM(setzero_ps)();
+    const size_t n = x.size() / 4 * 4;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r)
+        for (size_t i = 0; i < n; i += 4)
+            sum = SIMD_MM(add_ps)(sum, fn(SIMD_MM(loadu_ps)(x.data() + i)));
+    const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    alignas(16) float lanes[4];
+    SIMD_MM(store_ps)(lanes, sum);
+    sink = lanes[0];
+    (void)sink;
+    return ns / (static_cast<double>(n) * repeats);
+}
+
+template <Accuracy A, typename Scalar, typename Simd>
+Result measure(const Function& f, const std::vector<float>& x, int repeats, Scalar&& scalar, Simd&& simd)
+{
+    Result r{f.name, tierName<A>(), f.low, f.high, f.relative ? "relative" : "absolute"};
+    const auto error = [&f](double got, double want) {
+        return std::abs(got - want) / (f.relative ? std::abs(want) : 1.0);
+    };
+    for (float v : x)
+    {
+        const double want = f.reference(static_cast<double>(v));
+
+        // The SIMD overload is held to the same bound as the scalar one
+        alignas(16) float lanes[4];
+        SIMD_MM(store_ps)(lanes, simd(SIMD_MM(set1_ps)(v)));
+        r.maxError = std::max({r.maxError, error(scalar(v), want), error(lanes[0], want)});
+    }
+    r.nsScalar = timeScalar(x, repeats, scalar);
+    r.nsSimd = timeSimd(x, repeats, simd);
+    return r;
+}
+
+/** The three tiers of one function */
+#define FASTMATH_TIERS(results, f, x, repeats, call)                                                         \
+    do                                                                                                       \
+    {                                                                                                        \
+        results.push_back(measure<Accuracy::Exact>(f, x, repeats,                                            \
+            [](float v) { return FastMath::call<Accuracy::Exact>(v); },                                      \
+            [](SIMD_M128 v) { return FastMath::call<Accuracy::Exact>(v); }));                                \
+        results.push_back(measure<Accuracy::Audio>(f, x, repeats,                                            \
+            [](float v) { return FastMath::call<Accuracy::Audio>(v); },                                      \
+            [](SIMD_M128 v) { return FastMath::call<Accuracy::Audio>(v); }));                                \
+        results.push_back(measure<Accuracy::Control>(f, x, repeats,                                          \
+            [](float v) { return FastMath::call<Accuracy::Control>(v); },                                    \
+            [](SIMD_M128 v) { return FastMath::call<Accuracy::Control>(v); }));                              \
+    } while (false)
+
+void writeJson(const std::string& path, const std::vector<Result>& results)
+{
+    std::ofstream out(path);
+    char line[512];
+    out << "{\n  \"functions\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "    {\"function\": \"%s\", \"tier\": \"%s\", \"low\": %g, \"high\": %g, "
+                      "\"error\": \"%s\", \"maxError\": %.3g, \"nsScalar\": %.3f, \"nsSimd\": %.3f}%s\n",
+                      r.function.c_str(), r.tier, r.low, r.high, r.errorKind, r.maxError, r.nsScalar, r.nsSimd,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string outDir = "bench";
+    bool quick = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outDir = argv[++i];
+        else if (std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    bench::ScopedFlushDenormals noDenormals;
+    const int points = 1 << 16;
+    const int repeats = quick ? 20 : 200;
+
+    // Ranges the engines use: saturator drive, phase in cycles, envelope
+    // and pitch exponents, detector levels
+    const Function tanhF{"tanh", -8.0, 8.0, [](double x) { return std::tanh(x); }, false};
+    const Function sinF{"sinCycles", -4.0, 4.0, [](double x) { return std::sin(2.0 * M_PI * x); }, false};
+    const Function exp2F{"exp2", -24.0, 24.0, [](double x) { return std::exp2(x); }, true};
+    const Function expF{"exp", -16.0, 16.0, [](double x) { return std::exp(x); }, true};
+    const Function log2F{"log2", 1.0e-6, 16.0, [](double x) { return std::log2(x); }, false};
+
+    std::vector<Result> results;
+    FASTMATH_TIERS(results, tanhF, sweep(tanhF.low, tanhF.high, points), repeats, tanh);
+    FASTMATH_TIERS(results, sinF, sweep(sinF.low, sinF.high, points), repeats, sinCycles);
+    FASTMATH_TIERS(results, exp2F, sweep(exp2F.low, exp2F.high, points), repeats, exp2);
+    FASTMATH_TIERS(results, expF, sweep(expF.low, expF.high, points), repeats, exp);
+    FASTMATH_TIERS(results, log2F, sweep(log2F.low, log2F.high, points), repeats, log2);
+
+    std::printf("%-10s %-8s %10s %9s %10s %10s\n", "function", "tier", "max error", "", "ns scalar", "ns simd");
+    for (const Result& r : results)
+        std::printf("%-10s %-8s %10.3g %9s %10.3f %10.3f\n", r.function.c_str(), r.tier, r.maxError, r.errorKind,
+                    r.nsScalar, r.nsSimd);
+
+    std::filesystem::create_directories(outDir);
+    const auto path = (std::filesystem::path(outDir) / "fastmath.json").string();
+    writeJson(path, results);
+    std::printf("Wrote %s\n", path.c_str());
+    return 0;
+}
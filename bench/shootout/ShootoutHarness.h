@@ -0,0 +1,355 @@
+/**
+ * @file ShootoutHarness.h
+ * @brief Filter and oscillator microbenchmarks: cost per sample and aliasing
+ *
+ * synth_bench times whole engines; this times the kernels inside them, so
+ * a plugin-local ladder can be weighed against the sst filter it could be
+ * swapped for (and a polyBLEP against the shared BLEP / DPW oscillators)
+ * before anyone rewrites a voice.
+ *
+ * Each shootout_<group> executable registers its kernels; this header runs
+ * every kernel at each sample rate and a few cutoffs / pitches and reports:
+ *
+ *   - nsPerVoiceSample: wall time per sample per voice. Quad kernels run
+ *     four voices per call, so their 4-lane cost is divided by four; their
+ *     1-lane entry shows what one voice pays for the SIMD kernel alone.
+ *   - aliasDb: power outside the harmonic series, relative to the
+ *     fundamental. Filters are driven at 0 dBFS by a sine at their cutoff
+ *     (the nonlinear ones generate harmonics that fold back); oscillators
+ *     are measured as they are. The tone sits on an FFT bin, so a
+ *     Blackman-Harris window and +-4 bins around each harmonic cover the
+ *     leakage; everything else is aliasing (or the noise floor).
+ *
+ * Timing follows BenchHarness.h: wall clock around the processing, with
+ * denormals flushed as the hosts do. The groups are separate executables
+ * because the plugins' kernels share class names (three LadderFilters).
+ *
+ * Usage: shootout_<group> [--out DIR] [--seconds S] [--quick] [--rate SR]
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"  // ScopedFlushDenormals
+
+namespace shootout
+{
+
+struct Options
+{
+    double seconds = 1.0;  // Audio processed per timing
+    std::string outDir = "bench";
+    std::vector<double> sampleRates{48000.0, 96000.0};
+    std::vector<float> cutoffs{250.0f, 2000.0f, 8000.0f};      // Filters
+    std::vector<float> frequencies{110.0f, 1760.0f, 5000.0f};  // Oscillators
+    float resonance = 0.5f;
+};
+
+inline Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    bool quick = false, seconds = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            options.outDir = argv[++i];
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            options.seconds = std::max(0.05, std::atof(argv[++i]));
+            seconds = true;
+        }
+        else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            options.sampleRates = {std::max(8000.0, std::atof(argv[++i]))};
+        else if (std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+    }
+
+    if (quick)
+    {
+        if (!seconds)
+            options.seconds = 0.1;
+        options.cutoffs = {2000.0f};
+        options.frequencies = {1760.0f};
+    }
+    return options;
+}
+
+/**
+ * @brief A filter under test
+ *
+ * process() runs n samples through every lane with the same input and
+ * returns lane 0. prepare() must leave the filter silent.
+ */
+struct FilterKernel
+{
+    std::string name;
+    int lanes = 1;  // Voices per process() call
+    std::function<void(double sampleRate)> prepare;
+    std::function<void(float cutoffHz, float resonance)> set;
+    std::function<void(const float* in, float* out, int n)> process;
+};
+
+/** An oscillator under test (one voice) */
+struct OscillatorKernel
+{
+    std::string name;
+    std::function<void(double sampleRate)> prepare;
+    std::function<void(float frequencyHz)> setFrequency;
+    std::function<void(float* out, int n)> process;
+};
+
+struct Result
+{
+    std::string kernel;
+    int lanes = 1;
+    double sampleRate = 0.0;
+    float hz = 0.0f;  // Cutoff or pitch
+    double nsPerVoiceSample = 0.0;
+    double aliasDb = 0.0;
+    long nonFinite = 0;
+};
+
+//==============================================================================
+// Spectrum
+//==============================================================================
+
+static constexpr int fftSize = 16384;
+static constexpr int blockSize = 64;  // process() calls are this long
+
+/** In-place radix-2 FFT; x.size() is a power of two */
+inline void fft(std::vector<std::complex<double>>& x)
+{
+    const size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        const double angle = -2.0 * M_PI / static_cast<double>(len);
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < len / 2; ++k)
+            {
+                const auto u = x[i + k];
+                const auto v = x[i + k + len / 2] * w;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+                w *= step;
+            }
+        }
+    }
+}
+
+/** The nearest odd FFT bin to hz, so harmonics rarely fold onto each other */
+inline int coherentBin(float hz, double sampleRate)
+{
+    int bin = static_cast<int>(std::lround(hz * fftSize / sampleRate));
+    bin = std::clamp(bin | 1, 3, fftSize / 2 - 1);
+    return bin;
+}
+
+inline float binFrequency(int bin, double sampleRate)
+{
+    return static_cast<float>(bin * sampleRate / fftSize);
+}
+
+/**
+ * @brief Power outside the harmonics of `bin`, relative to the fundamental, in dB
+ *
+ * x holds fftSize samples of a steady tone whose fundamental is on `bin`.
+ */
+inline double aliasingDb(const std::vector<float>& x, int bin)
+{
+    static constexpr int guard = 4;  // Blackman-Harris main lobe half-width
+
+    std::vector<std::complex<double>> spectrum(fftSize);
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const double p = 2.0 * M_PI * i / fftSize;
+        const double w = 0.35875 - 0.48829 * std::cos(p) + 0.14128 * std::cos(2 * p) - 0.01168 * std::cos(3 * p);
+        spectrum[static_cast<size_t>(i)] = x[static_cast<size_t>(i)] * w;
+    }
+    fft(spectrum);
+
+    std::vector<bool> harmonic(fftSize / 2, false);
+    for (int h = bin; h < fftSize / 2; h += bin)
+        for (int b = std::max(0, h - guard); b <= std::min(fftSize / 2 - 1, h + guard); ++b)
+            harmonic[static_cast<size_t>(b)] = true;
+
+    double fundamental = 0.0, alias = 1e-30;
+    for (int b = guard + 1; b < fftSize / 2; ++b)  // Skip DC
+    {
+        const double p = std::norm(spectrum[static_cast<size_t>(b)]);
+        if (std::abs(b - bin) <= guard)
+            fundamental += p;
+        else if (!harmonic[static_cast<size_t>(b)])
+            alias += p;
+    }
+    return 10.0 * std::log10(alias / std::max(fundamental, 1e-30));
+}
+
+//==============================================================================
+// Runs
+//==============================================================================
+
+/** Deterministic white noise in [-amplitude, amplitude] */
+inline std::vector<float> noise(int n, float amplitude)
+{
+    std::vector<float> x(static_cast<size_t>(n));
+    uint32_t seed = 0x1234567u;
+    for (auto& s : x)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        s = amplitude * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+    }
+    return x;
+}
+
+inline long countNonFinite(const std::vector<float>& x)
+{
+    return std::count_if(x.begin(), x.end(), [](float s) { return !std::isfinite(s); });
+}
+
+inline Result runFilter(FilterKernel& kernel, double sampleRate, float cutoff, const Options& options)
+{
+    Result r{kernel.name, kernel.lanes, sampleRate, cutoff};
+    const int n = std::max(blockSize, static_cast<int>(options.seconds * sampleRate) / blockSize * blockSize);
+
+    // Cost: noise through the filter
+    const auto input = noise(n, 0.5f);
+    std::vector<float> output(static_cast<size_t>(n));
+    kernel.prepare(sampleRate);
+    kernel.set(cutoff, options.resonance);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i += blockSize)
+        kernel.process(input.data() + i, output.data() + i, blockSize);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    r.nsPerVoiceSample = elapsed / (static_cast<double>(n) * kernel.lanes);
+    r.nonFinite = countNonFinite(output);
+
+    // Aliasing: a 0 dBFS sine at the cutoff, measured after a settle
+    const int bin = coherentBin(cutoff, sampleRate);
+    const int settle = static_cast<int>(sampleRate / 4) / blockSize * blockSize;
+    std::vector<float> sine(static_cast<size_t>(settle + fftSize));
+    for (size_t i = 0; i < sine.size(); ++i)
+        sine[i] = static_cast<float>(std::sin(2.0 * M_PI * static_cast<double>(bin) * static_cast<double>(i % fftSize) / fftSize));
+    std::vector<float> tone(sine.size());
+    kernel.prepare(sampleRate);
+    kernel.set(cutoff, options.resonance);
+    for (size_t i = 0; i < sine.size(); i += blockSize)
+        kernel.process(sine.data() + i, tone.data() + i, blockSize);
+
+    r.nonFinite += countNonFinite(tone);
+    r.aliasDb = aliasingDb(std::vector<float>(tone.end() - fftSize, tone.end()), bin);
+    return r;
+}
+
+inline Result runOscillator(OscillatorKernel& kernel, double sampleRate, float frequency, const Options& options)
+{
+    const int bin = coherentBin(frequency, sampleRate);
+    Result r{kernel.name, 1, sampleRate, binFrequency(bin, sampleRate)};
+    const int n = std::max(fftSize, static_cast<int>(options.seconds * sampleRate) / blockSize * blockSize);
+
+    std::vector<float> output(static_cast<size_t>(n));
+    kernel.prepare(sampleRate);
+    kernel.setFrequency(r.hz);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i += blockSize)
+        kernel.process(output.data() + i, blockSize);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    r.nsPerVoiceSample = elapsed / n;
+    r.nonFinite = countNonFinite(output);
+    r.aliasDb = aliasingDb(std::vector<float>(output.end() - fftSize, output.end()), bin);
+    return r;
+}
+
+inline void writeJson(const std::string& path, const std::string& group, const Options& options,
+                      const std::vector<Result>& filters, const std::vector<Result>& oscillators)
+{
+    std::ofstream out(path);
+    char line[512];
+
+    auto writeResults = [&](const char* key, const char* hzKey, const std::vector<Result>& results, bool last) {
+        out << "  \"" << key << "\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::snprintf(line, sizeof(line),
+                          "    {\"kernel\": \"%s\", \"lanes\": %d, \"sampleRate\": %.0f, \"%s\": %.1f, "
+                          "\"nsPerVoiceSample\": %.3f, \"aliasDb\": %.1f, \"nonFinite\": %ld}%s\n",
+                          r.kernel.c_str(), r.lanes, r.sampleRate, hzKey, static_cast<double>(r.hz),
+                          r.nsPerVoiceSample, r.aliasDb, r.nonFinite, i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "  ]" << (last ? "\n" : ",\n");
+    };
+
+    out << "{\n";
+    out << "  \"group\": \"" << group << "\",\n";
+    out << "  \"secondsPerRun\": " << options.seconds << ",\n";
+    out << "  \"resonance\": " << options.resonance << ",\n";
+    writeResults("filters", "cutoffHz", filters, false);
+    writeResults("oscillators", "frequencyHz", oscillators, true);
+    out << "}\n";
+}
+
+/** Entry point for a shootout_<group> executable */
+inline int runMain(int argc, char** argv, const std::string& group,
+                   std::vector<FilterKernel> filterKernels, std::vector<OscillatorKernel> oscillatorKernels)
+{
+    const Options options = parseOptions(argc, argv);
+    bench::ScopedFlushDenormals noDenormals;
+
+    std::vector<Result> filters, oscillators;
+    std::printf("%-28s %5s %7s %8s %12s %9s\n", "kernel", "lanes", "rate", "hz", "ns/voice/smp", "alias dB");
+
+    auto print = [](const Result& r) {
+        std::printf("%-28s %5d %7.0f %8.1f %12.3f %9.1f%s\n", r.kernel.c_str(), r.lanes, r.sampleRate,
+                    static_cast<double>(r.hz), r.nsPerVoiceSample, r.aliasDb, r.nonFinite > 0 ? "  NON-FINITE" : "");
+    };
+
+    for (double sampleRate : options.sampleRates)
+    {
+        for (auto& kernel : filterKernels)
+            for (float cutoff : options.cutoffs)
+                print(filters.emplace_back(runFilter(kernel, sampleRate, cutoff, options)));
+
+        for (auto& kernel : oscillatorKernels)
+            for (float frequency : options.frequencies)
+                print(oscillators.emplace_back(runOscillator(kernel, sampleRate, frequency, options)));
+    }
+
+    std::filesystem::create_directories(options.outDir);
+    const auto path = (std::filesystem::path(options.outDir) / ("shootout_" + group + ".json")).string();
+    writeJson(path, group, options, filters, oscillators);
+    std::cout << "Wrote " << path << "\n";
+    return 0;
+}
+
+} // namespace shootout
@@ -0,0 +1,123 @@
+/**
+ * @file ShootoutKernels.h
+ * @brief FilterKernel adapters: sst quad filter units and per-lane scalar filters
+ *
+ * sstQuadKernel() drives any QuadFilterUnit process function. Its
+ * coefficients come from FilterCoefficientMaker, refreshed every 32 samples
+ * per active lane as the plugins do, so that cost is counted. The function
+ * is passed in so plugin kernels built on the same state (ModelD's
+ * LadderFilter::processQuad) run through the same path.
+ *
+ * scalarKernel() runs one plugin-style scalar filter per lane, the
+ * alternative to sharing a quad call between four voices.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/filters.h"
+
+#include "ShootoutHarness.h"
+
+namespace shootout
+{
+
+/** A quad filter unit with `lanes` active voices (1 or 4) */
+inline FilterKernel sstQuadKernel(const std::string& name, int lanes, sst::filters::FilterType type,
+                                  sst::filters::FilterSubType subtype, sst::filters::FilterUnitQFPtr fn)
+{
+    static constexpr int coeffBlock = 32;
+
+    struct State
+    {
+        sst::filters::QuadFilterUnitState q{};
+        std::array<sst::filters::FilterCoefficientMaker<>, 4> makers;
+        float cutoff = 1000.0f, resonance = 0.0f;
+        int untilUpdate = 0;
+    };
+
+    auto s = std::make_shared<State>();
+    FilterKernel kernel;
+    kernel.name = name + (lanes == 4 ? " x4" : " x1");
+    kernel.lanes = lanes;
+
+    kernel.prepare = [s, lanes](double sampleRate) {
+        std::memset(&s->q, 0, sizeof(s->q));
+        s->q.sampleRate = static_cast<float>(sampleRate);
+        s->q.sampleRateInv = 1.0f / static_cast<float>(sampleRate);
+        for (int lane = 0; lane < 4; ++lane)
+            s->q.active[lane] = lane < lanes ? -1 : 0;
+        for (auto& m : s->makers)
+        {
+            m.setSampleRateAndBlockSize(static_cast<float>(sampleRate), coeffBlock);
+            m.Reset();
+        }
+        s->untilUpdate = 0;
+    };
+
+    kernel.set = [s](float cutoffHz, float resonance) {
+        s->cutoff = cutoffHz;
+        s->resonance = resonance;
+    };
+
+    kernel.process = [s, lanes, type, subtype, fn](const float* in, float* out, int n) {
+        for (int i = 0; i < n; ++i)
+        {
+            if (s->untilUpdate-- == 0)
+            {
+                for (int lane = 0; lane < lanes; ++lane)
+                {
+                    auto& m = s->makers[static_cast<size_t>(lane)];
+                    m.updateCoefficients(s->q, lane);
+                    m.MakeCoeffs(12.0f * std::log2(s->cutoff / 440.0f), s->resonance, type, subtype, nullptr, false);
+                    m.updateState(s->q, lane);
+                }
+                s->untilUpdate = coeffBlock - 1;
+            }
+            out[i] = SIMD_MM(cvtss_f32)(fn(&s->q, SIMD_MM(set1_ps)(in[i])));
+        }
+    };
+
+    return kernel;
+}
+
+/** `lanes` copies of a scalar Filter (setCutoff / setResonance / process) */
+template <typename Filter, typename Prepare>
+FilterKernel scalarKernel(const std::string& name, int lanes, Prepare prepare)
+{
+    auto filters = std::make_shared<std::array<Filter, 4>>();
+    FilterKernel kernel;
+    kernel.name = name + (lanes == 4 ? " x4" : " x1");
+    kernel.lanes = lanes;
+
+    kernel.prepare = [filters, prepare](double sampleRate) {
+        for (auto& f : *filters)
+        {
+            f = Filter{};
+            prepare(f, sampleRate);
+        }
+    };
+    kernel.set = [filters](float cutoffHz, float resonance) {
+        for (auto& f : *filters)
+        {
+            f.setCutoff(cutoffHz);
+            f.setResonance(resonance);
+        }
+    };
+    kernel.process = [filters, lanes](const float* in, float* out, int n) {
+        for (int i = 0; i < n; ++i)
+        {
+            out[i] = (*filters)[0].process(in[i]);
+            for (int lane = 1; lane < lanes; ++lane)
+                (*filters)[static_cast<size_t>(lane)].process(in[i]);
+        }
+    };
+    return kernel;
+}
+
+} // namespace shootout
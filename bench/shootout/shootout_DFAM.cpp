@@ -0,0 +1,16 @@
+// Filter / oscillator shootout: DFAM's scalar ladder (5 tanh per sample)
+
+#include "ShootoutKernels.h"
+#include "Voice.h"
+
+int main(int argc, char** argv)
+{
+    auto prepare = [](LadderFilter& f, double sr) { f.prepare(sr); f.setMode(LadderFilter::LOWPASS); };
+
+    std::vector<shootout::FilterKernel> filters{
+        shootout::scalarKernel<LadderFilter>("DFAM ladder", 1, prepare),
+        shootout::scalarKernel<LadderFilter>("DFAM ladder", 4, prepare),
+    };
+
+    return shootout::runMain(argc, argv, "DFAM", std::move(filters), {});
+}
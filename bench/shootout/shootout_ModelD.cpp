@@ -0,0 +1,26 @@
+// Filter / oscillator shootout: ModelD's ladder and polyBLEP oscillator
+
+#include "ShootoutKernels.h"
+#include "Voice.h"
+
+int main(int argc, char** argv)
+{
+    using namespace sst::filters;
+
+    // The voice's ladder is the sst Huov unit behind a tanh input clip;
+    // x4 is the VoiceGroup path, x1 what a lone voice pays
+    std::vector<shootout::FilterKernel> filters{
+        shootout::sstQuadKernel("ModelD ladder", 1, fut_vintageladder, st_vintage_type2, &LadderFilter::processQuad),
+        shootout::sstQuadKernel("ModelD ladder", 4, fut_vintageladder, st_vintage_type2, &LadderFilter::processQuad),
+    };
+
+    auto osc = std::make_shared<PolyBlepOscillator>();
+    std::vector<shootout::OscillatorKernel> oscillators{
+        {"ModelD polyBLEP saw",
+         [osc](double sr) { *osc = PolyBlepOscillator{}; osc->setSampleRate(static_cast<float>(sr)); },
+         [osc](float hz) { osc->setFrequency(hz); },
+         [osc](float* out, int n) { for (int i = 0; i < n; ++i) out[i] = osc->process(); }},
+    };
+
+    return shootout::runMain(argc, argv, "ModelD", std::move(filters), std::move(oscillators));
+}
@@ -0,0 +1,16 @@
+// Filter / oscillator shootout: Subharmonicon's scalar ladder (trapezoidal, one tanh)
+
+#include "ShootoutKernels.h"
+#include "Voice.h"
+
+int main(int argc, char** argv)
+{
+    auto prepare = [](LadderFilter& f, double sr) { f.setSampleRate(static_cast<float>(sr)); };
+
+    std::vector<shootout::FilterKernel> filters{
+        shootout::scalarKernel<LadderFilter>("Subharmonicon ladder", 1, prepare),
+        shootout::scalarKernel<LadderFilter>("Subharmonicon ladder", 4, prepare),
+    };
+
+    return shootout::runMain(argc, argv, "Subharmonicon", std::move(filters), {});
+}
@@ -0,0 +1,122 @@
+// Filter / oscillator shootout: the shared kernels (sst filters, core/dsp oscillators)
+
+#include "ShootoutKernels.h"
+#include "BandLimitedOscillator.h"
+#include "Waveguide.h"
+#include "Wavetable.h"
+#include "sst/filters/CytomicSVF.h"
+
+#include <memory>
+
+using namespace sst::filters;
+
+namespace
+{
+template <typename Osc>
+shootout::OscillatorKernel oscillatorKernel(const std::string& name)
+{
+    auto osc = std::make_shared<Osc>();
+    return {name,
+            [osc](double sr) { osc->prepare(sr); osc->setShape(OscShape::Saw); },
+            [osc](float hz) { osc->setFrequency(hz); },
+            [osc](float* out, int n) { for (int i = 0; i < n; ++i) out[i] = osc->process(); }};
+}
+
+/** WavetableOscillator on the built-in table, first frame */
+shootout::OscillatorKernel wavetableKernel()
+{
+    auto osc = std::make_shared<WavetableOscillator>();
+    return {"wavetable (basic)",
+            [osc](double sr) {
+                osc->prepare(sr);
+                osc->setTable(WavetableRegistry::get().builtin(WavetableRegistry::Builtin::Basic));
+            },
+            [osc](float hz) { osc->setFrequency(hz); },
+            [osc](float* out, int n) { for (int i = 0; i < n; ++i) out[i] = osc->process(0.0f); }};
+}
+
+/** One WaveguideString lane, plucked or bowed; excited on every retune */
+shootout::OscillatorKernel waveguideKernel(const std::string& name, StringExcitation excitation)
+{
+    auto string = std::make_shared<WaveguideString>();
+    return {name,
+            [string, excitation](double sr) {
+                string->prepare(sr);
+                string->setExcitation(excitation);
+            },
+            [string](float hz) {
+                string->reset(0);
+                string->setFrequency(0, hz);
+                string->excite(0, 1.0f);
+            },
+            [string](float* out, int n) { for (int i = 0; i < n; ++i) out[i] = string->process(); }};
+}
+
+/** The trivial saw, as the aliasing reference */
+shootout::OscillatorKernel naiveSaw()
+{
+    struct State { double sampleRate = 48000.0; float phase = 0.0f, inc = 0.0f; };
+    auto s = std::make_shared<State>();
+    return {"naive saw",
+            [s](double sr) { *s = State{sr}; },
+            [s](float hz) { s->inc = hz / static_cast<float>(s->sampleRate); },
+            [s](float* out, int n) {
+                for (int i = 0; i < n; ++i)
+                {
+                    out[i] = 2.0f * s->phase - 1.0f;
+                    s->phase += s->inc;
+                    if (s->phase >= 1.0f)
+                        s->phase -= 1.0f;
+                }
+            }};
+}
+
+/** CytomicSVF lowpass, the standalone struct (one voice per lane, as Phoneme uses it) */
+shootout::FilterKernel cytomicStruct()
+{
+    struct State { CytomicSVF svf; float srInv = 1.0f / 48000.0f; };
+    auto s = std::make_shared<State>();
+    return {"CytomicSVF struct LP x1", 1,
+            [s](double sr) { s->svf.init(); s->srInv = 1.0f / static_cast<float>(sr); },
+            [s](float hz, float res) { s->svf.setCoeff(CytomicSVF::Mode::Lowpass, hz, res, s->srInv); },
+            [s](const float* in, float* out, int n) {
+                for (int i = 0; i < n; ++i)
+                {
+                    float x = in[i];
+                    s->svf.processBlockStep(x);
+                    out[i] = x;
+                }
+            }};
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    struct Unit { const char* name; FilterType type; FilterSubType subtype; };
+    const Unit units[] = {
+        {"vintage ladder (Huov)", fut_vintageladder, st_vintage_type2},
+        {"vintage ladder (RK)", fut_vintageladder, st_vintage_type1},
+        {"OB-Xd 24 dB", fut_obxd_4pole, st_obxd4pole_24dB},
+        {"diode ladder 24 dB", fut_diode, st_diode_24dB},
+        {"K35 LP", fut_k35_lp, st_k35_moderate},
+        {"cytomic SVF LP", fut_cytomic_svf, st_cytomic_lp},
+    };
+
+    std::vector<shootout::FilterKernel> filters;
+    for (const auto& u : units)
+        for (int lanes : {1, 4})
+            filters.push_back(shootout::sstQuadKernel(u.name, lanes, u.type, u.subtype,
+                                                      GetQFPtrFilterUnit(u.type, u.subtype)));
+    filters.push_back(cytomicStruct());
+
+    std::vector<shootout::OscillatorKernel> oscillators{
+        naiveSaw(),
+        oscillatorKernel<BlepOscillator>("BLEP saw (EBSaw)"),
+        oscillatorKernel<DPWOscillator>("DPW saw"),
+        wavetableKernel(),
+        waveguideKernel("waveguide pluck", StringExcitation::Pluck),
+        waveguideKernel("waveguide bow", StringExcitation::Bow),
+    };
+
+    return shootout::runMain(argc, argv, "sst", std::move(filters), std::move(oscillators));
+}
@@ -0,0 +1,436 @@
+#!/usr/bin/env node
+/**
+ * @file wasm_bench.mjs
+ * @brief Headless WASM benchmark: the web engines under Node, native scenarios
+ *
+ * The browser builds (web-dfam's dfam.wasm, AdditiveSquare's synth.wasm)
+ * could only be measured in a tab. This loads each built module the way
+ * its worklet does - raw .wasm instantiated with names read from the
+ * Emscripten glue (web-dfam/src/audio/wasmGlue.ts) - calls init and
+ * process, and times every block of the synth_bench --latency scenarios,
+ * for the SIMD128 and scalar builds of each engine.
+ *
+ * The scenarios follow bench::runScenario in bench/BenchHarness.h event
+ * for event (same periods, chords and sweep), and the report uses the
+ * native <Plugin>.latency.json fields plus realtimeFactor, so the two
+ * can be compared directly. Change them together.
+ *
+ * Usage: node bench/wasm/wasm_bench.mjs [--out DIR] [--seconds S] [--quick]
+ *                                       [--block N]... [--rate SR] [--engine NAME]...
+ *
+ * Build the modules first (make wasm in web-dfam and synths/AdditiveSquare);
+ * missing builds are skipped.
+ */
+
+import { existsSync, mkdirSync, readFileSync, writeFileSync } from 'node:fs';
+import { dirname, join, resolve } from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { performance } from 'node:perf_hooks';
+
+const ROOT = resolve(dirname(fileURLToPath(import.meta.url)), '../..');
+
+//==============================================================================
+// Options (as BenchHarness.h parseOptions with --latency)
+//==============================================================================
+
+function parseOptions(argv) {
+  const options = {
+    seconds: 20,
+    outDir: 'bench',
+    blockSizes: [32, 64, 128, 256, 512],
+    sampleRates: [48000],
+    engines: [],
+  };
+  let quick = false, seconds = false, blocks = false;
+
+  for (let i = 0; i < argv.length; i++) {
+    const next = () => argv[++i];
+    if (argv[i] === '--out' && i + 1 < argv.length) options.outDir = next();
+    else if (argv[i] === '--seconds' && i + 1 < argv.length) {
+      options.seconds = Math.max(0.05, Number(next()));
+      seconds = true;
+    } else if (argv[i] === '--block' && i + 1 < argv.length) {
+      if (!blocks) options.blockSizes = [];
+      options.blockSizes.push(Math.max(1, parseInt(next(), 10)));
+      blocks = true;
+    } else if (argv[i] === '--rate' && i + 1 < argv.length) {
+      options.sampleRates = [Math.max(8000, Number(next()))];
+    } else if (argv[i] === '--engine' && i + 1 < argv.length) {
+      options.engines.push(next());
+    } else if (argv[i] === '--quick') {
+      quick = true;
+    }
+  }
+
+  if (quick && !seconds) options.seconds = 0.25;
+  if (quick && !blocks) options.blockSizes = [128];
+  return options;
+}
+
+//==============================================================================
+// Loading (as the worklets do)
+//==============================================================================
+
+/** C export name -> minified export, minified import key -> runtime name (wasmGlue.ts) */
+function parseWasmGlue(glue) {
+  const exports = {};
+  const imports = {};
+
+  for (const m of glue.matchAll(/Module\["_(\w+)"\]=wasmExports\["(\w+)"\]/g)) {
+    exports[m[1]] = m[2];
+  }
+
+  const memory = glue.match(/wasmMemory=wasmExports\["(\w+)"\]/);
+  if (memory) exports.memory = memory[1];
+
+  const ctors = glue.match(/addOnInit\(wasmExports\["(\w+)"\]\)/);
+  if (ctors) exports.__wasm_call_ctors = ctors[1];
+
+  const importBlock = glue.match(/wasmImports=\{([^}]*)\}/);
+  if (importBlock) {
+    for (const entry of importBlock[1].split(',')) {
+      const [key, name] = entry.split(':');
+      if (key && name) imports[key.trim()] = name.trim();
+    }
+  }
+
+  return { exports, imports };
+}
+
+/**
+ * Instantiate <base>.wasm next to its glue <base>.js and resolve the C
+ * exports by name. Returns null if the build isn't there.
+ */
+async function loadModule(dir, base) {
+  const wasmPath = join(dir, base + '.wasm');
+  const gluePath = join(dir, base + '.js');
+  if (!existsSync(wasmPath)) return null;
+
+  const names = existsSync(gluePath)
+    ? parseWasmGlue(readFileSync(gluePath, 'utf8'))
+    : { exports: {}, imports: {} };
+
+  let memory = null;
+  const runtime = {
+    _abort: () => { throw new Error('WASM abort'); },
+    ___cxa_throw: () => { throw new Error('C++ exception'); },
+    _getentropy: (buffer, size) => {
+      const view = new Uint8Array(memory.buffer, buffer, size);
+      for (let i = 0; i < size; i++) view[i] = Math.floor(Math.random() * 256);
+      return 0;
+    },
+    _emscripten_memcpy_js: (dest, src, num) => {
+      new Uint8Array(memory.buffer).copyWithin(dest, src, src + num);
+    },
+    _emscripten_memcpy_big: (dest, src, num) => {
+      new Uint8Array(memory.buffer).copyWithin(dest, src, src + num);
+    },
+    _emscripten_resize_heap: (requestedSize) => {
+      const pages = Math.ceil((requestedSize - memory.buffer.byteLength) / 65536);
+      try {
+        memory.grow(pages);
+        return 1;
+      } catch {
+        return 0;
+      }
+    },
+    _emscripten_get_now: () => performance.now(),
+  };
+
+  // Minified builds import { a: { <key>: fn } }; unminified ones name env functions
+  const module = await WebAssembly.compile(readFileSync(wasmPath));
+  const importObject = {};
+  for (const imp of WebAssembly.Module.imports(module)) {
+    if (imp.kind !== 'function') continue;
+    const name = names.imports[imp.name] || '_' + imp.name;
+    const fn = runtime[name] || (() => { throw new Error('Unsupported WASM import ' + name); });
+    (importObject[imp.module] ??= {})[imp.name] = fn;
+  }
+
+  const instance = await WebAssembly.instantiate(module, importObject);
+  const raw = instance.exports;
+  const resolveExport = (name) => raw[names.exports[name]] || raw[name] || null;
+
+  const wasm = {};
+  for (const name of Object.keys(names.exports).concat(Object.keys(raw))) {
+    const fn = resolveExport(name);
+    if (fn && !(name in wasm)) wasm[name] = fn;
+  }
+
+  memory = resolveExport('memory');
+  if (!memory) throw new Error(wasmPath + ': no memory export');
+  const ctors = resolveExport('__wasm_call_ctors');
+  if (ctors) ctors();
+
+  return { wasm, memory };
+}
+
+//==============================================================================
+// Engines
+//==============================================================================
+
+/** Hold a chord of `voices` notes (BenchHarness.h chordNote / playChord) */
+function chordNote(voice, lowestNote) {
+  const intervals = [0, 7, 12, 16, 19, 24, 28, 31];
+  return Math.min(lowestNote + intervals[voice % 8] + 36 * Math.floor(voice / 8), 120);
+}
+
+/** Words per ParamInfo row (web-dfam/src/dsp/dfam_params.h) */
+const PARAM_INFO_WORDS = 8;
+
+/**
+ * What the driver needs from each module: where the builds are, how to
+ * init it, and the same adapter hooks as bench/engines/bench_<Plugin>.cpp
+ * (start, notes, filter).
+ */
+const ENGINES = {
+  DFAM: {
+    dir: 'web-dfam/public',
+    base: 'dfam',
+    maxVoices: 1,
+    hasNotes: false,
+
+    init({ wasm, memory }, sampleRate, blockSize) {
+      if (!wasm.init(sampleRate, blockSize)) {
+        throw new Error('sample rate ' + sampleRate + ' is above what dfam.wasm was built for');
+      }
+
+      // Parameter slots by name, from the table in the heap
+      const f32 = new Float32Array(memory.buffer);
+      const i32 = new Int32Array(memory.buffer);
+      const bytes = new Uint8Array(memory.buffer);
+      const base = wasm.getParamTablePtr() >> 2;
+      const slots = {};
+      for (let i = 0; i < wasm.getParamCount(); i++) {
+        const row = base + i * PARAM_INFO_WORDS;
+        let name = '';
+        for (let p = i32[row]; bytes[p] !== 0; p++) name += String.fromCharCode(bytes[p]);
+        slots[name] = i32[row + 6];
+      }
+
+      const block = wasm.getParamBlockPtr() >> 2;
+      this.setParam = (name, value) => { f32[block + slots[name]] = value; };
+    },
+
+    // The sequencer plays the voice (bench_DFAM.cpp: setRunning(true))
+    start() { this.setParam('running', 1); },
+
+    setFilter(cutoffHz, resonance) {
+      this.setParam('filterCutoff', cutoffHz);
+      this.setParam('filterReso', resonance);
+    },
+  },
+
+  AdditiveSquare: {
+    dir: 'synths/AdditiveSquare/ui/public',
+    base: 'synth',
+    maxVoices: 8,  // Engine::MAX_VOICES
+    hasNotes: true,
+
+    init({ wasm }, sampleRate) {
+      wasm.init(sampleRate);
+      this.wasm = wasm;
+    },
+
+    start(voices) { this.playChord(voices, 36); },
+    playChord(voices, lowestNote = 36) {
+      for (let v = 0; v < voices; v++) this.wasm.noteOn(chordNote(v, lowestNote), 0.8);
+    },
+    releaseChord(voices, lowestNote = 36) {
+      for (let v = 0; v < voices; v++) this.wasm.noteOff(chordNote(v, lowestNote));
+    },
+
+    // Engine.h: cutoff is normalised, 20 Hz * 1000^x
+    setFilter(cutoffHz, resonance) {
+      const normalised = Math.log(Math.min(Math.max(cutoffHz, 20), 20000) / 20) / Math.log(1000);
+      this.wasm.setParameter(8, normalised);   // FILTER_CUTOFF
+      this.wasm.setParameter(9, resonance);    // FILTER_RESONANCE
+    },
+  },
+};
+
+//==============================================================================
+// Scenarios (bench/BenchHarness.h runScenario)
+//==============================================================================
+
+const SCENARIOS = ['playing', 'chordStabs', 'resonanceSweep', 'releaseTails'];
+
+/** Nearest-rank q-quantile (0-1) of sorted times */
+function percentile(sorted, q) {
+  if (sorted.length === 0) return 0;
+  const rank = Math.ceil(q * sorted.length);
+  return sorted[Math.min(sorted.length - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+async function runScenario(spec, build, scenario, blockSize, sampleRate, options) {
+  const result = {
+    scenario, blockSize, sampleRate,
+    blocks: 0, p50Us: 0, p99Us: 0, p999Us: 0, maxUs: 0,
+    blockBudgetUs: 1e6 * blockSize / sampleRate, overBudget: 0, nonFinite: 0, realtimeFactor: 0,
+  };
+
+  const usesNotes = scenario === 'chordStabs' || scenario === 'releaseTails';
+  if (usesNotes && !spec.hasNotes) return result;
+
+  // A fresh instance per scenario, as the native bench makes a new engine
+  const module = await loadModule(join(ROOT, spec.dir), spec.base + build.suffix);
+  const engine = Object.create(spec);
+  engine.init(module, sampleRate, blockSize);
+
+  const { wasm, memory } = module;
+  const outL = wasm.malloc(blockSize * 4);
+  const outR = wasm.malloc(blockSize * 4);
+  if (!outL || !outR) throw new Error('malloc failed (is _malloc exported?)');
+
+  const voices = spec.maxVoices;
+  const samples = (seconds) => Math.max(1, Math.round(sampleRate * seconds));
+  const retrigger = samples(0.5);
+  const stab = samples(0.125);
+  const tailPeriod = samples(2.0);
+  const tailNoteLength = samples(0.1);
+  const sweepPeriod = samples(2.0);
+
+  let pos = 0;
+  const crosses = (period, at = 0) => {
+    const phase = pos % period;
+    return phase <= at && at < phase + blockSize;
+  };
+
+  const warmupBlocks = Math.max(1, Math.floor(Math.floor(sampleRate * 0.1) / blockSize));
+  const timedBlocks = Math.max(1, Math.floor(Math.floor(sampleRate * options.seconds) / blockSize));
+  const times = new Float64Array(timedBlocks);
+  let stabs = 0;
+  let heap = new Float32Array(memory.buffer);
+
+  for (let b = 0; b < warmupBlocks + timedBlocks; ++b, pos += blockSize) {
+    // Events first, inside the timing: the worklet does them in the block too
+    const t0 = performance.now();
+    switch (scenario) {
+      case 'playing':
+        if (crosses(retrigger)) engine.start(voices);
+        break;
+
+      case 'chordStabs':
+        if (crosses(stab)) {
+          if (stabs > 0) engine.releaseChord(voices, (stabs - 1) % 2 === 0 ? 36 : 41);
+          engine.playChord(voices, stabs % 2 === 0 ? 36 : 41);
+          ++stabs;
+        }
+        break;
+
+      case 'resonanceSweep': {
+        if (crosses(retrigger)) engine.start(voices);
+        const phase = (pos % sweepPeriod) / sweepPeriod;
+        const triangle = phase < 0.5 ? 2 * phase : 2 - 2 * phase;
+        engine.setFilter(40 * Math.pow(450, triangle), 0.95);
+        break;
+      }
+
+      case 'releaseTails':
+        if (crosses(tailPeriod)) engine.playChord(voices);
+        if (crosses(tailPeriod, tailNoteLength)) engine.releaseChord(voices);
+        break;
+    }
+
+    wasm.process(outL, outR, blockSize);
+    const t1 = performance.now();
+
+    if (b < warmupBlocks) continue;
+    times[b - warmupBlocks] = (t1 - t0) * 1e3;
+
+    if (heap.buffer !== memory.buffer) heap = new Float32Array(memory.buffer);
+    for (let i = 0; i < blockSize; i++) {
+      if (!Number.isFinite(heap[(outL >> 2) + i]) || !Number.isFinite(heap[(outR >> 2) + i])) {
+        ++result.nonFinite;
+      }
+    }
+  }
+
+  const total = times.reduce((a, t) => a + t, 0);
+  times.sort();
+  result.blocks = times.length;
+  result.p50Us = percentile(times, 0.5);
+  result.p99Us = percentile(times, 0.99);
+  result.p999Us = percentile(times, 0.999);
+  result.maxUs = times[times.length - 1];
+  result.overBudget = times.filter((t) => t > result.blockBudgetUs).length;
+  result.realtimeFactor = total > 0 ? (timedBlocks * result.blockBudgetUs) / total : 0;
+  return result;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+const BUILDS = [
+  { name: 'simd', suffix: '.simd' },
+  { name: 'scalar', suffix: '' },
+];
+
+function fixed(value, digits) {
+  return Number(value.toFixed(digits));
+}
+
+async function main() {
+  const options = parseOptions(process.argv.slice(2));
+  const names = options.engines.length > 0 ? options.engines : Object.keys(ENGINES);
+  mkdirSync(options.outDir, { recursive: true });
+
+  for (const name of names) {
+    const spec = ENGINES[name];
+    if (!spec) {
+      console.error('Unknown engine ' + name + ' (have ' + Object.keys(ENGINES).join(', ') + ')');
+      process.exitCode = 1;
+      continue;
+    }
+
+    const builds = [];
+    for (const build of BUILDS) {
+      if (!existsSync(join(ROOT, spec.dir, spec.base + build.suffix + '.wasm'))) {
+        console.log(name + ' ' + build.name + ': no ' + spec.base + build.suffix + '.wasm in ' + spec.dir + ', skipped');
+        continue;
+      }
+
+      const results = [];
+      for (const sampleRate of options.sampleRates) {
+        for (const blockSize of options.blockSizes) {
+          for (const scenario of SCENARIOS) {
+            const r = await runScenario(spec, build, scenario, blockSize, sampleRate, options);
+            if (r.blocks === 0) continue;
+            results.push(r);
+            console.log(
+              `${name} ${build.name.padEnd(6)} ${scenario.padEnd(15)} ${String(blockSize).padStart(4)} @ ${sampleRate}: ` +
+              `p50 ${r.p50Us.toFixed(1)} us, p99.9 ${r.p999Us.toFixed(1)} us, max ${r.maxUs.toFixed(1)} us ` +
+              `(budget ${r.blockBudgetUs.toFixed(0)} us), ${r.realtimeFactor.toFixed(1)}x real time` +
+              (r.nonFinite > 0 ? '  NON-FINITE' : ''));
+          }
+        }
+      }
+      builds.push({
+        build: build.name,
+        results: results.map((r) => ({
+          ...r,
+          p50Us: fixed(r.p50Us, 3), p99Us: fixed(r.p99Us, 3), p999Us: fixed(r.p999Us, 3),
+          maxUs: fixed(r.maxUs, 3), blockBudgetUs: fixed(r.blockBudgetUs, 3),
+          realtimeFactor: fixed(r.realtimeFactor, 2),
+        })),
+      });
+    }
+
+    if (builds.length === 0) continue;
+    const path = join(options.outDir, name + '.wasm.latency.json');
+    writeFileSync(path, JSON.stringify({
+      engine: name,
+      runtime: 'node ' + process.version,
+      maxVoices: spec.maxVoices,
+      secondsPerScenario: options.seconds,
+      builds,
+    }, null, 2) + '\n');
+    console.log('Wrote ' + path);
+  }
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
@@ -0,0 +1,19 @@
+# ============================================================================
+# Gzip one file next to itself: INPUT -> INPUT.gz
+#
+#   cmake -DINPUT=ui/dist/index.html -P core/cmake/GzipFile.cmake
+#
+# The plugins embed their UI this way and inflate it once per process
+# (see core/dsp/UIResourceCache.h).
+# ============================================================================
+
+if(NOT DEFINED INPUT OR NOT EXISTS "${INPUT}")
+    message(FATAL_ERROR "GzipFile.cmake: INPUT '${INPUT}' not found")
+endif()
+
+file(ARCHIVE_CREATE
+    OUTPUT "${INPUT}.gz"
+    PATHS "${INPUT}"
+    FORMAT raw
+    COMPRESSION GZip
+)
@@ -0,0 +1,255 @@
+/**
+ * @file ADEnvelope.h
+ * @brief Attack/decay envelope for percussive voices, exponential or linear
+ *
+ * The curve is a template argument, so each engine keeps the one it was
+ * voiced with:
+ *
+ *   Exponential  One-pole: the attack closes 1 - e^(-4/samples) of the gap
+ *                to 1 each sample (no click at the onset, within 2% after
+ *                the attack time), the decay multiplies by e^(-4/samples).
+ *                The stages end at 0.999 and 0.001. DFAM.
+ *   Linear       Ramps at 1/samples up, then down, ending exactly at 1
+ *                and 0. Subharmonicon.
+ *
+ * trigger() starts the attack from the current level, so a retrigger
+ * mid-decay doesn't click. advance(n) skips n samples for control-rate
+ * modulators: the exponential attack (a few ms at most) is stepped per
+ * sample and its decay is one multiply per control block
+ * (setControlBlock()); the linear ramps land in closed form.
+ *
+ *   ADEnvelope env;              // Or LinearADEnvelope
+ *   env.setSampleRate(sampleRate);
+ *   env.setAD(0.001f, 0.5f);     // Seconds
+ *   env.trigger();
+ *   level = env.process();       // Or env.advance(n) per control block
+ *
+ * Engines that change a decay per step of a sequence work its
+ * coefficients out ahead of time with decayFor() and hand them over with
+ * setDecay(const Decay&), without the exp and pow.
+ *
+ * Header-only and free of sst, like LFO.h and PolyBlepOscillator.h, so
+ * the web builds share it too.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+enum class ADCurve
+{
+    Exponential,
+    Linear
+};
+
+template <ADCurve Curve>
+class BasicADEnvelope
+{
+public:
+    enum class Stage { Idle, Attack, Decay };
+
+    void setSampleRate(double sr)
+    {
+        sampleRate = sr;
+        updateCoefficients();
+    }
+
+    void setAttack(float seconds)
+    {
+        attackTime = std::max(MIN_TIME, seconds);
+        updateCoefficients();
+    }
+
+    void setDecay(float seconds)
+    {
+        decayTime = std::max(MIN_TIME, seconds);
+        updateCoefficients();
+    }
+
+    void setAD(float attackSeconds, float decaySeconds)
+    {
+        attackTime = std::max(MIN_TIME, attackSeconds);
+        decayTime = std::max(MIN_TIME, decaySeconds);
+        updateCoefficients();
+    }
+
+    /** A decay time with its coefficients, worked out ahead of time by decayFor() */
+    struct Decay
+    {
+        float time = 0.5f;
+        float coef = 0.9999f;        // Per sample: a multiplier, or the linear step
+        float blockCoef = 0.9968f;   // coef^controlBlock (exponential only)
+    };
+
+    /** The coefficients setDecay(seconds) would derive, at the current rate and control block */
+    Decay decayFor(float seconds) const
+    {
+        Decay d;
+        d.time = std::max(MIN_TIME, seconds);
+        const float decaySamples = d.time * static_cast<float>(sampleRate);
+        if constexpr (Curve == ADCurve::Exponential)
+        {
+            d.coef = std::exp(-4.0f / decaySamples);  // ~2% remaining after the decay time
+            d.blockCoef = std::pow(d.coef, static_cast<float>(controlBlock));
+        }
+        else
+        {
+            d.coef = 1.0f / std::max(0.001f, decaySamples);
+            d.blockCoef = d.coef * static_cast<float>(controlBlock);
+        }
+        return d;
+    }
+
+    /** setDecay() without the exp and pow */
+    void setDecay(const Decay& d)
+    {
+        decayTime = d.time;
+        decayCoef = d.coef;
+        decayBlockCoef = d.blockCoef;
+    }
+
+    void trigger()
+    {
+        stage = Stage::Attack;
+        // From the current level, so a retrigger doesn't click; a tail
+        // below the exponential's threshold starts from zero
+        if constexpr (Curve == ADCurve::Exponential)
+            if (level < 0.001f)
+                level = 0.0f;
+    }
+
+    void reset()
+    {
+        stage = Stage::Idle;
+        level = 0.0f;
+    }
+
+    float process()
+    {
+        switch (stage)
+        {
+            case Stage::Attack:
+                if constexpr (Curve == ADCurve::Exponential)
+                    level += attackCoef * (1.0f - level);
+                else
+                    level += attackCoef;
+                if (level >= ATTACK_END)
+                {
+                    level = 1.0f;
+                    stage = Stage::Decay;
+                }
+                break;
+
+            case Stage::Decay:
+                if constexpr (Curve == ADCurve::Exponential)
+                    level *= decayCoef;
+                else
+                    level -= decayCoef;
+                if (level <= DECAY_END)
+                {
+                    level = 0.0f;
+                    stage = Stage::Idle;
+                }
+                break;
+
+            case Stage::Idle:
+            default:
+                break;
+        }
+
+        return level;
+    }
+
+    /**
+     * @brief Skip n samples ahead (control rate)
+     * @return Level after the n samples
+     */
+    float advance(int n)
+    {
+        if constexpr (Curve == ADCurve::Exponential)
+        {
+            for (; n > 0 && stage == Stage::Attack; --n)
+                process();
+
+            if (n > 0 && stage == Stage::Decay)
+            {
+                level *= n == controlBlock ? decayBlockCoef : std::pow(decayCoef, static_cast<float>(n));
+                if (level <= DECAY_END)
+                {
+                    level = 0.0f;
+                    stage = Stage::Idle;
+                }
+            }
+        }
+        else
+        {
+            // As n process() calls would leave it
+            while (n > 0 && stage != Stage::Idle)
+            {
+                if (stage == Stage::Attack)
+                    n -= finishRamp(n, attackCoef, 1.0f, Stage::Decay);
+                else
+                    n -= finishRamp(n, -decayCoef, 0.0f, Stage::Idle);
+            }
+        }
+
+        return level;
+    }
+
+    bool isActive() const { return stage != Stage::Idle; }
+    float getLevel() const { return level; }
+    Stage getStage() const { return stage; }
+
+    /** Samples advance() is usually called for (the voice's control block) */
+    void setControlBlock(int n)
+    {
+        controlBlock = n;
+        updateCoefficients();
+    }
+
+private:
+    // The exponential never reaches 1 or 0, so it stops just short
+    static constexpr float MIN_TIME = Curve == ADCurve::Exponential ? 0.001f : 0.0f;
+    static constexpr float ATTACK_END = Curve == ADCurve::Exponential ? 0.999f : 1.0f;
+    static constexpr float DECAY_END = Curve == ADCurve::Exponential ? 0.001f : 0.0f;
+
+    void updateCoefficients()
+    {
+        const float attackSamples = attackTime * static_cast<float>(sampleRate);
+        if constexpr (Curve == ADCurve::Exponential)
+            attackCoef = 1.0f - std::exp(-4.0f / attackSamples);  // ~98% in the attack time
+        else
+            attackCoef = 1.0f / std::max(0.001f, attackSamples);  // A zero time is one step
+
+        setDecay(decayFor(decayTime));
+    }
+
+    /** Step the linear ramp up to n samples towards end; returns the samples used */
+    int finishRamp(int n, float rate, float end, Stage next)
+    {
+        const int steps = std::max(1, static_cast<int>(std::ceil((end - level) / rate)));
+        if (steps > n)
+        {
+            level += rate * static_cast<float>(n);
+            return n;
+        }
+
+        level = end;
+        stage = next;
+        return steps;
+    }
+
+    double sampleRate = 44100.0;
+    float attackTime = 0.01f;
+    float decayTime = 0.5f;
+    float attackCoef = 0.001f;
+    float decayCoef = 0.9999f;
+    float decayBlockCoef = 0.9968f;  // decayCoef^controlBlock, for advance()
+    int controlBlock = 32;  // ControlRamp::BLOCK_SIZE, until setControlBlock()
+    float level = 0.0f;
+    Stage stage = Stage::Idle;
+};
+
+using ADEnvelope = BasicADEnvelope<ADCurve::Exponential>;
+using LinearADEnvelope = BasicADEnvelope<ADCurve::Linear>;
@@ -0,0 +1,291 @@
+/**
+ * @file ADSREnvelope.h
+ * @brief Analog-style ADSR: exponential segments, stage ends planned as sample counts
+ *
+ * Each stage is an RC charge towards a target past its end: attack aims
+ * above 1 so it arrives at full level on a rounded curve, decay and
+ * release aim just below sustain / zero so they land in finite time.
+ * Per sample that is one multiply-add, level = level * coeff + offset.
+ *
+ * The samples a stage will take are worked out in closed form when it
+ * starts (and again if its time or the sustain level moves), so nothing
+ * is compared per sample: render() runs the recurrence for the rest of the
+ * segment in a tight loop, then lands on the stage's end and plans the
+ * next one. advance() jumps n samples in closed form, for control-rate
+ * modulators. Coefficients are worked out in the setters, and only for
+ * the time that changed.
+ *
+ * Times are the full-scale stage lengths: attack from 0 to 1, decay from 1
+ * to a sustain of 0, release from 1 to 0. Shorter swings take less time,
+ * as on an analog envelope.
+ *
+ *   ADSREnvelope env;
+ *   env.setSampleRate(sampleRate);
+ *   env.setADSR(0.01f, 0.1f, 0.7f, 0.3f);   // Seconds, level, seconds
+ *   env.trigger();                          // From the current level
+ *   env.render(levels, n);                  // Or process() per sample
+ *
+ * Renderers that run several envelopes side by side (one per SIMD lane)
+ * read the current segment (getSegmentSamples(), getCoefficient(),
+ * getOffset()), run the shortest segment's samples of the recurrence for
+ * every lane at once, hand each lane its level back with skip(), and take
+ * the sample that ends a segment with process().
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "SilenceGate.h"
+
+class ADSREnvelope
+{
+public:
+    enum class Stage { Idle, Attack, Decay, Sustain, Release };
+
+    /** How far past 1 the attack aims (a fraction of full scale) */
+    static constexpr float ATTACK_OVERSHOOT = 0.2231302f;     // e^-1.5
+    /** How far below its end decay and release aim */
+    static constexpr float DECAY_UNDERSHOOT = 0.007083408f;  // e^-4.95
+
+    void setSampleRate(float sr)
+    {
+        sampleRate = sr;
+        attackCoeff = coefficient(ATTACK_OVERSHOOT, attackTime);
+        decayCoeff = coefficient(DECAY_UNDERSHOOT, decayTime);
+        releaseCoeff = coefficient(DECAY_UNDERSHOOT, releaseTime);
+        plan();
+    }
+
+    void setADSR(float a, float d, float s, float r)
+    {
+        setAttack(a);
+        setDecay(d);
+        setSustain(s);
+        setRelease(r);
+    }
+
+    void setAttack(float seconds) { setTime(attackTime, attackCoeff, seconds, ATTACK_OVERSHOOT, Stage::Attack); }
+    void setDecay(float seconds) { setTime(decayTime, decayCoeff, seconds, DECAY_UNDERSHOOT, Stage::Decay); }
+    void setRelease(float seconds) { setTime(releaseTime, releaseCoeff, seconds, DECAY_UNDERSHOOT, Stage::Release); }
+
+    void setSustain(float s)
+    {
+        s = std::clamp(s, 0.0f, 1.0f);
+        if (s == sustainLevel)
+            return;
+        sustainLevel = s;
+        if (stage == Stage::Sustain)
+            level = sustainLevel;
+        if (stage == Stage::Decay || stage == Stage::Sustain)
+            plan();
+    }
+
+    /** Attack from the current level (legato retriggers don't click) */
+    void trigger() { enter(Stage::Attack); }
+
+    void release()
+    {
+        if (stage != Stage::Idle)
+            enter(Stage::Release);
+    }
+
+    void reset()
+    {
+        level = 0.0f;
+        enter(Stage::Idle);
+    }
+
+    float process()
+    {
+        if (remaining > 0)
+        {
+            --remaining;
+            level = level * coeff + offset;
+            return level;
+        }
+        return finishSegment();
+    }
+
+    /** The next n levels into out */
+    void render(float* out, int n)
+    {
+        int i = 0;
+        while (i < n)
+        {
+            const int run = std::min(n - i, remaining);
+            float x = level;
+            for (int k = 0; k < run; ++k)
+            {
+                x = x * coeff + offset;
+                out[i + k] = x;
+            }
+            level = x;
+            remaining -= run;
+            i += run;
+
+            if (i < n)
+                out[i++] = finishSegment();
+        }
+    }
+
+    /**
+     * @brief Skip n samples ahead (control rate)
+     * @return Level after the n samples, as n process() calls would leave it
+     */
+    float advance(int n)
+    {
+        while (n > remaining)
+        {
+            level = target + (level - target) * power(remaining);
+            n -= remaining + 1;
+            remaining = 0;
+            finishSegment();
+        }
+
+        level = target + (level - target) * power(n);
+        remaining -= n;
+        return level;
+    }
+
+    /** Recurrence samples left before the sample that ends this segment */
+    int getSegmentSamples() const { return remaining; }
+    float getCoefficient() const { return coeff; }
+    float getOffset() const { return offset; }
+
+    /** n samples of the recurrence were run elsewhere, ending at newLevel */
+    void skip(int n, float newLevel)
+    {
+        remaining -= n;
+        level = newLevel;
+    }
+
+    bool isActive() const { return stage != Stage::Idle; }
+
+    /** Held at a sustain level below -120 dB: silent until released or retriggered */
+    bool isSilent() const { return stage == Stage::Sustain && sustainLevel < Silence::THRESHOLD; }
+
+    float getLevel() const { return level; }
+    Stage getStage() const { return stage; }
+
+private:
+    /** Per-sample coefficient for a charge from 0 to 1 + overshoot over seconds to reach 1 */
+    float coefficient(float overshoot, float seconds) const
+    {
+        const float samples = std::max(1.0f, seconds * sampleRate);
+        return std::exp(-std::log((1.0f + overshoot) / overshoot) / samples);
+    }
+
+    void setTime(float& time, float& c, float seconds, float overshoot, Stage s)
+    {
+        if (seconds == time)
+            return;
+        time = seconds;
+        c = coefficient(overshoot, seconds);
+        if (stage == s)
+            plan();
+    }
+
+    void enter(Stage s)
+    {
+        stage = s;
+        plan();
+    }
+
+    /** The current stage's curve from the current level, and the samples until it ends */
+    void plan()
+    {
+        switch (stage)
+        {
+            case Stage::Attack:
+                startSegment(attackCoeff, 1.0f + ATTACK_OVERSHOOT, 1.0f);
+                break;
+            case Stage::Decay:
+                startSegment(decayCoeff, sustainLevel - DECAY_UNDERSHOOT, sustainLevel);
+                break;
+            case Stage::Release:
+                startSegment(releaseCoeff, -DECAY_UNDERSHOOT, 0.0f);
+                break;
+            case Stage::Sustain:
+            case Stage::Idle:
+                hold();
+                break;
+        }
+    }
+
+    void startSegment(float c, float aim, float end)
+    {
+        coeff = c;
+        target = aim;
+        offset = aim * (1.0f - c);
+        segmentEnd = end;
+
+        // level_k = aim + (level - aim) c^k: the first k that reaches end
+        // ends the segment. A level already there ends it on the next sample.
+        const float ratio = (end - aim) / (level - aim);
+        int steps = 1;
+        if (ratio > 0.0f && ratio < 1.0f)
+            steps = static_cast<int>(std::min(std::ceil(std::log(ratio) / std::log(c)), static_cast<float>(INT_MAX / 2)));
+        remaining = std::max(1, steps) - 1;
+    }
+
+    /** Sustain and idle: the level stands still */
+    void hold()
+    {
+        coeff = 1.0f;
+        offset = 0.0f;
+        target = segmentEnd = level;
+        remaining = INT_MAX;
+    }
+
+    /** The sample that ends a segment: land exactly on its end and start the next stage */
+    float finishSegment()
+    {
+        level = segmentEnd;
+        switch (stage)
+        {
+            case Stage::Attack: enter(Stage::Decay); break;
+            case Stage::Decay: enter(Stage::Sustain); break;
+            case Stage::Release: enter(Stage::Idle); break;
+            case Stage::Sustain:
+            case Stage::Idle: hold(); break;
+        }
+        return level;
+    }
+
+    /** coeff^n, cached: control-rate steps repeat the same n */
+    float power(int n)
+    {
+        if (n != powerSamples || coeff != powerCoeff)
+        {
+            powerSamples = n;
+            powerCoeff = coeff;
+            powerValue = std::pow(coeff, static_cast<float>(n));
+        }
+        return powerValue;
+    }
+
+    float sampleRate = 44100.0f;
+    float attackTime = 0.01f;
+    float decayTime = 0.1f;
+    float sustainLevel = 0.7f;
+    float releaseTime = 0.3f;
+    float attackCoeff = coefficient(ATTACK_OVERSHOOT, 0.01f);
+    float decayCoeff = coefficient(DECAY_UNDERSHOOT, 0.1f);
+    float releaseCoeff = coefficient(DECAY_UNDERSHOOT, 0.3f);
+
+    // The segment being run
+    Stage stage = Stage::Idle;
+    float level = 0.0f;
+    float coeff = 1.0f;
+    float offset = 0.0f;
+    float target = 0.0f;
+    float segmentEnd = 0.0f;
+    int remaining = INT_MAX;
+
+    int powerSamples = 0;
+    float powerCoeff = 1.0f;
+    float powerValue = 1.0f;
+};
@@ -0,0 +1,105 @@
+/**
+ * @file ActiveVoiceList.h
+ * @brief The indices of an engine's sounding voices, packed
+ *
+ * Engines render, release and count only the voices on the list, so an
+ * instance playing one note walks one voice, not the pool, and never calls
+ * isActive() on an idle voice. A voice goes on the list at note on and
+ * comes off when the renderer sees it finish, or when everything is
+ * killed. Each voice's place in the list is kept, so add() and remove()
+ * are constant time; removing swaps the last entry in, so the order is
+ * arbitrary.
+ *
+ *   voices[v].noteOn(note, velocity);
+ *   active.add(v);                          // Already listed (stolen): no-op
+ *
+ *   for (int v : active)                    // Note off, parameter updates
+ *       ...
+ *
+ *   active.update([&](int v)                // Render; drop voices that finished
+ *   {
+ *       voices[v].render(mixL, mixR, numSamples);
+ *       return voices[v].isActive();
+ *   });
+ *
+ * @note Audio thread only - fixed capacity, no allocations
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+template <int MAX_VOICES>
+class ActiveVoiceList
+{
+public:
+    static_assert(MAX_VOICES > 0 && MAX_VOICES <= 127, "indices are stored in a byte");
+
+    ActiveVoiceList() { position.fill(NONE); }
+
+    /** Put voice v on the list (no-op if it's there) */
+    void add(int v)
+    {
+        if (position[v] != NONE)
+            return;
+        position[v] = static_cast<int8_t>(count);
+        voices[count++] = static_cast<uint8_t>(v);
+    }
+
+    /** Take voice v off the list (no-op if it isn't there) */
+    void remove(int v)
+    {
+        if (position[v] != NONE)
+            removeAt(position[v]);
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < count; ++i)
+            position[voices[i]] = NONE;
+        count = 0;
+    }
+
+    /**
+     * @brief Call fn(v) for each listed voice, dropping those it returns false for
+     *
+     * fn mustn't add or remove voices itself.
+     */
+    template <typename Fn>
+    void update(Fn&& fn)
+    {
+        for (int i = 0; i < count;)
+        {
+            if (fn(static_cast<int>(voices[i])))
+                ++i;
+            else
+                removeAt(i);
+        }
+    }
+
+    bool contains(int v) const { return position[v] != NONE; }
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == MAX_VOICES; }
+
+    int operator[](int i) const { return voices[i]; }
+    const uint8_t* begin() const { return voices.data(); }
+    const uint8_t* end() const { return voices.data() + count; }
+
+private:
+    static constexpr int8_t NONE = -1;
+
+    void removeAt(int i)
+    {
+        const int v = voices[i];
+        const int last = voices[--count];
+        voices[i] = static_cast<uint8_t>(last);
+        position[last] = static_cast<int8_t>(i);
+        position[v] = NONE;
+    }
+
+    std::array<uint8_t, MAX_VOICES> voices{};  // Listed voices, packed
+    std::array<int8_t, MAX_VOICES> position{};  // Index in voices, or NONE
+    int count = 0;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file AnalogDrift.h
+ * @brief Slow random pitch wander, stepped once per control block
+ *
+ * An analog oscillator never quite holds its pitch: it wanders by a few
+ * cents over seconds, and every voice wanders its own way, so a chord
+ * beats and breathes. sst-basic-blocks' DriftLFO models that as white
+ * noise through a one-pole lowpass with a time constant of seconds, scaled
+ * back up by 1/sqrt(coefficient) so its spread doesn't depend on the
+ * filter. It steps every sample and draws from rand(); at a pole that slow
+ * nothing changes between samples, so AnalogDrift steps once per control
+ * block, the coefficient scaled by the block's length, and draws from a
+ * seeded NoiseSource. The caller ramps the result across the block, as it
+ * would an LFO.
+ *
+ *   drift.prepare(sampleRate);
+ *   drift.reseed(NoiseSource::deriveSeed(seed, voiceIndex));  // Each its own path
+ *   const float wander = drift.advance(n);                    // Per control block
+ *   pitchSemitones += wander * amount;
+ *
+ * advance() returns a wander with a standard deviation of about 0.4,
+ * peaks rarely past 1. The sample rate sets the coefficient, so the
+ * drift's speed is the same at every rate.
+ *
+ * @note No allocation: real-time safe once constructed.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "Noise.h"
+
+class AnalogDrift
+{
+public:
+    /** Time constant of the wander */
+    static constexpr float SECONDS = 2.0f;
+
+    explicit AnalogDrift(uint32_t seed = 0x0D21F7u) : noise(seed) {}
+
+    void prepare(double sampleRate)
+    {
+        perSample = 1.0f / (SECONDS * static_cast<float>(sampleRate));
+        cachedSamples = 0;
+    }
+
+    /** Restart the wander from the centre; the same seed always takes the same path */
+    void reseed(uint32_t seed)
+    {
+        noise.reseed(seed);
+        level = 0.0f;
+    }
+
+    /**
+     * @brief Step the wander over the next n samples
+     * @return Its value at the end of them
+     */
+    float advance(int n)
+    {
+        // Control blocks repeat the same n: keep its coefficient and gain
+        if (n != cachedSamples)
+        {
+            cachedSamples = n;
+            coefficient = std::fmin(perSample * static_cast<float>(n), 1.0f);
+            gain = 1.0f / std::sqrt(coefficient);
+        }
+
+        level += (noise.unifPM1() - level) * coefficient;
+        return level * gain;
+    }
+
+private:
+    NoiseSource noise;
+    float perSample = 1.0f / (SECONDS * 44100.0f);
+    float level = 0.0f;
+    float coefficient = 0.0f;
+    float gain = 0.0f;
+    int cachedSamples = 0;
+};
@@ -0,0 +1,64 @@
+/**
+ * @file Arena.h
+ * @brief Bump allocator over a caller-owned float region, for delay lines
+ *
+ * An engine works out how many floats it needs at a sample rate
+ * (memoryNeeded(), constexpr so a build can size a static region from it),
+ * then takes every buffer from one arena in prepare(). Nothing is freed
+ * piecemeal: the region lives as long as the engine. dfam.wasm carves the
+ * arena out of static memory, so init can't fail on a short heap halfway
+ * through and INITIAL_MEMORY is known at link time.
+ *
+ * A region that's known to be zero (fresh static or just-assigned memory)
+ * can say so, and take() then skips the fill: the first init doesn't
+ * write, and so doesn't fault in, megabytes of delay line nobody has
+ * touched yet. Re-preparing over a used region clears what it takes.
+ *
+ *   static float region[SynthEngine::memoryNeeded(96000.0)];
+ *   Arena arena(region, std::size(region));
+ *   if (!engine.prepare(sr, blockSize, arena)) ...   // sr too high
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+class Arena {
+public:
+    // Buffers start on 16-byte boundaries if the region does (SIMD loads)
+    static constexpr size_t ALIGN_FLOATS = 4;
+
+    static constexpr size_t aligned(size_t floats) {
+        return (floats + ALIGN_FLOATS - 1) / ALIGN_FLOATS * ALIGN_FLOATS;
+    }
+
+    Arena() = default;
+    Arena(float* base, size_t capacity, bool regionIsZero = false)
+        : base(base), capacity(capacity), regionIsZero(regionIsZero) {}
+
+    // n zeroed floats, or null when the region is exhausted
+    float* take(size_t n) {
+        const size_t size = aligned(n);
+        if (!base || size > capacity - used) return nullptr;
+        float* p = base + used;
+        used += size;
+        if (!regionIsZero) std::fill(p, p + n, 0.0f);
+        return p;
+    }
+
+    // n zeroed samples of T (SampleStorage.h's 16-bit types), in whole floats
+    template <typename T>
+    T* takeSamples(size_t n) {
+        return reinterpret_cast<T*>(take((n * sizeof(T) + sizeof(float) - 1) / sizeof(float)));
+    }
+
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    float* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    bool regionIsZero = false;
+};
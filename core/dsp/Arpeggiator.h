@@ -0,0 +1,451 @@
+/**
+ * @file Arpeggiator.h
+ * @brief Chord memory and an arpeggiator that sit in the engine, ahead of voice allocation
+ *
+ * An arp driven from the host or the UI lands its notes wherever the MIDI
+ * (or the postMessage) does. Inside the engine it steps on a StepClock, so
+ * each generated note starts on its sample and nothing crosses threads:
+ *
+ *   // noteOn() / noteOff() from the host go to the arp, not the voices
+ *   arp.noteOn(key, velocity);
+ *
+ *   // renderBlock, between queued events: split at every step and gate end
+ *   for (int i = 0; i < numSamples;)
+ *   {
+ *       const int n = arp.next(numSamples - i, [&](int note, float velocity) {
+ *           velocity > 0.0f ? startVoice(note, velocity) : releaseVoice(note);
+ *       });
+ *       renderVoices(outL + i, outR + i, n);
+ *       i += n;
+ *   }
+ *
+ * ChordMemory turns one key into a chord: a fixed shape (major, minor7...)
+ * or one learned with memorize(). With the arp off the engine plays the
+ * chord directly; with it on, the arp steps through the chords of every
+ * held key. ChordMemory remembers which notes each key started, so a shape
+ * change while keys are down still releases the right ones.
+ *
+ * Free running, the first key plays at once and the steps follow from it.
+ * Following a host, syncTo() at the top of each block lines the steps up
+ * with its beat position and a new key waits for the next step.
+ *
+ * @note Audio thread only - fixed capacity, no allocations
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "StepClock.h"
+
+class ChordMemory
+{
+public:
+    /** Most notes one key plays */
+    static constexpr int MAX_NOTES = 6;
+
+    /** Off plays the key alone; Memory the chord last given to memorize() */
+    enum class Shape { Off, Major, Minor, Sus4, Major7, Minor7, Fifths, Memory };
+
+    void setShape(Shape s) { shape = s; }
+    Shape getShape() const { return shape; }
+
+    /** Learn a chord from its notes, in any order; its lowest note plays on the key */
+    void memorize(const int* notes, int count)
+    {
+        std::array<int, MAX_NOTES> sorted{};
+        const int n = std::clamp(count, 0, MAX_NOTES);
+        std::copy(notes, notes + n, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + n);
+
+        memory = {{0}, 1};
+        for (int i = 1; i < n; ++i)
+        {
+            const int interval = sorted[static_cast<size_t>(i)] - sorted[0];
+            if (interval > memory.steps[static_cast<size_t>(memory.size - 1)])
+                memory.steps[static_cast<size_t>(memory.size++)] = interval;
+        }
+    }
+
+    /**
+     * @brief The notes a key plays: the key and the shape above it
+     * @param out At least MAX_NOTES notes, each within 0-127
+     * @return How many
+     */
+    int expand(int key, int* out) const
+    {
+        const Intervals& chord = shape == Shape::Memory ? memory : SHAPES[static_cast<size_t>(shape)];
+        int count = 0;
+        for (int i = 0; i < chord.size; ++i)
+        {
+            const int note = key + chord.steps[static_cast<size_t>(i)];
+            if (note >= 0 && note < 128)
+                out[count++] = note;
+        }
+        return count;
+    }
+
+    /** Play a key: start(note) for each note of its chord */
+    template <typename StartFn>
+    void noteOn(int key, StartFn&& start)
+    {
+        if (key < 0 || key >= 128)
+            return;
+
+        Held& h = held[static_cast<size_t>(key)];
+        std::array<int, MAX_NOTES> notes{};
+        h.count = expand(key, notes.data());
+        for (int i = 0; i < h.count; ++i)
+        {
+            h.notes[static_cast<size_t>(i)] = static_cast<uint8_t>(notes[static_cast<size_t>(i)]);
+            start(notes[static_cast<size_t>(i)]);
+        }
+    }
+
+    /** Let a key go: release(note) for each note its noteOn() started */
+    template <typename ReleaseFn>
+    void noteOff(int key, ReleaseFn&& release)
+    {
+        if (key < 0 || key >= 128)
+            return;
+
+        Held& h = held[static_cast<size_t>(key)];
+        for (int i = 0; i < h.count; ++i)
+            release(static_cast<int>(h.notes[static_cast<size_t>(i)]));
+        h.count = 0;
+    }
+
+    /** Let every held key go */
+    template <typename ReleaseFn>
+    void releaseAll(ReleaseFn&& release)
+    {
+        for (int key = 0; key < 128; ++key)
+        {
+            if (held[static_cast<size_t>(key)].count > 0)
+                noteOff(key, release);
+        }
+    }
+
+    /** Forget the held keys (their voices were stopped elsewhere) */
+    void reset()
+    {
+        for (auto& h : held)
+            h.count = 0;
+    }
+
+private:
+    struct Intervals
+    {
+        std::array<int, MAX_NOTES> steps;
+        int size;
+    };
+
+    // Semitones above the key, per Shape up to Memory
+    static constexpr std::array<Intervals, 7> SHAPES{{
+        {{0}, 1},
+        {{0, 4, 7}, 3},
+        {{0, 3, 7}, 3},
+        {{0, 5, 7}, 3},
+        {{0, 4, 7, 11}, 4},
+        {{0, 3, 7, 10}, 4},
+        {{0, 7, 12}, 3},
+    }};
+
+    struct Held
+    {
+        std::array<uint8_t, MAX_NOTES> notes{};
+        int count = 0;
+    };
+
+    Shape shape = Shape::Off;
+    Intervals memory{{0}, 1};
+    std::array<Held, 128> held{};
+};
+
+class Arpeggiator
+{
+public:
+    enum class Mode { Up, Down, UpDown, AsPlayed, Random };
+
+    static constexpr int MAX_KEYS = 16;
+    static constexpr int MAX_OCTAVES = 4;
+
+    /** Every note of every held key's chord over every octave */
+    static constexpr int MAX_PATTERN = MAX_KEYS * ChordMemory::MAX_NOTES * MAX_OCTAVES;
+
+    /** Step lengths follow from this and the tempo */
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        updateRate();
+        reset();
+    }
+
+    /** Expand keys through @p chords (nullptr: each key plays alone) */
+    void setChordMemory(const ChordMemory* chords)
+    {
+        chordMemory = chords;
+        rebuild();
+    }
+
+    /** Re-read the chord memory after its shape changed */
+    void chordChanged() { rebuild(); }
+
+    void setMode(Mode m)
+    {
+        mode = m;
+        rebuild();
+    }
+
+    /** Octaves the pattern climbs (1 to MAX_OCTAVES) */
+    void setOctaves(int count)
+    {
+        octaves = std::clamp(count, 1, MAX_OCTAVES);
+        rebuild();
+    }
+
+    void setTempo(double bpm)
+    {
+        tempo = std::clamp(bpm, 20.0, 300.0);
+        updateRate();
+    }
+
+    /** Steps per beat: 1 quarters, 2 eighths, 3 eighth triplets, 4 sixteenths... */
+    void setStepsPerBeat(double steps)
+    {
+        stepsPerBeat = std::max(0.25, steps);
+        updateRate();
+    }
+
+    /** Note length as a fraction of the step (0.01 to 1) */
+    void setGate(float fraction) { gate = std::clamp(fraction, 0.01f, 1.0f); }
+
+    /** Follow the host: its position in beats at the next sample, at the top of each block */
+    void syncTo(double beats)
+    {
+        following = true;
+        clock.syncTo(beats * stepsPerBeat);
+    }
+
+    /** Stop following the host: the next first key starts the steps again */
+    void freeRun() { following = false; }
+
+    /** A key goes down (or changes velocity, if it's held already) */
+    void noteOn(int key, float velocity)
+    {
+        if (key < 0 || key >= 128)
+            return;
+
+        for (int k = 0; k < numKeys; ++k)
+        {
+            if (keys[static_cast<size_t>(k)] == key)
+            {
+                velocities[static_cast<size_t>(k)] = velocity;
+                rebuild();
+                return;
+            }
+        }
+        if (numKeys == MAX_KEYS)
+            return;
+
+        // Free running, the first key plays on its own sample
+        if (numKeys == 0)
+        {
+            position = 0;
+            if (!following)
+                clock.syncTo(0.0);
+        }
+
+        keys[static_cast<size_t>(numKeys)] = key;
+        velocities[static_cast<size_t>(numKeys++)] = velocity;
+        rebuild();
+    }
+
+    /** A key comes up; with none left the sounding note is released through note(n, 0) */
+    template <typename NoteFn>
+    void noteOff(int key, NoteFn&& note)
+    {
+        const auto end = keys.begin() + numKeys;
+        const auto it = std::find(keys.begin(), end, key);
+        if (it == end)
+            return;
+
+        const auto k = it - keys.begin();
+        std::move(it + 1, end, it);
+        std::move(velocities.begin() + k + 1, velocities.begin() + numKeys, velocities.begin() + k);
+        --numKeys;
+        rebuild();
+
+        if (numKeys == 0)
+            stop(note);
+    }
+
+    /** Release the sounding note and forget the keys */
+    template <typename NoteFn>
+    void stop(NoteFn&& note)
+    {
+        release(note);
+        numKeys = 0;
+        length = 0;
+        position = 0;
+    }
+
+    /** Forget everything, sounding note included (its voice was stopped elsewhere) */
+    void reset()
+    {
+        playing = -1;
+        numKeys = 0;
+        length = 0;
+        position = 0;
+    }
+
+    /** True while keys are held or a note still sounds */
+    bool isRunning() const { return length > 0 || playing >= 0; }
+
+    /** The note it's playing, or -1 */
+    int getPlayingNote() const { return playing; }
+
+    /** Notes in one pass of the pattern (before UpDown turns round) */
+    int getPatternLength() const { return length; }
+
+    /**
+     * @brief Take the next run of up to maxSamples samples
+     * @param note Called as note(n, velocity) for a step's note, note(n, 0) at its gate end;
+     *             both only ever at the run's first sample
+     * @return Run length (1 to maxSamples); maxSamples when idle
+     */
+    template <typename NoteFn>
+    int next(int maxSamples, NoteFn&& note)
+    {
+        if (!isRunning())
+            return maxSamples;
+
+        // A step ends the last note's gate before it starts its own
+        const bool stepping = clock.isStepNext();
+        if (playing >= 0 && (stepping || gateLeft <= 0))
+            release(note);
+        if (stepping && length > 0)
+            step(note);
+
+        int n = std::min(maxSamples, clock.nextRunLength());
+        if (playing >= 0)
+            n = std::min(n, gateLeft);
+
+        clock.advance(n);
+        gateLeft -= n;
+        return n;
+    }
+
+private:
+    struct Step
+    {
+        int note;
+        float velocity;
+    };
+
+    void updateRate() { clock.setSamplesPerStep(sampleRate * 60.0 / (tempo * stepsPerBeat)); }
+
+    template <typename NoteFn>
+    void release(NoteFn&& note)
+    {
+        if (playing >= 0)
+            note(playing, 0.0f);
+        playing = -1;
+    }
+
+    template <typename NoteFn>
+    void step(NoteFn&& note)
+    {
+        const Step& s = pattern[static_cast<size_t>(patternIndex())];
+        ++position;
+        playing = s.note;
+        gateLeft = std::max(1, static_cast<int>(std::ceil(gate * clock.getSamplesPerStep())));
+        note(s.note, s.velocity);
+    }
+
+    int patternIndex()
+    {
+        switch (mode)
+        {
+        case Mode::Down: return length - 1 - static_cast<int>(position % length);
+        case Mode::UpDown:
+        {
+            if (length < 2)
+                return 0;
+            const int64_t cycle = 2 * length - 2;  // The ends play once per cycle
+            const int i = static_cast<int>(position % cycle);
+            return i < length ? i : static_cast<int>(cycle) - i;
+        }
+        case Mode::Random:
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return static_cast<int>(random % static_cast<uint32_t>(length));
+        default: return static_cast<int>(position % length);
+        }
+    }
+
+    /** Lay out the held keys' chords over the octaves; runs on key and setting changes */
+    void rebuild()
+    {
+        // One octave, in played order
+        std::array<Step, MAX_KEYS * ChordMemory::MAX_NOTES> octave{};
+        int count = 0;
+        for (int k = 0; k < numKeys; ++k)
+        {
+            std::array<int, ChordMemory::MAX_NOTES> chord{};
+            int size = 1;
+            chord[0] = keys[static_cast<size_t>(k)];
+            if (chordMemory != nullptr)
+                size = chordMemory->expand(keys[static_cast<size_t>(k)], chord.data());
+            for (int i = 0; i < size; ++i)
+                octave[static_cast<size_t>(count++)] = {chord[static_cast<size_t>(i)], velocities[static_cast<size_t>(k)]};
+        }
+
+        // Sorted by pitch with each note once, except as played
+        if (mode != Mode::AsPlayed)
+        {
+            const auto end = octave.begin() + count;
+            std::stable_sort(octave.begin(), end, [](const Step& a, const Step& b) { return a.note < b.note; });
+            count = static_cast<int>(std::unique(octave.begin(), end, [](const Step& a, const Step& b) {
+                                         return a.note == b.note;
+                                     }) - octave.begin());
+        }
+
+        length = 0;
+        for (int o = 0; o < octaves; ++o)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const Step& s = octave[static_cast<size_t>(i)];
+                if (s.note + 12 * o < 128)
+                    pattern[static_cast<size_t>(length++)] = {s.note + 12 * o, s.velocity};
+            }
+        }
+    }
+
+    const ChordMemory* chordMemory = nullptr;
+    StepClock clock;
+    double sampleRate = 44100.0;
+    double tempo = 120.0;
+    double stepsPerBeat = 4.0;
+    float gate = 0.5f;
+    Mode mode = Mode::Up;
+    int octaves = 1;
+    bool following = false;
+
+    // Held keys, in the order they went down
+    std::array<int, MAX_KEYS> keys{};
+    std::array<float, MAX_KEYS> velocities{};
+    int numKeys = 0;
+
+    std::array<Step, MAX_PATTERN> pattern{};
+    int length = 0;
+    int64_t position = 0;  // Steps since the first key
+    int playing = -1;      // Sounding note
+    int gateLeft = 0;      // Samples until its gate ends
+    uint32_t random = 0x9E3779B9u;
+};
@@ -0,0 +1,78 @@
+/**
+ * @file AsyncPrepare.h
+ * @brief Run an engine's prepare() on a background thread
+ *
+ * Some engines allocate and clear megabytes in prepare() (TapeLoop's tape
+ * is up to a minute of stereo, DFAM's delay and reverb several MB), and
+ * prepareToPlay() runs on the message thread: a sample-rate change in a
+ * big session stalled it once per instance. Instead:
+ *
+ *   // prepareToPlay
+ *   preparer.start([this, sr, block] { engine.prepare(sr, block); }, !isNonRealtime());
+ *
+ *   // processBlock
+ *   if (!preparer.isReady())
+ *       return;  // Silence until the engine is ready
+ *
+ * The job's writes are visible to the audio thread once isReady() is true
+ * (release / acquire). start() first waits for a job still running. Offline
+ * renders pass background = false, so the first block isn't lost. Anything
+ * else that touches the engine off the audio thread calls wait() first.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+class AsyncPrepare
+{
+public:
+    AsyncPrepare() = default;
+    ~AsyncPrepare() { wait(); }
+
+    AsyncPrepare(const AsyncPrepare&) = delete;
+    AsyncPrepare& operator=(const AsyncPrepare&) = delete;
+
+    /** Run job on a worker thread (or here, if !background), ready once it returns */
+    template <typename Fn>
+    void start(Fn&& job, bool background = true)
+    {
+        wait();
+        ready.store(false, std::memory_order_release);
+
+        if (!background)
+        {
+            job();
+            ready.store(true, std::memory_order_release);
+            return;
+        }
+
+        worker = std::thread([this, job = std::forward<Fn>(job)]() mutable {
+            job();
+            ready.store(true, std::memory_order_release);
+        });
+    }
+
+    /** True once the last job has finished (audio thread) */
+    bool isReady() const noexcept { return ready.load(std::memory_order_acquire); }
+
+    /** Block until a running job finishes */
+    void wait()
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+
+    /** Wait, then report not ready until the next start(), e.g. from releaseResources() */
+    void reset()
+    {
+        wait();
+        ready.store(false, std::memory_order_release);
+    }
+
+private:
+    std::thread worker;
+    std::atomic<bool> ready{false};
+};
@@ -0,0 +1,386 @@
+/**
+ * @file BandLimitedOscillator.h
+ * @brief Multi-shape band-limited oscillators on sst-basic-blocks
+ *
+ * Two flavours with the same interface, for two budgets:
+ *
+ *   BlepOscillator  sst's EBSaw / EBPulse / EBTri (elliptic BLEP). Aliasing
+ *                   stays far below a two-sample polyBLEP or a naive ramp
+ *                   right up the keyboard, at about 20 ns a sample. Use it
+ *                   for a handful of lead oscillators, especially under FM.
+ *   DPWOscillator   sst's DPWSawOscillator / DPWPulseOscillator (cubic
+ *                   differentiated polynomial waves). About polyBLEP quality
+ *                   at 2-3 ns a sample; use it for banks of oscillators.
+ *
+ * TieredOscillator holds one of each and runs the BLEP, or the DPW in the
+ * draft quality tier (QualityTier.h), switching at the next resetPhase().
+ *
+ * In both, the triangle (DPW only) and sine are evaluated directly from the
+ * phase with sst's EBTri / EBApproxSin shape functions: the sine is a
+ * rational approximation, so nothing per sample calls std::sin or
+ * std::fmod, and neither shape has a step worth correcting.
+ *
+ * Frequency changes are unsmoothed (NoSmoothingStrategy), so per-sample FM
+ * and sequenced pitch jumps land on the sample they're set. Only the
+ * selected shape runs; switching shape restarts it at phase 0.
+ *
+ * BlepOscillator::prepare() builds the BLEP pole table for the sample rate,
+ * which allocates; call it from the engine's prepare(), never while
+ * rendering.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include "sst/basic-blocks/dsp/EllipticBlepOscillators.h"
+#include "sst/basic-blocks/dsp/DPWSawPulseOscillator.h"
+
+/** Oscillator shapes, in the order the plugins' waveform parameters use */
+enum class OscShape { Saw = 0, Pulse, Triangle, Sine };
+
+/**
+ * @brief Phase accumulator for the shapes evaluated straight from the phase
+ */
+struct OscPhase
+{
+    float phase = 0.0f;
+    float increment = 0.0f;
+
+    float next() noexcept
+    {
+        const float p = phase;
+        phase += increment;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+        return p;
+    }
+
+    static float triangle(float p) noexcept
+    {
+        return sst::basic_blocks::dsp::EBTri<sst::basic_blocks::dsp::NoSmoothingStrategy>::valueAt(p);
+    }
+
+    static float sine(float p) noexcept
+    {
+        return sst::basic_blocks::dsp::EBApproxSin<sst::basic_blocks::dsp::NoSmoothingStrategy>::valueAt(p);
+    }
+};
+
+class BlepOscillator
+{
+public:
+    BlepOscillator()
+    {
+        // The default 44.1k poles, so setFrequency() is valid before prepare()
+        setSampleRateAll(sampleRate);
+    }
+
+    void prepare(double sr)
+    {
+        sst::basic_blocks::dsp::prepareEBOscillators(sr);
+        sampleRate = sr;
+        setSampleRateAll(sr);
+        reset();
+    }
+
+    /** Restart at phase 0 with a clean BLEP state (note on, retrigger) */
+    void reset()
+    {
+        saw.reset();
+        pulse.reset();
+        tri.reset();
+        pulse.setWidth(pulseWidth);
+        sine.phase = 0.0f;
+        applyFrequency();
+    }
+
+    void setFrequency(float freqHz)
+    {
+        frequency = freqHz;
+        applyFrequency();
+    }
+
+    void setShape(OscShape s)
+    {
+        if (s == shape)
+            return;
+        shape = s;
+        restart();
+    }
+
+    /** Shape by index: 0 saw, 1 pulse / square, 2 triangle, 3 sine */
+    void setShape(int s) { setShape(static_cast<OscShape>(std::clamp(s, 0, 3))); }
+
+    /** Pulse duty cycle (0.01-0.99, 0.5 = square) */
+    void setPulseWidth(float width)
+    {
+        pulseWidth = std::clamp(width, 0.01f, 0.99f);
+        pulse.setWidth(pulseWidth);
+    }
+
+    OscShape getShape() const { return shape; }
+    float getFrequency() const { return frequency; }
+
+    float process()
+    {
+        switch (shape)
+        {
+        case OscShape::Saw: return saw.step();
+        case OscShape::Pulse: return pulse.step();
+        case OscShape::Triangle: return tri.step();
+        case OscShape::Sine:
+        default: return OscPhase::sine(sine.next());
+        }
+    }
+
+    /**
+     * @brief setFrequency(freqHz[i]) then process() for each of @p n samples
+     *
+     * The shape is picked once for the block rather than per sample. The
+     * BLEP shapes still step one sample at a time; the sine's phases are
+     * accumulated first and evaluated in a separate loop that vectorizes.
+     * Renders the same as the per-sample calls.
+     */
+    void processBlock(const float* freqHz, float* out, int n)
+    {
+        if (n <= 0)
+            return;
+
+        switch (shape)
+        {
+        case OscShape::Saw:
+            for (int i = 0; i < n; ++i)
+            {
+                saw.setFrequency(freqHz[i]);
+                out[i] = saw.step();
+            }
+            break;
+        case OscShape::Pulse:
+            for (int i = 0; i < n; ++i)
+            {
+                pulse.setFrequency(freqHz[i]);
+                out[i] = pulse.step();
+            }
+            break;
+        case OscShape::Triangle:
+            for (int i = 0; i < n; ++i)
+            {
+                tri.setFrequency(freqHz[i]);
+                out[i] = tri.step();
+            }
+            break;
+        case OscShape::Sine:
+            for (int i = 0; i < n; ++i)
+            {
+                sine.increment = static_cast<float>(freqHz[i] / sampleRate);
+                out[i] = sine.next();
+            }
+            for (int i = 0; i < n; ++i)
+                out[i] = OscPhase::sine(out[i]);
+            break;
+        }
+        frequency = freqHz[n - 1];
+    }
+
+private:
+    using Smoothing = sst::basic_blocks::dsp::NoSmoothingStrategy;
+
+    void setSampleRateAll(double sr)
+    {
+        saw.setSampleRate(sr);
+        pulse.setSampleRate(sr);
+        tri.setSampleRate(sr);
+    }
+
+    /** Only the running shape tracks frequency; restart() catches the others up */
+    void applyFrequency()
+    {
+        switch (shape)
+        {
+        case OscShape::Saw: saw.setFrequency(frequency); break;
+        case OscShape::Pulse: pulse.setFrequency(frequency); break;
+        case OscShape::Triangle: tri.setFrequency(frequency); break;
+        case OscShape::Sine: sine.increment = static_cast<float>(frequency / sampleRate); break;
+        }
+    }
+
+    void restart()
+    {
+        switch (shape)
+        {
+        case OscShape::Saw: saw.reset(); break;
+        case OscShape::Pulse: pulse.reset(); pulse.setWidth(pulseWidth); break;
+        case OscShape::Triangle: tri.reset(); break;
+        case OscShape::Sine: sine.phase = 0.0f; break;
+        }
+        applyFrequency();
+    }
+
+    sst::basic_blocks::dsp::EBSaw<Smoothing> saw;
+    sst::basic_blocks::dsp::EBPulse<Smoothing> pulse;
+    sst::basic_blocks::dsp::EBTri<Smoothing> tri;
+    OscPhase sine;
+
+    double sampleRate = 44100.0;
+    float frequency = 440.0f;
+    float pulseWidth = 0.5f;
+    OscShape shape = OscShape::Saw;
+};
+
+class DPWOscillator
+{
+public:
+    DPWOscillator() { reset(); }
+
+    void prepare(double sr)
+    {
+        sampleRateInv = 1.0 / sr;
+        reset();
+    }
+
+    /** Restart at phase 0 (note on, retrigger) */
+    void reset()
+    {
+        saw.retrigger();
+        pulse.retrigger();
+        pulse.setPulseWidth(pulseWidth);
+        shaped.phase = 0.0f;
+        applyFrequency();
+    }
+
+    void setFrequency(float freqHz)
+    {
+        frequency = freqHz;
+        applyFrequency();
+    }
+
+    void setShape(OscShape s)
+    {
+        if (s == shape)
+            return;
+        shape = s;
+        reset();
+    }
+
+    /** Shape by index: 0 saw, 1 pulse / square, 2 triangle, 3 sine */
+    void setShape(int s) { setShape(static_cast<OscShape>(std::clamp(s, 0, 3))); }
+
+    /** Pulse duty cycle (0.01-0.99, 0.5 = square) */
+    void setPulseWidth(float width)
+    {
+        pulseWidth = std::clamp(width, 0.01f, 0.99f);
+        pulse.setPulseWidth(pulseWidth);
+    }
+
+    OscShape getShape() const { return shape; }
+    float getFrequency() const { return frequency; }
+
+    float process()
+    {
+        switch (shape)
+        {
+        case OscShape::Saw: return static_cast<float>(saw.step());
+        // The DPW pulse is saw(p) - saw(p + width): low first; flip it to start high
+        case OscShape::Pulse: return -static_cast<float>(pulse.step());
+        case OscShape::Triangle: return OscPhase::triangle(shaped.next());
+        case OscShape::Sine:
+        default: return OscPhase::sine(shaped.next());
+        }
+    }
+
+private:
+    using Smoothing = sst::basic_blocks::dsp::NoSmoothingStrategy;
+
+    void applyFrequency()
+    {
+        switch (shape)
+        {
+        case OscShape::Saw: saw.setFrequency(frequency, sampleRateInv); break;
+        case OscShape::Pulse: pulse.setFrequency(frequency, sampleRateInv); break;
+        case OscShape::Triangle:
+        case OscShape::Sine: shaped.increment = static_cast<float>(frequency * sampleRateInv); break;
+        }
+    }
+
+    sst::basic_blocks::dsp::DPWSawOscillator<Smoothing> saw;
+    sst::basic_blocks::dsp::DPWPulseOscillator<Smoothing> pulse;
+    OscPhase shaped;
+
+    double sampleRateInv = 1.0 / 44100.0;
+    float frequency = 440.0f;
+    float pulseWidth = 0.5f;
+    OscShape shape = OscShape::Saw;
+};
+
+/**
+ * @brief BlepOscillator, or DPWOscillator for the draft quality tier
+ *
+ * The switch waits for the next resetPhase(), which restarts either, so a
+ * tier change never lands mid-cycle. Frequencies are clamped to 20 Hz -
+ * 20 kHz, so FM can't drive the phase backwards or past Nyquist.
+ */
+class TieredOscillator
+{
+public:
+    void prepare(double sr)
+    {
+        osc.prepare(sr);
+        draftOsc.prepare(sr);
+    }
+
+    // Per sample (FM); the oscillator takes it unsmoothed
+    void setFrequency(float freq)
+    {
+        freq = std::clamp(freq, 20.0f, 20000.0f);
+        if (draft)
+            draftOsc.setFrequency(freq);
+        else
+            osc.setFrequency(freq);
+    }
+
+    void setShape(OscShape s) { setShape(static_cast<int>(s)); }
+    void setShape(int s)
+    {
+        osc.setShape(s);
+        draftOsc.setShape(s);
+    }
+
+    /** DPW instead of elliptic BLEP from the next resetPhase(), which restarts either */
+    void setDraft(bool useDraft) { pendingDraft = useDraft; }
+
+    void resetPhase()
+    {
+        draft = pendingDraft;
+        if (draft)
+            draftOsc.reset();
+        else
+            osc.reset();
+    }
+
+    float process() { return draft ? draftOsc.process() : osc.process(); }
+
+    /** setFrequency() and process() for a block: @p freq is clamped in place */
+    void processBlock(float* freq, float* out, int n)
+    {
+        for (int i = 0; i < n; ++i)
+            freq[i] = std::clamp(freq[i], 20.0f, 20000.0f);
+
+        if (draft)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                draftOsc.setFrequency(freq[i]);
+                out[i] = draftOsc.process();
+            }
+            return;
+        }
+        osc.processBlock(freq, out, n);
+    }
+
+private:
+    BlepOscillator osc;
+    DPWOscillator draftOsc;
+    bool draft = false;
+    bool pendingDraft = false;
+};
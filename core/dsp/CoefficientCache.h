@@ -0,0 +1,78 @@
+/**
+ * @file CoefficientCache.h
+ * @brief Filter coefficients worked out once per setting and shared by the voices on it
+ *
+ * With no key tracking, envelope or per-voice modulation on the cutoff,
+ * every voice asks for the same coefficients (a tan or sin each) at every
+ * update. The engine (or a SIMD voice group) holds a small cache, keyed by
+ * the values the coefficients are made from, and each voice takes its
+ * coefficients from it; only a setting no voice has asked for yet runs the
+ * maths:
+ *
+ *   const auto& c = cache.get(cutoff, resonance, mode,
+ *                             [&](Coeffs& out) { out = makeCoeffs(cutoff, resonance, mode); });
+ *
+ * The result is exactly what each voice would have worked out itself (the
+ * same function on the same inputs), so sharing never changes the sound.
+ * Keys compare exactly: a voice a hair off gets its own entry. When more
+ * than ENTRIES settings are in use the oldest entry goes.
+ *
+ * clear() when anything the key leaves out changes (the sample rate).
+ * One thread: a cache shared by voices rendered on a pool needs one per
+ * worker (ModelD keeps one per voice group call).
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+template <typename Coeffs, int ENTRIES = 4>
+class CoefficientCache
+{
+public:
+    using Key = std::array<float, 3>;
+
+    /** The coefficients for (a, b, c), made by make(Coeffs&) if no entry has them */
+    template <typename Make>
+    const Coeffs& get(float a, float b, float c, Make&& make)
+    {
+        const Key key{a, b, c};
+        for (int i = 0; i < size; ++i)
+        {
+            if (keys[static_cast<size_t>(i)] == key)
+            {
+                ++hits;
+                return values[static_cast<size_t>(i)];
+            }
+        }
+
+        const auto slot = static_cast<size_t>(next);
+        next = (next + 1) % ENTRIES;
+        size = size < ENTRIES ? size + 1 : ENTRIES;
+
+        keys[slot] = key;
+        make(values[slot]);
+        ++misses;
+        return values[slot];
+    }
+
+    /** Forget every entry */
+    void clear()
+    {
+        size = 0;
+        next = 0;
+    }
+
+    /** Lookups served from an entry / that ran make() */
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+
+private:
+    std::array<Key, ENTRIES> keys{};
+    std::array<Coeffs, ENTRIES> values{};
+    int size = 0;
+    int next = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
@@ -0,0 +1,200 @@
+/**
+ * @file Compressor.h
+ * @brief Master-bus compressor shared by DFAM and TapeLoop
+ *
+ * Level detection runs every sample, and it is cheap: the louder
+ * channel's squared level adds to the control block's mean power, an RMS
+ * detector over CONTROL_BLOCK samples. The gain computer runs once per
+ * control block. It works in the log2 domain with FastMath's log2 and
+ * exp2 (fastLog2() and fastExp2()), good to under 0.001 dB. Each sample
+ * the gain moves toward the latest target at the attack or release rate,
+ * which interpolates it between updates. So no sample pays for a log10
+ * or a pow.
+ *
+ * The control-block phase is part of the state, so a block renders the
+ * same however it is split.
+ *
+ * The reference build (ReferenceDsp.h) runs the original per-sample gain
+ * computer: 20 log10 of the level, and a 10^(-gr/20) target smoothed at the
+ * attack and release rates.
+ *
+ * With lookahead on, the gain is worked out from the input as it arrives
+ * but applied to the signal LOOKAHEAD_MS later, so the attack has already
+ * caught a transient by the time it plays. Dry and wet are both delayed,
+ * which the engine reports to the host as latency (getLatency()).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "FastMath.h"
+#include "MemoryReport.h"
+#include "ReferenceDsp.h"
+#include "SilenceGate.h"
+
+class Compressor
+{
+public:
+    static constexpr float LOOKAHEAD_MS = 5.0f;
+
+    /** Samples between gain-computer runs */
+    static constexpr int CONTROL_BLOCK = 16;
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        updateCoefficients();
+
+        // Only grow the line: a lower rate reuses it
+        lookaheadSamples = static_cast<size_t>(std::round(LOOKAHEAD_MS * 0.001 * sr));
+        if (lookaheadL.size() < lookaheadSamples)
+        {
+            lookaheadL.assign(lookaheadSamples, 0.0f);
+            lookaheadR.assign(lookaheadSamples, 0.0f);
+        }
+        clearLookahead();
+    }
+
+    void setThreshold(float db) { threshold = db; }
+    void setRatio(float r) { ratio = std::clamp(r, 1.0f, 20.0f); }
+    void setAttack(float ms) { attackMs = std::clamp(ms, 0.1f, 100.0f); updateCoefficients(); }
+    void setRelease(float ms) { releaseMs = std::clamp(ms, 10.0f, 1000.0f); updateCoefficients(); }
+    void setMakeupGain(float db) { makeupGain = std::pow(10.0f, db / 20.0f); }
+    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
+
+    /** Delay the signal by LOOKAHEAD_MS so the gain leads it; the line starts silent */
+    void setLookahead(bool on)
+    {
+        if (on == lookahead)
+            return;
+        lookahead = on;
+        clearLookahead();
+    }
+
+    /** Samples the output is delayed by */
+    int getLatency() const { return lookahead ? static_cast<int>(lookaheadSamples) : 0; }
+
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
+
+    /** Compress a block in place */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        const float slope = 1.0f - 1.0f / ratio;
+        const float dryMix = 1.0f - mix;
+        const bool delayed = lookahead && lookaheadSamples > 0;
+
+        // 20 log10(x) = DB_PER_OCTAVE log2(x)
+        const float thresholdLog2 = threshold / DB_PER_OCTAVE;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float peak = std::max(std::abs(left[i]), std::abs(right[i]));
+
+            float env;
+            if constexpr (ReferenceDsp::ENABLED)
+            {
+                const float inputDb = 20.0f * std::log10(peak + 1e-6f);
+                float gainReduction = 0.0f;
+                if (inputDb > threshold)
+                    gainReduction = (inputDb - threshold) * slope;
+
+                const float targetGain = std::pow(10.0f, -gainReduction / 20.0f);
+                const float coef = targetGain < gain ? attackCoef : releaseCoef;
+                gain = coef * gain + (1.0f - coef) * targetGain;
+                env = gain;
+            }
+            else
+            {
+                blockPower += peak * peak * (1.0f / CONTROL_BLOCK);
+                if (--untilControl <= 0)
+                {
+                    untilControl = CONTROL_BLOCK;
+                    // log2 of the RMS level is half the power's
+                    const float over = 0.5f * fastLog2(blockPower + 1e-12f) - thresholdLog2;
+                    target = over > 0.0f ? fastExp2(-over * slope) : 1.0f;
+                    blockPower = 0.0f;
+                }
+
+                const float coef = target < gain ? attackCoef : releaseCoef;
+                gain = target + (gain - target) * coef;
+                env = gain;
+            }
+
+            // The gain from this sample goes on the one LOOKAHEAD_MS back
+            float l = left[i];
+            float r = right[i];
+            if (delayed)
+            {
+                std::swap(l, lookaheadL[lookaheadPos]);
+                std::swap(r, lookaheadR[lookaheadPos]);
+                if (++lookaheadPos == lookaheadSamples)
+                    lookaheadPos = 0;
+            }
+
+            const float wet = env * makeupGain;
+            left[i] = l * dryMix + l * wet * mix;
+            right[i] = r * dryMix + r * wet * mix;
+        }
+    }
+
+    /**
+     * @brief Samples for the gain to recover after the input stops
+     *
+     * Silence in is silence out; running on only lets the envelope release
+     * as it would have, so the next note isn't squashed by the last one.
+     * With lookahead the line has to empty first.
+     */
+    int64_t getTailSamples() const { return Silence::decayTail(releaseCoef) + CONTROL_BLOCK + getLatency(); }
+
+    /** Bytes of lookahead line allocated by prepare() */
+    size_t getHeapBytes() const { return MemoryReport::bytesOf(lookaheadL) + MemoryReport::bytesOf(lookaheadR); }
+
+    /** log2(x) for x > 0, within 1e-4 (0.0006 dB) */
+    static float fastLog2(float x) { return FastMath::log2<FastMath::Accuracy::Control>(x); }
+
+    /** 2^x for x in [-126, 127], within 3e-7 relative */
+    static float fastExp2(float x) { return FastMath::exp2<FastMath::Accuracy::Audio>(x); }
+
+private:
+    static constexpr float DB_PER_OCTAVE = 6.020599913f;
+
+    void updateCoefficients()
+    {
+        attackCoef = std::exp(-1.0f / (attackMs * 0.001f * static_cast<float>(sampleRate)));
+        releaseCoef = std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
+    }
+
+    void clearLookahead()
+    {
+        std::fill(lookaheadL.begin(), lookaheadL.end(), 0.0f);
+        std::fill(lookaheadR.begin(), lookaheadR.end(), 0.0f);
+        lookaheadPos = 0;
+    }
+
+    double sampleRate = 44100.0;
+    float threshold = -10.0f;
+    float ratio = 4.0f;
+    float attackMs = 10.0f;
+    float releaseMs = 100.0f;
+    float makeupGain = 1.0f;
+    float attackCoef = 0.0f;
+    float releaseCoef = 0.0f;
+    float mix = 1.0f;
+
+    // Detector and gain: this control block's mean power so far, samples
+    // until its end, the gain computer's last target and the smoothed gain
+    float blockPower = 0.0f;
+    int untilControl = CONTROL_BLOCK;
+    float target = 1.0f;
+    float gain = 1.0f;
+
+    bool lookahead = false;
+    std::vector<float> lookaheadL;
+    std::vector<float> lookaheadR;
+    size_t lookaheadSamples = 0;
+    size_t lookaheadPos = 0;
+};
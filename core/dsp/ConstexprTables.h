@@ -0,0 +1,126 @@
+/**
+ * @file ConstexprTables.h
+ * @brief Lookup tables computed by the compiler, kept in read-only data
+ *
+ * A table built in a constructor or a function-local static costs every
+ * process the time to fill it and a private copy of its pages; in WASM it
+ * costs every module instance. Built by the compiler instead, the table
+ * is part of the binary: it sits in .rodata (the data segment in WASM),
+ * processes running the same library share it through the page cache,
+ * and nothing runs at startup or on the first note.
+ *
+ * std::sin, std::pow and friends aren't constexpr before C++26, so this
+ * has its own, in double: exp2, sin, cos and tan, range-reduced and summed
+ * as fixed polynomials (no loops, so even clang's step limit leaves room
+ * for tables of thousands of points). They are accurate to a few double
+ * ulps, so a float table comes out the same as one built with libm.
+ *
+ *   static constexpr auto TABLE = ConstexprTables::make<float, 4096>(
+ *       [](size_t i) { return ConstexprTables::tan(ConstexprTables::PI * i / 8192.0); });
+ *
+ * For build time only: at run time std:: is faster. C++17, for the web
+ * builds, which keep copies of this file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace ConstexprTables
+{
+
+inline constexpr double PI = 3.14159265358979323846;
+inline constexpr double LN2 = 0.69314718055994530942;
+
+/** The largest whole number not above x (x within +-2^62) */
+constexpr double floor(double x)
+{
+    const double whole = static_cast<double>(static_cast<long long>(x));
+    return whole > x ? whole - 1.0 : whole;
+}
+
+/** 2^x */
+constexpr double exp2(double x)
+{
+    // 2^x = 2^n * e^(f ln 2), |f| <= 1/2: Taylor to the 14th power is
+    // within 1e-19 there
+    const double n = floor(x + 0.5);
+    const double y = (x - n) * LN2;
+    double r = 1.0 + y * (1.0 + y * (1.0 / 2 + y * (1.0 / 6 + y * (1.0 / 24 + y * (1.0 / 120 + y * (1.0 / 720
+             + y * (1.0 / 5040 + y * (1.0 / 40320 + y * (1.0 / 362880 + y * (1.0 / 3628800 + y * (1.0 / 39916800
+             + y * (1.0 / 479001600 + y * (1.0 / 6227020800.0 + y * (1.0 / 87178291200.0))))))))))))));
+    for (int e = 0; e < n; ++e)
+        r *= 2.0;
+    for (int e = 0; e > n; --e)
+        r *= 0.5;
+    return r;
+}
+
+namespace detail
+{
+// Taylor series for |x| <= pi/4, within 1e-19
+constexpr double sinSmall(double x)
+{
+    const double x2 = x * x;
+    return x * (1.0 - x2 / 6 * (1.0 - x2 / 20 * (1.0 - x2 / 42 * (1.0 - x2 / 72 * (1.0 - x2 / 110
+             * (1.0 - x2 / 156 * (1.0 - x2 / 210 * (1.0 - x2 / 272))))))));
+}
+
+constexpr double cosSmall(double x)
+{
+    const double x2 = x * x;
+    return 1.0 - x2 / 2 * (1.0 - x2 / 12 * (1.0 - x2 / 30 * (1.0 - x2 / 56 * (1.0 - x2 / 90 * (1.0 - x2 / 132
+             * (1.0 - x2 / 182 * (1.0 - x2 / 240 * (1.0 - x2 / 306))))))));
+}
+
+/** x's quadrant (x = q pi/2 + r, |r| <= pi/4), q mod 4 */
+constexpr int quadrant(double x, double& r)
+{
+    const double q = floor(x / (PI / 2) + 0.5);
+    r = x - q * (PI / 2);
+    const long long whole = static_cast<long long>(q) % 4;
+    return static_cast<int>(whole < 0 ? whole + 4 : whole);
+}
+} // namespace detail
+
+constexpr double sin(double x)
+{
+    double r = 0.0;
+    switch (detail::quadrant(x, r))
+    {
+    case 0: return detail::sinSmall(r);
+    case 1: return detail::cosSmall(r);
+    case 2: return -detail::sinSmall(r);
+    default: return -detail::cosSmall(r);
+    }
+}
+
+constexpr double cos(double x)
+{
+    double r = 0.0;
+    switch (detail::quadrant(x, r))
+    {
+    case 0: return detail::cosSmall(r);
+    case 1: return -detail::sinSmall(r);
+    case 2: return -detail::cosSmall(r);
+    default: return detail::sinSmall(r);
+    }
+}
+
+constexpr double tan(double x)
+{
+    return sin(x) / cos(x);
+}
+
+/** An N-point table of T, point i = fn(i) */
+template <typename T, size_t N, typename Fn>
+constexpr std::array<T, N> make(Fn fn)
+{
+    std::array<T, N> table{};
+    for (size_t i = 0; i < N; ++i)
+        table[i] = static_cast<T>(fn(i));
+    return table;
+}
+
+} // namespace ConstexprTables
@@ -0,0 +1,587 @@
+/**
+ * @file Convolver.h
+ * @brief Impulse response reverb: zero-latency, uniformly partitioned FFT convolution
+ *
+ * The impulse response is cut into partitions of BLOCK samples. The first
+ * runs as a direct-form FIR over the input as it arrives, so the wet
+ * signal has no latency. The rest run in the frequency domain
+ * (uniformly partitioned overlap-save): every BLOCK samples, one FFT of
+ * the last two input blocks joins a delay line of input spectra, each
+ * partition's spectrum multiplies its slot of that line, and one inverse
+ * FFT of the sum gives the tail for the next BLOCK samples. The tail
+ * starts BLOCK samples in, exactly where the head stops. The cost is the
+ * same every BLOCK samples, so a long response costs steadily rather than
+ * in spikes.
+ *
+ * Left and right share each FFT as the real and imaginary parts of one
+ * complex signal and are split apart by symmetry. The FFT works on
+ * split real / imaginary arrays, and every butterfly stage past the
+ * second and every spectrum multiply is a plain loop over contiguous
+ * floats, which the compiler turns into SSE / NEON / WASM SIMD.
+ *
+ * Loading is off the audio thread: loadImpulse() resamples the response
+ * to the engine's rate (Lanczos, a = 4, as sst's LanczosResampler, but
+ * written out here: the web builds have no sst; and widened going down, so
+ * it doesn't alias), trims and normalizes it,
+ * builds its partition spectra and posts the result through an atomic
+ * pointer. The audio thread picks it up at the next partition boundary
+ * and crossfades to it over one BLOCK. A kernel it lets go of goes on a
+ * lock-free list the next load (or prepare()) frees, never the audio thread. The response
+ * is kept as loaded, so prepare() at another rate rebuilds it.
+ *
+ *   // Background thread
+ *   convolver.loadImpulse(left.data(), right.data(), length, fileRate);
+ *
+ *   // Audio thread
+ *   convolver.processBlock(left, right, n);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Denormals.h"
+#include "MemoryReport.h"
+#include "SplitFFT.h"
+
+/**
+ * @brief Stereo convolution with a loaded impulse response, dry / wet mixed
+ */
+class Convolver
+{
+public:
+    static constexpr int BLOCK = 128;             // Partition length, and the head's taps
+    static constexpr double MAX_SECONDS = 10.0;   // Longest response kept
+
+    Convolver() = default;
+    ~Convolver() { freeKernels(); }
+
+    Convolver(const Convolver&) = delete;
+    Convolver& operator=(const Convolver&) = delete;
+
+    /**
+     * @brief Rebuild the loaded response for @p sr and start from silence
+     *
+     * Not while the audio thread runs, like any prepare().
+     */
+    void prepare(double sr)
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        sampleRate = sr;
+        freeKernels();
+        history = {};
+        position = 0;
+        fade = FADE_DONE;
+        if (!sourceL.empty())
+            active = build(sr).release();
+    }
+
+    /**
+     * @brief Load an impulse response (not from the audio thread)
+     * @param right The right channel, or nullptr for a mono response
+     * @param rate The response's own sample rate
+     *
+     * Blocks for as long as resampling and the partition FFTs take, so
+     * call it from a background thread; the audio thread crossfades to the
+     * new response once it's posted.
+     */
+    void loadImpulse(const float* left, const float* right, size_t length, double rate)
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        sourceL.assign(left, left + length);
+        sourceR.assign(right ? right : left, (right ? right : left) + length);
+        sourceRate = rate;
+        post(build(sampleRate));
+    }
+
+    /** Drop the response (not from the audio thread); the wet signal fades out */
+    void clearImpulse()
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+        sourceL.clear();
+        sourceR.clear();
+        post(std::make_unique<Kernel>());
+    }
+
+    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
+
+    /**
+     * @brief Mix the convolution into a block, in place
+     *
+     * At zero mix the block passes untouched; the input still goes into the
+     * history and the spectra line (one FFT per BLOCK), so raising the mix
+     * picks up where the input is.
+     */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        if (position == 0)
+            takeIncoming();
+        if (!isAudible())
+            return;
+
+        const bool heard = mix > 0.0f;
+        const float wetMix = mix;
+        const float dryMix = 1.0f - mix;
+        float* const channels[2] = {left, right};
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int run = std::min(numSamples - start, BLOCK - position);
+
+            for (int c = 0; c < 2; ++c)
+                std::copy(channels[c] + start, channels[c] + start + run, history[c].data() + BLOCK + position);
+
+            if (heard)
+            {
+                alignas(16) float wet[2][BLOCK];
+                renderWet(active, wet, run);
+                if (fade != FADE_DONE)
+                    crossfade(wet, run);
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    float* const io = channels[c] + start;
+                    for (int i = 0; i < run; ++i)
+                        io[i] = io[i] * dryMix + wet[c][i] * wetMix;
+                }
+            }
+            else if (fade != FADE_DONE)
+                fade += run;
+
+            position += run;
+            start += run;
+            if (position == BLOCK)
+                endBlock(heard);
+        }
+    }
+
+    /** Samples until the wet signal falls silent after the input does */
+    int64_t getTailSamples() const
+    {
+        const Kernel* longest = active;
+        if (fade != FADE_DONE && fadeFrom && (!longest || fadeFrom->length > longest->length))
+            longest = fadeFrom;
+        return longest && longest->length > 0 ? static_cast<int64_t>(longest->length) + BLOCK : 0;
+    }
+
+    /** Length of the loaded response at the engine's rate, 0 if none (not the audio thread) */
+    size_t getImpulseSamples() const { return impulseSamples.load(std::memory_order_relaxed); }
+
+    /** Bytes of the kernel last built: partition spectra and their input line */
+    size_t getHeapBytes() const { return kernelBytes.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int FFT_SIZE = 2 * BLOCK;
+    static constexpr int BINS = BLOCK + 1;  // 0 to Nyquist; the rest mirror them
+    static constexpr int LANES = 8;         // Bins summed side by side
+    static constexpr int SPAN = (BINS + LANES - 1) / LANES * LANES;  // Padded with zero bins
+    static constexpr int FADE_DONE = -1;
+
+    using FFT = SplitFFT<FFT_SIZE>;
+    static constexpr int LANCZOS_A = 4;         // Lobes of the resampling kernel
+    static constexpr int TABLE_STEPS = 1024;    // Kernel table points per lobe
+
+    /** Half spectra of the left and right channels, split real / imaginary */
+    struct Spectra
+    {
+        alignas(16) float leftRe[SPAN];
+        alignas(16) float leftIm[SPAN];
+        alignas(16) float rightRe[SPAN];
+        alignas(16) float rightIm[SPAN];
+    };
+
+    /** One response at one rate, with the state that depends on its length */
+    struct Kernel
+    {
+        size_t length = 0;
+        alignas(16) float head[2][BLOCK]{};  // First BLOCK taps, left and right
+        std::vector<Spectra> partitions;     // The rest, BLOCK taps each
+        std::vector<Spectra> inputs;         // Input spectra, newest at inputPos
+        size_t inputPos = 0;
+        alignas(16) float tail[2][BLOCK]{};  // The partitions' output for this block
+        Kernel* nextRetired = nullptr;       // Down the retired list
+
+        size_t heapBytes() const { return MemoryReport::bytesOf(partitions) + MemoryReport::bytesOf(inputs); }
+    };
+
+    bool isAudible() const { return (active && active->length > 0) || fade != FADE_DONE; }
+
+    /** Swap in a posted kernel, at a block boundary, while nothing else is fading */
+    void takeIncoming()
+    {
+        if (fade != FADE_DONE)
+            return;
+        Kernel* const next = incoming.exchange(nullptr, std::memory_order_acq_rel);
+        if (!next)
+            return;
+        if (!isAudible())
+            history = {};  // Not kept while there was nothing to hear
+        fadeFrom = active;
+        active = next;
+        fade = 0;
+    }
+
+    /** Head FIR over the run just copied into history, plus this block's tail */
+    void renderWet(const Kernel* kernel, float (&wet)[2][BLOCK], int run) const
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            float* const out = wet[c];
+            if (!kernel || kernel->length == 0)
+            {
+                std::fill(out, out + run, 0.0f);
+                continue;
+            }
+
+            std::copy(kernel->tail[c] + position, kernel->tail[c] + position + run, out);
+            const float* const taps = kernel->head[c];
+            const float* const x = history[c].data() + BLOCK + position;
+            for (int m = 0; m < BLOCK; ++m)
+            {
+                const float h = taps[m];
+                const float* const delayed = x - m;
+                for (int i = 0; i < run; ++i)
+                    out[i] += h * delayed[i];
+            }
+        }
+    }
+
+    /** Mix the outgoing kernel's wet signal under the incoming one's, over one BLOCK */
+    void crossfade(float (&wet)[2][BLOCK], int run)
+    {
+        alignas(16) float outgoing[2][BLOCK];
+        renderWet(fadeFrom, outgoing, run);
+        constexpr float STEP = 1.0f / BLOCK;
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < run; ++i)
+            {
+                const float g = static_cast<float>(fade + i) * STEP;
+                wet[c][i] = outgoing[c][i] + (wet[c][i] - outgoing[c][i]) * g;
+            }
+        fade += run;
+    }
+
+    /** A BLOCK of input is in: run the partitions (if @p heard), then slide the history on */
+    void endBlock(bool heard)
+    {
+        const bool fading = fade != FADE_DONE && fade < BLOCK;
+        if (hasPartitions(active) || (fading && hasPartitions(fadeFrom)))
+        {
+            Spectra input;
+            transformInput(input);
+            runPartitions(active, input, heard);
+            if (fading)
+                runPartitions(fadeFrom, input, heard);
+        }
+
+        if (fade != FADE_DONE && !fading)
+        {
+            retire(fadeFrom);
+            fadeFrom = nullptr;
+            fade = FADE_DONE;
+        }
+
+        for (auto& h : history)
+            std::copy(h.begin() + BLOCK, h.end(), h.begin());
+        position = 0;
+    }
+
+    static bool hasPartitions(const Kernel* kernel) { return kernel && !kernel->partitions.empty(); }
+
+    /**
+     * Spectrum of the last two input blocks, left and right through one FFT
+     * and split apart: L = (Z(k) + Z*(N-k)) / 2, R = (Z(k) - Z*(N-k)) / 2i.
+     * The halves are in the partition spectra.
+     */
+    void transformInput(Spectra& x) const
+    {
+        alignas(16) float re[FFT_SIZE];
+        alignas(16) float im[FFT_SIZE];
+        std::copy(history[0].begin(), history[0].end(), re);
+        std::copy(history[1].begin(), history[1].end(), im);
+        fft.forward(re, im);
+
+        for (int k = 0; k < BINS; ++k)
+        {
+            const int mirror = (FFT_SIZE - k) & (FFT_SIZE - 1);
+            const float a = re[k], b = im[k];
+            const float c = re[mirror], d = im[mirror];
+            x.leftRe[k] = a + c;
+            x.leftIm[k] = b - d;
+            x.rightRe[k] = b + d;
+            x.rightIm[k] = c - a;
+        }
+        for (int k = BINS; k < SPAN; ++k)
+            x.leftRe[k] = x.leftIm[k] = x.rightRe[k] = x.rightIm[k] = 0.0f;
+    }
+
+    /**
+     * Overlap-save: @p input joins the kernel's line of input spectra, and
+     * if @p heard, every partition times its slot of the line, summed and
+     * transformed back, is the next block's tail
+     */
+    void runPartitions(Kernel* kernel, const Spectra& input, bool heard)
+    {
+        if (!hasPartitions(kernel))
+            return;
+
+        const size_t count = kernel->inputs.size();
+        kernel->inputPos = (kernel->inputPos + count - 1) % count;
+        kernel->inputs[kernel->inputPos] = input;
+        if (!heard)
+        {
+            std::fill(&kernel->tail[0][0], &kernel->tail[0][0] + 2 * BLOCK, 0.0f);
+            return;
+        }
+
+        // A span of bins at a time through every partition, so the span's
+        // sums stay in registers
+        alignas(16) float yLRe[SPAN], yLIm[SPAN], yRRe[SPAN], yRIm[SPAN];
+        for (int k0 = 0; k0 < SPAN; k0 += LANES)
+        {
+            float lRe[LANES]{}, lIm[LANES]{}, rRe[LANES]{}, rIm[LANES]{};
+            size_t slot = kernel->inputPos;
+            for (const Spectra& h : kernel->partitions)
+            {
+                const Spectra& in = kernel->inputs[slot];
+                for (int j = 0; j < LANES; ++j)
+                {
+                    const int k = k0 + j;
+                    lRe[j] += in.leftRe[k] * h.leftRe[k] - in.leftIm[k] * h.leftIm[k];
+                    lIm[j] += in.leftRe[k] * h.leftIm[k] + in.leftIm[k] * h.leftRe[k];
+                    rRe[j] += in.rightRe[k] * h.rightRe[k] - in.rightIm[k] * h.rightIm[k];
+                    rIm[j] += in.rightRe[k] * h.rightIm[k] + in.rightIm[k] * h.rightRe[k];
+                }
+                slot = slot + 1 == count ? 0 : slot + 1;
+            }
+            for (int j = 0; j < LANES; ++j)
+            {
+                yLRe[k0 + j] = lRe[j];
+                yLIm[k0 + j] = lIm[j];
+                yRRe[k0 + j] = rRe[j];
+                yRIm[k0 + j] = rIm[j];
+            }
+        }
+
+        // Back to one complex spectrum, left real and right imaginary:
+        // Y(k) = L(k) + i R(k), Y(N-k) = L*(k) + i R*(k)
+        alignas(16) float re[FFT_SIZE];
+        alignas(16) float im[FFT_SIZE];
+        for (int k = 0; k < BINS; ++k)
+        {
+            re[k] = yLRe[k] - yRIm[k];
+            im[k] = yLIm[k] + yRRe[k];
+        }
+        for (int k = 1; k < BLOCK; ++k)
+        {
+            re[FFT_SIZE - k] = yLRe[k] + yRIm[k];
+            im[FFT_SIZE - k] = yRRe[k] - yLIm[k];
+        }
+        fft.inverse(re, im);
+
+        // The second half is the valid part; the BIAS keeps the sums off denormals
+        for (int i = 0; i < BLOCK; ++i)
+        {
+            kernel->tail[0][i] = re[BLOCK + i] + Denormals::BIAS;
+            kernel->tail[1][i] = im[BLOCK + i] + Denormals::BIAS;
+        }
+    }
+
+    /** The loaded response resampled to @p sr, trimmed, normalized and partitioned */
+    std::unique_ptr<Kernel> build(double sr) const
+    {
+        auto kernel = std::make_unique<Kernel>();
+        if (sourceL.empty())
+            return kernel;
+
+        std::vector<float> left, right;
+        resample(sr, left, right);
+
+        // Trim the silent end: 120 dB below the peak adds nothing audible
+        float peak = 0.0f;
+        for (size_t i = 0; i < left.size(); ++i)
+            peak = std::max({peak, std::fabs(left[i]), std::fabs(right[i])});
+        size_t length = left.size();
+        while (length > 0 && std::fabs(left[length - 1]) <= peak * 1.0e-6f && std::fabs(right[length - 1]) <= peak * 1.0e-6f)
+            --length;
+        length = std::min(length, static_cast<size_t>(MAX_SECONDS * sr));
+        if (length == 0)
+            return kernel;
+
+        // Unit energy in the louder channel: white noise in, the same level out
+        double energyL = 0.0, energyR = 0.0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            energyL += static_cast<double>(left[i]) * left[i];
+            energyR += static_cast<double>(right[i]) * right[i];
+        }
+        const float gain = static_cast<float>(1.0 / std::sqrt(std::max(energyL, energyR)));
+
+        kernel->length = length;
+        for (int m = 0; m < BLOCK && static_cast<size_t>(m) < length; ++m)
+        {
+            kernel->head[0][m] = left[static_cast<size_t>(m)] * gain;
+            kernel->head[1][m] = right[static_cast<size_t>(m)] * gain;
+        }
+
+        const size_t partitions = length > BLOCK ? (length - BLOCK + BLOCK - 1) / BLOCK : 0;
+        kernel->partitions.resize(partitions);
+        kernel->inputs.assign(partitions, Spectra{});
+
+        // Each partition zero-padded to FFT_SIZE, left and right split apart
+        // as the input is. processBlock()'s 1 / 2 from the split and the
+        // inverse FFT's 1 / FFT_SIZE are folded in here.
+        const float scale = gain * 0.5f / FFT_SIZE;
+        for (size_t p = 0; p < partitions; ++p)
+        {
+            alignas(16) float re[FFT_SIZE]{};
+            alignas(16) float im[FFT_SIZE]{};
+            const size_t from = BLOCK + p * BLOCK;
+            const size_t to = std::min(from + BLOCK, length);
+            for (size_t i = from; i < to; ++i)
+            {
+                re[i - from] = left[i] * scale;
+                im[i - from] = right[i] * scale;
+            }
+            fft.forward(re, im);
+
+            Spectra& h = kernel->partitions[p];
+            for (int k = 0; k < BINS; ++k)
+            {
+                const int mirror = (FFT_SIZE - k) & (FFT_SIZE - 1);
+                h.leftRe[k] = 0.5f * (re[k] + re[mirror]);
+                h.leftIm[k] = 0.5f * (im[k] - im[mirror]);
+                h.rightRe[k] = 0.5f * (im[k] + im[mirror]);
+                h.rightIm[k] = 0.5f * (re[mirror] - re[k]);
+            }
+        }
+        return kernel;
+    }
+
+    /**
+     * The source response at @p sr (a copy if the rates match). Each output
+     * sample is the source under a Lanczos kernel, tabulated and linearly
+     * interpolated; going down, the kernel is stretched by the ratio so its
+     * cutoff is the new Nyquist.
+     */
+    void resample(double sr, std::vector<float>& left, std::vector<float>& right) const
+    {
+        const size_t length = std::min(sourceL.size(), static_cast<size_t>(MAX_SECONDS * sourceRate) + 1);
+        if (std::fabs(sourceRate - sr) < 1.0e-6 * sr)
+        {
+            left.assign(sourceL.begin(), sourceL.begin() + static_cast<std::ptrdiff_t>(length));
+            right.assign(sourceR.begin(), sourceR.begin() + static_cast<std::ptrdiff_t>(length));
+            return;
+        }
+
+        constexpr double PI = 3.141592653589793;
+        constexpr int TABLE_SIZE = LANCZOS_A * TABLE_STEPS;
+        std::vector<float> kernel(TABLE_SIZE + 2, 0.0f);  // Zero from A on
+        kernel[0] = 1.0f;
+        for (int i = 1; i < TABLE_SIZE; ++i)
+        {
+            const double x = static_cast<double>(i) / TABLE_STEPS;
+            kernel[static_cast<size_t>(i)] =
+                static_cast<float>(LANCZOS_A * std::sin(PI * x) * std::sin(PI * x / LANCZOS_A) / (PI * PI * x * x));
+        }
+
+        const double step = sourceRate / sr;                  // Source samples per output sample
+        const double scale = std::min(1.0, sr / sourceRate);  // Kernel squeeze, 1 going up
+        const double reach = LANCZOS_A / scale;               // Source samples either side
+        const auto wanted = static_cast<size_t>(std::ceil(static_cast<double>(length) / step));
+        left.assign(wanted, 0.0f);
+        right.assign(wanted, 0.0f);
+
+        for (size_t n = 0; n < wanted; ++n)
+        {
+            const double t = static_cast<double>(n) * step;
+            const auto first = static_cast<size_t>(std::max(0.0, std::ceil(t - reach)));
+            const auto last = std::min(length - 1, static_cast<size_t>(t + reach));
+            double sumL = 0.0, sumR = 0.0;
+            for (size_t k = first; k <= last; ++k)
+            {
+                const double x = std::fabs(t - static_cast<double>(k)) * scale * TABLE_STEPS;
+                const auto i = static_cast<size_t>(x);
+                if (i >= static_cast<size_t>(TABLE_SIZE))
+                    continue;
+                const double w = kernel[i] + (kernel[i + 1] - kernel[i]) * (x - static_cast<double>(i));
+                sumL += w * sourceL[k];
+                sumR += w * sourceR[k];
+            }
+            left[n] = static_cast<float>(sumL * scale);
+            right[n] = static_cast<float>(sumR * scale);
+        }
+    }
+
+    /** Push @p kernel on the retired list (audio thread); the loader frees it */
+    void retire(Kernel* kernel)
+    {
+        if (!kernel)
+            return;
+        kernel->nextRetired = retired.load(std::memory_order_relaxed);
+        while (!retired.compare_exchange_weak(kernel->nextRetired, kernel, std::memory_order_release,
+                                              std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /** Free every retired kernel (not the audio thread) */
+    void freeRetired()
+    {
+        for (Kernel* k = retired.exchange(nullptr, std::memory_order_acquire); k;)
+        {
+            Kernel* const next = k->nextRetired;
+            delete k;
+            k = next;
+        }
+    }
+
+    /** Hand @p kernel to the audio thread; free what it let go of */
+    void post(std::unique_ptr<Kernel> kernel)
+    {
+        impulseSamples.store(kernel->length, std::memory_order_relaxed);
+        kernelBytes.store(kernel->heapBytes(), std::memory_order_relaxed);
+        freeRetired();
+        delete incoming.exchange(kernel.release(), std::memory_order_acq_rel);  // One nobody took
+    }
+
+    void freeKernels()
+    {
+        delete active;
+        delete fadeFrom;
+        delete incoming.exchange(nullptr);
+        freeRetired();
+        active = nullptr;
+        fadeFrom = nullptr;
+    }
+
+    FFT fft;
+    double sampleRate = 44100.0;
+
+    // Audio thread
+    Kernel* active = nullptr;
+    Kernel* fadeFrom = nullptr;
+    int fade = FADE_DONE;
+    std::array<std::array<float, 2 * BLOCK>, 2> history{};  // Last block, then this one
+    int position = 0;
+    float mix = 0.0f;
+
+    // Loader to audio thread, and back
+    std::atomic<Kernel*> incoming{nullptr};
+    std::atomic<Kernel*> retired{nullptr};
+
+    // Loader
+    std::mutex loadMutex;
+    std::vector<float> sourceL, sourceR;
+    double sourceRate = 44100.0;
+    std::atomic<size_t> impulseSamples{0};
+    std::atomic<size_t> kernelBytes{0};
+};
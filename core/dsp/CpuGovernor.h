@@ -0,0 +1,199 @@
+/**
+ * @file CpuGovernor.h
+ * @brief Opt-in load shedding: step an engine down before a block misses its deadline
+ *
+ * PerfStats reports a block that ran over after the fact; the governor
+ * acts on it. The engine brackets renderBlock() with beginBlock() /
+ * endBlock(), which times the block against its deadline (numSamples /
+ * sampleRate) and returns a step, 0 to MAX_STEP. What each step sheds is
+ * the engine's choice, cheapest to hear first: drop releasing voices that
+ * are already inaudible, lower the voice limit, fall back to the draft
+ * quality tier (QualityTier.h).
+ *
+ *   governor.beginBlock();
+ *   ...render...
+ *   applyGovernorStep(governor.endBlock(numSamples));
+ *
+ * A block that takes more than HIGH_LOAD of its deadline steps down at
+ * once, then the governor waits SETTLE_SECONDS for the step to show
+ * before it takes another. It steps back up one at a time, only after
+ * the smoothed load has stayed under LOW_LOAD for RECOVER_SECONDS: the gap
+ * between the thresholds and the wait keep it from flapping on a load
+ * that sits near the line.
+ *
+ * Off (step 0, beginBlock()/endBlock() just return) until setEnabled(true).
+ * Unlike PerfStats it doesn't depend on a build flag: it reads the wall
+ * clock twice per block. getSnapshot() reports the step and how often it
+ * has moved, from any thread, through the same relaxed atomics PerfStats
+ * uses.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class CpuGovernor
+{
+public:
+    /** Deepest step; an engine with fewer actions repeats its last */
+    static constexpr int MAX_STEP = 3;
+
+    /** Block time / deadline above which the governor steps down */
+    static constexpr double HIGH_LOAD = 0.75;
+
+    /** Smoothed load under which it may step back up */
+    static constexpr double LOW_LOAD = 0.4;
+
+    /** Wait after stepping down before stepping down again */
+    static constexpr double SETTLE_SECONDS = 0.05;
+
+    /** Time under LOW_LOAD before each step back up */
+    static constexpr double RECOVER_SECONDS = 2.0;
+
+    struct Snapshot
+    {
+        bool enabled = false;
+        int step = 0;
+        uint64_t stepsDown = 0;  // Times it shed load
+        uint64_t stepsUp = 0;    // Times it recovered
+        double load = 0.0;       // Smoothed block time / deadline
+    };
+
+    /** Set the rate the deadlines are measured in and return to step 0 */
+    void prepare(double sr) noexcept
+    {
+        sampleRate = sr;
+        reset();
+    }
+
+    /** Back to step 0 with the counters cleared - only while the audio thread isn't rendering */
+    void reset() noexcept
+    {
+        step = 0;
+        stepsDown = stepsUp = 0;
+        load = 0.0;
+        settleLeft = recoverLeft = 0.0;
+        publish();
+    }
+
+    /** Opt in; turning it off returns to step 0 at the next endBlock() */
+    void setEnabled(bool on) noexcept { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /** Start of renderBlock() (audio thread) */
+    void beginBlock() noexcept
+    {
+        if (isEnabled())
+            blockStart = Clock::now();
+    }
+
+    /** End of renderBlock(): the step for the next block (audio thread) */
+    int endBlock(int numSamples) noexcept
+    {
+        if (!isEnabled())
+        {
+            if (step != 0)
+            {
+                step = 0;
+                publish();
+            }
+            return 0;
+        }
+        return update(std::chrono::duration<double>(Clock::now() - blockStart).count(), numSamples);
+    }
+
+    /** Feed one block's render time by hand (endBlock() without the clock; tests, offline) */
+    int update(double elapsedSeconds, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return step;
+
+        const double seconds = numSamples / sampleRate;
+        const double blockLoad = elapsedSeconds / seconds;
+
+        // About 100 ms of smoothing for the recovery check
+        const double alpha = std::min(1.0, seconds / 0.1);
+        load += alpha * (blockLoad - load);
+
+        settleLeft -= seconds;
+        if (blockLoad > HIGH_LOAD)
+        {
+            recoverLeft = RECOVER_SECONDS;
+            if (step < MAX_STEP && settleLeft <= 0.0)
+            {
+                ++step;
+                ++stepsDown;
+                settleLeft = SETTLE_SECONDS;
+            }
+        }
+        else if (step > 0 && load < LOW_LOAD)
+        {
+            recoverLeft -= seconds;
+            if (recoverLeft <= 0.0)
+            {
+                --step;
+                ++stepsUp;
+                recoverLeft = RECOVER_SECONDS;
+            }
+        }
+        else
+        {
+            recoverLeft = RECOVER_SECONDS;
+        }
+
+        publish();
+        return step;
+    }
+
+    /** The step endBlock() last returned */
+    int getStep() const noexcept { return step; }
+
+    /** Latest state (any thread) */
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot snap;
+        snap.enabled = isEnabled();
+        snap.step = shared.step.load(std::memory_order_relaxed);
+        snap.stepsDown = shared.stepsDown.load(std::memory_order_relaxed);
+        snap.stepsUp = shared.stepsUp.load(std::memory_order_relaxed);
+        snap.load = shared.load.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void publish() noexcept
+    {
+        shared.step.store(step, std::memory_order_relaxed);
+        shared.stepsDown.store(stepsDown, std::memory_order_relaxed);
+        shared.stepsUp.store(stepsUp, std::memory_order_relaxed);
+        shared.load.store(load, std::memory_order_relaxed);
+    }
+
+    double sampleRate = 48000.0;
+    std::atomic<bool> enabled{false};
+
+    // Audio thread only
+    Clock::time_point blockStart{};
+    int step = 0;
+    uint64_t stepsDown = 0;
+    uint64_t stepsUp = 0;
+    double load = 0.0;
+    double settleLeft = 0.0;   // Seconds before another step down
+    double recoverLeft = 0.0;  // Seconds of low load before a step up
+
+    // Published copy read by getSnapshot()
+    struct Shared
+    {
+        std::atomic<int> step{0};
+        std::atomic<uint64_t> stepsDown{0};
+        std::atomic<uint64_t> stepsUp{0};
+        std::atomic<double> load{0.0};
+    };
+
+    Shared shared;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file Denormals.h
+ * @brief Denormal policy: flush to zero where the FPU can, bias the feedback loops where it can't
+ *
+ * A feedback loop (comb, allpass, delay) decaying towards silence passes
+ * through the denormal range, where x86 and many ARM cores take a slow path
+ * that costs 10-100x per operation: CPU climbs as a reverb tail dies away.
+ *
+ * - ScopedFlushDenormals turns on flush-to-zero for the current thread
+ *   (MXCSR FTZ|DAZ on x86, FPCR.FZ on AArch64) and restores the caller's
+ *   mode on exit. Every engine's renderBlock() opens one, so the render and
+ *   bench harnesses, the tests and the worker threads (which copy the
+ *   caller's mode) get the same arithmetic as a plugin host.
+ * - WebAssembly mandates denormals and has no flush mode, so on targets
+ *   without one the loops keep themselves out of the range: each feedback
+ *   write adds Denormals::BIAS, a DC offset at -360 dB. A decaying tail
+ *   then settles on a tiny normal value instead of sinking through the
+ *   denormals. Where flushing works BIAS is zero and costs nothing.
+ *
+ *   combBuffer[pos] = input + filtered * gain + Denormals::BIAS;
+ */
+
+#pragma once
+
+#if (defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)) && !defined(__EMSCRIPTEN__)
+#include <xmmintrin.h>
+#define SYNTH_DENORMALS_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cstdint>
+#define SYNTH_DENORMALS_FPCR 1
+#endif
+
+namespace Denormals
+{
+#if defined(SYNTH_DENORMALS_MXCSR) || defined(SYNTH_DENORMALS_FPCR)
+/** The FPU can flush denormals to zero (ScopedFlushDenormals does something) */
+inline constexpr bool CAN_FLUSH = true;
+#else
+inline constexpr bool CAN_FLUSH = false;
+#endif
+
+/** Added to every feedback write so loops never decay into denormals (0 where flushing works) */
+inline constexpr float BIAS = CAN_FLUSH ? 0.0f : 1.0e-18f;
+} // namespace Denormals
+
+/**
+ * @brief Flush denormals to zero on this thread until the end of the scope
+ */
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals()
+    {
+#if defined(SYNTH_DENORMALS_MXCSR)
+        saved = _mm_getcsr();
+        _mm_setcsr(saved | 0x8040);  // FTZ | DAZ
+#elif defined(SYNTH_DENORMALS_FPCR)
+        asm volatile("mrs %0, fpcr" : "=r"(saved));
+        asm volatile("msr fpcr, %0" : : "r"(saved | (uint64_t{1} << 24)));  // FZ
+#endif
+    }
+
+    ~ScopedFlushDenormals()
+    {
+#if defined(SYNTH_DENORMALS_MXCSR)
+        _mm_setcsr(saved);
+#elif defined(SYNTH_DENORMALS_FPCR)
+        asm volatile("msr fpcr, %0" : : "r"(saved));
+#endif
+    }
+
+    ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+    ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+private:
+#if defined(SYNTH_DENORMALS_MXCSR)
+    unsigned int saved = 0;
+#elif defined(SYNTH_DENORMALS_FPCR)
+    uint64_t saved = 0;
+#endif
+};
@@ -0,0 +1,206 @@
+/**
+ * @file DspGraph.h
+ * @brief Compile-time signal graphs: nodes are types, edges are template arguments
+ *
+ * A fixed signal chain (oscillators -> shaper -> gain, summed) is written
+ * as a type, so the compiler sees the whole chain: every node's process()
+ * inlines into one loop body, and there are no virtual calls, no node
+ * lists and no buffers between nodes.
+ *
+ *   using Osc1 = DspGraph::Serial<Oscillator<OscShape::Saw>,
+ *                                 DspGraph::When<HAS_DRIVE, SoftClip<&Signals::drive>>,
+ *                                 DspGraph::Gain<&Signals::osc1Level>>;
+ *   using Source = DspGraph::Sum<Osc1, Osc2>;
+ *
+ *   Source source;                                   // Node state, inline
+ *   DspGraph::prepare(source, sampleRate);
+ *   DspGraph::node<0, 0>(source).setFrequency(hz);  // Osc1's oscillator
+ *   DspGraph::render(source, signals, out, n);       // One fused loop
+ *
+ * A node is any type with
+ *
+ *   template <typename T, typename Ctx> T process(T x, const Ctx& ctx, int i)
+ *
+ * and, optionally, prepare(double sampleRate) and reset(). x is the
+ * node's input for sample i of the block (sources ignore it), T the
+ * sample type (float, or a SIMD register for nodes that run four voices),
+ * and ctx whatever the caller renders with: typically a struct of
+ * per-sample arrays that Gain and Input read by member pointer.
+ *
+ * Nodes switched off at compile time (When<false, Node>) become Skip: no
+ * storage and no code, so a spec's absent features cost nothing.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace DspGraph
+{
+
+/** A node removed at compile time */
+struct Skip
+{
+};
+
+/** Node if Enabled, else nothing */
+template <bool Enabled, typename Node>
+using When = std::conditional_t<Enabled, Node, Skip>;
+
+template <typename Node>
+inline constexpr bool isSkip = std::is_same_v<Node, Skip>;
+
+/** prepare() every node that has one */
+template <typename Node>
+void prepare(Node& node, double sampleRate)
+{
+    if constexpr (requires { node.prepare(sampleRate); })
+        node.prepare(sampleRate);
+}
+
+/** reset() every node that has one */
+template <typename Node>
+void reset(Node& node)
+{
+    if constexpr (requires { node.reset(); })
+        node.reset();
+}
+
+/** Base of the combinators: children held inline, Skips taking no space */
+template <typename... Nodes>
+struct Group
+{
+    std::tuple<Nodes...> nodes;
+
+    static constexpr size_t SIZE = sizeof...(Nodes);
+
+    void prepare(double sampleRate)
+    {
+        std::apply([sampleRate](auto&... n) { (DspGraph::prepare(n, sampleRate), ...); }, nodes);
+    }
+
+    void reset()
+    {
+        std::apply([](auto&... n) { (DspGraph::reset(n), ...); }, nodes);
+    }
+};
+
+/** x -> Nodes[0] -> Nodes[1] -> ... */
+template <typename... Nodes>
+struct Serial : Group<Nodes...>
+{
+    template <typename T, typename Ctx>
+    T process(T x, const Ctx& ctx, int i)
+    {
+        return step<0>(x, ctx, i);
+    }
+
+private:
+    template <size_t I, typename T, typename Ctx>
+    T step(T x, const Ctx& ctx, int i)
+    {
+        if constexpr (I == sizeof...(Nodes))
+            return x;
+        else if constexpr (isSkip<std::tuple_element_t<I, std::tuple<Nodes...>>>)
+            return step<I + 1>(x, ctx, i);
+        else
+            return step<I + 1>(std::get<I>(this->nodes).process(x, ctx, i), ctx, i);
+    }
+};
+
+/** Every node fed x, outputs summed (a mixer; zero if every node is skipped) */
+template <typename... Nodes>
+struct Sum : Group<Nodes...>
+{
+    template <typename T, typename Ctx>
+    T process(T x, const Ctx& ctx, int i)
+    {
+        return add<0>(T{}, x, ctx, i);
+    }
+
+private:
+    template <size_t I, typename T, typename Ctx>
+    T add(T sum, T x, const Ctx& ctx, int i)
+    {
+        if constexpr (I == sizeof...(Nodes))
+            return sum;
+        else if constexpr (isSkip<std::tuple_element_t<I, std::tuple<Nodes...>>>)
+            return add<I + 1>(sum, x, ctx, i);
+        else
+            return add<I + 1>(sum + std::get<I>(this->nodes).process(x, ctx, i), x, ctx, i);
+    }
+};
+
+/** x scaled by a per-sample signal: (ctx.*Signal)[i] */
+template <auto Signal>
+struct Gain
+{
+    template <typename T, typename Ctx>
+    T process(T x, const Ctx& ctx, int i)
+    {
+        return x * (ctx.*Signal)[i];
+    }
+};
+
+/** A per-sample signal as a source (x ignored) */
+template <auto Signal>
+struct Input
+{
+    template <typename T, typename Ctx>
+    T process(T, const Ctx& ctx, int i)
+    {
+        return (ctx.*Signal)[i];
+    }
+};
+
+/**
+ * @brief A node inside a graph, by its index at each level
+ *
+ * node<1, 0>(g) is the first node of g's second node.
+ */
+template <size_t I, size_t... Rest, typename Graph>
+auto& node(Graph& graph)
+{
+    auto& child = std::get<I>(graph.nodes);
+    if constexpr (sizeof...(Rest) == 0)
+        return child;
+    else
+        return node<Rest...>(child);
+}
+
+/** Nodes a graph actually runs: leaves, not counting Skips */
+template <typename Node>
+struct LiveNodes
+{
+    static constexpr int value = isSkip<Node> ? 0 : 1;
+};
+
+template <template <typename...> class Combinator, typename... Nodes>
+    requires std::is_base_of_v<Group<Nodes...>, Combinator<Nodes...>>
+struct LiveNodes<Combinator<Nodes...>>
+{
+    static constexpr int value = (LiveNodes<Nodes>::value + ... + 0);
+};
+
+template <typename Graph>
+inline constexpr int liveNodes = LiveNodes<Graph>::value;
+
+/** n samples of a source graph into out, in one loop */
+template <typename Graph, typename Ctx, typename T>
+void render(Graph& graph, const Ctx& ctx, T* out, int n)
+{
+    for (int i = 0; i < n; ++i)
+        out[i] = graph.process(T{}, ctx, i);
+}
+
+/** n samples of a processing graph, in place */
+template <typename Graph, typename Ctx, typename T>
+void process(Graph& graph, const Ctx& ctx, T* io, int n)
+{
+    for (int i = 0; i < n; ++i)
+        io[i] = graph.process(io[i], ctx, i);
+}
+
+} // namespace DspGraph
@@ -0,0 +1,95 @@
+/**
+ * @file EditorRefresh.h
+ * @brief How often the editor's timer ticks, from what is on screen
+ *
+ * The editor used to tick at 30 Hz from opening to closing, pulling the
+ * scope and pushing JavaScript into a WebView nobody could see. Now the
+ * timer asks this instead:
+ *
+ *   - hidden or minimised: HIDDEN_HZ, only to notice the window coming back
+ *     (nothing is sent; changed parameters keep their flags until then)
+ *   - showing, no live view: IDLE_HZ, enough for knobs following automation
+ *   - showing with a live view (scope, spectrum, meters, sequencer):
+ *     LIVE_HZ, or BACKGROUND_HZ while another application has the focus
+ *
+ * The web UI names the live views it has on screen through the editor's
+ * "setLiveViews" native function, and names none when the page is hidden:
+ *
+ *   // Editor: the native function, then every timer tick
+ *   refresh.setLiveViews(EditorRefresh::viewFromName("scope") | ...);
+ *   refresh.setWindow(isShowing() && !peer->isMinimised(), juce::Process::isForegroundProcess());
+ *   scopeFifo.setConsumerAttached(refresh.wants(EditorRefresh::Scope));
+ *   if (getTimerInterval() != EditorRefresh::intervalMs(refresh.getRateHz())) ...
+ *
+ * @note Message thread only
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+class EditorRefresh
+{
+public:
+    /** Views the web UI can have on screen, as bits */
+    enum View : uint32_t
+    {
+        Scope = 1u << 0,
+        Spectrum = 1u << 1,
+        Meters = 1u << 2,
+        Sequencer = 1u << 3
+    };
+
+    static constexpr int HIDDEN_HZ = 1;
+    static constexpr int IDLE_HZ = 10;
+    static constexpr int BACKGROUND_HZ = 15;
+    static constexpr int LIVE_HZ = 30;
+
+    /** The bit for a view named by the web UI; 0 for names it doesn't know */
+    static uint32_t viewFromName(std::string_view name) noexcept
+    {
+        if (name == "scope")
+            return Scope;
+        if (name == "spectrum")
+            return Spectrum;
+        if (name == "meters")
+            return Meters;
+        if (name == "sequencer")
+            return Sequencer;
+        return 0;
+    }
+
+    /** Timer interval for a rate, as juce::Timer::startTimerHz() sets it */
+    static constexpr int intervalMs(int hz) noexcept { return 1000 / hz; }
+
+    /** Views on screen, per the web UI's last report */
+    void setLiveViews(uint32_t views) noexcept { liveViews = views; }
+    uint32_t getLiveViews() const noexcept { return liveViews; }
+
+    /** The editor's window: on screen (not hidden or minimised), and in the foreground application */
+    void setWindow(bool isShowing, bool isFocused) noexcept
+    {
+        showing = isShowing;
+        focused = isFocused;
+    }
+
+    bool isShowing() const noexcept { return showing; }
+
+    /** True while view is on screen, so its data is worth producing */
+    bool wants(View view) const noexcept { return showing && (liveViews & view) != 0; }
+
+    int getRateHz() const noexcept
+    {
+        if (!showing)
+            return HIDDEN_HZ;
+        if (liveViews == 0)
+            return IDLE_HZ;
+        return focused ? LIVE_HZ : BACKGROUND_HZ;
+    }
+
+private:
+    uint32_t liveViews = 0;
+    bool showing = false;
+    bool focused = true;
+};
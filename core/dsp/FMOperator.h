@@ -0,0 +1,197 @@
+/**
+ * @file FMOperator.h
+ * @brief Table-sine FM operators: one at a time, or four in one SIMD vector
+ *
+ * An operator is a phase accumulator (in cycles, 0-1) whose sine is read
+ * from a quarter-wave table instead of std::sin, with phase modulation in
+ * and its own output fed back into its phase:
+ *
+ *   out = sin(2 pi (phase + pm + feedback * lastOut));  phase += increment
+ *
+ * FMOperator runs one; FMOperatorQuad runs four, one per SSE lane, so a
+ * voice's operators cost one vector pass per sample. Operators that feed
+ * each other within a sample can't share a pass; voices pipeline them
+ * instead (see FMDrone's Voice, where the carrier runs a sample behind its
+ * modulator).
+ *
+ *   FMOperatorQuad ops;
+ *   ops.setFeedback(SIMD_MM(setr_ps)(0.0f, fb, 0.0f, 0.0f));
+ *   auto out = ops.process(pm, increments);   // Four sines, then advance
+ *
+ * The table is 1025 points over a quarter cycle, linearly interpolated:
+ * the error is under 3e-7, float rounding. It is computed by the compiler
+ * (ConstexprTables.h) and shared as read-only data. The reference build
+ * (ReferenceDsp.h) reads std::sin instead.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+#include "ConstexprTables.h"
+#include "ReferenceDsp.h"
+
+class FMSineTable
+{
+public:
+    static constexpr int QUARTER_POINTS = 1024;
+
+    /** The shared table (read-only data) */
+    static const FMSineTable& get()
+    {
+        static constexpr FMSineTable table{};
+        return table;
+    }
+
+    /** sin(2 pi x), x in cycles, any value */
+    float sine(float x) const noexcept
+    {
+        if constexpr (ReferenceDsp::ENABLED)
+            return static_cast<float>(std::sin(TWO_PI * static_cast<double>(x)));
+
+        x -= std::floor(x);
+        const float sign = x < 0.5f ? 1.0f : -1.0f;
+        const float half = x < 0.5f ? x : x - 0.5f;
+
+        // Fold the half cycle onto the rising quarter
+        const float pos = (0.25f - std::abs(half - 0.25f)) * SCALE;
+        const int i = static_cast<int>(pos);
+        const float frac = pos - static_cast<float>(i);
+        const float a = quarter[static_cast<size_t>(i)];
+        return sign * (a + (quarter[static_cast<size_t>(i + 1)] - a) * frac);
+    }
+
+    /** Four sines at once: the same folding, lane-wise */
+    SIMD_M128 sine(SIMD_M128 x) const noexcept
+    {
+        if constexpr (ReferenceDsp::ENABLED)
+        {
+            alignas(16) float lanes[4];
+            SIMD_MM(store_ps)(lanes, x);
+            for (float& lane : lanes)
+                lane = sine(lane);
+            return SIMD_MM(load_ps)(lanes);
+        }
+
+        const auto half = SIMD_MM(set1_ps)(0.5f);
+        const auto quarterCycle = SIMD_MM(set1_ps)(0.25f);
+        const auto absMask = SIMD_MM(castsi128_ps)(SIMD_MM(set1_epi32)(0x7FFFFFFF));
+
+        x = SIMD_MM(sub_ps)(x, floor(x));
+        const auto upper = SIMD_MM(cmpge_ps)(x, half);
+        const auto inHalf = SIMD_MM(sub_ps)(x, SIMD_MM(and_ps)(upper, half));
+        const auto folded = SIMD_MM(sub_ps)(quarterCycle, SIMD_MM(and_ps)(absMask, SIMD_MM(sub_ps)(inHalf, quarterCycle)));
+        const auto pos = SIMD_MM(mul_ps)(folded, SIMD_MM(set1_ps)(SCALE));
+
+        const auto index = SIMD_MM(cvttps_epi32)(pos);
+        const auto frac = SIMD_MM(sub_ps)(pos, SIMD_MM(cvtepi32_ps)(index));
+
+        // No gather in SSE: four scalar loads of each neighbour
+        alignas(16) int32_t idx[4];
+        alignas(16) float a[4];
+        alignas(16) float b[4];
+        SIMD_MM(store_si128)(reinterpret_cast<SIMD_M128I*>(idx), index);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            a[lane] = quarter[static_cast<size_t>(idx[lane])];
+            b[lane] = quarter[static_cast<size_t>(idx[lane] + 1)];
+        }
+        const auto va = SIMD_MM(load_ps)(a);
+        const auto value = SIMD_MM(add_ps)(va, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(load_ps)(b), va), frac));
+
+        // Flip the sign of the second half cycle
+        const auto signBit = SIMD_MM(and_ps)(upper, SIMD_MM(set1_ps)(-0.0f));
+        return SIMD_MM(xor_ps)(value, signBit);
+    }
+
+    /** Lane-wise floor (SSE2 has none: truncate, then step down negatives) */
+    static SIMD_M128 floor(SIMD_M128 x) noexcept
+    {
+        const auto truncated = SIMD_MM(cvtepi32_ps)(SIMD_MM(cvttps_epi32)(x));
+        const auto above = SIMD_MM(cmpgt_ps)(truncated, x);
+        return SIMD_MM(sub_ps)(truncated, SIMD_MM(and_ps)(above, SIMD_MM(set1_ps)(1.0f)));
+    }
+
+private:
+    static constexpr float SCALE = 4.0f * static_cast<float>(QUARTER_POINTS);
+    static constexpr double TWO_PI = 6.283185307179586;
+
+    constexpr FMSineTable() = default;
+
+    // One guard point past the peak, so the peak itself needs no clamp
+    std::array<float, QUARTER_POINTS + 2> quarter = ConstexprTables::make<float, QUARTER_POINTS + 2>([](size_t i) {
+        const size_t point = i <= size_t{QUARTER_POINTS} ? i : size_t{QUARTER_POINTS} - 1;  // The guard mirrors the peak
+        return ConstexprTables::sin(TWO_PI * (static_cast<double>(point) / (4.0 * QUARTER_POINTS)));
+    });
+};
+
+/**
+ * @brief One FM operator
+ */
+class FMOperator
+{
+public:
+    void reset(float startPhase = 0.0f)
+    {
+        phase = startPhase;
+        last = 0.0f;
+    }
+
+    /** Feedback: how much of the last output (in cycles) is added to the phase */
+    void setFeedback(float fb) { feedback = fb; }
+
+    /** One sample: the sine at phase + pm (cycles), then advance by increment */
+    float process(float pm, float increment) noexcept
+    {
+        last = table->sine(phase + pm + feedback * last);
+        phase += increment;
+        phase -= std::floor(phase);
+        return last;
+    }
+
+    float getPhase() const { return phase; }
+
+private:
+    const FMSineTable* table = &FMSineTable::get();
+    float phase = 0.0f;
+    float feedback = 0.0f;
+    float last = 0.0f;
+};
+
+/**
+ * @brief Four FM operators, one per SIMD lane
+ */
+class FMOperatorQuad
+{
+public:
+    /** Phases to (a, b, c, d), outputs to 0 */
+    void reset(float a = 0.0f, float b = 0.0f, float c = 0.0f, float d = 0.0f)
+    {
+        const auto start = SIMD_MM(setr_ps)(a, b, c, d);
+        phase = SIMD_MM(sub_ps)(start, FMSineTable::floor(start));
+        last = SIMD_MM(setzero_ps)();
+    }
+
+    /** Per-lane feedback, as FMOperator::setFeedback */
+    void setFeedback(SIMD_M128 fb) { feedback = fb; }
+
+    /** One sample of all four: the sines at phase + pm, then advance by increment */
+    SIMD_M128 process(SIMD_M128 pm, SIMD_M128 increment) noexcept
+    {
+        const auto x = SIMD_MM(add_ps)(SIMD_MM(add_ps)(phase, pm), SIMD_MM(mul_ps)(feedback, last));
+        last = table->sine(x);
+        phase = SIMD_MM(add_ps)(phase, increment);
+        phase = SIMD_MM(sub_ps)(phase, FMSineTable::floor(phase));
+        return last;
+    }
+
+private:
+    const FMSineTable* table = &FMSineTable::get();
+    SIMD_M128 phase = SIMD_MM(setzero_ps)();
+    SIMD_M128 feedback = SIMD_MM(setzero_ps)();
+    SIMD_M128 last = SIMD_MM(setzero_ps)();
+};
@@ -0,0 +1,453 @@
+/**
+ * @file FastMath.h
+ * @brief tanh, sin, exp, log and pow at the accuracy each call site needs
+ *
+ * Hot loops that call libm pay for accuracy they can't hear, and pay more
+ * in WASM, where libm is compiled code rather than a tuned platform
+ * library. Each function here takes its accuracy as a template argument,
+ * so the choice is made at the call site and costs nothing at run time:
+ *
+ *   Exact    std:: (the platform's libm)
+ *   Audio    tanh within 1e-4, sin 1e-5, exp2 and log2 about float
+ *            rounding: saturators, oscillators, anything heard directly
+ *   Control  within about 1e-3 (2e-2 for tanh): LFOs, level detectors,
+ *            anything whose value steers something else
+ *
+ *   out = FastMath::tanh(x * drive);                          // Audio
+ *   lfo = FastMath::sinCycles<FastMath::Accuracy::Control>(phase);
+ *   auto y = FastMath::tanh(SIMD_MM(load_ps)(in));            // Four lanes
+ *
+ * tanh and sin are sst-basic-blocks' Pade approximants (FastMath.h there,
+ * written out in detail:: so the scalar functions build without sst) with
+ * their ranges handled: tanh is clamped where it reaches +-1, sin takes
+ * any argument. exp2 and log2 split off the float's exponent and
+ * fit a polynomial to what's left, so they keep their accuracy across
+ * the whole range; exp, log10, pow and the dB conversions are built on
+ * them. tanh, sin, cos, exp2, exp and log2 have four-lane SIMD_M128
+ * overloads with the same results, where sst-basic-blocks is on the
+ * include path (FASTMATH_HAS_SIMD); the web build has only the scalar
+ * functions.
+ *
+ * The reference build (ReferenceDsp.h) makes every tier Exact.
+ * bench/fastmath measures each tier's error and speed.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "ReferenceDsp.h"
+
+#if __has_include("sst/basic-blocks/simd/setup.h")
+#include "sst/basic-blocks/dsp/FastMath.h"
+#include "sst/basic-blocks/simd/setup.h"
+#define FASTMATH_HAS_SIMD 1
+#else
+#define FASTMATH_HAS_SIMD 0
+#endif
+
+namespace FastMath
+{
+
+enum class Accuracy
+{
+    Exact,
+    Audio,
+    Control
+};
+
+/** True if a tier is std:: in this build */
+template <Accuracy A>
+inline constexpr bool USES_LIBM = A == Accuracy::Exact || ReferenceDsp::ENABLED;
+
+namespace detail
+{
+inline constexpr float LOG2_E = 1.44269504f;
+inline constexpr float LOG10_2 = 0.301029996f;
+inline constexpr float TWO_PI = 6.28318531f;
+inline constexpr float INV_TWO_PI = 0.159154943f;
+
+/** sst::basic_blocks::dsp::fastsin(), for x in [-pi, pi] */
+inline float fastsin(float x)
+{
+    const float x2 = x * x;
+    const float numerator = -x * (-11511339840.0f + x2 * (1640635920.0f + x2 * (-52785432.0f + x2 * 479249.0f)));
+    const float denominator = 11511339840.0f + x2 * (277920720.0f + x2 * (3177720.0f + x2 * 18361.0f));
+    return numerator / denominator;
+}
+
+/** sst::basic_blocks::dsp::fasttanh(), for |x| up to about 5 */
+inline float fasttanh(float x)
+{
+    const float x2 = x * x;
+    const float numerator = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+    const float denominator = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2));
+    return numerator / denominator;
+}
+
+#if FASTMATH_HAS_SIMD
+/** A libm function lane by lane, for the Exact tier's SIMD overloads */
+template <typename Fn>
+SIMD_M128 perLane(SIMD_M128 x, Fn&& fn)
+{
+    alignas(16) float lanes[4];
+    SIMD_MM(store_ps)(lanes, x);
+    for (float& lane : lanes)
+        lane = fn(lane);
+    return SIMD_MM(load_ps)(lanes);
+}
+
+/** Lane-wise floor (SSE2 has none: truncate, then step down negatives) */
+inline SIMD_M128 floor(SIMD_M128 x)
+{
+    const auto truncated = SIMD_MM(cvtepi32_ps)(SIMD_MM(cvttps_epi32)(x));
+    const auto above = SIMD_MM(cmpgt_ps)(truncated, x);
+    return SIMD_MM(sub_ps)(truncated, SIMD_MM(and_ps)(above, SIMD_MM(set1_ps)(1.0f)));
+}
+
+inline SIMD_M128 clamp(SIMD_M128 x, float lo, float hi)
+{
+    return SIMD_MM(min_ps)(SIMD_MM(set1_ps)(hi), SIMD_MM(max_ps)(SIMD_MM(set1_ps)(lo), x));
+}
+#endif
+
+/** 2^f for f in [-0.5, 0.5]: Taylor to f^6 (1e-7) or f^3 (6e-4) */
+template <Accuracy A>
+constexpr float exp2Fraction(float f)
+{
+    if constexpr (A == Accuracy::Control)
+        return 1.0f + f * (0.693147181f + f * (0.240226507f + f * 0.0555041087f));
+    else
+        return 1.0f
+               + f * (0.693147181f
+                      + f * (0.240226507f
+                             + f * (0.0555041087f + f * (0.00961812911f + f * (0.00133335581f + f * 0.000154035304f)))));
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A>
+SIMD_M128 exp2Fraction(SIMD_M128 f)
+{
+    const auto c = [](float v) { return SIMD_MM(set1_ps)(v); };
+#define M(a, b) SIMD_MM(mul_ps)(a, b)
+#define P(a, b) SIMD_MM(add_ps)(a, b)
+    if constexpr (A == Accuracy::Control)
+        return P(c(1.0f), M(f, P(c(0.693147181f), M(f, P(c(0.240226507f), M(f, c(0.0555041087f)))))));
+    else
+        return P(c(1.0f),
+                 M(f, P(c(0.693147181f),
+                        M(f, P(c(0.240226507f),
+                               M(f, P(c(0.0555041087f),
+                                      M(f, P(c(0.00961812911f), M(f, P(c(0.00133335581f), M(f, c(0.000154035304f)))))))))))));
+#undef M
+#undef P
+}
+#endif
+
+/** ln(m) for m in [sqrt(1/2), sqrt(2)]: atanh series to t^7 (3e-8) or t^3 (6e-5) */
+template <Accuracy A>
+constexpr float logMantissa(float m)
+{
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    if constexpr (A == Accuracy::Control)
+        return 2.0f * t * (1.0f + t2 * 0.333333333f);
+    else
+        return 2.0f * t * (1.0f + t2 * (0.333333333f + t2 * (0.2f + t2 * 0.142857143f)));
+}
+} // namespace detail
+
+//==============================================================================
+// tanh
+//==============================================================================
+
+/** tanh: Audio within 1e-4, exactly +-1 from |x| = 4.97; Control within 2e-2, +-1 from |x| = 3 */
+template <Accuracy A = Accuracy::Audio>
+inline float tanh(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::tanh(x);
+    else if constexpr (A == Accuracy::Control)
+    {
+        x = std::clamp(x, -3.0f, 3.0f);
+        const float x2 = x * x;
+        return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+    }
+    else
+        return std::clamp(detail::fasttanh(std::clamp(x, -4.97f, 4.97f)), -1.0f, 1.0f);
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 tanh(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::tanh(v); });
+    else if constexpr (A == Accuracy::Control)
+    {
+        x = detail::clamp(x, -3.0f, 3.0f);
+        const auto x2 = SIMD_MM(mul_ps)(x, x);
+        const auto num = SIMD_MM(mul_ps)(x, SIMD_MM(add_ps)(SIMD_MM(set1_ps)(27.0f), x2));
+        const auto den = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(27.0f), SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(9.0f), x2));
+        return SIMD_MM(div_ps)(num, den);
+    }
+    else
+        return detail::clamp(sst::basic_blocks::dsp::fasttanhSSE(detail::clamp(x, -4.97f, 4.97f)), -1.0f, 1.0f);
+}
+#endif
+
+//==============================================================================
+// sin / cos
+//==============================================================================
+
+/** sin(2 pi x), x in cycles, any value: Audio within 1e-5, Control within 1e-3 */
+template <Accuracy A = Accuracy::Audio>
+inline float sinCycles(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::sin(detail::TWO_PI * x);
+    else
+    {
+        x -= std::floor(x + 0.5f);  // [-0.5, 0.5)
+        if constexpr (A == Accuracy::Control)
+        {
+            // Parabola, then a second one through its own error
+            const float y = 8.0f * x - 16.0f * x * std::abs(x);
+            return 0.225f * (y * std::abs(y) - y) + y;
+        }
+        else
+            return detail::fastsin(detail::TWO_PI * x);
+    }
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 sinCycles(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::sin(detail::TWO_PI * v); });
+    else
+    {
+        x = SIMD_MM(sub_ps)(x, detail::floor(SIMD_MM(add_ps)(x, SIMD_MM(set1_ps)(0.5f))));
+        if constexpr (A == Accuracy::Control)
+        {
+            const auto absMask = SIMD_MM(castsi128_ps)(SIMD_MM(set1_epi32)(0x7FFFFFFF));
+            const auto y = SIMD_MM(sub_ps)(
+                SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(8.0f), x),
+                SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(16.0f), x), SIMD_MM(and_ps)(absMask, x)));
+            const auto bend = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(y, SIMD_MM(and_ps)(absMask, y)), y);
+            return SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(0.225f), bend), y);
+        }
+        else
+            return sst::basic_blocks::dsp::fastsinSSE(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(detail::TWO_PI), x));
+    }
+}
+#endif
+
+/** sin(x), x in radians, any value */
+template <Accuracy A = Accuracy::Audio>
+inline float sin(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::sin(x);
+    else
+        return sinCycles<A>(x * detail::INV_TWO_PI);
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 sin(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::sin(v); });
+    else
+        return sinCycles<A>(SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(detail::INV_TWO_PI)));
+}
+#endif
+
+/** cos(x), x in radians, any value */
+template <Accuracy A = Accuracy::Audio>
+inline float cos(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::cos(x);
+    else
+        return sinCycles<A>(x * detail::INV_TWO_PI + 0.25f);
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 cos(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::cos(v); });
+    else
+        return sinCycles<A>(
+            SIMD_MM(add_ps)(SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(detail::INV_TWO_PI)), SIMD_MM(set1_ps)(0.25f)));
+}
+#endif
+
+//==============================================================================
+// exp2 / exp
+//==============================================================================
+
+/** 2^x: Audio within 3e-7 relative, Control within 8e-4; x clamped to [-126, 127] */
+template <Accuracy A = Accuracy::Audio>
+inline float exp2(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::exp2(x);
+    else
+    {
+        x = std::clamp(x, -126.0f, 127.0f);
+        const float whole = std::floor(x + 0.5f);
+        const int32_t bits = (static_cast<int32_t>(whole) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return detail::exp2Fraction<A>(x - whole) * scale;
+    }
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 exp2(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::exp2(v); });
+    else
+    {
+        x = detail::clamp(x, -126.0f, 127.0f);
+        const auto whole = detail::floor(SIMD_MM(add_ps)(x, SIMD_MM(set1_ps)(0.5f)));
+        const auto bits = SIMD_MM(slli_epi32)(
+            SIMD_MM(add_epi32)(SIMD_MM(cvttps_epi32)(whole), SIMD_MM(set1_epi32)(127)), 23);
+        return SIMD_MM(mul_ps)(detail::exp2Fraction<A>(SIMD_MM(sub_ps)(x, whole)), SIMD_MM(castsi128_ps)(bits));
+    }
+}
+#endif
+
+/** e^x, as exp2(x log2 e): the product's rounding adds up to 1e-6 relative at |x| = 16 */
+template <Accuracy A = Accuracy::Audio>
+inline float exp(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::exp(x);
+    else
+        return exp2<A>(x * detail::LOG2_E);
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 exp(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::exp(v); });
+    else
+        return exp2<A>(SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(detail::LOG2_E)));
+}
+#endif
+
+//==============================================================================
+// log2 / log10 / pow
+//==============================================================================
+
+/** log2(x) for x > 0: Audio within 5e-7 absolute, Control within 1e-4; x below FLT_MIN reads as FLT_MIN */
+template <Accuracy A = Accuracy::Audio>
+inline float log2(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::log2(x);
+    else
+    {
+        x = std::max(x, 1.17549435e-38f);
+        int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        // Mantissa into [sqrt(1/2), sqrt(2)), the exponent adjusted to match
+        const int32_t offset = (bits - 0x3F3504F3) & static_cast<int32_t>(0xFF800000);
+        const int32_t exponent = offset >> 23;
+        const int32_t mantissaBits = bits - offset;
+        float m;
+        std::memcpy(&m, &mantissaBits, sizeof(m));
+        return static_cast<float>(exponent) + detail::logMantissa<A>(m) * detail::LOG2_E;
+    }
+}
+
+#if FASTMATH_HAS_SIMD
+template <Accuracy A = Accuracy::Audio>
+inline SIMD_M128 log2(SIMD_M128 x)
+{
+    if constexpr (USES_LIBM<A>)
+        return detail::perLane(x, [](float v) { return std::log2(v); });
+    else
+    {
+        x = SIMD_MM(max_ps)(x, SIMD_MM(set1_ps)(1.17549435e-38f));
+        const auto bits = SIMD_MM(castps_si128)(x);
+        const auto offset = SIMD_MM(and_si128)(SIMD_MM(sub_epi32)(bits, SIMD_MM(set1_epi32)(0x3F3504F3)),
+                                               SIMD_MM(set1_epi32)(static_cast<int32_t>(0xFF800000)));
+        const auto exponent = SIMD_MM(cvtepi32_ps)(SIMD_MM(srai_epi32)(offset, 23));
+        const auto m = SIMD_MM(castsi128_ps)(SIMD_MM(sub_epi32)(bits, offset));
+
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto t = SIMD_MM(div_ps)(SIMD_MM(sub_ps)(m, one), SIMD_MM(add_ps)(m, one));
+        const auto t2 = SIMD_MM(mul_ps)(t, t);
+        SIMD_M128 series;
+        if constexpr (A == Accuracy::Control)
+            series = SIMD_MM(add_ps)(one, SIMD_MM(mul_ps)(t2, SIMD_MM(set1_ps)(0.333333333f)));
+        else
+            series = SIMD_MM(add_ps)(
+                one, SIMD_MM(mul_ps)(t2, SIMD_MM(add_ps)(SIMD_MM(set1_ps)(0.333333333f),
+                                                         SIMD_MM(mul_ps)(t2, SIMD_MM(add_ps)(SIMD_MM(set1_ps)(0.2f),
+                                                                                             SIMD_MM(mul_ps)(t2, SIMD_MM(set1_ps)(0.142857143f)))))));
+        const auto ln = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(2.0f), t), series);
+        return SIMD_MM(add_ps)(exponent, SIMD_MM(mul_ps)(ln, SIMD_MM(set1_ps)(detail::LOG2_E)));
+    }
+}
+#endif
+
+template <Accuracy A = Accuracy::Audio>
+inline float log10(float x)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::log10(x);
+    else
+        return log2<A>(x) * detail::LOG10_2;
+}
+
+/** base^exponent for base > 0 */
+template <Accuracy A = Accuracy::Audio>
+inline float pow(float base, float exponent)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::pow(base, exponent);
+    else
+        return exp2<A>(exponent * log2<A>(base));
+}
+
+//==============================================================================
+// Decibels
+//==============================================================================
+
+/** 20 log10(gain), gain > 0 */
+template <Accuracy A = Accuracy::Audio>
+inline float gainToDb(float gain)
+{
+    if constexpr (USES_LIBM<A>)
+        return 20.0f * std::log10(gain);
+    else
+        return log2<A>(gain) * (20.0f * detail::LOG10_2);
+}
+
+/** 10^(dB / 20) */
+template <Accuracy A = Accuracy::Audio>
+inline float dbToGain(float db)
+{
+    if constexpr (USES_LIBM<A>)
+        return std::pow(10.0f, db / 20.0f);
+    else
+        return exp2<A>(db * (1.0f / (20.0f * detail::LOG10_2)));
+}
+
+} // namespace FastMath
@@ -0,0 +1,336 @@
+/**
+ * @file FdnReverb.h
+ * @brief Eight-line feedback delay network reverb, light enough for the web builds
+ *
+ * Eight delay lines of unrelated lengths feed back into each other
+ * through an 8x8 Hadamard matrix. The matrix is orthogonal, so the loop
+ * loses energy only through each line's gain and damping, and every line
+ * feeds every other on each trip, which builds echo density fast.
+ *
+ * The lines are DelayLine (StereoDelay.h), run a block at a time: read
+ * the run's taps, damp and mix them, write the run back. A run is never
+ * longer than the shortest line, so it reads only what's written. The
+ * mixing is a fast Walsh-Hadamard transform (three stages of butterflies,
+ * no multiplies), each butterfly a plain loop along the run that the
+ * compiler turns into SSE / NEON / WASM SIMD. Only the damping filters'
+ * recurrence goes sample by sample, the eight lines side by side.
+ *
+ * Nothing transcendental runs per sample. Each line's gain for the decay
+ * time (-60 dB after the same time whatever the line's length) and its
+ * damping pole (the same loss of highs per second whatever its length)
+ * are worked out in setDecay() and setDamping(). A slow sine moves each
+ * tap by a fraction of a millisecond to break up metallic ringing; the
+ * taps move once per RUN samples, on a fixed grid, so a block renders
+ * the same as sample by sample.
+ *
+ * The lines' memory comes from a vector the reverb owns (prepare(sr)) or
+ * from an Arena (prepare(sr, arena), with memoryNeeded()), stored as the
+ * Storage parameter says (SampleStorage.h); FdnReverb keeps floats.
+ *
+ *   FdnReverb reverb;
+ *   reverb.prepare(sr);
+ *   reverb.setDecay(2.0f);
+ *   reverb.setMix(0.3f);
+ *   reverb.processBlock(left, right, n);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Arena.h"
+#include "Denormals.h"
+#include "MemoryReport.h"
+#include "SilenceGate.h"
+#include "StereoDelay.h"
+
+template <typename Storage = SampleStorage::Float32>
+class BasicFdnReverb
+{
+public:
+    using Line = BasicDelayLine<Storage>;
+    using Stored = typename Storage::Stored;
+
+    static constexpr int LINES = 8;
+
+    /** Samples one line takes at @p sr */
+    static constexpr size_t lineCapacity(double sr)
+    {
+        return Line::capacityFor(static_cast<size_t>(sr * (LINE_SECONDS[LINES - 1] + 2.0 * MOD_SECONDS)) + 1);
+    }
+
+    /** Floats prepare(sr, arena) takes */
+    static constexpr size_t memoryNeeded(double sr)
+    {
+        return LINES * Arena::aligned(SampleStorage::floatsFor<Storage>(lineCapacity(sr)));
+    }
+
+    /** Lines from the reverb's own storage: only grown, a lower rate reuses it */
+    void prepare(double sr)
+    {
+        const size_t capacity = lineCapacity(sr);
+        if (storage.size() < LINES * capacity)
+            storage.assign(LINES * capacity, Stored{});
+        else
+            std::fill_n(storage.begin(), LINES * capacity, Stored{});
+        for (int k = 0; k < LINES; ++k)
+            lines[k].attach(storage.data() + static_cast<size_t>(k) * capacity, capacity);
+        setRate(sr);
+    }
+
+    /** Lines from @p arena; false if it's short */
+    bool prepare(double sr, Arena& arena)
+    {
+        const size_t capacity = lineCapacity(sr);
+        for (auto& line : lines)
+        {
+            Stored* const memory = arena.takeSamples<Stored>(capacity);
+            if (!memory)
+                return false;
+            line.attach(memory, capacity);
+        }
+        setRate(sr);
+        return true;
+    }
+
+    /** Silence the tail (prepare(sr) storage only) */
+    void clear()
+    {
+        std::fill(storage.begin(), storage.end(), Stored{});
+        lowpass.fill(0.0f);
+    }
+
+    /** Decay time in seconds (to -60 dB) */
+    void setDecay(float seconds)
+    {
+        decay = std::clamp(seconds, 0.1f, 10.0f);
+        updateGains();
+    }
+
+    /** High-frequency damping of the tail, 0-1 */
+    void setDamping(float d)
+    {
+        damping = std::clamp(d, 0.0f, 1.0f);
+        updateDamping();
+    }
+
+    /** Wet level, 0-1, linear (the dry level is 1 - mix) */
+    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
+
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
+
+    /** Mix the reverb into a block, in place */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        const float wetMix = mix * OUTPUT_GAIN;
+        const float dryMix = 1.0f - mix;
+
+        alignas(16) float taps[LINES][RUN];
+        alignas(16) float mixed[LINES][RUN];
+
+        for (int start = 0; start < numSamples;)
+        {
+            if (runPos == 0)
+                updateTaps();
+
+            const int run = std::min(numSamples - start, RUN - runPos);
+            float* const l = left + start;
+            float* const r = right + start;
+
+            for (int k = 0; k < LINES; ++k)
+                lines[k].readBlock(taps[k], run, tapDelays[k]);
+
+            damp(taps, mixed, run);
+            hadamard(mixed, run);
+
+            // Back into the lines with the input: left into the even lines,
+            // right into the odd
+            for (int k = 0; k < LINES; k += 2)
+            {
+                const float gainL = mixGains[k];
+                const float gainR = mixGains[k + 1];
+                float* const even = mixed[k];
+                float* const odd = mixed[k + 1];
+                for (int i = 0; i < run; ++i)
+                {
+                    even[i] = even[i] * gainL + l[i] + Denormals::BIAS;
+                    odd[i] = odd[i] * gainR + r[i] + Denormals::BIAS;
+                }
+                lines[k].writeBlock(even, run);
+                lines[k + 1].writeBlock(odd, run);
+            }
+
+            for (int i = 0; i < run; ++i)
+            {
+                const float wetL = taps[0][i] - taps[2][i] + taps[4][i] - taps[6][i];
+                const float wetR = taps[1][i] - taps[3][i] + taps[5][i] - taps[7][i];
+                l[i] = l[i] * dryMix + wetL * wetMix;
+                r[i] = r[i] * dryMix + wetR * wetMix;
+            }
+
+            runPos = (runPos + run) % RUN;
+            start += run;
+        }
+    }
+
+    /**
+     * @brief Samples until the tail falls below -120 dB (see SilenceGate.h)
+     *
+     * Every line loses 60 dB per decay time, so the longest line's trips
+     * bound the tail.
+     */
+    int64_t getTailSamples() const
+    {
+        return Silence::feedbackTail(lineSamples[LINES - 1] + modSamples, gains[LINES - 1]);
+    }
+
+    /** Bytes of delay line allocated by prepare(sr); none from an arena */
+    size_t getHeapBytes() const { return MemoryReport::bytesOf(storage); }
+
+private:
+    // Taps move every RUN samples; also the longest run read ahead
+    static constexpr int RUN = 64;
+
+    static constexpr float OUTPUT_GAIN = 0.35f;
+    static constexpr double MOD_SECONDS = 0.00025;
+    static constexpr float HADAMARD_SCALE = 0.35355339f;  // 1 / sqrt(LINES)
+
+    static constexpr double LINE_SECONDS[LINES] = {0.0297, 0.0341, 0.0389, 0.0437,
+                                                   0.0491, 0.0547, 0.0613, 0.0677};
+    static constexpr double MOD_HZ[LINES] = {0.31, 0.37, 0.43, 0.47, 0.53, 0.59, 0.67, 0.71};
+
+    /**
+     * One-pole lowpass of each line's taps. The lines' filters run side by
+     * side, one sample at a time, so the eight recurrences overlap.
+     */
+    void damp(const float (&in)[LINES][RUN], float (&out)[LINES][RUN], int run)
+    {
+        float state[LINES];
+        float pole[LINES];
+        float zero[LINES];
+        for (int k = 0; k < LINES; ++k)
+        {
+            state[k] = lowpass[k];
+            pole[k] = poles[k];
+            zero[k] = 1.0f - poles[k];
+        }
+
+        for (int i = 0; i < run; ++i)
+            for (int k = 0; k < LINES; ++k)
+            {
+                state[k] = state[k] * pole[k] + in[k][i] * zero[k];
+                out[k][i] = state[k];
+            }
+
+        for (int k = 0; k < LINES; ++k)
+            lowpass[k] = state[k];
+    }
+
+    /**
+     * Orthonormal 8-point Walsh-Hadamard transform of each sample across the
+     * lines, in place (less the 1 / sqrt(8), which is in mixGains): three
+     * stages of butterflies, each a loop over the run that vectorizes
+     */
+    static void hadamard(float (&v)[LINES][RUN], int run)
+    {
+        for (int h = 1; h < LINES; h <<= 1)
+            for (int j0 = 0; j0 < LINES; j0 += 2 * h)
+                for (int j = j0; j < j0 + h; ++j)
+                {
+                    float* const x = v[j];
+                    float* const y = v[j + h];
+                    for (int i = 0; i < run; ++i)
+                    {
+                        const float a = x[i];
+                        const float b = y[i];
+                        x[i] = a + b;
+                        y[i] = a - b;
+                    }
+                }
+    }
+
+    void setRate(double sr)
+    {
+        sampleRate = sr;
+        modSamples = MOD_SECONDS * sr;
+        for (int k = 0; k < LINES; ++k)
+        {
+            lineSamples[k] = LINE_SECONDS[k] * sr;
+            modPhase[k] = static_cast<double>(k) / LINES;
+            modIncrement[k] = MOD_HZ[k] * RUN / sr;
+        }
+        lowpass.fill(0.0f);
+        runPos = 0;
+        updateGains();
+        updateDamping();
+    }
+
+    /** Each line's gain per trip for -60 dB after the decay time */
+    void updateGains()
+    {
+        for (int k = 0; k < LINES; ++k)
+        {
+            const double trips = decay * sampleRate / (lineSamples[k] + modSamples);
+            gains[k] = static_cast<float>(std::pow(0.001, 1.0 / trips));
+            mixGains[k] = gains[k] * HADAMARD_SCALE;
+        }
+    }
+
+    /**
+     * One-pole lowpass per line. The shortest line's pole is the damping
+     * scaled to 0-0.9; a longer line loses as much at Nyquist per trip as
+     * the shortest loses over the same time.
+     */
+    void updateDamping()
+    {
+        const double pole = 0.9 * damping;
+        const double nyquistGain = (1.0 - pole) / (1.0 + pole);
+        for (int k = 0; k < LINES; ++k)
+        {
+            const double g = std::pow(nyquistGain, lineSamples[k] / lineSamples[0]);
+            poles[k] = static_cast<float>((1.0 - g) / (1.0 + g));
+        }
+    }
+
+    /** Move the taps along their sines; once per RUN samples */
+    void updateTaps()
+    {
+        constexpr double TWO_PI = 6.283185307179586;
+        for (int k = 0; k < LINES; ++k)
+        {
+            tapDelays[k] = static_cast<float>(lineSamples[k] + modSamples * (1.0 + std::sin(TWO_PI * modPhase[k])));
+            modPhase[k] += modIncrement[k];
+            modPhase[k] -= std::floor(modPhase[k]);
+        }
+    }
+
+    double sampleRate = 44100.0;
+    std::vector<Stored> storage;
+    std::array<Line, LINES> lines;
+
+    // Derived from the rate and the parameters
+    double lineSamples[LINES]{};
+    double modSamples = 0.0;
+    double modIncrement[LINES]{};
+    std::array<float, LINES> gains{};
+    std::array<float, LINES> mixGains{};  // gains with hadamard()'s 1 / sqrt(8)
+    std::array<float, LINES> poles{};
+
+    // Running state
+    std::array<float, LINES> lowpass{};
+    double modPhase[LINES]{};
+    float tapDelays[LINES]{};
+    int runPos = 0;
+
+    // Parameters
+    float decay = 2.0f;
+    float damping = 0.5f;
+    float mix = 0.0f;
+};
+
+using FdnReverb = BasicFdnReverb<>;
@@ -0,0 +1,238 @@
+/**
+ * @file FixedRateRenderer.h
+ * @brief Run an engine at a fixed internal rate, resampled to the host's
+ *
+ * An engine's cost per second scales with the host rate (at 192 kHz every
+ * per-sample loop runs four times as often as at 48 kHz), and so does
+ * anything sized in samples. With an internal rate set, the engine is
+ * prepared and rendered at that rate whatever the host runs at, and
+ * sst's LanczosResampler (4-lobe, stereo) converts its output to the
+ * host's:
+ *
+ *   // prepare (allocates)
+ *   fixedRate.prepare(hostRate, maxHostBlock, FixedRateRenderer::DEFAULT_RATE);
+ *   prepareInternals(fixedRate.getEngineRate(), fixedRate.getMaxEngineBlock());
+ *
+ *   // noteOn() and friends: offsets arrive in host samples
+ *   sampleOffset = fixedRate.toEngineOffset(sampleOffset);
+ *
+ *   // renderBlock
+ *   fixedRate.render(inL, inR, outL, outR, numSamples,
+ *                    [this](const float* l, const float* r, float* oL, float* oR, int n) { ... });
+ *
+ * Each host block asks the engine for however many samples the resampler
+ * needs to fill it (the block length times the rate ratio, give or take
+ * one), so events keep their place to within one internal sample. An
+ * input (nullptr for none) goes through a second resampler the other way,
+ * primed with silence so every block's worth is ready. Together they add
+ * toHostLatency() of delay.
+ *
+ * With no internal rate, or one equal to the host's, render() calls the
+ * engine straight through on the host's buffers.
+ *
+ * Going down (48 kHz internal, 44.1 kHz host) the kernel isn't widened,
+ * so the 22-24 kHz band folds back just under Nyquist rather than being
+ * filtered out; going up there is nothing to fold.
+ *
+ * @note prepare() allocates; everything else is audio-thread safe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "sst/basic-blocks/dsp/LanczosResampler.h"
+
+class FixedRateRenderer
+{
+public:
+    /** The internal rate the plugins offer */
+    static constexpr double DEFAULT_RATE = 48000.0;
+
+    /**
+     * @brief Size for the host's rate and block (allocates)
+     * @param engineRate Rate to render at, or 0 for the host's
+     */
+    void prepare(double hostRate, int maxHostBlock, double engineRate)
+    {
+        active = engineRate > 0.0 && std::abs(engineRate - hostRate) >= 1.0;
+        rate = active ? engineRate : hostRate;
+        ratio = rate / hostRate;
+
+        if (!active)
+        {
+            maxEngineBlock = maxHostBlock;
+            output.reset();
+            input.reset();
+            return;
+        }
+
+        // The resampler asks for at most ratio * (n + 1) + A + 3 inputs for n outputs
+        maxEngineBlock = static_cast<int>(std::ceil(ratio * (maxHostBlock + 1))) + static_cast<int>(Resampler::A) + 3;
+        output = std::make_unique<Resampler>(static_cast<float>(rate), static_cast<float>(hostRate));
+        input = std::make_unique<Resampler>(static_cast<float>(hostRate), static_cast<float>(rate));
+        engineInL.assign(static_cast<size_t>(maxEngineBlock), 0.0f);
+        engineInR.assign(static_cast<size_t>(maxEngineBlock), 0.0f);
+        engineOutL.assign(static_cast<size_t>(maxEngineBlock), 0.0f);
+        engineOutR.assign(static_cast<size_t>(maxEngineBlock), 0.0f);
+        reset();
+    }
+
+    /** Drop whatever the resamplers hold (the engine was reset) */
+    void reset()
+    {
+        if (!active)
+            return;
+
+        clear(*output);
+        clear(*input);
+
+        // Enough silence ahead of the input that each block's share is ready
+        const int priming = static_cast<int>(std::ceil((Resampler::A + 4) / ratio)) + static_cast<int>(Resampler::A) + 4;
+        for (int i = 0; i < priming; ++i)
+            input->push(0.0f, 0.0f);
+        lastInL = lastInR = 0.0f;
+        lastOutL = lastOutR = 0.0f;
+    }
+
+    /** True when the engine runs at a rate other than the host's */
+    bool isActive() const { return active; }
+
+    /** Rate to prepare the engine at */
+    double getEngineRate() const { return rate; }
+
+    /** Longest block render() hands the engine */
+    int getMaxEngineBlock() const { return maxEngineBlock; }
+
+    /** Resamplers and engine-rate buffers (MemoryReport) */
+    size_t getHeapBytes() const
+    {
+        return (output != nullptr ? 2 * sizeof(Resampler) : 0)
+               + (engineInL.capacity() + engineInR.capacity() + engineOutL.capacity() + engineOutR.capacity())
+                     * sizeof(float);
+    }
+
+    /** A host-block offset, in the block the engine is about to render */
+    int toEngineOffset(int hostOffset) const
+    {
+        return active ? static_cast<int>(std::lround(hostOffset * ratio)) : hostOffset;
+    }
+
+    /** The engine's latency plus the output resampler's, in host samples */
+    int toHostLatency(int engineLatency) const
+    {
+        return active ? static_cast<int>(std::lround((engineLatency + static_cast<int>(Resampler::A)) / ratio)) : engineLatency;
+    }
+
+    /**
+     * @brief Render @p numSamples host samples
+     * @param inputL,inputR Host-rate input, or nullptr for none
+     * @param render Called once as render(inL, inR, outL, outR, n) with engine-rate
+     *               buffers (the inputs nullptr if the caller's were)
+     */
+    template <typename RenderFn>
+    void render(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples,
+                RenderFn&& render)
+    {
+        if (!active)
+        {
+            render(inputL, inputR, outputL, outputR, numSamples);
+            return;
+        }
+        if (numSamples <= 0)
+            return;
+
+        const int engineSamples = std::min(
+            static_cast<int>(output->inputsRequiredToGenerateOutputs(static_cast<size_t>(numSamples))), maxEngineBlock);
+
+        if (inputL != nullptr)
+        {
+            resampleInput(inputL, inputR, numSamples, engineSamples);
+            render(engineInL.data(), engineInR.data(), engineOutL.data(), engineOutR.data(), engineSamples);
+        }
+        else
+        {
+            render(nullptr, nullptr, engineOutL.data(), engineOutR.data(), engineSamples);
+        }
+
+        // In slices, so a long block never laps the resampler's ring
+        int filled = 0;
+        int pushed = 0;
+        do
+        {
+            const int end = std::min(pushed + SLICE, engineSamples);
+            for (; pushed < end; ++pushed)
+                output->push(engineOutL[static_cast<size_t>(pushed)], engineOutR[static_cast<size_t>(pushed)]);
+
+            filled += static_cast<int>(
+                output->populateNext(outputL + filled, outputR + filled, static_cast<size_t>(numSamples - filled)));
+        } while (pushed < engineSamples);
+
+        // Never expected: hold the last sample rather than leave a gap
+        if (filled > 0)
+        {
+            lastOutL = outputL[filled - 1];
+            lastOutR = outputR[filled - 1];
+        }
+        std::fill(outputL + filled, outputL + numSamples, lastOutL);
+        std::fill(outputR + filled, outputR + numSamples, lastOutR);
+
+        output->renormalizePhases();
+    }
+
+private:
+    using Resampler = sst::basic_blocks::dsp::LanczosResampler<32>;
+
+    /** Samples pushed between pulls; well inside Resampler::BUFFER_SZ */
+    static constexpr int SLICE = 1024;
+
+    static void clear(Resampler& r)
+    {
+        std::fill(std::begin(r.input[0]), std::end(r.input[0]), 0.0f);
+        std::fill(std::begin(r.input[1]), std::end(r.input[1]), 0.0f);
+        r.wp = 0;
+        r.snapOutToIn();
+    }
+
+    void resampleInput(const float* inputL, const float* inputR, int numSamples, int engineSamples)
+    {
+        int filled = 0;
+        int pushed = 0;
+        do
+        {
+            const int end = std::min(pushed + SLICE, numSamples);
+            for (; pushed < end; ++pushed)
+                input->push(inputL[pushed], inputR[pushed]);
+
+            filled += static_cast<int>(input->populateNext(engineInL.data() + filled, engineInR.data() + filled,
+                                                           static_cast<size_t>(engineSamples - filled)));
+        } while (pushed < numSamples);
+
+        if (filled > 0)
+        {
+            lastInL = engineInL[static_cast<size_t>(filled - 1)];
+            lastInR = engineInR[static_cast<size_t>(filled - 1)];
+        }
+        std::fill(engineInL.begin() + filled, engineInL.begin() + engineSamples, lastInL);
+        std::fill(engineInR.begin() + filled, engineInR.begin() + engineSamples, lastInR);
+
+        input->renormalizePhases();
+    }
+
+    bool active = false;
+    double rate = 44100.0;
+    double ratio = 1.0;
+    int maxEngineBlock = 0;
+
+    std::unique_ptr<Resampler> output;  // Engine rate -> host rate
+    std::unique_ptr<Resampler> input;   // Host rate -> engine rate
+
+    std::vector<float> engineInL, engineInR;
+    std::vector<float> engineOutL, engineOutR;
+    float lastInL = 0.0f, lastInR = 0.0f;
+    float lastOutL = 0.0f, lastOutR = 0.0f;
+};
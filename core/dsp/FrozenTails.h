@@ -0,0 +1,130 @@
+/**
+ * @file FrozenTails.h
+ * @brief Released voices' tails, played out of the voice pool
+ *
+ * A drone's release can run for tens of seconds, and all that time the
+ * voice holds one of a handful of slots: the next note steals it and the
+ * tail stops dead. Once a voice is released and the parameters have held
+ * still, nothing more can change its tail, so the engine freezes it: the
+ * voice is copied into a tail slot here and goes straight back to the
+ * pool. Each slot renders its copy ahead a CHUNK at a time into its own
+ * buffer and mixes from there; the copy is dropped once it has rendered
+ * its last sample and the slot frees itself when the buffer runs dry.
+ *
+ *   // Per block, after the parameters were applied
+ *   if (voice.isReleasing() && paramsHeldStill && tails.freeze(voice))
+ *       voice.kill();                               // Its slot is free
+ *   tails.render(mixL, mixR, numSamples);
+ *
+ * A frozen tail is the sample-for-sample continuation of the voice with
+ * the parameters it had; only changes after it froze don't reach it.
+ * The Voice needs to be copyable and have render(left, right, n), adding
+ * into the buffers, and isActive().
+ *
+ * @note Audio thread only - fixed capacity, no allocations
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+template <typename Voice, int SLOTS, int CHUNK = 256>
+class FrozenTails
+{
+public:
+    /** Copy a released voice into a free slot; false if every slot is busy */
+    bool freeze(const Voice& voice)
+    {
+        for (Slot& slot : slots)
+        {
+            if (slot.busy)
+                continue;
+            slot.voice.emplace(voice);
+            slot.busy = true;
+            slot.readPos = slot.filled = 0;
+            ++count;
+            return true;
+        }
+        return false;
+    }
+
+    /** Add every tail's next numSamples into the buffers */
+    void render(float* outputL, float* outputR, int numSamples)
+    {
+        if (count == 0)
+            return;
+
+        for (Slot& slot : slots)
+        {
+            if (!slot.busy)
+                continue;
+
+            for (int done = 0; done < numSamples;)
+            {
+                if (slot.readPos == slot.filled && !refill(slot))
+                    break;
+
+                const int n = std::min(numSamples - done, slot.filled - slot.readPos);
+                const float* l = slot.left.data() + slot.readPos;
+                const float* r = slot.right.data() + slot.readPos;
+                for (int i = 0; i < n; ++i)
+                {
+                    outputL[done + i] += l[i];
+                    outputR[done + i] += r[i];
+                }
+                slot.readPos += n;
+                done += n;
+            }
+        }
+    }
+
+    /** Stop every tail */
+    void clear()
+    {
+        for (Slot& slot : slots)
+        {
+            slot.voice.reset();
+            slot.busy = false;
+        }
+        count = 0;
+    }
+
+    /** Tails still sounding */
+    int size() const { return count; }
+
+private:
+    struct Slot
+    {
+        std::array<float, CHUNK> left{};
+        std::array<float, CHUNK> right{};
+        std::optional<Voice> voice;  // Dropped once it has rendered its last sample
+        int readPos = 0;
+        int filled = 0;
+        bool busy = false;
+    };
+
+    /** Render the slot's next chunk; false (and the slot freed) if the tail has ended */
+    bool refill(Slot& slot)
+    {
+        if (!slot.voice)
+        {
+            slot.busy = false;
+            --count;
+            return false;
+        }
+
+        std::fill(slot.left.begin(), slot.left.end(), 0.0f);
+        std::fill(slot.right.begin(), slot.right.end(), 0.0f);
+        slot.voice->render(slot.left.data(), slot.right.data(), CHUNK);
+        if (!slot.voice->isActive())
+            slot.voice.reset();
+        slot.readPos = 0;
+        slot.filled = CHUNK;
+        return true;
+    }
+
+    std::array<Slot, SLOTS> slots{};
+    int count = 0;
+};
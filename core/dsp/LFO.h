@@ -0,0 +1,159 @@
+/**
+ * @file LFO.h
+ * @brief Bipolar modulation LFO: sine, triangle, saw, square, sample & hold
+ *
+ * The rate is in Hz, or a clock divider against a tempo (cycles per beat:
+ * 1 is a quarter note, 4 a sixteenth, 0.25 a bar). Callers clamp the rate
+ * to their own range; this only keeps it below Nyquist, so audio-rate
+ * ranges (the A-111-5's 5 kHz) run through the same class.
+ *
+ * process() steps one sample; advance(n) jumps n for control-rate
+ * modulators (ControlRate.h) and returns the value where it lands.
+ * getValue() reads the current value without stepping, for sequencers
+ * that sample the LFO once per step.
+ *
+ *   LFO lfo;
+ *   lfo.prepare(sampleRate);
+ *   lfo.setRate(2.0f);                     // Or setClockSyncRate(bpm, 4.0f)
+ *   lfo.setWaveform(LFO::Waveform::Triangle);
+ *   mod = lfo.advance(ControlRamp::BLOCK_SIZE);
+ *
+ * The phase is a double, so slow rates don't stall in float rounding.
+ * The sine is FastMath's Control tier. Sample & hold draws a new value
+ * from a fixed-seed LCG each time the phase wraps, so renders repeat.
+ *
+ * Header-only and free of sst, like ADEnvelope.h and
+ * PolyBlepOscillator.h, so the web builds share it too.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "FastMath.h"
+
+class LFO
+{
+public:
+    enum class Waveform { Sine, Triangle, Saw, Square, SampleHold };
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        phase = 0.0;
+        updatePhaseIncrement();
+    }
+
+    void setRate(float hz)
+    {
+        rate = std::max(0.0f, hz);
+        useClockSync = false;
+        updatePhaseIncrement();
+    }
+
+    /**
+     * @brief Set the rate from a tempo and clock divider
+     * @param bpm Tempo, clamped to 20-300
+     * @param divider Cycles per beat, clamped to 1/64-64
+     */
+    void setClockSyncRate(float bpm, float divider)
+    {
+        tempo = std::clamp(bpm, 20.0f, 300.0f);
+        clockDivider = std::clamp(divider, 0.015625f, 64.0f);
+        useClockSync = true;
+        updatePhaseIncrement();
+    }
+
+    void setWaveform(Waveform w) { waveform = w; }
+    /** From a choice parameter's index, in Waveform's order */
+    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 4)); }
+
+    /** Value at the current phase, without stepping: [-1, 1] */
+    float getValue() const { return valueAt(phase); }
+
+    /** One sample: the value at the current phase, then step */
+    float process()
+    {
+        // Sample & hold takes its next value as the phase wraps
+        if (waveform == Waveform::SampleHold && phase + phaseIncrement >= 1.0)
+            nextSampleHold();
+
+        const float output = valueAt(phase);
+        phase += phaseIncrement;
+        if (phase >= 1.0)
+            phase -= 1.0;
+        return output;
+    }
+
+    /**
+     * @brief Skip n samples ahead (control rate)
+     * @return Value at the new phase
+     */
+    float advance(int n)
+    {
+        phase += phaseIncrement * n;
+        if (phase >= 1.0)
+        {
+            phase -= std::floor(phase);
+            if (waveform == Waveform::SampleHold)
+                nextSampleHold();
+        }
+        return valueAt(phase);
+    }
+
+    void reset()
+    {
+        phase = 0.0;
+        sampleHoldValue = 0.0f;
+    }
+
+    float getPhase() const { return static_cast<float>(phase); }
+
+private:
+    void updatePhaseIncrement()
+    {
+        // Sync: one cycle per beat times the divider
+        const float hz = useClockSync ? tempo / 60.0f * clockDivider : rate;
+        phaseIncrement = std::min(static_cast<double>(hz), 0.5 * sampleRate) / sampleRate;
+    }
+
+    float valueAt(double p) const
+    {
+        const float x = static_cast<float>(p);
+        switch (waveform)
+        {
+            case Waveform::Sine:
+                return FastMath::sinCycles<FastMath::Accuracy::Control>(x);
+            case Waveform::Triangle:
+                return 4.0f * std::abs(x - 0.5f) - 1.0f;
+            case Waveform::Saw:
+                return 2.0f * x - 1.0f;
+            case Waveform::Square:
+                return p < 0.5 ? 1.0f : -1.0f;
+            case Waveform::SampleHold:
+                return sampleHoldValue;
+            default:
+                return 0.0f;
+        }
+    }
+
+    void nextSampleHold()
+    {
+        sampleHoldState = sampleHoldState * 1664525u + 1013904223u;
+        sampleHoldValue = static_cast<float>(sampleHoldState) / 2147483648.0f - 1.0f;
+    }
+
+    double sampleRate = 44100.0;
+    double phase = 0.0;
+    double phaseIncrement = 0.0;
+    float rate = 1.0f;
+    float tempo = 120.0f;
+    float clockDivider = 1.0f;
+    bool useClockSync = false;
+    Waveform waveform = Waveform::Sine;
+
+    float sampleHoldValue = 0.0f;
+    uint32_t sampleHoldState = 54321;
+};
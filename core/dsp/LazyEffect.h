@@ -0,0 +1,283 @@
+/**
+ * @file LazyEffect.h
+ * @brief An effect whose buffers exist only while it's in use
+ *
+ * A delay holds megabytes of line and a reverb half a megabyte whether
+ * their mix is up or not, and most patches leave one or the other off.
+ * LazyEffect keeps the effect object (its settings, always applied) but
+ * takes its buffers, through the effect's Arena interface, from a block
+ * that exists only while the effect is wanted:
+ *
+ *   - The audio thread asks for a block when the effect is switched on
+ *     (setWanted(true)) and has none. Allocating, and zeroing, it is left
+ *     to whoever calls service() off the audio thread; the block comes
+ *     back through an atomic, as Convolver.h's kernels do. The effect
+ *     attaches it at the next update() and fades in over FADE_SAMPLES, so
+ *     its empty lines don't step in.
+ *   - Once the effect has been off for RELEASE_SECONDS the audio thread
+ *     lets the block go on a retired list, and the next service() frees
+ *     it. Off means mix 0, where the effect passes its input through and
+ *     its tail is already inaudible, so dropping it is silent.
+ *
+ * Until its block arrives a wanted effect passes its input through: one
+ * trip through the message loop, tens of milliseconds.
+ *
+ * Offline renders can't wait for that, so lazy is a choice made at
+ * prepare(): eager allocates the block there, attaches it for good and
+ * renders exactly as the effect on its own would. An effect without the
+ * Arena interface (memoryNeeded(sr) and prepare(sr, arena)) is always
+ * eager and prepared with prepare(sr).
+ *
+ *   // prepare (not the audio thread)
+ *   delay.prepare(sr, !isNonRealtime());
+ *   // audio thread, per block
+ *   delay.setWanted(mix > 0.0f);
+ *   const bool ready = delay.update(n);
+ *   if (gate.process(silent, n, delay->getTailSamples()) && ready) delay.process(l, r, n);
+ *   if (delay.needsService()) triggerAsyncUpdate();
+ *   // message thread
+ *   delay.service();
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Arena.h"
+
+template <typename Effect>
+class LazyEffect
+{
+public:
+    /** Off for this long before the buffers go */
+    static constexpr double RELEASE_SECONDS = 5.0;
+
+    /** Fade in after the buffers attach */
+    static constexpr int FADE_SAMPLES = 512;
+
+    /** True if Effect takes its buffers from an Arena (otherwise always eager) */
+    static constexpr bool USES_ARENA = requires(Effect& e, Arena& a) {
+        Effect::memoryNeeded(48000.0);
+        e.prepare(48000.0, a);
+    };
+
+    LazyEffect() = default;
+    ~LazyEffect()
+    {
+        delete current;
+        delete incoming.exchange(nullptr);
+        freeRetired();
+    }
+
+    LazyEffect(const LazyEffect&) = delete;
+    LazyEffect& operator=(const LazyEffect&) = delete;
+
+    /** The effect, for its setters and getters; its buffers may not be there */
+    Effect* operator->() { return &effect; }
+    const Effect* operator->() const { return &effect; }
+
+    /**
+     * @brief Prepare at @p sr, dropping any buffers (not while rendering)
+     *
+     * Eager (@p lazy false) allocates the buffers now and keeps them.
+     */
+    void prepare(double sr, bool lazy)
+    {
+        sampleRate = sr;
+        releaseAfter = static_cast<int64_t>(sr * RELEASE_SECONDS);
+        isLazy = lazy && USES_ARENA;
+
+        delete current;
+        current = nullptr;
+        delete incoming.exchange(nullptr, std::memory_order_acq_rel);
+        freeRetired();
+        requested.store(false, std::memory_order_relaxed);
+        heldBytes.store(0, std::memory_order_relaxed);
+        asked = false;
+        idleSamples = 0;
+
+        if constexpr (USES_ARENA)
+        {
+            if (!isLazy)
+                attach(allocate(sr));
+        }
+        else
+        {
+            effect.prepare(sr);
+        }
+        fadePos = FADE_SAMPLES;
+    }
+
+    /** Whether the effect is switched on, its mix above 0 (audio thread, or before rendering) */
+    void setWanted(bool on) { wanted = on; }
+
+    /**
+     * @brief Attach, ask for or let go of the buffers (audio thread, once a block)
+     * @return True if the effect has its buffers and can process()
+     */
+    bool update(int numSamples)
+    {
+        if (!isLazy)
+            return true;
+
+        if (Block* block = incoming.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            if (current || block->sampleRate != sampleRate)
+                retire(block);
+            else
+                attach(block);
+            asked = false;
+        }
+
+        if (wanted && !current && !asked)
+        {
+            requestedRate.store(sampleRate, std::memory_order_relaxed);
+            requested.store(true, std::memory_order_release);
+            asked = true;
+        }
+
+        if (current && !wanted)
+        {
+            idleSamples += numSamples;
+            if (idleSamples >= releaseAfter)
+            {
+                retire(current);
+                current = nullptr;
+                heldBytes.store(0, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            idleSamples = 0;
+        }
+        return current != nullptr;
+    }
+
+    /** Process a block in place, fading in after the buffers attach (only after update() said so) */
+    void process(float* left, float* right, int numSamples)
+    {
+        int start = 0;
+        while (fadePos < FADE_SAMPLES && start < numSamples)
+        {
+            const int run = std::min({numSamples - start, FADE_SAMPLES - fadePos, RUN});
+            float dryL[RUN];
+            float dryR[RUN];
+            std::copy(left + start, left + start + run, dryL);
+            std::copy(right + start, right + start + run, dryR);
+
+            effect.processBlock(left + start, right + start, run);
+
+            for (int i = 0; i < run; ++i)
+            {
+                const float g = static_cast<float>(fadePos + i + 1) / static_cast<float>(FADE_SAMPLES);
+                left[start + i] = dryL[i] + (left[start + i] - dryL[i]) * g;
+                right[start + i] = dryR[i] + (right[start + i] - dryR[i]) * g;
+            }
+            fadePos += run;
+            start += run;
+        }
+
+        if (start < numSamples)
+            effect.processBlock(left + start, right + start, numSamples - start);
+    }
+
+    /** True if service() has a block to allocate or free (audio thread polls) */
+    bool needsService() const
+    {
+        return requested.load(std::memory_order_acquire) || retired.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /** Allocate the block the audio thread asked for and free the ones it let go (not the audio thread) */
+    void service()
+    {
+        if constexpr (USES_ARENA)
+        {
+            if (requested.exchange(false, std::memory_order_acquire))
+                delete incoming.exchange(allocate(requestedRate.load(std::memory_order_relaxed)),
+                                         std::memory_order_acq_rel);  // One nobody took
+        }
+        freeRetired();
+    }
+
+    /** True while the buffers are attached */
+    bool isAttached() const { return !isLazy || current != nullptr; }
+
+    /** Bytes of buffer held now (any thread) */
+    size_t getHeapBytes() const { return heldBytes.load(std::memory_order_relaxed); }
+
+private:
+    // Longest run of the fade (its dry copy is on the stack)
+    static constexpr int RUN = 128;
+
+    struct Block
+    {
+        std::unique_ptr<float[]> memory;
+        size_t floats = 0;
+        double sampleRate = 0.0;
+        Block* nextRetired = nullptr;
+    };
+
+    /** A zeroed block for @p sr (not the audio thread) */
+    static Block* allocate(double sr)
+    {
+        auto* block = new Block;
+        block->floats = Effect::memoryNeeded(sr);
+        block->memory.reset(new float[block->floats]());
+        block->sampleRate = sr;
+        return block;
+    }
+
+    /** Hand @p block's memory to the effect and fade it in */
+    void attach(Block* block)
+    {
+        Arena arena(block->memory.get(), block->floats, true);
+        effect.prepare(block->sampleRate, arena);
+        current = block;
+        fadePos = 0;
+        idleSamples = 0;
+        heldBytes.store(block->floats * sizeof(float), std::memory_order_relaxed);
+    }
+
+    /** Push @p block on the retired list (audio thread); service() frees it */
+    void retire(Block* block)
+    {
+        block->nextRetired = retired.load(std::memory_order_relaxed);
+        while (!retired.compare_exchange_weak(block->nextRetired, block, std::memory_order_release,
+                                              std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void freeRetired()
+    {
+        for (Block* b = retired.exchange(nullptr, std::memory_order_acquire); b;)
+        {
+            Block* const next = b->nextRetired;
+            delete b;
+            b = next;
+        }
+    }
+
+    Effect effect;
+
+    double sampleRate = 44100.0;
+    int64_t releaseAfter = 0;
+    bool isLazy = false;
+
+    // Audio thread
+    Block* current = nullptr;
+    bool wanted = false;
+    bool asked = false;  // requested set and no block back yet
+    int64_t idleSamples = 0;
+    int fadePos = FADE_SAMPLES;
+
+    std::atomic<bool> requested{false};
+    std::atomic<double> requestedRate{44100.0};
+    std::atomic<Block*> incoming{nullptr};
+    std::atomic<Block*> retired{nullptr};
+    std::atomic<size_t> heldBytes{0};
+};
@@ -0,0 +1,314 @@
+/**
+ * @file MappedSample.h
+ * @brief One-shot samples played straight from a memory-mapped file, shared per process
+ *
+ * Loading a sample kit into every instance's heap costs its size per
+ * instance and a decode on every session load. A MappedSample instead maps
+ * a preconverted file read-only: the samples are the file's pages, held
+ * once in the OS page cache however many instances play them, and opening
+ * it reads nothing but the header. Only the first PREFETCH_SECONDS are
+ * copied into RAM (as float), so a hit starts without touching the file;
+ * the rest is asked of the page cache ahead of time (madvise WILLNEED) and
+ * read from the mapping as playback gets there.
+ *
+ *   MappedSample::saveFile("kick.ams", left, right, frames, 48000);    // Preconvert, once
+ *   auto kick = MappedSampleRegistry::get().load("kick.ams");        // Not on the audio thread
+ *   float y = kick->sample(0, frame);                                // Audio thread
+ *
+ * On disk a sample is an .ams file: "AMS1", then sample rate (uint32),
+ * channels (uint16, 1 or 2), a zero uint16 and frame count (uint32), all
+ * little-endian, then the frames as interleaved int16. The samples are
+ * read in place, so the file is the format the voices play: there is no
+ * decoding step to skip.
+ *
+ * Samples are immutable and held by shared_ptr. The registry hands every
+ * caller asking for the same file the same sample, mapping it on the first
+ * request, and keeps only weak references, so a file is unmapped when its
+ * last user lets go.
+ *
+ * WASM has no file mapping: there the file is read into the heap, which
+ * is no worse than before. The same goes for any file that won't map.
+ *
+ * @note A read past the head can fault in a page the OS has evicted since
+ *       the prefetch; the head covers the start of every hit, where that
+ *       would be heard as a late hit rather than a late tail.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define SYNTH_MAPPED_SAMPLE_WIN32 1
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__) && (defined(__unix__) || defined(__APPLE__))
+#define SYNTH_MAPPED_SAMPLE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedSample
+{
+public:
+    static_assert(std::endian::native == std::endian::little, "MappedSample reads the little-endian file in place");
+
+    /** How much of each sample is copied into RAM, so a hit starts without the page cache */
+    static constexpr float PREFETCH_SECONDS = 0.02f;
+
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr size_t HEADER_BYTES = 16;
+
+    ~MappedSample() { unmap(); }
+
+    MappedSample(const MappedSample&) = delete;
+    MappedSample& operator=(const MappedSample&) = delete;
+
+    /**
+     * @brief Write a sample as an .ams file (clipped to +/-1)
+     * @param right nullptr for a mono sample
+     */
+    static bool saveFile(const std::string& path, const float* left, const float* right, size_t frames,
+                         uint32_t sampleRate)
+    {
+        if (left == nullptr || frames == 0 || frames > UINT32_MAX || sampleRate == 0)
+            return false;
+
+        std::unique_ptr<FILE, int (*)(FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        if (!file)
+            return false;
+
+        const uint16_t channels = right != nullptr ? 2 : 1;
+        std::vector<uint8_t> bytes = {'A', 'M', 'S', '1'};
+        const auto put = [&bytes](uint32_t v, int size) {
+            for (int b = 0; b < size; ++b)
+                bytes.push_back(static_cast<uint8_t>(v >> (8 * b)));
+        };
+        put(sampleRate, 4);
+        put(channels, 2);
+        put(0, 2);
+        put(static_cast<uint32_t>(frames), 4);
+
+        bytes.reserve(HEADER_BYTES + frames * channels * 2);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (const float* channel : {left, right})
+            {
+                if (channel == nullptr)
+                    continue;
+                const auto value = static_cast<int16_t>(std::lround(std::clamp(channel[i], -1.0f, 1.0f) * 32767.0f));
+                put(static_cast<uint16_t>(value), 2);
+            }
+        }
+        return std::fwrite(bytes.data(), 1, bytes.size(), file.get()) == bytes.size();
+    }
+
+    /** Map an .ams file; nullptr if it can't be read or isn't one */
+    static std::shared_ptr<const MappedSample> open(const std::string& path)
+    {
+        std::shared_ptr<MappedSample> sample(new MappedSample());
+        if (!sample->map(path) || !sample->parse())
+            return nullptr;
+        sample->prefetch();
+        return sample;
+    }
+
+    size_t getFrames() const { return frames; }
+    int getChannels() const { return channels; }
+    double getSampleRate() const { return sampleRate; }
+
+    /** Frames copied into RAM: min(frames, PREFETCH_SECONDS at the file's rate) */
+    size_t getHeadFrames() const { return headFrames; }
+
+    /** Frame (< getFrames()) of channel; a mono sample gives the same for either */
+    float sample(int channel, size_t frame) const noexcept
+    {
+        const size_t index = frame * static_cast<size_t>(channels) + (channel < channels ? static_cast<size_t>(channel) : 0);
+        if (frame < headFrames)
+            return head[index];
+        return static_cast<float>(body[index]) * (1.0f / 32767.0f);
+    }
+
+    /** True if the samples are the file's pages, false if they were read into the heap */
+    bool isMapped() const { return mapped != nullptr; }
+
+    /** Bytes of the file the samples are read from (in the page cache if mapped) */
+    size_t getFileBytes() const { return size; }
+
+    /** Bytes held in the heap: the head, plus the whole file if it couldn't be mapped */
+    size_t getHeapBytes() const { return head.capacity() * sizeof(float) + copy.capacity(); }
+
+private:
+    MappedSample() = default;
+
+    bool map(const std::string& path)
+    {
+#if SYNTH_MAPPED_SAMPLE_POSIX
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat info{};
+            if (::fstat(fd, &info) == 0 && info.st_size > static_cast<off_t>(HEADER_BYTES))
+            {
+                void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                if (view != MAP_FAILED)
+                {
+                    mapped = view;
+                    size = static_cast<size_t>(info.st_size);
+                    data = static_cast<const uint8_t*>(view);
+                }
+            }
+            ::close(fd);  // The mapping keeps the file
+            if (mapped != nullptr)
+                return true;
+        }
+#elif SYNTH_MAPPED_SAMPLE_WIN32
+        const int wide = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+        std::wstring widePath(static_cast<size_t>(std::max(wide, 1)), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), wide);
+
+        HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER fileSize{};
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > static_cast<LONGLONG>(HEADER_BYTES))
+            {
+                if (HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+                {
+                    if (void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+                    {
+                        mapped = view;
+                        size = static_cast<size_t>(fileSize.QuadPart);
+                        data = static_cast<const uint8_t*>(view);
+                    }
+                    CloseHandle(mapping);  // The view keeps the mapping
+                }
+            }
+            CloseHandle(file);
+            if (mapped != nullptr)
+                return true;
+        }
+#endif
+        // No mapping here: read the file into the heap
+        std::unique_ptr<FILE, int (*)(FILE*)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+        if (!file)
+            return false;
+        uint8_t buffer[65536];
+        for (size_t got; (got = std::fread(buffer, 1, sizeof(buffer), file.get())) > 0;)
+            copy.insert(copy.end(), buffer, buffer + got);
+        size = copy.size();
+        data = copy.data();
+        return size > HEADER_BYTES;
+    }
+
+    void unmap()
+    {
+        if (mapped == nullptr)
+            return;
+#if SYNTH_MAPPED_SAMPLE_POSIX
+        ::munmap(mapped, size);
+#elif SYNTH_MAPPED_SAMPLE_WIN32
+        UnmapViewOfFile(mapped);
+#endif
+        mapped = nullptr;
+    }
+
+    /** Check the header, point body at the frames and copy the head out */
+    bool parse()
+    {
+        if (std::memcmp(data, "AMS1", 4) != 0)
+            return false;
+
+        const auto u32 = [this](size_t at) {
+            return static_cast<uint32_t>(data[at]) | static_cast<uint32_t>(data[at + 1]) << 8
+                   | static_cast<uint32_t>(data[at + 2]) << 16 | static_cast<uint32_t>(data[at + 3]) << 24;
+        };
+        const uint32_t rate = u32(4);
+        const uint32_t channelCount = u32(8) & 0xFFFFu;
+        frames = u32(12);
+        if (rate == 0 || channelCount < 1 || channelCount > MAX_CHANNELS || frames == 0
+            || frames > (size - HEADER_BYTES) / (channelCount * 2))
+            return false;
+
+        sampleRate = static_cast<double>(rate);
+        channels = static_cast<int>(channelCount);
+        body = reinterpret_cast<const int16_t*>(data + HEADER_BYTES);
+
+        headFrames = std::min(frames, static_cast<size_t>(std::ceil(PREFETCH_SECONDS * sampleRate)));
+        head.resize(headFrames * channelCount);
+        for (size_t i = 0; i < head.size(); ++i)
+            head[i] = static_cast<float>(body[i]) * (1.0f / 32767.0f);
+        return true;
+    }
+
+    /** Ask the OS to read the rest into the page cache now, not at the first hit */
+    void prefetch() const
+    {
+#if SYNTH_MAPPED_SAMPLE_POSIX
+        if (mapped != nullptr)
+            ::madvise(mapped, size, MADV_WILLNEED);
+#endif
+    }
+
+    void* mapped = nullptr;         // The view, if the file is mapped
+    std::vector<uint8_t> copy;      // The file, if it isn't
+    const uint8_t* data = nullptr;  // The file, either way
+    size_t size = 0;
+
+    const int16_t* body = nullptr;  // Interleaved frames, in the file
+    std::vector<float> head;        // The first headFrames of body, in RAM
+    size_t frames = 0;
+    size_t headFrames = 0;
+    int channels = 1;
+    double sampleRate = 44100.0;
+};
+
+/**
+ * @brief The process's mapped samples, opened on first request and shared
+ *
+ * Call from the message thread or a loader, not the audio thread: a first
+ * request maps the file and copies its head.
+ */
+class MappedSampleRegistry
+{
+public:
+    static MappedSampleRegistry& get()
+    {
+        static MappedSampleRegistry registry;
+        return registry;
+    }
+
+    /** The sample in an .ams file; nullptr if it can't be read */
+    std::shared_ptr<const MappedSample> load(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto sample = samples[path].lock())
+            return sample;
+        auto sample = MappedSample::open(path);
+        samples[path] = sample;
+        return sample;
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<const MappedSample>> samples;
+};
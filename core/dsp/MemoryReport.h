@@ -0,0 +1,135 @@
+/**
+ * @file MemoryReport.h
+ * @brief What one engine instance costs in memory, by component
+ *
+ * Each engine's memoryReport() fills one in (never on the audio thread):
+ *
+ *   - static: sizeof(engine), with its biggest inline members listed
+ *     (mix buffers, reverb delay lines held as arrays)
+ *   - heap: what prepare() allocated (tape, delay lines, effects), which
+ *     mostly scales with the sample rate
+ *   - shared: process-wide tables every instance reads (pitch tables,
+ *     sinc kernels), paid once however many instances there are
+ *
+ * getInstanceBytes() (static + heap) is what one more instance costs;
+ * the tests hold each engine to a budget at 48 and 192 kHz, and
+ * projectMemory() prepares fresh engines at several rates to show how the
+ * heap grows.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MemoryReport
+{
+public:
+    enum class Kind
+    {
+        Inline,  // Part of sizeof(engine)
+        Heap,    // Allocated by prepare()
+        Shared   // Process-wide, paid once
+    };
+
+    struct Entry
+    {
+        const char* component;
+        Kind kind;
+        size_t bytes;
+    };
+
+    explicit MemoryReport(size_t engineBytes) : staticBytes(engineBytes) {}
+
+    /** A large member already counted in the static size */
+    void addInline(const char* component, size_t bytes) { entries.push_back({component, Kind::Inline, bytes}); }
+
+    /** Buffers prepare() allocated for this instance */
+    void addHeap(const char* component, size_t bytes) { entries.push_back({component, Kind::Heap, bytes}); }
+
+    /** Tables shared by every instance in the process */
+    void addShared(const char* component, size_t bytes) { entries.push_back({component, Kind::Shared, bytes}); }
+
+    size_t getStaticBytes() const { return staticBytes; }
+    size_t getHeapBytes() const { return sum(Kind::Heap); }
+    size_t getSharedBytes() const { return sum(Kind::Shared); }
+
+    /** What one more instance costs: static + heap */
+    size_t getInstanceBytes() const { return staticBytes + getHeapBytes(); }
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    /** Bytes listed under this component name (0 if not listed) */
+    size_t getBytes(const std::string& component) const
+    {
+        size_t total = 0;
+        for (const auto& e : entries)
+            if (component == e.component)
+                total += e.bytes;
+        return total;
+    }
+
+    /** Heap actually held by a vector (its capacity, not its size) */
+    template <typename T>
+    static size_t bytesOf(const std::vector<T>& v)
+    {
+        return v.capacity() * sizeof(T);
+    }
+
+    /** A readable table, one component per line, sizes in KiB */
+    std::string toString() const
+    {
+        std::string text;
+        char line[128];
+        auto add = [&](const char* label, const char* kind, size_t bytes) {
+            std::snprintf(line, sizeof(line), "  %-28s %-7s %12.1f KiB\n", label, kind,
+                          static_cast<double>(bytes) / 1024.0);
+            text += line;
+        };
+
+        add("static (sizeof)", "", staticBytes);
+        for (const auto& e : entries)
+            add(e.component, e.kind == Kind::Inline ? "inline" : e.kind == Kind::Heap ? "heap" : "shared", e.bytes);
+        add("per instance", "", getInstanceBytes());
+        return text;
+    }
+
+private:
+    size_t sum(Kind kind) const
+    {
+        size_t total = 0;
+        for (const auto& e : entries)
+            if (e.kind == kind)
+                total += e.bytes;
+        return total;
+    }
+
+    size_t staticBytes;
+    std::vector<Entry> entries;
+};
+
+/**
+ * @brief Prepare a fresh engine at each rate and report it
+ *
+ * Engines only grow their buffers, so each rate gets its own instance
+ * (on the heap: some are too big for the stack).
+ */
+template <typename Engine>
+std::vector<std::pair<double, MemoryReport>> projectMemory(std::initializer_list<double> sampleRates = {44100.0, 48000.0,
+                                                                                                          96000.0, 192000.0},
+                                                           int maxBlockSize = 512)
+{
+    std::vector<std::pair<double, MemoryReport>> reports;
+    for (const double rate : sampleRates)
+    {
+        auto engine = std::make_unique<Engine>();
+        engine->prepare(rate, maxBlockSize);
+        reports.emplace_back(rate, engine->memoryReport());
+    }
+    return reports;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file MidiEventQueue.h
+ * @brief Timestamped MIDI events for sample-accurate rendering
+ *
+ * The processor hands every event in the block's MidiBuffer to the engine
+ * with its sample offset. Events at offset 0 are applied right away; later
+ * ones are queued here, and SynthEngine::renderBlock() renders up to each
+ * event, applies it, and carries on.
+ *
+ * Sub-blocks are never shorter than MIN_SUB_BLOCK samples (except the last
+ * one in a block), so a dense burst of MIDI is applied together rather than
+ * chopping the block into tiny pieces. An event can land at most
+ * MIN_SUB_BLOCK - 1 samples late.
+ *
+ * Hosts with sorted in-block events (CLAP) can schedule more than MIDI: a
+ * parameter change, a per-note expression or a per-note (polyphonic)
+ * modulation lands on its sample the same way. Engines ignore the types
+ * they don't handle.
+ *
+ * @note Audio thread only - fixed capacity, no allocations
+ */
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+
+/**
+ * @brief One MIDI event scheduled within the current block
+ */
+struct MidiEvent
+{
+    enum class Type { NoteOn, NoteOff, AllNotesOff, PitchBend, Pressure, Slide, Param, NoteExpression, NoteModulation };
+
+    Type type = Type::NoteOn;
+    int sampleOffset = 0;
+    int note = 0;        // -1 in NoteExpression / NoteModulation: every note
+    float value = 0.0f;  // Velocity for NoteOn, bend (-1 to 1), pressure (0 to 1), slide (-1 to 1),
+                         // or a parameter value / modulation amount in its own units
+    int channel = 0;     // MIDI channel 0-15, for engines that read it (MPE)
+    int id = 0;          // Param / NoteModulation: parameter index; NoteExpression: which expression;
+                         // NoteOn: the host's note ID, for engines that report notes ending
+};
+
+/**
+ * @brief Fixed-capacity, offset-ordered event queue for one audio block
+ */
+class MidiEventQueue
+{
+public:
+    /** Maximum events held per block */
+    static constexpr int CAPACITY = 512;
+
+    /** Shortest sub-block renderBlock() will split off */
+    static constexpr int MIN_SUB_BLOCK = 16;
+
+    /**
+     * @brief Queue an event, keeping the queue ordered by sample offset
+     * @return false if the queue is full (caller should apply it now)
+     */
+    bool push(const MidiEvent& event)
+    {
+        if (count >= CAPACITY)
+            return false;
+
+        // MidiBuffer is already time ordered, so this is normally an append
+        int i = count++;
+        while (i > 0 && events[i - 1].sampleOffset > event.sampleOffset)
+        {
+            events[i] = events[i - 1];
+            --i;
+        }
+        events[i] = event;
+        return true;
+    }
+
+    void clear() { count = 0; }
+    bool isEmpty() const { return count == 0; }
+    int size() const { return count; }
+
+    /**
+     * @brief Render a block, applying queued events at their offsets
+     * @param numSamples Block length
+     * @param render Called as render(startSample, numSamples) for each sub-block
+     * @param apply Called as apply(event) before the sub-block it starts
+     *
+     * Empties the queue. Events past the end of the block are applied after
+     * the last sub-block so nothing is dropped.
+     */
+    template <typename RenderFn, typename ApplyFn>
+    void process(int numSamples, RenderFn&& render, ApplyFn&& apply)
+    {
+        int next = 0;
+        int pos = 0;
+
+        while (pos < numSamples)
+        {
+            while (next < count && events[next].sampleOffset <= pos)
+                apply(events[next++]);
+
+            int end = numSamples;
+            if (next < count)
+                end = std::min(std::max(events[next].sampleOffset, pos + MIN_SUB_BLOCK), numSamples);  // Not clamp: lo may pass hi
+
+            render(pos, end - pos);
+            pos = end;
+        }
+
+        while (next < count)
+            apply(events[next++]);
+
+        count = 0;
+    }
+
+private:
+    std::array<MidiEvent, CAPACITY> events{};
+    int count = 0;
+};
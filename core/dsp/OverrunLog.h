@@ -0,0 +1,229 @@
+/**
+ * @file OverrunLog.h
+ * @brief The last few blocks that missed their deadline, and what the engine was doing
+ *
+ * A block that takes longer than numSamples / sampleRate is a click, and
+ * the user can't tell which patch or plugin made it. The processor
+ * brackets all of processBlock() with beginBlock() / endBlock(); a block
+ * that ran over is written, with a snapshot of the engine's state, into a
+ * ring of the last HISTORY overruns and published whole through a
+ * StatePublisher. The editor's timer reads it and hands it to the page
+ * as JSON, so a screenshot of the UI says what was going on:
+ *
+ *   // processBlock (audio thread), first thing
+ *   OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] {
+ *       OverrunLog::EngineState s;
+ *       s.activeVoices = engine.getActiveVoiceCount();
+ *       return s;
+ *   });
+ *
+ *   // timerCallback (message thread)
+ *   const auto& history = overruns.read();
+ *   if (history.total != lastSent) send(overruns.toJson(history));
+ *
+ * Always on, like CpuGovernor: two clock reads a block. The state
+ * callback and the publish only run for a block that overran. Fields an
+ * engine doesn't have stay -1; effects is a bit per name given to
+ * setEffectNames(), set if that effect was on.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include "StatePublisher.h"
+
+class OverrunLog
+{
+public:
+    /** Overruns kept, newest last */
+    static constexpr int HISTORY = 16;
+
+    /** Effects a processor can name */
+    static constexpr int MAX_EFFECTS = 8;
+
+    using Clock = std::chrono::steady_clock;
+
+    /** What the engine was doing; -1 for what it doesn't have */
+    struct EngineState
+    {
+        int activeVoices = -1;
+        int qualityTier = -1;   // QualityTier index
+        int governorStep = -1;  // CpuGovernor step
+        uint32_t effects = 0;   // Bit i: effect i (setEffectNames()) was on
+    };
+
+    struct Overrun
+    {
+        double seconds = 0.0;  // Stream time since prepare() at the block's start
+        float blockMs = 0.0f;  // How long the block took
+        float budgetMs = 0.0f; // numSamples / sampleRate
+        int numSamples = 0;
+        EngineState state;
+    };
+
+    struct History
+    {
+        std::array<Overrun, HISTORY> entries{};
+        int count = 0;       // Valid entries, oldest first
+        uint64_t total = 0;  // Overruns since prepare(), kept or not
+        float worstLoad = 0.0f;  // Worst block time / budget among them
+    };
+
+    /** Names for the effects bits, in order (before the audio thread runs) */
+    void setEffectNames(std::initializer_list<const char*> names)
+    {
+        numEffects = 0;
+        for (const char* name : names)
+            if (numEffects < MAX_EFFECTS)
+                effectNames[static_cast<size_t>(numEffects++)] = name;
+    }
+
+    /** Rate the deadlines are measured in; clears the history (not while rendering) */
+    void prepare(double sr) noexcept
+    {
+        sampleRate = sr;
+        samplesDone = 0;
+        ring = {};
+        next = 0;
+        kept = 0;
+        total = 0;
+        worstLoad = 0.0f;
+        publish();
+    }
+
+    /** Start of processBlock() (audio thread) */
+    Clock::time_point beginBlock() const noexcept { return Clock::now(); }
+
+    /** End of processBlock(); state() is called only if the block overran (audio thread) */
+    template <typename StateFn>
+    void endBlock(Clock::time_point start, int numSamples, StateFn&& state)
+    {
+        record(std::chrono::duration<double>(Clock::now() - start).count(), numSamples, state);
+    }
+
+    /** beginBlock() / endBlock() around a scope: all of a processBlock() with early returns */
+    template <typename StateFn>
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(OverrunLog& l, int n, StateFn fn)
+            : log(l), numSamples(n), state(std::move(fn)), start(l.beginBlock())
+        {
+        }
+        ~ScopedBlock() { log.endBlock(start, numSamples, state); }
+
+        ScopedBlock(const ScopedBlock&) = delete;
+        ScopedBlock& operator=(const ScopedBlock&) = delete;
+
+    private:
+        OverrunLog& log;
+        const int numSamples;
+        StateFn state;
+        const Clock::time_point start;
+    };
+
+    /** One block's time by hand (endBlock() without the clock; tests, offline) */
+    template <typename StateFn>
+    void record(double elapsedSeconds, int numSamples, StateFn&& state)
+    {
+        if (numSamples <= 0)
+            return;
+
+        const double budget = numSamples / sampleRate;
+        const double at = static_cast<double>(samplesDone) / sampleRate;
+        samplesDone += static_cast<uint64_t>(numSamples);
+        if (elapsedSeconds <= budget)
+            return;
+
+        Overrun& o = ring[static_cast<size_t>(next)];
+        o.seconds = at;
+        o.blockMs = static_cast<float>(elapsedSeconds * 1000.0);
+        o.budgetMs = static_cast<float>(budget * 1000.0);
+        o.numSamples = numSamples;
+        o.state = state();
+
+        next = (next + 1) % HISTORY;
+        kept = std::min(kept + 1, HISTORY);
+        ++total;
+        worstLoad = std::max(worstLoad, static_cast<float>(elapsedSeconds / budget));
+        publish();
+    }
+
+    /** The newest history (message thread) */
+    const History& read() noexcept { return published.read(); }
+
+    int getNumEffects() const { return numEffects; }
+    const char* getEffectName(int i) const { return effectNames[static_cast<size_t>(i)]; }
+
+    /**
+     * @brief A history as JSON for the page
+     *
+     * {"total", "worstLoad", "overruns": [{"seconds", "blockMs", "budgetMs",
+     * "samples", "voices", "quality", "governorStep", "effects": [names]}]},
+     * oldest overrun first; absent engine fields are null.
+     */
+    std::string toJson(const History& h) const
+    {
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer), "{\"total\":%llu,\"worstLoad\":%.3f,\"overruns\":[",
+                      static_cast<unsigned long long>(h.total), static_cast<double>(h.worstLoad));
+        std::string json(buffer);
+
+        const auto field = [](int value) { return value < 0 ? std::string("null") : std::to_string(value); };
+        for (int i = 0; i < h.count; ++i)
+        {
+            const Overrun& o = h.entries[static_cast<size_t>(i)];
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s{\"seconds\":%.3f,\"blockMs\":%.3f,\"budgetMs\":%.3f,\"samples\":%d,", i > 0 ? "," : "",
+                          o.seconds, static_cast<double>(o.blockMs), static_cast<double>(o.budgetMs), o.numSamples);
+            json += buffer;
+            json += "\"voices\":" + field(o.state.activeVoices) + ",\"quality\":" + field(o.state.qualityTier)
+                  + ",\"governorStep\":" + field(o.state.governorStep) + ",\"effects\":[";
+            bool first = true;
+            for (int e = 0; e < numEffects; ++e)
+                if ((o.state.effects >> e) & 1u)
+                {
+                    json += (first ? "\"" : ",\"") + std::string(effectNames[static_cast<size_t>(e)]) + "\"";
+                    first = false;
+                }
+            json += "]}";
+        }
+        return json + "]}";
+    }
+
+private:
+    /** Oldest first into the writer's slot */
+    void publish() noexcept
+    {
+        History& h = published.write();
+        const int oldest = (next - kept + HISTORY) % HISTORY;
+        for (int i = 0; i < kept; ++i)
+            h.entries[static_cast<size_t>(i)] = ring[static_cast<size_t>((oldest + i) % HISTORY)];
+        h.count = kept;
+        h.total = total;
+        h.worstLoad = worstLoad;
+        published.publish();
+    }
+
+    double sampleRate = 44100.0;
+    uint64_t samplesDone = 0;
+
+    std::array<Overrun, HISTORY> ring{};
+    int next = 0;  // Slot the next overrun goes in
+    int kept = 0;
+    uint64_t total = 0;
+    float worstLoad = 0.0f;
+
+    StatePublisher<History> published;
+
+    std::array<const char*, MAX_EFFECTS> effectNames{};
+    int numEffects = 0;
+};
@@ -0,0 +1,265 @@
+/**
+ * @file Oversampler.h
+ * @brief 2x / 4x oversampling around a nonlinear stage, on sst's HalfRateFilter
+ *
+ * Saturators, tanh ladders and tape models alias when driven hard. Running
+ * only that stage at 2x or 4x costs far less than running the whole host
+ * at 96 kHz: the oversampler upsamples a block through sst-filters'
+ * half-band IIR (HalfRateFilter, as Surge uses it), hands the stage the
+ * oversampled block, and filters it back down.
+ *
+ *   Factor 2: base -> 2x (12th-order steep half-band) -> stage -> base
+ *   Factor 4: base -> 2x -> 4x (8th-order soft half-band) -> stage -> 2x -> base
+ *
+ * The half-band filters work in groups of four base-rate samples, so with
+ * oversampling on the stage's output is LATENCY (4) samples late, on top of
+ * the filters' own phase delay of a few samples; any host block size works.
+ * Factor 1 calls the stage in place, with no delay.
+ *
+ * Whatever the stage derives from the sample rate (filter coefficients,
+ * envelope ramps) has to use getFactor() * the base rate. setFactor()
+ * only resets state, so it is safe between blocks on the audio thread.
+ *
+ * Typical use, around a stereo drive (the stage runs in place):
+ *
+ *   oversampler.process(left, right, numSamples, [&](float* l, float* r, int n) {
+ *       for (int i = 0; i < n; ++i)
+ *           drive.process(l[i], r[i]);
+ *   });
+ *
+ * Per voice, the factor can follow the note: a low note, or one through
+ * a stage barely driven, has no harmonics to fold back, while a high,
+ * hard-driven one needs 4x. adapt() picks the lowest factor that keeps a
+ * note's harmonics out of the audio band (factorFor()); call it at note
+ * on, when the voice starts from silence anyway, and again when the note
+ * changes under it (legato). A bend or glide that takes the note higher
+ * calls raiseFactor(), which keeps the delay line. With
+ * setConstantLatency() a voice at 1x is delayed LATENCY samples too, so
+ * voices at different factors stay in time with each other and with the
+ * latency the host was told.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+
+#include "sst/filters/HalfRateFilter.h"
+
+class Oversampler
+{
+public:
+    static constexpr int MAX_FACTOR = 4;
+
+    /** Base-rate samples per half-band pass (a multiple of GRANULE) */
+    static constexpr int CHUNK = 64;
+
+    /** Base-rate samples the half-band filters consume at a time */
+    static constexpr int GRANULE = 4;
+
+    /** Delay through the oversampled path, in base-rate samples */
+    static constexpr int LATENCY = GRANULE;
+
+    /** Ring-down of the half-band pairs, with headroom (about 1100 measured at 4x) */
+    static constexpr int TAIL = 2048;
+
+    Oversampler() { reset(); }
+
+    /** 1 (off), 2 or 4; anything else rounds down to one of those */
+    void setFactor(int f)
+    {
+        f = f >= 4 ? 4 : (f >= 2 ? 2 : 1);
+        if (f == factor)
+            return;
+        factor = f;
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+
+    /**
+     * @brief The lowest factor that keeps a driven note's harmonics from folding into the audio band
+     * @param drive How hard the stage is driven, 0 (linear: nothing to fold) to 1 (about tanh(8x))
+     *
+     * A stage driven to 1 puts harmonics worth hearing up to about the
+     * 15th. At factor F a harmonic below F * sampleRate - Nyquist folds
+     * only above the base Nyquist, where the down filters take it out.
+     */
+    static int factorFor(double sampleRate, float fundamentalHz, float drive)
+    {
+        if (drive <= 0.0f)
+            return 1;
+        const double highest = fundamentalHz * (1.0 + 14.0 * std::min(drive, 1.0f));
+        if (highest < sampleRate * 0.5)
+            return 1;
+        return highest < sampleRate * 1.5 ? 2 : 4;
+    }
+
+    /** setFactor(factorFor(...)); true if it changed, so the stage has to be prepared for the new rate */
+    bool adapt(double sampleRate, float fundamentalHz, float drive)
+    {
+        const int previous = factor;
+        setFactor(factorFor(sampleRate, fundamentalHz, drive));
+        return factor != previous;
+    }
+
+    /**
+     * @brief Raise the factor under a sounding note, keeping the delay line
+     * @return True if it rose, so the stage has to be prepared for the new rate
+     *
+     * For a pitch that bends or glides up past what the note started with.
+     * setFactor() clears the queue along with the filters, dropping
+     * LATENCY samples of the note; this clears only the half-band pairs
+     * that were idle, so the output stays LATENCY late (from 2x up, or at
+     * 1x with setConstantLatency()) while the new pair settles in. Lower
+     * factors wait for the next note, so a bend back and forth switches
+     * once.
+     */
+    bool raiseFactor(int f)
+    {
+        f = f >= 4 ? 4 : (f >= 2 ? 2 : 1);
+        if (f <= factor)
+            return false;
+        if (factor == 1)
+        {
+            up2.reset();
+            down2.reset();
+        }
+        up4.reset();
+        down4.reset();
+        factor = f;
+        return true;
+    }
+
+    /** Delay 1x by LATENCY as well, for voices whose factors differ */
+    void setConstantLatency(bool constant)
+    {
+        if (constant == constantLatency)
+            return;
+        constantLatency = constant;
+        reset();
+    }
+
+    /** Samples the stage's output is delayed by at the current factor */
+    int getLatency() const { return factor > 1 || constantLatency ? LATENCY : 0; }
+
+    /** Base-rate samples for the filters to ring out below -120 dB after full scale in */
+    int getTailSamples() const { return factor > 1 ? TAIL : getLatency(); }
+
+    /** Clear the filters and the delay (silence in, silence out) */
+    void reset()
+    {
+        up2.reset();
+        down2.reset();
+        up4.reset();
+        down4.reset();
+        pending = 0;
+        held = LATENCY;
+        std::fill(std::begin(heldL), std::end(heldL), 0.0f);
+        std::fill(std::begin(heldR), std::end(heldR), 0.0f);
+    }
+
+    /**
+     * @brief Run stage(l, r, n) over the block at the oversampled rate, in place
+     * @param right May be nullptr for a mono stage (which then ignores r)
+     */
+    template <typename Stage>
+    void process(float* left, float* right, int numSamples, Stage&& stage)
+    {
+        if (factor == 1 && !constantLatency)
+        {
+            stage(left, right, numSamples);
+            return;
+        }
+
+        // Queue the input behind any partial granule from the last call,
+        // filter whole granules, and hand back the output LATENCY samples
+        // late. pending + held stays LATENCY across calls
+        for (int i = 0; i < numSamples;)
+        {
+            const int n = std::min(numSamples - i, CHUNK - GRANULE);
+            std::copy(left + i, left + i + n, workL + pending);
+            if (right)
+                std::copy(right + i, right + i + n, workR + pending);
+            else
+                std::fill(workR + pending, workR + pending + n, 0.0f);
+
+            const int total = pending + n;
+            const int ready = total - total % GRANULE;
+            if (ready > 0)
+            {
+                runOversampled(ready, stage);
+                std::copy(workL, workL + ready, heldL + held);
+                std::copy(workR, workR + ready, heldR + held);
+                held += ready;
+                std::copy(workL + ready, workL + total, workL);
+                std::copy(workR + ready, workR + total, workR);
+            }
+            pending = total - ready;
+
+            std::copy(heldL, heldL + n, left + i);
+            if (right)
+                std::copy(heldR, heldR + n, right + i);
+            std::copy(heldL + n, heldL + held, heldL);
+            std::copy(heldR + n, heldR + held, heldR);
+            held -= n;
+            i += n;
+        }
+    }
+
+    /** Mono convenience: stage(x, n) */
+    template <typename Stage>
+    void processMono(float* samples, int numSamples, Stage&& stage)
+    {
+        process(samples, nullptr, numSamples, [&stage](float* l, float*, int n) { stage(l, n); });
+    }
+
+private:
+    /** Up, stage, down over workL/R[0, n), n a multiple of GRANULE */
+    template <typename Stage>
+    void runOversampled(int n, Stage& stage)
+    {
+        if (factor == 1)
+        {
+            stage(workL, workR, n);  // Only queued, for the constant latency
+            return;
+        }
+
+        up2.process_block_U2_fullscale(workL, workR, upL, upR, n * 2);
+        if (factor == 4)
+        {
+            up4.process_block_U2_fullscale(upL, upR, up4L, up4R, n * 4);
+            stage(up4L, up4R, n * 4);
+            down4.process_block_D2(up4L, up4R, n * 4, upL, upR);
+        }
+        else
+        {
+            stage(upL, upR, n * 2);
+        }
+        down2.process_block_D2(upL, upR, n * 2, workL, workR);
+    }
+
+    using HalfRate = sst::filters::HalfRate::HalfRateFilter;
+    static_assert(CHUNK * MAX_FACTOR <= static_cast<int>(sst::filters::HalfRate::hr_BLOCK_SIZE));
+
+    // Base <-> 2x carries the audio band, so it gets the steep filter; the
+    // 2x <-> 4x pair only has to stop what would fold below the base Nyquist
+    HalfRate up2{6, true};
+    HalfRate down2{6, true};
+    HalfRate up4{4, false};
+    HalfRate down4{4, false};
+
+    alignas(16) float workL[CHUNK]{};
+    alignas(16) float workR[CHUNK]{};
+    alignas(16) float upL[CHUNK * 2]{};
+    alignas(16) float upR[CHUNK * 2]{};
+    alignas(16) float up4L[CHUNK * 4]{};
+    alignas(16) float up4R[CHUNK * 4]{};
+    float heldL[CHUNK + LATENCY]{};
+    float heldR[CHUNK + LATENCY]{};
+
+    int factor = 1;
+    bool constantLatency = false;
+    int pending = 0;  // Input samples waiting for a whole granule
+    int held = 0;     // Filtered samples waiting to go out
+};
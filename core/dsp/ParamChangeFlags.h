@@ -0,0 +1,70 @@
+/**
+ * @file ParamChangeFlags.h
+ * @brief Lock-free "changed since the last UI tick" bits for the parameters
+ *
+ * Parameter listeners can fire on the audio thread during host automation,
+ * once per change. They only mark() the parameter's index; the editor's
+ * timer drains() the marked indices on the message thread and sends their
+ * current values to the WebView in one call. A parameter that changes many
+ * times between ticks is sent once, with its latest value.
+ *
+ * Any number of threads may mark(); one thread drains. No locks and no
+ * allocation.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class ParamChangeFlags
+{
+public:
+    /** More parameters than any plugin has; higher indices are ignored */
+    static constexpr int CAPACITY = 256;
+
+    /** Flag a parameter as changed (any thread) */
+    void mark(int index) noexcept
+    {
+        if (index < 0 || index >= CAPACITY)
+            return;
+        words[static_cast<size_t>(index >> 5)].fetch_or(1u << (index & 31), std::memory_order_release);
+    }
+
+    /**
+     * @brief Clear every flag, calling fn(index) for each one that was set
+     * @return Number of parameters that had changed
+     */
+    template <typename Fn>
+    int drain(Fn&& fn)
+    {
+        int count = 0;
+        for (size_t w = 0; w < words.size(); ++w)
+        {
+            uint32_t bits = words[w].exchange(0, std::memory_order_acquire);
+            while (bits != 0)
+            {
+                fn(static_cast<int>(w * 32) + countTrailingZeros(bits));
+                bits &= bits - 1;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+private:
+    static int countTrailingZeros(uint32_t bits) noexcept
+    {
+        int n = 0;
+        while ((bits & 1u) == 0)
+        {
+            bits >>= 1;
+            ++n;
+        }
+        return n;
+    }
+
+    std::array<std::atomic<uint32_t>, CAPACITY / 32> words{};
+};
@@ -0,0 +1,129 @@
+/**
+ * @file ParamSnapshot.h
+ * @brief One block's parameter values, read once, with a record of what changed
+ *
+ * processBlock() used to load every parameter atomic and call every engine
+ * setter each block, even though almost nothing moves between blocks and
+ * some setters recompute coefficients. A snapshot instead copies every
+ * bound atomic into one packed array at the top of the block and marks the
+ * values that differ from last block's, so the engine can skip the rest:
+ *
+ *   // Constructor
+ *   for (int i = 0; i < kNumParams; ++i)
+ *       params.bind(i, apvts.getRawParameterValue(kParamIds[i]));
+ *
+ *   // processBlock()
+ *   params.update();
+ *   synthEngine.applySnapshot(params);
+ *
+ *   // SynthEngine::applySnapshot()
+ *   if (p.changed(kFilterCutoff, kFilterReso))
+ *       setFilter(p[kFilterCutoff], p[kFilterReso]);
+ *
+ * The IDs come from the plugin's parameter list (dsp/SynthParams.h), an
+ * X-macro that generates the index enum and the ID strings together so the
+ * two can't drift apart.
+ *
+ * Everything starts out changed, and markAllChanged() (from prepareToPlay(),
+ * where setters that depend on the sample rate need re-running) makes the
+ * next update() report every value again.
+ *
+ * update() only reads atomics and writes preallocated state: real-time safe.
+ * Floats are compared exactly, so re-storing the same value is not a change.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+template <int NumParams>
+class ParamSnapshot
+{
+public:
+    static constexpr int SIZE = NumParams;
+
+    /** Read parameter id from source on every update() (nullptr: only set() changes it) */
+    void bind(int id, const std::atomic<float>* source) { sources[static_cast<size_t>(id)] = source; }
+
+    /** Load every bound parameter and mark the ones that moved since the last update() */
+    void update()
+    {
+        changedBits.fill(allPending ? ~uint64_t{0} : uint64_t{0});
+        allPending = false;
+
+        for (int i = 0; i < NumParams; ++i)
+        {
+            const std::atomic<float>* source = sources[static_cast<size_t>(i)];
+            if (source == nullptr)
+                continue;
+            const float v = source->load(std::memory_order_relaxed);
+            if (v != values[static_cast<size_t>(i)])
+            {
+                values[static_cast<size_t>(i)] = v;
+                mark(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Write a value directly, marking it changed if it moved
+     *
+     * For offline renders and tests: call after update(), which starts the
+     * block (and clears the marks) whether or not anything is bound.
+     */
+    void set(int id, float value)
+    {
+        if (value != values[static_cast<size_t>(id)])
+        {
+            values[static_cast<size_t>(id)] = value;
+            mark(id);
+        }
+    }
+
+    /** Report every value as changed on the next update() */
+    void markAllChanged() { allPending = true; }
+
+    /** The value apvts.getRawParameterValue(id) held at update() */
+    float operator[](int id) const { return values[static_cast<size_t>(id)]; }
+
+    /** Choice / int parameters, cast the way processBlock() always has */
+    int index(int id) const { return static_cast<int>((*this)[id]); }
+
+    /** Bool parameters */
+    bool flag(int id) const { return (*this)[id] > 0.5f; }
+
+    /** True if any of the given parameters changed in the last update() */
+    template <typename... Ids>
+    bool changed(int id, Ids... more) const
+    {
+        const bool c = allPending || ((changedBits[static_cast<size_t>(id) / 64] >> (id % 64)) & 1u) != 0;
+        if constexpr (sizeof...(more) == 0)
+            return c;
+        else
+            return c || changed(more...);
+    }
+
+    /** True if anything changed in the last update() */
+    bool anyChanged() const
+    {
+        if (allPending)
+            return true;
+        for (uint64_t w : changedBits)
+            if (w != 0)
+                return true;
+        return false;
+    }
+
+private:
+    static constexpr int WORDS = (NumParams + 63) / 64;
+
+    void mark(int id) { changedBits[static_cast<size_t>(id) / 64] |= uint64_t{1} << (id % 64); }
+
+    // Read together every block: keep the values contiguous and line-aligned
+    alignas(64) std::array<float, NumParams> values{};
+    std::array<uint64_t, WORDS> changedBits{};
+    bool allPending = true;
+    std::array<const std::atomic<float>*, NumParams> sources{};
+};
@@ -0,0 +1,446 @@
+/**
+ * @file PatchGraph.h
+ * @brief User-patchable module graphs, compiled into a flat block schedule
+ *
+ * DspGraph.h fixes a graph when the plugin is built; a user patch changes
+ * while it runs. Walking a node graph per sample would cost a call and a
+ * lookup per node per sample, so instead the patch is compiled whenever
+ * it's edited (message thread):
+ *
+ * - the modules feeding the output are sorted so each runs after the ones
+ *   it reads; modules that never reach the output aren't scheduled
+ * - a cable that closes a loop becomes a feedback cable, read a block late
+ *   from a buffer of its own
+ * - every output gets a buffer slot, handed on to a later output once its
+ *   last reader has run
+ * - what's left is a flat array of steps: a block function, its module
+ *   and pointers to its slots
+ *
+ * A Player takes the compiled Schedule in at the start of its next block
+ * with one atomic exchange, and hands the one it replaced back to be freed
+ * by the next load(), off the audio thread. A block is then one function
+ * pointer call per module.
+ *
+ *   PatchGraph::Patch patch(sampleRate, 32);          // Message thread
+ *   const int osc = patch.add<PatchModules::Oscillator>();
+ *   const int vca = patch.add<PatchModules::Vca>();
+ *   patch.connect(osc, 0, vca, 0);
+ *   patch.setOutput(vca, 0);
+ *   player.load(patch.compile());
+ *
+ *   player.render(output, numSamples);                // Audio thread
+ *
+ * A module is any type with
+ *
+ *   static constexpr int INPUTS = ..., OUTPUTS = ...;
+ *   void process(const float* const* in, float* const* out, int numSamples);
+ *
+ * and optionally prepare(double sampleRate, int blockSize), called once
+ * by add(). An unconnected input is nullptr, so a module can skip the
+ * modulation nobody patched. Outputs are written whole, never read back:
+ * a slot is another output's the moment its last reader is done.
+ *
+ * Modules are shared by the patch and every schedule compiled from it, so
+ * recompiling keeps their state (phases, filter memory). One is freed with
+ * the last of them to let go, which is never the audio thread. Feedback
+ * cables start from silence in each new schedule.
+ *
+ * A feedback cable is a block late: blockSize samples, fewer after a
+ * host block that isn't a multiple of it.
+ *
+ * @note Patch and compile() allocate: message thread. Player::render() is
+ *       real-time safe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace PatchGraph
+{
+
+/** One module's block: in[INPUTS] (nullptr where unpatched) to out[OUTPUTS] */
+using ProcessFn = void (*)(void* module, const float* const* in, float* const* out, int numSamples);
+
+/** A patch compiled for the audio thread (Patch::compile()) */
+class Schedule
+{
+public:
+    /** Run every step over numSamples (at most getBlockSize()) and copy the patch output to out */
+    void run(float* out, int numSamples)
+    {
+        for (const Step& s : steps)
+            s.process(s.module, inputs.data() + s.firstInput, outputs.data() + s.firstOutput, numSamples);
+
+        if (output != nullptr)
+            std::copy(output, output + numSamples, out);
+        else
+            std::fill(out, out + numSamples, 0.0f);
+    }
+
+    int getBlockSize() const { return blockSize; }
+
+    /** Module blocks per run: the scheduled modules and a copy per feedback cable */
+    int getNumSteps() const { return static_cast<int>(steps.size()); }
+
+    /** Buffers the outputs share, feedback buffers included */
+    int getNumSlots() const { return numSlots; }
+
+    /** Cables that closed a loop, read a block late */
+    int getNumFeedbackCables() const { return numFeedback; }
+
+private:
+    friend class Patch;
+
+    struct Step
+    {
+        ProcessFn process;
+        void* module;
+        int firstInput;   // Into inputs
+        int firstOutput;  // Into outputs
+    };
+
+    /** A feedback cable's step: its source's output into the buffer read next block */
+    static void copyBlock(void*, const float* const* in, float* const* out, int numSamples)
+    {
+        std::copy(in[0], in[0] + numSamples, out[0]);
+    }
+
+    std::vector<Step> steps;
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+    std::vector<float> buffers;                   // numSlots * blockSize
+    std::vector<std::shared_ptr<void>> modules;  // Alive while this schedule might run
+    const float* output = nullptr;
+    int blockSize = 0;
+    int numSlots = 0;
+    int numFeedback = 0;
+};
+
+/** The patch as edited: modules and cables (message thread) */
+class Patch
+{
+public:
+    Patch(double sampleRate, int blockSize) : sampleRate(sampleRate), blockSize(std::max(blockSize, 1)) {}
+
+    /** Add a module, prepared; returns its ID */
+    template <typename Module, typename... Args>
+    int add(Args&&... args)
+    {
+        auto module = std::make_shared<Module>(std::forward<Args>(args)...);
+        if constexpr (requires { module->prepare(sampleRate, blockSize); })
+            module->prepare(sampleRate, blockSize);
+
+        Node node;
+        node.process = [](void* m, const float* const* in, float* const* out, int n) {
+            static_cast<Module*>(m)->process(in, out, n);
+        };
+        node.numOutputs = Module::OUTPUTS;
+        node.inputs.resize(Module::INPUTS);
+        node.module = std::move(module);
+        nodes.push_back(std::move(node));
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    /**
+     * @brief The module with ID id; nullptr if there's none
+     *
+     * Once a schedule holding it is loaded the audio thread is running
+     * it, so only setters that are safe from another thread (atomics,
+     * as in PatchModules.h) may be called then.
+     */
+    template <typename Module>
+    Module* get(int id) const
+    {
+        return exists(id) ? static_cast<Module*>(nodes[static_cast<size_t>(id)].module.get()) : nullptr;
+    }
+
+    /** Take a module out, with every cable to and from it */
+    void remove(int id)
+    {
+        if (!exists(id))
+            return;
+        nodes[static_cast<size_t>(id)].module.reset();
+        for (Node& node : nodes)
+            for (Cable& cable : node.inputs)
+                if (cable.from == id)
+                    cable = {};
+        if (out.from == id)
+            out = {};
+    }
+
+    /** Patch from's output into to's input, replacing whatever was there; false if either isn't there */
+    bool connect(int from, int output, int to, int input)
+    {
+        if (!hasOutput(from, output) || !hasInput(to, input))
+            return false;
+        nodes[static_cast<size_t>(to)].inputs[static_cast<size_t>(input)] = {from, output};
+        return true;
+    }
+
+    void disconnect(int to, int input)
+    {
+        if (hasInput(to, input))
+            nodes[static_cast<size_t>(to)].inputs[static_cast<size_t>(input)] = {};
+    }
+
+    /** The output the patch plays; false if it isn't there */
+    bool setOutput(int module, int output)
+    {
+        if (!hasOutput(module, output))
+            return false;
+        out = {module, output};
+        return true;
+    }
+
+    /** Sort, lay out and flatten the patch as it stands */
+    std::unique_ptr<Schedule> compile() const
+    {
+        auto schedule = std::make_unique<Schedule>();
+        schedule->blockSize = blockSize;
+
+        // Feeders first, depth first from the output; a cable back into a
+        // module still being visited closes a loop
+        std::vector<int> order;
+        std::vector<Cable> feedback;
+        std::vector<char> state(nodes.size(), 0);  // 0 unseen, 1 on the path, 2 placed
+        if (out.from >= 0)
+            visit(out.from, state, order, feedback);
+
+        std::vector<int> position(nodes.size(), -1);
+        for (size_t i = 0; i < order.size(); ++i)
+            position[static_cast<size_t>(order[i])] = static_cast<int>(i);
+
+        // The position of an output's last reader, after which its slot is passed on.
+        // A feedback copy reads it at its source's own position.
+        auto lastRead = [&](int module, int output) {
+            int last = module == out.from && output == out.output ? static_cast<int>(order.size())
+                                                                   : position[static_cast<size_t>(module)];
+            for (int reader : order)
+            {
+                const Node& node = nodes[static_cast<size_t>(reader)];
+                for (size_t input = 0; input < node.inputs.size(); ++input)
+                    if (node.inputs[input].from == module && node.inputs[input].output == output
+                        && feedbackOf(feedback, reader, static_cast<int>(input)) < 0)
+                        last = std::max(last, position[static_cast<size_t>(reader)]);
+            }
+            return last;
+        };
+
+        // Feedback buffers hold a block from one run to the next, so are never passed on
+        int slots = static_cast<int>(feedback.size());
+        std::vector<int> free;
+        struct Held
+        {
+            int slot;
+            int until;  // Position
+        };
+        std::vector<Held> held;
+
+        std::vector<std::vector<int>> slotOf(nodes.size());
+        std::vector<int> inputSlots;  // -1 for unpatched; made pointers once the buffers exist
+        std::vector<int> outputSlots;
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const int module = order[i];
+            const Node& node = nodes[static_cast<size_t>(module)];
+
+            schedule->steps.push_back({node.process, node.module.get(), static_cast<int>(inputSlots.size()),
+                                       static_cast<int>(outputSlots.size())});
+            for (size_t input = 0; input < node.inputs.size(); ++input)
+            {
+                const Cable& cable = node.inputs[input];
+                const int f = feedbackOf(feedback, module, static_cast<int>(input));
+                if (f >= 0)
+                    inputSlots.push_back(f);
+                else if (cable.from >= 0)
+                    inputSlots.push_back(slotOf[static_cast<size_t>(cable.from)][static_cast<size_t>(cable.output)]);
+                else
+                    inputSlots.push_back(-1);
+            }
+
+            // Outputs take slots before this module's inputs let theirs go, so they never alias
+            for (int o = 0; o < node.numOutputs; ++o)
+            {
+                int slot = slots;
+                if (free.empty())
+                {
+                    ++slots;
+                }
+                else
+                {
+                    slot = free.back();
+                    free.pop_back();
+                }
+                slotOf[static_cast<size_t>(module)].push_back(slot);
+                outputSlots.push_back(slot);
+                held.push_back({slot, lastRead(module, o)});
+            }
+
+            for (size_t f = 0; f < feedback.size(); ++f)
+            {
+                if (feedback[f].from != module)
+                    continue;
+                schedule->steps.push_back({&Schedule::copyBlock, nullptr, static_cast<int>(inputSlots.size()),
+                                           static_cast<int>(outputSlots.size())});
+                inputSlots.push_back(slotOf[static_cast<size_t>(module)][static_cast<size_t>(feedback[f].output)]);
+                outputSlots.push_back(static_cast<int>(f));
+            }
+
+            // Slots whose last reader has now run are free for the next outputs
+            for (size_t h = 0; h < held.size();)
+            {
+                if (held[h].until <= static_cast<int>(i))
+                {
+                    free.push_back(held[h].slot);
+                    held[h] = held.back();
+                    held.pop_back();
+                }
+                else
+                {
+                    ++h;
+                }
+            }
+        }
+
+        // Buffers last: every pointer into them is final from here
+        schedule->numSlots = slots;
+        schedule->numFeedback = static_cast<int>(feedback.size());
+        schedule->buffers.assign(static_cast<size_t>(slots) * static_cast<size_t>(blockSize), 0.0f);
+        auto slotPtr = [&](int slot) {
+            return schedule->buffers.data() + static_cast<size_t>(slot) * static_cast<size_t>(blockSize);
+        };
+        for (int slot : inputSlots)
+            schedule->inputs.push_back(slot >= 0 ? slotPtr(slot) : nullptr);
+        for (int slot : outputSlots)
+            schedule->outputs.push_back(slotPtr(slot));
+        if (out.from >= 0)
+            schedule->output = slotPtr(slotOf[static_cast<size_t>(out.from)][static_cast<size_t>(out.output)]);
+
+        for (int module : order)
+            schedule->modules.push_back(nodes[static_cast<size_t>(module)].module);
+        return schedule;
+    }
+
+private:
+    struct Cable
+    {
+        int from = -1;  // Module ID, -1 for none
+        int output = 0;
+        int to = -1;    // Only set on feedback cables
+        int input = 0;
+    };
+
+    struct Node
+    {
+        std::shared_ptr<void> module;  // Null once removed
+        ProcessFn process = nullptr;
+        int numOutputs = 0;
+        std::vector<Cable> inputs;  // By input
+    };
+
+    bool exists(int id) const { return id >= 0 && id < static_cast<int>(nodes.size()) && nodes[static_cast<size_t>(id)].module; }
+
+    bool hasOutput(int id, int output) const
+    {
+        return exists(id) && output >= 0 && output < nodes[static_cast<size_t>(id)].numOutputs;
+    }
+
+    bool hasInput(int id, int input) const
+    {
+        return exists(id) && input >= 0 && input < static_cast<int>(nodes[static_cast<size_t>(id)].inputs.size());
+    }
+
+    /** The feedback cable into module's input, or -1 */
+    static int feedbackOf(const std::vector<Cable>& feedback, int module, int input)
+    {
+        for (size_t f = 0; f < feedback.size(); ++f)
+            if (feedback[f].to == module && feedback[f].input == input)
+                return static_cast<int>(f);
+        return -1;
+    }
+
+    /** Place module after everything it reads; cables back onto the path go in feedback */
+    void visit(int module, std::vector<char>& state, std::vector<int>& order, std::vector<Cable>& feedback) const
+    {
+        state[static_cast<size_t>(module)] = 1;
+        const Node& node = nodes[static_cast<size_t>(module)];
+        for (size_t input = 0; input < node.inputs.size(); ++input)
+        {
+            const Cable& cable = node.inputs[input];
+            if (cable.from < 0)
+                continue;
+            if (state[static_cast<size_t>(cable.from)] == 1)
+                feedback.push_back({cable.from, cable.output, module, static_cast<int>(input)});
+            else if (state[static_cast<size_t>(cable.from)] == 0)
+                visit(cable.from, state, order, feedback);
+        }
+        state[static_cast<size_t>(module)] = 2;
+        order.push_back(module);
+    }
+
+    double sampleRate;
+    int blockSize;
+    std::vector<Node> nodes;  // By ID
+    Cable out;
+};
+
+/** Plays the latest Schedule loaded, swapping at block boundaries */
+class Player
+{
+public:
+    Player() = default;
+    ~Player()
+    {
+        delete pending.exchange(nullptr, std::memory_order_acquire);
+        delete retired.exchange(nullptr, std::memory_order_acquire);
+        delete current;
+    }
+
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+
+    /** Play schedule from the audio thread's next block; frees what it has finished with (message thread) */
+    void load(std::unique_ptr<Schedule> schedule)
+    {
+        delete retired.exchange(nullptr, std::memory_order_acquire);
+        delete pending.exchange(schedule.release(), std::memory_order_acq_rel);  // One never picked up
+    }
+
+    /** numSamples of the patch into out (audio thread) */
+    void render(float* out, int numSamples)
+    {
+        // Take a new schedule only once the last one replaced has been collected
+        if (retired.load(std::memory_order_acquire) == nullptr)
+        {
+            if (Schedule* next = pending.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                retired.store(current, std::memory_order_release);
+                current = next;
+            }
+        }
+
+        if (current == nullptr)
+        {
+            std::fill(out, out + numSamples, 0.0f);
+            return;
+        }
+
+        const int block = current->getBlockSize();
+        for (int done = 0; done < numSamples; done += block)
+            current->run(out + done, std::min(block, numSamples - done));
+    }
+
+private:
+    Schedule* current = nullptr;            // Audio thread's
+    std::atomic<Schedule*> pending{nullptr};  // Loaded, not yet playing
+    std::atomic<Schedule*> retired{nullptr};  // Replaced, for load() to free
+};
+
+} // namespace PatchGraph
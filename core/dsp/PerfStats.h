@@ -0,0 +1,291 @@
+/**
+ * @file PerfStats.h
+ * @brief Optional per-block CPU counters for the engine
+ *
+ * Off unless the build defines SYNTH_PERF_STATS=1 (cmake -DSYNTH_PERF_STATS=ON).
+ * When off, every member is an empty inline and ScopedStage is an empty
+ * object, so engines can call it unconditionally at no cost.
+ *
+ * The engine (audio thread) brackets renderBlock() with beginBlock() /
+ * endBlock() and wraps its stages in ScopedStage. Any other thread (the
+ * editor's getPerfStats native function, the WASM getPerfStats export)
+ * reads getSnapshot(). Counters are relaxed atomics with a single writer:
+ * lock free, each field consistent on its own, fields may be one block
+ * apart from each other.
+ *
+ * Stage times come from the CPU cycle counter (rdtsc / cntvct_el0) and are
+ * meant to be compared with each other; the over-budget check uses wall
+ * clock time against numSamples / sampleRate.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#ifndef SYNTH_PERF_STATS
+#define SYNTH_PERF_STATS 0
+#endif
+
+#if SYNTH_PERF_STATS
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+class PerfStats
+{
+public:
+    static constexpr bool ENABLED = SYNTH_PERF_STATS != 0;
+
+    /** renderBlock() stages; engines that fuse stages leave the others at 0 */
+    enum Stage
+    {
+        Voices = 0,  // Oscillators, envelopes and anything else per voice
+        Filter,      // Filters run outside the voices
+        Effects,     // Delay, reverb, saturation, compression
+        Master,      // Master gain, limiting and output copy
+        NUM_STAGES
+    };
+
+    /** Lower-case stage name for reports ("voices", "filter", ...) */
+    static constexpr const char* getStageName(int stage) noexcept
+    {
+        constexpr const char* names[NUM_STAGES] = {"voices", "filter", "effects", "master"};
+        return stage >= 0 && stage < NUM_STAGES ? names[stage] : "";
+    }
+
+    /** Blocks per active voice count; the last bucket collects 16 and more */
+    static constexpr int HISTOGRAM_SIZE = 17;
+
+    struct Snapshot
+    {
+        bool enabled = ENABLED;
+        uint64_t blocks = 0;
+        uint64_t blocksOverBudget = 0;
+        double lastBlockUs = 0.0;
+        double worstBlockUs = 0.0;
+        double averageLoad = 0.0;                   // Render time / audio time, 1.0 = one full core
+        std::array<uint64_t, NUM_STAGES> stageCycles{};
+        uint64_t blockCycles = 0;                   // Total, for stage shares
+        std::array<uint64_t, HISTOGRAM_SIZE> voiceHistogram{};
+
+        /** Values in toFlat() order */
+        static constexpr int FLAT_SIZE = 7 + NUM_STAGES + HISTOGRAM_SIZE;
+
+        /**
+         * @brief Write every field as a double (for the WASM export)
+         *
+         * Order: enabled, blocks, blocksOverBudget, lastBlockUs, worstBlockUs,
+         * averageLoad, blockCycles, stageCycles[NUM_STAGES],
+         * voiceHistogram[HISTOGRAM_SIZE].
+         */
+        void toFlat(double* out) const
+        {
+            int i = 0;
+            out[i++] = enabled ? 1.0 : 0.0;
+            out[i++] = static_cast<double>(blocks);
+            out[i++] = static_cast<double>(blocksOverBudget);
+            out[i++] = lastBlockUs;
+            out[i++] = worstBlockUs;
+            out[i++] = averageLoad;
+            out[i++] = static_cast<double>(blockCycles);
+            for (uint64_t c : stageCycles)
+                out[i++] = static_cast<double>(c);
+            for (uint64_t n : voiceHistogram)
+                out[i++] = static_cast<double>(n);
+        }
+    };
+
+    /** Times one stage for as long as it is in scope (audio thread) */
+    class ScopedStage
+    {
+    public:
+        ScopedStage(PerfStats& s, Stage st) noexcept
+#if SYNTH_PERF_STATS
+            : stats(s), stage(st), start(readCycleCounter())
+#endif
+        {
+            (void)s;
+            (void)st;
+        }
+
+        ~ScopedStage()
+        {
+#if SYNTH_PERF_STATS
+            stats.stageAccum[stage] += readCycleCounter() - start;
+#endif
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+
+#if SYNTH_PERF_STATS
+    private:
+        PerfStats& stats;
+        Stage stage;
+        uint64_t start;
+#endif
+    };
+
+    /** Set the rate for the budget check and clear the counters (prepare) */
+    void prepare(double sr) noexcept
+    {
+        sampleRate = sr;
+        reset();
+    }
+
+    /** Clear the counters - only while the audio thread isn't rendering */
+    void reset() noexcept
+    {
+        if constexpr (ENABLED)
+        {
+            blocks = 0;
+            overBudget = 0;
+            worstNs = 0.0;
+            totalNs = 0.0;
+            audioNs = 0.0;
+            totalCycles = 0;
+            stageAccum.fill(0);
+            stageTotal.fill(0);
+            histogram.fill(0);
+            publish(0.0);
+        }
+    }
+
+    /** Start of renderBlock() (audio thread) */
+    void beginBlock() noexcept
+    {
+        if constexpr (ENABLED)
+        {
+            blockStartNs = readWallNs();
+            blockStartCycles = readCycleCounter();
+            stageAccum.fill(0);
+        }
+    }
+
+    /** End of renderBlock() (audio thread) */
+    void endBlock(int numSamples, int activeVoices) noexcept
+    {
+        if constexpr (ENABLED)
+        {
+            const double elapsedNs = readWallNs() - blockStartNs;
+            const double budgetNs = 1.0e9 * numSamples / sampleRate;
+
+            ++blocks;
+            if (elapsedNs > budgetNs)
+                ++overBudget;
+            worstNs = std::max(worstNs, elapsedNs);
+            totalNs += elapsedNs;
+            audioNs += budgetNs;
+            totalCycles += readCycleCounter() - blockStartCycles;
+
+            for (int s = 0; s < NUM_STAGES; ++s)
+                stageTotal[static_cast<size_t>(s)] += stageAccum[static_cast<size_t>(s)];
+
+            ++histogram[static_cast<size_t>(std::clamp(activeVoices, 0, HISTOGRAM_SIZE - 1))];
+            publish(elapsedNs);
+        }
+        else
+        {
+            (void)numSamples;
+            (void)activeVoices;
+        }
+    }
+
+    /** Latest readings (any thread) */
+    Snapshot getSnapshot() const noexcept
+    {
+        Snapshot snap;
+        if constexpr (ENABLED)
+        {
+            snap.blocks = shared.blocks.load(std::memory_order_relaxed);
+            snap.blocksOverBudget = shared.blocksOverBudget.load(std::memory_order_relaxed);
+            snap.lastBlockUs = shared.lastBlockUs.load(std::memory_order_relaxed);
+            snap.worstBlockUs = shared.worstBlockUs.load(std::memory_order_relaxed);
+            snap.averageLoad = shared.averageLoad.load(std::memory_order_relaxed);
+            snap.blockCycles = shared.blockCycles.load(std::memory_order_relaxed);
+            for (size_t s = 0; s < NUM_STAGES; ++s)
+                snap.stageCycles[s] = shared.stageCycles[s].load(std::memory_order_relaxed);
+            for (size_t v = 0; v < HISTOGRAM_SIZE; ++v)
+                snap.voiceHistogram[v] = shared.voiceHistogram[v].load(std::memory_order_relaxed);
+        }
+        return snap;
+    }
+
+    /** Raw cycle count; wall clock where no counter is readable */
+    static uint64_t readCycleCounter() noexcept
+    {
+#if SYNTH_PERF_STATS && !defined(__EMSCRIPTEN__) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif SYNTH_PERF_STATS && !defined(__EMSCRIPTEN__) && defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(readWallNs());
+#endif
+    }
+
+private:
+    static double readWallNs() noexcept
+    {
+#if SYNTH_PERF_STATS && defined(__EMSCRIPTEN__)
+        return emscripten_get_now() * 1.0e6;
+#else
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    void publish(double lastNs) noexcept
+    {
+        shared.blocks.store(blocks, std::memory_order_relaxed);
+        shared.blocksOverBudget.store(overBudget, std::memory_order_relaxed);
+        shared.lastBlockUs.store(lastNs * 1.0e-3, std::memory_order_relaxed);
+        shared.worstBlockUs.store(worstNs * 1.0e-3, std::memory_order_relaxed);
+        shared.averageLoad.store(audioNs > 0.0 ? totalNs / audioNs : 0.0, std::memory_order_relaxed);
+        shared.blockCycles.store(totalCycles, std::memory_order_relaxed);
+        for (size_t s = 0; s < NUM_STAGES; ++s)
+            shared.stageCycles[s].store(stageTotal[s], std::memory_order_relaxed);
+        for (size_t v = 0; v < HISTOGRAM_SIZE; ++v)
+            shared.voiceHistogram[v].store(histogram[v], std::memory_order_relaxed);
+    }
+
+    double sampleRate = 48000.0;
+
+    // Audio thread only
+    double blockStartNs = 0.0;
+    uint64_t blockStartCycles = 0;
+    uint64_t blocks = 0;
+    uint64_t overBudget = 0;
+    double worstNs = 0.0;
+    double totalNs = 0.0;
+    double audioNs = 0.0;
+    uint64_t totalCycles = 0;
+    std::array<uint64_t, NUM_STAGES> stageAccum{};
+    std::array<uint64_t, NUM_STAGES> stageTotal{};
+    std::array<uint64_t, HISTOGRAM_SIZE> histogram{};
+
+    // Published copy read by getSnapshot()
+    struct Shared
+    {
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> blocksOverBudget{0};
+        std::atomic<double> lastBlockUs{0.0};
+        std::atomic<double> worstBlockUs{0.0};
+        std::atomic<double> averageLoad{0.0};
+        std::atomic<uint64_t> blockCycles{0};
+        std::array<std::atomic<uint64_t>, NUM_STAGES> stageCycles{};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_SIZE> voiceHistogram{};
+    };
+
+    Shared shared;
+};
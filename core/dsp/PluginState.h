@@ -0,0 +1,255 @@
+/**
+ * @file PluginState.h
+ * @brief Flat binary plugin state: parameter ID hashes and values, plus chunks
+ *
+ * getStateInformation() used to copy the APVTS tree, turn it into XML and
+ * wrap that, and setStateInformation() parsed it all back. Hosts call both
+ * for undo snapshots and autosave, so with dozens of instances the XML
+ * round trips showed up as UI hitches. This layout is one pass over the
+ * parameters each way:
+ *
+ *   // getStateInformation
+ *   PluginState::Writer state(numParameters);
+ *   for (each parameter)
+ *       state.addParameter(PluginState::idHash(id), plainValue);
+ *   state.addChunk(PluginState::tag("TAPE"), blob.data(), blob.size());  // Optional
+ *
+ *   // setStateInformation
+ *   if (!PluginState::isState(data, size))
+ *       ...  // Saved before this format: the XML
+ *   else if (PluginState::canRead(data, size))
+ *   {
+ *       PluginState::Values saved;
+ *       PluginState::read(data, size, saved.collector(), onChunk);
+ *       PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
+ *   }
+ *
+ * Layout (little-endian): "ASTA", u16 version, u16 0, u32 parameter count;
+ * count x (u32 ID hash, f32 plain value); then chunks to the end, each
+ * u32 tag, u32 size, size bytes. IDs are 32-bit FNV-1a hashes, so a reader
+ * skips parameters it doesn't have, as the XML did, and chunks it doesn't
+ * know.
+ *
+ * The version is that of the layout. A state from a newer build, in a
+ * layout this one doesn't know, is refused whole (canRead(), read()), so
+ * the plugin keeps what it has rather than resetting to defaults; when
+ * the layout changes, read() takes the older versions by their number.
+ *
+ * @note Writer and Values allocate: message thread only, like the XML it replaces.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace PluginState
+{
+static constexpr uint16_t VERSION = 1;  // Of the layout; 1 is the first
+static constexpr size_t HEADER_BYTES = 12;
+static constexpr size_t PARAMETER_BYTES = 8;
+static constexpr size_t CHUNK_HEADER_BYTES = 8;
+
+/** 32-bit FNV-1a of a parameter ID */
+constexpr uint32_t idHash(std::string_view id)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : id)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/** A chunk tag from four characters, e.g. tag("TAPE") */
+constexpr uint32_t tag(const char (&name)[5])
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(name[0])) | static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8
+           | static_cast<uint32_t>(static_cast<uint8_t>(name[2])) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24;
+}
+
+namespace detail
+{
+inline void putU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b)
+        out.push_back(static_cast<uint8_t>(v >> (8 * b)));
+}
+
+inline void setU32(uint8_t* p, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b)
+        p[b] = static_cast<uint8_t>(v >> (8 * b));
+}
+
+inline uint32_t getU32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16
+           | static_cast<uint32_t>(p[3]) << 24;
+}
+} // namespace detail
+
+/** Builds a state: every parameter first, then any chunks */
+class Writer
+{
+public:
+    /** numParameters only sizes the buffer; the count written is what was added */
+    explicit Writer(size_t numParameters = 0)
+    {
+        out.reserve(HEADER_BYTES + numParameters * PARAMETER_BYTES);
+        out.insert(out.end(), {'A', 'S', 'T', 'A'});
+        out.push_back(static_cast<uint8_t>(VERSION & 0xFF));
+        out.push_back(static_cast<uint8_t>(VERSION >> 8));
+        out.push_back(0);
+        out.push_back(0);
+        detail::putU32(out, 0);
+    }
+
+    void addParameter(uint32_t hash, float value)
+    {
+        if (hasChunks)
+            return;  // The layout has no room for it after a chunk
+
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        detail::putU32(out, hash);
+        detail::putU32(out, bits);
+        detail::setU32(out.data() + 8, ++numParameters);
+    }
+
+    void addChunk(uint32_t chunkTag, const uint8_t* data, size_t size)
+    {
+        hasChunks = true;
+        detail::putU32(out, chunkTag);
+        detail::putU32(out, static_cast<uint32_t>(size));
+        out.insert(out.end(), data, data + size);
+    }
+
+    const std::vector<uint8_t>& data() const { return out; }
+
+private:
+    std::vector<uint8_t> out;
+    uint32_t numParameters = 0;
+    bool hasChunks = false;
+};
+
+/** True if data starts as a state from Writer (anything else is an older format) */
+inline bool isState(const void* data, size_t size)
+{
+    return data != nullptr && size >= HEADER_BYTES && std::memcmp(data, "ASTA", 4) == 0;
+}
+
+/** The layout version a state was written in, or 0 if it isn't a state */
+inline uint16_t getVersion(const void* data, size_t size)
+{
+    if (!isState(data, size))
+        return 0;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    return static_cast<uint16_t>(bytes[4] | bytes[5] << 8);
+}
+
+/** True if this build reads the state: its version is VERSION or older */
+inline bool canRead(const void* data, size_t size)
+{
+    const uint16_t version = getVersion(data, size);
+    return version >= 1 && version <= VERSION;
+}
+
+/**
+ * @brief Read a state: onParameter(hash, value) per parameter, onChunk(tag, data, size) per chunk
+ * @return False if it isn't one this build reads (nothing is reported) or is cut short
+ *         (whatever came before the cut still is)
+ */
+template <typename ParameterFn, typename ChunkFn>
+bool read(const void* data, size_t size, ParameterFn&& onParameter, ChunkFn&& onChunk)
+{
+    using detail::getU32;
+    if (!canRead(data, size))
+        return false;
+
+    // Version 1 is the only layout so far
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const size_t numParameters = getU32(bytes + 8);
+    size_t offset = HEADER_BYTES;
+
+    for (size_t i = 0; i < numParameters; ++i, offset += PARAMETER_BYTES)
+    {
+        if (size - offset < PARAMETER_BYTES)
+            return false;
+        const uint32_t bits = getU32(bytes + offset + 4);
+        float value = 0.0f;
+        std::memcpy(&value, &bits, sizeof(value));
+        onParameter(getU32(bytes + offset), value);
+    }
+
+    while (offset < size)
+    {
+        if (size - offset < CHUNK_HEADER_BYTES)
+            return false;
+        const uint32_t chunkTag = getU32(bytes + offset);
+        const size_t chunkSize = getU32(bytes + offset + 4);
+        offset += CHUNK_HEADER_BYTES;
+        if (size - offset < chunkSize)
+            return false;
+        onChunk(chunkTag, bytes + offset, chunkSize);
+        offset += chunkSize;
+    }
+    return true;
+}
+
+/** A state's parameter values by ID hash, so restoring finds each parameter's in one lookup */
+class Values
+{
+public:
+    /** One saved parameter; the first value saved for a hash wins */
+    void add(uint32_t hash, float value) { values.emplace(hash, value); }
+
+    /** add() as read()'s onParameter */
+    auto collector()
+    {
+        return [this](uint32_t hash, float value) { add(hash, value); };
+    }
+
+    /** The saved plain value, or nullptr if the state has none (or not a finite one) */
+    const float* find(uint32_t hash) const
+    {
+        const auto it = values.find(hash);
+        return it != values.end() && std::isfinite(it->second) ? &it->second : nullptr;
+    }
+
+    size_t size() const { return values.size(); }
+
+private:
+    std::unordered_map<uint32_t, float> values;
+};
+
+/**
+ * @brief Set each parameter to its saved value, or to its default where the state has none (as the XML did)
+ * @param parameters Pointers to the plugin's parameters (AudioProcessor::getParameters())
+ *
+ * Ranged is the parameter type with an ID and a range,
+ * juce::RangedAudioParameter: paramID.toRawUTF8(), convertTo0to1(),
+ * getDefaultValue() and setValueNotifyingHost(). Parameters of any other
+ * type are left alone.
+ */
+template <typename Ranged, typename Parameters>
+void applyParameters(const Values& saved, const Parameters& parameters)
+{
+    for (auto* parameter : parameters)
+    {
+        auto* ranged = dynamic_cast<Ranged*>(parameter);
+        if (ranged == nullptr)
+            continue;
+
+        const float* value = saved.find(idHash(ranged->paramID.toRawUTF8()));
+        ranged->setValueNotifyingHost(value != nullptr ? ranged->convertTo0to1(*value) : ranged->getDefaultValue());
+    }
+}
+} // namespace PluginState
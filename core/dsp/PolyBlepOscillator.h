@@ -0,0 +1,204 @@
+/**
+ * @file PolyBlepOscillator.h
+ * @brief Saw, triangle, pulse and sine with polyBLEP edges and hard sync
+ *
+ * The cheap band-limited oscillator: the saw and pulse are the naive
+ * waveforms with a two-sample polynomial residual subtracted at each
+ * edge, the triangle and sine are left as they are. Next to the elliptic
+ * BLEP in BandLimitedOscillator.h it aliases more at the top of the
+ * range, and costs a few multiplies per sample with no history to keep.
+ *
+ *   PolyBlepOscillator osc;
+ *   osc.setSampleRate(sampleRate);
+ *   osc.setWaveform(PolyBlepOscillator::Waveform::Pulse);
+ *   osc.setFrequency(hz);
+ *   out = osc.process();
+ *
+ * sync() restarts the phase at the point in the step where a master
+ * wrapped (its wrapFraction()), with the jump polyBLEP-smoothed.
+ * setBandLimited(false) drops the residuals, for the web DFAM's draft and
+ * normal tiers.
+ *
+ * The sine is sst's fastsin (FastMath.h's copy), as -fastsin(2 pi p - pi),
+ * so SIMD renderers that run several of these side by side (ModelD's
+ * VoiceGroup, through getLaneState() / setLaneState()) can match it with
+ * fastsinSSE lane for lane.
+ *
+ * Header-only and free of sst, like ADEnvelope.h and LFO.h, so the web
+ * builds share it too.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "FastMath.h"
+
+class PolyBlepOscillator
+{
+public:
+    enum class Waveform { Saw, Triangle, Pulse, Sine };
+
+    void setSampleRate(float sr) { sampleRate = sr; }
+
+    void setFrequency(float freq)
+    {
+        frequency = freq;
+        phaseIncrement = frequency / sampleRate;
+    }
+
+    void setWaveform(Waveform wf) { waveform = wf; }
+    void setPulseWidth(float pw) { pulseWidth = std::clamp(pw, 0.1f, 0.9f); }
+    void setLevel(float l) { level = l; }
+
+    /** polyBLEP on the saw and pulse edges (the default), or the naive waveforms */
+    void setBandLimited(bool on) { bandLimited = on; }
+
+    void reset()
+    {
+        phase = 0.0f;
+        syncBlep = 0.0f;
+    }
+
+    /** Fraction of the last process() step that came after the phase wrapped, or -1 if it didn't */
+    float wrapFraction() const { return phase < phaseIncrement ? phase / phaseIncrement : -1.0f; }
+
+    /**
+     * @brief Hard sync: restart the phase where the master wrapped, band-limited
+     * @param after The master's wrapFraction() for the same step
+     * @return Correction to add to the sample process() just returned
+     *
+     * Call after process(). The phase restarts at the exact point in the
+     * step where the master wrapped, so it is increment * after now. The
+     * waveform jumps there from wherever it was to its start; a polyBLEP of
+     * that height is split between the sample just returned and the next.
+     * process() smooths its own edge at phase 0 next sample as if the phase
+     * had wrapped naturally, so that edge comes off the second half.
+     */
+    float sync(float after)
+    {
+        float before = phase - phaseIncrement * after;  // Phase at the master's wrap
+        if (before < 0.0f)
+            before += 1.0f;
+        phase = phaseIncrement * after;
+
+        const float jump = naive(0.0f) - naive(before);
+        const float tail = 1.0f - after;
+        syncBlep = 0.5f * (edgeAtZero() - jump) * tail * tail;
+        return 0.5f * jump * after * after * level;
+    }
+
+    float process()
+    {
+        float output = naive(phase);
+
+        if (bandLimited)
+        {
+            if (waveform == Waveform::Saw)
+                output -= polyBlep(phase, phaseIncrement);
+            else if (waveform == Waveform::Pulse)
+            {
+                output += polyBlep(phase, phaseIncrement);
+                output -= polyBlep(wrapped(phase + 1.0f - pulseWidth), phaseIncrement);
+            }
+        }
+
+        // Second half of the last sync's polyBLEP
+        output += syncBlep;
+        syncBlep = 0.0f;
+
+        phase += phaseIncrement;
+        if (phase >= 1.0f)
+            phase -= 1.0f;
+
+        return output * level;
+    }
+
+    float getPhase() const { return phase; }
+
+    /** What a SIMD renderer carries per lane between blocks */
+    struct LaneState
+    {
+        float phase = 0.0f;
+        float increment = 0.0f;
+        float syncBlep = 0.0f;  // Second half of a sync's polyBLEP, due next sample
+    };
+
+    LaneState getLaneState() const { return {phase, phaseIncrement, syncBlep}; }
+
+    void setLaneState(const LaneState& s)
+    {
+        phase = s.phase;
+        phaseIncrement = s.increment;
+        frequency = s.increment * sampleRate;
+        syncBlep = s.syncBlep;
+    }
+
+private:
+    static constexpr float PI = 3.14159265358979323846f;
+    static constexpr float TWO_PI = 2.0f * PI;
+
+    // One step of wrap for phase + 1 - pw, which stays in [0.1, 2)
+    static float wrapped(float p) { return p >= 1.0f ? p - 1.0f : p; }
+
+    /** The waveform at phase p, before any polyBLEP */
+    float naive(float p) const
+    {
+        switch (waveform)
+        {
+            case Waveform::Saw:
+                return 2.0f * p - 1.0f;
+            case Waveform::Triangle:
+                return p < 0.5f ? 4.0f * p - 1.0f : 3.0f - 4.0f * p;
+            case Waveform::Pulse:
+                return p < pulseWidth ? 1.0f : -1.0f;
+            case Waveform::Sine:
+            default:
+                // sin(2 pi p) == -sin(2 pi p - pi), in fastsin's [-pi, pi]
+                return -FastMath::detail::fastsin(TWO_PI * p - PI);
+        }
+    }
+
+    /** Height of the edge process() smooths at phase 0 */
+    float edgeAtZero() const
+    {
+        if (!bandLimited)
+            return 0.0f;
+        switch (waveform)
+        {
+            case Waveform::Saw:
+                return -2.0f;
+            case Waveform::Pulse:
+                return 2.0f;
+            default:
+                return 0.0f;
+        }
+    }
+
+    /** Two-sample polynomial residual of a unit step at phase 0 */
+    static float polyBlep(float t, float dt)
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+        if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+        return 0.0f;
+    }
+
+    float sampleRate = 44100.0f;
+    float frequency = 440.0f;
+    float phase = 0.0f;
+    float phaseIncrement = 0.01f;
+    float pulseWidth = 0.5f;
+    float level = 1.0f;
+    float syncBlep = 0.0f;
+    bool bandLimited = true;
+    Waveform waveform = Waveform::Saw;
+};
@@ -0,0 +1,332 @@
+/**
+ * @file PresetAudition.h
+ * @brief Preset previews: a held note rendered off the audio thread, played from memory
+ *
+ * Browsing presets meant loading each into the live engine and playing
+ * it. Instead the editor asks for an audition: a worker thread loads the
+ * preset into an engine of its own, at the draft tier where the engine
+ * has one, renders one held note (C3 for two seconds by default) faster
+ * than real time and hands the clip to a sample player the processor
+ * mixes in after the live engine. The live engine and its parameters
+ * are never touched.
+ *
+ *   // prepareToPlay (message thread)
+ *   audition.prepare(sampleRate);
+ *
+ *   // The browser (message thread), per preset selected
+ *   audition.audition(presetParams);
+ *
+ *   // processBlock, after the engine
+ *   audition.mix(left, right, numSamples);
+ *
+ * Clips are cached by a hash of the preset's values, so going back to a
+ * preset plays at once; the last MAX_CLIPS are kept. Requests made while
+ * the worker renders replace each other and only the newest is rendered,
+ * so scrolling through a bank doesn't queue up a render per preset. A new
+ * clip starts from its beginning, cutting off the one playing.
+ *
+ * The Engine needs prepare(sampleRate, blockSize), applySnapshot(Params),
+ * noteOn(note, velocity), noteOff(note) and renderBlock(left, right, n);
+ * setQualityTier() and setNoiseSeed() are used if it has them, the seed
+ * taken from the key so a clip always renders the same. Params is a
+ * ParamSnapshot, its values plain (as applySnapshot() takes them).
+ *
+ * @note audition(), stop() and prepare() on the message thread; mix() on
+ *       the audio thread, which never waits or allocates. Each cached clip
+ *       is seconds * sampleRate * 2 floats (768 KB at the defaults, 48 kHz).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "QualityTier.h"
+#include "StatePublisher.h"
+
+template <typename Engine, typename Params>
+class PresetAudition
+{
+public:
+    static constexpr int MAX_CLIPS = 16;
+
+    struct Settings
+    {
+        int note = 48;              // C3
+        float velocity = 0.8f;
+        double seconds = 2.0;       // Clip length
+        double heldSeconds = 1.5;   // Note off here, so the release is in the clip
+        double prerollSeconds = 0.05;  // Rendered and dropped, while the preset's smoothing settles
+        int blockSize = 256;
+    };
+
+    PresetAudition() = default;
+    ~PresetAudition() { shutdown(); }
+
+    PresetAudition(const PresetAudition&) = delete;
+    PresetAudition& operator=(const PresetAudition&) = delete;
+
+    /** Render at sampleRate from now on; drops the cached clips (message thread) */
+    void prepare(double rate, const Settings& s = {})
+    {
+        shutdown();
+        sampleRate = rate;
+        settings = s;
+        cache.clear();
+    }
+
+    /** Play preset's clip, rendering it first if it isn't cached (message thread) */
+    void audition(const Params& preset)
+    {
+        post(Request::Play, &preset);
+    }
+
+    /** Cut off the clip playing (message thread) */
+    void stop() { post(Request::Stop, nullptr); }
+
+    /** Block until the worker has handled every request so far */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return request == Request::None && !busy; });
+    }
+
+    /** Clips cached (for tests and the editor) */
+    int getNumCached() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(cache.size());
+    }
+
+    /** The cache key of a preset's values */
+    static uint64_t keyOf(const Params& preset)
+    {
+        uint64_t key = 0xcbf29ce484222325ull;  // FNV-1a over the values' bits
+        for (int i = 0; i < Params::SIZE; ++i)
+        {
+            const float value = preset[i];
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int b = 0; b < 4; ++b)
+                key = (key ^ ((bits >> (8 * b)) & 0xffu)) * 0x100000001b3ull;
+        }
+        return key;
+    }
+
+    /** Add the clip playing into the buffers (audio thread) */
+    void mix(float* left, float* right, int numSamples)
+    {
+        if (const Playback* fresh = clips.readFresh())
+        {
+            playing = fresh;
+            position = 0;
+        }
+        if (playing == nullptr)
+            return;
+
+        const int n = std::min(numSamples, playing->length - position);
+        const float* l = playing->left.data() + position;
+        const float* r = playing->right.data() + position;
+        for (int i = 0; i < n; ++i)
+        {
+            left[i] += l[i];
+            right[i] += r[i];
+        }
+        position += std::max(n, 0);
+    }
+
+    /** True while a clip has samples left (audio thread) */
+    bool isPlaying() const { return playing != nullptr && position < playing->length; }
+
+private:
+    enum class Request
+    {
+        None,
+        Play,
+        Stop
+    };
+
+    struct Clip
+    {
+        uint64_t key = 0;
+        std::vector<float> left, right;
+    };
+
+    /** What the audio thread plays: the clip's samples, copied in by the worker */
+    struct Playback
+    {
+        std::vector<float> left, right;
+        int length = 0;
+    };
+
+    void post(Request kind, const Params* preset)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            request = kind;
+            if (preset != nullptr)
+                requested = *preset;
+        }
+        if (!worker.joinable())
+            worker = std::thread([this] { run(); });
+        wake.notify_one();
+    }
+
+    void shutdown()
+    {
+        if (!worker.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_one();
+        worker.join();
+        quit = false;
+        request = Request::None;
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            wake.wait(lock, [this] { return request != Request::None || quit; });
+            if (quit)
+                return;
+
+            const Request kind = request;
+            const Params preset = requested;
+            request = Request::None;
+            busy = true;
+
+            std::shared_ptr<const Clip> clip;
+            if (kind == Request::Play)
+            {
+                const uint64_t key = keyOf(preset);
+                clip = find(key);
+                if (clip == nullptr)
+                {
+                    lock.unlock();
+                    clip = render(preset, key);
+                    lock.lock();
+                    store(clip);
+                }
+            }
+
+            lock.unlock();
+            play(clip.get());
+            lock.lock();
+            busy = false;
+            idle.notify_all();
+        }
+    }
+
+    /** The cached clip for key, made the most recent; nullptr if there's none (mutex held) */
+    std::shared_ptr<const Clip> find(uint64_t key)
+    {
+        const auto it = std::find_if(cache.begin(), cache.end(), [key](const auto& c) { return c->key == key; });
+        if (it == cache.end())
+            return nullptr;
+        std::rotate(it, it + 1, cache.end());
+        return cache.back();
+    }
+
+    /** Cache a clip, dropping the least recently played past MAX_CLIPS (mutex held) */
+    void store(std::shared_ptr<const Clip> clip)
+    {
+        if (static_cast<int>(cache.size()) >= MAX_CLIPS)
+            cache.erase(cache.begin());
+        cache.push_back(std::move(clip));
+    }
+
+    std::shared_ptr<const Clip> render(const Params& preset, uint64_t key)
+    {
+        if (engine == nullptr)
+            engine = std::make_unique<Engine>();
+
+        const int block = std::max(settings.blockSize, 1);
+        engine->prepare(sampleRate, block);
+        if constexpr (requires { engine->setQualityTier(QualityTier::Draft); })
+            engine->setQualityTier(QualityTier::Draft);
+        if constexpr (requires { engine->setNoiseSeed(uint32_t{}); })
+            engine->setNoiseSeed(static_cast<uint32_t>(key ^ (key >> 32)));
+
+        Params values = preset;
+        values.markAllChanged();  // A fresh engine needs every value
+        engine->applySnapshot(values);
+
+        auto clip = std::make_shared<Clip>();
+        clip->key = key;
+        const int length = std::max(0, static_cast<int>(settings.seconds * sampleRate));
+        const int held = static_cast<int>(settings.heldSeconds * sampleRate);
+        clip->left.assign(static_cast<size_t>(length), 0.0f);
+        clip->right.assign(static_cast<size_t>(length), 0.0f);
+
+        std::vector<float> scratchL(static_cast<size_t>(block)), scratchR(static_cast<size_t>(block));
+        for (int done = 0, preroll = static_cast<int>(settings.prerollSeconds * sampleRate); done < preroll; done += block)
+            engine->renderBlock(scratchL.data(), scratchR.data(), std::min(block, preroll - done));
+
+        engine->noteOn(settings.note, settings.velocity);
+        bool released = false;
+        for (int done = 0; done < length;)
+        {
+            // Blocks end at the note off, so it lands on its sample
+            int n = std::min(block, length - done);
+            if (!released && done < held)
+                n = std::min(n, held - done);
+            else if (!released)
+            {
+                engine->noteOff(settings.note);
+                released = true;
+            }
+            engine->renderBlock(clip->left.data() + done, clip->right.data() + done, n);
+            done += n;
+        }
+        return clip;
+    }
+
+    /** Hand a clip (or silence, for nullptr) to the audio thread */
+    void play(const Clip* clip)
+    {
+        Playback& slot = clips.write();
+        if (clip == nullptr)
+        {
+            slot.length = 0;
+        }
+        else
+        {
+            slot.left.assign(clip->left.begin(), clip->left.end());
+            slot.right.assign(clip->right.begin(), clip->right.end());
+            slot.length = static_cast<int>(clip->left.size());
+        }
+        clips.publish();
+    }
+
+    double sampleRate = 44100.0;
+    Settings settings;
+
+    // Worker: its engine and the cache, the request it takes next
+    std::unique_ptr<Engine> engine;
+    std::vector<std::shared_ptr<const Clip>> cache;  // Least recently played first
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    Request request = Request::None;
+    Params requested;
+    bool busy = false;
+    bool quit = false;
+    std::thread worker;
+
+    // Worker to audio thread
+    StatePublisher<Playback> clips;
+    const Playback* playing = nullptr;  // Audio thread
+    int position = 0;
+};
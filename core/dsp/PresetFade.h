@@ -0,0 +1,108 @@
+/**
+ * @file PresetFade.h
+ * @brief Fade out, switch patch at silence, fade back in
+ *
+ * A whole preset applied between two samples still clicks: waveforms,
+ * envelope times and filter settings all jump while voices sound. The
+ * engine fades its output out over a few milliseconds, switches at the
+ * bottom, and fades back in:
+ *
+ *   // loadPreset() (audio thread)
+ *   pending = &preset;
+ *   fade.start();
+ *
+ *   // renderBlock: never render past the next turn
+ *   n = std::min(n, fade.samplesToTurn());
+ *   render(outL, outR, n);
+ *   if (fade.apply(outL, outR, n))
+ *       applySnapshot(*pending);            // At silence
+ *
+ * start() during a fade turns it around from wherever it is, so a burst
+ * of presets (browsing with the arrow keys) keeps fading out and only the
+ * last one is switched in. With nothing sounding there's nothing to fade:
+ * the engine can apply the preset at once and skip this.
+ *
+ * @note Audio thread only; prepare() sets the length
+ */
+
+#pragma once
+
+#include <algorithm>
+
+class PresetFade
+{
+public:
+    /** Each half (out, then in) */
+    static constexpr double FADE_SECONDS = 0.005;
+
+    void prepare(double sampleRate)
+    {
+        length = std::max(1, static_cast<int>(sampleRate * FADE_SECONDS));
+        reset();
+    }
+
+    void reset()
+    {
+        state = State::Idle;
+        position = 0;
+    }
+
+    /** Fade out towards a switch; a fade in turns back from its current gain */
+    void start()
+    {
+        if (state == State::In)
+            position = length - position;
+        else if (state == State::Idle)
+            position = 0;
+        state = State::Out;
+    }
+
+    bool isActive() const { return state != State::Idle; }
+
+    /** True while fading out: the switch hasn't happened yet */
+    bool isFadingOut() const { return state == State::Out; }
+
+    /** Samples until the fade out reaches silence or the fade in ends (a large number when idle) */
+    int samplesToTurn() const { return state == State::Idle ? 1 << 30 : length - position; }
+
+    /**
+     * @brief Scale n samples, n <= samplesToTurn()
+     * @return True when this reached silence: switch now, the fade in follows
+     */
+    bool apply(float* left, float* right, int n)
+    {
+        if (state == State::Idle)
+            return false;
+
+        const float step = 1.0f / static_cast<float>(length);
+        const float sign = state == State::Out ? -1.0f : 1.0f;
+        float gain = state == State::Out ? 1.0f - position * step : position * step;
+
+        for (int i = 0; i < n; ++i)
+        {
+            gain += sign * step;
+            left[i] *= gain;
+            right[i] *= gain;
+        }
+
+        position += n;
+        if (position < length)
+            return false;
+
+        position = 0;
+        if (state == State::Out)
+        {
+            state = State::In;
+            return true;
+        }
+        state = State::Idle;
+        return false;
+    }
+
+private:
+    enum class State { Idle, Out, In };
+
+    State state = State::Idle;
+    int position = 0;
+    int length = 240;
+};
@@ -0,0 +1,126 @@
+/**
+ * @file PresetMorph.h
+ * @brief Two to MAX_PRESETS presets along one knob, compiled to start + delta arrays
+ *
+ * Morphing by calling every setter with a blend of two patches costs a
+ * setter per parameter per block, moving or not. compile() (message
+ * thread) instead keeps only the parameters the presets disagree on, and
+ * for each pair of neighbours stores their start values and the deltas to
+ * the next, packed. evaluate() (audio thread) is then one lerp over a
+ * dense array: pick the pair the position falls in, start + t * delta.
+ *
+ *   // Message thread: normalised 0..1 values, one array per preset
+ *   morphs.write().compile(presets.data(), numPresets);
+ *   morphs.publish();
+ *
+ *   // processBlock(), when the knob or the morph moved
+ *   const int n = morph->evaluate(position, values.data());
+ *   for (int m = 0; m < n; ++m)
+ *       snapshot.set(morph->paramAt(m), fromNormalised(morph->paramAt(m), values[m]));
+ *
+ * ParamSnapshot::set() marks only values that moved, so the engine's
+ * applySnapshot() still re-derives just what changed. Values are
+ * interpolated normalised, the way the host's automation moves them: the
+ * caller maps them back through each parameter's range, which also snaps
+ * choices and toggles to the nearer preset's setting. Parameters every
+ * preset agrees on aren't morphed at all and stay free for automation.
+ *
+ * Fixed-size storage, no allocation: compile into a StatePublisher slot.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+template <int NumParams>
+class PresetMorph
+{
+public:
+    static constexpr int MAX_PRESETS = 8;
+
+    using Values = std::array<float, NumParams>;
+
+    /**
+     * @brief Build the morph through @p count presets, in knob order
+     * @return False (and no morph) for fewer than two or more than MAX_PRESETS
+     */
+    bool compile(const Values* presets, int count)
+    {
+        numPresets = 0;
+        numMorphed = 0;
+        morphed.fill(false);
+        if (presets == nullptr || count < 2 || count > MAX_PRESETS)
+            return false;
+
+        for (int id = 0; id < NumParams; ++id)
+        {
+            const auto i = static_cast<size_t>(id);
+            bool differs = false;
+            for (int p = 1; p < count; ++p)
+                differs = differs || presets[p][i] != presets[0][i];
+            if (!differs)
+                continue;
+
+            const auto m = static_cast<size_t>(numMorphed++);
+            ids[m] = id;
+            morphed[i] = true;
+            for (int s = 0; s < count - 1; ++s)
+            {
+                start[static_cast<size_t>(s)][m] = presets[s][i];
+                delta[static_cast<size_t>(s)][m] = presets[s + 1][i] - presets[s][i];
+            }
+        }
+
+        numPresets = count;
+        return true;
+    }
+
+    /** True once compile() succeeded */
+    bool isActive() const { return numPresets >= 2; }
+
+    int getNumPresets() const { return numPresets; }
+
+    /** Parameters the presets disagree on: evaluate() writes one value per */
+    int getNumMorphed() const { return numMorphed; }
+
+    /** ParamId of evaluate()'s m-th value */
+    int paramAt(int m) const { return ids[static_cast<size_t>(m)]; }
+
+    /** True if evaluate() produces @p id (every preset has the same value otherwise) */
+    bool isMorphed(int id) const { return morphed[static_cast<size_t>(id)]; }
+
+    /**
+     * @brief Normalised values at @p position (0 first preset, 1 last)
+     * @param out getNumMorphed() values, in paramAt() order
+     * @return getNumMorphed()
+     */
+    int evaluate(float position, float* out) const
+    {
+        if (!isActive())
+            return 0;
+
+        const int segments = numPresets - 1;
+        const float x = std::clamp(position, 0.0f, 1.0f) * static_cast<float>(segments);
+        const int s = std::min(static_cast<int>(x), segments - 1);
+        const float t = x - static_cast<float>(s);
+
+        // Contiguous and branch-free: vectorises
+        const float* a = start[static_cast<size_t>(s)].data();
+        const float* d = delta[static_cast<size_t>(s)].data();
+        for (int m = 0; m < numMorphed; ++m)
+            out[m] = a[m] + t * d[m];
+
+        return numMorphed;
+    }
+
+private:
+    int numPresets = 0;
+    int numMorphed = 0;
+
+    // Per segment (preset s to s + 1), packed over the morphed parameters
+    alignas(64) std::array<Values, MAX_PRESETS - 1> start{};
+    alignas(64) std::array<Values, MAX_PRESETS - 1> delta{};
+    std::array<int, NumParams> ids{};
+    std::array<bool, NumParams> morphed{};
+};
@@ -0,0 +1,47 @@
+/**
+ * @file QualityTier.h
+ * @brief Draft / normal / high: one knob for what an engine spends per sample
+ *
+ * An engine with tiers takes setQualityTier() at any time. Normal is what
+ * the engine's own parameters ask for, so the tier changes nothing until
+ * it's moved. Draft picks the cheapest version of each stage (browser
+ * previews on weak devices, quick offline drafts); high the best (final
+ * renders). What a tier touches is the engine's choice: interpolation
+ * order, oversampling factor, reverb density, oscillator algorithm,
+ * control-rate resolution.
+ *
+ * Switching is allocation-free once prepare() has run, and glitch-free:
+ * a stage whose state can carry over (an interpolator, a control ramp)
+ * switches on the next block; one that would have to restart (an
+ * oscillator, an oversampler's filters) switches the next time it's
+ * silent or retriggered.
+ *
+ *   engine.setQualityTier(QualityTier::Draft);
+ *   oversampling = forTier(tier, 1, userOversampling, 4);
+ */
+
+#pragma once
+
+#include <algorithm>
+
+enum class QualityTier
+{
+    Draft = 0,
+    Normal,
+    High
+};
+
+inline constexpr int NUM_QUALITY_TIERS = 3;
+
+/** Tier by index (0 draft, 1 normal, 2 high), clamped */
+inline constexpr QualityTier qualityTierFromIndex(int index)
+{
+    return static_cast<QualityTier>(std::clamp(index, 0, NUM_QUALITY_TIERS - 1));
+}
+
+/** The setting for @p tier out of the three */
+template <typename T>
+constexpr T forTier(QualityTier tier, T draft, T normal, T high)
+{
+    return tier == QualityTier::Draft ? draft : (tier == QualityTier::High ? high : normal);
+}
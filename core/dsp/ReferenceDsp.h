@@ -0,0 +1,38 @@
+/**
+ * @file ReferenceDsp.h
+ * @brief Reference build: the engines' plain scalar paths instead of their optimised kernels
+ *
+ * Off unless the build defines SYNTH_REFERENCE_DSP=1 (cmake
+ * -DSYNTH_REFERENCE_DSP=ON). When on, each optimised kernel takes the path
+ * it was written to match:
+ *
+ *   - FMSineTable: std::sin instead of the quarter-wave table
+ *   - ModelD: one Voice::render() per voice instead of VoiceGroup's lanes
+ *   - DFAM's Saturator: std::tanh instead of the polynomial
+ *   - FastMath.h: every accuracy tier is libm's, so the ladders,
+ *     saturators and soft clips that call it run std::tanh, std::sin
+ *     and std::exp
+ *   - Galactic3: std::sin per sample for the vibrato instead of the
+ *     rotating phasor, and TapeLoop runs the exact double-precision
+ *     Galactic3Reverb instead of Galactic3ReverbPacked
+ *
+ * The golden renders (core/test/GoldenRender.h) are taken from this build
+ * and every build's tests hold the engine to them, so a SIMD, table or
+ * control-rate change can land only if it still sounds like the
+ * reference. It is also the fallback for a target where the optimised
+ * kernels are suspect.
+ *
+ * Kernels branch with `if constexpr (ReferenceDsp::ENABLED)`, so the
+ * optimised build carries none of the reference code.
+ */
+
+#pragma once
+
+#ifndef SYNTH_REFERENCE_DSP
+#define SYNTH_REFERENCE_DSP 0
+#endif
+
+namespace ReferenceDsp
+{
+inline constexpr bool ENABLED = SYNTH_REFERENCE_DSP != 0;
+} // namespace ReferenceDsp
@@ -0,0 +1,102 @@
+/**
+ * @file ReleaseCull.h
+ * @brief Free releasing voices once they're too quiet to hear
+ *
+ * A voice normally stays on until its envelope idles, and an exponential
+ * release (sst's ADSREnvelope, a one-pole) spends a long stretch of that
+ * far below audibility, holding a voice of the pool. The cull frees a
+ * releasing voice as soon as its level at the output falls under a
+ * threshold, -90 dB unless setThreshold() says otherwise. A release only
+ * falls, so a voice under it at the start of a block would have stayed
+ * under it to the end.
+ *
+ * The threshold is at the output, so it is kept as a voice level: divided
+ * by the master gain the engine applies after the voices.
+ *
+ *   ReleaseCull cull;
+ *   cull.setMasterGain(masterGain);          // Whenever it changes
+ *
+ *   cull.process(active, voices, [&](int v)  // Start of each block
+ *   {
+ *       voices[v].kill();
+ *       allocator.voiceFinished(v);
+ *   });
+ *
+ * Voices need isReleasing() and getLevel() (envelope x velocity, or a
+ * bound on the voice's gain where more than the envelope drives its VCA).
+ * A CPU governor sheds load by raising the threshold (setRaised()) to
+ * RAISED_DB, or keeping the user's if that is higher.
+ *
+ * @note Audio thread; setThreshold() and setMasterGain() take a pow
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+class ReleaseCull
+{
+public:
+    static constexpr float DEFAULT_DB = -90.0f;
+    static constexpr float RAISED_DB = -60.0f;
+
+    ReleaseCull() { update(); }
+
+    /** Level re full scale at the output, after velocity and master gain (-inf: only when they idle) */
+    void setThreshold(float db)
+    {
+        thresholdDb = db;
+        update();
+    }
+
+    float getThreshold() const { return thresholdDb; }
+
+    /** The gain the engine puts on the voices' mix */
+    void setMasterGain(float gain)
+    {
+        masterGain = gain;
+        update();
+    }
+
+    /** Cull at RAISED_DB at least, to shed load */
+    void setRaised(bool on)
+    {
+        if (on == raised)
+            return;
+        raised = on;
+        update();
+    }
+
+    /** True if a releasing voice at this level (before master gain) can go */
+    bool isUnder(float voiceLevel) const { return voiceLevel < level; }
+
+    /**
+     * @brief Free the releasing voices under the threshold
+     * @param free Called with each one's index; it comes off the active list
+     */
+    template <typename ActiveList, typename Voices, typename FreeFn>
+    void process(ActiveList& active, Voices& voices, FreeFn&& free) const
+    {
+        active.update([&](int v)
+        {
+            const auto& voice = voices[v];
+            if (!voice.isReleasing() || !isUnder(voice.getLevel()))
+                return true;
+            free(v);
+            return false;
+        });
+    }
+
+private:
+    void update()
+    {
+        const float db = raised ? std::max(thresholdDb, RAISED_DB) : thresholdDb;
+        level = std::pow(10.0f, db / 20.0f) / std::max(masterGain, 1.0e-9f);
+    }
+
+    float thresholdDb = DEFAULT_DB;
+    float masterGain = 1.0f;
+    float level = 0.0f;  // The threshold as a voice level
+    bool raised = false;
+};
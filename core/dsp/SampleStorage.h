@@ -0,0 +1,218 @@
+/**
+ * @file SampleStorage.h
+ * @brief How a long buffer keeps its samples: float, half float or 16-bit
+ *
+ * Delay lines and reverbs are the big buffers: StereoDelay holds four
+ * seconds a channel, and in the browser the heap is a hard limit. They
+ * compute in float but needn't store in it. A storage policy is the type
+ * a buffer keeps (Stored) and the conversions at its two ends, a run at
+ * a time:
+ *
+ *   Float32  4 bytes  as before, the conversions are copies
+ *   Float16  2 bytes  IEEE half: 11 bits of mantissa at any level, so a
+ *                     quiet reverb tail keeps its detail; to +/-65504
+ *   Int16    2 bytes  full scale +/-1 in 16 bits, TPDF dithered so the
+ *                     truncation is noise, not distortion
+ *
+ * The owner picks per buffer (BasicStereoDelay<SampleStorage::Float16>);
+ * the default stays Float32. Half floats use F16C on x86 builds that
+ * enable it and the conversion instructions on AArch64; elsewhere (SSE4.1,
+ * WASM) a branch-free bit conversion whose loops the compiler vectorizes.
+ * Int16's loops vectorize everywhere.
+ *
+ * Int16 stores anything under one step (-90 dB) as an exact zero, without
+ * dither. Otherwise the dither would recirculate through a feedback delay
+ * at the bottom bit forever; this way a tail dies out and the line reads
+ * back silent. Float16 goes down to denormals before it reaches zero.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace SampleStorage
+{
+/** 32-bit float, the conversions are copies */
+struct Float32
+{
+    using Stored = float;
+
+    static float load(Stored s) { return s; }
+    static void load(const Stored* in, float* out, int n) { std::copy(in, in + n, out); }
+
+    Stored store(float x) { return x; }
+    void store(const float* in, Stored* out, int n) { std::copy(in, in + n, out); }
+};
+
+/** IEEE 754 half float, rounded to nearest even */
+struct Float16
+{
+    using Stored = uint16_t;
+
+    /** Largest finite half; stores clamp to it */
+    static constexpr float MAX = 65504.0f;
+
+    static float load(Stored h)
+    {
+        // Exponent and mantissa into place, rebias; a denormal half (zero
+        // exponent) is renormalised by letting the FPU subtract the
+        // implicit one back out
+        constexpr uint32_t REBIAS = (127 - 15) << 23;
+        constexpr float DENORMAL_MAGIC = std::bit_cast<float>(uint32_t{113} << 23);
+
+        const uint32_t magnitude = (static_cast<uint32_t>(h) & 0x7fffu) << 13;
+        const uint32_t normal = magnitude + REBIAS;
+        const float denormal = std::bit_cast<float>(normal + (1u << 23)) - DENORMAL_MAGIC;
+        const uint32_t bits = (magnitude & (0x1fu << 23)) != 0 ? normal : std::bit_cast<uint32_t>(denormal);
+        return std::bit_cast<float>(bits | ((static_cast<uint32_t>(h) & 0x8000u) << 16));
+    }
+
+    static void load(const Stored* in, float* out, int n)
+    {
+        int i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        for (; i + 4 <= n; i += 4)
+            vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+#endif
+        for (; i < n; ++i)
+            out[i] = load(in[i]);
+    }
+
+    Stored store(float x) { return toHalf(x); }
+
+    void store(const float* in, Stored* out, int n)
+    {
+        int i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), _mm256_set1_ps(-MAX)),
+                                           _mm256_set1_ps(MAX));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        for (; i + 4 <= n; i += 4)
+        {
+            const float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(in + i), vdupq_n_f32(-MAX)), vdupq_n_f32(MAX));
+            vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(x)));
+        }
+#endif
+        for (; i < n; ++i)
+            out[i] = toHalf(in[i]);
+    }
+
+private:
+    static Stored toHalf(float f)
+    {
+        // After F. Giesen's float_to_half_fast3_rtne, with the input
+        // clamped to the finite range so there's no infinity or NaN case
+        constexpr uint32_t DENORMAL_MAGIC_BITS = ((127 - 15) + (23 - 10) + 1) << 23;
+        constexpr float DENORMAL_MAGIC = std::bit_cast<float>(DENORMAL_MAGIC_BITS);
+
+        const uint32_t bits = std::bit_cast<uint32_t>(std::clamp(f, -MAX, MAX));
+        const uint32_t sign = (bits & 0x80000000u) >> 16;
+        const uint32_t magnitude = bits & 0x7fffffffu;
+
+        // Under the smallest normal half: let the FPU round the mantissa off
+        const uint32_t denormal = std::bit_cast<uint32_t>(std::bit_cast<float>(magnitude) + DENORMAL_MAGIC)
+                                  - DENORMAL_MAGIC_BITS;
+
+        // Normal: rebias, and round to nearest even by hand
+        const uint32_t odd = (magnitude >> 13) & 1u;
+        const uint32_t normal = (magnitude + (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + odd) >> 13;
+
+        return static_cast<Stored>((magnitude < (113u << 23) ? denormal : normal) | sign);
+    }
+};
+
+/** Triangular dither of +/-1 LSB: the sum of two uniform LCG draws */
+template <size_t N>
+constexpr std::array<float, N> makeDither()
+{
+    std::array<float, N> table{};
+    uint32_t state = 0x2545f491u;
+    const auto uniform = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    };
+    for (float& d : table)
+    {
+        const float a = uniform();
+        d = a + uniform() - 1.0f;
+    }
+    return table;
+}
+
+/** 16-bit integer, full scale +/-1, TPDF dithered */
+struct Int16
+{
+    using Stored = int16_t;
+
+    static constexpr float SCALE = 32767.0f;
+
+    static float load(Stored s) { return static_cast<float>(s) * (1.0f / SCALE); }
+
+    static void load(const Stored* in, float* out, int n)
+    {
+        for (int i = 0; i < n; ++i)
+            out[i] = static_cast<float>(in[i]) * (1.0f / SCALE);
+    }
+
+    Stored store(float x)
+    {
+        const float d = DITHER[phase];
+        phase = (phase + 1) & (DITHER_SIZE - 1);
+        return quantize(x, d);
+    }
+
+    /** Runs up to the dither table's end, so each inner loop is straight */
+    void store(const float* in, Stored* out, int n)
+    {
+        for (int i = 0; i < n;)
+        {
+            const int run = std::min(n - i, static_cast<int>(DITHER_SIZE - phase));
+            const float* const d = DITHER.data() + phase;
+            for (int k = 0; k < run; ++k)
+                out[i + k] = quantize(in[i + k], d[k]);
+            i += run;
+            phase = (phase + static_cast<size_t>(run)) & (DITHER_SIZE - 1);
+        }
+    }
+
+private:
+    static constexpr size_t DITHER_SIZE = 4096;
+
+    static Stored quantize(float x, float dither)
+    {
+        const float scaled = std::clamp(x * SCALE + dither, -SCALE, SCALE);
+        const float rounded = std::abs(x) * SCALE < 1.0f ? 0.0f : std::floor(scaled + 0.5f);
+        return static_cast<Stored>(static_cast<int32_t>(rounded));
+    }
+
+    static constexpr std::array<float, DITHER_SIZE> DITHER = makeDither<DITHER_SIZE>();
+
+    size_t phase = 0;
+};
+
+/** Floats of memory (Arena units) that @p samples take in @p Storage */
+template <typename Storage>
+constexpr size_t floatsFor(size_t samples)
+{
+    return (samples * sizeof(typename Storage::Stored) + sizeof(float) - 1) / sizeof(float);
+}
+
+} // namespace SampleStorage
@@ -0,0 +1,99 @@
+/**
+ * @file ScopeFifo.h
+ * @brief Lock-free audio -> UI sample FIFO for the oscilloscope
+ *
+ * processBlock() pushes every rendered sample; the editor's timer pulls the
+ * most recent window and ships it to the WebView. Single producer (audio
+ * thread), single consumer (message thread), no locks and no allocation.
+ *
+ * The editor attaches itself while its scope is on screen; the rest of
+ * the time processBlock() checks hasConsumer() and skips the push, so a
+ * closed, hidden or minimised editor costs the audio thread nothing. If
+ * something pushes anyway the FIFO fills up and new samples are dropped
+ * until the next pullLatest() discards the backlog.
+ *
+ *   // processBlock (audio thread)
+ *   if (scopeFifo.hasConsumer())
+ *       scopeFifo.push(left, numSamples);
+ *
+ * @note CAPACITY must be a power of two
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+
+class ScopeFifo
+{
+public:
+    /** Samples held - about 85 ms at 48 kHz, well over one UI frame */
+    static constexpr int CAPACITY = 4096;
+
+    /**
+     * @brief Append samples (audio thread)
+     * @return Number of samples written; the rest are dropped if full
+     */
+    int push(const float* data, int numSamples) noexcept
+    {
+        const int write = writePos.load(std::memory_order_relaxed);
+        const int read = readPos.load(std::memory_order_acquire);
+        const int space = CAPACITY - 1 - ((write - read) & MASK);
+        const int count = std::min(numSamples, space);
+
+        for (int i = 0; i < count; ++i)
+            buffer[static_cast<size_t>((write + i) & MASK)] = data[i];
+
+        writePos.store((write + count) & MASK, std::memory_order_release);
+        return count;
+    }
+
+    /** Samples waiting to be pulled (either thread, approximate) */
+    int getNumReady() const noexcept
+    {
+        return (writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_acquire)) & MASK;
+    }
+
+    /**
+     * @brief Take the newest samples (message thread)
+     * @param dest Receives up to maxSamples samples, oldest first
+     * @return Number of samples copied; older ones beyond maxSamples are discarded
+     */
+    int pullLatest(float* dest, int maxSamples) noexcept
+    {
+        const int write = writePos.load(std::memory_order_acquire);
+        int read = readPos.load(std::memory_order_relaxed);
+        const int ready = (write - read) & MASK;
+        const int count = std::min(ready, maxSamples);
+
+        read = (read + ready - count) & MASK;
+        for (int i = 0; i < count; ++i)
+            dest[i] = buffer[static_cast<size_t>((read + i) & MASK)];
+
+        readPos.store(write, std::memory_order_release);
+        return count;
+    }
+
+    /** Say whether anything is pulling (message thread) */
+    void setConsumerAttached(bool attached) noexcept { consumer.store(attached, std::memory_order_relaxed); }
+
+    /** True while something pulls, so push() is worth calling (either thread) */
+    bool hasConsumer() const noexcept { return consumer.load(std::memory_order_relaxed); }
+
+    /** Empty the FIFO - only while neither thread is using it (prepareToPlay) */
+    void reset() noexcept
+    {
+        writePos.store(0, std::memory_order_relaxed);
+        readPos.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static constexpr int MASK = CAPACITY - 1;
+
+    std::array<float, CAPACITY> buffer{};
+    std::atomic<int> writePos{0};
+    std::atomic<int> readPos{0};
+    std::atomic<bool> consumer{false};
+};
@@ -0,0 +1,116 @@
+/**
+ * @file SilenceGate.h
+ * @brief Silence detection and tail gating for voices and effects
+ *
+ * Delays, reverbs and compressors don't need to run once their input has
+ * been silent for longer than their tail: everything left in their state is
+ * below -120 dB. A TailGate per effect counts the silent samples since the
+ * last real input and says when the effect can be skipped; the effect wakes
+ * on the first non-silent block. Each effect supplies its own tail length
+ * (feedbackTail() / decayTail() below cover the usual shapes), and the
+ * count is checked against the current tail every block, so turning the
+ * feedback up during a tail keeps the effect running.
+ *
+ * A skipped effect leaves its buffer alone. The input was silent, so the
+ * output it would have written is silent too.
+ *
+ * Typical use, in a sub-block render:
+ *
+ *   bool silent = Silence::isSilent(left, right, n);
+ *   if (delayGate.process(silent, n, delay.getTailSamples()))
+ *   {
+ *       delay.processBlock(left, right, n);
+ *       silent = false;  // The next effect hears the delay's tail
+ *   }
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Silence
+{
+/** -120 dB: anything quieter counts as silence */
+inline constexpr float THRESHOLD = 1.0e-6f;
+
+/** A tail that never dies out (feedback at or above unity) */
+inline constexpr int64_t INFINITE_TAIL = std::numeric_limits<int64_t>::max();
+
+inline bool isSilent(const float* buffer, int numSamples)
+{
+    float peak = 0.0f;
+    for (int i = 0; i < numSamples; ++i)
+        peak = std::max(peak, std::abs(buffer[i]));
+    return peak < THRESHOLD;
+}
+
+inline bool isSilent(const float* left, const float* right, int numSamples)
+{
+    return isSilent(left, numSamples) && isSilent(right, numSamples);
+}
+
+/**
+ * @brief Samples for a feedback loop to fall below THRESHOLD
+ * @param loopSamples Length of one trip round the loop
+ * @param loopGain Gain per trip
+ *
+ * One trip for the dry pass, then as many as it takes loopGain^k to reach
+ * -120 dB.
+ */
+inline int64_t feedbackTail(double loopSamples, double loopGain)
+{
+    loopGain = std::fabs(loopGain);
+    if (loopGain >= 1.0)
+        return INFINITE_TAIL;
+
+    double trips = 1.0;
+    if (loopGain > 0.0)
+        trips += std::ceil(std::log(static_cast<double>(THRESHOLD)) / std::log(loopGain));
+
+    return static_cast<int64_t>(std::ceil(trips * loopSamples));
+}
+
+/** Samples for something multiplied by coef every sample (a one-pole) to fall below THRESHOLD */
+inline int64_t decayTail(double coef)
+{
+    return feedbackTail(1.0, coef);
+}
+} // namespace Silence
+
+/**
+ * @brief Per-effect bypass once the input has been silent for the whole tail
+ */
+class TailGate
+{
+public:
+    /**
+     * @brief Decide whether the effect runs this block
+     * @param inputSilent The effect's input is below Silence::THRESHOLD
+     * @param numSamples Block length
+     * @param tailSamples The effect's current tail length
+     * @return True if the effect has to process the block
+     */
+    bool process(bool inputSilent, int numSamples, int64_t tailSamples)
+    {
+        if (!inputSilent)
+        {
+            silentSamples = 0;
+            return true;
+        }
+
+        if (silentSamples >= tailSamples)
+            return false;
+
+        silentSamples += numSamples;
+        return true;
+    }
+
+    /** Asleep, for an effect whose state has just been cleared */
+    void reset() { silentSamples = Silence::INFINITE_TAIL; }
+
+private:
+    int64_t silentSamples = Silence::INFINITE_TAIL;
+};
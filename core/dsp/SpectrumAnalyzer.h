@@ -0,0 +1,257 @@
+/**
+ * @file SpectrumAnalyzer.h
+ * @brief Spectrum of the output for the editor, computed off the audio thread
+ *
+ * The audio thread only copies its output into a ScopeFifo of the
+ * analyzer's own, and only while the analyzer runs (the editor starts it
+ * while the spectrum is on screen). A background thread wakes at the
+ * frame rate, takes the newest samples, runs a Hann windowed FFT_SIZE
+ * point FFT over the last FFT_SIZE of them and reduces the bins to
+ * NUM_BANDS log-spaced bands from 20 Hz to 20 kHz, in dB relative to a
+ * full-scale sine. The editor's timer reads the newest
+ * frame through a StatePublisher:
+ *
+ *   // prepareToPlay
+ *   analyzer.prepare(sampleRate);
+ *
+ *   // processBlock (audio thread)
+ *   if (analyzer.isRunning())
+ *       analyzer.push(left, numSamples);
+ *
+ *   // Editor: spectrum shown / hidden or closed / timerCallback
+ *   processor.getSpectrumAnalyzer().start(30.0);
+ *   processor.getSpectrumAnalyzer().stop();
+ *   const auto& spectrum = processor.getSpectrumAnalyzer().read();
+ *
+ * Each band is the loudest bin in it; bands narrower than a bin (the
+ * lowest ones) read the magnitude interpolated at their centre. Peaks
+ * show at once and fall at FALL_DB_PER_SECOND, like a meter. Bands above
+ * Nyquist stay at FLOOR_DB.
+ *
+ * The thread runs at the platform's default priority, under the audio
+ * thread's real-time one (on macOS it's also marked utility QoS), and
+ * takes well under a millisecond a frame. analyze() is the same frame on
+ * the calling thread, for tests and offline tools.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#include "ScopeFifo.h"
+#include "SplitFFT.h"
+#include "StatePublisher.h"
+
+class SpectrumAnalyzer
+{
+public:
+    static constexpr int FFT_SIZE = 2048;
+    static constexpr int NUM_BANDS = 128;
+    static constexpr float MIN_HZ = 20.0f;
+    static constexpr float MAX_HZ = 20000.0f;
+    static constexpr float FLOOR_DB = -100.0f;
+    static constexpr float FALL_DB_PER_SECOND = 48.0f;
+
+    struct Spectrum
+    {
+        std::array<float, NUM_BANDS> db{};
+        uint32_t frame = 0;  // Counts analysed frames; unchanged means nothing new
+    };
+
+    SpectrumAnalyzer()
+    {
+        for (int i = 0; i < FFT_SIZE; ++i)
+            window[static_cast<size_t>(i)] =
+                static_cast<float>(0.5 - 0.5 * std::cos(2.0 * 3.141592653589793 * i / FFT_SIZE));
+        bands.fill(FLOOR_DB);
+    }
+
+    ~SpectrumAnalyzer() { stop(); }
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    /** Centre of band b in Hz; the same at every sample rate */
+    static float getBandHz(int band)
+    {
+        return MIN_HZ * std::pow(MAX_HZ / MIN_HZ, (static_cast<float>(band) + 0.5f) / NUM_BANDS);
+    }
+
+    /** Sample rate of what's pushed; any thread, takes effect at the next frame */
+    void prepare(double sampleRate) { rate.store(sampleRate, std::memory_order_relaxed); }
+
+    /** Copy the output in (audio thread) */
+    void push(const float* data, int numSamples) noexcept { input.push(data, numSamples); }
+
+    /** Analyse framesPerSecond times a second on a background thread until stop() */
+    void start(double framesPerSecond = 30.0)
+    {
+        if (running.exchange(true))
+            return;
+
+        stopping = false;
+        const auto period = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::duration<double>(1.0 / std::max(1.0, framesPerSecond)));
+        fallPerFrame = FALL_DB_PER_SECOND * static_cast<float>(std::chrono::duration<double>(period).count());
+
+        worker = std::thread([this, period] {
+#if defined(__APPLE__)
+            pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#endif
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping)
+            {
+                wake.wait_for(lock, period, [this] { return stopping; });
+                if (!stopping)
+                    analyze();
+            }
+        });
+    }
+
+    /** Join the thread; safe to call twice */
+    void stop()
+    {
+        if (!running.exchange(false))
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    /** The newest frame (message thread) */
+    const Spectrum& read() noexcept { return published.read(); }
+
+    /**
+     * @brief One frame: take what's been pushed, analyse, publish
+     *
+     * The analysis thread's job; call it directly only while that isn't
+     * running. Does nothing if nothing new was pushed.
+     */
+    void analyze()
+    {
+        const int fresh = input.pullLatest(incoming.data(), FFT_SIZE);
+        if (fresh == 0)
+            return;
+
+        // Slide the history along and append
+        std::copy(history.begin() + fresh, history.end(), history.begin());
+        std::copy(incoming.begin(), incoming.begin() + fresh, history.end() - fresh);
+
+        const double sampleRate = rate.load(std::memory_order_relaxed);
+        if (sampleRate != tableRate)
+            buildBandTable(sampleRate);
+
+        alignas(16) std::array<float, FFT_SIZE> re;
+        alignas(16) std::array<float, FFT_SIZE> im{};
+        for (size_t i = 0; i < re.size(); ++i)
+            re[i] = history[i] * window[i];
+        fft.forward(re.data(), im.data());
+
+        // A full-scale sine peaks at FFT_SIZE / 4 through the Hann window
+        constexpr float SCALE = 4.0f / FFT_SIZE;
+        for (int k = 0; k <= FFT_SIZE / 2; ++k)
+        {
+            const auto i = static_cast<size_t>(k);
+            magnitude[i] = SCALE * std::sqrt(re[i] * re[i] + im[i] * im[i]);
+        }
+
+        auto& out = published.write();
+        for (size_t b = 0; b < bands.size(); ++b)
+        {
+            const BandBins& bins = bandBins[b];
+            float level = 0.0f;
+            if (bins.interpolate)
+            {
+                const auto k = static_cast<size_t>(bins.first);
+                level = magnitude[k] + bins.fraction * (magnitude[k + 1] - magnitude[k]);
+            }
+            else  // No bins above Nyquist
+                for (int k = bins.first; k <= bins.last; ++k)
+                    level = std::max(level, magnitude[static_cast<size_t>(k)]);
+
+            const float db = level > 0.0f ? std::max(FLOOR_DB, 20.0f * std::log10(level)) : FLOOR_DB;
+            bands[b] = std::max(db, std::max(FLOOR_DB, bands[b] - fallPerFrame));
+            out.db[b] = bands[b];
+        }
+        out.frame = ++frames;
+        published.publish();
+    }
+
+private:
+    /** Bins [first, last] of one band, or the pair from first to interpolate between */
+    struct BandBins
+    {
+        int first = 0;
+        int last = -1;
+        float fraction = 0.0f;
+        bool interpolate = false;
+    };
+
+    void buildBandTable(double sampleRate)
+    {
+        tableRate = sampleRate;
+        const double binHz = sampleRate / FFT_SIZE;
+        const double nyquist = 0.5 * sampleRate;
+        for (int b = 0; b < NUM_BANDS; ++b)
+        {
+            const double low = MIN_HZ * std::pow(MAX_HZ / MIN_HZ, static_cast<double>(b) / NUM_BANDS);
+            const double high = MIN_HZ * std::pow(MAX_HZ / MIN_HZ, static_cast<double>(b + 1) / NUM_BANDS);
+            BandBins& bins = bandBins[static_cast<size_t>(b)];
+            if (low >= nyquist)
+            {
+                bins = {};
+                continue;
+            }
+
+            bins.first = static_cast<int>(std::ceil(low / binHz));
+            bins.last = std::min(static_cast<int>(std::floor(high / binHz)), FFT_SIZE / 2);
+            bins.interpolate = bins.last < bins.first;
+            if (bins.interpolate)
+            {
+                const double centre = getBandHz(b) / binHz;
+                bins.first = std::min(static_cast<int>(centre), FFT_SIZE / 2 - 1);
+                bins.fraction = static_cast<float>(centre - bins.first);
+            }
+        }
+    }
+
+    ScopeFifo input;
+    std::atomic<double> rate{44100.0};
+    StatePublisher<Spectrum> published;
+
+    // Analysis thread only
+    SplitFFT<FFT_SIZE> fft;
+    std::array<float, FFT_SIZE> window{};
+    std::array<float, FFT_SIZE> history{};
+    std::array<float, FFT_SIZE> incoming{};
+    std::array<float, FFT_SIZE / 2 + 1> magnitude{};
+    std::array<BandBins, NUM_BANDS> bandBins{};
+    std::array<float, NUM_BANDS> bands{};
+    double tableRate = 0.0;
+    float fallPerFrame = FALL_DB_PER_SECOND / 30.0f;
+    uint32_t frames = 0;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<bool> running{false};
+};
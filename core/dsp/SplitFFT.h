@@ -0,0 +1,123 @@
+/**
+ * @file SplitFFT.h
+ * @brief In-place radix-2 complex FFT over split real / imaginary arrays
+ *
+ * Shared by the convolver and the spectrum analyzer. Every butterfly stage
+ * past the second is a plain loop over contiguous floats, which the
+ * compiler turns into SSE / NEON / WASM SIMD.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief Complex FFT of a fixed power-of-two size over split real / imaginary arrays
+ *
+ * Unscaled both ways. The inverse is the forward transform with the real
+ * and imaginary parts swapped.
+ */
+template <int N>
+class SplitFFT
+{
+public:
+    static_assert(N >= 8 && (N & (N - 1)) == 0, "SplitFFT needs a power of two");
+
+    SplitFFT()
+    {
+        int pairs = 0;
+        for (int i = 1, j = 0; i < N; ++i)
+        {
+            int bit = N >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+            {
+                swaps[static_cast<size_t>(pairs)][0] = static_cast<uint16_t>(i);
+                swaps[static_cast<size_t>(pairs)][1] = static_cast<uint16_t>(j);
+                ++pairs;
+            }
+        }
+        swapCount = pairs;
+
+        // Each stage's twiddles in a run of their own, so a stage reads them contiguously
+        for (int half = 1; half < N; half <<= 1)
+            for (int k = 0; k < half; ++k)
+            {
+                const double angle = -3.141592653589793 * k / half;
+                twiddleRe[static_cast<size_t>(half - 1 + k)] = static_cast<float>(std::cos(angle));
+                twiddleIm[static_cast<size_t>(half - 1 + k)] = static_cast<float>(std::sin(angle));
+            }
+    }
+
+    void forward(float* re, float* im) const
+    {
+        for (int s = 0; s < swapCount; ++s)
+        {
+            const int a = swaps[static_cast<size_t>(s)][0];
+            const int b = swaps[static_cast<size_t>(s)][1];
+            std::swap(re[a], re[b]);
+            std::swap(im[a], im[b]);
+        }
+
+        // The first two stages' twiddles are 1 and -i: no multiplies
+        for (int i = 0; i < N; i += 2)
+        {
+            const float ar = re[i], ai = im[i];
+            const float br = re[i + 1], bi = im[i + 1];
+            re[i] = ar + br;
+            im[i] = ai + bi;
+            re[i + 1] = ar - br;
+            im[i + 1] = ai - bi;
+        }
+        for (int i = 0; i < N; i += 4)
+        {
+            const float ar = re[i], ai = im[i];
+            const float br = re[i + 2], bi = im[i + 2];
+            const float cr = re[i + 1], ci = im[i + 1];
+            const float dr = im[i + 3], di = -re[i + 3];  // times -i
+            re[i] = ar + br;
+            im[i] = ai + bi;
+            re[i + 2] = ar - br;
+            im[i + 2] = ai - bi;
+            re[i + 1] = cr + dr;
+            im[i + 1] = ci + di;
+            re[i + 3] = cr - dr;
+            im[i + 3] = ci - di;
+        }
+
+        for (int half = 4; half < N; half <<= 1)
+        {
+            const float* const wr = twiddleRe.data() + half - 1;
+            const float* const wi = twiddleIm.data() + half - 1;
+            for (int start = 0; start < N; start += 2 * half)
+            {
+                float* const ar = re + start;
+                float* const ai = im + start;
+                float* const br = ar + half;
+                float* const bi = ai + half;
+                for (int k = 0; k < half; ++k)
+                {
+                    const float tr = br[k] * wr[k] - bi[k] * wi[k];
+                    const float ti = br[k] * wi[k] + bi[k] * wr[k];
+                    br[k] = ar[k] - tr;
+                    bi[k] = ai[k] - ti;
+                    ar[k] += tr;
+                    ai[k] += ti;
+                }
+            }
+        }
+    }
+
+    void inverse(float* re, float* im) const { forward(im, re); }
+
+private:
+    std::array<std::array<uint16_t, 2>, N / 2> swaps{};
+    int swapCount = 0;
+    std::array<float, N> twiddleRe{};
+    std::array<float, N> twiddleIm{};
+};
@@ -0,0 +1,78 @@
+/**
+ * @file StatePublisher.h
+ * @brief Triple-buffered engine state for the editor: one writer, one reader, no locks
+ *
+ * Editors used to call engine getters (sequencer step, voice counts) from
+ * their timer while the audio thread was changing the same members, so a
+ * read could mix two blocks. Instead the audio thread fills a snapshot
+ * once per block and publishes it; the editor's timer reads the newest one
+ * whole:
+ *
+ *   // processBlock (audio thread)
+ *   auto& s = sequencerState.write();
+ *   s = engine.getSequencerState();
+ *   sequencerState.publish();
+ *
+ *   // timerCallback (message thread)
+ *   const auto& s = sequencerState.read();
+ *
+ * Three slots: the writer's, the reader's and the newest published one in
+ * between, which publish() and read() swap theirs with (one atomic
+ * exchange each). Neither side ever waits, and the reader sees each
+ * snapshot whole. If nothing was published since the last read(), read()
+ * returns the same snapshot again.
+ *
+ * It works the other way round too: the message thread stages a whole
+ * preset and publishes it, and the audio thread takes it with readFresh(),
+ * which returns nullptr until something new is published. The pointer
+ * stays valid until the reader's next read() or readFresh().
+ *
+ * write() hands back whatever that slot held two publishes ago: fill every
+ * field. State must be trivially copyable-ish; it's copied by the caller,
+ * never allocated here.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+template <typename State>
+class StatePublisher
+{
+public:
+    /** The slot to fill before publish() (writer) */
+    State& write() noexcept { return slots[static_cast<size_t>(writeIndex)]; }
+
+    /** Make the filled slot the newest (writer) */
+    void publish() noexcept
+    {
+        writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /** The newest published state (reader) */
+    const State& read() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) != 0)
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX;
+        return slots[static_cast<size_t>(readIndex)];
+    }
+
+    /** The state published since the last read, or nullptr if there's none (reader) */
+    const State* readFresh() noexcept
+    {
+        if ((middle.load(std::memory_order_acquire) & FRESH) == 0)
+            return nullptr;
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX;
+        return &slots[static_cast<size_t>(readIndex)];
+    }
+
+private:
+    static constexpr int INDEX = 3;
+    static constexpr int FRESH = 4;  // Set in middle while the reader hasn't taken it
+
+    std::array<State, 3> slots{};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle{2};
+};
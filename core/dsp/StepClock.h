@@ -0,0 +1,117 @@
+/**
+ * @file StepClock.h
+ * @brief Sample-accurate step clock that finds the next boundary ahead
+ *
+ * Sequencers advance on step boundaries a whole number of samples apart
+ * on average (samplesPerStep may be fractional; the remainder carries
+ * over). Rather than counting every sample to find the boundary, the
+ * engine asks how long the next run is, applies any step change once at
+ * the start of it, and renders the run as a plain block:
+ *
+ *   for (int i = 0; i < numSamples;)
+ *   {
+ *       bool stepped = false;
+ *       const int n = clock.next(std::min(numSamples - i, ControlRamp::BLOCK_SIZE), stepped);
+ *       if (stepped)
+ *           advanceSequencer();  // New pitch/gate from this run's first sample
+ *       voice.render(outL + i, outR + i, n);
+ *       i += n;
+ *   }
+ *
+ * A boundary only ever falls on the first sample of a run. Several clocks
+ * can share runs by taking the shortest nextRunLength() and advancing each
+ * by that.
+ *
+ * Timing matches the per-sample counter it replaces: each sample adds one,
+ * and the sample that takes the count to samplesPerStep is a step.
+ *
+ * Following a host, syncTo() at the top of each block replaces the carried
+ * remainder with the host's position, so the clock can't drift from the
+ * host's timeline; the runs inside the block are found ahead as before.
+ *
+ * Steps needn't all be the same length: setNextStep() queues the length
+ * of the step after the current one, which a run starting on the boundary
+ * needs to know how far it can go. Call it again after each step.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+class StepClock
+{
+public:
+    /** Step length in samples (at least 1). The current step keeps its elapsed samples */
+    void setSamplesPerStep(double samples) { samplesPerStep = nextStep = std::max(1.0, samples); }
+    double getSamplesPerStep() const { return samplesPerStep; }
+
+    /** Length of the step after the current one (at least 1), when they vary */
+    void setNextStep(double samples) { nextStep = std::max(1.0, samples); }
+
+    /** Start a fresh step: the first boundary is samplesPerStep samples away */
+    void reset() { elapsed = 0.0; }
+
+    /** True if the next sample (the next run's first) is a step boundary */
+    bool isStepNext() const { return elapsed + 1.0 >= samplesPerStep; }
+
+    /** Longest run from here with no step boundary after its first sample */
+    int nextRunLength() const
+    {
+        double afterFirst = elapsed + 1.0;
+        if (afterFirst >= samplesPerStep)
+            return std::max(1, static_cast<int>(std::ceil(nextStep - (afterFirst - samplesPerStep))));
+        return std::max(1, static_cast<int>(std::ceil(samplesPerStep - afterFirst)));
+    }
+
+    /**
+     * @brief Move numSamples forward (at most nextRunLength())
+     * @return True if the run's first sample is a step boundary
+     */
+    bool advance(int numSamples)
+    {
+        elapsed += 1.0;
+        const bool stepped = elapsed >= samplesPerStep;
+        if (stepped)
+        {
+            elapsed -= samplesPerStep;
+            samplesPerStep = nextStep;
+        }
+        elapsed += static_cast<double>(numSamples - 1);
+        return stepped;
+    }
+
+    /**
+     * @brief Line the next boundary up with a host position
+     * @param steps Host position in steps (beats x steps per beat) at the next sample
+     * @return The step number that boundary starts (a sequencer's next step)
+     *
+     * A boundary within a thousandth of a sample after a sample counts as
+     * on it, since hosts' beat positions are rarely exact.
+     */
+    int64_t syncTo(double steps)
+    {
+        const double nextStep = std::ceil(steps - 0.001 / samplesPerStep);
+        const double untilStep = std::max(0.0, (nextStep - steps) * samplesPerStep - 0.001);
+        elapsed = samplesPerStep - 1.0 - untilStep;
+        return static_cast<int64_t>(nextStep);
+    }
+
+    /**
+     * @brief Take the next run of up to maxSamples samples
+     * @param stepped Set to whether the run starts on a step boundary
+     * @return Run length (1 to maxSamples)
+     */
+    int next(int maxSamples, bool& stepped)
+    {
+        const int n = std::min(maxSamples, nextRunLength());
+        stepped = advance(n);
+        return n;
+    }
+
+private:
+    double samplesPerStep = 1000.0;
+    double nextStep = 1000.0;  // The step after the current one
+    double elapsed = 0.0;      // Samples into the current step
+};
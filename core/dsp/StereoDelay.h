@@ -0,0 +1,341 @@
+/**
+ * @file StereoDelay.h
+ * @brief Power-of-two delay lines and the feedback delay DFAM and TapeLoop share
+ *
+ * DelayLine is the primitive: a ring of power-of-two capacity, so a
+ * position wraps with a mask rather than a modulo or a branch, and reads
+ * at fractional delays with linear interpolation. It runs over memory its
+ * owner supplies. readBlock() and writeBlock() move a run of samples at a
+ * time. A read doesn't see the samples written after it, so a run can be
+ * no longer than the delay. BasicDelayLine<Storage> keeps its samples in
+ * one of SampleStorage.h's formats and converts a run at each end;
+ * DelayLine is the float one.
+ *
+ * StereoDelay is the feedback delay built from two of them: up to
+ * MAX_SECONDS, set in seconds or synced to the tempo. Its lines come
+ * either from a vector it owns (prepare(sr), grown only, like the other
+ * effects) or from an Arena (prepare(sr, arena), for builds that size
+ * their memory up front; memoryNeeded() says how much). Its Storage
+ * parameter is its lines'; BasicStereoDelay<SampleStorage::Float16> takes
+ * half the memory.
+ *
+ * processBlock() works in runs up to the delay's length: read the run's
+ * taps, then write the run back with feedback. So the inner loops are
+ * straight-line and need no wrap checks, and a block renders the same as
+ * sample by sample.
+ *
+ *   StereoDelay delay;
+ *   delay.prepare(sr);
+ *   delay.setClockSyncTime(bpm, 2.0f);  // An eighth note
+ *   delay.processBlock(left, right, n);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Arena.h"
+#include "Denormals.h"
+#include "MemoryReport.h"
+#include "SampleStorage.h"
+#include "SilenceGate.h"
+
+/**
+ * @brief One channel of delay over a power-of-two ring
+ */
+template <typename Storage = SampleStorage::Float32>
+class BasicDelayLine
+{
+public:
+    using Stored = typename Storage::Stored;
+
+    /** Capacity (a power of two) that holds @p maxDelay samples of delay, interpolated */
+    static constexpr size_t capacityFor(size_t maxDelay)
+    {
+        size_t capacity = 1;
+        while (capacity < maxDelay + 2)
+            capacity <<= 1;
+        return capacity;
+    }
+
+    /**
+     * @brief Run over @p capacity samples at @p memory, from the start
+     *
+     * @p capacity must be a power of two (capacityFor()). The memory is used
+     * as it is: the owner hands it over cleared.
+     */
+    void attach(Stored* memory, size_t capacity)
+    {
+        buffer = memory;
+        mask = capacity - 1;
+        writePos = 0;
+    }
+
+    size_t getCapacity() const { return mask + 1; }
+
+    /** The sample @p delay samples before the next write (1 to capacity - 2) */
+    float read(float delay) const
+    {
+        const size_t whole = static_cast<size_t>(delay);
+        const float frac = delay - static_cast<float>(whole);
+        const float newer = Storage::load(buffer[(writePos - whole) & mask]);
+        const float older = Storage::load(buffer[(writePos - whole - 1) & mask]);
+        return newer + (older - newer) * frac;
+    }
+
+    void write(float x)
+    {
+        buffer[writePos] = format.store(x);
+        writePos = (writePos + 1) & mask;
+    }
+
+    /**
+     * @brief read() for the next @p n writes, as they'll be made
+     *
+     * @p n is at most the whole delay, so every tap is already written.
+     * The taps are read in straight runs between the ring's wraps; a
+     * compact line converts each run, and the sample before it, first.
+     */
+    void readBlock(float* out, int n, float delay) const
+    {
+        const size_t whole = static_cast<size_t>(delay);
+        const float frac = delay - static_cast<float>(whole);
+        size_t pos = (writePos - whole) & mask;
+        for (int i = 0; i < n;)
+        {
+            // The older tap of position 0 is the ring's last sample
+            if (pos == 0)
+            {
+                const float first = Storage::load(buffer[0]);
+                out[i++] = first + (Storage::load(buffer[mask]) - first) * frac;
+                pos = 1;
+                continue;
+            }
+
+            int run = static_cast<int>(std::min(static_cast<size_t>(n - i), mask + 1 - pos));
+            const float* newer;
+            float converted[CONVERT_RUN + 1];
+            if constexpr (IS_FLOAT)
+            {
+                newer = buffer + pos;
+            }
+            else
+            {
+                run = std::min(run, CONVERT_RUN);
+                Storage::load(buffer + pos - 1, converted, run + 1);
+                newer = converted + 1;
+            }
+
+            float* const o = out + i;
+            if (frac == 0.0f)
+                std::copy(newer, newer + run, o);
+            else
+                for (int k = 0; k < run; ++k)
+                    o[k] = newer[k] + (newer[k - 1] - newer[k]) * frac;
+            i += run;
+            pos = (pos + static_cast<size_t>(run)) & mask;
+        }
+    }
+
+    /** write() each of @p in[0..n), in straight runs between the ring's wraps */
+    void writeBlock(const float* in, int n)
+    {
+        for (int i = 0; i < n;)
+        {
+            const int run = static_cast<int>(std::min(static_cast<size_t>(n - i), mask + 1 - writePos));
+            format.store(in + i, buffer + writePos, run);
+            i += run;
+            writePos = (writePos + static_cast<size_t>(run)) & mask;
+        }
+    }
+
+private:
+    static constexpr bool IS_FLOAT = std::is_same_v<Stored, float>;
+
+    // Longest run a compact line converts at once
+    static constexpr int CONVERT_RUN = IS_FLOAT ? 0 : 128;
+
+    Stored* buffer = nullptr;
+    size_t mask = 0;
+    size_t writePos = 0;
+    [[no_unique_address]] Storage format;  // Int16's dither position
+};
+
+using DelayLine = BasicDelayLine<>;
+
+/**
+ * @brief Stereo feedback delay with tempo sync
+ */
+template <typename Storage = SampleStorage::Float32>
+class BasicStereoDelay
+{
+public:
+    using Line = BasicDelayLine<Storage>;
+    using Stored = typename Storage::Stored;
+
+    static constexpr double MAX_SECONDS = 4.0;
+
+    /** Samples per channel at @p sr */
+    static constexpr size_t capacityFor(double sr)
+    {
+        return Line::capacityFor(static_cast<size_t>(sr * MAX_SECONDS));
+    }
+
+    /** Floats prepare(sr, arena) takes */
+    static constexpr size_t memoryNeeded(double sr)
+    {
+        return 2 * Arena::aligned(SampleStorage::floatsFor<Storage>(capacityFor(sr)));
+    }
+
+    /** Lines from the delay's own storage: only grown, a lower rate reuses it */
+    void prepare(double sr)
+    {
+        const size_t capacity = capacityFor(sr);
+        if (storage.size() < 2 * capacity)
+            storage.assign(2 * capacity, Stored{});
+        else
+            std::fill_n(storage.begin(), 2 * capacity, Stored{});
+        lineL.attach(storage.data(), capacity);
+        lineR.attach(storage.data() + capacity, capacity);
+        setRate(sr);
+    }
+
+    /** Lines from @p arena; false if it's short */
+    bool prepare(double sr, Arena& arena)
+    {
+        const size_t capacity = capacityFor(sr);
+        Stored* const memoryL = arena.takeSamples<Stored>(capacity);
+        Stored* const memoryR = arena.takeSamples<Stored>(capacity);
+        if (!memoryL || !memoryR)
+            return false;
+        lineL.attach(memoryL, capacity);
+        lineR.attach(memoryR, capacity);
+        setRate(sr);
+        return true;
+    }
+
+    void setTime(float seconds)
+    {
+        delayTime = std::clamp(seconds, 0.001f, static_cast<float>(MAX_SECONDS));
+        useClockSync = false;
+        updateDelaySamples();
+    }
+
+    /**
+     * @brief Set delay time synced to tempo via clock divider
+     * @param bpm Current tempo in BPM
+     * @param divider Clock divider (1/64 to 64x)
+     *
+     * At divider=1, delay = one beat (quarter note)
+     * At divider=0.5, delay = two beats (half note)
+     * At divider=4, delay = a quarter beat (16th note)
+     *
+     * The delay follows the rate: prepare() at another rate keeps it on
+     * the beat.
+     */
+    void setClockSyncTime(float bpm, float divider)
+    {
+        tempo = std::clamp(bpm, 20.0f, 300.0f);
+        clockDivider = std::clamp(divider, 0.015625f, 64.0f);
+        useClockSync = true;
+        updateDelaySamples();
+    }
+
+    void setFeedback(float fb) { feedback = std::clamp(fb, 0.0f, 0.95f); }
+    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
+
+    /** Delay in samples, fractional */
+    float getDelaySamples() const { return delaySamples; }
+
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
+
+    /** Delay a block in place */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        const float fb = feedback;
+        const float wetMix = mix;
+        const float dryMix = 1.0f - mix;
+        const int maxRun = std::min(RUN, static_cast<int>(delaySamples));
+
+        float delayedL[RUN];
+        float delayedR[RUN];
+        float recordL[RUN];
+        float recordR[RUN];
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int run = std::min(numSamples - start, maxRun);
+            float* const l = left + start;
+            float* const r = right + start;
+
+            lineL.readBlock(delayedL, run, delaySamples);
+            lineR.readBlock(delayedR, run, delaySamples);
+
+            for (int i = 0; i < run; ++i)
+            {
+                recordL[i] = l[i] + delayedL[i] * fb + Denormals::BIAS;
+                recordR[i] = r[i] + delayedR[i] * fb + Denormals::BIAS;
+
+                l[i] = l[i] * dryMix + delayedL[i] * wetMix;
+                r[i] = r[i] * dryMix + delayedR[i] * wetMix;
+            }
+
+            lineL.writeBlock(recordL, run);
+            lineR.writeBlock(recordR, run);
+            start += run;
+        }
+    }
+
+    /** Samples until the repeats fall below -120 dB (see SilenceGate.h) */
+    int64_t getTailSamples() const
+    {
+        return Silence::feedbackTail(static_cast<double>(delaySamples), feedback);
+    }
+
+    /** Bytes of delay line allocated by prepare(sr); none from an arena */
+    size_t getHeapBytes() const { return MemoryReport::bytesOf(storage); }
+
+private:
+    // Longest run processBlock() reads ahead
+    static constexpr int RUN = 128;
+
+    void setRate(double sr)
+    {
+        sampleRate = sr;
+        updateDelaySamples();
+    }
+
+    void updateDelaySamples()
+    {
+        float seconds = delayTime;
+        if (useClockSync)
+        {
+            // Sync to tempo: one beat / divider
+            const float secondsPerBeat = 60.0f / tempo;
+            seconds = std::clamp(secondsPerBeat / clockDivider, 0.001f, static_cast<float>(MAX_SECONDS));
+        }
+
+        // A line always has room for MAX_SECONDS; before prepare() there's no line
+        const float longest = static_cast<float>(lineL.getCapacity()) - 2.0f;
+        delaySamples = std::clamp(seconds * static_cast<float>(sampleRate), 1.0f, std::max(longest, 1.0f));
+    }
+
+    double sampleRate = 44100.0;
+    std::vector<Stored> storage;
+    Line lineL;
+    Line lineR;
+    float delaySamples = 22050.0f;
+    float delayTime = 0.5f;
+    float tempo = 120.0f;
+    float clockDivider = 1.0f;
+    bool useClockSync = false;
+    float feedback = 0.3f;
+    float mix = 0.0f;
+};
+
+using StereoDelay = BasicStereoDelay<>;
@@ -0,0 +1,168 @@
+/**
+ * @file TraceDumper.h
+ * @brief Drain TraceRings on a background thread into a Chrome trace file
+ *
+ * The file is Chrome's JSON trace event format, which chrome://tracing
+ * and ui.perfetto.dev both open. Each ring becomes one named track:
+ *
+ *   TraceDumper dumper("/tmp/TapeLoop-trace.json", "TapeLoop");
+ *   dumper.addRing(engine.getTrace(), "audio");
+ *   dumper.start();      // Drains every 50 ms
+ *   ...
+ *   dumper.stop();       // Last drain, closes the file
+ *
+ * Rings are added before start() and must outlive stop(). Only useful in
+ * SYNTH_TRACE builds; otherwise the rings never have anything to drain.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "TraceRing.h"
+
+class TraceDumper
+{
+public:
+    TraceDumper(const std::string& path, std::string processName)
+        : out(path), process(std::move(processName))
+    {
+    }
+
+    ~TraceDumper() { stop(); }
+
+    TraceDumper(const TraceDumper&) = delete;
+    TraceDumper& operator=(const TraceDumper&) = delete;
+
+    /** False if the file couldn't be opened */
+    bool isOpen() const { return out.is_open(); }
+
+    /** Trace ring to drain, shown as a track called threadName (before start()) */
+    void addRing(TraceRing& ring, std::string threadName)
+    {
+        rings.push_back({&ring, std::move(threadName)});
+    }
+
+    void start(std::chrono::milliseconds period = std::chrono::milliseconds(50))
+    {
+        if (!out.is_open() || running.exchange(true))
+            return;
+
+        out << "{\"traceEvents\":[\n";
+        writeMetadata("process_name", 0, process);
+        for (size_t i = 0; i < rings.size(); ++i)
+            writeMetadata("thread_name", static_cast<int>(i + 1), rings[i].name);
+        origin = TraceRing::nowNs();
+
+        worker = std::thread([this, period] {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping)
+            {
+                wake.wait_for(lock, period, [this] { return stopping; });
+                drainAll();
+            }
+        });
+    }
+
+    /** Drain what's left and close the file; safe to call twice */
+    void stop()
+    {
+        if (!running.exchange(false))
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+
+        for (size_t i = 0; i < rings.size(); ++i)
+            writeCounter("dropped", static_cast<int>(i + 1), rings[i].ring->getDropped());
+        out << "\n]}\n";
+        out.close();
+    }
+
+    /** One event as a Chrome trace JSON object, with times relative to originNs */
+    static std::string formatEvent(const TraceRing::Event& e, int tid, uint64_t originNs)
+    {
+        char line[256];
+        const double ts = static_cast<double>(e.startNs - originNs) * 1.0e-3;
+        if (e.instant)
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                          e.name, e.category, ts, tid);
+        else
+            std::snprintf(line, sizeof(line),
+                          "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+                          e.name, e.category, ts, static_cast<double>(e.durationNs) * 1.0e-3, tid);
+
+        std::string json(line);
+        if (e.arg >= 0)
+            json += ",\"args\":{\"value\":" + std::to_string(e.arg) + "}";
+        return json + "}";
+    }
+
+private:
+    struct Source
+    {
+        TraceRing* ring;
+        std::string name;
+    };
+
+    void drainAll()
+    {
+        for (size_t i = 0; i < rings.size(); ++i)
+        {
+            const int tid = static_cast<int>(i + 1);
+            rings[i].ring->drain([this, tid](const TraceRing::Event& e) {
+                // Events from before start() would have negative times
+                if (e.startNs >= origin)
+                    write(formatEvent(e, tid, origin));
+            });
+        }
+        out.flush();
+    }
+
+    /** One element of the traceEvents array */
+    void write(const std::string& json)
+    {
+        out << (first ? "" : ",\n") << json;
+        first = false;
+    }
+
+    void writeMetadata(const char* kind, int tid, const std::string& name)
+    {
+        write("{\"name\":\"" + std::string(kind) + "\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(tid)
+              + ",\"args\":{\"name\":\"" + name + "\"}}");
+    }
+
+    void writeCounter(const char* name, int tid, uint64_t value)
+    {
+        char ts[32];
+        std::snprintf(ts, sizeof(ts), "%.3f", static_cast<double>(TraceRing::nowNs() - origin) * 1.0e-3);
+        write("{\"name\":\"" + std::string(name) + "\",\"ph\":\"C\",\"ts\":" + ts + ",\"pid\":1,\"tid\":"
+              + std::to_string(tid) + ",\"args\":{\"events\":" + std::to_string(value) + "}}");
+    }
+
+    std::ofstream out;
+    std::string process;
+    std::vector<Source> rings;
+    uint64_t origin = 0;
+    bool first = true;  // No comma before the first event
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;  // Under mutex
+    std::atomic<bool> running{false};
+};
@@ -0,0 +1,158 @@
+/**
+ * @file TraceRing.h
+ * @brief Optional timeline of engine events, for Chrome / Perfetto traces
+ *
+ * Off unless the build defines SYNTH_TRACE=1 (cmake -DSYNTH_TRACE=ON). When
+ * off, Scope is an empty object and every member an empty inline, like
+ * PerfStats, so engines can call it unconditionally at no cost.
+ *
+ * PerfStats says how much time each stage takes on average; a trace says
+ * when. The engine (audio thread) wraps what it wants on the timeline in
+ * a Scope, or marks a moment with instant():
+ *
+ *   TraceRing::Scope scope(trace, "effects", "reverb");
+ *   trace.instant("sequencer", "step", currentStep);
+ *
+ * Events go into a fixed ring with a single reader: TraceDumper.h drains
+ * it on a background thread into a Chrome trace JSON file. Nothing
+ * allocates or locks on the audio thread; if the reader falls behind,
+ * new events are dropped and counted (getDropped()), old ones are kept.
+ *
+ * Names and categories must be string literals: only the pointer is
+ * stored.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef SYNTH_TRACE
+#define SYNTH_TRACE 0
+#endif
+
+#if SYNTH_TRACE && defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#endif
+
+class TraceRing
+{
+public:
+    static constexpr bool ENABLED = SYNTH_TRACE != 0;
+
+    /** Events held between drains (a power of two) */
+    static constexpr size_t CAPACITY = 8192;
+
+    struct Event
+    {
+        const char* category = "";
+        const char* name = "";
+        uint64_t startNs = 0;
+        uint64_t durationNs = 0;  // 0 for an instant
+        int32_t arg = -1;         // Step, note, sample count...; -1 for none
+        bool instant = false;
+    };
+
+    /** Records one complete event from construction to destruction (audio thread) */
+    class Scope
+    {
+    public:
+        Scope(TraceRing& r, const char* category, const char* name, int arg = -1) noexcept
+#if SYNTH_TRACE
+            : ring(r), event{category, name, nowNs(), 0, arg, false}
+#endif
+        {
+            (void)r;
+            (void)category;
+            (void)name;
+            (void)arg;
+        }
+
+        ~Scope()
+        {
+#if SYNTH_TRACE
+            event.durationNs = nowNs() - event.startNs;
+            ring.push(event);
+#endif
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+#if SYNTH_TRACE
+    private:
+        TraceRing& ring;
+        Event event;
+#endif
+    };
+
+    /** Mark a moment (audio thread) */
+    void instant(const char* category, const char* name, int arg = -1) noexcept
+    {
+        if constexpr (ENABLED)
+            push({category, name, nowNs(), 0, arg, true});
+        else
+        {
+            (void)category;
+            (void)name;
+            (void)arg;
+        }
+    }
+
+    /**
+     * @brief Hand every waiting event to fn, oldest first (the one reader thread)
+     * @return How many there were
+     */
+    template <typename Fn>
+    size_t drain(Fn&& fn)
+    {
+        size_t count = 0;
+        if constexpr (ENABLED)
+        {
+            const uint64_t end = writeIndex.load(std::memory_order_acquire);
+            uint64_t read = readIndex.load(std::memory_order_relaxed);
+            for (; read != end; ++read, ++count)
+                fn(static_cast<const Event&>(events[read & (CAPACITY - 1)]));
+            readIndex.store(read, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /** Events lost to a full ring since construction */
+    uint64_t getDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /** The trace clock (steady, nanoseconds) */
+    static uint64_t nowNs() noexcept
+    {
+#if SYNTH_TRACE && defined(__EMSCRIPTEN__)
+        return static_cast<uint64_t>(emscripten_get_now() * 1.0e6);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+private:
+    void push(const Event& e) noexcept
+    {
+        const uint64_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) >= CAPACITY)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[write & (CAPACITY - 1)] = e;
+        writeIndex.store(write + 1, std::memory_order_release);
+    }
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+    // One slot when off, so engines don't carry the ring for nothing
+    std::array<Event, ENABLED ? CAPACITY : 1> events{};
+    std::atomic<uint64_t> writeIndex{0};  // Audio thread
+    std::atomic<uint64_t> readIndex{0};   // Reader
+    std::atomic<uint64_t> dropped{0};
+};
@@ -0,0 +1,269 @@
+/**
+ * @file TuningTable.h
+ * @brief A frequency per MIDI note, from 12-TET or a Scala scale and keyboard mapping
+ *
+ * Voices look their note up once, at noteOn, so a tuning costs nothing per
+ * sample. The table is built off the audio thread (parsing allocates) and
+ * handed over whole; an engine copies it in with setTuning():
+ *
+ *   // Message thread
+ *   TuningTable table;
+ *   std::string error;
+ *   if (TuningTable::fromScala(sclText, kbmText, table, &error))
+ *       stage(table);
+ *
+ *   // Voice::noteOn
+ *   frequency = tuning != nullptr ? tuning->frequency(note) : PitchTables::get().midiToFrequency(note);
+ *
+ * Scala files as documented at huygens-fokker.org/scala: a .scl lists the
+ * degrees above the tonic (cents if the value has a '.', else a ratio
+ * n/d or an integer), the last being the period. A .kbm maps keys to
+ * degrees: map size, first and last note, middle note (degree 0),
+ * reference note and its frequency, the degree that is the formal octave,
+ * then a degree or 'x' (unmapped) per key. An empty .kbm is the usual
+ * default: every key a degree, middle C on the tonic, A4 at 440 Hz.
+ * Unmapped keys and keys outside first..last have frequency 0; engines
+ * don't start a voice for them.
+ *
+ * A default-constructed table is 12-TET at A4 = 440 Hz. Anything that
+ * sends per-note frequencies (an MTS-ESP client, a host's tuning) can fill
+ * a table through fromFrequencies().
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TuningTable
+{
+public:
+    static constexpr int NUM_NOTES = 128;
+
+    /** 12-TET, A4 = 440 Hz */
+    TuningTable()
+    {
+        for (int n = 0; n < NUM_NOTES; ++n)
+            hz[static_cast<size_t>(n)] = static_cast<float>(440.0 * std::pow(2.0, (n - 69) / 12.0));
+    }
+
+    /** Hz for a MIDI note, 0 if it's unmapped or out of range */
+    float frequency(int note) const
+    {
+        return note >= 0 && note < NUM_NOTES ? hz[static_cast<size_t>(note)] : 0.0f;
+    }
+
+    bool isMapped(int note) const { return frequency(note) > 0.0f; }
+
+    /** True for the default table: engines can keep their own 12-TET path */
+    bool isEqualTemperament() const { return equal; }
+
+    /** Take 128 frequencies as they are (0 or less: unmapped) */
+    static TuningTable fromFrequencies(const float* frequencies)
+    {
+        TuningTable table;
+        table.equal = false;
+        for (int n = 0; n < NUM_NOTES; ++n)
+        {
+            const float f = frequencies[n];
+            table.hz[static_cast<size_t>(n)] = std::isfinite(f) && f > 0.0f ? f : 0.0f;
+        }
+        return table;
+    }
+
+    /**
+     * @brief Build from the text of a .scl and a .kbm (empty: the default mapping)
+     * @return False, leaving @p out alone and saying why in @p error, if either doesn't parse
+     */
+    static bool fromScala(std::string_view scl, std::string_view kbm, TuningTable& out,
+                          std::string* error = nullptr)
+    {
+        auto fail = [error](const char* why) {
+            if (error != nullptr)
+                *error = why;
+            return false;
+        };
+
+        // Scale: cents of each degree above the tonic, the last the period
+        const std::vector<std::string> scaleLines = dataLines(scl);
+        if (scaleLines.size() < 2)
+            return fail("Scale: no degree count");
+        const long count = std::strtol(scaleLines[1].c_str(), nullptr, 10);
+        if (count < 1 || static_cast<size_t>(count) > scaleLines.size() - 2)
+            return fail("Scale: degree count doesn't match the degrees");
+
+        std::vector<double> cents{0.0};
+        for (long d = 0; d < count; ++d)
+        {
+            double c = 0.0;
+            if (!parsePitch(scaleLines[static_cast<size_t>(d + 2)], c))
+                return fail("Scale: unreadable degree");
+            cents.push_back(c);
+        }
+
+        // Mapping, or the default: linear from middle C, A4 = 440
+        Mapping map;
+        map.octaveDegree = static_cast<int>(count);
+        if (!kbm.empty() && !parseMapping(kbm, map))
+            return fail("Keyboard mapping: unreadable");
+
+        const auto degreeCents = [&](long degree) {
+            const long n = static_cast<long>(count);
+            const long octaves = floorDiv(degree, n);
+            return static_cast<double>(octaves) * cents.back() + cents[static_cast<size_t>(degree - octaves * n)];
+        };
+
+        // Cents of a key above the middle note, or false if it's unmapped
+        const auto keyCents = [&](int key, double& c) {
+            if (key < map.first || key > map.last)
+                return false;
+            const long offset = key - map.middle;
+            if (map.degrees.empty())
+            {
+                c = degreeCents(offset);
+                return true;
+            }
+            const long size = static_cast<long>(map.degrees.size());
+            const long octaves = floorDiv(offset, size);
+            const int degree = map.degrees[static_cast<size_t>(offset - octaves * size)];
+            if (degree < 0)
+                return false;
+            c = static_cast<double>(octaves) * degreeCents(map.octaveDegree) + degreeCents(degree);
+            return true;
+        };
+
+        double referenceCents = 0.0;
+        if (!keyCents(map.referenceNote, referenceCents))
+            return fail("Keyboard mapping: the reference note is unmapped");
+
+        TuningTable table;
+        table.equal = false;
+        for (int n = 0; n < NUM_NOTES; ++n)
+        {
+            double c = 0.0;
+            float f = 0.0f;
+            if (keyCents(n, c))
+            {
+                f = static_cast<float>(map.referenceHz * std::pow(2.0, (c - referenceCents) / 1200.0));
+                if (!std::isfinite(f) || f <= 0.0f)
+                    f = 0.0f;
+            }
+            table.hz[static_cast<size_t>(n)] = f;
+        }
+
+        out = table;
+        return true;
+    }
+
+private:
+    struct Mapping
+    {
+        int first = 0;
+        int last = NUM_NOTES - 1;
+        int middle = 60;
+        int referenceNote = 69;
+        double referenceHz = 440.0;
+        int octaveDegree = 12;
+        std::vector<int> degrees;  // Per key from the middle note, -1 unmapped; empty: linear
+    };
+
+    static long floorDiv(long a, long b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    /** Non-comment lines, trimmed (a .scl's description may be empty, so it's kept) */
+    static std::vector<std::string> dataLines(std::string_view text)
+    {
+        std::vector<std::string> lines;
+        std::istringstream in{std::string(text)};
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty() && line[0] == '!')
+                continue;
+            const size_t start = line.find_first_not_of(" \t");
+            lines.push_back(start == std::string::npos ? std::string() : line.substr(start));
+        }
+        return lines;
+    }
+
+    /** A degree: cents with a '.', else n/d or n; anything after it is a comment */
+    static bool parsePitch(const std::string& line, double& cents)
+    {
+        std::istringstream in(line);
+        std::string token;
+        if (!(in >> token))
+            return false;
+
+        char* end = nullptr;
+        if (token.find('.') != std::string::npos)
+        {
+            cents = std::strtod(token.c_str(), &end);
+            return end != token.c_str() && std::isfinite(cents);
+        }
+
+        const long num = std::strtol(token.c_str(), &end, 10);
+        long den = 1;
+        if (*end == '/')
+        {
+            const char* d = end + 1;
+            den = std::strtol(d, &end, 10);
+            if (end == d)
+                return false;
+        }
+        if (num <= 0 || den <= 0)
+            return false;
+        cents = 1200.0 * std::log2(static_cast<double>(num) / static_cast<double>(den));
+        return true;
+    }
+
+    static bool parseMapping(std::string_view kbm, Mapping& map)
+    {
+        std::vector<std::string> lines;
+        for (std::string& line : dataLines(kbm))
+        {
+            if (!line.empty())
+                lines.push_back(std::move(line));
+        }
+        if (lines.size() < 7)
+            return false;
+
+        auto integer = [&lines](size_t i, int& v) {
+            char* end = nullptr;
+            const long x = std::strtol(lines[i].c_str(), &end, 10);
+            v = static_cast<int>(x);
+            return end != lines[i].c_str();
+        };
+
+        int size = 0;
+        if (!integer(0, size) || !integer(1, map.first) || !integer(2, map.last) || !integer(3, map.middle)
+            || !integer(4, map.referenceNote))
+            return false;
+        map.referenceHz = std::strtod(lines[5].c_str(), nullptr);
+        if (!integer(6, map.octaveDegree))
+            return false;
+        if (size < 0 || map.referenceHz <= 0.0 || !std::isfinite(map.referenceHz) || map.octaveDegree < 0)
+            return false;
+
+        // Fewer entries than the map size: the rest are unmapped
+        map.degrees.assign(static_cast<size_t>(size), -1);
+        for (int k = 0; k < size && static_cast<size_t>(7 + k) < lines.size(); ++k)
+        {
+            const std::string& entry = lines[static_cast<size_t>(7 + k)];
+            int degree = -1;
+            if (entry[0] != 'x' && !integer(static_cast<size_t>(7 + k), degree))
+                return false;
+            map.degrees[static_cast<size_t>(k)] = degree < 0 ? -1 : degree;
+        }
+        return true;
+    }
+
+    std::array<float, NUM_NOTES> hz{};
+    bool equal = true;
+};
@@ -0,0 +1,129 @@
+/**
+ * @file UIResourceCache.h
+ * @brief The editor's embedded UI files, looked up by URL and inflated once per process
+ *
+ * getResource() used to copy the whole inlined index.html out of the binary
+ * data for every request and served nothing else. Now the build embeds
+ * every file gzipped (a few times smaller in the binary; see
+ * core/cmake/GzipFile.cmake) and one cache per process serves them all:
+ *
+ *   static UIResourceCache cache(embeddedFiles(), inflateGzip);   // Every editor shares it
+ *
+ *   if (const auto* file = cache.find(path))                      // "/", "index.html?x=1"...
+ *       serve(file->bytes, file->mimeType);
+ *
+ * Files are registered by name; "name.gz" is stored compressed and served
+ * as "name", inflated on its first request. Later requests, from any editor
+ * instance, get the same bytes back with no work. Lookups are by the URL's
+ * path without query or fragment, and "/" means index.html.
+ *
+ * The inflate function is passed in (the editor uses JUCE's gzip stream),
+ * so this header stays free of JUCE.
+ *
+ * @note find() may allocate on a file's first request: message thread, or
+ *       wherever the WebView asks for resources. Never the audio thread.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class UIResourceCache
+{
+public:
+    /** One embedded file as the binary data has it */
+    struct EmbeddedFile
+    {
+        std::string_view name;  // "index.html", or "index.html.gz" if gzipped
+        const void* data = nullptr;
+        size_t size = 0;
+    };
+
+    /** A file ready to serve */
+    struct File
+    {
+        std::vector<std::byte> bytes;
+        std::string_view mimeType;
+    };
+
+    using Inflate = std::function<std::vector<std::byte>(const void* data, size_t size)>;
+
+    UIResourceCache(const std::vector<EmbeddedFile>& files, Inflate inflateGzip)
+        : inflate(std::move(inflateGzip))
+    {
+        for (const auto& f : files)
+        {
+            const bool gzipped = f.name.size() > 3 && f.name.substr(f.name.size() - 3) == ".gz";
+            const auto name = gzipped ? f.name.substr(0, f.name.size() - 3) : f.name;
+            entries[std::string(name)] = {f.data, f.size, gzipped, false, {{}, mimeTypeFor(name)}};
+        }
+    }
+
+    UIResourceCache(const UIResourceCache&) = delete;
+    UIResourceCache& operator=(const UIResourceCache&) = delete;
+
+    /** The file for a URL path, or nullptr if there's none; the pointer stays valid for the cache's life */
+    const File* find(std::string_view urlPath)
+    {
+        const auto it = entries.find(normalisePath(urlPath));
+        if (it == entries.end())
+            return nullptr;
+
+        Entry& e = it->second;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!e.ready)
+        {
+            const auto* bytes = static_cast<const std::byte*>(e.data);
+            e.file.bytes = e.gzipped ? inflate(e.data, e.size) : std::vector<std::byte>(bytes, bytes + e.size);
+            e.ready = true;
+        }
+        return &e.file;
+    }
+
+    /** "/" -> "index.html"; the leading slash, query and fragment go */
+    static std::string normalisePath(std::string_view urlPath)
+    {
+        urlPath = urlPath.substr(0, urlPath.find_first_of("?#"));
+        while (!urlPath.empty() && urlPath.front() == '/')
+            urlPath.remove_prefix(1);
+        return urlPath.empty() ? std::string("index.html") : std::string(urlPath);
+    }
+
+    /** MIME type by extension, for what a Vite build emits */
+    static std::string_view mimeTypeFor(std::string_view name)
+    {
+        const auto dot = name.rfind('.');
+        const auto ext = dot == std::string_view::npos ? std::string_view() : name.substr(dot + 1);
+
+        if (ext == "html") return "text/html";
+        if (ext == "js" || ext == "mjs") return "text/javascript";
+        if (ext == "css") return "text/css";
+        if (ext == "json") return "application/json";
+        if (ext == "svg") return "image/svg+xml";
+        if (ext == "png") return "image/png";
+        if (ext == "woff2") return "font/woff2";
+        if (ext == "wasm") return "application/wasm";
+        return "application/octet-stream";
+    }
+
+private:
+    struct Entry
+    {
+        const void* data;
+        size_t size;
+        bool gzipped;
+        bool ready;  // file holds the bytes (under mutex)
+        File file;
+    };
+
+    Inflate inflate;
+    std::map<std::string, Entry, std::less<>> entries;  // Fixed after construction
+    std::mutex mutex;
+};
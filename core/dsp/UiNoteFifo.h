@@ -0,0 +1,103 @@
+/**
+ * @file UiNoteFifo.h
+ * @brief Lock-free UI -> audio note FIFO for the on-screen keyboard
+ *
+ * The editor's native noteOn / noteOff functions push here (message
+ * thread); processBlock() drains it at the top of the block and merges
+ * the notes into the block's MidiBuffer, so they reach the engine through
+ * the same path as host MIDI. Single producer, single consumer, no locks
+ * and no allocation.
+ *
+ * Each note is stamped with the time it was pushed. drain() places it in
+ * the block at the same distance from the previous block's start, so
+ * notes played during one block keep their spacing in the next: a block
+ * of latency, but no jitter. A note older than one block (the host
+ * stalled, or the first block) lands at offset 0.
+ *
+ * Times are in seconds on any clock that both threads read
+ * (juce::Time::getMillisecondCounterHiRes() * 0.001 in the plugins).
+ *
+ * @note CAPACITY must be a power of two
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+
+class UiNoteFifo
+{
+public:
+    /** Notes held between two blocks; far more than a hand can play */
+    static constexpr int CAPACITY = 256;
+
+    struct Note
+    {
+        int note = 0;
+        float velocity = 0.0f;  // 0 for a note off
+        bool isNoteOn = false;
+        double time = 0.0;
+    };
+
+    /**
+     * @brief Queue a note (message thread)
+     * @return false if the FIFO is full and the note was dropped
+     */
+    bool push(int note, float velocity, bool isNoteOn, double timeSeconds) noexcept
+    {
+        const int write = writePos.load(std::memory_order_relaxed);
+        const int next = (write + 1) & MASK;
+        if (next == readPos.load(std::memory_order_acquire))
+            return false;
+
+        notes[static_cast<size_t>(write)] = {note, isNoteOn ? velocity : 0.0f, isNoteOn, timeSeconds};
+        writePos.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Hand the queued notes to @p fn with their sample offsets (audio thread)
+     * @param nowSeconds Time at the start of this block
+     * @param sampleRate Rate the offsets are in
+     * @param numSamples Block length; offsets are 0 to numSamples - 1
+     * @param fn Called as fn(note, offset), oldest first
+     */
+    template <typename Fn>
+    void drain(double nowSeconds, double sampleRate, int numSamples, Fn&& fn)
+    {
+        const int write = writePos.load(std::memory_order_acquire);
+        int read = readPos.load(std::memory_order_relaxed);
+
+        // The previous block's start, or one block ago if that's further back
+        const double blockSeconds = numSamples / sampleRate;
+        const double windowStart = std::max(lastBlockTime, nowSeconds - blockSeconds);
+        lastBlockTime = nowSeconds;
+
+        const double last = std::max(numSamples - 1, 0);
+        for (; read != write; read = (read + 1) & MASK)
+        {
+            const Note& n = notes[static_cast<size_t>(read)];
+            const double offset = std::clamp((n.time - windowStart) * sampleRate, 0.0, last);
+            fn(n, static_cast<int>(std::lround(offset)));
+        }
+
+        readPos.store(read, std::memory_order_release);
+    }
+
+    /** Whether notes are waiting (either thread, approximate) */
+    bool isEmpty() const noexcept
+    {
+        return writePos.load(std::memory_order_acquire) == readPos.load(std::memory_order_acquire);
+    }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static constexpr int MASK = CAPACITY - 1;
+
+    std::array<Note, CAPACITY> notes{};
+    std::atomic<int> writePos{0};
+    std::atomic<int> readPos{0};
+    double lastBlockTime = 0.0;  // Audio thread only
+};
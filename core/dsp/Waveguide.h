@@ -0,0 +1,419 @@
+/**
+ * @file Waveguide.h
+ * @brief Waveguide strings, plucked or bowed, one or four to a bank
+ *
+ * Each string is a digital waveguide: two fractional delay lines, read
+ * through the 12-tap windowed sinc of sst's SSESincDelayLine, meeting at
+ * the excitation point (STK's bowed string). A wave leaves the excitation
+ * point down one line, reflects inverted off that end, travels back along
+ * the other line and reflects off the far end. The bridge end carries the
+ * loss filter: a one-pole lowpass for the damping and a gain for the
+ * decay. A pluck adds one period of noise at the excitation point
+ * and the string rings down (Karplus-Strong); a bow keeps adding velocity
+ * through a stick-slip friction curve (the STK bow table), so the string
+ * sustains while the bow is on it. This is the string of sst-effects'
+ * StringResonator without its line pool and parameter metadata, so a
+ * voice can own its strings by value.
+ *
+ *   WaveguideQuad strings;                        // Four voices, one lane each
+ *   strings.prepare(sampleRate);
+ *   strings.setExcitation(StringExcitation::Bow);
+ *   strings.setLoss(decaySeconds, brightness);    // Per block: every lane
+ *   strings.setFrequency(lane, hz);               // Per block: one lane
+ *   strings.excite(lane, velocity);               // Note on
+ *   strings.release(lane);                        // Note off: the bow lifts
+ *   strings.process(out);                         // out[0..4), one sample
+ *
+ * WaveguideString is the one-lane bank, with float process().
+ *
+ * The lines are the arena: two of LINE_SIZE samples per lane, held inline,
+ * so a bank is allocated once with its voices and a note never allocates.
+ * A lane costs 64 KB and reaches down to about 6 Hz at 48 kHz (24 Hz at
+ * 192 kHz).
+ *
+ * The loss filter's coefficients and the line lengths are worked out per
+ * block in setFrequency() and setLoss(), and only when they change. The
+ * loop gain is set so the fundamental falls 60 dB in decaySeconds
+ * whatever the damping. The sinc reads lose a little at high pitches
+ * (their passband ends at 0.455 x Nyquist), so to leave the gain room the
+ * lowpass and the reads together may take at most half of that loss:
+ * high notes are damped less than the brightness asks, and from about
+ * 2 kHz (at 48 kHz) they ring shorter than decaySeconds. The lowpass's phase delay at
+ * the fundamental comes off the lines, which keeps the string in tune. The sample loop reads the lines lane by lane and
+ * runs everything else across the lanes in plain float arrays with no
+ * branches, which the compiler turns into one SIMD register op per step
+ * (SSE natively, SIMD128 in the web build).
+ *
+ * sst's simd/setup.h needs C++20. C++17 builds (the web synths) read the
+ * lines through a scalar copy of SSESincDelayLine: same table, same taps,
+ * same sound.
+ *
+ * @note Constructing a bank builds the sinc table on first use (once per
+ *       process); after that everything is real-time safe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include "Noise.h"
+#include "sst/basic-blocks/tables/SincTableProvider.h"
+
+#if __cplusplus >= 202002L
+#include "sst/basic-blocks/dsp/SSESincDelayLine.h"
+#define WAVEGUIDE_SSE_LINES 1
+#else
+#define WAVEGUIDE_SSE_LINES 0
+#endif
+
+enum class StringExcitation
+{
+    Pluck,  // A burst of noise, one period long, then free decay
+    Bow     // Stick-slip friction, sustained until release()
+};
+
+namespace WaveguideDetail
+{
+
+using SincTable = sst::basic_blocks::tables::SurgeSincTableProvider;
+
+/** The sinc table every line reads through, built on first use */
+inline const SincTable& sincTable()
+{
+    static const SincTable table;
+    return table;
+}
+
+#if WAVEGUIDE_SSE_LINES
+template <int SIZE>
+using SincLine = sst::basic_blocks::dsp::SSESincDelayLine<SIZE>;
+#else
+/** SSESincDelayLine's write() and read(), without SSE */
+template <int SIZE>
+struct SincLine
+{
+    static_assert((SIZE & (SIZE - 1)) == 0, "line sizes are powers of two");
+
+    explicit SincLine(const SincTable& st) : sinctable(st.sinctable) { clear(); }
+
+    void write(float f)
+    {
+        buffer[wp] = f;
+        buffer[wp + (wp < SincTable::FIRipol_N) * SIZE] = f;
+        wp = (wp + 1) & (SIZE - 1);
+    }
+
+    float read(float delay) const
+    {
+        const int iDelay = static_cast<int>(delay);
+        const float fracDelay = delay - static_cast<float>(iDelay);
+        const int tableOffset = static_cast<int>((1.0f - fracDelay) * SincTable::FIRipol_M) * SincTable::FIRipol_N * 2;
+        const int readPtr = (wp - iDelay - (SincTable::FIRipol_N >> 1)) & (SIZE - 1);
+
+        float sum = 0.0f;
+        for (int k = 0; k < SincTable::FIRipol_N; ++k)
+            sum += buffer[readPtr + k] * sinctable[tableOffset + k];
+        return sum;
+    }
+
+    void clear()
+    {
+        std::memset(buffer, 0, sizeof(buffer));
+        wp = 0;
+    }
+
+    alignas(16) float buffer[SIZE + SincTable::FIRipol_N];
+    int wp = 0;
+    const float* sinctable;
+};
+#endif
+
+} // namespace WaveguideDetail
+
+template <int LANES>
+class WaveguideStrings
+{
+public:
+    static constexpr int LINE_SIZE = 1 << 13;
+
+    /** Shortest line the sinc can read (it reaches FIRipol_N / 2 samples either side) */
+    static constexpr float MIN_DELAY = static_cast<float>(WaveguideDetail::SincTable::FIRipol_N / 2 + 1);
+    static constexpr float MAX_DELAY = static_cast<float>(LINE_SIZE - WaveguideDetail::SincTable::FIRipol_N);
+
+    /** Bow speed at full velocity, and how fast the bow lands and lifts (per sample) */
+    static constexpr float BOW_SPEED = 0.25f;
+    static constexpr float BOW_SMOOTHING = 0.002f;
+
+    WaveguideStrings() { std::fill(std::begin(hz), std::end(hz), 440.0f); }
+
+    void prepare(double sr)
+    {
+        sampleRate = static_cast<float>(sr);
+        for (int l = 0; l < LANES; ++l)
+        {
+            reset(l);
+            update(l);
+        }
+    }
+
+    /** Lane to silence: lines cleared, filters, bow and burst stopped */
+    void reset(int lane)
+    {
+        neck[lane].clear();
+        bridge[lane].clear();
+        lowpass[lane] = dcIn[lane] = dcOut[lane] = 0.0f;
+        bowSpeed[lane] = bowContact[lane] = bowTarget[lane] = 0.0f;
+        burstLeft[lane] = 0;
+        burstLevel[lane] = 0.0f;
+    }
+
+    void setExcitation(StringExcitation e) { excitation = e; }
+
+    /**
+     * @brief How hard the bow presses (0-1)
+     *
+     * Heavier pressure holds the string through more of each stick phase:
+     * a fuller tone. Light pressure slips early and sounds airy.
+     */
+    void setBowPressure(float pressure) { bowSlope = 5.0f - 4.0f * std::clamp(pressure, 0.0f, 1.0f); }
+
+    /** Where the string is plucked or bowed, as a fraction of its length from the bridge */
+    void setPosition(float fraction)
+    {
+        fraction = std::clamp(fraction, 0.02f, 0.5f);
+        if (fraction == position)
+            return;
+        position = fraction;
+        for (int l = 0; l < LANES; ++l)
+            update(l);
+    }
+
+    /**
+     * @brief Every lane's loss filter (per block)
+     * @param decaySeconds Time for the fundamental to fall 60 dB
+     * @param brightness   0 damps the upper partials hard, 1 barely at all
+     */
+    void setLoss(float decaySeconds, float brightness)
+    {
+        decaySeconds = std::max(decaySeconds, 0.01f);
+        const float p = 0.9f * (1.0f - std::clamp(brightness, 0.0f, 1.0f));
+        if (decaySeconds == decay && p == pole)
+            return;
+        decay = decaySeconds;
+        pole = p;
+        for (int l = 0; l < LANES; ++l)
+            update(l);
+    }
+
+    /** Lane's pitch: its line lengths and loop gain (per block) */
+    void setFrequency(int lane, float frequency)
+    {
+        frequency = std::clamp(frequency, 1.0f, 0.45f * sampleRate);
+        if (frequency == hz[lane])
+            return;
+        hz[lane] = frequency;
+        update(lane);
+    }
+
+    /** Note on: pluck the string, or set the bow on it, at velocity (0-1) */
+    void excite(int lane, float velocity)
+    {
+        if (excitation == StringExcitation::Pluck)
+        {
+            burstLeft[lane] = static_cast<int>(neckDelay[lane] + bridgeDelay[lane]);
+            burstLevel[lane] = velocity;
+        }
+        else
+        {
+            bowSpeed[lane] = BOW_SPEED * velocity;
+            bowTarget[lane] = 1.0f;
+        }
+    }
+
+    /** Note off: lift the bow (a plucked string rings on) */
+    void release(int lane) { bowTarget[lane] = 0.0f; }
+
+    /** One sample of every lane into out[0..LANES) */
+    void process(float* out) noexcept
+    {
+        alignas(16) float atBridge[LANES];
+        alignas(16) float atNut[LANES];
+        alignas(16) float burst[LANES];
+        for (int l = 0; l < LANES; ++l)
+        {
+            atBridge[l] = bridge[l].read(bridgeDelay[l]);
+            atNut[l] = neck[l].read(neckDelay[l]);
+            burst[l] = 0.0f;
+            if (burstLeft[l] > 0)
+            {
+                burst[l] = burstLevel[l] * noise.unifPM1();
+                --burstLeft[l];
+            }
+        }
+
+        for (int l = 0; l < LANES; ++l)
+        {
+            // Bridge: damping and decay, inverted
+            lowpass[l] += lossCoef[l] * (atBridge[l] - lowpass[l]);
+            const float bridgeReflection = -lossGain[l] * lowpass[l];
+            const float nutReflection = -atNut[l];
+
+            // Bow: the string sticks to it while their speeds are close
+            // (reflection near 1) and slips once they part
+            bowContact[l] += BOW_SMOOTHING * (bowTarget[l] - bowContact[l]);
+            const float dv = bowSpeed[l] - (bridgeReflection + nutReflection);
+            const float t = 1.0f / (std::fabs(dv * bowSlope) + 0.75f);
+            const float t4 = (t * t) * (t * t);
+            const float reflection = t4 - positive(t4 - 1.0f);  // min(t4, 1)
+            const float added = bowContact[l] * dv * reflection + burst[l];
+
+            atNut[l] = bridgeReflection + added;  // Into the neck line
+            atBridge[l] = nutReflection + added;  // Into the bridge line
+
+            // Out through a DC blocker: the bow pushes the string off centre
+            out[l] = bridgeReflection - dcIn[l] + DC_POLE * dcOut[l];
+            dcIn[l] = bridgeReflection;
+            dcOut[l] = out[l];
+        }
+
+        for (int l = 0; l < LANES; ++l)
+        {
+            neck[l].write(atNut[l]);
+            bridge[l].write(atBridge[l]);
+        }
+    }
+
+    /** One sample of a one-lane bank */
+    float process() noexcept
+    {
+        static_assert(LANES == 1, "multi-lane banks render into an array");
+        float out;
+        process(&out);
+        return out;
+    }
+
+    /** Round-trip line length in samples, as set for the lane's pitch */
+    float getDelay(int lane) const { return neckDelay[lane] + bridgeDelay[lane]; }
+
+    void reseed(uint32_t seed) { noise.reseed(seed); }
+
+private:
+    /** Line with its sinc table, so the arena default-constructs */
+    struct Line : WaveguideDetail::SincLine<LINE_SIZE>
+    {
+        Line() : WaveguideDetail::SincLine<LINE_SIZE>(WaveguideDetail::sincTable()) {}
+    };
+
+    static constexpr float DC_POLE = 0.995f;
+
+    /** max(x, 0) without a comparison, so the lane loop vectorizes */
+    static float positive(float x) { return 0.5f * (x + std::fabs(x)); }
+
+    /** Lane's loss filter and line lengths, for its pitch and the shared loss settings */
+    void update(int lane)
+    {
+        const float w = 6.28318531f * hz[lane] / sampleRate;
+
+        // The lowpass and the reads keep at least the square root of the
+        // round trip's gain at the fundamental; the loop gain makes up the
+        // rest. The reads' gain depends on the line lengths, which depend
+        // on the lowpass: sized first with the last cap, then again
+        setLines(lane, w, std::min(pole, poleCap[lane]));
+        const float perTrip = std::exp(-6.90775528f / (decay * hz[lane]));  // -60 dB over decaySeconds
+        const float reads = readGain(w, neckDelay[lane]) * readGain(w, bridgeDelay[lane]);
+        poleCap[lane] = poleFor(w, std::sqrt(perTrip) / reads);
+        const float a = std::min(pole, poleCap[lane]);
+        lossGain[lane] = std::min(perTrip / (lowpassGain(w, a) * reads), 0.9999f);
+        lossCoef[lane] = 1.0f - a;
+        setLines(lane, w, a);
+    }
+
+    /** Both lines together one period less the lowpass's phase delay at w, split at the position */
+    void setLines(int lane, float w, float a)
+    {
+        const float phaseDelay = std::atan2(a * std::sin(w), 1.0f - a * std::cos(w)) / w;
+        const float total = std::max(sampleRate / hz[lane] - phaseDelay, 2.0f * MIN_DELAY);
+        bridgeDelay[lane] = std::clamp(total * position, MIN_DELAY, MAX_DELAY);
+        neckDelay[lane] = std::clamp(total - bridgeDelay[lane], MIN_DELAY, MAX_DELAY);
+    }
+
+    static float lowpassGain(float w, float a)
+    {
+        const float re = 1.0f - a * std::cos(w);
+        const float im = a * std::sin(w);
+        return (1.0f - a) / std::sqrt(re * re + im * im);
+    }
+
+    /** Gain at w of the sinc taps a line reads delay through */
+    static float readGain(float w, float delay)
+    {
+        using Table = WaveguideDetail::SincTable;
+        const float frac = delay - static_cast<float>(static_cast<int>(delay));
+        const float* taps = WaveguideDetail::sincTable().sinctable +
+                            static_cast<int>((1.0f - frac) * Table::FIRipol_M) * Table::FIRipol_N * 2;
+
+        // Sum of taps[k] e^(-jwk), the phasor stepped by rotation
+        const float c1 = std::cos(w), s1 = std::sin(w);
+        float c = 1.0f, s = 0.0f, re = 0.0f, im = 0.0f;
+        for (int k = 0; k < Table::FIRipol_N; ++k)
+        {
+            re += taps[k] * c;
+            im -= taps[k] * s;
+            const float next = c * c1 - s * s1;
+            s = s * c1 + c * s1;
+            c = next;
+        }
+        return std::sqrt(re * re + im * im);
+    }
+
+    /** The one-pole lowpass pole whose gain at w (radians per sample) is m */
+    static float poleFor(float w, float m)
+    {
+        // (1 - a)^2 = m^2 (1 - 2a cos w + a^2), the root inside the unit circle
+        const float m2 = m * m;
+        if (m2 >= 1.0f)
+            return 0.0f;
+        const float b = 1.0f - m2 * std::cos(w);
+        const float c = 1.0f - m2;
+        return (b - std::sqrt(std::max(b * b - c * c, 0.0f))) / c;
+    }
+
+    float sampleRate = 48000.0f;
+    float decay = 2.0f;
+    float pole = 0.45f;
+    float position = 0.13f;
+    float bowSlope = 3.0f;
+    StringExcitation excitation = StringExcitation::Pluck;
+
+    // Per lane, set per block
+    alignas(16) float hz[LANES] = {};
+    alignas(16) float neckDelay[LANES] = {};
+    alignas(16) float bridgeDelay[LANES] = {};
+    alignas(16) float lossGain[LANES] = {};
+    alignas(16) float lossCoef[LANES] = {};
+    alignas(16) float poleCap[LANES] = {};
+
+    // Per lane, per sample
+    alignas(16) float lowpass[LANES] = {};
+    alignas(16) float dcIn[LANES] = {};
+    alignas(16) float dcOut[LANES] = {};
+    alignas(16) float bowSpeed[LANES] = {};
+    alignas(16) float bowContact[LANES] = {};
+    alignas(16) float bowTarget[LANES] = {};
+    alignas(16) float burstLevel[LANES] = {};
+    int burstLeft[LANES] = {};
+
+    NoiseSource noise;
+
+    // The arena: two lines a lane, inline
+    std::array<Line, LANES> neck;
+    std::array<Line, LANES> bridge;
+};
+
+using WaveguideString = WaveguideStrings<1>;
+using WaveguideQuad = WaveguideStrings<4>;
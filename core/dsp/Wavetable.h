@@ -0,0 +1,513 @@
+/**
+ * @file Wavetable.h
+ * @brief Mip-mapped wavetables, shared per process, and oscillators that morph through them
+ *
+ * A Wavetable is a set of single-cycle frames, band-limited once when it's
+ * built: each frame is transformed and resynthesised at LEVELS mip levels,
+ * level L keeping MAX_HARMONICS >> L harmonics at four or more points per
+ * harmonic. An oscillator picks the level whose top harmonic stays under
+ * Nyquist for its pitch, so playback needs no per-voice FFT or aliasing
+ * fix, only table reads:
+ *
+ *   auto table = WavetableRegistry::get().load("tables/vowels.awt");  // prepare(), not audio
+ *   osc.setTable(table);
+ *   osc.setFrequency(hz);
+ *   float y = osc.process(position);   // 0-1 across the frames, interpolated
+ *
+ * Tables are immutable and held by shared_ptr. The registry hands every
+ * caller asking for the same file (or built-in) the same table, building
+ * it on the first request; it keeps only weak references, so a table goes
+ * when its last oscillator lets go.
+ *
+ * On disk a table is an .awt file: "AWT1", then frame size and frame
+ * count (little-endian uint32), then the frames as int16. Frame sizes are
+ * powers of two from 64 to 4096; a 2048 x 64 table is 256 KB.
+ *
+ * WavetableOscillatorQuad runs four oscillators on one table, one per SIMD
+ * lane: phases, interpolation and the frame morph are vector math, with
+ * the table reads done lane by lane (SSE has no gather).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+class Wavetable
+{
+public:
+    static constexpr int MAX_HARMONICS = 512;
+    static constexpr int LEVELS = 10;  // 512, 256, ... 1 harmonics
+    static constexpr int MIN_LEVEL_SIZE = 64;
+    static constexpr int MIN_FRAME_SIZE = 64;
+    static constexpr int MAX_FRAME_SIZE = 4096;
+
+    /** Points per cycle at a mip level (each frame stores one more, a copy of the first) */
+    static constexpr int levelSize(int level)
+    {
+        return std::max(MIN_LEVEL_SIZE, 4 * (MAX_HARMONICS >> level));
+    }
+
+    /**
+     * @brief Band-limit frames into a table
+     * @param samples frameCount cycles of frameSize samples each, back to back
+     * @return nullptr if frameSize isn't a power of two in range or there are no frames
+     */
+    static std::shared_ptr<const Wavetable> fromFrames(const float* samples, int frameSize, int frameCount)
+    {
+        if (samples == nullptr || frameCount < 1 || frameSize < MIN_FRAME_SIZE || frameSize > MAX_FRAME_SIZE
+            || (frameSize & (frameSize - 1)) != 0)
+            return nullptr;
+        return std::shared_ptr<const Wavetable>(new Wavetable(samples, frameSize, frameCount));
+    }
+
+    /** Read an .awt file; nullptr if it can't be read or isn't one */
+    static std::shared_ptr<const Wavetable> loadFile(const std::string& path)
+    {
+        std::unique_ptr<FILE, int (*)(FILE*)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+        if (!file)
+            return nullptr;
+
+        char magic[4];
+        uint8_t header[8];
+        if (std::fread(magic, 1, 4, file.get()) != 4 || std::string(magic, 4) != "AWT1"
+            || std::fread(header, 1, 8, file.get()) != 8)
+            return nullptr;
+
+        const auto u32 = [&](int at) {
+            return static_cast<uint32_t>(header[at]) | static_cast<uint32_t>(header[at + 1]) << 8
+                   | static_cast<uint32_t>(header[at + 2]) << 16 | static_cast<uint32_t>(header[at + 3]) << 24;
+        };
+        const uint32_t frameSize = u32(0);
+        const uint32_t frameCount = u32(4);
+        if (frameSize < MIN_FRAME_SIZE || frameSize > MAX_FRAME_SIZE || frameCount < 1 || frameCount > 4096)
+            return nullptr;
+
+        std::vector<uint8_t> raw(static_cast<size_t>(frameSize) * frameCount * 2);
+        if (std::fread(raw.data(), 1, raw.size(), file.get()) != raw.size())
+            return nullptr;
+
+        std::vector<float> samples(raw.size() / 2);
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const auto value = static_cast<int16_t>(static_cast<uint16_t>(raw[2 * i] | raw[2 * i + 1] << 8));
+            samples[i] = static_cast<float>(value) * (1.0f / 32767.0f);
+        }
+        return fromFrames(samples.data(), static_cast<int>(frameSize), static_cast<int>(frameCount));
+    }
+
+    /** Write frames as an .awt file (clipped to +/-1) */
+    static bool saveFile(const std::string& path, const float* samples, int frameSize, int frameCount)
+    {
+        std::unique_ptr<FILE, int (*)(FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        if (!file)
+            return false;
+
+        std::vector<uint8_t> bytes = {'A', 'W', 'T', '1'};
+        for (uint32_t v : {static_cast<uint32_t>(frameSize), static_cast<uint32_t>(frameCount)})
+            for (int b = 0; b < 4; ++b)
+                bytes.push_back(static_cast<uint8_t>(v >> (8 * b)));
+        for (size_t i = 0; i < static_cast<size_t>(frameSize) * static_cast<size_t>(frameCount); ++i)
+        {
+            const auto value = static_cast<int16_t>(std::lround(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f));
+            bytes.push_back(static_cast<uint8_t>(value & 0xFF));
+            bytes.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+        }
+        return std::fwrite(bytes.data(), 1, bytes.size(), file.get()) == bytes.size();
+    }
+
+    int getFrameCount() const { return frameCount; }
+
+    /** Bytes held by the mip levels */
+    size_t getMemoryBytes() const { return data.size() * sizeof(float); }
+
+    /** The level to play at increment (cycles per sample): its top harmonic under Nyquist */
+    static int levelFor(float increment)
+    {
+        int level = 0;
+        while (level < LEVELS - 1 && static_cast<float>(MAX_HARMONICS >> level) * increment > 0.5f)
+            ++level;
+        return level;
+    }
+
+    /** levelSize(level) + 1 points of frame at a level */
+    const float* frame(int level, int index) const
+    {
+        return data.data() + levelOffset[static_cast<size_t>(level)]
+               + static_cast<size_t>(index) * static_cast<size_t>(levelSize(level) + 1);
+    }
+
+private:
+    using Complex = std::complex<double>;
+
+    Wavetable(const float* samples, int frameSize, int frames) : frameCount(frames)
+    {
+        size_t total = 0;
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            levelOffset[static_cast<size_t>(level)] = total;
+            total += static_cast<size_t>(frames) * static_cast<size_t>(levelSize(level) + 1);
+        }
+        data.assign(total, 0.0f);
+
+        std::vector<Complex> spectrum(static_cast<size_t>(frameSize));
+        std::vector<Complex> level(static_cast<size_t>(levelSize(0)));
+        const int harmonics = std::min(MAX_HARMONICS, frameSize / 2 - 1);
+
+        for (int f = 0; f < frames; ++f)
+        {
+            for (int i = 0; i < frameSize; ++i)
+                spectrum[static_cast<size_t>(i)] = samples[static_cast<size_t>(f) * static_cast<size_t>(frameSize) + static_cast<size_t>(i)];
+            fft(spectrum, false);
+
+            for (int l = 0; l < LEVELS; ++l)
+            {
+                // Keep DC and this level's harmonics, then resynthesise at its size
+                const int size = levelSize(l);
+                const int keep = std::min(harmonics, MAX_HARMONICS >> l);
+                level.assign(static_cast<size_t>(size), Complex{});
+                const double scale = 1.0 / static_cast<double>(frameSize);
+                level[0] = spectrum[0] * scale;
+                for (int h = 1; h <= keep; ++h)
+                {
+                    level[static_cast<size_t>(h)] = spectrum[static_cast<size_t>(h)] * scale;
+                    level[static_cast<size_t>(size - h)] = spectrum[static_cast<size_t>(frameSize - h)] * scale;
+                }
+                fft(level, true);
+
+                float* out = data.data() + levelOffset[static_cast<size_t>(l)]
+                             + static_cast<size_t>(f) * static_cast<size_t>(size + 1);
+                for (int i = 0; i < size; ++i)
+                    out[i] = static_cast<float>(level[static_cast<size_t>(i)].real());
+                out[size] = out[0];
+            }
+        }
+    }
+
+    /** In-place radix-2 FFT (inverse unscaled) */
+    static void fft(std::vector<Complex>& x, bool inverse)
+    {
+        const size_t n = x.size();
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(x[i], x[j]);
+        }
+        for (size_t length = 2; length <= n; length <<= 1)
+        {
+            const double angle = (inverse ? 2.0 : -2.0) * 3.141592653589793 / static_cast<double>(length);
+            const Complex step(std::cos(angle), std::sin(angle));
+            for (size_t i = 0; i < n; i += length)
+            {
+                Complex w(1.0, 0.0);
+                for (size_t k = 0; k < length / 2; ++k)
+                {
+                    const Complex even = x[i + k];
+                    const Complex odd = x[i + k + length / 2] * w;
+                    x[i + k] = even + odd;
+                    x[i + k + length / 2] = even - odd;
+                    w *= step;
+                }
+            }
+        }
+    }
+
+    int frameCount = 0;
+    std::array<size_t, LEVELS> levelOffset{};
+    std::vector<float> data;  // Level by level, frame by frame
+};
+
+/**
+ * @brief The process's wavetables, built on first request and shared
+ *
+ * Call from prepare() or the message thread: a first request reads the
+ * file (or builds the built-in) and band-limits it.
+ */
+class WavetableRegistry
+{
+public:
+    /** Built-in tables, made without a file */
+    enum class Builtin
+    {
+        Basic,   // Sine -> triangle -> saw -> square, four frames
+        Glottal  // Glottal flow derivative, pressed -> breathy, four frames
+    };
+
+    static WavetableRegistry& get()
+    {
+        static WavetableRegistry registry;
+        return registry;
+    }
+
+    /** The table in an .awt file; nullptr if it can't be read */
+    std::shared_ptr<const Wavetable> load(const std::string& path)
+    {
+        return find("file:" + path, [&] { return Wavetable::loadFile(path); });
+    }
+
+    std::shared_ptr<const Wavetable> builtin(Builtin which)
+    {
+        return find("builtin:" + std::to_string(static_cast<int>(which)), [which] {
+            switch (which)
+            {
+                case Builtin::Basic:
+                    break;
+                case Builtin::Glottal:
+                    return makeGlottal();
+            }
+            return makeBasic();
+        });
+    }
+
+private:
+    template <typename Make>
+    std::shared_ptr<const Wavetable> find(const std::string& key, Make&& make)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto table = tables[key].lock())
+            return table;
+        auto table = make();
+        tables[key] = table;
+        return table;
+    }
+
+    static std::shared_ptr<const Wavetable> makeBasic()
+    {
+        constexpr int SIZE = 2048;
+        std::vector<float> frames(4 * SIZE);
+        for (int i = 0; i < SIZE; ++i)
+        {
+            const float p = static_cast<float>(i) / SIZE;
+            frames[static_cast<size_t>(i)] = std::sin(6.2831853f * p);
+            frames[static_cast<size_t>(SIZE + i)] = p < 0.25f ? 4.0f * p : p < 0.75f ? 2.0f - 4.0f * p : 4.0f * p - 4.0f;
+            frames[static_cast<size_t>(2 * SIZE + i)] = p < 0.5f ? 2.0f * p : 2.0f * p - 2.0f;
+            frames[static_cast<size_t>(3 * SIZE + i)] = p < 0.5f ? 1.0f : -1.0f;
+        }
+        return Wavetable::fromFrames(frames.data(), SIZE, 4);
+    }
+
+    /**
+     * @brief Rosenberg glottal pulses, differentiated: a voice source for formant filters
+     *
+     * The flow rises over two thirds of the open phase and closes over the
+     * last third; its derivative is the pulse the vocal tract hears, with
+     * the sharp closure that carries the upper harmonics. The frames open
+     * for 40%, 55%, 70% and 85% of the cycle (pressed to breathy), each
+     * scaled to a peak of 1.
+     */
+    static std::shared_ptr<const Wavetable> makeGlottal()
+    {
+        constexpr int SIZE = 2048;
+        constexpr double PI = 3.141592653589793;
+        constexpr double OPEN[4] = {0.40, 0.55, 0.70, 0.85};
+
+        std::vector<float> frames(4 * SIZE);
+        for (int f = 0; f < 4; ++f)
+        {
+            const double rise = OPEN[f] * 2.0 / 3.0;
+            const double fall = OPEN[f] - rise;
+            float* frame = frames.data() + static_cast<size_t>(f) * SIZE;
+            float peak = 0.0f;
+            for (int i = 0; i < SIZE; ++i)
+            {
+                const double t = static_cast<double>(i) / SIZE;
+                double d = 0.0;
+                if (t < rise)
+                    d = 0.5 * PI / rise * std::sin(PI * t / rise);
+                else if (t < OPEN[f])
+                    d = -0.5 * PI / fall * std::sin(0.5 * PI * (t - rise) / fall);
+                frame[i] = static_cast<float>(d);
+                peak = std::max(peak, std::abs(frame[i]));
+            }
+            for (int i = 0; i < SIZE; ++i)
+                frame[i] /= peak;
+        }
+        return Wavetable::fromFrames(frames.data(), SIZE, 4);
+    }
+
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<const Wavetable>> tables;
+};
+
+/**
+ * @brief One wavetable oscillator
+ */
+class WavetableOscillator
+{
+public:
+    void setTable(std::shared_ptr<const Wavetable> t)
+    {
+        table = std::move(t);
+        selectLevel();
+    }
+
+    void prepare(double sr)
+    {
+        sampleRate = static_cast<float>(sr);
+        reset();
+    }
+
+    void reset(float startPhase = 0.0f) { phase = startPhase - std::floor(startPhase); }
+
+    /** Also picks the mip level: call per block, not per sample */
+    void setFrequency(float hz)
+    {
+        increment = std::clamp(hz / sampleRate, 0.0f, 0.5f);
+        selectLevel();
+    }
+
+    /** One sample at position (0-1 across the frames), then advance; silent with no table */
+    float process(float position) noexcept
+    {
+        if (!table)
+            return 0.0f;
+
+        const float framePos = std::clamp(position, 0.0f, 1.0f) * static_cast<float>(lastFrame);
+        const int f0 = std::min(static_cast<int>(framePos), std::max(lastFrame - 1, 0));
+        const float morph = framePos - static_cast<float>(f0);
+        const float* a = table->frame(level, f0);
+        const float* b = table->frame(level, std::min(f0 + 1, lastFrame));
+
+        const float x = phase * static_cast<float>(size);
+        const int i = static_cast<int>(x);
+        const float frac = x - static_cast<float>(i);
+        const float va = a[i] + (a[i + 1] - a[i]) * frac;
+        const float vb = b[i] + (b[i + 1] - b[i]) * frac;
+
+        phase += increment;
+        phase -= phase >= 1.0f ? 1.0f : 0.0f;
+        return va + (vb - va) * morph;
+    }
+
+    int getLevel() const { return level; }
+
+private:
+    void selectLevel()
+    {
+        level = Wavetable::levelFor(increment);
+        size = Wavetable::levelSize(level);
+        lastFrame = table ? table->getFrameCount() - 1 : 0;
+    }
+
+    std::shared_ptr<const Wavetable> table;
+    float sampleRate = 44100.0f;
+    float phase = 0.0f;
+    float increment = 0.0f;
+    int level = 0;
+    int size = Wavetable::levelSize(0);
+    int lastFrame = 0;
+};
+
+/**
+ * @brief Four wavetable oscillators on one table, one per SIMD lane
+ */
+class WavetableOscillatorQuad
+{
+public:
+    void setTable(std::shared_ptr<const Wavetable> t)
+    {
+        table = std::move(t);
+        lastFrame = table ? table->getFrameCount() - 1 : 0;
+    }
+
+    void prepare(double sr)
+    {
+        sampleRate = static_cast<float>(sr);
+        phase = SIMD_MM(setzero_ps)();
+    }
+
+    /** Lane's phase to startPhase (a note starting on it) */
+    void reset(int lane, float startPhase = 0.0f)
+    {
+        alignas(16) float p[4];
+        SIMD_MM(store_ps)(p, phase);
+        p[lane] = startPhase - std::floor(startPhase);
+        phase = SIMD_MM(load_ps)(p);
+    }
+
+    /** Lane's frequency and mip level: per block, not per sample */
+    void setFrequency(int lane, float hz)
+    {
+        alignas(16) float inc[4];
+        SIMD_MM(store_ps)(inc, increment);
+        inc[lane] = std::clamp(hz / sampleRate, 0.0f, 0.5f);
+        increment = SIMD_MM(load_ps)(inc);
+
+        const int level = Wavetable::levelFor(inc[lane]);
+        levels[static_cast<size_t>(lane)] = level;
+        sizes[static_cast<size_t>(lane)] = static_cast<float>(Wavetable::levelSize(level));
+    }
+
+    /** One sample of all four at per-lane positions (0-1), then advance */
+    SIMD_M128 process(SIMD_M128 position) noexcept
+    {
+        if (!table)
+            return SIMD_MM(setzero_ps)();
+
+        const auto zero = SIMD_MM(setzero_ps)();
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+
+        // Frame pair and morph, per lane
+        const auto framePos = SIMD_MM(mul_ps)(SIMD_MM(min_ps)(SIMD_MM(max_ps)(position, zero), one),
+                                              SIMD_MM(set1_ps)(static_cast<float>(lastFrame)));
+        const auto f0 = SIMD_MM(cvttps_epi32)(SIMD_MM(min_ps)(framePos, SIMD_MM(set1_ps)(static_cast<float>(std::max(lastFrame - 1, 0)))));
+        const auto morph = SIMD_MM(sub_ps)(framePos, SIMD_MM(cvtepi32_ps)(f0));
+
+        // Read point and fraction, per lane
+        const auto x = SIMD_MM(mul_ps)(phase, SIMD_MM(load_ps)(sizes.data()));
+        const auto index = SIMD_MM(cvttps_epi32)(x);
+        const auto frac = SIMD_MM(sub_ps)(x, SIMD_MM(cvtepi32_ps)(index));
+
+        // No gather in SSE: the four corners, lane by lane
+        alignas(16) int32_t frames[4];
+        alignas(16) int32_t idx[4];
+        alignas(16) float a0[4], a1[4], b0[4], b1[4];
+        SIMD_MM(store_si128)(reinterpret_cast<SIMD_M128I*>(frames), f0);
+        SIMD_MM(store_si128)(reinterpret_cast<SIMD_M128I*>(idx), index);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            const int level = levels[static_cast<size_t>(lane)];
+            const float* a = table->frame(level, frames[lane]);
+            const float* b = table->frame(level, std::min(frames[lane] + 1, lastFrame));
+            a0[lane] = a[idx[lane]];
+            a1[lane] = a[idx[lane] + 1];
+            b0[lane] = b[idx[lane]];
+            b1[lane] = b[idx[lane] + 1];
+        }
+
+        const auto va0 = SIMD_MM(load_ps)(a0);
+        const auto vb0 = SIMD_MM(load_ps)(b0);
+        const auto va = SIMD_MM(add_ps)(va0, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(load_ps)(a1), va0), frac));
+        const auto vb = SIMD_MM(add_ps)(vb0, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(load_ps)(b1), vb0), frac));
+
+        phase = SIMD_MM(add_ps)(phase, increment);
+        phase = SIMD_MM(sub_ps)(phase, SIMD_MM(and_ps)(SIMD_MM(cmpge_ps)(phase, one), one));
+        return SIMD_MM(add_ps)(va, SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(vb, va), morph));
+    }
+
+private:
+    std::shared_ptr<const Wavetable> table;
+    float sampleRate = 44100.0f;
+    int lastFrame = 0;
+    SIMD_M128 phase = SIMD_MM(setzero_ps)();
+    SIMD_M128 increment = SIMD_MM(setzero_ps)();
+    std::array<int, 4> levels{};
+    alignas(16) std::array<float, 4> sizes{
+        static_cast<float>(Wavetable::levelSize(0)), static_cast<float>(Wavetable::levelSize(0)),
+        static_cast<float>(Wavetable::levelSize(0)), static_cast<float>(Wavetable::levelSize(0))};
+};
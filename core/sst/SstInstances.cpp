@@ -0,0 +1,10 @@
+/**
+ * @file SstInstances.cpp
+ * @brief The SST template instances SstPrecompiled.h declares extern
+ */
+
+#include "SstPrecompiled.h"
+
+template class sst::filters::FilterCoefficientMaker<>;
+template void sst::filters::FilterCoefficientMaker<>::updateState(sst::filters::QuadFilterUnitState&, int);
+template void sst::filters::FilterCoefficientMaker<>::updateCoefficients(sst::filters::QuadFilterUnitState&, int);
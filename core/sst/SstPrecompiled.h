@@ -0,0 +1,33 @@
+/**
+ * @file SstPrecompiled.h
+ * @brief The SST headers the engines share, precompiled once (see CMakeLists.txt)
+ *
+ * Every render, engine library, bench and shootout target force-includes
+ * this header through the autosynth-sst precompiled header instead of
+ * parsing sst-filters' _Impl headers and sst-effects per translation
+ * unit. The engines still include what they use by name; with the
+ * header already in, those includes cost nothing.
+ *
+ * FilterCoefficientMaker<> is declared extern: SstInstances.cpp
+ * instantiates it, and the update templates for QuadFilterUnitState,
+ * once for everything linked against autosynth-sst.
+ */
+
+#pragma once
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/basic-blocks/dsp/BlockInterpolators.h"
+#include "sst/basic-blocks/dsp/Clippers.h"
+#include "sst/basic-blocks/dsp/FastMath.h"
+#include "sst/basic-blocks/tables/EqualTuningProvider.h"
+#include "sst/basic-blocks/tables/TwoToTheXProvider.h"
+#include "sst/effects/EffectCore.h"
+#include "sst/effects/Reverb2.h"
+#include "sst/filters.h"
+#include "sst/filters/CytomicSVF.h"
+#include "sst/filters/HalfRateFilter.h"
+
+extern template class sst::filters::FilterCoefficientMaker<>;
+extern template void sst::filters::FilterCoefficientMaker<>::updateState(sst::filters::QuadFilterUnitState&, int);
+extern template void sst::filters::FilterCoefficientMaker<>::updateCoefficients(sst::filters::QuadFilterUnitState&,
+                                                                                 int);
@@ -0,0 +1,315 @@
+/**
+ * @file GoldenRender.h
+ * @brief Test support: hold an engine's sound to golden renders of its reference build
+ *
+ * Optimised kernels (SIMD lanes, table lookups, control-rate modulation)
+ * change the numerics, so their output can't be compared sample by
+ * sample. A scenario is instead rendered and reduced to a fingerprint of
+ * what a listener would notice:
+ *
+ *   - the RMS level of each channel
+ *   - the level envelope, in 50 ms windows
+ *   - the long-term spectrum, in third-octave bands from 25 Hz to 20 kHz
+ *     (bands far below the loudest get a looser tolerance: masked, and
+ *     where the fast clippers' faint top harmonics differ)
+ *
+ * The golden fingerprints are rendered by the reference build (the scalar
+ * paths, ReferenceDsp.h) and checked in as text, one file per scenario.
+ * Every build's tests render the same scenarios and compare within
+ * tolerances:
+ *
+ *   const auto got = GoldenRender::fingerprint(GoldenRender::render<SynthEngine>(48000.0, 2.0, script), 48000.0);
+ *   const std::string diff = GoldenRender::check(GOLDEN_DIR, "chord", got, tolerance);
+ *   INFO(diff);
+ *   CHECK(diff.empty());
+ *
+ * To regenerate the goldens after an intended change in sound, run the
+ * reference build's tests with AUTOSYNTH_GOLDEN_UPDATE=1: check() then
+ * writes the fingerprint instead of comparing. (An optimised build won't
+ * write; its goldens would drift with each kernel.)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ReferenceDsp.h"
+
+namespace GoldenRender
+{
+
+/** A stereo render */
+struct Stereo
+{
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+/** What the comparison looks at (levels in dBFS, floored at -200) */
+struct Fingerprint
+{
+    std::vector<double> rmsDb;       // Left, right
+    std::vector<double> envelopeDb;  // Mid level per 50 ms window
+    std::vector<double> bandDb;      // Mid power per third-octave band
+};
+
+/** How far a render may stray from its golden */
+struct Tolerance
+{
+    double rmsDb = 0.5;       // Overall level of each channel
+    double envelopeDb = 1.5;  // Each envelope window
+    double bandDb = 1.5;      // Each spectrum band
+    double quietBandDb = 4.0; // Bands over maskDb below the golden's loudest (masked by it)
+    double maskDb = 30.0;
+    double floorDb = -80.0;   // Windows and bands quieter than this in both are ignored
+};
+
+/**
+ * @brief Render an engine through a script
+ * @param script Called as script(engine, frame) before each block, with
+ *               the block's first frame: notes and parameter changes go here
+ */
+template <typename Engine, typename Script>
+Stereo render(double sampleRate, double seconds, Script&& script, int blockSize = 64)
+{
+    auto engine = std::make_unique<Engine>();
+    engine->prepare(sampleRate, blockSize);
+    if constexpr (requires { engine->setNoiseSeed(1u); })
+        engine->setNoiseSeed(1u);
+
+    const long frames = std::lround(sampleRate * seconds);
+    Stereo out;
+    out.left.assign(static_cast<size_t>(frames), 0.0f);
+    out.right.assign(static_cast<size_t>(frames), 0.0f);
+
+    for (long pos = 0; pos < frames; pos += blockSize)
+    {
+        const int n = static_cast<int>(std::min<long>(blockSize, frames - pos));
+        script(*engine, pos);
+        engine->renderBlock(out.left.data() + pos, out.right.data() + pos, n);
+    }
+    return out;
+}
+
+inline double toDb(double power)
+{
+    return power > 1.0e-20 ? 10.0 * std::log10(power) : -200.0;
+}
+
+/** In-place radix-2 FFT; data.size() must be a power of two */
+inline void fft(std::vector<std::complex<double>>& data)
+{
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1)
+    {
+        const double angle = -2.0 * 3.141592653589793 / static_cast<double>(length);
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < n; i += length)
+        {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < length / 2; ++k)
+            {
+                const auto even = data[i + k];
+                const auto odd = data[i + k + length / 2] * w;
+                data[i + k] = even + odd;
+                data[i + k + length / 2] = even - odd;
+                w *= step;
+            }
+        }
+    }
+}
+
+/** Reduce a render to its fingerprint */
+inline Fingerprint fingerprint(const Stereo& audio, double sampleRate)
+{
+    static constexpr size_t FFT_SIZE = 4096;
+    const size_t frames = audio.left.size();
+
+    std::vector<double> mid(frames);
+    for (size_t i = 0; i < frames; ++i)
+        mid[i] = 0.5 * (static_cast<double>(audio.left[i]) + static_cast<double>(audio.right[i]));
+
+    Fingerprint fp;
+    for (const auto* channel : {&audio.left, &audio.right})
+    {
+        double sum = 0.0;
+        for (float x : *channel)
+            sum += static_cast<double>(x) * static_cast<double>(x);
+        fp.rmsDb.push_back(toDb(frames > 0 ? sum / static_cast<double>(frames) : 0.0));
+    }
+
+    const size_t window = std::max<size_t>(1, static_cast<size_t>(sampleRate * 0.05));
+    for (size_t start = 0; start + window <= frames; start += window)
+    {
+        double sum = 0.0;
+        for (size_t i = start; i < start + window; ++i)
+            sum += mid[i] * mid[i];
+        fp.envelopeDb.push_back(toDb(sum / static_cast<double>(window)));
+    }
+
+    // Long-term spectrum: Hann-windowed frames, half overlapped, powers averaged
+    std::vector<double> power(FFT_SIZE / 2, 0.0);
+    std::vector<std::complex<double>> bins(FFT_SIZE);
+    int count = 0;
+    for (size_t start = 0; start + FFT_SIZE <= frames; start += FFT_SIZE / 2, ++count)
+    {
+        for (size_t i = 0; i < FFT_SIZE; ++i)
+        {
+            const double hann = 0.5 - 0.5 * std::cos(2.0 * 3.141592653589793 * static_cast<double>(i) / FFT_SIZE);
+            bins[i] = {mid[start + i] * hann, 0.0};
+        }
+        fft(bins);
+        for (size_t k = 0; k < FFT_SIZE / 2; ++k)
+            power[k] += std::norm(bins[k]);
+    }
+
+    // Scaled so a full-scale sine reads about 0 dB in its band
+    const double scale = count > 0 ? 4.0 / (static_cast<double>(count) * FFT_SIZE * FFT_SIZE * 0.375) : 0.0;
+    const double binHz = sampleRate / FFT_SIZE;
+    for (int band = -16; band <= 13; ++band)  // 25 Hz - 20 kHz around 1 kHz
+    {
+        const double centre = 1000.0 * std::pow(2.0, band / 3.0);
+        const double lo = centre * std::pow(2.0, -1.0 / 6.0);
+        const double hi = std::min(centre * std::pow(2.0, 1.0 / 6.0), sampleRate * 0.5);
+        double sum = 0.0;
+        for (size_t k = 1; k < FFT_SIZE / 2; ++k)
+        {
+            const double hz = static_cast<double>(k) * binHz;
+            if (hz >= lo && hz < hi)
+                sum += power[k];
+        }
+        fp.bandDb.push_back(toDb(sum * scale));
+    }
+    return fp;
+}
+
+/**
+ * @brief Compare a render's fingerprint with its golden
+ * @return Empty if within tolerance, else one line per difference
+ */
+inline std::string compare(const Fingerprint& golden, const Fingerprint& got, const Tolerance& tolerance)
+{
+    std::string report;
+    char line[160];
+
+    // Fast tanh and polynomial clippers shift the faint top harmonics by a dB or two
+    const double loudest = golden.bandDb.empty() ? 0.0 : *std::max_element(golden.bandDb.begin(), golden.bandDb.end());
+    std::vector<double> bandLimits;
+    for (double band : golden.bandDb)
+        bandLimits.push_back(band < loudest - tolerance.maskDb ? tolerance.quietBandDb : tolerance.bandDb);
+
+    auto series = [&](const char* what, const std::vector<double>& a, const std::vector<double>& b,
+                      const std::vector<double>& limits, bool floored) {
+        if (a.size() != b.size())
+        {
+            std::snprintf(line, sizeof(line), "%s: %zu values, golden has %zu\n", what, b.size(), a.size());
+            report += line;
+            return;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (floored && a[i] < tolerance.floorDb && b[i] < tolerance.floorDb)
+                continue;
+            if (std::abs(a[i] - b[i]) > limits[i])
+            {
+                std::snprintf(line, sizeof(line), "%s[%zu]: %.2f dB, golden %.2f dB (tolerance %.2f)\n", what, i,
+                              b[i], a[i], limits[i]);
+                report += line;
+            }
+        }
+    };
+
+    series("rms", golden.rmsDb, got.rmsDb, std::vector<double>(golden.rmsDb.size(), tolerance.rmsDb), false);
+    series("envelope", golden.envelopeDb, got.envelopeDb,
+           std::vector<double>(golden.envelopeDb.size(), tolerance.envelopeDb), true);
+    series("band", golden.bandDb, got.bandDb, bandLimits, true);
+    return report;
+}
+
+/** Write a fingerprint as text: one "key value value..." line per series */
+inline bool save(const std::string& path, const Fingerprint& fp)
+{
+    std::ofstream out(path);
+    auto line = [&](const char* key, const std::vector<double>& values) {
+        out << key;
+        char cell[32];
+        for (double v : values)
+        {
+            std::snprintf(cell, sizeof(cell), " %.3f", v);
+            out << cell;
+        }
+        out << "\n";
+    };
+    line("rms", fp.rmsDb);
+    line("envelope", fp.envelopeDb);
+    line("band", fp.bandDb);
+    return static_cast<bool>(out);
+}
+
+inline bool load(const std::string& path, Fingerprint& fp)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+
+    std::string text;
+    while (std::getline(in, text))
+    {
+        std::istringstream line(text);
+        std::string key;
+        line >> key;
+        std::vector<double>* series = key == "rms" ? &fp.rmsDb : key == "envelope" ? &fp.envelopeDb
+                                    : key == "band" ? &fp.bandDb : nullptr;
+        if (series == nullptr)
+            continue;
+        series->clear();
+        for (double v; line >> v;)
+            series->push_back(v);
+    }
+    return true;
+}
+
+/** AUTOSYNTH_GOLDEN_UPDATE=1 in a reference build: write goldens instead of checking them */
+inline bool updating()
+{
+    const char* update = std::getenv("AUTOSYNTH_GOLDEN_UPDATE");
+    return ReferenceDsp::ENABLED && update != nullptr && update[0] == '1';
+}
+
+/**
+ * @brief Check (or, when updating, write) <dir>/<name>.golden
+ * @return Empty on success, else what went wrong
+ */
+inline std::string check(const std::string& dir, const std::string& name, const Fingerprint& got,
+                         const Tolerance& tolerance)
+{
+    const std::string path = dir + "/" + name + ".golden";
+    if (updating())
+        return save(path, got) ? std::string() : "could not write " + path + "\n";
+
+    Fingerprint golden;
+    if (!load(path, golden))
+        return "no golden at " + path + " (render it with the reference build and AUTOSYNTH_GOLDEN_UPDATE=1)\n";
+    return compare(golden, got, tolerance);
+}
+
+} // namespace GoldenRender
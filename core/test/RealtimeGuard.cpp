@@ -0,0 +1,161 @@
+/**
+ * @file RealtimeGuard.cpp
+ * @brief The counting operator new / delete and lock hook (see RealtimeGuard.h)
+ */
+
+#include "RealtimeGuard.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+namespace
+{
+thread_local int depth = 0;  // Nested checks on this thread
+thread_local RealtimeGuard::Counts counts;
+
+void* allocate(std::size_t size)
+{
+    if (depth > 0)
+        ++counts.allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    if (depth > 0)
+        ++counts.allocations;
+    const auto align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc wants a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+void release(void* p)
+{
+    if (p != nullptr && depth > 0)
+        ++counts.deallocations;
+    std::free(p);
+}
+
+void releaseAligned(void* p)
+{
+    if (p != nullptr && depth > 0)
+        ++counts.deallocations;
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+} // namespace
+
+namespace RealtimeGuard::detail
+{
+void enter()
+{
+    if (depth++ == 0)
+        counts = {};
+}
+
+Counts leave()
+{
+    --depth;
+    return counts;
+}
+} // namespace RealtimeGuard::detail
+
+//==============================================================================
+// Replacement operators: every form, so new and delete always pair up
+//==============================================================================
+
+void* operator new(std::size_t size)
+{
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocateAligned(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocateAligned(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+//==============================================================================
+// Lock hook: the executable's pthread_mutex_lock is found before libc's
+//==============================================================================
+
+#if defined(__linux__)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFn = int (*)(pthread_mutex_t*);
+
+    // No function-local static: its guard could lock, and land back here
+    static std::atomic<LockFn> real{nullptr};
+    LockFn fn = real.load(std::memory_order_acquire);
+    if (fn == nullptr)
+    {
+        fn = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        real.store(fn, std::memory_order_release);
+    }
+
+    if (depth > 0)
+        ++counts.locks;
+    return fn(mutex);
+}
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file RealtimeGuard.h
+ * @brief Test support: count allocations and locks made while rendering
+ *
+ * Engines promise no allocations or locks in renderBlock(), but nothing
+ * checked it. Linking RealtimeGuard.cpp into a test executable replaces
+ * the global operator new / delete (and, on Linux, pthread_mutex_lock, so
+ * std::mutex too) with versions that count calls made inside a check on
+ * the calling thread:
+ *
+ *   const auto rt = RealtimeGuard::check([&] {
+ *       engine.renderBlock(left, right, numSamples);
+ *   });
+ *   REQUIRE(rt.allocations == 0);
+ *   REQUIRE(rt.locks == 0);
+ *
+ * Outside a check everything behaves as usual, so the rest of a test
+ * (Catch2 included) is unaffected. Anything the engine does through
+ * malloc() directly is not seen; the engines are C++ and don't.
+ *
+ * @note Link RealtimeGuard.cpp into one executable only once (it defines
+ *       the replacement operators), plus ${CMAKE_DL_LIBS} for the lock
+ *       hook's dlsym().
+ */
+
+#pragma once
+
+namespace RealtimeGuard
+{
+/** What the calling thread did during a check */
+struct Counts
+{
+    int allocations = 0;
+    int deallocations = 0;
+    int locks = 0;  // Always 0 where locks can't be hooked (not Linux)
+};
+
+namespace detail
+{
+void enter();
+Counts leave();
+} // namespace detail
+
+/** Run fn and count its allocations, frees and locks (this thread only) */
+template <typename Fn>
+Counts check(Fn&& fn)
+{
+    detail::enter();
+    fn();
+    return detail::leave();
+}
+} // namespace RealtimeGuard
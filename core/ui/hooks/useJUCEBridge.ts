@@ -7,7 +7,7 @@
  *
  * Communication Flow:
  *   React -> JUCE: window.__JUCE__.backend.emitEvent("__juce__invoke", ...)
- *   JUCE -> React: window.onParameterUpdate(), window.onAudioData(), etc.
+ *   JUCE -> React: window.onParametersUpdate(), window.onAudioData(), etc.
  *
  * IMPORTANT: JUCE 8 native functions registered with withNativeFunction()
  * are NOT directly accessible on window.__JUCE__.backend. They must be
@@ -41,6 +41,8 @@ declare global {
     };
     /** Called by JUCE when a parameter changes */
     onParameterUpdate?: (paramId: string, value: number) => void;
+    /** Called by JUCE once per UI tick with every parameter that changed */
+    onParametersUpdate?: (values: Record<string, number>) => void;
     /** Called by JUCE with all parameter state */
     onStateUpdate?: (state: Record<string, number>) => void;
     /** Called by JUCE with audio visualization data */
@@ -88,6 +90,14 @@ export interface UseJUCEBridgeReturn {
   noteOn: (note: number, velocity: number) => void;
   /** Trigger MIDI note off */
   noteOff: (note: number) => void;
+  /**
+   * Preview a preset (normalised values by parameter ID) without loading it,
+   * rendered in the background and played over the output; plugins without
+   * previews ignore it
+   */
+  auditionPreset: (values: Record<string, number>) => void;
+  /** Cut off the preview playing */
+  stopAudition: () => void;
   /** Register callback for parameter updates from JUCE */
   onParameterChange: (callback: (paramId: string, value: number) => void) => void;
   /** Register callback for full state updates from JUCE */
@@ -150,6 +160,13 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     // Full state update handler
     window.onStateUpdate = (state: Record<string, number>) => {
       if (stateCallbackRef.current) {
@@ -166,6 +183,7 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
       window.onAudioData = undefined;
     };
@@ -207,6 +225,17 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     callNativeFunction("noteOff", [note]);
   }, [isConnected, callNativeFunction]);
 
+  // Preset preview, rendered by the plugin off the audio thread
+  const auditionPreset = useCallback((values: Record<string, number>) => {
+    if (!isConnected) return;
+    callNativeFunction("auditionPreset", [values]);
+  }, [isConnected, callNativeFunction]);
+
+  const stopAudition = useCallback(() => {
+    if (!isConnected) return;
+    callNativeFunction("stopAudition", []);
+  }, [isConnected, callNativeFunction]);
+
   // Register parameter change callback
   const onParameterChange = useCallback((callback: (paramId: string, value: number) => void) => {
     parameterCallbackRef.current = callback;
@@ -225,6 +254,8 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     requestState,
     noteOn,
     noteOff,
+    auditionPreset,
+    stopAudition,
     onParameterChange,
     onStateChange,
   };
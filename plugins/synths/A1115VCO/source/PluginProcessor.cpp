@@ -7,6 +7,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -18,47 +19,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    // VCO
-    oscWaveformParam = apvts.getRawParameterValue("osc_waveform");
-    oscTuneParam = apvts.getRawParameterValue("osc_tune");
-    oscFineParam = apvts.getRawParameterValue("osc_fine");
-    pulseWidthParam = apvts.getRawParameterValue("pulse_width");
-    subLevelParam = apvts.getRawParameterValue("sub_level");
-    glideTimeParam = apvts.getRawParameterValue("glide_time");
-    monoModeParam = apvts.getRawParameterValue("mono_mode");
-    vcoFMSourceParam = apvts.getRawParameterValue("vco_fm_source");
-    vcoFMAmountParam = apvts.getRawParameterValue("vco_fm_amount");
-    vcoPWMSourceParam = apvts.getRawParameterValue("vco_pwm_source");
-    vcoPWMAmountParam = apvts.getRawParameterValue("vco_pwm_amount");
-
-    // VCF
-    vcfCutoffParam = apvts.getRawParameterValue("vcf_cutoff");
-    vcfResonanceParam = apvts.getRawParameterValue("vcf_resonance");
-    vcfTrackingParam = apvts.getRawParameterValue("vcf_tracking");
-    vcfModSourceParam = apvts.getRawParameterValue("vcf_mod_source");
-    vcfModAmountParam = apvts.getRawParameterValue("vcf_mod_amount");
-    vcfLFMAmountParam = apvts.getRawParameterValue("vcf_lfm_amount");
-
-    // VCA
-    vcaModSourceParam = apvts.getRawParameterValue("vca_mod_source");
-    vcaInitialLevelParam = apvts.getRawParameterValue("vca_initial_level");
-    masterLevelParam = apvts.getRawParameterValue("master_level");
-
-    // LFO1
-    lfo1FrequencyParam = apvts.getRawParameterValue("lfo1_frequency");
-    lfo1WaveformParam = apvts.getRawParameterValue("lfo1_waveform");
-    lfo1RangeParam = apvts.getRawParameterValue("lfo1_range");
-
-    // LFO2
-    lfo2FrequencyParam = apvts.getRawParameterValue("lfo2_frequency");
-    lfo2WaveformParam = apvts.getRawParameterValue("lfo2_waveform");
-    lfo2RangeParam = apvts.getRawParameterValue("lfo2_range");
-
-    // ADSR
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -327,11 +293,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -343,100 +311,38 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = synthEngine.getActiveVoiceCount();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read VCO parameters
-    int waveform = static_cast<int>(oscWaveformParam->load());
-    float tune = oscTuneParam->load();
-    float fine = oscFineParam->load();
-    float pulseWidth = pulseWidthParam->load();
-    float subLevel = subLevelParam->load();
-    float glideTime = glideTimeParam->load();
-    bool monoMode = monoModeParam->load() > 0.5f;
-    int vcoFMSource = static_cast<int>(vcoFMSourceParam->load());
-    float vcoFMAmount = vcoFMAmountParam->load();
-    int vcoPWMSource = static_cast<int>(vcoPWMSourceParam->load());
-    float vcoPWMAmount = vcoPWMAmountParam->load();
-
-    // Read VCF parameters
-    float vcfCutoff = vcfCutoffParam->load();
-    float vcfResonance = vcfResonanceParam->load();
-    int vcfTracking = static_cast<int>(vcfTrackingParam->load());
-    int vcfModSource = static_cast<int>(vcfModSourceParam->load());
-    float vcfModAmount = vcfModAmountParam->load();
-    float vcfLFMAmount = vcfLFMAmountParam->load();
-
-    // Read VCA parameters
-    int vcaModSource = static_cast<int>(vcaModSourceParam->load());
-    float vcaInitialLevel = vcaInitialLevelParam->load();
-    float masterLevel = masterLevelParam->load();
-
-    // Read LFO1 parameters
-    float lfo1Frequency = lfo1FrequencyParam->load();
-    int lfo1Waveform = static_cast<int>(lfo1WaveformParam->load());
-    int lfo1Range = static_cast<int>(lfo1RangeParam->load());
-
-    // Read LFO2 parameters
-    float lfo2Frequency = lfo2FrequencyParam->load();
-    int lfo2Waveform = static_cast<int>(lfo2WaveformParam->load());
-    int lfo2Range = static_cast<int>(lfo2RangeParam->load());
-
-    // Read ADSR parameters
-    float attack = ampAttackParam->load();
-    float decay = ampDecayParam->load();
-    float sustain = ampSustainParam->load();
-    float release = ampReleaseParam->load();
-
-    // Update synth engine - VCO
-    synthEngine.setWaveform(waveform);
-    synthEngine.setTune(tune);
-    synthEngine.setFine(fine);
-    synthEngine.setPulseWidth(pulseWidth);
-    synthEngine.setSubLevel(subLevel);
-    synthEngine.setGlideTime(glideTime);
-    synthEngine.setMonoMode(monoMode);
-    synthEngine.setVCOFMSource(vcoFMSource);
-    synthEngine.setVCOFMAmount(vcoFMAmount);
-    synthEngine.setVCOPWMSource(vcoPWMSource);
-    synthEngine.setVCOPWMAmount(vcoPWMAmount);
-
-    // Update synth engine - VCF
-    synthEngine.setVCFCutoff(vcfCutoff);
-    synthEngine.setVCFResonance(vcfResonance);
-    synthEngine.setVCFTracking(vcfTracking);
-    synthEngine.setVCFModSource(vcfModSource);
-    synthEngine.setVCFModAmount(vcfModAmount);
-    synthEngine.setVCFLFMAmount(vcfLFMAmount);
-
-    // Update synth engine - VCA
-    synthEngine.setVCAModSource(vcaModSource);
-    synthEngine.setVCAInitialLevel(vcaInitialLevel);
-    synthEngine.setMasterLevel(masterLevel);
-
-    // Update synth engine - LFO1
-    synthEngine.setLFO1Frequency(lfo1Frequency);
-    synthEngine.setLFO1Waveform(lfo1Waveform);
-    synthEngine.setLFO1Range(lfo1Range);
-
-    // Update synth engine - LFO2
-    synthEngine.setLFO2Frequency(lfo2Frequency);
-    synthEngine.setLFO2Waveform(lfo2Waveform);
-    synthEngine.setLFO2Range(lfo2Range);
-
-    // Update synth engine - ADSR
-    synthEngine.setAttack(attack);
-    synthEngine.setDecay(decay);
-    synthEngine.setSustain(sustain);
-    synthEngine.setRelease(release);
+    // Update synth engine (only the parameters that changed)
+    params.update();
+    synthEngine.applySnapshot(params);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -456,24 +362,21 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition);
         }
     }
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[static_cast<size_t>(i)] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -491,18 +394,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
@@ -9,6 +9,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 /**
  * @brief Main audio processor class for A111-5 VCO
@@ -51,7 +54,14 @@ public:
     //==========================================================================
 
     juce::AudioProcessorValueTreeState apvts;
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
 
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -63,64 +73,11 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters - VCO
-    //==========================================================================
-
-    std::atomic<float>* oscWaveformParam = nullptr;
-    std::atomic<float>* oscTuneParam = nullptr;
-    std::atomic<float>* oscFineParam = nullptr;
-    std::atomic<float>* pulseWidthParam = nullptr;
-    std::atomic<float>* subLevelParam = nullptr;
-    std::atomic<float>* glideTimeParam = nullptr;
-    std::atomic<float>* monoModeParam = nullptr;
-    std::atomic<float>* vcoFMSourceParam = nullptr;
-    std::atomic<float>* vcoFMAmountParam = nullptr;
-    std::atomic<float>* vcoPWMSourceParam = nullptr;
-    std::atomic<float>* vcoPWMAmountParam = nullptr;
-
-    //==========================================================================
-    // Cached Parameters - VCF
-    //==========================================================================
-
-    std::atomic<float>* vcfCutoffParam = nullptr;
-    std::atomic<float>* vcfResonanceParam = nullptr;
-    std::atomic<float>* vcfTrackingParam = nullptr;
-    std::atomic<float>* vcfModSourceParam = nullptr;
-    std::atomic<float>* vcfModAmountParam = nullptr;
-    std::atomic<float>* vcfLFMAmountParam = nullptr;
-
-    //==========================================================================
-    // Cached Parameters - VCA
-    //==========================================================================
-
-    std::atomic<float>* vcaModSourceParam = nullptr;
-    std::atomic<float>* vcaInitialLevelParam = nullptr;
-    std::atomic<float>* masterLevelParam = nullptr;
-
-    //==========================================================================
-    // Cached Parameters - LFO1
-    //==========================================================================
-
-    std::atomic<float>* lfo1FrequencyParam = nullptr;
-    std::atomic<float>* lfo1WaveformParam = nullptr;
-    std::atomic<float>* lfo1RangeParam = nullptr;
-
-    //==========================================================================
-    // Cached Parameters - LFO2
+    // Parameters
     //==========================================================================
 
-    std::atomic<float>* lfo2FrequencyParam = nullptr;
-    std::atomic<float>* lfo2WaveformParam = nullptr;
-    std::atomic<float>* lfo2RangeParam = nullptr;
-
-    //==========================================================================
-    // Cached Parameters - ADSR
-    //==========================================================================
-
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     //==========================================================================
     // State
@@ -128,7 +85,14 @@ private:
 
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
-    std::array<float, 512> visualizationBuffer{};
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -0,0 +1,102 @@
+/**
+ * @file PitchGlide.h
+ * @brief Portamento as a per-block exponential ramp: one multiply per sample
+ *
+ * A glide moves linearly in octaves, so in Hz each sample multiplies the
+ * frequency by the same factor. Once per block, advance() works out where
+ * the glide is and the factor that brings it to where it will be at the
+ * block's end; the voice steps its frequency with that multiply, so a
+ * gliding note costs what a held one does. Both ends come from the glide's
+ * progress, so the ramp is re-anchored every block and can't drift, and
+ * the glide time is read every block, so moving it mid-glide takes effect
+ * at once.
+ *
+ *   glide.setTime(0.2f);
+ *   glide.start(targetHz);                        // From wherever it is now
+ *
+ *   auto ramp = glide.advance(n, sampleRate);     // Once per block
+ *   float freq = ramp.frequency;
+ *   for (int i = 0; i < n; ++i)
+ *   {
+ *       osc.setFrequency(freq);
+ *       freq *= ramp.step;
+ *   }
+ *
+ * A glide that ends inside a block is stretched to the block's end: it
+ * lands at most one block late.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "PitchTables.h"
+
+class PitchGlide
+{
+public:
+    /** Below this, glide is off and notes jump */
+    static constexpr float MIN_SECONDS = 0.001f;
+
+    /** The frequency at a block's first sample, and the factor per sample after it */
+    struct Ramp
+    {
+        float frequency;
+        float step;
+    };
+
+    void setTime(float seconds) { time = std::max(0.0f, seconds); }
+
+    /** Glide from the current frequency to targetHz (jump when glide is off or there's nowhere to glide from) */
+    void start(float targetHz)
+    {
+        target = targetHz;
+        if (time > MIN_SECONDS && current > 0.0f)
+        {
+            fromOctaves = std::log2(current / targetHz);
+            progress = 0.0f;
+        }
+        else
+        {
+            jump(targetHz);
+        }
+    }
+
+    /** Go straight to hz */
+    void jump(float hz)
+    {
+        target = current = hz;
+        fromOctaves = 0.0f;
+        progress = 1.0f;
+    }
+
+    /** The ramp for the next n samples */
+    Ramp advance(int n, float sampleRate)
+    {
+        if (progress >= 1.0f || time <= MIN_SECONDS)
+        {
+            progress = 1.0f;
+            current = target;
+            return {target, 1.0f};
+        }
+
+        const PitchTables& pitch = PitchTables::get();
+        const float from = target * pitch.octavesToRatio(fromOctaves * (1.0f - progress));
+        const float startProgress = progress;
+        progress = std::min(1.0f, progress + static_cast<float>(n) / (time * sampleRate));
+        current = target * pitch.octavesToRatio(fromOctaves * (1.0f - progress));
+        return {from, std::exp2(fromOctaves * (startProgress - progress) / static_cast<float>(n))};
+    }
+
+    /** Where the glide is (as of the last block's end) */
+    float getFrequency() const { return current; }
+    bool isGliding() const { return progress < 1.0f; }
+
+private:
+    float time = 0.0f;         // Seconds
+    float target = 0.0f;       // Hz
+    float current = 0.0f;      // Hz, 0 before the first note
+    float fromOctaves = 0.0f;  // Start relative to target: log2(start / target)
+    float progress = 1.0f;     // 0-1 through the glide
+};
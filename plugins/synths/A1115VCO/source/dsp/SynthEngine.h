@@ -4,6 +4,11 @@
  *
  * Manages 4-voice polyphony with voice stealing.
  * Based on Doepfer A-111-5 architecture with VCO, VCF, VCA, dual LFOs, and ADSR.
+ *
+ * Mono mode plays voice 0 alone, legato between held keys (the newest
+ * sounds, a release falls back to the one before). Once any poly voices
+ * have finished it renders voice 0 straight into the output, without the
+ * mix buffers or the active list (renderMono()).
  */
 
 #pragma once
@@ -11,6 +16,12 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
+#include "ActiveVoiceList.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
 
 /**
  * @brief Main synthesizer engine
@@ -32,10 +43,14 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
 
+        // Its keys leave out the sample rate
+        sharedFilter.clear();
         for (auto& voice : voices)
         {
             voice.prepare(sampleRate);
+            voice.setSharedFilter(&sharedFilter);
         }
 
         std::fill(mixBufferL.begin(), mixBufferL.end(), 0.0f);
@@ -51,9 +66,25 @@ public:
     // MIDI Handling
     //==========================================================================
 
+    /**
+     * @brief Retune: note frequencies from @p table from the next note on
+     *
+     * Copies the table (128 floats: fine on the audio thread). A 12-TET
+     * table puts the voices back on PitchTables.
+     */
+    void setTuning(const TuningTable& table)
+    {
+        tuning = table;
+        for (auto& voice : voices)
+            voice.setTuning(tuning.isEqualTemperament() ? nullptr : &tuning);
+    }
+
+    const TuningTable& getTuning() const { return tuning; }
+
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        (void)sampleOffset;
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -61,13 +92,21 @@ public:
             return;
         }
 
+        // Keys the tuning leaves unmapped are silent
+        if (!tuning.isMapped(note))
+            return;
+
         if (monoMode)
         {
-            // Mono mode: always use voice 0, track held notes
+            // Mono mode: always use voice 0, track held notes (newest last)
             bool isLegato = numHeldNotes > 0;  // Legato if we already have held notes
-            heldNotes[numHeldNotes++ % 16] = note;
+            forgetHeldNote(note);  // A key pressed again moves to the top
+            if (numHeldNotes == static_cast<int>(heldNotes.size()))
+                forgetHeldNote(heldNotes[0]);  // Full: the oldest key is forgotten
+            heldNotes[static_cast<size_t>(numHeldNotes++)] = note;
             applyParametersToVoice(voices[0]);
             voices[0].noteOn(note, velocity, isLegato);
+            active.add(0);
         }
         else
         {
@@ -77,28 +116,19 @@ public:
             {
                 applyParametersToVoice(*voice);
                 voice->noteOn(note, velocity);
+                active.add(static_cast<int>(voice - voices.data()));
             }
         }
     }
 
     void noteOff(int note, int sampleOffset = 0)
     {
-        (void)sampleOffset;
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
         if (monoMode)
         {
-            // Remove note from held notes
-            for (int i = 0; i < numHeldNotes; ++i)
-            {
-                if (heldNotes[i] == note)
-                {
-                    // Shift remaining notes
-                    for (int j = i; j < numHeldNotes - 1; ++j)
-                        heldNotes[j] = heldNotes[j + 1];
-                    --numHeldNotes;
-                    break;
-                }
-            }
+            forgetHeldNote(note);
 
             // If there are still held notes, glide to the last one (legato)
             if (numHeldNotes > 0)
@@ -106,6 +136,7 @@ public:
                 int lastNote = heldNotes[numHeldNotes - 1];
                 applyParametersToVoice(voices[0]);
                 voices[0].noteOn(lastNote, voices[0].getVelocity(), true);  // true = legato
+                active.add(0);
             }
             else
             {
@@ -116,9 +147,10 @@ public:
         else
         {
             // Poly mode: release matching voice
-            for (auto& voice : voices)
+            for (int v : active)
             {
-                if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
+                Voice& voice = voices[v];
+                if (voice.getNote() == note && !voice.isReleasing())
                 {
                     voice.noteOff();
                 }
@@ -126,16 +158,23 @@ public:
         }
     }
 
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voices[v].kill();
         }
+        active.clear();
     }
 
-    void setPitchBend(float bend)
+    void setPitchBend(float bend, int sampleOffset = 0)
     {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend}))
+            return;
+
         pitchBend = bend;
     }
 
@@ -145,24 +184,20 @@ public:
 
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
+        perfStats.beginBlock();
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
             {
-                applyParametersToVoice(voice);
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+                renderVoices(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
 
-        float gain = masterGain;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            outputL[i] = mixBufferL[static_cast<size_t>(i)] * gain;
-            outputR[i] = mixBufferR[static_cast<size_t>(i)] * gain;
-        }
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
     //==========================================================================
@@ -228,34 +263,186 @@ public:
     void setSustain(float level) { sustain = level; }
     void setRelease(float seconds) { release = seconds; }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // VCO
+        if (p.changed(kOscWaveform)) setWaveform(p.index(kOscWaveform));
+        if (p.changed(kOscTune)) setTune(p[kOscTune]);
+        if (p.changed(kOscFine)) setFine(p[kOscFine]);
+        if (p.changed(kPulseWidth)) setPulseWidth(p[kPulseWidth]);
+        if (p.changed(kSubLevel)) setSubLevel(p[kSubLevel]);
+        if (p.changed(kGlideTime)) setGlideTime(p[kGlideTime]);
+        if (p.changed(kMonoMode)) setMonoMode(p.flag(kMonoMode));
+        if (p.changed(kVcoFMSource)) setVCOFMSource(p.index(kVcoFMSource));
+        if (p.changed(kVcoFMAmount)) setVCOFMAmount(p[kVcoFMAmount]);
+        if (p.changed(kVcoPWMSource)) setVCOPWMSource(p.index(kVcoPWMSource));
+        if (p.changed(kVcoPWMAmount)) setVCOPWMAmount(p[kVcoPWMAmount]);
+
+        // VCF
+        if (p.changed(kVcfCutoff)) setVCFCutoff(p[kVcfCutoff]);
+        if (p.changed(kVcfResonance)) setVCFResonance(p[kVcfResonance]);
+        if (p.changed(kVcfTracking)) setVCFTracking(p.index(kVcfTracking));
+        if (p.changed(kVcfModSource)) setVCFModSource(p.index(kVcfModSource));
+        if (p.changed(kVcfModAmount)) setVCFModAmount(p[kVcfModAmount]);
+        if (p.changed(kVcfLFMAmount)) setVCFLFMAmount(p[kVcfLFMAmount]);
+
+        // VCA
+        if (p.changed(kVcaModSource)) setVCAModSource(p.index(kVcaModSource));
+        if (p.changed(kVcaInitialLevel)) setVCAInitialLevel(p[kVcaInitialLevel]);
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+
+        // LFO1
+        if (p.changed(kLfo1Frequency)) setLFO1Frequency(p[kLfo1Frequency]);
+        if (p.changed(kLfo1Waveform)) setLFO1Waveform(p.index(kLfo1Waveform));
+        if (p.changed(kLfo1Range)) setLFO1Range(p.index(kLfo1Range));
+
+        // LFO2
+        if (p.changed(kLfo2Frequency)) setLFO2Frequency(p[kLfo2Frequency]);
+        if (p.changed(kLfo2Waveform)) setLFO2Waveform(p.index(kLfo2Waveform));
+        if (p.changed(kLfo2Range)) setLFO2Range(p.index(kLfo2Range));
+
+        // ADSR
+        if (p.changed(kAmpAttack)) setAttack(p[kAmpAttack]);
+        if (p.changed(kAmpDecay)) setDecay(p[kAmpDecay]);
+        if (p.changed(kAmpSustain)) setSustain(p[kAmpSustain]);
+        if (p.changed(kAmpRelease)) setRelease(p[kAmpRelease]);
+    }
+
     //==========================================================================
     // State Queries
     //==========================================================================
 
-    int getActiveVoiceCount() const
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
     {
-        int count = 0;
-        for (const auto& voice : voices)
+        MemoryReport report(sizeof(*this));
+        report.addInline("voices", sizeof(voices));
+        report.addInline("mix buffers", sizeof(mixBufferL) + sizeof(mixBufferR));
+        report.addShared("pitch tables", sizeof(PitchTables));
+        return report;
+    }
+
+private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** Render one sub-block between MIDI events */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
+    {
+        // Poly voices still releasing after a switch to mono take the mixing path
+        if (monoMode && (active.isEmpty() || (active.size() == 1 && active.contains(0))))
         {
-            if (voice.isActive())
-                ++count;
+            renderMono(outputL, outputR, numSamples);
+            return;
+        }
+
+        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
+        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+            active.update([&](int v)
+            {
+                Voice& voice = voices[v];
+                applyParametersToVoice(voice);
+                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+                return voice.isActive();
+            });
+        }
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+            float gain = masterGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] = mixBufferL[static_cast<size_t>(i)] * gain;
+                outputR[i] = mixBufferR[static_cast<size_t>(i)] * gain;
+            }
+        }
+    }
+
+    /**
+     * @brief renderVoices() with voice 0 the only one sounding
+     *
+     * The voice adds into the cleared output and the gain goes on in place:
+     * the same samples as mixing, without the mix buffers' fill and copy.
+     */
+    void renderMono(float* outputL, float* outputR, int numSamples)
+    {
+        std::fill(outputL, outputL + numSamples, 0.0f);
+        std::fill(outputR, outputR + numSamples, 0.0f);
+        if (active.isEmpty())
+            return;
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+            Voice& voice = voices[0];
+            applyParametersToVoice(voice);
+            voice.render(outputL, outputR, numSamples);
+            if (!voice.isActive())
+                active.clear();
+        }
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+            const float gain = masterGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] *= gain;
+                outputR[i] *= gain;
+            }
+        }
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value); break;
+        default: break;
         }
-        return count;
     }
 
-private:
     //==========================================================================
     // Voice Management
     //==========================================================================
 
+    /** Take @p note off the mono held-note stack, if it's there */
+    void forgetHeldNote(int note)
+    {
+        const auto held = heldNotes.begin() + numHeldNotes;
+        const auto it = std::find(heldNotes.begin(), held, note);
+        if (it != held)
+        {
+            std::copy(it + 1, held, it);
+            --numHeldNotes;
+        }
+    }
+
     Voice* findFreeVoice(int /* note */)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
+        // First, any voice not on the active list
+        if (!active.isFull())
         {
-            if (!voice.isActive())
+            for (int v = 0; v < MAX_VOICES; ++v)
             {
-                return &voice;
+                if (!active.contains(v))
+                    return &voices[v];
             }
         }
 
@@ -348,6 +535,15 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** Note frequencies the voices read at note on (see TuningTable.h) */
+    TuningTable tuning;
+
+    /** Static-filter coefficients for every voice on the same cutoff and resonance */
+    Voice::SharedFilter sharedFilter;
+
+    /** The voices sounding, the only ones rendered, released or counted */
+    ActiveVoiceList<MAX_VOICES> active;
+
     //==========================================================================
     // Mix Buffers
     //==========================================================================
@@ -364,7 +560,13 @@ private:
     float pitchBend = 0.0f;
     float masterGain = 0.8f;
 
-    // Mono mode note tracking
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
+    // Mono mode note tracking: held keys, oldest first
     std::array<int, 16> heldNotes{};
     int numHeldNotes = 0;
 
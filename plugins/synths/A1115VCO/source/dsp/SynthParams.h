@@ -0,0 +1,66 @@
+/**
+ * @file SynthParams.h
+ * @brief A1115VCO parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(OscWaveform,     "osc_waveform") \
+    X(OscTune,         "osc_tune") \
+    X(OscFine,         "osc_fine") \
+    X(PulseWidth,      "pulse_width") \
+    X(SubLevel,        "sub_level") \
+    X(GlideTime,       "glide_time") \
+    X(MonoMode,        "mono_mode") \
+    X(VcoFMSource,     "vco_fm_source") \
+    X(VcoFMAmount,     "vco_fm_amount") \
+    X(VcoPWMSource,    "vco_pwm_source") \
+    X(VcoPWMAmount,    "vco_pwm_amount") \
+    X(VcfCutoff,       "vcf_cutoff") \
+    X(VcfResonance,    "vcf_resonance") \
+    X(VcfTracking,     "vcf_tracking") \
+    X(VcfModSource,    "vcf_mod_source") \
+    X(VcfModAmount,    "vcf_mod_amount") \
+    X(VcfLFMAmount,    "vcf_lfm_amount") \
+    X(VcaModSource,    "vca_mod_source") \
+    X(VcaInitialLevel, "vca_initial_level") \
+    X(MasterLevel,     "master_level") \
+    X(Lfo1Frequency,   "lfo1_frequency") \
+    X(Lfo1Waveform,    "lfo1_waveform") \
+    X(Lfo1Range,       "lfo1_range") \
+    X(Lfo2Frequency,   "lfo2_frequency") \
+    X(Lfo2Waveform,    "lfo2_waveform") \
+    X(Lfo2Range,       "lfo2_range") \
+    X(AmpAttack,       "amp_attack") \
+    X(AmpDecay,        "amp_decay") \
+    X(AmpSustain,      "amp_sustain") \
+    X(AmpRelease,      "amp_release")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
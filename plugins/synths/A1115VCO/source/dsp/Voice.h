@@ -12,6 +12,19 @@
  *
  * Signal Flow (per A-111-5 diagram):
  *   VCO (with LFO1 FM, LFO2 PWM) -> VCF (with LFO2/ADSR mod) -> VCA (with ADSR, LFO1 AM) -> Output
+ *
+ * The VCF is sst's CytomicSVF lowpass, and its coefficients move at the
+ * block rate wherever the cutoff does:
+ *
+ * - Nothing moving the cutoff: set once per block from the engine's
+ *   SharedFilter cache, so voices on the same cutoff (no key tracking)
+ *   work out the tan only once between them.
+ * - The ADSR or a slow LFO2 on it: worked out once per block, from the
+ *   modulation as the last block left it, and interpolated across the
+ *   block sample by sample (a block, under a millisecond, behind).
+ * - Audio-rate modulation - the triangle's linear FM, or LFO2 in its
+ *   high range - can't be caught between block boundaries, so only then
+ *   are the coefficients worked out every sample.
  */
 
 #pragma once
@@ -20,9 +33,14 @@
 #include <array>
 #include <algorithm>
 
-// Pi constant
-static constexpr float PI_F = 3.14159265359f;
-static constexpr float TWO_PI_F = 6.28318530718f;
+#include "sst/filters/CytomicSVF.h"
+
+#include "CoefficientCache.h"
+#include "FastMath.h"
+#include "LFO.h"
+#include "PitchGlide.h"
+#include "PitchTables.h"
+#include "TuningTable.h"
 
 /**
  * @brief Waveform types for the main oscillator
@@ -108,131 +126,61 @@ enum class VCFTracking
 };
 
 /**
- * @brief Simple LFO class
+ * @brief An LFO (LFO.h) set the A-111-5 way: a range and a 0-1 knob, or off
+ *
+ * The rate is worked out when the knob or the range moves, not per sample.
  */
-class LFO
+class RangedLFO
 {
 public:
-    void prepare(double sr) { sampleRate = sr; }
-
-    void setFrequency(float freq) { frequency = freq; }
-    void setWaveform(LFOWaveform wf) { waveform = wf; }
-    void setRange(LFORange r) { range = r; }
-
-    // Get frequency adjusted for range
-    float getActualFrequency() const
+    void prepare(double sr)
     {
-        float minFreq, maxFreq;
-        switch (range)
-        {
-            case LFORange::Low:    minFreq = 0.05f; maxFreq = 5.0f; break;
-            case LFORange::Medium: minFreq = 0.5f;  maxFreq = 50.0f; break;
-            case LFORange::High:   minFreq = 5.0f;  maxFreq = 5000.0f; break;
-            default:               minFreq = 0.05f; maxFreq = 5.0f; break;
-        }
-        return minFreq + frequency * (maxFreq - minFreq);
+        lfo.prepare(sr);
+        setWaveform(waveform);
+        updateRate();
     }
 
-    float process()
+    void setFrequency(float freq)  // 0-1 normalized within the range
     {
-        if (waveform == LFOWaveform::Off)
-            return 0.0f;
-
-        float actualFreq = getActualFrequency();
-        float phaseInc = actualFreq / static_cast<float>(sampleRate);
-
-        float output = 0.0f;
-        switch (waveform)
-        {
-            case LFOWaveform::Triangle:
-                // Triangle: -1 to +1
-                output = 4.0f * std::abs(phase - 0.5f) - 1.0f;
-                break;
-
-            case LFOWaveform::Pulse:
-                // Square/Pulse: -1 or +1
-                output = phase < 0.5f ? 1.0f : -1.0f;
-                break;
-
-            default:
-                output = 0.0f;
-                break;
-        }
-
-        phase += phaseInc;
-        if (phase >= 1.0f)
-            phase -= 1.0f;
-
-        return output;
+        frequency = freq;
+        updateRate();
     }
 
-    void reset() { phase = 0.0f; }
-
-private:
-    double sampleRate = 44100.0;
-    float frequency = 0.5f;  // 0-1 normalized within range
-    float phase = 0.0f;
-    LFOWaveform waveform = LFOWaveform::Triangle;
-    LFORange range = LFORange::Low;
-};
-
-/**
- * @brief Simple state-variable filter (SVF) for VCF section
- * More versatile than pure ladder, commonly used in Doepfer modules
- */
-class SVFilter
-{
-public:
-    void prepare(double sr) { sampleRate = sr; }
-
-    void setCutoff(float freq)
+    void setWaveform(LFOWaveform wf)
     {
-        cutoffFreq = std::clamp(freq, 20.0f, 20000.0f);
-        updateCoefficients();
+        waveform = wf;
+        lfo.setWaveform(wf == LFOWaveform::Pulse ? LFO::Waveform::Square : LFO::Waveform::Triangle);
     }
 
-    void setResonance(float res)
+    void setRange(LFORange r)
     {
-        resonance = std::clamp(res, 0.0f, 1.0f);
-        updateCoefficients();
+        range = r;
+        updateRate();
     }
 
-    float processLowpass(float input)
-    {
-        // State-variable filter
-        float hp = input - low - q * band;
-        band += f * hp;
-        low += f * band;
-        return low;
-    }
+    float process() { return waveform == LFOWaveform::Off ? 0.0f : lfo.process(); }
 
-    void reset()
-    {
-        low = 0.0f;
-        band = 0.0f;
-    }
+    /** True if it can run fast enough to matter between one sample and the next */
+    bool isAudioRate() const { return waveform != LFOWaveform::Off && range == LFORange::High; }
 
 private:
-    void updateCoefficients()
+    void updateRate()
     {
-        // Compute filter coefficient (simplified)
-        f = 2.0f * std::sin(PI_F * cutoffFreq / static_cast<float>(sampleRate));
-        f = std::clamp(f, 0.0f, 1.0f);
-
-        // Q from resonance (0-1 maps to Q of 0.5 to 20)
-        float qVal = 0.5f + resonance * 19.5f;
-        q = 1.0f / qVal;
+        float minFreq, maxFreq;
+        switch (range)
+        {
+            case LFORange::Medium: minFreq = 0.5f;  maxFreq = 50.0f; break;
+            case LFORange::High:   minFreq = 5.0f;  maxFreq = 5000.0f; break;
+            case LFORange::Low:
+            default:               minFreq = 0.05f; maxFreq = 5.0f; break;
+        }
+        lfo.setRate(minFreq + frequency * (maxFreq - minFreq));
     }
 
-    double sampleRate = 44100.0;
-    float cutoffFreq = 1000.0f;
-    float resonance = 0.0f;
-
-    // Filter state
-    float low = 0.0f;
-    float band = 0.0f;
-    float f = 0.1f;
-    float q = 2.0f;
+    LFO lfo;
+    float frequency = 0.5f;
+    LFOWaveform waveform = LFOWaveform::Triangle;
+    LFORange range = LFORange::Low;
 };
 
 /**
@@ -259,13 +207,20 @@ public:
 
         lfo1.prepare(sr);
         lfo2.prepare(sr);
-        filter.prepare(sr);
+
+        // Every coefficient and ramp defined before the first block picks a path
+        filter.init();
+        filter.setCoeff(FilterMode::Lowpass, vcfCutoff, 0.0f, 1.0f / static_cast<float>(sr));
+        filter.retainCoeffForBlock<BLOCK_SIZE>();
     }
 
     //==========================================================================
     // Note Events
     //==========================================================================
 
+    /** Note frequencies from @p table (nullptr: 12-TET from PitchTables); the engine owns it */
+    void setTuning(const TuningTable* table) { tuning = table; }
+
     void noteOn(int note, float vel, bool legato = false)
     {
         currentNote = note;
@@ -274,25 +229,10 @@ public:
         age = 0;
 
         // Calculate target frequency
-        float targetFrequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        float targetFrequency = noteToFrequency(note);
 
-        // Handle glide
-        if (glideTime > 0.001f && baseFrequency > 0.0f)
-        {
-            // Glide from current frequency to target
-            glideStartFreq = currentFrequency > 0.0f ? currentFrequency : targetFrequency;
-            glideTargetFreq = targetFrequency;
-            glideProgress = 0.0f;
-        }
-        else
-        {
-            // No glide - jump to target
-            glideStartFreq = targetFrequency;
-            glideTargetFreq = targetFrequency;
-            glideProgress = 1.0f;
-            currentFrequency = targetFrequency;
-        }
-        baseFrequency = targetFrequency;
+        // Glide from the current frequency to target (or jump, with glide off)
+        glide.start(targetFrequency);
 
         // For legato notes in mono mode when not in release, don't reset anything - just change pitch
         if (legato && monoMode && active && envStage != EnvStage::Release && envStage != EnvStage::Idle)
@@ -325,7 +265,7 @@ public:
         // This prevents clicks on fast retriggering
 
         // Reset filter
-        filter.reset();
+        filter.init();
     }
 
     void noteOff()
@@ -385,7 +325,7 @@ public:
     void setFine(float cents) { fineOffset = cents; }
     void setPulseWidth(float pw) { pulseWidth = std::clamp(pw, 0.05f, 0.95f); }
     void setSubLevel(float level) { subLevel = std::clamp(level, 0.0f, 1.0f); }
-    void setGlideTime(float seconds) { glideTime = std::max(0.0f, seconds); }
+    void setGlideTime(float seconds) { glide.setTime(seconds); }
     void setMonoMode(bool mono) { monoMode = mono; }
 
     // VCO modulation
@@ -398,6 +338,12 @@ public:
     // VCF Parameter Setters
     //==========================================================================
 
+    /** Coefficients by (cutoff, resonance), shared by one engine's voices */
+    using SharedFilter = CoefficientCache<sst::filters::CytomicSVF, 4>;
+
+    /** Take a static filter's coefficients from @p cache (nullptr: work them out here) */
+    void setSharedFilter(SharedFilter* cache) { sharedFilter = cache; }
+
     void setVCFCutoff(float freq) { vcfCutoff = std::clamp(freq, 20.0f, 20000.0f); }
     void setVCFResonance(float res) { vcfResonance = std::clamp(res, 0.0f, 1.0f); }
     void setVCFTracking(int track) { vcfTracking = static_cast<VCFTracking>(std::clamp(track, 0, 2)); }
@@ -435,6 +381,14 @@ public:
     void setRelease(float seconds) { releaseTime = std::max(0.001f, seconds); }
 
 private:
+    /** The note's frequency in the current tuning */
+    float noteToFrequency(int note) const
+    {
+        return tuning != nullptr ? tuning->frequency(note) : PitchTables::get().midiToFrequency(static_cast<float>(note));
+    }
+
+    const TuningTable* tuning = nullptr;  // The engine's, when it isn't 12-TET
+
     //==========================================================================
     // Envelope Stages
     //==========================================================================
@@ -452,15 +406,215 @@ private:
     // Block Rendering
     //==========================================================================
 
+    /** How the cutoff moves within a block, which decides how often the coefficients are worked out */
+    enum class CutoffMotion
+    {
+        Static,     // Once per block, from the shared cache
+        Ramped,     // Once per block, interpolated across it
+        AudioRate   // Every sample
+    };
+
+    using FilterMode = sst::filters::CytomicSVF::Mode;
+
+    /** The knob's 0-1 as CytomicSVF's: Q from 0.5 to 20, as the panel's range */
+    static constexpr float RESONANCE_SCALE = 0.975f;
+
+    /**
+     * @brief One block's modulation routing, as weights
+     *
+     * Each source/destination pair gets a weight, zero when it isn't
+     * routed, so the kernels mix sources with multiply-adds instead of
+     * switching on the source enums per sample.
+     */
+    struct Routing
+    {
+        float semitones = 0.0f;   // Tune + fine
+        float fmLfo1 = 0.0f;      // Semitones per unit
+        float fmEnv = 0.0f;
+        float pwLfo2 = 0.0f;      // Pulse width per unit
+        float pwEnv = 0.0f;
+        float cutoffBase = 0.0f;  // Hz: cutoff + key tracking (+ inverted envelope's offset)
+        float cutoffLfo2 = 0.0f;
+        float cutoffEnv = 0.0f;
+        float cutoffTri = 0.0f;   // Linear FM from the VCO triangle
+        float vcaBase = 0.0f;
+        float vcaLfo1 = 0.0f;
+        float vcaEnv = 0.0f;
+        bool pitchMod = false;    // Any per-sample pitch movement besides glide
+        CutoffMotion cutoff = CutoffMotion::Static;
+    };
+
+    Routing makeRouting() const
+    {
+        Routing r;
+        r.semitones = tuneOffset + fineOffset / 100.0f;
+
+        // VCO FM: up to 24 semitones at full amount
+        if (vcoFMSource == VCOFMSource::LFO1)
+            r.fmLfo1 = vcoFMAmount * 24.0f;
+        else if (vcoFMSource == VCOFMSource::ADSR)
+            r.fmEnv = vcoFMAmount * 24.0f;
+
+        // VCO PWM
+        if (vcoPWMSource == VCOPWMSource::LFO2)
+            r.pwLfo2 = vcoPWMAmount * 0.4f;
+        else if (vcoPWMSource == VCOPWMSource::ADSR)
+            r.pwEnv = vcoPWMAmount * 0.4f;
+
+        // Key tracking
+        r.cutoffBase = vcfCutoff;
+        if (vcfTracking == VCFTracking::Half)
+            r.cutoffBase += (currentNote - 60) * 50.0f;   // ~50Hz per semitone from middle C
+        else if (vcfTracking == VCFTracking::Full)
+            r.cutoffBase += (currentNote - 60) * 100.0f;  // ~100Hz per semitone
+
+        // Exponential FM modulation; a negative envelope amount inverts it
+        if (vcfModSource == VCFModSource::LFO2)
+        {
+            r.cutoffLfo2 = vcfModAmount * 5000.0f;
+        }
+        else if (vcfModSource == VCFModSource::ADSR)
+        {
+            if (vcfModAmount >= 0.0f)
+            {
+                r.cutoffEnv = vcfModAmount * 10000.0f;
+            }
+            else
+            {
+                r.cutoffBase += std::abs(vcfModAmount) * 10000.0f;
+                r.cutoffEnv = -std::abs(vcfModAmount) * 10000.0f;
+            }
+        }
+        r.cutoffTri = vcfLFMAmount * 2000.0f;
+
+        // VCA: initial level alone (drones), LFO1 tremolo around it, or the ADSR
+        if (vcaModSource == VCAModSource::LFO1)
+        {
+            r.vcaBase = vcaInitialLevel * 0.5f;
+            r.vcaLfo1 = vcaInitialLevel * 0.5f;
+        }
+        else if (vcaModSource == VCAModSource::ADSR)
+        {
+            r.vcaEnv = 1.0f;
+        }
+        else
+        {
+            r.vcaBase = vcaInitialLevel;
+        }
+
+        r.pitchMod = r.fmLfo1 != 0.0f || r.fmEnv != 0.0f;
+        if (r.cutoffTri != 0.0f || (r.cutoffLfo2 != 0.0f && lfo2.isAudioRate()))
+            r.cutoff = CutoffMotion::AudioRate;
+        else if (r.cutoffLfo2 != 0.0f || r.cutoffEnv != 0.0f)
+            r.cutoff = CutoffMotion::Ramped;
+        return r;
+    }
+
+    using Kernel = void (Voice::*)(float*, float*, int, const Routing&);
+
+    /** The kernel for this waveform and routing, from a table of every combination */
+    static Kernel selectKernel(Waveform wave, const Routing& r)
+    {
+        using enum CutoffMotion;
+        static constexpr Kernel kernels[3][2][3] = {
+            {{&Voice::renderKernel<Waveform::Triangle, false, Static>, &Voice::renderKernel<Waveform::Triangle, false, Ramped>,
+              &Voice::renderKernel<Waveform::Triangle, false, AudioRate>},
+             {&Voice::renderKernel<Waveform::Triangle, true, Static>, &Voice::renderKernel<Waveform::Triangle, true, Ramped>,
+              &Voice::renderKernel<Waveform::Triangle, true, AudioRate>}},
+            {{&Voice::renderKernel<Waveform::Saw, false, Static>, &Voice::renderKernel<Waveform::Saw, false, Ramped>,
+              &Voice::renderKernel<Waveform::Saw, false, AudioRate>},
+             {&Voice::renderKernel<Waveform::Saw, true, Static>, &Voice::renderKernel<Waveform::Saw, true, Ramped>,
+              &Voice::renderKernel<Waveform::Saw, true, AudioRate>}},
+            {{&Voice::renderKernel<Waveform::Pulse, false, Static>, &Voice::renderKernel<Waveform::Pulse, false, Ramped>,
+              &Voice::renderKernel<Waveform::Pulse, false, AudioRate>},
+             {&Voice::renderKernel<Waveform::Pulse, true, Static>, &Voice::renderKernel<Waveform::Pulse, true, Ramped>,
+              &Voice::renderKernel<Waveform::Pulse, true, AudioRate>}}};
+        return kernels[static_cast<int>(wave)][r.pitchMod][static_cast<int>(r.cutoff)];
+    }
+
+    /** Coefficients for a cutoff that holds for the block, from the shared cache when there is one */
+    void setStaticFilter(float cutoff, float res)
+    {
+        const float srInv = 1.0f / static_cast<float>(sampleRate);
+        if (sharedFilter == nullptr)
+        {
+            filter.setCoeff(FilterMode::Lowpass, cutoff, res, srInv);
+            filter.retainCoeffForBlock<BLOCK_SIZE>();
+            return;
+        }
+
+        // fetchCoeffs() copies the ramps too: the shared ones are zero
+        filter.fetchCoeffs(sharedFilter->get(cutoff, res, 0.0f, [&](sst::filters::CytomicSVF& out) {
+            out.setCoeff(FilterMode::Lowpass, cutoff, res, srInv);
+            out.retainCoeffForBlock<BLOCK_SIZE>();
+        }));
+    }
+
+    /** Interpolate from the current coefficients to @p cutoff's over the next @p blockSize samples */
+    void rampFilter(float cutoff, float res, int blockSize)
+    {
+        filter.setCoeffForBlock<BLOCK_SIZE>(FilterMode::Lowpass, cutoff, res, 1.0f / static_cast<float>(sampleRate));
+
+        // A short block (the tail of a split) still arrives; a lowpass's m's don't move
+        if (blockSize != BLOCK_SIZE)
+        {
+            const auto stretch = SIMD_MM(set1_ps)(static_cast<float>(BLOCK_SIZE) / static_cast<float>(blockSize));
+            filter.da1 = SIMD_MM(mul_ps)(filter.da1, stretch);
+            filter.da2 = SIMD_MM(mul_ps)(filter.da2, stretch);
+            filter.da3 = SIMD_MM(mul_ps)(filter.da3, stretch);
+        }
+    }
+
+    /**
+     * Routing is resolved once per block: the waveform and whether pitch and
+     * cutoff move per sample pick a kernel, and the rest become weights.
+     */
     void renderBlock(float* outputL, float* outputR, int blockSize)
     {
+        const Routing routing = makeRouting();
+        (this->*selectKernel(waveform, routing))(outputL, outputR, blockSize, routing);
+    }
+
+    /**
+     * @brief The per-sample loop for one waveform and routing
+     *
+     * Without pitch modulation the tuning ratio is worked out once per
+     * block; the filter's coefficients are as often as CUTOFF says.
+     */
+    template <Waveform WAVE, bool PITCH_MOD, CutoffMotion CUTOFF>
+    void renderKernel(float* outputL, float* outputR, int blockSize, const Routing& r)
+    {
+        const PitchTables& pitch = PitchTables::get();
+        const float sr = static_cast<float>(sampleRate);
+        const float tuneRatio = pitch.semitonesToRatio(r.semitones);
+
+        // Glide: the note's frequency, stepped by one multiply per sample
+        const PitchGlide::Ramp glideRamp = glide.advance(blockSize, sr);
+        float noteFrequency = glideRamp.frequency;
+
+        const float res = vcfResonance * RESONANCE_SCALE;
+        if constexpr (CUTOFF == CutoffMotion::Static)
+        {
+            setStaticFilter(std::clamp(r.cutoffBase, 20.0f, 20000.0f), res);
+        }
+        else if constexpr (CUTOFF == CutoffMotion::Ramped)
+        {
+            const float target = r.cutoffBase + lfo2Value * r.cutoffLfo2 + envLevel * r.cutoffEnv;
+            rampFilter(std::clamp(target, 20.0f, 20000.0f), res, blockSize);
+        }
+        else
+        {
+            filter.retainCoeffForBlock<BLOCK_SIZE>();
+        }
+        float lfo2Out = lfo2Value;
+
         for (int i = 0; i < blockSize; ++i)
         {
             // ================================================================
             // LFO PROCESSING
             // ================================================================
             float lfo1Out = lfo1.process();
-            float lfo2Out = lfo2.process();
+            lfo2Out = lfo2.process();
 
             // ================================================================
             // ENVELOPE PROCESSING
@@ -471,85 +625,39 @@ private:
             if (envOut <= 0.0f && envStage == EnvStage::Idle)
             {
                 active = false;
+                lfo2Value = lfo2Out;
                 return;
             }
 
-            // ================================================================
-            // GLIDE PROCESSING
-            // ================================================================
-            if (glideProgress < 1.0f && glideTime > 0.001f)
-            {
-                float glideIncrement = 1.0f / (glideTime * static_cast<float>(sampleRate));
-                glideProgress = std::min(1.0f, glideProgress + glideIncrement);
-                // Exponential glide for more musical feel
-                currentFrequency = glideStartFreq * std::pow(glideTargetFreq / glideStartFreq, glideProgress);
-            }
-            else
-            {
-                currentFrequency = glideTargetFreq;
-            }
-
             // ================================================================
             // VCO FREQUENCY MODULATION
             // ================================================================
-            float fmMod = 0.0f;
-            switch (vcoFMSource)
-            {
-                case VCOFMSource::LFO1:
-                    fmMod = lfo1Out * vcoFMAmount;
-                    break;
-                case VCOFMSource::ADSR:
-                    fmMod = envOut * vcoFMAmount;
-                    break;
-                default:
-                    break;
-            }
-
-            // Calculate frequency with tuning and FM (use currentFrequency for glide)
-            // FM modulation in semitones (up to 24 semitones at full amount)
-            float tunedFreq = currentFrequency * std::pow(2.0f,
-                (tuneOffset + fineOffset / 100.0f + fmMod * 24.0f) / 12.0f);
-            float phaseInc = tunedFreq / static_cast<float>(sampleRate);
-
-            // ================================================================
-            // VCO PULSE WIDTH MODULATION
-            // ================================================================
-            float modulatedPW = pulseWidth;
-            switch (vcoPWMSource)
-            {
-                case VCOPWMSource::LFO2:
-                    modulatedPW = pulseWidth + lfo2Out * vcoPWMAmount * 0.4f;
-                    break;
-                case VCOPWMSource::ADSR:
-                    modulatedPW = pulseWidth + envOut * vcoPWMAmount * 0.4f;
-                    break;
-                default:
-                    break;
-            }
-            modulatedPW = std::clamp(modulatedPW, 0.05f, 0.95f);
+            float ratio = tuneRatio;
+            if constexpr (PITCH_MOD)
+                ratio = pitch.semitonesToRatio(r.semitones + lfo1Out * r.fmLfo1 + envOut * r.fmEnv);
+            float phaseInc = noteFrequency * ratio / sr;
+            noteFrequency *= glideRamp.step;
 
             // ================================================================
             // VCO WAVEFORM GENERATION
             // ================================================================
-            float oscOut = 0.0f;
-            float triOut = 0.0f;  // Always compute triangle for VCF linear FM
 
-            // Triangle (always computed for linear FM)
-            triOut = 4.0f * std::abs(phase - 0.5f) - 1.0f;
+            // Triangle (also the VCF's linear FM source)
+            const float triOut = 4.0f * std::abs(phase - 0.5f) - 1.0f;
 
-            switch (waveform)
+            float oscOut;
+            if constexpr (WAVE == Waveform::Triangle)
             {
-                case Waveform::Triangle:
-                    oscOut = triOut;
-                    break;
-
-                case Waveform::Saw:
-                    oscOut = polyBlepSaw(phase, phaseInc);
-                    break;
-
-                case Waveform::Pulse:
-                    oscOut = polyBlepPulse(phase, phaseInc, modulatedPW);
-                    break;
+                oscOut = triOut;
+            }
+            else if constexpr (WAVE == Waveform::Saw)
+            {
+                oscOut = polyBlepSaw(phase, phaseInc);
+            }
+            else
+            {
+                const float modulatedPW = std::clamp(pulseWidth + lfo2Out * r.pwLfo2 + envOut * r.pwEnv, 0.05f, 0.95f);
+                oscOut = polyBlepPulse(phase, phaseInc, modulatedPW);
             }
 
             // Advance phase
@@ -561,7 +669,7 @@ private:
             // SUB OSCILLATOR (one octave down)
             // ================================================================
             float subPhaseInc = phaseInc * 0.5f;  // One octave down
-            float subOut = std::sin(subPhase * TWO_PI_F) * subLevel;
+            float subOut = FastMath::sinCycles(subPhase) * subLevel;
             subPhase += subPhaseInc;
             if (subPhase >= 1.0f)
                 subPhase -= 1.0f;
@@ -572,77 +680,19 @@ private:
             // ================================================================
             // VCF PROCESSING
             // ================================================================
-
-            // Key tracking
-            float trackingMod = 0.0f;
-            switch (vcfTracking)
+            if constexpr (CUTOFF == CutoffMotion::AudioRate)
             {
-                case VCFTracking::Half:
-                    trackingMod = (currentNote - 60) * 50.0f;  // ~50Hz per semitone from middle C
-                    break;
-                case VCFTracking::Full:
-                    trackingMod = (currentNote - 60) * 100.0f;  // ~100Hz per semitone
-                    break;
-                default:
-                    break;
+                float finalCutoff = r.cutoffBase + lfo2Out * r.cutoffLfo2 + envOut * r.cutoffEnv + triOut * r.cutoffTri;
+                filter.setCoeff(FilterMode::Lowpass, std::clamp(finalCutoff, 20.0f, 20000.0f), res, 1.0f / sr);
             }
 
-            // Exponential FM modulation
-            float vcfMod = 0.0f;
-            switch (vcfModSource)
-            {
-                case VCFModSource::LFO2:
-                    vcfMod = lfo2Out * vcfModAmount * 5000.0f;
-                    break;
-                case VCFModSource::ADSR:
-                    if (vcfModAmount >= 0.0f)
-                    {
-                        vcfMod = envOut * vcfModAmount * 10000.0f;
-                    }
-                    else
-                    {
-                        // Negative: inverted envelope
-                        vcfMod = std::abs(vcfModAmount) * (1.0f - envOut) * 10000.0f;
-                    }
-                    break;
-                default:
-                    break;
-            }
-
-            // Linear FM from VCO triangle
-            float vcfLFM = triOut * vcfLFMAmount * 2000.0f;
-
-            // Compute final cutoff
-            float finalCutoff = vcfCutoff + trackingMod + vcfMod + vcfLFM;
-            finalCutoff = std::clamp(finalCutoff, 20.0f, 20000.0f);
-
-            filter.setCutoff(finalCutoff);
-            filter.setResonance(vcfResonance);
-
-            float filteredOut = filter.processLowpass(mixOut);
+            float filteredOut = mixOut;
+            filter.processBlockStep(filteredOut);
 
             // ================================================================
             // VCA PROCESSING
             // ================================================================
-            float vcaGain = vcaInitialLevel;
-
-            switch (vcaModSource)
-            {
-                case VCAModSource::LFO1:
-                    // AM modulation - scale LFO to 0-1 range for tremolo
-                    vcaGain = vcaInitialLevel * (0.5f + 0.5f * lfo1Out);
-                    break;
-                case VCAModSource::ADSR:
-                    vcaGain = envOut;
-                    break;
-                default:
-                    // When off, VCA is controlled only by initial level (for drones)
-                    break;
-            }
-
-            // If ADSR is the source, silence without note
-            if (vcaModSource == VCAModSource::ADSR && envOut <= 0.0f)
-                vcaGain = 0.0f;
+            float vcaGain = r.vcaBase + lfo1Out * r.vcaLfo1 + envOut * r.vcaEnv;
 
             // ================================================================
             // OUTPUT
@@ -651,6 +701,7 @@ private:
             outputL[i] += output;
             outputR[i] += output;
         }
+        lfo2Value = lfo2Out;  // Where the next block's ramp heads from
     }
 
     //==========================================================================
@@ -698,7 +749,7 @@ private:
             case EnvStage::Attack:
             {
                 // Exponential attack
-                float attackCoef = 1.0f - std::exp(-4.0f / (attackTime * static_cast<float>(sampleRate)));
+                float attackCoef = 1.0f - FastMath::exp(-4.0f / (attackTime * static_cast<float>(sampleRate)));
                 envLevel += attackCoef * (1.0f - envLevel);
                 if (envLevel >= 0.999f)
                 {
@@ -711,7 +762,7 @@ private:
             case EnvStage::Decay:
             {
                 // Exponential decay
-                float decayCoef = std::exp(-4.0f / (decayTime * static_cast<float>(sampleRate)));
+                float decayCoef = FastMath::exp(-4.0f / (decayTime * static_cast<float>(sampleRate)));
                 envLevel = sustainLevel + (envLevel - sustainLevel) * decayCoef;
                 if (envLevel <= sustainLevel + 0.001f)
                 {
@@ -728,7 +779,7 @@ private:
             case EnvStage::Release:
             {
                 // Exponential release
-                float releaseCoef = std::exp(-4.0f / (releaseTime * static_cast<float>(sampleRate)));
+                float releaseCoef = FastMath::exp(-4.0f / (releaseTime * static_cast<float>(sampleRate)));
                 envLevel *= releaseCoef;
                 if (envLevel <= 0.001f)
                 {
@@ -763,7 +814,6 @@ private:
     //==========================================================================
 
     double sampleRate = 44100.0;
-    float baseFrequency = 440.0f;
     float phase = 0.0f;
 
     // Envelope state
@@ -771,11 +821,13 @@ private:
     float envLevel = 0.0f;
 
     // LFOs
-    LFO lfo1;
-    LFO lfo2;
+    RangedLFO lfo1;
+    RangedLFO lfo2;
 
     // Filter
-    SVFilter filter;
+    sst::filters::CytomicSVF filter;
+    SharedFilter* sharedFilter = nullptr;  // The engine's
+    float lfo2Value = 0.0f;                // LFO2 at the end of the last block
 
     //==========================================================================
     // VCO Parameters
@@ -789,11 +841,7 @@ private:
     float subPhase = 0.0f;        // Sub oscillator phase
 
     // Glide/Portamento
-    float glideTime = 0.0f;       // Glide time in seconds
-    float glideStartFreq = 0.0f;
-    float glideTargetFreq = 0.0f;
-    float glideProgress = 1.0f;
-    float currentFrequency = 0.0f;
+    PitchGlide glide;
     bool monoMode = false;
 
     // VCO Modulation
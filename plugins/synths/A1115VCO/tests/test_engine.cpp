@@ -14,8 +14,8 @@
 #include <cmath>
 #include <array>
 
-// TODO: Include your synth engine implementation
-// #include "dsp/SynthEngine.h"
+#include "dsp/SynthEngine.h"
+#include "RealtimeGuard.h"
 
 using Catch::Approx;
 
@@ -254,3 +254,96 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // All inline, most of it the two 8192-sample mix buffers
+    constexpr size_t BUDGET = 128u << 10;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    INFO(at48k.toString());
+
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+    REQUIRE(at48k.getHeapBytes() == 0);
+    REQUIRE(reports[1].second.getInstanceBytes() == at48k.getInstanceBytes());
+    CHECK(at48k.getInstanceBytes() <= BUDGET);
+}
+
+TEST_CASE("Mono mode renders its voice straight out, as the mixing path would", "[engine][mono]")
+{
+    constexpr int bufferSize = 512;
+    SynthEngine mono;
+    SynthEngine poly;
+    mono.prepare(48000.0, bufferSize);
+    poly.prepare(48000.0, bufferSize);
+    mono.setMonoMode(true);
+
+    std::array<float, bufferSize> monoL{}, monoR{}, polyL{}, polyR{};
+    const auto renderBoth = [&] {
+        mono.renderBlock(monoL.data(), monoR.data(), bufferSize);
+        poly.renderBlock(polyL.data(), polyR.data(), bufferSize);
+    };
+
+    // One key at a time: both play it on voice 0, sample for sample
+    mono.noteOn(60, 0.8f);
+    poly.noteOn(60, 0.8f);
+    for (int block = 0; block < 40; ++block)
+    {
+        if (block == 20)
+        {
+            mono.noteOff(60);
+            poly.noteOff(60);
+        }
+        renderBoth();
+        REQUIRE(monoL == polyL);
+        REQUIRE(monoR == polyR);
+    }
+
+    SECTION("More keys than the held-note stack keeps")
+    {
+        for (int note = 40; note < 80; ++note)
+        {
+            mono.noteOn(note, 0.8f);
+            mono.renderBlock(monoL.data(), monoR.data(), bufferSize);
+            REQUIRE(mono.getActiveVoiceCount() == 1);
+        }
+        for (int note = 40; note < 80; ++note)
+            mono.noteOff(note);
+
+        // Every key up: the voice releases and leaves the active list
+        for (int block = 0; block < 200 && mono.getActiveVoiceCount() > 0; ++block)
+            mono.renderBlock(monoL.data(), monoR.data(), bufferSize);
+        REQUIRE(mono.getActiveVoiceCount() == 0);
+        mono.renderBlock(monoL.data(), monoR.data(), bufferSize);
+        REQUIRE(isBufferSilent(monoL.data(), bufferSize));
+    }
+}
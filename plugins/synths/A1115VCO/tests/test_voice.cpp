@@ -14,8 +14,7 @@
 #include <cmath>
 #include <array>
 
-// TODO: Include your voice implementation
-// #include "dsp/Voice.h"
+#include "dsp/Voice.h"
 
 using Catch::Approx;
 
@@ -255,3 +254,163 @@ TEST_CASE("Voice envelope behavior", "[voice][envelope]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("Voice routing kernels", "[voice][dsp]")
+{
+    constexpr int blockSize = 512;
+    std::array<float, blockSize> leftBuffer{};
+    std::array<float, blockSize> rightBuffer{};
+
+    SECTION("Every waveform and modulation routing renders finite audio")
+    {
+        for (int wave = 0; wave < 3; ++wave)
+            for (int fm = 0; fm < 3; ++fm)
+                for (int pwm = 0; pwm < 3; ++pwm)
+                    for (int vcf = 0; vcf < 3; ++vcf)
+                        for (int vca = 0; vca < 3; ++vca)
+                        {
+                            Voice voice;
+                            voice.prepare(44100.0);
+                            voice.setWaveform(wave);
+                            voice.setVCOFMSource(fm);
+                            voice.setVCOFMAmount(0.3f);
+                            voice.setVCOPWMSource(pwm);
+                            voice.setVCOPWMAmount(0.5f);
+                            voice.setVCFModSource(vcf);
+                            voice.setVCFModAmount(vcf == 2 ? -0.7f : 0.7f);
+                            voice.setVCFLFMAmount(0.2f);
+                            voice.setVCAModSource(vca);
+                            voice.setVCAInitialLevel(0.8f);
+                            voice.setLFO1Range(2);
+                            voice.setLFO2Range(1);
+                            voice.noteOn(48, 1.0f);
+
+                            float peak = 0.0f;
+                            for (int block = 0; block < 8; ++block)
+                            {
+                                leftBuffer.fill(0.0f);
+                                voice.render(leftBuffer.data(), rightBuffer.data(), blockSize);
+                                REQUIRE(isBufferValid(leftBuffer.data(), blockSize));
+                                for (float x : leftBuffer)
+                                    peak = std::max(peak, std::abs(x));
+                            }
+                            REQUIRE(peak > 0.001f);
+                        }
+    }
+
+    SECTION("Voices sharing a static filter's coefficients sound as they would alone")
+    {
+        auto render = [&](int note, Voice::SharedFilter* shared) {
+            Voice voice;
+            voice.prepare(44100.0);
+            voice.setSharedFilter(shared);
+            voice.setVCFCutoff(1500.0f);
+            voice.setVCFResonance(0.5f);
+            voice.setVCFModSource(0);
+            voice.setVCFLFMAmount(0.0f);
+            voice.noteOn(note, 1.0f);
+
+            std::vector<float> out;
+            for (int block = 0; block < 4; ++block)
+            {
+                leftBuffer.fill(0.0f);
+                voice.render(leftBuffer.data(), rightBuffer.data(), blockSize);
+                out.insert(out.end(), leftBuffer.begin(), leftBuffer.end());
+            }
+            return out;
+        };
+
+        Voice::SharedFilter shared;
+        for (int note : {48, 55, 60})
+            REQUIRE(render(note, &shared) == render(note, nullptr));
+
+        // No key tracking: one cutoff for all three
+        REQUIRE(shared.getMisses() == 1);
+        REQUIRE(shared.getHits() > 0);
+    }
+
+    SECTION("A cutoff ramped at the block rate lands on the static filter's coefficients")
+    {
+        // LFO2 switched off but routed: the ramped kernel, heading for the static cutoff
+        auto render = [&](int modSource) {
+            Voice voice;
+            voice.prepare(44100.0);
+            voice.setVCFCutoff(1500.0f);
+            voice.setVCFResonance(0.6f);
+            voice.setVCFModSource(modSource);
+            voice.setVCFModAmount(0.5f);
+            voice.setVCFLFMAmount(0.0f);
+            voice.setLFO2Waveform(2);
+            voice.setVCAModSource(0);
+            voice.setVCAInitialLevel(0.8f);
+            voice.noteOn(48, 1.0f);
+
+            std::vector<float> out;
+            for (int block = 0; block < 4; ++block)
+            {
+                leftBuffer.fill(0.0f);
+                voice.render(leftBuffer.data(), rightBuffer.data(), blockSize);
+                out.insert(out.end(), leftBuffer.begin(), leftBuffer.end());
+            }
+            return out;
+        };
+
+        REQUIRE(render(1) == render(0));
+    }
+
+    SECTION("Cutoffs above the filter's stable range are held inside it")
+    {
+        Voice voice;
+        voice.prepare(44100.0);
+        voice.setVCFCutoff(20000.0f);
+        voice.setVCFModSource(0);
+        voice.noteOn(60, 1.0f);
+
+        for (int block = 0; block < 20; ++block)
+        {
+            voice.render(leftBuffer.data(), rightBuffer.data(), blockSize);
+            REQUIRE(isBufferValid(leftBuffer.data(), blockSize));
+        }
+    }
+}
+
+TEST_CASE("Pitch glide ramps", "[voice][dsp]")
+{
+    constexpr float sampleRate = 48000.0f;
+    constexpr int blockSize = 32;
+
+    PitchGlide glide;
+    glide.setTime(0.05f);
+    glide.start(220.0f);  // Nothing to glide from: jumps
+    REQUIRE(glide.getFrequency() == Approx(220.0f));
+
+    SECTION("Multiplying by the step follows the exponential curve")
+    {
+        glide.start(440.0f);
+
+        // 0.05 s at 48 kHz: an octave over 2400 samples
+        int n = 0;
+        for (int block = 0; block < 100; ++block)
+        {
+            const auto ramp = glide.advance(blockSize, sampleRate);
+            float freq = ramp.frequency;
+            for (int i = 0; i < blockSize; ++i, ++n)
+            {
+                const double t = std::min(1.0, n / (0.05 * sampleRate));
+                REQUIRE(freq == Approx(220.0 * std::pow(2.0, t)).epsilon(1e-5));
+                freq *= ramp.step;
+            }
+        }
+        REQUIRE_FALSE(glide.isGliding());
+        REQUIRE(glide.getFrequency() == Approx(440.0f));
+    }
+
+    SECTION("Glide off jumps")
+    {
+        glide.setTime(0.0f);
+        glide.start(330.0f);
+        const auto ramp = glide.advance(blockSize, sampleRate);
+        REQUIRE(ramp.frequency == Approx(330.0f));
+        REQUIRE(ramp.step == 1.0f);
+    }
+}
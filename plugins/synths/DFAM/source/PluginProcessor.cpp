@@ -7,6 +7,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -14,13 +15,26 @@
 
 PluginProcessor::PluginProcessor()
     : AudioProcessor(BusesProperties()
-                     .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                     // Optional: the voice before the effects
+                     .withOutput("Voice", juce::AudioChannelSet::stereo(), false))
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
+    // Cache parameter pointers for lock-free audio thread access
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
+
+    // The effects bits getOverrunState() sets, in order
+    overruns.setEffectNames({"saturation", "delay", "reverb", "convolution", "compressor"});
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -355,6 +369,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // Runs the ladder filter and the saturator at 2x / 4x to cut aliasing
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"oversampling", 1},
+        "Oversampling",
+        juce::StringArray{"Off", "2x", "4x"},
+        0  // default to off
+    ));
+
     // =========================================================================
     // EFFECTS - DELAY (clock synced)
     // =========================================================================
@@ -407,6 +429,25 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // Reverb2 (smooth, the original sound) or the FDN (lighter, denser)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"reverb_engine", 1},
+        "Reverb Engine",
+        juce::StringArray{"Reverb2", "FDN"},
+        0  // default to Reverb2
+    ));
+
+    // =========================================================================
+    // EFFECTS - CONVOLUTION (loaded impulse response)
+    // =========================================================================
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"conv_mix", 1},
+        "Convolution Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
     // =========================================================================
     // EFFECTS - COMPRESSOR
     // =========================================================================
@@ -479,196 +520,196 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
-    synthEngine.prepare(sampleRate, samplesPerBlock);
+    // Allocating and clearing the delay and reverb takes a while: do it off the
+    // message thread (see AsyncPrepare.h). Offline renders wait for it.
+    // An offline render can't wait for the delay's lines, so it keeps them
+    const bool lazyEffects = !isNonRealtime();
+    preparer.start([this, sampleRate, samplesPerBlock, lazyEffects] {
+        synthEngine.setLazyEffects(lazyEffects);
+        synthEngine.prepare(sampleRate, samplesPerBlock);
+    }, !isNonRealtime());
+
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
+
+#if SYNTH_TRACE
+    // A new file per prepare, opened in chrome://tracing or ui.perfetto.dev
+    traceDumper.reset();
+    const auto traceFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getNonexistentChildFile("DFAM-trace", ".json");
+    traceDumper = std::make_unique<TraceDumper>(traceFile.getFullPathName().toStdString(), "DFAM");
+    traceDumper->addRing(synthEngine.getTrace(), "audio");
+    traceDumper->start();
+#endif
+}
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+void PluginProcessor::handleAsyncUpdate()
+{
+    // Delay lines asked for or let go (see LazyEffect.h)
+    if (preparer.isReady())
+        synthEngine.serviceEffects();
 }
 
 void PluginProcessor::releaseResources()
 {
+#if SYNTH_TRACE
+    traceDumper.reset();
+#endif
+    preparer.reset();
     synthEngine.releaseResources();
 }
 
+//==============================================================================
+// Impulse Response
+//==============================================================================
+
+void PluginProcessor::loadImpulseResponse(const juce::File& file)
+{
+    {
+        const juce::ScopedLock lock(impulseLock);
+        impulsePath = file.getFullPathName();
+    }
+
+    // Reading, resampling and transforming a long response takes a while:
+    // off the message thread, and the audio crossfades to it when it's done
+    impulseLoader.start([this, file] {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+            return;
+
+        const auto length = static_cast<int>(std::min<juce::int64>(
+            reader->lengthInSamples, static_cast<juce::int64>(Convolver::MAX_SECONDS * reader->sampleRate) + 1));
+        juce::AudioBuffer<float> samples(reader->numChannels > 1 ? 2 : 1, length);
+        if (!reader->read(&samples, 0, length, 0, true, samples.getNumChannels() > 1))
+            return;
+
+        synthEngine.loadImpulse(samples.getReadPointer(0),
+                                samples.getNumChannels() > 1 ? samples.getReadPointer(1) : nullptr,
+                                static_cast<size_t>(length), reader->sampleRate);
+    }, !isNonRealtime());
+}
+
+void PluginProcessor::clearImpulseResponse()
+{
+    {
+        const juce::ScopedLock lock(impulseLock);
+        impulsePath.clear();
+    }
+    impulseLoader.start([this] { synthEngine.clearImpulse(); }, !isNonRealtime());
+}
+
+juce::String PluginProcessor::getImpulseName() const
+{
+    const juce::ScopedLock lock(impulseLock);
+    return impulsePath.isEmpty() ? juce::String() : juce::File(impulsePath).getFileNameWithoutExtension();
+}
+
+//==============================================================================
+// Host Transport
+//==============================================================================
+
+void PluginProcessor::updateTransport()
+{
+    using Transport = sst::basic_blocks::modulators::Transport;
+    transport.status = Transport::STOPPED;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return;
+    const auto position = playHead->getPosition();
+    if (!position)
+        return;
+
+    if (const auto bpm = position->getBpm())
+        transport.tempo = *bpm;
+    if (const auto signature = position->getTimeSignature())
+        transport.signature = {static_cast<uint16_t>(signature->numerator), static_cast<uint16_t>(signature->denominator)};
+    if (const auto barStart = position->getPpqPositionOfLastBarStart())
+        transport.lastBarStartInBeats = *barStart;
+
+    // Without a beat position there is no grid to follow, so count it as stopped
+    if (const auto ppq = position->getPpqPosition())
+    {
+        transport.hostTimeInBeats = *ppq;
+        transport.timeInBeats = *ppq;
+        if (position->getIsPlaying())
+            transport.status |= Transport::PLAYING;
+    }
+    if (position->getIsRecording())
+        transport.status |= Transport::RECORDING;
+    if (position->getIsLooping())
+        transport.status |= Transport::LOOPING;
+}
+
 //==============================================================================
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    // The engine may still be preparing on another thread
+    OverrunLog::EngineState state;
+    if (!preparer.isReady())
+        return state;
+
+    state.qualityTier = static_cast<int>(synthEngine.getQualityTier());
+
+    // Bits in the order of the names given in the constructor
+    if (params[kSatMix] > 0.0f)
+        state.effects |= 1u << 0;
+    if (params[kDelayMix] > 0.0f)
+        state.effects |= 1u << 1;
+    if (params[kReverbMix] > 0.0f)
+        state.effects |= 1u << 2;
+    if (params[kConvMix] > 0.0f)
+        state.effects |= 1u << 3;
+    if (params[kCompMix] > 0.0f)
+        state.effects |= 1u << 4;
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
+    // Silent until the engine has been prepared
+    if (!preparer.isReady())
+        return;
+
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Helper to convert clock divider index to multiplier value
-    // Musical divisions including triplets, quintuplets, etc.
-    // Slow -> Fast: 1/16, 1/12, 1/8, 1/6, 1/5, 1/4, 1/3, 1/2, 1x, 3/2, 2x, 3x, 4x, 5x, 6x, 8x, 12x, 16x
-    static const float clockDividerValues[] = {
-        0.0625f,    // 1/16 (4 bars)
-        0.0833333f, // 1/12 (3 bars)
-        0.125f,     // 1/8 (2 bars)
-        0.1666667f, // 1/6 (1.5 bars)
-        0.2f,       // 1/5
-        0.25f,      // 1/4 (1 bar)
-        0.3333333f, // 1/3
-        0.5f,       // 1/2 (half note)
-        1.0f,       // 1x (quarter note)
-        1.5f,       // 3/2 (dotted quarter)
-        2.0f,       // 2x (8th note)
-        3.0f,       // 3x (8th triplet)
-        4.0f,       // 4x (16th note)
-        5.0f,       // 5x (16th quintuplet)
-        6.0f,       // 6x (16th triplet)
-        8.0f,       // 8x (32nd note)
-        12.0f,      // 12x (32nd triplet)
-        16.0f       // 16x (64th note)
-    };
-    auto getClockDivider = [&](int index) {
-        return clockDividerValues[std::clamp(index, 0, 17)];
-    };
-
-    // Read parameters
-    float tempo = *apvts.getRawParameterValue("tempo");
-    bool running = *apvts.getRawParameterValue("running") > 0.5f;
-    int clockDividerIdx = static_cast<int>(*apvts.getRawParameterValue("clock_divider"));
-
-    float vco1Freq = *apvts.getRawParameterValue("vco1_freq");
-    int vco1Wave = static_cast<int>(*apvts.getRawParameterValue("vco1_wave"));
-    float vco1Level = *apvts.getRawParameterValue("vco1_level");
-
-    float vco2Freq = *apvts.getRawParameterValue("vco2_freq");
-    int vco2Wave = static_cast<int>(*apvts.getRawParameterValue("vco2_wave"));
-    float vco2Level = *apvts.getRawParameterValue("vco2_level");
-
-    float fmAmount = *apvts.getRawParameterValue("fm_amount");
-    float noiseLevel = *apvts.getRawParameterValue("noise_level");
-    float pitchToNoise = *apvts.getRawParameterValue("pitch_to_noise");
-    float pitchToDecay = *apvts.getRawParameterValue("pitch_to_decay");
-
-    float filterCutoff = *apvts.getRawParameterValue("filter_cutoff");
-    float filterReso = *apvts.getRawParameterValue("filter_reso");
-    float filterEnvAmount = *apvts.getRawParameterValue("filter_env_amount");
-
-    float pitchEnvAttack = *apvts.getRawParameterValue("pitch_env_attack");
-    float pitchEnvDecay = *apvts.getRawParameterValue("pitch_env_decay");
-    float pitchEnvAmount = *apvts.getRawParameterValue("pitch_env_amount");
-
-    float vcfVcaAttack = *apvts.getRawParameterValue("vcf_vca_attack");
-    float vcfVcaDecay = *apvts.getRawParameterValue("vcf_vca_decay");
-
-    float masterVolume = *apvts.getRawParameterValue("master_volume");
-
-    // Update synth engine parameters
-    synthEngine.setTempo(tempo);
-    synthEngine.setClockDivider(getClockDivider(clockDividerIdx));
-    synthEngine.setRunning(running);
-
-    synthEngine.setVCO1Frequency(vco1Freq);
-    synthEngine.setVCO1Waveform(vco1Wave);
-    synthEngine.setVCO1Level(vco1Level);
-
-    synthEngine.setVCO2Frequency(vco2Freq);
-    synthEngine.setVCO2Waveform(vco2Wave);
-    synthEngine.setVCO2Level(vco2Level);
-
-    synthEngine.setFMAmount(fmAmount);
-    synthEngine.setNoiseLevel(noiseLevel);
-    synthEngine.setPitchToNoiseAmount(pitchToNoise);
-    synthEngine.setPitchToDecayAmount(pitchToDecay);
-
-    synthEngine.setFilterCutoff(filterCutoff);
-    synthEngine.setFilterResonance(filterReso);
-    synthEngine.setFilterEnvAmount(filterEnvAmount);
-
-    synthEngine.setPitchEnvAttack(pitchEnvAttack);
-    synthEngine.setPitchEnvDecay(pitchEnvDecay);
-    synthEngine.setPitchEnvAmount(pitchEnvAmount);
-
-    synthEngine.setVCFVCAEnvAttack(vcfVcaAttack);
-    synthEngine.setVCFVCAEnvDecay(vcfVcaDecay);
-
-    synthEngine.setMasterVolume(masterVolume);
-
-    // Update sequencer steps
-    for (int i = 0; i < 8; ++i)
-    {
-        float pitch = *apvts.getRawParameterValue("seq_pitch_" + juce::String(i));
-        float velocity = *apvts.getRawParameterValue("seq_vel_" + juce::String(i));
-        synthEngine.setStepPitch(i, pitch);
-        synthEngine.setStepVelocity(i, velocity);
-    }
-
-    // Update LFO parameters (clock synced)
-    int pitchLfoRateIdx = static_cast<int>(*apvts.getRawParameterValue("pitch_lfo_rate"));
-    float pitchLfoAmount = *apvts.getRawParameterValue("pitch_lfo_amount");
-    int velLfoRateIdx = static_cast<int>(*apvts.getRawParameterValue("vel_lfo_rate"));
-    float velLfoAmount = *apvts.getRawParameterValue("vel_lfo_amount");
+    // Update synth engine parameters (only the ones that changed)
+    params.update();
 
-    synthEngine.setPitchLfoClockSync(getClockDivider(pitchLfoRateIdx));
-    synthEngine.setPitchLfoAmount(pitchLfoAmount);
-    synthEngine.setVelocityLfoClockSync(getClockDivider(velLfoRateIdx));
-    synthEngine.setVelocityLfoAmount(velLfoAmount);
+    // The sequencer follows the host's tempo and beat grid while it plays
+    updateTransport();
+    synthEngine.setTransport(transport);
+    synthEngine.applySnapshot(params);
 
-    // Update per-step LFO enables
-    for (int i = 0; i < 8; ++i)
-    {
-        bool pitchLfoEn = *apvts.getRawParameterValue("pitch_lfo_en_" + juce::String(i)) > 0.5f;
-        bool velLfoEn = *apvts.getRawParameterValue("vel_lfo_en_" + juce::String(i)) > 0.5f;
-        synthEngine.setStepPitchLfoEnabled(i, pitchLfoEn);
-        synthEngine.setStepVelocityLfoEnabled(i, velLfoEn);
-    }
+    // Oversampling delays the output: keep the host's delay compensation in step
+    if (const int latency = synthEngine.getLatencySamples(); latency != getLatencySamples())
+        setLatencySamples(latency);
 
-    // Update filter LFO (clock synced)
-    int filterLfoRateIdx = static_cast<int>(*apvts.getRawParameterValue("filter_lfo_rate"));
-    float filterLfoAmount = *apvts.getRawParameterValue("filter_lfo_amount");
-    synthEngine.setFilterLfoClockSync(getClockDivider(filterLfoRateIdx));
-    synthEngine.setFilterLfoAmount(filterLfoAmount);
-
-    // Update filter mode
-    int filterMode = static_cast<int>(*apvts.getRawParameterValue("filter_mode"));
-    synthEngine.setFilterMode(filterMode);
-
-    // Update effects - Saturator
-    float satDrive = *apvts.getRawParameterValue("sat_drive");
-    float satMix = *apvts.getRawParameterValue("sat_mix");
-    synthEngine.setSaturatorDrive(satDrive);
-    synthEngine.setSaturatorMix(satMix);
-
-    // Update effects - Delay (clock synced)
-    int delayTimeIdx = static_cast<int>(*apvts.getRawParameterValue("delay_time"));
-    float delayFeedback = *apvts.getRawParameterValue("delay_feedback");
-    float delayMix = *apvts.getRawParameterValue("delay_mix");
-    synthEngine.setDelayClockSync(getClockDivider(delayTimeIdx));
-    synthEngine.setDelayFeedback(delayFeedback);
-    synthEngine.setDelayMix(delayMix);
-
-    // Update effects - Reverb
-    float reverbDecay = *apvts.getRawParameterValue("reverb_decay");
-    float reverbDamping = *apvts.getRawParameterValue("reverb_damping");
-    float reverbMix = *apvts.getRawParameterValue("reverb_mix");
-    synthEngine.setReverbDecay(reverbDecay);
-    synthEngine.setReverbDamping(reverbDamping);
-    synthEngine.setReverbMix(reverbMix);
-
-    // Update effects - Compressor
-    float compThreshold = *apvts.getRawParameterValue("comp_threshold");
-    float compRatio = *apvts.getRawParameterValue("comp_ratio");
-    float compAttack = *apvts.getRawParameterValue("comp_attack");
-    float compRelease = *apvts.getRawParameterValue("comp_release");
-    float compMakeup = *apvts.getRawParameterValue("comp_makeup");
-    float compMix = *apvts.getRawParameterValue("comp_mix");
-    synthEngine.setCompThreshold(compThreshold);
-    synthEngine.setCompRatio(compRatio);
-    synthEngine.setCompAttack(compAttack);
-    synthEngine.setCompRelease(compRelease);
-    synthEngine.setCompMakeup(compMakeup);
-    synthEngine.setCompMix(compMix);
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages (for manual triggering)
     for (const auto metadata : midiMessages)
@@ -688,15 +729,51 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
     }
 
-    // Render audio
-    synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
-
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
+    // Render audio, and the dry voice too if its bus is enabled
+    float* voiceL = nullptr;
+    float* voiceR = nullptr;
+    const auto* voiceBus = getBus(false, 1);
+    if (voiceBus != nullptr && voiceBus->isEnabled() && voiceBus->getNumberOfChannels() == 2)
     {
-        visualizationBuffer[i] = leftChannel[i];
+        auto voiceBuffer = getBusBuffer(buffer, false, 1);
+        voiceL = voiceBuffer.getWritePointer(0);
+        voiceR = voiceBuffer.getWritePointer(1);
     }
+    synthEngine.renderBlock(leftChannel, rightChannel, voiceL, voiceR, numSamples);
+
+    // Nothing audible and nothing ringing: mark the buffer cleared so hosts
+    // and wrappers that check hasBeenCleared() can skip it
+    if (synthEngine.isSilent())
+        buffer.clear();
+
+    // The delay switched on wants its lines, or long off let them go
+    if (synthEngine.needsEffectService())
+        triggerAsyncUpdate();
+
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+
+    // The editor reads the sequencer from here, never from the engine
+    sequencerState.write() = synthEngine.getSequencerState();
+    sequencerState.publish();
+}
+
+//==============================================================================
+// Bus Layout
+//==============================================================================
+
+bool PluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Stereo main out; the voice bus stereo or off
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    if (layouts.outputBuses.size() < 2)
+        return true;
+
+    const auto& voice = layouts.getChannelSet(false, 1);
+    return voice.isDisabled() || voice == juce::AudioChannelSet::stereo();
 }
 
 //==============================================================================
@@ -712,20 +789,66 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 // State Save/Load
 //==============================================================================
 
+// The impulse response's path (UTF-8), if one is loaded
+static constexpr uint32_t IMPULSE_CHUNK = PluginState::tag("IMPR");
+
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    juce::String path;
+    {
+        const juce::ScopedLock lock(impulseLock);
+        path = impulsePath;
+    }
+    if (path.isNotEmpty())
+        state.addChunk(IMPULSE_CHUNK, path.toRawUTF8(), path.getNumBytesAsUTF8());
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    juce::String savedImpulse;
+    PluginState::read(data, size, saved.collector(),
+        [&savedImpulse](uint32_t chunkTag, const uint8_t* chunk, size_t chunkSize) {
+            if (chunkTag == IMPULSE_CHUNK)
+                savedImpulse = juce::String::fromUTF8(reinterpret_cast<const char*>(chunk), static_cast<int>(chunkSize));
+        });
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
+
+    // The response is saved by path: one that's gone is left out
+    if (const juce::File impulse(savedImpulse); savedImpulse.isNotEmpty() && impulse.existsAsFile())
+        loadImpulseResponse(impulse);
+    else if (getImpulseName().isNotEmpty())
+        clearImpulseResponse();
 }
 
 //==============================================================================
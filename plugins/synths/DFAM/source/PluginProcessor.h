@@ -15,6 +15,15 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
+#include "StatePublisher.h"
+#include "AsyncPrepare.h"
+
+#if SYNTH_TRACE
+#include "TraceDumper.h"
+#endif
 
 /**
  * @brief Main audio processor class
@@ -23,7 +32,8 @@
  * Parameters are exposed via AudioProcessorValueTreeState for
  * automation and state persistence.
  */
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor,
+                        private juce::AsyncUpdater
 {
 public:
     PluginProcessor();
@@ -35,6 +45,7 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -63,11 +74,29 @@ public:
     /** Audio parameter value tree state - use for UI binding */
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+
+    /** On-screen keyboard notes for processBlock() (pushed on the message thread) */
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
+
+    /** The sequencer as of the newest block (editor timer only; see core/dsp/StatePublisher.h) */
+    SynthEngine::SequencerState getSequencerState() { return sequencerState.read(); }
 
-    /** Get current sequencer state for UI */
-    SynthEngine::SequencerState getSequencerState() const { return synthEngine.getSequencerState(); }
+    /** Read @p file and hand it to the convolver, on a background thread; saved with the state */
+    void loadImpulseResponse(const juce::File& file);
+
+    /** Drop the impulse response */
+    void clearImpulseResponse();
+
+    /** The loaded response's file name, empty if none */
+    juce::String getImpulseName() const;
 
 private:
     /** Create the parameter layout - called once in constructor */
@@ -80,14 +109,39 @@ private:
     /** The synth engine that handles all audio processing */
     SynthEngine synthEngine;
 
+    /** Runs synthEngine.prepare() off the message thread; silence until it's done */
+    AsyncPrepare preparer;
+
+    /** Reads impulse responses into the engine off the message thread (see AsyncPrepare.h) */
+    AsyncPrepare impulseLoader;
+
+    /** File the impulse response came from, for the state; empty if none */
+    juce::String impulsePath;
+    juce::CriticalSection impulseLock;
+
+#if SYNTH_TRACE
+    /** Writes the engine's timeline to <temp>/DFAM-trace*.json while prepared */
+    std::unique_ptr<TraceDumper> traceDumper;
+#endif
+
     //==========================================================================
-    // Cached Parameters (for lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // TODO: Add cached parameter pointers
-    // Example:
-    // std::atomic<float>* filterCutoffParam = nullptr;
-    // std::atomic<float>* filterResoParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
+
+    /** Sequencer state for the editor, published once per block */
+    StatePublisher<SynthEngine::SequencerState> sequencerState;
+
+    /** The host's transport this block, from the play head (see updateTransport) */
+    sst::basic_blocks::modulators::Transport transport;
+
+    /** Read the play head into transport; stopped if the host gives no beat position */
+    void updateTransport();
+
+    /** Allocates and frees the delay's lines on the message thread (LazyEffect.h) */
+    void handleAsyncUpdate() override;
 
     //==========================================================================
     // State
@@ -96,8 +150,17 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    /** Buffer for UI visualization */
-    std::array<float, 512> visualizationBuffer{};
+    /** Audio thread -> UI oscilloscope samples */
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+
+    /** UI keyboard -> audio thread notes */
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -0,0 +1,205 @@
+/**
+ * @file SSTEffect.h
+ * @brief Host any sst-effects effect (Reverb2, Delay, Chorus, Nimbus...) in an engine
+ *
+ * sst-effects' effects are templates over an FXConfig that supplies their
+ * parameter storage, sample rate, tuning and dB maths (see
+ * sst/effects/EffectCore.h for the full list). SSTEffectConfig is that
+ * adapter, shared by every effect, and SSTEffect wraps one effect in the
+ * interface the engines' own effects have: prepare(), parameter setters and
+ * processBlock() over any number of samples.
+ *
+ *   SSTEffect<sst::effects::reverb2::Reverb2> reverb;
+ *   using R2 = decltype(reverb)::FX;
+ *
+ *   reverb.prepare(sampleRate);                                   // Allocates
+ *   reverb.setParam(R2::rev2_decay_time, std::log2(seconds));     // Effect's units
+ *   reverb.setParam(R2::rev2_mix, 1.0f);                          // Wet only
+ *   reverb.processBlock(left, right, numSamples);                 // In place
+ *
+ * Effects process fixed blocks of SSTEffectConfig::blockSize samples, so
+ * the wrapper queues the input and returns each block once it's full: the
+ * output is exactly LATENCY samples late. Run the effect wet only and mix
+ * the dry signal outside, so the dry path isn't delayed.
+ *
+ * Parameters are in the effect's own units (paramAt(i) describes them);
+ * any not set keep the effect's default.
+ *
+ * @note prepare() allocates (Reverb2 alone is ~14 MB of delay lines) and
+ *       starts from silence. Everything else is real-time safe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "sst/effects/EffectCore.h"
+
+#include "Noise.h"
+
+/**
+ * @brief The FXConfig every SSTEffect uses
+ */
+struct SSTEffectConfig
+{
+    static constexpr int blockSize = 16;
+    static constexpr int MAX_PARAMS = 20;
+
+    struct BaseClass
+    {
+        // The effect reads its parameters from here (floatValueAt)
+        std::array<float, MAX_PARAMS> params{};
+
+        template <typename... Args>
+        BaseClass(Args...) {}
+    };
+
+    struct GlobalStorage
+    {
+        explicit GlobalStorage(double sr) : sampleRate(sr) {}
+
+        double sampleRate;
+        NoiseSource noise{1u};  // Fixed seed: effects render the same every time
+    };
+
+    struct EffectStorage
+    {
+    };
+
+    using ValueStorage = float*;
+    using BiquadAdapter = SSTEffectConfig;
+
+    static float floatValueAt(const BaseClass* const e, const ValueStorage* const, int idx)
+    {
+        return e->params[static_cast<size_t>(idx)];
+    }
+
+    static int intValueAt(const BaseClass* const e, const ValueStorage* const, int idx)
+    {
+        return static_cast<int>(std::round(e->params[static_cast<size_t>(idx)]));
+    }
+
+    static float envelopeRateLinear(GlobalStorage* s, float f)
+    {
+        return static_cast<float>(blockSize / s->sampleRate) * std::pow(2.0f, -f);
+    }
+
+    static float temposyncRatio(GlobalStorage*, EffectStorage*, int) { return 1.0f; }
+    static bool isDeactivated(EffectStorage*, int) { return false; }
+    static bool isExtended(EffectStorage*, int) { return false; }
+
+    static float rand01(GlobalStorage* s) { return s->noise.unif01(); }
+
+    static double sampleRate(GlobalStorage* s) { return s->sampleRate; }
+    static double sampleRateInv(GlobalStorage* s) { return 1.0 / s->sampleRate; }
+
+    static float noteToPitch(GlobalStorage*, float note) { return std::pow(2.0f, note / 12.0f); }
+    static float noteToPitchIgnoringTuning(GlobalStorage* s, float note) { return noteToPitch(s, note); }
+    static float noteToPitchInv(GlobalStorage* s, float note) { return 1.0f / noteToPitch(s, note); }
+
+    static float dbToLinear(GlobalStorage*, float db) { return std::pow(10.0f, db / 20.0f); }
+};
+
+/**
+ * @brief One sst-effects effect, any block size in, LATENCY samples late out
+ */
+template <template <typename> class Effect>
+class SSTEffect
+{
+public:
+    using FX = Effect<SSTEffectConfig>;
+
+    static constexpr int BLOCK = SSTEffectConfig::blockSize;
+    static constexpr int LATENCY = BLOCK;
+
+    static_assert(FX::numParams <= SSTEffectConfig::MAX_PARAMS);
+
+    SSTEffect() { values.fill(std::numeric_limits<float>::quiet_NaN()); }
+
+    /** Build the effect at this rate, silent, with the parameters set so far */
+    void prepare(double sampleRate)
+    {
+        global.sampleRate = sampleRate;
+
+        // The effects' buffers are fixed-size members, so a re-prepare builds
+        // the new one in the old one's memory rather than allocating again
+        if (effect)
+        {
+            std::destroy_at(effect.get());
+            std::construct_at(effect.get(), &global, &storage, nullptr);
+        }
+        else
+        {
+            effect = std::make_unique<FX>(&global, &storage, nullptr);
+        }
+        for (int i = 0; i < FX::numParams; ++i)
+        {
+            const float v = values[static_cast<size_t>(i)];
+            effect->params[static_cast<size_t>(i)] = std::isnan(v) ? effect->paramAt(i).defaultVal : v;
+        }
+        effect->initialize();
+
+        queueL.fill(0.0f);
+        queueR.fill(0.0f);
+        filled = 0;
+    }
+
+    bool isPrepared() const { return effect != nullptr; }
+
+    /** Set parameter idx (the effect's enum) in the effect's own units */
+    void setParam(int idx, float value)
+    {
+        if (idx < 0 || idx >= FX::numParams)
+            return;
+        values[static_cast<size_t>(idx)] = value;
+        if (effect)
+            effect->params[static_cast<size_t>(idx)] = value;
+    }
+
+    /** Process in place; the output trails the input by LATENCY samples */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        if (!effect)
+            return;
+
+        // The queue holds the last processed block's output from 'filled'
+        // on: hand that out and take the new input in its place
+        while (numSamples > 0)
+        {
+            const int n = std::min(numSamples, BLOCK - filled);
+            std::swap_ranges(left, left + n, queueL.begin() + filled);
+            std::swap_ranges(right, right + n, queueR.begin() + filled);
+            left += n;
+            right += n;
+            numSamples -= n;
+
+            filled += n;
+            if (filled == BLOCK)
+            {
+                effect->processBlock(queueL.data(), queueR.data());
+                filled = 0;
+            }
+        }
+    }
+
+    FX* get() { return effect.get(); }
+
+    /** Bytes of the effect prepare() allocated (0 before the first prepare()) */
+    size_t getHeapBytes() const { return effect ? sizeof(FX) : 0; }
+
+private:
+    SSTEffectConfig::GlobalStorage global{48000.0};
+    SSTEffectConfig::EffectStorage storage;
+    std::unique_ptr<FX> effect;
+
+    std::array<float, SSTEffectConfig::MAX_PARAMS> values{};  // NaN: effect's default
+
+    alignas(16) std::array<float, BLOCK> queueL{};
+    alignas(16) std::array<float, BLOCK> queueR{};
+    int filled = 0;
+};
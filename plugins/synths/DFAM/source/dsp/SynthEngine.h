@@ -9,23 +9,73 @@
  * - Noise generator
  * - Moog-style ladder filter
  * - 2 AD envelopes (pitch, VCF/VCA)
- * - Internal clock with tempo control
+ * - Internal clock with tempo control, or the host's beat grid while it plays
+ * - Optional 2x / 4x oversampling of the ladder and the saturator
+ * - A dry copy of the voice for a separate output (renderBlock with voiceL/R)
+ * - A convolution stage after the reverb for a loaded impulse response
+ *   (Convolver.h, loadImpulse())
+ *
+ * Between hits the voice is skipped, and each effect sleeps once its input
+ * has been silent for longer than its tail (SilenceGate.h); isSilent()
+ * reports a block with nothing left ringing.
+ *
+ * With setLazyEffects() the delay's lines exist only while its mix is up
+ * (LazyEffect.h); serviceEffects() allocates and frees them off the audio
+ * thread.
+ *
+ * setQualityTier() (QualityTier.h) trades fidelity for speed: draft runs
+ * DPW oscillators, 64-sample control blocks and no oversampling; high
+ * runs 8-sample control blocks and 4x oversampling.
+ *
+ * Steps can lock the cutoff, resonance, filter envelope amount and the
+ * two decays (setStepLock()). Each step's values, the knobs' where it
+ * locks nothing, are kept resolved with the pitch envelope's coefficients
+ * worked out, and redone only when a lock or one of those knobs moves; a
+ * step boundary copies its step's into the voice. A knob reaches the
+ * voice at once unless the step playing locks it.
  */
 
 #pragma once
 
 #include "Voice.h"
+#include "Convolver.h"
+#include "LazyEffect.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "QualityTier.h"
+#include "StepClock.h"
+#include "SynthParams.h"
+#include "TraceRing.h"
+#include "Denormals.h"
+#include <sst/basic-blocks/modulators/Transport.h>
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+
+/** Parameters a step can lock (DFAMSequencer::setStepLock()) */
+enum class StepLock
+{
+    FilterCutoff,     // Hz
+    FilterResonance,  // 0-1
+    FilterEnvAmount,
+    PitchEnvDecay,    // Seconds
+    VcfVcaDecay       // Seconds
+};
 
 /**
  * @brief 8-step sequencer with pitch and velocity per step
+ *
+ * Each step can also lock any of the StepLock parameters to a value of
+ * its own. The locks are sparse: a step without one plays the knob.
  */
 class DFAMSequencer
 {
 public:
     static constexpr int NUM_STEPS = 8;
+    static constexpr int NUM_LOCKS = 5;
+    using LockValues = std::array<float, NUM_LOCKS>;
 
     void reset()
     {
@@ -72,9 +122,56 @@ public:
     float getCurrentVelocity() const { return velocities[currentStep]; }
     int getCurrentStep() const { return currentStep; }
 
+    /** Jump to a step without triggering it (host sync: advance() then plays the next) */
+    void setCurrentStep(int step) { currentStep = ((step % NUM_STEPS) + NUM_STEPS) % NUM_STEPS; }
+
+    /** Lock a parameter on a step; false for a step that isn't there */
+    bool setStepLock(int step, StepLock lock, float value)
+    {
+        if (step < 0 || step >= NUM_STEPS)
+            return false;
+        lockValues[static_cast<size_t>(step)][static_cast<size_t>(lock)] = value;
+        lockMasks[static_cast<size_t>(step)] |= bit(lock);
+        return true;
+    }
+
+    /** Hand a parameter back to its knob on a step; false for a step that isn't there */
+    bool clearStepLock(int step, StepLock lock)
+    {
+        if (step < 0 || step >= NUM_STEPS)
+            return false;
+        lockMasks[static_cast<size_t>(step)] &= static_cast<uint8_t>(~bit(lock));
+        return true;
+    }
+
+    bool isLocked(int step, StepLock lock) const
+    {
+        return step >= 0 && step < NUM_STEPS && (lockMasks[static_cast<size_t>(step)] & bit(lock)) != 0;
+    }
+
+    /** A step's locked value, or 0 if it isn't locked */
+    float getStepLock(int step, StepLock lock) const
+    {
+        return isLocked(step, lock) ? lockValues[static_cast<size_t>(step)][static_cast<size_t>(lock)] : 0.0f;
+    }
+
+    /** What a step plays: its locks over the knobs' values */
+    LockValues resolve(int step, const LockValues& knobs) const
+    {
+        LockValues values = knobs;
+        for (int l = 0; l < NUM_LOCKS; ++l)
+            if (isLocked(step, static_cast<StepLock>(l)))
+                values[static_cast<size_t>(l)] = lockValues[static_cast<size_t>(step)][static_cast<size_t>(l)];
+        return values;
+    }
+
+    static uint8_t bit(StepLock lock) { return static_cast<uint8_t>(1u << static_cast<unsigned>(lock)); }
+
 private:
     std::array<float, NUM_STEPS> pitches = {0, 0, 0, 0, 0, 0, 0, 0};
     std::array<float, NUM_STEPS> velocities = {1, 1, 1, 1, 1, 1, 1, 1};
+    std::array<LockValues, NUM_STEPS> lockValues{};
+    std::array<uint8_t, NUM_STEPS> lockMasks{};  // Bit per StepLock
     int currentStep = 0;
 };
 
@@ -84,6 +181,8 @@ private:
 class SynthEngine
 {
 public:
+    using Transport = sst::basic_blocks::modulators::Transport;
+
     SynthEngine() = default;
     ~SynthEngine() = default;
 
@@ -91,15 +190,21 @@ public:
     {
         sampleRate = sr;
         blockSize = samplesPerBlock;
+        perfStats.prepare(sr);
 
+        voice.setOversampling(tierOversampling());
         voice.prepare(sr);
+        refreshSteps();  // Their decay coefficients are the rate's
         pitchLfo.prepare(sr);
         velocityLfo.prepare(sr);
         filterLfo.prepare(sr);
 
         // Effects
-        delay.prepare(sr);
+        saturatorOversampler.setFactor(tierOversampling());
+        saturatorOversampler.reset();
+        delay.prepare(sr, lazyEffects);
         reverb.prepare(sr);
+        convolver.prepare(sr);
         compressor.prepare(sr);
 
         updateClockRate();
@@ -111,51 +216,41 @@ public:
         running = false;
     }
 
+    /** Fix the noise so renders repeat exactly (default: clock-seeded) */
+    void setNoiseSeed(uint32_t seed) { voice.setNoiseSeed(NoiseSource::deriveSeed(seed, 0)); }
+
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        std::fill(outputL, outputL + numSamples, 0.0f);
-        std::fill(outputR, outputR + numSamples, 0.0f);
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            // Advance LFOs (free-running)
-            pitchLfo.process();
-            velocityLfo.process();
-            float filterLfoValue = filterLfo.process();
-
-            // Apply filter LFO modulation
-            float modulatedCutoff = filterCutoffBase + filterLfoValue * filterLfoAmount * 5000.0f;
-            modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
-            voice.setFilterCutoff(modulatedCutoff);
-
-            // Process clock if running
-            if (running)
-            {
-                clockAccumulator += 1.0;
-
-                if (clockAccumulator >= samplesPerStep)
-                {
-                    clockAccumulator -= samplesPerStep;
-                    processSequencerStep();
-                }
-            }
-
-            // Render voice
-            float outL = 0.0f;
-            float outR = 0.0f;
-            voice.render(&outL, &outR, 1);
+        renderBlock(outputL, outputR, nullptr, nullptr, numSamples);
+    }
 
-            // Apply effects chain: Saturator -> Delay -> Reverb -> Compressor
-            outL = saturator.process(outL);
-            outR = saturator.process(outR);
+    /**
+     * @brief Render, also writing the dry voice to a second pair
+     *
+     * For the plugin's optional voice output bus: the voice before the
+     * saturator, delay, reverb and compressor, at the master level, so it
+     * can be processed apart from them. voiceL / voiceR may be null.
+     */
+    void renderBlock(float* outputL, float* outputR, float* voiceL, float* voiceR, int numSamples)
+    {
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-            delay.process(outL, outR);
-            reverb.process(outL, outR);
-            compressor.process(outL, outR);
+        perfStats.beginBlock();
+        TraceRing::Scope blockScope(trace, "render", "renderBlock", numSamples);
+        silentBlock = true;
 
-            outputL[i] = outL * masterGain;
-            outputR[i] = outR * masterGain;
-        }
+        // Split the block at queued MIDI events so triggers land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR, voiceL, voiceR](int start, int count)
+            {
+                renderSamples(outputL + start, outputR + start,
+                              voiceL != nullptr ? voiceL + start : nullptr,
+                              voiceR != nullptr ? voiceR + start : nullptr, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, voice.isActive() ? 1 : 0);
     }
 
     // =========================================================================
@@ -166,10 +261,11 @@ public:
     {
         if (run && !running)
         {
-            clockAccumulator = 0.0;
+            stepClock.reset();
             sequencer.reset();
-            // Trigger first step immediately
-            processSequencerStep();
+            // Trigger first step immediately (following the host, its grid does)
+            if (!hostPlaying)
+                processSequencerStep();
         }
         running = run;
     }
@@ -184,6 +280,26 @@ public:
 
     float getTempo() const { return tempo; }
 
+    /**
+     * @brief Follow the host's transport, from the next applySnapshot()
+     *
+     * While the host plays, its tempo stands in for the tempo knob and each
+     * block lines the step clock and the sequencer up with the host's beat
+     * position, so steps land on the host's grid and a given position
+     * always plays the same step. The run switch still starts and stops the
+     * sequencer. With the host stopped, the knob and the free-running
+     * clock take over again.
+     */
+    void setTransport(const Transport& transport)
+    {
+        const bool playing = (transport.status & Transport::PLAYING) != 0;
+        if (playing != hostPlaying || (playing && transport.tempo != hostTempo))
+            hostTempoChanged = true;
+        hostPlaying = playing;
+        hostTempo = transport.tempo;
+        hostBeats = transport.hostTimeInBeats;
+    }
+
     /**
      * @brief Set sequencer clock divider
      * @param divider Clock divider value (0.0625 = 1/16x to 16 = 16x)
@@ -203,6 +319,35 @@ public:
 
     float getClockDivider() const { return clockDivider; }
 
+    /**
+     * @brief Clock divider value of a clock_divider / *_lfo_rate / delay_time choice
+     * @param index Choice index, slow to fast (see setClockDivider)
+     */
+    static float clockDividerChoice(int index)
+    {
+        static constexpr float values[] = {
+            0.0625f,    // 1/16 (4 bars)
+            0.0833333f, // 1/12 (3 bars)
+            0.125f,     // 1/8 (2 bars)
+            0.1666667f, // 1/6 (1.5 bars)
+            0.2f,       // 1/5
+            0.25f,      // 1/4 (1 bar)
+            0.3333333f, // 1/3
+            0.5f,       // 1/2 (half note)
+            1.0f,       // 1x (quarter note)
+            1.5f,       // 3/2 (dotted quarter)
+            2.0f,       // 2x (8th note)
+            3.0f,       // 3x (8th triplet)
+            4.0f,       // 4x (16th note)
+            5.0f,       // 5x (16th quintuplet)
+            6.0f,       // 6x (16th triplet)
+            8.0f,       // 8x (32nd note)
+            12.0f,      // 12x (32nd triplet)
+            16.0f       // 16x (64th note)
+        };
+        return values[std::clamp(index, 0, 17)];
+    }
+
     // =========================================================================
     // Sequencer Settings
     // =========================================================================
@@ -219,6 +364,23 @@ public:
 
     int getCurrentStep() const { return sequencer.getCurrentStep(); }
 
+    /** Lock a parameter on a step, from the step's next hit */
+    void setStepLock(int step, StepLock lock, float value)
+    {
+        if (sequencer.setStepLock(step, lock, value))
+            refreshStep(step);
+    }
+
+    /** Hand a step's parameter back to its knob, from the step's next hit */
+    void clearStepLock(int step, StepLock lock)
+    {
+        if (sequencer.clearStepLock(step, lock))
+            refreshStep(step);
+    }
+
+    bool isStepLocked(int step, StepLock lock) const { return sequencer.isLocked(step, lock); }
+    float getStepLock(int step, StepLock lock) const { return sequencer.getStepLock(step, lock); }
+
     // =========================================================================
     // VCO Parameters
     // =========================================================================
@@ -243,12 +405,12 @@ public:
     // LFO Parameters (with clock sync support)
     // =========================================================================
 
-    void setPitchLfoRate(float hz) { pitchLfo.setRate(hz); }
+    void setPitchLfoRate(float hz) { pitchLfo.setRate(std::clamp(hz, 0.01f, 20.0f)); }
     void setPitchLfoClockSync(float divider) { pitchLfo.setClockSyncRate(tempo, divider); }
     void setPitchLfoAmount(float semitones) { pitchLfoAmount = semitones; }
     void setPitchLfoWaveform(int w) { pitchLfo.setWaveform(w); }
 
-    void setVelocityLfoRate(float hz) { velocityLfo.setRate(hz); }
+    void setVelocityLfoRate(float hz) { velocityLfo.setRate(std::clamp(hz, 0.01f, 20.0f)); }
     void setVelocityLfoClockSync(float divider) { velocityLfo.setClockSyncRate(tempo, divider); }
     void setVelocityLfoAmount(float amount) { velocityLfoAmount = std::clamp(amount, 0.0f, 1.0f); }
     void setVelocityLfoWaveform(int w) { velocityLfo.setWaveform(w); }
@@ -283,20 +445,16 @@ public:
     // Filter Parameters
     // =========================================================================
 
-    void setFilterCutoff(float freq)
-    {
-        filterCutoffBase = freq;
-        voice.setFilterCutoff(freq);
-    }
-    void setFilterResonance(float res) { voice.setFilterResonance(res); }
-    void setFilterEnvAmount(float amount) { voice.setFilterEnvAmount(amount); }
+    void setFilterCutoff(float freq) { setKnob(StepLock::FilterCutoff, freq); }
+    void setFilterResonance(float res) { setKnob(StepLock::FilterResonance, res); }
+    void setFilterEnvAmount(float amount) { setKnob(StepLock::FilterEnvAmount, amount); }
     void setFilterMode(int mode) { voice.setFilterMode(mode); }
 
     // =========================================================================
     // Filter LFO (with clock sync support)
     // =========================================================================
 
-    void setFilterLfoRate(float hz) { filterLfo.setRate(hz); }
+    void setFilterLfoRate(float hz) { filterLfo.setRate(std::clamp(hz, 0.01f, 20.0f)); }
     void setFilterLfoClockSync(float divider) { filterLfo.setClockSyncRate(tempo, divider); }
     void setFilterLfoAmount(float amount) { filterLfoAmount = std::clamp(amount, 0.0f, 1.0f); }
     void setFilterLfoWaveform(int w) { filterLfo.setWaveform(w); }
@@ -308,14 +466,77 @@ public:
     void setSaturatorDrive(float drive) { saturator.setDrive(drive); }
     void setSaturatorMix(float mix) { saturator.setMix(mix); }
 
+    // =========================================================================
+    // Oversampling (the ladder filter and the saturator)
+    // =========================================================================
+
+    /** 1 (off), 2 or 4, unless the quality tier overrides it; the stages are reset when it changes */
+    void setOversampling(int factor)
+    {
+        oversampling = factor;
+        voice.setOversampling(tierOversampling());
+        saturatorOversampler.setFactor(tierOversampling());
+    }
+
+    /** The factor running, the quality tier's if it overrides the parameter */
+    int getOversampling() const { return saturatorOversampler.getFactor(); }
+
+    /**
+     * @brief Draft, normal or high (see QualityTier.h)
+     *
+     * Draft: DPW oscillators, 64-sample control blocks, no oversampling.
+     * High: 8-sample control blocks, 4x oversampling. Normal leaves the
+     * oversampling to its parameter. The oscillators change at the next
+     * hit, and each oversampler once its stage is silent (the voice
+     * between hits, the saturator after its tail), since a new factor
+     * restarts its filters.
+     */
+    void setQualityTier(QualityTier tier)
+    {
+        quality = tier;
+        voice.setQualityTier(tier);
+        refreshSteps();  // Their decay coefficients are the control block's
+    }
+
+    QualityTier getQualityTier() const { return quality; }
+
+    /**
+     * @brief Samples the output trails the triggers by, for the host's delay compensation
+     *
+     * The sum of every stage in series that delays the signal: the ladder's
+     * oversampler, then the saturator's. The reverb's block latency is on
+     * the wet path only, so it doesn't count. The voice output (see
+     * renderBlock()) is taken before the saturator: it leads by the
+     * saturator's share.
+     */
+    int getLatencySamples() const { return voice.getLatency() + saturatorOversampler.getLatency(); }
+
     // =========================================================================
     // Effects - Delay (with clock sync support)
     // =========================================================================
 
-    void setDelayTime(float seconds) { delay.setTime(seconds); }
-    void setDelayClockSync(float divider) { delay.setClockSyncTime(tempo, divider); }
-    void setDelayFeedback(float fb) { delay.setFeedback(fb); }
-    void setDelayMix(float mix) { delay.setMix(mix); }
+    void setDelayTime(float seconds) { delay->setTime(seconds); }
+    void setDelayClockSync(float divider) { delay->setClockSyncTime(tempo, divider); }
+    void setDelayFeedback(float fb) { delay->setFeedback(fb); }
+    void setDelayMix(float mix)
+    {
+        delay->setMix(mix);
+        delay.setWanted(mix > 0.0f);
+    }
+
+    /**
+     * @brief Keep the delay's lines only while its mix is up (LazyEffect.h)
+     *
+     * Takes effect at the next prepare(); realtime use only, as the delay
+     * is silent for the moment its lines take to arrive.
+     */
+    void setLazyEffects(bool lazy) { lazyEffects = lazy; }
+
+    /** True if serviceEffects() has lines to allocate or free (audio thread, after renderBlock()) */
+    bool needsEffectService() const { return delay.needsService(); }
+
+    /** Allocate the lines the delay asked for and free the ones it let go (not the audio thread) */
+    void serviceEffects() { delay.service(); }
 
     // =========================================================================
     // Effects - Reverb
@@ -325,6 +546,32 @@ public:
     void setReverbDamping(float damping) { reverb.setDamping(damping); }
     void setReverbMix(float mix) { reverb.setMix(mix); }
 
+    /** Reverb::REVERB2 or Reverb::FDN */
+    void setReverbEngine(int engine) { reverb.setEngine(engine); }
+
+    // =========================================================================
+    // Effects - Convolution
+    // =========================================================================
+
+    void setConvMix(float mix) { convolver.setMix(mix); }
+
+    /**
+     * @brief Load an impulse response for the convolver (see Convolver::loadImpulse)
+     *
+     * Resamples and transforms it on the calling thread, so call it from a
+     * background thread; the audio crossfades to it once it's ready.
+     */
+    void loadImpulse(const float* left, const float* right, size_t length, double rate)
+    {
+        convolver.loadImpulse(left, right, length, rate);
+    }
+
+    /** Drop the impulse response (not from the audio thread) */
+    void clearImpulse() { convolver.clearImpulse(); }
+
+    /** Loaded impulse response length at the engine's rate, 0 if none */
+    size_t getImpulseSamples() const { return convolver.getImpulseSamples(); }
+
     // =========================================================================
     // Effects - Compressor
     // =========================================================================
@@ -341,7 +588,7 @@ public:
     // =========================================================================
 
     void setPitchEnvAttack(float t) { voice.setPitchEnvAttack(t); }
-    void setPitchEnvDecay(float t) { voice.setPitchEnvDecay(t); }
+    void setPitchEnvDecay(float t) { setKnob(StepLock::PitchEnvDecay, t); }
     void setPitchEnvAmount(float semitones) { voice.setPitchEnvAmount(semitones); }
 
     // =========================================================================
@@ -349,7 +596,7 @@ public:
     // =========================================================================
 
     void setVCFVCAEnvAttack(float t) { voice.setVCFVCAEnvAttack(t); }
-    void setVCFVCAEnvDecay(float t) { voice.setVCFVCAEnvDecay(t); }
+    void setVCFVCAEnvDecay(float t) { setKnob(StepLock::VcfVcaDecay, t); }
 
     // =========================================================================
     // Master
@@ -360,15 +607,112 @@ public:
         masterGain = std::pow(10.0f, volumeDb / 20.0f);
     }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h). The clock
+     * synced LFO and delay rates are worked out from the tempo when they're
+     * set, so a tempo change (the knob's or the host's) re-applies them too.
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Transport: the host's tempo and position while it plays (setTransport)
+        const bool tempoChanged = p.changed(kTempo) || hostTempoChanged;
+        hostTempoChanged = false;
+        if (tempoChanged) setTempo(hostPlaying ? static_cast<float>(hostTempo) : p[kTempo]);
+        if (p.changed(kClockDivider)) setClockDivider(clockDividerChoice(p.index(kClockDivider)));
+        if (p.changed(kRunning)) setRunning(p.flag(kRunning));
+        if (hostPlaying && running)
+            syncToHost();
+
+        // VCOs
+        if (p.changed(kVco1Freq)) setVCO1Frequency(p[kVco1Freq]);
+        if (p.changed(kVco1Wave)) setVCO1Waveform(p.index(kVco1Wave));
+        if (p.changed(kVco1Level)) setVCO1Level(p[kVco1Level]);
+
+        if (p.changed(kVco2Freq)) setVCO2Frequency(p[kVco2Freq]);
+        if (p.changed(kVco2Wave)) setVCO2Waveform(p.index(kVco2Wave));
+        if (p.changed(kVco2Level)) setVCO2Level(p[kVco2Level]);
+
+        if (p.changed(kFmAmount)) setFMAmount(p[kFmAmount]);
+        if (p.changed(kNoiseLevel)) setNoiseLevel(p[kNoiseLevel]);
+        if (p.changed(kPitchToNoise)) setPitchToNoiseAmount(p[kPitchToNoise]);
+        if (p.changed(kPitchToDecay)) setPitchToDecayAmount(p[kPitchToDecay]);
+
+        // Filter
+        if (p.changed(kFilterCutoff)) setFilterCutoff(p[kFilterCutoff]);
+        if (p.changed(kFilterReso)) setFilterResonance(p[kFilterReso]);
+        if (p.changed(kFilterEnvAmount)) setFilterEnvAmount(p[kFilterEnvAmount]);
+
+        // Envelopes
+        if (p.changed(kPitchEnvAttack)) setPitchEnvAttack(p[kPitchEnvAttack]);
+        if (p.changed(kPitchEnvDecay)) setPitchEnvDecay(p[kPitchEnvDecay]);
+        if (p.changed(kPitchEnvAmount)) setPitchEnvAmount(p[kPitchEnvAmount]);
+
+        if (p.changed(kVcfVcaAttack)) setVCFVCAEnvAttack(p[kVcfVcaAttack]);
+        if (p.changed(kVcfVcaDecay)) setVCFVCAEnvDecay(p[kVcfVcaDecay]);
+
+        if (p.changed(kMasterVolume)) setMasterVolume(p[kMasterVolume]);
+
+        // Sequencer steps
+        for (int i = 0; i < 8; ++i)
+        {
+            if (p.changed(kSeqPitch0 + i)) setStepPitch(i, p[kSeqPitch0 + i]);
+            if (p.changed(kSeqVel0 + i)) setStepVelocity(i, p[kSeqVel0 + i]);
+            if (p.changed(kPitchLfoEn0 + i)) setStepPitchLfoEnabled(i, p.flag(kPitchLfoEn0 + i));
+            if (p.changed(kVelLfoEn0 + i)) setStepVelocityLfoEnabled(i, p.flag(kVelLfoEn0 + i));
+        }
+
+        // LFOs (clock synced)
+        if (p.changed(kPitchLfoRate) || tempoChanged)
+            setPitchLfoClockSync(clockDividerChoice(p.index(kPitchLfoRate)));
+        if (p.changed(kPitchLfoAmount)) setPitchLfoAmount(p[kPitchLfoAmount]);
+        if (p.changed(kVelLfoRate) || tempoChanged)
+            setVelocityLfoClockSync(clockDividerChoice(p.index(kVelLfoRate)));
+        if (p.changed(kVelLfoAmount)) setVelocityLfoAmount(p[kVelLfoAmount]);
+
+        if (p.changed(kFilterLfoRate) || tempoChanged)
+            setFilterLfoClockSync(clockDividerChoice(p.index(kFilterLfoRate)));
+        if (p.changed(kFilterLfoAmount)) setFilterLfoAmount(p[kFilterLfoAmount]);
+
+        if (p.changed(kFilterMode)) setFilterMode(p.index(kFilterMode));
+
+        // Effects
+        if (p.changed(kSatDrive)) setSaturatorDrive(p[kSatDrive]);
+        if (p.changed(kSatMix)) setSaturatorMix(p[kSatMix]);
+
+        // Choice index 0/1/2 -> factor 1/2/4
+        if (p.changed(kOversampling)) setOversampling(1 << std::clamp(p.index(kOversampling), 0, 2));
+
+        if (p.changed(kDelayTime) || tempoChanged) setDelayClockSync(clockDividerChoice(p.index(kDelayTime)));
+        if (p.changed(kDelayFeedback)) setDelayFeedback(p[kDelayFeedback]);
+        if (p.changed(kDelayMix)) setDelayMix(p[kDelayMix]);
+
+        if (p.changed(kReverbDecay)) setReverbDecay(p[kReverbDecay]);
+        if (p.changed(kReverbDamping)) setReverbDamping(p[kReverbDamping]);
+        if (p.changed(kReverbMix)) setReverbMix(p[kReverbMix]);
+        if (p.changed(kReverbEngine)) setReverbEngine(p.index(kReverbEngine));
+        if (p.changed(kConvMix)) setConvMix(p[kConvMix]);
+
+        if (p.changed(kCompThreshold)) setCompThreshold(p[kCompThreshold]);
+        if (p.changed(kCompRatio)) setCompRatio(p[kCompRatio]);
+        if (p.changed(kCompAttack)) setCompAttack(p[kCompAttack]);
+        if (p.changed(kCompRelease)) setCompRelease(p[kCompRelease]);
+        if (p.changed(kCompMakeup)) setCompMakeup(p[kCompMakeup]);
+        if (p.changed(kCompMix)) setCompMix(p[kCompMix]);
+    }
+
     // =========================================================================
     // MIDI (for external triggering)
     // =========================================================================
 
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
+
         // Manual trigger from MIDI
-        float freq = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        float freq = PitchTables::get().midiToFrequency(static_cast<float>(note));
         voice.setVCO1Frequency(freq);
         voice.setVCO2Frequency(freq);
         voice.trigger(velocity);
@@ -376,18 +720,23 @@ public:
 
     void noteOff(int note, int sampleOffset = 0)
     {
-        juce::ignoreUnused(note, sampleOffset);
+        (void)note;
+        (void)sampleOffset;
         // DFAM doesn't have sustain - just AD envelopes
     }
 
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
         running = false;
     }
 
-    void setPitchBend(float bend)
+    void setPitchBend(float bend, int sampleOffset = 0)
     {
-        juce::ignoreUnused(bend);
+        (void)bend;
+        (void)sampleOffset;
     }
 
     // =========================================================================
@@ -415,14 +764,199 @@ public:
         return state;
     }
 
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Render timeline for TraceDumper (see TraceRing.h - empty unless built with SYNTH_TRACE) */
+    TraceRing& getTrace() { return trace; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        report.addInline("voice", sizeof(voice));
+        report.addInline("saturator oversampler", sizeof(saturatorOversampler));
+        report.addInline("trace ring", sizeof(trace));
+        report.addHeap("delay", delay.getHeapBytes());
+        report.addHeap("reverb", reverb.getHeapBytes());
+        report.addHeap("impulse response", convolver.getHeapBytes());
+        report.addShared("pitch tables", sizeof(PitchTables));
+        return report;
+    }
+
+    /** True if the last renderBlock() was all below -120 dB, with no effect tail still running */
+    bool isSilent() const { return silentBlock; }
+
 private:
+    /** Render one sub-block between MIDI events (voiceL / voiceR: dry copy, or null) */
+    void renderSamples(float* outputL, float* outputR, float* voiceL, float* voiceR, int numSamples)
+    {
+        // Voice pass first, then the effects over the whole sub-block. Nothing
+        // feeds back from the effects to the voice, so this is the same as
+        // running the chain per sample, and each half can be timed
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            std::fill(outputL, outputL + numSamples, 0.0f);
+            std::fill(outputR, outputR + numSamples, 0.0f);
+
+            // Spans of up to one control block. The step clock ends each
+            // span before the next step, so triggers stay sample accurate
+            int i = 0;
+            while (i < numSamples)
+            {
+                int n = std::min(voice.getControlBlock(), numSamples - i);
+
+                if (running)
+                {
+                    bool stepped = false;
+                    n = stepClock.next(n, stepped);
+                    if (stepped)
+                    {
+                        // Tagged with the step it moves to
+                        TraceRing::Scope scope(trace, "sequencer", "step",
+                                               (sequencer.getCurrentStep() + 1) % DFAMSequencer::NUM_STEPS);
+                        processSequencerStep();
+                    }
+                }
+
+                // Advance LFOs (free-running)
+                pitchLfo.advance(n);
+                velocityLfo.advance(n);
+                float filterLfoValue = filterLfo.advance(n);
+
+                // Apply filter LFO modulation; the voice glides to it over the span
+                float modulatedCutoff = filterCutoffBase + filterLfoValue * filterLfoAmount * 5000.0f;
+                modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
+                voice.setFilterCutoff(modulatedCutoff);
+
+                // Between hits the VCA is closed: nothing to render
+                if (voice.isActive())
+                {
+                    TraceRing::Scope scope(trace, "voice", "voice", n);
+                    voice.render(outputL + i, outputR + i, n);
+                }
+                else
+                {
+                    voice.skip(n);
+                    if (voice.getOversampling() != tierOversampling())
+                        voice.setOversampling(tierOversampling());
+                }
+                i += n;
+            }
+        }
+
+        if (voiceL != nullptr && voiceR != nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                voiceL[i] = outputL[i] * masterGain;
+                voiceR[i] = outputR[i] * masterGain;
+            }
+        }
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Effects);
+
+            // Effects chain: Saturator -> Delay -> Reverb -> Convolver -> Compressor, each
+            // over the whole sub-block (the saturator oversampled when set).
+            // An effect whose input has been silent for its whole tail is
+            // skipped; one that runs may ring, so the next one hears it
+            bool silent = Silence::isSilent(outputL, outputR, numSamples);
+
+            if (saturatorGate.process(silent, numSamples, saturatorOversampler.getTailSamples()))
+            {
+                TraceRing::Scope scope(trace, "effect", "saturator", numSamples);
+                saturatorOversampler.process(outputL, outputR, numSamples,
+                    [this](float* l, float* r, int n)
+                    {
+                        saturator.processBlock(l, n);
+                        saturator.processBlock(r, n);
+                    });
+                silent = false;
+            }
+            else if (saturatorOversampler.getFactor() != tierOversampling())
+            {
+                saturatorOversampler.setFactor(tierOversampling());
+            }
+
+            // Without its lines the delay passes the input through
+            const bool delayReady = delay.update(numSamples);
+            if (delayGate.process(silent, numSamples, delay->getTailSamples()) && delayReady)
+            {
+                TraceRing::Scope scope(trace, "effect", "delay", numSamples);
+                delay.process(outputL, outputR, numSamples);
+                silent = false;
+            }
+
+            if (reverbGate.process(silent, numSamples, reverb.getTailSamples()))
+            {
+                TraceRing::Scope scope(trace, "effect", "reverb", numSamples);
+                reverb.processBlock(outputL, outputR, numSamples);
+                silent = false;
+            }
+
+            if (convolverGate.process(silent, numSamples, convolver.getTailSamples()))
+            {
+                TraceRing::Scope scope(trace, "effect", "convolver", numSamples);
+                convolver.processBlock(outputL, outputR, numSamples);
+                silent = false;
+            }
+
+            // Silence in is silence out: the compressor's tail is only its
+            // gain recovering, so it never wakes the output
+            if (compressorGate.process(silent, numSamples, compressor.getTailSamples()))
+            {
+                TraceRing::Scope scope(trace, "effect", "compressor", numSamples);
+                compressor.processBlock(outputL, outputR, numSamples);
+            }
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] *= masterGain;
+                outputR[i] *= masterGain;
+            }
+
+            silentBlock = silentBlock && silent;
+        }
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn:
+        {
+            TraceRing::Scope scope(trace, "midi", "noteOn", event.note);
+            noteOn(event.note, event.value);
+            break;
+        }
+        case MidiEvent::Type::AllNotesOff:
+        {
+            TraceRing::Scope scope(trace, "midi", "allNotesOff");
+            allNotesOff();
+            break;
+        }
+        default: break;
+        }
+    }
+
+    /** Step clock and sequencer to the host's position at this block's start */
+    void syncToHost()
+    {
+        const double stepsPerBeat = 4.0 * clockDivider;  // 16th notes * divider, as updateClockRate()
+        const int64_t nextStep = stepClock.syncTo(hostBeats * stepsPerBeat);
+        sequencer.setCurrentStep(static_cast<int>((nextStep - 1) % DFAMSequencer::NUM_STEPS));
+    }
+
     void updateClockRate()
     {
         // Calculate samples per sequencer step
         // At 120 BPM with 16th notes: 120/60 * 4 = 8 steps per second
         // Clock divider multiplies/divides the step rate
         float stepsPerSecond = (tempo / 60.0f) * 4.0f * clockDivider;  // 16th notes * divider
-        samplesPerStep = sampleRate / stepsPerSecond;
+        stepClock.setSamplesPerStep(sampleRate / stepsPerSecond);
     }
 
     void processSequencerStep()
@@ -449,10 +983,91 @@ private:
             modulatedVelocity = std::clamp(modulatedVelocity, 0.0f, 1.0f);
         }
 
+        applyStep(step);
         voice.setPitchOffset(modulatedPitch);
         voice.trigger(modulatedVelocity);
     }
 
+    // =========================================================================
+    // Parameter locks
+    // =========================================================================
+
+    /** A step's values resolved, with what the voice derives from them worked out */
+    struct StepSnapshot
+    {
+        DFAMSequencer::LockValues values{};
+        ADEnvelope::Decay pitchEnvDecay;
+    };
+
+    /** A lockable knob: into every step that doesn't lock it, and the voice unless the step playing does */
+    void setKnob(StepLock lock, float value)
+    {
+        const auto l = static_cast<size_t>(lock);
+        knobs[l] = value;
+
+        const ADEnvelope::Decay decay =
+            lock == StepLock::PitchEnvDecay ? voice.pitchEnvDecayFor(value) : ADEnvelope::Decay{};
+        for (int step = 0; step < DFAMSequencer::NUM_STEPS; ++step)
+        {
+            if (sequencer.isLocked(step, lock))
+                continue;
+            StepSnapshot& snapshot = stepSnapshots[static_cast<size_t>(step)];
+            snapshot.values[l] = value;
+            if (lock == StepLock::PitchEnvDecay)
+                snapshot.pitchEnvDecay = decay;
+        }
+
+        if ((heldLocks & DFAMSequencer::bit(lock)) == 0)
+            applyValue(lock, value, decay);
+    }
+
+    /** Resolve one step again, after its locks changed */
+    void refreshStep(int step)
+    {
+        StepSnapshot& snapshot = stepSnapshots[static_cast<size_t>(step)];
+        snapshot.values = sequencer.resolve(step, knobs);
+        snapshot.pitchEnvDecay =
+            voice.pitchEnvDecayFor(snapshot.values[static_cast<size_t>(StepLock::PitchEnvDecay)]);
+    }
+
+    /** Resolve every step again, after the rate or the control block changed */
+    void refreshSteps()
+    {
+        for (int step = 0; step < DFAMSequencer::NUM_STEPS; ++step)
+            refreshStep(step);
+    }
+
+    /** Put a step's snapshot into the voice: stores only */
+    void applyStep(int step)
+    {
+        const StepSnapshot& snapshot = stepSnapshots[static_cast<size_t>(step)];
+        for (int l = 0; l < DFAMSequencer::NUM_LOCKS; ++l)
+            applyValue(static_cast<StepLock>(l), snapshot.values[static_cast<size_t>(l)], snapshot.pitchEnvDecay);
+
+        heldLocks = 0;
+        for (int l = 0; l < DFAMSequencer::NUM_LOCKS; ++l)
+            if (sequencer.isLocked(step, static_cast<StepLock>(l)))
+                heldLocks |= DFAMSequencer::bit(static_cast<StepLock>(l));
+    }
+
+    void applyValue(StepLock lock, float value, const ADEnvelope::Decay& pitchEnvDecay)
+    {
+        switch (lock)
+        {
+        case StepLock::FilterCutoff:
+            filterCutoffBase = value;  // The filter LFO rides on it
+            voice.setFilterCutoff(value);
+            break;
+        case StepLock::FilterResonance: voice.setFilterResonance(value); break;
+        case StepLock::FilterEnvAmount: voice.setFilterEnvAmount(value); break;
+        case StepLock::PitchEnvDecay: voice.setPitchEnvDecay(pitchEnvDecay); break;
+        case StepLock::VcfVcaDecay: voice.setVCFVCAEnvDecay(value); break;
+        }
+    }
+
+    /** The oversampling for the parameter and the quality tier */
+    int tierOversampling() const { return forTier(quality, 1, oversampling, 4); }
+
     // Audio settings
     double sampleRate = 44100.0;
     int blockSize = 512;
@@ -460,13 +1075,28 @@ private:
     // Voice
     DFAMVoice voice;
 
+    // MIDI events scheduled later in the current block
+    MidiEventQueue eventQueue;
+
+    // Per-block CPU counters, read by the editor
+    PerfStats perfStats;
+
+    // Render and sequencer timeline, drained by the processor's TraceDumper
+    TraceRing trace;
+
     // Sequencer
     DFAMSequencer sequencer;
 
+    // Parameter locks: the lockable knobs (StepLock order, the voice's
+    // defaults), each step resolved, and the locks of the step playing
+    DFAMSequencer::LockValues knobs = {5000.0f, 0.0f, 0.5f, 0.3f, 0.5f};
+    std::array<StepSnapshot, DFAMSequencer::NUM_STEPS> stepSnapshots{};
+    uint8_t heldLocks = 0;
+
     // LFOs
-    SimpleLFO pitchLfo;
-    SimpleLFO velocityLfo;
-    SimpleLFO filterLfo;
+    LFO pitchLfo;
+    LFO velocityLfo;
+    LFO filterLfo;
     float pitchLfoAmount = 12.0f;      // Semitones
     float velocityLfoAmount = 0.5f;    // 0-1 depth
     float filterLfoAmount = 0.5f;      // 0-1 depth
@@ -474,18 +1104,38 @@ private:
     std::array<bool, 8> pitchLfoEnabled = {false, false, false, false, false, false, false, false};
     std::array<bool, 8> velocityLfoEnabled = {false, false, false, false, false, false, false, false};
 
+    // Oversampling parameter and the quality tier that can override it
+    int oversampling = 1;
+    QualityTier quality = QualityTier::Normal;
+
     // Effects chain
     Saturator saturator;
-    StereoDelay delay;
-    AmbisonicReverb reverb;
+    Oversampler saturatorOversampler;
+    LazyEffect<StereoDelay> delay;
+    bool lazyEffects = false;  // Next prepare(): delay lines only while on
+    Reverb reverb;
+    Convolver convolver;
     Compressor compressor;
 
+    // Effect bypass once the input and the tail have died away
+    TailGate saturatorGate;
+    TailGate delayGate;
+    TailGate reverbGate;
+    TailGate convolverGate;
+    TailGate compressorGate;
+    bool silentBlock = true;  // Last renderBlock() was silent
+
     // Transport
     bool running = false;
     float tempo = 120.0f;
     float clockDivider = 1.0f;  // 1/64x to 64x (0.015625 to 64.0)
-    double samplesPerStep = 1000.0;
-    double clockAccumulator = 0.0;
+    StepClock stepClock;
+
+    // Host transport (setTransport)
+    bool hostPlaying = false;
+    bool hostTempoChanged = false;
+    double hostTempo = 120.0;
+    double hostBeats = 0.0;
 
     // Master
     float masterGain = 0.5f;
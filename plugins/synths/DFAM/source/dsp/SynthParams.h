@@ -0,0 +1,114 @@
+/**
+ * @file SynthParams.h
+ * @brief DFAM parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(Tempo,           "tempo") \
+    X(Running,         "running") \
+    X(ClockDivider,    "clock_divider") \
+    X(Vco1Freq,        "vco1_freq") \
+    X(Vco1Wave,        "vco1_wave") \
+    X(Vco1Level,       "vco1_level") \
+    X(Vco2Freq,        "vco2_freq") \
+    X(Vco2Wave,        "vco2_wave") \
+    X(Vco2Level,       "vco2_level") \
+    X(FmAmount,        "fm_amount") \
+    X(NoiseLevel,      "noise_level") \
+    X(PitchToNoise,    "pitch_to_noise") \
+    X(PitchToDecay,    "pitch_to_decay") \
+    X(FilterCutoff,    "filter_cutoff") \
+    X(FilterReso,      "filter_reso") \
+    X(FilterEnvAmount, "filter_env_amount") \
+    X(PitchEnvAttack,  "pitch_env_attack") \
+    X(PitchEnvDecay,   "pitch_env_decay") \
+    X(PitchEnvAmount,  "pitch_env_amount") \
+    X(VcfVcaAttack,    "vcf_vca_attack") \
+    X(VcfVcaDecay,     "vcf_vca_decay") \
+    X(SeqPitch0,       "seq_pitch_0") \
+    X(SeqPitch1,       "seq_pitch_1") \
+    X(SeqPitch2,       "seq_pitch_2") \
+    X(SeqPitch3,       "seq_pitch_3") \
+    X(SeqPitch4,       "seq_pitch_4") \
+    X(SeqPitch5,       "seq_pitch_5") \
+    X(SeqPitch6,       "seq_pitch_6") \
+    X(SeqPitch7,       "seq_pitch_7") \
+    X(SeqVel0,         "seq_vel_0") \
+    X(SeqVel1,         "seq_vel_1") \
+    X(SeqVel2,         "seq_vel_2") \
+    X(SeqVel3,         "seq_vel_3") \
+    X(SeqVel4,         "seq_vel_4") \
+    X(SeqVel5,         "seq_vel_5") \
+    X(SeqVel6,         "seq_vel_6") \
+    X(SeqVel7,         "seq_vel_7") \
+    X(PitchLfoRate,    "pitch_lfo_rate") \
+    X(PitchLfoAmount,  "pitch_lfo_amount") \
+    X(PitchLfoEn0,     "pitch_lfo_en_0") \
+    X(PitchLfoEn1,     "pitch_lfo_en_1") \
+    X(PitchLfoEn2,     "pitch_lfo_en_2") \
+    X(PitchLfoEn3,     "pitch_lfo_en_3") \
+    X(PitchLfoEn4,     "pitch_lfo_en_4") \
+    X(PitchLfoEn5,     "pitch_lfo_en_5") \
+    X(PitchLfoEn6,     "pitch_lfo_en_6") \
+    X(PitchLfoEn7,     "pitch_lfo_en_7") \
+    X(VelLfoRate,      "vel_lfo_rate") \
+    X(VelLfoAmount,    "vel_lfo_amount") \
+    X(VelLfoEn0,       "vel_lfo_en_0") \
+    X(VelLfoEn1,       "vel_lfo_en_1") \
+    X(VelLfoEn2,       "vel_lfo_en_2") \
+    X(VelLfoEn3,       "vel_lfo_en_3") \
+    X(VelLfoEn4,       "vel_lfo_en_4") \
+    X(VelLfoEn5,       "vel_lfo_en_5") \
+    X(VelLfoEn6,       "vel_lfo_en_6") \
+    X(VelLfoEn7,       "vel_lfo_en_7") \
+    X(FilterLfoRate,   "filter_lfo_rate") \
+    X(FilterLfoAmount, "filter_lfo_amount") \
+    X(FilterMode,      "filter_mode") \
+    X(SatDrive,        "sat_drive") \
+    X(SatMix,          "sat_mix") \
+    X(Oversampling,    "oversampling") \
+    X(DelayTime,       "delay_time") \
+    X(DelayFeedback,   "delay_feedback") \
+    X(DelayMix,        "delay_mix") \
+    X(ReverbDecay,     "reverb_decay") \
+    X(ReverbDamping,   "reverb_damping") \
+    X(ReverbMix,       "reverb_mix") \
+    X(ReverbEngine,    "reverb_engine") \
+    X(ConvMix,         "conv_mix") \
+    X(CompThreshold,   "comp_threshold") \
+    X(CompRatio,       "comp_ratio") \
+    X(CompAttack,      "comp_attack") \
+    X(CompRelease,     "comp_release") \
+    X(CompMakeup,      "comp_makeup") \
+    X(CompMix,         "comp_mix") \
+    X(MasterVolume,    "master_volume")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
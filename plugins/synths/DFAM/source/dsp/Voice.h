@@ -18,312 +18,62 @@
  * Envelopes:
  *   - VCO Decay: Attack + Decay envelope for pitch modulation
  *   - VCF/VCA Decay: Attack + Decay envelope for filter and amplitude
+ *
+ * The pitch envelope and the filter cutoff run at control rate (once per
+ * ControlRamp::BLOCK_SIZE samples) and are ramped across each block; the
+ * VCF/VCA envelope stays per sample because it is the VCA.
+ *
+ * render() runs each stage over a whole control block in its own buffer:
+ * pitch ramp, VCO1, VCO2's FM'd frequencies, VCO2, mixer, ladder, VCA.
+ * The oscillators pick their shape once per block, and the arithmetic
+ * stages between them are plain loops the compiler vectorizes.
+ *
+ * The ladder's tanh stages can run 2x or 4x oversampled (Oversampler.h,
+ * setOversampling()); the oscillators and the VCA stay at the base rate.
+ *
+ * setQualityTier() (QualityTier.h) sets the control block: 64 samples in
+ * draft, 8 in high. Draft also swaps the VCOs' elliptic BLEP for DPW at
+ * the next trigger, which restarts them anyway.
  */
 
 #pragma once
 
-#include <juce_core/juce_core.h>
 #include <cmath>
-#include <random>
 #include <algorithm>
+#include <array>
+#include <vector>
 
 // SST Libraries
 #include "sst/basic-blocks/dsp/Clippers.h"
 
-/**
- * @brief Simple noise generator
- */
-class NoiseGenerator
-{
-public:
-    float process()
-    {
-        return distribution(generator);
-    }
-
-private:
-    std::mt19937 generator{std::random_device{}()};
-    std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
-};
-
-/**
- * @brief Simple LFO for modulation with clock sync support
- *
- * Rate can be set in Hz or as a clock divider relative to tempo.
- * Clock divider values: 1/64, 1/32, 1/16, 1/8, 1/4, 1/2, 1, 2, 4, 8, 16, 32, 64
- */
-class SimpleLFO
-{
-public:
-    enum Waveform { SINE, TRIANGLE, SAW, SQUARE };
-
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        phase = 0.0;
-        updatePhaseIncrement();
-    }
-
-    void setRate(float hz)
-    {
-        rate = std::clamp(hz, 0.01f, 20.0f);
-        useClockSync = false;
-        updatePhaseIncrement();
-    }
-
-    /**
-     * @brief Set LFO rate synced to tempo via clock divider
-     * @param bpm Current tempo in BPM
-     * @param divider Clock divider (1/64 to 64x)
-     *
-     * At divider=1, LFO completes one cycle per beat (quarter note)
-     * At divider=4, LFO completes 4 cycles per beat (16th notes)
-     * At divider=0.25, LFO completes one cycle per bar (whole note)
-     */
-    void setClockSyncRate(float bpm, float divider)
-    {
-        tempo = std::clamp(bpm, 20.0f, 300.0f);
-        clockDivider = std::clamp(divider, 0.015625f, 64.0f);
-        useClockSync = true;
-        updatePhaseIncrement();
-    }
-
-    void setWaveform(Waveform w) { waveform = w; }
-    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
-
-    /**
-     * @brief Get current LFO value without advancing phase
-     * @return Value in range [-1, 1]
-     */
-    float getValue() const
-    {
-        return computeValue(phase);
-    }
-
-    /**
-     * @brief Process and advance phase
-     * @return Value in range [-1, 1]
-     */
-    float process()
-    {
-        float output = computeValue(phase);
-        phase += phaseIncrement;
-        if (phase >= 1.0)
-            phase -= 1.0;
-        return output;
-    }
-
-    void reset() { phase = 0.0; }
-
-private:
-    void updatePhaseIncrement()
-    {
-        if (useClockSync)
-        {
-            // Sync to tempo: one cycle per beat * divider
-            float beatsPerSecond = tempo / 60.0f;
-            float cyclesPerSecond = beatsPerSecond * clockDivider;
-            phaseIncrement = cyclesPerSecond / sampleRate;
-        }
-        else
-        {
-            phaseIncrement = rate / sampleRate;
-        }
-    }
-
-    float computeValue(double p) const
-    {
-        switch (waveform)
-        {
-            case SINE:
-                return std::sin(2.0f * juce::MathConstants<float>::pi * static_cast<float>(p));
-            case TRIANGLE:
-                return 4.0f * std::abs(static_cast<float>(p) - 0.5f) - 1.0f;
-            case SAW:
-                return 2.0f * static_cast<float>(p) - 1.0f;
-            case SQUARE:
-                return p < 0.5 ? 1.0f : -1.0f;
-            default:
-                return 0.0f;
-        }
-    }
-
-    double sampleRate = 44100.0;
-    double phase = 0.0;
-    double phaseIncrement = 0.0;
-    float rate = 1.0f;
-    float tempo = 120.0f;
-    float clockDivider = 1.0f;
-    bool useClockSync = false;
-    Waveform waveform = SINE;
-};
-
-/**
- * @brief Simple oscillator with multiple waveforms
- */
-class DFAMOscillator
-{
-public:
-    enum Waveform { SAW, SQUARE, TRIANGLE, SINE };
-
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        phase = 0.0;
-    }
-
-    void setFrequency(float freq)
-    {
-        frequency = std::clamp(freq, 20.0f, 20000.0f);
-        phaseIncrement = frequency / sampleRate;
-    }
-
-    void setWaveform(Waveform w) { waveform = w; }
-    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
-
-    void resetPhase() { phase = 0.0; }
-
-    float process()
-    {
-        float output = 0.0f;
-
-        switch (waveform)
-        {
-            case SAW:
-                // Start at -1, rise to +1 (zero crossing at start)
-                output = 2.0f * static_cast<float>(phase) - 1.0f;
-                break;
-            case SQUARE:
-                output = phase < 0.5 ? 1.0f : -1.0f;
-                break;
-            case TRIANGLE:
-                // Starts at -1 when phase=0 (zero crossing point)
-                output = 4.0f * std::abs(static_cast<float>(phase) - 0.5f) - 1.0f;
-                break;
-            case SINE:
-                // Sine starts at 0 when phase=0 (perfect zero crossing)
-                output = std::sin(2.0f * juce::MathConstants<float>::pi * static_cast<float>(phase));
-                break;
-        }
-
-        phase += phaseIncrement;
-        if (phase >= 1.0)
-            phase -= 1.0;
-
-        return output;
-    }
-
-private:
-    double sampleRate = 44100.0;
-    double phase = 0.0;
-    double phaseIncrement = 0.0;
-    float frequency = 440.0f;
-    Waveform waveform = SAW;
-};
-
-/**
- * @brief Smooth AD (Attack/Decay) envelope with exponential curves
- *
- * Uses exponential curves to avoid clicks at attack onset.
- * The attack phase uses an inverted exponential for a smooth start,
- * and decay uses a standard exponential fall.
- */
-class ADEnvelope
-{
-public:
-    enum Stage { IDLE, ATTACK, DECAY };
-
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        updateCoefficients();
-    }
-
-    void setAttack(float seconds)
-    {
-        attackTime = std::max(0.001f, seconds);
-        updateCoefficients();
-    }
-
-    void setDecay(float seconds)
-    {
-        decayTime = std::max(0.001f, seconds);
-        updateCoefficients();
-    }
-
-    void trigger()
-    {
-        stage = ATTACK;
-        // Don't reset value - allows smooth retriggering
-        // But if idle, start from zero
-        if (value < 0.001f)
-            value = 0.0f;
-    }
-
-    float process()
-    {
-        switch (stage)
-        {
-            case ATTACK:
-            {
-                // Exponential approach to 1.0 (smooth start, no click)
-                value += attackCoef * (1.0f - value);
-                if (value >= 0.999f)
-                {
-                    value = 1.0f;
-                    stage = DECAY;
-                }
-                break;
-            }
-
-            case DECAY:
-            {
-                // Exponential decay toward 0
-                value *= decayCoef;
-                if (value <= 0.001f)
-                {
-                    value = 0.0f;
-                    stage = IDLE;
-                }
-                break;
-            }
-
-            case IDLE:
-            default:
-                break;
-        }
-
-        return value;
-    }
-
-    bool isActive() const { return stage != IDLE; }
-
-private:
-    void updateCoefficients()
-    {
-        // Calculate exponential coefficients
-        // For attack: we want to reach ~99.9% in attackTime
-        // coefficient = 1 - e^(-1/(time * sampleRate * tau))
-        // Using tau factor to control curve shape
-        float attackSamples = attackTime * static_cast<float>(sampleRate);
-        attackCoef = 1.0f - std::exp(-4.0f / attackSamples);  // ~98% in attackTime
-
-        // For decay: exponential fall
-        float decaySamples = decayTime * static_cast<float>(sampleRate);
-        decayCoef = std::exp(-4.0f / decaySamples);  // ~2% remaining after decayTime
-    }
-
-    double sampleRate = 44100.0;
-    float attackTime = 0.01f;
-    float decayTime = 0.5f;
-    float attackCoef = 0.001f;  // Exponential attack coefficient
-    float decayCoef = 0.9999f;  // Exponential decay coefficient
-    float value = 0.0f;
-    Stage stage = IDLE;
-};
+#include "ADEnvelope.h"
+#include "BandLimitedOscillator.h"
+#include "Compressor.h"
+#include "ControlRate.h"
+#include "Oversampler.h"
+#include "PitchTables.h"
+#include "QualityTier.h"
+#include "SilenceGate.h"
+#include "Denormals.h"
+#include "FastMath.h"
+#include "FdnReverb.h"
+#include "LFO.h"
+#include "MemoryReport.h"
+#include "Noise.h"
+#include "ReferenceDsp.h"
+#include "SSTEffect.h"
+#include "StereoDelay.h"
+
+#include "sst/effects/Reverb2.h"
+
+// Constants
+static constexpr float PI = 3.14159265358979323846f;
+static constexpr float TWO_PI = 2.0f * PI;
 
 /**
  * @brief Ladder filter with LP/HP modes
+ *
+ * The stages' tanh is FastMath's Audio tier (std::tanh in the reference build).
  */
 class LadderFilter
 {
@@ -333,20 +83,32 @@ public:
     void prepare(double sr)
     {
         sampleRate = sr;
+        gRamp.reset(computeG());
         reset();
     }
 
     void reset()
     {
         for (int i = 0; i < 4; ++i)
+        {
             stage[i] = 0.0f;
+            stageTanh[i] = 0.0f;
+        }
         lastInput = 0.0f;
     }
 
+    /** Jump straight to freq */
     void setCutoff(float freq)
     {
         cutoff = std::clamp(freq, 20.0f, 20000.0f);
-        updateCoefficients();
+        gRamp.reset(computeG());
+    }
+
+    /** Glide to freq over the next n process() calls (control rate) */
+    void glideCutoff(float freq, int n)
+    {
+        cutoff = std::clamp(freq, 20.0f, 20000.0f);
+        gRamp.setTarget(computeG(), n);
     }
 
     void setResonance(float res)
@@ -359,13 +121,17 @@ public:
 
     float process(float input)
     {
+        const float g = gRamp.next();
         float feedback = resonance * 4.0f * (stage[3] - 0.5f * input);
-        float x = input - feedback;
+        float xTanh = FastMath::tanh(input - feedback);
 
+        // Each stage's tanh drives the next stage now and is this stage's
+        // own term next sample, so it's computed once: 5 tanh, not 8
         for (int i = 0; i < 4; ++i)
         {
-            stage[i] += g * (std::tanh(x) - std::tanh(stage[i]));
-            x = stage[i];
+            stage[i] += g * (xTanh - stageTanh[i]);
+            stageTanh[i] = FastMath::tanh(stage[i]);
+            xTanh = stageTanh[i];
         }
 
         lastInput = input;
@@ -376,18 +142,19 @@ public:
     }
 
 private:
-    void updateCoefficients()
+    float computeG() const
     {
         float fc = cutoff / static_cast<float>(sampleRate);
-        g = std::tan(juce::MathConstants<float>::pi * std::min(fc, 0.49f));
-        g = g / (1.0f + g);
+        float g = std::tan(PI * std::min(fc, 0.49f));
+        return g / (1.0f + g);
     }
 
     double sampleRate = 44100.0;
     float cutoff = 5000.0f;
     float resonance = 0.0f;
-    float g = 0.0f;
+    ControlRamp gRamp;  // One-pole coefficient, linear between control blocks
     float stage[4] = {0, 0, 0, 0};
+    float stageTanh[4] = {0, 0, 0, 0};  // tanh(stage[i]), kept from the last sample
     float lastInput = 0.0f;
     Mode mode = LOWPASS;
 };
@@ -395,6 +162,7 @@ private:
 /**
  * @brief Saturator using SST tanh7 clipping algorithm
  * Uses sst-basic-blocks/dsp/Clippers.h for high-quality saturation
+ * (std::tanh in the reference build, see ReferenceDsp.h)
  */
 class Saturator
 {
@@ -404,6 +172,9 @@ public:
 
     float process(float input)
     {
+        if constexpr (ReferenceDsp::ENABLED)
+            return input * (1.0f - mix) + std::tanh(input * drive) * mix;
+
         // Use SST tanh7 for high-quality saturation
         // tanh7 uses 7th-order polynomial approximation for accurate tanh
         alignas(16) float vals[4] = {input * drive, 0.0f, 0.0f, 0.0f};
@@ -422,7 +193,7 @@ public:
 
         // Process in blocks of 4 for SIMD efficiency
         int i = 0;
-        for (; i + 4 <= numSamples; i += 4)
+        for (; !ReferenceDsp::ENABLED && i + 4 <= numSamples; i += 4)
         {
             alignas(16) float dry[4];
             alignas(16) float wet[4];
@@ -452,125 +223,62 @@ private:
 };
 
 /**
- * @brief Simple stereo delay with tempo sync support
+ * @brief Stereo reverb: sst-effects' Reverb2 (via SSTEffect.h) or the FDN, with a dry/wet mix
+ *
+ * Reverb2 runs wet only, in blocks of SSTEffect::BLOCK samples; the dry
+ * signal is mixed in here, undelayed, so only the wet path carries the
+ * wrapper's latency (a third of a millisecond, well inside any pre-delay).
+ * The FDN (FdnReverb.h, the web build's reverb) mixes its own dry signal
+ * and has no latency; it's lighter and denser, Reverb2 smoother.
  */
-class StereoDelay
+class Reverb
 {
 public:
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        bufferSize = static_cast<size_t>(sr * 4.0);  // 4 seconds max for slow tempos
-        bufferL.resize(bufferSize, 0.0f);
-        bufferR.resize(bufferSize, 0.0f);
-        writePos = 0;
-    }
+    using R2 = SSTEffect<sst::effects::reverb2::Reverb2>::FX;
 
-    void setTime(float seconds)
+    Reverb()
     {
-        delayTime = std::clamp(seconds, 0.001f, 4.0f);
-        useClockSync = false;
-        updateDelaySamples();
+        reverb.setParam(R2::rev2_predelay, -8.0f);  // 2^-8 s: effectively none
+        reverb.setParam(R2::rev2_mix, 1.0f);        // Wet only, dry mixed here
+        setDecay(decay);
+        setDamping(damping);
     }
 
-    /**
-     * @brief Set delay time synced to tempo via clock divider
-     * @param bpm Current tempo in BPM
-     * @param divider Clock divider (1/64 to 64x)
-     *
-     * At divider=1, delay = one beat (quarter note)
-     * At divider=0.5, delay = half beat (8th note)
-     * At divider=4, delay = 4 beats (whole note)
-     */
-    void setClockSyncTime(float bpm, float divider)
+    enum Engine
     {
-        tempo = std::clamp(bpm, 20.0f, 300.0f);
-        clockDivider = std::clamp(divider, 0.015625f, 64.0f);
-        useClockSync = true;
-        updateDelaySamples();
-    }
-
-    void setFeedback(float fb) { feedback = std::clamp(fb, 0.0f, 0.95f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
+        REVERB2,
+        FDN,
+        NUM_ENGINES
+    };
 
-    void process(float& left, float& right)
+    void prepare(double sr)
     {
-        size_t readPos = (writePos + bufferSize - delaySamples) % bufferSize;
-
-        float delayedL = bufferL[readPos];
-        float delayedR = bufferR[readPos];
-
-        bufferL[writePos] = left + delayedL * feedback;
-        bufferR[writePos] = right + delayedR * feedback;
-
-        left = left * (1.0f - mix) + delayedL * mix;
-        right = right * (1.0f - mix) + delayedR * mix;
-
-        writePos = (writePos + 1) % bufferSize;
+        sampleRate = sr;
+        reverb.prepare(sr);
+        fdn.prepare(sr);
     }
 
-private:
-    void updateDelaySamples()
+    /** Which reverb runs; the FDN starts from silence when it's switched in */
+    void setEngine(int e)
     {
-        if (useClockSync)
-        {
-            // Sync to tempo: one beat / divider
-            float secondsPerBeat = 60.0f / tempo;
-            float syncedTime = secondsPerBeat / clockDivider;
-            syncedTime = std::clamp(syncedTime, 0.001f, 4.0f);
-            delaySamples = static_cast<size_t>(syncedTime * sampleRate);
-        }
-        else
-        {
-            delaySamples = static_cast<size_t>(delayTime * sampleRate);
-        }
-        // Clamp to buffer size
-        if (delaySamples >= bufferSize)
-            delaySamples = bufferSize - 1;
+        const Engine next = static_cast<Engine>(std::clamp(e, 0, NUM_ENGINES - 1));
+        if (next == engine)
+            return;
+        engine = next;
+        if (engine == FDN)
+            fdn.clear();
     }
 
-    double sampleRate = 44100.0;
-    std::vector<float> bufferL;
-    std::vector<float> bufferR;
-    size_t bufferSize = 176400;  // 4 seconds at 44.1k
-    size_t writePos = 0;
-    size_t delaySamples = 22050;
-    float delayTime = 0.5f;
-    float tempo = 120.0f;
-    float clockDivider = 1.0f;
-    bool useClockSync = false;
-    float feedback = 0.3f;
-    float mix = 0.0f;
-};
+    Engine getEngine() const { return engine; }
 
-/**
- * @brief Simple ambisonic-style reverb (Schroeder-style with diffusion)
- */
-class AmbisonicReverb
-{
-public:
-    void prepare(double sr)
+    /** Decay time in seconds (to -60 dB) */
+    void setDecay(float d)
     {
-        sampleRate = sr;
-
-        // Allpass delays for diffusion
-        for (int i = 0; i < 4; ++i)
-        {
-            apDelays[i].resize(static_cast<size_t>(sr * apTimes[i]), 0.0f);
-            apPos[i] = 0;
-        }
-
-        // Comb filters for reverb tail
-        for (int i = 0; i < 8; ++i)
-        {
-            combDelays[i].resize(static_cast<size_t>(sr * combTimes[i]), 0.0f);
-            combPos[i] = 0;
-            combFilters[i] = 0.0f;
-        }
+        decay = std::clamp(d, 0.1f, 10.0f);
+        reverb.setParam(R2::rev2_decay_time, std::log2(decay));
+        fdn.setDecay(decay);
     }
 
-    void setDecay(float d) { decay = std::clamp(d, 0.1f, 10.0f); }
-
     /**
      * @brief Set reverb mix with very gradual curve for subtle control
      * @param m Mix value 0-1
@@ -591,138 +299,81 @@ public:
         // Apply 4th power curve for very gradual onset
         float curved = linearMix * linearMix * linearMix * linearMix;
         mix = curved;
-    }
-    void setDamping(float d) { damping = std::clamp(d, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
-    {
-        float input = (left + right) * 0.5f;
-
-        // Allpass diffusion
-        float diffused = input;
-        for (int i = 0; i < 4; ++i)
-            diffused = processAllpass(i, diffused);
-
-        // Parallel comb filters
-        float reverbL = 0.0f;
-        float reverbR = 0.0f;
-        float combGain = std::pow(0.001f, 1.0f / (decay * static_cast<float>(sampleRate)));
-
-        for (int i = 0; i < 4; ++i)
-            reverbL += processComb(i, diffused, combGain);
-        for (int i = 4; i < 8; ++i)
-            reverbR += processComb(i, diffused, combGain);
-
-        reverbL *= 0.25f;
-        reverbR *= 0.25f;
-
-        left = left * (1.0f - mix) + reverbL * mix;
-        right = right * (1.0f - mix) + reverbR * mix;
+        fdn.setMix(mix);
     }
 
-private:
-    float processAllpass(int idx, float input)
+    /** High-frequency damping of the tail, 0-1 */
+    void setDamping(float d)
     {
-        float delayed = apDelays[idx][apPos[idx]];
-        float output = -input + delayed;
-        apDelays[idx][apPos[idx]] = input + delayed * 0.5f;
-        apPos[idx] = (apPos[idx] + 1) % apDelays[idx].size();
-        return output;
+        damping = std::clamp(d, 0.0f, 1.0f);
+        reverb.setParam(R2::rev2_hf_damping, damping);
+        fdn.setDamping(damping);
     }
 
-    float processComb(int idx, float input, float gain)
+    /** Mix the reverb into a block, in place */
+    void processBlock(float* left, float* right, int numSamples)
     {
-        float delayed = combDelays[idx][combPos[idx]];
-        combFilters[idx] = delayed * (1.0f - damping) + combFilters[idx] * damping;
-        combDelays[idx][combPos[idx]] = input + combFilters[idx] * gain;
-        combPos[idx] = (combPos[idx] + 1) % combDelays[idx].size();
-        return delayed;
-    }
+        if (engine == FDN)
+        {
+            fdn.processBlock(left, right, numSamples);
+            return;
+        }
 
-    double sampleRate = 44100.0;
-    float decay = 2.0f;
-    float mix = 0.0f;
-    float damping = 0.5f;
+        for (int start = 0; start < numSamples; start += CHUNK)
+        {
+            const int n = std::min(numSamples - start, CHUNK);
+            float* l = left + start;
+            float* r = right + start;
 
-    // Allpass filter delays (in seconds)
-    float apTimes[4] = {0.0051f, 0.0076f, 0.01f, 0.0123f};
-    std::vector<float> apDelays[4];
-    size_t apPos[4] = {0, 0, 0, 0};
-
-    // Comb filter delays (in seconds) - slightly different for L/R
-    float combTimes[8] = {0.0297f, 0.0371f, 0.0411f, 0.0437f,
-                          0.0299f, 0.0373f, 0.0413f, 0.0439f};
-    std::vector<float> combDelays[8];
-    size_t combPos[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    float combFilters[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-};
+            std::array<float, CHUNK> wetL;
+            std::array<float, CHUNK> wetR;
+            std::copy(l, l + n, wetL.begin());
+            std::copy(r, r + n, wetR.begin());
+            reverb.processBlock(wetL.data(), wetR.data(), n);
 
-/**
- * @brief Simple compressor with dry/wet mix
- */
-class Compressor
-{
-public:
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        updateCoefficients();
+            for (int i = 0; i < n; ++i)
+            {
+                l[i] = l[i] * (1.0f - mix) + wetL[static_cast<size_t>(i)] * mix;
+                r[i] = r[i] * (1.0f - mix) + wetR[static_cast<size_t>(i)] * mix;
+            }
+        }
     }
 
-    void setThreshold(float db) { threshold = db; }
-    void setRatio(float r) { ratio = std::clamp(r, 1.0f, 20.0f); }
-    void setAttack(float ms) { attackMs = std::clamp(ms, 0.1f, 100.0f); updateCoefficients(); }
-    void setRelease(float ms) { releaseMs = std::clamp(ms, 10.0f, 1000.0f); updateCoefficients(); }
-    void setMakeupGain(float db) { makeupGain = std::pow(10.0f, db / 20.0f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
+    /**
+     * @brief Samples until the tail falls below -120 dB (see SilenceGate.h)
+     *
+     * Reverb2's feedback loop is 0.55 s long at room size 0 and loses 60 dB
+     * per decay time; the pre-delay, the input diffusers and the block
+     * latency come on top. The FDN works out its own.
+     */
+    int64_t getTailSamples() const
     {
-        // Store dry signal
-        float dryL = left;
-        float dryR = right;
-
-        float inputLevel = std::max(std::abs(left), std::abs(right));
-        float inputDb = 20.0f * std::log10(inputLevel + 1e-6f);
-
-        // Calculate gain reduction
-        float gainReduction = 0.0f;
-        if (inputDb > threshold)
-            gainReduction = (inputDb - threshold) * (1.0f - 1.0f / ratio);
-
-        // Smooth envelope
-        float targetGain = std::pow(10.0f, -gainReduction / 20.0f);
-        if (targetGain < envelope)
-            envelope = attackCoef * envelope + (1.0f - attackCoef) * targetGain;
-        else
-            envelope = releaseCoef * envelope + (1.0f - releaseCoef) * targetGain;
-
-        float gain = envelope * makeupGain;
-        float wetL = left * gain;
-        float wetR = right * gain;
-
-        // Blend dry/wet
-        left = dryL * (1.0f - mix) + wetL * mix;
-        right = dryR * (1.0f - mix) + wetR * mix;
+        if (engine == FDN)
+            return fdn.getTailSamples();
+
+        const double loopSamples = LOOP_SECONDS * sampleRate;
+        const double loopGain = std::pow(0.001, LOOP_SECONDS / decay);
+        const int64_t tail = Silence::feedbackTail(loopSamples, loopGain);
+        if (tail == Silence::INFINITE_TAIL)
+            return tail;
+        return tail + static_cast<int64_t>(loopSamples) + SSTEffect<sst::effects::reverb2::Reverb2>::LATENCY;
     }
 
+    /** Bytes of Reverb2 (its delay lines are members) and the FDN's lines allocated by prepare() */
+    size_t getHeapBytes() const { return reverb.getHeapBytes() + fdn.getHeapBytes(); }
+
 private:
-    void updateCoefficients()
-    {
-        attackCoef = std::exp(-1.0f / (attackMs * 0.001f * static_cast<float>(sampleRate)));
-        releaseCoef = std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
-    }
+    static constexpr int CHUNK = 64;
+    static constexpr double LOOP_SECONDS = 0.5508;  // Reverb2's loop_time_s at room size 0
+
+    SSTEffect<sst::effects::reverb2::Reverb2> reverb;
+    FdnReverb fdn;
+    Engine engine = REVERB2;
 
     double sampleRate = 44100.0;
-    float threshold = -10.0f;
-    float ratio = 4.0f;
-    float attackMs = 10.0f;
-    float releaseMs = 100.0f;
-    float makeupGain = 1.0f;
-    float attackCoef = 0.0f;
-    float releaseCoef = 0.0f;
-    float envelope = 1.0f;
-    float mix = 1.0f;  // Default to full wet (100% compression)
+    float decay = 2.0f;
+    float mix = 0.0f;
+    float damping = 0.5f;
 };
 
 /**
@@ -731,20 +382,27 @@ private:
 class DFAMVoice
 {
 public:
+    /** The longest control block (the draft tier's) */
+    static constexpr int MAX_CONTROL_BLOCK = 2 * ControlRamp::BLOCK_SIZE;
+
     void prepare(double sr)
     {
         sampleRate = sr;
 
         vco1.prepare(sr);
         vco2.prepare(sr);
-        filter.prepare(sr);
-        pitchEnv.prepare(sr);
-        vcfVcaEnv.prepare(sr);
+        filter.prepare(sr * filterOversampler.getFactor());
+        filterOversampler.reset();
+        pitchEnv.setSampleRate(sr);
+        vcfVcaEnv.setSampleRate(sr);
 
         pitchEnv.setAttack(0.001f);
         pitchEnv.setDecay(0.3f);
         vcfVcaEnv.setAttack(0.001f);
         vcfVcaEnv.setDecay(0.5f);
+
+        filter.setCutoff(filterCutoff);
+        pitchRamp.reset(PitchTables::get().semitonesToRatio(pitchOffset));
     }
 
     void trigger(float vel = 1.0f)
@@ -784,39 +442,65 @@ public:
         float modulatedNoiseLevel = noiseLevel + pitchToNoiseAmount * pitchNormalized;
         modulatedNoiseLevel = std::clamp(modulatedNoiseLevel, 0.0f, 1.0f);
 
-        for (int i = 0; i < numSamples; ++i)
-        {
-            float pitchEnvValue = pitchEnv.process();
-            float vcfVcaEnvValue = vcfVcaEnv.process();
-
-            // VCO frequencies with pitch envelope
-            float vco1Freq = vco1BaseFreq * std::pow(2.0f, (pitchEnvValue * pitchEnvAmount + pitchOffset) / 12.0f);
-            float vco2Freq = vco2BaseFreq * std::pow(2.0f, (pitchEnvValue * pitchEnvAmount + pitchOffset) / 12.0f);
+        const PitchTables& pitch = PitchTables::get();
 
-            vco1.setFrequency(vco1Freq);
-            float vco1Out = vco1.process();
+        for (int start = 0; start < numSamples; start += controlBlock)
+        {
+            const int n = std::min(numSamples - start, controlBlock);
+
+            // VCF/VCA envelope per sample (it's the VCA); its block-end value
+            // sets the cutoff target
+            float vcfVcaEnvValues[MAX_CONTROL_BLOCK];
+            for (int i = 0; i < n; ++i)
+                vcfVcaEnvValues[i] = vcfVcaEnv.process();
+
+            // Pitch envelope and filter cutoff once per block, ramped across it
+            // (same offset for both VCOs)
+            pitchRamp.setTarget(pitch.semitonesToRatio(pitchEnv.advance(n) * pitchEnvAmount + pitchOffset), n);
+            filter.glideCutoff(filterCutoff + vcfVcaEnvValues[n - 1] * filterEnvAmount * 10000.0f,
+                               n * filterOversampler.getFactor());
+
+            // Each stage runs over the whole block in its own buffer, so the
+            // loops between the oscillators vectorize
+            float ratio[MAX_CONTROL_BLOCK];
+            float freq[MAX_CONTROL_BLOCK];
+            float vco1Out[MAX_CONTROL_BLOCK];
+            float vco2Out[MAX_CONTROL_BLOCK];
+            float noiseBlock[MAX_CONTROL_BLOCK];
+            float mixed[MAX_CONTROL_BLOCK];
+
+            for (int i = 0; i < n; ++i)
+                ratio[i] = pitchRamp.next();
+
+            for (int i = 0; i < n; ++i)
+                freq[i] = vco1BaseFreq * ratio[i];
+            vco1.processBlock(freq, vco1Out, n);
 
             // FM: VCO1 modulates VCO2
-            float fmMod = vco1Out * fmAmount * vco2Freq;
-            vco2.setFrequency(vco2Freq + fmMod);
-            float vco2Out = vco2.process();
-
-            // Noise with pitch modulation
-            float noiseOut = noise.process();
+            for (int i = 0; i < n; ++i)
+            {
+                const float vco2Freq = vco2BaseFreq * ratio[i];
+                freq[i] = vco2Freq + vco1Out[i] * fmAmount * vco2Freq;
+            }
+            vco2.processBlock(freq, vco2Out, n);
 
             // Mix with pitch-modulated noise
-            float mix = vco1Out * vco1Level + vco2Out * vco2Level + noiseOut * modulatedNoiseLevel;
-
-            // Filter with envelope
-            float filterMod = filterCutoff + vcfVcaEnvValue * filterEnvAmount * 10000.0f;
-            filter.setCutoff(std::clamp(filterMod, 20.0f, 20000.0f));
-            float filtered = filter.process(mix);
-
-            // VCA with anti-click ramp
-            float output = filtered * vcfVcaEnvValue * velocity * masterLevel;
-
-            // Apply anti-click ramp at note onset
-            if (antiClickActive)
+            noise.fillPM1(noiseBlock, n);
+            for (int i = 0; i < n; ++i)
+                mixed[i] = vco1Out[i] * vco1Level + vco2Out[i] * vco2Level + noiseBlock[i] * modulatedNoiseLevel;
+
+            // Filter, cutoff gliding with the envelope, at the oversampled rate
+            filterOversampler.processMono(mixed, n, [this](float* x, int m) {
+                for (int j = 0; j < m; ++j)
+                    x[j] = filter.process(x[j]);
+            });
+
+            // VCA
+            for (int i = 0; i < n; ++i)
+                mixed[i] = mixed[i] * vcfVcaEnvValues[i] * velocity * masterLevel;
+
+            // Anti-click ramp at note onset, over the first few samples only
+            for (int i = 0; i < n && antiClickActive; ++i)
             {
                 antiClickRamp += antiClickIncrement;
                 if (antiClickRamp >= 1.0f)
@@ -824,23 +508,36 @@ public:
                     antiClickRamp = 1.0f;
                     antiClickActive = false;
                 }
-                output *= antiClickRamp;
+                mixed[i] *= antiClickRamp;
             }
 
-            outputL[i] += output;
-            outputR[i] += output;
+            float* const l = outputL + start;
+            float* const r = outputR + start;
+            for (int i = 0; i < n; ++i)
+            {
+                l[i] += mixed[i];
+                r[i] += mixed[i];
+            }
         }
     }
 
+    /**
+     * @brief Stand in for render() while the VCA is closed
+     *
+     * The output would be silent, so only the pitch envelope, which can
+     * outlast the VCA and sets where the next attack starts, keeps running.
+     */
+    void skip(int numSamples) { pitchEnv.advance(numSamples); }
+
     // VCO1
     void setVCO1Frequency(float freq) { vco1BaseFreq = freq; }
     void setVCO1Level(float level) { vco1Level = level; }
-    void setVCO1Waveform(int w) { vco1.setWaveform(w); }
+    void setVCO1Waveform(int w) { vco1.setShape(w); }
 
     // VCO2
     void setVCO2Frequency(float freq) { vco2BaseFreq = freq; }
     void setVCO2Level(float level) { vco2Level = level; }
-    void setVCO2Waveform(int w) { vco2.setWaveform(w); }
+    void setVCO2Waveform(int w) { vco2.setShape(w); }
 
     // FM
     void setFMAmount(float amount) { fmAmount = amount; }
@@ -850,14 +547,48 @@ public:
     void setPitchToNoiseAmount(float amount) { pitchToNoiseAmount = std::clamp(amount, 0.0f, 1.0f); }
 
     // Filter
-    void setFilterCutoff(float freq) { filterCutoff = freq; filter.setCutoff(freq); }
+    void setFilterCutoff(float freq) { filterCutoff = freq; }  // Picked up at the next control block
     void setFilterResonance(float res) { filter.setResonance(res); }
     void setFilterEnvAmount(float amount) { filterEnvAmount = amount; }
     void setFilterMode(int mode) { filter.setMode(mode); }
 
+    /** Ladder oversampling: 1 (off), 2 or 4. Resets the filter when it changes */
+    void setOversampling(int factor)
+    {
+        const int previous = filterOversampler.getFactor();
+        filterOversampler.setFactor(factor);
+        if (filterOversampler.getFactor() != previous)
+            filter.prepare(sampleRate * filterOversampler.getFactor());
+    }
+
+    int getOversampling() const { return filterOversampler.getFactor(); }
+
+    /**
+     * @brief Control block and VCO algorithm for a quality tier
+     *
+     * The pitch envelope and cutoff step every 64 samples in draft, 32 in
+     * normal and 8 in high, ramping across each block either way. Draft's
+     * DPW oscillators take over at the next trigger.
+     */
+    void setQualityTier(QualityTier tier)
+    {
+        controlBlock = forTier(tier, MAX_CONTROL_BLOCK, ControlRamp::BLOCK_SIZE, ControlRamp::BLOCK_SIZE / 4);
+        pitchEnv.setControlBlock(controlBlock);
+        vco1.setDraft(tier == QualityTier::Draft);
+        vco2.setDraft(tier == QualityTier::Draft);
+    }
+
+    /** Samples per control block (at most MAX_CONTROL_BLOCK) */
+    int getControlBlock() const { return controlBlock; }
+
+    /** Samples the voice's output is delayed by (the ladder's oversampler) */
+    int getLatency() const { return filterOversampler.getLatency(); }
+
     // Pitch envelope
     void setPitchEnvAttack(float t) { pitchEnv.setAttack(t); }
     void setPitchEnvDecay(float t) { pitchEnv.setDecay(t); }
+    void setPitchEnvDecay(const ADEnvelope::Decay& d) { pitchEnv.setDecay(d); }
+    ADEnvelope::Decay pitchEnvDecayFor(float t) const { return pitchEnv.decayFor(t); }
     void setPitchEnvAmount(float semitones) { pitchEnvAmount = semitones; }
 
     // VCF/VCA envelope
@@ -871,17 +602,23 @@ public:
     // Master
     void setMasterLevel(float level) { masterLevel = level; }
 
+    /** Restart the noise sequence (reproducible renders, see Noise.h) */
+    void setNoiseSeed(uint32_t seed) { noise.reseed(seed); }
+
     bool isActive() const { return vcfVcaEnv.isActive(); }
 
 private:
     double sampleRate = 44100.0;
 
-    DFAMOscillator vco1;
-    DFAMOscillator vco2;
-    NoiseGenerator noise;
+    TieredOscillator vco1;
+    TieredOscillator vco2;
+    NoiseSource noise;
     LadderFilter filter;
+    Oversampler filterOversampler;  // Around the ladder only
     ADEnvelope pitchEnv;
     ADEnvelope vcfVcaEnv;
+    ControlRamp pitchRamp;  // Pitch envelope + offset as a frequency ratio
+    int controlBlock = ControlRamp::BLOCK_SIZE;
 
     float vco1BaseFreq = 110.0f;
     float vco2BaseFreq = 110.0f;
@@ -13,9 +13,14 @@
 #include <catch2/catch_approx.hpp>
 #include <cmath>
 #include <array>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-// TODO: Include your synth engine implementation
-// #include "dsp/SynthEngine.h"
+#include "dsp/SynthEngine.h"
+#include "GoldenRender.h"
+#include "RealtimeGuard.h"
 
 using Catch::Approx;
 
@@ -254,3 +259,363 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("SynthEngine swaps impulse responses in without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+    engine.setConvMix(0.5f);
+
+    // A decaying click train, at another rate so it's resampled
+    std::vector<float> impulse(22050);
+    for (size_t i = 0; i < impulse.size(); i += 300)
+        impulse[i] = std::exp(-static_cast<float>(i) / 5000.0f);
+
+    auto play = [&] {
+        return RealtimeGuard::check([&] {
+            for (int i = 0; i < 100; ++i)
+            {
+                if (i % 4 == 0)
+                    engine.noteOn(48 + (i % 12), 0.8f);
+                engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+            }
+        });
+    };
+
+    // Loaded (here, as a background thread would), then picked up, faded
+    // in and the old kernel let go of, all on the audio thread
+    for (int load = 0; load < 3; ++load)
+    {
+        engine.loadImpulse(impulse.data(), nullptr, impulse.size(), 44100.0);
+        REQUIRE(engine.getImpulseSamples() > 23000);
+        REQUIRE(engine.memoryReport().getBytes("impulse response") > 0);
+
+        const auto rt = play();
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.deallocations == 0);
+        REQUIRE(rt.locks == 0);
+    }
+
+    engine.clearImpulse();
+    REQUIRE(engine.getImpulseSamples() == 0);
+    const auto rt = play();
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+}
+
+TEST_CASE("SynthEngine traces each sequencer step", "[engine][trace]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 256;
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+    engine.setTempo(240.0f);
+    engine.setRunning(true);
+
+    for (int i = 0; i < 200; ++i)
+        engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+
+    // Each step is tagged with the step it moves to, so they count 0-7 in turn
+    int steps = 0, blocks = 0, lastStep = -1;
+    bool inOrder = true;
+    engine.getTrace().drain([&](const TraceRing::Event& e) {
+        if (std::string_view(e.name) == "step")
+        {
+            if (lastStep >= 0 && e.arg != (lastStep + 1) % 8)
+                inOrder = false;
+            lastStep = e.arg;
+            ++steps;
+        }
+        else if (std::string_view(e.name) == "renderBlock")
+            ++blocks;
+    });
+
+    if constexpr (TraceRing::ENABLED)
+    {
+        REQUIRE(blocks == 200);
+        REQUIRE(steps > 8);
+        REQUIRE(inOrder);
+    }
+    else
+    {
+        REQUIRE(blocks == 0);
+        REQUIRE(steps == 0);
+    }
+}
+
+TEST_CASE("SynthEngine plays each step's parameter locks", "[engine][sequencer]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 64;
+    std::array<float, bufferSize> left{};
+    std::array<float, bufferSize> right{};
+
+    engine.prepare(48000.0, bufferSize);
+    engine.setTempo(60.0f);  // 12000 samples a step
+    engine.setDelayMix(0.0f);  // Only the voice, no tails across steps
+    engine.setReverbMix(0.0f);
+    engine.setVCFVCAEnvDecay(2.0f);
+    engine.setStepLock(3, StepLock::VcfVcaDecay, 0.01f);
+
+    REQUIRE(engine.isStepLocked(3, StepLock::VcfVcaDecay));
+    REQUIRE_FALSE(engine.isStepLocked(2, StepLock::VcfVcaDecay));
+    REQUIRE(engine.getStepLock(3, StepLock::VcfVcaDecay) == 0.01f);
+
+    // Energy over the second half of each step, by the step playing
+    auto stepEnergy = [&] {
+        std::array<double, 8> energy{};
+        engine.setRunning(false);
+        engine.setRunning(true);
+        for (int block = 0; block < 12000 * 8 / bufferSize; ++block)
+        {
+            engine.renderBlock(left.data(), right.data(), bufferSize);
+            if ((block * bufferSize) % 12000 < 6000)
+                continue;
+            for (float x : left)
+                energy[static_cast<size_t>(engine.getCurrentStep())] += static_cast<double>(x) * x;
+        }
+        return energy;
+    };
+
+    SECTION("A locked step plays its own decay, the rest the knob's")
+    {
+        engine.setVCFVCAEnvDecay(1.5f);  // Still not step 3's
+        const auto energy = stepEnergy();
+        REQUIRE(energy[2] > 0.0);
+        REQUIRE(energy[3] < energy[2] * 1e-2);
+        REQUIRE(energy[4] > energy[3] * 1e2);
+    }
+
+    SECTION("Cleared, the step goes back to the knob")
+    {
+        engine.clearStepLock(3, StepLock::VcfVcaDecay);
+        REQUIRE_FALSE(engine.isStepLocked(3, StepLock::VcfVcaDecay));
+        const auto energy = stepEnergy();
+        REQUIRE(energy[3] == Approx(energy[2]).epsilon(0.5));
+    }
+
+    SECTION("Step boundaries apply the snapshots without allocating")
+    {
+        for (int step = 0; step < 8; ++step)
+            engine.setStepLock(step, StepLock::FilterCutoff, 200.0f + 400.0f * static_cast<float>(step));
+        std::array<double, 8> energy{};
+        const auto rt = RealtimeGuard::check([&] { energy = stepEnergy(); });
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.locks == 0);
+        REQUIRE(energy[7] > energy[0]);  // The brighter the cutoff, the more gets through
+    }
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // Reverb2's delay lines are a fixed 14 MB whatever the rate; the delay's
+    // 4 seconds of stereo float, rounded up to a power of two, and the FDN
+    // reverb's lines (128 KB at 48 kHz) are what grow with it
+    constexpr size_t BUDGET_48K = 17u << 20;
+    constexpr size_t BUDGET_192K = 24u << 20;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    const MemoryReport& at192k = reports[1].second;
+    INFO("48 kHz:\n" << at48k.toString() << "192 kHz:\n" << at192k.toString());
+
+    REQUIRE(at48k.getBytes("delay") == 262144 * 2 * sizeof(float));
+    REQUIRE(at192k.getBytes("delay") == 4 * at48k.getBytes("delay"));
+    REQUIRE(at48k.getBytes("reverb") > 0);
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+
+    CHECK(at48k.getInstanceBytes() <= BUDGET_48K);
+    CHECK(at192k.getInstanceBytes() <= BUDGET_192K);
+}
+
+TEST_CASE("Reverb's FDN engine decays on time in any block size", "[engine][reverb]")
+{
+    constexpr double SR = 48000.0;
+    constexpr int LENGTH = 96000;
+
+    // A 10 ms burst of noise, then silence
+    std::vector<float> inputL(LENGTH, 0.0f);
+    std::vector<float> inputR(LENGTH, 0.0f);
+    NoiseSource noise(7);
+    noise.fillPM1(inputL.data(), 480);
+    noise.fillPM1(inputR.data(), 480);
+
+    auto render = [&](const std::function<int(int)>& blockAt) {
+        Reverb reverb;
+        reverb.prepare(SR);
+        reverb.setEngine(Reverb::FDN);
+        reverb.setDecay(1.0f);
+        reverb.setDamping(0.0f);
+        reverb.setMix(1.0f);
+
+        std::pair<std::vector<float>, std::vector<float>> out{inputL, inputR};
+        for (int i = 0; i < LENGTH;)
+        {
+            const int n = std::min(blockAt(i), LENGTH - i);
+            reverb.processBlock(out.first.data() + i, out.second.data() + i, n);
+            i += n;
+        }
+        return out;
+    };
+
+    const auto whole = render([](int) { return 512; });
+    const auto ragged = render([](int i) { return 1 + (i * 7) % 97; });
+
+    SECTION("A block renders the same as any split of it")
+    {
+        REQUIRE(whole.first == ragged.first);
+        REQUIRE(whole.second == ragged.second);
+    }
+
+    SECTION("The tail falls 60 dB in the decay time")
+    {
+        auto energyDb = [&](double seconds) {
+            const int start = static_cast<int>(seconds * SR);
+            double sum = 0.0;
+            for (int i = start; i < start + 2400; ++i)
+                sum += whole.first[i] * whole.first[i] + whole.second[i] * whole.second[i];
+            return 10.0 * std::log10(sum);
+        };
+
+        const double drop = energyDb(0.25) - energyDb(1.25);
+        CHECK(drop > 54.0);
+        CHECK(drop < 72.0);
+    }
+
+    SECTION("The left and right tails differ")
+    {
+        REQUIRE(whole.first != whole.second);
+        REQUIRE(isBufferValid(whole.first.data(), LENGTH));
+    }
+}
+
+TEST_CASE("SynthEngine switches quality tiers between hits", "[engine][quality]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+    std::array<float, bufferSize> left{};
+    std::array<float, bufferSize> right{};
+
+    engine.prepare(48000.0, bufferSize);
+    engine.setOversampling(2);
+    engine.setSaturatorMix(1.0f);
+    engine.setVCFVCAEnvDecay(0.02f);
+    engine.setTempo(40.0f);
+    engine.setRunning(true);
+
+    SECTION("Normal leaves the oversampling parameter; the tiers' factors wait for silence")
+    {
+        REQUIRE(engine.getQualityTier() == QualityTier::Normal);
+        REQUIRE(engine.getOversampling() == 2);
+
+        for (QualityTier tier : {QualityTier::High, QualityTier::Draft, QualityTier::Normal})
+        {
+            engine.setQualityTier(tier);
+            const int expected = forTier(tier, 1, 2, 4);
+            int blocks = 0;
+            for (; blocks < 400 && engine.getOversampling() != expected; ++blocks)
+                engine.renderBlock(left.data(), right.data(), bufferSize);
+            REQUIRE(engine.getOversampling() == expected);
+        }
+    }
+
+    SECTION("Every tier plays, and switching doesn't allocate")
+    {
+        float peak = 0.0f;
+        bool valid = true;
+        const auto rt = RealtimeGuard::check([&] {
+            for (int block = 0; block < 300; ++block)
+            {
+                engine.setQualityTier(qualityTierFromIndex(block / 100));
+                engine.renderBlock(left.data(), right.data(), bufferSize);
+                valid = valid && isBufferValid(left.data(), bufferSize);
+                for (float x : left)
+                    peak = std::max(peak, std::abs(x));
+            }
+        });
+
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.locks == 0);
+        REQUIRE(valid);
+        REQUIRE(peak > 0.01f);
+    }
+}
+
+TEST_CASE("SynthEngine matches its golden renders", "[engine][golden]")
+{
+    struct Scenario
+    {
+        const char* name;
+        double seconds;
+        std::function<void(SynthEngine&, long)> script;
+    };
+
+    const Scenario scenarios[] = {
+        {"sequence", 3.0, [](SynthEngine& engine, long frame) {
+             if (frame == 0)
+             {
+                 engine.setTempo(140.0f);
+                 engine.setFMAmount(0.3f);
+                 engine.setFilterCutoff(900.0f);
+                 engine.setFilterResonance(0.6f);
+                 engine.setRunning(true);
+             }
+         }},
+        {"saturated", 3.0, [](SynthEngine& engine, long frame) {
+             // The saturator driven hard, into the delay
+             if (frame == 0)
+             {
+                 engine.setTempo(120.0f);
+                 engine.setSaturatorDrive(8.0f);
+                 engine.setSaturatorMix(1.0f);
+                 engine.setDelayTime(0.25f);
+                 engine.setDelayFeedback(0.4f);
+                 engine.setDelayMix(0.3f);
+                 engine.setRunning(true);
+             }
+         }},
+    };
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto audio = GoldenRender::render<SynthEngine>(48000.0, scenario.seconds, scenario.script);
+        const std::string diff = GoldenRender::check(GOLDEN_DIR, scenario.name,
+                                                     GoldenRender::fingerprint(audio, 48000.0), {});
+        INFO(scenario.name << ":\n" << diff);
+        CHECK(diff.empty());
+    }
+}
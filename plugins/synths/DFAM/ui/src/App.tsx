@@ -37,7 +37,8 @@ const getNormalized = (paramId: string, rawValue: number): number => {
 };
 
 const App: React.FC = () => {
-  const { isConnected, audioData: bridgeAudioData } = useJUCEBridge({ enableAudioData: true });
+  const { isConnected, audioData: bridgeAudioData, impulseName, loadImpulse, clearImpulse } =
+    useJUCEBridge({ enableAudioData: true, liveViews: ['scope', 'sequencer'] });
 
   const { paramValues, handleChange } = useParameters({
     parameters: PARAMETER_DEFINITIONS,
@@ -332,6 +333,10 @@ const App: React.FC = () => {
               value={getDenormalized('sat_mix', paramValues.sat_mix ?? 0)}
               onChange={(v) => handleChange('sat_mix', getNormalized('sat_mix', v))}
             />
+            <SynthKnob label="OS" min={0} max={2} step={1} options={['OFF', '2X', '4X']}
+              value={getDenormalized('oversampling', paramValues.oversampling ?? 0)}
+              onChange={(v) => handleChange('oversampling', getNormalized('oversampling', v))}
+            />
           </div>
         </div>
 
@@ -370,6 +375,35 @@ const App: React.FC = () => {
               value={getDenormalized('reverb_mix', paramValues.reverb_mix ?? 0)}
               onChange={(v) => handleChange('reverb_mix', getNormalized('reverb_mix', v))}
             />
+            <SynthKnob label="TYPE" min={0} max={1} step={1} options={['R2', 'FDN']}
+              value={getDenormalized('reverb_engine', paramValues.reverb_engine ?? 0)}
+              onChange={(v) => handleChange('reverb_engine', getNormalized('reverb_engine', v))}
+            />
+          </div>
+        </div>
+
+        {/* Convolution */}
+        <div style={{ background: 'rgba(255,51,102,0.05)', border: '1px solid rgba(255,51,102,0.3)', borderRadius: '8px', padding: '10px' }}>
+          <div style={{ color: '#ff6688', fontSize: '10px', fontWeight: 'bold', letterSpacing: '1px', marginBottom: '8px', textAlign: 'center' }}>🏛 IR</div>
+          <div style={{ display: 'flex', gap: '6px', alignItems: 'center' }}>
+            <div style={{ display: 'flex', flexDirection: 'column', gap: '4px', width: '84px' }}>
+              <button onClick={loadImpulse}
+                style={{ background: '#1a1a1a', border: '1px solid rgba(255,51,102,0.5)', borderRadius: '4px', color: '#ff6688', fontSize: '9px', padding: '4px', cursor: 'pointer' }}>
+                LOAD
+              </button>
+              <button onClick={clearImpulse} disabled={!impulseName}
+                style={{ background: '#1a1a1a', border: '1px solid #333', borderRadius: '4px', color: '#888', fontSize: '9px', padding: '4px', cursor: 'pointer' }}>
+                CLEAR
+              </button>
+              <div style={{ color: '#888', fontSize: '9px', overflow: 'hidden', textOverflow: 'ellipsis', whiteSpace: 'nowrap' }}
+                title={impulseName}>
+                {impulseName || 'None'}
+              </div>
+            </div>
+            <SynthKnob label="MIX" min={0} max={1}
+              value={getDenormalized('conv_mix', paramValues.conv_mix ?? 0)}
+              onChange={(v) => handleChange('conv_mix', getNormalized('conv_mix', v))}
+            />
           </div>
         </div>
 
@@ -7,7 +7,7 @@
  *
  * Communication Flow:
  *   React -> JUCE: window.__JUCE__.backend.emitEvent("__juce__invoke", ...)
- *   JUCE -> React: window.onParameterUpdate(), window.onAudioData(), etc.
+ *   JUCE -> React: window.onParametersUpdate(), window.onAudioData(), etc.
  *
  * IMPORTANT: JUCE 8 native functions registered with withNativeFunction()
  * are NOT directly accessible on window.__JUCE__.backend. They must be
@@ -41,13 +41,24 @@ declare global {
     };
     /** Called by JUCE when a parameter changes */
     onParameterUpdate?: (paramId: string, value: number) => void;
+    /** Called by JUCE once per UI tick with every parameter that changed */
+    onParametersUpdate?: (values: Record<string, number>) => void;
     /** Called by JUCE with all parameter state */
     onStateUpdate?: (state: Record<string, number>) => void;
     /** Called by JUCE with audio visualization data */
     onAudioData?: (samples: number[]) => void;
+    /** Called by JUCE with base64 Float32 scope samples (see decodeScopeSamples) */
+    onAudioDataBase64?: (data: string) => void;
+    /** Called by JUCE with the loaded impulse response's name ('' if none) */
+    onImpulseUpdate?: (name: string) => void;
   }
 }
 
+/**
+ * Views that show live engine data; the editor ticks fast only while one is on screen
+ */
+export type LiveView = 'scope' | 'spectrum' | 'meters' | 'sequencer';
+
 /**
  * Hook configuration options
  */
@@ -58,6 +69,8 @@ export interface UseJUCEBridgeOptions {
   audioChannel?: 'lead' | 'drum' | 'sub' | 'master';
   /** Enable preset management */
   enablePresets?: boolean;
+  /** Live views on screen (default: ["scope"] with enableAudioData, else none) */
+  liveViews?: LiveView[];
 }
 
 /**
@@ -88,6 +101,12 @@ export interface UseJUCEBridgeReturn {
   noteOn: (note: number, velocity: number) => void;
   /** Trigger MIDI note off */
   noteOff: (note: number) => void;
+  /** Name of the convolver's impulse response, '' if none */
+  impulseName: string;
+  /** Open the file chooser for an impulse response */
+  loadImpulse: () => void;
+  /** Drop the impulse response */
+  clearImpulse: () => void;
   /** Register callback for parameter updates from JUCE */
   onParameterChange: (callback: (paramId: string, value: number) => void) => void;
   /** Register callback for full state updates from JUCE */
@@ -101,6 +120,14 @@ const isJUCEWebView = (): boolean => {
   return typeof window !== 'undefined' && window.__JUCE__ !== undefined;
 };
 
+/**
+ * Decode scope samples sent by the editor: base64 of little-endian Float32
+ */
+const decodeScopeSamples = (data: string): number[] => {
+  const bytes = Uint8Array.from(atob(data), (c) => c.charCodeAt(0));
+  return Array.from(new Float32Array(bytes.buffer, 0, bytes.length >> 2));
+};
+
 /**
  * React hook for JUCE WebView integration
  *
@@ -118,11 +145,12 @@ const isJUCEWebView = (): boolean => {
  * ```
  */
 export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridgeReturn {
-  const { enableAudioData = false } = options;
+  const { enableAudioData = false, liveViews = enableAudioData ? ['scope'] : [] } = options;
 
   const [isConnected, setIsConnected] = useState(false);
   const [juceInfo, setJuceInfo] = useState<JUCEInfo>({});
   const [audioData, setAudioData] = useState<number[]>([]);
+  const [impulseName, setImpulseName] = useState('');
 
   // Callback refs for JUCE -> React communication
   const parameterCallbackRef = useRef<((paramId: string, value: number) => void) | null>(null);
@@ -150,6 +178,13 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     // Full state update handler
     window.onStateUpdate = (state: Record<string, number>) => {
       if (stateCallbackRef.current) {
@@ -157,17 +192,27 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    window.onImpulseUpdate = (name: string) => {
+      setImpulseName(name);
+    };
+
     // Audio data handler
     if (enableAudioData) {
       window.onAudioData = (samples: number[]) => {
         setAudioData(samples);
       };
+      window.onAudioDataBase64 = (data: string) => {
+        setAudioData(decodeScopeSamples(data));
+      };
     }
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
+      window.onImpulseUpdate = undefined;
       window.onAudioData = undefined;
+      window.onAudioDataBase64 = undefined;
     };
   }, [isConnected, enableAudioData]);
 
@@ -182,6 +227,21 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     });
   }, [isConnected]);
 
+  // Tell the editor which live views are on screen (none while the page is
+  // hidden), so it only ticks fast and feeds the scope while they are
+  const liveViewKey = liveViews.join(',');
+  useEffect(() => {
+    if (!isConnected || liveViewKey === '') return;
+    const views = liveViewKey.split(',');
+    const report = () => callNativeFunction("setLiveViews", document.hidden ? [] : views);
+    report();
+    document.addEventListener('visibilitychange', report);
+    return () => {
+      document.removeEventListener('visibilitychange', report);
+      callNativeFunction("setLiveViews", []);
+    };
+  }, [isConnected, liveViewKey, callNativeFunction]);
+
   // Send parameter to JUCE
   const setParameter = useCallback((paramId: string, value: number) => {
     if (!isConnected) return;
@@ -207,6 +267,15 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     callNativeFunction("noteOff", [note]);
   }, [isConnected, callNativeFunction]);
 
+  // Impulse response file chooser (the editor answers with onImpulseUpdate)
+  const loadImpulse = useCallback(() => {
+    callNativeFunction("loadImpulse", []);
+  }, [callNativeFunction]);
+
+  const clearImpulse = useCallback(() => {
+    callNativeFunction("clearImpulse", []);
+  }, [callNativeFunction]);
+
   // Register parameter change callback
   const onParameterChange = useCallback((callback: (paramId: string, value: number) => void) => {
     parameterCallbackRef.current = callback;
@@ -225,6 +294,9 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     requestState,
     noteOn,
     noteOff,
+    impulseName,
+    loadImpulse,
+    clearImpulse,
     onParameterChange,
     onStateChange,
   };
@@ -296,6 +296,7 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
 
   sat_drive: { id: 'sat_drive', name: 'Drive', min: 1, max: 20, default: 1 },
   sat_mix: { id: 'sat_mix', name: 'Drive Mix', min: 0, max: 1, default: 0 },
+  oversampling: { id: 'oversampling', name: 'Oversampling', min: 0, max: 2, default: 0, step: 1 },
 
   // =========================================================================
   // EFFECTS - DELAY
@@ -312,6 +313,13 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
   reverb_decay: { id: 'reverb_decay', name: 'Reverb Decay', min: 0.1, max: 10, default: 2, unit: 's' },
   reverb_damping: { id: 'reverb_damping', name: 'Reverb Damping', min: 0, max: 1, default: 0.5 },
   reverb_mix: { id: 'reverb_mix', name: 'Reverb Mix', min: 0, max: 1, default: 0 },
+  reverb_engine: { id: 'reverb_engine', name: 'Reverb Engine', min: 0, max: 1, default: 0, step: 1 },
+
+  // =========================================================================
+  // EFFECTS - CONVOLUTION
+  // =========================================================================
+
+  conv_mix: { id: 'conv_mix', name: 'Convolution Mix', min: 0, max: 1, default: 0 },
 
   // =========================================================================
   // EFFECTS - COMPRESSOR
@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -16,22 +17,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    carrierRatioParam = apvts.getRawParameterValue("carrier_ratio");
-    carrierLevelParam = apvts.getRawParameterValue("carrier_level");
-    modRatioParam = apvts.getRawParameterValue("mod_ratio");
-    modDepthParam = apvts.getRawParameterValue("mod_depth");
-    modFeedbackParam = apvts.getRawParameterValue("mod_feedback");
-    modAttackParam = apvts.getRawParameterValue("mod_attack");
-    modDecayParam = apvts.getRawParameterValue("mod_decay");
-    modSustainParam = apvts.getRawParameterValue("mod_sustain");
-    modReleaseParam = apvts.getRawParameterValue("mod_release");
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
-    driftRateParam = apvts.getRawParameterValue("drift_rate");
-    driftAmountParam = apvts.getRawParameterValue("drift_amount");
-    masterLevelParam = apvts.getRawParameterValue("master_level");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -202,13 +193,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     // Prepare synth engine
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    // Clear visualization buffer
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Live, released notes give their voices up to the next ones; a bounce
+    // keeps every tail following the automation
+    synthEngine.setTailFreeze(!isNonRealtime());
+
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -220,12 +216,22 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = synthEngine.getActiveVoiceCount();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     // CRITICAL: Suppress denormals for performance
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     // Clear output buffer
     buffer.clear();
 
@@ -233,23 +239,17 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read parameters (lock-free via atomics)
-    synthEngine.setCarrierRatio(carrierRatioParam->load());
-    synthEngine.setCarrierLevel(carrierLevelParam->load());
-    synthEngine.setModRatio(modRatioParam->load());
-    synthEngine.setModDepth(modDepthParam->load());
-    synthEngine.setModFeedback(modFeedbackParam->load());
-    synthEngine.setModAttack(modAttackParam->load());
-    synthEngine.setModDecay(modDecayParam->load());
-    synthEngine.setModSustain(modSustainParam->load());
-    synthEngine.setModRelease(modReleaseParam->load());
-    synthEngine.setAmpAttack(ampAttackParam->load());
-    synthEngine.setAmpDecay(ampDecayParam->load());
-    synthEngine.setAmpSustain(ampSustainParam->load());
-    synthEngine.setAmpRelease(ampReleaseParam->load());
-    synthEngine.setDriftRate(driftRateParam->load());
-    synthEngine.setDriftAmount(driftAmountParam->load());
-    synthEngine.setMasterLevel(masterLevelParam->load());
+    // Read parameters (lock-free via atomics) and update the ones that changed
+    params.update();
+    synthEngine.applySnapshot(params);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -269,24 +269,21 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition);
         }
     }
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer (for UI oscilloscope)
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -304,18 +301,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
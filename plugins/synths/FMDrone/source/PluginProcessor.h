@@ -9,6 +9,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 /**
  * @brief FM Drone audio processor
@@ -56,8 +59,17 @@ public:
     /** Audio parameter value tree state - use for UI binding */
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+
+    /** On-screen keyboard notes for processBlock() (pushed on the message thread) */
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
 
 private:
     /** Create the parameter layout - called once in constructor */
@@ -70,36 +82,11 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters (lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // Carrier
-    std::atomic<float>* carrierRatioParam = nullptr;
-    std::atomic<float>* carrierLevelParam = nullptr;
-
-    // Modulator
-    std::atomic<float>* modRatioParam = nullptr;
-    std::atomic<float>* modDepthParam = nullptr;
-    std::atomic<float>* modFeedbackParam = nullptr;
-
-    // Modulator envelope
-    std::atomic<float>* modAttackParam = nullptr;
-    std::atomic<float>* modDecayParam = nullptr;
-    std::atomic<float>* modSustainParam = nullptr;
-    std::atomic<float>* modReleaseParam = nullptr;
-
-    // Amp envelope
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
-
-    // Drift
-    std::atomic<float>* driftRateParam = nullptr;
-    std::atomic<float>* driftAmountParam = nullptr;
-
-    // Master
-    std::atomic<float>* masterLevelParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     //==========================================================================
     // State
@@ -108,8 +95,17 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    /** Buffer for UI visualization */
-    std::array<float, 512> visualizationBuffer{};
+    /** Audio thread -> UI oscilloscope samples */
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+
+    /** UI keyboard -> audio thread notes */
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -6,6 +6,14 @@
  *
  * Signal Flow:
  *   MIDI -> Voice Manager -> [Voice Pool] -> [Mix] -> Output
+ *                                 |            ^
+ *                                 +-> [Frozen Tails]
+ *
+ * With tail freeze on (setTailFreeze()), a released voice leaves the pool
+ * once the parameters have held still for a block: its tail plays on from
+ * a copy (FrozenTails.h) and the voice takes the next note. Four voices
+ * then play four notes over up to MAX_TAILS long releases, instead of
+ * stealing one of them.
  */
 
 #pragma once
@@ -13,6 +21,13 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
+#include "ActiveVoiceList.h"
+#include "FrozenTails.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
 
 /**
  * @brief FM Drone synthesizer engine
@@ -32,6 +47,9 @@ public:
     /** Block size for internal processing */
     static constexpr int BLOCK_SIZE = 64;
 
+    /** Released tails that can play out of the voice pool at once */
+    static constexpr int MAX_TAILS = 8;
+
     SynthEngine() = default;
     ~SynthEngine() = default;
 
@@ -43,6 +61,7 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
 
         // Prepare all voices
         for (auto& voice : voices)
@@ -50,6 +69,8 @@ public:
             voice.prepare(sampleRate);
         }
 
+        tails.clear();
+
         // Clear buffers
         std::fill(mixBufferL.begin(), mixBufferL.end(), 0.0f);
         std::fill(mixBufferR.begin(), mixBufferR.end(), 0.0f);
@@ -64,9 +85,25 @@ public:
     // MIDI Handling
     //==========================================================================
 
+    /**
+     * @brief Retune: note frequencies from @p table from the next note on
+     *
+     * Copies the table (128 floats: fine on the audio thread). A 12-TET
+     * table puts the voices back on PitchTables.
+     */
+    void setTuning(const TuningTable& table)
+    {
+        tuning = table;
+        for (auto& voice : voices)
+            voice.setTuning(tuning.isEqualTemperament() ? nullptr : &tuning);
+    }
+
+    const TuningTable& getTuning() const { return tuning; }
+
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -74,38 +111,53 @@ public:
             return;
         }
 
+        // Keys the tuning leaves unmapped are silent
+        if (!tuning.isMapped(note))
+            return;
+
         Voice* voice = findFreeVoice(note);
         if (voice)
         {
             // Apply current parameters to voice before noteOn
             applyParametersToVoice(*voice);
             voice->noteOn(note, velocity);
+            active.add(static_cast<int>(voice - voices.data()));
         }
     }
 
     void noteOff(int note, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
-        for (auto& voice : voices)
+        for (int v : active)
         {
-            if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
+            Voice& voice = voices[v];
+            if (voice.getNote() == note && !voice.isReleasing())
             {
                 voice.noteOff();
             }
         }
     }
 
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voices[v].kill();
         }
+        active.clear();
+        tails.clear();
     }
 
-    void setPitchBend(float bend)
+    void setPitchBend(float bend, int sampleOffset = 0)
     {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend}))
+            return;
+
         pitchBend = bend;
     }
 
@@ -115,28 +167,20 @@ public:
 
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        // Clear mix buffers
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        // Update and render all active voices
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
+        perfStats.beginBlock();
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
             {
-                // Update voice parameters
-                applyParametersToVoice(voice);
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+                renderVoices(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
 
-        // Copy to output with master gain
-        float gain = masterGain;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            outputL[i] = mixBufferL[i] * gain;
-            outputR[i] = mixBufferR[i] * gain;
-        }
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
     //==========================================================================
@@ -144,49 +188,182 @@ public:
     //==========================================================================
 
     // Carrier
-    void setCarrierRatio(float ratio) { carrierRatio = ratio; }
-    void setCarrierLevel(float level) { carrierLevel = level; }
+    void setCarrierRatio(float ratio) { updateParam(carrierRatio, ratio); }
+    void setCarrierLevel(float level) { updateParam(carrierLevel, level); }
 
     // Modulator
-    void setModRatio(float ratio) { modRatio = ratio; }
-    void setModDepth(float depth) { modDepth = depth; }
-    void setModFeedback(float fb) { modFeedback = fb; }
+    void setModRatio(float ratio) { updateParam(modRatio, ratio); }
+    void setModDepth(float depth) { updateParam(modDepth, depth); }
+    void setModFeedback(float fb) { updateParam(modFeedback, fb); }
 
     // Modulator envelope
-    void setModAttack(float a) { modAttack = a; }
-    void setModDecay(float d) { modDecay = d; }
-    void setModSustain(float s) { modSustain = s; }
-    void setModRelease(float r) { modRelease = r; }
+    void setModAttack(float a) { updateParam(modAttack, a); }
+    void setModDecay(float d) { updateParam(modDecay, d); }
+    void setModSustain(float s) { updateParam(modSustain, s); }
+    void setModRelease(float r) { updateParam(modRelease, r); }
 
     // Amp envelope
-    void setAmpAttack(float a) { ampAttack = a; }
-    void setAmpDecay(float d) { ampDecay = d; }
-    void setAmpSustain(float s) { ampSustain = s; }
-    void setAmpRelease(float r) { ampRelease = r; }
+    void setAmpAttack(float a) { updateParam(ampAttack, a); }
+    void setAmpDecay(float d) { updateParam(ampDecay, d); }
+    void setAmpSustain(float s) { updateParam(ampSustain, s); }
+    void setAmpRelease(float r) { updateParam(ampRelease, r); }
 
     // Drift
-    void setDriftRate(float rate) { driftRate = rate; }
-    void setDriftAmount(float amount) { driftAmount = amount; }
+    void setDriftRate(float rate) { updateParam(driftRate, rate); }
+    void setDriftAmount(float amount) { updateParam(driftAmount, amount); }
 
     // Master
-    void setMasterLevel(float level) { masterLevel = level; masterGain = level; }
+    void setMasterLevel(float level) { updateParam(masterLevel, level); masterGain = level; }
+
+    /**
+     * @brief Free released voices for new notes by playing their tails from copies
+     *
+     * The copies keep the parameters they had when they froze, so a change
+     * made during a long release doesn't reach the notes already let go.
+     * Off by default; the processor turns it on for live playing.
+     */
+    void setTailFreeze(bool on)
+    {
+        tailFreeze = on;
+        if (!on)
+            tails.clear();
+    }
+
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Carrier
+        if (p.changed(kCarrierRatio)) setCarrierRatio(p[kCarrierRatio]);
+        if (p.changed(kCarrierLevel)) setCarrierLevel(p[kCarrierLevel]);
+
+        // Modulator
+        if (p.changed(kModRatio)) setModRatio(p[kModRatio]);
+        if (p.changed(kModDepth)) setModDepth(p[kModDepth]);
+        if (p.changed(kModFeedback)) setModFeedback(p[kModFeedback]);
+
+        // Modulator envelope
+        if (p.changed(kModAttack)) setModAttack(p[kModAttack]);
+        if (p.changed(kModDecay)) setModDecay(p[kModDecay]);
+        if (p.changed(kModSustain)) setModSustain(p[kModSustain]);
+        if (p.changed(kModRelease)) setModRelease(p[kModRelease]);
+
+        // Amp envelope
+        if (p.changed(kAmpAttack)) setAmpAttack(p[kAmpAttack]);
+        if (p.changed(kAmpDecay)) setAmpDecay(p[kAmpDecay]);
+        if (p.changed(kAmpSustain)) setAmpSustain(p[kAmpSustain]);
+        if (p.changed(kAmpRelease)) setAmpRelease(p[kAmpRelease]);
+
+        // Drift
+        if (p.changed(kDriftRate)) setDriftRate(p[kDriftRate]);
+        if (p.changed(kDriftAmount)) setDriftAmount(p[kDriftAmount]);
+
+        // Master
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+    }
 
     //==========================================================================
     // State Queries
     //==========================================================================
 
-    int getActiveVoiceCount() const
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** Released tails playing out of the voice pool */
+    int getFrozenTailCount() const { return tails.size(); }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
     {
-        int count = 0;
-        for (const auto& voice : voices)
+        MemoryReport report(sizeof(*this));
+        report.addInline("voices", sizeof(voices));
+        report.addInline("mix buffers", sizeof(mixBufferL) + sizeof(mixBufferR));
+        report.addInline("frozen tails", sizeof(tails));
+        report.addShared("pitch tables", sizeof(PitchTables));
+        report.addShared("sine table", sizeof(FMSineTable));
+        return report;
+    }
+
+private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** Render one sub-block between MIDI events */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
+    {
+        // Clear mix buffers
+        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
+        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            // Tails frozen in earlier blocks first: one frozen below starts next block
+            tails.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+
+            // A released voice can freeze once no parameter moved for a whole block
+            const bool paramsStill = paramRevision == lastBlockRevision;
+            lastBlockRevision = paramRevision;
+
+            // Update and render all active voices
+            active.update([&](int v)
+            {
+                Voice& voice = voices[v];
+                // Update voice parameters
+                applyParametersToVoice(voice);
+                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+
+                if (tailFreeze && paramsStill && voice.isReleasing() && voice.isActive() && tails.freeze(voice))
+                {
+                    voice.kill();
+                    return false;
+                }
+                return voice.isActive();
+            });
+        }
+
         {
-            if (voice.isActive())
-                ++count;
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+
+            // Copy to output with master gain
+            float gain = masterGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] = mixBufferL[i] * gain;
+                outputR[i] = mixBufferR[i] * gain;
+            }
+        }
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value); break;
+        default: break;
+        }
+    }
+
+    /** Store a parameter, counting the change if it is one */
+    void updateParam(float& field, float value)
+    {
+        if (field != value)
+        {
+            field = value;
+            ++paramRevision;
         }
-        return count;
     }
 
-private:
     //==========================================================================
     // Voice Management
     //==========================================================================
@@ -211,14 +388,15 @@ private:
         voice.setMasterLevel(masterLevel);
     }
 
-    Voice* findFreeVoice(int note)
+    Voice* findFreeVoice(int /*note*/)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
+        // First, any voice not on the active list
+        if (!active.isFull())
         {
-            if (!voice.isActive())
+            for (int v = 0; v < MAX_VOICES; ++v)
             {
-                return &voice;
+                if (!active.contains(v))
+                    return &voices[v];
             }
         }
 
@@ -266,6 +444,18 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** Note frequencies the voices read at note on (see TuningTable.h) */
+    TuningTable tuning;
+
+    /** The voices sounding, the only ones rendered, released or counted */
+    ActiveVoiceList<MAX_VOICES> active;
+
+    /** Released voices' tails, playing on from copies (setTailFreeze()) */
+    FrozenTails<Voice, MAX_TAILS> tails;
+    bool tailFreeze = false;
+    uint32_t paramRevision = 0;      // Bumped by every setter that changes a value
+    uint32_t lastBlockRevision = 0;  // paramRevision at the last sub-block
+
     //==========================================================================
     // Mix Buffers
     //==========================================================================
@@ -282,6 +472,12 @@ private:
     float pitchBend = 0.0f;
     float masterGain = 0.7f;
 
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
     //==========================================================================
     // FM Parameters (cached for voice updates)
     //==========================================================================
@@ -0,0 +1,52 @@
+/**
+ * @file SynthParams.h
+ * @brief FMDrone parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(CarrierRatio, "carrier_ratio") \
+    X(CarrierLevel, "carrier_level") \
+    X(ModRatio,     "mod_ratio") \
+    X(ModDepth,     "mod_depth") \
+    X(ModFeedback,  "mod_feedback") \
+    X(ModAttack,    "mod_attack") \
+    X(ModDecay,     "mod_decay") \
+    X(ModSustain,   "mod_sustain") \
+    X(ModRelease,   "mod_release") \
+    X(AmpAttack,    "amp_attack") \
+    X(AmpDecay,     "amp_decay") \
+    X(AmpSustain,   "amp_sustain") \
+    X(AmpRelease,   "amp_release") \
+    X(DriftRate,    "drift_rate") \
+    X(DriftAmount,  "drift_amount") \
+    X(MasterLevel,  "master_level")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
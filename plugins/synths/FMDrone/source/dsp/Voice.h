@@ -8,12 +8,26 @@
  *                      Mod Envelope              Drift LFO
  *
  * Based on classic DX7-style FM synthesis but simplified for ambient/drone sounds.
+ *
+ * The drift LFO, modulator and carrier are three lanes of one FMOperatorQuad
+ * (table sines, one SIMD pass per sample). The carrier needs this sample's
+ * modulator, so its lane runs a sample behind and the voice's output is one
+ * sample late; the drift lane runs a sample ahead so every increment is
+ * known before the pass.
  */
 
 #pragma once
 
 #include <cmath>
 #include <array>
+#include <algorithm>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+#include "FastMath.h"
+#include "FMOperator.h"
+#include "PitchTables.h"
+#include "TuningTable.h"
 
 /**
  * @brief Simple envelope stages
@@ -59,6 +73,9 @@ public:
     // Note Events
     //==========================================================================
 
+    /** Note frequencies from @p table (nullptr: 12-TET from PitchTables); the engine owns it */
+    void setTuning(const TuningTable* table) { tuning = table; }
+
     void noteOn(int note, float vel)
     {
         currentNote = note;
@@ -68,13 +85,17 @@ public:
         age = 0;
 
         // Calculate base frequency from MIDI note
-        baseFrequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
-
-        // Reset oscillator phases for clean attack
-        carrierPhase = 0.0f;
-        modulatorPhase = 0.0f;
-        driftPhase = 0.0f;
-        feedbackSample = 0.0f;
+        baseFrequency = noteToFrequency(note);
+
+        // Reset oscillator phases for clean attack. The drift lane starts a
+        // sample in; the carrier a sample back, so its first, discarded,
+        // pass lands it on 0
+        operators.reset(driftRate * sampleRateInv, 0.0f, -baseFrequency * carrierRatio * sampleRateInv, 0.0f);
+        driftNow = 0.0f;
+        driftPrev = 0.0f;
+        modulatorPrev = 0.0f;
+        fmIndexPrev = 0.0f;
+        ampEnvPrev = 0.0f;
 
         // Trigger envelopes
         ampEnvStage = EnvStage::Attack;
@@ -163,6 +184,14 @@ public:
     void setMasterLevel(float level) { masterLevel = level; }
 
 private:
+    /** The note's frequency in the current tuning */
+    float noteToFrequency(int note) const
+    {
+        return tuning != nullptr ? tuning->frequency(note) : PitchTables::get().midiToFrequency(static_cast<float>(note));
+    }
+
+    const TuningTable* tuning = nullptr;  // The engine's, when it isn't 12-TET
+
     //==========================================================================
     // Block Rendering
     //==========================================================================
@@ -182,6 +211,14 @@ private:
         // Higher values = more harmonics, typical range 0-8
         float maxFmIndex = modDepth * 8.0f;
 
+        operators.setFeedback(SIMD_MM(setr_ps)(0.0f, modFeedback, 0.0f, 0.0f));
+
+        const float gain = carrierLevel * velocity * masterLevel;
+        alignas(16) float dry[BLOCK_SIZE] = {};
+        alignas(16) float spread[BLOCK_SIZE];
+        alignas(16) float lanes[4];
+
+        int rendered = blockSize;
         for (int i = 0; i < blockSize; ++i)
         {
             // Process envelopes
@@ -192,49 +229,42 @@ private:
             if (ampEnvStage == EnvStage::Idle && releasing)
             {
                 active = false;
-                return;
+                rendered = i;
+                break;
             }
 
-            // Drift LFO (slow sine wave for organic movement)
-            float drift = std::sin(driftPhase * TWO_PI) * driftAmount * 0.02f;
-            driftPhase += driftPhaseInc;
-            if (driftPhase >= 1.0f)
-                driftPhase -= 1.0f;
-
-            // Apply drift to both oscillators
-            float driftedCarrierPhaseInc = carrierPhaseInc * (1.0f + drift);
-            float driftedModPhaseInc = modulatorPhaseInc * (1.0f + drift * 0.5f);
-
-            // Modulator with feedback
-            float modulatorInput = modulatorPhase + feedbackSample * modFeedback;
-            float modulatorOut = std::sin(modulatorInput * TWO_PI);
-            feedbackSample = modulatorOut;
-
-            // Update modulator phase
-            modulatorPhase += driftedModPhaseInc;
-            if (modulatorPhase >= 1.0f)
-                modulatorPhase -= 1.0f;
+            // One pass: lane 0 is next sample's drift LFO (slow sine for
+            // organic movement), lane 1 this sample's modulator (with
+            // feedback), lane 2 last sample's carrier, modulated by last
+            // sample's modulator
+            const auto pm = SIMD_MM(setr_ps)(0.0f, 0.0f, modulatorPrev * fmIndexPrev / TWO_PI, 0.0f);
+            const auto increments = SIMD_MM(setr_ps)(driftPhaseInc,
+                                                     modulatorPhaseInc * (1.0f + driftNow * 0.5f),
+                                                     carrierPhaseInc * (1.0f + driftPrev),
+                                                     0.0f);
+            SIMD_MM(store_ps)(lanes, operators.process(pm, increments));
 
-            // FM synthesis: modulator output modulates carrier phase
-            float fmIndex = maxFmIndex * modEnvOut;
-            float carrierInput = carrierPhase + (modulatorOut * fmIndex / TWO_PI);
-            float carrierOut = std::sin(carrierInput * TWO_PI);
+            // Apply amplitude envelope and levels (soft clipped below)
+            dry[i] = lanes[2] * gain * ampEnvPrev * 1.2f;
 
-            // Update carrier phase
-            carrierPhase += driftedCarrierPhaseInc;
-            if (carrierPhase >= 1.0f)
-                carrierPhase -= 1.0f;
+            // Output (mono summed to stereo with slight spread from drift)
+            spread[i] = driftPrev * 0.1f;
 
-            // Apply amplitude envelope and levels
-            float output = carrierOut * carrierLevel * ampEnvOut * velocity * masterLevel;
+            driftPrev = driftNow;
+            driftNow = lanes[0] * driftAmount * 0.02f;
+            modulatorPrev = lanes[1];
+            fmIndexPrev = maxFmIndex * modEnvOut;
+            ampEnvPrev = ampEnvOut;
+        }
 
-            // Soft clip for warmth
-            output = std::tanh(output * 1.2f);
+        // Soft clip for warmth, four samples at a time
+        for (int i = 0; i < rendered; i += 4)
+            SIMD_MM(store_ps)(dry + i, FastMath::tanh(SIMD_MM(load_ps)(dry + i)));
 
-            // Output (mono summed to stereo with slight spread from drift)
-            float spread = drift * 0.1f;
-            outputL[i] += output * (1.0f - spread);
-            outputR[i] += output * (1.0f + spread);
+        for (int i = 0; i < rendered; ++i)
+        {
+            outputL[i] += dry[i] * (1.0f - spread[i]);
+            outputR[i] += dry[i] * (1.0f + spread[i]);
         }
     }
 
@@ -258,13 +288,15 @@ private:
     // Base frequency from MIDI note
     float baseFrequency = 440.0f;
 
-    // Oscillator phases (0-1 range)
-    float carrierPhase = 0.0f;
-    float modulatorPhase = 0.0f;
-    float driftPhase = 0.0f;
+    // Drift LFO, modulator and carrier (lanes 0-2, see renderBlock)
+    FMOperatorQuad operators;
 
-    // Feedback state
-    float feedbackSample = 0.0f;
+    // What the pipelined lanes need from the samples either side
+    float driftNow = 0.0f;       // This sample's drift (lane 0 ran ahead)
+    float driftPrev = 0.0f;      // Last sample's, for the carrier lane
+    float modulatorPrev = 0.0f;  // Last sample's modulator and FM index
+    float fmIndexPrev = 0.0f;
+    float ampEnvPrev = 0.0f;     // Last sample's envelope, for the carrier's output
 
     //==========================================================================
     // Envelope State
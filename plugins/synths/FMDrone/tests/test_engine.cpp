@@ -13,9 +13,13 @@
 #include <catch2/catch_approx.hpp>
 #include <cmath>
 #include <array>
+#include <functional>
+#include <memory>
+#include <vector>
 
-// TODO: Include your synth engine implementation
-// #include "dsp/SynthEngine.h"
+#include "dsp/SynthEngine.h"
+#include "GoldenRender.h"
+#include "RealtimeGuard.h"
 
 using Catch::Approx;
 
@@ -254,3 +258,169 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("Tail freeze plays released notes on out of the voice pool", "[engine][voices]")
+{
+    auto makeEngine = [](bool freeze) {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 128);
+        engine->setAmpAttack(0.01f);
+        engine->setModAttack(0.01f);
+        engine->setAmpRelease(4.0f);
+        engine->setTailFreeze(freeze);
+        return engine;
+    };
+
+    auto run = [](SynthEngine& engine, std::vector<float>& out, int blocks) {
+        std::array<float, 128> l{}, r{};
+        for (int b = 0; b < blocks; ++b)
+        {
+            engine.renderBlock(l.data(), r.data(), 128);
+            out.insert(out.end(), l.begin(), l.end());
+        }
+    };
+
+    SECTION("A frozen tail is the voice's own, sample for sample")
+    {
+        std::vector<float> outputs[2];
+        for (int freeze = 0; freeze < 2; ++freeze)
+        {
+            auto engine = makeEngine(freeze == 1);
+            engine->noteOn(48, 0.9f);
+            engine->noteOn(55, 0.7f);
+            run(*engine, outputs[freeze], 40);
+            engine->noteOff(48);
+            engine->noteOff(55);
+            run(*engine, outputs[freeze], 200);
+
+            if (freeze == 1)
+            {
+                REQUIRE(engine->getActiveVoiceCount() == 0);
+                REQUIRE(engine->getFrozenTailCount() == 2);
+            }
+        }
+        REQUIRE(outputs[1] == outputs[0]);
+    }
+
+    SECTION("New notes take the released voices instead of stealing their tails")
+    {
+        auto engine = makeEngine(true);
+        for (int n = 0; n < SynthEngine::MAX_VOICES; ++n)
+            engine->noteOn(48 + 3 * n, 0.8f);
+        std::vector<float> out;
+        run(*engine, out, 40);
+        for (int n = 0; n < SynthEngine::MAX_VOICES; ++n)
+            engine->noteOff(48 + 3 * n);
+        run(*engine, out, 2);
+
+        REQUIRE(engine->getActiveVoiceCount() == 0);
+        REQUIRE(engine->getFrozenTailCount() == SynthEngine::MAX_VOICES);
+
+        for (int n = 0; n < SynthEngine::MAX_VOICES; ++n)
+            engine->noteOn(60 + 3 * n, 0.8f);
+        run(*engine, out, 4);
+        REQUIRE(engine->getActiveVoiceCount() == SynthEngine::MAX_VOICES);
+        REQUIRE(engine->getFrozenTailCount() == SynthEngine::MAX_VOICES);
+        REQUIRE(isBufferValid(out.data(), static_cast<int>(out.size())));
+
+        // A parameter moving holds off the next freeze for a block
+        engine->noteOff(60);
+        engine->setAmpRelease(3.0f);
+        run(*engine, out, 1);
+        REQUIRE(engine->getActiveVoiceCount() == SynthEngine::MAX_VOICES);
+        run(*engine, out, 1);
+        REQUIRE(engine->getActiveVoiceCount() == SynthEngine::MAX_VOICES - 1);
+
+        engine->allNotesOff();
+        REQUIRE(engine->getFrozenTailCount() == 0);
+    }
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // All inline, most of it the two 8192-sample mix buffers
+    constexpr size_t BUDGET = 128u << 10;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    INFO(at48k.toString());
+
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+    REQUIRE(at48k.getHeapBytes() == 0);
+    REQUIRE(reports[1].second.getInstanceBytes() == at48k.getInstanceBytes());
+    CHECK(at48k.getInstanceBytes() <= BUDGET);
+}
+
+TEST_CASE("SynthEngine matches its golden renders", "[engine][golden]")
+{
+    struct Scenario
+    {
+        const char* name;
+        double seconds;
+        std::function<void(SynthEngine&, long)> script;
+    };
+
+    const Scenario scenarios[] = {
+        {"drone", 3.0, [](SynthEngine& engine, long frame) {
+             // Deep modulation with feedback and drift: the table sine's worst case
+             if (frame == 0)
+             {
+                 engine.setModRatio(1.5f);
+                 engine.setModDepth(0.6f);
+                 engine.setModFeedback(0.3f);
+                 engine.setDriftAmount(0.5f);
+                 engine.noteOn(36, 0.9f);
+             }
+         }},
+        {"chord_release", 2.5, [](SynthEngine& engine, long frame) {
+             static constexpr int chord[] = {48, 55, 60, 63};
+             if (frame == 0)
+                 for (int note : chord)
+                     engine.noteOn(note, 0.8f);
+             if (frame == 57600)
+                 for (int note : chord)
+                     engine.noteOff(note);
+         }},
+    };
+
+    // The fast tanh soft clip lifts the drone's upper partials by about 1.5 dB
+    GoldenRender::Tolerance tolerance;
+    tolerance.bandDb = 2.0;
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto audio = GoldenRender::render<SynthEngine>(48000.0, scenario.seconds, scenario.script);
+        const std::string diff = GoldenRender::check(GOLDEN_DIR, scenario.name,
+                                                     GoldenRender::fingerprint(audio, 48000.0), tolerance);
+        INFO(scenario.name << ":\n" << diff);
+        CHECK(diff.empty());
+    }
+}
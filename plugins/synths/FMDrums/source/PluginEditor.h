@@ -9,6 +9,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "EditorRefresh.h"
+#include "ParamChangeFlags.h"
 
 class PluginEditor : public juce::AudioProcessorEditor,
                      private juce::Timer
@@ -22,9 +24,16 @@ public:
 
 private:
     void timerCallback() override;
-    void sendParameterToWebView(const juce::String& paramId, float value);
+
+    /** Match the timer to what's on screen; attaches the scope FIFO while it's wanted */
+    void updateRefreshRate();
+    void sendChangedParametersToWebView();
     void sendAllParametersToWebView();
     void sendAudioDataToWebView();
+    void sendOverrunsToWebView();
+    void sendSampleLayersToWebView();
+    void chooseSampleLayer(int drum);
+    juce::var getPerfStatsForWebView() const;
     void handleParameterFromWebView(const juce::String& paramId, float value);
     void handleNoteFromWebView(int note, float velocity, bool isNoteOn);
     std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
@@ -35,18 +44,35 @@ private:
     std::unique_ptr<juce::WebBrowserComponent> webView;
 #endif
 
+    /** Flags its parameter as changed; can run on the audio thread */
     struct ParameterListener : public juce::AudioProcessorValueTreeState::Listener
     {
         PluginEditor& editor;
-        explicit ParameterListener(PluginEditor& e) : editor(e) {}
-        void parameterChanged(const juce::String& paramId, float newValue) override
+        const int index;
+        ParameterListener(PluginEditor& e, int i) : editor(e), index(i) {}
+        void parameterChanged(const juce::String&, float) override
         {
-            editor.sendParameterToWebView(paramId, newValue);
+            if (!editor.ignoreParameterCallbacks)
+                editor.changedParameters.mark(index);
         }
     };
-    std::unique_ptr<ParameterListener> paramListener;
+    std::vector<std::unique_ptr<ParameterListener>> paramListeners;
+    juce::Array<juce::RangedAudioParameter*> listenedParameters;  // By listener index
+    ParamChangeFlags changedParameters;  // Sent by timerCallback()
+
+    std::atomic<bool> ignoreParameterCallbacks{false};
+
+    /** Newest output samples sent to the oscilloscope per timer tick */
+    static constexpr int SCOPE_WINDOW = 1024;
+    std::array<float, SCOPE_WINDOW> scopeSamples{};
+
+    /** Timer rate, from the window and the web UI's live views */
+    EditorRefresh refresh;
+
+    uint64_t lastOverrunTotal = 0;  // OverrunLog total last sent
 
-    bool ignoreParameterCallbacks = false;
+    /** Open while the user picks a sample layer */
+    std::unique_ptr<juce::FileChooser> sampleChooser;
 
     static constexpr int DEFAULT_WIDTH = 800;
     static constexpr int DEFAULT_HEIGHT = 700;
@@ -5,44 +5,25 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 PluginProcessor::PluginProcessor()
     : AudioProcessor(BusesProperties()
-                     .withOutput("Output", juce::AudioChannelSet::stereo(), true))
+                     .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                     // Optional per-drum outputs, in DrumEngine::Drum order
+                     .withOutput("Kick", juce::AudioChannelSet::stereo(), false)
+                     .withOutput("Snare", juce::AudioChannelSet::stereo(), false)
+                     .withOutput("Hat", juce::AudioChannelSet::stereo(), false)
+                     .withOutput("Perc", juce::AudioChannelSet::stereo(), false))
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    // Cache parameter pointers for lock-free access
-    kickCarrierFreq = apvts.getRawParameterValue("kick_carrier_freq");
-    kickModRatio = apvts.getRawParameterValue("kick_mod_ratio");
-    kickModDepth = apvts.getRawParameterValue("kick_mod_depth");
-    kickPitchDecay = apvts.getRawParameterValue("kick_pitch_decay");
-    kickPitchAmount = apvts.getRawParameterValue("kick_pitch_amount");
-    kickAmpDecay = apvts.getRawParameterValue("kick_amp_decay");
-    kickLevel = apvts.getRawParameterValue("kick_level");
-
-    snareCarrierFreq = apvts.getRawParameterValue("snare_carrier_freq");
-    snareModRatio = apvts.getRawParameterValue("snare_mod_ratio");
-    snareModDepth = apvts.getRawParameterValue("snare_mod_depth");
-    snarePitchDecay = apvts.getRawParameterValue("snare_pitch_decay");
-    snareAmpDecay = apvts.getRawParameterValue("snare_amp_decay");
-    snareNoise = apvts.getRawParameterValue("snare_noise");
-    snareLevel = apvts.getRawParameterValue("snare_level");
-
-    hatCarrierFreq = apvts.getRawParameterValue("hat_carrier_freq");
-    hatModRatio = apvts.getRawParameterValue("hat_mod_ratio");
-    hatModDepth = apvts.getRawParameterValue("hat_mod_depth");
-    hatAmpDecay = apvts.getRawParameterValue("hat_amp_decay");
-    hatNoise = apvts.getRawParameterValue("hat_noise");
-    hatLevel = apvts.getRawParameterValue("hat_level");
-
-    percCarrierFreq = apvts.getRawParameterValue("perc_carrier_freq");
-    percModRatio = apvts.getRawParameterValue("perc_mod_ratio");
-    percModDepth = apvts.getRawParameterValue("perc_mod_depth");
-    percPitchDecay = apvts.getRawParameterValue("perc_pitch_decay");
-    percAmpDecay = apvts.getRawParameterValue("perc_amp_decay");
-    percLevel = apvts.getRawParameterValue("perc_level");
-
-    masterLevel = apvts.getRawParameterValue("master_level");
+    // Cache parameter pointers for lock-free audio thread access
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -60,6 +41,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     auto freqRangePerc = juce::NormalisableRange<float>(100.0f, 1000.0f, 1.0f, 0.5f);
     auto ratioRange = juce::NormalisableRange<float>(0.5f, 16.0f, 0.1f, 0.5f);
     auto linearRange = juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f);
+    auto tuneRange = juce::NormalisableRange<float>(-24.0f, 24.0f, 0.01f);
 
     // KICK
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -88,6 +70,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"kick_level", 1}, "Kick Level", linearRange, 0.8f));
 
+    // The sample layer (plays only with a sample loaded)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"kick_layer_level", 1}, "Kick Layer Level", linearRange, 0.8f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"kick_layer_tune", 1}, "Kick Layer Tune", tuneRange, 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")));
+
     // SNARE
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"snare_carrier_freq", 1}, "Snare Freq", freqRangeSnare, 180.0f,
@@ -115,6 +105,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"snare_level", 1}, "Snare Level", linearRange, 0.8f));
 
+    // The sample layer (plays only with a sample loaded)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"snare_layer_level", 1}, "Snare Layer Level", linearRange, 0.8f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"snare_layer_tune", 1}, "Snare Layer Tune", tuneRange, 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")));
+
     // HAT
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"hat_carrier_freq", 1}, "Hat Freq", freqRangeHat, 800.0f,
@@ -137,6 +135,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"hat_level", 1}, "Hat Level", linearRange, 0.7f));
 
+    // The sample layer (plays only with a sample loaded)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"hat_layer_level", 1}, "Hat Layer Level", linearRange, 0.8f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"hat_layer_tune", 1}, "Hat Layer Tune", tuneRange, 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")));
+
     // PERC
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"perc_carrier_freq", 1}, "Perc Freq", freqRangePerc, 400.0f,
@@ -161,6 +167,14 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"perc_level", 1}, "Perc Level", linearRange, 0.7f));
 
+    // The sample layer (plays only with a sample loaded)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"perc_layer_level", 1}, "Perc Layer Level", linearRange, 0.8f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"perc_layer_tune", 1}, "Perc Layer Tune", tuneRange, 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")));
+
     // MASTER
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID{"master_level", 1}, "Master Level", linearRange, 0.8f));
@@ -171,8 +185,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     drumEngine.prepare(sampleRate, samplesPerBlock);
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -180,48 +197,37 @@ void PluginProcessor::releaseResources()
     drumEngine.releaseResources();
 }
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = drumEngine.getActiveVoiceCount();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Update parameters
-    drumEngine.setKickCarrierFreq(kickCarrierFreq->load());
-    drumEngine.setKickModRatio(kickModRatio->load());
-    drumEngine.setKickModDepth(kickModDepth->load());
-    drumEngine.setKickPitchDecay(kickPitchDecay->load());
-    drumEngine.setKickPitchAmount(kickPitchAmount->load());
-    drumEngine.setKickAmpDecay(kickAmpDecay->load());
-    drumEngine.setKickLevel(kickLevel->load());
-
-    drumEngine.setSnareCarrierFreq(snareCarrierFreq->load());
-    drumEngine.setSnareModRatio(snareModRatio->load());
-    drumEngine.setSnareModDepth(snareModDepth->load());
-    drumEngine.setSnarePitchDecay(snarePitchDecay->load());
-    drumEngine.setSnareAmpDecay(snareAmpDecay->load());
-    drumEngine.setSnareNoise(snareNoise->load());
-    drumEngine.setSnareLevel(snareLevel->load());
-
-    drumEngine.setHatCarrierFreq(hatCarrierFreq->load());
-    drumEngine.setHatModRatio(hatModRatio->load());
-    drumEngine.setHatModDepth(hatModDepth->load());
-    drumEngine.setHatAmpDecay(hatAmpDecay->load());
-    drumEngine.setHatNoise(hatNoise->load());
-    drumEngine.setHatLevel(hatLevel->load());
-
-    drumEngine.setPercCarrierFreq(percCarrierFreq->load());
-    drumEngine.setPercModRatio(percModRatio->load());
-    drumEngine.setPercModDepth(percModDepth->load());
-    drumEngine.setPercPitchDecay(percPitchDecay->load());
-    drumEngine.setPercAmpDecay(percAmpDecay->load());
-    drumEngine.setPercLevel(percLevel->load());
-
-    drumEngine.setMasterLevel(masterLevel->load());
+    // Update parameters (only the ones that changed)
+    params.update();
+    drumEngine.applySnapshot(params);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI
     for (const auto metadata : midiMessages)
@@ -237,15 +243,43 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiB
         }
     }
 
-    // Render audio
-    drumEngine.renderBlock(leftChannel, rightChannel, numSamples);
+    // Render audio: a drum whose own bus is enabled plays there instead of
+    // on the main output
+    std::array<float*, DrumEngine::NUM_DRUMS> outputsL;
+    std::array<float*, DrumEngine::NUM_DRUMS> outputsR;
+    for (int d = 0; d < DrumEngine::NUM_DRUMS; ++d)
+    {
+        outputsL[static_cast<size_t>(d)] = leftChannel;
+        outputsR[static_cast<size_t>(d)] = rightChannel;
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
+        const auto* bus = getBus(false, d + 1);
+        if (bus != nullptr && bus->isEnabled() && bus->getNumberOfChannels() == 2)
+        {
+            auto drumBuffer = getBusBuffer(buffer, false, d + 1);
+            outputsL[static_cast<size_t>(d)] = drumBuffer.getWritePointer(0);
+            outputsR[static_cast<size_t>(d)] = drumBuffer.getWritePointer(1);
+        }
+    }
+    drumEngine.renderBlock(outputsL, outputsR, numSamples);
+
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+}
+
+bool PluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Stereo main out; each drum's bus stereo, or off (the drum stays on the main out)
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
     {
-        visualizationBuffer[i] = leftChannel[i];
+        const auto& channels = layouts.getChannelSet(false, bus);
+        if (!channels.isDisabled() && channels != juce::AudioChannelSet::stereo())
+            return false;
     }
+    return true;
 }
 
 juce::AudioProcessorEditor* PluginProcessor::createEditor()
@@ -253,19 +287,183 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
     return new PluginEditor(*this);
 }
 
+//==============================================================================
+// Sample Layers
+//==============================================================================
+
+// Longest sample a layer keeps: drums, not loops
+static constexpr double MAX_LAYER_SECONDS = 10.0;
+
+/** Where file's preconverted .ams lives: itself if it is one, else the user's sample cache */
+static juce::File preconvertedSample(const juce::File& file)
+{
+    if (file.hasFileExtension("ams"))
+        return file;
+
+    // Keyed by path, size and date, so an edited file is converted again
+    const auto key = file.getFullPathName() + juce::String(file.getSize())
+                   + juce::String(file.getLastModificationTime().toMilliseconds());
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("autosynth/FMDrums/Samples")
+        .getChildFile(file.getFileNameWithoutExtension() + "-" + juce::String::toHexString(key.hashCode64()) + ".ams");
+}
+
+/** Decode file and write it to target as an .ams (see core/dsp/MappedSample.h) */
+static bool preconvertSample(const juce::File& file, const juce::File& target)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return false;
+
+    const auto length = static_cast<int>(std::min<juce::int64>(
+        reader->lengthInSamples, static_cast<juce::int64>(MAX_LAYER_SECONDS * reader->sampleRate)));
+    juce::AudioBuffer<float> samples(reader->numChannels > 1 ? 2 : 1, length);
+    if (!reader->read(&samples, 0, length, 0, true, samples.getNumChannels() > 1))
+        return false;
+
+    // Written aside and moved into place, so another instance never maps half a file
+    if (!target.getParentDirectory().createDirectory())
+        return false;
+    juce::TemporaryFile temp(target);
+    return MappedSample::saveFile(temp.getFile().getFullPathName().toStdString(), samples.getReadPointer(0),
+                                  samples.getNumChannels() > 1 ? samples.getReadPointer(1) : nullptr,
+                                  static_cast<size_t>(length), static_cast<uint32_t>(reader->sampleRate))
+           && temp.overwriteTargetFileWithTemporary();
+}
+
+bool PluginProcessor::loadSampleLayer(int drum, const juce::File& file)
+{
+    if (drum < 0 || drum >= DrumEngine::NUM_DRUMS)
+        return false;
+
+    // Converting is once per file; after that, loading is mapping
+    const auto converted = preconvertedSample(file);
+    if (!converted.existsAsFile() && !preconvertSample(file, converted))
+        return false;
+
+    auto sample = MappedSampleRegistry::get().load(converted.getFullPathName().toStdString());
+    if (sample == nullptr)
+        return false;
+
+    {
+        const juce::ScopedLock lock(sampleLayerLock);
+        sampleLayerPaths[static_cast<size_t>(drum)] = file.getFullPathName();
+    }
+
+    // Swapped with the audio thread held off; the old sample goes outside the lock
+    std::shared_ptr<const MappedSample> previous;
+    {
+        const juce::ScopedLock lock(getCallbackLock());
+        previous = drumEngine.setSampleLayer(static_cast<DrumEngine::Drum>(drum), std::move(sample));
+    }
+    return true;
+}
+
+void PluginProcessor::clearSampleLayer(int drum)
+{
+    if (drum < 0 || drum >= DrumEngine::NUM_DRUMS)
+        return;
+
+    {
+        const juce::ScopedLock lock(sampleLayerLock);
+        sampleLayerPaths[static_cast<size_t>(drum)].clear();
+    }
+
+    std::shared_ptr<const MappedSample> previous;
+    {
+        const juce::ScopedLock lock(getCallbackLock());
+        previous = drumEngine.setSampleLayer(static_cast<DrumEngine::Drum>(drum), nullptr);
+    }
+}
+
+juce::String PluginProcessor::getSampleLayerName(int drum) const
+{
+    if (drum < 0 || drum >= DrumEngine::NUM_DRUMS)
+        return {};
+
+    const juce::ScopedLock lock(sampleLayerLock);
+    const auto& path = sampleLayerPaths[static_cast<size_t>(drum)];
+    return path.isEmpty() ? juce::String() : juce::File(path).getFileNameWithoutExtension();
+}
+
+//==============================================================================
+// State Save/Load
+//==============================================================================
+
+// State is a PluginState (see core/dsp/PluginState.h): the parameters, then
+// each sample layer's source path (UTF-8) in a chunk per drum, if it has one
+static constexpr std::array<uint32_t, DrumEngine::NUM_DRUMS> LAYER_CHUNKS = {
+    PluginState::tag("LYRK"), PluginState::tag("LYRS"), PluginState::tag("LYRH"), PluginState::tag("LYRP")};
+
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    std::array<juce::String, DrumEngine::NUM_DRUMS> paths;
+    {
+        const juce::ScopedLock lock(sampleLayerLock);
+        paths = sampleLayerPaths;
+    }
+    for (size_t d = 0; d < paths.size(); ++d)
+    {
+        if (paths[d].isNotEmpty())
+            state.addChunk(LAYER_CHUNKS[d], paths[d].toRawUTF8(), paths[d].getNumBytesAsUTF8());
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    std::array<juce::String, DrumEngine::NUM_DRUMS> savedLayers;
+
+    if (!PluginState::isState(data, size))
+    {
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+    }
+    else
+    {
+        // Saved by a newer build: keep what's loaded rather than reset it
+        if (!PluginState::canRead(data, size))
+            return;
+
+        PluginState::Values saved;
+        PluginState::read(data, size, saved.collector(),
+            [&savedLayers](uint32_t chunkTag, const uint8_t* chunk, size_t chunkSize) {
+                const auto it = std::find(LAYER_CHUNKS.begin(), LAYER_CHUNKS.end(), chunkTag);
+                if (it != LAYER_CHUNKS.end())
+                    savedLayers[static_cast<size_t>(it - LAYER_CHUNKS.begin())]
+                        = juce::String::fromUTF8(reinterpret_cast<const char*>(chunk), static_cast<int>(chunkSize));
+            });
+
+        // A parameter the state doesn't have goes back to its default, as with the XML
+        PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
+    }
+
+    // The samples are saved by path: one that's gone is left out
+    for (int d = 0; d < DrumEngine::NUM_DRUMS; ++d)
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        const auto& path = savedLayers[static_cast<size_t>(d)];
+        if (const juce::File sample(path); path.isNotEmpty() && sample.existsAsFile() && loadSampleLayer(d, sample))
+            continue;
+        if (getSampleLayerName(d).isNotEmpty())
+            clearSampleLayer(d);
     }
 }
 
@@ -7,6 +7,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/DrumEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 class PluginProcessor : public juce::AudioProcessor
 {
@@ -17,6 +20,7 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -36,48 +40,54 @@ public:
     void changeProgramName(int, const juce::String&) override {}
 
     juce::AudioProcessorValueTreeState apvts;
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return drumEngine.getPerfStats(); }
+
+    //==========================================================================
+    // Sample layers (see DrumEngine::setSampleLayer)
+
+    /**
+     * @brief Layer a sample file under a drum (DrumEngine::Drum order)
+     *
+     * An .ams file is mapped as it is; anything else is preconverted to
+     * one in the user's sample cache the first time, and mapped from
+     * there after that. False if the file can't be read.
+     */
+    bool loadSampleLayer(int drum, const juce::File& file);
+
+    /** Drop a drum's sample layer */
+    void clearSampleLayer(int drum);
+
+    /** Name of a drum's sample file, empty if none */
+    juce::String getSampleLayerName(int drum) const;
 
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     DrumEngine drumEngine;
 
-    // Cached parameters
-    std::atomic<float>* kickCarrierFreq = nullptr;
-    std::atomic<float>* kickModRatio = nullptr;
-    std::atomic<float>* kickModDepth = nullptr;
-    std::atomic<float>* kickPitchDecay = nullptr;
-    std::atomic<float>* kickPitchAmount = nullptr;
-    std::atomic<float>* kickAmpDecay = nullptr;
-    std::atomic<float>* kickLevel = nullptr;
-
-    std::atomic<float>* snareCarrierFreq = nullptr;
-    std::atomic<float>* snareModRatio = nullptr;
-    std::atomic<float>* snareModDepth = nullptr;
-    std::atomic<float>* snarePitchDecay = nullptr;
-    std::atomic<float>* snareAmpDecay = nullptr;
-    std::atomic<float>* snareNoise = nullptr;
-    std::atomic<float>* snareLevel = nullptr;
-
-    std::atomic<float>* hatCarrierFreq = nullptr;
-    std::atomic<float>* hatModRatio = nullptr;
-    std::atomic<float>* hatModDepth = nullptr;
-    std::atomic<float>* hatAmpDecay = nullptr;
-    std::atomic<float>* hatNoise = nullptr;
-    std::atomic<float>* hatLevel = nullptr;
-
-    std::atomic<float>* percCarrierFreq = nullptr;
-    std::atomic<float>* percModRatio = nullptr;
-    std::atomic<float>* percModDepth = nullptr;
-    std::atomic<float>* percPitchDecay = nullptr;
-    std::atomic<float>* percAmpDecay = nullptr;
-    std::atomic<float>* percLevel = nullptr;
-
-    std::atomic<float>* masterLevel = nullptr;
+    /** Files the sample layers came from, for the state; empty if none */
+    std::array<juce::String, DrumEngine::NUM_DRUMS> sampleLayerPaths;
+    juce::CriticalSection sampleLayerLock;
+
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     double currentSampleRate = 44100.0;
-    std::array<float, 512> visualizationBuffer{};
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -7,12 +7,189 @@
  *   - SNARE: D1 (38)
  *   - HAT:   F#1 (42) closed, A#1 (46) open
  *   - PERC:  C#2 (49) or any other note
+ *
+ * Each drum is a DrumPool of VOICES_PER_DRUM voices, so a retrigger rings
+ * on under the new hit (rolls, flams) instead of cutting it. Drums in the
+ * same choke group cut each other's hits short; by default the hats are a
+ * group, so a hat hit chokes the one before it as on a real hi-hat.
+ *
+ * renderBlock() mixes the four drums into one stereo pair, or gives each
+ * drum its own pair for the plugin's per-drum output buses.
+ *
+ * A drum can also have a sample layered under its FM (setSampleLayer()):
+ * a memory-mapped MappedSample, shared with every instance playing the
+ * same file, so a kit costs an instance only the pointers to it.
  */
 
 #pragma once
 
 #include "DrumVoice.h"
+#include "MappedSample.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
 #include <array>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief One drum's preallocated voices, handed out round-robin
+ *
+ * A hit takes the next idle voice after the last one used; with every voice
+ * still sounding it steals the quietest. Only sounding voices render: the
+ * pool keeps a bitmask of them, so an idle drum costs nothing.
+ */
+template <int VOICES>
+class DrumPool
+{
+public:
+    static_assert(VOICES > 0 && VOICES <= 32);
+
+    DrumPool() = default;
+    DrumPool(const DrumPool&) = delete;  // The voices point at our cache
+    DrumPool& operator=(const DrumPool&) = delete;
+
+    void prepare(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        for (auto& v : voices)
+            v.prepare(sampleRate);
+        activeMask = 0;
+        if (cacheEnabled)
+            cache.prepare(sampleRate);
+    }
+
+    /** Turn the hit cache on or off (allocates if turned on after prepare()) */
+    void setHitCacheEnabled(bool enabled)
+    {
+        cacheEnabled = enabled;
+        if (enabled && sampleRate > 0.0)
+            cache.prepare(sampleRate);
+        for (auto& v : voices)
+            v.setHitCache(enabled ? &cache : nullptr);
+    }
+
+    /** Seed voice v with deriveSeed(seed, firstIndex + v * stride) */
+    void setNoiseSeed(uint32_t seed, uint32_t firstIndex, uint32_t stride)
+    {
+        cache.invalidate();
+        for (int v = 0; v < VOICES; ++v)
+            voices[static_cast<size_t>(v)].setNoiseSeed(NoiseSource::deriveSeed(seed, firstIndex + static_cast<uint32_t>(v) * stride));
+    }
+
+    void trigger(float velocity)
+    {
+        int chosen = -1;
+        for (int n = 1; n <= VOICES && chosen < 0; ++n)
+        {
+            const int v = (last + n) % VOICES;
+            if (!(activeMask & (1u << v)))
+                chosen = v;
+        }
+
+        if (chosen < 0)
+        {
+            chosen = 0;
+            for (int v = 1; v < VOICES; ++v)
+            {
+                if (voices[static_cast<size_t>(v)].getLevel() < voices[static_cast<size_t>(chosen)].getLevel())
+                    chosen = v;
+            }
+        }
+
+        voices[static_cast<size_t>(chosen)].trigger(velocity);
+        activeMask |= 1u << chosen;
+        last = chosen;
+    }
+
+    /** Fade out every sounding voice (see DrumVoice::choke) */
+    void choke()
+    {
+        for (uint32_t mask = activeMask; mask != 0; mask &= mask - 1)
+            voices[static_cast<size_t>(lowestBit(mask))].choke();
+    }
+
+    /**
+     * @brief Render the sounding voices, times gain
+     * @param accumulate Add to the buffers, or have the first voice overwrite them
+     * @return True if the buffers now hold the mix (accumulate, or a voice wrote them)
+     */
+    bool render(float* outputL, float* outputR, int numSamples, float gain, bool accumulate)
+    {
+        for (uint32_t mask = activeMask; mask != 0; mask &= mask - 1)
+        {
+            const int v = lowestBit(mask);
+            auto& voice = voices[static_cast<size_t>(v)];
+            voice.render(outputL, outputR, numSamples, gain, accumulate);
+            accumulate = true;
+            if (!voice.isActive())
+                activeMask &= ~(1u << v);
+        }
+        return accumulate;
+    }
+
+    /** Call setter(value) on every voice, e.g. set(&DrumVoice::setLevel, 0.8f) */
+    void set(void (DrumVoice::*setter)(float), float value)
+    {
+        cache.invalidate();
+        for (auto& v : voices)
+            (v.*setter)(value);
+    }
+
+    /** Call setter(value) on every voice's sample layer (the FM, and so the cache, is untouched) */
+    void set(void (SampleLayer::*setter)(float), float value)
+    {
+        for (auto& v : voices)
+            (v.getSampleLayer().*setter)(value);
+    }
+
+    /** Layer sample under every hit (nullptr: none), cutting the layers sounding */
+    void setSampleLayer(const MappedSample* sample)
+    {
+        for (int v = 0; v < VOICES; ++v)
+        {
+            auto& voice = voices[static_cast<size_t>(v)];
+            voice.getSampleLayer().setSample(sample);
+            if (!voice.isActive())
+                activeMask &= ~(1u << v);
+        }
+    }
+
+    int getActiveCount() const
+    {
+        int count = 0;
+        for (uint32_t mask = activeMask; mask != 0; mask &= mask - 1)
+            ++count;
+        return count;
+    }
+
+    bool isActive() const { return activeMask != 0; }
+
+    /** Bytes of hit cache allocated (0 unless the cache was ever enabled) */
+    size_t getHeapBytes() const { return cache.getHeapBytes(); }
+
+private:
+    static int lowestBit(uint32_t mask)
+    {
+        int bit = 0;
+        while (!(mask & 1u))
+        {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+    }
+
+    std::array<DrumVoice, VOICES> voices;
+    uint32_t activeMask = 0;  // Bit v: voice v is sounding
+    int last = VOICES - 1;    // So the first hit takes voice 0
+
+    double sampleRate = 0.0;
+    HitCache cache;           // The voices point here while it's enabled
+    bool cacheEnabled = false;
+};
 
 /**
  * @brief FM drum engine with 4 drum channels
@@ -27,117 +204,331 @@ public:
     static constexpr int NOTE_HAT_OPEN = 46;   // A#1
     static constexpr int NOTE_PERC = 49;       // C#2
 
+    static constexpr int VOICES_PER_DRUM = 4;
+    static constexpr int NUM_DRUMS = 4;
+
+    enum Drum { Kick, Snare, Hat, Perc };
+
     DrumEngine() = default;
     ~DrumEngine() = default;
 
     void prepare(double sampleRate, int /*samplesPerBlock*/)
     {
-        kick.prepare(sampleRate);
-        snare.prepare(sampleRate);
-        hat.prepare(sampleRate);
-        perc.prepare(sampleRate);
+        for (auto& drum : drums)
+            drum.prepare(sampleRate);
+        perfStats.prepare(sampleRate);
     }
 
     void releaseResources() {}
 
-    void noteOn(int note, float velocity, int /*samplePosition*/)
+    /** Fix the noise so renders repeat exactly (default: clock-seeded) */
+    void setNoiseSeed(uint32_t seed)
     {
+        // A seed per voice: shared noise would sum coherently on simultaneous hits
+        for (int d = 0; d < NUM_DRUMS; ++d)
+            drums[static_cast<size_t>(d)].setNoiseSeed(seed, static_cast<uint32_t>(d), NUM_DRUMS);
+    }
+
+    void noteOn(int note, float velocity, int samplePosition = 0)
+    {
+        // Hits later in the block are deferred to their sample in renderBlock
+        if (samplePosition > 0 && eventQueue.push({MidiEvent::Type::NoteOn, samplePosition, note, velocity}))
+            return;
+
         switch (note)
         {
             case NOTE_KICK:
-                kick.trigger(velocity);
+                hit(Kick, velocity);
                 break;
             case NOTE_SNARE:
-                snare.trigger(velocity);
+                hit(Snare, velocity);
                 break;
             case NOTE_HAT_CLOSED:
             case NOTE_HAT_OPEN:
-                hat.trigger(velocity);
+                hit(Hat, velocity);
                 break;
             default:
                 // All other notes trigger perc
-                perc.trigger(velocity);
+                hit(Perc, velocity);
                 break;
         }
     }
 
-    void noteOff(int /*note*/, int /*samplePosition*/)
+    /**
+     * @brief Put a drum in a choke group (0: none)
+     *
+     * A hit chokes every drum in its group, itself included. The hats start
+     * in group 1; the rest ring over each other.
+     */
+    void setChokeGroup(Drum drum, int group) { chokeGroups[static_cast<size_t>(drum)] = group; }
+
+    /**
+     * @brief Replay hits from a per-drum cache while the parameters hold still
+     *
+     * For batch rendering of patterns: see HitCache in DrumVoice.h. Off by
+     * default, since replayed hits repeat their noise. Allocates.
+     */
+    void setHitCacheEnabled(bool enabled)
+    {
+        for (auto& drum : drums)
+            drum.setHitCacheEnabled(enabled);
+    }
+
+    void noteOff(int /*note*/, int /*samplePosition*/ = 0)
     {
         // Drums are one-shot, ignore note off
     }
 
-    void allNotesOff()
+    void allNotesOff(int /*samplePosition*/ = 0)
     {
         // Drums continue to decay naturally
     }
 
-    void setPitchBend(float /*bend*/)
+    void setPitchBend(float /*bend*/, int /*samplePosition*/ = 0)
     {
         // Not used for drums
     }
 
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        // Clear buffers
-        std::fill(outputL, outputL + numSamples, 0.0f);
-        std::fill(outputR, outputR + numSamples, 0.0f);
+        renderBlock({outputL, outputL, outputL, outputL}, {outputR, outputR, outputR, outputR}, numSamples);
+    }
+
+    /**
+     * @brief Render each drum into its own stereo pair (indexed by Drum)
+     *
+     * Drums given the same pair mix into it, so a plugin can send some drums
+     * to their own buses and leave the rest on the main one.
+     */
+    void renderBlock(const std::array<float*, NUM_DRUMS>& outputsL,
+                     const std::array<float*, NUM_DRUMS>& outputsR, int numSamples)
+    {
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        // Render each drum voice
-        kick.render(outputL, outputR, numSamples);
-        snare.render(outputL, outputR, numSamples);
-        hat.render(outputL, outputR, numSamples);
-        perc.render(outputL, outputR, numSamples);
+        perfStats.beginBlock();
 
-        // Apply master level
-        for (int i = 0; i < numSamples; ++i)
+        // The first drum on each pair owns it: it and the drums sharing the
+        // pair report whether it has been written yet
+        std::array<int, NUM_DRUMS> owner{};
+        for (int d = 0; d < NUM_DRUMS; ++d)
         {
-            outputL[i] *= masterLevel;
-            outputR[i] *= masterLevel;
+            owner[static_cast<size_t>(d)] = d;
+            for (int e = 0; e < d; ++e)
+            {
+                if (outputsL[static_cast<size_t>(e)] == outputsL[static_cast<size_t>(d)])
+                {
+                    owner[static_cast<size_t>(d)] = e;
+                    break;
+                }
+            }
         }
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            // Render each drum voice, splitting at queued hits. The first
+            // sounding voice on a pair writes it and the rest add to it, all
+            // at the master level, so there's no clearing or gain pass; only a
+            // pair left silent is filled.
+            eventQueue.process(numSamples,
+                [this, &outputsL, &outputsR, &owner](int start, int count)
+                {
+                    std::array<bool, NUM_DRUMS> written{};
+                    for (size_t d = 0; d < NUM_DRUMS; ++d)
+                    {
+                        bool& pairWritten = written[static_cast<size_t>(owner[d])];
+                        pairWritten = drums[d].render(outputsL[d] + start, outputsR[d] + start, count, masterLevel, pairWritten);
+                    }
+                    for (size_t d = 0; d < NUM_DRUMS; ++d)
+                    {
+                        if (owner[d] == static_cast<int>(d) && !written[d])
+                        {
+                            std::fill(outputsL[d] + start, outputsL[d] + start + count, 0.0f);
+                            std::fill(outputsR[d] + start, outputsR[d] + start + count, 0.0f);
+                        }
+                    }
+                },
+                [this](const MidiEvent& event)
+                {
+                    if (event.type == MidiEvent::Type::NoteOn)
+                        noteOn(event.note, event.value);
+                });
+        }
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
+    /** Drum voices still sounding */
+    int getActiveVoiceCount() const
+    {
+        int count = 0;
+        for (const auto& drum : drums)
+            count += drum.getActiveCount();
+        return count;
+    }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        size_t cacheBytes = 0;
+        for (const auto& drum : drums)
+            cacheBytes += drum.getHeapBytes();
+        report.addHeap("hit cache", cacheBytes);
+        report.addShared("sine table", sizeof(FMSineTable));
+
+        // The samples belong to the registry: every instance playing a file shares it
+        size_t layerBytes = 0;
+        for (const auto& sample : sampleLayers)
+        {
+            if (sample)
+                layerBytes += sample->getHeapBytes() + (sample->isMapped() ? sample->getFileBytes() : 0);
+        }
+        report.addShared("sample layers", layerBytes);
+        return report;
+    }
+
+    /**
+     * @brief Play sample under drum's FM hits (nullptr: none)
+     *
+     * The sample starts with each hit, at velocity x the drum's layer level
+     * and pitched by its layer tune. Not on the audio thread: the processor
+     * calls this with its callback lock held, since the drum's sounding
+     * layers are cut. Returns the sample it replaces, for the caller to
+     * let go of outside the lock (the last reference unmaps the file).
+     */
+    std::shared_ptr<const MappedSample> setSampleLayer(Drum drum, std::shared_ptr<const MappedSample> sample)
+    {
+        drums[static_cast<size_t>(drum)].setSampleLayer(sample.get());
+        std::swap(sampleLayers[static_cast<size_t>(drum)], sample);
+        return sample;
+    }
+
+    const MappedSample* getSampleLayer(Drum drum) const { return sampleLayers[static_cast<size_t>(drum)].get(); }
+
     // Kick parameters
-    void setKickCarrierFreq(float v) { kick.setCarrierFreq(v); }
-    void setKickModRatio(float v) { kick.setModRatio(v); }
-    void setKickModDepth(float v) { kick.setModDepth(v); }
-    void setKickPitchDecay(float v) { kick.setPitchDecay(v); }
-    void setKickPitchAmount(float v) { kick.setPitchAmount(v); }
-    void setKickAmpDecay(float v) { kick.setAmpDecay(v); }
-    void setKickLevel(float v) { kick.setLevel(v); }
+    void setKickCarrierFreq(float v) { drums[Kick].set(&DrumVoice::setCarrierFreq, v); }
+    void setKickModRatio(float v) { drums[Kick].set(&DrumVoice::setModRatio, v); }
+    void setKickModDepth(float v) { drums[Kick].set(&DrumVoice::setModDepth, v); }
+    void setKickPitchDecay(float v) { drums[Kick].set(&DrumVoice::setPitchDecay, v); }
+    void setKickPitchAmount(float v) { drums[Kick].set(&DrumVoice::setPitchAmount, v); }
+    void setKickAmpDecay(float v) { drums[Kick].set(&DrumVoice::setAmpDecay, v); }
+    void setKickLevel(float v) { drums[Kick].set(&DrumVoice::setLevel, v); }
+    void setKickLayerLevel(float v) { drums[Kick].set(&SampleLayer::setLevel, v); }
+    void setKickLayerTune(float v) { drums[Kick].set(&SampleLayer::setTune, v); }
 
     // Snare parameters
-    void setSnareCarrierFreq(float v) { snare.setCarrierFreq(v); }
-    void setSnareModRatio(float v) { snare.setModRatio(v); }
-    void setSnareModDepth(float v) { snare.setModDepth(v); }
-    void setSnarePitchDecay(float v) { snare.setPitchDecay(v); }
-    void setSnareAmpDecay(float v) { snare.setAmpDecay(v); }
-    void setSnareNoise(float v) { snare.setNoiseAmount(v); }
-    void setSnareLevel(float v) { snare.setLevel(v); }
+    void setSnareCarrierFreq(float v) { drums[Snare].set(&DrumVoice::setCarrierFreq, v); }
+    void setSnareModRatio(float v) { drums[Snare].set(&DrumVoice::setModRatio, v); }
+    void setSnareModDepth(float v) { drums[Snare].set(&DrumVoice::setModDepth, v); }
+    void setSnarePitchDecay(float v) { drums[Snare].set(&DrumVoice::setPitchDecay, v); }
+    void setSnareAmpDecay(float v) { drums[Snare].set(&DrumVoice::setAmpDecay, v); }
+    void setSnareNoise(float v) { drums[Snare].set(&DrumVoice::setNoiseAmount, v); }
+    void setSnareLevel(float v) { drums[Snare].set(&DrumVoice::setLevel, v); }
+    void setSnareLayerLevel(float v) { drums[Snare].set(&SampleLayer::setLevel, v); }
+    void setSnareLayerTune(float v) { drums[Snare].set(&SampleLayer::setTune, v); }
 
     // Hat parameters
-    void setHatCarrierFreq(float v) { hat.setCarrierFreq(v); }
-    void setHatModRatio(float v) { hat.setModRatio(v); }
-    void setHatModDepth(float v) { hat.setModDepth(v); }
-    void setHatAmpDecay(float v) { hat.setAmpDecay(v); }
-    void setHatNoise(float v) { hat.setNoiseAmount(v); }
-    void setHatLevel(float v) { hat.setLevel(v); }
+    void setHatCarrierFreq(float v) { drums[Hat].set(&DrumVoice::setCarrierFreq, v); }
+    void setHatModRatio(float v) { drums[Hat].set(&DrumVoice::setModRatio, v); }
+    void setHatModDepth(float v) { drums[Hat].set(&DrumVoice::setModDepth, v); }
+    void setHatAmpDecay(float v) { drums[Hat].set(&DrumVoice::setAmpDecay, v); }
+    void setHatNoise(float v) { drums[Hat].set(&DrumVoice::setNoiseAmount, v); }
+    void setHatLevel(float v) { drums[Hat].set(&DrumVoice::setLevel, v); }
+    void setHatLayerLevel(float v) { drums[Hat].set(&SampleLayer::setLevel, v); }
+    void setHatLayerTune(float v) { drums[Hat].set(&SampleLayer::setTune, v); }
 
     // Perc parameters
-    void setPercCarrierFreq(float v) { perc.setCarrierFreq(v); }
-    void setPercModRatio(float v) { perc.setModRatio(v); }
-    void setPercModDepth(float v) { perc.setModDepth(v); }
-    void setPercPitchDecay(float v) { perc.setPitchDecay(v); }
-    void setPercAmpDecay(float v) { perc.setAmpDecay(v); }
-    void setPercLevel(float v) { perc.setLevel(v); }
+    void setPercCarrierFreq(float v) { drums[Perc].set(&DrumVoice::setCarrierFreq, v); }
+    void setPercModRatio(float v) { drums[Perc].set(&DrumVoice::setModRatio, v); }
+    void setPercModDepth(float v) { drums[Perc].set(&DrumVoice::setModDepth, v); }
+    void setPercPitchDecay(float v) { drums[Perc].set(&DrumVoice::setPitchDecay, v); }
+    void setPercAmpDecay(float v) { drums[Perc].set(&DrumVoice::setAmpDecay, v); }
+    void setPercLevel(float v) { drums[Perc].set(&DrumVoice::setLevel, v); }
+    void setPercLayerLevel(float v) { drums[Perc].set(&SampleLayer::setLevel, v); }
+    void setPercLayerTune(float v) { drums[Perc].set(&SampleLayer::setTune, v); }
 
     // Master
     void setMasterLevel(float v) { masterLevel = v; }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Kick
+        if (p.changed(kKickCarrierFreq)) setKickCarrierFreq(p[kKickCarrierFreq]);
+        if (p.changed(kKickModRatio)) setKickModRatio(p[kKickModRatio]);
+        if (p.changed(kKickModDepth)) setKickModDepth(p[kKickModDepth]);
+        if (p.changed(kKickPitchDecay)) setKickPitchDecay(p[kKickPitchDecay]);
+        if (p.changed(kKickPitchAmount)) setKickPitchAmount(p[kKickPitchAmount]);
+        if (p.changed(kKickAmpDecay)) setKickAmpDecay(p[kKickAmpDecay]);
+        if (p.changed(kKickLevel)) setKickLevel(p[kKickLevel]);
+        if (p.changed(kKickLayerLevel)) setKickLayerLevel(p[kKickLayerLevel]);
+        if (p.changed(kKickLayerTune)) setKickLayerTune(p[kKickLayerTune]);
+
+        // Snare
+        if (p.changed(kSnareCarrierFreq)) setSnareCarrierFreq(p[kSnareCarrierFreq]);
+        if (p.changed(kSnareModRatio)) setSnareModRatio(p[kSnareModRatio]);
+        if (p.changed(kSnareModDepth)) setSnareModDepth(p[kSnareModDepth]);
+        if (p.changed(kSnarePitchDecay)) setSnarePitchDecay(p[kSnarePitchDecay]);
+        if (p.changed(kSnareAmpDecay)) setSnareAmpDecay(p[kSnareAmpDecay]);
+        if (p.changed(kSnareNoise)) setSnareNoise(p[kSnareNoise]);
+        if (p.changed(kSnareLevel)) setSnareLevel(p[kSnareLevel]);
+        if (p.changed(kSnareLayerLevel)) setSnareLayerLevel(p[kSnareLayerLevel]);
+        if (p.changed(kSnareLayerTune)) setSnareLayerTune(p[kSnareLayerTune]);
+
+        // Hat
+        if (p.changed(kHatCarrierFreq)) setHatCarrierFreq(p[kHatCarrierFreq]);
+        if (p.changed(kHatModRatio)) setHatModRatio(p[kHatModRatio]);
+        if (p.changed(kHatModDepth)) setHatModDepth(p[kHatModDepth]);
+        if (p.changed(kHatAmpDecay)) setHatAmpDecay(p[kHatAmpDecay]);
+        if (p.changed(kHatNoise)) setHatNoise(p[kHatNoise]);
+        if (p.changed(kHatLevel)) setHatLevel(p[kHatLevel]);
+        if (p.changed(kHatLayerLevel)) setHatLayerLevel(p[kHatLayerLevel]);
+        if (p.changed(kHatLayerTune)) setHatLayerTune(p[kHatLayerTune]);
+
+        // Perc
+        if (p.changed(kPercCarrierFreq)) setPercCarrierFreq(p[kPercCarrierFreq]);
+        if (p.changed(kPercModRatio)) setPercModRatio(p[kPercModRatio]);
+        if (p.changed(kPercModDepth)) setPercModDepth(p[kPercModDepth]);
+        if (p.changed(kPercPitchDecay)) setPercPitchDecay(p[kPercPitchDecay]);
+        if (p.changed(kPercAmpDecay)) setPercAmpDecay(p[kPercAmpDecay]);
+        if (p.changed(kPercLevel)) setPercLevel(p[kPercLevel]);
+        if (p.changed(kPercLayerLevel)) setPercLayerLevel(p[kPercLayerLevel]);
+        if (p.changed(kPercLayerTune)) setPercLayerTune(p[kPercLayerTune]);
+
+        // Master
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+    }
+
 private:
-    DrumVoice kick;
-    DrumVoice snare;
-    DrumVoice hat;
-    DrumVoice perc;
+    void hit(Drum drum, float velocity)
+    {
+        const int group = chokeGroups[static_cast<size_t>(drum)];
+        if (group != 0)
+        {
+            for (int d = 0; d < NUM_DRUMS; ++d)
+            {
+                if (chokeGroups[static_cast<size_t>(d)] == group)
+                    drums[static_cast<size_t>(d)].choke();
+            }
+        }
+        drums[static_cast<size_t>(drum)].trigger(velocity);
+    }
+
+    std::array<DrumPool<VOICES_PER_DRUM>, NUM_DRUMS> drums;  // Indexed by Drum
+    std::array<int, NUM_DRUMS> chokeGroups = {0, 0, 1, 0};
+    std::array<std::shared_ptr<const MappedSample>, NUM_DRUMS> sampleLayers;  // Held while the voices point at them
 
     float masterLevel = 0.8f;
+
+    MidiEventQueue eventQueue;  // Hits scheduled later in the current block
+    PerfStats perfStats;        // Per-block CPU counters, read by the editor
 };
@@ -9,12 +9,126 @@
  *
  * Each drum has fast exponential envelopes for punchy, percussive sounds.
  * Pitch envelope sweeps the carrier frequency down for classic FM drum sounds.
+ *
+ * Both operators are table-sine FMOperators (see FMOperator.h). The decay
+ * coefficients are worked out when their times change, not on every hit.
+ *
+ * With a HitCache attached, a hit is synthesized once per velocity layer
+ * and replayed from the cache after that (see HitCache below).
+ *
+ * A SampleLayer (see SampleLayer.h) plays the drum's sample, if it has
+ * one, under the FM: it starts, is choked and is stolen with the hit, but
+ * isn't cached, and the voice sounds until both have finished.
  */
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cmath>
-#include <random>
+#include <cstdint>
+#include <vector>
+
+#include "FastMath.h"
+#include "FMOperator.h"
+#include "Noise.h"
+#include "SampleLayer.h"
+
+/**
+ * @brief Recorded hits for one drum, one per velocity layer
+ *
+ * A hit is deterministic given the drum's parameters and velocity (noise
+ * aside), so once a layer has been heard, later hits in that layer replay
+ * the recording scaled by velocity / the recorded velocity: a copy and a
+ * multiply instead of the FM. The first hit in a layer is recorded as it
+ * plays; it only counts if it runs to its natural end and fits in
+ * MAX_SECONDS. Any parameter change invalidates every layer (and abandons
+ * recordings in flight), so the cache only helps while the sound is static.
+ *
+ * Replayed hits repeat their recording's noise, and the soft clip is baked
+ * in at the recorded velocity: close within a layer, not exact.
+ *
+ * @note prepare() allocates LAYERS x MAX_SECONDS of samples.
+ */
+class HitCache
+{
+public:
+    static constexpr int LAYERS = 8;
+    static constexpr float MAX_SECONDS = 2.0f;
+
+    void prepare(double sampleRate)
+    {
+        capacity = static_cast<int>(sampleRate * MAX_SECONDS);
+        samples.assign(static_cast<size_t>(LAYERS) * static_cast<size_t>(capacity), 0.0f);
+        invalidate();
+    }
+
+    void invalidate()
+    {
+        for (auto& l : layers)
+            l = Layer{};
+        ++generation;
+    }
+
+    static int layerFor(float velocity) { return std::clamp(static_cast<int>(velocity * LAYERS), 0, LAYERS - 1); }
+
+    bool isReady(int layer) const { return layers[static_cast<size_t>(layer)].state == State::Ready; }
+    int getLength(int layer) const { return layers[static_cast<size_t>(layer)].length; }
+    float getVelocity(int layer) const { return layers[static_cast<size_t>(layer)].velocity; }
+    const float* data(int layer) const { return samples.data() + static_cast<size_t>(layer) * static_cast<size_t>(capacity); }
+
+    /** Claim an empty layer for recording; returns the generation to record under, or 0 */
+    uint32_t beginRecording(int layer, float velocity)
+    {
+        auto& l = layers[static_cast<size_t>(layer)];
+        if (capacity == 0 || l.state != State::Empty)
+            return 0;
+        l.state = State::Recording;
+        l.velocity = velocity;
+        return generation;
+    }
+
+    /** Where recorded sample pos goes, or nullptr once the recording is void */
+    float* recordSlot(int layer, uint32_t gen, int pos)
+    {
+        if (gen != generation || pos >= capacity)
+            return nullptr;
+        return samples.data() + static_cast<size_t>(layer) * static_cast<size_t>(capacity) + static_cast<size_t>(pos);
+    }
+
+    void finishRecording(int layer, uint32_t gen, int length)
+    {
+        if (gen != generation)
+            return;
+        auto& l = layers[static_cast<size_t>(layer)];
+        l.state = State::Ready;
+        l.length = length;
+    }
+
+    void abandonRecording(int layer, uint32_t gen)
+    {
+        if (gen == generation)
+            layers[static_cast<size_t>(layer)] = Layer{};
+    }
+
+    /** Bytes of recorded hits allocated by prepare() */
+    size_t getHeapBytes() const { return samples.capacity() * sizeof(float); }
+
+private:
+    enum class State { Empty, Recording, Ready };
+
+    struct Layer
+    {
+        State state = State::Empty;
+        int length = 0;
+        float velocity = 1.0f;
+    };
+
+    std::vector<float> samples;
+    std::array<Layer, LAYERS> layers{};
+    int capacity = 0;
+    uint32_t generation = 1;  // Bumped by invalidate(), voiding recordings in flight
+};
 
 /**
  * @brief Single FM drum voice (one-shot trigger)
@@ -29,39 +143,134 @@ public:
     {
         this->sampleRate = sampleRate;
         sampleRateInv = 1.0f / static_cast<float>(sampleRate);
+        updateDecayCoefficients();
+        layer.prepare(sampleRate);
     }
 
     void trigger(float vel)
     {
+        stopRecording();
+
         velocity = vel;
         active = true;
-        phase = 0.0f;
-        modPhase = 0.0f;
+        carrier.reset();
+        modulator.reset();
         pitchEnvValue = 1.0f;
         ampEnvValue = 1.0f;
+        choked = false;
+        chokeLevel = 1.0f;
+        hitPos = 0;
 
-        // Calculate decay coefficients from times
-        pitchDecayCoeff = std::exp(-1.0f / (pitchDecayTime * static_cast<float>(sampleRate)));
-        ampDecayCoeff = std::exp(-1.0f / (ampDecayTime * static_cast<float>(sampleRate)));
+        // Replay this layer if it's cached, else record it if nobody is
+        replaying = false;
+        if (cache)
+        {
+            cacheLayer = HitCache::layerFor(vel);
+            replaying = cache->isReady(cacheLayer);
+            if (replaying)
+                replayGain = vel / cache->getVelocity(cacheLayer);
+            else
+                recording = cache->beginRecording(cacheLayer, vel);
+        }
+
+        layer.trigger(vel);
     }
 
-    void render(float* outputL, float* outputR, int numSamples)
+    /**
+     * @brief Cut the hit short: a fast fade (CHOKE_SECONDS time constant) rather than a click
+     *
+     * The fade is applied after the hit, so a hit being recorded for the
+     * cache keeps synthesizing, silently, to its natural end: with choking
+     * hats, no hit would ever be recorded otherwise.
+     */
+    void choke()
     {
-        if (!active)
-            return;
+        choked = active;
+        layer.choke();
+    }
+
+    /** Share a drum's HitCache (nullptr: always synthesize) */
+    void setHitCache(HitCache* c)
+    {
+        stopRecording();
+        cache = c;
+    }
 
-        static constexpr float TWO_PI = 6.283185307179586f;
+    /**
+     * @brief Render the hit into the output buffers, times gain
+     * @param accumulate Add to the buffers (true) or overwrite them (false;
+     *                   samples after the hit ends are written as silence)
+     */
+    void render(float* outputL, float* outputR, int numSamples, float gain = 1.0f, bool accumulate = true)
+    {
+        if (active)
+        {
+            if (replaying)
+                renderReplay(outputL, outputR, numSamples, gain, accumulate);
+            else
+                renderHit(outputL, outputR, numSamples, gain, accumulate);
+            accumulate = true;
+        }
+
+        if (layer.isActive())
+            layer.render(outputL, outputR, numSamples, gain, accumulate);
+    }
+
+    /** True while the hit or its sample layer is sounding */
+    bool isActive() const { return active || layer.isActive(); }
+
+    /** Current loudness (envelope x velocity), for picking a voice to steal */
+    float getLevel() const { return std::max(active ? ampEnvValue * chokeLevel * velocity : 0.0f, layer.getLevel()); }
+
+    /** The drum's sample layer, for its sample and parameters */
+    SampleLayer& getSampleLayer() { return layer; }
+
+    /** Restart the noise sequence (reproducible renders, see Noise.h) */
+    void setNoiseSeed(uint32_t seed) { rng.reseed(seed); }
+
+    // Parameter setters
+    void setCarrierFreq(float freq) { carrierFreq = freq; }
+    void setModRatio(float ratio) { modRatio = ratio; }
+    void setModDepth(float depth) { modDepth = depth; }
+    void setPitchDecay(float ms) { pitchDecayTime = ms * 0.001f; updateDecayCoefficients(); }
+    void setPitchAmount(float amt) { pitchAmount = amt; }
+    void setAmpDecay(float ms) { ampDecayTime = ms * 0.001f; updateDecayCoefficients(); }
+    void setNoiseAmount(float noise) { noiseAmount = noise; }
+    void setLevel(float lvl) { level = lvl; }
+
+private:
+    static constexpr float TWO_PI = 6.283185307179586f;
+    static constexpr float CHOKE_SECONDS = 0.001f;
+
+    /** Synthesize the hit, recording it for the cache if this layer's recording is ours */
+    void renderHit(float* outputL, float* outputR, int numSamples, float gain, bool accumulate)
+    {
+        const float fmDepth = modDepth * 6.0f / TWO_PI; // FM index range 0-6, in cycles
 
         for (int i = 0; i < numSamples; ++i)
         {
             // Exponential decay envelopes
             pitchEnvValue *= pitchDecayCoeff;
             ampEnvValue *= ampDecayCoeff;
+            if (choked)
+                chokeLevel *= chokeCoeff;
 
             // Check if voice is done (amplitude below threshold)
             if (ampEnvValue < 0.0001f)
             {
                 active = false;
+                if (recording)
+                    cache->finishRecording(cacheLayer, recording, hitPos);
+                recording = 0;
+                if (!accumulate)
+                    silence(outputL + i, outputR + i, numSamples - i);
+                return;
+            }
+            if (chokeLevel < 0.0001f && !recording)
+            {
+                active = false;
+                if (!accumulate)
+                    silence(outputL + i, outputR + i, numSamples - i);
                 return;
             }
 
@@ -75,64 +284,108 @@ public:
             float phaseInc = currentFreq * sampleRateInv;
             float modPhaseInc = modFreq * sampleRateInv;
 
-            // FM modulator
-            float modulator = std::sin(modPhase * TWO_PI);
-            modPhase += modPhaseInc;
-            if (modPhase >= 1.0f) modPhase -= 1.0f;
-
-            // FM carrier with modulation
-            float fmIndex = modDepth * 6.0f; // FM index range 0-6
-            float carrier = std::sin((phase + modulator * fmIndex / TWO_PI) * TWO_PI);
-            phase += phaseInc;
-            if (phase >= 1.0f) phase -= 1.0f;
+            // FM modulator, then the carrier it modulates
+            float mod = modulator.process(0.0f, modPhaseInc);
+            float car = carrier.process(mod * fmDepth, phaseInc);
 
             // Noise component (for snare/hat)
             float noise = 0.0f;
             if (noiseAmount > 0.0f)
             {
-                noise = (dist(rng) * 2.0f - 1.0f) * noiseAmount;
+                noise = rng.unifPM1() * noiseAmount;
             }
 
             // Mix carrier and noise
-            float output = (carrier * (1.0f - noiseAmount) + noise) * ampEnvValue * velocity * level;
+            float output = (car * (1.0f - noiseAmount) + noise) * ampEnvValue * velocity * level;
 
             // Soft clip for warmth
-            output = std::tanh(output * 1.5f);
+            output = FastMath::tanh(output * 1.5f);
+
+            if (recording)
+            {
+                if (float* slot = cache->recordSlot(cacheLayer, recording, hitPos))
+                    *slot = output;
+                else
+                    stopRecording();
+            }
+            ++hitPos;
+            output *= chokeLevel * gain;
 
             // Output
-            outputL[i] += output;
-            outputR[i] += output;
+            write(outputL[i], outputR[i], output, accumulate);
         }
     }
 
-    bool isActive() const { return active; }
+    /** Play the cached hit, with the choke fade applied on top */
+    void renderReplay(float* outputL, float* outputR, int numSamples, float gain, bool accumulate)
+    {
+        const float* hit = cache->data(cacheLayer);
+        const int n = std::min(numSamples, cache->getLength(cacheLayer) - hitPos);
+        const float hitGain = replayGain * gain;
+        for (int i = 0; i < n; ++i)
+        {
+            if (choked)
+                chokeLevel *= chokeCoeff;
+            write(outputL[i], outputR[i], hit[hitPos + i] * hitGain * chokeLevel, accumulate);
+        }
+        hitPos += n;
+        if (!accumulate)
+            silence(outputL + n, outputR + n, numSamples - n);
 
-    // Parameter setters
-    void setCarrierFreq(float freq) { carrierFreq = freq; }
-    void setModRatio(float ratio) { modRatio = ratio; }
-    void setModDepth(float depth) { modDepth = depth; }
-    void setPitchDecay(float ms) { pitchDecayTime = ms * 0.001f; }
-    void setPitchAmount(float amt) { pitchAmount = amt; }
-    void setAmpDecay(float ms) { ampDecayTime = ms * 0.001f; }
-    void setNoiseAmount(float noise) { noiseAmount = noise; }
-    void setLevel(float lvl) { level = lvl; }
+        if (n < numSamples || chokeLevel < 0.0001f)
+            active = false;
+    }
+
+    static void write(float& left, float& right, float output, bool accumulate)
+    {
+        if (accumulate)
+        {
+            left += output;
+            right += output;
+        }
+        else
+        {
+            left = right = output;
+        }
+    }
+
+    static void silence(float* outputL, float* outputR, int numSamples)
+    {
+        std::fill(outputL, outputL + numSamples, 0.0f);
+        std::fill(outputR, outputR + numSamples, 0.0f);
+    }
+
+    void stopRecording()
+    {
+        if (recording)
+            cache->abandonRecording(cacheLayer, recording);
+        recording = 0;
+    }
+
+    void updateDecayCoefficients()
+    {
+        pitchDecayCoeff = std::exp(-1.0f / (pitchDecayTime * static_cast<float>(sampleRate)));
+        ampDecayCoeff = std::exp(-1.0f / (ampDecayTime * static_cast<float>(sampleRate)));
+        chokeCoeff = std::exp(-1.0f / (CHOKE_SECONDS * static_cast<float>(sampleRate)));
+    }
 
-private:
     double sampleRate = 44100.0;
     float sampleRateInv = 1.0f / 44100.0f;
 
     bool active = false;
+    bool choked = false;
     float velocity = 1.0f;
 
-    // Oscillator state
-    float phase = 0.0f;
-    float modPhase = 0.0f;
+    // Operators
+    FMOperator carrier;
+    FMOperator modulator;
 
     // Envelope state
     float pitchEnvValue = 0.0f;
     float ampEnvValue = 0.0f;
     float pitchDecayCoeff = 0.999f;
     float ampDecayCoeff = 0.9999f;
+    float chokeCoeff = 0.98f;
 
     // Parameters
     float carrierFreq = 60.0f;   // Hz
@@ -145,6 +398,16 @@ private:
     float level = 0.8f;          // 0-1
 
     // Noise generator
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+    NoiseSource rng;
+
+    // Hit cache (see HitCache)
+    HitCache* cache = nullptr;
+    int cacheLayer = 0;
+    int hitPos = 0;          // Samples into the hit
+    uint32_t recording = 0;  // Generation being recorded under, 0 when not
+    bool replaying = false;
+    float replayGain = 1.0f;
+    float chokeLevel = 1.0f; // Choke fade, on top of the hit
+
+    SampleLayer layer;       // Played under the hit, if the drum has a sample
 };
@@ -0,0 +1,147 @@
+/**
+ * @file SampleLayer.h
+ * @brief A one-shot sample played under a drum voice's FM hit
+ *
+ * Each DrumVoice carries a SampleLayer: a hit starts the drum's sample
+ * from its first frame alongside the FM, at velocity x the layer level,
+ * and a choke fades both together. The sample is a MappedSample (see
+ * core/dsp/MappedSample.h), shared with every other voice and instance
+ * playing the same file, so a layer holds only a pointer and a position.
+ *
+ * Tune shifts the playback rate in semitones, on top of the conversion
+ * from the file's sample rate to the engine's; frames are interpolated
+ * linearly between.
+ *
+ * @note No allocation or locks: real-time safe. setSample() is not: the
+ *       engine calls it with the audio thread held off (see
+ *       DrumEngine::setSampleLayer).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "MappedSample.h"
+
+class SampleLayer
+{
+public:
+    static constexpr float MAX_TUNE = 24.0f;  // Semitones either way
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        chokeCoeff = std::exp(-1.0f / (CHOKE_SECONDS * static_cast<float>(sr)));
+        active = false;
+        updateRate();
+    }
+
+    /** The sample to play (nullptr: none); stops the one sounding */
+    void setSample(const MappedSample* s)
+    {
+        sample = s;
+        active = false;
+        updateRate();
+    }
+
+    /** Layer volume under the FM, 0-1 */
+    void setLevel(float value) { level = std::clamp(value, 0.0f, 1.0f); }
+
+    /** Playback pitch, in semitones from the sample's own */
+    void setTune(float semitones)
+    {
+        tune = std::clamp(semitones, -MAX_TUNE, MAX_TUNE);
+        updateRate();
+    }
+
+    void trigger(float velocity)
+    {
+        active = sample != nullptr && level > 0.0f;
+        position = 0.0;
+        hitGain = velocity * level;
+        choked = false;
+        chokeLevel = 1.0f;
+    }
+
+    /** Fade out with the FM hit (see DrumVoice::choke) */
+    void choke() { choked = active; }
+
+    bool isActive() const { return active; }
+
+    /** Current loudness, for picking a voice to steal */
+    float getLevel() const { return active ? hitGain * chokeLevel : 0.0f; }
+
+    /**
+     * @brief Play the sample into the output buffers, times gain
+     * @param accumulate Add to the buffers (true) or overwrite them (false;
+     *                   samples after the sample ends are written as silence)
+     */
+    void render(float* outputL, float* outputR, int numSamples, float gain, bool accumulate)
+    {
+        const size_t last = sample->getFrames() - 1;
+        const float scale = hitGain * gain;
+
+        int i = 0;
+        for (; i < numSamples; ++i)
+        {
+            const auto frame = static_cast<size_t>(position);
+            if (frame >= last || chokeLevel < 0.0001f)
+            {
+                active = false;
+                break;
+            }
+
+            const float frac = static_cast<float>(position - static_cast<double>(frame));
+            const float l0 = sample->sample(0, frame);
+            const float r0 = sample->sample(1, frame);
+            const float l = l0 + (sample->sample(0, frame + 1) - l0) * frac;
+            const float r = r0 + (sample->sample(1, frame + 1) - r0) * frac;
+
+            if (choked)
+                chokeLevel *= chokeCoeff;
+            const float g = scale * chokeLevel;
+            if (accumulate)
+            {
+                outputL[i] += l * g;
+                outputR[i] += r * g;
+            }
+            else
+            {
+                outputL[i] = l * g;
+                outputR[i] = r * g;
+            }
+            position += rate;
+        }
+
+        if (!accumulate)
+        {
+            std::fill(outputL + i, outputL + numSamples, 0.0f);
+            std::fill(outputR + i, outputR + numSamples, 0.0f);
+        }
+    }
+
+private:
+    static constexpr float CHOKE_SECONDS = 0.001f;  // As DrumVoice's
+
+    void updateRate()
+    {
+        const double fileRate = sample != nullptr ? sample->getSampleRate() : sampleRate;
+        rate = fileRate / sampleRate * std::exp2(static_cast<double>(tune) / 12.0);
+    }
+
+    const MappedSample* sample = nullptr;
+    double sampleRate = 44100.0;
+    double position = 0.0;  // Frame, fractional
+    double rate = 1.0;      // Frames per output sample
+
+    bool active = false;
+    bool choked = false;
+    float hitGain = 0.0f;   // Velocity x level, for this hit
+    float chokeLevel = 1.0f;
+    float chokeCoeff = 0.98f;
+
+    float level = 0.8f;
+    float tune = 0.0f;
+};
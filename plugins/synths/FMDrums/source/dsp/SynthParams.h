@@ -0,0 +1,71 @@
+/**
+ * @file SynthParams.h
+ * @brief FMDrums parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * DrumEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(KickCarrierFreq,  "kick_carrier_freq") \
+    X(KickModRatio,     "kick_mod_ratio") \
+    X(KickModDepth,     "kick_mod_depth") \
+    X(KickPitchDecay,   "kick_pitch_decay") \
+    X(KickPitchAmount,  "kick_pitch_amount") \
+    X(KickAmpDecay,     "kick_amp_decay") \
+    X(KickLevel,        "kick_level") \
+    X(KickLayerLevel,   "kick_layer_level") \
+    X(KickLayerTune,    "kick_layer_tune") \
+    X(SnareCarrierFreq, "snare_carrier_freq") \
+    X(SnareModRatio,    "snare_mod_ratio") \
+    X(SnareModDepth,    "snare_mod_depth") \
+    X(SnareNoise,       "snare_noise") \
+    X(SnarePitchDecay,  "snare_pitch_decay") \
+    X(SnareAmpDecay,    "snare_amp_decay") \
+    X(SnareLevel,       "snare_level") \
+    X(SnareLayerLevel,  "snare_layer_level") \
+    X(SnareLayerTune,   "snare_layer_tune") \
+    X(HatCarrierFreq,   "hat_carrier_freq") \
+    X(HatModRatio,      "hat_mod_ratio") \
+    X(HatModDepth,      "hat_mod_depth") \
+    X(HatNoise,         "hat_noise") \
+    X(HatAmpDecay,      "hat_amp_decay") \
+    X(HatLevel,         "hat_level") \
+    X(HatLayerLevel,    "hat_layer_level") \
+    X(HatLayerTune,     "hat_layer_tune") \
+    X(PercCarrierFreq,  "perc_carrier_freq") \
+    X(PercModRatio,     "perc_mod_ratio") \
+    X(PercModDepth,     "perc_mod_depth") \
+    X(PercPitchDecay,   "perc_pitch_decay") \
+    X(PercAmpDecay,     "perc_amp_decay") \
+    X(PercLevel,        "perc_level") \
+    X(PercLayerLevel,   "perc_layer_level") \
+    X(PercLayerTune,    "perc_layer_tune") \
+    X(MasterLevel,      "master_level")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
@@ -7,6 +7,13 @@
 #include <catch2/catch_approx.hpp>
 #include "dsp/DrumVoice.h"
 #include "dsp/DrumEngine.h"
+#include "FMOperator.h"
+#include "RealtimeGuard.h"
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <vector>
 
 TEST_CASE("DrumVoice initializes correctly", "[DrumVoice]")
 {
@@ -86,3 +93,380 @@ TEST_CASE("DrumEngine produces stereo output", "[DrumEngine]")
     REQUIRE(maxLeft > 0.01f);
     REQUIRE(maxRight > 0.01f);
 }
+
+TEST_CASE("DrumEngine plays hits at their sample offset", "[DrumEngine]")
+{
+    DrumEngine engine;
+    engine.prepare(44100.0, 1024);
+
+    engine.noteOn(DrumEngine::NOTE_KICK, 1.0f, 300);
+
+    std::array<float, 1024> left{}, right{};
+    engine.renderBlock(left.data(), right.data(), 1024);
+
+    float maxBefore = 0.0f, maxAfter = 0.0f;
+    for (int i = 0; i < 300; ++i)
+        maxBefore = std::max(maxBefore, std::abs(left[i]));
+    for (int i = 300; i < 1024; ++i)
+        maxAfter = std::max(maxAfter, std::abs(left[i]));
+
+    REQUIRE(maxBefore == 0.0f);
+    REQUIRE(maxAfter > 0.01f);
+}
+
+TEST_CASE("DrumEngine mixes hits at the master level", "[DrumEngine]")
+{
+    DrumEngine full, half;
+    full.prepare(44100.0, 512);
+    half.prepare(44100.0, 512);
+    full.setMasterLevel(1.0f);
+    half.setMasterLevel(0.5f);
+
+    for (auto* engine : {&full, &half})
+    {
+        engine->noteOn(DrumEngine::NOTE_KICK, 1.0f);
+        engine->noteOn(DrumEngine::NOTE_SNARE, 0.7f, 100);
+        engine->noteOn(DrumEngine::NOTE_HAT_CLOSED, 0.5f, 200);
+    }
+
+    // The output is written, not added to: stale samples don't leak through
+    for (int block = 0; block < 40; ++block)
+    {
+        std::array<float, 512> fullL{}, fullR{}, halfL{}, halfR{};
+        fullL.fill(7.0f);
+        fullR.fill(7.0f);
+        halfL.fill(7.0f);
+        halfR.fill(7.0f);
+        full.renderBlock(fullL.data(), fullR.data(), 512);
+        half.renderBlock(halfL.data(), halfR.data(), 512);
+
+        for (int i = 0; i < 512; ++i)
+        {
+            REQUIRE(std::abs(fullL[i]) < 2.0f);
+            REQUIRE(halfL[i] == Catch::Approx(fullL[i] * 0.5f).margin(1.0e-6));
+            REQUIRE(halfR[i] == halfL[i]);
+        }
+    }
+}
+
+TEST_CASE("DrumEngine renders drums to their own outputs", "[DrumEngine]")
+{
+    DrumEngine mixed, split;
+    for (auto* engine : {&mixed, &split})
+    {
+        engine->prepare(44100.0, 512);
+        engine->setNoiseSeed(7);
+        engine->noteOn(DrumEngine::NOTE_KICK, 1.0f);
+        engine->noteOn(DrumEngine::NOTE_SNARE, 0.7f, 100);
+        engine->noteOn(DrumEngine::NOTE_HAT_CLOSED, 0.5f, 200);
+    }
+
+    // Kick and snare on their own pairs; hat and perc share the main one
+    for (int block = 0; block < 40; ++block)
+    {
+        std::array<float, 512> mixL{}, mixR{}, mainL{}, mainR{}, kickL{}, kickR{}, snareL{}, snareR{};
+        for (auto* buffer : {&mainL, &mainR, &kickL, &kickR, &snareL, &snareR})
+            buffer->fill(7.0f);  // Stale samples must not leak through
+
+        mixed.renderBlock(mixL.data(), mixR.data(), 512);
+        split.renderBlock({kickL.data(), snareL.data(), mainL.data(), mainL.data()},
+                          {kickR.data(), snareR.data(), mainR.data(), mainR.data()}, 512);
+
+        for (int i = 0; i < 512; ++i)
+        {
+            REQUIRE(mainL[i] + kickL[i] + snareL[i] == Catch::Approx(mixL[i]).margin(1.0e-5));
+            REQUIRE(mainR[i] + kickR[i] + snareR[i] == Catch::Approx(mixR[i]).margin(1.0e-5));
+        }
+
+        // Nothing but the kick before the snare's hit
+        if (block == 0)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                REQUIRE(snareL[i] == 0.0f);
+                REQUIRE(mainL[i] == 0.0f);
+            }
+            REQUIRE(std::abs(kickL[50]) > 0.0f);
+        }
+    }
+}
+
+TEST_CASE("DrumEngine voice pools", "[DrumEngine]")
+{
+    DrumEngine engine;
+    engine.prepare(44100.0, 512);
+    std::array<float, 512> left{}, right{};
+
+    SECTION("A retrigger rings on under the new hit")
+    {
+        engine.noteOn(DrumEngine::NOTE_KICK, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 512);
+        engine.noteOn(DrumEngine::NOTE_KICK, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+    }
+
+    SECTION("A full pool steals rather than growing")
+    {
+        for (int i = 0; i < DrumEngine::VOICES_PER_DRUM + 2; ++i)
+        {
+            engine.noteOn(DrumEngine::NOTE_SNARE, 1.0f);
+            engine.renderBlock(left.data(), right.data(), 64);
+        }
+        REQUIRE(engine.getActiveVoiceCount() == DrumEngine::VOICES_PER_DRUM);
+    }
+
+    SECTION("Hats choke each other, other drums don't")
+    {
+        engine.noteOn(DrumEngine::NOTE_HAT_OPEN, 1.0f);
+        engine.noteOn(DrumEngine::NOTE_SNARE, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 64);
+        engine.noteOn(DrumEngine::NOTE_HAT_CLOSED, 1.0f);
+
+        // 30 ms: the choked hat has faded out, the new hat and snare haven't
+        for (int i = 0; i < 3; ++i)
+            engine.renderBlock(left.data(), right.data(), 441);
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+
+        engine.setChokeGroup(DrumEngine::Hat, 0);
+        engine.noteOn(DrumEngine::NOTE_HAT_CLOSED, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 441);
+        REQUIRE(engine.getActiveVoiceCount() == 3);
+    }
+
+    SECTION("Silence once every hit has decayed")
+    {
+        engine.noteOn(DrumEngine::NOTE_HAT_CLOSED, 1.0f);
+        for (int i = 0; i < 1000 && engine.getActiveVoiceCount() > 0; ++i)
+            engine.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+
+        engine.renderBlock(left.data(), right.data(), 512);
+        for (float s : left)
+            REQUIRE(s == 0.0f);
+    }
+}
+
+TEST_CASE("DrumEngine hit cache replays static hits", "[DrumEngine]")
+{
+    DrumEngine engine;
+    engine.setHitCacheEnabled(true);
+    engine.prepare(44100.0, 512);
+    engine.setNoiseSeed(3);
+    engine.setHatAmpDecay(50.0f);  // ~0.5 s hits, well inside the cache
+    engine.setHatNoise(0.5f);
+
+    auto renderHit = [&engine](float velocity)
+    {
+        std::vector<float> left(44100, 0.0f), right(44100, 0.0f);
+        engine.noteOn(DrumEngine::NOTE_HAT_CLOSED, velocity);
+        for (int pos = 0; pos < 44100; pos += 441)
+            engine.renderBlock(left.data() + pos, right.data() + pos, 441);
+        return left;
+    };
+
+    const auto first = renderHit(0.8f);
+    const auto replayed = renderHit(0.8f);
+    REQUIRE(replayed == first);  // Noise included: it's the recording
+
+    // Same layer, lower velocity: the recording scaled down
+    const auto softer = renderHit(0.76f);
+    for (size_t i = 0; i < first.size(); i += 97)
+        REQUIRE(softer[i] == Catch::Approx(first[i] * 0.76f / 0.8f).margin(1.0e-6));
+
+    // A parameter change invalidates: this hit is synthesized afresh
+    engine.setHatModDepth(0.9f);
+    const auto changed = renderHit(0.8f);
+    REQUIRE(changed != first);
+    REQUIRE(renderHit(0.8f) == changed);
+}
+
+TEST_CASE("FM operator kernel matches std::sin", "[FMOperator]")
+{
+    const auto& table = FMSineTable::get();
+
+    SECTION("Table sine, scalar and four lanes")
+    {
+        float maxError = 0.0f;
+        alignas(16) float lanes[4];
+        for (int i = -20000; i < 20000; i += 4)
+        {
+            // Phases well outside 0-1 too: modulation pushes them there
+            const float x = static_cast<float>(i) * 0.000173f;
+            SIMD_MM(store_ps)(lanes, table.sine(SIMD_MM(setr_ps)(x, x + 0.25f, x + 0.5f, x + 0.75f)));
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const float xl = x + 0.25f * static_cast<float>(lane);
+                const float expected = static_cast<float>(std::sin(6.283185307179586 * xl));
+                maxError = std::max(maxError, std::abs(lanes[lane] - expected));
+                maxError = std::max(maxError, std::abs(table.sine(xl) - expected));
+            }
+        }
+        REQUIRE(maxError < 2.0e-5f);
+    }
+
+    SECTION("A quad runs four operators exactly as four scalar ones")
+    {
+        FMOperatorQuad quad;
+        quad.reset(0.0f, 0.1f, 0.2f, 0.3f);
+        quad.setFeedback(SIMD_MM(setr_ps)(0.0f, 0.4f, 0.0f, 0.9f));
+
+        std::array<FMOperator, 4> ops;
+        const float start[4] = {0.0f, 0.1f, 0.2f, 0.3f};
+        const float feedback[4] = {0.0f, 0.4f, 0.0f, 0.9f};
+        const float increment[4] = {0.01f, 0.023f, 0.005f, 0.031f};
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            ops[static_cast<size_t>(lane)].reset(start[lane]);
+            ops[static_cast<size_t>(lane)].setFeedback(feedback[lane]);
+        }
+
+        alignas(16) float lanes[4];
+        float maxError = 0.0f;
+        for (int n = 0; n < 1000; ++n)
+        {
+            const float pm = 0.3f * std::sin(0.01f * static_cast<float>(n));
+            SIMD_MM(store_ps)(lanes, quad.process(SIMD_MM(set1_ps)(pm), SIMD_MM(load_ps)(increment)));
+            for (int lane = 0; lane < 4; ++lane)
+                maxError = std::max(maxError, std::abs(lanes[lane] - ops[static_cast<size_t>(lane)].process(pm, increment[lane])));
+        }
+        REQUIRE(maxError < 1.0e-5f);
+    }
+}
+
+TEST_CASE("DrumEngine renders without allocating or locking", "[DrumEngine][realtime]")
+{
+    DrumEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("DrumEngine stays within its memory budget", "[DrumEngine][memory]")
+{
+    // The hit cache is the only heap: 8 layers of 2 seconds per drum, once enabled
+    constexpr size_t BUDGET_48K = 16u << 20;
+    constexpr size_t BUDGET_192K = 56u << 20;
+
+    auto engine = std::make_unique<DrumEngine>();
+    engine->prepare(48000.0, 512);
+    REQUIRE(engine->memoryReport().getHeapBytes() == 0);
+    REQUIRE(engine->memoryReport().getStaticBytes() == sizeof(DrumEngine));
+
+    engine->setHitCacheEnabled(true);
+    const MemoryReport at48k = engine->memoryReport();
+    INFO(at48k.toString());
+    REQUIRE(at48k.getBytes("hit cache") == 4 * 8 * 96000 * sizeof(float));
+    CHECK(at48k.getInstanceBytes() <= BUDGET_48K);
+
+    engine->prepare(192000.0, 512);
+    const MemoryReport at192k = engine->memoryReport();
+    INFO(at192k.toString());
+    REQUIRE(at192k.getBytes("hit cache") == 4 * at48k.getBytes("hit cache"));
+    CHECK(at192k.getInstanceBytes() <= BUDGET_192K);
+}
+
+TEST_CASE("DrumEngine plays sample layers from a shared mapped file", "[DrumEngine][samples]")
+{
+    constexpr double RATE = 48000.0;
+    constexpr int FRAMES = 24000;
+    constexpr int bufferSize = 2048;
+
+    // A mono sine sweep, long enough to play past the prefetched head
+    std::vector<float> source(FRAMES);
+    for (int i = 0; i < FRAMES; ++i)
+        source[static_cast<size_t>(i)] = 0.5f * std::sin(0.0005f * static_cast<float>(i) * static_cast<float>(i) / FRAMES * 40.0f);
+    const auto path = (std::filesystem::temp_directory_path() / "FMDrums-layer-test.ams").string();
+    REQUIRE(MappedSample::saveFile(path, source.data(), nullptr, FRAMES, static_cast<uint32_t>(RATE)));
+
+    // Every load of the file is the same mapping
+    auto sample = MappedSampleRegistry::get().load(path);
+    REQUIRE(sample != nullptr);
+    REQUIRE(MappedSampleRegistry::get().load(path) == sample);
+    REQUIRE(sample->getFrames() == FRAMES);
+    REQUIRE(sample->getChannels() == 1);
+    REQUIRE(sample->getHeadFrames() == 960);  // 20 ms
+#if SYNTH_MAPPED_SAMPLE_POSIX
+    REQUIRE(sample->isMapped());
+    REQUIRE(sample->getHeapBytes() < FRAMES * sizeof(float) / 10);
+#endif
+    for (size_t frame : {size_t{0}, size_t{100}, sample->getHeadFrames() - 1, sample->getHeadFrames(), size_t{20000}})
+    {
+        CHECK(sample->sample(0, frame) == Catch::Approx(source[frame]).margin(1.0 / 32767.0));
+        CHECK(sample->sample(1, frame) == sample->sample(0, frame));
+    }
+
+    // The kick's FM silent, so the output is the layer alone
+    auto play = [&](DrumEngine& engine, float tune) {
+        engine.prepare(RATE, bufferSize);
+        engine.setKickLevel(0.0f);
+        engine.setKickLayerLevel(1.0f);
+        engine.setKickLayerTune(tune);
+        engine.setMasterLevel(1.0f);
+        engine.noteOn(DrumEngine::NOTE_KICK, 1.0f);
+        std::vector<float> left(bufferSize), right(bufferSize);
+        engine.renderBlock(left.data(), right.data(), bufferSize);
+        return left;
+    };
+
+    DrumEngine a, b;
+    REQUIRE(a.setSampleLayer(DrumEngine::Kick, sample) == nullptr);
+    b.setSampleLayer(DrumEngine::Kick, sample);
+    REQUIRE(a.getSampleLayer(DrumEngine::Kick) == b.getSampleLayer(DrumEngine::Kick));
+
+    // Instances share the sample: it's in neither one's heap
+    const MemoryReport report = a.memoryReport();
+    INFO(report.toString());
+    REQUIRE(report.getHeapBytes() == 0);
+    REQUIRE(report.getBytes("sample layers") >= sample->getHeapBytes());
+
+    const auto unison = play(a, 0.0f);
+    for (size_t i = 0; i < bufferSize; i += 97)
+        CHECK(unison[i] == Catch::Approx(source[i]).margin(1.0e-3));
+
+    // Up an octave reads two frames a sample
+    const auto octave = play(b, 12.0f);
+    for (size_t i = 0; i < bufferSize; i += 97)
+        CHECK(octave[i] == Catch::Approx(source[2 * i]).margin(1.0e-3));
+
+    // Playing past the head neither allocates nor locks
+    const auto rt = RealtimeGuard::check([&] {
+        std::array<float, bufferSize> left{}, right{};
+        for (int block = 0; block < 12; ++block)
+            a.renderBlock(left.data(), right.data(), bufferSize);
+    });
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.locks == 0);
+
+    // Clearing hands back the sample and cuts the layer sounding
+    a.noteOn(DrumEngine::NOTE_KICK, 1.0f);
+    REQUIRE(a.setSampleLayer(DrumEngine::Kick, nullptr) == sample);
+    std::vector<float> left(bufferSize), right(bufferSize);
+    a.renderBlock(left.data(), right.data(), bufferSize);
+    for (float x : left)
+        REQUIRE(x == 0.0f);
+
+    b.setSampleLayer(DrumEngine::Kick, nullptr);
+    sample.reset();
+    std::filesystem::remove(path);
+}
@@ -3,7 +3,8 @@
  * @brief FM Drums synthesizer UI
  *
  * 4 drum channels: KICK, SNARE, HAT, PERC
- * Each with FM synthesis and fast envelopes for punchy percussion.
+ * Each with FM synthesis and fast envelopes for punchy percussion, and an
+ * optional sample layered under the FM.
  */
 
 import React from 'react';
@@ -27,7 +28,7 @@ const getNormalized = (paramId: string, rawValue: number): number => {
 };
 
 const App: React.FC = () => {
-  const { isConnected, audioData } = useJUCEBridge({
+  const { isConnected, audioData, sampleLayers, loadSampleLayer, clearSampleLayer } = useJUCEBridge({
     enableAudioData: true,
     audioChannel: 'master',
   });
@@ -37,6 +38,33 @@ const App: React.FC = () => {
     syncWithJUCE: true,
   });
 
+  // A drum's sample layer: its file, level and tune (drum in DrumEngine::Drum order)
+  const layerRow = (drum: number, prefix: string, label: string) => (
+    <SynthRow label={`${label} LAYER`}>
+      <div className="sample-layer">
+        <button className="reset-button" onClick={() => loadSampleLayer(drum)}>Load</button>
+        <button className="reset-button" onClick={() => clearSampleLayer(drum)} disabled={!sampleLayers[drum]}>
+          Clear
+        </button>
+        <span className="sample-layer-name">{sampleLayers[drum] || 'No sample'}</span>
+      </div>
+      <SynthKnob
+        label="LEVEL"
+        min={0}
+        max={1}
+        value={getDenormalized(`${prefix}_layer_level`, paramValues[`${prefix}_layer_level`] ?? 0.8)}
+        onChange={(v) => handleChange(`${prefix}_layer_level`, getNormalized(`${prefix}_layer_level`, v))}
+      />
+      <SynthKnob
+        label="TUNE"
+        min={-24}
+        max={24}
+        value={getDenormalized(`${prefix}_layer_tune`, paramValues[`${prefix}_layer_tune`] ?? 0.5)}
+        onChange={(v) => handleChange(`${prefix}_layer_tune`, getNormalized(`${prefix}_layer_tune`, v))}
+      />
+    </SynthRow>
+  );
+
   return (
     <div className="synth-container">
       {/* HEADER */}
@@ -105,6 +133,8 @@ const App: React.FC = () => {
         />
       </SynthRow>
 
+      {layerRow(0, 'kick', 'KICK')}
+
       {/* SNARE SECTION */}
       <SynthRow label="SNARE" showPanel>
         <SynthKnob
@@ -161,6 +191,8 @@ const App: React.FC = () => {
         />
       </SynthRow>
 
+      {layerRow(1, 'snare', 'SNARE')}
+
       {/* HAT SECTION */}
       <SynthRow label="HAT" showPanel>
         <SynthKnob
@@ -210,6 +242,8 @@ const App: React.FC = () => {
         />
       </SynthRow>
 
+      {layerRow(2, 'hat', 'HAT')}
+
       {/* PERC SECTION */}
       <SynthRow label="PERC" showPanel>
         <SynthKnob
@@ -259,6 +293,8 @@ const App: React.FC = () => {
         />
       </SynthRow>
 
+      {layerRow(3, 'perc', 'PERC')}
+
       {/* OUTPUT SECTION */}
       <SynthRow label="OUTPUT" showPanel>
         <SynthKnob
@@ -25,15 +25,22 @@ declare global {
       };
     };
     onParameterUpdate?: (paramId: string, value: number) => void;
+    onParametersUpdate?: (values: Record<string, number>) => void;
     onStateUpdate?: (state: Record<string, number>) => void;
     onAudioData?: (samples: number[]) => void;
+    onAudioDataBase64?: (data: string) => void;
+    /** Called by JUCE with each drum's sample layer name ('' if none), in drum order */
+    onSampleLayersUpdate?: (names: string[]) => void;
   }
 }
 
+export type LiveView = 'scope' | 'spectrum' | 'meters' | 'sequencer';
+
 export interface UseJUCEBridgeOptions {
   enableAudioData?: boolean;
   audioChannel?: 'lead' | 'drum' | 'sub' | 'master';
   enablePresets?: boolean;
+  liveViews?: LiveView[];
 }
 
 export interface JUCEInfo {
@@ -53,18 +60,33 @@ export interface UseJUCEBridgeReturn {
   noteOff: (note: number) => void;
   onParameterChange: (callback: (paramId: string, value: number) => void) => void;
   onStateChange: (callback: (state: Record<string, number>) => void) => void;
+  /** Name of each drum's sample layer (kick, snare, hat, perc), '' if none */
+  sampleLayers: string[];
+  /** Open the file chooser for a drum's sample layer */
+  loadSampleLayer: (drum: number) => void;
+  /** Drop a drum's sample layer */
+  clearSampleLayer: (drum: number) => void;
 }
 
 const isJUCEWebView = (): boolean => {
   return typeof window !== 'undefined' && window.__JUCE__ !== undefined;
 };
 
+/**
+ * Decode scope samples sent by the editor: base64 of little-endian Float32
+ */
+const decodeScopeSamples = (data: string): number[] => {
+  const bytes = Uint8Array.from(atob(data), (c) => c.charCodeAt(0));
+  return Array.from(new Float32Array(bytes.buffer, 0, bytes.length >> 2));
+};
+
 export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridgeReturn {
-  const { enableAudioData = false } = options;
+  const { enableAudioData = false, liveViews = enableAudioData ? ['scope'] : [] } = options;
 
   const [isConnected, setIsConnected] = useState(false);
   const [juceInfo, setJuceInfo] = useState<JUCEInfo>({});
   const [audioData, setAudioData] = useState<number[]>([]);
+  const [sampleLayers, setSampleLayers] = useState<string[]>(['', '', '', '']);
 
   const parameterCallbackRef = useRef<((paramId: string, value: number) => void) | null>(null);
   const stateCallbackRef = useRef<((state: Record<string, number>) => void) | null>(null);
@@ -88,22 +110,39 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     window.onStateUpdate = (state: Record<string, number>) => {
       if (stateCallbackRef.current) {
         stateCallbackRef.current(state);
       }
     };
 
+    window.onSampleLayersUpdate = (names: string[]) => {
+      setSampleLayers(names);
+    };
+
     if (enableAudioData) {
       window.onAudioData = (samples: number[]) => {
         setAudioData(samples);
       };
+      window.onAudioDataBase64 = (data: string) => {
+        setAudioData(decodeScopeSamples(data));
+      };
     }
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
+      window.onSampleLayersUpdate = undefined;
       window.onAudioData = undefined;
+      window.onAudioDataBase64 = undefined;
     };
   }, [isConnected, enableAudioData]);
 
@@ -116,6 +155,21 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     });
   }, [isConnected]);
 
+  // Tell the editor which live views are on screen (none while the page is
+  // hidden), so it only ticks fast and feeds the scope while they are
+  const liveViewKey = liveViews.join(',');
+  useEffect(() => {
+    if (!isConnected || liveViewKey === '') return;
+    const views = liveViewKey.split(',');
+    const report = () => callNativeFunction("setLiveViews", document.hidden ? [] : views);
+    report();
+    document.addEventListener('visibilitychange', report);
+    return () => {
+      document.removeEventListener('visibilitychange', report);
+      callNativeFunction("setLiveViews", []);
+    };
+  }, [isConnected, liveViewKey, callNativeFunction]);
+
   const setParameter = useCallback((paramId: string, value: number) => {
     if (!isConnected) return;
     const clampedValue = Math.max(0, Math.min(1, value));
@@ -137,6 +191,15 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     callNativeFunction("noteOff", [note]);
   }, [isConnected, callNativeFunction]);
 
+  // Sample layer file chooser (the editor answers with onSampleLayersUpdate)
+  const loadSampleLayer = useCallback((drum: number) => {
+    callNativeFunction("loadSampleLayer", [drum]);
+  }, [callNativeFunction]);
+
+  const clearSampleLayer = useCallback((drum: number) => {
+    callNativeFunction("clearSampleLayer", [drum]);
+  }, [callNativeFunction]);
+
   const onParameterChange = useCallback((callback: (paramId: string, value: number) => void) => {
     parameterCallbackRef.current = callback;
   }, []);
@@ -155,5 +218,8 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     noteOff,
     onParameterChange,
     onStateChange,
+    sampleLayers,
+    loadSampleLayer,
+    clearSampleLayer,
   };
 }
@@ -24,6 +24,8 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
   kick_pitch_amount: { id: 'kick_pitch_amount', name: 'Kick Pitch Amt', min: 0, max: 1, default: 0.8 },
   kick_amp_decay: { id: 'kick_amp_decay', name: 'Kick Amp Decay', min: 1, max: 2000, default: 400, unit: 'ms' },
   kick_level: { id: 'kick_level', name: 'Kick Level', min: 0, max: 1, default: 0.8 },
+  kick_layer_level: { id: 'kick_layer_level', name: 'Kick Layer Level', min: 0, max: 1, default: 0.8 },
+  kick_layer_tune: { id: 'kick_layer_tune', name: 'Kick Layer Tune', min: -24, max: 24, default: 0, unit: 'st' },
 
   // SNARE
   snare_carrier_freq: { id: 'snare_carrier_freq', name: 'Snare Freq', min: 80, max: 500, default: 180, unit: 'Hz' },
@@ -33,6 +35,8 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
   snare_pitch_decay: { id: 'snare_pitch_decay', name: 'Snare Pitch Decay', min: 1, max: 200, default: 20, unit: 'ms' },
   snare_amp_decay: { id: 'snare_amp_decay', name: 'Snare Amp Decay', min: 1, max: 1000, default: 200, unit: 'ms' },
   snare_level: { id: 'snare_level', name: 'Snare Level', min: 0, max: 1, default: 0.8 },
+  snare_layer_level: { id: 'snare_layer_level', name: 'Snare Layer Level', min: 0, max: 1, default: 0.8 },
+  snare_layer_tune: { id: 'snare_layer_tune', name: 'Snare Layer Tune', min: -24, max: 24, default: 0, unit: 'st' },
 
   // HAT
   hat_carrier_freq: { id: 'hat_carrier_freq', name: 'Hat Freq', min: 200, max: 2000, default: 800, unit: 'Hz' },
@@ -41,6 +45,8 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
   hat_noise: { id: 'hat_noise', name: 'Hat Noise', min: 0, max: 1, default: 0.7 },
   hat_amp_decay: { id: 'hat_amp_decay', name: 'Hat Amp Decay', min: 1, max: 500, default: 80, unit: 'ms' },
   hat_level: { id: 'hat_level', name: 'Hat Level', min: 0, max: 1, default: 0.7 },
+  hat_layer_level: { id: 'hat_layer_level', name: 'Hat Layer Level', min: 0, max: 1, default: 0.8 },
+  hat_layer_tune: { id: 'hat_layer_tune', name: 'Hat Layer Tune', min: -24, max: 24, default: 0, unit: 'st' },
 
   // PERC
   perc_carrier_freq: { id: 'perc_carrier_freq', name: 'Perc Freq', min: 100, max: 1000, default: 400, unit: 'Hz' },
@@ -49,6 +55,8 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
   perc_pitch_decay: { id: 'perc_pitch_decay', name: 'Perc Pitch Decay', min: 1, max: 300, default: 30, unit: 'ms' },
   perc_amp_decay: { id: 'perc_amp_decay', name: 'Perc Amp Decay', min: 1, max: 1000, default: 250, unit: 'ms' },
   perc_level: { id: 'perc_level', name: 'Perc Level', min: 0, max: 1, default: 0.7 },
+  perc_layer_level: { id: 'perc_layer_level', name: 'Perc Layer Level', min: 0, max: 1, default: 0.8 },
+  perc_layer_tune: { id: 'perc_layer_tune', name: 'Perc Layer Tune', min: -24, max: 24, default: 0, unit: 'st' },
 
   // MASTER
   master_level: { id: 'master_level', name: 'Master Level', min: 0, max: 1, default: 0.8 },
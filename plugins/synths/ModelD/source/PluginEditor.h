@@ -9,6 +9,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "EditorRefresh.h"
+#include "ParamChangeFlags.h"
 
 /**
  * @brief WebView-based plugin editor
@@ -26,11 +28,18 @@ public:
 private:
     void timerCallback() override;
 
-    void sendParameterToWebView(const juce::String& paramId, float value);
+    /** Match the timer to what's on screen; attaches the scope FIFO while it's wanted */
+    void updateRefreshRate();
+
+    void sendChangedParametersToWebView();
     void sendAllParametersToWebView();
     void sendAudioDataToWebView();
+    void sendOverrunsToWebView();
+    void sendSpectrumToWebView();
+    juce::var getPerfStatsForWebView() const;
     void handleParameterFromWebView(const juce::String& paramId, float value);
     void handleNoteFromWebView(int note, float velocity, bool isNoteOn);
+    void handleAuditionFromWebView(const juce::var& values);
 
     // Resource provider for serving embedded HTML
     std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
@@ -39,18 +48,34 @@ private:
 
     std::unique_ptr<juce::WebBrowserComponent> webView;
 
+    /** Flags its parameter as changed; can run on the audio thread */
     struct ParameterListener : public juce::AudioProcessorValueTreeState::Listener
     {
         PluginEditor& editor;
-        explicit ParameterListener(PluginEditor& e) : editor(e) {}
-        void parameterChanged(const juce::String& paramId, float newValue) override
+        const int index;
+        ParameterListener(PluginEditor& e, int i) : editor(e), index(i) {}
+        void parameterChanged(const juce::String&, float) override
         {
-            editor.sendParameterToWebView(paramId, newValue);
+            if (!editor.ignoreParameterCallbacks)
+                editor.changedParameters.mark(index);
         }
     };
-    std::unique_ptr<ParameterListener> paramListener;
+    std::vector<std::unique_ptr<ParameterListener>> paramListeners;
+    juce::Array<juce::RangedAudioParameter*> listenedParameters;  // By listener index
+    ParamChangeFlags changedParameters;  // Sent by timerCallback()
+
+    std::atomic<bool> ignoreParameterCallbacks{false};
+
+    /** Newest output samples sent to the oscilloscope per timer tick */
+    static constexpr int SCOPE_WINDOW = 1024;
+    std::array<float, SCOPE_WINDOW> scopeSamples{};
+
+    /** Timer rate, from the window and the web UI's live views */
+    EditorRefresh refresh;
+
+    uint64_t lastOverrunTotal = 0;  // OverrunLog total last sent
 
-    bool ignoreParameterCallbacks = false;
+    uint32_t lastSpectrumFrame = 0;  // Newest spectrum frame sent
 
     juce::File uiDistFolder;  // Path to UI dist folder for resource provider
 
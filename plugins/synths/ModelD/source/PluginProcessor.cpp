@@ -5,6 +5,26 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
+
+#include <cstring>
+
+namespace
+{
+#if AUTOSYNTH_CLAP
+    /** A float the CLAP host may also modulate, per note or for all (SynthEngine::isPolyModulatable) */
+    struct ModulatableParameter : juce::AudioParameterFloat,
+                                  clap_juce_extensions::clap_juce_parameter_capabilities
+    {
+        using juce::AudioParameterFloat::AudioParameterFloat;
+
+        bool supportsMonophonicModulation() override { return true; }
+        bool supportsPolyphonicModulation() override { return true; }
+    };
+#else
+    using ModulatableParameter = juce::AudioParameterFloat;
+#endif
+} // namespace
 
 //==============================================================================
 // Constructor / Destructor
@@ -16,54 +36,21 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+        rangedParams[static_cast<size_t>(i)] = apvts.getParameter(kParamIds[i]);
+    }
 
-    // Oscillator 1
-    osc1WaveformParam = apvts.getRawParameterValue("osc1_waveform");
-    osc1OctaveParam = apvts.getRawParameterValue("osc1_octave");
-    osc1LevelParam = apvts.getRawParameterValue("osc1_level");
-
-    // Oscillator 2
-    osc2WaveformParam = apvts.getRawParameterValue("osc2_waveform");
-    osc2OctaveParam = apvts.getRawParameterValue("osc2_octave");
-    osc2DetuneParam = apvts.getRawParameterValue("osc2_detune");
-    osc2LevelParam = apvts.getRawParameterValue("osc2_level");
-    osc2SyncParam = apvts.getRawParameterValue("osc2_sync");
-
-    // Oscillator 3
-    osc3WaveformParam = apvts.getRawParameterValue("osc3_waveform");
-    osc3OctaveParam = apvts.getRawParameterValue("osc3_octave");
-    osc3DetuneParam = apvts.getRawParameterValue("osc3_detune");
-    osc3LevelParam = apvts.getRawParameterValue("osc3_level");
-
-    // Noise
-    noiseLevelParam = apvts.getRawParameterValue("noise_level");
-
-    // Filter
-    filterCutoffParam = apvts.getRawParameterValue("filter_cutoff");
-    filterResoParam = apvts.getRawParameterValue("filter_reso");
-    filterEnvAmountParam = apvts.getRawParameterValue("filter_env_amount");
-    filterKbdTrackParam = apvts.getRawParameterValue("filter_kbd_track");
-
-    // Amp Envelope
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
-
-    // Filter Envelope
-    filterAttackParam = apvts.getRawParameterValue("filter_attack");
-    filterDecayParam = apvts.getRawParameterValue("filter_decay");
-    filterSustainParam = apvts.getRawParameterValue("filter_sustain");
-    filterReleaseParam = apvts.getRawParameterValue("filter_release");
-
-    // Master
-    masterVolumeParam = apvts.getRawParameterValue("master_volume");
-
-    // LFO
-    lfoRateParam = apvts.getRawParameterValue("lfo_rate");
-    lfoWaveformParam = apvts.getRawParameterValue("lfo_waveform");
-    lfoPitchAmountParam = apvts.getRawParameterValue("lfo_pitch_amount");
-    lfoFilterAmountParam = apvts.getRawParameterValue("lfo_filter_amount");
+#if AUTOSYNTH_CLAP
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        clapParamIds[static_cast<size_t>(i)] = static_cast<uint32_t>(juce::String(kParamIds[i]).hashCode());
+    }
+    noteIdByKey.fill(-1);
+#endif
 }
 
 PluginProcessor::~PluginProcessor()
@@ -183,11 +170,18 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f  // Off by default
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"analog_drift", 1},
+        "Analog Drift",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f  // Off by default
+    ));
+
     // =========================================================================
     // FILTER PARAMETERS
     // =========================================================================
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<ModulatableParameter>(
         juce::ParameterID{"filter_cutoff", 1},
         "Filter Cutoff",
         juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.3f),  // skew=0.3 for log
@@ -195,7 +189,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::AudioParameterFloatAttributes().withLabel("Hz")
     ));
 
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+    params.push_back(std::make_unique<ModulatableParameter>(
         juce::ParameterID{"filter_reso", 1},
         "Filter Resonance",
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
@@ -334,6 +328,58 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"lfo_mode", 1},
+        "LFO Mode",
+        juce::StringArray{"Global", "Per Voice"},
+        0  // Default: Global
+    ));
+
+    // =========================================================================
+    // VOICES
+    // =========================================================================
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"voice_steal", 1},
+        "Voice Steal",
+        juce::StringArray{"Oldest", "Quietest", "Same Note"},
+        0  // Default: Oldest
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"voice_mode", 1},
+        "Voice Mode",
+        juce::StringArray{"Poly", "Paraphonic"},
+        0  // Default: Poly
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"para_trigger", 1},
+        "Para Trigger",
+        juce::StringArray{"First Note", "Every Note"},
+        0  // Default: First Note
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"mpe", 1},
+        "MPE",
+        false
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"cpu_governor", 1},
+        "CPU Governor",
+        false
+    ));
+
+    // Position along the presets given to setMorphPresets()
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"morph", 1},
+        "Morph",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f),
+        0.0f
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -344,13 +390,16 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     // Prepare synth engine
     synthEngine.prepare(sampleRate, samplesPerBlock);
+    spectrumAnalyzer.prepare(sampleRate);
+    audition.prepare(sampleRate);  // Clips at the old rate are dropped
 
-    // Clear visualization buffer
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -362,12 +411,24 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = synthEngine.getActiveVoiceCount();
+    if (synthEngine.getCpuGovernor().isEnabled())
+        state.governorStep = synthEngine.getCpuGovernor().getStep();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     // CRITICAL: Suppress denormals for performance
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     // Clear output buffer
     buffer.clear();
 
@@ -375,66 +436,43 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read parameters (lock-free via atomics)
-    // Oscillator 1
-    int osc1Waveform = static_cast<int>(osc1WaveformParam->load());
-    int osc1Octave = static_cast<int>(osc1OctaveParam->load());
-    float osc1Level = osc1LevelParam->load();
-
-    // Oscillator 2
-    int osc2Waveform = static_cast<int>(osc2WaveformParam->load());
-    int osc2Octave = static_cast<int>(osc2OctaveParam->load());
-    float osc2Detune = osc2DetuneParam->load();
-    float osc2Level = osc2LevelParam->load();
-    bool osc2Sync = osc2SyncParam->load() > 0.5f;
-
-    // Oscillator 3
-    int osc3Waveform = static_cast<int>(osc3WaveformParam->load());
-    int osc3Octave = static_cast<int>(osc3OctaveParam->load());
-    float osc3Detune = osc3DetuneParam->load();
-    float osc3Level = osc3LevelParam->load();
-
-    // Noise
-    float noiseLevel = noiseLevelParam->load();
-
-    // Filter
-    float filterCutoff = filterCutoffParam->load();
-    float filterReso = filterResoParam->load();
-    float filterEnvAmount = filterEnvAmountParam->load();
-    float filterKbdTrack = filterKbdTrackParam->load();
-
-    // Amp Envelope
-    float ampAttack = ampAttackParam->load();
-    float ampDecay = ampDecayParam->load();
-    float ampSustain = ampSustainParam->load();
-    float ampRelease = ampReleaseParam->load();
-
-    // Filter Envelope
-    float filterAttack = filterAttackParam->load();
-    float filterDecay = filterDecayParam->load();
-    float filterSustain = filterSustainParam->load();
-    float filterRelease = filterReleaseParam->load();
-
-    // Master
-    float masterVolume = masterVolumeParam->load();
-
-    // LFO
-    float lfoRate = lfoRateParam->load();
-    int lfoWaveform = static_cast<int>(lfoWaveformParam->load());
-    float lfoPitchAmount = lfoPitchAmountParam->load();
-    float lfoFilterAmount = lfoFilterAmountParam->load();
+    // Read parameters (lock-free via atomics), then any preset staged since
+    // the last block: it was published before its parameters started moving
+    params.update();
+    if (const SynthParams* preset = presets.readFresh())
+        synthEngine.loadPreset(*preset);
+    if (const TuningTable* table = tunings.readFresh())
+        synthEngine.setTuning(*table);
+    if (const auto* fresh = morphs.readFresh())
+    {
+        // The engine gets every value again, morphed or (when it's off) not
+        morph = fresh->isActive() ? fresh : nullptr;
+        morphMoved = true;
+        morphed.markAllChanged();
+        params.markAllChanged();
+    }
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
     {
         auto message = metadata.getMessage();
         int samplePosition = metadata.samplePosition;
+        const int channel = message.getChannel() - 1;
 
         if (message.isNoteOn())
         {
             synthEngine.noteOn(message.getNoteNumber(),
                               message.getFloatVelocity(),
-                              samplePosition);
+                              samplePosition,
+                              channel);
         }
         else if (message.isNoteOff())
         {
@@ -442,67 +480,71 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition, channel);
+        }
+        else if (message.isChannelPressure())
+        {
+            synthEngine.setPressure(message.getChannelPressureValue() / 127.0f, samplePosition, channel);
+        }
+        else if (message.isControllerOfType(74))
+        {
+            // MPE slide: centred on 64
+            float slide = std::max(-1.0f, (message.getControllerValue() - 64) / 63.0f);
+            synthEngine.setSlide(slide, samplePosition, channel);
         }
     }
 
-    // Update synth engine parameters
-    // Oscillator 1
-    synthEngine.setOsc1Waveform(osc1Waveform);
-    synthEngine.setOsc1Octave(osc1Octave);
-    synthEngine.setOsc1Level(osc1Level);
-
-    // Oscillator 2
-    synthEngine.setOsc2Waveform(osc2Waveform);
-    synthEngine.setOsc2Octave(osc2Octave);
-    synthEngine.setOsc2Detune(osc2Detune);
-    synthEngine.setOsc2Level(osc2Level);
-    synthEngine.setOsc2Sync(osc2Sync);
-
-    // Oscillator 3
-    synthEngine.setOsc3Waveform(osc3Waveform);
-    synthEngine.setOsc3Octave(osc3Octave);
-    synthEngine.setOsc3Detune(osc3Detune);
-    synthEngine.setOsc3Level(osc3Level);
-
-    // Noise
-    synthEngine.setNoiseLevel(noiseLevel);
-
-    // Filter
-    synthEngine.setFilterCutoff(filterCutoff);
-    synthEngine.setFilterResonance(filterReso);
-    synthEngine.setFilterEnvAmount(filterEnvAmount);
-    synthEngine.setFilterKeyboardTracking(filterKbdTrack);
-
-    // Amp Envelope
-    synthEngine.setAmpEnvelope(ampAttack, ampDecay, ampSustain, ampRelease);
-
-    // Filter Envelope
-    synthEngine.setFilterEnvelope(filterAttack, filterDecay, filterSustain, filterRelease);
-
-    // LFO
-    synthEngine.setLFORate(lfoRate);
-    synthEngine.setLFOWaveform(lfoWaveform);
-    synthEngine.setLFOPitchAmount(lfoPitchAmount);
-    synthEngine.setLFOFilterAmount(lfoFilterAmount);
-
-    // Master
-    synthEngine.setMasterVolume(masterVolume);
-
-    // Render audio
-    synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
-
-    // Copy to visualization buffer (for UI oscilloscope)
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
+    // Update synth engine parameters (only the ones that changed). While a
+    // preset goes in, the parameters are half way to it: hold them back,
+    // then re-read every one once they've settled
+    if (synthEngine.isLoadingPreset() || stagingPreset.load(std::memory_order_acquire))
     {
-        visualizationBuffer[i] = leftChannel[i];
+        params.markAllChanged();
+        morphMoved = true;  // The morph goes back over the preset's values
+        morphed.markAllChanged();
     }
+    else if (morph != nullptr)
+        synthEngine.applySnapshot(morphSnapshot());
+    else
+        synthEngine.applySnapshot(params);
+
+#if AUTOSYNTH_CLAP
+    // CLAP events land on their samples, after the block's values
+    for (int i = 0; i < numClapEvents; ++i)
+    {
+        const MidiEvent& event = clapEvents[static_cast<size_t>(i)];
+        synthEngine.addEvent(event);
+
+        // The parameter follows for the editor and saved state; the next
+        // block's snapshot then matches what the engine already has
+        if (event.type == MidiEvent::Type::Param)
+        {
+            auto* param = rangedParams[static_cast<size_t>(event.id)];
+            param->setValue(param->convertTo0to1(event.value));
+        }
+    }
+    numClapEvents = 0;
+#endif
+
+    // Render audio, and any preset preview over it
+    synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
+    audition.mix(leftChannel, rightChannel, numSamples);
+
+    // Nothing audible and nothing ringing: mark the buffer cleared so hosts
+    // and wrappers that check hasBeenCleared() can skip it
+    if (synthEngine.isSilent() && !audition.isPlaying())
+        buffer.clear();
+
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+    if (spectrumAnalyzer.isRunning())
+        spectrumAnalyzer.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -518,20 +560,241 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 // State Save/Load
 //==============================================================================
 
+// The tuning's .scl text, a NUL, then its .kbm text; absent for 12-TET
+static constexpr uint32_t TUNING_CHUNK = PluginState::tag("TUNE");
+
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    juce::MemoryBlock tuning;
+    {
+        const juce::ScopedLock lock(tuningLock);
+        if (tuningScale.isNotEmpty())
+        {
+            tuning.append(tuningScale.toRawUTF8(), tuningScale.getNumBytesAsUTF8() + 1);
+            tuning.append(tuningMapping.toRawUTF8(), tuningMapping.getNumBytesAsUTF8());
+        }
+    }
+    if (tuning.getSize() > 0)
+        state.addChunk(TUNING_CHUNK, static_cast<const uint8_t*>(tuning.getData()), tuning.getSize());
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    std::array<float, kNumParams> normalised{};
+    if (!readState(data, size, normalised))
+    {
+        // Saved before the binary state: XML. A binary state from a newer
+        // build isn't XML either, so it leaves everything as it is
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
+    }
+
+    // The whole patch goes to the engine in one piece (SynthEngine::loadPreset),
+    // published before any parameter moves; the block that takes it holds the
+    // parameters back until they've all caught up
+    stagingPreset.store(true, std::memory_order_release);
+    SynthParams& staged = presets.write();
+    for (int i = 0; i < kNumParams; ++i)
+        staged.set(i, rangedParams[static_cast<size_t>(i)]->convertFrom0to1(normalised[static_cast<size_t>(i)]));
+    presets.publish();
+
+    for (int i = 0; i < kNumParams; ++i)
+        rangedParams[static_cast<size_t>(i)]->setValueNotifyingHost(normalised[static_cast<size_t>(i)]);
+    stagingPreset.store(false, std::memory_order_release);
+
+    // The tuning, or 12-TET for a state saved without one
+    juce::String scale, mapping;
+    PluginState::read(data, size, [](uint32_t, float) {},
+        [&scale, &mapping](uint32_t chunkTag, const uint8_t* chunk, size_t chunkSize) {
+            if (chunkTag != TUNING_CHUNK)
+                return;
+            const auto* text = reinterpret_cast<const char*>(chunk);
+            const auto* split = static_cast<const char*>(std::memchr(text, 0, chunkSize));
+            const size_t scaleBytes = split != nullptr ? static_cast<size_t>(split - text) : chunkSize;
+            scale = juce::String::fromUTF8(text, static_cast<int>(scaleBytes));
+            if (split != nullptr)
+                mapping = juce::String::fromUTF8(split + 1, static_cast<int>(chunkSize - scaleBytes - 1));
+        });
+    bool tuned = false;
+    {
+        const juce::ScopedLock lock(tuningLock);
+        tuned = tuningScale.isNotEmpty();
+    }
+    if (scale.isNotEmpty())
+        applyTuning(scale, mapping);
+    else if (tuned)
+        clearTuning();
+}
+
+bool PluginProcessor::readState(const void* data, size_t size, std::array<float, kNumParams>& normalised) const
+{
+    // Not a binary state, or one from a newer build
+    if (!PluginState::canRead(data, size))
+        return false;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    for (int i = 0; i < kNumParams; ++i)
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        const auto& ranged = *rangedParams[static_cast<size_t>(i)];
+        const float* value = saved.find(PluginState::idHash(ranged.paramID.toRawUTF8()));
+        normalised[static_cast<size_t>(i)] = value != nullptr ? ranged.convertTo0to1(*value) : ranged.getDefaultValue();
     }
+    return true;
+}
+
+//==============================================================================
+// Tuning
+//==============================================================================
+
+void PluginProcessor::loadTuning(const juce::File& scale, const juce::File& mapping)
+{
+    applyTuning(scale.loadFileAsString(), mapping == juce::File() ? juce::String() : mapping.loadFileAsString());
+}
+
+void PluginProcessor::clearTuning()
+{
+    {
+        const juce::ScopedLock lock(tuningLock);
+        tuningScale.clear();
+        tuningMapping.clear();
+        tuningError.clear();
+    }
+    tuningLoader.start([this] {
+        tunings.write() = TuningTable();
+        tunings.publish();
+    }, !isNonRealtime());
+}
+
+void PluginProcessor::applyTuning(juce::String scale, juce::String mapping)
+{
+    tuningLoader.start([this, scale, mapping] {
+        TuningTable table;
+        std::string error;
+        const bool ok = TuningTable::fromScala(scale.toStdString(), mapping.toStdString(), table, &error);
+
+        const juce::ScopedLock lock(tuningLock);
+        tuningError = ok ? juce::String() : juce::String(error);
+        if (!ok)
+            return;
+        tuningScale = scale;
+        tuningMapping = mapping;
+        tunings.write() = table;
+        tunings.publish();
+    }, !isNonRealtime());
+}
+
+juce::String PluginProcessor::getTuningName() const
+{
+    const juce::ScopedLock lock(tuningLock);
+    if (tuningScale.isEmpty())
+        return "12-TET";
+
+    // A .scl's first line that isn't a comment is its description
+    for (const auto& line : juce::StringArray::fromLines(tuningScale))
+    {
+        if (!line.startsWith("!"))
+            return line.trim().isNotEmpty() ? line.trim() : juce::String("Scala tuning");
+    }
+    return "Scala tuning";
+}
+
+juce::String PluginProcessor::getTuningError() const
+{
+    const juce::ScopedLock lock(tuningLock);
+    return tuningError;
+}
+
+//==============================================================================
+// Preset Morph
+//==============================================================================
+
+bool PluginProcessor::setMorphPresets(const std::vector<juce::MemoryBlock>& states)
+{
+    const int count = static_cast<int>(states.size());
+    if (count == 1 || count > PresetMorph<kNumParams>::MAX_PRESETS)
+        return false;
+
+    std::array<std::array<float, kNumParams>, PresetMorph<kNumParams>::MAX_PRESETS> presets{};
+    for (int p = 0; p < count; ++p)
+    {
+        auto& values = presets[static_cast<size_t>(p)];
+        if (!readState(states[static_cast<size_t>(p)].getData(), states[static_cast<size_t>(p)].getSize(), values))
+            return false;
+        values[kMorph] = 0.0f;  // The knob doesn't morph itself
+    }
+
+    morphs.write().compile(presets.data(), count);  // Fewer than two: off
+    morphs.publish();
+    return true;
+}
+
+const SynthParams& PluginProcessor::morphSnapshot()
+{
+    morphed.update();  // Nothing is bound: this only clears the marks
+
+    // What the presets agree on follows the parameters (and their automation)
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        if (!morph->isMorphed(i))
+            morphed.set(i, params[i]);
+    }
+
+    // The rest only moves with the knob
+    if (morphMoved || params.changed(kMorph))
+    {
+        morphMoved = false;
+        const int n = morph->evaluate(params[kMorph], morphValues.data());
+        for (int m = 0; m < n; ++m)
+        {
+            const int id = morph->paramAt(m);
+            const auto& range = rangedParams[static_cast<size_t>(id)]->getNormalisableRange();
+            morphed.set(id, range.snapToLegalValue(range.convertFrom0to1(morphValues[static_cast<size_t>(m)])));
+        }
+    }
+    return morphed;
+}
+
+//==============================================================================
+// Preset Audition
+//==============================================================================
+
+bool PluginProcessor::auditionPreset(const juce::MemoryBlock& state)
+{
+    std::array<float, kNumParams> normalised{};
+    if (!readState(state.getData(), state.getSize(), normalised))
+        return false;
+
+    auditionPreset(normalised);
+    return true;
+}
+
+void PluginProcessor::auditionPreset(const std::array<float, kNumParams>& normalised)
+{
+    SynthParams preset;
+    for (int i = 0; i < kNumParams; ++i)
+        preset.set(i, rangedParams[static_cast<size_t>(i)]->convertFrom0to1(normalised[static_cast<size_t>(i)]));
+    audition.audition(preset);
 }
 
 //==============================================================================
@@ -542,3 +805,188 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new PluginProcessor();
 }
+
+#if AUTOSYNTH_CLAP
+//==============================================================================
+// CLAP events
+//==============================================================================
+
+bool PluginProcessor::supportsDirectEvent(uint16_t spaceId, uint16_t type)
+{
+    if (spaceId != CLAP_CORE_EVENT_SPACE_ID)
+        return false;
+
+    switch (type)
+    {
+        case CLAP_EVENT_NOTE_ON:
+        case CLAP_EVENT_NOTE_OFF:
+        case CLAP_EVENT_NOTE_CHOKE:
+        case CLAP_EVENT_NOTE_EXPRESSION:
+        case CLAP_EVENT_PARAM_VALUE:
+        case CLAP_EVENT_PARAM_MOD:
+            return true;
+        default:
+            return false;  // MIDI takes the MidiBuffer path
+    }
+}
+
+void PluginProcessor::handleDirectEvent(const clap_event_header_t* event, int sampleOffset)
+{
+    if (numClapEvents >= MidiEventQueue::CAPACITY)
+        return;
+
+    MidiEvent e;
+    e.sampleOffset = sampleOffset;
+
+    switch (event->type)
+    {
+        case CLAP_EVENT_NOTE_ON:
+        case CLAP_EVENT_NOTE_OFF:
+        case CLAP_EVENT_NOTE_CHOKE:
+        {
+            const auto* note = reinterpret_cast<const clap_event_note_t*>(event);
+            e.note = keyForNote(note->note_id, note->key);
+            if (e.note == -1 && event->type != CLAP_EVENT_NOTE_ON)
+            {
+                e.type = MidiEvent::Type::AllNotesOff;  // Wildcard key and note_id
+                break;
+            }
+            if (e.note < 0)
+                return;
+
+            if (event->type == CLAP_EVENT_NOTE_ON)
+            {
+                noteIdByKey[static_cast<size_t>(e.note)] = note->note_id;
+                e.type = MidiEvent::Type::NoteOn;
+                e.value = static_cast<float>(note->velocity);
+                e.channel = std::max<int>(note->channel, 0);
+                e.id = note->note_id;
+            }
+            else
+            {
+                e.type = MidiEvent::Type::NoteOff;
+            }
+            break;
+        }
+
+        case CLAP_EVENT_NOTE_EXPRESSION:
+        {
+            const auto* expression = reinterpret_cast<const clap_event_note_expression_t*>(event);
+            e.type = MidiEvent::Type::NoteExpression;
+            e.note = keyForNote(expression->note_id, expression->key);
+            e.value = static_cast<float>(expression->value);
+            if (e.note < -1)
+                return;
+
+            switch (expression->expression_id)
+            {
+                case CLAP_NOTE_EXPRESSION_TUNING:
+                    e.id = static_cast<int>(SynthEngine::NoteExpression::Tuning);
+                    break;
+                case CLAP_NOTE_EXPRESSION_PRESSURE:
+                    e.id = static_cast<int>(SynthEngine::NoteExpression::Pressure);
+                    break;
+                case CLAP_NOTE_EXPRESSION_BRIGHTNESS:
+                    // 0-1 from the host, centred slide for the engine
+                    e.id = static_cast<int>(SynthEngine::NoteExpression::Slide);
+                    e.value = e.value * 2.0f - 1.0f;
+                    break;
+                default:
+                    return;  // Volume, pan, vibrato, expression: no per-voice target
+            }
+            break;
+        }
+
+        case CLAP_EVENT_PARAM_VALUE:
+        {
+            const auto* value = reinterpret_cast<const clap_event_param_value_t*>(event);
+            const int index = paramIndexForClapId(value->param_id);
+            if (index < 0)
+                return;
+
+            // The wrapper's values are normalised; the engine takes plain ones
+            e.type = MidiEvent::Type::Param;
+            e.id = index;
+            e.value = rangedParams[static_cast<size_t>(index)]->convertFrom0to1(
+                juce::jlimit(0.0f, 1.0f, static_cast<float>(value->value)));
+            break;
+        }
+
+        case CLAP_EVENT_PARAM_MOD:
+        {
+            const auto* mod = reinterpret_cast<const clap_event_param_mod_t*>(event);
+            const int index = paramIndexForClapId(mod->param_id);
+            if (index < 0 || !SynthEngine::isPolyModulatable(index))
+                return;
+
+            e.type = MidiEvent::Type::NoteModulation;
+            e.id = index;
+            e.note = keyForNote(mod->note_id, mod->key);
+            if (e.note < -1)
+                return;
+
+            // A normalised amount, as an offset in the parameter's own units
+            // from its current value (cutoff is skewed, so Hz depend on where it is)
+            const auto* param = rangedParams[static_cast<size_t>(index)];
+            const float base = params[index];
+            const float target = juce::jlimit(0.0f, 1.0f, param->convertTo0to1(base) + static_cast<float>(mod->amount));
+            e.value = param->convertFrom0to1(target) - base;
+            break;
+        }
+
+        default:
+            return;
+    }
+
+    clapEvents[static_cast<size_t>(numClapEvents++)] = e;
+}
+
+void PluginProcessor::addOutboundEventsToQueue(const clap_output_events* out, const juce::MidiBuffer&,
+                                               int sampleOffset)
+{
+    for (int i = 0; i < synthEngine.getNumEndedNotes(); ++i)
+    {
+        const auto& ended = synthEngine.getEndedNote(i);
+
+        clap_event_note_t e{};
+        e.header.size = sizeof(e);
+        e.header.time = static_cast<uint32_t>(sampleOffset + ended.sampleOffset);
+        e.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+        e.header.type = CLAP_EVENT_NOTE_END;
+        e.note_id = ended.noteId;
+        e.port_index = 0;
+        e.channel = static_cast<int16_t>(ended.channel);
+        e.key = static_cast<int16_t>(ended.note);
+        out->try_push(out, &e.header);
+    }
+    synthEngine.clearEndedNotes();
+}
+
+bool PluginProcessor::voiceInfoGet(clap_voice_info* info)
+{
+    info->voice_count = SynthEngine::MAX_VOICES;
+    info->voice_capacity = SynthEngine::MAX_VOICES;
+    info->flags = CLAP_VOICE_INFO_SUPPORTS_OVERLAPPING_NOTES;
+    return true;
+}
+
+int PluginProcessor::paramIndexForClapId(clap_id id) const
+{
+    for (int i = 0; i < kNumParams; ++i)
+        if (clapParamIds[static_cast<size_t>(i)] == id)
+            return i;
+    return -1;
+}
+
+int PluginProcessor::keyForNote(int32_t noteId, int16_t key) const
+{
+    if (key >= 0 && key <= 127)
+        return key;
+    if (noteId < 0)
+        return -1;
+    for (int k = 0; k < 128; ++k)
+        if (noteIdByKey[static_cast<size_t>(k)] == noteId)
+            return k;
+    return -2;
+}
+#endif
@@ -15,6 +15,18 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "AsyncPrepare.h"
+#include "OverrunLog.h"
+#include "PresetAudition.h"
+#include "PresetMorph.h"
+#include "ScopeFifo.h"
+#include "SpectrumAnalyzer.h"
+#include "StatePublisher.h"
+#include "UiNoteFifo.h"
+
+#if AUTOSYNTH_CLAP
+#include <clap-juce-extensions/clap-juce-extensions.h>
+#endif
 
 /**
  * @brief Main audio processor class
@@ -24,6 +36,9 @@
  * automation and state persistence.
  */
 class PluginProcessor : public juce::AudioProcessor
+#if AUTOSYNTH_CLAP
+                      , public clap_juce_extensions::clap_juce_audio_processor_capabilities
+#endif
 {
 public:
     PluginProcessor();
@@ -63,13 +78,96 @@ public:
     /** Audio parameter value tree state - use for UI binding */
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+
+    /** Output spectrum for the editor, analysed on its own thread while started */
+    SpectrumAnalyzer& getSpectrumAnalyzer() { return spectrumAnalyzer; }
+
+    /** On-screen keyboard notes for processBlock() (pushed on the message thread) */
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
+
+    /** The engine's load governor, reported alongside the counters (see core/dsp/CpuGovernor.h) */
+    const CpuGovernor& getCpuGovernor() const { return synthEngine.getCpuGovernor(); }
+
+    /**
+     * @brief Morph through saved states (getStateInformation()) on the morph knob
+     *
+     * Message thread. Two to PresetMorph::MAX_PRESETS states, first at 0 and
+     * last at 1; an empty list turns the morph off. Returns false, leaving
+     * the morph as it was, if the count is out of range or a state isn't one.
+     */
+    bool setMorphPresets(const std::vector<juce::MemoryBlock>& states);
+
+    /**
+     * @brief Preview a saved state (getStateInformation()) without loading it
+     *
+     * Message thread. A held C3 is rendered from the state on a background
+     * thread, or found among the ones already rendered, and played over the
+     * output (see core/dsp/PresetAudition.h). The parameters don't move.
+     * Returns false if the state isn't one.
+     */
+    bool auditionPreset(const juce::MemoryBlock& state);
+
+    /** Preview a preset given as every parameter's normalised value, by ParamId */
+    void auditionPreset(const std::array<float, kNumParams>& normalised);
+
+    /** Cut off the preview playing */
+    void stopAudition() { audition.stop(); }
+
+    /**
+     * @brief Retune from a Scala scale and (optionally) keyboard mapping, saved with the state
+     *
+     * The files are read and the table built on a background thread, then
+     * handed to the engine for its next note on (see core/dsp/TuningTable.h).
+     * A file that doesn't parse leaves the tuning as it was.
+     */
+    void loadTuning(const juce::File& scale, const juce::File& mapping = {});
+
+    /** Back to 12-TET */
+    void clearTuning();
+
+    /** The scale's description (or "12-TET"), and why the last load failed if it did */
+    juce::String getTuningName() const;
+    juce::String getTuningError() const;
+
+#if AUTOSYNTH_CLAP
+    //==========================================================================
+    // CLAP (clap-juce-extensions): notes, parameter values, note expressions
+    // and polyphonic modulation reach the engine on their sample
+    //==========================================================================
+    bool supportsDirectEvent(uint16_t spaceId, uint16_t type) override;
+    void handleDirectEvent(const clap_event_header_t* event, int sampleOffset) override;
+
+    bool supportsNoteDialectClap(bool isInput) override { return isInput; }
+    bool prefersNoteDialectClap(bool isInput) override { return isInput; }
+
+    bool supportsVoiceInfo() override { return true; }
+    bool voiceInfoGet(clap_voice_info* info) override;
+
+    // NOTE_END for every note that stops sounding, so the host ends its
+    // per-note modulation and expressions with it
+    bool supportsOutboundEvents() override { return true; }
+    void addOutboundEventsToQueue(const clap_output_events* out, const juce::MidiBuffer& midi,
+                                  int sampleOffset) override;
+#endif
 
 private:
     /** Create the parameter layout - called once in constructor */
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    /** Normalised value of each ParamId in a binary state, defaults where it has none */
+    bool readState(const void* data, size_t size, std::array<float, kNumParams>& normalised) const;
+
+    /** This block's parameters with the morphed ones replaced (audio thread) */
+    const SynthParams& morphSnapshot();
+
     //==========================================================================
     // DSP Engine
     //==========================================================================
@@ -78,56 +176,47 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters (for lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // Oscillator 1
-    std::atomic<float>* osc1WaveformParam = nullptr;
-    std::atomic<float>* osc1OctaveParam = nullptr;
-    std::atomic<float>* osc1LevelParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
+
+    /** Whole presets from setStateInformation(), staged for SynthEngine::loadPreset() */
+    StatePublisher<SynthParams> presets;
+
+    /** Set while setStateInformation() moves the parameters to a staged preset */
+    std::atomic<bool> stagingPreset{false};
 
-    // Oscillator 2
-    std::atomic<float>* osc2WaveformParam = nullptr;
-    std::atomic<float>* osc2OctaveParam = nullptr;
-    std::atomic<float>* osc2DetuneParam = nullptr;
-    std::atomic<float>* osc2LevelParam = nullptr;
-    std::atomic<float>* osc2SyncParam = nullptr;
+    /** Compiled by setMorphPresets(), taken by processBlock() */
+    StatePublisher<PresetMorph<kNumParams>> morphs;
 
-    // Oscillator 3
-    std::atomic<float>* osc3WaveformParam = nullptr;
-    std::atomic<float>* osc3OctaveParam = nullptr;
-    std::atomic<float>* osc3DetuneParam = nullptr;
-    std::atomic<float>* osc3LevelParam = nullptr;
+    /** Preset previews, rendered by an engine of their own and mixed in after synthEngine */
+    PresetAudition<SynthEngine, SynthParams> audition;
 
-    // Noise
-    std::atomic<float>* noiseLevelParam = nullptr;
+    // Audio thread: the morph in use (nullptr: off), and the snapshot it feeds the engine
+    const PresetMorph<kNumParams>* morph = nullptr;
+    bool morphMoved = false;
+    SynthParams morphed;
+    std::array<float, kNumParams> morphValues{};
 
-    // Filter
-    std::atomic<float>* filterCutoffParam = nullptr;
-    std::atomic<float>* filterResoParam = nullptr;
-    std::atomic<float>* filterEnvAmountParam = nullptr;
-    std::atomic<float>* filterKbdTrackParam = nullptr;
+    /** Parse .scl/.kbm text off the message thread and publish the table for processBlock() */
+    void applyTuning(juce::String scale, juce::String mapping);
 
-    // Amp Envelope
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
+    /** Built by tuningLoader, taken by processBlock() */
+    StatePublisher<TuningTable> tunings;
 
-    // Filter Envelope
-    std::atomic<float>* filterAttackParam = nullptr;
-    std::atomic<float>* filterDecayParam = nullptr;
-    std::atomic<float>* filterSustainParam = nullptr;
-    std::atomic<float>* filterReleaseParam = nullptr;
+    /** The tuning's text, for the state (both empty: 12-TET), and the last error */
+    juce::String tuningScale;
+    juce::String tuningMapping;
+    juce::String tuningError;
+    juce::CriticalSection tuningLock;
 
-    // Master
-    std::atomic<float>* masterVolumeParam = nullptr;
+    /** Builds tuning tables off the message thread (see AsyncPrepare.h); after what its jobs use */
+    AsyncPrepare tuningLoader;
 
-    // LFO
-    std::atomic<float>* lfoRateParam = nullptr;
-    std::atomic<float>* lfoWaveformParam = nullptr;
-    std::atomic<float>* lfoPitchAmountParam = nullptr;
-    std::atomic<float>* lfoFilterAmountParam = nullptr;
+    /** For converting to and from normalised values */
+    std::array<juce::RangedAudioParameter*, kNumParams> rangedParams{};
 
     //==========================================================================
     // State
@@ -136,8 +225,41 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    /** Buffer for UI visualization */
-    std::array<float, 512> visualizationBuffer{};
+    /** Audio thread -> UI oscilloscope samples */
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+
+    /** Audio thread -> analysis thread -> UI spectrum */
+    SpectrumAnalyzer spectrumAnalyzer;
+
+    /** UI keyboard -> audio thread notes */
+    UiNoteFifo uiNotes;
+
+#if AUTOSYNTH_CLAP
+    //==========================================================================
+    // CLAP events
+    //==========================================================================
+
+    /** ParamId for a CLAP param_id (the wrapper's ids hash the JUCE IDs), or -1 */
+    int paramIndexForClapId(clap_id id) const;
+
+    /** Key an event addresses: its key, else its note_id's; -1 = every note, -2 = ended */
+    int keyForNote(int32_t noteId, int16_t key) const;
+
+    /** This block's events, handed to the engine after its snapshot */
+    std::array<MidiEvent, MidiEventQueue::CAPACITY> clapEvents{};
+    int numClapEvents = 0;
+
+    std::array<uint32_t, kNumParams> clapParamIds{};
+
+    /** Latest note_id per key */
+    std::array<int32_t, 128> noteIdByKey{};
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -12,6 +12,68 @@
  * Signal Flow:
  *   MIDI -> Voice Manager -> [Voice Pool] -> [Mix] -> [Effects] -> Output
  *
+ * Voices are handed out by a VoiceAllocator (free list, release order,
+ * note map), so note on and off don't scan the pool; the steal policy is
+ * the voice_steal parameter. Active voices are rendered in 4-lane SIMD
+ * groups (see VoiceGroup.h).
+ * Pitch bend, channel pressure and slide (CC74) are kept per MIDI channel
+ * in small arrays beside the pool and handed to each active voice once per
+ * sub-block, so they ride the voices' control-rate modulation; with MPE on,
+ * every note follows its own channel.
+ * Hosts with sorted in-block events (CLAP) can also change a parameter on
+ * its sample (setParameter), give one note its own tuning, pressure or
+ * slide (setNoteExpression), and modulate one note's cutoff and resonance
+ * without touching the parameter (setNoteModulation). Every note that
+ * stops sounding (its release ended, it was culled, stolen or cut off) is
+ * listed with the host's note ID for getEndedNote(), so the host can end
+ * its per-note modulation (CLAP NOTE_END).
+ * Voices held at a silent sustain sleep until released or retriggered,
+ * and isSilent() reports a block with no voice rendered. A releasing voice
+ * whose level at the output (envelope x velocity x master) has fallen
+ * under the cull threshold (-90 dB unless setCullThreshold() says) is
+ * freed at the next block rather than when its envelope idles: a release
+ * only falls, so all it had left was inaudible.
+ *
+ * The LFO is global by default (lfo_mode): the engine runs one LFO, a value
+ * per control block of each sub-block into a small buffer, and every voice
+ * reads it. Per Voice gives each voice its own LFO, which runs only while
+ * the voice sounds, so voices started at different times drift apart.
+ *
+ * Paraphonic (voice_mode) keeps the per-note oscillators but shares one
+ * filter and envelope pair: every note's oscillators, times its velocity,
+ * are summed into one mono bus, and a bus voice runs the noise, ladder,
+ * filter envelope and VCA over it once. The cost is the oscillators times
+ * the notes plus one filter. para_trigger picks when the shared envelopes
+ * start: on the first note of a phrase (later ones play legato into them)
+ * or on every note. A note released while others are held fades out over
+ * Voice::GATE_SECONDS; the last one released rings on through the shared
+ * release, and a new note fades those out. The filter tracks the newest
+ * note's key and takes its channel's pressure and slide.
+ *
+ * analog_drift wanders each voice's pitch on its own slow random path
+ * (AnalogDrift.h). It is stepped once per control block with the LFO and
+ * rides the same pitch ramp, so the 4-lane groups apply it to their phase
+ * increments with the LFO's pitch modulation, at no per-sample cost.
+ *
+ * Noise works the same way whatever the mode: when the noise level is up,
+ * the engine fills one NoiseBlock (Noise.h) per sub-block, four
+ * independent lanes per lane group, and each voice reads its own lane.
+ * One vectorized fill replaces a generator stepped per voice per sample.
+ *
+ * Groups render on the audio thread alone unless setRenderThreads() opts
+ * in to the process's shared VoiceThreadPool, whose workers every instance
+ * takes turns with; blocks too small to pay for waking the workers, or
+ * arriving while another instance holds them, still render serially.
+ *
+ * loadPreset() switches every parameter at once, staged on the message
+ * thread: with voices sounding the output dips for 5 ms either side of
+ * the switch (PresetFade.h) instead of jumping, and the voices re-derive
+ * their coefficients once.
+ *
+ * With cpu_governor on, a CpuGovernor times each block against its
+ * deadline and sheds load in steps: first the cull threshold rises to
+ * -60 dB, then the voice limit falls to 8, then to 4 (one lane group). It steps back once the load has stayed low.
+ *
  * @note This class is called from the audio thread - no allocations allowed
  */
 
@@ -20,6 +82,20 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
+#include "ActiveVoiceList.h"
+#include "CpuGovernor.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "Noise.h"
+#include "PerfStats.h"
+#include "PresetFade.h"
+#include "ReleaseCull.h"
+#include "SynthParams.h"
+#include "VoiceAllocator.h"
+#include "VoiceGroup.h"
+#include "VoiceThreadPool.h"
+#include "Denormals.h"
+#include "ReferenceDsp.h"
 
 // SST Effects (uncomment when needed)
 // #include "sst/effects/Reverb.h"
@@ -44,7 +120,13 @@ public:
     /** Block size for internal processing */
     static constexpr int BLOCK_SIZE = 64;
 
-    SynthEngine() = default;
+    SynthEngine()
+    {
+        // setParameter()'s copy only reports what it is handed
+        eventParams.update();
+        seedDrift(DRIFT_SEED);
+    }
+
     ~SynthEngine() = default;
 
     //==========================================================================
@@ -60,21 +142,53 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
+        governor.prepare(sampleRate);
+        applyGovernorStep(0);
+        releaseCull.setMasterGain(masterGain);
+        presetFade.prepare(sampleRate);
+        pendingPreset = nullptr;
 
         // Prepare all voices
         for (auto& voice : voices)
         {
             voice.prepare(sampleRate);
         }
+        busVoice.prepare(sampleRate);
+
+        sharedLfo.prepare(sampleRate);
+        sharedLfo.setRate(std::clamp(params.lfoRate, 0.01f, 50.0f));
+        sharedLfo.setWaveform(static_cast<LFO::Waveform>(params.lfoWaveform));
+        sharedLfo.reset();
+        sharedLfoValue = 0.0f;
 
         // TODO: Prepare effects
         // Example:
         // reverb.prepare(sampleRate, maxBlockSize);
         // delay.prepare(sampleRate, maxBlockSize);
+    }
+
+    /**
+     * @brief Split voice rendering across up to numThreads cores
+     * @param numThreads Threads including the audio thread (1 = serial, the default)
+     * @note May start or join the shared pool's threads - call from prepare time, not the audio thread
+     */
+    void setRenderThreads(int numThreads)
+    {
+        renderThreads = numThreads;
+        if (numThreads > 1)
+            voicePool = VoiceThreadPool::shared();
+        else
+            voicePool.reset();
+    }
 
-        // Clear buffers
-        std::fill(mixBufferL.begin(), mixBufferL.end(), 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.end(), 0.0f);
+    int getRenderThreads() const { return voicePool ? std::min(renderThreads, voicePool->getNumThreads()) : 1; }
+
+    /** Reseed the voices' noise and drift: the same seed renders the same noise */
+    void setNoiseSeed(uint32_t seed)
+    {
+        sharedNoise.reseed(seed);
+        seedDrift(seed ^ DRIFT_SEED);
     }
 
     /**
@@ -89,15 +203,34 @@ public:
     // MIDI Handling
     //==========================================================================
 
+    /**
+     * @brief Retune: note frequencies from @p table from the next note on
+     *
+     * Copies the table (128 floats: fine on the audio thread). A 12-TET
+     * table puts the voices back on PitchTables.
+     */
+    void setTuning(const TuningTable& table)
+    {
+        tuning = table;
+        for (auto& voice : voices)
+            voice.setTuning(tuning.isEqualTemperament() ? nullptr : &tuning);
+        busVoice.setTuning(tuning.isEqualTemperament() ? nullptr : &tuning);
+    }
+
+    const TuningTable& getTuning() const { return tuning; }
+
     /**
      * @brief Handle MIDI note on
      * @param note MIDI note number (0-127)
      * @param velocity Note velocity (0.0-1.0)
      * @param sampleOffset Sample offset within current block
+     * @param channel MIDI channel (0-15) whose expression the note follows in MPE mode
+     * @param noteId The host's ID for the note, handed back when it ends (-1: none)
      */
-    void noteOn(int note, float velocity, int sampleOffset = 0)
+    void noteOn(int note, float velocity, int sampleOffset = 0, int channel = 0, int noteId = -1)
     {
-        (void)sampleOffset; // TODO: Implement sample-accurate timing
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity, channel, noteId}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -105,11 +238,33 @@ public:
             return;
         }
 
-        Voice* voice = findFreeVoice(note);
-        if (voice)
+        // Keys the tuning leaves unmapped are silent: over as soon as they start
+        if (!tuning.isMapped(note))
         {
-            voice->noteOn(note, velocity);
+            endNote({renderPosition, note, channel, noteId});
+            return;
         }
+
+        const auto slot = allocator.noteOn(note, [this](int v) { return voices[v].getLevel(); });
+        Voice& voice = voices[slot.voice];
+        if (slot.stolen)
+        {
+            voiceEnded(slot.voice, renderPosition);
+            voice.kill();
+        }
+        hostNote[slot.voice] = {0, note, channel, noteId};
+
+        // Idle voices skip applyParams in renderBlock, so catch up first
+        voice.applyParams(params, paramRevision);
+        voiceChannel[slot.voice] = expressionChannel(channel);
+        noteState[slot.voice] = {};
+        applyExpression(slot.voice);
+        voice.setSharedLFO(lfoMode == LFOMode::Global ? sharedLfoBlock.data() : nullptr, sharedLfoValue);
+        voice.noteOn(note, velocity);
+        active.add(slot.voice);  // A stolen voice is listed already
+
+        if (voiceMode == VoiceMode::Paraphonic)
+            busNoteOn(slot.voice);
     }
 
     /**
@@ -119,37 +274,170 @@ public:
      */
     void noteOff(int note, int sampleOffset = 0)
     {
-        (void)sampleOffset;
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
-        for (auto& voice : voices)
-        {
-            if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
-            {
-                voice.noteOff();
-                // Don't break - release all voices playing this note
-            }
-        }
+        // Every voice holding this note, not just the newest
+        allocator.noteOff(note, [this](int v) { voices[v].noteOff(); });
+
+        if (voiceMode == VoiceMode::Paraphonic)
+            busNoteOff();
     }
 
     /**
      * @brief Stop all notes immediately
+     * @param sampleOffset Sample offset within current block
      */
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voiceEnded(v, renderPosition);
+            voices[v].kill();
         }
+        allocator.reset();
+        active.clear();
+        busVoice.kill();
     }
 
     /**
      * @brief Set pitch bend amount
      * @param bend Pitch bend value (-1.0 to 1.0)
+     * @param sampleOffset Sample offset within current block
+     * @param channel MIDI channel (0-15); one bend for every note unless MPE is on
+     */
+    void setPitchBend(float bend, int sampleOffset = 0, int channel = 0)
+    {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend, channel}))
+            return;
+
+        expression.bend[expressionChannel(channel)] = bend;
+    }
+
+    /**
+     * @brief Set channel pressure (aftertouch)
+     * @param pressure 0.0-1.0
+     * @param sampleOffset Sample offset within current block
+     * @param channel MIDI channel (0-15)
      */
-    void setPitchBend(float bend)
+    void setPressure(float pressure, int sampleOffset = 0, int channel = 0)
     {
-        pitchBend = bend;
-        // TODO: Apply pitch bend to all active voices
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::Pressure, sampleOffset, 0, pressure, channel}))
+            return;
+
+        expression.pressure[expressionChannel(channel)] = pressure;
+    }
+
+    /**
+     * @brief Set slide (MPE timbre, CC74)
+     * @param slide -1.0 to 1.0, centred on CC value 64
+     * @param sampleOffset Sample offset within current block
+     * @param channel MIDI channel (0-15)
+     */
+    void setSlide(float slide, int sampleOffset = 0, int channel = 0)
+    {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::Slide, sampleOffset, 0, slide, channel}))
+            return;
+
+        expression.slide[expressionChannel(channel)] = slide;
+    }
+
+    /** Per-note expressions, on top of the note's channel expression */
+    enum class NoteExpression { Tuning, Pressure, Slide };
+
+    /**
+     * @brief Set one note's own expression (CLAP note expressions)
+     * @param note MIDI note number, or -1 for every sounding note
+     * @param which Tuning in semitones, pressure 0-1 or slide -1 to 1
+     * @param sampleOffset Sample offset within current block
+     *
+     * Added to the channel's bend, pressure and slide, and cleared when the
+     * voice starts its next note.
+     */
+    void setNoteExpression(int note, NoteExpression which, float value, int sampleOffset = 0)
+    {
+        if (sampleOffset > 0
+            && eventQueue.push({MidiEvent::Type::NoteExpression, sampleOffset, note, value, 0, static_cast<int>(which)}))
+            return;
+
+        forEachVoiceOnNote(note, [&](int v)
+        {
+            NoteState& n = noteState[v];
+            switch (which)
+            {
+            case NoteExpression::Tuning: n.tuning = value; break;
+            case NoteExpression::Pressure: n.pressure = value; break;
+            case NoteExpression::Slide: n.slide = value; break;
+            }
+        });
+    }
+
+    /** Parameters setNoteModulation() can offset per voice */
+    static constexpr bool isPolyModulatable(int paramId) { return paramId == kFilterCutoff || paramId == kFilterReso; }
+
+    /**
+     * @brief Polyphonic modulation: offset one note's cutoff or resonance
+     * @param note MIDI note number, or -1 for every voice, now and later
+     *             (monophonic modulation)
+     * @param paramId kFilterCutoff (Hz) or kFilterReso; others are ignored
+     * @param amount Offset in the parameter's own units, replacing the last one
+     * @param sampleOffset Sample offset within current block
+     *
+     * The parameter itself doesn't move, so automation and modulation
+     * combine. A note's offset is cleared when its voice starts a new note.
+     */
+    void setNoteModulation(int note, int paramId, float amount, int sampleOffset = 0)
+    {
+        if (!isPolyModulatable(paramId))
+            return;
+
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteModulation, sampleOffset, note, amount, 0, paramId}))
+            return;
+
+        if (note < 0)
+        {
+            (paramId == kFilterCutoff ? allNotes.cutoff : allNotes.resonance) = amount;
+            return;
+        }
+
+        forEachVoiceOnNote(note, [&](int v)
+        {
+            (paramId == kFilterCutoff ? noteState[v].cutoff : noteState[v].resonance) = amount;
+        });
+    }
+
+    /**
+     * @brief Change one parameter on its sample (CLAP parameter events)
+     * @param paramId ParamId (dsp/SynthParams.h)
+     * @param value In the parameter's own units, as the APVTS holds it
+     * @param sampleOffset Sample offset within current block
+     *
+     * Runs the same setters as applySnapshot(), against a copy of the last
+     * snapshot, so an envelope stage change keeps the other three stages.
+     */
+    void setParameter(int paramId, float value, int sampleOffset = 0)
+    {
+        if (paramId < 0 || paramId >= kNumParams)
+            return;
+
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::Param, sampleOffset, 0, value, 0, paramId}))
+            return;
+
+        eventParams.update();  // Nothing is bound: this only clears the marks
+        eventParams.set(paramId, value);
+        applySnapshot(eventParams);
+    }
+
+    /** Schedule any event at its sample offset (0: now), for hosts that hand over MidiEvents */
+    void addEvent(const MidiEvent& event)
+    {
+        if (event.sampleOffset > 0 && eventQueue.push(event))
+            return;
+
+        handleEvent(event);
     }
 
     //==========================================================================
@@ -164,76 +452,40 @@ public:
      */
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        // Clear mix buffers
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        // Render all active voices
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
-            {
-                // Update voice parameters before rendering
-
-                // Oscillator 1
-                voice.setOsc1Waveform(static_cast<Oscillator::Waveform>(osc1Waveform));
-                voice.setOsc1Octave(osc1Octave);
-                voice.setOsc1Level(osc1Level);
-
-                // Oscillator 2
-                voice.setOsc2Waveform(static_cast<Oscillator::Waveform>(osc2Waveform));
-                voice.setOsc2Octave(osc2Octave);
-                voice.setOsc2Detune(osc2Detune);
-                voice.setOsc2Level(osc2Level);
-                voice.setOsc2Sync(osc2Sync);
-
-                // Oscillator 3
-                voice.setOsc3Waveform(static_cast<Oscillator::Waveform>(osc3Waveform));
-                voice.setOsc3Octave(osc3Octave);
-                voice.setOsc3Detune(osc3Detune);
-                voice.setOsc3Level(osc3Level);
-
-                // Noise
-                voice.setNoiseLevel(noiseLevel);
-
-                // Filter
-                voice.setFilterCutoff(filterCutoff);
-                voice.setFilterResonance(filterResonance);
-                voice.setFilterEnvAmount(filterEnvAmount);
-                voice.setFilterKeyboardTracking(filterKeyboardTracking);
-
-                // Amp Envelope
-                voice.setAmpAttack(ampAttack);
-                voice.setAmpDecay(ampDecay);
-                voice.setAmpSustain(ampSustain);
-                voice.setAmpRelease(ampRelease);
-
-                // Filter Envelope
-                voice.setFilterAttack(filterAttack);
-                voice.setFilterDecay(filterDecay);
-                voice.setFilterSustain(filterSustain);
-                voice.setFilterRelease(filterRelease);
-
-                // LFO
-                voice.setLFORate(lfoRate);
-                voice.setLFOWaveform(static_cast<LFO::Waveform>(lfoWaveform));
-                voice.setLFOPitchAmount(lfoPitchAmount);
-                voice.setLFOFilterAmount(lfoFilterAmount);
-
-                // Master level per voice
-                voice.setMasterLevel(1.0f);
-
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+        perfStats.beginBlock();
+        governor.beginBlock();
+        silentBlock = true;
+        renderPosition = 0;
 
-        // Apply master volume
-        float gain = masterGain;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            outputL[i] = mixBufferL[i] * gain;
-            outputR[i] = mixBufferR[i] * gain;
-        }
+        cullQuietReleases();
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
+            {
+                // No longer than the shared LFO's buffer covers, and split
+                // where a preset fade turns
+                for (int done = 0; done < count;)
+                {
+                    const int n = std::min({MAX_SPAN, count - done, presetFade.samplesToTurn()});
+                    float* l = outputL + start + done;
+                    float* r = outputR + start + done;
+                    renderVoices(l, r, n);
+                    if (presetFade.apply(l, r, n))
+                        applyPendingPreset();
+                    done += n;
+                    renderPosition += n;
+                }
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
+        renderPosition = 0;  // Notes ending before the next block end on its first sample
+
+        applyGovernorStep(governor.endBlock(numSamples));
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
     //==========================================================================
@@ -243,135 +495,596 @@ public:
     // Master
     void setMasterVolume(float volumeDb)
     {
+        if (volumeDb == masterVolumeDb)
+            return;
+
         // Convert dB to linear gain
+        masterVolumeDb = volumeDb;
         masterGain = std::pow(10.0f, volumeDb / 20.0f);
+        releaseCull.setMasterGain(masterGain);
     }
 
     // Oscillator 1
-    void setOsc1Waveform(int wf) { osc1Waveform = wf; }
-    void setOsc1Octave(int oct) { osc1Octave = oct; }
-    void setOsc1Level(float l) { osc1Level = l; }
+    void setOsc1Waveform(int wf) { updateParam(params.osc1Waveform, wf); }
+    void setOsc1Octave(int oct) { updateParam(params.osc1Octave, oct); }
+    void setOsc1Level(float l) { updateParam(params.osc1Level, l); }
 
     // Oscillator 2
-    void setOsc2Waveform(int wf) { osc2Waveform = wf; }
-    void setOsc2Octave(int oct) { osc2Octave = oct; }
-    void setOsc2Detune(float cents) { osc2Detune = cents; }
-    void setOsc2Level(float l) { osc2Level = l; }
-    void setOsc2Sync(bool sync) { osc2Sync = sync; }
+    void setOsc2Waveform(int wf) { updateParam(params.osc2Waveform, wf); }
+    void setOsc2Octave(int oct) { updateParam(params.osc2Octave, oct); }
+    void setOsc2Detune(float cents) { updateParam(params.osc2Detune, cents); }
+    void setOsc2Level(float l) { updateParam(params.osc2Level, l); }
+    void setOsc2Sync(bool sync) { updateParam(params.osc2Sync, sync); }
 
     // Oscillator 3
-    void setOsc3Waveform(int wf) { osc3Waveform = wf; }
-    void setOsc3Octave(int oct) { osc3Octave = oct; }
-    void setOsc3Detune(float cents) { osc3Detune = cents; }
-    void setOsc3Level(float l) { osc3Level = l; }
+    void setOsc3Waveform(int wf) { updateParam(params.osc3Waveform, wf); }
+    void setOsc3Octave(int oct) { updateParam(params.osc3Octave, oct); }
+    void setOsc3Detune(float cents) { updateParam(params.osc3Detune, cents); }
+    void setOsc3Level(float l) { updateParam(params.osc3Level, l); }
 
     // Noise
-    void setNoiseLevel(float l) { noiseLevel = l; }
+    void setNoiseLevel(float l) { updateParam(params.noiseLevel, l); }
+
+    // Drift
+    void setAnalogDrift(float amt) { updateParam(params.analogDrift, amt); }
 
     // Filter
-    void setFilterCutoff(float cutoffHz) { filterCutoff = cutoffHz; }
-    void setFilterResonance(float reso) { filterResonance = reso; }
-    void setFilterEnvAmount(float amt) { filterEnvAmount = amt; }
-    void setFilterKeyboardTracking(float amt) { filterKeyboardTracking = amt; }
+    void setFilterCutoff(float cutoffHz) { updateParam(params.filterCutoff, cutoffHz); }
+    void setFilterResonance(float reso) { updateParam(params.filterResonance, reso); }
+    void setFilterEnvAmount(float amt) { updateParam(params.filterEnvAmount, amt); }
+    void setFilterKeyboardTracking(float amt) { updateParam(params.filterKeyboardTracking, amt); }
 
     // Amp Envelope
     void setAmpEnvelope(float a, float d, float s, float r)
     {
-        ampAttack = a;
-        ampDecay = d;
-        ampSustain = s;
-        ampRelease = r;
+        updateParam(params.ampAttack, a);
+        updateParam(params.ampDecay, d);
+        updateParam(params.ampSustain, s);
+        updateParam(params.ampRelease, r);
     }
 
     // Filter Envelope
     void setFilterEnvelope(float a, float d, float s, float r)
     {
-        filterAttack = a;
-        filterDecay = d;
-        filterSustain = s;
-        filterRelease = r;
+        updateParam(params.filterAttack, a);
+        updateParam(params.filterDecay, d);
+        updateParam(params.filterSustain, s);
+        updateParam(params.filterRelease, r);
     }
 
     // LFO
-    void setLFORate(float hz) { lfoRate = hz; }
-    void setLFOWaveform(int wf) { lfoWaveform = wf; }
-    void setLFOPitchAmount(float amt) { lfoPitchAmount = amt; }
-    void setLFOFilterAmount(float amt) { lfoFilterAmount = amt; }
+    void setLFORate(float hz)
+    {
+        updateParam(params.lfoRate, hz);
+        sharedLfo.setRate(std::clamp(hz, 0.01f, 50.0f));
+    }
 
-    //==========================================================================
-    // State Queries
-    //==========================================================================
+    void setLFOWaveform(int wf)
+    {
+        updateParam(params.lfoWaveform, wf);
+        sharedLfo.setWaveform(static_cast<LFO::Waveform>(wf));
+    }
+
+    void setLFOPitchAmount(float amt) { updateParam(params.lfoPitchAmount, amt); }
+    void setLFOFilterAmount(float amt) { updateParam(params.lfoFilterAmount, amt); }
 
-    int getActiveVoiceCount() const
+    /**
+     * @brief Switch to a whole preset at once (audio thread)
+     *
+     * @p preset is staged off the audio thread with every value set(), so
+     * it reports every parameter changed. With voices sounding it goes in
+     * at the bottom of a PresetFade; a newer preset during the fade takes
+     * its place. @p preset must stay valid while isLoadingPreset().
+     */
+    void loadPreset(const SynthParams& preset)
     {
-        int count = 0;
-        for (const auto& voice : voices)
+        if (active.size() == 0 && !presetFade.isActive())
         {
-            if (voice.isActive())
-                ++count;
+            applySnapshot(preset);
+            return;
         }
-        return count;
+        pendingPreset = &preset;
+        presetFade.start();
     }
 
-private:
+    /** True until a preset handed to loadPreset() has gone in */
+    bool isLoadingPreset() const { return pendingPreset != nullptr; }
+
+    /** One LFO for every voice, or each voice its own (the lfo_mode choice) */
+    enum class LFOMode { Global = 0, PerVoice };
+
+    void setLFOMode(int mode) { lfoMode = static_cast<LFOMode>(std::clamp(mode, 0, 1)); }
+    LFOMode getLFOMode() const { return lfoMode; }
+
+    /** Every note its own filter and envelopes, or one pair over the summed notes (the voice_mode choice) */
+    enum class VoiceMode { Poly = 0, Paraphonic };
+
+    /** Notes sounding in one mode can't carry on in the other, so switching stops them */
+    void setVoiceMode(int mode)
+    {
+        const auto m = static_cast<VoiceMode>(std::clamp(mode, 0, 1));
+        if (m == voiceMode)
+            return;
+        allNotesOff();
+        voiceMode = m;
+    }
+
+    VoiceMode getVoiceMode() const { return voiceMode; }
+
+    /** When the paraphonic envelopes start: with no other note held, or on every note (para_trigger) */
+    enum class ParaTrigger { FirstNote = 0, EveryNote };
+
+    void setParaTrigger(int trigger) { paraTrigger = static_cast<ParaTrigger>(std::clamp(trigger, 0, 1)); }
+
+    // Voices
+    void setVoiceSteal(int policy) { allocator.setStealPolicy(static_cast<VoiceAllocator<MAX_VOICES>::StealPolicy>(std::clamp(policy, 0, 2))); }
+
+    /**
+     * @brief Free releasing voices once they're this quiet at the output
+     * @param db Level re full scale, after velocity and master volume (-inf: only when they idle)
+     */
+    void setCullThreshold(float db) { releaseCull.setThreshold(db); }
+
+    float getCullThreshold() const { return releaseCull.getThreshold(); }
+
+    /** Shed load when blocks near their deadline (the cpu_governor toggle, see CpuGovernor.h) */
+    void setCpuGovernor(bool on) { governor.setEnabled(on); }
+
+    /** MPE: each note follows its own channel's bend, pressure and slide (off: channels are merged) */
+    void setMpe(bool on)
+    {
+        if (on == mpe)
+            return;
+
+        // Channel state from the other mode means nothing in this one
+        mpe = on;
+        expression = {};
+        voiceChannel.fill(0);
+    }
+
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h). Envelope
+     * stages share one setter each, so a change to any of them re-applies
+     * the four together.
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Oscillator 1
+        if (p.changed(kOsc1Waveform)) setOsc1Waveform(p.index(kOsc1Waveform));
+        if (p.changed(kOsc1Octave)) setOsc1Octave(p.index(kOsc1Octave));
+        if (p.changed(kOsc1Level)) setOsc1Level(p[kOsc1Level]);
+
+        // Oscillator 2
+        if (p.changed(kOsc2Waveform)) setOsc2Waveform(p.index(kOsc2Waveform));
+        if (p.changed(kOsc2Octave)) setOsc2Octave(p.index(kOsc2Octave));
+        if (p.changed(kOsc2Detune)) setOsc2Detune(p[kOsc2Detune]);
+        if (p.changed(kOsc2Level)) setOsc2Level(p[kOsc2Level]);
+        if (p.changed(kOsc2Sync)) setOsc2Sync(p.flag(kOsc2Sync));
+
+        // Oscillator 3
+        if (p.changed(kOsc3Waveform)) setOsc3Waveform(p.index(kOsc3Waveform));
+        if (p.changed(kOsc3Octave)) setOsc3Octave(p.index(kOsc3Octave));
+        if (p.changed(kOsc3Detune)) setOsc3Detune(p[kOsc3Detune]);
+        if (p.changed(kOsc3Level)) setOsc3Level(p[kOsc3Level]);
+
+        // Noise
+        if (p.changed(kNoiseLevel)) setNoiseLevel(p[kNoiseLevel]);
+        if (p.changed(kAnalogDrift)) setAnalogDrift(p[kAnalogDrift]);
+
+        // Filter
+        if (p.changed(kFilterCutoff)) setFilterCutoff(p[kFilterCutoff]);
+        if (p.changed(kFilterReso)) setFilterResonance(p[kFilterReso]);
+        if (p.changed(kFilterEnvAmount)) setFilterEnvAmount(p[kFilterEnvAmount]);
+        if (p.changed(kFilterKbdTrack)) setFilterKeyboardTracking(p[kFilterKbdTrack]);
+
+        // Envelopes
+        if (p.changed(kAmpAttack, kAmpDecay, kAmpSustain, kAmpRelease))
+            setAmpEnvelope(p[kAmpAttack], p[kAmpDecay], p[kAmpSustain], p[kAmpRelease]);
+        if (p.changed(kFilterAttack, kFilterDecay, kFilterSustain, kFilterRelease))
+            setFilterEnvelope(p[kFilterAttack], p[kFilterDecay], p[kFilterSustain], p[kFilterRelease]);
+
+        // LFO
+        if (p.changed(kLfoRate)) setLFORate(p[kLfoRate]);
+        if (p.changed(kLfoWaveform)) setLFOWaveform(p.index(kLfoWaveform));
+        if (p.changed(kLfoPitchAmount)) setLFOPitchAmount(p[kLfoPitchAmount]);
+        if (p.changed(kLfoFilterAmount)) setLFOFilterAmount(p[kLfoFilterAmount]);
+        if (p.changed(kLfoMode)) setLFOMode(p.index(kLfoMode));
+
+        // Master
+        if (p.changed(kMasterVolume)) setMasterVolume(p[kMasterVolume]);
+
+        // Voices
+        if (p.changed(kVoiceSteal)) setVoiceSteal(p.index(kVoiceSteal));
+        if (p.changed(kVoiceMode)) setVoiceMode(p.index(kVoiceMode));
+        if (p.changed(kParaTrigger)) setParaTrigger(p.index(kParaTrigger));
+        if (p.changed(kMpe)) setMpe(p.flag(kMpe));
+        if (p.changed(kCpuGovernor)) setCpuGovernor(p.flag(kCpuGovernor));
+
+        // Keep setParameter()'s copy in step
+        if (&p != &eventParams)
+        {
+            for (int i = 0; i < kNumParams; ++i)
+                eventParams.set(i, p[i]);
+        }
+    }
+
+    /** Current parameter revision (changes whenever any voice parameter changes) */
+    uint32_t getParamRevision() const { return paramRevision; }
+
     //==========================================================================
-    // Voice Management
+    // State Queries
     //==========================================================================
 
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** A note that stopped sounding, as the host started it */
+    struct EndedNote
+    {
+        int sampleOffset = 0;  // Within the block it ended in
+        int note = 0;
+        int channel = 0;
+        int noteId = -1;
+    };
+
     /**
-     * @brief Find a free voice or steal one
-     * @param note The note to be played (used for note stealing priority)
-     * @return Pointer to available voice, or nullptr if none available
+     * @brief Notes that ended since the last clearEndedNotes(), in time order
+     *
+     * Read after renderBlock(); the offsets are in that block. Only the
+     * first MAX_ENDED_NOTES are kept.
      */
-    Voice* findFreeVoice(int note)
+    int getNumEndedNotes() const { return numEndedNotes; }
+    const EndedNote& getEndedNote(int i) const { return endedNotes[static_cast<size_t>(i)]; }
+    void clearEndedNotes() { numEndedNotes = 0; }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** The load governor's step and history (any thread) */
+    const CpuGovernor& getCpuGovernor() const { return governor; }
+
+    /** Voices a note on may use (MAX_VOICES unless the governor has lowered it) */
+    int getVoiceLimit() const { return allocator.getVoiceLimit(); }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        report.addInline("voices", sizeof(voices));
+        report.addInline("paraphonic bus", sizeof(busVoice) + sizeof(paraBus));
+        report.addShared("voice threads", voicePool ? voicePool->getHeapBytes() : 0);
+        report.addShared("pitch tables", sizeof(PitchTables));
+        return report;
+    }
+
+    /** True if no voice sounded during the last renderBlock() */
+    bool isSilent() const { return silentBlock; }
+
+private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** Render one sub-block between MIDI events */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
         {
-            if (!voice.isActive())
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            // The shared LFO, a value per control block, whether or not a voice reads it
+            const float lfoStart = sharedLfoValue;
+            const float* lfoValues = nullptr;
+            if (lfoMode == LFOMode::Global)
             {
-                return &voice;
+                for (int i = 0, k = 0; i < numSamples; i += ControlRamp::BLOCK_SIZE, ++k)
+                    sharedLfoBlock[static_cast<size_t>(k)] = sharedLfoValue =
+                        sharedLfo.advance(std::min(ControlRamp::BLOCK_SIZE, numSamples - i));
+                lfoValues = sharedLfoBlock.data();
             }
-        }
 
-        // No free voice - use voice stealing
+            if (voiceMode == VoiceMode::Paraphonic)
+            {
+                renderParaphonic(outputL, outputR, numSamples, lfoValues, lfoStart);
+                return;
+            }
 
-        // Strategy 1: Steal oldest voice in release phase
-        Voice* oldest = nullptr;
-        int oldestAge = -1;
+            // Sync parameters and collect active voices into SIMD lane groups
+            numActive = 0;
 
-        for (auto& voice : voices)
-        {
-            if (voice.isReleasing() && voice.getAge() > oldestAge)
+            for (int v : active)
+            {
+                Voice& voice = voices[v];
+
+                // Re-derives coefficients only if a setter ran since the last block
+                voice.applyParams(params, paramRevision);
+                applyExpression(v);
+                voice.setSharedLFO(lfoValues, lfoStart);
+
+                // Held at zero sustain: nothing to render until it wakes
+                if (!voice.isSleeping())
+                    activeVoices[numActive++] = &voice;
+            }
+
+            silentBlock = silentBlock && numActive == 0;
+
+            // Noise for every group at once; each voice reads its lane
+            const int numGroups = (numActive + VoiceGroup::LANES - 1) / VoiceGroup::LANES;
+            if (params.noiseLevel != 0.0f)
+                sharedNoise.fill(numSamples, numGroups);
+            for (int i = 0; i < numActive; ++i)
+                activeVoices[i]->setSharedNoise(sharedNoise.group(i / VoiceGroup::LANES), i % VoiceGroup::LANES);
+
+            // Render four voices at a time straight into the output, master
+            // gain included: serially the first group writes the bus and the
+            // rest add; across the pool every thread adds, so it starts cleared
+            if (numGroups == 0)
+            {
+                std::fill(outputL, outputL + numSamples, 0.0f);
+                std::fill(outputR, outputR + numSamples, 0.0f);
+            }
+            else if constexpr (ReferenceDsp::ENABLED)
             {
-                oldest = &voice;
-                oldestAge = voice.getAge();
+                // Reference build: the scalar voice, one at a time
+                std::fill(outputL, outputL + numSamples, 0.0f);
+                std::fill(outputR, outputR + numSamples, 0.0f);
+                for (int i = 0; i < numActive; ++i)
+                    activeVoices[i]->render(outputL, outputR, numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    outputL[i] *= masterGain;
+                    outputR[i] *= masterGain;
+                }
+            }
+            else if (voicePool && voicePool->worthSplitting(numGroups, numSamples))
+            {
+                std::fill(outputL, outputL + numSamples, 0.0f);
+                std::fill(outputR, outputR + numSamples, 0.0f);
+                voicePool->run(&SynthEngine::renderGroup, this, numGroups, outputL, outputR, numSamples,
+                               renderThreads);
+            }
+            else
+            {
+                VoiceGroup::render(activeVoices.data(), std::min(VoiceGroup::LANES, numActive), params,
+                                   outputL, outputR, numSamples, masterGain, false, sharedNoise.group(0));
+                for (int g = 1; g < numGroups; ++g)
+                    renderGroup(this, g, outputL, outputR, numSamples);
+            }
+
+            // Voices whose release ended go back on the free list
+            for (int i = 0; i < numActive; ++i)
+            {
+                if (!activeVoices[i]->isActive())
+                {
+                    const int v = static_cast<int>(activeVoices[i] - voices.data());
+                    voiceEnded(v, renderPosition + numSamples - 1);
+                    allocator.voiceFinished(v);
+                    active.remove(v);
+                }
             }
         }
+    }
+
+    /** Paraphonic: every note's oscillators into paraBus, then the bus voice over it */
+    void renderParaphonic(float* outputL, float* outputR, int numSamples, const float* lfoValues, float lfoStart)
+    {
+        std::fill(outputL, outputL + numSamples, 0.0f);
+        std::fill(outputR, outputR + numSamples, 0.0f);
 
-        if (oldest)
+        busVoice.applyParams(params, paramRevision);
+        applyExpression(busLead, busVoice);
+        busVoice.setSharedLFO(lfoValues, lfoStart);
+
+        // Held at zero sustain: the notes have nothing to be heard through
+        if (!busVoice.isActive() || busVoice.isSleeping())
+            return;
+
+        silentBlock = false;
+
+        // Released notes ring on through the shared release, but not while
+        // another note is held (decided here, once a chord's note offs are all in)
+        bool anyHeld = false;
+        for (int v : active)
+            anyHeld = anyHeld || !voices[v].isReleasing();
+
+        std::fill(paraBus.begin(), paraBus.begin() + numSamples, 0.0f);
+        for (int v : active)
         {
-            oldest->kill();
-            return oldest;
+            Voice& voice = voices[v];
+            voice.applyParams(params, paramRevision);
+            applyExpression(v);
+            voice.setSharedLFO(lfoValues, lfoStart);
+            if (anyHeld && voice.isReleasing())
+                voice.fadeOut();
+            voice.renderOscillators(paraBus.data(), numSamples);
         }
 
-        // Strategy 2: Steal oldest playing voice
-        for (auto& voice : voices)
+        // One noise source in the mixer, as the notes share it
+        if (params.noiseLevel != 0.0f)
+            sharedNoise.fill(numSamples, 1);
+        busVoice.setSharedNoise(sharedNoise.group(0), 0);
+        busVoice.renderBus(paraBus.data(), outputL, outputR, numSamples, masterGain);
+
+        // Notes that faded out go back on the free list; all of them once the shared release ends
+        const int end = renderPosition + numSamples - 1;
+        if (!busVoice.isActive())
         {
-            if (voice.getAge() > oldestAge)
+            for (int v : active)
             {
-                oldest = &voice;
-                oldestAge = voice.getAge();
+                voiceEnded(v, end);
+                voices[v].kill();
             }
+            active.clear();  // Ended here, at the end of the sub-block, not again in allNotesOff()
+            allNotesOff();
+            return;
         }
+        active.update([this, end](int v)
+        {
+            if (voices[v].isActive())
+                return true;
+            voiceEnded(v, end);
+            allocator.voiceFinished(v);
+            return false;
+        });
+    }
 
-        if (oldest)
+    /** Paraphonic note on (voice v just started): start or follow the shared envelopes */
+    void busNoteOn(int v)
+    {
+        int held = 0;
+        for (int u : active)
+            held += u != v && !voices[u].isReleasing();
+
+        // Idle voices skip applyParams, so catch up first
+        busVoice.applyParams(params, paramRevision);
+        busVoice.busNoteOn(voices[v].getNote(), held == 0 || paraTrigger == ParaTrigger::EveryNote);
+        busLead = v;
+    }
+
+    /** Paraphonic note off: the last note held releases the shared envelopes */
+    void busNoteOff()
+    {
+        for (int v : active)
         {
-            oldest->kill();
-            return oldest;
+            if (!voices[v].isReleasing())
+                return;
         }
 
-        return nullptr;
+        if (busVoice.isActive() && !busVoice.isReleasing())
+            busVoice.noteOff();
+    }
+
+    /** The fade reached silence: switch to the preset it was fading towards */
+    void applyPendingPreset()
+    {
+        if (pendingPreset != nullptr)
+            applySnapshot(*pendingPreset);
+        pendingPreset = nullptr;
+    }
+
+    /** Take the governor's step: 1 raises the cull threshold, 2 and 3 lower the voice limit too */
+    void applyGovernorStep(int step)
+    {
+        releaseCull.setRaised(step >= 1);
+        allocator.setVoiceLimit(step >= 3 ? VoiceGroup::LANES : (step == 2 ? MAX_VOICES / 2 : MAX_VOICES));
+    }
+
+    /** Free releasing voices under the cull threshold: a release only falls, so they'd stay under it */
+    void cullQuietReleases()
+    {
+        // Paraphonic notes have no envelope of their own: the shared release is culled, with all of them
+        if (voiceMode == VoiceMode::Paraphonic)
+        {
+            if (busVoice.isReleasing() && releaseCull.isUnder(busVoice.getLevel()))
+                allNotesOff();
+            return;
+        }
+
+        releaseCull.process(active, voices, [this](int v)
+        {
+            voiceEnded(v, renderPosition);
+            voices[v].kill();
+            allocator.voiceFinished(v);
+        });
+    }
+
+    /** Render lane group g of activeVoices (a VoiceThreadPool::TaskFn) */
+    static void renderGroup(void* context, int g, float* mixL, float* mixR, int numSamples)
+    {
+        auto& self = *static_cast<SynthEngine*>(context);
+        const int first = g * VoiceGroup::LANES;
+        const int numLanes = std::min(VoiceGroup::LANES, self.numActive - first);
+        VoiceGroup::render(self.activeVoices.data() + first, numLanes, self.params,
+                           mixL, mixR, numSamples, self.masterGain, true, self.sharedNoise.group(g));
+    }
+
+    /** Voice v's note stopped sounding at offset */
+    void voiceEnded(int v, int offset)
+    {
+        EndedNote ended = hostNote[v];
+        ended.sampleOffset = offset;
+        endNote(ended);
+    }
+
+    void endNote(const EndedNote& ended)
+    {
+        if (numEndedNotes < MAX_ENDED_NOTES)
+            endedNotes[static_cast<size_t>(numEndedNotes++)] = ended;
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value, 0, event.channel, event.id); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value, 0, event.channel); break;
+        case MidiEvent::Type::Pressure: setPressure(event.value, 0, event.channel); break;
+        case MidiEvent::Type::Slide: setSlide(event.value, 0, event.channel); break;
+        case MidiEvent::Type::Param: setParameter(event.id, event.value); break;
+        case MidiEvent::Type::NoteExpression:
+            setNoteExpression(event.note, static_cast<NoteExpression>(event.id), event.value);
+            break;
+        case MidiEvent::Type::NoteModulation: setNoteModulation(event.note, event.id, event.value); break;
+        }
+    }
+
+    //==========================================================================
+    // Expression
+    //==========================================================================
+
+    /** Where a channel's expression is kept: its own slot in MPE mode, else all share slot 0 */
+    int expressionChannel(int channel) const { return mpe ? (channel & (MIDI_CHANNELS - 1)) : 0; }
+
+    /** Hand voice v its channel's bend, pressure and slide plus its own, in the voice's units */
+    void applyExpression(int v) { applyExpression(v, voices[v]); }
+
+    /** The same for voice v's note, handed to target */
+    void applyExpression(int v, Voice& target)
+    {
+        const int c = voiceChannel[v];
+        const NoteState& n = noteState[v];
+        float bend = expression.bend[c] * (c == 0 ? BEND_RANGE : MPE_BEND_RANGE);
+        if (c != 0)
+            bend += expression.bend[0] * BEND_RANGE;  // The MPE master channel bends every note
+
+        target.setExpression(bend + n.tuning,
+                             std::clamp(expression.pressure[c] + n.pressure, 0.0f, 1.0f),
+                             std::clamp(expression.slide[c] + n.slide, -1.0f, 1.0f));
+        target.setModulation(allNotes.cutoff + n.cutoff, allNotes.resonance + n.resonance);
+    }
+
+    /** Give every voice its own drift path, derived from seed */
+    void seedDrift(uint32_t seed)
+    {
+        for (int v = 0; v < MAX_VOICES; ++v)
+            voices[static_cast<size_t>(v)].setDriftSeed(NoiseSource::deriveSeed(seed, static_cast<uint32_t>(v)));
+    }
+
+    /** Call fn(v) for every active voice playing note (-1: every active voice) */
+    template <typename Fn>
+    void forEachVoiceOnNote(int note, Fn&& fn)
+    {
+        for (int v : active)
+        {
+            if (note < 0 || voices[v].getNote() == note)
+                fn(v);
+        }
+    }
+
+    /**
+     * @brief Store a parameter and bump the revision if it actually changed
+     */
+    template <typename T>
+    void updateParam(T& field, T value)
+    {
+        if (field != value)
+        {
+            field = value;
+            ++paramRevision;
+        }
     }
 
     //==========================================================================
@@ -380,12 +1093,100 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** Note frequencies the voices read at note on (see TuningTable.h) */
+    TuningTable tuning;
+
+    /** Which voice plays which note, and which goes next */
+    VoiceAllocator<MAX_VOICES> allocator;
+
+    static constexpr int MIDI_CHANNELS = 16;
+
+    /** Drift paths before any setNoiseSeed(), so renders repeat regardless */
+    static constexpr uint32_t DRIFT_SEED = 0xD21F7u;
+
+    /** Bend range of channel 0 (and of every channel with MPE off), in semitones */
+    static constexpr float BEND_RANGE = 2.0f;
+    /** Bend range of the MPE note channels (the MPE spec's default) */
+    static constexpr float MPE_BEND_RANGE = 48.0f;
+
+    /** Latest expression per channel, one array per dimension */
+    struct ChannelExpression
+    {
+        std::array<float, MIDI_CHANNELS> bend{};      // -1 to 1
+        std::array<float, MIDI_CHANNELS> pressure{};  // 0 to 1
+        std::array<float, MIDI_CHANNELS> slide{};     // -1 to 1
+    };
+
+    ChannelExpression expression;
+
+    /** Channel each voice's note came in on (0 with MPE off) */
+    std::array<uint8_t, MAX_VOICES> voiceChannel{};
+    bool mpe = false;
+
+    /** Each voice's note as the host named it, and the notes that ended */
+    static constexpr int MAX_ENDED_NOTES = MAX_VOICES + MidiEventQueue::CAPACITY;
+    std::array<EndedNote, MAX_VOICES> hostNote{};
+    std::array<EndedNote, MAX_ENDED_NOTES> endedNotes{};
+    int numEndedNotes = 0;
+
+    /** Samples of the current block rendered so far (0 outside renderBlock()) */
+    int renderPosition = 0;
+
+    /** A note's own expression and modulation offsets */
+    struct NoteState
+    {
+        float tuning = 0.0f;     // Semitones
+        float pressure = 0.0f;   // Added to the channel's
+        float slide = 0.0f;      // Added to the channel's
+        float cutoff = 0.0f;     // Hz
+        float resonance = 0.0f;
+    };
+
+    std::array<NoteState, MAX_VOICES> noteState{};
+
+    /** Monophonic modulation: every voice's cutoff and resonance offsets */
+    NoteState allNotes;
+
+    /** The voices sounding (sleeping ones included): the only ones walked per block */
+    ActiveVoiceList<MAX_VOICES> active;
+
+    /** Voices rendering in the current sub-block, in lane-group order */
+    std::array<Voice*, MAX_VOICES> activeVoices{};
+    int numActive = 0;
+
+    /** The process's shared voice-group workers (none unless setRenderThreads) */
+    std::shared_ptr<VoiceThreadPool> voicePool;
+
+    //==========================================================================
+    // Paraphonic
+    //==========================================================================
+
+    VoiceMode voiceMode = VoiceMode::Poly;
+    ParaTrigger paraTrigger = ParaTrigger::FirstNote;
+
+    /** The shared noise, filter and envelopes; its oscillators are unused */
+    Voice busVoice;
+
+    /** Voice of the newest note, whose key and expression the filter follows */
+    int busLead = 0;
+
     //==========================================================================
-    // Mix Buffers (pre-allocated for real-time safety)
+    // Shared LFO
     //==========================================================================
 
-    std::array<float, 8192> mixBufferL{};
-    std::array<float, 8192> mixBufferR{};
+    /** Longest sub-block renderVoices() is handed: sharedLfoBlock holds its control blocks */
+    static constexpr int MAX_SPAN = 16 * ControlRamp::BLOCK_SIZE;
+
+    LFOMode lfoMode = LFOMode::Global;
+    LFO sharedLfo;
+    float sharedLfoValue = 0.0f;  // Its value at the end of the last sub-block
+    std::array<float, MAX_SPAN / ControlRamp::BLOCK_SIZE> sharedLfoBlock{};
+
+    /** Every voice's noise for the current sub-block, a lane each */
+    NoiseBlock<MAX_SPAN, MAX_VOICES / VoiceGroup::LANES> sharedNoise;
+
+    /** Paraphonic: the notes' oscillators, summed, for the current sub-block */
+    std::array<float, MAX_SPAN> paraBus{};
 
     //==========================================================================
     // Engine State
@@ -393,57 +1194,39 @@ private:
 
     double sampleRate = 44100.0;
     int maxBlockSize = 512;
-    float pitchBend = 0.0f;
+    int renderThreads = 1;  // Requested by setRenderThreads()
     float masterGain = 0.5f;  // -6dB default
+    float masterVolumeDb = -6.0206f;  // 20 * log10(masterGain)
+    bool silentBlock = true;  // No voice sounded in the last renderBlock()
 
-    //==========================================================================
-    // Global Parameters
-    //==========================================================================
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
 
-    // Oscillator 1
-    int osc1Waveform = 0;    // Saw
-    int osc1Octave = 0;
-    float osc1Level = 1.0f;
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
 
-    // Oscillator 2
-    int osc2Waveform = 0;    // Saw
-    int osc2Octave = 0;
-    float osc2Detune = 0.0f; // cents
-    float osc2Level = 1.0f;
-    bool osc2Sync = false;
+    /** The preset loadPreset() is fading towards, and the fade */
+    const SynthParams* pendingPreset = nullptr;
+    PresetFade presetFade;
 
-    // Oscillator 3
-    int osc3Waveform = 0;    // Saw
-    int osc3Octave = 0;
-    float osc3Detune = 0.0f; // cents
-    float osc3Level = 0.0f;  // Off by default
+    /** Frees releasing voices under the cull threshold (raised by the governor's first step) */
+    ReleaseCull releaseCull;
 
-    // Noise
-    float noiseLevel = 0.0f;
+    /** Opt-in load shedding (cpu_governor) and what its step asks for */
+    CpuGovernor governor;
 
-    // Filter
-    float filterCutoff = 5000.0f;
-    float filterResonance = 0.0f;
-    float filterEnvAmount = 0.5f;
-    float filterKeyboardTracking = 0.0f;
+    //==========================================================================
+    // Global Parameters
+    //==========================================================================
 
-    // Amp Envelope
-    float ampAttack = 0.01f;
-    float ampDecay = 0.1f;
-    float ampSustain = 0.7f;
-    float ampRelease = 0.3f;
+    /** Snapshot applied to voices; see Voice::applyParams */
+    VoiceParams params;
 
-    // Filter Envelope
-    float filterAttack = 0.01f;
-    float filterDecay = 0.2f;
-    float filterSustain = 0.5f;
-    float filterRelease = 0.3f;
+    /** The last snapshot, for applying one parameter at a time (setParameter) */
+    SynthParams eventParams;
 
-    // LFO
-    float lfoRate = 2.0f;        // Hz
-    int lfoWaveform = 0;         // 0=Sine, 1=Triangle, 2=Saw, 3=Square, 4=S&H
-    float lfoPitchAmount = 0.0f; // 0-1 range
-    float lfoFilterAmount = 0.0f; // 0-1 range
+    /** Starts at 1 so freshly constructed voices (revision 0) always sync */
+    uint32_t paramRevision = 1;
 
     //==========================================================================
     // SST Effects
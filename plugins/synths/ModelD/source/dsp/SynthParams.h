@@ -0,0 +1,75 @@
+/**
+ * @file SynthParams.h
+ * @brief ModelD parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot(). Morph has none: the processor reads it to
+ * position the preset morph (core/dsp/PresetMorph.h).
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(Osc1Waveform,    "osc1_waveform") \
+    X(Osc1Octave,      "osc1_octave") \
+    X(Osc1Level,       "osc1_level") \
+    X(Osc2Waveform,    "osc2_waveform") \
+    X(Osc2Octave,      "osc2_octave") \
+    X(Osc2Detune,      "osc2_detune") \
+    X(Osc2Level,       "osc2_level") \
+    X(Osc2Sync,        "osc2_sync") \
+    X(Osc3Waveform,    "osc3_waveform") \
+    X(Osc3Octave,      "osc3_octave") \
+    X(Osc3Detune,      "osc3_detune") \
+    X(Osc3Level,       "osc3_level") \
+    X(NoiseLevel,      "noise_level") \
+    X(AnalogDrift,     "analog_drift") \
+    X(FilterCutoff,    "filter_cutoff") \
+    X(FilterReso,      "filter_reso") \
+    X(FilterEnvAmount, "filter_env_amount") \
+    X(FilterKbdTrack,  "filter_kbd_track") \
+    X(AmpAttack,       "amp_attack") \
+    X(AmpDecay,        "amp_decay") \
+    X(AmpSustain,      "amp_sustain") \
+    X(AmpRelease,      "amp_release") \
+    X(FilterAttack,    "filter_attack") \
+    X(FilterDecay,     "filter_decay") \
+    X(FilterSustain,   "filter_sustain") \
+    X(FilterRelease,   "filter_release") \
+    X(MasterVolume,    "master_volume") \
+    X(LfoRate,         "lfo_rate") \
+    X(LfoWaveform,     "lfo_waveform") \
+    X(LfoPitchAmount,  "lfo_pitch_amount") \
+    X(LfoFilterAmount, "lfo_filter_amount") \
+    X(LfoMode,         "lfo_mode") \
+    X(VoiceSteal,      "voice_steal") \
+    X(VoiceMode,       "voice_mode") \
+    X(ParaTrigger,     "para_trigger") \
+    X(Mpe,             "mpe") \
+    X(CpuGovernor,     "cpu_governor") \
+    X(Morph,           "morph")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
@@ -10,11 +10,22 @@
  *           Filter Env ─> Filter Cutoff Modulation
  *
  * Features:
- *   - 3 oscillators with saw, triangle, pulse waveforms
- *   - Oscillator sync (OSC2 synced to OSC1)
- *   - 4-pole ladder filter with resonance
- *   - Filter and Amplitude ADSR envelopes
+ *   - 3 oscillators with saw, triangle, pulse waveforms (PolyBlepOscillator.h)
+ *   - Oscillator sync (OSC2 synced to OSC1 at the sub-sample point, polyBLEP-smoothed)
+ *   - 4-pole ladder filter with resonance (sst::filters vintage ladder)
+ *   - Filter and Amplitude ADSR envelopes (exponential segments, ADSREnvelope.h)
  *   - Filter keyboard tracking
+ *   - LFO and filter envelope at control rate (ControlRate.h); the LFO is
+ *     the voice's own or read from the engine's shared one (setSharedLFO)
+ *   - Noise from the engine's NoiseBlock (setSharedNoise), or the voice's
+ *     own generator on its own
+ *   - Per-note expression (bend, pressure, slide) and polyphonic modulation
+ *     (cutoff, resonance) on the same control-rate path
+ *   - Analog drift: each voice's pitch wanders on its own (AnalogDrift.h),
+ *     stepped with the LFO and ramped with its pitch modulation
+ *   - Paraphonic rendering: renderOscillators() adds just the oscillators
+ *     to a bus, and one voice's filter and envelopes run over the bus
+ *     (renderBus)
  */
 
 #pragma once
@@ -22,358 +33,245 @@
 #include <cmath>
 #include <array>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/basic-blocks/dsp/FastMath.h"
+#include "sst/filters.h"
+
+#include "ADSREnvelope.h"
+#include "AnalogDrift.h"
+#include "CoefficientCache.h"
+#include "ControlRate.h"
+#include "FastMath.h"
+#include "LFO.h"
+#include "PitchTables.h"
+#include "PolyBlepOscillator.h"
+#include "TuningTable.h"
+#include "SilenceGate.h"
 
 // Constants
 static constexpr float PI = 3.14159265358979323846f;
 static constexpr float TWO_PI = 2.0f * PI;
 
 /**
- * @brief Simple ADSR Envelope Generator
+ * @brief Moog-style 4-pole ladder filter (24dB/octave)
+ *
+ * Wraps the Huovilainen model from sst::filters::VintageLadder, which runs
+ * four SSE lanes at once. A scalar voice uses lane 0 of its own
+ * QuadFilterUnitState; VoiceGroup moves each voice's lane into a shared
+ * state so four voices share one filter call.
+ *
+ * Coefficients come from FilterCoefficientMaker and are only recomputed
+ * every COEFF_BLOCK_SIZE samples; the filter glides linearly (C += dC) to
+ * the new target in between. In a VoiceGroup the targets come through a
+ * SharedCoefficients cache, so lanes on the same cutoff and resonance (no
+ * envelope, LFO or key tracking on the filter) work them out once.
  */
-class ADSREnvelope
+class LadderFilter
 {
+    friend class VoiceGroup;  // SIMD renderer gathers/scatters lane state
+
 public:
-    enum class Stage { Idle, Attack, Decay, Sustain, Release };
+    using QuadState = sst::filters::QuadFilterUnitState;
 
-    void setSampleRate(float sr) { sampleRate = sr; }
+    /** Target coefficients for one cutoff and resonance */
+    struct Coefficients
+    {
+        float c[sst::filters::n_cm_coeffs]{};
+    };
+
+    /** Targets by (cutoff, resonance, sample rate), for the lanes of one VoiceGroup call */
+    using SharedCoefficients = CoefficientCache<Coefficients, 4>;
+
+    /** Samples between coefficient updates */
+    static constexpr int COEFF_BLOCK_SIZE = 32;
 
-    void setADSR(float a, float d, float s, float r)
+    void setSampleRate(float sr)
     {
-        // Convert times to rates (seconds to samples)
-        attackRate = 1.0f / std::max(0.001f, a * sampleRate);
-        decayRate = 1.0f / std::max(0.001f, d * sampleRate);
-        sustainLevel = std::clamp(s, 0.0f, 1.0f);
-        releaseRate = 1.0f / std::max(0.001f, r * sampleRate);
+        sampleRate = sr;
+        coeffMaker.setSampleRateAndBlockSize(sampleRate, COEFF_BLOCK_SIZE);
+        reset();
     }
 
-    void trigger()
+    void setCutoff(float freq)
     {
-        stage = Stage::Attack;
-        // Don't reset level for legato-style retriggering
+        // Clamp to safe range
+        cutoffFreq = std::clamp(freq, 20.0f, sampleRate * 0.45f);
     }
 
-    void release()
+    void setResonance(float res)
     {
-        if (stage != Stage::Idle)
-            stage = Stage::Release;
+        // Resonance 0-1; the ladder model self-oscillates close to 1
+        resonance = std::clamp(res, 0.0f, 1.0f);
     }
 
-    void reset()
+    /** Retarget the scalar state's coefficients; call once per COEFF_BLOCK_SIZE */
+    void updateCoefficients() { makeCoefficients(state, 0); }
+
+    float process(float input)
     {
-        stage = Stage::Idle;
-        level = 0.0f;
+        auto out = processQuad(&state, SIMD_MM(set1_ps)(input));
+        return SIMD_MM(cvtss_f32)(out);
     }
 
-    float process()
+    void reset()
     {
-        switch (stage)
-        {
-        case Stage::Attack:
-            level += attackRate;
-            if (level >= 1.0f)
-            {
-                level = 1.0f;
-                stage = Stage::Decay;
-            }
-            break;
-
-        case Stage::Decay:
-            level -= decayRate;
-            if (level <= sustainLevel)
-            {
-                level = sustainLevel;
-                stage = Stage::Sustain;
-            }
-            break;
-
-        case Stage::Sustain:
-            level = sustainLevel;
-            break;
-
-        case Stage::Release:
-            level -= releaseRate;
-            if (level <= 0.0f)
-            {
-                level = 0.0f;
-                stage = Stage::Idle;
-            }
-            break;
-
-        case Stage::Idle:
-        default:
-            level = 0.0f;
-            break;
-        }
+        std::memset(&state, 0, sizeof(state));
+        state.sampleRate = sampleRate;
+        state.sampleRateInv = 1.0f / sampleRate;
 
-        return level;
+        // Next coefficient update jumps straight to the target
+        coeffMaker.Reset();
     }
 
-    bool isActive() const { return stage != Stage::Idle; }
-    float getLevel() const { return level; }
-    Stage getStage() const { return stage; }
+    /**
+     * @brief Ladder for four lanes
+     *
+     * The input is soft clipped first, like the Minimoog mixer overdriving
+     * into the filter, so levels stay close to unity with all oscillators up.
+     */
+    static SIMD_M128 processQuad(QuadState* q, SIMD_M128 input)
+    {
+        return sst::filters::VintageLadder::Huov::process(
+            q, FastMath::tanh(input));
+    }
 
 private:
-    float sampleRate = 44100.0f;
-    float attackRate = 0.001f;
-    float decayRate = 0.001f;
-    float sustainLevel = 0.7f;
-    float releaseRate = 0.001f;
-    float level = 0.0f;
-    Stage stage = Stage::Idle;
-};
-
-/**
- * @brief Oscillator with multiple waveforms
- */
-class Oscillator
-{
-public:
-    enum class Waveform { Saw, Triangle, Pulse, Sine };
-
-    void setSampleRate(float sr) { sampleRate = sr; }
-
-    void setFrequency(float freq)
+    /** Compute coefficients for one lane of q, gliding from its current values */
+    void makeCoefficients(QuadState& q, int lane)
     {
-        frequency = freq;
-        phaseIncrement = frequency / sampleRate;
+        coeffMaker.updateCoefficients(q, lane);
+        makeTarget(coeffMaker);
+        coeffMaker.updateState(q, lane);
     }
 
-    void setWaveform(Waveform wf) { waveform = wf; }
-    void setPulseWidth(float pw) { pulseWidth = std::clamp(pw, 0.1f, 0.9f); }
-    void setLevel(float l) { level = l; }
-
-    void reset() { phase = 0.0f; }
-
-    // Sync to another oscillator (hard sync)
-    void sync() { phase = 0.0f; }
-
-    float process()
+    /** As above, with the target from (or added to) a cache the other lanes share */
+    void makeCoefficients(QuadState& q, int lane, SharedCoefficients& shared)
     {
-        float output = 0.0f;
-
-        switch (waveform)
-        {
-        case Waveform::Saw:
-            // Polyblep sawtooth for reduced aliasing
-            output = 2.0f * phase - 1.0f;
-            output -= polyBlep(phase, phaseIncrement);
-            break;
-
-        case Waveform::Triangle:
-            // Triangle from integrated square
-            output = phase < 0.5f
-                ? 4.0f * phase - 1.0f
-                : 3.0f - 4.0f * phase;
-            break;
-
-        case Waveform::Pulse:
-            // Polyblep pulse wave
-            output = phase < pulseWidth ? 1.0f : -1.0f;
-            output += polyBlep(phase, phaseIncrement);
-            output -= polyBlep(std::fmod(phase + 1.0f - pulseWidth, 1.0f), phaseIncrement);
-            break;
-
-        case Waveform::Sine:
-            output = std::sin(TWO_PI * phase);
-            break;
-        }
-
-        // Advance phase
-        phase += phaseIncrement;
-        if (phase >= 1.0f)
-            phase -= 1.0f;
-
-        return output * level;
+        const Coefficients& target = shared.get(cutoffFreq, resonance, sampleRate,
+            [this](Coefficients& out)
+            {
+                // A fresh maker's first target is taken as is, unsmoothed
+                sst::filters::FilterCoefficientMaker<> maker;
+                maker.setSampleRateAndBlockSize(sampleRate, COEFF_BLOCK_SIZE);
+                makeTarget(maker);
+                std::memcpy(out.c, maker.C, sizeof(out.c));
+            });
+
+        coeffMaker.updateCoefficients(q, lane);
+        coeffMaker.FromDirect(target.c);
+        coeffMaker.updateState(q, lane);
     }
 
-    float getPhase() const { return phase; }
-
-private:
-    // PolyBLEP to reduce aliasing
-    float polyBlep(float t, float dt)
+    /** MakeCoeffs() for this cutoff and resonance: the sums, then FromDirect() */
+    void makeTarget(sst::filters::FilterCoefficientMaker<>& maker) const
     {
-        if (t < dt)
-        {
-            t /= dt;
-            return t + t - t * t - 1.0f;
-        }
-        else if (t > 1.0f - dt)
-        {
-            t = (t - 1.0f) / dt;
-            return t * t + t + t + 1.0f;
-        }
-        return 0.0f;
+        maker.MakeCoeffs(12.0f * std::log2(cutoffFreq / 440.0f), resonance,
+                         sst::filters::FilterType::fut_vintageladder,
+                         sst::filters::FilterSubType::st_vintage_type2, nullptr, false);
     }
 
-    float sampleRate = 44100.0f;
-    float frequency = 440.0f;
-    float phase = 0.0f;
-    float phaseIncrement = 0.01f;
-    float pulseWidth = 0.5f;
-    float level = 1.0f;
-    Waveform waveform = Waveform::Saw;
-};
-
-/**
- * @brief LFO (Low Frequency Oscillator) for modulation
- *
- * Provides classic modulation waveforms for parameter modulation.
- * Like the original Minimoog, can modulate pitch and filter.
- */
-class LFO
-{
-public:
-    enum class Waveform { Sine, Triangle, Saw, Square, SampleHold };
-
-    void setSampleRate(float sr) { sampleRate = sr; }
-
-    void setRate(float hz)
+    /** Copy this filter's registers and coefficients into a lane of q */
+    void loadLane(QuadState& q, int lane) const
     {
-        rate = std::clamp(hz, 0.01f, 50.0f);
-        phaseIncrement = rate / sampleRate;
+        for (int r = 0; r < sst::filters::n_filter_registers; ++r)
+            setLane(q.R[r], lane, SIMD_MM(cvtss_f32)(state.R[r]));
+        for (int c = 0; c < sst::filters::n_cm_coeffs; ++c)
+            setLane(q.C[c], lane, SIMD_MM(cvtss_f32)(state.C[c]));
     }
 
-    void setWaveform(Waveform wf) { waveform = wf; }
-
-    void reset()
+    /** Copy a lane of q back into this filter's registers and coefficients */
+    void storeLane(const QuadState& q, int lane)
     {
-        phase = 0.0f;
-        sampleHoldValue = 0.0f;
+        for (int r = 0; r < sst::filters::n_filter_registers; ++r)
+            state.R[r] = SIMD_MM(set1_ps)(getLane(q.R[r], lane));
+        for (int c = 0; c < sst::filters::n_cm_coeffs; ++c)
+            state.C[c] = SIMD_MM(set1_ps)(getLane(q.C[c], lane));
     }
 
-    /**
-     * @brief Process one sample of LFO output
-     * @return Bipolar output in range [-1, 1]
-     */
-    float process()
+    static void setLane(SIMD_M128& m, int lane, float f)
     {
-        float output = 0.0f;
-
-        switch (waveform)
-        {
-        case Waveform::Sine:
-            output = std::sin(TWO_PI * phase);
-            break;
-
-        case Waveform::Triangle:
-            output = phase < 0.5f
-                ? 4.0f * phase - 1.0f
-                : 3.0f - 4.0f * phase;
-            break;
-
-        case Waveform::Saw:
-            output = 2.0f * phase - 1.0f;
-            break;
-
-        case Waveform::Square:
-            output = phase < 0.5f ? 1.0f : -1.0f;
-            break;
-
-        case Waveform::SampleHold:
-            // Update sample-hold value when phase wraps
-            if (phase + phaseIncrement >= 1.0f)
-            {
-                // Generate random value
-                shNoiseState = shNoiseState * 1664525u + 1013904223u;
-                sampleHoldValue = (static_cast<float>(shNoiseState) / 2147483648.0f) - 1.0f;
-            }
-            output = sampleHoldValue;
-            break;
-        }
-
-        // Advance phase
-        phase += phaseIncrement;
-        if (phase >= 1.0f)
-            phase -= 1.0f;
-
-        return output;
+        alignas(16) float v[4];
+        SIMD_MM(store_ps)(v, m);
+        v[lane] = f;
+        m = SIMD_MM(load_ps)(v);
     }
 
-    float getPhase() const { return phase; }
+    static float getLane(SIMD_M128 m, int lane)
+    {
+        alignas(16) float v[4];
+        SIMD_MM(store_ps)(v, m);
+        return v[lane];
+    }
 
-private:
     float sampleRate = 44100.0f;
-    float rate = 1.0f;
-    float phase = 0.0f;
-    float phaseIncrement = 0.0001f;
-    Waveform waveform = Waveform::Sine;
-
-    // Sample-and-hold state
-    float sampleHoldValue = 0.0f;
-    uint32_t shNoiseState = 54321;
+    float cutoffFreq = 5000.0f;
+    float resonance = 0.0f;
+
+    QuadState state{};  // Lane 0 holds this voice's filter
+    sst::filters::FilterCoefficientMaker<> coeffMaker;
 };
 
 /**
- * @brief Moog-style 4-pole ladder filter (24dB/octave)
+ * @brief Global parameter snapshot shared by all voices
  *
- * Based on the classic transistor ladder topology with
- * 4 cascaded 1-pole filters and feedback for resonance.
+ * Owned by SynthEngine. Every engine setter that changes a field bumps the
+ * engine's parameter revision; voices only re-derive their coefficients
+ * (octave multipliers, detune ratios, envelope rates) when the revision
+ * they last applied differs from the current one.
  */
-class LadderFilter
+struct VoiceParams
 {
-public:
-    void setSampleRate(float sr)
-    {
-        sampleRate = sr;
-        // Reset state
-        std::fill(stage.begin(), stage.end(), 0.0f);
-    }
-
-    void setCutoff(float freq)
-    {
-        // Clamp to safe range
-        cutoffFreq = std::clamp(freq, 20.0f, sampleRate * 0.45f);
-
-        // Calculate coefficient using tan approximation for stability
-        float wc = TWO_PI * cutoffFreq / sampleRate;
-        g = 0.9892f * wc - 0.4342f * wc * wc + 0.1381f * wc * wc * wc - 0.0202f * wc * wc * wc * wc;
-        g = std::clamp(g, 0.0f, 1.0f);
-    }
+    // Oscillators
+    int osc1Waveform = 0;    // Saw
+    int osc1Octave = 0;
+    float osc1Level = 1.0f;
 
-    void setResonance(float res)
-    {
-        // Resonance 0-1 maps to feedback 0-4
-        // Self-oscillation starts around 3.8
-        resonance = std::clamp(res, 0.0f, 1.0f);
-        k = 4.0f * resonance;
-    }
+    int osc2Waveform = 0;    // Saw
+    int osc2Octave = 0;
+    float osc2Detune = 0.0f; // cents
+    float osc2Level = 1.0f;
+    bool osc2Sync = false;
 
-    float process(float input)
-    {
-        // Feedback from output (4th stage)
-        float feedback = k * stage[3];
+    int osc3Waveform = 0;    // Saw
+    int osc3Octave = 0;
+    float osc3Detune = 0.0f; // cents
+    float osc3Level = 0.0f;  // Off by default
 
-        // Input with feedback subtracted (inverted ladder topology)
-        float u = input - feedback;
+    // Noise
+    float noiseLevel = 0.0f;
 
-        // Soft clip the input to prevent runaway with high resonance
-        u = std::tanh(u);
+    // Filter
+    float filterCutoff = 5000.0f;
+    float filterResonance = 0.0f;
+    float filterEnvAmount = 0.5f;
+    float filterKeyboardTracking = 0.0f;
 
-        // Four cascaded 1-pole lowpass stages
-        for (int i = 0; i < 4; ++i)
-        {
-            float v = (u - stage[i]) * g;
-            float y = v + stage[i];
-            stage[i] = y + v;  // Trapezoidal integration
-            u = y;
-        }
+    // Amp Envelope
+    float ampAttack = 0.01f;
+    float ampDecay = 0.1f;
+    float ampSustain = 0.7f;
+    float ampRelease = 0.3f;
 
-        return stage[3];
-    }
+    // Filter Envelope
+    float filterAttack = 0.01f;
+    float filterDecay = 0.2f;
+    float filterSustain = 0.5f;
+    float filterRelease = 0.3f;
 
-    void reset()
-    {
-        std::fill(stage.begin(), stage.end(), 0.0f);
-    }
+    // LFO
+    float lfoRate = 2.0f;         // Hz
+    int lfoWaveform = 0;          // 0=Sine, 1=Triangle, 2=Saw, 3=Square, 4=S&H
+    float lfoPitchAmount = 0.0f;  // 0-1 range
+    float lfoFilterAmount = 0.0f; // 0-1 range
 
-private:
-    float sampleRate = 44100.0f;
-    float cutoffFreq = 5000.0f;
-    float resonance = 0.0f;
-    float g = 0.5f;  // Filter coefficient
-    float k = 0.0f;  // Feedback amount
+    // Drift
+    float analogDrift = 0.0f;     // 0-1 range
 
-    std::array<float, 4> stage{};  // 4 filter stages
+    // Master level per voice
+    float masterLevel = 1.0f;
 };
 
 /**
@@ -381,6 +279,8 @@ private:
  */
 class Voice
 {
+    friend class VoiceGroup;  // SIMD renderer gathers/scatters lane state
+
 public:
     static constexpr int NUM_OSCILLATORS = 3;
 
@@ -397,32 +297,39 @@ public:
         filter.setSampleRate(sampleRate);
         ampEnv.setSampleRate(sampleRate);
         filterEnv.setSampleRate(sampleRate);
-        lfo.setSampleRate(sampleRate);
+        lfo.prepare(sampleRate);
 
         // Default envelope settings (Minimoog-like)
         ampEnv.setADSR(0.01f, 0.1f, 0.7f, 0.3f);
         filterEnv.setADSR(0.01f, 0.2f, 0.5f, 0.3f);
 
         // Default LFO settings
-        lfo.setRate(2.0f);
+        setLFORate(2.0f);
         lfo.setWaveform(LFO::Waveform::Sine);
+
+        drift.prepare(sr);
+        gateStep = 1.0f / (GATE_SECONDS * sampleRate);
     }
 
+    /** Note frequencies from @p table (nullptr: 12-TET from PitchTables); the engine owns it */
+    void setTuning(const TuningTable* table) { tuning = table; }
+
     void noteOn(int note, float vel)
     {
         currentNote = note;
         velocity = vel;
         active = true;
         releasing = false;
-        age = 0;
 
-        // Calculate base frequency from MIDI note
-        float baseFreq = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        // Calculate base frequency from MIDI note (cached for render)
+        float baseFreq = noteToFrequency(note);
+        noteFrequency = baseFreq;
 
         // Set oscillator frequencies with octave/detune
-        oscillators[0].setFrequency(baseFreq * osc1OctaveMultiplier);
-        oscillators[1].setFrequency(baseFreq * osc2OctaveMultiplier * osc2Detune);
-        oscillators[2].setFrequency(baseFreq * osc3OctaveMultiplier * osc3Detune);
+        setOscillatorFrequencies(1.0f);
+
+        // Pick the free-running LFO's pitch modulation (and the bend) up where it is
+        pitchRamp.reset(PitchTables::get().semitonesToRatio(pitchModSemitones()));
 
         // Calculate keyboard tracking for filter
         keyboardTrackingFreq = baseFreq;
@@ -436,6 +343,9 @@ public:
             osc.reset();
 
         filter.reset();
+
+        gate = 0.0f;
+        gateTarget = 1.0f;
     }
 
     void noteOff()
@@ -459,117 +369,253 @@ public:
         if (!active)
             return;
 
-        ++age;
-
-        // Calculate base frequency from current note for pitch modulation
-        float baseFreq = 440.0f * std::pow(2.0f, (currentNote - 69) / 12.0f);
+        const bool pitchMod = lfoPitchAmount != 0.0f || bendSemitones != 0.0f || driftAmount != 0.0f;
 
         for (int i = 0; i < numSamples; ++i)
         {
-            // Get LFO value (bipolar -1 to +1)
-            float lfoValue = lfo.process();
+            // Modulators and filter coefficients, once per control block
+            if (i % ControlRamp::BLOCK_SIZE == 0)
+            {
+                updateModulators(std::min(numSamples - i, ControlRamp::BLOCK_SIZE));
+                filter.updateCoefficients();
 
-            // Apply LFO pitch modulation (in semitones)
-            // Max pitch mod range: +/- 12 semitones (1 octave)
-            float pitchModSemitones = lfoValue * lfoPitchAmount * 12.0f;
-            float pitchModMultiplier = std::pow(2.0f, pitchModSemitones / 12.0f);
+                if (!pitchMod)
+                    setOscillatorFrequencies(1.0f);
+            }
 
-            // Update oscillator frequencies with LFO pitch modulation
-            oscillators[0].setFrequency(baseFreq * osc1OctaveMultiplier * pitchModMultiplier);
-            oscillators[1].setFrequency(baseFreq * osc2OctaveMultiplier * osc2Detune * pitchModMultiplier);
-            oscillators[2].setFrequency(baseFreq * osc3OctaveMultiplier * osc3Detune * pitchModMultiplier);
+            // LFO pitch modulation, ramped across the control block
+            if (pitchMod)
+                setOscillatorFrequencies(pitchRamp.next());
 
-            // Process oscillators
-            float osc1Out = oscillators[0].process();
-            float osc2Out = oscillators[1].process();
-            float osc3Out = oscillators[2].process();
+            // Mix oscillators + noise
+            float mix = oscillatorMix()
+                      + (sharedNoise != nullptr ? sharedNoise[4 * i] : noise()) * noiseLevel;
 
-            // OSC2 sync to OSC1 (optional)
-            if (osc2Sync && oscillators[0].getPhase() < 0.01f)
-                oscillators[1].sync();
+            // Apply filter
+            float filtered = filter.process(mix);
 
-            // Mix oscillators + noise
-            float mix = osc1Out * osc1Level
-                      + osc2Out * osc2Level
-                      + osc3Out * osc3Level
-                      + noise() * noiseLevel;
-
-            // Filter envelope modulation
-            float filterEnvOut = filterEnv.process();
-            float modCutoff;
-
-            if (filterEnvAmount >= 0.0f) {
-                // Positive: envelope opens filter (sweep up from base)
-                modCutoff = filterCutoff + filterEnvAmount * filterEnvOut * 10000.0f;
-            } else {
-                // Negative: inverted - filter starts open, closes at envelope peak
-                // At env=0: cutoff = base + |amt| * 10000 (bright)
-                // At env=1: cutoff = base (dark)
-                modCutoff = filterCutoff + std::abs(filterEnvAmount) * (1.0f - filterEnvOut) * 10000.0f;
+            // Amp envelope
+            float ampEnvOut = ampEnv.process();
+
+            // Check if voice has finished
+            if (!ampEnv.isActive())
+            {
+                active = false;
+                return;
             }
 
-            // LFO filter modulation
-            // Bipolar modulation: positive LFO increases cutoff, negative decreases
-            // Max filter mod range: +/- 8000 Hz
-            float lfoFilterMod = lfoValue * lfoFilterAmount * 8000.0f;
-            modCutoff += lfoFilterMod;
+            // Final output
+            float output = filtered * ampEnvOut * velocity * masterLevel;
+            outputL[i] += output;
+            outputR[i] += output;
+        }
+    }
 
-            // Keyboard tracking
-            if (filterKeyboardTracking > 0.0f)
+    /**
+     * @brief Paraphonic: add the oscillators alone, times velocity, to a mono bus
+     *
+     * No noise, filter or envelope: the engine's bus voice (renderBus)
+     * applies those once to the sum. The LFO and bend still move the pitch.
+     * The oscillators fade in over GATE_SECONDS from note on, and out once
+     * fadeOut() asks; the voice goes inactive when the fade out ends.
+     */
+    void renderOscillators(float* bus, int numSamples)
+    {
+        if (!active)
+            return;
+
+        const bool pitchMod = lfoPitchAmount != 0.0f || bendSemitones != 0.0f || driftAmount != 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (i % ControlRamp::BLOCK_SIZE == 0)
             {
-                modCutoff += (keyboardTrackingFreq - 261.63f) * filterKeyboardTracking;
+                updatePitchModulation(std::min(numSamples - i, ControlRamp::BLOCK_SIZE));
+
+                if (!pitchMod)
+                    setOscillatorFrequencies(1.0f);
             }
 
-            filter.setCutoff(modCutoff);
-            filter.setResonance(filterResonance);
+            if (pitchMod)
+                setOscillatorFrequencies(pitchRamp.next());
 
-            // Apply filter
+            if (gate != gateTarget)
+            {
+                gate = gateTarget > gate ? std::min(gate + gateStep, 1.0f) : std::max(gate - gateStep, 0.0f);
+                if (gate == 0.0f)
+                {
+                    active = false;
+                    return;
+                }
+            }
+
+            bus[i] += oscillatorMix() * velocity * gate;
+        }
+    }
+
+    /** Paraphonic: fade the oscillators out, then free the voice (its note gave way) */
+    void fadeOut() { gateTarget = 0.0f; }
+
+    /**
+     * @brief Paraphonic: follow note on the bus voice
+     * @param retrigger Start the envelopes again from where they are
+     *
+     * The filter tracks the note's key. A voice already sounding keeps its
+     * filter state, so a retrigger doesn't click.
+     */
+    void busNoteOn(int note, bool retrigger)
+    {
+        if (!active)
+        {
+            filter.reset();
+            retrigger = true;
+        }
+
+        currentNote = note;
+        velocity = 1.0f;  // Each note's velocity is on its oscillators
+        keyboardTrackingFreq = noteToFrequency(note);
+
+        if (retrigger)
+        {
+            active = true;
+            releasing = false;
+            ampEnv.trigger();
+            filterEnv.trigger();
+        }
+    }
+
+    /**
+     * @brief Paraphonic: this voice's noise, filter and VCA over a bus of summed oscillators
+     * @param gain Applied on top of the voice's own level
+     *
+     * render() with the bus for the oscillators; the voice goes inactive
+     * when its amp envelope ends.
+     */
+    void renderBus(const float* bus, float* outputL, float* outputR, int numSamples, float gain)
+    {
+        if (!active)
+            return;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (i % ControlRamp::BLOCK_SIZE == 0)
+            {
+                updateModulators(std::min(numSamples - i, ControlRamp::BLOCK_SIZE));
+                filter.updateCoefficients();
+            }
+
+            float mix = bus[i] + (sharedNoise != nullptr ? sharedNoise[4 * i] : noise()) * noiseLevel;
             float filtered = filter.process(mix);
 
-            // Amp envelope
             float ampEnvOut = ampEnv.process();
-
-            // Check if voice has finished
             if (!ampEnv.isActive())
             {
                 active = false;
                 return;
             }
 
-            // Final output
-            float output = filtered * ampEnvOut * velocity * masterLevel;
+            float output = filtered * ampEnvOut * velocity * masterLevel * gain;
             outputL[i] += output;
             outputR[i] += output;
         }
     }
 
+    /**
+     * @brief Apply the engine's parameter snapshot if it has changed
+     * @param p Current global parameters
+     * @param revision Engine parameter revision (bumped on every change)
+     *
+     * Cheap when nothing changed: a single integer compare per block.
+     */
+    void applyParams(const VoiceParams& p, uint32_t revision)
+    {
+        if (revision == appliedRevision)
+            return;
+
+        appliedRevision = revision;
+
+        setOsc1Waveform(static_cast<PolyBlepOscillator::Waveform>(p.osc1Waveform));
+        setOsc1Octave(p.osc1Octave);
+        setOsc1Level(p.osc1Level);
+
+        setOsc2Waveform(static_cast<PolyBlepOscillator::Waveform>(p.osc2Waveform));
+        setOsc2Octave(p.osc2Octave);
+        setOsc2Detune(p.osc2Detune);
+        setOsc2Level(p.osc2Level);
+        setOsc2Sync(p.osc2Sync);
+
+        setOsc3Waveform(static_cast<PolyBlepOscillator::Waveform>(p.osc3Waveform));
+        setOsc3Octave(p.osc3Octave);
+        setOsc3Detune(p.osc3Detune);
+        setOsc3Level(p.osc3Level);
+
+        setNoiseLevel(p.noiseLevel);
+
+        setFilterCutoff(p.filterCutoff);
+        setFilterResonance(p.filterResonance);
+        setFilterEnvAmount(p.filterEnvAmount);
+        setFilterKeyboardTracking(p.filterKeyboardTracking);
+
+        ampAttack = p.ampAttack;
+        ampDecay = p.ampDecay;
+        ampSustain = p.ampSustain;
+        ampRelease = p.ampRelease;
+        updateAmpEnv();
+
+        filterAttackTime = p.filterAttack;
+        filterDecayTime = p.filterDecay;
+        filterSustainLevel = p.filterSustain;
+        filterReleaseTime = p.filterRelease;
+        updateFilterEnv();
+
+        setLFORate(p.lfoRate);
+        setLFOWaveform(static_cast<LFO::Waveform>(p.lfoWaveform));
+        setLFOPitchAmount(p.lfoPitchAmount);
+        setLFOFilterAmount(p.lfoFilterAmount);
+
+        setAnalogDrift(p.analogDrift);
+
+        setMasterLevel(p.masterLevel);
+    }
+
     // State accessors
     bool isActive() const { return active; }
+
+    /**
+     * @brief Still holding its note, but at a silent sustain
+     *
+     * The voice keeps its slot (note off and retrigger still find it) but
+     * has nothing to render; the engine skips it until it wakes.
+     */
+    bool isSleeping() const { return active && ampEnv.isSilent(); }
+
     bool isReleasing() const { return releasing; }
     int getNote() const { return currentNote; }
     float getVelocity() const { return velocity; }
-    int getAge() const { return age; }
+
+    /** Loudness now (amp envelope x velocity), for the Quietest steal policy */
+    float getLevel() const { return ampEnv.getLevel() * velocity; }
 
     // =========================================================================
     // Parameter Setters
     // =========================================================================
 
     // Oscillator 1
-    void setOsc1Waveform(Oscillator::Waveform wf) { oscillators[0].setWaveform(wf); }
-    void setOsc1Octave(int oct) { osc1OctaveMultiplier = std::pow(2.0f, oct); }
+    void setOsc1Waveform(PolyBlepOscillator::Waveform wf) { oscillators[0].setWaveform(wf); }
+    void setOsc1Octave(int oct) { osc1OctaveMultiplier = PitchTables::get().octavesToRatio(static_cast<float>(oct)); }
     void setOsc1Level(float l) { osc1Level = l; }
 
     // Oscillator 2
-    void setOsc2Waveform(Oscillator::Waveform wf) { oscillators[1].setWaveform(wf); }
-    void setOsc2Octave(int oct) { osc2OctaveMultiplier = std::pow(2.0f, oct); }
-    void setOsc2Detune(float cents) { osc2Detune = std::pow(2.0f, cents / 1200.0f); }
+    void setOsc2Waveform(PolyBlepOscillator::Waveform wf) { oscillators[1].setWaveform(wf); }
+    void setOsc2Octave(int oct) { osc2OctaveMultiplier = PitchTables::get().octavesToRatio(static_cast<float>(oct)); }
+    void setOsc2Detune(float cents) { osc2Detune = PitchTables::get().centsToRatio(cents); }
     void setOsc2Level(float l) { osc2Level = l; }
     void setOsc2Sync(bool sync) { osc2Sync = sync; }
 
     // Oscillator 3
-    void setOsc3Waveform(Oscillator::Waveform wf) { oscillators[2].setWaveform(wf); }
-    void setOsc3Octave(int oct) { osc3OctaveMultiplier = std::pow(2.0f, oct); }
-    void setOsc3Detune(float cents) { osc3Detune = std::pow(2.0f, cents / 1200.0f); }
+    void setOsc3Waveform(PolyBlepOscillator::Waveform wf) { oscillators[2].setWaveform(wf); }
+    void setOsc3Octave(int oct) { osc3OctaveMultiplier = PitchTables::get().octavesToRatio(static_cast<float>(oct)); }
+    void setOsc3Detune(float cents) { osc3Detune = PitchTables::get().centsToRatio(cents); }
     void setOsc3Level(float l) { osc3Level = l; }
 
     // Noise
@@ -594,15 +640,176 @@ public:
     void setFilterRelease(float t) { filterReleaseTime = t; updateFilterEnv(); }
 
     // LFO
-    void setLFORate(float hz) { lfo.setRate(hz); }
+    void setLFORate(float hz) { lfo.setRate(std::clamp(hz, 0.01f, 50.0f)); }
     void setLFOWaveform(LFO::Waveform wf) { lfo.setWaveform(wf); }
     void setLFOPitchAmount(float amt) { lfoPitchAmount = amt; }
     void setLFOFilterAmount(float amt) { lfoFilterAmount = amt; }
 
+    // Drift
+    void setAnalogDrift(float amt)
+    {
+        driftAmount = amt;
+        if (amt == 0.0f)
+            driftSemitones = 0.0f;
+    }
+
+    /** Seed this voice's drift: voices seeded apart wander apart */
+    void setDriftSeed(uint32_t seed) { drift.reseed(seed); }
+
     // Master
     void setMasterLevel(float l) { masterLevel = l; }
 
+    /**
+     * @brief Read the LFO from a buffer the engine renders for all voices
+     * @param values One LFO value per control block of the next render(),
+     *               or nullptr to run the voice's own LFO
+     * @param current The shared LFO's value now, for a note on before then
+     */
+    void setSharedLFO(const float* values, float current)
+    {
+        sharedLfo = values;
+        sharedLfoIndex = 0;
+        if (values != nullptr)
+            lfoValue = current;
+    }
+
+    /**
+     * @brief Read noise from the engine's NoiseBlock for the next render()
+     * @param quad The voice's group, four interleaved lanes (NoiseBlock::group()),
+     *             or nullptr to run the voice's own generator
+     * @param lane The voice's lane in the group
+     */
+    void setSharedNoise(const float* quad, int lane) { sharedNoise = quad != nullptr ? quad + lane : nullptr; }
+
+    /**
+     * @brief Per-note expression, read at the next control block
+     * @param bend Pitch bend in semitones
+     * @param pressure 0-1, opens the filter
+     * @param slide -1 to 1 (MPE timbre, CC74), moves the cutoff either way
+     */
+    void setExpression(float bend, float pressure, float slide)
+    {
+        bendSemitones = bend;
+        expressionCutoff = pressure * PRESSURE_CUTOFF_HZ + slide * SLIDE_CUTOFF_HZ;
+    }
+
+    /**
+     * @brief Polyphonic modulation of this voice alone, read at the next control block
+     * @param cutoffHz Added to the filter cutoff
+     * @param resonance Added to the resonance (the sum is clamped to 0-1)
+     */
+    void setModulation(float cutoffHz, float resonance)
+    {
+        modCutoffHz = cutoffHz;
+        modResonance = resonance;
+    }
+
+    /** Full analog drift scales AnalogDrift's wander to this (about 20 cents either way, typically) */
+    static constexpr float DRIFT_SEMITONES = 0.5f;
+
+    /** Paraphonic oscillators fade in and out over this long */
+    static constexpr float GATE_SECONDS = 0.005f;
+
+    /** Full pressure adds this to the cutoff */
+    static constexpr float PRESSURE_CUTOFF_HZ = 6000.0f;
+    /** Full slide either way moves the cutoff this far */
+    static constexpr float SLIDE_CUTOFF_HZ = 4000.0f;
+
 private:
+    /** The note's frequency in the current tuning */
+    float noteToFrequency(int note) const
+    {
+        return tuning != nullptr ? tuning->frequency(note) : PitchTables::get().midiToFrequency(static_cast<float>(note));
+    }
+
+    const TuningTable* tuning = nullptr;  // The engine's, when it isn't 12-TET
+
+    static_assert(ControlRamp::BLOCK_SIZE == LadderFilter::COEFF_BLOCK_SIZE,
+                  "filter coefficients glide over one control block");
+
+    /**
+     * @brief Step the LFO and filter envelope over the next n samples
+     *
+     * Runs once per control block. The pitch ramp and the filter cutoff are
+     * retargeted to the block-end values; the ladder's coefficients glide
+     * there over the block (filter.updateCoefficients() or VoiceGroup).
+     */
+    void updateModulators(int n)
+    {
+        updatePitchModulation(n);
+        const float filterEnvOut = filterEnv.advance(n);
+
+        // Filter envelope modulation
+        float modCutoff;
+
+        if (filterEnvAmount >= 0.0f) {
+            // Positive: envelope opens filter (sweep up from base)
+            modCutoff = filterCutoff + filterEnvAmount * filterEnvOut * 10000.0f;
+        } else {
+            // Negative: inverted - filter starts open, closes at envelope peak
+            // At env=0: cutoff = base + |amt| * 10000 (bright)
+            // At env=1: cutoff = base (dark)
+            modCutoff = filterCutoff + std::abs(filterEnvAmount) * (1.0f - filterEnvOut) * 10000.0f;
+        }
+
+        // LFO filter modulation
+        // Bipolar modulation: positive LFO increases cutoff, negative decreases
+        // Max filter mod range: +/- 8000 Hz
+        modCutoff += lfoValue * lfoFilterAmount * 8000.0f;
+
+        // Pressure, slide and polyphonic modulation
+        modCutoff += expressionCutoff + modCutoffHz;
+
+        // Keyboard tracking
+        if (filterKeyboardTracking > 0.0f)
+        {
+            modCutoff += (keyboardTrackingFreq - 261.63f) * filterKeyboardTracking;
+        }
+
+        filter.setCutoff(modCutoff);
+        filter.setResonance(filterResonance + modResonance);
+    }
+
+    /** Step the LFO and drift over the next n samples and retarget the pitch ramp (LFO, bend, drift) */
+    void updatePitchModulation(int n)
+    {
+        // LFO value (bipolar -1 to +1)
+        lfoValue = sharedLfo != nullptr ? sharedLfo[sharedLfoIndex++] : lfo.advance(n);
+        if (driftAmount != 0.0f)
+            driftSemitones = drift.advance(n) * driftAmount * DRIFT_SEMITONES;
+        pitchRamp.setTarget(PitchTables::get().semitonesToRatio(pitchModSemitones()), n);
+    }
+
+    /** The three oscillators' next sample, synced and mixed at their levels */
+    float oscillatorMix()
+    {
+        float osc1Out = oscillators[0].process();
+        float osc2Out = oscillators[1].process();
+        float osc3Out = oscillators[2].process();
+
+        // OSC2 sync to OSC1, from the point in the sample where OSC1 wrapped
+        if (osc2Sync)
+        {
+            const float after = oscillators[0].wrapFraction();
+            if (after >= 0.0f)
+                osc2Out += oscillators[1].sync(after);
+        }
+
+        return osc1Out * osc1Level + osc2Out * osc2Level + osc3Out * osc3Level;
+    }
+
+    /** LFO pitch modulation (max +/- 12 semitones) plus the bend and drift */
+    float pitchModSemitones() const { return lfoValue * lfoPitchAmount * 12.0f + bendSemitones + driftSemitones; }
+
+    /** Oscillator frequencies from the note, octave and detune, times pitchMod */
+    void setOscillatorFrequencies(float pitchMod)
+    {
+        const float baseFreq = noteFrequency * pitchMod;
+        oscillators[0].setFrequency(baseFreq * osc1OctaveMultiplier);
+        oscillators[1].setFrequency(baseFreq * osc2OctaveMultiplier * osc2Detune);
+        oscillators[2].setFrequency(baseFreq * osc3OctaveMultiplier * osc3Detune);
+    }
+
     void updateAmpEnv()
     {
         ampEnv.setADSR(ampAttack, ampDecay, ampSustain, ampRelease);
@@ -621,16 +828,17 @@ private:
     }
 
     // Voice state
+    uint32_t appliedRevision = 0;  // Engine revision last applied (0 = never)
     bool active = false;
     bool releasing = false;
     int currentNote = -1;
+    float noteFrequency = 440.0f;  // currentNote in Hz, set by noteOn
     float velocity = 0.0f;
-    int age = 0;
 
     float sampleRate = 44100.0f;
 
     // Oscillators
-    std::array<Oscillator, NUM_OSCILLATORS> oscillators;
+    std::array<PolyBlepOscillator, NUM_OSCILLATORS> oscillators;
 
     // Oscillator parameters
     float osc1OctaveMultiplier = 1.0f;
@@ -648,6 +856,11 @@ private:
     float noiseLevel = 0.0f;
     uint32_t noiseState = 12345;
 
+    // Paraphonic oscillator gate (renderOscillators)
+    float gate = 1.0f;
+    float gateTarget = 1.0f;
+    float gateStep = 1.0f;
+
     // Filter
     LadderFilter filter;
     float filterCutoff = 5000.0f;
@@ -662,9 +875,27 @@ private:
 
     // LFO
     LFO lfo;
+    const float* sharedLfo = nullptr;  // The engine's per-control-block values (setSharedLFO)
+    const float* sharedNoise = nullptr;  // The engine's noise, this voice's lane, stride 4 (setSharedNoise)
+    int sharedLfoIndex = 0;
+    float lfoValue = 0.0f;         // LFO output at the end of the last control block
+    ControlRamp pitchRamp;         // LFO pitch ratio, ramped per control block
     float lfoPitchAmount = 0.0f;   // 0-1 range, 1.0 = 12 semitones
     float lfoFilterAmount = 0.0f;  // 0-1 range, 1.0 = 8000 Hz
 
+    // Drift (its wander continues from note to note, as a real oscillator's would)
+    AnalogDrift drift;
+    float driftAmount = 0.0f;      // 0-1 range
+    float driftSemitones = 0.0f;   // At the end of the last control block
+
+    // Expression (see setExpression)
+    float bendSemitones = 0.0f;
+    float expressionCutoff = 0.0f;  // Hz added by pressure and slide
+
+    // Polyphonic modulation (see setModulation)
+    float modCutoffHz = 0.0f;
+    float modResonance = 0.0f;
+
     // Envelope parameters
     float ampAttack = 0.01f;
     float ampDecay = 0.1f;
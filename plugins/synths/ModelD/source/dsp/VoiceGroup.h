@@ -0,0 +1,497 @@
+/**
+ * @file VoiceGroup.h
+ * @brief 4-wide SIMD renderer for groups of Model D voices
+ *
+ * The scalar Voice::render() processes one voice per loop. VoiceGroup packs
+ * up to four voices into the lanes of an SSE register (the same layout
+ * sst::filters::QuadFilterUnit uses for its filters) and runs the three
+ * oscillators, noise, mixer, ladder filter and VCA for all lanes at once.
+ * The ladder is one sst::filters vintage ladder call on a shared
+ * QuadFilterUnitState, with each lane's coefficients retargeted once per
+ * BLOCK_SIZE samples by that voice's FilterCoefficientMaker. Lanes on the
+ * same cutoff and resonance (a static filter, a paraphonic patch) share
+ * the target's maths through a cache kept for the call.
+ *
+ * The LFO (the voice's own or the engine's shared one) and filter envelope
+ * run at control rate in each voice (Voice::updateModulators), once per
+ * BLOCK_SIZE chunk; the pitch ratio (LFO and bend) is ramped across the
+ * chunk in SIMD. The amp envelopes run as one 4-lane recurrence into a
+ * block-sized buffer, stepping lane by lane only on the samples where a
+ * stage ends; everything per-sample after that is SIMD.
+ *
+ * Lane state is gathered from the voices at the start of each call and
+ * scattered back at the end, so voices can move between groups freely as
+ * they start and stop.
+ *
+ * @note Voice::render() remains the scalar reference implementation.
+ */
+
+#pragma once
+
+#include "Voice.h"
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/basic-blocks/mechanics/simd-ops.h"
+#include "sst/basic-blocks/dsp/FastMath.h"
+
+class VoiceGroup
+{
+public:
+    /** Voices per SIMD lane set */
+    static constexpr int LANES = 4;
+
+    /** Internal block size: one control block per chunk */
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
+
+    /**
+     * @brief Render up to four voices into the output buffers
+     *
+     * The first group of a block writes the mix bus (accumulate = false), so
+     * nothing has to clear it first; the rest add to it. The master gain is
+     * folded into each lane's gain, so there's no separate gain pass.
+     * @param lanes Voices to render (all must be active and share params)
+     * @param numLanes Number of valid entries in lanes (1-4)
+     * @param p Parameter snapshot the voices have applied
+     * @param outputL Left channel output buffer
+     * @param outputR Right channel output buffer
+     * @param numSamples Number of samples to render
+     * @param gain Applied on top of each voice's own level
+     * @param accumulate Add to the buffers (true) or overwrite them (false)
+     * @param noise The group's NoiseBlock::group(), four lanes per sample,
+     *              or nullptr for each voice's own generator
+     */
+    static void render(Voice* const* lanes, int numLanes, const VoiceParams& p,
+                       float* outputL, float* outputR, int numSamples,
+                       float gain = 1.0f, bool accumulate = true, const float* noise = nullptr)
+    {
+        Lanes st;
+        gather(st, lanes, numLanes, gain);
+
+        int offset = 0;
+        while (offset < numSamples)
+        {
+            const int n = std::min(numSamples - offset, BLOCK_SIZE);
+            renderChunk(st, lanes, numLanes, p, outputL + offset, outputR + offset, n, accumulate,
+                        noise != nullptr ? noise + LANES * offset : nullptr);
+            offset += n;
+        }
+
+        scatter(st, lanes, numLanes);
+    }
+
+private:
+    /** Per-lane DSP state carried across chunks */
+    struct alignas(16) Lanes
+    {
+        float phase[3][LANES]{};
+        float baseInc[3][LANES]{};    // Phase increment before pitch mod
+        float syncBlep[LANES]{};      // OSC2's pending half of a sync polyBLEP
+        uint32_t noise[LANES]{};
+        float gain[LANES]{};          // velocity * masterLevel * mix gain, 0 for unused lanes
+        bool finished[LANES]{};
+        LadderFilter::QuadState filter{};
+        LadderFilter::SharedCoefficients coefficients;  // Per call: no sharing across threads
+    };
+
+    static void gather(Lanes& st, Voice* const* lanes, int numLanes, float gain)
+    {
+        std::memset(&st.filter, 0, sizeof(st.filter));
+
+        for (int l = 0; l < LANES; ++l)
+        {
+            if (l >= numLanes)
+            {
+                // Unused lanes run silently; keep increments non-zero so the
+                // polyBLEP 1/dt stays finite
+                for (int o = 0; o < 3; ++o)
+                    st.baseInc[o][l] = 0.01f;
+                st.noise[l] = 12345;
+                continue;
+            }
+
+            const Voice& v = *lanes[l];
+            const float baseFreq = v.noteFrequency;
+            const float invSr = 1.0f / v.sampleRate;
+
+            st.baseInc[0][l] = baseFreq * v.osc1OctaveMultiplier * invSr;
+            st.baseInc[1][l] = baseFreq * v.osc2OctaveMultiplier * v.osc2Detune * invSr;
+            st.baseInc[2][l] = baseFreq * v.osc3OctaveMultiplier * v.osc3Detune * invSr;
+
+            for (int o = 0; o < 3; ++o)
+                st.phase[o][l] = v.oscillators[o].getLaneState().phase;
+            st.syncBlep[l] = v.oscillators[1].getLaneState().syncBlep;
+
+            v.filter.loadLane(st.filter, l);
+
+            st.noise[l] = v.noiseState;
+            st.gain[l] = v.velocity * v.masterLevel * gain;
+        }
+    }
+
+    static void scatter(const Lanes& st, Voice* const* lanes, int numLanes)
+    {
+        for (int l = 0; l < numLanes; ++l)
+        {
+            Voice& v = *lanes[l];
+
+            for (int o = 0; o < 3; ++o)
+                v.oscillators[o].setLaneState({st.phase[o][l], st.baseInc[o][l], o == 1 ? st.syncBlep[l] : 0.0f});
+
+            v.filter.storeLane(st.filter, l);
+
+            v.noiseState = st.noise[l];
+
+            if (st.finished[l])
+                v.active = false;
+        }
+    }
+
+    /**
+     * @brief Amp envelopes for one chunk, all lanes in one SIMD recurrence
+     *
+     * Each lane's envelope is an exponential segment, level * coeff +
+     * offset per sample, with the samples to its end known in advance. The
+     * lanes run together up to the first segment end, then that one sample
+     * is stepped lane by lane (landing the segment and planning the next),
+     * and the lanes run together again.
+     *
+     * Writes zero amp-envelope values once a lane's envelope finishes, which
+     * silences that lane in the SIMD loop without any per-sample masking.
+     */
+    static void renderAmpEnvelopes(Lanes& st, Voice* const* lanes, int numLanes, int n,
+                                   float (&ampEnv)[BLOCK_SIZE][LANES])
+    {
+        // Unused and finished lanes hold at zero
+        ADSREnvelope* env[LANES]{};
+        for (int l = 0; l < numLanes; ++l)
+            if (!st.finished[l])
+                env[l] = &lanes[l]->ampEnv;
+
+        int i = 0;
+        while (i < n)
+        {
+            alignas(16) float level[LANES]{};
+            alignas(16) float coeff[LANES] = {1.0f, 1.0f, 1.0f, 1.0f};
+            alignas(16) float offset[LANES]{};
+            int run = n - i;
+            for (int l = 0; l < LANES; ++l)
+            {
+                if (!env[l])
+                    continue;
+                level[l] = env[l]->getLevel();
+                coeff[l] = env[l]->getCoefficient();
+                offset[l] = env[l]->getOffset();
+                run = std::min(run, env[l]->getSegmentSamples());
+            }
+
+            auto x = SIMD_MM(load_ps)(level);
+            const auto c = SIMD_MM(load_ps)(coeff);
+            const auto o = SIMD_MM(load_ps)(offset);
+            for (int k = 0; k < run; ++k)
+            {
+                x = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(x, c), o);
+                SIMD_MM(store_ps)(ampEnv[i + k], x);
+            }
+            SIMD_MM(store_ps)(level, x);
+            i += run;
+
+            for (int l = 0; l < LANES; ++l)
+                if (env[l])
+                    env[l]->skip(run, level[l]);
+
+            if (i == n)
+                break;
+
+            // Some lane ends a segment on this sample
+            for (int l = 0; l < LANES; ++l)
+            {
+                ampEnv[i][l] = 0.0f;
+                if (!env[l])
+                    continue;
+
+                const float amp = env[l]->process();
+                if (!env[l]->isActive())
+                {
+                    st.finished[l] = true;
+                    env[l] = nullptr;
+                    continue;
+                }
+                ampEnv[i][l] = amp;
+            }
+            ++i;
+        }
+    }
+
+    /**
+     * @brief Control-rate update for the coming chunk
+     *
+     * Steps each lane's LFO and filter envelope with the same code as
+     * Voice::render(), retargets its ladder coefficients and loads its pitch
+     * ramp. Finished and unused lanes hold still: their coefficients stop
+     * gliding so they can't drift across a long block.
+     */
+    static void updateControl(Lanes& st, Voice* const* lanes, int numLanes, int n,
+                              float (&pitch)[LANES], float (&pitchInc)[LANES])
+    {
+        for (int l = 0; l < LANES; ++l)
+        {
+            pitch[l] = 1.0f;
+            pitchInc[l] = 0.0f;
+
+            if (l >= numLanes)
+                continue;
+
+            if (st.finished[l])
+            {
+                for (int c = 0; c < sst::filters::n_cm_coeffs; ++c)
+                    LadderFilter::setLane(st.filter.dC[c], l, 0.0f);
+                continue;
+            }
+
+            Voice& v = *lanes[l];
+            v.updateModulators(n);
+            v.filter.makeCoefficients(st.filter, l, st.coefficients);
+
+            // The SIMD loop runs the ramp itself; the next setTarget()
+            // starts from the target, so the voice's copy needn't step
+            pitch[l] = v.pitchRamp.getValue();
+            pitchInc[l] = v.pitchRamp.getIncrement();
+        }
+    }
+
+    //==========================================================================
+    // SIMD helpers
+    //==========================================================================
+
+    static SIMD_M128 blend(SIMD_M128 mask, SIMD_M128 a, SIMD_M128 b)
+    {
+        // mask ? a : b
+        return SIMD_MM(or_ps)(SIMD_MM(and_ps)(mask, a), SIMD_MM(andnot_ps)(mask, b));
+    }
+
+    /** Vector polyBLEP residual, matching PolyBlepOscillator::polyBlep */
+    static SIMD_M128 polyBlep(SIMD_M128 t, SIMD_M128 dt)
+    {
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto invDt = SIMD_MM(div_ps)(one, dt);
+
+        // t < dt: t/dt, then 2t - t^2 - 1
+        auto a = SIMD_MM(mul_ps)(t, invDt);
+        auto ra = SIMD_MM(sub_ps)(SIMD_MM(sub_ps)(SIMD_MM(add_ps)(a, a), SIMD_MM(mul_ps)(a, a)), one);
+
+        // t > 1 - dt: (t - 1)/dt, then t^2 + 2t + 1
+        auto b = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(t, one), invDt);
+        auto rb = SIMD_MM(add_ps)(SIMD_MM(add_ps)(SIMD_MM(mul_ps)(b, b), SIMD_MM(add_ps)(b, b)), one);
+
+        auto maskA = SIMD_MM(cmplt_ps)(t, dt);
+        auto maskB = SIMD_MM(cmpgt_ps)(t, SIMD_MM(sub_ps)(one, dt));
+
+        return SIMD_MM(or_ps)(SIMD_MM(and_ps)(maskA, ra),
+                              SIMD_MM(and_ps)(SIMD_MM(andnot_ps)(maskA, maskB), rb));
+    }
+
+    /** One oscillator sample for four lanes, matching PolyBlepOscillator::process */
+    static SIMD_M128 oscillator(PolyBlepOscillator::Waveform wf, SIMD_M128 phase, SIMD_M128 inc,
+                                SIMD_M128 pulseWidth)
+    {
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto two = SIMD_MM(set1_ps)(2.0f);
+
+        switch (wf)
+        {
+        case PolyBlepOscillator::Waveform::Saw:
+            return SIMD_MM(sub_ps)(SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, phase), one),
+                                   polyBlep(phase, inc));
+
+        case PolyBlepOscillator::Waveform::Triangle:
+        {
+            const auto four = SIMD_MM(set1_ps)(4.0f);
+            auto up = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(four, phase), one);
+            auto down = SIMD_MM(sub_ps)(SIMD_MM(set1_ps)(3.0f), SIMD_MM(mul_ps)(four, phase));
+            return blend(SIMD_MM(cmplt_ps)(phase, SIMD_MM(set1_ps)(0.5f)), up, down);
+        }
+
+        case PolyBlepOscillator::Waveform::Pulse:
+        {
+            auto out = blend(SIMD_MM(cmplt_ps)(phase, pulseWidth), one, SIMD_MM(set1_ps)(-1.0f));
+            out = SIMD_MM(add_ps)(out, polyBlep(phase, inc));
+
+            // fmod(phase + 1 - pw, 1) for phase in [0,1) and pw in [0.1,0.9]
+            auto shifted = SIMD_MM(sub_ps)(SIMD_MM(add_ps)(phase, one), pulseWidth);
+            shifted = SIMD_MM(sub_ps)(shifted, SIMD_MM(and_ps)(SIMD_MM(cmpge_ps)(shifted, one), one));
+            return SIMD_MM(sub_ps)(out, polyBlep(shifted, inc));
+        }
+
+        case PolyBlepOscillator::Waveform::Sine:
+        default:
+        {
+            // sin(2*pi*p) == -sin(2*pi*p - pi), and the argument stays in [-pi, pi)
+            auto x = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(TWO_PI), phase),
+                                     SIMD_MM(set1_ps)(PI));
+            return SIMD_MM(sub_ps)(SIMD_MM(setzero_ps)(),
+                                   sst::basic_blocks::dsp::fastsinSSE(x));
+        }
+        }
+    }
+
+    /** The waveform at each lane's phase before any polyBLEP, matching PolyBlepOscillator::naive */
+    static SIMD_M128 naive(PolyBlepOscillator::Waveform wf, SIMD_M128 phase, SIMD_M128 pulseWidth)
+    {
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+
+        switch (wf)
+        {
+        case PolyBlepOscillator::Waveform::Saw:
+            return SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(2.0f), phase), one);
+
+        case PolyBlepOscillator::Waveform::Pulse:
+            return blend(SIMD_MM(cmplt_ps)(phase, pulseWidth), one, SIMD_MM(set1_ps)(-1.0f));
+
+        default:
+            // Triangle and sine have no polyBLEP
+            return oscillator(wf, phase, one, pulseWidth);
+        }
+    }
+
+    static SIMD_M128 advance(SIMD_M128 phase, SIMD_M128 inc)
+    {
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        phase = SIMD_MM(add_ps)(phase, inc);
+        return SIMD_MM(sub_ps)(phase, SIMD_MM(and_ps)(SIMD_MM(cmpge_ps)(phase, one), one));
+    }
+
+    /** White noise for four lanes, same LCG as Voice::noise (voices rendered without a NoiseBlock) */
+    static SIMD_M128 noise(uint32_t (&state)[LANES])
+    {
+        alignas(16) float out[LANES];
+        for (int l = 0; l < LANES; ++l)
+        {
+            state[l] = state[l] * 1664525u + 1013904223u;
+            out[l] = (static_cast<float>(state[l]) / 2147483648.0f) - 1.0f;
+        }
+        return SIMD_MM(load_ps)(out);
+    }
+
+    //==========================================================================
+    // Main kernel
+    //==========================================================================
+
+    static void renderChunk(Lanes& st, Voice* const* lanes, int numLanes, const VoiceParams& p,
+                            float* outputL, float* outputR, int n, bool accumulate, const float* sharedNoise)
+    {
+        alignas(16) float ampEnv[BLOCK_SIZE][LANES];
+        alignas(16) float pitch[LANES];
+        alignas(16) float pitchInc[LANES];
+        renderAmpEnvelopes(st, lanes, numLanes, n, ampEnv);
+        updateControl(st, lanes, numLanes, n, pitch, pitchInc);
+
+        const auto wf1 = static_cast<PolyBlepOscillator::Waveform>(p.osc1Waveform);
+        const auto wf2 = static_cast<PolyBlepOscillator::Waveform>(p.osc2Waveform);
+        const auto wf3 = static_cast<PolyBlepOscillator::Waveform>(p.osc3Waveform);
+
+        // Oscillators use their default 0.5 pulse width in Model D
+        const auto pw = SIMD_MM(set1_ps)(0.5f);
+        const auto zero = SIMD_MM(setzero_ps)();
+
+        // LFO or bend on any lane (an unbent, unmodulated chunk skips the multiplies)
+        bool usePitchMod = false;
+        for (int l = 0; l < LANES; ++l)
+            usePitchMod = usePitchMod || pitch[l] != 1.0f || pitchInc[l] != 0.0f;
+        const bool useNoise = p.noiseLevel != 0.0f;
+        const bool sync = p.osc2Sync;
+
+        // OSC2 at the start of its cycle, and the edge its polyBLEP smooths there
+        const auto start2 = naive(wf2, zero, pw);
+        const float edge2 = wf2 == PolyBlepOscillator::Waveform::Saw ? -2.0f
+                          : wf2 == PolyBlepOscillator::Waveform::Pulse ? 2.0f : 0.0f;
+        const auto edgeAtZero2 = SIMD_MM(set1_ps)(edge2);
+        const auto half = SIMD_MM(set1_ps)(0.5f);
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+
+        const auto lvl1 = SIMD_MM(set1_ps)(p.osc1Level);
+        const auto lvl2 = SIMD_MM(set1_ps)(p.osc2Level);
+        const auto lvl3 = SIMD_MM(set1_ps)(p.osc3Level);
+        const auto lvlN = SIMD_MM(set1_ps)(p.noiseLevel);
+        auto pm = SIMD_MM(load_ps)(pitch);
+        const auto dpm = SIMD_MM(load_ps)(pitchInc);
+
+        auto ph1 = SIMD_MM(load_ps)(st.phase[0]);
+        auto ph2 = SIMD_MM(load_ps)(st.phase[1]);
+        auto ph3 = SIMD_MM(load_ps)(st.phase[2]);
+        auto blep2 = SIMD_MM(load_ps)(st.syncBlep);
+        const auto inc1 = SIMD_MM(load_ps)(st.baseInc[0]);
+        const auto inc2 = SIMD_MM(load_ps)(st.baseInc[1]);
+        const auto inc3 = SIMD_MM(load_ps)(st.baseInc[2]);
+        const auto gain = SIMD_MM(load_ps)(st.gain);
+
+        for (int i = 0; i < n; ++i)
+        {
+            // LFO pitch modulation and bend, ramped across the chunk
+            auto m1 = inc1, m2 = inc2, m3 = inc3;
+            if (usePitchMod)
+            {
+                m1 = SIMD_MM(mul_ps)(inc1, pm);
+                m2 = SIMD_MM(mul_ps)(inc2, pm);
+                m3 = SIMD_MM(mul_ps)(inc3, pm);
+                pm = SIMD_MM(add_ps)(pm, dpm);
+            }
+
+            auto o1 = oscillator(wf1, ph1, m1, pw);
+            auto o2 = SIMD_MM(add_ps)(oscillator(wf2, ph2, m2, pw), blep2);
+            auto o3 = oscillator(wf3, ph3, m3, pw);
+            blep2 = zero;
+
+            ph1 = advance(ph1, m1);
+            ph2 = advance(ph2, m2);
+            ph3 = advance(ph3, m3);
+
+            // OSC2 hard sync to OSC1, as PolyBlepOscillator::sync() (unused lanes' increments aren't 0)
+            if (sync)
+            {
+                const auto wrapped = SIMD_MM(cmplt_ps)(ph1, m1);
+                const auto after = SIMD_MM(div_ps)(ph1, m1);
+                auto before = SIMD_MM(sub_ps)(ph2, SIMD_MM(mul_ps)(m2, after));
+                before = SIMD_MM(add_ps)(before, SIMD_MM(and_ps)(SIMD_MM(cmplt_ps)(before, zero), one));
+
+                const auto jump = SIMD_MM(sub_ps)(start2, naive(wf2, before, pw));
+                const auto tail = SIMD_MM(sub_ps)(one, after);
+                const auto now = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(half, jump), SIMD_MM(mul_ps)(after, after));
+                const auto next = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(half, SIMD_MM(sub_ps)(edgeAtZero2, jump)),
+                                                  SIMD_MM(mul_ps)(tail, tail));
+
+                o2 = SIMD_MM(add_ps)(o2, SIMD_MM(and_ps)(wrapped, now));
+                blep2 = SIMD_MM(and_ps)(wrapped, next);
+                ph2 = blend(wrapped, SIMD_MM(mul_ps)(m2, after), ph2);
+            }
+
+            auto mix = SIMD_MM(add_ps)(SIMD_MM(add_ps)(SIMD_MM(mul_ps)(o1, lvl1),
+                                                       SIMD_MM(mul_ps)(o2, lvl2)),
+                                       SIMD_MM(mul_ps)(o3, lvl3));
+            if (useNoise)
+            {
+                const auto white = sharedNoise != nullptr ? SIMD_MM(load_ps)(sharedNoise + LANES * i) : noise(st.noise);
+                mix = SIMD_MM(add_ps)(mix, SIMD_MM(mul_ps)(white, lvlN));
+            }
+
+            auto filtered = LadderFilter::processQuad(&st.filter, mix);
+
+            auto out = SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(filtered, SIMD_MM(load_ps)(ampEnv[i])), gain);
+            const float sum = sst::basic_blocks::mechanics::sum_ps_to_float(out);
+            if (accumulate)
+            {
+                outputL[i] += sum;
+                outputR[i] += sum;
+            }
+            else
+            {
+                outputL[i] = sum;
+                outputR[i] = sum;
+            }
+        }
+
+        SIMD_MM(store_ps)(st.phase[0], ph1);
+        SIMD_MM(store_ps)(st.phase[1], ph2);
+        SIMD_MM(store_ps)(st.phase[2], ph3);
+        SIMD_MM(store_ps)(st.syncBlep, blep2);
+    }
+};
@@ -0,0 +1,353 @@
+/**
+ * @file VoiceThreadPool.h
+ * @brief Real-time-safe worker pool for rendering voice groups in parallel
+ *
+ * The engine renders its active voices as a list of independent tasks (one
+ * per VoiceGroup). With a pool started, those tasks are shared between the
+ * audio thread and a few pre-spawned workers:
+ *
+ * - Tasks are dealt out in contiguous slices, one per thread. Each thread
+ *   pops from its own slice and, once that runs dry, steals from the
+ *   others. Owner and thieves claim a task with the same fetch_add on the
+ *   slice's cursor, so there are no locks and no task runs twice.
+ * - Every thread accumulates into its own mix buffer. The audio thread
+ *   renders straight into the engine's buffers and adds the workers'
+ *   buffers in afterwards, in a fixed order.
+ * - Workers spin briefly after each job, then sleep on their own atomic
+ *   ticket. Waking one is a notify, so the audio thread never blocks on a
+ *   lock; it only spins while the last tasks it couldn't steal finish.
+ *
+ * run() only touches preallocated state. start() and stop() allocate and
+ * create or join threads, so they belong in prepare(), not the audio thread.
+ *
+ * A pool per engine puts a set of workers in every instance, and a host
+ * running ten of them would oversubscribe the CPU ten times over. shared()
+ * hands every engine in the process the same pool, one worker per core
+ * and started by the first engine to ask; it stops when the last one lets
+ * go. One job runs at a time: an engine whose run() finds the pool busy
+ * with another instance's block renders its own tasks on its own thread
+ * instead of waiting, so the host's audio threads and the workers between
+ * them keep every core busy without blocking one another.
+ *
+ * Waking workers costs a few microseconds, so the caller should fall back
+ * to serial rendering for small jobs (see worthSplitting()).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define VOICE_POOL_HAS_MXCSR 1
+#endif
+
+class VoiceThreadPool
+{
+public:
+    /** Most threads a job is split across, including the audio thread */
+    static constexpr int MAX_THREADS = 8;
+
+    /** Fewer samples than this are rendered serially */
+    static constexpr int MIN_PARALLEL_SAMPLES = 64;
+
+    /** Fewer tasks than this are rendered serially */
+    static constexpr int MIN_PARALLEL_TASKS = 2;
+
+    /** Largest block the shared pool splits; longer ones are rendered serially */
+    static constexpr int SHARED_MAX_SAMPLES = 4096;
+
+    /**
+     * @brief Render one task, adding into the thread's mix buffers
+     * @param context Pointer passed to run()
+     * @param task Task index (0 to numTasks - 1)
+     */
+    using TaskFn = void (*)(void* context, int task, float* mixL, float* mixR, int numSamples);
+
+    VoiceThreadPool() = default;
+    ~VoiceThreadPool() { stop(); }
+
+    VoiceThreadPool(const VoiceThreadPool&) = delete;
+    VoiceThreadPool& operator=(const VoiceThreadPool&) = delete;
+
+    /**
+     * @brief Spawn numThreads - 1 workers (1 or less = serial, no threads)
+     *
+     * Capped at the hardware thread count: a worker sharing a core with
+     * the audio thread only makes the block later.
+     * @param maxSamples Largest numSamples run() will be given
+     * @note Not real-time safe; stops any workers already running
+     */
+    void start(int numThreads, int maxSamples)
+    {
+        stop();
+
+        const int cores = static_cast<int>(std::thread::hardware_concurrency());
+        numThreads = std::clamp(numThreads, 1, cores > 0 ? std::min(cores, MAX_THREADS) : MAX_THREADS);
+        if (numThreads == 1)
+            return;
+
+        quit.store(false, std::memory_order_relaxed);
+        workers.reserve(static_cast<size_t>(numThreads - 1));
+
+        maxSamples = std::max(maxSamples, 0);
+        capacity = maxSamples;
+        for (int i = 0; i < numThreads - 1; ++i)
+        {
+            auto w = std::make_unique<Worker>();
+            w->mixL.assign(static_cast<size_t>(maxSamples), 0.0f);
+            w->mixR.assign(static_cast<size_t>(maxSamples), 0.0f);
+            workers.push_back(std::move(w));
+        }
+
+        // Only start threads once the vector stops moving
+        for (int i = 0; i < numThreads - 1; ++i)
+            workers[static_cast<size_t>(i)]->thread = std::thread([this, i] { workerLoop(i); });
+    }
+
+    /**
+     * @brief The process's pool, started on first use with a thread per core
+     *
+     * Every caller gets the same pool until the last reference is dropped,
+     * which stops it.
+     * @note Not real-time safe: may start or (dropping it) join threads
+     */
+    static std::shared_ptr<VoiceThreadPool> shared()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<VoiceThreadPool> current;
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<VoiceThreadPool> pool = current.lock();
+        if (!pool)
+        {
+            pool = std::make_shared<VoiceThreadPool>();
+            pool->start(MAX_THREADS, SHARED_MAX_SAMPLES);
+            current = pool;
+        }
+        return pool;
+    }
+
+    /** Join the workers; run() is serial afterwards */
+    void stop()
+    {
+        if (workers.empty())
+            return;
+
+        quit.store(true, std::memory_order_release);
+        for (auto& w : workers)
+        {
+            w->ticket.fetch_add(1, std::memory_order_release);
+            w->ticket.notify_one();
+        }
+        for (auto& w : workers)
+            w->thread.join();
+
+        workers.clear();
+    }
+
+    /** Threads a job can use, including the audio thread */
+    int getNumThreads() const { return static_cast<int>(workers.size()) + 1; }
+
+    /** Bytes start() allocated: the workers and their mix buffers (stacks not counted) */
+    size_t getHeapBytes() const
+    {
+        size_t bytes = workers.capacity() * sizeof(workers[0]);
+        for (const auto& w : workers)
+            bytes += sizeof(Worker) + (w->mixL.capacity() + w->mixR.capacity()) * sizeof(float);
+        return bytes;
+    }
+
+    /** True if a job this size is worth waking the workers for (and fits their buffers) */
+    bool worthSplitting(int numTasks, int numSamples) const
+    {
+        return !workers.empty() && numTasks >= MIN_PARALLEL_TASKS && numSamples >= MIN_PARALLEL_SAMPLES
+            && numSamples <= capacity;
+    }
+
+    /**
+     * @brief Run numTasks tasks across the pool and sum them into mixL/mixR
+     *
+     * The calling thread takes part and returns once every task has been
+     * rendered and added in. mixL/mixR are added to, not cleared. If
+     * another thread's job holds the pool, the caller renders every task
+     * itself.
+     * @param maxThreads Most threads this job may use, the caller's included
+     */
+    void run(TaskFn fn, void* context, int numTasks, float* mixL, float* mixR, int numSamples,
+             int maxThreads = MAX_THREADS)
+    {
+        if (busy.test_and_set(std::memory_order_acquire))
+        {
+            for (int task = 0; task < numTasks; ++task)
+                fn(context, task, mixL, mixR, numSamples);
+            return;
+        }
+
+        const int numThreads = std::clamp(std::min(getNumThreads(), numTasks), 1, std::max(maxThreads, 1));
+
+        job.fn = fn;
+        job.context = context;
+        job.numSamples = numSamples;
+        job.numThreads = numThreads;
+#ifdef VOICE_POOL_HAS_MXCSR
+        job.mxcsr = _mm_getcsr();  // Workers copy the host's denormal mode
+#endif
+
+        for (int t = 0; t < numThreads; ++t)
+        {
+            slices[static_cast<size_t>(t)].next.store(t * numTasks / numThreads, std::memory_order_relaxed);
+            slices[static_cast<size_t>(t)].end = (t + 1) * numTasks / numThreads;
+        }
+
+        pending.store(numThreads - 1, std::memory_order_relaxed);
+
+        for (int w = 0; w < numThreads - 1; ++w)
+        {
+            Worker& worker = *workers[static_cast<size_t>(w)];
+            worker.ticket.fetch_add(1, std::memory_order_release);
+            worker.ticket.notify_one();
+        }
+
+        work(0, mixL, mixR);
+
+        // Stragglers are mid-task; stop hogging the core if one was preempted
+        for (int spin = 0; pending.load(std::memory_order_acquire) > 0; ++spin)
+        {
+            if (spin < SPIN_COUNT)
+                pause();
+            else
+                std::this_thread::yield();
+        }
+
+        for (int w = 0; w < numThreads - 1; ++w)
+        {
+            const Worker& worker = *workers[static_cast<size_t>(w)];
+            if (!worker.used)
+                continue;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                mixL[i] += worker.mixL[static_cast<size_t>(i)];
+                mixR[i] += worker.mixR[static_cast<size_t>(i)];
+            }
+        }
+
+        busy.clear(std::memory_order_release);
+    }
+
+private:
+    /** Pause loops (tens of microseconds) before a worker sleeps or the audio thread yields */
+    static constexpr int SPIN_COUNT = 4096;
+
+    struct Job
+    {
+        TaskFn fn = nullptr;
+        void* context = nullptr;
+        int numSamples = 0;
+        int numThreads = 0;
+        unsigned int mxcsr = 0;
+    };
+
+    /** One thread's share of the tasks; thieves claim from the same cursor */
+    struct alignas(64) Slice
+    {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    struct Worker
+    {
+        std::thread thread;
+        alignas(64) std::atomic<uint32_t> ticket{0};
+        bool used = false;  // Rendered at least one task this job
+        std::vector<float> mixL, mixR;
+    };
+
+    static void pause()
+    {
+#ifdef VOICE_POOL_HAS_MXCSR
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    /** Claim a task: own slice first, then steal from the others in turn */
+    int claim(int self)
+    {
+        for (int k = 0; k < job.numThreads; ++k)
+        {
+            Slice& s = slices[static_cast<size_t>((self + k) % job.numThreads)];
+            if (s.next.load(std::memory_order_relaxed) >= s.end)
+                continue;
+            const int task = s.next.fetch_add(1, std::memory_order_relaxed);
+            if (task < s.end)
+                return task;
+        }
+        return -1;
+    }
+
+    /** Render tasks until none are left; returns true if any were ours */
+    bool work(int self, float* mixL, float* mixR)
+    {
+        bool any = false;
+        for (int task = claim(self); task >= 0; task = claim(self))
+        {
+            job.fn(job.context, task, mixL, mixR, job.numSamples);
+            any = true;
+        }
+        return any;
+    }
+
+    void workerLoop(int index)
+    {
+        Worker& w = *workers[static_cast<size_t>(index)];
+        uint32_t seen = 0;
+
+        for (;;)
+        {
+            // Spin a little in case the next block follows closely, then sleep
+            uint32_t ticket = w.ticket.load(std::memory_order_acquire);
+            for (int spin = 0; ticket == seen && spin < SPIN_COUNT; ++spin)
+            {
+                pause();
+                ticket = w.ticket.load(std::memory_order_acquire);
+            }
+            while (ticket == seen)
+            {
+                w.ticket.wait(seen, std::memory_order_acquire);
+                ticket = w.ticket.load(std::memory_order_acquire);
+            }
+            seen = ticket;
+
+            if (quit.load(std::memory_order_acquire))
+                return;
+
+#ifdef VOICE_POOL_HAS_MXCSR
+            if (_mm_getcsr() != job.mxcsr)
+                _mm_setcsr(job.mxcsr);
+#endif
+            const int n = job.numSamples;
+            std::fill(w.mixL.begin(), w.mixL.begin() + n, 0.0f);
+            std::fill(w.mixR.begin(), w.mixR.begin() + n, 0.0f);
+            w.used = work(index + 1, w.mixL.data(), w.mixR.data());
+
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::array<Slice, MAX_THREADS> slices{};
+    Job job;
+    std::atomic<int> pending{0};
+    std::atomic<bool> quit{false};
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;  // A job is running: other callers render alone
+    int capacity = 0;                          // Samples each worker's mix buffer holds
+};
@@ -5,17 +5,40 @@
  * Tests:
  * - Engine initialization
  * - Polyphony and voice allocation
- * - Voice stealing
+ * - Voice stealing and the allocator's steal policies
  * - Audio output
  * - Parameter routing
+ * - Per-channel (MPE) expression
+ * - Global and per-voice LFO
+ * - Paraphonic mode
+ * - Analog drift
  */
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../source/dsp/SynthEngine.h"
+#include "ScopeFifo.h"
+#include "EditorRefresh.h"
+#include "SpectrumAnalyzer.h"
+#include "GoldenRender.h"
+#include "OverrunLog.h"
+#include "ParamChangeFlags.h"
+#include "PresetAudition.h"
+#include "PresetMorph.h"
+#include "RealtimeGuard.h"
+#include "StatePublisher.h"
+#include "TuningTable.h"
 
 using Catch::Approx;
 
@@ -132,6 +155,117 @@ TEST_CASE("SynthEngine voice stealing", "[engine][voices]")
     }
 }
 
+TEST_CASE("VoiceAllocator steals by policy", "[engine][voices]")
+{
+    using Allocator = VoiceAllocator<4>;
+    Allocator alloc;
+    std::array<float, 4> levels{};
+    auto levelOf = [&](int v) { return levels[static_cast<size_t>(v)]; };
+    auto noRelease = [](int) {};
+
+    SECTION("Free voices first, then the oldest released, then the oldest held")
+    {
+        for (int n = 0; n < 4; ++n)
+            REQUIRE_FALSE(alloc.noteOn(60 + n, levelOf).stolen);
+
+        alloc.noteOff(62, noRelease);
+        auto a = alloc.noteOn(70, levelOf);
+        REQUIRE(a.stolen);
+        REQUIRE(a.voice == 2);
+
+        a = alloc.noteOn(71, levelOf);
+        REQUIRE(a.voice == 0);
+        REQUIRE(alloc.voiceForNote(60) == -1);
+    }
+
+    SECTION("A finished voice is reused without stealing")
+    {
+        for (int n = 0; n < 4; ++n)
+            alloc.noteOn(60 + n, levelOf);
+        alloc.noteOff(61, noRelease);
+        alloc.voiceFinished(1);
+        alloc.voiceFinished(1);  // Twice is harmless
+
+        auto a = alloc.noteOn(72, levelOf);
+        REQUIRE_FALSE(a.stolen);
+        REQUIRE(a.voice == 1);
+    }
+
+    SECTION("Quietest takes the lowest level")
+    {
+        alloc.setStealPolicy(Allocator::StealPolicy::Quietest);
+        for (int n = 0; n < 4; ++n)
+            alloc.noteOn(60 + n, levelOf);
+        levels = {0.9f, 0.8f, 0.1f, 0.7f};
+        REQUIRE(alloc.noteOn(70, levelOf).voice == 2);
+    }
+
+    SECTION("Same Note retriggers the note's voice even with voices free")
+    {
+        alloc.setStealPolicy(Allocator::StealPolicy::SameNote);
+        const int first = alloc.noteOn(60, levelOf).voice;
+        auto a = alloc.noteOn(60, levelOf);
+        REQUIRE(a.stolen);
+        REQUIRE(a.voice == first);
+
+        int released = 0;
+        alloc.noteOff(60, [&](int) { ++released; });
+        REQUIRE(released == 1);
+        REQUIRE_FALSE(alloc.isHeld(first));
+    }
+}
+
+TEST_CASE("SynthEngine applies per-channel expression", "[engine][mpe]")
+{
+    constexpr int N = 2048;
+
+    // Render one note on its own engine, after setup(engine)
+    auto renderNote = [](int note, int channel, auto setup)
+    {
+        std::vector<float> left(N, 0.0f), right(N, 0.0f);
+        SynthEngine engine;
+        engine.prepare(48000.0, N);
+        setup(engine);
+        engine.noteOn(note, 0.8f, 0, channel);
+        engine.renderBlock(left.data(), right.data(), N);
+        return left;
+    };
+    auto none = [](SynthEngine&) {};
+    auto maxDifference = [](const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float d = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            d = std::max(d, std::abs(a[i] - b[i]));
+        return d;
+    };
+
+    const auto reference = renderNote(69, 0, none);
+
+    SECTION("An MPE note follows its own channel's bend")
+    {
+        // +12 of the note channels' 48 semitones
+        auto bent = renderNote(57, 3, [](SynthEngine& e) { e.setMpe(true); e.setPitchBend(0.25f, 0, 3); });
+        REQUIRE(maxDifference(bent, reference) < 1e-3f);
+
+        auto other = renderNote(69, 3, [](SynthEngine& e) { e.setMpe(true); e.setPitchBend(0.25f, 0, 4); });
+        REQUIRE(maxDifference(other, reference) < 1e-6f);
+    }
+
+    SECTION("With MPE off every channel bends every note")
+    {
+        // Full bend is 2 semitones
+        auto bent = renderNote(67, 5, [](SynthEngine& e) { e.setPitchBend(1.0f, 0, 9); });
+        REQUIRE(maxDifference(bent, reference) < 1e-3f);
+    }
+
+    SECTION("Pressure opens the filter")
+    {
+        auto closed = [](SynthEngine& e) { e.setFilterCutoff(300.0f); e.setFilterEnvAmount(0.0f); };
+        auto pressed = [&](SynthEngine& e) { closed(e); e.setPressure(1.0f); };
+        REQUIRE(calculateRMS(renderNote(45, 0, pressed).data(), N) > 1.2f * calculateRMS(renderNote(45, 0, closed).data(), N));
+    }
+}
+
 TEST_CASE("SynthEngine audio rendering", "[engine][audio]")
 {
     SynthEngine engine;
@@ -298,6 +432,237 @@ TEST_CASE("SynthEngine parameter update", "[engine][params]")
     }
 }
 
+TEST_CASE("SynthEngine parameter revision", "[engine][params]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 512);
+
+    SECTION("Setting an unchanged value does not bump the revision")
+    {
+        engine.setOsc2Detune(7.0f);
+        const auto revision = engine.getParamRevision();
+
+        engine.setOsc2Detune(7.0f);
+        engine.setAmpEnvelope(0.01f, 0.1f, 0.7f, 0.3f);  // Defaults
+        REQUIRE(engine.getParamRevision() == revision);
+    }
+
+    SECTION("Changing a value bumps the revision")
+    {
+        const auto revision = engine.getParamRevision();
+        engine.setOsc3Octave(1);
+        REQUIRE(engine.getParamRevision() != revision);
+    }
+
+    SECTION("Changes made while idle reach newly triggered voices")
+    {
+        constexpr int bufferSize = 512;
+        std::array<float, bufferSize> leftBuffer{};
+        std::array<float, bufferSize> rightBuffer{};
+
+        engine.setOsc1Level(0.0f);
+        engine.setOsc2Level(0.0f);
+        engine.setOsc3Level(0.0f);
+
+        engine.noteOn(60, 1.0f);
+        engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        REQUIRE(isBufferSilent(leftBuffer.data(), bufferSize));
+    }
+}
+
+TEST_CASE("SynthEngine sample-accurate MIDI", "[engine][midi]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 1024);
+
+    constexpr int bufferSize = 1024;
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    SECTION("Note on with an offset is deferred to that sample")
+    {
+        engine.noteOn(60, 1.0f, 600);
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+
+        engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+
+        REQUIRE(engine.getActiveVoiceCount() == 1);
+        REQUIRE(isBufferSilent(leftBuffer.data(), 600));
+        REQUIRE_FALSE(isBufferSilent(leftBuffer.data() + 600, bufferSize - 600));
+    }
+
+    SECTION("Events closer than the minimum sub-block are applied together")
+    {
+        engine.noteOn(60, 1.0f, 100);
+        engine.noteOn(64, 1.0f, 100 + MidiEventQueue::MIN_SUB_BLOCK / 2);
+
+        engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+        REQUIRE(isBufferSilent(leftBuffer.data(), 100));
+        REQUIRE(isBufferValid(leftBuffer.data(), bufferSize));
+    }
+
+    SECTION("Events in the last minimum sub-block stay inside the block")
+    {
+        MidiEventQueue queue;
+        queue.push({MidiEvent::Type::NoteOn, 500, 60, 1.0f});
+        queue.push({MidiEvent::Type::NoteOn, 510, 64, 1.0f});
+
+        int rendered = 0;
+        int applied = 0;
+        queue.process(512,
+            [&](int start, int count) {
+                REQUIRE(start == rendered);
+                REQUIRE(count > 0);
+                REQUIRE(start + count <= 512);
+                rendered += count;
+            },
+            [&](const MidiEvent&) { ++applied; });
+
+        REQUIRE(rendered == 512);
+        REQUIRE(applied == 2);
+    }
+
+    SECTION("Offset note off releases within the same block")
+    {
+        engine.setAmpEnvelope(0.001f, 0.1f, 1.0f, 0.001f);
+        engine.noteOn(60, 1.0f);
+        engine.noteOff(60, 200);
+
+        engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+        REQUIRE_FALSE(isBufferSilent(leftBuffer.data(), 200));
+        REQUIRE(isBufferSilent(leftBuffer.data() + 400, bufferSize - 400));
+    }
+}
+
+TEST_CASE("SynthEngine host events: parameters, note expression, polyphonic modulation", "[engine][midi]")
+{
+    constexpr int bufferSize = 1024;
+
+    // Two chords rendered side by side, one of them with extra host events
+    auto render = [](SynthEngine& engine, std::array<float, bufferSize>& left)
+    {
+        std::array<float, bufferSize> right{};
+        engine.renderBlock(left.data(), right.data(), bufferSize);
+    };
+    auto start = [](SynthEngine& engine)
+    {
+        engine.prepare(48000.0, bufferSize);
+        engine.noteOn(60, 1.0f);
+        engine.noteOn(67, 1.0f);
+    };
+
+    SynthEngine reference;
+    SynthEngine engine;
+    std::array<float, bufferSize> expected{};
+    std::array<float, bufferSize> actual{};
+
+    SECTION("A parameter change lands on its sample")
+    {
+        start(reference);
+        start(engine);
+        engine.setParameter(kMasterVolume, -24.0f, 512);
+
+        render(reference, expected);
+        render(engine, actual);
+
+        REQUIRE(std::equal(actual.begin(), actual.begin() + 512, expected.begin()));
+        REQUIRE(std::abs(actual[700]) < std::abs(expected[700]));
+    }
+
+    SECTION("Polyphonic modulation only touches its note")
+    {
+        start(reference);
+        start(engine);
+        engine.setNoteModulation(72, kFilterCutoff, -4000.0f);  // Not playing
+        engine.setNoteModulation(60, kOsc1Level, -1.0f);        // Not modulatable
+
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE(actual == expected);
+
+        engine.setNoteModulation(67, kFilterCutoff, -4000.0f, 256);
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE(std::equal(actual.begin(), actual.begin() + 256, expected.begin()));
+        REQUIRE_FALSE(actual == expected);
+        REQUIRE(isBufferValid(actual.data(), bufferSize));
+    }
+
+    SECTION("Monophonic modulation reaches notes played later")
+    {
+        engine.setNoteModulation(-1, kFilterReso, 0.8f);
+        start(reference);
+        start(engine);
+
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE_FALSE(actual == expected);
+    }
+
+    SECTION("Note expression is per note and ends with the note")
+    {
+        start(reference);
+        start(engine);
+        engine.setNoteExpression(60, SynthEngine::NoteExpression::Tuning, 12.0f);
+
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE_FALSE(actual == expected);
+
+        // Retriggered voices start from the channel's expression again
+        for (auto* e : {&reference, &engine})
+        {
+            e->allNotesOff();
+            e->noteOn(60, 1.0f);
+        }
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Notes that stop sounding are reported with the host's IDs")
+    {
+        engine.prepare(48000.0, bufferSize);
+        engine.setParameter(kAmpRelease, 0.001f);
+        engine.addEvent({MidiEvent::Type::NoteOn, 0, 60, 1.0f, 2, 7});
+        engine.addEvent({MidiEvent::Type::NoteOn, 100, 64, 1.0f, 3, 8});
+        engine.noteOff(60, 200);
+        render(engine, actual);
+
+        REQUIRE(engine.getNumEndedNotes() == 1);
+        const auto& ended = engine.getEndedNote(0);
+        REQUIRE(ended.note == 60);
+        REQUIRE(ended.channel == 2);
+        REQUIRE(ended.noteId == 7);
+        REQUIRE(ended.sampleOffset > 200);
+        REQUIRE(ended.sampleOffset < bufferSize);
+
+        // Cut off: ended where the cut lands, still in time order
+        engine.clearEndedNotes();
+        engine.allNotesOff(300);
+        render(engine, actual);
+        REQUIRE(engine.getNumEndedNotes() == 1);
+        REQUIRE(engine.getEndedNote(0).noteId == 8);
+        REQUIRE(engine.getEndedNote(0).sampleOffset == 300);
+    }
+
+    SECTION("addEvent schedules any event type")
+    {
+        start(reference);
+        start(engine);
+        reference.setParameter(kMasterVolume, -24.0f, 300);
+        engine.addEvent({MidiEvent::Type::Param, 300, 0, -24.0f, 0, kMasterVolume});
+
+        render(reference, expected);
+        render(engine, actual);
+        REQUIRE(actual == expected);
+    }
+}
+
 TEST_CASE("SynthEngine polyphony", "[engine][poly]")
 {
     SynthEngine engine;
@@ -420,3 +785,1244 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         }
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+// ============================================================================
+// Oscilloscope FIFO
+// ============================================================================
+
+TEST_CASE("ScopeFifo hands the newest samples to the UI", "[scope]")
+{
+    ScopeFifo fifo;
+    std::array<float, 256> block{};
+    std::array<float, ScopeFifo::CAPACITY> out{};
+
+    SECTION("Empty FIFO pulls nothing")
+    {
+        REQUIRE(fifo.pullLatest(out.data(), 64) == 0);
+    }
+
+    SECTION("Pull returns the latest window, oldest first")
+    {
+        for (int i = 0; i < 256; ++i)
+            block[static_cast<size_t>(i)] = static_cast<float>(i);
+
+        REQUIRE(fifo.push(block.data(), 256) == 256);
+        REQUIRE(fifo.getNumReady() == 256);
+
+        REQUIRE(fifo.pullLatest(out.data(), 64) == 64);
+        REQUIRE(out[0] == 192.0f);
+        REQUIRE(out[63] == 255.0f);
+
+        // Older samples were discarded along with the pull
+        REQUIRE(fifo.getNumReady() == 0);
+    }
+
+    SECTION("A full FIFO drops new samples instead of blocking")
+    {
+        int written = 0;
+        for (int i = 0; i < 2 * ScopeFifo::CAPACITY / 256; ++i)
+            written += fifo.push(block.data(), 256);
+
+        REQUIRE(written == ScopeFifo::CAPACITY - 1);
+
+        // Draining makes room again
+        fifo.pullLatest(out.data(), 16);
+        REQUIRE(fifo.push(block.data(), 256) == 256);
+    }
+
+    SECTION("Indices wrap around the ring")
+    {
+        for (int n = 0; n < 100; ++n)
+        {
+            for (int i = 0; i < 256; ++i)
+                block[static_cast<size_t>(i)] = static_cast<float>(n * 256 + i);
+
+            fifo.push(block.data(), 256);
+            REQUIRE(fifo.pullLatest(out.data(), 8) == 8);
+            REQUIRE(out[7] == static_cast<float>(n * 256 + 255));
+        }
+    }
+}
+
+TEST_CASE("EditorRefresh ticks fast only while a live view is on screen", "[scope]")
+{
+    EditorRefresh refresh;
+    ScopeFifo fifo;
+
+    SECTION("Nothing is live until the editor shows")
+    {
+        REQUIRE_FALSE(fifo.hasConsumer());
+        refresh.setLiveViews(EditorRefresh::Scope);
+        REQUIRE(refresh.getRateHz() == EditorRefresh::HIDDEN_HZ);
+        REQUIRE_FALSE(refresh.wants(EditorRefresh::Scope));
+    }
+
+    SECTION("Showing, the rate follows the live views and the focus")
+    {
+        refresh.setWindow(true, true);
+        REQUIRE(refresh.getRateHz() == EditorRefresh::IDLE_HZ);
+
+        refresh.setLiveViews(EditorRefresh::viewFromName("scope") | EditorRefresh::viewFromName("sequencer"));
+        REQUIRE(refresh.getRateHz() == EditorRefresh::LIVE_HZ);
+        REQUIRE(refresh.wants(EditorRefresh::Scope));
+        REQUIRE_FALSE(refresh.wants(EditorRefresh::Spectrum));
+
+        refresh.setWindow(true, false);
+        REQUIRE(refresh.getRateHz() == EditorRefresh::BACKGROUND_HZ);
+
+        // Minimised: the scope is dropped until the window comes back
+        refresh.setWindow(false, false);
+        REQUIRE(refresh.getRateHz() == EditorRefresh::HIDDEN_HZ);
+        REQUIRE_FALSE(refresh.wants(EditorRefresh::Scope));
+    }
+
+    SECTION("Unknown view names are ignored")
+    {
+        refresh.setWindow(true, true);
+        refresh.setLiveViews(EditorRefresh::viewFromName("keyboard"));
+        REQUIRE(refresh.getRateHz() == EditorRefresh::IDLE_HZ);
+    }
+
+    SECTION("The scope FIFO follows its consumer")
+    {
+        fifo.setConsumerAttached(true);
+        REQUIRE(fifo.hasConsumer());
+        fifo.setConsumerAttached(false);
+        REQUIRE_FALSE(fifo.hasConsumer());
+    }
+}
+
+TEST_CASE("SpectrumAnalyzer puts a sine in its band", "[scope]")
+{
+    constexpr double SR = 48000.0;
+    constexpr double HZ = 43.0 * SR / SpectrumAnalyzer::FFT_SIZE;  // On a bin, about 1008 Hz
+
+    auto analyzer = std::make_unique<SpectrumAnalyzer>();
+    analyzer->prepare(SR);
+
+    std::vector<float> sine(SpectrumAnalyzer::FFT_SIZE);
+    for (size_t i = 0; i < sine.size(); ++i)
+        sine[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * HZ * static_cast<double>(i) / SR));
+
+    const auto bandOf = [](double hz) {
+        return static_cast<size_t>(std::log(hz / SpectrumAnalyzer::MIN_HZ)
+                                   / std::log(SpectrumAnalyzer::MAX_HZ / SpectrumAnalyzer::MIN_HZ)
+                                   * SpectrumAnalyzer::NUM_BANDS);
+    };
+
+    SECTION("Half scale reads -6 dB, far bands read nothing")
+    {
+        analyzer->push(sine.data(), static_cast<int>(sine.size()));
+        analyzer->analyze();
+
+        const auto& spectrum = analyzer->read();
+        REQUIRE(spectrum.frame == 1);
+        REQUIRE(spectrum.db[bandOf(HZ)] == Catch::Approx(-6.02f).margin(0.1f));
+        REQUIRE(spectrum.db[bandOf(100.0)] < -80.0f);
+        REQUIRE(spectrum.db[bandOf(10000.0)] < -80.0f);
+
+        // Nothing pushed since: no new frame
+        analyzer->analyze();
+        REQUIRE(analyzer->read().frame == 1);
+    }
+
+    SECTION("Analyses on its own thread once started")
+    {
+        analyzer->start(100.0);
+        for (int tries = 0; tries < 200 && analyzer->read().frame == 0; ++tries)
+        {
+            analyzer->push(sine.data(), static_cast<int>(sine.size()));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        analyzer->stop();
+
+        REQUIRE(analyzer->read().frame > 0);
+        REQUIRE(analyzer->read().db[bandOf(HZ)] > -12.0f);
+        REQUIRE_FALSE(analyzer->isRunning());
+    }
+}
+
+TEST_CASE("ParamChangeFlags coalesces changes between UI ticks", "[scope][params]")
+{
+    ParamChangeFlags flags;
+    std::vector<int> drained;
+    auto drain = [&] {
+        drained.clear();
+        return flags.drain([&](int index) { drained.push_back(index); });
+    };
+
+    SECTION("Nothing marked, nothing drained")
+    {
+        REQUIRE(drain() == 0);
+    }
+
+    SECTION("Repeated changes are sent once, in index order")
+    {
+        flags.mark(40);
+        flags.mark(3);
+        flags.mark(3);
+        flags.mark(ParamChangeFlags::CAPACITY - 1);
+        flags.mark(ParamChangeFlags::CAPACITY);  // Out of range: ignored
+
+        REQUIRE(drain() == 3);
+        REQUIRE(drained == std::vector<int>{3, 40, ParamChangeFlags::CAPACITY - 1});
+        REQUIRE(drain() == 0);
+    }
+
+    SECTION("Marks from another thread are not lost")
+    {
+        std::thread automation([&] {
+            for (int i = 0; i < 10000; ++i)
+                flags.mark(i % 48);
+        });
+        automation.join();
+
+        REQUIRE(drain() == 48);
+    }
+}
+
+TEST_CASE("PerfStats counts blocks, stages and voices", "[engine][perf]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 256);
+    engine.noteOn(60, 0.8f);
+    engine.noteOn(64, 0.8f);
+
+    std::vector<float> left(256), right(256);
+    for (int b = 0; b < 8; ++b)
+        engine.renderBlock(left.data(), right.data(), 256);
+
+    const auto stats = engine.getPerfStats().getSnapshot();
+    REQUIRE(stats.enabled == PerfStats::ENABLED);
+
+    if constexpr (PerfStats::ENABLED)
+    {
+        REQUIRE(stats.blocks == 8);
+        REQUIRE(stats.voiceHistogram[2] == 8);
+        REQUIRE(stats.stageCycles[PerfStats::Voices] > 0);
+        REQUIRE(stats.stageCycles[PerfStats::Voices] + stats.stageCycles[PerfStats::Master] <= stats.blockCycles);
+        REQUIRE(stats.worstBlockUs >= stats.lastBlockUs);
+    }
+    else
+    {
+        // Compiled out: nothing is counted
+        REQUIRE(stats.blocks == 0);
+    }
+}
+
+TEST_CASE("SynthEngine frees releasing voices under the cull threshold", "[engine][voices]")
+{
+    auto blocksToFree = [](float cullDb) {
+        SynthEngine engine;
+        engine.prepare(48000.0, 256);
+        engine.setAmpEnvelope(0.001f, 0.1f, 1.0f, 2.0f);
+        engine.setCullThreshold(cullDb);
+        REQUIRE(engine.getCullThreshold() == cullDb);
+
+        std::vector<float> left(256), right(256);
+        engine.noteOn(60, 0.8f);
+        for (int b = 0; b < 20; ++b)
+            engine.renderBlock(left.data(), right.data(), 256);
+
+        engine.noteOff(60);
+        int blocks = 0;
+        while (engine.getActiveVoiceCount() > 0 && blocks < 2000)
+        {
+            engine.renderBlock(left.data(), right.data(), 256);
+            ++blocks;
+        }
+        return blocks;
+    };
+
+    const int idle = blocksToFree(-std::numeric_limits<float>::infinity());
+    const int culled = blocksToFree(-30.0f);
+    const int byDefault = blocksToFree(-90.0f);
+
+    // 2 s of release is 375 blocks; -30 dB at the output comes well before its end
+    REQUIRE(idle > 350);
+    REQUIRE(culled < idle * 3 / 4);
+    REQUIRE(byDefault <= idle);
+}
+
+TEST_CASE("SynthEngine loads a whole preset through a fade", "[engine][params]")
+{
+    // Staged off the audio thread: every value set(), never update()d
+    auto patch = [](int waveform, float cutoff, float volumeDb) {
+        SynthParams p;
+        for (int i = 0; i < kNumParams; ++i)
+            p.set(i, 0.0f);
+        p.set(kOsc1Waveform, static_cast<float>(waveform));
+        p.set(kOsc1Level, 1.0f);
+        p.set(kFilterCutoff, cutoff);
+        p.set(kAmpAttack, 0.001f);
+        p.set(kAmpDecay, 0.1f);
+        p.set(kAmpSustain, 1.0f);
+        p.set(kAmpRelease, 0.3f);
+        p.set(kFilterAttack, 0.01f);
+        p.set(kFilterDecay, 0.1f);
+        p.set(kFilterRelease, 0.1f);
+        p.set(kLfoRate, 1.0f);
+        p.set(kMasterVolume, volumeDb);
+        return p;
+    };
+
+    const SynthParams bright = patch(0, 8000.0f, -6.0f);
+    const SynthParams dark = patch(3, 400.0f, -12.0f);
+
+    SynthEngine engine;
+    engine.prepare(48000.0, 512);
+    std::vector<float> left(512), right(512);
+
+    SECTION("With nothing sounding it goes in at once")
+    {
+        const uint32_t revision = engine.getParamRevision();
+        engine.loadPreset(dark);
+        REQUIRE_FALSE(engine.isLoadingPreset());
+        REQUIRE(engine.getParamRevision() != revision);
+    }
+
+    SECTION("Sounding voices dip to silence at the switch and come back")
+    {
+        engine.loadPreset(bright);
+        engine.noteOn(48, 1.0f);
+        for (int b = 0; b < 10; ++b)
+            engine.renderBlock(left.data(), right.data(), 512);
+
+        const uint32_t revision = engine.getParamRevision();
+        engine.loadPreset(dark);
+        REQUIRE(engine.isLoadingPreset());
+
+        std::vector<float> out;
+        for (int b = 0; b < 4; ++b)
+        {
+            engine.renderBlock(left.data(), right.data(), 512);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+
+        REQUIRE_FALSE(engine.isLoadingPreset());
+        REQUIRE(engine.getParamRevision() != revision);
+        REQUIRE(isBufferValid(out.data(), static_cast<int>(out.size())));
+
+        // 5 ms out (240 samples), 5 ms in: quiet either side of the switch,
+        // full level again after
+        const int fade = static_cast<int>(48000.0 * PresetFade::FADE_SECONDS);
+        for (int i = fade - 4; i < fade + 4; ++i)
+            REQUIRE(std::abs(out[static_cast<size_t>(i)]) < 0.05f);
+
+        float after = 0.0f;
+        for (size_t i = static_cast<size_t>(4 * fade); i < out.size(); ++i)
+            after = std::max(after, std::abs(out[i]));
+        REQUIRE(after > 0.05f);
+    }
+
+    SECTION("A newer preset during the fade takes the older one's place")
+    {
+        engine.loadPreset(bright);
+        engine.noteOn(48, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 512);
+
+        engine.loadPreset(dark);
+        engine.renderBlock(left.data(), right.data(), 64);
+        engine.loadPreset(bright);
+        for (int b = 0; b < 4; ++b)
+            engine.renderBlock(left.data(), right.data(), 512);
+
+        REQUIRE_FALSE(engine.isLoadingPreset());
+        REQUIRE(isBufferValid(left.data(), 512));
+    }
+}
+
+TEST_CASE("PresetAudition renders previews off the audio thread and caches them", "[engine][params]")
+{
+    auto patch = [](float cutoff) {
+        SynthParams p;
+        for (int i = 0; i < kNumParams; ++i)
+            p.set(i, 0.0f);
+        p.set(kOsc1Level, 1.0f);
+        p.set(kFilterCutoff, cutoff);
+        p.set(kAmpAttack, 0.001f);
+        p.set(kAmpSustain, 1.0f);
+        p.set(kAmpRelease, 0.05f);
+        p.set(kMasterVolume, -6.0f);
+        return p;
+    };
+
+    PresetAudition<SynthEngine, SynthParams> audition;
+    PresetAudition<SynthEngine, SynthParams>::Settings settings;
+    settings.seconds = 0.25;
+    settings.heldSeconds = 0.15;
+    audition.prepare(48000.0, settings);
+
+    constexpr int block = 256;
+    std::array<float, block> left{}, right{};
+    auto play = [&] {
+        std::vector<float> out;
+        while (out.size() < 12000 + 2 * block)
+        {
+            left.fill(0.0f);
+            right.fill(0.0f);
+            audition.mix(left.data(), right.data(), block);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+        return out;
+    };
+    auto energy = [](const std::vector<float>& x) {
+        double e = 0.0;
+        for (float v : x)
+            e += static_cast<double>(v) * v;
+        return e;
+    };
+
+    SECTION("Nothing plays until a preview is asked for")
+    {
+        REQUIRE(energy(play()) == 0.0);
+        REQUIRE_FALSE(audition.isPlaying());
+    }
+
+    SECTION("A preset plays its held note, the same from the cache")
+    {
+        const SynthParams bright = patch(8000.0f);
+        audition.audition(bright);
+        audition.wait();
+        REQUIRE(audition.getNumCached() == 1);
+
+        const std::vector<float> first = play();
+        REQUIRE(energy(first) > 1.0);
+        REQUIRE_FALSE(audition.isPlaying());  // 0.25 s, played out
+
+        audition.audition(bright);
+        audition.wait();
+        REQUIRE(audition.getNumCached() == 1);
+        const std::vector<float> again = play();
+        REQUIRE(again == first);
+
+        audition.audition(patch(300.0f));
+        audition.wait();
+        REQUIRE(audition.getNumCached() == 2);
+        REQUIRE(energy(play()) < energy(first));  // Darker
+
+        audition.audition(bright);
+        audition.wait();
+        const auto rt = RealtimeGuard::check([&] {
+            for (int b = 0; b < 16; ++b)
+                audition.mix(left.data(), right.data(), block);
+        });
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.deallocations == 0);
+        REQUIRE(rt.locks == 0);
+    }
+
+    SECTION("stop() cuts the preview off")
+    {
+        audition.audition(patch(8000.0f));
+        audition.wait();
+        audition.stop();
+        audition.wait();
+        REQUIRE(energy(play()) == 0.0);
+    }
+}
+
+TEST_CASE("PresetMorph lerps only what the presets disagree on", "[params]")
+{
+    using Morph = PresetMorph<kNumParams>;
+    std::array<Morph::Values, 3> presets{};
+    for (auto& p : presets)
+        p.fill(0.5f);
+    presets[0][kFilterCutoff] = 0.2f;
+    presets[1][kFilterCutoff] = 0.6f;
+    presets[2][kFilterCutoff] = 1.0f;
+    presets[2][kOsc1Waveform] = 1.0f;
+
+    Morph morph;
+    REQUIRE_FALSE(morph.compile(presets.data(), 1));
+    REQUIRE_FALSE(morph.isActive());
+    REQUIRE(morph.compile(presets.data(), 3));
+
+    REQUIRE(morph.getNumMorphed() == 2);
+    REQUIRE(morph.isMorphed(kFilterCutoff));
+    REQUIRE(morph.isMorphed(kOsc1Waveform));
+    REQUIRE_FALSE(morph.isMorphed(kAmpAttack));
+
+    std::array<float, kNumParams> values{};
+    auto valueOf = [&](int id) {
+        for (int m = 0; m < morph.getNumMorphed(); ++m)
+            if (morph.paramAt(m) == id)
+                return values[static_cast<size_t>(m)];
+        return -1.0f;
+    };
+
+    REQUIRE(morph.evaluate(0.0f, values.data()) == 2);
+    REQUIRE(valueOf(kFilterCutoff) == Catch::Approx(0.2f));
+    morph.evaluate(0.25f, values.data());
+    REQUIRE(valueOf(kFilterCutoff) == Catch::Approx(0.4f));
+    REQUIRE(valueOf(kOsc1Waveform) == Catch::Approx(0.5f));
+    morph.evaluate(0.75f, values.data());
+    REQUIRE(valueOf(kFilterCutoff) == Catch::Approx(0.8f));
+    REQUIRE(valueOf(kOsc1Waveform) == Catch::Approx(0.75f));
+    morph.evaluate(2.0f, values.data());
+    REQUIRE(valueOf(kFilterCutoff) == Catch::Approx(1.0f));
+
+    // Fed to a snapshot, only the values that moved are marked
+    SynthParams snapshot;
+    snapshot.update();
+    morph.evaluate(0.1f, values.data());
+    for (int m = 0; m < morph.getNumMorphed(); ++m)
+        snapshot.set(morph.paramAt(m), values[static_cast<size_t>(m)]);
+    snapshot.update();
+    morph.evaluate(0.2f, values.data());
+    for (int m = 0; m < morph.getNumMorphed(); ++m)
+        snapshot.set(morph.paramAt(m), values[static_cast<size_t>(m)]);
+    REQUIRE(snapshot.changed(kFilterCutoff));
+    REQUIRE_FALSE(snapshot.changed(kOsc1Waveform));  // Flat from the first preset to the second
+    REQUIRE_FALSE(snapshot.changed(kAmpAttack));
+}
+
+TEST_CASE("TuningTable reads Scala scales and keyboard mappings", "[tuning]")
+{
+    SECTION("The default is 12-TET at A4 = 440 Hz")
+    {
+        const TuningTable table;
+        REQUIRE(table.isEqualTemperament());
+        REQUIRE(table.frequency(69) == Catch::Approx(440.0f));
+        REQUIRE(table.frequency(57) == Catch::Approx(220.0f));
+        REQUIRE(table.frequency(60) == Catch::Approx(261.6256f));
+        REQUIRE_FALSE(table.isMapped(128));
+    }
+
+    SECTION("A 12-EDO .scl with the default mapping matches 12-TET")
+    {
+        std::string scl = "! 12edo.scl\n!\n12 equal\n 12\n!\n";
+        for (int d = 1; d <= 12; ++d)
+            scl += std::to_string(d * 100) + ".0\n";
+
+        TuningTable table;
+        REQUIRE(TuningTable::fromScala(scl, "", table));
+        REQUIRE_FALSE(table.isEqualTemperament());
+        for (int n = 0; n < TuningTable::NUM_NOTES; ++n)
+            REQUIRE(table.frequency(n) == Catch::Approx(TuningTable().frequency(n)).epsilon(1e-5));
+    }
+
+    SECTION("Ratios, a keyboard mapping with a gap, and the reference pitch")
+    {
+        // Just major pentatonic over five keys from middle C, the fifth key
+        // unmapped; C4 = 256 Hz
+        const std::string scl = "Just pentatonic\n5\n9/8\n5/4\n3/2\n5/3\n2/1\n";
+        const std::string kbm = "! map\n5\n0\n127\n60\n60\n256.0\n5\n0\n1\n2\n3\nx\n";
+
+        TuningTable table;
+        std::string error;
+        REQUIRE(TuningTable::fromScala(scl, kbm, table, &error));
+        REQUIRE(table.frequency(60) == Catch::Approx(256.0f));
+        REQUIRE(table.frequency(61) == Catch::Approx(288.0f));
+        REQUIRE(table.frequency(63) == Catch::Approx(384.0f));
+        REQUIRE_FALSE(table.isMapped(64));
+        REQUIRE(table.frequency(65) == Catch::Approx(512.0f));  // Next pattern, an octave up
+        REQUIRE(table.frequency(55) == Catch::Approx(128.0f));
+    }
+
+    SECTION("A file that doesn't parse leaves the table alone")
+    {
+        TuningTable table;
+        std::string error;
+        REQUIRE_FALSE(TuningTable::fromScala("Broken\n3\n100.0\n", "", table, &error));
+        REQUIRE_FALSE(error.empty());
+        REQUIRE(table.isEqualTemperament());
+
+        REQUIRE_FALSE(TuningTable::fromScala("Bad ratio\n1\n-3/2\n", "", table));
+        REQUIRE(table.isEqualTemperament());
+    }
+}
+
+TEST_CASE("SynthEngine plays notes at the tuning's frequencies", "[engine][tuning]")
+{
+    auto render = [](int note, const TuningTable* tuning) {
+        SynthEngine engine;
+        engine.prepare(48000.0, 512);
+        if (tuning != nullptr)
+            engine.setTuning(*tuning);
+        engine.noteOn(note, 1.0f);
+
+        std::vector<float> left(4800), right(4800);
+        engine.renderBlock(left.data(), right.data(), 4800);
+        return std::make_pair(left, engine.getActiveVoiceCount());
+    };
+
+    // Every key at A4's pitch: middle C sounds like A4 in 12-TET
+    std::array<float, TuningTable::NUM_NOTES> flat{};
+    flat.fill(440.0f);
+    flat[64] = 0.0f;  // Unmapped
+    const TuningTable tuned = TuningTable::fromFrequencies(flat.data());
+
+    const auto reference = render(69, nullptr);
+    const auto retuned = render(60, &tuned);
+    REQUIRE(retuned.second == 1);
+    REQUIRE(retuned.first == reference.first);
+
+    // An unmapped key starts nothing
+    REQUIRE(render(64, &tuned).second == 0);
+
+    // Back to 12-TET
+    SynthEngine engine;
+    engine.prepare(48000.0, 512);
+    engine.setTuning(tuned);
+    engine.setTuning(TuningTable());
+    engine.noteOn(64, 1.0f);
+    REQUIRE(engine.getActiveVoiceCount() == 1);
+}
+
+TEST_CASE("StatePublisher hands each published state to readFresh() once", "[params]")
+{
+    StatePublisher<int> publisher;
+    REQUIRE(publisher.readFresh() == nullptr);
+
+    publisher.write() = 7;
+    publisher.publish();
+    const int* fresh = publisher.readFresh();
+    REQUIRE(fresh != nullptr);
+    REQUIRE(*fresh == 7);
+    REQUIRE(publisher.readFresh() == nullptr);
+
+    publisher.write() = 8;
+    publisher.publish();
+    publisher.write() = 9;
+    publisher.publish();
+    REQUIRE(*publisher.readFresh() == 9);
+}
+
+TEST_CASE("OverrunLog keeps the last blocks that ran over", "[engine][perf]")
+{
+    auto log = std::make_unique<OverrunLog>();
+    log->setEffectNames({"delay", "reverb"});
+    log->prepare(48000.0);
+
+    int calls = 0;
+    const auto state = [&calls] {
+        ++calls;
+        OverrunLog::EngineState s;
+        s.activeVoices = 7;
+        s.effects = 2u;
+        return s;
+    };
+
+    // 480 samples at 48 kHz: a 10 ms budget
+    log->record(0.005, 480, state);
+    REQUIRE(calls == 0);
+    REQUIRE(log->read().total == 0);
+
+    log->record(0.015, 480, state);
+    REQUIRE(calls == 1);
+    const auto& first = log->read();
+    REQUIRE(first.total == 1);
+    REQUIRE(first.count == 1);
+    REQUIRE(first.entries[0].seconds == Catch::Approx(0.01));
+    REQUIRE(first.entries[0].blockMs == Catch::Approx(15.0f));
+    REQUIRE(first.entries[0].budgetMs == Catch::Approx(10.0f));
+    REQUIRE(first.entries[0].state.activeVoices == 7);
+    REQUIRE(first.worstLoad == Catch::Approx(1.5f));
+
+    const std::string json = log->toJson(first);
+    REQUIRE(json.find("\"voices\":7") != std::string::npos);
+    REQUIRE(json.find("\"quality\":null") != std::string::npos);
+    REQUIRE(json.find("\"effects\":[\"reverb\"]") != std::string::npos);
+
+    // Only the newest HISTORY are kept, oldest first
+    for (int i = 0; i < OverrunLog::HISTORY + 4; ++i)
+        log->record(0.011 + 0.001 * i, 480, state);
+    const auto& full = log->read();
+    REQUIRE(full.total == OverrunLog::HISTORY + 5);
+    REQUIRE(full.count == OverrunLog::HISTORY);
+    REQUIRE(full.entries[0].blockMs == Catch::Approx(15.0f));
+    REQUIRE(full.entries[OverrunLog::HISTORY - 1].blockMs == Catch::Approx(11.0f + OverrunLog::HISTORY + 3));
+
+    log->prepare(48000.0);
+    REQUIRE(log->read().total == 0);
+    REQUIRE(log->read().count == 0);
+}
+
+TEST_CASE("VoiceAllocator steals at its voice limit", "[engine][voices]")
+{
+    using Allocator = VoiceAllocator<4>;
+    Allocator alloc;
+    auto levelOf = [](int) { return 0.0f; };
+
+    for (int n = 0; n < 3; ++n)
+        alloc.noteOn(60 + n, levelOf);
+
+    alloc.setVoiceLimit(2);
+    REQUIRE(alloc.getVoiceLimit() == 2);
+
+    // Over the limit already: voices keep playing, new notes steal the oldest
+    auto a = alloc.noteOn(70, levelOf);
+    REQUIRE(a.stolen);
+    REQUIRE(a.voice == 0);
+
+    // Two voices finish: one is back under the limit, so the next note takes a free voice
+    alloc.voiceFinished(1);
+    alloc.voiceFinished(2);
+    REQUIRE_FALSE(alloc.noteOn(71, levelOf).stolen);
+    REQUIRE(alloc.noteOn(72, levelOf).stolen);
+
+    alloc.setVoiceLimit(0);
+    REQUIRE(alloc.getVoiceLimit() == 1);
+    alloc.setVoiceLimit(99);
+    REQUIRE(alloc.getVoiceLimit() == 4);
+}
+
+TEST_CASE("CpuGovernor sheds load and recovers with hysteresis", "[engine][perf]")
+{
+    constexpr double sr = 48000.0;
+    constexpr int block = 480;  // 10 ms deadline
+    CpuGovernor governor;
+    governor.prepare(sr);
+    governor.setEnabled(true);
+
+    auto feed = [&](double load, int blocks) {
+        for (int b = 0; b < blocks; ++b)
+            governor.update(load * block / sr, block);
+        return governor.getStep();
+    };
+
+    SECTION("An overrun steps down at once, then waits for the step to show")
+    {
+        REQUIRE(feed(0.9, 1) == 1);
+        REQUIRE(feed(0.9, 1) == 1);
+        REQUIRE(feed(0.9, 10) == CpuGovernor::MAX_STEP);
+        REQUIRE(feed(2.0, 10) == CpuGovernor::MAX_STEP);
+        REQUIRE(governor.getSnapshot().stepsDown == CpuGovernor::MAX_STEP);
+    }
+
+    SECTION("It steps back up one at a time after a quiet stretch")
+    {
+        feed(0.9, 20);
+        REQUIRE(feed(0.2, 150) == CpuGovernor::MAX_STEP);
+        REQUIRE(feed(0.2, 100) == CpuGovernor::MAX_STEP - 1);
+        REQUIRE(feed(0.2, 1000) == 0);
+        REQUIRE(governor.getSnapshot().stepsUp == CpuGovernor::MAX_STEP);
+    }
+
+    SECTION("A load between the thresholds holds the step")
+    {
+        feed(0.9, 1);
+        REQUIRE(feed(0.6, 1000) == 1);
+
+        // Any overrun restarts the wait
+        feed(0.2, 150);
+        feed(0.9, 1);
+        REQUIRE(feed(0.2, 150) == 2);
+    }
+
+    SECTION("Turned off, it reports step 0")
+    {
+        feed(0.9, 1);
+        governor.setEnabled(false);
+        REQUIRE(governor.endBlock(block) == 0);
+        REQUIRE(governor.getSnapshot().step == 0);
+        REQUIRE_FALSE(governor.getSnapshot().enabled);
+    }
+}
+
+TEST_CASE("SynthEngine leaves its voices alone while the governor sees headroom", "[engine][perf]")
+{
+    SynthEngine plain, governed;
+    for (auto* engine : {&plain, &governed})
+    {
+        engine->prepare(48000.0, 4096);
+        for (int n = 0; n < 8; ++n)
+            engine->noteOn(48 + n, 0.8f);
+    }
+    governed.setCpuGovernor(true);
+
+    // Eight voices render far inside a 4096-sample (85 ms) deadline
+    std::vector<float> l1(4096), r1(4096), l2(4096), r2(4096);
+    for (int b = 0; b < 4; ++b)
+    {
+        plain.renderBlock(l1.data(), r1.data(), 4096);
+        governed.renderBlock(l2.data(), r2.data(), 4096);
+    }
+
+    const auto state = governed.getCpuGovernor().getSnapshot();
+    REQUIRE(state.enabled);
+    REQUIRE(state.step == 0);
+    REQUIRE(governed.getVoiceLimit() == SynthEngine::MAX_VOICES);
+    REQUIRE(l1 == l2);
+    REQUIRE(plain.getCpuGovernor().getSnapshot().load == 0.0);
+}
+
+TEST_CASE("SynthEngine sleeps voices held at a silent sustain", "[engine][voices]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 256);
+    engine.setAmpEnvelope(0.001f, 0.01f, 0.0f, 0.1f);
+
+    std::vector<float> left(256), right(256);
+    engine.renderBlock(left.data(), right.data(), 256);
+    REQUIRE(engine.isSilent());
+
+    engine.noteOn(60, 0.8f);
+    engine.renderBlock(left.data(), right.data(), 256);
+    REQUIRE_FALSE(engine.isSilent());
+
+    SECTION("Decayed to zero sustain: still held, nothing rendered")
+    {
+        for (int b = 0; b < 8; ++b)
+            engine.renderBlock(left.data(), right.data(), 256);
+
+        REQUIRE(engine.getActiveVoiceCount() == 1);
+        REQUIRE(engine.isSilent());
+        REQUIRE(isBufferSilent(left.data(), 256));
+
+        // Note off still finds the sleeping voice
+        engine.noteOff(60);
+        engine.renderBlock(left.data(), right.data(), 256);
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+    }
+
+    SECTION("Raising the sustain wakes the held voice")
+    {
+        for (int b = 0; b < 8; ++b)
+            engine.renderBlock(left.data(), right.data(), 256);
+        REQUIRE(engine.isSilent());
+
+        engine.setAmpEnvelope(0.001f, 0.01f, 0.5f, 0.1f);
+        engine.renderBlock(left.data(), right.data(), 256);
+        REQUIRE_FALSE(engine.isSilent());
+        REQUIRE(calculateRMS(left.data(), 256) > 0.01f);
+    }
+}
+
+TEST_CASE("SynthEngine shares one LFO across voices", "[engine][lfo]")
+{
+    // Pitch LFO on; renders 0.5 s after `silence` blocks of nothing
+    auto render = [](SynthEngine::LFOMode mode, std::initializer_list<int> notes, int silence)
+    {
+        SynthEngine engine;
+        engine.prepare(48000.0, 256);
+        engine.setLFOMode(static_cast<int>(mode));
+        engine.setLFORate(3.0f);
+        engine.setLFOPitchAmount(0.2f);
+
+        std::vector<float> left(256), right(256), out;
+        for (int b = 0; b < silence; ++b)
+            engine.renderBlock(left.data(), right.data(), 256);
+        for (int note : notes)
+            engine.noteOn(note, 0.8f);
+        for (int b = 0; b < 94; ++b)
+        {
+            engine.renderBlock(left.data(), right.data(), 256);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+        return out;
+    };
+
+    using Mode = SynthEngine::LFOMode;
+
+    SECTION("Voices started together sound the same in either mode")
+    {
+        REQUIRE(render(Mode::Global, {48, 55, 60, 64, 67}, 0) == render(Mode::PerVoice, {48, 55, 60, 64, 67}, 0));
+    }
+
+    SECTION("The global LFO runs on between notes; a voice's own starts where it left off")
+    {
+        const auto fresh = render(Mode::PerVoice, {60}, 0);
+        REQUIRE(render(Mode::PerVoice, {60}, 20) == fresh);
+        REQUIRE(render(Mode::Global, {60}, 20) != fresh);
+    }
+}
+
+TEST_CASE("SynthEngine draws every voice's noise from one block", "[engine][noise]")
+{
+    // Noise alone through an open filter, 0.25 s
+    auto render = [](uint32_t seed, std::initializer_list<int> notes)
+    {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 256);
+        engine->setNoiseSeed(seed);
+        engine->setOsc1Level(0.0f);
+        engine->setOsc2Level(0.0f);
+        engine->setOsc3Level(0.0f);
+        engine->setNoiseLevel(1.0f);
+        engine->setFilterCutoff(20000.0f);
+        for (int note : notes)
+            engine->noteOn(note, 0.8f);
+
+        std::vector<float> left(256), right(256), out;
+        for (int b = 0; b < 47; ++b)
+        {
+            engine->renderBlock(left.data(), right.data(), 256);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+        return out;
+    };
+
+    SECTION("The seed sets the noise")
+    {
+        REQUIRE(render(3, {60}) == render(3, {60}));
+        REQUIRE(render(3, {60}) != render(4, {60}));
+    }
+
+    SECTION("Voices read independent lanes: they add in power, not in amplitude")
+    {
+        const auto one = render(3, {60});
+        const auto five = render(3, {60, 61, 62, 63, 64});  // Two lane groups
+        const float ratio = calculateRMS(five.data(), static_cast<int>(five.size()))
+                          / calculateRMS(one.data(), static_cast<int>(one.size()));
+        REQUIRE(ratio == Approx(std::sqrt(5.0f)).epsilon(0.1));
+    }
+}
+
+TEST_CASE("SynthEngine renders voice groups on worker threads", "[engine][threads]")
+{
+    auto serial = std::make_unique<SynthEngine>();
+    auto threaded = std::make_unique<SynthEngine>();
+    serial->prepare(48000.0, 256);
+    threaded->prepare(48000.0, 256);
+    threaded->setRenderThreads(4);
+
+    // Capped at the machine's cores; one core means serial
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    REQUIRE(threaded->getRenderThreads() == (cores > 0 ? std::min(4, cores) : 4));
+    REQUIRE(serial->getRenderThreads() == 1);
+
+    for (int v = 0; v < SynthEngine::MAX_VOICES; ++v)
+    {
+        serial->noteOn(36 + v * 3, 0.8f);
+        threaded->noteOn(36 + v * 3, 0.8f);
+    }
+
+    // 256 samples splits across the pool, 16 is rendered serially
+    std::vector<float> sL(256), sR(256), tL(256), tR(256);
+    for (int block : {256, 16, 256, 256, 16})
+    {
+        for (int b = 0; b < 8; ++b)
+        {
+            serial->renderBlock(sL.data(), sR.data(), block);
+            threaded->renderBlock(tL.data(), tR.data(), block);
+
+            // Same voices, only the order groups are summed in differs
+            for (int i = 0; i < block; ++i)
+            {
+                REQUIRE(tL[static_cast<size_t>(i)] == Approx(sL[static_cast<size_t>(i)]).margin(1e-5));
+                REQUIRE(tR[static_cast<size_t>(i)] == Approx(sR[static_cast<size_t>(i)]).margin(1e-5));
+            }
+        }
+    }
+    REQUIRE(calculateRMS(tL.data(), 16) > 0.01f);
+
+    threaded->setRenderThreads(1);
+    REQUIRE(threaded->getRenderThreads() == 1);
+}
+
+TEST_CASE("SynthEngines share one worker pool across the process", "[engine][threads]")
+{
+    auto a = std::make_unique<SynthEngine>();
+    auto b = std::make_unique<SynthEngine>();
+    auto reference = std::make_unique<SynthEngine>();
+    for (SynthEngine* engine : {a.get(), b.get(), reference.get()})
+    {
+        engine->prepare(48000.0, 256);
+        for (int v = 0; v < SynthEngine::MAX_VOICES; ++v)
+            engine->noteOn(36 + v * 3, 0.8f);
+    }
+    a->setRenderThreads(4);
+    b->setRenderThreads(2);
+
+    SECTION("Every instance holds the same pool; the last one out stops it")
+    {
+        const std::weak_ptr<VoiceThreadPool> pool = VoiceThreadPool::shared();
+        REQUIRE(pool.lock() == VoiceThreadPool::shared());
+        REQUIRE(a->getRenderThreads() <= 4);
+        REQUIRE(b->getRenderThreads() <= 2);
+
+        a->setRenderThreads(1);
+        REQUIRE_FALSE(pool.expired());
+        b.reset();
+        REQUIRE(pool.expired());
+    }
+
+    SECTION("Instances rendering at once take turns without blocking")
+    {
+        // Both on their own threads: whichever finds the pool busy renders alone
+        constexpr int BLOCKS = 200;
+        std::vector<float> aL(256 * BLOCKS), aR(aL.size()), bL(aL.size()), bR(aL.size());
+        std::thread other([&] {
+            for (int k = 0; k < BLOCKS; ++k)
+                b->renderBlock(bL.data() + k * 256, bR.data() + k * 256, 256);
+        });
+        for (int k = 0; k < BLOCKS; ++k)
+            a->renderBlock(aL.data() + k * 256, aR.data() + k * 256, 256);
+        other.join();
+
+        std::vector<float> rL(256), rR(256);
+        for (int k = 0; k < BLOCKS; ++k)
+        {
+            reference->renderBlock(rL.data(), rR.data(), 256);
+            for (size_t i = 0; i < 256; ++i)
+            {
+                const size_t at = static_cast<size_t>(k) * 256 + i;
+                REQUIRE(aL[at] == Approx(rL[i]).margin(1e-5));
+                REQUIRE(bR[at] == Approx(rR[i]).margin(1e-5));
+            }
+        }
+    }
+}
+
+TEST_CASE("SynthEngine plays paraphonic notes through one filter and envelope", "[engine][voices]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 256);
+    engine.setVoiceMode(static_cast<int>(SynthEngine::VoiceMode::Paraphonic));
+    engine.setAmpEnvelope(0.001f, 0.05f, 0.0f, 0.2f);
+
+    std::vector<float> left(256), right(256);
+    auto render = [&](int blocks)
+    {
+        float rms = 0.0f;
+        for (int b = 0; b < blocks; ++b)
+        {
+            engine.renderBlock(left.data(), right.data(), 256);
+            REQUIRE(isBufferValid(left.data(), 256));
+            rms = std::max(rms, calculateRMS(left.data(), 256));
+        }
+        return rms;
+    };
+
+    SECTION("A chord sounds, and frees every note once the shared release ends")
+    {
+        engine.setAmpEnvelope(0.001f, 0.05f, 0.7f, 0.05f);
+        engine.noteOn(48, 0.8f);
+        engine.noteOn(52, 0.8f);
+        engine.noteOn(55, 0.8f);
+        REQUIRE(render(8) > 0.01f);
+        REQUIRE(engine.getActiveVoiceCount() == 3);
+
+        // Released with another note held: fades out on its own
+        engine.noteOff(52);
+        render(2);
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+
+        // The last two ring on through the shared release, then go together
+        engine.noteOff(48);
+        engine.noteOff(55);
+        render(1);
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+        render(40);
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+        REQUIRE(engine.isSilent());
+    }
+
+    SECTION("First note: a note played into a held one doesn't restart the envelopes")
+    {
+        engine.noteOn(48, 0.8f);
+        render(16);  // Decayed to a silent sustain
+        REQUIRE(engine.isSilent());
+
+        engine.noteOn(55, 0.8f);
+        REQUIRE(render(4) < 1.0e-4f);
+        REQUIRE(engine.getActiveVoiceCount() == 2);
+    }
+
+    SECTION("Every note: each note on restarts them")
+    {
+        engine.setParaTrigger(static_cast<int>(SynthEngine::ParaTrigger::EveryNote));
+        engine.noteOn(48, 0.8f);
+        render(16);
+        REQUIRE(engine.isSilent());
+
+        engine.noteOn(55, 0.8f);
+        REQUIRE(render(4) > 0.01f);
+    }
+
+    SECTION("Switching back to poly stops the notes")
+    {
+        engine.noteOn(48, 0.8f);
+        render(1);
+        engine.setVoiceMode(static_cast<int>(SynthEngine::VoiceMode::Poly));
+        REQUIRE(engine.getActiveVoiceCount() == 0);
+        REQUIRE(render(1) == 0.0f);
+    }
+}
+
+TEST_CASE("SynthEngine drifts each voice's pitch on its own path", "[engine][drift]")
+{
+    SECTION("AnalogDrift wanders as far at any control block size")
+    {
+        for (int n : {16, 32, 64})
+        {
+            AnalogDrift drift;
+            drift.prepare(48000.0);
+            drift.reseed(7);
+
+            double sum = 0.0, sumSq = 0.0, maxStep = 0.0;
+            float last = 0.0f;
+            const int steps = 48000 * 600 / n;  // Ten minutes
+            for (int i = 0; i < steps; ++i)
+            {
+                const float d = drift.advance(n);
+                sum += d;
+                sumSq += static_cast<double>(d) * d;
+                maxStep = std::max(maxStep, static_cast<double>(std::abs(d - last)));
+                last = d;
+            }
+            const double mean = sum / steps;
+            const double sd = std::sqrt(sumSq / steps - mean * mean);
+            INFO("n = " << n << ", sd = " << sd);
+            REQUIRE(sd > 0.2);
+            REQUIRE(sd < 0.6);
+            REQUIRE(maxStep < 0.1);  // Slow: a wander, not noise
+        }
+    }
+
+    auto render = [](float drift, uint32_t seed)
+    {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 256);
+        engine->setNoiseSeed(seed);
+        engine->setAnalogDrift(drift);
+        engine->noteOn(57, 0.8f);
+        engine->noteOn(57, 0.8f);  // Two voices on the one note: drift beats them apart
+        std::vector<float> out, left(256), right(256);
+        for (int b = 0; b < 400; ++b)
+        {
+            engine->renderBlock(left.data(), right.data(), 256);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+        return out;
+    };
+
+    const auto still = render(0.0f, 1);
+    const auto drifting = render(1.0f, 1);
+    REQUIRE(isBufferValid(drifting.data(), static_cast<int>(drifting.size())));
+    REQUIRE(drifting != still);
+
+    // The same seed takes the same path
+    REQUIRE(render(1.0f, 1) == drifting);
+    REQUIRE(render(1.0f, 2) != drifting);
+
+    // Without drift the two voices stay in phase; with it they beat, so
+    // the level moves from one stretch to the next
+    auto levelSpread = [](const std::vector<float>& x)
+    {
+        float lo = 1.0e9f, hi = 0.0f;
+        for (size_t start = 48000; start + 4800 <= x.size(); start += 4800)
+        {
+            const float rms = calculateRMS(x.data() + start, 4800);
+            lo = std::min(lo, rms);
+            hi = std::max(hi, rms);
+        }
+        return hi - lo;
+    };
+    REQUIRE(levelSpread(still) < 1.0e-3f);
+    REQUIRE(levelSpread(drifting) > 1.0e-3f);
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // All inline (voices and their filters); nothing scales with the rate
+    constexpr size_t BUDGET = 256u << 10;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    const MemoryReport& at192k = reports[1].second;
+    INFO("48 kHz:\n" << at48k.toString());
+
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+    REQUIRE(at48k.getHeapBytes() == 0);
+    REQUIRE(at192k.getInstanceBytes() == at48k.getInstanceBytes());
+    CHECK(at48k.getInstanceBytes() <= BUDGET);
+
+    SECTION("Worker threads bring their own mix buffers")
+    {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 512);
+        engine->setRenderThreads(2);
+        if (engine->getRenderThreads() > 1)
+            REQUIRE(engine->memoryReport().getBytes("voice threads") >= 2 * 512 * sizeof(float));
+    }
+}
+
+TEST_CASE("SynthEngine matches its golden renders", "[engine][golden]")
+{
+    // Six voices so VoiceGroup runs a full and a partial lane set
+    static constexpr int chord[] = {36, 48, 55, 60, 64, 67};
+
+    struct Scenario
+    {
+        const char* name;
+        double seconds;
+        std::function<void(SynthEngine&, long)> script;
+    };
+
+    const Scenario scenarios[] = {
+        {"chord", 2.5, [](SynthEngine& engine, long frame) {
+             if (frame == 0)
+             {
+                 engine.setFilterCutoff(1200.0f);
+                 engine.setFilterResonance(0.4f);
+                 engine.setLFOPitchAmount(0.05f);
+                 for (int note : chord)
+                     engine.noteOn(note, 0.8f);
+             }
+             if (frame == 72000)
+                 for (int note : chord)
+                     engine.noteOff(note);
+         }},
+        {"resonance_sweep", 2.0, [](SynthEngine& engine, long frame) {
+             // 100 Hz to 8 kHz at resonance 0.9, retargeted every block
+             if (frame == 0)
+             {
+                 engine.setFilterResonance(0.9f);
+                 engine.noteOn(36, 0.8f);
+                 engine.noteOn(43, 0.8f);
+             }
+             engine.setFilterCutoff(100.0f * std::pow(80.0f, static_cast<float>(frame) / 96000.0f));
+         }},
+        {"stabs", 2.0, [](SynthEngine& engine, long frame) {
+             // A chord every 256 ms, released after 100 ms: attacks, releases and steals
+             const long phase = frame % 12288;
+             const int root = 36 + static_cast<int>(frame / 12288) % 4 * 3;
+             if (phase == 0)
+                 for (int note : chord)
+                     engine.noteOn(note + root - 36, 0.9f);
+             if (phase == 4800)
+                 for (int note : chord)
+                     engine.noteOff(note + root - 36);
+         }},
+    };
+
+    for (const auto& scenario : scenarios)
+    {
+        const auto audio = GoldenRender::render<SynthEngine>(48000.0, scenario.seconds, scenario.script);
+        const std::string diff = GoldenRender::check(GOLDEN_DIR, scenario.name,
+                                                     GoldenRender::fingerprint(audio, 48000.0), {});
+        INFO(scenario.name << ":\n" << diff);
+        CHECK(diff.empty());
+    }
+}
@@ -8,13 +8,17 @@
  * - Audio output validity
  * - Envelope behavior
  * - Oscillator waveforms
+ * - Band-limited hard sync
  * - Filter behavior
+ * - Pitch tables
+ * - Control-rate modulators
  */
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
 #include <array>
+#include <vector>
 
 #include "../source/dsp/Voice.h"
 
@@ -65,6 +69,33 @@ int countZeroCrossings(const float* buffer, int numSamples)
     return crossings;
 }
 
+/**
+ * Power off a fundamental's harmonics, relative to the total, in dB
+ * (Hann-windowed DFT; the fundamental sits exactly on bin harmonicBin)
+ */
+double offHarmonicDb(const std::vector<float>& x, int harmonicBin)
+{
+    const int n = static_cast<int>(x.size());
+    const double pi = 3.14159265358979323846;
+    double total = 0.0, off = 0.0;
+    for (int k = 1; k < n / 2; ++k)
+    {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            const double w = 0.5 - 0.5 * std::cos(2.0 * pi * i / n);
+            re += w * x[static_cast<size_t>(i)] * std::cos(2.0 * pi * k * i / n);
+            im -= w * x[static_cast<size_t>(i)] * std::sin(2.0 * pi * k * i / n);
+        }
+        const double power = re * re + im * im;
+        const int nearest = (k + harmonicBin / 2) / harmonicBin * harmonicBin;
+        total += power;
+        if (std::abs(k - nearest) > 2)  // Outside the window's main lobe
+            off += power;
+    }
+    return 10.0 * std::log10(off / total);
+}
+
 /**
  * Clear buffer
  */
@@ -214,7 +245,7 @@ TEST_CASE("Voice oscillator waveforms", "[voice][oscillator]")
         clearBuffer(leftBuffer.data(), bufferSize);
         clearBuffer(rightBuffer.data(), bufferSize);
 
-        voice.setOsc1Waveform(Oscillator::Waveform::Saw);
+        voice.setOsc1Waveform(PolyBlepOscillator::Waveform::Saw);
         voice.noteOn(60, 1.0f);
         voice.render(leftBuffer.data(), rightBuffer.data(), bufferSize);
 
@@ -227,7 +258,7 @@ TEST_CASE("Voice oscillator waveforms", "[voice][oscillator]")
         clearBuffer(leftBuffer.data(), bufferSize);
         clearBuffer(rightBuffer.data(), bufferSize);
 
-        voice.setOsc1Waveform(Oscillator::Waveform::Triangle);
+        voice.setOsc1Waveform(PolyBlepOscillator::Waveform::Triangle);
         voice.noteOn(60, 1.0f);
         voice.render(leftBuffer.data(), rightBuffer.data(), bufferSize);
 
@@ -240,7 +271,7 @@ TEST_CASE("Voice oscillator waveforms", "[voice][oscillator]")
         clearBuffer(leftBuffer.data(), bufferSize);
         clearBuffer(rightBuffer.data(), bufferSize);
 
-        voice.setOsc1Waveform(Oscillator::Waveform::Pulse);
+        voice.setOsc1Waveform(PolyBlepOscillator::Waveform::Pulse);
         voice.noteOn(60, 1.0f);
         voice.render(leftBuffer.data(), rightBuffer.data(), bufferSize);
 
@@ -253,7 +284,7 @@ TEST_CASE("Voice oscillator waveforms", "[voice][oscillator]")
         clearBuffer(leftBuffer.data(), bufferSize);
         clearBuffer(rightBuffer.data(), bufferSize);
 
-        voice.setOsc1Waveform(Oscillator::Waveform::Sine);
+        voice.setOsc1Waveform(PolyBlepOscillator::Waveform::Sine);
         voice.noteOn(60, 1.0f);
         voice.render(leftBuffer.data(), rightBuffer.data(), bufferSize);
 
@@ -262,6 +293,59 @@ TEST_CASE("Voice oscillator waveforms", "[voice][oscillator]")
     }
 }
 
+TEST_CASE("Hard sync is band-limited", "[voice][oscillator][sync]")
+{
+    // Master and slave both land exactly on DFT bins (211 and 500), so
+    // everything the synced slave makes should sit on the master's
+    // harmonics, and the free-running slave on its own
+    constexpr int n = 4096;
+    const float masterHz = 48000.0f * 211 / n;  // About 2473 Hz: the old reset missed most cycles
+    const float slaveHz = 48000.0f * 500 / n;
+
+    enum Sync { NONE, THRESHOLD, BAND_LIMITED };
+    const auto render = [&](PolyBlepOscillator::Waveform wf, Sync sync) {
+        PolyBlepOscillator master, slave;
+        for (PolyBlepOscillator* osc : {&master, &slave})
+        {
+            osc->setSampleRate(48000.0f);
+            osc->setWaveform(wf);
+        }
+        master.setFrequency(masterHz);
+        slave.setFrequency(slaveHz);
+
+        std::vector<float> out(n);
+        for (int i = 0; i < 2 * n; ++i)
+        {
+            master.process();
+            float y = slave.process();
+            if (sync == BAND_LIMITED)
+            {
+                const float after = master.wrapFraction();
+                if (after >= 0.0f)
+                    y += slave.sync(after);
+            }
+            else if (sync == THRESHOLD && master.getPhase() < 0.01f)
+            {
+                slave.reset();  // The old hard reset
+            }
+            if (i >= n)
+                out[static_cast<size_t>(i - n)] = y;
+        }
+        return out;
+    };
+
+    for (auto wf : {PolyBlepOscillator::Waveform::Saw, PolyBlepOscillator::Waveform::Pulse})
+    {
+        const double freeDb = offHarmonicDb(render(wf, NONE), 500);
+        const double oldDb = offHarmonicDb(render(wf, THRESHOLD), 211);
+        const double newDb = offHarmonicDb(render(wf, BAND_LIMITED), 211);
+
+        // No worse than the slave's own polyBLEP edges, and far below the old reset
+        REQUIRE(newDb < freeDb + 3.0);
+        REQUIRE(newDb < oldDb - 20.0);
+    }
+}
+
 TEST_CASE("Voice filter behavior", "[voice][filter]")
 {
     Voice voice;
@@ -389,17 +473,17 @@ TEST_CASE("Voice parameter setters", "[voice][params]")
 
     SECTION("Oscillator setters do not crash")
     {
-        voice.setOsc1Waveform(Oscillator::Waveform::Saw);
+        voice.setOsc1Waveform(PolyBlepOscillator::Waveform::Saw);
         voice.setOsc1Octave(-1);
         voice.setOsc1Level(0.5f);
 
-        voice.setOsc2Waveform(Oscillator::Waveform::Triangle);
+        voice.setOsc2Waveform(PolyBlepOscillator::Waveform::Triangle);
         voice.setOsc2Octave(1);
         voice.setOsc2Detune(5.0f);
         voice.setOsc2Level(0.7f);
         voice.setOsc2Sync(true);
 
-        voice.setOsc3Waveform(Oscillator::Waveform::Sine);
+        voice.setOsc3Waveform(PolyBlepOscillator::Waveform::Sine);
         voice.setOsc3Octave(-2);
         voice.setOsc3Detune(-10.0f);
         voice.setOsc3Level(0.3f);
@@ -588,3 +672,360 @@ TEST_CASE("Voice stress test", "[voice][stress]")
         }
     }
 }
+
+// ============================================================================
+// SIMD Voice Group Tests
+// ============================================================================
+
+#include "../source/dsp/VoiceGroup.h"
+
+TEST_CASE("VoiceGroup matches scalar Voice render", "[voice][simd]")
+{
+    constexpr int bufferSize = 512;
+    constexpr double sampleRate = 48000.0;
+
+    VoiceParams params;
+    params.osc2Detune = 7.0f;
+    params.osc3Level = 0.5f;
+    params.osc3Waveform = 2;  // Pulse
+    params.filterCutoff = 1200.0f;
+    params.filterResonance = 0.4f;
+    params.lfoPitchAmount = 0.05f;
+
+    std::array<Voice, 4> scalarVoices;
+    std::array<Voice, 4> simdVoices;
+    const int notes[4] = {48, 55, 60, 67};
+
+    for (int v = 0; v < 4; ++v)
+    {
+        scalarVoices[v].prepare(sampleRate);
+        scalarVoices[v].applyParams(params, 1);
+        scalarVoices[v].noteOn(notes[v], 0.8f);
+
+        simdVoices[v].prepare(sampleRate);
+        simdVoices[v].applyParams(params, 1);
+        simdVoices[v].noteOn(notes[v], 0.8f);
+    }
+
+    std::array<float, bufferSize> scalarL{}, scalarR{};
+    std::array<float, bufferSize> simdL{}, simdR{};
+
+    for (auto& voice : scalarVoices)
+        voice.render(scalarL.data(), scalarR.data(), bufferSize);
+
+    std::array<Voice*, 4> lanes{&simdVoices[0], &simdVoices[1], &simdVoices[2], &simdVoices[3]};
+    VoiceGroup::render(lanes.data(), 4, params, simdL.data(), simdR.data(), bufferSize);
+
+    REQUIRE(isBufferValid(simdL.data(), bufferSize));
+
+    // fasttanh/fastexp approximations allow small per-sample deviation
+    float maxDiff = 0.0f;
+    for (int i = 0; i < bufferSize; ++i)
+        maxDiff = std::max(maxDiff, std::abs(scalarL[i] - simdL[i]));
+
+    REQUIRE(maxDiff < 1.0e-2f);
+    REQUIRE(calculateRMS(simdL.data(), bufferSize)
+            == Approx(calculateRMS(scalarL.data(), bufferSize)).epsilon(0.01));
+}
+
+TEST_CASE("VoiceGroup handles partially filled lane sets", "[voice][simd]")
+{
+    constexpr int bufferSize = 256;
+    VoiceParams params;
+
+    Voice voice;
+    voice.prepare(44100.0);
+    voice.applyParams(params, 1);
+    voice.noteOn(60, 1.0f);
+
+    std::array<float, bufferSize> outL{}, outR{};
+    Voice* lanes[1] = {&voice};
+    VoiceGroup::render(lanes, 1, params, outL.data(), outR.data(), bufferSize);
+
+    REQUIRE(isBufferValid(outL.data(), bufferSize));
+    REQUIRE(calculateRMS(outL.data(), bufferSize) > 0.0f);
+    REQUIRE(voice.isActive());
+}
+
+TEST_CASE("VoiceGroup ladder stays stable at full resonance", "[voice][simd][filter]")
+{
+    constexpr int blockSize = 37;  // Not a multiple of the coefficient block
+    VoiceParams params;
+    params.filterCutoff = 400.0f;
+    params.filterResonance = 1.0f;
+    params.filterEnvAmount = 1.0f;
+    params.lfoFilterAmount = 0.5f;
+
+    std::array<Voice, 4> voices;
+    const int notes[4] = {36, 48, 60, 72};
+    for (int v = 0; v < 4; ++v)
+    {
+        voices[v].prepare(44100.0);
+        voices[v].applyParams(params, 1);
+        voices[v].noteOn(notes[v], 1.0f);
+    }
+
+    std::array<Voice*, 4> lanes{&voices[0], &voices[1], &voices[2], &voices[3]};
+    std::array<float, blockSize> outL{}, outR{};
+    float peak = 0.0f;
+
+    for (int block = 0; block < 500; ++block)
+    {
+        clearBuffer(outL.data(), blockSize);
+        clearBuffer(outR.data(), blockSize);
+        VoiceGroup::render(lanes.data(), 4, params, outL.data(), outR.data(), blockSize);
+
+        REQUIRE(isBufferValid(outL.data(), blockSize));
+        for (float s : outL)
+            peak = std::max(peak, std::abs(s));
+    }
+
+    REQUIRE(peak > 0.0f);
+    REQUIRE(peak < 8.0f);
+}
+
+TEST_CASE("VoiceGroup matches scalar Voice render with hard sync", "[voice][simd][sync]")
+{
+    constexpr int bufferSize = 512;
+    VoiceParams params;
+    params.osc2Sync = true;
+    params.osc2Octave = 1;
+    params.osc2Detune = 5.0f;
+    params.osc2Waveform = 2;  // Pulse
+    params.lfoPitchAmount = 0.05f;
+
+    std::array<Voice, 4> scalarVoices;
+    std::array<Voice, 4> simdVoices;
+    const int notes[4] = {45, 57, 69, 81};
+    for (int v = 0; v < 4; ++v)
+    {
+        for (Voice* voice : {&scalarVoices[v], &simdVoices[v]})
+        {
+            voice->prepare(48000.0);
+            voice->applyParams(params, 1);
+            voice->noteOn(notes[v], 0.8f);
+        }
+    }
+
+    std::array<float, bufferSize> scalarL{}, scalarR{};
+    std::array<float, bufferSize> simdL{}, simdR{};
+    std::array<Voice*, 4> lanes{&simdVoices[0], &simdVoices[1], &simdVoices[2], &simdVoices[3]};
+
+    // Two calls, so a polyBLEP half pending at the end of the first carries over
+    for (int half = 0; half < 2; ++half)
+    {
+        for (auto& voice : scalarVoices)
+            voice.render(scalarL.data() + half * bufferSize / 2, scalarR.data() + half * bufferSize / 2,
+                         bufferSize / 2);
+        VoiceGroup::render(lanes.data(), 4, params, simdL.data() + half * bufferSize / 2,
+                           simdR.data() + half * bufferSize / 2, bufferSize / 2);
+    }
+
+    float maxDiff = 0.0f;
+    for (int i = 0; i < bufferSize; ++i)
+        maxDiff = std::max(maxDiff, std::abs(scalarL[i] - simdL[i]));
+    REQUIRE(isBufferValid(simdL.data(), bufferSize));
+    REQUIRE(maxDiff < 1.0e-2f);
+}
+
+// ============================================================================
+// Pitch Tables
+// ============================================================================
+
+TEST_CASE("PitchTables match std::pow to a fraction of a cent", "[voice][pitch]")
+{
+    const PitchTables& pitch = PitchTables::get();
+
+    // 0.01 cents is a ratio error of about 6e-6
+    constexpr double tolerance = 6.0e-6;
+
+    for (float note = 0.0f; note <= 127.0f; note += 0.37f)
+    {
+        const double expected = 440.0 * std::pow(2.0, (note - 69.0) / 12.0);
+        REQUIRE(std::abs(pitch.midiToFrequency(note) / expected - 1.0) < tolerance);
+    }
+
+    for (float semitones = -48.0f; semitones <= 48.0f; semitones += 0.113f)
+    {
+        const double expected = std::pow(2.0, semitones / 12.0);
+        REQUIRE(std::abs(pitch.semitonesToRatio(semitones) / expected - 1.0) < tolerance);
+    }
+
+    REQUIRE(pitch.midiToFrequency(69.0f) == Approx(440.0f));
+    REQUIRE(pitch.centsToRatio(1200.0f) == Approx(2.0f));
+    REQUIRE(pitch.octavesToRatio(-2.0f) == Approx(0.25f));
+
+    // Out-of-range input clamps instead of reading past the table
+    REQUIRE(std::isfinite(pitch.octavesToRatio(100.0f)));
+    REQUIRE(pitch.octavesToRatio(-100.0f) > 0.0f);
+}
+
+// ============================================================================
+// Control-rate modulators
+// ============================================================================
+
+TEST_CASE("Control-rate modulators match per-sample stepping", "[voice][control]")
+{
+    constexpr float sampleRate = 48000.0f;
+    constexpr int n = ControlRamp::BLOCK_SIZE;
+
+    SECTION("ADSREnvelope::advance lands where process() would")
+    {
+        ADSREnvelope stepped, skipped;
+        for (auto* env : {&stepped, &skipped})
+        {
+            env->setSampleRate(sampleRate);
+            env->setADSR(0.005f, 0.05f, 0.4f, 0.02f);
+            env->trigger();
+        }
+
+        for (int block = 0; block < 200; ++block)
+        {
+            if (block == 120)
+            {
+                stepped.release();
+                skipped.release();
+            }
+
+            float last = 0.0f;
+            for (int i = 0; i < n; ++i)
+                last = stepped.process();
+
+            // Float rounding can move a stage corner by one sample
+            REQUIRE(skipped.advance(n) == Approx(last).margin(1.0e-3));
+        }
+
+        REQUIRE_FALSE(stepped.isActive());
+        REQUIRE_FALSE(skipped.isActive());
+    }
+
+    SECTION("LFO::advance keeps the phase of process()")
+    {
+        LFO stepped, skipped;
+        for (auto* lfo : {&stepped, &skipped})
+        {
+            lfo->prepare(sampleRate);
+            lfo->setRate(7.3f);
+            lfo->setWaveform(LFO::Waveform::Triangle);
+        }
+
+        for (int block = 0; block < 500; ++block)
+        {
+            for (int i = 0; i < n; ++i)
+                stepped.process();
+            skipped.advance(n);
+        }
+
+        REQUIRE(skipped.getPhase() == Approx(stepped.getPhase()).margin(1.0e-3));
+    }
+
+    SECTION("ControlRamp reaches each target in one block")
+    {
+        ControlRamp ramp;
+        ramp.reset(1.0f);
+        ramp.setTarget(2.0f, n);
+
+        float previous = ramp.next();
+        REQUIRE(previous == 1.0f);
+        for (int i = 1; i < n; ++i)
+        {
+            const float value = ramp.next();
+            REQUIRE(value > previous);
+            previous = value;
+        }
+
+        REQUIRE(ramp.getValue() == Approx(2.0f));
+    }
+}
+
+// ============================================================================
+// Exponential-segment envelope
+// ============================================================================
+
+TEST_CASE("ADSREnvelope runs exponential segments", "[voice][envelope]")
+{
+    constexpr float sampleRate = 48000.0f;
+
+    SECTION("Attack reaches full level at the attack time, on a rounded curve")
+    {
+        ADSREnvelope env;
+        env.setSampleRate(sampleRate);
+        env.setADSR(0.01f, 0.1f, 0.5f, 0.1f);
+        env.trigger();
+
+        int samples = 0;
+        float atHalfTime = 0.0f;
+        while (env.getStage() == ADSREnvelope::Stage::Attack && samples < 10000)
+        {
+            const float level = env.process();
+            if (++samples == 240)
+                atHalfTime = level;
+        }
+
+        REQUIRE(samples == Approx(480).margin(1));
+        REQUIRE(env.getLevel() == 1.0f);
+        REQUIRE(atHalfTime > 0.6f);  // An RC charge, not a line
+    }
+
+    SECTION("Decay settles exactly on sustain, release on zero")
+    {
+        ADSREnvelope env;
+        env.setSampleRate(sampleRate);
+        env.setADSR(0.001f, 0.05f, 0.4f, 0.02f);
+        env.trigger();
+
+        for (int i = 0; i < 48000 && env.getStage() != ADSREnvelope::Stage::Sustain; ++i)
+            env.process();
+        REQUIRE(env.getStage() == ADSREnvelope::Stage::Sustain);
+        REQUIRE(env.process() == 0.4f);
+
+        env.release();
+        int samples = 0;
+        while (env.isActive() && samples < 48000)
+        {
+            env.process();
+            ++samples;
+        }
+
+        REQUIRE_FALSE(env.isActive());
+        REQUIRE(env.getLevel() == 0.0f);
+        REQUIRE(samples <= 960);  // A swing from 0.4 is shorter than the full-scale time
+    }
+
+    SECTION("render() lands where process() would, through changes mid-stage")
+    {
+        ADSREnvelope stepped, rendered;
+        for (auto* env : {&stepped, &rendered})
+        {
+            env->setSampleRate(sampleRate);
+            env->setADSR(0.004f, 0.03f, 0.6f, 0.015f);
+            env->trigger();
+        }
+
+        std::array<float, 37> block{};
+        for (int b = 0; b < 120; ++b)
+        {
+            if (b == 20)
+            {
+                stepped.setSustain(0.3f);
+                rendered.setSustain(0.3f);
+            }
+            if (b == 50)
+            {
+                stepped.release();
+                rendered.release();
+            }
+            if (b == 52)
+            {
+                stepped.setRelease(0.05f);
+                rendered.setRelease(0.05f);
+            }
+
+            rendered.render(block.data(), static_cast<int>(block.size()));
+            for (float level : block)
+                REQUIRE(level == Approx(stepped.process()).margin(1.0e-6));
+        }
+
+        REQUIRE_FALSE(rendered.isActive());
+    }
+}
@@ -6,7 +6,7 @@
 import React from 'react';
 import { useJUCEBridge } from './hooks/useJUCEBridge';
 import { useParameters, normalizeValue, denormalizeValue } from './hooks/useParameters';
-import { PARAMETER_DEFINITIONS, WAVEFORM_OPTIONS, OCTAVE_OPTIONS, LFO_WAVEFORM_OPTIONS } from './types/parameters';
+import { PARAMETER_DEFINITIONS, WAVEFORM_OPTIONS, OCTAVE_OPTIONS, LFO_WAVEFORM_OPTIONS, LFO_MODE_OPTIONS } from './types/parameters';
 import { SynthKnob } from './components/SynthKnob';
 import { SynthADSR } from './components/SynthADSR';
 import Oscilloscope from './components/Oscilloscope';
@@ -106,7 +106,7 @@ const OscillatorSection: React.FC<OscillatorProps> = ({
  * Main synthesizer UI
  */
 const App: React.FC = () => {
-  const { isConnected, audioData } = useJUCEBridge({
+  const { isConnected, audioData, spectrumData, overrunLog } = useJUCEBridge({
     enableAudioData: true,
     audioChannel: 'master',
   });
@@ -128,6 +128,7 @@ const App: React.FC = () => {
           <Oscilloscope
             label="SCOPE"
             audioData={audioData}
+            spectrumData={spectrumData}
             width={300}
             height={80}
             color="#00ff88"
@@ -147,6 +148,22 @@ const App: React.FC = () => {
             <span className={`status-indicator ${isConnected ? 'connected' : 'disconnected'}`} />
             {isConnected ? 'Connected' : 'Standalone'}
           </div>
+          {overrunLog.total > 0 && (
+            // Blocks that ran over their deadline, newest first, with what
+            // the engine was doing: enough to diagnose a click from a screenshot
+            <div className="overrun-log">
+              <span className="overrun-title">
+                {overrunLog.total} OVERRUN{overrunLog.total === 1 ? '' : 'S'} (worst {Math.round(overrunLog.worstLoad * 100)}%)
+              </span>
+              {overrunLog.overruns.slice(-3).reverse().map((o, i) => (
+                <span key={i} className="overrun-entry">
+                  {o.seconds.toFixed(1)}s {o.blockMs.toFixed(1)}/{o.budgetMs.toFixed(1)} ms
+                  {o.voices !== null && ` · ${o.voices} voices`}
+                  {o.governorStep !== null && ` · gov ${o.governorStep}`}
+                </span>
+              ))}
+            </div>
+          )}
         </div>
       </header>
 
@@ -192,6 +209,18 @@ const App: React.FC = () => {
               />
             </div>
           </div>
+          <div className="oscillator-section noise-section">
+            <h3>DRIFT</h3>
+            <div className="knob-row">
+              <SynthKnob
+                label="AMOUNT"
+                min={0}
+                max={1}
+                value={getDenormalized('analog_drift', paramValues.analog_drift ?? 0)}
+                onChange={(v) => handleChange('analog_drift', getNormalized('analog_drift', v))}
+              />
+            </div>
+          </div>
         </div>
       </section>
 
@@ -290,6 +319,15 @@ const App: React.FC = () => {
             value={getDenormalized('lfo_filter_amount', paramValues.lfo_filter_amount ?? 0)}
             onChange={(v) => handleChange('lfo_filter_amount', getNormalized('lfo_filter_amount', v))}
           />
+          <SynthKnob
+            label="MODE"
+            min={0}
+            max={1}
+            step={1}
+            value={getDenormalized('lfo_mode', paramValues.lfo_mode ?? 0)}
+            onChange={(v) => handleChange('lfo_mode', getNormalized('lfo_mode', v))}
+            options={LFO_MODE_OPTIONS.map(o => o.label)}
+          />
         </div>
       </section>
 
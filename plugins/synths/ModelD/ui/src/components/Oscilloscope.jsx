@@ -27,6 +27,8 @@ import React, { useRef, useEffect } from 'react';
  * ## Data Format
  * Pass an array of sample values normalized to -1 to +1 range.
  * Typical array length is 256-1024 samples for smooth display.
+ * spectrumData, if given, is band levels in dB (low to high frequency),
+ * filled in behind the trace from spectrumFloorDb at the bottom to 0 dB.
  *
  * @example
  * ```jsx
@@ -55,6 +57,8 @@ const Oscilloscope = ({
   width = 300,
   height = 150,
   audioData = [],  // Array of sample values from -1 to 1
+  spectrumData = [],  // Optional band levels in dB, low to high, drawn behind the trace
+  spectrumFloorDb = -90,
   color = '#4CAF50',
   backgroundColor = '#0a0a0a',
   gridColor = '#1a1a1a',
@@ -115,6 +119,22 @@ const Oscilloscope = ({
         ctx.stroke();
       }
 
+      // Spectrum behind the trace: bands left to right, 0 dB at the top
+      if (spectrumData && spectrumData.length > 1) {
+        ctx.fillStyle = color;
+        ctx.globalAlpha = 0.2;
+        ctx.beginPath();
+        ctx.moveTo(0, height);
+        for (let i = 0; i < spectrumData.length; i++) {
+          const level = Math.max(0, Math.min(1, 1 - spectrumData[i] / spectrumFloorDb));
+          ctx.lineTo((width * i) / (spectrumData.length - 1), height * (1 - level));
+        }
+        ctx.lineTo(width, height);
+        ctx.closePath();
+        ctx.fill();
+        ctx.globalAlpha = 1.0;
+      }
+
       // Draw waveform
       if (audioData && audioData.length > 0) {
         ctx.strokeStyle = color;
@@ -189,7 +209,7 @@ const Oscilloscope = ({
         cancelAnimationFrame(animationRef.current);
       }
     };
-  }, [audioData, width, height, color, backgroundColor, gridColor, showGrid, showPeaks]);
+  }, [audioData, spectrumData, spectrumFloorDb, width, height, color, backgroundColor, gridColor, showGrid, showPeaks]);
 
   return (
     <div style={{
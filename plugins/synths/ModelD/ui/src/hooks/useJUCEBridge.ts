@@ -7,7 +7,7 @@
  *
  * Communication Flow:
  *   React -> JUCE: window.__JUCE__.postMessage() or registered native functions
- *   JUCE -> React: window.onParameterUpdate(), window.onAudioData(), etc.
+ *   JUCE -> React: window.onParametersUpdate(), window.onAudioData(), etc.
  */
 
 import { useState, useEffect, useCallback, useRef } from 'react';
@@ -37,13 +37,49 @@ declare global {
     };
     /** Called by JUCE when a parameter changes */
     onParameterUpdate?: (paramId: string, value: number) => void;
+    /** Called by JUCE once per UI tick with every parameter that changed */
+    onParametersUpdate?: (values: Record<string, number>) => void;
     /** Called by JUCE with all parameter state */
     onStateUpdate?: (state: Record<string, number>) => void;
     /** Called by JUCE with audio visualization data */
     onAudioData?: (samples: number[]) => void;
+    /** Called by JUCE with base64 Float32 scope samples (see decodeScopeSamples) */
+    onAudioDataBase64?: (data: string) => void;
+    /** Called by JUCE with base64 Float32 spectrum bands in dB (SpectrumAnalyzer.h) */
+    onSpectrumBase64?: (data: string) => void;
+    /** Called by JUCE when a block has missed its deadline (OverrunLog.h) */
+    onOverruns?: (log: OverrunLog) => void;
   }
 }
 
+/**
+ * One block that took longer than its buffer lasts; engine fields are
+ * null when the plugin doesn't have them
+ */
+export interface Overrun {
+  /** Stream time since playback was prepared */
+  seconds: number;
+  blockMs: number;
+  budgetMs: number;
+  samples: number;
+  voices: number | null;
+  quality: number | null;
+  governorStep: number | null;
+  effects: string[];
+}
+
+/** The last few overruns, oldest first, and how many there have been */
+export interface OverrunLog {
+  total: number;
+  worstLoad: number;
+  overruns: Overrun[];
+}
+
+/**
+ * Views that show live engine data; the editor ticks fast only while one is on screen
+ */
+export type LiveView = 'scope' | 'spectrum' | 'meters' | 'sequencer';
+
 /**
  * Hook configuration options
  */
@@ -54,6 +90,8 @@ export interface UseJUCEBridgeOptions {
   audioChannel?: 'lead' | 'drum' | 'sub' | 'master';
   /** Enable preset management */
   enablePresets?: boolean;
+  /** Live views on screen (default: ["scope", "spectrum"] with enableAudioData, else none) */
+  liveViews?: LiveView[];
 }
 
 /**
@@ -76,6 +114,10 @@ export interface UseJUCEBridgeReturn {
   juceInfo: JUCEInfo;
   /** Latest audio data samples for visualization */
   audioData: number[];
+  /** Latest output spectrum: log-spaced bands from 20 Hz to 20 kHz, in dB */
+  spectrumData: number[];
+  /** Blocks that missed their deadline since playback was prepared */
+  overrunLog: OverrunLog;
   /** Send parameter value to JUCE */
   setParameter: (paramId: string, value: number) => void;
   /** Request all parameters from JUCE */
@@ -97,6 +139,14 @@ const isJUCEWebView = (): boolean => {
   return typeof window !== 'undefined' && window.__JUCE__ !== undefined;
 };
 
+/**
+ * Decode scope samples sent by the editor: base64 of little-endian Float32
+ */
+const decodeScopeSamples = (data: string): number[] => {
+  const bytes = Uint8Array.from(atob(data), (c) => c.charCodeAt(0));
+  return Array.from(new Float32Array(bytes.buffer, 0, bytes.length >> 2));
+};
+
 /**
  * React hook for JUCE WebView integration
  *
@@ -114,11 +164,13 @@ const isJUCEWebView = (): boolean => {
  * ```
  */
 export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridgeReturn {
-  const { enableAudioData = false } = options;
+  const { enableAudioData = false, liveViews = enableAudioData ? ['scope', 'spectrum'] : [] } = options;
 
   const [isConnected, setIsConnected] = useState(false);
   const [juceInfo, setJuceInfo] = useState<JUCEInfo>({});
   const [audioData, setAudioData] = useState<number[]>([]);
+  const [spectrumData, setSpectrumData] = useState<number[]>([]);
+  const [overrunLog, setOverrunLog] = useState<OverrunLog>({ total: 0, worstLoad: 0, overruns: [] });
 
   // Callback refs for JUCE -> React communication
   const parameterCallbackRef = useRef<((paramId: string, value: number) => void) | null>(null);
@@ -163,6 +215,13 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     // Full state update handler
     window.onStateUpdate = (state: Record<string, number>) => {
       if (stateCallbackRef.current) {
@@ -170,17 +229,32 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Overruns come whenever there's a new one, audio data or not
+    window.onOverruns = (log: OverrunLog) => {
+      setOverrunLog(log);
+    };
+
     // Audio data handler
     if (enableAudioData) {
       window.onAudioData = (samples: number[]) => {
         setAudioData(samples);
       };
+      window.onAudioDataBase64 = (data: string) => {
+        setAudioData(decodeScopeSamples(data));
+      };
+      window.onSpectrumBase64 = (data: string) => {
+        setSpectrumData(decodeScopeSamples(data));
+      };
     }
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
       window.onAudioData = undefined;
+      window.onAudioDataBase64 = undefined;
+      window.onSpectrumBase64 = undefined;
+      window.onOverruns = undefined;
     };
   }, [isConnected, enableAudioData]);
 
@@ -194,6 +268,21 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     });
   }, [isConnected]);
 
+  // Tell the editor which live views are on screen (none while the page is
+  // hidden), so it only ticks fast and feeds the scope while they are
+  const liveViewKey = liveViews.join(',');
+  useEffect(() => {
+    if (!isConnected || liveViewKey === '') return;
+    const views = liveViewKey.split(',');
+    const report = () => callNativeFunction("setLiveViews", document.hidden ? [] : views);
+    report();
+    document.addEventListener('visibilitychange', report);
+    return () => {
+      document.removeEventListener('visibilitychange', report);
+      callNativeFunction("setLiveViews", []);
+    };
+  }, [isConnected, liveViewKey, callNativeFunction]);
+
   // Send parameter to JUCE
   const setParameter = useCallback((paramId: string, value: number) => {
     if (!isConnected) return;
@@ -233,6 +322,8 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     isConnected,
     juceInfo,
     audioData,
+    spectrumData,
+    overrunLog,
     setParameter,
     requestState,
     noteOn,
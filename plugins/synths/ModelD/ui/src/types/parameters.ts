@@ -160,6 +160,14 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: 0.0,
   },
 
+  analog_drift: {
+    id: 'analog_drift',
+    name: 'Analog Drift',
+    min: 0,
+    max: 1,
+    default: 0.0,
+  },
+
   // =========================================================================
   // FILTER PARAMETERS
   // =========================================================================
@@ -313,6 +321,15 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: 0,
   },
 
+  lfo_mode: {
+    id: 'lfo_mode',
+    name: 'LFO Mode',
+    min: 0,
+    max: 1,
+    default: 0,  // Global
+    step: 1,
+  },
+
   // =========================================================================
   // MASTER
   // =========================================================================
@@ -325,6 +342,60 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: -6,
     unit: 'dB',
   },
+
+  voice_steal: {
+    id: 'voice_steal',
+    name: 'Voice Steal',
+    min: 0,
+    max: 2,
+    default: 0,  // Oldest
+    step: 1,
+  },
+
+  voice_mode: {
+    id: 'voice_mode',
+    name: 'Voice Mode',
+    min: 0,
+    max: 1,
+    default: 0,  // Poly
+    step: 1,
+  },
+
+  para_trigger: {
+    id: 'para_trigger',
+    name: 'Para Trigger',
+    min: 0,
+    max: 1,
+    default: 0,  // First Note
+    step: 1,
+  },
+
+  mpe: {
+    id: 'mpe',
+    name: 'MPE',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
+
+  cpu_governor: {
+    id: 'cpu_governor',
+    name: 'CPU Governor',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
+
+  morph: {
+    id: 'morph',
+    name: 'Morph',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 0.001,
+  },
 };
 
 /**
@@ -359,6 +430,14 @@ export const LFO_WAVEFORM_OPTIONS = [
   { value: 4, label: 'S&H' },
 ];
 
+/**
+ * LFO Mode labels for UI display
+ */
+export const LFO_MODE_OPTIONS = [
+  { value: 0, label: 'Global' },
+  { value: 1, label: 'Voice' },
+];
+
 /**
  * Get parameters by category
  */
@@ -367,12 +446,12 @@ export function getParametersByCategory(category: ParameterCategory): ParameterD
     [ParameterCategory.OSCILLATOR_1]: ['osc1_waveform', 'osc1_octave', 'osc1_level'],
     [ParameterCategory.OSCILLATOR_2]: ['osc2_waveform', 'osc2_octave', 'osc2_detune', 'osc2_level', 'osc2_sync'],
     [ParameterCategory.OSCILLATOR_3]: ['osc3_waveform', 'osc3_octave', 'osc3_detune', 'osc3_level'],
-    [ParameterCategory.MIXER]: ['osc1_level', 'osc2_level', 'osc3_level', 'noise_level'],
+    [ParameterCategory.MIXER]: ['osc1_level', 'osc2_level', 'osc3_level', 'noise_level', 'analog_drift'],
     [ParameterCategory.FILTER]: ['filter_cutoff', 'filter_reso', 'filter_env_amount', 'filter_kbd_track'],
     [ParameterCategory.AMP_ENVELOPE]: ['amp_attack', 'amp_decay', 'amp_sustain', 'amp_release'],
     [ParameterCategory.FILTER_ENVELOPE]: ['filter_attack', 'filter_decay', 'filter_sustain', 'filter_release'],
-    [ParameterCategory.LFO]: ['lfo_rate', 'lfo_waveform', 'lfo_pitch_amount', 'lfo_filter_amount'],
-    [ParameterCategory.MASTER]: ['master_volume'],
+    [ParameterCategory.LFO]: ['lfo_rate', 'lfo_waveform', 'lfo_pitch_amount', 'lfo_filter_amount', 'lfo_mode'],
+    [ParameterCategory.MASTER]: ['master_volume', 'voice_steal', 'voice_mode', 'para_trigger', 'mpe', 'cpu_governor', 'morph'],
   };
 
   return categoryMap[category]
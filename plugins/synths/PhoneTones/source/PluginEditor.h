@@ -8,6 +8,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "EditorRefresh.h"
+#include "ParamChangeFlags.h"
 
 class PluginEditor : public juce::AudioProcessorEditor,
                      private juce::Timer
@@ -25,10 +27,15 @@ public:
 private:
     void timerCallback() override;
 
+    /** Match the timer to what's on screen; attaches the scope FIFO while it's wanted */
+    void updateRefreshRate();
+
     // WebView bridge methods
-    void sendParameterToWebView(const juce::String& paramId, float value);
+    void sendChangedParametersToWebView();
     void sendAllParametersToWebView();
     void sendAudioDataToWebView();
+    void sendOverrunsToWebView();
+    juce::var getPerfStatsForWebView() const;
     void handleParameterFromWebView(const juce::String& paramId, float value);
     void handleNoteFromWebView(int note, float velocity, bool isNoteOn);
     std::optional<juce::WebBrowserComponent::Resource> getResource(const juce::String& url);
@@ -40,20 +47,34 @@ private:
 #endif
 
     // Parameter listener for host -> UI updates
+    /** Flags its parameter as changed; can run on the audio thread */
     class ParameterListener : public juce::AudioProcessorValueTreeState::Listener
     {
     public:
-        explicit ParameterListener(PluginEditor& e) : editor(e) {}
-        void parameterChanged(const juce::String& paramId, float newValue) override
+        ParameterListener(PluginEditor& e, int i) : editor(e), index(i) {}
+        void parameterChanged(const juce::String&, float) override
         {
-            editor.sendParameterToWebView(paramId, newValue);
+            if (!editor.ignoreParameterCallbacks)
+                editor.changedParameters.mark(index);
         }
     private:
         PluginEditor& editor;
+        const int index;
     };
 
-    std::unique_ptr<ParameterListener> paramListener;
-    bool ignoreParameterCallbacks = false;
+    std::vector<std::unique_ptr<ParameterListener>> paramListeners;
+    juce::Array<juce::RangedAudioParameter*> listenedParameters;  // By listener index
+    ParamChangeFlags changedParameters;  // Sent by timerCallback()
+    std::atomic<bool> ignoreParameterCallbacks{false};
+
+    /** Newest output samples sent to the oscilloscope per timer tick */
+    static constexpr int SCOPE_WINDOW = 1024;
+    std::array<float, SCOPE_WINDOW> scopeSamples{};
+
+    /** Timer rate, from the window and the web UI's live views */
+    EditorRefresh refresh;
+
+    uint64_t lastOverrunTotal = 0;  // OverrunLog total last sent
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditor)
 };
@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -16,22 +17,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    toneModeParam = apvts.getRawParameterValue("tone_mode");
-    tone1FreqParam = apvts.getRawParameterValue("tone1_freq");
-    tone2FreqParam = apvts.getRawParameterValue("tone2_freq");
-    toneMixParam = apvts.getRawParameterValue("tone_mix");
-    filterLowParam = apvts.getRawParameterValue("filter_low");
-    filterHighParam = apvts.getRawParameterValue("filter_high");
-    filterDriveParam = apvts.getRawParameterValue("filter_drive");
-    noiseLevelParam = apvts.getRawParameterValue("noise_level");
-    noiseCrackleParam = apvts.getRawParameterValue("noise_crackle");
-    patternRateParam = apvts.getRawParameterValue("pattern_rate");
-    patternDutyParam = apvts.getRawParameterValue("pattern_duty");
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
-    masterLevelParam = apvts.getRawParameterValue("master_level");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -206,11 +197,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -222,52 +215,37 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    // No voices, tiers or effects to report: the time alone
+    return {};
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read parameters (lock-free via atomics)
-    int toneMode = static_cast<int>(toneModeParam->load());
-    float tone1Freq = tone1FreqParam->load();
-    float tone2Freq = tone2FreqParam->load();
-    float toneMix = toneMixParam->load();
-    float filterLow = filterLowParam->load();
-    float filterHigh = filterHighParam->load();
-    float filterDrive = filterDriveParam->load();
-    float noiseLevel = noiseLevelParam->load();
-    float noiseCrackle = noiseCrackleParam->load();
-    float patternRate = patternRateParam->load();
-    float patternDuty = patternDutyParam->load();
-    float attack = ampAttackParam->load();
-    float decay = ampDecayParam->load();
-    float sustain = ampSustainParam->load();
-    float release = ampReleaseParam->load();
-    float masterLevel = masterLevelParam->load();
-
-    // Update synth engine parameters
-    synthEngine.setToneMode(toneMode);
-    synthEngine.setTone1Freq(tone1Freq);
-    synthEngine.setTone2Freq(tone2Freq);
-    synthEngine.setToneMix(toneMix);
-    synthEngine.setFilterLow(filterLow);
-    synthEngine.setFilterHigh(filterHigh);
-    synthEngine.setFilterDrive(filterDrive);
-    synthEngine.setNoiseLevel(noiseLevel);
-    synthEngine.setNoiseCrackle(noiseCrackle);
-    synthEngine.setPatternRate(patternRate);
-    synthEngine.setPatternDuty(patternDuty);
-    synthEngine.setAttack(attack);
-    synthEngine.setDecay(decay);
-    synthEngine.setSustain(sustain);
-    synthEngine.setRelease(release);
-    synthEngine.setMasterLevel(masterLevel);
+    // Read parameters (lock-free via atomics) and update the ones that changed
+    params.update();
+    synthEngine.applySnapshot(params);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -287,19 +265,16 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
     }
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -317,18 +292,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
@@ -9,6 +9,9 @@
 #include <array>
 #include <atomic>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 class PluginProcessor : public juce::AudioProcessor
 {
@@ -43,32 +46,31 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     // Visualization data
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
 
 private:
     SynthEngine synthEngine;
-    std::array<float, 512> visualizationBuffer{};
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+    UiNoteFifo uiNotes;
 
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    // Cached parameter pointers for lock-free audio thread access
-    std::atomic<float>* toneModeParam = nullptr;
-    std::atomic<float>* tone1FreqParam = nullptr;
-    std::atomic<float>* tone2FreqParam = nullptr;
-    std::atomic<float>* toneMixParam = nullptr;
-    std::atomic<float>* filterLowParam = nullptr;
-    std::atomic<float>* filterHighParam = nullptr;
-    std::atomic<float>* filterDriveParam = nullptr;
-    std::atomic<float>* noiseLevelParam = nullptr;
-    std::atomic<float>* noiseCrackleParam = nullptr;
-    std::atomic<float>* patternRateParam = nullptr;
-    std::atomic<float>* patternDutyParam = nullptr;
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
-    std::atomic<float>* masterLevelParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
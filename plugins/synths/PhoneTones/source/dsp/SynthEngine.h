@@ -6,8 +6,27 @@
 #pragma once
 
 #include "Voice.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
+#include <algorithm>
 #include <array>
 
+/**
+ * @brief One tone for SynthEngine::renderTones
+ */
+struct ToneRequest
+{
+    int note = 60;
+    float velocity = 1.0f;
+    int gateSamples = 0;      // Note-off this many samples in; 0 holds the note throughout
+    int numSamples = 0;       // Length of output
+    float* output = nullptr;  // Mono, overwritten
+    uint32_t seed = 1;        // Noise seed, so every tone renders the same each time
+};
+
 /**
  * @brief Monophonic synth engine for Phone Tones
  */
@@ -23,6 +42,7 @@ public:
     {
         this->sampleRate = sampleRate;
         voice.prepare(sampleRate);
+        perfStats.prepare(sampleRate);
     }
 
     void releaseResources()
@@ -30,38 +50,122 @@ public:
         voice.kill();
     }
 
-    void noteOn(int note, float velocity, int /*samplePosition*/)
+    /** Fix the noise so renders repeat exactly (default: clock-seeded) */
+    void setNoiseSeed(uint32_t seed) { voice.setNoiseSeed(NoiseSource::deriveSeed(seed, 0)); }
+
+    void noteOn(int note, float velocity, int samplePosition = 0)
     {
+        if (samplePosition > 0 && eventQueue.push({MidiEvent::Type::NoteOn, samplePosition, note, velocity}))
+            return;
+
         // Monophonic - just retrigger the single voice
         voice.noteOn(note, velocity);
     }
 
-    void noteOff(int note, int /*samplePosition*/)
+    void noteOff(int note, int samplePosition = 0)
     {
+        if (samplePosition > 0 && eventQueue.push({MidiEvent::Type::NoteOff, samplePosition, note}))
+            return;
+
         if (voice.getNote() == note)
         {
             voice.noteOff();
         }
     }
 
-    void allNotesOff()
+    void allNotesOff(int samplePosition = 0)
     {
+        if (samplePosition > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, samplePosition}))
+            return;
+
         voice.kill();
     }
 
-    void setPitchBend(float /*bend*/)
+    void setPitchBend(float /*bend*/, int /*samplePosition*/ = 0)
     {
         // Not used for telephone tones
     }
 
     void renderBlock(float* leftChannel, float* rightChannel, int numSamples)
     {
-        if (voice.isActive())
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
+
+        perfStats.beginBlock();
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            // Split the block at queued MIDI events so they land on their sample
+            eventQueue.process(numSamples,
+                [this, leftChannel, rightChannel](int start, int count)
+                {
+                    if (voice.isActive())
+                        voice.render(leftChannel + start, rightChannel + start, count);
+                },
+                [this](const MidiEvent& event)
+                {
+                    switch (event.type)
+                    {
+                    case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+                    case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+                    case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+                    default: break;  // No pitch bend or expression
+                    }
+                });
+        }
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, voice.isActive() ? 1 : 0);
+    }
+
+    /**
+     * @brief Render a batch of tones offline, each from silence, with the current settings
+     *
+     * For generating test signals faster than real time: no MIDI queue or
+     * perf counters, and every request gets a fresh copy of the configured
+     * voice, so the live voice is untouched and each tone only depends on
+     * its own request.
+     */
+    void renderTones(const ToneRequest* requests, int count)
+    {
+        ScopedFlushDenormals noDenormals;
+
+        alignas(16) float scratch[Voice::BLOCK_SIZE];
+        for (int r = 0; r < count; ++r)
         {
-            voice.render(leftChannel, rightChannel, numSamples);
+            const ToneRequest& req = requests[r];
+            if (req.output == nullptr || req.numSamples <= 0)
+                continue;
+            std::fill(req.output, req.output + req.numSamples, 0.0f);
+
+            Voice tone = voice;
+            tone.prepare(sampleRate);
+            tone.setNoiseSeed(NoiseSource::deriveSeed(req.seed, 0));
+            tone.noteOn(req.note, req.velocity);
+
+            int pos = 0;
+            while (pos < req.numSamples && tone.isActive())
+            {
+                // Stop each chunk at the note-off so it lands on its sample
+                int end = std::min(req.numSamples, pos + Voice::BLOCK_SIZE);
+                if (pos < req.gateSamples)
+                    end = std::min(end, req.gateSamples);
+
+                tone.render(req.output + pos, scratch, end - pos);  // Right is a copy of left
+                pos = end;
+
+                if (pos == req.gateSamples)
+                    tone.noteOff();
+            }
         }
     }
 
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance (see MemoryReport.h); nothing is allocated */
+    MemoryReport memoryReport() const { return MemoryReport(sizeof(*this)); }
+
     //==========================================================================
     // Parameter Setters - forwarded to voice
     //==========================================================================
@@ -83,7 +187,34 @@ public:
     void setRelease(float seconds) { voice.setRelease(seconds); }
     void setMasterLevel(float level) { voice.setMasterLevel(level); }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        if (p.changed(kToneMode)) setToneMode(p.index(kToneMode));
+        if (p.changed(kTone1Freq)) setTone1Freq(p[kTone1Freq]);
+        if (p.changed(kTone2Freq)) setTone2Freq(p[kTone2Freq]);
+        if (p.changed(kToneMix)) setToneMix(p[kToneMix]);
+        if (p.changed(kFilterLow)) setFilterLow(p[kFilterLow]);
+        if (p.changed(kFilterHigh)) setFilterHigh(p[kFilterHigh]);
+        if (p.changed(kFilterDrive)) setFilterDrive(p[kFilterDrive]);
+        if (p.changed(kNoiseLevel)) setNoiseLevel(p[kNoiseLevel]);
+        if (p.changed(kNoiseCrackle)) setNoiseCrackle(p[kNoiseCrackle]);
+        if (p.changed(kPatternRate)) setPatternRate(p[kPatternRate]);
+        if (p.changed(kPatternDuty)) setPatternDuty(p[kPatternDuty]);
+        if (p.changed(kAmpAttack)) setAttack(p[kAmpAttack]);
+        if (p.changed(kAmpDecay)) setDecay(p[kAmpDecay]);
+        if (p.changed(kAmpSustain)) setSustain(p[kAmpSustain]);
+        if (p.changed(kAmpRelease)) setRelease(p[kAmpRelease]);
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+    }
+
 private:
     double sampleRate = 44100.0;
     Voice voice;
+    MidiEventQueue eventQueue;  // Events scheduled later in the current block
+    PerfStats perfStats;        // Per-block CPU counters, read by the editor
 };
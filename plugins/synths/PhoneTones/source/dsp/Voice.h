@@ -3,7 +3,7 @@
  * @brief Phone Tones synthesizer voice - DTMF, dial tones, and telephone sounds
  *
  * Features:
- * - Dual sine oscillators for DTMF/dial tones
+ * - Dual sine oscillators for DTMF/dial tones (recursive quadrature pair)
  * - Noise generator for line static
  * - Bandpass filter for telephone frequency response (300-3400 Hz)
  * - Pattern generator for automated tone sequences
@@ -17,7 +17,12 @@
 #include <cmath>
 #include <array>
 #include <algorithm>
-#include <random>
+#include <cstdint>
+
+#include "sst/basic-blocks/dsp/QuadratureOscillators.h"
+
+#include "FastMath.h"
+#include "Noise.h"
 
 /**
  * @brief Tone mode presets
@@ -50,6 +55,118 @@ namespace DTMFFrequencies
     constexpr float HIGH_1633 = 1633.0f;
 }
 
+/**
+ * @brief The two sines behind every mode, as recursive quadrature oscillators
+ *
+ * Each tone is a QuadratureOscillator: a rotation by omega per sample, so a
+ * sample costs a few multiplies instead of a std::sin. The rotation only
+ * needs recomputing when a frequency moves (every block in Modem mode, never
+ * in the fixed-pair modes). Rounding slowly changes the amplitude, so each
+ * block pulls (cos, sin) back onto the unit circle with one Newton step.
+ */
+class ToneBank
+{
+public:
+    /** Both tones back to phase 0 (sin = 0), as the phase accumulators were */
+    void reset()
+    {
+        osc1.u = 1.0f;
+        osc1.v = 0.0f;
+        osc2.u = 1.0f;
+        osc2.v = 0.0f;
+    }
+
+    void setFrequencies(float f1, float f2, double sampleRate)
+    {
+        const float toOmega = 6.28318530718f / static_cast<float>(sampleRate);
+        if (f1 != freq1)
+        {
+            freq1 = f1;
+            osc1.setRate(f1 * toOmega);
+        }
+        if (f2 != freq2)
+        {
+            freq2 = f2;
+            osc2.setRate(f2 * toOmega);
+        }
+    }
+
+    /** out[i] = sin1 * (1 - mix) + sin2 * mix */
+    void render(float* out, int numSamples, float mix)
+    {
+        renormalize(osc1);
+        renormalize(osc2);
+
+        const float g1 = 1.0f - mix;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            out[i] = osc1.v * g1 + osc2.v * mix;
+            osc1.step();
+            osc2.step();
+        }
+    }
+
+private:
+    using Oscillator = sst::basic_blocks::dsp::QuadratureOscillator<float>;
+
+    static void renormalize(Oscillator& osc)
+    {
+        const float scale = 0.5f * (3.0f - (osc.u * osc.u + osc.v * osc.v));
+        osc.u *= scale;
+        osc.v *= scale;
+    }
+
+    Oscillator osc1;
+    Oscillator osc2;
+    float freq1 = -1.0f;
+    float freq2 = -1.0f;
+};
+
+/**
+ * @brief Busy/ring cadence as a sample schedule: on for onSamples of every periodSamples
+ *
+ * The rate and duty are turned into whole sample counts once, when they
+ * change, and each block's gate is written as runs of 1s and 0s rather than
+ * by comparing a phase every sample.
+ */
+class CadenceSchedule
+{
+public:
+    void configure(float rate, float duty, double sampleRate)
+    {
+        periodSamples = std::max(1, static_cast<int>(std::lround(sampleRate / rate)));
+        onSamples = std::clamp(static_cast<int>(std::lround(duty * static_cast<float>(periodSamples))), 0, periodSamples);
+        position %= periodSamples;
+    }
+
+    void reset() { position = 0; }
+
+    /** Write the next numSamples of gate (1 on, 0 off) */
+    void render(float* gate, int numSamples)
+    {
+        int i = 0;
+        while (i < numSamples)
+        {
+            const bool on = position < onSamples;
+            const int runEnd = on ? onSamples : periodSamples;
+            const int run = std::min(numSamples - i, runEnd - position);
+            std::fill(gate + i, gate + i + run, on ? 1.0f : 0.0f);
+            i += run;
+            position += run;
+            if (position >= periodSamples)
+                position = 0;
+        }
+    }
+
+    int getPeriodSamples() const { return periodSamples; }
+    int getOnSamples() const { return onSamples; }
+
+private:
+    int periodSamples = 22050;
+    int onSamples = 11025;
+    int position = 0;
+};
+
 /**
  * @brief Single synthesizer voice for Phone Tones
  */
@@ -60,7 +177,7 @@ public:
     static constexpr float PI = 3.14159265359f;
     static constexpr float TWO_PI = 6.28318530718f;
 
-    Voice() : rng(std::random_device{}()) {}
+    Voice() = default;
     ~Voice() = default;
 
     //==========================================================================
@@ -70,14 +187,15 @@ public:
     void prepare(double sr)
     {
         sampleRate = sr;
-        phase1 = 0.0f;
-        phase2 = 0.0f;
-        patternPhase = 0.0f;
+        tones.reset();
+        cadence.configure(patternRate, patternDuty, sampleRate);
+        cadence.reset();
         envLevel = 0.0f;
         envStage = EnvStage::Idle;
 
         // Initialize filter coefficients for telephone bandpass
         updateFilterCoefficients();
+        bpX1 = bpX2 = bpY1 = bpY2 = 0.0f;
     }
 
     //==========================================================================
@@ -93,9 +211,8 @@ public:
         age = 0;
 
         // Reset oscillator phases
-        phase1 = 0.0f;
-        phase2 = 0.0f;
-        patternPhase = 0.0f;
+        tones.reset();
+        cadence.reset();
 
         // Modem mode: start sweep
         modemSweepPhase = 0.0f;
@@ -150,6 +267,9 @@ public:
     bool isActive() const { return active; }
     bool isReleasing() const { return releasing; }
     int getNote() const { return currentNote; }
+
+    /** Restart the noise sequence (reproducible renders, see Noise.h) */
+    void setNoiseSeed(uint32_t seed) { rng.reseed(seed); }
     float getVelocity() const { return velocity; }
     int getAge() const { return age; }
 
@@ -166,8 +286,8 @@ public:
     void setFilterDrive(float drv) { filterDrive = std::clamp(drv, 0.0f, 1.0f); }
     void setNoiseLevel(float level) { noiseLevel = std::clamp(level, 0.0f, 1.0f); }
     void setNoiseCrackle(float crackle) { noiseCrackle = std::clamp(crackle, 0.0f, 1.0f); }
-    void setPatternRate(float rate) { patternRate = std::clamp(rate, 0.1f, 10.0f); }
-    void setPatternDuty(float duty) { patternDuty = std::clamp(duty, 0.0f, 1.0f); }
+    void setPatternRate(float rate) { patternRate = std::clamp(rate, 0.1f, 10.0f); cadence.configure(patternRate, patternDuty, sampleRate); }
+    void setPatternDuty(float duty) { patternDuty = std::clamp(duty, 0.0f, 1.0f); cadence.configure(patternRate, patternDuty, sampleRate); }
     void setAttack(float seconds) { attackTime = std::max(0.001f, seconds); }
     void setDecay(float seconds) { decayTime = std::max(0.001f, seconds); }
     void setSustain(float level) { sustainLevel = std::clamp(level, 0.0f, 1.0f); }
@@ -263,39 +383,24 @@ private:
         float freq1, freq2;
         getFrequencies(freq1, freq2);
 
-        float phaseInc1 = freq1 / static_cast<float>(sampleRate);
-        float phaseInc2 = freq2 / static_cast<float>(sampleRate);
-        float patternInc = patternRate / static_cast<float>(sampleRate);
+        // ================================================================
+        // DUAL SINE OSCILLATORS, gated by the busy/ring cadence
+        // ================================================================
+        alignas(16) float tone[BLOCK_SIZE];
+        tones.setFrequencies(freq1, freq2, sampleRate);
+        tones.render(tone, blockSize, toneMix);
 
-        for (int i = 0; i < blockSize; ++i)
+        if (toneMode == ToneMode::Busy || toneMode == ToneMode::Ring)
         {
-            // ================================================================
-            // PATTERN GENERATOR (for busy/ring cadence)
-            // ================================================================
-            float patternGate = 1.0f;
-            if (toneMode == ToneMode::Busy || toneMode == ToneMode::Ring)
-            {
-                patternGate = (patternPhase < patternDuty) ? 1.0f : 0.0f;
-                patternPhase += patternInc;
-                if (patternPhase >= 1.0f)
-                    patternPhase -= 1.0f;
-            }
-
-            // ================================================================
-            // DUAL SINE OSCILLATORS
-            // ================================================================
-            float osc1 = std::sin(phase1 * TWO_PI);
-            float osc2 = std::sin(phase2 * TWO_PI);
-
-            phase1 += phaseInc1;
-            phase2 += phaseInc2;
-
-            if (phase1 >= 1.0f) phase1 -= 1.0f;
-            if (phase2 >= 1.0f) phase2 -= 1.0f;
+            alignas(16) float gate[BLOCK_SIZE];
+            cadence.render(gate, blockSize);
+            for (int i = 0; i < blockSize; ++i)
+                tone[i] *= gate[i];
+        }
 
-            // Mix oscillators based on toneMix
-            float toneOut = osc1 * (1.0f - toneMix) + osc2 * toneMix;
-            toneOut *= patternGate;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            float toneOut = tone[i];
 
             // ================================================================
             // NOISE GENERATOR (line static)
@@ -304,16 +409,16 @@ private:
             if (noiseLevel > 0.0f)
             {
                 // Base white noise
-                float whiteNoise = noiseDist(rng);
+                float whiteNoise = rng.unifPM1();
 
                 // Crackle: occasional pops
                 float crackle = 0.0f;
                 if (noiseCrackle > 0.0f)
                 {
                     float crackleProb = noiseCrackle * 0.001f;
-                    if (crackleDist(rng) < crackleProb)
+                    if (rng.unif01() < crackleProb)
                     {
-                        crackle = (crackleDist(rng) > 0.5f ? 1.0f : -1.0f) * 0.5f;
+                        crackle = (rng.unif01() > 0.5f ? 1.0f : -1.0f) * 0.5f;
                     }
                 }
 
@@ -336,7 +441,7 @@ private:
             if (filterDrive > 0.0f)
             {
                 float driveAmount = 1.0f + filterDrive * 3.0f;
-                filtered = std::tanh(filtered * driveAmount) / driveAmount;
+                filtered = FastMath::tanh(filtered * driveAmount) / driveAmount;
             }
 
             // ================================================================
@@ -482,10 +587,9 @@ private:
 
     double sampleRate = 44100.0;
 
-    // Oscillator phases
-    float phase1 = 0.0f;
-    float phase2 = 0.0f;
-    float patternPhase = 0.0f;
+    // Oscillators and cadence
+    ToneBank tones;
+    CadenceSchedule cadence;
     float modemSweepPhase = 0.0f;
 
     // Envelope state
@@ -499,9 +603,7 @@ private:
     float bpA1 = 0.0f, bpA2 = 0.0f;
 
     // Random number generator for noise
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> noiseDist{-1.0f, 1.0f};
-    std::uniform_real_distribution<float> crackleDist{0.0f, 1.0f};
+    NoiseSource rng;
 
     //==========================================================================
     // Parameters
@@ -6,7 +6,10 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include "dsp/Voice.h"
+#include "dsp/SynthEngine.h"
+#include "RealtimeGuard.h"
 #include <vector>
+#include <array>
 #include <cmath>
 
 TEST_CASE("Voice initializes correctly", "[voice]")
@@ -116,3 +119,132 @@ TEST_CASE("DTMF mode generates different frequencies per note", "[voice]")
 
     REQUIRE(different);
 }
+
+TEST_CASE("Tone bank and cadence schedule", "[voice]")
+{
+    SECTION("Quadrature tones track std::sin")
+    {
+        ToneBank tones;
+        tones.reset();
+        tones.setFrequencies(697.0f, 1209.0f, 44100.0);
+
+        // A full second, so rounding has had time to build up
+        float block[32];
+        float maxError = 0.0f;
+        for (int b = 0; b < 44100 / 32; ++b)
+        {
+            tones.render(block, 32, 0.5f);
+            for (int i = 0; i < 32; ++i)
+            {
+                const double t = static_cast<double>(b * 32 + i) / 44100.0;
+                const double expected = 0.5 * std::sin(6.283185307179586 * 697.0 * t)
+                                      + 0.5 * std::sin(6.283185307179586 * 1209.0 * t);
+                maxError = std::max(maxError, static_cast<float>(std::abs(block[i] - expected)));
+            }
+        }
+        REQUIRE(maxError < 1.0e-3f);
+    }
+
+    SECTION("Cadence gates whole sample runs")
+    {
+        CadenceSchedule cadence;
+        cadence.configure(2.0f, 0.5f, 44100.0);
+        REQUIRE(cadence.getPeriodSamples() == 22050);
+        REQUIRE(cadence.getOnSamples() == 11025);
+
+        // Odd chunk sizes: the schedule must not care where blocks split
+        std::vector<float> gate(44100);
+        int pos = 0;
+        while (pos < 44100)
+        {
+            const int n = std::min(37, 44100 - pos);
+            cadence.render(gate.data() + pos, n);
+            pos += n;
+        }
+        REQUIRE(gate[0] == 1.0f);
+        REQUIRE(gate[11024] == 1.0f);
+        REQUIRE(gate[11025] == 0.0f);
+        REQUIRE(gate[22049] == 0.0f);
+        REQUIRE(gate[22050] == 1.0f);
+
+        int on = 0;
+        for (float g : gate)
+            on += g > 0.0f ? 1 : 0;
+        REQUIRE(on == 22050);
+    }
+}
+
+TEST_CASE("renderTones renders a batch offline, repeatably", "[engine]")
+{
+    SynthEngine engine;
+    engine.prepare(44100.0, 512);
+    engine.setToneMode(3);  // DTMF
+    engine.setNoiseLevel(0.2f);
+
+    std::vector<float> a(8000), b(8000), c(8000);
+    ToneRequest requests[] = {
+        {48, 1.0f, 4000, 8000, a.data(), 7},
+        {49, 1.0f, 4000, 8000, b.data(), 7},
+        {48, 1.0f, 4000, 8000, c.data(), 7},
+    };
+    engine.renderTones(requests, 3);
+
+    // Same request, same output, whatever ran before it
+    REQUIRE(a == c);
+
+    float peakA = 0.0f, tail = 0.0f;
+    bool differs = false;
+    for (int i = 0; i < 8000; ++i)
+    {
+        peakA = std::max(peakA, std::abs(a[i]));
+        differs = differs || a[i] != b[i];
+        if (i > 7000)
+            tail = std::max(tail, std::abs(a[i]));
+    }
+    REQUIRE(peakA > 0.05f);
+    REQUIRE(differs);
+    REQUIRE(tail == 0.0f);  // Released at 4000, silent well before the end
+}
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // One voice, nothing allocated
+    constexpr size_t BUDGET = 32u << 10;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    INFO(at48k.toString());
+
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+    REQUIRE(at48k.getHeapBytes() == 0);
+    REQUIRE(reports[1].second.getInstanceBytes() == at48k.getInstanceBytes());
+    CHECK(at48k.getInstanceBytes() <= BUDGET);
+}
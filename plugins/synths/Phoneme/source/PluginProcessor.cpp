@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -16,21 +17,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    oscWaveformParam = apvts.getRawParameterValue("osc_waveform");
-    oscTuneParam = apvts.getRawParameterValue("osc_tune");
-    oscPwParam = apvts.getRawParameterValue("osc_pw");
-    vowelParam = apvts.getRawParameterValue("vowel");
-    formantShiftParam = apvts.getRawParameterValue("formant_shift");
-    formantSpreadParam = apvts.getRawParameterValue("formant_spread");
-    vibratoRateParam = apvts.getRawParameterValue("vibrato_rate");
-    vibratoDepthParam = apvts.getRawParameterValue("vibrato_depth");
-    vowelLfoRateParam = apvts.getRawParameterValue("vowel_lfo_rate");
-    vowelLfoDepthParam = apvts.getRawParameterValue("vowel_lfo_depth");
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
-    masterLevelParam = apvts.getRawParameterValue("master_level");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -52,7 +44,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         juce::ParameterID{"osc_waveform", 1},
         "Waveform",
-        juce::StringArray{"Saw", "Pulse"},
+        juce::StringArray{"Saw", "Pulse", "Glottal"},
         0  // Default: Saw
     ));
 
@@ -193,11 +185,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -209,50 +203,38 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = synthEngine.getActiveVoiceCount();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read parameters (lock-free via atomics)
-    int waveform = static_cast<int>(oscWaveformParam->load());
-    float tune = oscTuneParam->load();
-    float pulseWidth = oscPwParam->load();
-    float vowel = vowelParam->load();
-    float formantShift = formantShiftParam->load();
-    float formantSpread = formantSpreadParam->load();
-    float vibratoRate = vibratoRateParam->load();
-    float vibratoDepth = vibratoDepthParam->load();
-    float vowelLfoRate = vowelLfoRateParam->load();
-    float vowelLfoDepth = vowelLfoDepthParam->load();
-    float attack = ampAttackParam->load();
-    float decay = ampDecayParam->load();
-    float sustain = ampSustainParam->load();
-    float release = ampReleaseParam->load();
-    float masterLevel = masterLevelParam->load();
-
-    // Update synth engine parameters
-    synthEngine.setWaveform(waveform);
-    synthEngine.setTune(tune);
-    synthEngine.setPulseWidth(pulseWidth);
-    synthEngine.setVowel(vowel);
-    synthEngine.setFormantShift(formantShift);
-    synthEngine.setFormantSpread(formantSpread);
-    synthEngine.setVibratoRate(vibratoRate);
-    synthEngine.setVibratoDepth(vibratoDepth);
-    synthEngine.setVowelLfoRate(vowelLfoRate);
-    synthEngine.setVowelLfoDepth(vowelLfoDepth);
-    synthEngine.setAttack(attack);
-    synthEngine.setDecay(decay);
-    synthEngine.setSustain(sustain);
-    synthEngine.setRelease(release);
-    synthEngine.setMasterLevel(masterLevel);
+    // Read parameters (lock-free via atomics) and update the ones that changed
+    params.update();
+    synthEngine.applySnapshot(params);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -272,24 +254,21 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition);
         }
     }
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -307,18 +286,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
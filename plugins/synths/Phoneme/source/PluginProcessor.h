@@ -7,6 +7,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 /**
  * @brief Main audio processor class for Phoneme
@@ -49,7 +52,14 @@ public:
     //==========================================================================
 
     juce::AudioProcessorValueTreeState apvts;
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
 
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -61,24 +71,11 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters
+    // Parameters
     //==========================================================================
 
-    std::atomic<float>* oscWaveformParam = nullptr;
-    std::atomic<float>* oscTuneParam = nullptr;
-    std::atomic<float>* oscPwParam = nullptr;
-    std::atomic<float>* vowelParam = nullptr;
-    std::atomic<float>* formantShiftParam = nullptr;
-    std::atomic<float>* formantSpreadParam = nullptr;
-    std::atomic<float>* vibratoRateParam = nullptr;
-    std::atomic<float>* vibratoDepthParam = nullptr;
-    std::atomic<float>* vowelLfoRateParam = nullptr;
-    std::atomic<float>* vowelLfoDepthParam = nullptr;
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
-    std::atomic<float>* masterLevelParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     //==========================================================================
     // State
@@ -86,7 +83,14 @@ private:
 
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
-    std::array<float, 512> visualizationBuffer{};
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -10,6 +10,12 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
+#include "ActiveVoiceList.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
 
 /**
  * @brief Main synthesizer engine
@@ -31,6 +37,7 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
 
         for (auto& voice : voices)
         {
@@ -52,7 +59,8 @@ public:
 
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        (void)sampleOffset;
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -65,32 +73,42 @@ public:
         {
             applyParametersToVoice(*voice);
             voice->noteOn(note, velocity);
+            active.add(static_cast<int>(voice - voices.data()));
         }
     }
 
     void noteOff(int note, int sampleOffset = 0)
     {
-        (void)sampleOffset;
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
-        for (auto& voice : voices)
+        for (int v : active)
         {
-            if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
+            Voice& voice = voices[v];
+            if (voice.getNote() == note && !voice.isReleasing())
             {
                 voice.noteOff();
             }
         }
     }
 
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voices[v].kill();
         }
+        active.clear();
     }
 
-    void setPitchBend(float bend)
+    void setPitchBend(float bend, int sampleOffset = 0)
     {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend}))
+            return;
+
         pitchBend = bend;
     }
 
@@ -100,25 +118,20 @@ public:
 
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
+        perfStats.beginBlock();
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
             {
-                applyParametersToVoice(voice);
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+                renderVoices(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
 
-        // Apply master volume
-        float gain = masterGain;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            outputL[i] = mixBufferL[i] * gain;
-            outputR[i] = mixBufferR[i] * gain;
-        }
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
     //==========================================================================
@@ -146,34 +159,114 @@ public:
         masterGain = volumeLinear;
     }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        if (p.changed(kOscWaveform)) setWaveform(p.index(kOscWaveform));
+        if (p.changed(kOscTune)) setTune(p[kOscTune]);
+        if (p.changed(kOscPw)) setPulseWidth(p[kOscPw]);
+        if (p.changed(kVowel)) setVowel(p[kVowel]);
+        if (p.changed(kFormantShift)) setFormantShift(p[kFormantShift]);
+        if (p.changed(kFormantSpread)) setFormantSpread(p[kFormantSpread]);
+        if (p.changed(kVibratoRate)) setVibratoRate(p[kVibratoRate]);
+        if (p.changed(kVibratoDepth)) setVibratoDepth(p[kVibratoDepth]);
+        if (p.changed(kVowelLfoRate)) setVowelLfoRate(p[kVowelLfoRate]);
+        if (p.changed(kVowelLfoDepth)) setVowelLfoDepth(p[kVowelLfoDepth]);
+        if (p.changed(kAmpAttack)) setAttack(p[kAmpAttack]);
+        if (p.changed(kAmpDecay)) setDecay(p[kAmpDecay]);
+        if (p.changed(kAmpSustain)) setSustain(p[kAmpSustain]);
+        if (p.changed(kAmpRelease)) setRelease(p[kAmpRelease]);
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+    }
+
     //==========================================================================
     // State Queries
     //==========================================================================
 
-    int getActiveVoiceCount() const
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
     {
-        int count = 0;
-        for (const auto& voice : voices)
+        MemoryReport report(sizeof(*this));
+        report.addInline("voices", sizeof(voices));
+        report.addInline("mix buffers", sizeof(mixBufferL) + sizeof(mixBufferR));
+        report.addShared("pitch tables", sizeof(PitchTables));
+        report.addShared("formant tables", sizeof(FormantTables));
+        report.addShared("vowel table", sizeof(VowelTable));
+        if (auto glottal = WavetableRegistry::get().builtin(WavetableRegistry::Builtin::Glottal))
+            report.addShared("glottal table", glottal->getMemoryBytes());
+        return report;
+    }
+
+private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** Render one sub-block between MIDI events */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
+    {
+        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
+        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+            active.update([&](int v)
+            {
+                Voice& voice = voices[v];
+                applyParametersToVoice(voice);
+                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+                return voice.isActive();
+            });
+        }
+
         {
-            if (voice.isActive())
-                ++count;
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+
+            // Apply master volume
+            float gain = masterGain;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] = mixBufferL[i] * gain;
+                outputR[i] = mixBufferR[i] * gain;
+            }
+        }
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value); break;
+        default: break;
         }
-        return count;
     }
 
-private:
     //==========================================================================
     // Voice Management
     //==========================================================================
 
-    Voice* findFreeVoice(int note)
+    Voice* findFreeVoice(int /*note*/)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
+        // First, any voice not on the active list
+        if (!active.isFull())
         {
-            if (!voice.isActive())
+            for (int v = 0; v < MAX_VOICES; ++v)
             {
-                return &voice;
+                if (!active.contains(v))
+                    return &voices[v];
             }
         }
 
@@ -240,6 +333,9 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** The voices sounding, the only ones rendered, released or counted */
+    ActiveVoiceList<MAX_VOICES> active;
+
     //==========================================================================
     // Mix Buffers
     //==========================================================================
@@ -256,6 +352,12 @@ private:
     float pitchBend = 0.0f;
     float masterGain = 0.8f;
 
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
     //==========================================================================
     // Global Parameters
     //==========================================================================
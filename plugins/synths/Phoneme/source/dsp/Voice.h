@@ -3,14 +3,15 @@
  * @brief Single synthesizer voice for Phoneme formant synthesizer
  *
  * Features:
- * - Saw/Pulse oscillator (harmonically rich source)
- * - 3 parallel bandpass formant filters (F1, F2, F3)
+ * - Saw/Pulse oscillator (harmonically rich source), or a glottal pulse
+ *   from a shared mip-mapped wavetable (Wavetable.h), PW its open phase
+ * - 4 parallel bandpass formant filters (F1-F4), the lanes of one SIMD CytomicSVF
  * - Vowel morphing (A, E, I, O, U)
  * - Vibrato LFO for pitch modulation
  * - Vowel LFO for automatic vowel morphing
  *
  * Signal Flow:
- *   Oscillator -> [F1 + F2 + F3 parallel BP filters] -> Amp Envelope -> Output
+ *   Oscillator -> [F1 + F2 + F3 + F4 parallel BP filters] -> Amp Envelope -> Output
  */
 
 #pragma once
@@ -18,6 +19,14 @@
 #include <cmath>
 #include <array>
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "ConstexprTables.h"
+#include "PitchTables.h"
+#include "Wavetable.h"
+#include "sst/filters/CytomicSVF.h"
 
 /**
  * @brief Waveform types
@@ -25,7 +34,8 @@
 enum class WaveformType
 {
     Saw = 0,
-    Pulse = 1
+    Pulse = 1,
+    Glottal = 2
 };
 
 /**
@@ -42,59 +52,134 @@ enum class Vowel
 
 /**
  * @brief Formant frequency data for vowels
- * Each vowel has 3 formant frequencies (F1, F2, F3)
+ * Each vowel has 4 formant frequencies (F1-F4)
  */
 struct FormantData
 {
     float f1;  // First formant
     float f2;  // Second formant
     float f3;  // Third formant
+    float f4;  // Fourth formant
+};
+
+/** A, E, I, O, U */
+inline constexpr FormantData VOWEL_FORMANTS[5] = {
+    { 800.0f, 1200.0f, 2500.0f, 3500.0f },  // A
+    { 400.0f, 2000.0f, 2600.0f, 3500.0f },  // E
+    { 300.0f, 2300.0f, 3000.0f, 3700.0f },  // I
+    { 500.0f,  800.0f, 2300.0f, 3300.0f },  // O
+    { 350.0f,  700.0f, 2500.0f, 3300.0f }   // U
 };
 
+/** The formants @p vowelPos (0-5, A to U and round to A) of the way round the vowels */
+inline FormantData interpolateVowels(float vowelPos)
+{
+    const int v1 = std::min(static_cast<int>(vowelPos), 4);
+    const int v2 = (v1 + 1) % 5;
+    const float frac = vowelPos - static_cast<float>(v1);
+    const FormantData& a = VOWEL_FORMANTS[v1];
+    const FormantData& b = VOWEL_FORMANTS[v2];
+    return {a.f1 + (b.f1 - a.f1) * frac, a.f2 + (b.f2 - a.f2) * frac, a.f3 + (b.f3 - a.f3) * frac,
+            a.f4 + (b.f4 - a.f4) * frac};
+}
+
 /**
- * @brief Simple 2-pole State Variable Filter for formant filtering
+ * @brief Formant bandpass prewarping without std::tan
+ *
+ * A formant's SVF coefficient is g = tan(pi * f / sampleRate). The table
+ * holds tan(pi * x) over normalised frequency x in [0, MAX_NORM], so one
+ * table serves every sample rate: the voice scales by 1 / sampleRate and
+ * interpolates. Computed by the compiler (ConstexprTables.h) and shared by
+ * all voices as read-only data.
  */
-class FormantFilter
+class FormantTables
 {
 public:
-    void reset()
+    static constexpr int TAN_POINTS = 4096;
+    static constexpr float MAX_NORM = 0.49f;  // Formants stop just short of Nyquist
+
+    static const FormantTables& get()
     {
-        ic1eq = 0.0f;
-        ic2eq = 0.0f;
+        static constexpr FormantTables tables{};
+        return tables;
     }
 
-    void setCoefficients(float frequency, float q, float sampleRate)
+    /** tan(pi * x), x = frequency / sampleRate, clamped to [0, MAX_NORM] */
+    float prewarp(float x) const
     {
-        // Clamp frequency to Nyquist
-        frequency = std::min(frequency, sampleRate * 0.49f);
-        frequency = std::max(frequency, 20.0f);
+        const float pos = std::clamp(x, 0.0f, MAX_NORM) * SCALE;
+        const int i = std::min(static_cast<int>(pos), TAN_POINTS - 2);
+        const float frac = pos - static_cast<float>(i);
+        return tanTable[static_cast<size_t>(i)]
+             + (tanTable[static_cast<size_t>(i + 1)] - tanTable[static_cast<size_t>(i)]) * frac;
+    }
 
-        float g = std::tan(3.14159265359f * frequency / sampleRate);
-        float k = 1.0f / q;
+private:
+    static constexpr float SCALE = static_cast<float>(TAN_POINTS - 1) / MAX_NORM;
 
-        a1 = 1.0f / (1.0f + g * (g + k));
-        a2 = g * a1;
-        a3 = g * a2;
-    }
+    constexpr FormantTables() = default;
 
-    float processBandpass(float input)
-    {
-        float v3 = input - ic2eq;
-        float v1 = a1 * ic1eq + a2 * v3;
-        float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+    std::array<float, TAN_POINTS> tanTable = ConstexprTables::make<float, TAN_POINTS>(
+        [](size_t i) { return ConstexprTables::tan(ConstexprTables::PI * (static_cast<double>(i) / SCALE)); });
+};
 
-        ic1eq = 2.0f * v1 - ic1eq;
-        ic2eq = 2.0f * v2 - ic2eq;
+/**
+ * @brief The four formant coefficients round the vowel ring, at one sample rate
+ *
+ * POINTS_PER_VOWEL steps from each vowel to the next, each the prewarped
+ * g of F1-F4 at no formant shift or spread, the setting a voice spends
+ * most of its time at. There a vowel sweep is one interpolated read per
+ * block. Built in prepare() and shared by every voice at the same rate,
+ * like the Wavetable registry's tables: forRate() keeps weak references,
+ * so a rate's table goes with its last voice.
+ */
+class VowelTable
+{
+public:
+    static constexpr int POINTS_PER_VOWEL = 64;
+    static constexpr int POINTS = 5 * POINTS_PER_VOWEL;
+
+    /** The table at @p sampleRate, built by the first voice to ask (not the audio thread) */
+    static std::shared_ptr<const VowelTable> forRate(double sampleRate)
+    {
+        static std::mutex mutex;
+        static std::map<double, std::weak_ptr<const VowelTable>> tables;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto table = tables[sampleRate].lock())
+            return table;
+        auto table = std::shared_ptr<const VowelTable>(new VowelTable(sampleRate));
+        tables[sampleRate] = table;
+        return table;
+    }
 
-        return v1;  // Bandpass output
+    /** F1-F4's g at @p vowelPos (0-5, wrapping), interpolated */
+    void lookup(float vowelPos, float (&g)[4]) const
+    {
+        const float pos = vowelPos * static_cast<float>(POINTS_PER_VOWEL);
+        const int i = std::clamp(static_cast<int>(pos), 0, POINTS - 1);
+        const float frac = pos - static_cast<float>(i);
+        const auto& a = points[static_cast<size_t>(i)];
+        const auto& b = points[static_cast<size_t>(i + 1)];
+        for (int lane = 0; lane < 4; ++lane)
+            g[lane] = a[static_cast<size_t>(lane)] + (b[static_cast<size_t>(lane)] - a[static_cast<size_t>(lane)]) * frac;
     }
 
 private:
-    float ic1eq = 0.0f;
-    float ic2eq = 0.0f;
-    float a1 = 0.0f;
-    float a2 = 0.0f;
-    float a3 = 0.0f;
+    explicit VowelTable(double sampleRate)
+    {
+        const FormantTables& tables = FormantTables::get();
+        const float srInv = 1.0f / static_cast<float>(sampleRate);
+        for (int i = 0; i <= POINTS; ++i)
+        {
+            const FormantData f = interpolateVowels(static_cast<float>(i % POINTS) / POINTS_PER_VOWEL);
+            points[static_cast<size_t>(i)] = {tables.prewarp(f.f1 * srInv), tables.prewarp(f.f2 * srInv),
+                                              tables.prewarp(f.f3 * srInv), tables.prewarp(f.f4 * srInv)};
+        }
+    }
+
+    // One past the end: the last step interpolates back to A
+    std::array<std::array<float, 4>, POINTS + 1> points{};
 };
 
 /**
@@ -123,10 +208,12 @@ public:
         envLevel = 0.0f;
         envStage = EnvStage::Idle;
 
-        for (auto& filter : formantFilters)
-        {
-            filter.reset();
-        }
+        formants.init();
+        snapFormants = true;
+
+        vowels = VowelTable::forRate(sr);
+        glottal.setTable(WavetableRegistry::get().builtin(WavetableRegistry::Builtin::Glottal));
+        glottal.prepare(sr);
     }
 
     //==========================================================================
@@ -142,17 +229,16 @@ public:
         age = 0;
 
         // Calculate base frequency
-        baseFrequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        baseFrequency = PitchTables::get().midiToFrequency(static_cast<float>(note));
 
         // Reset phases for clean attack
         phase = 0.0f;
         vibratoPhase = 0.0f;
+        glottal.reset();
 
-        // Reset filters
-        for (auto& filter : formantFilters)
-        {
-            filter.reset();
-        }
+        // Reset filters; the first block starts at its vowel rather than ramping
+        formants.init();
+        snapFormants = true;
 
         // Start envelope
         envStage = EnvStage::Attack;
@@ -211,7 +297,7 @@ public:
     // Parameter Setters
     //==========================================================================
 
-    void setWaveform(int wf) { waveform = static_cast<WaveformType>(std::clamp(wf, 0, 1)); }
+    void setWaveform(int wf) { waveform = static_cast<WaveformType>(std::clamp(wf, 0, 2)); }
     void setTune(float semitones) { tuneOffset = semitones; }
     void setPulseWidth(float pw) { pulseWidth = std::clamp(pw, 0.05f, 0.95f); }
     void setVowel(float v) { vowelValue = std::clamp(v, 0.0f, 4.0f); }
@@ -229,16 +315,13 @@ public:
 
 private:
     //==========================================================================
-    // Formant Frequency Tables
+    // Formant Filter Lanes
     //==========================================================================
 
-    static constexpr FormantData formantTable[5] = {
-        { 800.0f, 1200.0f, 2500.0f },  // A
-        { 400.0f, 2000.0f, 2600.0f },  // E
-        { 300.0f, 2300.0f, 3000.0f },  // I
-        { 500.0f,  800.0f, 2300.0f },  // O
-        { 350.0f,  700.0f, 2500.0f }   // U
-    };
+    // Per-lane SVF damping (k = 1 / Q: 8, 10, 12, 14) and mix weights (with
+    // the 0.5 normalisation), F1 to F4
+    static constexpr float FORMANT_K[4] = { 1.0f / 8.0f, 1.0f / 10.0f, 1.0f / 12.0f, 1.0f / 14.0f };
+    static constexpr float FORMANT_GAIN[4] = { 0.5f, 0.35f, 0.25f, 0.12f };
 
     //==========================================================================
     // Envelope Stages
@@ -257,32 +340,29 @@ private:
     // Get interpolated formant frequencies
     //==========================================================================
 
-    FormantData getInterpolatedFormants(float vowelPos) const
+    /** The vowel position after the vowel LFO, wrapped to 0-5 */
+    float modulatedVowel(float vowelPos) const
     {
-        // Apply vowel LFO modulation
-        float modulatedVowel = vowelPos + vowelLfoDepth * 4.0f * std::sin(vowelLfoPhase * TWO_PI);
-        modulatedVowel = std::fmod(modulatedVowel + 100.0f, 5.0f);  // Wrap around 0-5 range
-
-        int v1 = static_cast<int>(modulatedVowel);
-        int v2 = (v1 + 1) % 5;
-        float frac = modulatedVowel - v1;
+        const float modulated = vowelPos + vowelLfoDepth * 4.0f * std::sin(vowelLfoPhase * TWO_PI);
+        return std::fmod(modulated + 100.0f, 5.0f);
+    }
 
-        // Linear interpolation between vowels
-        FormantData result;
-        result.f1 = formantTable[v1].f1 * (1.0f - frac) + formantTable[v2].f1 * frac;
-        result.f2 = formantTable[v1].f2 * (1.0f - frac) + formantTable[v2].f2 * frac;
-        result.f3 = formantTable[v1].f3 * (1.0f - frac) + formantTable[v2].f3 * frac;
+    FormantData getInterpolatedFormants(float vowelPos) const
+    {
+        FormantData result = interpolateVowels(vowelPos);
 
         // Apply formant shift (in semitones)
-        float shiftRatio = std::pow(2.0f, formantShift / 12.0f);
+        float shiftRatio = PitchTables::get().semitonesToRatio(formantShift);
         result.f1 *= shiftRatio;
         result.f2 *= shiftRatio;
         result.f3 *= shiftRatio;
+        result.f4 *= shiftRatio;
 
         // Apply formant spread (centered on F2)
         float centerFreq = result.f2;
         result.f1 = centerFreq + (result.f1 - centerFreq) * formantSpread;
         result.f3 = centerFreq + (result.f3 - centerFreq) * formantSpread;
+        result.f4 = centerFreq + (result.f4 - centerFreq) * formantSpread;
 
         return result;
     }
@@ -291,24 +371,89 @@ private:
     // Block Rendering
     //==========================================================================
 
-    void renderBlock(float* outputL, float* outputR, int blockSize)
+    /**
+     * @brief Point the formant SVF at the current vowel, ramping over the block
+     *
+     * The four bandpasses are lanes of one CytomicSVF. Coefficients come
+     * from the rate's VowelTable at no shift or spread, otherwise from
+     * FormantTables (no std::tan either way), and glide from the last
+     * block's values to these across blockSize samples, so vowel sweeps
+     * are smooth and cost the same as a held vowel.
+     */
+    void updateFormants(int blockSize)
+    {
+        const float vowelPos = modulatedVowel(vowelValue);
+        alignas(16) float g[4];
+        if (vowels && formantShift == 0.0f && formantSpread == 1.0f)
+        {
+            vowels->lookup(vowelPos, g);
+        }
+        else
+        {
+            const FormantData f = getInterpolatedFormants(vowelPos);
+            const float srInv = 1.0f / static_cast<float>(sampleRate);
+            const FormantTables& tables = FormantTables::get();
+            g[0] = tables.prewarp(std::max(f.f1, 20.0f) * srInv);
+            g[1] = tables.prewarp(std::max(f.f2, 20.0f) * srInv);
+            g[2] = tables.prewarp(std::max(f.f3, 20.0f) * srInv);
+            g[3] = tables.prewarp(std::max(f.f4, 20.0f) * srInv);
+        }
+
+        const auto a1Prior = formants.a1;
+        const auto a2Prior = formants.a2;
+        const auto a3Prior = formants.a3;
+
+        formants.g = SIMD_MM(load_ps)(g);
+        formants.k = SIMD_MM(loadu_ps)(FORMANT_K);
+        formants.setCoeffPostGK(sst::filters::CytomicSVF::Mode::Bandpass, SIMD_MM(set1_ps)(1.0f));
+
+        if (snapFormants)
+        {
+            snapFormants = false;
+            formants.retainCoeffForBlock<BLOCK_SIZE>();
+            return;
+        }
+
+        const auto perSample = SIMD_MM(set1_ps)(1.0f / static_cast<float>(blockSize));
+        formants.da1 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(formants.a1, a1Prior), perSample);
+        formants.da2 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(formants.a2, a2Prior), perSample);
+        formants.da3 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(formants.a3, a3Prior), perSample);
+        formants.a1 = a1Prior;
+        formants.a2 = a2Prior;
+        formants.a3 = a3Prior;
+    }
+
+    /** All four formants for one sample, weighted and summed */
+    float processFormants(float input)
     {
-        // Get current formant frequencies
-        FormantData formants = getInterpolatedFormants(vowelValue);
+        const auto out = sst::filters::CytomicSVF::stepSSE(formants, SIMD_MM(set1_ps)(input));
+        formants.a1 = SIMD_MM(add_ps)(formants.a1, formants.da1);
+        formants.a2 = SIMD_MM(add_ps)(formants.a2, formants.da2);
+        formants.a3 = SIMD_MM(add_ps)(formants.a3, formants.da3);
+
+        alignas(16) float lanes[4];
+        SIMD_MM(store_ps)(lanes, SIMD_MM(mul_ps)(out, SIMD_MM(loadu_ps)(FORMANT_GAIN)));
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
 
-        // Update formant filter coefficients
-        // Using Q values typical for vocal formants
-        formantFilters[0].setCoefficients(formants.f1, 8.0f, sampleRate);
-        formantFilters[1].setCoefficients(formants.f2, 10.0f, sampleRate);
-        formantFilters[2].setCoefficients(formants.f3, 12.0f, sampleRate);
+    void renderBlock(float* outputL, float* outputR, int blockSize)
+    {
+        updateFormants(blockSize);
 
         // Calculate base phase increment
-        float tunedFreq = baseFrequency * std::pow(2.0f, tuneOffset / 12.0f);
+        const PitchTables& pitch = PitchTables::get();
+        float tunedFreq = baseFrequency * pitch.semitonesToRatio(tuneOffset);
 
         // LFO phase increments
         float vibratoPhaseInc = vibratoRate / static_cast<float>(sampleRate);
         float vowelLfoPhaseInc = vowelLfoRate / static_cast<float>(sampleRate);
 
+        // The glottal table's mip level for the block, its frame from PW
+        const bool glottalSource = waveform == WaveformType::Glottal;
+        const float glottalShape = (pulseWidth - 0.05f) / 0.9f;
+        if (glottalSource)
+            glottal.setFrequency(tunedFreq);
+
         for (int i = 0; i < blockSize; ++i)
         {
             // ================================================================
@@ -331,7 +476,7 @@ private:
                 vowelLfoPhase -= 1.0f;
 
             // Apply vibrato to frequency
-            float modulatedFreq = tunedFreq * std::pow(2.0f, vibratoMod / 12.0f);
+            float modulatedFreq = tunedFreq * pitch.semitonesToRatio(vibratoMod);
             float phaseInc = modulatedFreq / static_cast<float>(sampleRate);
 
             // ================================================================
@@ -348,6 +493,12 @@ private:
                 case WaveformType::Pulse:
                     oscOut = polyBlepPulse(phase, phaseInc, pulseWidth);
                     break;
+
+                case WaveformType::Glottal:
+                    if (vibratoDepth > 0.0f)
+                        glottal.setFrequency(modulatedFreq);
+                    oscOut = glottal.process(glottalShape);
+                    break;
             }
 
             // Advance phase
@@ -356,17 +507,9 @@ private:
                 phase -= 1.0f;
 
             // ================================================================
-            // FORMANT FILTERS (parallel)
+            // FORMANT FILTERS (parallel, one SIMD step; higher formants quieter)
             // ================================================================
-            float f1Out = formantFilters[0].processBandpass(oscOut);
-            float f2Out = formantFilters[1].processBandpass(oscOut);
-            float f3Out = formantFilters[2].processBandpass(oscOut);
-
-            // Mix formants with decreasing amplitude for higher formants
-            float formantMix = f1Out * 1.0f + f2Out * 0.7f + f3Out * 0.5f;
-
-            // Normalize the mix
-            formantMix *= 0.5f;
+            float formantMix = processFormants(oscOut);
 
             // ================================================================
             // AMPLITUDE ENVELOPE (ADSR)
@@ -511,8 +654,13 @@ private:
     EnvStage envStage = EnvStage::Idle;
     float envLevel = 0.0f;
 
-    // Formant filters
-    std::array<FormantFilter, 3> formantFilters;
+    // Formant filters: F1-F4 as the lanes of one SVF
+    sst::filters::CytomicSVF formants;
+    bool snapFormants = true;
+
+    // This rate's vowel coefficients and the glottal source (shared tables)
+    std::shared_ptr<const VowelTable> vowels;
+    WavetableOscillator glottal;
 
     //==========================================================================
     // Parameters
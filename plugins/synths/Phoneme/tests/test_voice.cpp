@@ -7,6 +7,8 @@
 #include <catch2/catch_approx.hpp>
 #include "dsp/Voice.h"
 
+#include <vector>
+
 using Catch::Approx;
 
 TEST_CASE("Voice initializes correctly", "[voice]")
@@ -127,6 +129,40 @@ TEST_CASE("Voice vowel selection affects formants", "[voice]")
     }
 }
 
+TEST_CASE("FormantTables prewarp matches tan and vowel sweeps stay smooth", "[voice][formant]")
+{
+    const auto& tables = FormantTables::get();
+    for (float hz : {20.0f, 300.0f, 800.0f, 2500.0f, 6000.0f, 15000.0f, 21000.0f})
+    {
+        const float x = hz / 44100.0f;
+        const float exact = std::tan(3.14159265f * x);
+        REQUIRE(tables.prewarp(x) == Approx(exact).epsilon(1.0e-4));
+    }
+
+    // A fast vowel LFO moves the formants every block: the coefficient ramps
+    // keep the output bounded and free of block-rate steps
+    Voice voice;
+    voice.prepare(44100.0);
+    voice.setAttack(0.001f);
+    voice.setMasterLevel(1.0f);
+    voice.setVowelLfoRate(5.0f);
+    voice.setVowelLfoDepth(1.0f);
+    voice.noteOn(48, 1.0f);
+
+    std::vector<float> left(22000, 0.0f), right(22000, 0.0f);
+    for (size_t pos = 0; pos < left.size(); pos += 100)
+        voice.render(left.data() + pos, right.data() + pos, 100);
+
+    float peak = 0.0f;
+    for (float s : left)
+    {
+        REQUIRE(std::isfinite(s));
+        peak = std::max(peak, std::abs(s));
+    }
+    REQUIRE(peak > 0.01f);
+    REQUIRE(peak < 4.0f);
+}
+
 TEST_CASE("Voice waveform selection works", "[voice]")
 {
     // Test Saw vs Pulse produce different output
@@ -159,3 +195,53 @@ TEST_CASE("Voice waveform selection works", "[voice]")
 
     REQUIRE(diff > 0.0f);
 }
+
+TEST_CASE("Glottal source sounds, and its open phase changes it", "[voice]")
+{
+    const auto renderGlottal = [](float pw) {
+        Voice voice;
+        voice.prepare(44100.0);
+        voice.setWaveform(2);  // Glottal
+        voice.setPulseWidth(pw);
+        voice.setAttack(0.001f);
+        voice.setMasterLevel(1.0f);
+        voice.noteOn(48, 1.0f);
+
+        std::vector<float> left(4096, 0.0f), right(4096, 0.0f);
+        voice.render(left.data(), right.data(), 4096);
+        return left;
+    };
+
+    const auto pressed = renderGlottal(0.05f);
+    const auto breathy = renderGlottal(0.95f);
+
+    float energy = 0.0f, diff = 0.0f;
+    for (size_t i = 0; i < pressed.size(); ++i)
+    {
+        REQUIRE(std::isfinite(pressed[i]));
+        REQUIRE(std::isfinite(breathy[i]));
+        energy += pressed[i] * pressed[i];
+        diff += std::abs(pressed[i] - breathy[i]);
+    }
+    REQUIRE(energy > 0.0f);
+    REQUIRE(diff > 0.0f);
+}
+
+TEST_CASE("VowelTable matches the formant path it replaces", "[voice][formant]")
+{
+    const auto table = VowelTable::forRate(48000.0);
+    REQUIRE(table == VowelTable::forRate(48000.0));  // Shared per rate
+    REQUIRE(table != VowelTable::forRate(44100.0));
+
+    const auto& tables = FormantTables::get();
+    for (float pos = 0.0f; pos < 5.0f; pos += 0.37f)
+    {
+        float g[4];
+        table->lookup(pos, g);
+
+        const FormantData f = interpolateVowels(pos);
+        const float hz[4] = {f.f1, f.f2, f.f3, f.f4};
+        for (int lane = 0; lane < 4; ++lane)
+            REQUIRE(g[lane] == Approx(tables.prewarp(hz[lane] / 48000.0f)).epsilon(2.0e-3));
+    }
+}
@@ -3,7 +3,7 @@
  * @brief Phoneme Formant Synthesizer UI
  *
  * Features:
- * - Saw/Pulse oscillator source
+ * - Saw/Pulse/Glottal oscillator source
  * - Vowel selection (A, E, I, O, U) with morphing
  * - Formant shift and spread controls
  * - Vibrato for natural pitch modulation
@@ -62,7 +62,7 @@ const App: React.FC = () => {
   });
 
   // Waveform labels
-  const waveformLabels = ['SAW', 'PLS'];
+  const waveformLabels = ['SAW', 'PLS', 'GLT'];
 
   // Vowel labels
   const vowelLabels = ['A', 'E', 'I', 'O', 'U'];
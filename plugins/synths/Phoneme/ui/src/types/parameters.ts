@@ -31,7 +31,7 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     id: 'osc_waveform',
     name: 'Waveform',
     min: 0,
-    max: 1,
+    max: 2,
     default: 0, // Saw
     step: 1,
   },
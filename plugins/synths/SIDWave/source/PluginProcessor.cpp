@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -16,34 +17,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    osc1WaveParam = apvts.getRawParameterValue("osc1_wave");
-    osc1TuneParam = apvts.getRawParameterValue("osc1_tune");
-    osc1PWParam = apvts.getRawParameterValue("osc1_pw");
-    osc1LevelParam = apvts.getRawParameterValue("osc1_level");
-
-    osc2WaveParam = apvts.getRawParameterValue("osc2_wave");
-    osc2TuneParam = apvts.getRawParameterValue("osc2_tune");
-    osc2PWParam = apvts.getRawParameterValue("osc2_pw");
-    osc2LevelParam = apvts.getRawParameterValue("osc2_level");
-    osc2RingParam = apvts.getRawParameterValue("osc2_ring");
-
-    osc3WaveParam = apvts.getRawParameterValue("osc3_wave");
-    osc3TuneParam = apvts.getRawParameterValue("osc3_tune");
-    osc3LevelParam = apvts.getRawParameterValue("osc3_level");
-
-    bitDepthParam = apvts.getRawParameterValue("bit_depth");
-    sampleRateParam = apvts.getRawParameterValue("sample_rate");
-
-    filterCutoffParam = apvts.getRawParameterValue("filter_cutoff");
-    filterResoParam = apvts.getRawParameterValue("filter_reso");
-    filterTypeParam = apvts.getRawParameterValue("filter_type");
-
-    ampAttackParam = apvts.getRawParameterValue("amp_attack");
-    ampDecayParam = apvts.getRawParameterValue("amp_decay");
-    ampSustainParam = apvts.getRawParameterValue("amp_sustain");
-    ampReleaseParam = apvts.getRawParameterValue("amp_release");
-
-    masterLevelParam = apvts.getRawParameterValue("master_level");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -249,6 +228,17 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.8f
     ));
 
+    // =========================================================================
+    // ENGINE
+    // =========================================================================
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"engine_mode", 1},
+        "Engine Mode",
+        juce::StringArray{"Modern", "Accurate"},
+        0  // Default: Modern (float filter and envelope)
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -259,11 +249,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -275,46 +267,37 @@ void PluginProcessor::releaseResources()
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    OverrunLog::EngineState state;
+    state.activeVoices = synthEngine.getActiveVoiceCount();
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Read parameters
-    int osc1Wave = static_cast<int>(osc1WaveParam->load());
-    float osc1Tune = osc1TuneParam->load();
-    float osc1PW = osc1PWParam->load();
-    float osc1Level = osc1LevelParam->load();
-
-    int osc2Wave = static_cast<int>(osc2WaveParam->load());
-    float osc2Tune = osc2TuneParam->load();
-    float osc2PW = osc2PWParam->load();
-    float osc2Level = osc2LevelParam->load();
-    float osc2Ring = osc2RingParam->load();
-
-    int osc3Wave = static_cast<int>(osc3WaveParam->load());
-    float osc3Tune = osc3TuneParam->load();
-    float osc3Level = osc3LevelParam->load();
-
-    int bitDepth = static_cast<int>(bitDepthParam->load());
-    float sampleRate = sampleRateParam->load();
-
-    float filterCutoff = filterCutoffParam->load();
-    float filterReso = filterResoParam->load();
-    int filterType = static_cast<int>(filterTypeParam->load());
-
-    float ampAttack = ampAttackParam->load();
-    float ampDecay = ampDecayParam->load();
-    float ampSustain = ampSustainParam->load();
-    float ampRelease = ampReleaseParam->load();
+    // Read parameters (lock-free via atomics)
+    params.update();
 
-    float masterLevel = masterLevelParam->load();
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -334,54 +317,24 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition);
         }
     }
 
-    // Update synth engine parameters
-    synthEngine.setOsc1Wave(osc1Wave);
-    synthEngine.setOsc1Tune(osc1Tune);
-    synthEngine.setOsc1PW(osc1PW);
-    synthEngine.setOsc1Level(osc1Level);
-
-    synthEngine.setOsc2Wave(osc2Wave);
-    synthEngine.setOsc2Tune(osc2Tune);
-    synthEngine.setOsc2PW(osc2PW);
-    synthEngine.setOsc2Level(osc2Level);
-    synthEngine.setOsc2Ring(osc2Ring);
-
-    synthEngine.setOsc3Wave(osc3Wave);
-    synthEngine.setOsc3Tune(osc3Tune);
-    synthEngine.setOsc3Level(osc3Level);
-
-    synthEngine.setBitDepth(bitDepth);
-    synthEngine.setSampleRate(sampleRate);
-
-    synthEngine.setFilterCutoff(filterCutoff);
-    synthEngine.setFilterReso(filterReso);
-    synthEngine.setFilterType(filterType);
-
-    synthEngine.setAmpAttack(ampAttack);
-    synthEngine.setAmpDecay(ampDecay);
-    synthEngine.setAmpSustain(ampSustain);
-    synthEngine.setAmpRelease(ampRelease);
-
-    synthEngine.setMasterLevel(masterLevel);
+    // Update synth engine parameters (only the ones that changed)
+    synthEngine.applySnapshot(params);
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
 }
 
 //==============================================================================
@@ -399,18 +352,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
@@ -15,6 +15,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
 
 /**
  * @brief Main audio processor class
@@ -63,8 +66,17 @@ public:
     /** Audio parameter value tree state - use for UI binding */
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+
+    /** On-screen keyboard notes for processBlock() (pushed on the message thread) */
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
 
 private:
     /** Create the parameter layout - called once in constructor */
@@ -78,44 +90,11 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters (for lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // Oscillator 1
-    std::atomic<float>* osc1WaveParam = nullptr;
-    std::atomic<float>* osc1TuneParam = nullptr;
-    std::atomic<float>* osc1PWParam = nullptr;
-    std::atomic<float>* osc1LevelParam = nullptr;
-
-    // Oscillator 2
-    std::atomic<float>* osc2WaveParam = nullptr;
-    std::atomic<float>* osc2TuneParam = nullptr;
-    std::atomic<float>* osc2PWParam = nullptr;
-    std::atomic<float>* osc2LevelParam = nullptr;
-    std::atomic<float>* osc2RingParam = nullptr;
-
-    // Oscillator 3
-    std::atomic<float>* osc3WaveParam = nullptr;
-    std::atomic<float>* osc3TuneParam = nullptr;
-    std::atomic<float>* osc3LevelParam = nullptr;
-
-    // Lo-Fi
-    std::atomic<float>* bitDepthParam = nullptr;
-    std::atomic<float>* sampleRateParam = nullptr;
-
-    // Filter
-    std::atomic<float>* filterCutoffParam = nullptr;
-    std::atomic<float>* filterResoParam = nullptr;
-    std::atomic<float>* filterTypeParam = nullptr;
-
-    // Envelope
-    std::atomic<float>* ampAttackParam = nullptr;
-    std::atomic<float>* ampDecayParam = nullptr;
-    std::atomic<float>* ampSustainParam = nullptr;
-    std::atomic<float>* ampReleaseParam = nullptr;
-
-    // Master
-    std::atomic<float>* masterLevelParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
 
     //==========================================================================
     // State
@@ -124,8 +103,17 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    /** Buffer for UI visualization */
-    std::array<float, 512> visualizationBuffer{};
+    /** Audio thread -> UI oscilloscope samples */
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+
+    /** UI keyboard -> audio thread notes */
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -0,0 +1,310 @@
+/**
+ * @file SIDChip.h
+ * @brief The SID's filter and envelope, as the chip does them, for the Accurate engine mode
+ *
+ * SIDFilter: the 6581's 2-pole state-variable filter. The chip's cutoff
+ * is an 11-bit register (FC) whose response in Hz is far from the
+ * register's straight line: flat near 220 Hz for the bottom quarter,
+ * steep through the middle, with a drop at the 1024 boundary. The curve
+ * (reSID's measured 6581 points, interpolated) is one shared 2048-entry
+ * table, SIDFilterCurve. Resonance is the chip's 4 bits. The filter is a
+ * Chamberlin SVF, the topology of the chip's integrators, run once per
+ * sample with its coefficients worked out only when FC or resonance moves.
+ *
+ * SIDEnvelope: the SID's ADSR, an 8-bit counter stepped by a rate
+ * counter against the chip's 16 rate periods (in 985 kHz PAL clocks),
+ * with decay and release slowed by the exponential-curve divider as the
+ * level falls. Timing is integer: the rate counter advances by a fixed
+ * point clocks-per-sample each sample and the envelope steps when it
+ * passes the period. Two quirks of the chip come with it: the rate counter
+ * free-runs across notes, so an attack starts anywhere within its first
+ * period, and a period shortened below the running count waits for the
+ * counter to wrap at 2^15 clocks first (the "ADSR bug").
+ *
+ *   SIDEnvelope env;
+ *   env.prepare(sampleRate);
+ *   env.setAttack(0.01f);           // Nearest of the chip's 16 attack times
+ *   env.gate(true);
+ *   float level = env.process();    // Once per sample, 0-1
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+
+#include "ConstexprTables.h"
+
+/**
+ * @brief The 6581's FC register -> cutoff (Hz) curve
+ */
+class SIDFilterCurve
+{
+public:
+    static constexpr int FC_STEPS = 2048;
+
+    /** The shared table (read-only data, computed at compile time) */
+    static const SIDFilterCurve& get()
+    {
+        static constexpr SIDFilterCurve curve{};
+        return curve;
+    }
+
+    float cutoffHz(int fc) const { return hz[static_cast<size_t>(std::clamp(fc, 0, FC_STEPS - 1))]; }
+
+private:
+    // (FC, Hz), from reSID's 6581 measurements. The register's bit 10
+    // boundary drops back, so FC 1023 and 1024 appear twice.
+    static constexpr float POINTS[][2] = {
+        {0, 220},     {128, 230},   {256, 250},   {384, 300},   {512, 420},   {640, 780},
+        {768, 1600},  {832, 2300},  {896, 3200},  {960, 4300},  {992, 5000},  {1008, 5400},
+        {1016, 5700}, {1023, 6000}, {1024, 4600}, {1032, 4800}, {1056, 5300}, {1088, 6000},
+        {1120, 6600}, {1152, 7200}, {1280, 9500}, {1408, 12000}, {1536, 14500}, {1664, 16000},
+        {1792, 17100}, {1920, 17700}, {2047, 18000}};
+
+    constexpr SIDFilterCurve() = default;
+
+    std::array<float, FC_STEPS> hz = ConstexprTables::make<float, FC_STEPS>([](size_t fc) {
+        const float x = static_cast<float>(fc);
+        size_t p = 0;
+        while (p + 2 < std::size(POINTS) && x >= POINTS[p + 1][0])
+            ++p;
+        const float t = (x - POINTS[p][0]) / (POINTS[p + 1][0] - POINTS[p][0]);
+        return POINTS[p][1] + (POINTS[p + 1][1] - POINTS[p][1]) * std::clamp(t, 0.0f, 1.0f);
+    });
+};
+
+/**
+ * @brief The SID's state-variable filter (LP, BP or HP out)
+ */
+class SIDFilter
+{
+public:
+    void reset() { lp = bp = 0.0f; }
+
+    /** Cutoff register (0-2047), resonance register (0-15) and mode (0 LP, 1 BP, 2 HP) */
+    void setRegisters(int fcRegister, int resRegister, int outputMode, float sampleRate)
+    {
+        mode = outputMode;
+        if (fcRegister == fc && resRegister == res && sampleRate == rate)
+            return;
+        fc = fcRegister;
+        res = resRegister;
+        rate = sampleRate;
+
+        // reSID: 1/Q = 1 / (0.707 + res / 15)
+        damping = 1.0f / (0.707f + static_cast<float>(res) / 15.0f);
+
+        // The Chamberlin loop is stable while f^2 + 2 damping f < 4: keep a
+        // margin under that rather than let the top of the curve blow up
+        const float hz = SIDFilterCurve::get().cutoffHz(fc);
+        const float fMax = 0.9f * (std::sqrt(damping * damping + 4.0f) - damping);
+        f = std::min(2.0f * std::sin(3.14159265f * std::min(hz / sampleRate, 0.25f)), fMax);
+    }
+
+    float process(float in)
+    {
+        lp += f * bp;
+        const float hp = in - lp - damping * bp;
+        bp += f * hp;
+        return mode == 0 ? lp : (mode == 1 ? bp : hp);
+    }
+
+    float getCoefficient() const { return f; }
+
+private:
+    float lp = 0.0f;
+    float bp = 0.0f;
+    float f = 1.0f;
+    float damping = 1.0f;
+    int mode = 0;
+
+    // The registers the coefficients were last worked out for
+    int fc = -1;
+    int res = -1;
+    float rate = 0.0f;
+};
+
+/**
+ * @brief The SID's ADSR: rate-counter timing, 8-bit level
+ */
+class SIDEnvelope
+{
+public:
+    static constexpr double CLOCK_HZ = 985248.0;  // PAL
+    static constexpr int RATES = 16;
+    static constexpr int64_t ONE = 1 << 16;       // Rate counter fixed point
+
+    /** Clocks between envelope steps, per rate register value */
+    static constexpr std::array<int, RATES> RATE_PERIODS = {9,    32,   63,   95,    149,   220,   267,   313,
+                                                            392,  977,  1954, 3126,  3907,  11720, 19532, 31251};
+
+    /** The datasheet's attack times in seconds (decay and release take three times as long) */
+    static constexpr std::array<float, RATES> ATTACK_SECONDS = {0.002f, 0.008f, 0.016f, 0.024f, 0.038f, 0.056f,
+                                                                0.068f, 0.080f, 0.100f, 0.250f, 0.500f, 0.800f,
+                                                                1.000f, 3.000f, 5.000f, 8.000f};
+
+    enum class Stage { Idle, Attack, Decay, Release };
+
+    void prepare(double sampleRate)
+    {
+        clockStep = static_cast<int64_t>(std::llround(CLOCK_HZ / sampleRate * static_cast<double>(ONE)));
+        rateCounter = 0;
+        reset();
+    }
+
+    /** Silence (level 0, idle); the rate counter runs on, as the chip's does */
+    void reset()
+    {
+        stage = Stage::Idle;
+        level = 0;
+        expCounter = 0;
+        expPeriod = 1;
+        period = rateFor(Stage::Idle);
+    }
+
+    /** Rates: the nearest of the chip's 16 (log time) */
+    void setAttack(float seconds) { setRate(attackRate, rateRegister(seconds)); }
+    void setDecay(float seconds) { setRate(decayRate, rateRegister(seconds / 3.0f)); }
+    void setRelease(float seconds) { setRate(releaseRate, rateRegister(seconds / 3.0f)); }
+
+    /** Sustain: 4 bits, 0-1 in */
+    void setSustain(float level01) { sustainLevel = static_cast<int>(std::lround(std::clamp(level01, 0.0f, 1.0f) * 15.0f)) * 17; }
+
+    /** Gate on attacks from the current level, as the chip does; gate off releases */
+    void gate(bool on)
+    {
+        if (on)
+        {
+            enter(Stage::Attack);
+        }
+        else if (stage != Stage::Idle)
+        {
+            enter(Stage::Release);
+        }
+    }
+
+    /** One sample: run the rate counter, step the level on each period it passes */
+    float process()
+    {
+        rateCounter += clockStep;
+        while (rateCounter >= period)
+        {
+            rateCounter -= period;
+            step();
+        }
+        return static_cast<float>(level) * (1.0f / 255.0f);
+    }
+
+    bool isIdle() const { return stage == Stage::Idle; }
+    Stage getStage() const { return stage; }
+    int getLevel() const { return level; }
+
+    /** The rate whose attack time is nearest (in log time): past the geometric midpoints below it */
+    static int rateRegister(float attackSeconds)
+    {
+        const float squared = attackSeconds * attackSeconds;
+        int r = 0;
+        while (r < RATES - 1 && squared > ATTACK_SECONDS[static_cast<size_t>(r)] * ATTACK_SECONDS[static_cast<size_t>(r + 1)])
+            ++r;
+        return r;
+    }
+
+private:
+    static constexpr int64_t WRAP = int64_t{1} << 15;  // The chip's 15-bit rate counter
+
+    void setRate(int& rate, int r)
+    {
+        if (rate == r)
+            return;
+        rate = r;
+        setPeriod(rateFor(stage));
+    }
+
+    int64_t rateFor(Stage s) const
+    {
+        const int r = s == Stage::Attack ? attackRate : (s == Stage::Decay ? decayRate : releaseRate);
+        return static_cast<int64_t>(RATE_PERIODS[static_cast<size_t>(r)]) * ONE;
+    }
+
+    /** A new period: one the counter is already past only matches after a wrap */
+    void setPeriod(int64_t p)
+    {
+        period = p;
+        if (rateCounter >= period)
+            rateCounter -= WRAP * ONE;
+    }
+
+    void enter(Stage s)
+    {
+        stage = s;
+        if (s == Stage::Attack)
+            expCounter = 0;
+        setPeriod(rateFor(s));
+    }
+
+    void step()
+    {
+        switch (stage)
+        {
+            case Stage::Attack:
+                if (++level >= 255)
+                {
+                    level = 255;
+                    enter(Stage::Decay);
+                }
+                break;
+
+            case Stage::Decay:
+            case Stage::Release:
+            {
+                // Exponential approximation: fewer steps per tick as the level falls
+                if (++expCounter < expPeriod)
+                    break;
+                expCounter = 0;
+
+                const int floor = stage == Stage::Decay ? sustainLevel : 0;
+                if (level > floor)
+                    --level;
+                expPeriod = exponentialPeriod(level);
+                if (stage == Stage::Release && level == 0)
+                    stage = Stage::Idle;
+                break;
+            }
+
+            case Stage::Idle:
+                break;
+        }
+    }
+
+    static int exponentialPeriod(int level)
+    {
+        if (level > 93)
+            return 1;
+        if (level > 54)
+            return 2;
+        if (level > 26)
+            return 4;
+        if (level > 14)
+            return 8;
+        if (level > 6)
+            return 16;
+        return 30;
+    }
+
+    Stage stage = Stage::Idle;
+    int level = 0;            // 8-bit envelope counter
+    int sustainLevel = 0xBB;  // Sustain nibble x 17
+    int attackRate = 2;
+    int decayRate = 6;
+    int releaseRate = 6;
+
+    int64_t clockStep = ONE;  // Chip clocks per sample, fixed point
+    int64_t rateCounter = 0;  // Chip clocks since the last step, fixed point
+    int64_t period = ONE;
+    int expCounter = 0;
+    int expPeriod = 1;
+};
@@ -11,6 +11,12 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
+#include "ActiveVoiceList.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "SynthParams.h"
+#include "Denormals.h"
 
 /**
  * @brief Main SID Wave synthesizer engine
@@ -37,10 +43,14 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
 
+        // Its keys leave out the sample rate
+        sharedFilter.clear();
         for (auto& voice : voices)
         {
             voice.prepare(sampleRate);
+            voice.setSharedFilter(&sharedFilter);
         }
 
         std::fill(mixBufferL.begin(), mixBufferL.end(), 0.0f);
@@ -56,9 +66,25 @@ public:
     // MIDI Handling
     //==========================================================================
 
+    /**
+     * @brief Retune: note frequencies from @p table from the next note on
+     *
+     * Copies the table (128 floats: fine on the audio thread). A 12-TET
+     * table puts the voices back on PitchTables.
+     */
+    void setTuning(const TuningTable& table)
+    {
+        tuning = table;
+        for (auto& voice : voices)
+            voice.setTuning(tuning.isEqualTemperament() ? nullptr : &tuning);
+    }
+
+    const TuningTable& getTuning() const { return tuning; }
+
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -66,38 +92,52 @@ public:
             return;
         }
 
+        // Keys the tuning leaves unmapped are silent
+        if (!tuning.isMapped(note))
+            return;
+
         Voice* voice = findFreeVoice(note);
         if (voice)
         {
             // Apply current parameters to voice before note on
             applyParametersToVoice(*voice);
             voice->noteOn(note, velocity);
+            active.add(static_cast<int>(voice - voices.data()));
         }
     }
 
     void noteOff(int note, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
-        for (auto& voice : voices)
+        for (int v : active)
         {
-            if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
+            Voice& voice = voices[v];
+            if (voice.getNote() == note && !voice.isReleasing())
             {
                 voice.noteOff();
             }
         }
     }
 
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voices[v].kill();
         }
+        active.clear();
     }
 
-    void setPitchBend(float bend)
+    void setPitchBend(float bend, int sampleOffset = 0)
     {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend}))
+            return;
+
         pitchBend = bend;
     }
 
@@ -107,24 +147,20 @@ public:
 
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
+        perfStats.beginBlock();
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
             {
-                applyParametersToVoice(voice);
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+                renderVoices(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
 
-        // Apply master volume
-        for (int i = 0; i < numSamples; ++i)
-        {
-            outputL[i] = mixBufferL[i] * masterGain;
-            outputR[i] = mixBufferR[i] * masterGain;
-        }
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
     }
 
     //==========================================================================
@@ -167,22 +203,123 @@ public:
     // Master
     void setMasterLevel(float level) { masterGain = level; }
 
+    // Engine: 0 Modern, 1 Accurate (the chip's filter and envelope, from the next note)
+    void setEngineMode(int mode) { engineMode = mode; }
+
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h).
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Oscillator 1
+        if (p.changed(kOsc1Wave)) setOsc1Wave(p.index(kOsc1Wave));
+        if (p.changed(kOsc1Tune)) setOsc1Tune(p[kOsc1Tune]);
+        if (p.changed(kOsc1PW)) setOsc1PW(p[kOsc1PW]);
+        if (p.changed(kOsc1Level)) setOsc1Level(p[kOsc1Level]);
+
+        // Oscillator 2
+        if (p.changed(kOsc2Wave)) setOsc2Wave(p.index(kOsc2Wave));
+        if (p.changed(kOsc2Tune)) setOsc2Tune(p[kOsc2Tune]);
+        if (p.changed(kOsc2PW)) setOsc2PW(p[kOsc2PW]);
+        if (p.changed(kOsc2Level)) setOsc2Level(p[kOsc2Level]);
+        if (p.changed(kOsc2Ring)) setOsc2Ring(p[kOsc2Ring]);
+
+        // Oscillator 3
+        if (p.changed(kOsc3Wave)) setOsc3Wave(p.index(kOsc3Wave));
+        if (p.changed(kOsc3Tune)) setOsc3Tune(p[kOsc3Tune]);
+        if (p.changed(kOsc3Level)) setOsc3Level(p[kOsc3Level]);
+
+        // Lo-Fi
+        if (p.changed(kBitDepth)) setBitDepth(p.index(kBitDepth));
+        if (p.changed(kSampleRate)) setSampleRate(p[kSampleRate]);
+
+        // Filter
+        if (p.changed(kFilterCutoff)) setFilterCutoff(p[kFilterCutoff]);
+        if (p.changed(kFilterReso)) setFilterReso(p[kFilterReso]);
+        if (p.changed(kFilterType)) setFilterType(p.index(kFilterType));
+
+        // Envelope
+        if (p.changed(kAmpAttack)) setAmpAttack(p[kAmpAttack]);
+        if (p.changed(kAmpDecay)) setAmpDecay(p[kAmpDecay]);
+        if (p.changed(kAmpSustain)) setAmpSustain(p[kAmpSustain]);
+        if (p.changed(kAmpRelease)) setAmpRelease(p[kAmpRelease]);
+
+        // Master
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+
+        // Engine
+        if (p.changed(kEngineMode)) setEngineMode(p.index(kEngineMode));
+    }
+
     //==========================================================================
     // State Queries
     //==========================================================================
 
-    int getActiveVoiceCount() const
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        report.addInline("voices", sizeof(voices));
+        report.addInline("mix buffers", sizeof(mixBufferL) + sizeof(mixBufferR));
+        report.addShared("pitch tables", sizeof(PitchTables));
+        report.addShared("filter curve", sizeof(SIDFilterCurve));
+        return report;
+    }
+
+private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** Render one sub-block between MIDI events */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
     {
-        int count = 0;
-        for (const auto& voice : voices)
+        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
+        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+
         {
-            if (voice.isActive())
-                ++count;
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+            active.update([&](int v)
+            {
+                Voice& voice = voices[v];
+                applyParametersToVoice(voice);
+                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+                return voice.isActive();
+            });
+        }
+
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+
+            // Apply master volume
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputL[i] = mixBufferL[i] * masterGain;
+                outputR[i] = mixBufferR[i] * masterGain;
+            }
+        }
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value); break;
+        default: break;
         }
-        return count;
     }
 
-private:
     //==========================================================================
     // Voice Management
     //==========================================================================
@@ -221,16 +358,20 @@ private:
         voice.setDecay(ampDecay);
         voice.setSustain(ampSustain);
         voice.setRelease(ampRelease);
+
+        // Engine
+        voice.setEngineMode(engineMode);
     }
 
-    Voice* findFreeVoice(int note)
+    Voice* findFreeVoice(int /*note*/)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
+        // First, any voice not on the active list
+        if (!active.isFull())
         {
-            if (!voice.isActive())
+            for (int v = 0; v < MAX_VOICES; ++v)
             {
-                return &voice;
+                if (!active.contains(v))
+                    return &voices[v];
             }
         }
 
@@ -278,6 +419,15 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** Note frequencies the voices read at note on (see TuningTable.h) */
+    TuningTable tuning;
+
+    /** Filter coefficients for every voice on the same cutoff, resonance and mode */
+    Voice::SharedFilter sharedFilter;
+
+    /** The voices sounding, the only ones rendered, released or counted */
+    ActiveVoiceList<MAX_VOICES> active;
+
     //==========================================================================
     // Mix Buffers
     //==========================================================================
@@ -294,6 +444,12 @@ private:
     float pitchBend = 0.0f;
     float masterGain = 0.8f;
 
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
     //==========================================================================
     // Cached Parameters
     //==========================================================================
@@ -330,4 +486,7 @@ private:
     float ampDecay = 0.2f;
     float ampSustain = 0.7f;
     float ampRelease = 0.3f;
+
+    // Engine
+    int engineMode = 0;     // Modern
 };
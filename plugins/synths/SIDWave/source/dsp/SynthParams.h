@@ -0,0 +1,59 @@
+/**
+ * @file SynthParams.h
+ * @brief SIDWave parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(Osc1Wave,     "osc1_wave") \
+    X(Osc1Tune,     "osc1_tune") \
+    X(Osc1PW,       "osc1_pw") \
+    X(Osc1Level,    "osc1_level") \
+    X(Osc2Wave,     "osc2_wave") \
+    X(Osc2Tune,     "osc2_tune") \
+    X(Osc2PW,       "osc2_pw") \
+    X(Osc2Level,    "osc2_level") \
+    X(Osc2Ring,     "osc2_ring") \
+    X(Osc3Wave,     "osc3_wave") \
+    X(Osc3Tune,     "osc3_tune") \
+    X(Osc3Level,    "osc3_level") \
+    X(BitDepth,     "bit_depth") \
+    X(SampleRate,   "sample_rate") \
+    X(FilterCutoff, "filter_cutoff") \
+    X(FilterReso,   "filter_reso") \
+    X(FilterType,   "filter_type") \
+    X(AmpAttack,    "amp_attack") \
+    X(AmpDecay,     "amp_decay") \
+    X(AmpSustain,   "amp_sustain") \
+    X(AmpRelease,   "amp_release") \
+    X(MasterLevel,  "master_level") \
+    X(EngineMode,   "engine_mode")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
@@ -12,6 +12,31 @@
  * - Bit crushing for authentic 8-bit crunch
  * - Sample rate reduction
  * - Simple multimode filter (LP/BP/HP)
+ *
+ * The three oscillators run as the lanes of one SIMD vector (SIDOscillators):
+ * each block picks every lane's waveform by mask, so the per-sample loop
+ * has no waveform switch. Noise is a 23-bit LFSR per lane, clocked like
+ * the SID's on its accumulator's bit 19 (16 times per oscillator cycle)
+ * and held in between; patches without noise skip that work entirely.
+ *
+ * Sample rate reduction holds the lo-fi signal for a whole hold period, so
+ * only the held samples are worth synthesising: the oscillators step a
+ * hold period at a time, the mix and bit crush run once per hold, and a
+ * zero-order hold spreads each result over its period. Only the filter
+ * and envelope run at the full rate. At the 4 kHz setting a voice's
+ * front end costs a twelfth of what it did at 48 kHz.
+ *
+ * Two engine modes. Modern runs the float ADSR and sst's CytomicSVF, with
+ * the cutoff in Hz. Accurate swaps both for the chip's (see SIDChip.h):
+ * the cutoff knob sets the 11-bit FC register through the 6581's curve,
+ * resonance its 4 bits, and the ADSR is the chip's rate-counter envelope
+ * with its 16 times and 16 sustain levels. A voice keeps the mode it
+ * started its note in.
+ *
+ * Every voice's filter runs on the engine's cutoff, resonance and mode, so
+ * in Modern mode the engine hands the voices a SharedFilter cache and the
+ * SVF's coefficients (a tan) are worked out once per setting rather than
+ * per voice per block.
  */
 
 #pragma once
@@ -21,9 +46,16 @@
 #include <cstdint>
 #include <random>
 
+#include "sst/basic-blocks/simd/setup.h"
+
 // SST Filter
 #include "sst/filters/CytomicSVF.h"
 
+#include "CoefficientCache.h"
+#include "PitchTables.h"
+#include "TuningTable.h"
+#include "SIDChip.h"
+
 /**
  * @brief SID-style waveform types
  */
@@ -45,6 +77,15 @@ enum class FilterMode
     HighPass = 2
 };
 
+/**
+ * @brief Filter and envelope engine (see the file comment)
+ */
+enum class EngineMode
+{
+    Modern = 0,
+    Accurate = 1
+};
+
 /**
  * @brief Simple envelope stages
  */
@@ -57,6 +98,132 @@ enum class EnvStage
     Release
 };
 
+/**
+ * @brief The voice's three oscillators, one per SIMD lane (lane 3 is idle)
+ *
+ * configure() once per block turns each oscillator's waveform into lane
+ * masks; render() then computes pulse, saw and triangle for all lanes and
+ * keeps each lane's own with the masks: no branches per sample. The
+ * noise lanes' LFSRs are clocked on their clock edges only, which needs a
+ * per-lane count, so render is templated on whether any lane is noise.
+ */
+class SIDOscillators
+{
+public:
+    static constexpr int LANES = 3;
+    static constexpr uint32_t LFSR_SEED = 0x7FFFF8;
+    static constexpr float NOISE_CLOCKS_PER_CYCLE = 16.0f;  // Bit 19 of the SID's 24-bit accumulator
+
+    void reset()
+    {
+        phase = SIMD_MM(setzero_ps)();
+        for (auto& r : lfsr)
+            r = LFSR_SEED;
+        for (int lane = 0; lane < LANES; ++lane)
+            noiseHeld[static_cast<size_t>(lane)] = noiseValue(lfsr[static_cast<size_t>(lane)]);
+    }
+
+    /** Waveforms, pulse widths and phase increments for the next block */
+    void configure(const std::array<SIDWaveform, LANES>& waves, const std::array<float, LANES>& pulseWidths,
+                   const std::array<float, LANES>& increments)
+    {
+        alignas(16) uint32_t masks[4][4] = {};
+        alignas(16) float pw[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+        alignas(16) float inc[4] = {};
+        noiseLanes = 0;
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            const auto w = static_cast<size_t>(waves[static_cast<size_t>(lane)]);
+            masks[w][lane] = 0xFFFFFFFFu;
+            pw[lane] = pulseWidths[static_cast<size_t>(lane)];
+            inc[lane] = increments[static_cast<size_t>(lane)];
+            if (waves[static_cast<size_t>(lane)] == SIDWaveform::Noise)
+                noiseLanes |= 1u << lane;
+        }
+        for (int w = 0; w < 4; ++w)
+            waveMask[w] = SIMD_MM(load_ps)(reinterpret_cast<const float*>(masks[w]));
+        pulseWidth = SIMD_MM(load_ps)(pw);
+        increment = SIMD_MM(load_ps)(inc);
+    }
+
+    bool hasNoise() const { return noiseLanes != 0; }
+
+    /** out[i][lane] = oscillator lane's sample i */
+    template <bool NOISE>
+    void render(float (*out)[4], int numSamples)
+    {
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto two = SIMD_MM(set1_ps)(2.0f);
+        const auto four = SIMD_MM(set1_ps)(4.0f);
+        const auto half = SIMD_MM(set1_ps)(0.5f);
+        const auto absMask = SIMD_MM(castsi128_ps)(SIMD_MM(set1_epi32)(0x7FFFFFFF));
+        const auto clocks = SIMD_MM(set1_ps)(NOISE_CLOCKS_PER_CYCLE);
+
+        auto noise = SIMD_MM(loadu_ps)(noiseHeld.data());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto pulse = SIMD_MM(sub_ps)(SIMD_MM(and_ps)(SIMD_MM(cmplt_ps)(phase, pulseWidth), two), one);
+            const auto saw = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, phase), one);
+            const auto tri = SIMD_MM(sub_ps)(one, SIMD_MM(mul_ps)(four, SIMD_MM(and_ps)(absMask, SIMD_MM(sub_ps)(phase, half))));
+
+            auto wave = SIMD_MM(and_ps)(waveMask[0], pulse);
+            wave = SIMD_MM(or_ps)(wave, SIMD_MM(and_ps)(waveMask[1], saw));
+            wave = SIMD_MM(or_ps)(wave, SIMD_MM(and_ps)(waveMask[2], tri));
+            wave = SIMD_MM(or_ps)(wave, SIMD_MM(and_ps)(waveMask[3], noise));
+            SIMD_MM(store_ps)(out[i], wave);
+
+            // Advance: next = phase + increment, wrapped into 0-1
+            const auto next = SIMD_MM(add_ps)(phase, increment);
+            if constexpr (NOISE)
+            {
+                // Clock edges crossed this sample: floor(16 next) - floor(16 phase)
+                alignas(16) int32_t edges[4];
+                SIMD_MM(store_si128)(reinterpret_cast<SIMD_M128I*>(edges),
+                                     SIMD_MM(sub_epi32)(SIMD_MM(cvttps_epi32)(SIMD_MM(mul_ps)(next, clocks)),
+                                                        SIMD_MM(cvttps_epi32)(SIMD_MM(mul_ps)(phase, clocks))));
+                if ((edges[0] | edges[1] | edges[2]) != 0)
+                    noise = clockNoise(edges);
+            }
+            // floor() by truncation (next is positive): an increment of a
+            // whole cycle or more, at a reduced rate, still wraps
+            phase = SIMD_MM(sub_ps)(next, SIMD_MM(cvtepi32_ps)(SIMD_MM(cvttps_epi32)(next)));
+        }
+    }
+
+private:
+    static uint32_t clock(uint32_t r)
+    {
+        const uint32_t bit = ((r >> 22) ^ (r >> 17)) & 1;
+        return ((r << 1) | bit) & 0x7FFFFF;
+    }
+
+    static float noiseValue(uint32_t r) { return static_cast<float>(r & 0xFF) / 127.5f - 1.0f; }
+
+    SIMD_M128 clockNoise(const int32_t* edges)
+    {
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            if (!(noiseLanes & (1u << lane)))
+                continue;
+            auto& r = lfsr[static_cast<size_t>(lane)];
+            for (int e = 0; e < edges[lane]; ++e)
+                r = clock(r);
+            noiseHeld[static_cast<size_t>(lane)] = noiseValue(r);
+        }
+        return SIMD_MM(loadu_ps)(noiseHeld.data());
+    }
+
+    SIMD_M128 phase = SIMD_MM(setzero_ps)();
+    SIMD_M128 increment = SIMD_MM(setzero_ps)();
+    SIMD_M128 pulseWidth = SIMD_MM(set1_ps)(0.5f);
+    SIMD_M128 waveMask[4] = {};  // Indexed by SIDWaveform: all-ones in the lanes using it
+
+    std::array<uint32_t, LANES> lfsr{LFSR_SEED, LFSR_SEED, LFSR_SEED};
+    std::array<float, 4> noiseHeld{};  // Each noise lane's output between clock edges
+    uint32_t noiseLanes = 0;
+};
+
 /**
  * @brief Single SID Wave voice
  */
@@ -76,16 +243,19 @@ public:
     {
         sampleRate = sr;
 
-        // Initialize noise generator
-        noiseValue1 = 0.0f;
-        noiseValue2 = 0.0f;
-
         // Reset envelope
         envStage = EnvStage::Idle;
         envLevel = 0.0f;
+        sidEnvelope.prepare(sr);
+        sidFilter.reset();
+
+        // setCoeff() leaves the filter's per-sample coefficient ramps alone
+        // and processBlockStep() adds them, so they start at zero
+        filterL.init();
+        filterL.retainCoeffForBlock<BLOCK_SIZE>();
 
         // Reset sample-and-hold state
-        sampleHoldCounter = 0;
+        samplesToHold = 0;
         heldSample = 0.0f;
     }
 
@@ -93,6 +263,9 @@ public:
     // Note Events
     //==========================================================================
 
+    /** Note frequencies from @p table (nullptr: 12-TET from PitchTables); the engine owns it */
+    void setTuning(const TuningTable* table) { tuning = table; }
+
     void noteOn(int note, float vel)
     {
         currentNote = note;
@@ -102,32 +275,29 @@ public:
         age = 0;
 
         // Calculate base frequency
-        float frequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        float frequency = noteToFrequency(note);
         basePhaseInc = frequency / static_cast<float>(sampleRate);
 
-        // Reset oscillator phases
-        phase1 = 0.0f;
-        phase2 = 0.0f;
-        phase3 = 0.0f;
+        // Reset oscillator phases and noise shift registers (classic LFSR like SID)
+        oscillators.reset();
 
-        // Reset noise shift registers (classic LFSR like SID)
-        noiseShift1 = 0x7FFFF8;
-        noiseShift2 = 0x7FFFF8;
-        noiseShift3 = 0x7FFFF8;
-
-        // Start envelope
+        // Start envelope (the chip's attacks from wherever its level is)
+        mode = engineMode;
         envStage = EnvStage::Attack;
         envLevel = 0.0f;
+        sidEnvelope.gate(true);
     }
 
     void noteOff()
     {
         releasing = true;
         envStage = EnvStage::Release;
+        sidEnvelope.gate(false);
     }
 
     void kill()
     {
+        sidEnvelope.reset();
         active = false;
         releasing = false;
         currentNote = -1;
@@ -196,97 +366,53 @@ public:
         float targetRate = 4000.0f + reduction * (static_cast<float>(sampleRate) - 4000.0f);
         sampleHoldPeriod = static_cast<int>(sampleRate / targetRate);
         sampleHoldPeriod = std::max(1, sampleHoldPeriod);
+        samplesToHold = std::min(samplesToHold, sampleHoldPeriod - 1);
     }
 
     // Filter
+    /** Coefficients by (cutoff, resonance, mode), shared by the voices one engine renders */
+    using SharedFilter = CoefficientCache<sst::filters::CytomicSVF, 2>;
+
+    /** Take the Modern filter's coefficients from @p cache (nullptr: work them out here) */
+    void setSharedFilter(SharedFilter* cache) { sharedFilter = cache; }
+
     void setFilterCutoff(float hz) { filterCutoff = hz; }
     void setFilterReso(float reso) { filterReso = reso; }
-    void setFilterMode(int mode) { filterMode = static_cast<FilterMode>(std::clamp(mode, 0, 2)); }
+    void setFilterMode(int m) { filterMode = static_cast<FilterMode>(std::clamp(m, 0, 2)); }
 
     // Envelope
-    void setAttack(float seconds) { attackTime = seconds; }
-    void setDecay(float seconds) { decayTime = seconds; }
-    void setSustain(float level) { sustainLevel = level; }
-    void setRelease(float seconds) { releaseTime = seconds; }
+    void setAttack(float seconds) { attackTime = seconds; sidEnvelope.setAttack(seconds); }
+    void setDecay(float seconds) { decayTime = seconds; sidEnvelope.setDecay(seconds); }
+    void setSustain(float level) { sustainLevel = level; sidEnvelope.setSustain(level); }
+    void setRelease(float seconds) { releaseTime = seconds; sidEnvelope.setRelease(seconds); }
 
-private:
-    //==========================================================================
-    // Waveform Generation (SID-style)
-    //==========================================================================
+    // Engine (takes effect from the next note)
+    void setEngineMode(int m) { engineMode = static_cast<EngineMode>(std::clamp(m, 0, 1)); }
 
-    /**
-     * @brief Generate SID-style waveform
-     */
-    float generateWaveform(SIDWaveform wave, float& phase, float phaseInc, float pulseWidth, uint32_t& noiseShift)
+private:
+    /** The note's frequency in the current tuning */
+    float noteToFrequency(int note) const
     {
-        float output = 0.0f;
-
-        switch (wave)
-        {
-            case SIDWaveform::Pulse:
-                // Classic pulse wave with variable width
-                output = (phase < pulseWidth) ? 1.0f : -1.0f;
-                break;
-
-            case SIDWaveform::Saw:
-                // Sawtooth wave
-                output = 2.0f * phase - 1.0f;
-                break;
-
-            case SIDWaveform::Triangle:
-                // Triangle wave
-                output = (phase < 0.5f) ? (4.0f * phase - 1.0f) : (3.0f - 4.0f * phase);
-                break;
-
-            case SIDWaveform::Noise:
-                // SID-style LFSR noise (23-bit shift register)
-                // Clock the shift register at oscillator frequency
-                {
-                    // Simple feedback shift register
-                    uint32_t bit = ((noiseShift >> 22) ^ (noiseShift >> 17)) & 1;
-                    noiseShift = ((noiseShift << 1) | bit) & 0x7FFFFF;
-                    output = (static_cast<float>(noiseShift & 0xFF) / 127.5f) - 1.0f;
-                }
-                break;
-        }
+        return tuning != nullptr ? tuning->frequency(note) : PitchTables::get().midiToFrequency(static_cast<float>(note));
+    }
 
-        // Advance phase
-        phase += phaseInc;
-        if (phase >= 1.0f)
-            phase -= 1.0f;
+    const TuningTable* tuning = nullptr;  // The engine's, when it isn't 12-TET
 
-        return output;
-    }
+    //==========================================================================
+    // Waveform Generation (SID-style)
+    //==========================================================================
 
     /**
      * @brief Apply bit crushing
      */
-    float bitCrush(float sample)
+    float bitCrush(float sample, float halfLevels)
     {
-        // Quantize to bit depth
-        float levels = std::pow(2.0f, static_cast<float>(bitDepth));
-        float halfLevels = levels / 2.0f;
-
         // Scale to range, quantize, scale back
         float quantized = std::round((sample + 1.0f) * halfLevels) / halfLevels - 1.0f;
 
         return std::clamp(quantized, -1.0f, 1.0f);
     }
 
-    /**
-     * @brief Apply sample rate reduction via sample-and-hold
-     */
-    float sampleRateReduce(float sample)
-    {
-        sampleHoldCounter++;
-        if (sampleHoldCounter >= sampleHoldPeriod)
-        {
-            sampleHoldCounter = 0;
-            heldSample = sample;
-        }
-        return heldSample;
-    }
-
     /**
      * @brief Process ADSR envelope
      */
@@ -349,83 +475,167 @@ private:
     void renderBlock(float* outputL, float* outputR, int blockSize)
     {
         // Calculate phase increments with tuning
-        float tune1 = std::pow(2.0f, osc1Tune / 12.0f);
-        float tune2 = std::pow(2.0f, osc2Tune / 12.0f);
-        float tune3 = std::pow(2.0f, osc3Tune / 12.0f);
+        const PitchTables& pitch = PitchTables::get();
+        float tune1 = pitch.semitonesToRatio(osc1Tune);
+        float tune2 = pitch.semitonesToRatio(osc2Tune);
+        float tune3 = pitch.semitonesToRatio(osc3Tune);
         float phaseInc1 = basePhaseInc * tune1;
         float phaseInc2 = basePhaseInc * tune2;
         float phaseInc3 = basePhaseInc * tune3;
 
-        // Process filter coefficients
-        using FilterMode_t = sst::filters::CytomicSVF::Mode;
-
-        float srInv = 1.0f / static_cast<float>(sampleRate);
-        float res = std::clamp(filterReso, 0.0f, 0.98f);
-
-        for (int i = 0; i < blockSize; ++i)
+        // ================================================================
+        // OSCILLATORS, at the reduced rate
+        // ================================================================
+
+        // Only the samples the hold picks up: one every period, starting
+        // samplesToHold in. The oscillators step a whole period at a time.
+        const int period = sampleHoldPeriod;
+        const int holds = samplesToHold < blockSize ? (blockSize - samplesToHold + period - 1) / period : 0;
+        const float stride = static_cast<float>(period);
+
+        alignas(16) float osc[BLOCK_SIZE][4];
+        oscillators.configure({osc1Wave, osc2Wave, osc3Wave}, {osc1PulseWidth, osc2PulseWidth, 0.5f},
+                              {phaseInc1 * stride, phaseInc2 * stride, phaseInc3 * stride});
+        if (oscillators.hasNoise())
+            oscillators.render<true>(osc, holds);
+        else
+            oscillators.render<false>(osc, holds);
+
+        // ================================================================
+        // RING MOD, MIX AND BIT CRUSH, once per hold
+        // ================================================================
+
+        // Bit crush levels (2^bits / 2)
+        const float halfLevels = std::ldexp(1.0f, bitDepth - 1);
+
+        float held[BLOCK_SIZE];
+        for (int k = 0; k < holds; ++k)
         {
-            // ================================================================
-            // OSCILLATORS
-            // ================================================================
-
-            float osc1Out = generateWaveform(osc1Wave, phase1, phaseInc1, osc1PulseWidth, noiseShift1);
-            float osc2Out = generateWaveform(osc2Wave, phase2, phaseInc2, osc2PulseWidth, noiseShift2);
-            float osc3Out = generateWaveform(osc3Wave, phase3, phaseInc3, 0.5f, noiseShift3);
-
-            // ================================================================
-            // RING MODULATION
-            // ================================================================
+            const float osc1Out = osc[k][0];
+            const float osc2Out = osc[k][1];
+            const float osc3Out = osc[k][2];
 
             // Ring mod: blend between normal osc2 and osc1*osc2
-            float osc2Processed = osc2Out * (1.0f - osc2RingMod) + (osc1Out * osc2Out) * osc2RingMod;
-
-            // ================================================================
-            // MIX OSCILLATORS
-            // ================================================================
-
-            float mixed = osc1Out * osc1Level + osc2Processed * osc2Level + osc3Out * osc3Level;
-
-            // ================================================================
-            // LO-FI PROCESSING
-            // ================================================================
+            const float osc2Processed = osc2Out * (1.0f - osc2RingMod) + (osc1Out * osc2Out) * osc2RingMod;
+            const float mixed = osc1Out * osc1Level + osc2Processed * osc2Level + osc3Out * osc3Level;
+            held[k] = bitCrush(mixed, halfLevels);
+        }
 
-            // Sample rate reduction first (before bit crushing for more authentic sound)
-            float lofi = sampleRateReduce(mixed);
+        // Zero-order hold back out to the full rate (nothing to hold at it)
+        float expanded[BLOCK_SIZE];
+        const float* lofi = held;
+        if (period > 1)
+        {
+            int nextHold = samplesToHold;
+            for (int i = 0, k = 0; i < blockSize; ++i)
+            {
+                if (i == nextHold)
+                {
+                    heldSample = held[k++];
+                    nextHold += period;
+                }
+                expanded[i] = heldSample;
+            }
+            samplesToHold = nextHold - blockSize;
+            lofi = expanded;
+        }
 
-            // Bit crushing
-            lofi = bitCrush(lofi);
+        // Filter coefficients hold for the block
+        if (mode == EngineMode::Accurate)
+        {
+            sidFilter.setRegisters(fcRegister(filterCutoff), static_cast<int>(std::lround(std::clamp(filterReso, 0.0f, 1.0f) * 15.0f)),
+                                   static_cast<int>(filterMode), static_cast<float>(sampleRate));
+            renderSamples<true>(lofi, outputL, outputR, blockSize);
+            return;
+        }
 
-            // ================================================================
-            // FILTER
-            // ================================================================
+        using FilterMode_t = sst::filters::CytomicSVF::Mode;
 
-            // Set coefficients based on mode
+        float srInv = 1.0f / static_cast<float>(sampleRate);
+        float res = std::clamp(filterReso, 0.0f, 0.98f);
+        auto makeCoeffs = [&](sst::filters::CytomicSVF& filter)
+        {
             switch (filterMode)
             {
                 case FilterMode::LowPass:
-                    filterL.setCoeff(FilterMode_t::Lowpass, filterCutoff, res, srInv);
+                    filter.setCoeff(FilterMode_t::Lowpass, filterCutoff, res, srInv);
                     break;
                 case FilterMode::BandPass:
-                    filterL.setCoeff(FilterMode_t::Bandpass, filterCutoff, res, srInv);
+                    filter.setCoeff(FilterMode_t::Bandpass, filterCutoff, res, srInv);
                     break;
                 case FilterMode::HighPass:
-                    filterL.setCoeff(FilterMode_t::Highpass, filterCutoff, res, srInv);
+                    filter.setCoeff(FilterMode_t::Highpass, filterCutoff, res, srInv);
                     break;
             }
+        };
 
-            filterL.processBlockStep(lofi);
-            float filtered = lofi;
+        if (sharedFilter != nullptr)
+        {
+            // fetchCoeffs() copies the ramps too: the shared ones are zero, like ours
+            filterL.fetchCoeffs(sharedFilter->get(filterCutoff, res, static_cast<float>(filterMode),
+                [&](sst::filters::CytomicSVF& filter)
+                {
+                    makeCoeffs(filter);
+                    filter.retainCoeffForBlock<BLOCK_SIZE>();
+                }));
+        }
+        else
+        {
+            makeCoeffs(filterL);
+        }
+        renderSamples<false>(lofi, outputL, outputR, blockSize);
+    }
+
+    /**
+     * @brief The cutoff knob (20 Hz - 20 kHz, log) as the chip's FC register
+     *
+     * The knob's travel maps straight onto the register, so the 6581's
+     * curve, not the knob, decides where the cutoff lands.
+     */
+    static int fcRegister(float hz)
+    {
+        const float position = std::log(std::clamp(hz, 20.0f, 20000.0f) / 20.0f) / std::log(1000.0f);
+        return static_cast<int>(std::lround(position * static_cast<float>(SIDFilterCurve::FC_STEPS - 1)));
+    }
 
+    /** Filter and envelope at the full rate: Modern's or the chip's */
+    template <bool ACCURATE>
+    void renderSamples(const float* lofi, float* outputL, float* outputR, int blockSize)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
             // ================================================================
-            // ENVELOPE
+            // FILTER
             // ================================================================
 
-            float envOut = processEnvelope();
+            float filtered = lofi[i];
+            if constexpr (ACCURATE)
+                filtered = sidFilter.process(lofi[i]);
+            else
+                filterL.processBlockStep(filtered);
+
+            // ================================================================
+            // ENVELOPE
+            // ================================================================
 
-            if (envStage == EnvStage::Idle)
+            float envOut;
+            if constexpr (ACCURATE)
             {
-                active = false;
-                return;
+                envOut = sidEnvelope.process();
+                if (sidEnvelope.isIdle())
+                {
+                    active = false;
+                    return;
+                }
+            }
+            else
+            {
+                envOut = processEnvelope();
+                if (envStage == EnvStage::Idle)
+                {
+                    active = false;
+                    return;
+                }
             }
 
             // ================================================================
@@ -455,23 +665,13 @@ private:
     double sampleRate = 44100.0;
     float basePhaseInc = 0.0f;
 
-    // Oscillator phases
-    float phase1 = 0.0f;
-    float phase2 = 0.0f;
-    float phase3 = 0.0f;
-
-    // Noise shift registers (SID-style LFSR)
-    uint32_t noiseShift1 = 0x7FFFF8;
-    uint32_t noiseShift2 = 0x7FFFF8;
-    uint32_t noiseShift3 = 0x7FFFF8;
-    float noiseValue1 = 0.0f;
-    float noiseValue2 = 0.0f;
-    float noiseValue3 = 0.0f;
-
-    // Sample-and-hold for rate reduction
-    int sampleHoldCounter = 0;
+    // Oscillators, with their phases and noise shift registers (SID-style LFSR)
+    SIDOscillators oscillators;
+
+    // Sample-and-hold for rate reduction: the oscillators are at the next hold
+    int samplesToHold = 0;     // Samples from the start of the next block to it
     int sampleHoldPeriod = 1;
-    float heldSample = 0.0f;
+    float heldSample = 0.0f;   // Mixed and crushed
 
     //==========================================================================
     // SST Components
@@ -479,11 +679,17 @@ private:
 
     sst::filters::CytomicSVF filterL;
     sst::filters::CytomicSVF filterR;
+    SharedFilter* sharedFilter = nullptr;  // The engine's, for the whole note
 
     // Simple envelope state
     EnvStage envStage = EnvStage::Idle;
     float envLevel = 0.0f;
 
+    // The chip's filter and envelope (Accurate mode)
+    SIDFilter sidFilter;
+    SIDEnvelope sidEnvelope;
+    EngineMode mode = EngineMode::Modern;  // This note's
+
     //==========================================================================
     // Parameters
     //==========================================================================
@@ -519,4 +725,7 @@ private:
     float decayTime = 0.2f;
     float sustainLevel = 0.7f;
     float releaseTime = 0.3f;
+
+    // Engine
+    EngineMode engineMode = EngineMode::Modern;
 };
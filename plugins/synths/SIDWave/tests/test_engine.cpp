@@ -14,8 +14,8 @@
 #include <cmath>
 #include <array>
 
-// TODO: Include your synth engine implementation
-// #include "dsp/SynthEngine.h"
+#include "dsp/SynthEngine.h"
+#include "RealtimeGuard.h"
 
 using Catch::Approx;
 
@@ -254,3 +254,46 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("SynthEngine stays within its memory budget", "[engine][memory]")
+{
+    // All inline, most of it the two 8192-sample mix buffers
+    constexpr size_t BUDGET = 128u << 10;
+
+    const auto reports = projectMemory<SynthEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    INFO(at48k.toString());
+
+    REQUIRE(at48k.getStaticBytes() == sizeof(SynthEngine));
+    REQUIRE(at48k.getHeapBytes() == 0);
+    REQUIRE(reports[1].second.getInstanceBytes() == at48k.getInstanceBytes());
+    CHECK(at48k.getInstanceBytes() <= BUDGET);
+}
@@ -14,8 +14,7 @@
 #include <cmath>
 #include <array>
 
-// TODO: Include your voice implementation
-// #include "dsp/Voice.h"
+#include "dsp/Voice.h"
 
 using Catch::Approx;
 
@@ -255,3 +254,223 @@ TEST_CASE("Voice envelope behavior", "[voice][envelope]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SIDOscillators lanes", "[voice][dsp]")
+{
+    SIDOscillators oscillators;
+    oscillators.reset();
+
+    SECTION("Pulse, saw and triangle lanes match their formulas")
+    {
+        const float inc = 0.013f;
+        oscillators.configure({SIDWaveform::Pulse, SIDWaveform::Saw, SIDWaveform::Triangle}, {0.3f, 0.5f, 0.5f},
+                              {inc, inc, inc});
+        REQUIRE_FALSE(oscillators.hasNoise());
+
+        alignas(16) float out[Voice::BLOCK_SIZE][4];
+        oscillators.render<false>(out, Voice::BLOCK_SIZE);
+
+        float phase = 0.0f;
+        for (int i = 0; i < Voice::BLOCK_SIZE; ++i)
+        {
+            REQUIRE(out[i][0] == (phase < 0.3f ? 1.0f : -1.0f));
+            REQUIRE(out[i][1] == Approx(2.0f * phase - 1.0f).margin(1e-5));
+            REQUIRE(out[i][2] == Approx(phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase).margin(1e-5));
+            phase += inc;
+            if (phase >= 1.0f)
+                phase -= 1.0f;
+        }
+    }
+
+    SECTION("Noise changes only on clock edges, 16 per cycle")
+    {
+        const float inc = 1.0f / 256.0f;  // 16 samples per clock edge, exact in float
+        oscillators.configure({SIDWaveform::Saw, SIDWaveform::Saw, SIDWaveform::Noise}, {0.5f, 0.5f, 0.5f},
+                              {inc, inc, inc});
+        REQUIRE(oscillators.hasNoise());
+
+        // Twenty-five cycles: the held value may only move on an edge (every 16 samples)
+        alignas(16) float out[Voice::BLOCK_SIZE][4];
+        int changes = 0;
+        bool offEdge = false;
+        float last = 0.0f;
+        for (int block = 0; block < 200; ++block)
+        {
+            oscillators.render<true>(out, Voice::BLOCK_SIZE);
+            for (int i = 0; i < Voice::BLOCK_SIZE; ++i)
+            {
+                const int n = block * Voice::BLOCK_SIZE + i;
+                if (n > 0 && out[i][2] != last)
+                {
+                    ++changes;
+                    offEdge = offEdge || (n % 16) != 0;
+                }
+                last = out[i][2];
+            }
+        }
+
+        REQUIRE_FALSE(offEdge);
+        REQUIRE(changes > 100);
+    }
+}
+
+TEST_CASE("SID chip filter and envelope", "[voice][dsp]")
+{
+    SECTION("Cutoff curve follows the 6581's, drop at FC 1024 included")
+    {
+        const auto& curve = SIDFilterCurve::get();
+        REQUIRE(curve.cutoffHz(0) == Approx(220.0f));
+        REQUIRE(curve.cutoffHz(1023) == Approx(6000.0f));
+        REQUIRE(curve.cutoffHz(1024) == Approx(4600.0f));
+        REQUIRE(curve.cutoffHz(2047) == Approx(18000.0f));
+        REQUIRE(curve.cutoffHz(700) > curve.cutoffHz(600));
+    }
+
+    SECTION("Filter stays bounded at the top of the curve with full resonance")
+    {
+        SIDFilter filter;
+        filter.setRegisters(2047, 15, 0, 44100.0f);
+        float peak = 0.0f;
+        for (int i = 0; i < 44100; ++i)
+            peak = std::max(peak, std::abs(filter.process((i / 50) % 2 ? 1.0f : -1.0f)));
+        REQUIRE(peak < 10.0f);
+    }
+
+    SECTION("Envelope times come from the rate counters")
+    {
+        const double sampleRate = 48000.0;
+        SIDEnvelope env;
+        env.prepare(sampleRate);
+        env.setAttack(0.008f);  // Rate 1: 255 steps of 32 clocks
+        env.setDecay(0.024f);
+        env.setSustain(0.5f);   // Nibble 8: level 136
+        env.setRelease(0.024f);
+        env.gate(true);
+
+        int samples = 0;
+        while (env.getStage() == SIDEnvelope::Stage::Attack)
+        {
+            env.process();
+            ++samples;
+        }
+        const double expected = 255.0 * 32.0 / SIDEnvelope::CLOCK_HZ * sampleRate;
+        REQUIRE(samples == Approx(expected).margin(2.0));
+        REQUIRE(env.getLevel() == 255);
+
+        for (int i = 0; i < 48000; ++i)
+            env.process();
+        REQUIRE(env.getLevel() == 136);
+
+        env.gate(false);
+        while (!env.isIdle())
+            env.process();
+        REQUIRE(env.getLevel() == 0);
+    }
+
+    SECTION("Accurate voices play and finish their release")
+    {
+        Voice voice;
+        voice.prepare(44100.0);
+        voice.setEngineMode(static_cast<int>(EngineMode::Accurate));
+        voice.setRelease(0.05f);
+        voice.noteOn(60, 1.0f);
+
+        std::array<float, 4096> left{}, right{};
+        voice.render(left.data(), right.data(), 4096);
+        REQUIRE(isBufferValid(left.data(), 4096));
+        REQUIRE(calculateRMS(left.data(), 4096) > 0.01f);
+
+        voice.noteOff();
+        for (int block = 0; block < 100 && voice.isActive(); ++block)
+            voice.render(left.data(), right.data(), 4096);
+        REQUIRE_FALSE(voice.isActive());
+    }
+}
+
+TEST_CASE("Voice renders rate-reduced patches at the reduced rate", "[voice][dsp]")
+{
+    SECTION("Oscillators wrap increments of a cycle or more")
+    {
+        SIDOscillators oscillators;
+        oscillators.reset();
+        oscillators.configure({SIDWaveform::Saw, SIDWaveform::Saw, SIDWaveform::Saw}, {0.5f, 0.5f, 0.5f},
+                              {0.25f, 1.25f, 2.25f});
+
+        alignas(16) float out[4][4];
+        oscillators.render<false>(out, 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            REQUIRE(out[i][0] == Approx(2.0f * (0.25f * i) - 1.0f).margin(1e-5));
+            REQUIRE(out[i][1] == Approx(out[i][0]).margin(1e-5));
+            REQUIRE(out[i][2] == Approx(out[i][0]).margin(1e-5));
+        }
+    }
+
+    SECTION("Pitch and level hold at 4 kHz")
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numSamples = 48000;
+
+        auto render = [&](float reduction, bool noise) {
+            Voice voice;
+            voice.prepare(sampleRate);
+            voice.setOsc1Wave(noise ? 3 : 1);
+            voice.setOsc1Level(1.0f);
+            voice.setOsc2Level(0.0f);
+            voice.setOsc3Level(0.0f);
+            voice.setBitDepth(16);
+            voice.setSampleRateReduction(reduction);
+            voice.setFilterCutoff(1000.0f);  // Smooth the steps for the crossing count
+            voice.setFilterReso(0.0f);
+            voice.setSustain(1.0f);
+            voice.noteOn(57, 1.0f);  // 220 Hz
+
+            std::vector<float> left(numSamples, 0.0f), right(numSamples, 0.0f);
+            for (int pos = 0; pos < numSamples; pos += 500)
+                voice.render(left.data() + pos, right.data() + pos, std::min(500, numSamples - pos));
+            return left;
+        };
+
+        const auto full = render(1.0f, false);
+        const auto reduced = render(0.0f, false);
+        REQUIRE(isBufferValid(full.data(), numSamples));
+        REQUIRE(isBufferValid(reduced.data(), numSamples));
+        REQUIRE(countZeroCrossings(reduced.data(), numSamples) == Approx(220).margin(2));
+        REQUIRE(calculateRMS(reduced.data(), numSamples)
+                == Approx(calculateRMS(full.data(), numSamples)).epsilon(0.1));
+
+        const auto noise = render(0.0f, true);
+        REQUIRE(isBufferValid(noise.data(), numSamples));
+        REQUIRE(calculateRMS(noise.data(), numSamples) > 0.01f);
+    }
+}
+
+TEST_CASE("Voices sharing filter coefficients sound as they would alone", "[voice][dsp]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 4800;
+
+    auto render = [&](int note, float cutoff, Voice::SharedFilter* shared) {
+        Voice voice;
+        voice.prepare(sampleRate);
+        voice.setSharedFilter(shared);
+        voice.setFilterCutoff(cutoff);
+        voice.setFilterReso(0.6f);
+        voice.setFilterMode(1);
+        voice.noteOn(note, 1.0f);
+
+        std::vector<float> left(numSamples, 0.0f), right(numSamples, 0.0f);
+        for (int pos = 0; pos < numSamples; pos += 480)
+            voice.render(left.data() + pos, right.data() + pos, 480);
+        return left;
+    };
+
+    Voice::SharedFilter shared;
+    REQUIRE(render(48, 1200.0f, &shared) == render(48, 1200.0f, nullptr));
+    REQUIRE(render(55, 1200.0f, &shared) == render(55, 1200.0f, nullptr));
+    REQUIRE(render(60, 3000.0f, &shared) == render(60, 3000.0f, nullptr));
+
+    // Two settings between three voices: worked out twice, looked up the rest
+    REQUIRE(shared.getMisses() == 2);
+    REQUIRE(shared.getHits() > 0);
+}
@@ -242,6 +242,19 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     max: 1,
     default: 0.8,
   },
+
+  // =========================================================================
+  // ENGINE
+  // =========================================================================
+
+  engine_mode: {
+    id: 'engine_mode',
+    name: 'Engine',
+    min: 0,
+    max: 1,
+    default: 0,  // Modern
+    step: 1,
+  },
 };
 
 /**
@@ -255,7 +268,7 @@ export function getParametersByCategory(category: ParameterCategory): ParameterD
     [ParameterCategory.LOFI]: ['bit_depth', 'sample_rate'],
     [ParameterCategory.FILTER]: ['filter_cutoff', 'filter_reso', 'filter_type'],
     [ParameterCategory.ENVELOPE]: ['amp_attack', 'amp_decay', 'amp_sustain', 'amp_release'],
-    [ParameterCategory.MASTER]: ['master_level'],
+    [ParameterCategory.MASTER]: ['master_level', 'engine_mode'],
   };
 
   return categoryMap[category]
@@ -7,6 +7,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -18,66 +19,12 @@ PluginProcessor::PluginProcessor()
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-
-    // VCO 1
-    osc1FreqParam = apvts.getRawParameterValue("osc1_freq");
-    osc1LevelParam = apvts.getRawParameterValue("osc1_level");
-    osc1WaveParam = apvts.getRawParameterValue("osc1_wave");
-    sub1aDivParam = apvts.getRawParameterValue("sub1a_div");
-    sub1aLevelParam = apvts.getRawParameterValue("sub1a_level");
-    sub1bDivParam = apvts.getRawParameterValue("sub1b_div");
-    sub1bLevelParam = apvts.getRawParameterValue("sub1b_level");
-
-    // VCO 2
-    osc2FreqParam = apvts.getRawParameterValue("osc2_freq");
-    osc2LevelParam = apvts.getRawParameterValue("osc2_level");
-    osc2WaveParam = apvts.getRawParameterValue("osc2_wave");
-    sub2aDivParam = apvts.getRawParameterValue("sub2a_div");
-    sub2aLevelParam = apvts.getRawParameterValue("sub2a_level");
-    sub2bDivParam = apvts.getRawParameterValue("sub2b_div");
-    sub2bLevelParam = apvts.getRawParameterValue("sub2b_level");
-
-    // Voice 1 Filter & Envelopes
-    filter1CutoffParam = apvts.getRawParameterValue("filter1_cutoff");
-    filter1ResoParam = apvts.getRawParameterValue("filter1_reso");
-    filter1EnvAmtParam = apvts.getRawParameterValue("filter1_env_amt");
-    vcf1AttackParam = apvts.getRawParameterValue("vcf1_attack");
-    vcf1DecayParam = apvts.getRawParameterValue("vcf1_decay");
-    vca1AttackParam = apvts.getRawParameterValue("vca1_attack");
-    vca1DecayParam = apvts.getRawParameterValue("vca1_decay");
-
-    // Voice 2 Filter & Envelopes
-    filter2CutoffParam = apvts.getRawParameterValue("filter2_cutoff");
-    filter2ResoParam = apvts.getRawParameterValue("filter2_reso");
-    filter2EnvAmtParam = apvts.getRawParameterValue("filter2_env_amt");
-    vcf2AttackParam = apvts.getRawParameterValue("vcf2_attack");
-    vcf2DecayParam = apvts.getRawParameterValue("vcf2_decay");
-    vca2AttackParam = apvts.getRawParameterValue("vca2_attack");
-    vca2DecayParam = apvts.getRawParameterValue("vca2_decay");
-
-    // Sequencer
-    tempoParam = apvts.getRawParameterValue("tempo");
-    rhythm1DivParam = apvts.getRawParameterValue("rhythm1_div");
-    rhythm2DivParam = apvts.getRawParameterValue("rhythm2_div");
-    rhythm3DivParam = apvts.getRawParameterValue("rhythm3_div");
-    rhythm4DivParam = apvts.getRawParameterValue("rhythm4_div");
-
-    seq1EnableParam = apvts.getRawParameterValue("seq1_enable");
-    seq1Step1Param = apvts.getRawParameterValue("seq1_step1");
-    seq1Step2Param = apvts.getRawParameterValue("seq1_step2");
-    seq1Step3Param = apvts.getRawParameterValue("seq1_step3");
-    seq1Step4Param = apvts.getRawParameterValue("seq1_step4");
-
-    seq2EnableParam = apvts.getRawParameterValue("seq2_enable");
-    seq2Step1Param = apvts.getRawParameterValue("seq2_step1");
-    seq2Step2Param = apvts.getRawParameterValue("seq2_step2");
-    seq2Step3Param = apvts.getRawParameterValue("seq2_step3");
-    seq2Step4Param = apvts.getRawParameterValue("seq2_step4");
-
-    seqRunParam = apvts.getRawParameterValue("seq_run");
-
-    // Master
-    masterVolumeParam = apvts.getRawParameterValue("master_volume");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -412,11 +359,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
 
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -424,15 +373,61 @@ void PluginProcessor::releaseResources()
     synthEngine.releaseResources();
 }
 
+//==============================================================================
+// Host Transport
+//==============================================================================
+
+void PluginProcessor::updateTransport()
+{
+    using Transport = sst::basic_blocks::modulators::Transport;
+    transport.status = Transport::STOPPED;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return;
+    const auto position = playHead->getPosition();
+    if (!position)
+        return;
+
+    if (const auto bpm = position->getBpm())
+        transport.tempo = *bpm;
+    if (const auto signature = position->getTimeSignature())
+        transport.signature = {static_cast<uint16_t>(signature->numerator), static_cast<uint16_t>(signature->denominator)};
+    if (const auto barStart = position->getPpqPositionOfLastBarStart())
+        transport.lastBarStartInBeats = *barStart;
+
+    // Without a beat position there is no grid to follow, so count it as stopped
+    if (const auto ppq = position->getPpqPosition())
+    {
+        transport.hostTimeInBeats = *ppq;
+        transport.timeInBeats = *ppq;
+        if (position->getIsPlaying())
+            transport.status |= Transport::PLAYING;
+    }
+    if (position->getIsRecording())
+        transport.status |= Transport::RECORDING;
+    if (position->getIsLooping())
+        transport.status |= Transport::LOOPING;
+}
+
 //==============================================================================
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    // No voices, tiers or effects to report: the time alone
+    return {};
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
     buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
@@ -440,75 +435,11 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     const int numSamples = buffer.getNumSamples();
 
     // Read all parameters (lock-free via atomics)
+    params.update();
 
-    // VCO 1
-    float osc1Freq = osc1FreqParam->load();
-    float osc1Level = osc1LevelParam->load();
-    int osc1Wave = static_cast<int>(osc1WaveParam->load());
-    int sub1aDiv = static_cast<int>(sub1aDivParam->load());
-    float sub1aLevel = sub1aLevelParam->load();
-    int sub1bDiv = static_cast<int>(sub1bDivParam->load());
-    float sub1bLevel = sub1bLevelParam->load();
-
-    // VCO 2
-    float osc2Freq = osc2FreqParam->load();
-    float osc2Level = osc2LevelParam->load();
-    int osc2Wave = static_cast<int>(osc2WaveParam->load());
-    int sub2aDiv = static_cast<int>(sub2aDivParam->load());
-    float sub2aLevel = sub2aLevelParam->load();
-    int sub2bDiv = static_cast<int>(sub2bDivParam->load());
-    float sub2bLevel = sub2bLevelParam->load();
-
-    // Voice 1 Filter & Envelopes
-    float filter1Cutoff = filter1CutoffParam->load();
-    float filter1Reso = filter1ResoParam->load();
-    float filter1EnvAmt = filter1EnvAmtParam->load();
-    float vcf1Attack = vcf1AttackParam->load();
-    float vcf1Decay = vcf1DecayParam->load();
-    float vca1Attack = vca1AttackParam->load();
-    float vca1Decay = vca1DecayParam->load();
-
-    // Voice 2 Filter & Envelopes
-    float filter2Cutoff = filter2CutoffParam->load();
-    float filter2Reso = filter2ResoParam->load();
-    float filter2EnvAmt = filter2EnvAmtParam->load();
-    float vcf2Attack = vcf2AttackParam->load();
-    float vcf2Decay = vcf2DecayParam->load();
-    float vca2Attack = vca2AttackParam->load();
-    float vca2Decay = vca2DecayParam->load();
-
-    // Sequencer
-    float tempo = tempoParam->load();
-
-    // Rhythm preset values: 0=1/64, 1=1/32, 2=1/16, 3=1/8, 4=1/4, 5=1/2, 6=1x, 7=2x, 8=4x, 9=8x, 10=16x, 11=32x, 12=64x
-    static const float rhythmPresets[] = {0.015625f, 0.03125f, 0.0625f, 0.125f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f};
-
-    int rhythm1Idx = juce::jlimit(0, 12, static_cast<int>(rhythm1DivParam->load()));
-    int rhythm2Idx = juce::jlimit(0, 12, static_cast<int>(rhythm2DivParam->load()));
-    int rhythm3Idx = juce::jlimit(0, 12, static_cast<int>(rhythm3DivParam->load()));
-    int rhythm4Idx = juce::jlimit(0, 12, static_cast<int>(rhythm4DivParam->load()));
-
-    float rhythm1Div = rhythmPresets[rhythm1Idx];
-    float rhythm2Div = rhythmPresets[rhythm2Idx];
-    float rhythm3Div = rhythmPresets[rhythm3Idx];
-    float rhythm4Div = rhythmPresets[rhythm4Idx];
-
-    bool seq1Enable = seq1EnableParam->load() > 0.5f;
-    float seq1Step1 = seq1Step1Param->load();
-    float seq1Step2 = seq1Step2Param->load();
-    float seq1Step3 = seq1Step3Param->load();
-    float seq1Step4 = seq1Step4Param->load();
-
-    bool seq2Enable = seq2EnableParam->load() > 0.5f;
-    float seq2Step1 = seq2Step1Param->load();
-    float seq2Step2 = seq2Step2Param->load();
-    float seq2Step3 = seq2Step3Param->load();
-    float seq2Step4 = seq2Step4Param->load();
-
-    bool seqRun = seqRunParam->load() > 0.5f;
-
-    // Master
-    float masterVolume = masterVolumeParam->load();
+    // The sequencer follows the host's tempo and beat grid while it plays
+    updateTransport();
+    synthEngine.setTransport(transport);
 
     // Handle MIDI messages (for external triggering)
     for (const auto metadata : midiMessages)
@@ -526,77 +457,19 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
     }
 
-    // Update synth engine parameters
-
-    // VCO 1
-    synthEngine.setVCO1Frequency(osc1Freq);
-    synthEngine.setVCO1Level(osc1Level);
-    synthEngine.setVCO1Waveform(osc1Wave);
-    synthEngine.setSub1ADivision(sub1aDiv);
-    synthEngine.setSub1ALevel(sub1aLevel);
-    synthEngine.setSub1BDivision(sub1bDiv);
-    synthEngine.setSub1BLevel(sub1bLevel);
-
-    // VCO 2
-    synthEngine.setVCO2Frequency(osc2Freq);
-    synthEngine.setVCO2Level(osc2Level);
-    synthEngine.setVCO2Waveform(osc2Wave);
-    synthEngine.setSub2ADivision(sub2aDiv);
-    synthEngine.setSub2ALevel(sub2aLevel);
-    synthEngine.setSub2BDivision(sub2bDiv);
-    synthEngine.setSub2BLevel(sub2bLevel);
-
-    // Voice 1 Filter & Envelopes
-    synthEngine.setFilter1Cutoff(filter1Cutoff);
-    synthEngine.setFilter1Resonance(filter1Reso);
-    synthEngine.setFilter1EnvAmount(filter1EnvAmt);
-    synthEngine.setVCF1Attack(vcf1Attack);
-    synthEngine.setVCF1Decay(vcf1Decay);
-    synthEngine.setVCA1Attack(vca1Attack);
-    synthEngine.setVCA1Decay(vca1Decay);
-
-    // Voice 2 Filter & Envelopes
-    synthEngine.setFilter2Cutoff(filter2Cutoff);
-    synthEngine.setFilter2Resonance(filter2Reso);
-    synthEngine.setFilter2EnvAmount(filter2EnvAmt);
-    synthEngine.setVCF2Attack(vcf2Attack);
-    synthEngine.setVCF2Decay(vcf2Decay);
-    synthEngine.setVCA2Attack(vca2Attack);
-    synthEngine.setVCA2Decay(vca2Decay);
-
-    // Sequencer
-    synthEngine.setTempo(tempo);
-    synthEngine.setRhythm1Division(rhythm1Div);
-    synthEngine.setRhythm2Division(rhythm2Div);
-    synthEngine.setRhythm3Division(rhythm3Div);
-    synthEngine.setRhythm4Division(rhythm4Div);
-
-    synthEngine.setSeq1Enabled(seq1Enable);
-    synthEngine.setSeq1Step(0, seq1Step1);
-    synthEngine.setSeq1Step(1, seq1Step2);
-    synthEngine.setSeq1Step(2, seq1Step3);
-    synthEngine.setSeq1Step(3, seq1Step4);
-
-    synthEngine.setSeq2Enabled(seq2Enable);
-    synthEngine.setSeq2Step(0, seq2Step1);
-    synthEngine.setSeq2Step(1, seq2Step2);
-    synthEngine.setSeq2Step(2, seq2Step3);
-    synthEngine.setSeq2Step(3, seq2Step4);
-
-    synthEngine.setRunning(seqRun);
-
-    // Master
-    synthEngine.setMasterVolume(masterVolume);
+    // Update synth engine parameters (only the ones that changed)
+    synthEngine.applySnapshot(params);
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+
+    // The editor reads the sequencer from here, never from the engine
+    sequencerState.write() = synthEngine.getSequencerState();
+    sequencerState.publish();
 }
 
 //==============================================================================
@@ -614,18 +487,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
@@ -14,6 +14,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "StatePublisher.h"
 
 class PluginProcessor : public juce::AudioProcessor
 {
@@ -54,11 +57,17 @@ public:
 
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
 
-    /** Get sequencer state for UI feedback */
-    SubharmoniconEngine::SequencerState getSequencerState() const { return synthEngine.getSequencerState(); }
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
+
+    /** The sequencer as of the newest block (editor timer only; see core/dsp/StatePublisher.h) */
+    SubharmoniconEngine::SequencerState getSequencerState() { return sequencerState.read(); }
 
 private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -70,68 +79,20 @@ private:
     SubharmoniconEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameter Pointers (lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // VCO 1
-    std::atomic<float>* osc1FreqParam = nullptr;
-    std::atomic<float>* osc1LevelParam = nullptr;
-    std::atomic<float>* osc1WaveParam = nullptr;
-    std::atomic<float>* sub1aDivParam = nullptr;
-    std::atomic<float>* sub1aLevelParam = nullptr;
-    std::atomic<float>* sub1bDivParam = nullptr;
-    std::atomic<float>* sub1bLevelParam = nullptr;
-
-    // VCO 2
-    std::atomic<float>* osc2FreqParam = nullptr;
-    std::atomic<float>* osc2LevelParam = nullptr;
-    std::atomic<float>* osc2WaveParam = nullptr;
-    std::atomic<float>* sub2aDivParam = nullptr;
-    std::atomic<float>* sub2aLevelParam = nullptr;
-    std::atomic<float>* sub2bDivParam = nullptr;
-    std::atomic<float>* sub2bLevelParam = nullptr;
-
-    // Voice 1 Filter & Envelopes
-    std::atomic<float>* filter1CutoffParam = nullptr;
-    std::atomic<float>* filter1ResoParam = nullptr;
-    std::atomic<float>* filter1EnvAmtParam = nullptr;
-    std::atomic<float>* vcf1AttackParam = nullptr;
-    std::atomic<float>* vcf1DecayParam = nullptr;
-    std::atomic<float>* vca1AttackParam = nullptr;
-    std::atomic<float>* vca1DecayParam = nullptr;
-
-    // Voice 2 Filter & Envelopes
-    std::atomic<float>* filter2CutoffParam = nullptr;
-    std::atomic<float>* filter2ResoParam = nullptr;
-    std::atomic<float>* filter2EnvAmtParam = nullptr;
-    std::atomic<float>* vcf2AttackParam = nullptr;
-    std::atomic<float>* vcf2DecayParam = nullptr;
-    std::atomic<float>* vca2AttackParam = nullptr;
-    std::atomic<float>* vca2DecayParam = nullptr;
-
-    // Sequencer
-    std::atomic<float>* tempoParam = nullptr;
-    std::atomic<float>* rhythm1DivParam = nullptr;
-    std::atomic<float>* rhythm2DivParam = nullptr;
-    std::atomic<float>* rhythm3DivParam = nullptr;
-    std::atomic<float>* rhythm4DivParam = nullptr;
-
-    std::atomic<float>* seq1EnableParam = nullptr;
-    std::atomic<float>* seq1Step1Param = nullptr;
-    std::atomic<float>* seq1Step2Param = nullptr;
-    std::atomic<float>* seq1Step3Param = nullptr;
-    std::atomic<float>* seq1Step4Param = nullptr;
-
-    std::atomic<float>* seq2EnableParam = nullptr;
-    std::atomic<float>* seq2Step1Param = nullptr;
-    std::atomic<float>* seq2Step2Param = nullptr;
-    std::atomic<float>* seq2Step3Param = nullptr;
-    std::atomic<float>* seq2Step4Param = nullptr;
-
-    std::atomic<float>* seqRunParam = nullptr;
-
-    // Master
-    std::atomic<float>* masterVolumeParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
+
+    /** Sequencer state for the editor, published once per block */
+    StatePublisher<SubharmoniconEngine::SequencerState> sequencerState;
+
+    /** The host's transport this block, from the play head (see updateTransport) */
+    sst::basic_blocks::modulators::Transport transport;
+
+    /** Read the play head into transport; stopped if the host gives no beat position */
+    void updateTransport();
 
     //==========================================================================
     // State
@@ -140,7 +101,13 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    std::array<float, 512> visualizationBuffer{};
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -17,59 +17,170 @@
  *
  * When a rhythm generator fires, it advances its associated sequencer
  * by one step and triggers ONLY that voice's envelope.
+ *
+ * The four generators' triggers are compiled into a PolyrhythmSchedule
+ * whenever a division changes, and the master clock (a StepClock) counts
+ * the samples from one scheduled event to the next, so a 64x generator's
+ * triggers land evenly through the clock, each on its own sample, and
+ * rendering costs the same whatever the divisions.
+ *
+ * While the host plays (setTransport), the master clock follows its tempo
+ * and beat position, and the schedule and sequencers are set to where a
+ * run started at beat 0 would be.
  */
 
 #pragma once
 
 #include "Voice.h"
+#include "MemoryReport.h"
+#include "PerfStats.h"
+#include "StepClock.h"
+#include "SynthParams.h"
+#include "Denormals.h"
+#include <sst/basic-blocks/modulators/Transport.h>
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 
 /**
  * @brief Polyrhythmic Clock Divider with extended range
  *
- * Supports division values from 0.0625 (1/16x = 16 clocks per trigger)
+ * Supports division values from 0.015625 (1/64x = 64 clocks per trigger)
  * to 64 (64x = trigger every 1/64th of a clock).
  *
  * Division interpretation:
  * - division < 1: Clock divider (trigger every N clocks where N = 1/division)
  * - division = 1: Trigger every clock
- * - division > 1: Clock multiplier (trigger N times per clock)
+ * - division > 1: Clock multiplier (trigger N times per clock, evenly spaced)
+ *
+ * Divisions are powers of two (other values snap to the nearest), so each
+ * generator fires every whole number of PolyrhythmSchedule ticks.
  */
 class RhythmGenerator
 {
 public:
+    /** Schedule ticks per master clock: the fastest division fires every tick */
+    static constexpr int TICKS_PER_CLOCK = 64;
+
     void setDivision(float div)
     {
-        division = std::clamp(div, 0.015625f, 64.0f);  // 1/64 to 64x
+        const float clamped = std::clamp(div, 0.015625f, 64.0f);  // 1/64 to 64x
+        division = std::exp2(std::round(std::log2(clamped)));
+        interval = static_cast<int>(std::lround(TICKS_PER_CLOCK / division));
     }
     float getDivision() const { return division; }
 
-    void reset()
+    /** Ticks between triggers (1 to 4096) */
+    int getInterval() const { return interval; }
+
+    /** Times fired in ticks 1 to @p tick (negative before tick 0) */
+    int64_t firedIn(int64_t tick) const
     {
-        accumulator = 0.0f;
+        return tick >= 0 ? tick / interval : -((-tick + interval - 1) / interval);
     }
 
-    /**
-     * @brief Process a master clock pulse
-     * @return Number of times this rhythm generator should fire (0, 1, or more for fast divisions)
-     */
-    int processClock()
+private:
+    float division = 1.0f;
+    int interval = TICKS_PER_CLOCK;
+};
+
+/**
+ * @brief The four rhythm generators' combined triggers, compiled ahead
+ *
+ * Time runs in ticks of 1/64 of a master clock. Every generator fires
+ * every whole power-of-two number of ticks, so together they repeat
+ * after the longest interval: at most 64 clocks. compile() lists the ticks
+ * in that period where anything fires, with a bit per generator that
+ * does, once per divisor change. Rendering then only ever asks for the
+ * next event and how far away it is, whatever the divisions.
+ *
+ * Ticks are absolute (0 is where the sequencer starts, or the host's beat
+ * 0); an event's ticks in the table are 1 to the period, so the period's
+ * last event is also tick 0 of the next.
+ */
+class PolyrhythmSchedule
+{
+public:
+    static constexpr int GENERATORS = 4;
+    static constexpr int MAX_PERIOD = 64 * RhythmGenerator::TICKS_PER_CLOCK;
+
+    /** Build the table for the generators' intervals (no allocation) */
+    void compile(const std::array<RhythmGenerator, GENERATORS>& generators)
     {
-        accumulator += division;
-        int triggers = 0;
-        while (accumulator >= 1.0f)
+        int shortest = MAX_PERIOD;
+        period = 1;
+        for (const auto& g : generators)
         {
-            accumulator -= 1.0f;
-            triggers++;
+            shortest = std::min(shortest, g.getInterval());
+            period = std::max(period, g.getInterval());  // Powers of two: the LCM
+        }
+
+        count = 0;
+        for (int t = shortest; t <= period; t += shortest)
+        {
+            uint8_t mask = 0;
+            for (int g = 0; g < GENERATORS; ++g)
+                if ((t & (generators[static_cast<size_t>(g)].getInterval() - 1)) == 0)
+                    mask = static_cast<uint8_t>(mask | (1 << g));
+            if (mask != 0)
+            {
+                ticks[static_cast<size_t>(count)] = t;
+                masks[static_cast<size_t>(count)] = mask;
+                ++count;
+            }
+        }
+    }
+
+    int getPeriod() const { return period; }
+    int size() const { return count; }
+
+    /** A place in the schedule: the next event is at base + its tick */
+    struct Cursor
+    {
+        int index = 0;
+        int64_t base = 0;
+    };
+
+    /** The first event at or after absolute @p tick */
+    Cursor seek(int64_t tick) const
+    {
+        // Events of the cycle from base are at base + 1 to base + period
+        Cursor c;
+        c.base = floorDiv(tick - 1, period) * period;
+        const int within = static_cast<int>(tick - c.base);
+        c.index = static_cast<int>(std::lower_bound(ticks.begin(), ticks.begin() + count, within) - ticks.begin());
+        return c;
+    }
+
+    int64_t tickOf(const Cursor& c) const { return c.base + ticks[static_cast<size_t>(c.index)]; }
+
+    /** The event before @p c's (the previous cycle's last is at base) */
+    int64_t tickBefore(const Cursor& c) const
+    {
+        return c.index > 0 ? c.base + ticks[static_cast<size_t>(c.index - 1)] : c.base;
+    }
+
+    /** Which generators fire at @p c's event, a bit each */
+    uint8_t firing(const Cursor& c) const { return masks[static_cast<size_t>(c.index)]; }
+
+    /** On to the next event */
+    void advance(Cursor& c) const
+    {
+        if (++c.index == count)
+        {
+            c.index = 0;
+            c.base += period;
         }
-        return triggers;
     }
 
 private:
-    float division = 1.0f;
-    float accumulator = 0.0f;
+    static int64_t floorDiv(int64_t a, int64_t b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    std::array<int, MAX_PERIOD> ticks{};
+    std::array<uint8_t, MAX_PERIOD> masks{};
+    int count = 0;
+    int period = 1;
 };
 
 /**
@@ -126,6 +237,9 @@ public:
 
     int getCurrentStep() const { return currentStep; }
 
+    /** Jump to a step without playing it (host sync) */
+    void setCurrentStep(int step) { currentStep = ((step % NUM_STEPS) + NUM_STEPS) % NUM_STEPS; }
+
 private:
     std::array<float, NUM_STEPS> steps = {0.0f, 0.0f, 0.0f, 0.0f};
     int currentStep = 0;
@@ -146,6 +260,8 @@ private:
 class SubharmoniconEngine
 {
 public:
+    using Transport = sst::basic_blocks::modulators::Transport;
+
     SubharmoniconEngine() = default;
     ~SubharmoniconEngine() = default;
 
@@ -155,15 +271,16 @@ public:
         this->blockSize = samplesPerBlock;
 
         voice.prepare(sampleRate);
+        perfStats.prepare(sampleRate);
 
         // Calculate samples per clock tick
         updateClockRate();
 
-        // Reset sequencers and rhythm generators
+        // Reset sequencers and the schedule
         seq1.reset();
         seq2.reset();
-        for (auto& rg : rhythmGenerators)
-            rg.reset();
+        updateSchedule();
+        restartSchedule();
     }
 
     void releaseResources()
@@ -176,33 +293,57 @@ public:
      */
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
+
+        perfStats.beginBlock();
+
         // Clear output
         std::fill(outputL, outputL + numSamples, 0.0f);
         std::fill(outputR, outputR + numSamples, 0.0f);
 
-        // Process sample by sample for accurate clock timing
-        for (int i = 0; i < numSamples; ++i)
         {
-            // Process clock if running
-            if (running)
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            updateSchedule();
+
+            // Spans of up to one control block. The master clock works out
+            // the next scheduled event ahead and a span always starts on it,
+            // so triggers stay sample accurate without being counted per sample
+            int i = 0;
+            while (i < numSamples)
             {
-                clockAccumulator += 1.0;
+                int n = std::min(ControlRamp::BLOCK_SIZE, numSamples - i);
 
-                if (clockAccumulator >= samplesPerClock)
+                if (running)
                 {
-                    clockAccumulator -= samplesPerClock;
-                    processMasterClock();
+                    bool ticked = false;
+                    n = masterClock.next(n, ticked);
+                    if (ticked)
+                        playEvent();
                 }
+
+                // Render voice (always running in drone mode)
+                voice.render(outputL + i, outputR + i, n);
+                i += n;
             }
+        }
+
+        // One voice, always running in drone mode
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, 1);
+    }
 
-            // Render voice (always running in drone mode)
-            float outL = 0.0f;
-            float outR = 0.0f;
-            voice.render(&outL, &outR, 1);
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
 
-            outputL[i] = outL;
-            outputR[i] = outR;
-        }
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        report.addInline("voice", sizeof(voice));
+        report.addInline("rhythm schedule", sizeof(schedule));
+        report.addShared("pitch tables", sizeof(PitchTables));
+        return report;
     }
 
     // =========================================================================
@@ -214,9 +355,8 @@ public:
         if (run && !running)
         {
             // Starting - reset everything
-            clockAccumulator = 0.0;
-            for (auto& rg : rhythmGenerators)
-                rg.reset();
+            updateSchedule();
+            restartSchedule();
             seq1.reset();
             seq2.reset();
 
@@ -241,6 +381,25 @@ public:
         updateClockRate();
     }
 
+    /**
+     * @brief Follow the host's transport, from the next applySnapshot()
+     *
+     * While the host plays, its tempo replaces the tempo knob and each block
+     * re-derives the clock phase, rhythm counters and sequencer steps from
+     * its beat position, so the polyrhythm never drifts from the host and
+     * a given position always sounds the same. The run switch still starts
+     * and stops the sequencer.
+     */
+    void setTransport(const Transport& transport)
+    {
+        const bool playing = (transport.status & Transport::PLAYING) != 0;
+        if (playing != hostPlaying || (playing && transport.tempo != hostTempo))
+            hostTempoChanged = true;
+        hostPlaying = playing;
+        hostTempo = transport.tempo;
+        hostBeats = transport.hostTimeInBeats;
+    }
+
     // =========================================================================
     // Sequencer Enable Controls
     // =========================================================================
@@ -270,10 +429,13 @@ public:
     // Rhythm Generator Settings (extended range: 0.0625 to 64)
     // =========================================================================
 
-    void setRhythm1Division(float div) { rhythmGenerators[0].setDivision(div); }
-    void setRhythm2Division(float div) { rhythmGenerators[1].setDivision(div); }
-    void setRhythm3Division(float div) { rhythmGenerators[2].setDivision(div); }
-    void setRhythm4Division(float div) { rhythmGenerators[3].setDivision(div); }
+    // The schedule is recompiled once, at the next block or host sync,
+    // however many divisions change
+
+    void setRhythm1Division(float div) { setRhythmDivision(0, div); }
+    void setRhythm2Division(float div) { setRhythmDivision(1, div); }
+    void setRhythm3Division(float div) { setRhythmDivision(2, div); }
+    void setRhythm4Division(float div) { setRhythmDivision(3, div); }
 
     // Legacy int interface (maps 1-8 to float)
     void setRhythm1Division(int div) { setRhythm1Division(static_cast<float>(div)); }
@@ -281,6 +443,17 @@ public:
     void setRhythm3Division(int div) { setRhythm3Division(static_cast<float>(div)); }
     void setRhythm4Division(int div) { setRhythm4Division(static_cast<float>(div)); }
 
+    /**
+     * @brief Division of a rhythm*_div choice
+     * @param index Choice index: 0=1/64, 1=1/32, ... 6=1x, ... 12=64x
+     */
+    static float rhythmDivisionChoice(int index)
+    {
+        static constexpr float values[] = {0.015625f, 0.03125f, 0.0625f, 0.125f, 0.25f, 0.5f, 1.0f,
+                                           2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f};
+        return values[std::clamp(index, 0, 12)];
+    }
+
     // =========================================================================
     // Sequencer Settings
     // =========================================================================
@@ -363,6 +536,76 @@ public:
 
     void setMasterVolume(float vol) { voice.setMasterLevel(vol); }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h). seq_run is
+     * the exception: it is re-asserted every block, so a MIDI start/stop
+     * only lasts until the next block, as it always has.
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // VCO 1
+        if (p.changed(kOsc1Freq)) setVCO1Frequency(p[kOsc1Freq]);
+        if (p.changed(kOsc1Level)) setVCO1Level(p[kOsc1Level]);
+        if (p.changed(kOsc1Wave)) setVCO1Waveform(p.index(kOsc1Wave));
+        if (p.changed(kSub1aDiv)) setSub1ADivision(p.index(kSub1aDiv));
+        if (p.changed(kSub1aLevel)) setSub1ALevel(p[kSub1aLevel]);
+        if (p.changed(kSub1bDiv)) setSub1BDivision(p.index(kSub1bDiv));
+        if (p.changed(kSub1bLevel)) setSub1BLevel(p[kSub1bLevel]);
+
+        // VCO 2
+        if (p.changed(kOsc2Freq)) setVCO2Frequency(p[kOsc2Freq]);
+        if (p.changed(kOsc2Level)) setVCO2Level(p[kOsc2Level]);
+        if (p.changed(kOsc2Wave)) setVCO2Waveform(p.index(kOsc2Wave));
+        if (p.changed(kSub2aDiv)) setSub2ADivision(p.index(kSub2aDiv));
+        if (p.changed(kSub2aLevel)) setSub2ALevel(p[kSub2aLevel]);
+        if (p.changed(kSub2bDiv)) setSub2BDivision(p.index(kSub2bDiv));
+        if (p.changed(kSub2bLevel)) setSub2BLevel(p[kSub2bLevel]);
+
+        // Voice 1 Filter & Envelopes
+        if (p.changed(kFilter1Cutoff)) setFilter1Cutoff(p[kFilter1Cutoff]);
+        if (p.changed(kFilter1Reso)) setFilter1Resonance(p[kFilter1Reso]);
+        if (p.changed(kFilter1EnvAmt)) setFilter1EnvAmount(p[kFilter1EnvAmt]);
+        if (p.changed(kVcf1Attack)) setVCF1Attack(p[kVcf1Attack]);
+        if (p.changed(kVcf1Decay)) setVCF1Decay(p[kVcf1Decay]);
+        if (p.changed(kVca1Attack)) setVCA1Attack(p[kVca1Attack]);
+        if (p.changed(kVca1Decay)) setVCA1Decay(p[kVca1Decay]);
+
+        // Voice 2 Filter & Envelopes
+        if (p.changed(kFilter2Cutoff)) setFilter2Cutoff(p[kFilter2Cutoff]);
+        if (p.changed(kFilter2Reso)) setFilter2Resonance(p[kFilter2Reso]);
+        if (p.changed(kFilter2EnvAmt)) setFilter2EnvAmount(p[kFilter2EnvAmt]);
+        if (p.changed(kVcf2Attack)) setVCF2Attack(p[kVcf2Attack]);
+        if (p.changed(kVcf2Decay)) setVCF2Decay(p[kVcf2Decay]);
+        if (p.changed(kVca2Attack)) setVCA2Attack(p[kVca2Attack]);
+        if (p.changed(kVca2Decay)) setVCA2Decay(p[kVca2Decay]);
+
+        // Sequencer
+        if (p.changed(kTempo) || hostTempoChanged)
+            setTempo(hostPlaying ? static_cast<float>(hostTempo) : p[kTempo]);
+        hostTempoChanged = false;
+        if (p.changed(kRhythm1Div)) setRhythm1Division(rhythmDivisionChoice(p.index(kRhythm1Div)));
+        if (p.changed(kRhythm2Div)) setRhythm2Division(rhythmDivisionChoice(p.index(kRhythm2Div)));
+        if (p.changed(kRhythm3Div)) setRhythm3Division(rhythmDivisionChoice(p.index(kRhythm3Div)));
+        if (p.changed(kRhythm4Div)) setRhythm4Division(rhythmDivisionChoice(p.index(kRhythm4Div)));
+
+        if (p.changed(kSeq1Enable)) setSeq1Enabled(p.flag(kSeq1Enable));
+        for (int i = 0; i < 4; ++i)
+            if (p.changed(kSeq1Step1 + i)) setSeq1Step(i, p[kSeq1Step1 + i]);
+
+        if (p.changed(kSeq2Enable)) setSeq2Enabled(p.flag(kSeq2Enable));
+        for (int i = 0; i < 4; ++i)
+            if (p.changed(kSeq2Step1 + i)) setSeq2Step(i, p[kSeq2Step1 + i]);
+
+        setRunning(p.flag(kSeqRun));
+        if (hostPlaying && running)
+            syncToHost();
+
+        // Master
+        if (p.changed(kMasterVolume)) setMasterVolume(p[kMasterVolume]);
+    }
+
     // =========================================================================
     // State for UI feedback
     // =========================================================================
@@ -394,70 +637,96 @@ public:
     }
 
 private:
+    // Clock rate: 4 pulses per beat (16th notes at tempo)
+    static constexpr double CLOCKS_PER_BEAT = 4.0;
+
     void updateClockRate()
     {
-        // Clock rate: 4 pulses per beat (16th notes at tempo)
-        // This gives good resolution for rhythm divisions
-        float beatsPerSecond = tempo / 60.0f;
-        float clocksPerSecond = beatsPerSecond * 4.0f;  // 4 clocks per beat
-        samplesPerClock = sampleRate / clocksPerSecond;
+        const double clocksPerSecond = tempo / 60.0 * CLOCKS_PER_BEAT;
+        samplesPerTick = sampleRate / clocksPerSecond / RhythmGenerator::TICKS_PER_CLOCK;
+        retime();
     }
 
-    void processMasterClock()
+    void setRhythmDivision(int generator, float div)
     {
-        // Reset trigger indicators
-        lastRhythm1Fired = false;
-        lastRhythm2Fired = false;
-        lastRhythm3Fired = false;
-        lastRhythm4Fired = false;
-
-        // Process rhythm generators
-        // Rhythms 1 & 2 drive Sequencer 1 (VCO1) - but only if seq1 is enabled
-        // Rhythms 3 & 4 drive Sequencer 2 (VCO2) - but only if seq2 is enabled
+        rhythmGenerators[static_cast<size_t>(generator)].setDivision(div);
+        scheduleChanged = true;
+    }
 
-        int seq1Triggers = 0;
-        int seq2Triggers = 0;
+    /** Recompile after division changes, keeping the time since the last event */
+    void updateSchedule()
+    {
+        if (!scheduleChanged)
+            return;
+        scheduleChanged = false;
+        schedule.compile(rhythmGenerators);
+        nextEvent = schedule.seek(lastEventTick + 1);
+        retime();
+    }
 
-        // Voice 1 rhythm generators
-        if (seq1.isEnabled())
-        {
-            int r1 = rhythmGenerators[0].processClock();
-            int r2 = rhythmGenerators[1].processClock();
+    /** Back to tick 0: the first event comes after it, as a free run starts */
+    void restartSchedule()
+    {
+        masterClock.reset();
+        lastEventTick = 0;
+        nextEvent = schedule.seek(1);
+        retime();
+    }
 
-            if (r1 > 0) lastRhythm1Fired = true;
-            if (r2 > 0) lastRhythm2Fired = true;
+    /** The master clock's steps: last event to the next, and the one after */
+    void retime()
+    {
+        PolyrhythmSchedule::Cursor following = nextEvent;
+        schedule.advance(following);
+        const int64_t next = schedule.tickOf(nextEvent);
+        masterClock.setSamplesPerStep(static_cast<double>(next - lastEventTick) * samplesPerTick);
+        masterClock.setNextStep(static_cast<double>(schedule.tickOf(following) - next) * samplesPerTick);
+    }
 
-            // Total triggers for seq1 (can be multiple per clock at high divisions)
-            seq1Triggers = r1 + r2;
-        }
-        else
-        {
-            // Still process clocks to keep them in sync, but don't trigger
-            rhythmGenerators[0].processClock();
-            rhythmGenerators[1].processClock();
-        }
+    /** Clock, schedule and sequencers to the host's position at this block's start */
+    void syncToHost()
+    {
+        updateSchedule();
+
+        // Everything is set as of the event before the next one, which
+        // playEvent() then plays
+        const double tick = hostBeats * CLOCKS_PER_BEAT * RhythmGenerator::TICKS_PER_CLOCK;
+        const double tolerance = 0.001 / samplesPerTick;  // As StepClock::syncTo()
+        nextEvent = schedule.seek(static_cast<int64_t>(std::ceil(tick - tolerance)));
+        lastEventTick = schedule.tickBefore(nextEvent);
+        retime();
+
+        const double gap = static_cast<double>(schedule.tickOf(nextEvent) - lastEventTick);
+        masterClock.syncTo((tick - static_cast<double>(lastEventTick)) / gap);
+
+        seq1.setCurrentStep(static_cast<int>((rhythmGenerators[0].firedIn(lastEventTick) +
+                                              rhythmGenerators[1].firedIn(lastEventTick)) % StepSequencer::NUM_STEPS));
+        seq2.setCurrentStep(static_cast<int>((rhythmGenerators[2].firedIn(lastEventTick) +
+                                              rhythmGenerators[3].firedIn(lastEventTick)) % StepSequencer::NUM_STEPS));
+    }
 
-        // Voice 2 rhythm generators
-        if (seq2.isEnabled())
-        {
-            int r3 = rhythmGenerators[2].processClock();
-            int r4 = rhythmGenerators[3].processClock();
+    /** Play the scheduled event the master clock has just reached */
+    void playEvent()
+    {
+        const uint8_t firing = schedule.firing(nextEvent);
+        lastEventTick = schedule.tickOf(nextEvent);
+        schedule.advance(nextEvent);
+        retime();
 
-            if (r3 > 0) lastRhythm3Fired = true;
-            if (r4 > 0) lastRhythm4Fired = true;
+        // Rhythms 1 & 2 drive Sequencer 1 (VCO1) - but only if seq1 is enabled
+        // Rhythms 3 & 4 drive Sequencer 2 (VCO2) - but only if seq2 is enabled
+        const bool seq1On = seq1.isEnabled();
+        const bool seq2On = seq2.isEnabled();
+        lastRhythm1Fired = seq1On && (firing & 1) != 0;
+        lastRhythm2Fired = seq1On && (firing & 2) != 0;
+        lastRhythm3Fired = seq2On && (firing & 4) != 0;
+        lastRhythm4Fired = seq2On && (firing & 8) != 0;
 
-            // Total triggers for seq2
-            seq2Triggers = r3 + r4;
-        }
-        else
-        {
-            // Still process clocks to keep them in sync, but don't trigger
-            rhythmGenerators[2].processClock();
-            rhythmGenerators[3].processClock();
-        }
+        const int seq1Triggers = static_cast<int>(lastRhythm1Fired) + static_cast<int>(lastRhythm2Fired);
+        const int seq2Triggers = static_cast<int>(lastRhythm3Fired) + static_cast<int>(lastRhythm4Fired);
 
         // Advance sequencers for each trigger and trigger envelopes
-        // Multiple triggers = multiple steps + retriggering (for fast divisions)
+        // (two generators firing together step twice)
         for (int i = 0; i < seq1Triggers; ++i)
         {
             float pitchOffset = seq1.advance();
@@ -483,11 +752,21 @@ private:
     // Transport
     bool running = false;
     float tempo = 120.0f;
-    double samplesPerClock = 1000.0;
-    double clockAccumulator = 0.0;
+    StepClock masterClock;     // Counts the samples between scheduled events
+    double samplesPerTick = 0.0;
+
+    // Host transport (setTransport)
+    bool hostPlaying = false;
+    bool hostTempoChanged = false;
+    double hostTempo = 120.0;
+    double hostBeats = 0.0;
 
     // Rhythm generators (4 total)
     std::array<RhythmGenerator, 4> rhythmGenerators;
+    PolyrhythmSchedule schedule;
+    PolyrhythmSchedule::Cursor nextEvent;
+    int64_t lastEventTick = 0;
+    bool scheduleChanged = true;
 
     // Sequencers (2 total, 4 steps each)
     StepSequencer seq1;
@@ -498,4 +777,7 @@ private:
     bool lastRhythm2Fired = false;
     bool lastRhythm3Fired = false;
     bool lastRhythm4Fired = false;
+
+    // Per-block CPU counters, read by the editor
+    PerfStats perfStats;
 };
@@ -0,0 +1,81 @@
+/**
+ * @file SynthParams.h
+ * @brief Subharmonicon parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SubharmoniconEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(Osc1Freq,      "osc1_freq") \
+    X(Osc1Level,     "osc1_level") \
+    X(Osc1Wave,      "osc1_wave") \
+    X(Sub1aDiv,      "sub1a_div") \
+    X(Sub1aLevel,    "sub1a_level") \
+    X(Sub1bDiv,      "sub1b_div") \
+    X(Sub1bLevel,    "sub1b_level") \
+    X(Osc2Freq,      "osc2_freq") \
+    X(Osc2Level,     "osc2_level") \
+    X(Osc2Wave,      "osc2_wave") \
+    X(Sub2aDiv,      "sub2a_div") \
+    X(Sub2aLevel,    "sub2a_level") \
+    X(Sub2bDiv,      "sub2b_div") \
+    X(Sub2bLevel,    "sub2b_level") \
+    X(Filter1Cutoff, "filter1_cutoff") \
+    X(Filter1Reso,   "filter1_reso") \
+    X(Filter1EnvAmt, "filter1_env_amt") \
+    X(Vcf1Attack,    "vcf1_attack") \
+    X(Vcf1Decay,     "vcf1_decay") \
+    X(Vca1Attack,    "vca1_attack") \
+    X(Vca1Decay,     "vca1_decay") \
+    X(Filter2Cutoff, "filter2_cutoff") \
+    X(Filter2Reso,   "filter2_reso") \
+    X(Filter2EnvAmt, "filter2_env_amt") \
+    X(Vcf2Attack,    "vcf2_attack") \
+    X(Vcf2Decay,     "vcf2_decay") \
+    X(Vca2Attack,    "vca2_attack") \
+    X(Vca2Decay,     "vca2_decay") \
+    X(Tempo,         "tempo") \
+    X(Rhythm1Div,    "rhythm1_div") \
+    X(Rhythm2Div,    "rhythm2_div") \
+    X(Rhythm3Div,    "rhythm3_div") \
+    X(Rhythm4Div,    "rhythm4_div") \
+    X(Seq1Enable,    "seq1_enable") \
+    X(Seq1Step1,     "seq1_step1") \
+    X(Seq1Step2,     "seq1_step2") \
+    X(Seq1Step3,     "seq1_step3") \
+    X(Seq1Step4,     "seq1_step4") \
+    X(Seq2Enable,    "seq2_enable") \
+    X(Seq2Step1,     "seq2_step1") \
+    X(Seq2Step2,     "seq2_step2") \
+    X(Seq2Step3,     "seq2_step3") \
+    X(Seq2Step4,     "seq2_step4") \
+    X(SeqRun,        "seq_run") \
+    X(MasterVolume,  "master_volume")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
@@ -18,8 +18,11 @@
  *   - 2 completely independent signal paths
  *   - Each voice has its own ladder filter with independent cutoff/resonance
  *   - Each voice has its own AD envelopes (VCF and VCA)
- *   - Subharmonic oscillators divide parent VCO frequency by integers 1-16
+ *   - Subharmonic oscillators divide the parent VCO by integers 1-16,
+ *     counting its cycles, so they stay phase-locked to it
  *   - Waveform selection for each oscillator (SAW, SQR, TRI, SIN)
+ *   - VCF envelope and cutoff at control rate
+ *     (ControlRate.h); the VCA envelope stays per sample
  */
 
 #pragma once
@@ -28,6 +31,11 @@
 #include <array>
 #include <algorithm>
 
+#include "ADEnvelope.h"
+#include "BandLimitedOscillator.h"
+#include "ControlRate.h"
+#include "PitchTables.h"
+
 // Constants
 static constexpr float PI = 3.14159265358979323846f;
 static constexpr float TWO_PI = 2.0f * PI;
@@ -38,180 +46,167 @@ static constexpr float TWO_PI = 2.0f * PI;
 enum class Waveform { Saw = 0, Square = 1, Triangle = 2, Sine = 3 };
 
 /**
- * @brief Attack/Decay Envelope Generator
+ * @brief A VCO and its two subharmonics, divided from one phase
+ *
+ * The hardware divides: each sub counts the VCO's cycles and steps once
+ * every N of them. So here one phase accumulator runs at the VCO's rate,
+ * and each sub keeps an integer count of its wraps. A sub's phase is
+ * (count + phase) / N: locked to the VCO's exactly, whatever the pitch
+ * does, and nothing to retune per block.
+ *
+ * The three run as lanes of one group (the fourth is padding), so each
+ * per-sample step is a short loop across the lanes.
+ *
+ * Saw and square edges are band-limited with two-sample polyBLEPs (the
+ * same aliasing as the DPW oscillators the subs used to be). An edge can
+ * only fall where the VCO wraps or half-way through its cycle, and a
+ * divided lane sits as many samples from its edge as the VCO does from
+ * its own. So the residuals are worked out once per sample, just after
+ * and just before each of those two points, and shared: a lane takes one
+ * when its count says its edge is there. Triangle and sine are evaluated
+ * straight from the phase, as in BandLimitedOscillator.h.
  */
-class ADEnvelope
+class DividedOscillator
 {
 public:
-    enum class Stage { Idle, Attack, Decay };
+    static constexpr int LANES = 4;  // VCO, sub A, sub B, padding
+    enum Lane { VCO = 0, SUB_A, SUB_B };
 
-    void setSampleRate(float sr) { sampleRate = sr; }
-
-    void setAD(float a, float d)
+    void setSampleRate(float sr)
     {
-        attackRate = 1.0f / std::max(0.001f, a * sampleRate);
-        decayRate = 1.0f / std::max(0.001f, d * sampleRate);
+        sampleRate = sr;
+        setFrequency(frequency);
+        reset();
     }
 
-    void trigger()
+    /** The VCO's frequency; the subs follow it */
+    void setFrequency(float freq)
     {
-        stage = Stage::Attack;
+        frequency = std::clamp(freq, 1.0f, sampleRate * 0.45f);
+        increment = frequency / sampleRate;
     }
 
-    void reset()
-    {
-        stage = Stage::Idle;
-        level = 0.0f;
-    }
+    float getFrequency() const { return frequency; }
 
-    float process()
+    /** Divide lane SUB_A or SUB_B's frequency by @p div (1-16); the phase stays locked */
+    void setDivision(Lane lane, int div)
     {
-        switch (stage)
-        {
-        case Stage::Attack:
-            level += attackRate;
-            if (level >= 1.0f)
-            {
-                level = 1.0f;
-                stage = Stage::Decay;
-            }
-            break;
-
-        case Stage::Decay:
-            level -= decayRate;
-            if (level <= 0.0f)
-            {
-                level = 0.0f;
-                stage = Stage::Idle;
-            }
-            break;
-
-        case Stage::Idle:
-        default:
-            level = 0.0f;
-            break;
-        }
-
-        return level;
+        const int d = std::clamp(div, 1, 16);
+        lastCount[lane] = d - 1;
+        invDivision[lane] = 1.0f / static_cast<float>(d);
+        count[lane] %= d;
+
+        // The half-cycle edge falls on the VCO's wrap into count d / 2
+        // (even divisions) or half-way through count (d - 1) / 2 (odd)
+        halfWrapCount[lane] = d % 2 == 0 ? d / 2 : -1;
+        halfMiddleCount[lane] = d % 2 == 0 ? -1 : (d - 1) / 2;
     }
 
-    bool isActive() const { return stage != Stage::Idle; }
-    float getLevel() const { return level; }
-    Stage getStage() const { return stage; }
-
-private:
-    float sampleRate = 44100.0f;
-    float attackRate = 0.001f;
-    float decayRate = 0.001f;
-    float level = 0.0f;
-    Stage stage = Stage::Idle;
-};
-
-/**
- * @brief Multi-waveform Oscillator with PolyBLEP anti-aliasing
- */
-class MultiOscillator
-{
-public:
-    void setSampleRate(float sr) { sampleRate = sr; }
+    void setLevel(Lane lane, float l) { level[lane] = l; }
+    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
 
-    void setFrequency(float freq)
+    /** Restart the VCO and the sub counts at phase 0 */
+    void reset()
     {
-        frequency = std::clamp(freq, 1.0f, sampleRate * 0.45f);
-        phaseIncrement = frequency / sampleRate;
+        phase = 0.0f;
+        for (int k = 0; k < LANES; ++k)
+            count[k] = 0;
     }
 
-    void setLevel(float l) { level = l; }
-    void setWaveform(Waveform w) { waveform = w; }
-    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
-
-    void reset() { phase = 0.0f; }
-
+    /** The three lanes, mixed at their levels */
     float process()
     {
-        float output = 0.0f;
-
+        const float dt = increment;
+
+        // The shared residuals of a rising edge of 2, 0 away from the edges
+        float half = phase - 0.5f;
+        if (half < 0.0f)
+            half += 1.0f;
+        const float wrapAfter = residualAfter(phase, dt);
+        const float wrapBefore = residualBefore(phase, dt);
+        const float halfResidual = residualAfter(half, dt) + residualBefore(half, dt);
+
+        float p[LANES];
+        for (int k = 0; k < LANES; ++k)
+            p[k] = (static_cast<float>(count[k]) + phase) * invDivision[k];
+
+        // The shape once for all the lanes
+        float out[LANES];
         switch (waveform)
         {
         case Waveform::Saw:
-            output = 2.0f * phase - 1.0f;
-            output -= polyBlepSaw(phase, phaseIncrement);
+            for (int k = 0; k < LANES; ++k)
+            {
+                const float atWrap = (count[k] == 0 ? wrapAfter : 0.0f) + (count[k] == lastCount[k] ? wrapBefore : 0.0f);
+                out[k] = 2.0f * p[k] - 1.0f - atWrap;
+            }
             break;
-
         case Waveform::Square:
-            output = phase < 0.5f ? 1.0f : -1.0f;
-            output += polyBlepSquare(phase, phaseIncrement);
+            for (int k = 0; k < LANES; ++k)
+            {
+                const float atWrap = (count[k] == 0 ? wrapAfter : 0.0f) + (count[k] == lastCount[k] ? wrapBefore : 0.0f);
+
+                // Into the wrap that starts the half-cycle edge's count, or
+                // the count before it
+                const float atHalf = (count[k] == halfWrapCount[k] ? wrapAfter : 0.0f)
+                                     + (count[k] + 1 == halfWrapCount[k] ? wrapBefore : 0.0f)
+                                     + (count[k] == halfMiddleCount[k] ? halfResidual : 0.0f);
+                out[k] = (p[k] < 0.5f ? 1.0f : -1.0f) + atWrap - atHalf;
+            }
             break;
-
         case Waveform::Triangle:
-            // Integrated square wave for triangle
-            output = 4.0f * std::abs(phase - 0.5f) - 1.0f;
+            for (int k = 0; k < LANES; ++k)
+                out[k] = OscPhase::triangle(p[k]);
             break;
-
         case Waveform::Sine:
-            output = std::sin(TWO_PI * phase);
+        default:
+            for (int k = 0; k < LANES; ++k)
+                out[k] = OscPhase::sine(p[k]);
             break;
         }
 
-        // Advance phase
-        phase += phaseIncrement;
+        phase += dt;
         if (phase >= 1.0f)
+        {
             phase -= 1.0f;
+            for (int k = 0; k < LANES; ++k)
+                count[k] = count[k] == lastCount[k] ? 0 : count[k] + 1;
+        }
 
-        return output * level;
+        return out[VCO] * level[VCO] + out[SUB_A] * level[SUB_A] + out[SUB_B] * level[SUB_B];
     }
 
-    float getPhase() const { return phase; }
-    float getFrequency() const { return frequency; }
-
 private:
-    float polyBlepSaw(float t, float dt)
+    /** polyBLEP residual at phase @p t, moving @p dt a sample, in the sample after an edge at 0 */
+    static float residualAfter(float t, float dt)
     {
-        if (t < dt)
-        {
-            t /= dt;
-            return t + t - t * t - 1.0f;
-        }
-        else if (t > 1.0f - dt)
-        {
-            t = (t - 1.0f) / dt;
-            return t * t + t + t + 1.0f;
-        }
-        return 0.0f;
+        if (t >= dt)
+            return 0.0f;
+        const float x = t / dt;
+        return x + x - x * x - 1.0f;
     }
 
-    float polyBlepSquare(float t, float dt)
+    /** ... and in the sample before an edge at 1 */
+    static float residualBefore(float t, float dt)
     {
-        float blep = 0.0f;
-        // Rising edge at 0
-        if (t < dt)
-        {
-            float x = t / dt;
-            blep = x + x - x * x - 1.0f;
-        }
-        else if (t > 1.0f - dt)
-        {
-            float x = (t - 1.0f) / dt;
-            blep = x * x + x + x + 1.0f;
-        }
-        // Falling edge at 0.5
-        if (t > 0.5f - dt && t < 0.5f + dt)
-        {
-            float x = (t - 0.5f) / dt;
-            if (t < 0.5f)
-                blep -= (x + x - x * x - 1.0f);
-            else
-                blep -= (x * x + x + x + 1.0f);
-        }
-        return blep;
+        if (t <= 1.0f - dt)
+            return 0.0f;
+        const float y = (t - 1.0f) / dt;
+        return y * y + y + y + 1.0f;
     }
 
     float sampleRate = 44100.0f;
     float frequency = 220.0f;
+    float increment = 220.0f / 44100.0f;
     float phase = 0.0f;
-    float phaseIncrement = 0.005f;
-    float level = 1.0f;
     Waveform waveform = Waveform::Saw;
+
+    int count[LANES] = {0, 0, 0, 0};
+    int lastCount[LANES] = {0, 1, 2, 0};           // Division - 1
+    float invDivision[LANES] = {1.0f, 0.5f, 1.0f / 3.0f, 1.0f};
+    int halfWrapCount[LANES] = {-1, 1, -1, -1};    // Count the half edge starts (even divisions)
+    int halfMiddleCount[LANES] = {0, -1, 1, 0};    // Count the half edge splits (odd divisions)
+    float level[LANES] = {0.8f, 0.5f, 0.5f, 0.0f};
 };
 
 /**
@@ -227,19 +222,21 @@ public:
     {
         sampleRate = sr;
         std::fill(stage.begin(), stage.end(), 0.0f);
+        gRamp.reset(computeG());
     }
 
+    /** Jump straight to freq */
     void setCutoff(float freq)
     {
         cutoffFreq = std::clamp(freq, 20.0f, std::min(20000.0f, sampleRate * 0.45f));
+        gRamp.reset(computeG());
+    }
 
-        // Improved coefficient calculation for better low-frequency response
-        float fc = cutoffFreq / sampleRate;
-        fc = std::clamp(fc, 0.001f, 0.45f);
-
-        // Use tangent approximation for more accurate filter response
-        g = std::tan(PI * fc);
-        g = g / (1.0f + g);  // Normalized for trapezoidal integration
+    /** Glide to freq over the next n process() calls (control rate) */
+    void glideCutoff(float freq, int n)
+    {
+        cutoffFreq = std::clamp(freq, 20.0f, std::min(20000.0f, sampleRate * 0.45f));
+        gRamp.setTarget(computeG(), n);
     }
 
     void setResonance(float res)
@@ -251,6 +248,8 @@ public:
 
     float process(float input)
     {
+        const float g = gRamp.next();
+
         // Feedback with saturation
         float feedback = k * (stage[3] - 0.5f * input);
         float u = input - std::tanh(feedback);
@@ -273,10 +272,21 @@ public:
     }
 
 private:
+    float computeG() const
+    {
+        // Improved coefficient calculation for better low-frequency response
+        float fc = cutoffFreq / sampleRate;
+        fc = std::clamp(fc, 0.001f, 0.45f);
+
+        // Use tangent approximation for more accurate filter response
+        float g = std::tan(PI * fc);
+        return g / (1.0f + g);  // Normalized for trapezoidal integration
+    }
+
     float sampleRate = 44100.0f;
     float cutoffFreq = 5000.0f;
     float resonance = 0.0f;
-    float g = 0.5f;
+    ControlRamp gRamp;  // Integrator gain, linear between control blocks
     float k = 0.0f;
     std::array<float, 4> stage{};
 };
@@ -297,9 +307,7 @@ public:
     {
         sampleRate = sr;
 
-        vco.setSampleRate(sr);
-        subA.setSampleRate(sr);
-        subB.setSampleRate(sr);
+        oscillators.setSampleRate(sr);
 
         filter.setSampleRate(sr);
         vcaEnv.setSampleRate(sr);
@@ -321,22 +329,16 @@ public:
         vcfEnv.reset();
     }
 
-    float process()
+    /**
+     * @brief Control-rate update for the next n process() calls
+     *
+     * Steps the VCF envelope once and glides the filter to the block-end
+     * cutoff.
+     */
+    void updateControl(int n)
     {
-        // Update subharmonic frequencies
-        subA.setFrequency(vco.getFrequency() / static_cast<float>(subADiv));
-        subB.setFrequency(vco.getFrequency() / static_cast<float>(subBDiv));
-
-        // Generate oscillators
-        float vcoOut = vco.process();
-        float subAOut = subA.process();
-        float subBOut = subB.process();
-
-        // Mix
-        float mix = vcoOut * vcoLevel + subAOut * subALevel + subBOut * subBLevel;
-
         // VCF Envelope modulation
-        float vcfEnvOut = vcfEnv.process();
+        float vcfEnvOut = vcfEnv.advance(n);
         float modCutoff;
 
         if (vcfEnvAmount >= 0.0f)
@@ -348,10 +350,16 @@ public:
             modCutoff = filterCutoff + std::abs(vcfEnvAmount) * (1.0f - vcfEnvOut) * 15000.0f;
         }
 
-        filter.setCutoff(modCutoff);
+        filter.glideCutoff(modCutoff, n);
         filter.setResonance(filterResonance);
+    }
+
+    float process()
+    {
+        // Oscillators, mixed
+        float mix = oscillators.process();
 
-        // Apply filter
+        // Apply filter (cutoff gliding since updateControl)
         float filtered = filter.process(mix);
 
         // VCA Envelope
@@ -363,14 +371,14 @@ public:
     // VCO settings
     void setVCOFrequency(float freq) { baseFreq = freq; updateVCOFrequency(); }
     void setVCOPitchOffset(float semitones) { pitchOffset = semitones; updateVCOFrequency(); }
-    void setVCOLevel(float l) { vcoLevel = l; }
-    void setVCOWaveform(int w) { vco.setWaveform(w); subA.setWaveform(w); subB.setWaveform(w); }
+    void setVCOLevel(float l) { oscillators.setLevel(DividedOscillator::VCO, l); }
+    void setVCOWaveform(int w) { oscillators.setWaveform(w); }
 
     // Subharmonic settings
-    void setSubADivision(int div) { subADiv = std::clamp(div, 1, 16); }
-    void setSubBDivision(int div) { subBDiv = std::clamp(div, 1, 16); }
-    void setSubALevel(float l) { subALevel = l; }
-    void setSubBLevel(float l) { subBLevel = l; }
+    void setSubADivision(int div) { oscillators.setDivision(DividedOscillator::SUB_A, div); }
+    void setSubBDivision(int div) { oscillators.setDivision(DividedOscillator::SUB_B, div); }
+    void setSubALevel(float l) { oscillators.setLevel(DividedOscillator::SUB_A, l); }
+    void setSubBLevel(float l) { oscillators.setLevel(DividedOscillator::SUB_B, l); }
 
     // Filter settings
     void setFilterCutoff(float freq) { filterCutoff = freq; }
@@ -388,25 +396,17 @@ public:
 private:
     void updateVCOFrequency()
     {
-        float freq = baseFreq * std::pow(2.0f, pitchOffset / 12.0f);
-        vco.setFrequency(freq);
+        float freq = baseFreq * PitchTables::get().semitonesToRatio(pitchOffset);
+        oscillators.setFrequency(freq);
     }
 
     float sampleRate = 44100.0f;
 
-    // Oscillators
-    MultiOscillator vco;
-    MultiOscillator subA;
-    MultiOscillator subB;
+    // VCO and subharmonics, phase-locked
+    DividedOscillator oscillators;
 
     float baseFreq = 220.0f;
     float pitchOffset = 0.0f;
-    float vcoLevel = 0.8f;
-
-    int subADiv = 2;
-    int subBDiv = 3;
-    float subALevel = 0.5f;
-    float subBLevel = 0.5f;
 
     // Filter
     LadderFilter filter;
@@ -415,8 +415,8 @@ private:
     float vcfEnvAmount = 0.5f;
 
     // Envelopes
-    ADEnvelope vcaEnv;
-    ADEnvelope vcfEnv;
+    LinearADEnvelope vcaEnv;
+    LinearADEnvelope vcfEnv;
 
     float vcaAttack = 0.01f;
     float vcaDecay = 0.5f;
@@ -455,6 +455,14 @@ public:
     {
         for (int i = 0; i < numSamples; ++i)
         {
+            // Envelopes and cutoff once per control block
+            if (i % ControlRamp::BLOCK_SIZE == 0)
+            {
+                const int n = std::min(numSamples - i, ControlRamp::BLOCK_SIZE);
+                voice1.updateControl(n);
+                voice2.updateControl(n);
+            }
+
             float voice1Out = voice1.process();
             float voice2Out = voice2.process();
 
@@ -0,0 +1,199 @@
+/**
+ * @file test_engine.cpp
+ * @brief Unit tests for the Subharmonicon's clock scheduling
+ *
+ * Tests:
+ * - Clock edges land on their samples whatever the block boundaries
+ * - A tempo change retimes the clock from the last edge
+ * - A 64x rhythm's edges each land on their own sample
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "dsp/SynthEngine.h"
+
+// ============================================================================
+// Test Utilities
+// ============================================================================
+namespace {
+
+/** A tempo change at the start of a block */
+struct TempoChange
+{
+    int sample;
+    float bpm;
+};
+
+/**
+ * @brief Where rhythm 1's edges should land
+ *
+ * The master clock runs 4 clocks a beat, and a rhythm at division d fires
+ * d times a clock. The sample that takes the time since the last edge to
+ * the step length is an edge (StepClock), so edge n of a steady clock is
+ * sample ceil(n * step) - 1. A tempo change sets the length of the step
+ * it falls in, counted from the last edge.
+ */
+std::vector<int> expectedEdges(double sampleRate, float bpm, float division, std::vector<TempoChange> changes,
+                               int count)
+{
+    const auto stepFor = [&](float t) { return sampleRate * 60.0 / (t * 4.0) / division; };
+
+    std::vector<int> edges;
+    double clock = 0.0;  // Time of the last edge, in samples
+    double step = stepFor(bpm);
+    size_t c = 0;
+    while (static_cast<int>(edges.size()) < count)
+    {
+        const int edge = static_cast<int>(std::ceil(clock + step)) - 1;
+        if (c < changes.size() && changes[c].sample <= edge)
+        {
+            step = stepFor(changes[c++].bpm);
+            continue;
+        }
+        edges.push_back(edge);
+        clock += step;
+    }
+    return edges;
+}
+
+/** An engine running rhythm 1 alone into sequencer 1 */
+struct ClockedEngine
+{
+    SubharmoniconEngine engine;
+    std::vector<float> left = std::vector<float>(4096);
+    std::vector<float> right = std::vector<float>(4096);
+    std::vector<TempoChange> changes;
+    size_t nextChange = 0;
+    int position = 0;
+
+    ClockedEngine(double sampleRate, float bpm, float division, std::vector<TempoChange> tempoChanges = {})
+        : changes(std::move(tempoChanges))
+    {
+        engine.prepare(sampleRate, 512);
+        engine.setTempo(bpm);
+        engine.setRhythm1Division(division);
+        engine.setRhythm2Division(0.015625f);  // Every 64 clocks: after these tests end
+        engine.setRhythm3Division(0.015625f);
+        engine.setRhythm4Division(0.015625f);
+        engine.setRunning(true);
+    }
+
+    /** Render one block up to @p end, or to the next tempo change, which is applied first */
+    void renderBlock(int end)
+    {
+        if (nextChange < changes.size() && changes[nextChange].sample == position)
+            engine.setTempo(changes[nextChange++].bpm);
+        if (nextChange < changes.size())
+            end = std::min(end, changes[nextChange].sample);
+
+        engine.renderBlock(left.data(), right.data(), end - position);
+        position = end;
+    }
+
+    /** Render up to @p end in blocks of varied length */
+    void renderTo(int end)
+    {
+        static constexpr int lengths[] = {512, 1, 17, 333, 64, 2048, 5, 700};
+        for (int i = 0; position < end; ++i)
+            renderBlock(std::min(end, position + lengths[i % 8]));
+    }
+
+    int step() const { return engine.getSeq1CurrentStep(); }
+};
+
+/**
+ * @brief Render across each edge and check sequencer 1 steps on it
+ *
+ * Each edge gets a block of its own varied length, with the edge as its
+ * first sample (@p edgeFirst) or its last. The step before the block and
+ * after it pin the edge to the block's first or last sample: the two
+ * runs together pin it to its exact sample.
+ */
+void checkEdges(ClockedEngine& clocked, const std::vector<int>& edges, bool edgeFirst)
+{
+    for (size_t n = 0; n < edges.size(); ++n)
+    {
+        const int edge = edges[n];
+        const int previous = n > 0 ? edges[n - 1] : -1;
+        const int room = edgeFirst ? (n + 1 < edges.size() ? edges[n + 1] - edge : 1) : edge - previous;
+        const int length = std::clamp(1 + static_cast<int>(n * 97 % 1500), 1, room);
+        const int start = edgeFirst ? edge : edge + 1 - length;
+
+        INFO("edge " << n + 1 << " at sample " << edge << ", in a block of " << length);
+
+        clocked.renderTo(start);
+        REQUIRE(clocked.step() == static_cast<int>(n % StepSequencer::NUM_STEPS));
+
+        clocked.renderBlock(start + length);
+        REQUIRE(clocked.step() == static_cast<int>((n + 1) % StepSequencer::NUM_STEPS));
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Clock scheduling
+// ============================================================================
+
+TEST_CASE("Clock edges land on their samples across block boundaries", "[engine][clock]")
+{
+    // 123 BPM at 44.1 kHz: 5378.05 samples a clock, so the fraction carries
+    const auto edges = expectedEdges(44100.0, 123.0f, 1.0f, {}, 24);
+
+    SECTION("Edge on a block's first sample")
+    {
+        ClockedEngine clocked(44100.0, 123.0f, 1.0f);
+        checkEdges(clocked, edges, true);
+    }
+
+    SECTION("Edge on a block's last sample")
+    {
+        ClockedEngine clocked(44100.0, 123.0f, 1.0f);
+        checkEdges(clocked, edges, false);
+    }
+}
+
+TEST_CASE("A tempo change retimes the clock from the last edge", "[engine][clock]")
+{
+    // 6000 samples a clock at 120 BPM, 4800 at 150 and 6819.59 at 97. Each
+    // change falls between two edges, over 1500 samples (the longest edge
+    // block) from both, and sets the length of the step it falls in
+    const std::vector<TempoChange> changes = {{14000, 150.0f}, {30001, 97.0f}, {50000, 120.0f}};
+    const auto edges = expectedEdges(48000.0, 120.0f, 1.0f, changes, 16);
+
+    REQUIRE(edges[2] == 16799);  // 12000 + 4800, less one
+
+    SECTION("Edge on a block's first sample")
+    {
+        ClockedEngine clocked(48000.0, 120.0f, 1.0f, changes);
+        checkEdges(clocked, edges, true);
+    }
+
+    SECTION("Edge on a block's last sample")
+    {
+        ClockedEngine clocked(48000.0, 120.0f, 1.0f, changes);
+        checkEdges(clocked, edges, false);
+    }
+}
+
+TEST_CASE("A 64x rhythm's edges each land on their own sample", "[engine][clock]")
+{
+    // 84.03 samples apart at 123 BPM, so a host block holds several
+    const auto edges = expectedEdges(44100.0, 123.0f, 64.0f, {}, 200);
+
+    SECTION("Edge on a block's first sample")
+    {
+        ClockedEngine clocked(44100.0, 123.0f, 64.0f);
+        checkEdges(clocked, edges, true);
+    }
+
+    SECTION("Edge on a block's last sample")
+    {
+        ClockedEngine clocked(44100.0, 123.0f, 64.0f);
+        checkEdges(clocked, edges, false);
+    }
+}
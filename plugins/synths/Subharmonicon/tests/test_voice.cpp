@@ -0,0 +1,143 @@
+/**
+ * @file test_voice.cpp
+ * @brief Unit tests for the Subharmonicon's divided oscillators
+ *
+ * Tests:
+ * - Sub edges land on VCO edges while the VCO sweeps
+ * - A sub steps once every N of the VCO's edges
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "dsp/Voice.h"
+
+// ============================================================================
+// Test Utilities
+// ============================================================================
+namespace {
+
+constexpr float SAMPLE_RATE = 48000.0f;
+
+/** 40 Hz to 4 kHz and back, exponentially, a second each way */
+std::vector<float> makeSweep()
+{
+    const int half = static_cast<int>(SAMPLE_RATE);
+    std::vector<float> sweep(static_cast<size_t>(2 * half));
+    for (int i = 0; i < half; ++i)
+    {
+        const float f = 40.0f * std::pow(100.0f, static_cast<float>(i) / static_cast<float>(half));
+        sweep[static_cast<size_t>(i)] = f;
+        sweep[static_cast<size_t>(2 * half - 1 - i)] = f;
+    }
+    return sweep;
+}
+
+/** One lane of a DividedOscillator on its own, retuned every sample */
+std::vector<float> renderLane(DividedOscillator::Lane lane, Waveform waveform, int divA, int divB,
+                              const std::vector<float>& sweep)
+{
+    DividedOscillator osc;
+    osc.setSampleRate(SAMPLE_RATE);
+    osc.setWaveform(static_cast<int>(waveform));
+    osc.setDivision(DividedOscillator::SUB_A, divA);
+    osc.setDivision(DividedOscillator::SUB_B, divB);
+    for (auto l : {DividedOscillator::VCO, DividedOscillator::SUB_A, DividedOscillator::SUB_B})
+        osc.setLevel(l, l == lane ? 1.0f : 0.0f);
+
+    std::vector<float> out;
+    out.reserve(sweep.size());
+    for (float f : sweep)
+    {
+        osc.setFrequency(f);
+        out.push_back(osc.process());
+    }
+    return out;
+}
+
+/** Where @p x crosses zero, interpolated between samples: falling only (saw), or either way (square) */
+std::vector<double> zeroCrossings(const std::vector<float>& x, bool fallingOnly)
+{
+    std::vector<double> crossings;
+    for (size_t n = 1; n < x.size(); ++n)
+    {
+        const float a = x[n - 1];
+        const float b = x[n];
+        const bool falling = a > 0.0f && b <= 0.0f;
+        const bool rising = a <= 0.0f && b > 0.0f;
+        if (falling || (rising && !fallingOnly))
+            crossings.push_back(static_cast<double>(n - 1) + static_cast<double>(a / (a - b)));
+    }
+    return crossings;
+}
+
+/**
+ * Each of the sub's edges must fall on one of the VCO's (within a fraction
+ * of a sample: the lanes share the VCO's polyBLEP residuals), and
+ * consecutive sub edges must be @p div VCO edges apart
+ */
+void checkLocked(const std::vector<double>& vcoEdges, const std::vector<double>& subEdges, int div)
+{
+    REQUIRE(subEdges.size() > 20);
+
+    long previous = -1;
+    for (double edge : subEdges)
+    {
+        const auto it = std::lower_bound(vcoEdges.begin(), vcoEdges.end(), edge);
+        long nearest = static_cast<long>(it - vcoEdges.begin());
+        if (it == vcoEdges.end() || (it != vcoEdges.begin() && edge - *(it - 1) < *it - edge))
+            --nearest;
+
+        INFO("sub edge at sample " << edge);
+        REQUIRE(std::abs(vcoEdges[static_cast<size_t>(nearest)] - edge) < 0.25);
+        if (previous >= 0)
+            REQUIRE(nearest - previous == div);
+        previous = nearest;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Phase-divided subs
+// ============================================================================
+
+TEST_CASE("Sub saw edges land on VCO edges through a sweep", "[voice][divider]")
+{
+    const auto sweep = makeSweep();
+
+    for (const auto& [divA, divB] : {std::pair{2, 3}, std::pair{5, 16}, std::pair{7, 4}})
+    {
+        CAPTURE(divA, divB);
+
+        const auto vco = zeroCrossings(renderLane(DividedOscillator::VCO, Waveform::Saw, divA, divB, sweep), true);
+        const auto subA = zeroCrossings(renderLane(DividedOscillator::SUB_A, Waveform::Saw, divA, divB, sweep), true);
+        const auto subB = zeroCrossings(renderLane(DividedOscillator::SUB_B, Waveform::Saw, divA, divB, sweep), true);
+
+        checkLocked(vco, subA, divA);
+        checkLocked(vco, subB, divB);
+    }
+}
+
+TEST_CASE("Sub square edges land on VCO edges through a sweep", "[voice][divider]")
+{
+    // Even divisions put the sub's half-cycle edge on a VCO wrap, odd ones
+    // half-way through a VCO cycle: either way on a VCO edge, and every
+    // N VCO edges (two a cycle) a sub edge (two a sub cycle)
+    const auto sweep = makeSweep();
+
+    for (const auto& [divA, divB] : {std::pair{2, 3}, std::pair{5, 16}, std::pair{7, 4}})
+    {
+        CAPTURE(divA, divB);
+
+        const auto vco = zeroCrossings(renderLane(DividedOscillator::VCO, Waveform::Square, divA, divB, sweep), false);
+        const auto subA = zeroCrossings(renderLane(DividedOscillator::SUB_A, Waveform::Square, divA, divB, sweep), false);
+        const auto subB = zeroCrossings(renderLane(DividedOscillator::SUB_B, Waveform::Square, divA, divB, sweep), false);
+
+        checkLocked(vco, subA, divA);
+        checkLocked(vco, subB, divB);
+    }
+}
@@ -36,7 +36,10 @@ const getNormalized = (paramId: string, rawValue: number): number => {
 };
 
 const App: React.FC = () => {
-  const { isConnected, audioData: bridgeAudioData } = useJUCEBridge({ enableAudioData: true });
+  const { isConnected, audioData: bridgeAudioData } = useJUCEBridge({
+    enableAudioData: true,
+    liveViews: ['scope', 'sequencer'],
+  });
 
   const { paramValues, handleChange } = useParameters({
     parameters: PARAMETER_DEFINITIONS,
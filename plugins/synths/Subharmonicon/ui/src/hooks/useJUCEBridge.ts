@@ -24,8 +24,10 @@ declare global {
       };
     };
     onParameterUpdate?: (paramId: string, value: number) => void;
+    onParametersUpdate?: (values: Record<string, number>) => void;
     onStateUpdate?: (state: Record<string, number>) => void;
     onAudioData?: (samples: number[]) => void;
+    onAudioDataBase64?: (data: string) => void;
     onSequencerState?: (state: unknown) => void;
   }
 }
@@ -33,11 +35,14 @@ declare global {
 /**
  * Hook options
  */
+export type LiveView = 'scope' | 'spectrum' | 'meters' | 'sequencer';
+
 export interface UseJUCEBridgeOptions {
   /** Enable audio data callbacks */
   enableAudioData?: boolean;
   /** Audio channel to monitor */
   audioChannel?: 'left' | 'right' | 'master';
+  liveViews?: LiveView[];
 }
 
 /**
@@ -58,11 +63,19 @@ export interface UseJUCEBridgeReturn {
   audioData: number[];
 }
 
+/**
+ * Decode scope samples sent by the editor: base64 of little-endian Float32
+ */
+const decodeScopeSamples = (data: string): number[] => {
+  const bytes = Uint8Array.from(atob(data), (c) => c.charCodeAt(0));
+  return Array.from(new Float32Array(bytes.buffer, 0, bytes.length >> 2));
+};
+
 /**
  * React hook for JUCE WebView communication
  */
 export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridgeReturn {
-  const { enableAudioData = false } = options;
+  const { enableAudioData = false, liveViews = enableAudioData ? ['scope'] : [] } = options;
 
   const [isConnected, setIsConnected] = useState(false);
   const [audioData, setAudioData] = useState<number[]>([]);
@@ -89,6 +102,13 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       paramChangeCallback.current?.(paramId, value);
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     window.onStateUpdate = (state: Record<string, number>) => {
       stateChangeCallback.current?.(state);
     };
@@ -97,12 +117,17 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       window.onAudioData = (samples: number[]) => {
         setAudioData(samples);
       };
+      window.onAudioDataBase64 = (data: string) => {
+        setAudioData(decodeScopeSamples(data));
+      };
     }
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
       window.onAudioData = undefined;
+      window.onAudioDataBase64 = undefined;
     };
   }, [enableAudioData]);
 
@@ -116,6 +141,21 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     });
   }, [isConnected]);
 
+  // Tell the editor which live views are on screen (none while the page is
+  // hidden), so it only ticks fast and feeds the scope while they are
+  const liveViewKey = liveViews.join(',');
+  useEffect(() => {
+    if (!isConnected || liveViewKey === '') return;
+    const views = liveViewKey.split(',');
+    const report = () => callNativeFunction("setLiveViews", document.hidden ? [] : views);
+    report();
+    document.addEventListener('visibilitychange', report);
+    return () => {
+      document.removeEventListener('visibilitychange', report);
+      callNativeFunction("setLiveViews", []);
+    };
+  }, [isConnected, liveViewKey, callNativeFunction]);
+
   // Send parameter to JUCE
   const setParameter = useCallback((paramId: string, value: number) => {
     const clampedValue = Math.max(0, Math.min(1, value));
@@ -7,6 +7,37 @@
 
 #ifdef HAS_UI_RESOURCES
 #include "UIResources.h"
+#include "UIResourceCache.h"
+
+namespace
+{
+std::vector<std::byte> inflateGzip(const void* data, size_t size)
+{
+    juce::MemoryInputStream compressed(data, size, false);
+    juce::GZIPDecompressorInputStream gunzip(&compressed, false, juce::GZIPDecompressorInputStream::gzipFormat);
+
+    juce::MemoryBlock inflated;
+    juce::MemoryOutputStream(inflated, false).writeFromInputStream(gunzip, -1);
+    const auto* bytes = static_cast<const std::byte*>(inflated.getData());
+    return {bytes, bytes + inflated.getSize()};
+}
+
+/** The UI files in the binary data, shared by every editor in the process */
+UIResourceCache& embeddedUI()
+{
+    static UIResourceCache cache([] {
+        std::vector<UIResourceCache::EmbeddedFile> files;
+        for (int i = 0; i < UIResources::namedResourceListSize; ++i)
+        {
+            int size = 0;
+            if (const auto* data = UIResources::getNamedResource(UIResources::namedResourceList[i], size))
+                files.push_back({UIResources::originalFilenames[i], data, static_cast<size_t>(size)});
+        }
+        return files;
+    }(), inflateGzip);
+    return cache;
+}
+} // namespace
 #endif
 
 //==============================================================================
@@ -66,6 +97,42 @@ PluginEditor::PluginEditor(PluginProcessor& p)
             [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
             {
                 sendAllParametersToWebView();
+                sendImpulseNameToWebView();
+                completion({});
+            })
+        .withNativeFunction("loadImpulse",
+            [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+            {
+                chooseImpulseResponse();
+                completion({});
+            })
+        .withNativeFunction("clearImpulse",
+            [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+            {
+                processorRef.clearImpulseResponse();
+                sendImpulseNameToWebView();
+                completion({});
+            })
+        .withNativeFunction("exportTape",
+            [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+            {
+                chooseTapeExport();
+                completion({});
+            })
+        .withNativeFunction("getPerfStats",
+            [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+            {
+                completion(getPerfStatsForWebView());
+            })
+        .withNativeFunction("setLiveViews",
+            [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+            {
+                // Names of the views on screen ("scope", "meters"...); none while the page is hidden
+                uint32_t views = 0;
+                for (const auto& arg : args)
+                    views |= EditorRefresh::viewFromName(arg.toString().toStdString());
+                refresh.setLiveViews(views);
+                updateRefreshRate();
                 completion({});
             })
         .withNativeFunction("consoleLog",
@@ -98,29 +165,30 @@ PluginEditor::PluginEditor(PluginProcessor& p)
     });
 #endif
 
-    paramListener = std::make_unique<ParameterListener>(*this);
+    // Listeners only flag changes (automation can fire them on the audio
+    // thread); timerCallback() sends the changed values in one batch
     for (auto* param : processorRef.apvts.processor.getParameters())
     {
-        if (auto* paramWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
         {
-            processorRef.apvts.addParameterListener(paramWithID->getParameterID(), paramListener.get());
+            paramListeners.push_back(std::make_unique<ParameterListener>(*this, listenedParameters.size()));
+            listenedParameters.add(ranged);
+            processorRef.apvts.addParameterListener(ranged->getParameterID(), paramListeners.back().get());
         }
     }
 
-    startTimerHz(30);
+    // Ticks at a rate for what is on screen, rechecked every tick
+    updateRefreshRate();
 }
 
 PluginEditor::~PluginEditor()
 {
     stopTimer();
+    processorRef.getScopeFifo().setConsumerAttached(false);
 
-    for (auto* param : processorRef.apvts.processor.getParameters())
-    {
-        if (auto* paramWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
-        {
-            processorRef.apvts.removeParameterListener(paramWithID->getParameterID(), paramListener.get());
-        }
-    }
+    for (size_t i = 0; i < paramListeners.size(); ++i)
+        processorRef.apvts.removeParameterListener(listenedParameters[static_cast<int>(i)]->getParameterID(),
+                                                   paramListeners[i].get());
 }
 
 //==============================================================================
@@ -148,23 +216,52 @@ void PluginEditor::resized()
 
 void PluginEditor::timerCallback()
 {
+    updateRefreshRate();
+    if (!refresh.isShowing())
+        return;  // Changed parameters keep their flags until the editor is back
+
+    sendChangedParametersToWebView();
     sendAudioDataToWebView();
+    sendOverrunsToWebView();
+}
+
+void PluginEditor::updateRefreshRate()
+{
+    auto* peer = getPeer();
+    refresh.setWindow(isShowing() && peer != nullptr && !peer->isMinimised(), juce::Process::isForegroundProcess());
+
+    // processBlock() skips the scope while nothing pulls it
+    processorRef.getScopeFifo().setConsumerAttached(refresh.wants(EditorRefresh::Scope));
+
+    const int hz = refresh.getRateHz();
+    if (getTimerInterval() != EditorRefresh::intervalMs(hz))
+        startTimerHz(hz);
 }
 
 //==============================================================================
 // WebView Bridge
 //==============================================================================
 
-void PluginEditor::sendParameterToWebView(const juce::String& paramId, float value)
+void PluginEditor::sendChangedParametersToWebView()
 {
-    if (ignoreParameterCallbacks)
+    // Everything that changed since the last tick, latest values, one call
+    juce::DynamicObject::Ptr values;
+    changedParameters.drain([&](int index)
+    {
+        auto* param = listenedParameters[index];
+        if (values == nullptr)
+            values = new juce::DynamicObject();
+        values->setProperty(param->getParameterID(), param->convertFrom0to1(param->getValue()));
+    });
+
+    if (values == nullptr)
         return;
 
 #if JUCE_WEB_BROWSER
     if (webView)
     {
-        juce::String script = "if (window.onParameterUpdate) window.onParameterUpdate('"
-                            + paramId + "', " + juce::String(value) + ");";
+        juce::String script = "if (window.onParametersUpdate) window.onParametersUpdate("
+                            + juce::JSON::toString(juce::var(values.get()), true) + ");";
         webView->evaluateJavascript(script, nullptr);
     }
 #endif
@@ -200,24 +297,136 @@ void PluginEditor::sendAudioDataToWebView()
     if (!webView)
         return;
 
-    const auto& audioData = processorRef.getVisualizationBuffer();
+    // Newest window of output samples at full resolution. The raw Float32
+    // bytes go over as base64, which is much cheaper to build (and for the
+    // page to parse) than a JSON array.
+    const int numSamples = processorRef.getScopeFifo().pullLatest(scopeSamples.data(), SCOPE_WINDOW);
+    if (numSamples == 0)
+        return;
 
-    juce::Array<juce::var> samples;
-    samples.ensureStorageAllocated(128);
+    juce::String script = "if (window.onAudioDataBase64) window.onAudioDataBase64('"
+                        + juce::Base64::toBase64(scopeSamples.data(), static_cast<size_t>(numSamples) * sizeof(float))
+                        + "');";
+    webView->evaluateJavascript(script, nullptr);
+#endif
+}
 
-    for (int i = 0; i < 128; ++i)
-    {
-        int srcIndex = (i * audioData.size()) / 128;
-        samples.add(audioData[srcIndex]);
-    }
+void PluginEditor::sendOverrunsToWebView()
+{
+    if (!webView)
+        return;
+
+    // Only when a block has run over since the last send, or the log was
+    // cleared: the last few, with what the engine was doing (OverrunLog.h)
+    auto& overruns = processorRef.getOverrunLog();
+    const auto& history = overruns.read();
+    if (history.total == lastOverrunTotal)
+        return;
+    lastOverrunTotal = history.total;
+
+    webView->evaluateJavascript("if (window.onOverruns) window.onOverruns("
+                                + juce::String(overruns.toJson(history)) + ");", nullptr);
+}
+
+void PluginEditor::sendImpulseNameToWebView()
+{
+#if JUCE_WEB_BROWSER
+    if (!webView)
+        return;
+
+    juce::String script = "if (window.onImpulseUpdate) window.onImpulseUpdate("
+                        + juce::JSON::toString(processorRef.getImpulseName()) + ");";
+    webView->evaluateJavascript(script, nullptr);
+#endif
+}
+
+void PluginEditor::chooseImpulseResponse()
+{
+    impulseChooser = std::make_unique<juce::FileChooser>("Load Impulse Response", juce::File(),
+                                                         "*.wav;*.aif;*.aiff;*.flac");
+    impulseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                [this](const juce::FileChooser& chooser)
+                                {
+                                    const auto file = chooser.getResult();
+                                    if (file.existsAsFile())
+                                    {
+                                        processorRef.loadImpulseResponse(file);
+                                        sendImpulseNameToWebView();
+                                    }
+                                });
+}
+
+void PluginEditor::chooseTapeExport()
+{
+    exportChooser = std::make_unique<juce::FileChooser>(
+        "Export Tape", juce::File::getSpecialLocation(juce::File::userMusicDirectory).getChildFile("Tape Loop.wav"),
+        "*.wav");
+    exportChooser->launchAsync(
+        juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+            | juce::FileBrowserComponent::warnAboutOverwriting,
+        [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+            if (file == juce::File())
+                return;
+
+            // Reported from the export thread: back to the message thread, if the editor's still open
+            juce::Component::SafePointer<PluginEditor> editor(this);
+            const bool started = processorRef.exportTape(file, [editor, file](bool whole) {
+                juce::MessageManager::callAsync([editor, file, whole] {
+                    if (editor != nullptr)
+                        editor->sendTapeExportToWebView(whole, file.getFullPathName());
+                });
+            });
+            if (!started)
+                sendTapeExportToWebView(false, {});
+        });
+}
+
+void PluginEditor::sendTapeExportToWebView(bool whole, const juce::String& path)
+{
+#if JUCE_WEB_BROWSER
+    if (!webView)
+        return;
 
-    juce::var samplesVar(samples);
-    juce::String json = juce::JSON::toString(samplesVar);
-    juce::String script = "if (window.onAudioData) window.onAudioData(" + json + ");";
+    juce::String script = "if (window.onTapeExport) window.onTapeExport(" + juce::String(whole ? "true" : "false")
+                        + ", " + juce::JSON::toString(path) + ");";
     webView->evaluateJavascript(script, nullptr);
 #endif
 }
 
+juce::var PluginEditor::getPerfStatsForWebView() const
+{
+    // All zero with "enabled": false unless built with SYNTH_PERF_STATS
+    const auto stats = processorRef.getPerfStats().getSnapshot();
+
+    auto* result = new juce::DynamicObject();
+    result->setProperty("enabled", stats.enabled);
+    result->setProperty("blocks", static_cast<juce::int64>(stats.blocks));
+    result->setProperty("blocksOverBudget", static_cast<juce::int64>(stats.blocksOverBudget));
+    result->setProperty("lastBlockUs", stats.lastBlockUs);
+    result->setProperty("worstBlockUs", stats.worstBlockUs);
+    result->setProperty("averageLoad", stats.averageLoad);
+
+    // Cycle counts only mean something relative to each other, so send shares
+    auto* stageShare = new juce::DynamicObject();
+    for (int s = 0; s < PerfStats::NUM_STAGES; ++s)
+    {
+        const double share = stats.blockCycles > 0
+            ? static_cast<double>(stats.stageCycles[static_cast<size_t>(s)]) / static_cast<double>(stats.blockCycles)
+            : 0.0;
+        stageShare->setProperty(PerfStats::getStageName(s), share);
+    }
+    result->setProperty("stageShare", juce::var(stageShare));
+
+    juce::Array<juce::var> voiceHistogram;
+    for (auto count : stats.voiceHistogram)
+        voiceHistogram.add(static_cast<juce::int64>(count));
+    result->setProperty("voiceHistogram", voiceHistogram);
+
+    return juce::var(result);
+}
+
 void PluginEditor::handleParameterFromWebView(const juce::String& paramId, float value)
 {
     ignoreParameterCallbacks = true;
@@ -232,7 +441,9 @@ void PluginEditor::handleParameterFromWebView(const juce::String& paramId, float
 
 void PluginEditor::handleNoteFromWebView(int note, float velocity, bool isNoteOn)
 {
-    juce::ignoreUnused(note, velocity, isNoteOn);
+    // Queued for processBlock(), never played from the message thread
+    processorRef.getUiNoteFifo().push(std::clamp(note, 0, 127), std::clamp(velocity, 0.0f, 1.0f), isNoteOn,
+                                      juce::Time::getMillisecondCounterHiRes() * 0.001);
 }
 
 std::optional<juce::WebBrowserComponent::Resource> PluginEditor::getResource(const juce::String& url)
@@ -240,21 +451,20 @@ std::optional<juce::WebBrowserComponent::Resource> PluginEditor::getResource(con
     DBG("Resource request: " + url);
 
 #ifdef HAS_UI_RESOURCES
+    // Remove the JUCE resource provider root if present
+    // On Linux: juce://juce.backend/
+    // On Windows: https://juce.backend/
     juce::String path = url;
-
     auto root = juce::WebBrowserComponent::getResourceProviderRoot();
     if (path.startsWith(root))
         path = path.substring(root.length());
 
-    if (path.isEmpty() || path == "/" || path == "index.html")
+    if (const auto* file = embeddedUI().find(path.toStdString()))
     {
+        // Resource owns its bytes, so this is the one copy per request
         juce::WebBrowserComponent::Resource resource;
-        resource.data = std::vector<std::byte>(
-            reinterpret_cast<const std::byte*>(UIResources::index_html),
-            reinterpret_cast<const std::byte*>(UIResources::index_html) + UIResources::index_htmlSize
-        );
-        resource.mimeType = "text/html";
-        DBG("Serving index.html, size: " + juce::String(UIResources::index_htmlSize));
+        resource.data = file->bytes;
+        resource.mimeType = juce::String(file->mimeType.data(), file->mimeType.size());
         return resource;
     }
 
@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -12,111 +13,25 @@
 
 PluginProcessor::PluginProcessor()
     : AudioProcessor(BusesProperties()
+                     .withInput("Input", juce::AudioChannelSet::stereo(), false)
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true))
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers for lock-free audio thread access
-    osc1WaveformParam = apvts.getRawParameterValue("osc1_waveform");
-    osc1TuneParam = apvts.getRawParameterValue("osc1_tune");
-    osc1LevelParam = apvts.getRawParameterValue("osc1_level");
-
-    osc2WaveformParam = apvts.getRawParameterValue("osc2_waveform");
-    osc2TuneParam = apvts.getRawParameterValue("osc2_tune");
-    osc2DetuneParam = apvts.getRawParameterValue("osc2_detune");
-    osc2LevelParam = apvts.getRawParameterValue("osc2_level");
-
-    loopLengthParam = apvts.getRawParameterValue("loop_length");
-    loopFeedbackParam = apvts.getRawParameterValue("loop_feedback");
-    recordLevelParam = apvts.getRawParameterValue("record_level");
-
-    tapeSaturationParam = apvts.getRawParameterValue("tape_saturation");
-    tapeWobbleRateParam = apvts.getRawParameterValue("tape_wobble_rate");
-    tapeWobbleDepthParam = apvts.getRawParameterValue("tape_wobble_depth");
-
-    tapeHissParam = apvts.getRawParameterValue("tape_hiss");
-    tapeAgeParam = apvts.getRawParameterValue("tape_age");
-    tapeDegradeParam = apvts.getRawParameterValue("tape_degrade");
-    tapeModelParam = apvts.getRawParameterValue("tape_model");
-    tapeDriveParam = apvts.getRawParameterValue("tape_drive");
-    tapeBumpParam = apvts.getRawParameterValue("tape_bump");
-
-    recAttackParam = apvts.getRawParameterValue("rec_attack");
-    recDecayParam = apvts.getRawParameterValue("rec_decay");
-
-    fmAmountParam = apvts.getRawParameterValue("fm_amount");
-
-    lfoRateParam = apvts.getRawParameterValue("lfo_rate");
-    lfoDepthParam = apvts.getRawParameterValue("lfo_depth");
-    lfoWaveformParam = apvts.getRawParameterValue("lfo_waveform");
-    lfoTargetParam = apvts.getRawParameterValue("lfo_target");
-
-    dryLevelParam = apvts.getRawParameterValue("dry_level");
-    loopLevelParam = apvts.getRawParameterValue("loop_level");
-    masterLevelParam = apvts.getRawParameterValue("master_level");
-
-    // Effects
-    delayTimeParam = apvts.getRawParameterValue("delay_time");
-    delayFeedbackParam = apvts.getRawParameterValue("delay_feedback");
-    delayMixParam = apvts.getRawParameterValue("delay_mix");
-
-    reverbReplaceParam = apvts.getRawParameterValue("reverb_replace");
-    reverbBrightnessParam = apvts.getRawParameterValue("reverb_brightness");
-    reverbDetuneParam = apvts.getRawParameterValue("reverb_detune");
-    reverbBignessParam = apvts.getRawParameterValue("reverb_bigness");
-    reverbSizeParam = apvts.getRawParameterValue("reverb_size");
-    reverbMixParam = apvts.getRawParameterValue("reverb_mix");
-
-    compThresholdParam = apvts.getRawParameterValue("comp_threshold");
-    compRatioParam = apvts.getRawParameterValue("comp_ratio");
-    compMixParam = apvts.getRawParameterValue("comp_mix");
-
-    // Sequencers (dual)
-    seqEnabledParam = apvts.getRawParameterValue("seq_enabled");
-    seqBPMParam = apvts.getRawParameterValue("seq_bpm");
-
-    // Sequencer 1
-    seq1DivisionParam = apvts.getRawParameterValue("seq1_division");
-    seq1Pitch1Param = apvts.getRawParameterValue("seq1_pitch1");
-    seq1Pitch2Param = apvts.getRawParameterValue("seq1_pitch2");
-    seq1Pitch3Param = apvts.getRawParameterValue("seq1_pitch3");
-    seq1Pitch4Param = apvts.getRawParameterValue("seq1_pitch4");
-    seq1Gate1Param = apvts.getRawParameterValue("seq1_gate1");
-    seq1Gate2Param = apvts.getRawParameterValue("seq1_gate2");
-    seq1Gate3Param = apvts.getRawParameterValue("seq1_gate3");
-    seq1Gate4Param = apvts.getRawParameterValue("seq1_gate4");
-
-    // Sequencer 2
-    seq2DivisionParam = apvts.getRawParameterValue("seq2_division");
-    seq2Pitch1Param = apvts.getRawParameterValue("seq2_pitch1");
-    seq2Pitch2Param = apvts.getRawParameterValue("seq2_pitch2");
-    seq2Pitch3Param = apvts.getRawParameterValue("seq2_pitch3");
-    seq2Pitch4Param = apvts.getRawParameterValue("seq2_pitch4");
-    seq2Gate1Param = apvts.getRawParameterValue("seq2_gate1");
-    seq2Gate2Param = apvts.getRawParameterValue("seq2_gate2");
-    seq2Gate3Param = apvts.getRawParameterValue("seq2_gate3");
-    seq2Gate4Param = apvts.getRawParameterValue("seq2_gate4");
-
-    // Voice to Loop FM
-    voiceLoopFMParam = apvts.getRawParameterValue("voice_loop_fm");
-
-    // ADSR Envelopes (per oscillator)
-    osc1AttackParam = apvts.getRawParameterValue("osc1_attack");
-    osc1DecayParam = apvts.getRawParameterValue("osc1_decay");
-    osc1SustainParam = apvts.getRawParameterValue("osc1_sustain");
-    osc1ReleaseParam = apvts.getRawParameterValue("osc1_release");
-
-    osc2AttackParam = apvts.getRawParameterValue("osc2_attack");
-    osc2DecayParam = apvts.getRawParameterValue("osc2_decay");
-    osc2SustainParam = apvts.getRawParameterValue("osc2_sustain");
-    osc2ReleaseParam = apvts.getRawParameterValue("osc2_release");
-
-    // Pan LFO
-    panSpeedParam = apvts.getRawParameterValue("pan_speed");
-    panDepthParam = apvts.getRawParameterValue("pan_depth");
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
+
+    // The effects bits getOverrunState() sets, in order
+    overruns.setEffectNames({"delay", "reverb", "convolution", "compressor"});
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -289,6 +204,44 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // Runs the Airwindows stage at 2x / 4x to cut aliasing at high drive
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"tape_oversampling", 1},
+        "Tape Oversampling",
+        juce::StringArray{"Off", "2x", "4x"},
+        0  // Default: off
+    ));
+
+    // Read head interpolation; higher orders keep the top end under wobble
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"tape_interpolation", 1},
+        "Tape Interpolation",
+        juce::StringArray{"Linear", "Hermite", "Sinc"},
+        0  // Default: linear
+    ));
+
+    // Bake saturation, age and degrade into the tape as each pass is re-recorded
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"tape_wear_on_record", 1},
+        "Wear On Record",
+        false
+    ));
+
+    // Varispeed: the record head reads faster or slower than it records
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"tape_speed", 1},
+        "Tape Speed",
+        juce::NormalisableRange<float>(0.25f, 4.0f, 0.01f),
+        1.0f,
+        juce::AudioParameterFloatAttributes().withLabel("x")
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"tape_reverse", 1},
+        "Tape Reverse",
+        false
+    ));
+
     // =========================================================================
     // RECORDING ENVELOPE
     // =========================================================================
@@ -450,6 +403,17 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // =========================================================================
+    // CONVOLUTION (loaded impulse response)
+    // =========================================================================
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"conv_mix", 1},
+        "Convolution Mix",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
     // =========================================================================
     // COMPRESSOR
     // =========================================================================
@@ -476,6 +440,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // Delays the output 5 ms so the gain leads transients (reported as latency)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID{"comp_lookahead", 1},
+        "Comp Lookahead",
+        false
+    ));
+
     // =========================================================================
     // SEQUENCERS (dual - one per oscillator)
     // =========================================================================
@@ -649,6 +620,123 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         0.0f
     ));
 
+    // =========================================================================
+    // PLAY HEADS
+    // =========================================================================
+
+    // More reads of the same tape, mixed in before the degradation; off at zero level
+    for (int head = 1; head <= TapeLoopEngine::NUM_PLAY_HEADS; ++head)
+    {
+        const juce::String id = "head" + juce::String(head) + "_";
+        const juce::String name = "Head " + juce::String(head) + " ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{id + "level", 1},
+            name + "Level",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+            0.0f
+        ));
+
+        // Behind the record head, as a fraction of the loop
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{id + "offset", 1},
+            name + "Offset",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+            0.25f * static_cast<float>(head)
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{id + "speed", 1},
+            name + "Speed",
+            juce::NormalisableRange<float>(-4.0f, 4.0f, 0.01f),
+            1.0f,
+            juce::AudioParameterFloatAttributes().withLabel("x")
+        ));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{id + "pan", 1},
+            name + "Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f),
+            0.0f
+        ));
+    }
+
+    // =========================================================================
+    // GRAIN CLOUD
+    // =========================================================================
+
+    // Windowed grains from around a place on the tape, mixed in with the heads; off at zero level
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_level", 1},
+        "Grain Level",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.0f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_density", 1},
+        "Grain Density",
+        juce::NormalisableRange<float>(1.0f, 100.0f, 0.1f),
+        20.0f,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_size", 1},
+        "Grain Size",
+        juce::NormalisableRange<float>(10.0f, 500.0f, 1.0f),
+        100.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")
+    ));
+
+    // Behind the record head, as a fraction of the loop
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_position", 1},
+        "Grain Position",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_spray", 1},
+        "Grain Spray",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.1f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_pitch", 1},
+        "Grain Pitch",
+        juce::NormalisableRange<float>(-24.0f, 24.0f, 0.01f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_pitch_spread", 1},
+        "Grain Pitch Spread",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 0.01f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("st")
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"grain_pan_spread", 1},
+        "Grain Pan Spread",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f
+    ));
+
+    // Runs the engine at 48 kHz whatever the host's rate (see core/dsp/FixedRateRenderer.h);
+    // changing it re-prepares the engine
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"render_rate", 1},
+        "Render Rate",
+        juce::StringArray{"Host", "48 kHz"},
+        0,  // Default: the host's
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)
+    ));
+
     return { params.begin(), params.end() };
 }
 
@@ -659,164 +747,346 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    overruns.prepare(sampleRate);
     currentBlockSize = samplesPerBlock;
+    renderAtFixedRate = apvts.getRawParameterValue("render_rate")->load() >= 0.5f;
+
+    // Allocating and clearing the tape takes a while: do it off the
+    // message thread (see AsyncPrepare.h). Offline renders wait for it.
+    const double renderRate = renderAtFixedRate ? FixedRateRenderer::DEFAULT_RATE : 0.0;
+    const bool lazyEffects = !isNonRealtime();  // An offline render can't wait for an effect's lines
+    tapeExporter.wait();  // It reads the tape prepare() may reallocate
+    preparer.start([this, sampleRate, samplesPerBlock, renderRate, lazyEffects] {
+        engine.setRenderRate(renderRate);
+        engine.setLazyEffects(lazyEffects);
+        engine.prepare(sampleRate, samplesPerBlock);
+    }, !isNonRealtime());
+
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
+
+#if SYNTH_TRACE
+    // A new file per prepare, opened in chrome://tracing or ui.perfetto.dev
+    traceDumper.reset();
+    const auto traceFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getNonexistentChildFile("TapeLoop-trace", ".json");
+    traceDumper = std::make_unique<TraceDumper>(traceFile.getFullPathName().toStdString(), "TapeLoop");
+    traceDumper->addRing(engine.getTrace(), "audio");
+    traceDumper->start();
+#endif
+}
 
-    // Prepare tape loop engine
-    engine.prepare(sampleRate, samplesPerBlock);
+void PluginProcessor::handleAsyncUpdate()
+{
+    // Delay or reverb lines asked for or let go (see LazyEffect.h)
+    if (preparer.isReady())
+        engine.serviceEffects();
 
-    // Clear visualization buffer
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // The render rate changed: prepare again, with the callback held off
+    // until the new prepare is under way (it's silent until ready)
+    if ((apvts.getRawParameterValue("render_rate")->load() >= 0.5f) != renderAtFixedRate)
+    {
+        suspendProcessing(true);
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
 }
 
 void PluginProcessor::releaseResources()
 {
+#if SYNTH_TRACE
+    traceDumper.reset();
+#endif
+    preparer.reset();
+    tapeExporter.wait();
     engine.releaseResources();
 }
 
+//==============================================================================
+// Impulse Response
+//==============================================================================
+
+void PluginProcessor::loadImpulseResponse(const juce::File& file)
+{
+    {
+        const juce::ScopedLock lock(impulseLock);
+        impulsePath = file.getFullPathName();
+    }
+
+    // Reading, resampling and transforming a long response takes a while:
+    // off the message thread, and the audio crossfades to it when it's done
+    impulseLoader.start([this, file] {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+            return;
+
+        const auto length = static_cast<int>(std::min<juce::int64>(
+            reader->lengthInSamples, static_cast<juce::int64>(Convolver::MAX_SECONDS * reader->sampleRate) + 1));
+        juce::AudioBuffer<float> samples(reader->numChannels > 1 ? 2 : 1, length);
+        if (!reader->read(&samples, 0, length, 0, true, samples.getNumChannels() > 1))
+            return;
+
+        engine.loadImpulse(samples.getReadPointer(0),
+                           samples.getNumChannels() > 1 ? samples.getReadPointer(1) : nullptr,
+                           static_cast<size_t>(length), reader->sampleRate);
+    }, !isNonRealtime());
+}
+
+void PluginProcessor::clearImpulseResponse()
+{
+    {
+        const juce::ScopedLock lock(impulseLock);
+        impulsePath.clear();
+    }
+    impulseLoader.start([this] { engine.clearImpulse(); }, !isNonRealtime());
+}
+
+juce::String PluginProcessor::getImpulseName() const
+{
+    const juce::ScopedLock lock(impulseLock);
+    return impulsePath.isEmpty() ? juce::String() : juce::File(impulsePath).getFileNameWithoutExtension();
+}
+
+//==============================================================================
+// Tape Export
+//==============================================================================
+
+bool PluginProcessor::exportTape(const juce::File& file, std::function<void(bool)> done)
+{
+    if (!tapeExporter.isReady())
+        return false;
+
+    // Sizing the snapshot allocates: with the audio thread held off, once
+    // a prepare in flight has sized the tape
+    preparer.wait();
+    {
+        const juce::ScopedLock lock(getCallbackLock());
+        auto& snapshot = engine.getTapeSnapshot();
+        snapshot.prepare(engine.getTapeBufferSize());
+        snapshot.request();
+    }
+
+    // Up to a minute of stereo to copy and encode: off the message thread,
+    // while the loop goes on recording
+    tapeExporter.start([this, file, done = std::move(done)] {
+        auto& snapshot = engine.getTapeSnapshot();
+
+        // The audio thread marks the fence at its next block; with none coming, mark it here
+        for (int tries = 0; tries < 50 && snapshot.isRequested(); ++tries)
+            juce::Thread::sleep(10);
+        if (snapshot.isRequested())
+        {
+            const juce::ScopedLock lock(getCallbackLock());
+            engine.markTapeSnapshot();
+        }
+
+        bool whole = false;
+        {
+            file.deleteFile();
+            auto stream = std::make_unique<juce::FileOutputStream>(file);
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+            if (stream->openedOk())
+                writer.reset(juce::WavAudioFormat().createWriterFor(stream.get(), engine.getSampleRate(), 2, 16, {}, 0));
+
+            if (writer != nullptr)
+            {
+                stream.release();  // The writer owns it
+
+                std::vector<int16_t> left(TapeSnapshot::SEGMENT_SAMPLES), right(TapeSnapshot::SEGMENT_SAMPLES);
+                std::vector<int> wideL(TapeSnapshot::SEGMENT_SAMPLES), wideR(TapeSnapshot::SEGMENT_SAMPLES);
+                bool written = true;
+                while (const size_t n = snapshot.readNext(left.data(), right.data()))
+                {
+                    // AudioFormatWriter takes integers left-justified in 32 bits
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        wideL[i] = static_cast<int>(left[i]) * 65536;
+                        wideR[i] = static_cast<int>(right[i]) * 65536;
+                    }
+                    const int* channels[] = {wideL.data(), wideR.data(), nullptr};
+                    written = written && writer->write(channels, static_cast<int>(n));
+                }
+                whole = written && !snapshot.failed();
+            }
+        }
+        snapshot.finish();
+
+        if (!whole)
+            file.deleteFile();
+        if (done)
+            done(whole);
+    });
+    return true;
+}
+
+//==============================================================================
+// Host Transport
+//==============================================================================
+
+void PluginProcessor::updateTransport()
+{
+    using Transport = sst::basic_blocks::modulators::Transport;
+    transport.status = Transport::STOPPED;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return;
+    const auto position = playHead->getPosition();
+    if (!position)
+        return;
+
+    if (const auto bpm = position->getBpm())
+        transport.tempo = *bpm;
+    if (const auto signature = position->getTimeSignature())
+        transport.signature = {static_cast<uint16_t>(signature->numerator), static_cast<uint16_t>(signature->denominator)};
+    if (const auto barStart = position->getPpqPositionOfLastBarStart())
+        transport.lastBarStartInBeats = *barStart;
+
+    // Without a beat position there is no grid to follow, so count it as stopped
+    if (const auto ppq = position->getPpqPosition())
+    {
+        transport.hostTimeInBeats = *ppq;
+        transport.timeInBeats = *ppq;
+        if (position->getIsPlaying())
+            transport.status |= Transport::PLAYING;
+    }
+    if (position->getIsRecording())
+        transport.status |= Transport::RECORDING;
+    if (position->getIsLooping())
+        transport.status |= Transport::LOOPING;
+}
+
 //==============================================================================
 // Process Block
 //==============================================================================
 
+OverrunLog::EngineState PluginProcessor::getOverrunState() const
+{
+    // The engine may still be preparing on another thread
+    OverrunLog::EngineState state;
+    if (!preparer.isReady())
+        return state;
+
+    state.qualityTier = static_cast<int>(engine.getQualityTier());
+
+    // Bits in the order of the names given in the constructor
+    if (params[kDelayMix] > 0.0f)
+        state.effects |= 1u << 0;
+    if (params[kReverbMix] > 0.0f)
+        state.effects |= 1u << 1;
+    if (params[kConvMix] > 0.0f)
+        state.effects |= 1u << 2;
+    if (params[kCompMix] > 0.0f)
+        state.effects |= 1u << 3;
+    return state;
+}
+
 void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     // CRITICAL: Suppress denormals for performance
     juce::ScopedNoDenormals noDenormals;
 
-    // Clear output buffer
-    buffer.clear();
+    // The whole block against its deadline; the state only if it ran over
+    OverrunLog::ScopedBlock timing(overruns, buffer.getNumSamples(), [this] { return getOverrunState(); });
+
+    // Silent until the engine has been prepared
+    if (!preparer.isReady())
+    {
+        buffer.clear();
+        return;
+    }
+
+    // With the input bus on, the engine reads the host's input from the
+    // same channels it writes (in place); otherwise they start cleared
+    const int numInputs = getTotalNumInputChannels();
+    if (numInputs == 0)
+        buffer.clear();
 
     auto* leftChannel = buffer.getWritePointer(0);
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // Update engine parameters from APVTS
-    engine.setOsc1Waveform(static_cast<int>(osc1WaveformParam->load()));
-    engine.setOsc1Tune(osc1TuneParam->load());
-    engine.setOsc1Level(osc1LevelParam->load());
-
-    engine.setOsc2Waveform(static_cast<int>(osc2WaveformParam->load()));
-    engine.setOsc2Tune(osc2TuneParam->load());
-    engine.setOsc2Detune(osc2DetuneParam->load());
-    engine.setOsc2Level(osc2LevelParam->load());
-
-    engine.setLoopLength(loopLengthParam->load());
-    engine.setLoopFeedback(loopFeedbackParam->load());
-    engine.setRecordLevel(recordLevelParam->load());
-
-    engine.setSaturation(tapeSaturationParam->load());
-    engine.setWobbleRate(tapeWobbleRateParam->load());
-    engine.setWobbleDepth(tapeWobbleDepthParam->load());
-
-    engine.setTapeHiss(tapeHissParam->load());
-    engine.setTapeAge(tapeAgeParam->load());
-    engine.setTapeDegrade(tapeDegradeParam->load());
-    engine.setTapeModel(static_cast<int>(tapeModelParam->load()));
-    engine.setTapeDrive(tapeDriveParam->load());
-    engine.setTapeBump(tapeBumpParam->load());
-
-    engine.setRecAttack(recAttackParam->load());
-    engine.setRecDecay(recDecayParam->load());
-
-    engine.setFMAmount(fmAmountParam->load());
-
-    engine.setLFORate(lfoRateParam->load());
-    engine.setLFODepth(lfoDepthParam->load());
-    engine.setLFOWaveform(static_cast<int>(lfoWaveformParam->load()));
-    engine.setLFOTarget(static_cast<int>(lfoTargetParam->load()));
-
-    engine.setDryLevel(dryLevelParam->load());
-    engine.setLoopLevel(loopLevelParam->load());
-    engine.setMasterLevel(masterLevelParam->load());
-
-    // Effects
-    engine.setDelayTime(delayTimeParam->load());
-    engine.setDelayFeedback(delayFeedbackParam->load());
-    engine.setDelayMix(delayMixParam->load());
-
-    engine.setReverbReplace(reverbReplaceParam->load());
-    engine.setReverbBrightness(reverbBrightnessParam->load());
-    engine.setReverbDetune(reverbDetuneParam->load());
-    engine.setReverbBigness(reverbBignessParam->load());
-    engine.setReverbSize(reverbSizeParam->load());
-    engine.setReverbMix(reverbMixParam->load());
-
-    engine.setCompThreshold(compThresholdParam->load());
-    engine.setCompRatio(compRatioParam->load());
-    engine.setCompMix(compMixParam->load());
-
-    // Sequencers (dual)
-    engine.setSeqEnabled(seqEnabledParam->load() > 0.5f);
-    engine.setSeqBPM(seqBPMParam->load());
-
-    // Sequencer 1 (Osc 1)
-    engine.setSeq1Division(static_cast<int>(seq1DivisionParam->load()));
-    engine.setSeq1StepPitch(0, static_cast<int>(seq1Pitch1Param->load()));
-    engine.setSeq1StepPitch(1, static_cast<int>(seq1Pitch2Param->load()));
-    engine.setSeq1StepPitch(2, static_cast<int>(seq1Pitch3Param->load()));
-    engine.setSeq1StepPitch(3, static_cast<int>(seq1Pitch4Param->load()));
-    engine.setSeq1StepGate(0, seq1Gate1Param->load() > 0.5f);
-    engine.setSeq1StepGate(1, seq1Gate2Param->load() > 0.5f);
-    engine.setSeq1StepGate(2, seq1Gate3Param->load() > 0.5f);
-    engine.setSeq1StepGate(3, seq1Gate4Param->load() > 0.5f);
-
-    // Sequencer 2 (Osc 2)
-    engine.setSeq2Division(static_cast<int>(seq2DivisionParam->load()));
-    engine.setSeq2StepPitch(0, static_cast<int>(seq2Pitch1Param->load()));
-    engine.setSeq2StepPitch(1, static_cast<int>(seq2Pitch2Param->load()));
-    engine.setSeq2StepPitch(2, static_cast<int>(seq2Pitch3Param->load()));
-    engine.setSeq2StepPitch(3, static_cast<int>(seq2Pitch4Param->load()));
-    engine.setSeq2StepGate(0, seq2Gate1Param->load() > 0.5f);
-    engine.setSeq2StepGate(1, seq2Gate2Param->load() > 0.5f);
-    engine.setSeq2StepGate(2, seq2Gate3Param->load() > 0.5f);
-    engine.setSeq2StepGate(3, seq2Gate4Param->load() > 0.5f);
-
-    // Voice to Loop FM
-    engine.setVoiceLoopFM(voiceLoopFMParam->load());
-
-    // ADSR Envelopes (per oscillator)
-    engine.setOsc1Attack(osc1AttackParam->load());
-    engine.setOsc1Decay(osc1DecayParam->load());
-    engine.setOsc1Sustain(osc1SustainParam->load());
-    engine.setOsc1Release(osc1ReleaseParam->load());
-
-    engine.setOsc2Attack(osc2AttackParam->load());
-    engine.setOsc2Decay(osc2DecayParam->load());
-    engine.setOsc2Sustain(osc2SustainParam->load());
-    engine.setOsc2Release(osc2ReleaseParam->load());
-
-    // Pan LFO
-    engine.setPanSpeed(panSpeedParam->load());
-    engine.setPanDepth(panDepthParam->load());
+    // Update engine parameters from APVTS (only the ones that changed)
+    params.update();
+
+    // A new render rate needs a prepare, which can't happen here
+    if ((params.index(kRenderRate) == 1) != renderAtFixedRate)
+        triggerAsyncUpdate();
+
+    // The sequencer follows the host's tempo and beat grid while it plays
+    updateTransport();
+    engine.setTransport(transport);
+    engine.applySnapshot(params);
+
+    // Oversampling and lookahead delay the output: keep the host's delay
+    // compensation in step
+    if (const int latency = engine.getLatencySamples(); latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    // A restored tape goes back in a chunk per block (see dsp/TapeState.h)
+    if (tapeReader.pending())
+        tapeReader.streamInto(engine);
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
     {
         auto message = metadata.getMessage();
+        int samplePosition = metadata.samplePosition;
 
         if (message.isNoteOn())
         {
-            engine.noteOn(message.getNoteNumber(), message.getFloatVelocity());
+            engine.noteOn(message.getNoteNumber(), message.getFloatVelocity(), samplePosition);
         }
         else if (message.isNoteOff())
         {
-            engine.noteOff(message.getNoteNumber());
+            engine.noteOff(message.getNoteNumber(), samplePosition);
         }
         else if (message.isAllNotesOff())
         {
-            engine.allNotesOff();
+            engine.allNotesOff(samplePosition);
         }
     }
 
-    // Render audio
-    engine.renderBlock(leftChannel, rightChannel, numSamples);
+    // Render audio, recording the input (a mono input feeds both sides)
+    if (numInputs > 0)
+        engine.renderBlock(leftChannel, numInputs > 1 ? rightChannel : leftChannel, leftChannel, rightChannel,
+                           numSamples);
+    else
+        engine.renderBlock(leftChannel, rightChannel, numSamples);
+
+    // Nothing audible and nothing ringing: mark the buffer cleared so hosts
+    // and wrappers that check hasBeenCleared() can skip it
+    if (engine.isSilent())
+        buffer.clear();
+
+    // An effect switched on wants its lines, or one long off let them go
+    if (engine.needsEffectService())
+        triggerAsyncUpdate();
+
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+}
+
+bool PluginProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Stereo out; the input (for use as a tape loop effect) mono, stereo or off
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
 
-    // Copy to visualization buffer (for UI oscilloscope)
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    const auto& input = layouts.getMainInputChannelSet();
+    return input.isDisabled() || input == juce::AudioChannelSet::mono() || input == juce::AudioChannelSet::stereo();
 }
 
 //==============================================================================
@@ -832,20 +1102,118 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 // State Save/Load
 //==============================================================================
 
+// State is a PluginState (see core/dsp/PluginState.h): the parameters, then
+// the tape (TapeState::encode) in a "TAPE" chunk and the impulse response's
+// path (UTF-8) in an "IMPR" chunk, if one is loaded. Older states are "TLST",
+// the size of the parameter XML, the XML (copyXmlToBinary) and the tape, or
+// a bare XML blob from before the tape was saved; both still load.
+static constexpr int STATE_MAGIC = 0x54534C54;  // "TLST"
+static constexpr uint32_t TAPE_CHUNK = PluginState::tag("TAPE");
+static constexpr uint32_t IMPULSE_CHUNK = PluginState::tag("IMPR");
+
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    // Copy the loop under the callback lock (one memcpy), encode outside it,
+    // once a prepare in flight has sized it
+    preparer.wait();
+    std::vector<int16_t> tapeL, tapeR;
+    size_t writePos = 0;
+    {
+        const juce::ScopedLock lock(getCallbackLock());
+        const size_t samples = engine.getLoopSamples();
+        tapeL.assign(engine.getTapeL(), engine.getTapeL() + samples);
+        tapeR.assign(engine.getTapeR(), engine.getTapeR() + samples);
+        writePos = engine.getTapeWritePos();
+    }
+    const auto tape = TapeState::encode(tapeL.data(), tapeR.data(), tapeL.size(), writePos,
+                                        static_cast<uint32_t>(engine.getSampleRate()));
+    state.addChunk(TAPE_CHUNK, tape.data(), tape.size());
+
+    juce::String path;
+    {
+        const juce::ScopedLock lock(impulseLock);
+        path = impulsePath;
+    }
+    if (path.isNotEmpty())
+        state.addChunk(IMPULSE_CHUNK, path.toRawUTF8(), path.getNumBytesAsUTF8());
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+
+    const uint8_t* tapeData = nullptr;
+    size_t tapeSize = 0;
+    juce::String savedImpulse;
+
+    if (PluginState::isState(data, size))
+    {
+        // Saved by a newer build: keep what's loaded rather than reset it
+        if (!PluginState::canRead(data, size))
+            return;
+
+        PluginState::Values saved;
+        PluginState::read(data, size, saved.collector(),
+            [&](uint32_t chunkTag, const uint8_t* chunk, size_t chunkSize) {
+                if (chunkTag == TAPE_CHUNK)
+                {
+                    tapeData = chunk;
+                    tapeSize = chunkSize;
+                }
+                else if (chunkTag == IMPULSE_CHUNK)
+                {
+                    savedImpulse = juce::String::fromUTF8(reinterpret_cast<const char*>(chunk),
+                                                          static_cast<int>(chunkSize));
+                }
+            });
+
+        // A parameter the state doesn't have goes back to its default, as with the XML
+        PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
+    }
+    else
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        const uint8_t* xmlData = bytes;
+        size_t xmlSize = size;
+
+        if (size >= 8 && juce::ByteOrder::littleEndianInt(bytes) == static_cast<juce::uint32>(STATE_MAGIC))
+        {
+            xmlData = bytes + 8;
+            xmlSize = std::min(static_cast<size_t>(juce::ByteOrder::littleEndianInt(bytes + 4)), size - 8);
+            tapeData = xmlData + xmlSize;
+            tapeSize = size - 8 - xmlSize;
+        }
+
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(xmlData, static_cast<int>(xmlSize)));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
     }
+
+    // The response is saved by path: one that's gone is left out
+    if (const juce::File impulse(savedImpulse); savedImpulse.isNotEmpty() && impulse.existsAsFile())
+        loadImpulseResponse(impulse);
+    else if (getImpulseName().isNotEmpty())
+        clearImpulseResponse();
+
+    // processBlock() streams the tape in; open() only indexes it
+    const juce::ScopedLock lock(getCallbackLock());
+    if (tapeData != nullptr)
+        tapeReader.open(tapeData, tapeSize);
+    else
+        tapeReader.clear();
 }
 
 //==============================================================================
@@ -7,12 +7,24 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <array>
+#include <functional>
 #include "dsp/TapeLoopEngine.h"
+#include <sst/basic-blocks/modulators/Transport.h>
+#include "OverrunLog.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
+#include "dsp/TapeState.h"
+#include "AsyncPrepare.h"
+
+#if SYNTH_TRACE
+#include "TraceDumper.h"
+#endif
 
 /**
  * @brief Main audio processor for the Tape Loop synthesizer
  */
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor,
+                        private juce::AsyncUpdater
 {
 public:
     //==========================================================================
@@ -29,6 +41,7 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     //==========================================================================
     // Editor
@@ -76,7 +89,40 @@ public:
     // Visualization
     //==========================================================================
 
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** Blocks that missed their deadline, for the editor (see core/dsp/OverrunLog.h) */
+    OverrunLog& getOverrunLog() { return overruns; }
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return engine.getPerfStats(); }
+
+    //==========================================================================
+    // Impulse Response
+    //==========================================================================
+
+    /** Read @p file and hand it to the convolver, on a background thread; saved with the state */
+    void loadImpulseResponse(const juce::File& file);
+
+    /** Drop the impulse response */
+    void clearImpulseResponse();
+
+    /** The loaded response's file name, empty if none */
+    juce::String getImpulseName() const;
+
+    //==========================================================================
+    // Tape Export
+    //==========================================================================
+
+    /**
+     * @brief Write the loop as it is now to a 16-bit WAV, streamed out on a background thread
+     * @param done Called from that thread with whether the file holds the whole loop
+     * @return False, writing nothing, while an earlier export is still running
+     *
+     * The loop keeps recording meanwhile (see TapeSnapshot.h).
+     */
+    bool exportTape(const juce::File& file, std::function<void(bool)> done = {});
 
 private:
     //==========================================================================
@@ -85,107 +131,39 @@ private:
 
     TapeLoopEngine engine;
 
+    /** Runs engine.prepare() off the message thread; silence until it's done */
+    AsyncPrepare preparer;
+
+#if SYNTH_TRACE
+    /** Writes the engine's timeline to <temp>/TapeLoop-trace*.json while prepared */
+    std::unique_ptr<TraceDumper> traceDumper;
+#endif
+
+    /** Reads impulse responses into the engine off the message thread (see AsyncPrepare.h) */
+    AsyncPrepare impulseLoader;
+
+    /** File the impulse response came from, for the state; empty if none */
+    juce::String impulsePath;
+    juce::CriticalSection impulseLock;
+
+    /** Streams tape snapshots out to WAV files (see exportTape) */
+    AsyncPrepare tapeExporter;
+
+    /** Tape restored by setStateInformation, streamed in by processBlock */
+    TapeState::TapeStateReader tapeReader;
+
+    //==========================================================================
+    // Parameters
     //==========================================================================
-    // Parameter Pointers (for lock-free audio thread access)
-    //==========================================================================
-
-    std::atomic<float>* osc1WaveformParam = nullptr;
-    std::atomic<float>* osc1TuneParam = nullptr;
-    std::atomic<float>* osc1LevelParam = nullptr;
-
-    std::atomic<float>* osc2WaveformParam = nullptr;
-    std::atomic<float>* osc2TuneParam = nullptr;
-    std::atomic<float>* osc2DetuneParam = nullptr;
-    std::atomic<float>* osc2LevelParam = nullptr;
-
-    std::atomic<float>* loopLengthParam = nullptr;
-    std::atomic<float>* loopFeedbackParam = nullptr;
-    std::atomic<float>* recordLevelParam = nullptr;
-
-    std::atomic<float>* tapeSaturationParam = nullptr;
-    std::atomic<float>* tapeWobbleRateParam = nullptr;
-    std::atomic<float>* tapeWobbleDepthParam = nullptr;
-
-    std::atomic<float>* tapeHissParam = nullptr;
-    std::atomic<float>* tapeAgeParam = nullptr;
-    std::atomic<float>* tapeDegradeParam = nullptr;
-    std::atomic<float>* tapeModelParam = nullptr;
-    std::atomic<float>* tapeDriveParam = nullptr;
-    std::atomic<float>* tapeBumpParam = nullptr;
-
-    std::atomic<float>* recAttackParam = nullptr;
-    std::atomic<float>* recDecayParam = nullptr;
-
-    std::atomic<float>* fmAmountParam = nullptr;
-
-    std::atomic<float>* lfoRateParam = nullptr;
-    std::atomic<float>* lfoDepthParam = nullptr;
-    std::atomic<float>* lfoWaveformParam = nullptr;
-    std::atomic<float>* lfoTargetParam = nullptr;
-
-    std::atomic<float>* dryLevelParam = nullptr;
-    std::atomic<float>* loopLevelParam = nullptr;
-    std::atomic<float>* masterLevelParam = nullptr;
-
-    // Effects
-    std::atomic<float>* delayTimeParam = nullptr;
-    std::atomic<float>* delayFeedbackParam = nullptr;
-    std::atomic<float>* delayMixParam = nullptr;
-
-    std::atomic<float>* reverbReplaceParam = nullptr;
-    std::atomic<float>* reverbBrightnessParam = nullptr;
-    std::atomic<float>* reverbDetuneParam = nullptr;
-    std::atomic<float>* reverbBignessParam = nullptr;
-    std::atomic<float>* reverbSizeParam = nullptr;
-    std::atomic<float>* reverbMixParam = nullptr;
-
-    std::atomic<float>* compThresholdParam = nullptr;
-    std::atomic<float>* compRatioParam = nullptr;
-    std::atomic<float>* compMixParam = nullptr;
-
-    // Sequencers (dual)
-    std::atomic<float>* seqEnabledParam = nullptr;
-    std::atomic<float>* seqBPMParam = nullptr;
-
-    // Sequencer 1 (Osc 1)
-    std::atomic<float>* seq1DivisionParam = nullptr;
-    std::atomic<float>* seq1Pitch1Param = nullptr;
-    std::atomic<float>* seq1Pitch2Param = nullptr;
-    std::atomic<float>* seq1Pitch3Param = nullptr;
-    std::atomic<float>* seq1Pitch4Param = nullptr;
-    std::atomic<float>* seq1Gate1Param = nullptr;
-    std::atomic<float>* seq1Gate2Param = nullptr;
-    std::atomic<float>* seq1Gate3Param = nullptr;
-    std::atomic<float>* seq1Gate4Param = nullptr;
-
-    // Sequencer 2 (Osc 2)
-    std::atomic<float>* seq2DivisionParam = nullptr;
-    std::atomic<float>* seq2Pitch1Param = nullptr;
-    std::atomic<float>* seq2Pitch2Param = nullptr;
-    std::atomic<float>* seq2Pitch3Param = nullptr;
-    std::atomic<float>* seq2Pitch4Param = nullptr;
-    std::atomic<float>* seq2Gate1Param = nullptr;
-    std::atomic<float>* seq2Gate2Param = nullptr;
-    std::atomic<float>* seq2Gate3Param = nullptr;
-    std::atomic<float>* seq2Gate4Param = nullptr;
-
-    // Voice to Loop FM
-    std::atomic<float>* voiceLoopFMParam = nullptr;
-
-    // ADSR Envelopes (per oscillator)
-    std::atomic<float>* osc1AttackParam = nullptr;
-    std::atomic<float>* osc1DecayParam = nullptr;
-    std::atomic<float>* osc1SustainParam = nullptr;
-    std::atomic<float>* osc1ReleaseParam = nullptr;
-
-    std::atomic<float>* osc2AttackParam = nullptr;
-    std::atomic<float>* osc2DecayParam = nullptr;
-    std::atomic<float>* osc2SustainParam = nullptr;
-    std::atomic<float>* osc2ReleaseParam = nullptr;
-
-    // Pan LFO
-    std::atomic<float>* panSpeedParam = nullptr;
-    std::atomic<float>* panDepthParam = nullptr;
+
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
+
+    /** The host's transport this block, from the play head (see updateTransport) */
+    sst::basic_blocks::modulators::Transport transport;
+
+    /** Read the play head into transport; stopped if the host gives no beat position */
+    void updateTransport();
 
     //==========================================================================
     // State
@@ -193,7 +171,20 @@ private:
 
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
-    std::array<float, 512> visualizationBuffer{};
+
+    /** Whether the engine was last prepared at the fixed render rate */
+    bool renderAtFixedRate = false;
+
+    /** On the message thread: services the lazy effects, and re-prepares when the render rate changes */
+    void handleAsyncUpdate() override;
+    ScopeFifo scopeFifo;
+
+    /** Audio thread -> UI: the last blocks that ran over, with the engine's state */
+    OverrunLog overruns;
+
+    /** What overruns records with a block that ran over (audio thread) */
+    OverrunLog::EngineState getOverrunState() const;
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
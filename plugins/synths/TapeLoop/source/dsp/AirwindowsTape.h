@@ -12,6 +12,15 @@
  *
  * Signal Flow:
  * Input -> Gain -> Softness Filter -> Head Bump -> Saturation -> Output
+ *
+ * The drive and bump gains are worked out when their setter runs, the
+ * filter constants in prepare(). Left and right run side by side as a
+ * pair through each stage (the A/B flip-flop picks the same path for
+ * both), so the compiler can keep them in one SIMD register. The
+ * sin / asin waveshapers are polynomials good to about 1e-9, well under
+ * the float output's resolution. The reference build (ReferenceDsp.h)
+ * calls std::sin and std::asin. For oversampling, the engine wraps the
+ * whole stage in an Oversampler.
  */
 
 #pragma once
@@ -21,6 +30,8 @@
 #include <cstdint>
 #include <algorithm>
 
+#include "ReferenceDsp.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -28,33 +39,6 @@
 class AirwindowsTape
 {
 public:
-    AirwindowsTape()
-    {
-        std::memset(iirMidRollerAL, 0, sizeof(double));
-        std::memset(iirMidRollerBL, 0, sizeof(double));
-        std::memset(iirHeadBumpAL, 0, sizeof(double));
-        std::memset(iirHeadBumpBL, 0, sizeof(double));
-        std::memset(iirMidRollerAR, 0, sizeof(double));
-        std::memset(iirMidRollerBR, 0, sizeof(double));
-        std::memset(iirHeadBumpAR, 0, sizeof(double));
-        std::memset(iirHeadBumpBR, 0, sizeof(double));
-        std::memset(biquadAL, 0, sizeof(biquadAL));
-        std::memset(biquadBL, 0, sizeof(biquadBL));
-        std::memset(biquadCL, 0, sizeof(biquadCL));
-        std::memset(biquadDL, 0, sizeof(biquadDL));
-        std::memset(biquadAR, 0, sizeof(biquadAR));
-        std::memset(biquadBR, 0, sizeof(biquadBR));
-        std::memset(biquadCR, 0, sizeof(biquadCR));
-        std::memset(biquadDR, 0, sizeof(biquadDR));
-        flip = false;
-        lastSampleL = 0.0;
-        lastSampleR = 0.0;
-        fpdL = 1.0;
-        fpdR = 1.0;
-        inputGain = 0.5f;  // 0dB
-        headBump = 0.0f;   // No head bump
-    }
-
     void prepare(double sr)
     {
         sampleRate = sr;
@@ -68,6 +52,7 @@ public:
     void setInputGain(float gain)
     {
         inputGain = std::clamp(gain, 0.0f, 1.0f);
+        drive = std::pow(10.0, ((inputGain - 0.5) * 24.0) / 20.0);
     }
 
     /**
@@ -77,211 +62,168 @@ public:
     void setHeadBump(float bump)
     {
         headBump = std::clamp(bump, 0.0f, 1.0f);
+        bumpGain = headBump * 0.1;
     }
 
-    void process(float& left, float& right)
-    {
-        double inputSampleL = static_cast<double>(left);
-        double inputSampleR = static_cast<double>(right);
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
 
-        // Denormal protection
-        if (std::fabs(inputSampleL) < 1.18e-23) inputSampleL = fpdL * 1.18e-17;
-        if (std::fabs(inputSampleR) < 1.18e-23) inputSampleR = fpdR * 1.18e-17;
-
-        // Input gain (drive)
-        double gain = std::pow(10.0, ((inputGain - 0.5) * 24.0) / 20.0);
-        inputSampleL *= gain;
-        inputSampleR *= gain;
-
-        // Biquad coefficient calculation (frequency-dependent parameters)
-        double overallscale = sampleRate / 44100.0;
-        double bumpGain = headBump * 0.1;
-        double HeadBumpFreq = 0.12 / overallscale;
-        double softness = 0.618033988749894848204586;
-        double RollAmount = (1.0 - softness) / overallscale;
-
-        double HighsSampleL = 0.0;
-        double HighsSampleR = 0.0;
-        double NonHighsSampleL = 0.0;
-        double NonHighsSampleR = 0.0;
-        double tempSample;
-
-        // Flip-flop filter (reduces aliasing)
-        if (flip)
+    /** Run a block through the tape in place */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
         {
-            // Left channel processing
-            iirMidRollerAL[0] = (iirMidRollerAL[0] * (1.0 - RollAmount)) + (inputSampleL * RollAmount);
-            HighsSampleL = inputSampleL - iirMidRollerAL[0];
-            NonHighsSampleL = iirMidRollerAL[0];
-
-            // Head bump (bass resonance)
-            iirHeadBumpAL[0] += (inputSampleL * 0.05);
-            iirHeadBumpAL[0] -= (iirHeadBumpAL[0] * iirHeadBumpAL[0] * iirHeadBumpAL[0] * HeadBumpFreq);
-            iirHeadBumpAL[0] = std::sin(iirHeadBumpAL[0]);
-
-            // Biquad filter for head bump
-            tempSample = (iirHeadBumpAL[0] * biquadAL[2]) + biquadAL[7];
-            biquadAL[7] = (iirHeadBumpAL[0] * biquadAL[3]) - (tempSample * biquadAL[5]) + biquadAL[8];
-            biquadAL[8] = (iirHeadBumpAL[0] * biquadAL[4]) - (tempSample * biquadAL[6]);
-            iirHeadBumpAL[0] = tempSample;
-            if (iirHeadBumpAL[0] > 1.0) iirHeadBumpAL[0] = 1.0;
-            if (iirHeadBumpAL[0] < -1.0) iirHeadBumpAL[0] = -1.0;
-            iirHeadBumpAL[0] = std::asin(iirHeadBumpAL[0]);
-
-            // Main saturation
-            inputSampleL = std::sin(inputSampleL);
-            tempSample = (inputSampleL * biquadCL[2]) + biquadCL[7];
-            biquadCL[7] = (inputSampleL * biquadCL[3]) - (tempSample * biquadCL[5]) + biquadCL[8];
-            biquadCL[8] = (inputSampleL * biquadCL[4]) - (tempSample * biquadCL[6]);
-            inputSampleL = tempSample;
-            if (inputSampleL > 1.0) inputSampleL = 1.0;
-            if (inputSampleL < -1.0) inputSampleL = -1.0;
-            inputSampleL = std::asin(inputSampleL);
-
-            // Right channel (mirror of left)
-            iirMidRollerAR[0] = (iirMidRollerAR[0] * (1.0 - RollAmount)) + (inputSampleR * RollAmount);
-            HighsSampleR = inputSampleR - iirMidRollerAR[0];
-            NonHighsSampleR = iirMidRollerAR[0];
-
-            iirHeadBumpAR[0] += (inputSampleR * 0.05);
-            iirHeadBumpAR[0] -= (iirHeadBumpAR[0] * iirHeadBumpAR[0] * iirHeadBumpAR[0] * HeadBumpFreq);
-            iirHeadBumpAR[0] = std::sin(iirHeadBumpAR[0]);
-
-            tempSample = (iirHeadBumpAR[0] * biquadAR[2]) + biquadAR[7];
-            biquadAR[7] = (iirHeadBumpAR[0] * biquadAR[3]) - (tempSample * biquadAR[5]) + biquadAR[8];
-            biquadAR[8] = (iirHeadBumpAR[0] * biquadAR[4]) - (tempSample * biquadAR[6]);
-            iirHeadBumpAR[0] = tempSample;
-            if (iirHeadBumpAR[0] > 1.0) iirHeadBumpAR[0] = 1.0;
-            if (iirHeadBumpAR[0] < -1.0) iirHeadBumpAR[0] = -1.0;
-            iirHeadBumpAR[0] = std::asin(iirHeadBumpAR[0]);
-
-            inputSampleR = std::sin(inputSampleR);
-            tempSample = (inputSampleR * biquadCR[2]) + biquadCR[7];
-            biquadCR[7] = (inputSampleR * biquadCR[3]) - (tempSample * biquadCR[5]) + biquadCR[8];
-            biquadCR[8] = (inputSampleR * biquadCR[4]) - (tempSample * biquadCR[6]);
-            inputSampleR = tempSample;
-            if (inputSampleR > 1.0) inputSampleR = 1.0;
-            if (inputSampleR < -1.0) inputSampleR = -1.0;
-            inputSampleR = std::asin(inputSampleR);
+            double inputSample[2] = {static_cast<double>(left[i]), static_cast<double>(right[i])};
+
+            // Denormal protection, then input gain (drive)
+            for (int c = 0; c < 2; ++c)
+            {
+                if (std::fabs(inputSample[c]) < 1.18e-23) inputSample[c] = fpd[c] * 1.18e-17;
+                inputSample[c] *= drive;
+            }
+
+            // Flip-flop filter (reduces aliasing): alternate samples take path A and B
+            Path& path = flip ? pathA : pathB;
+            for (int c = 0; c < 2; ++c)
+            {
+                // Head bump (bass resonance)
+                double bump = path.headBump[c] + inputSample[c] * 0.05;
+                bump -= bump * bump * bump * headBumpFreq;
+                bump = sine(bump);
+                bump = bumpFilter.process(bump, path.bumpState[0][c], path.bumpState[1][c]);
+                path.headBump[c] = arcsine(std::clamp(bump, -1.0, 1.0));
+
+                // Main saturation
+                double sample = sine(inputSample[c]);
+                sample = mainFilter.process(sample, path.mainState[0][c], path.mainState[1][c]);
+                inputSample[c] = arcsine(std::clamp(sample, -1.0, 1.0));
+            }
+            flip = !flip;
+
+            for (int c = 0; c < 2; ++c)
+            {
+                // Mix in head bump
+                inputSample[c] = (inputSample[c] * (1.0 - bumpGain)) + (pathA.headBump[c] * bumpGain) +
+                                 (pathB.headBump[c] * bumpGain);
+
+                // 32-bit dither
+                int expon;
+                frexpf(static_cast<float>(inputSample[c]), &expon);
+                fpd[c] ^= fpd[c] << 13;
+                fpd[c] ^= fpd[c] >> 17;
+                fpd[c] ^= fpd[c] << 5;
+                inputSample[c] += (static_cast<double>(fpd[c]) - uint32_t(0x7fffffff)) * 5.5e-36 * std::ldexp(1.0, expon + 62);
+            }
+
+            left[i] = static_cast<float>(inputSample[0]);
+            right[i] = static_cast<float>(inputSample[1]);
         }
-        else  // !flip
-        {
-            // Left channel (B filters)
-            iirMidRollerBL[0] = (iirMidRollerBL[0] * (1.0 - RollAmount)) + (inputSampleL * RollAmount);
-            HighsSampleL = inputSampleL - iirMidRollerBL[0];
-            NonHighsSampleL = iirMidRollerBL[0];
-
-            iirHeadBumpBL[0] += (inputSampleL * 0.05);
-            iirHeadBumpBL[0] -= (iirHeadBumpBL[0] * iirHeadBumpBL[0] * iirHeadBumpBL[0] * HeadBumpFreq);
-            iirHeadBumpBL[0] = std::sin(iirHeadBumpBL[0]);
-
-            tempSample = (iirHeadBumpBL[0] * biquadBL[2]) + biquadBL[7];
-            biquadBL[7] = (iirHeadBumpBL[0] * biquadBL[3]) - (tempSample * biquadBL[5]) + biquadBL[8];
-            biquadBL[8] = (iirHeadBumpBL[0] * biquadBL[4]) - (tempSample * biquadBL[6]);
-            iirHeadBumpBL[0] = tempSample;
-            if (iirHeadBumpBL[0] > 1.0) iirHeadBumpBL[0] = 1.0;
-            if (iirHeadBumpBL[0] < -1.0) iirHeadBumpBL[0] = -1.0;
-            iirHeadBumpBL[0] = std::asin(iirHeadBumpBL[0]);
-
-            inputSampleL = std::sin(inputSampleL);
-            tempSample = (inputSampleL * biquadDL[2]) + biquadDL[7];
-            biquadDL[7] = (inputSampleL * biquadDL[3]) - (tempSample * biquadDL[5]) + biquadDL[8];
-            biquadDL[8] = (inputSampleL * biquadDL[4]) - (tempSample * biquadDL[6]);
-            inputSampleL = tempSample;
-            if (inputSampleL > 1.0) inputSampleL = 1.0;
-            if (inputSampleL < -1.0) inputSampleL = -1.0;
-            inputSampleL = std::asin(inputSampleL);
+    }
 
-            // Right channel
-            iirMidRollerBR[0] = (iirMidRollerBR[0] * (1.0 - RollAmount)) + (inputSampleR * RollAmount);
-            HighsSampleR = inputSampleR - iirMidRollerBR[0];
-            NonHighsSampleR = iirMidRollerBR[0];
+    /** sin(x) for any x, within 2e-11 (std::sin in the reference build) */
+    static double sine(double x)
+    {
+        if constexpr (ReferenceDsp::ENABLED)
+            return std::sin(x);
+
+        // x = k pi + r with r in [-pi/2, pi/2], and sin(x) = (-1)^k sin(r).
+        // Adding 1.5 * 2^52 rounds to an integer and leaves k's parity in the
+        // low mantissa bit, without a call to round().
+        constexpr double ROUND = 6755399441055744.0;
+        const double shifted = x * (1.0 / M_PI) + ROUND;
+        const double k = shifted - ROUND;
+        const double r = (x - k * 3.141592653589793116) - k * 1.2246467991473532e-16;
+
+        const double r2 = r * r;
+        double s = r * (0.99999999990720367 +
+                        r2 * (-0.16666666555512177 +
+                              r2 * (0.0083333295830947934 +
+                                    r2 * (-0.00019840732296133197 +
+                                          r2 * (2.7520045456411946e-06 + r2 * -2.3812211085275379e-08)))));
+
+        uint64_t parity, bits;
+        std::memcpy(&parity, &shifted, sizeof(parity));
+        std::memcpy(&bits, &s, sizeof(bits));
+        bits ^= (parity & 1u) << 63;
+        std::memcpy(&s, &bits, sizeof(s));
+        return s;
+    }
 
-            iirHeadBumpBR[0] += (inputSampleR * 0.05);
-            iirHeadBumpBR[0] -= (iirHeadBumpBR[0] * iirHeadBumpBR[0] * iirHeadBumpBR[0] * HeadBumpFreq);
-            iirHeadBumpBR[0] = std::sin(iirHeadBumpBR[0]);
+    /** asin(x) for x in [-1, 1], within 1e-9 (std::asin in the reference build) */
+    static double arcsine(double x)
+    {
+        if constexpr (ReferenceDsp::ENABLED)
+            return std::asin(x);
+
+        // asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)) above a = 0.5, which keeps
+        // the polynomial on [0, 0.5], away from the infinite slope at 1
+        const double a = std::fabs(x);
+        const bool outer = a > 0.5;
+        const double z = outer ? (1.0 - a) * 0.5 : a * a;
+        const double s = outer ? std::sqrt(z) : a;
+        const double p = s + s * z *
+                                 (0.16666653289850841 +
+                                  z * (0.075008122839836919 +
+                                       z * (0.044467532458331765 +
+                                            z * (0.032167560862133959 +
+                                                 z * (0.013220204769803165 + z * 0.039075980931200217)))));
+        return std::copysign(outer ? M_PI / 2 - 2.0 * p : p, x);
+    }
 
-            tempSample = (iirHeadBumpBR[0] * biquadBR[2]) + biquadBR[7];
-            biquadBR[7] = (iirHeadBumpBR[0] * biquadBR[3]) - (tempSample * biquadBR[5]) + biquadBR[8];
-            biquadBR[8] = (iirHeadBumpBR[0] * biquadBR[4]) - (tempSample * biquadBR[6]);
-            iirHeadBumpBR[0] = tempSample;
-            if (iirHeadBumpBR[0] > 1.0) iirHeadBumpBR[0] = 1.0;
-            if (iirHeadBumpBR[0] < -1.0) iirHeadBumpBR[0] = -1.0;
-            iirHeadBumpBR[0] = std::asin(iirHeadBumpBR[0]);
+private:
+    /** Airwindows' biquad with no b1 term, as the head bump and saturation filters use it */
+    struct Biquad
+    {
+        double b0 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
 
-            inputSampleR = std::sin(inputSampleR);
-            tempSample = (inputSampleR * biquadDR[2]) + biquadDR[7];
-            biquadDR[7] = (inputSampleR * biquadDR[3]) - (tempSample * biquadDR[5]) + biquadDR[8];
-            biquadDR[8] = (inputSampleR * biquadDR[4]) - (tempSample * biquadDR[6]);
-            inputSampleR = tempSample;
-            if (inputSampleR > 1.0) inputSampleR = 1.0;
-            if (inputSampleR < -1.0) inputSampleR = -1.0;
-            inputSampleR = std::asin(inputSampleR);
+        void setBandpass(double freq, double q)
+        {
+            const double K = std::tan(M_PI * freq);
+            const double norm = 1.0 / (1.0 + K / q + K * K);
+            b0 = K / q * norm;
+            b2 = -b0;
+            a1 = 2.0 * (K * K - 1.0) * norm;
+            a2 = (1.0 - K / q + K * K) * norm;
         }
 
-        flip = !flip;
-
-        // Mix in head bump
-        inputSampleL = (inputSampleL * (1.0 - bumpGain)) + (iirHeadBumpAL[0] * bumpGain) + (iirHeadBumpBL[0] * bumpGain);
-        inputSampleR = (inputSampleR * (1.0 - bumpGain)) + (iirHeadBumpAR[0] * bumpGain) + (iirHeadBumpBR[0] * bumpGain);
-
-        // 32-bit dither
-        int expon;
-        frexpf(static_cast<float>(inputSampleL), &expon);
-        fpdL ^= fpdL << 13; fpdL ^= fpdL >> 17; fpdL ^= fpdL << 5;
-        inputSampleL += ((static_cast<double>(fpdL) - uint32_t(0x7fffffff)) * 5.5e-36l * std::pow(2, expon + 62));
-
-        frexpf(static_cast<float>(inputSampleR), &expon);
-        fpdR ^= fpdR << 13; fpdR ^= fpdR >> 17; fpdR ^= fpdR << 5;
-        inputSampleR += ((static_cast<double>(fpdR) - uint32_t(0x7fffffff)) * 5.5e-36l * std::pow(2, expon + 62));
+        double process(double x, double& s1, double& s2) const
+        {
+            const double out = (x * b0) + s1;
+            s1 = -(out * a1) + s2;
+            s2 = (x * b2) - (out * a2);
+            return out;
+        }
+    };
 
-        left = static_cast<float>(inputSampleL);
-        right = static_cast<float>(inputSampleR);
-    }
+    /** One side of the flip-flop: head bump and filter state, left and right */
+    struct Path
+    {
+        double headBump[2]{};
+        double bumpState[2][2]{};  // [s1, s2][channel]
+        double mainState[2][2]{};
+    };
 
-private:
     void updateCoefficients()
     {
-        double overallscale = sampleRate / 44100.0;
-
-        // Biquad A/B (for head bump)
-        biquadAL[0] = biquadBL[0] = biquadAR[0] = biquadBR[0] = 0.0072 / overallscale;
-        biquadAL[1] = biquadBL[1] = biquadAR[1] = biquadBR[1] = 0.0009;
-        double K = std::tan(M_PI * biquadBR[0]);
-        double norm = 1.0 / (1.0 + K / biquadBR[1] + K * K);
-        biquadAL[2] = biquadBL[2] = biquadAR[2] = biquadBR[2] = K / biquadBR[1] * norm;
-        biquadAL[4] = biquadBL[4] = biquadAR[4] = biquadBR[4] = -biquadBR[2];
-        biquadAL[5] = biquadBL[5] = biquadAR[5] = biquadBR[5] = 2.0 * (K * K - 1.0) * norm;
-        biquadAL[6] = biquadBL[6] = biquadAR[6] = biquadBR[6] = (1.0 - K / biquadBR[1] + K * K) * norm;
-
-        // Biquad C/D (for main saturation)
-        biquadCL[0] = biquadDL[0] = biquadCR[0] = biquadDR[0] = 0.032 / overallscale;
-        biquadCL[1] = biquadDL[1] = biquadCR[1] = biquadDR[1] = 0.0007;
-        K = std::tan(M_PI * biquadDR[0]);
-        norm = 1.0 / (1.0 + K / biquadDR[1] + K * K);
-        biquadCL[2] = biquadDL[2] = biquadCR[2] = biquadDR[2] = K / biquadDR[1] * norm;
-        biquadCL[4] = biquadDL[4] = biquadCR[4] = biquadDR[4] = -biquadDR[2];
-        biquadCL[5] = biquadDL[5] = biquadCR[5] = biquadDR[5] = 2.0 * (K * K - 1.0) * norm;
-        biquadCL[6] = biquadDL[6] = biquadCR[6] = biquadDR[6] = (1.0 - K / biquadDR[1] + K * K) * norm;
+        const double overallscale = sampleRate / 44100.0;
+        headBumpFreq = 0.12 / overallscale;
+        bumpFilter.setBandpass(0.0072 / overallscale, 0.0009);
+        mainFilter.setBandpass(0.032 / overallscale, 0.0007);
     }
 
     double sampleRate = 44100.0;
 
-    // IIR state (dual-path for flip-flop anti-aliasing)
-    double iirMidRollerAL[1]{}, iirMidRollerBL[1]{};
-    double iirHeadBumpAL[1]{}, iirHeadBumpBL[1]{};
-    double iirMidRollerAR[1]{}, iirMidRollerBR[1]{};
-    double iirHeadBumpAR[1]{}, iirHeadBumpBR[1]{};
-
-    // Biquad filter coefficients and state
-    double biquadAL[9]{}, biquadBL[9]{}, biquadCL[9]{}, biquadDL[9]{};
-    double biquadAR[9]{}, biquadBR[9]{}, biquadCR[9]{}, biquadDR[9]{};
+    // Derived from the parameters and the rate
+    double drive = 1.0;
+    double bumpGain = 0.0;
+    double headBumpFreq = 0.12;
+    Biquad bumpFilter, mainFilter;
 
+    // Flip-flop paths
+    Path pathA, pathB;
     bool flip = false;
-    double lastSampleL = 0.0, lastSampleR = 0.0;
 
-    // Dither state
-    uint32_t fpdL = 1, fpdR = 1;
+    // Dither state, left and right
+    uint32_t fpd[2] = {1, 1};
 
     // Parameters
     float inputGain = 0.5f;  // 0-1 (0.5 = 0dB, full range is ±24dB)
@@ -8,6 +8,13 @@
  *
  * Designed for ultimate deep space ambient music with vibrato modulation,
  * multi-stage delay networks, and Bezier curve interpolation.
+ *
+ * The setters only store the value and mark the coefficients stale; the
+ * next block (or getTailSamples()) derives them once, so the sample loop
+ * runs on plain members. The vibrato's sine / cosine pair comes from a
+ * rotating phasor, one complex multiply per sample, except in the
+ * reference build (ReferenceDsp.h), which takes the two std::sin calls
+ * of the original.
  */
 
 #pragma once
@@ -17,8 +24,15 @@
 #include <cstdint>
 #include <algorithm>
 
+#include "ReferenceDsp.h"
+#include "SilenceGate.h"
+
 /**
- * @brief Galactic3 - Deep space ambient reverb
+ * @brief Galactic3's parameters, what they derive to, and the vibrato
+ *
+ * Shared by Galactic3Reverb and Galactic3ReverbPacked
+ * (Galactic3ReverbPacked.h), which differ only in how they store and run
+ * the delay network.
  *
  * Six parameters control the effect:
  *   Replace (A): Regeneration/feedback amount (0-1)
@@ -28,6 +42,170 @@
  *   Size (E): Delay network scaling (0-1)
  *   Mix (F): Dry/wet balance (0-1)
  */
+class Galactic3Control
+{
+public:
+    // The delay lines: three stages of four (I-L, A-D, E-H), then the vibrato line M
+    enum Line { I, J, K, L, A, B, C, D, E, F, G, H, M, NUM_LINES };
+
+    // Line lengths, as Airwindows allocates them
+    static constexpr int LINE_SIZES[NUM_LINES] = {6480, 3660, 1720, 680, 9700, 6000, 2320,
+                                                  940,  15220, 8460, 4540, 3200, 3111};
+
+    /** What the sample loop reads, derived from the parameters */
+    struct Coefficients
+    {
+        double regen = 0.0, attenuate = 0.0, lowpass = 0.0, drift = 0.0, derez = 1.0, wet = 0.0;
+        int delay[NUM_LINES] = {};
+        int64_t tail = 0;
+    };
+
+    void prepare(double sr)
+    {
+        sampleRate = sr;
+        dirty = true;
+    }
+
+    void setReplace(float value) { set(replace, value); }
+    void setBrightness(float value) { set(brightness, value); }
+    void setDetune(float value) { set(detune, value); }
+    void setBigness(float value) { set(bigness, value); }
+    void setSize(float value) { set(size, value); }
+    void setMix(float value) { set(mix, value); }
+
+    /**
+     * @brief Step the network at most once every @p samples (1: as Airwindows)
+     *
+     * A sparser reverb for less CPU: the quality tiers' reverb density. It
+     * only bites where Bigness would step more often.
+     */
+    void setMinCycle(int samples)
+    {
+        minCycle = std::max(1, samples);
+        dirty = true;
+    }
+
+    /** The coefficients, derived first if a setter or prepare() has run since */
+    const Coefficients& coefficients()
+    {
+        if (dirty)
+            derive();
+        return coeffs;
+    }
+
+    /**
+     * @brief Step the vibrato one sample
+     *
+     * The phase wraps at 2 pi, when the rate is re-seeded from the dither
+     * state (@p fpd) like the original's oldfpd.
+     */
+    void advanceVibrato(uint32_t fpd)
+    {
+        vibM += vibStep;
+        if (vibM > (3.141592653589793238 * 2.0)) {
+            vibM = 0.0;
+            oldfpd = 0.4294967295 + (fpd * 0.0000000000618);
+            setVibratoStep();
+            vibSin = 0.0;
+            vibCos = 1.0;
+        } else {
+            const double s = vibSin * rotCos + vibCos * rotSin;
+            vibCos = vibCos * rotCos - vibSin * rotSin;
+            vibSin = s;
+        }
+    }
+
+    /** Read offsets into the vibrato line M, left and right a quarter turn apart */
+    void vibratoOffsets(double& left, double& right) const
+    {
+        if constexpr (ReferenceDsp::ENABLED) {
+            left = (std::sin(vibM) + 1.0) * 127;
+            right = (std::sin(vibM + (3.141592653589793238 / 2.0)) + 1.0) * 127;
+        } else {
+            left = (vibSin + 1.0) * 127;
+            right = (vibCos + 1.0) * 127;
+        }
+    }
+
+private:
+    void set(float& param, float value)
+    {
+        param = std::clamp(value, 0.0f, 1.0f);
+        dirty = true;
+    }
+
+    /** Coefficients, delay lengths and tail, as Airwindows' processReplacing() works them out */
+    void derive()
+    {
+        double overallscale = 1.0;
+        overallscale /= 44100.0;
+        overallscale *= sampleRate;
+
+        coeffs.regen = 0.0625 + ((1.0 - replace) * 0.0625);
+        coeffs.attenuate = (1.0 - (coeffs.regen / 0.125)) * 1.333;
+        coeffs.lowpass = std::pow(1.00001 - (1.0 - brightness), 2.0) / std::sqrt(overallscale);
+        coeffs.drift = std::pow(detune, 3.0) * 0.001;
+        double derez = bigness / overallscale;
+        if (derez < 0.0005) derez = 0.0005;
+        if (derez > 1.0) derez = 1.0;
+        derez = std::min(derez, 1.0 / minCycle);
+        derez = 1.0 / (static_cast<int>(1.0 / derez));
+        coeffs.derez = derez;
+        double sizeParam = (size * 1.77) + 0.1;
+        coeffs.wet = 1.0 - std::pow(1.0 - mix, 3.0);
+
+        static constexpr double LENGTHS[M] = {3407.0, 1823.0, 859.0, 331.0, 4801.0, 2909.0,
+                                              1153.0, 461.0,  7607.0, 4217.0, 2269.0, 1597.0};
+        for (int line = 0; line < M; ++line)
+            coeffs.delay[line] = static_cast<int>(LENGTHS[line] * sizeParam);
+        coeffs.delay[M] = 256;
+
+        setVibratoStep();
+
+        // Tail: see Galactic3Reverb::getTailSamples()
+        const double samplesPerCycle = 1.0 / derez + 1.0;
+        const double longestTrip = (3407.0 + 4801.0 + 7607.0) * sizeParam * samplesPerCycle;
+        const int64_t network = Silence::feedbackTail(longestTrip, 8.0 * coeffs.regen);
+        const int64_t smoothing = Silence::decayTail(1.0 - coeffs.lowpass);
+        coeffs.tail = network == Silence::INFINITE_TAIL || smoothing == Silence::INFINITE_TAIL
+                          ? Silence::INFINITE_TAIL
+                          : network + 2 * smoothing + 256 + static_cast<int64_t>(std::ceil(3.0 * samplesPerCycle));
+
+        dirty = false;
+    }
+
+    /** The vibrato's phase step, and the phasor rotation by it; changes on a setter or a wrap */
+    void setVibratoStep()
+    {
+        vibStep = oldfpd * coeffs.drift;
+        rotSin = std::sin(vibStep);
+        rotCos = std::cos(vibStep);
+    }
+
+    // Parameters (0-1)
+    float replace = 0.5f, brightness = 0.5f, detune = 0.5f, bigness = 0.5f, size = 0.5f, mix = 0.5f;
+    int minCycle = 1;
+
+    double sampleRate = 44100.0;
+
+    // Rederived when a setter or prepare() marks them dirty
+    Coefficients coeffs;
+    bool dirty = true;
+
+    // Vibrato: phase, and its sine / cosine as a phasor turned by vibStep each sample
+    double vibM = 0.0, oldfpd = 0.4294967295;
+    double vibSin = 0.0, vibCos = 1.0;
+    double vibStep = 0.0, rotSin = 0.0, rotCos = 1.0;
+};
+
+/**
+ * @brief Galactic3 - Deep space ambient reverb
+ *
+ * The exact Airwindows path: L and R separately, in double precision, about
+ * 1 MB of delay lines. The engines take it in the reference build;
+ * Galactic3ReverbPacked is the float, interleaved version of the same
+ * network. Parameters are described on Galactic3Control.
+ */
 class Galactic3Reverb
 {
 public:
@@ -76,247 +254,240 @@ public:
         countI = countJ = countK = countL = 0;
         countM = 0;
 
-        // Initialize vibrato
-        vibM = 0.0;
-        oldfpd = 0.4294967295;
-
         // Initialize random state
         fpdL = 1.0;
         fpdR = 1.0;
-
-        // Default parameters
-        replace = 0.5f;      // A
-        brightness = 0.5f;   // B
-        detune = 0.5f;       // C
-        bigness = 0.5f;      // D
-        size = 0.5f;         // E
-        mix = 0.5f;          // F
-    }
-
-    void prepare(double sr)
-    {
-        sampleRate = sr;
     }
 
-    void setReplace(float value) { replace = std::clamp(value, 0.0f, 1.0f); }
-    void setBrightness(float value) { brightness = std::clamp(value, 0.0f, 1.0f); }
-    void setDetune(float value) { detune = std::clamp(value, 0.0f, 1.0f); }
-    void setBigness(float value) { bigness = std::clamp(value, 0.0f, 1.0f); }
-    void setSize(float value) { size = std::clamp(value, 0.0f, 1.0f); }
-    void setMix(float value) { mix = std::clamp(value, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
+    void prepare(double sr) { control.prepare(sr); }
+
+    void setReplace(float value) { control.setReplace(value); }
+    void setBrightness(float value) { control.setBrightness(value); }
+    void setDetune(float value) { control.setDetune(value); }
+    void setBigness(float value) { control.setBigness(value); }
+    void setSize(float value) { control.setSize(value); }
+    void setMix(float value) { control.setMix(value); }
+    void setMinCycle(int samples) { control.setMinCycle(samples); }
+
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
+
+    /**
+     * @brief Reverberate a block in place
+     *
+     * The coefficients and delay lengths depend only on the parameters, so
+     * they're derived when a setter has run (Galactic3Control), not per
+     * sample.
+     */
+    void processBlock(float* left, float* right, int numSamples)
     {
-        double overallscale = 1.0;
-        overallscale /= 44100.0;
-        overallscale *= sampleRate;
-
-        double regen = 0.0625 + ((1.0 - replace) * 0.0625);
-        double attenuate = (1.0 - (regen / 0.125)) * 1.333;
-        double lowpass = std::pow(1.00001 - (1.0 - brightness), 2.0) / std::sqrt(overallscale);
-        double drift = std::pow(detune, 3.0) * 0.001;
-        double derez = bigness / overallscale;
-        if (derez < 0.0005) derez = 0.0005;
-        if (derez > 1.0) derez = 1.0;
-        derez = 1.0 / (static_cast<int>(1.0 / derez));
-        double sizeParam = (size * 1.77) + 0.1;
-        double wet = 1.0 - std::pow(1.0 - mix, 3.0);
-
-        delayI = static_cast<int>(3407.0 * sizeParam);
-        delayJ = static_cast<int>(1823.0 * sizeParam);
-        delayK = static_cast<int>(859.0 * sizeParam);
-        delayL = static_cast<int>(331.0 * sizeParam);
-        delayA = static_cast<int>(4801.0 * sizeParam);
-        delayB = static_cast<int>(2909.0 * sizeParam);
-        delayC = static_cast<int>(1153.0 * sizeParam);
-        delayD = static_cast<int>(461.0 * sizeParam);
-        delayE = static_cast<int>(7607.0 * sizeParam);
-        delayF = static_cast<int>(4217.0 * sizeParam);
-        delayG = static_cast<int>(2269.0 * sizeParam);
-        delayH = static_cast<int>(1597.0 * sizeParam);
-        delayM = 256;
-
-        double inputSampleL = left;
-        double inputSampleR = right;
-        if (std::fabs(inputSampleL) < 1.18e-23) inputSampleL = fpdL * 1.18e-17;
-        if (std::fabs(inputSampleR) < 1.18e-23) inputSampleR = fpdR * 1.18e-17;
-        double drySampleL = inputSampleL;
-        double drySampleR = inputSampleR;
-
-        vibM += (oldfpd * drift);
-        if (vibM > (3.141592653589793238 * 2.0)) {
-            vibM = 0.0;
-            oldfpd = 0.4294967295 + (fpdL * 0.0000000000618);
+        const auto& c = control.coefficients();
+        const double regen = c.regen;
+        const double attenuate = c.attenuate;
+        const double lowpass = c.lowpass;
+        const double derez = c.derez;
+        const double wet = c.wet;
+        const int delayI = c.delay[Galactic3Control::I], delayJ = c.delay[Galactic3Control::J];
+        const int delayK = c.delay[Galactic3Control::K], delayL = c.delay[Galactic3Control::L];
+        const int delayA = c.delay[Galactic3Control::A], delayB = c.delay[Galactic3Control::B];
+        const int delayC = c.delay[Galactic3Control::C], delayD = c.delay[Galactic3Control::D];
+        const int delayE = c.delay[Galactic3Control::E], delayF = c.delay[Galactic3Control::F];
+        const int delayG = c.delay[Galactic3Control::G], delayH = c.delay[Galactic3Control::H];
+        const int delayM = c.delay[Galactic3Control::M];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double inputSampleL = left[i];
+            double inputSampleR = right[i];
+            if (std::fabs(inputSampleL) < 1.18e-23) inputSampleL = fpdL * 1.18e-17;
+            if (std::fabs(inputSampleR) < 1.18e-23) inputSampleR = fpdR * 1.18e-17;
+            double drySampleL = inputSampleL;
+            double drySampleR = inputSampleR;
+
+            control.advanceVibrato(fpdL);
+
+            aML[countM] = inputSampleL * attenuate;
+            aMR[countM] = inputSampleR * attenuate;
+            countM++;
+            if (countM < 0 || countM > delayM) countM = 0;
+
+            double offsetML, offsetMR;
+            control.vibratoOffsets(offsetML, offsetMR);
+            int workingML = countM + static_cast<int>(offsetML);
+            int workingMR = countM + static_cast<int>(offsetMR);
+            double interpolML = (aML[workingML - ((workingML > delayM) ? delayM + 1 : 0)] * (1 - (offsetML - std::floor(offsetML))));
+            interpolML += (aML[workingML + 1 - ((workingML + 1 > delayM) ? delayM + 1 : 0)] * ((offsetML - std::floor(offsetML))));
+            double interpolMR = (aMR[workingMR - ((workingMR > delayM) ? delayM + 1 : 0)] * (1 - (offsetMR - std::floor(offsetMR))));
+            interpolMR += (aMR[workingMR + 1 - ((workingMR + 1 > delayM) ? delayM + 1 : 0)] * ((offsetMR - std::floor(offsetMR))));
+            inputSampleL = interpolML;
+            inputSampleR = interpolMR;
+
+            iirAL = (iirAL * (1.0 - lowpass)) + (inputSampleL * lowpass);
+            inputSampleL = iirAL;
+            iirAR = (iirAR * (1.0 - lowpass)) + (inputSampleR * lowpass);
+            inputSampleR = iirAR;
+
+            bez[bez_cycle] += derez;
+            bez[bez_SampL] += ((inputSampleL + bez[bez_InL]) * derez);
+            bez[bez_SampR] += ((inputSampleR + bez[bez_InR]) * derez);
+            bez[bez_InL] = inputSampleL;
+            bez[bez_InR] = inputSampleR;
+
+            if (bez[bez_cycle] > 1.0) {
+                bez[bez_cycle] = 0.0;
+
+                aIL[countI] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackAR * regen);
+                aJL[countJ] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackBR * regen);
+                aKL[countK] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackCR * regen);
+                aLL[countL] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackDR * regen);
+                bez[bez_UnInL] = bez[bez_SampL];
+
+                aIR[countI] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackAL * regen);
+                aJR[countJ] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackBL * regen);
+                aKR[countK] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackCL * regen);
+                aLR[countL] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackDL * regen);
+                bez[bez_UnInR] = bez[bez_SampR];
+
+                countI++;
+                if (countI < 0 || countI > delayI) countI = 0;
+                countJ++;
+                if (countJ < 0 || countJ > delayJ) countJ = 0;
+                countK++;
+                if (countK < 0 || countK > delayK) countK = 0;
+                countL++;
+                if (countL < 0 || countL > delayL) countL = 0;
+
+                double outIL = aIL[countI - ((countI > delayI) ? delayI + 1 : 0)];
+                double outJL = aJL[countJ - ((countJ > delayJ) ? delayJ + 1 : 0)];
+                double outKL = aKL[countK - ((countK > delayK) ? delayK + 1 : 0)];
+                double outLL = aLL[countL - ((countL > delayL) ? delayL + 1 : 0)];
+                double outIR = aIR[countI - ((countI > delayI) ? delayI + 1 : 0)];
+                double outJR = aJR[countJ - ((countJ > delayJ) ? delayJ + 1 : 0)];
+                double outKR = aKR[countK - ((countK > delayK) ? delayK + 1 : 0)];
+                double outLR = aLR[countL - ((countL > delayL) ? delayL + 1 : 0)];
+
+                aAL[countA] = (outIL - (outJL + outKL + outLL));
+                aBL[countB] = (outJL - (outIL + outKL + outLL));
+                aCL[countC] = (outKL - (outIL + outJL + outLL));
+                aDL[countD] = (outLL - (outIL + outJL + outKL));
+                aAR[countA] = (outIR - (outJR + outKR + outLR));
+                aBR[countB] = (outJR - (outIR + outKR + outLR));
+                aCR[countC] = (outKR - (outIR + outJR + outLR));
+                aDR[countD] = (outLR - (outIR + outJR + outKR));
+
+                countA++;
+                if (countA < 0 || countA > delayA) countA = 0;
+                countB++;
+                if (countB < 0 || countB > delayB) countB = 0;
+                countC++;
+                if (countC < 0 || countC > delayC) countC = 0;
+                countD++;
+                if (countD < 0 || countD > delayD) countD = 0;
+
+                double outAL = aAL[countA - ((countA > delayA) ? delayA + 1 : 0)];
+                double outBL = aBL[countB - ((countB > delayB) ? delayB + 1 : 0)];
+                double outCL = aCL[countC - ((countC > delayC) ? delayC + 1 : 0)];
+                double outDL = aDL[countD - ((countD > delayD) ? delayD + 1 : 0)];
+                double outAR = aAR[countA - ((countA > delayA) ? delayA + 1 : 0)];
+                double outBR = aBR[countB - ((countB > delayB) ? delayB + 1 : 0)];
+                double outCR = aCR[countC - ((countC > delayC) ? delayC + 1 : 0)];
+                double outDR = aDR[countD - ((countD > delayD) ? delayD + 1 : 0)];
+
+                aEL[countE] = (outAL - (outBL + outCL + outDL));
+                aFL[countF] = (outBL - (outAL + outCL + outDL));
+                aGL[countG] = (outCL - (outAL + outBL + outDL));
+                aHL[countH] = (outDL - (outAL + outBL + outCL));
+                aER[countE] = (outAR - (outBR + outCR + outDR));
+                aFR[countF] = (outBR - (outAR + outCR + outDR));
+                aGR[countG] = (outCR - (outAR + outBR + outDR));
+                aHR[countH] = (outDR - (outAR + outBR + outCR));
+
+                countE++;
+                if (countE < 0 || countE > delayE) countE = 0;
+                countF++;
+                if (countF < 0 || countF > delayF) countF = 0;
+                countG++;
+                if (countG < 0 || countG > delayG) countG = 0;
+                countH++;
+                if (countH < 0 || countH > delayH) countH = 0;
+
+                double outEL = aEL[countE - ((countE > delayE) ? delayE + 1 : 0)];
+                double outFL = aFL[countF - ((countF > delayF) ? delayF + 1 : 0)];
+                double outGL = aGL[countG - ((countG > delayG) ? delayG + 1 : 0)];
+                double outHL = aHL[countH - ((countH > delayH) ? delayH + 1 : 0)];
+                double outER = aER[countE - ((countE > delayE) ? delayE + 1 : 0)];
+                double outFR = aFR[countF - ((countF > delayF) ? delayF + 1 : 0)];
+                double outGR = aGR[countG - ((countG > delayG) ? delayG + 1 : 0)];
+                double outHR = aHR[countH - ((countH > delayH) ? delayH + 1 : 0)];
+
+                feedbackAL = (outEL - (outFL + outGL + outHL));
+                feedbackBL = (outFL - (outEL + outGL + outHL));
+                feedbackCL = (outGL - (outEL + outFL + outHL));
+                feedbackDL = (outHL - (outEL + outFL + outGL));
+                feedbackAR = (outER - (outFR + outGR + outHR));
+                feedbackBR = (outFR - (outER + outGR + outHR));
+                feedbackCR = (outGR - (outER + outFR + outHR));
+                feedbackDR = (outHR - (outER + outFR + outGR));
+
+                inputSampleL = (outEL + outFL + outGL + outHL) / 8.0;
+                inputSampleR = (outER + outFR + outGR + outHR) / 8.0;
+
+                bez[bez_CL] = bez[bez_BL];
+                bez[bez_BL] = bez[bez_AL];
+                bez[bez_AL] = inputSampleL;
+                bez[bez_SampL] = 0.0;
+
+                bez[bez_CR] = bez[bez_BR];
+                bez[bez_BR] = bez[bez_AR];
+                bez[bez_AR] = inputSampleR;
+                bez[bez_SampR] = 0.0;
+            }
+
+            double CBL = (bez[bez_CL] * (1.0 - bez[bez_cycle])) + (bez[bez_BL] * bez[bez_cycle]);
+            double CBR = (bez[bez_CR] * (1.0 - bez[bez_cycle])) + (bez[bez_BR] * bez[bez_cycle]);
+            double BAL = (bez[bez_BL] * (1.0 - bez[bez_cycle])) + (bez[bez_AL] * bez[bez_cycle]);
+            double BAR = (bez[bez_BR] * (1.0 - bez[bez_cycle])) + (bez[bez_AR] * bez[bez_cycle]);
+            double CBAL = (bez[bez_BL] + (CBL * (1.0 - bez[bez_cycle])) + (BAL * bez[bez_cycle])) * 0.125;
+            double CBAR = (bez[bez_BR] + (CBR * (1.0 - bez[bez_cycle])) + (BAR * bez[bez_cycle])) * 0.125;
+            inputSampleL = CBAL;
+            inputSampleR = CBAR;
+
+            iirBL = (iirBL * (1.0 - lowpass)) + (inputSampleL * lowpass);
+            inputSampleL = iirBL;
+            iirBR = (iirBR * (1.0 - lowpass)) + (inputSampleR * lowpass);
+            inputSampleR = iirBR;
+
+            if (wet < 1.0) {
+                inputSampleL = (inputSampleL * wet) + (drySampleL * (1.0 - wet));
+                inputSampleR = (inputSampleR * wet) + (drySampleR * (1.0 - wet));
+            }
+
+            // Simple dither
+            fpdL ^= fpdL << 13;
+            fpdL ^= fpdL >> 17;
+            fpdL ^= fpdL << 5;
+            fpdR ^= fpdR << 13;
+            fpdR ^= fpdR >> 17;
+            fpdR ^= fpdR << 5;
+
+            left[i] = static_cast<float>(inputSampleL);
+            right[i] = static_cast<float>(inputSampleR);
         }
-
-        aML[countM] = inputSampleL * attenuate;
-        aMR[countM] = inputSampleR * attenuate;
-        countM++;
-        if (countM < 0 || countM > delayM) countM = 0;
-
-        double offsetML = (std::sin(vibM) + 1.0) * 127;
-        double offsetMR = (std::sin(vibM + (3.141592653589793238 / 2.0)) + 1.0) * 127;
-        int workingML = countM + static_cast<int>(offsetML);
-        int workingMR = countM + static_cast<int>(offsetMR);
-        double interpolML = (aML[workingML - ((workingML > delayM) ? delayM + 1 : 0)] * (1 - (offsetML - std::floor(offsetML))));
-        interpolML += (aML[workingML + 1 - ((workingML + 1 > delayM) ? delayM + 1 : 0)] * ((offsetML - std::floor(offsetML))));
-        double interpolMR = (aMR[workingMR - ((workingMR > delayM) ? delayM + 1 : 0)] * (1 - (offsetMR - std::floor(offsetMR))));
-        interpolMR += (aMR[workingMR + 1 - ((workingMR + 1 > delayM) ? delayM + 1 : 0)] * ((offsetMR - std::floor(offsetMR))));
-        inputSampleL = interpolML;
-        inputSampleR = interpolMR;
-
-        iirAL = (iirAL * (1.0 - lowpass)) + (inputSampleL * lowpass);
-        inputSampleL = iirAL;
-        iirAR = (iirAR * (1.0 - lowpass)) + (inputSampleR * lowpass);
-        inputSampleR = iirAR;
-
-        bez[bez_cycle] += derez;
-        bez[bez_SampL] += ((inputSampleL + bez[bez_InL]) * derez);
-        bez[bez_SampR] += ((inputSampleR + bez[bez_InR]) * derez);
-        bez[bez_InL] = inputSampleL;
-        bez[bez_InR] = inputSampleR;
-
-        if (bez[bez_cycle] > 1.0) {
-            bez[bez_cycle] = 0.0;
-
-            aIL[countI] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackAR * regen);
-            aJL[countJ] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackBR * regen);
-            aKL[countK] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackCR * regen);
-            aLL[countL] = (bez[bez_SampL] + bez[bez_UnInL]) + (feedbackDR * regen);
-            bez[bez_UnInL] = bez[bez_SampL];
-
-            aIR[countI] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackAL * regen);
-            aJR[countJ] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackBL * regen);
-            aKR[countK] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackCL * regen);
-            aLR[countL] = (bez[bez_SampR] + bez[bez_UnInR]) + (feedbackDL * regen);
-            bez[bez_UnInR] = bez[bez_SampR];
-
-            countI++;
-            if (countI < 0 || countI > delayI) countI = 0;
-            countJ++;
-            if (countJ < 0 || countJ > delayJ) countJ = 0;
-            countK++;
-            if (countK < 0 || countK > delayK) countK = 0;
-            countL++;
-            if (countL < 0 || countL > delayL) countL = 0;
-
-            double outIL = aIL[countI - ((countI > delayI) ? delayI + 1 : 0)];
-            double outJL = aJL[countJ - ((countJ > delayJ) ? delayJ + 1 : 0)];
-            double outKL = aKL[countK - ((countK > delayK) ? delayK + 1 : 0)];
-            double outLL = aLL[countL - ((countL > delayL) ? delayL + 1 : 0)];
-            double outIR = aIR[countI - ((countI > delayI) ? delayI + 1 : 0)];
-            double outJR = aJR[countJ - ((countJ > delayJ) ? delayJ + 1 : 0)];
-            double outKR = aKR[countK - ((countK > delayK) ? delayK + 1 : 0)];
-            double outLR = aLR[countL - ((countL > delayL) ? delayL + 1 : 0)];
-
-            aAL[countA] = (outIL - (outJL + outKL + outLL));
-            aBL[countB] = (outJL - (outIL + outKL + outLL));
-            aCL[countC] = (outKL - (outIL + outJL + outLL));
-            aDL[countD] = (outLL - (outIL + outJL + outKL));
-            aAR[countA] = (outIR - (outJR + outKR + outLR));
-            aBR[countB] = (outJR - (outIR + outKR + outLR));
-            aCR[countC] = (outKR - (outIR + outJR + outLR));
-            aDR[countD] = (outLR - (outIR + outJR + outKR));
-
-            countA++;
-            if (countA < 0 || countA > delayA) countA = 0;
-            countB++;
-            if (countB < 0 || countB > delayB) countB = 0;
-            countC++;
-            if (countC < 0 || countC > delayC) countC = 0;
-            countD++;
-            if (countD < 0 || countD > delayD) countD = 0;
-
-            double outAL = aAL[countA - ((countA > delayA) ? delayA + 1 : 0)];
-            double outBL = aBL[countB - ((countB > delayB) ? delayB + 1 : 0)];
-            double outCL = aCL[countC - ((countC > delayC) ? delayC + 1 : 0)];
-            double outDL = aDL[countD - ((countD > delayD) ? delayD + 1 : 0)];
-            double outAR = aAR[countA - ((countA > delayA) ? delayA + 1 : 0)];
-            double outBR = aBR[countB - ((countB > delayB) ? delayB + 1 : 0)];
-            double outCR = aCR[countC - ((countC > delayC) ? delayC + 1 : 0)];
-            double outDR = aDR[countD - ((countD > delayD) ? delayD + 1 : 0)];
-
-            aEL[countE] = (outAL - (outBL + outCL + outDL));
-            aFL[countF] = (outBL - (outAL + outCL + outDL));
-            aGL[countG] = (outCL - (outAL + outBL + outDL));
-            aHL[countH] = (outDL - (outAL + outBL + outCL));
-            aER[countE] = (outAR - (outBR + outCR + outDR));
-            aFR[countF] = (outBR - (outAR + outCR + outDR));
-            aGR[countG] = (outCR - (outAR + outBR + outDR));
-            aHR[countH] = (outDR - (outAR + outBR + outCR));
-
-            countE++;
-            if (countE < 0 || countE > delayE) countE = 0;
-            countF++;
-            if (countF < 0 || countF > delayF) countF = 0;
-            countG++;
-            if (countG < 0 || countG > delayG) countG = 0;
-            countH++;
-            if (countH < 0 || countH > delayH) countH = 0;
-
-            double outEL = aEL[countE - ((countE > delayE) ? delayE + 1 : 0)];
-            double outFL = aFL[countF - ((countF > delayF) ? delayF + 1 : 0)];
-            double outGL = aGL[countG - ((countG > delayG) ? delayG + 1 : 0)];
-            double outHL = aHL[countH - ((countH > delayH) ? delayH + 1 : 0)];
-            double outER = aER[countE - ((countE > delayE) ? delayE + 1 : 0)];
-            double outFR = aFR[countF - ((countF > delayF) ? delayF + 1 : 0)];
-            double outGR = aGR[countG - ((countG > delayG) ? delayG + 1 : 0)];
-            double outHR = aHR[countH - ((countH > delayH) ? delayH + 1 : 0)];
-
-            feedbackAL = (outEL - (outFL + outGL + outHL));
-            feedbackBL = (outFL - (outEL + outGL + outHL));
-            feedbackCL = (outGL - (outEL + outFL + outHL));
-            feedbackDL = (outHL - (outEL + outFL + outGL));
-            feedbackAR = (outER - (outFR + outGR + outHR));
-            feedbackBR = (outFR - (outER + outGR + outHR));
-            feedbackCR = (outGR - (outER + outFR + outHR));
-            feedbackDR = (outHR - (outER + outFR + outGR));
-
-            inputSampleL = (outEL + outFL + outGL + outHL) / 8.0;
-            inputSampleR = (outER + outFR + outGR + outHR) / 8.0;
-
-            bez[bez_CL] = bez[bez_BL];
-            bez[bez_BL] = bez[bez_AL];
-            bez[bez_AL] = inputSampleL;
-            bez[bez_SampL] = 0.0;
-
-            bez[bez_CR] = bez[bez_BR];
-            bez[bez_BR] = bez[bez_AR];
-            bez[bez_AR] = inputSampleR;
-            bez[bez_SampR] = 0.0;
-        }
-
-        double CBL = (bez[bez_CL] * (1.0 - bez[bez_cycle])) + (bez[bez_BL] * bez[bez_cycle]);
-        double CBR = (bez[bez_CR] * (1.0 - bez[bez_cycle])) + (bez[bez_BR] * bez[bez_cycle]);
-        double BAL = (bez[bez_BL] * (1.0 - bez[bez_cycle])) + (bez[bez_AL] * bez[bez_cycle]);
-        double BAR = (bez[bez_BR] * (1.0 - bez[bez_cycle])) + (bez[bez_AR] * bez[bez_cycle]);
-        double CBAL = (bez[bez_BL] + (CBL * (1.0 - bez[bez_cycle])) + (BAL * bez[bez_cycle])) * 0.125;
-        double CBAR = (bez[bez_BR] + (CBR * (1.0 - bez[bez_cycle])) + (BAR * bez[bez_cycle])) * 0.125;
-        inputSampleL = CBAL;
-        inputSampleR = CBAR;
-
-        iirBL = (iirBL * (1.0 - lowpass)) + (inputSampleL * lowpass);
-        inputSampleL = iirBL;
-        iirBR = (iirBR * (1.0 - lowpass)) + (inputSampleR * lowpass);
-        inputSampleR = iirBR;
-
-        if (wet < 1.0) {
-            inputSampleL = (inputSampleL * wet) + (drySampleL * (1.0 - wet));
-            inputSampleR = (inputSampleR * wet) + (drySampleR * (1.0 - wet));
-        }
-
-        // Simple dither
-        fpdL ^= fpdL << 13;
-        fpdL ^= fpdL >> 17;
-        fpdL ^= fpdL << 5;
-        fpdR ^= fpdR << 13;
-        fpdR ^= fpdR >> 17;
-        fpdR ^= fpdR << 5;
-
-        left = static_cast<float>(inputSampleL);
-        right = static_cast<float>(inputSampleR);
     }
 
+    /**
+     * @brief Samples until the tail falls below -120 dB (see SilenceGate.h)
+     *
+     * The network steps once per undersampling cycle (1 / derez + 1
+     * samples). Measured over the parameter range, a trip round its longest
+     * path (I -> A -> E) loses the tail at least as fast as a gain of
+     * 8 * regen per trip: about 0.65 against 0.75 at the default Replace,
+     * reaching 1 (never dies) at Replace 0. The two lowpasses, the vibrato
+     * line and the Bezier output stage add their own run-out.
+     *
+     * Derived with the coefficients, so it costs nothing unless a setter ran.
+     */
+    int64_t getTailSamples() { return control.coefficients().tail; }
+
 private:
     // Bezier interpolation indices
     enum {
@@ -330,11 +501,7 @@ private:
         bez_total
     };
 
-    // Parameters (0-1)
-    float replace, brightness, detune, bigness, size, mix;
-
-    // Sample rate
-    double sampleRate = 44100.0;
+    Galactic3Control control;
 
     // Filters
     double iirAL, iirBL, iirAR, iirBR;
@@ -355,14 +522,11 @@ private:
     double feedbackAL, feedbackBL, feedbackCL, feedbackDL;
     double feedbackAR, feedbackBR, feedbackCR, feedbackDR;
 
-    // Counters and delays
-    int countA, delayA, countB, delayB, countC, delayC, countD, delayD;
-    int countE, delayE, countF, delayF, countG, delayG, countH, delayH;
-    int countI, delayI, countJ, delayJ, countK, delayK, countL, delayL;
-    int countM, delayM;
-
-    // Vibrato
-    double vibM, oldfpd;
+    // Counters
+    int countA, countB, countC, countD;
+    int countE, countF, countG, countH;
+    int countI, countJ, countK, countL;
+    int countM;
 
     // Bezier reconstruction
     double bez[bez_total];
@@ -0,0 +1,273 @@
+/**
+ * @file Galactic3ReverbPacked.h
+ * @brief Galactic3 with float delay lines, left and right interleaved
+ *
+ * The same network as Galactic3Reverb (same parameters, coefficients,
+ * delay lengths and vibrato, from Galactic3Control), stored and run for
+ * throughput instead of bit-exactness with Airwindows:
+ *
+ *   - Every delay line holds float L/R pairs in one array, 528 KB against
+ *     the exact reverb's 1 MB of separate double lines, so a tap is one
+ *     8-byte load for both channels and half the cache traffic. The
+ *     array is the reverb's own (prepare(sr)) or an Arena's (prepare(sr,
+ *     arena), memoryNeeded() floats), so it can come and go with the
+ *     effect (LazyEffect.h).
+ *   - Each of the three stages is one 4-line matrix step over the eight
+ *     values of its four taps (out - (sum - out) per line and channel),
+ *     written as plain loops over the interleaved pairs so the compiler
+ *     vectorizes them on any target, WASM SIMD included.
+ *
+ * The lowpasses run as iir += (x - iir) * lowpass, which holds up in
+ * float at the small coefficients of a dark setting. The undersampling
+ * cycle and the vibrato stay in double, so the network steps on exactly
+ * the samples the exact reverb does. The output is within float rounding
+ * of Galactic3Reverb's (see the TapeLoop tests).
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Arena.h"
+#include "Galactic3Reverb.h"
+#include "MemoryReport.h"
+
+/**
+ * @brief Galactic3, float and interleaved
+ *
+ * Drop-in for Galactic3Reverb: same setters, processBlock() and tail.
+ */
+class Galactic3ReverbPacked
+{
+public:
+    Galactic3ReverbPacked()
+    {
+        std::memset(count, 0, sizeof(count));
+        std::memset(feedback, 0, sizeof(feedback));
+    }
+
+    /** Floats prepare(sr, arena) takes: every line's pairs, at any rate */
+    static constexpr size_t memoryNeeded(double) { return Arena::aligned(2 * static_cast<size_t>(OFFSETS[NUM_LINES])); }
+
+    /** Lines from the reverb's own storage, allocated once */
+    void prepare(double sr)
+    {
+        if (storage.empty())
+            storage.assign(static_cast<size_t>(OFFSETS[NUM_LINES]), Pair{0.0f, 0.0f});
+        lines = storage.data();
+        control.prepare(sr);
+    }
+
+    /** Lines from @p arena, which start empty, as does the network; false if it's short */
+    bool prepare(double sr, Arena& arena)
+    {
+        float* const memory = arena.take(memoryNeeded(sr));
+        if (!memory)
+            return false;
+        lines = reinterpret_cast<Pair*>(memory);
+        clear();
+        control.prepare(sr);
+        return true;
+    }
+
+    void setReplace(float value) { control.setReplace(value); }
+    void setBrightness(float value) { control.setBrightness(value); }
+    void setDetune(float value) { control.setDetune(value); }
+    void setBigness(float value) { control.setBigness(value); }
+    void setSize(float value) { control.setSize(value); }
+    void setMix(float value) { control.setMix(value); }
+    void setMinCycle(int samples) { control.setMinCycle(samples); }
+
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
+
+    /** Reverberate a block in place */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        const auto& c = control.coefficients();
+        const float regen = static_cast<float>(c.regen);
+        const float attenuate = static_cast<float>(c.attenuate);
+        const float lowpass = static_cast<float>(c.lowpass);
+        const double derez = c.derez;
+        const float wet = static_cast<float>(c.wet);
+        const int delayM = c.delay[Galactic3Control::M];
+        Pair* const lineM = line(Galactic3Control::M);
+        int& countM = count[Galactic3Control::M];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float inL = left[i];
+            float inR = right[i];
+            if (std::fabs(inL) < 1.18e-23f) inL = static_cast<float>(fpdL * 1.18e-17);
+            if (std::fabs(inR) < 1.18e-23f) inR = static_cast<float>(fpdR * 1.18e-17);
+            const Pair dry = {inL, inR};
+
+            control.advanceVibrato(fpdL);
+
+            // Vibrato line: both channels written together, each read at its own offset
+            lineM[countM] = dry * attenuate;
+            countM++;
+            if (countM > delayM) countM = 0;
+
+            double offsetML, offsetMR;
+            control.vibratoOffsets(offsetML, offsetMR);
+            const Pair sample = {tap(lineM, countM, delayM, offsetML).l, tap(lineM, countM, delayM, offsetMR).r};
+
+            iirA = iirA + (sample - iirA) * lowpass;
+
+            bezCycle += derez;
+            bezSamp = bezSamp + (iirA + bezIn) * static_cast<float>(derez);
+            bezIn = iirA;
+
+            if (bezCycle > 1.0) {
+                bezCycle = 0.0;
+                network(c, regen);
+            }
+
+            const float cycle = static_cast<float>(bezCycle);
+            const float hold = 1.0f - cycle;
+            const Pair cb = bezC * hold + bezB * cycle;
+            const Pair ba = bezB * hold + bezA * cycle;
+            Pair out = (bezB + cb * hold + ba * cycle) * 0.125f;
+
+            iirB = iirB + (out - iirB) * lowpass;
+            out = iirB;
+
+            if (wet < 1.0f)
+                out = out * wet + dry * (1.0f - wet);
+
+            fpdL ^= fpdL << 13;
+            fpdL ^= fpdL >> 17;
+            fpdL ^= fpdL << 5;
+            fpdR ^= fpdR << 13;
+            fpdR ^= fpdR >> 17;
+            fpdR ^= fpdR << 5;
+
+            left[i] = out.l;
+            right[i] = out.r;
+        }
+    }
+
+    /** As Galactic3Reverb::getTailSamples() */
+    int64_t getTailSamples() { return control.coefficients().tail; }
+
+    /** Bytes of line allocated by prepare(sr); none from an arena */
+    size_t getHeapBytes() const { return MemoryReport::bytesOf(storage); }
+
+private:
+    struct alignas(8) Pair
+    {
+        float l, r;
+
+        Pair operator+(Pair o) const { return {l + o.l, r + o.r}; }
+        Pair operator-(Pair o) const { return {l - o.l, r - o.r}; }
+        Pair operator*(float g) const { return {l * g, r * g}; }
+        Pair swapped() const { return {r, l}; }
+    };
+
+    static constexpr int NUM_LINES = Galactic3Control::NUM_LINES;
+
+    // Where each line starts in lines[]
+    static constexpr std::array<int, NUM_LINES + 1> OFFSETS = [] {
+        std::array<int, NUM_LINES + 1> offsets{};
+        for (int n = 0; n < NUM_LINES; ++n)
+            offsets[n + 1] = offsets[n] + Galactic3Control::LINE_SIZES[n];
+        return offsets;
+    }();
+
+    Pair* line(int n) { return lines + OFFSETS[n]; }
+
+    /** The network's state back to the constructor's (fresh lines) */
+    void clear()
+    {
+        std::memset(count, 0, sizeof(count));
+        std::memset(feedback, 0, sizeof(feedback));
+        iirA = iirB = {0.0f, 0.0f};
+        bezCycle = 0.0;
+        bezA = bezB = bezC = bezIn = bezUnIn = bezSamp = {0.0f, 0.0f};
+    }
+
+    /** Both channels of line M, @p offset samples on from @p countM (one of them is wanted) */
+    static Pair tap(const Pair* lineM, int countM, int delayM, double offset)
+    {
+        // offset >= 0, so truncating is floor
+        const int whole = static_cast<int>(offset);
+        const int working = countM + whole;
+        const float frac = static_cast<float>(offset - whole);
+        const Pair& a = lineM[working - ((working > delayM) ? delayM + 1 : 0)];
+        const Pair& b = lineM[working + 1 - ((working + 1 > delayM) ? delayM + 1 : 0)];
+        return {a.l + (b.l - a.l) * frac, a.r + (b.r - a.r) * frac};
+    }
+
+    /**
+     * @brief One 4-line stage: write @p in to lines FIRST..FIRST + 3, read their taps and mix
+     *
+     * Each output is its own tap minus the other three, both channels at
+     * once.
+     *
+     * @return The sum of the four taps
+     */
+    template <int FIRST>
+    Pair stage(const Galactic3Control::Coefficients& c, const Pair (&in)[4], Pair (&out)[4])
+    {
+        const auto write = [&](int k) {
+            const int n = FIRST + k;
+            Pair* const buffer = lines + OFFSETS[n];
+            buffer[count[n]] = in[k];
+            count[n]++;
+            if (count[n] > c.delay[n]) count[n] = 0;
+            return buffer[count[n]];
+        };
+        const Pair t0 = write(0), t1 = write(1), t2 = write(2), t3 = write(3);
+
+        const Pair sum = (t0 + t1) + (t2 + t3);
+        out[0] = t0 - (sum - t0);
+        out[1] = t1 - (sum - t1);
+        out[2] = t2 - (sum - t2);
+        out[3] = t3 - (sum - t3);
+        return sum;
+    }
+
+    /** One step of the network, once per undersampling cycle */
+    void network(const Galactic3Control::Coefficients& c, float regen)
+    {
+        // Each channel's stage-one input takes the other channel's feedback
+        const Pair input = bezSamp + bezUnIn;
+        Pair x[4], y[4];
+        for (int k = 0; k < 4; ++k)
+            x[k] = input + feedback[k].swapped() * regen;
+        bezUnIn = bezSamp;
+
+        stage<Galactic3Control::I>(c, x, y);
+        stage<Galactic3Control::A>(c, y, x);
+        // Stage three's mix is the feedback, its taps' sum the output
+        const Pair sum = stage<Galactic3Control::E>(c, x, feedback);
+
+        bezC = bezB;
+        bezB = bezA;
+        bezA = sum * 0.125f;
+        bezSamp = {0.0f, 0.0f};
+    }
+
+    Galactic3Control control;
+
+    // Every line's L/R pairs, back to back (OFFSETS), in storage or an arena
+    Pair* lines = nullptr;
+    std::vector<Pair> storage;
+    int count[NUM_LINES];
+
+    // Stage three's mix, per line (A-D)
+    Pair feedback[4];
+
+    Pair iirA = {0.0f, 0.0f}, iirB = {0.0f, 0.0f};
+
+    // Bezier reconstruction
+    double bezCycle = 0.0;
+    Pair bezA = {0.0f, 0.0f}, bezB = {0.0f, 0.0f}, bezC = {0.0f, 0.0f};
+    Pair bezIn = {0.0f, 0.0f}, bezUnIn = {0.0f, 0.0f}, bezSamp = {0.0f, 0.0f};
+
+    uint32_t fpdL = 1, fpdR = 1;
+};
@@ -0,0 +1,136 @@
+/**
+ * @file SynthParams.h
+ * @brief TapeLoop parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * TapeLoopEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+#define SYNTH_PARAMS(X) \
+    X(Osc1Waveform,     "osc1_waveform") \
+    X(Osc1Tune,         "osc1_tune") \
+    X(Osc1Level,        "osc1_level") \
+    X(Osc2Waveform,     "osc2_waveform") \
+    X(Osc2Tune,         "osc2_tune") \
+    X(Osc2Detune,       "osc2_detune") \
+    X(Osc2Level,        "osc2_level") \
+    X(LoopLength,       "loop_length") \
+    X(LoopFeedback,     "loop_feedback") \
+    X(RecordLevel,      "record_level") \
+    X(TapeSaturation,   "tape_saturation") \
+    X(TapeWobbleRate,   "tape_wobble_rate") \
+    X(TapeWobbleDepth,  "tape_wobble_depth") \
+    X(TapeHiss,         "tape_hiss") \
+    X(TapeAge,          "tape_age") \
+    X(TapeDegrade,      "tape_degrade") \
+    X(TapeModel,        "tape_model") \
+    X(TapeDrive,        "tape_drive") \
+    X(TapeBump,         "tape_bump") \
+    X(TapeOversampling, "tape_oversampling") \
+    X(TapeInterpolation, "tape_interpolation") \
+    X(TapeWearOnRecord, "tape_wear_on_record") \
+    X(TapeSpeed,        "tape_speed") \
+    X(TapeReverse,      "tape_reverse") \
+    X(RecAttack,        "rec_attack") \
+    X(RecDecay,         "rec_decay") \
+    X(FmAmount,         "fm_amount") \
+    X(LfoRate,          "lfo_rate") \
+    X(LfoDepth,         "lfo_depth") \
+    X(LfoWaveform,      "lfo_waveform") \
+    X(LfoTarget,        "lfo_target") \
+    X(DryLevel,         "dry_level") \
+    X(LoopLevel,        "loop_level") \
+    X(MasterLevel,      "master_level") \
+    X(DelayTime,        "delay_time") \
+    X(DelayFeedback,    "delay_feedback") \
+    X(DelayMix,         "delay_mix") \
+    X(ReverbReplace,    "reverb_replace") \
+    X(ReverbBrightness, "reverb_brightness") \
+    X(ReverbDetune,     "reverb_detune") \
+    X(ReverbBigness,    "reverb_bigness") \
+    X(ReverbSize,       "reverb_size") \
+    X(ReverbMix,        "reverb_mix") \
+    X(ConvMix,          "conv_mix") \
+    X(CompThreshold,    "comp_threshold") \
+    X(CompRatio,        "comp_ratio") \
+    X(CompMix,          "comp_mix") \
+    X(CompLookahead,    "comp_lookahead") \
+    X(SeqEnabled,       "seq_enabled") \
+    X(SeqBPM,           "seq_bpm") \
+    X(Seq1Division,     "seq1_division") \
+    X(Seq1Pitch1,       "seq1_pitch1") \
+    X(Seq1Pitch2,       "seq1_pitch2") \
+    X(Seq1Pitch3,       "seq1_pitch3") \
+    X(Seq1Pitch4,       "seq1_pitch4") \
+    X(Seq1Gate1,        "seq1_gate1") \
+    X(Seq1Gate2,        "seq1_gate2") \
+    X(Seq1Gate3,        "seq1_gate3") \
+    X(Seq1Gate4,        "seq1_gate4") \
+    X(Seq2Division,     "seq2_division") \
+    X(Seq2Pitch1,       "seq2_pitch1") \
+    X(Seq2Pitch2,       "seq2_pitch2") \
+    X(Seq2Pitch3,       "seq2_pitch3") \
+    X(Seq2Pitch4,       "seq2_pitch4") \
+    X(Seq2Gate1,        "seq2_gate1") \
+    X(Seq2Gate2,        "seq2_gate2") \
+    X(Seq2Gate3,        "seq2_gate3") \
+    X(Seq2Gate4,        "seq2_gate4") \
+    X(VoiceLoopFM,      "voice_loop_fm") \
+    X(Osc1Attack,       "osc1_attack") \
+    X(Osc1Decay,        "osc1_decay") \
+    X(Osc1Sustain,      "osc1_sustain") \
+    X(Osc1Release,      "osc1_release") \
+    X(Osc2Attack,       "osc2_attack") \
+    X(Osc2Decay,        "osc2_decay") \
+    X(Osc2Sustain,      "osc2_sustain") \
+    X(Osc2Release,      "osc2_release") \
+    X(PanSpeed,         "pan_speed") \
+    X(PanDepth,         "pan_depth") \
+    X(Head1Level,       "head1_level") \
+    X(Head1Offset,      "head1_offset") \
+    X(Head1Speed,       "head1_speed") \
+    X(Head1Pan,         "head1_pan") \
+    X(Head2Level,       "head2_level") \
+    X(Head2Offset,      "head2_offset") \
+    X(Head2Speed,       "head2_speed") \
+    X(Head2Pan,         "head2_pan") \
+    X(Head3Level,       "head3_level") \
+    X(Head3Offset,      "head3_offset") \
+    X(Head3Speed,       "head3_speed") \
+    X(Head3Pan,         "head3_pan") \
+    X(GrainLevel,       "grain_level") \
+    X(GrainDensity,     "grain_density") \
+    X(GrainSize,        "grain_size") \
+    X(GrainPosition,    "grain_position") \
+    X(GrainSpray,       "grain_spray") \
+    X(GrainPitch,       "grain_pitch") \
+    X(GrainPitchSpread, "grain_pitch_spread") \
+    X(GrainPanSpread,   "grain_pan_spread") \
+    X(RenderRate,       "render_rate")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
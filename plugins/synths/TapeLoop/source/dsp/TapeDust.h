@@ -11,13 +11,19 @@
  * "tape dust" that's more prominent during quiet or static passages.
  *
  * Algorithm:
- * - Tracks recent signal history (10 samples)
+ * - Tracks recent signal history (9 samples)
  * - Generates random noise scaled by user parameter
  * - Multiplies noise by slew rate: (1.0 - |current - previous|) * fuzz
  * - Blends multiple past samples with fractional gains for smoothing
  *
  * This creates noise that sounds like dust particles on magnetic tape,
  * particularly noticeable during quiet passages and tape stops.
+ *
+ * Range's noise scaling is worked out when it is set. Blocks run in chunks
+ * that draw their noise in one NoiseSource block fill, read the history
+ * from one line instead of shifting it every sample, and weight the taps
+ * with min / max rather than branches. At zero mix a block passes
+ * through untouched.
  */
 
 #pragma once
@@ -26,7 +32,8 @@
 #include <cstring>
 #include <cstdint>
 #include <algorithm>
-#include <random>
+
+#include "Noise.h"
 
 /**
  * @brief Slew-dependent tape noise generator
@@ -51,122 +58,162 @@ public:
 
     void reset()
     {
-        std::memset(bL, 0, sizeof(bL));
-        std::memset(bR, 0, sizeof(bR));
-        std::memset(fL, 0, sizeof(fL));
-        std::memset(fR, 0, sizeof(fR));
+        std::memset(history, 0, sizeof(history));
         fpFlip = false;
         fpdL = 1;
         fpdR = 1;
     }
 
-    void setRange(float r) { range = std::clamp(r, 0.0f, 1.0f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
+    void setRange(float r)
     {
-        double inputSampleL = left;
-        double inputSampleR = right;
+        range = std::clamp(r, 0.0f, 1.0f);
+        rRange = static_cast<double>(range) * range * 5.0;
+        xfuzz = rRange * 0.002;
+        rOffset = (rRange * 0.4) + 1.0;
+    }
 
-        // Denormal protection
-        if (std::fabs(inputSampleL) < 1.18e-23) inputSampleL = fpdL * 1.18e-17;
-        if (std::fabs(inputSampleR) < 1.18e-23) inputSampleR = fpdR * 1.18e-17;
+    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
 
-        double drySampleL = inputSampleL;
-        double drySampleR = inputSampleR;
+    /** Restart the dust sequence (reproducible renders, see Noise.h) */
+    void setNoiseSeed(uint32_t seed) { noise.reseed(seed); }
 
-        // Compute slew-dependent noise parameters
-        double rRange = std::pow(range, 2.0) * 5.0;
-        double xfuzz = rRange * 0.002;
-        double rOffset = (rRange * 0.4) + 1.0;
+    void process(float& left, float& right) { processBlock(&left, &right, 1); }
 
-        // Shift buffer (store signal history)
-        for (int count = 9; count > 0; count--) {
-            bL[count] = bL[count-1];
-            bR[count] = bR[count-1];
+    /**
+     * @brief Add dust to a block in place
+     *
+     * At zero mix the block passes untouched; only the history and the
+     * phase flip move on, so the dust picks up cleanly when it comes back.
+     */
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        if (mix <= 0.0f)
+        {
+            bypass(left, right, numSamples);
+            return;
         }
 
-        bL[0] = inputSampleL;
-        bR[0] = inputSampleR;
-
-        // Generate base random noise
-        inputSampleL = static_cast<double>(std::rand()) / RAND_MAX;
-        inputSampleR = static_cast<double>(std::rand()) / RAND_MAX;
-
-        double rDepthL = (inputSampleL * rRange) + rOffset;
-        double rDepthR = (inputSampleR * rRange) + rOffset;
-        double gainL = rDepthL;
-        double gainR = rDepthR;
-
-        // Modulate noise by slew rate (key to tape dust character!)
-        // Fast changes = less noise, slow/static = more dust
-        inputSampleL *= ((1.0 - std::fabs(bL[0] - bL[1])) * xfuzz);
-        inputSampleR *= ((1.0 - std::fabs(bR[0] - bR[1])) * xfuzz);
+        for (int start = 0; start < numSamples; start += CHUNK)
+            processChunk(left + start, right + start, std::min(CHUNK, numSamples - start));
+    }
 
-        // Flip phase every other sample for spectral shaping
-        if (fpFlip) {
-            inputSampleL = -inputSampleL;
-            inputSampleR = -inputSampleR;
-        }
-        fpFlip = !fpFlip;
-
-        // Fractional delay blend: spread noise across recent samples
-        // with decreasing weights for smoothing
-        for (int count = 0; count < 9; count++) {
-            if (gainL > 1.0) {
-                fL[count] = 1.0;
-                gainL -= 1.0;
-            } else {
-                fL[count] = gainL;
-                gainL = 0.0;
+private:
+    static constexpr int CHUNK = 64;
+
+    // Samples of history each output blends (the depth never reaches 9)
+    static constexpr int TAPS = 9;
+
+    /**
+     * @brief Dust one chunk
+     *
+     * The chunk's input follows the last TAPS - 1 samples of history in one
+     * line, so tap k of sample i is just line[i + TAPS - 1 - k], with no
+     * per-sample shifting. Left and right sit side by side in it and run as
+     * two lanes. The noise for the chunk comes from one block fill, L and R
+     * interleaved as the per-sample calls would draw it.
+     */
+    void processChunk(float* left, float* right, int n)
+    {
+        double line[TAPS - 1 + CHUNK][2];
+        std::memcpy(line, history, sizeof(history));
+
+        float dust[2 * CHUNK];
+        noise.fillPM1(dust, 2 * n);
+
+        const double wet = mix;
+        const double dry = 1.0 - wet;
+        const bool mixed = mix < 1.0f;
+
+        // Run state in locals: the float stores would otherwise reload them
+        bool phase = fpFlip;
+        uint32_t ditherL = fpdL, ditherR = fpdR;
+
+        for (int i = 0; i < n; ++i)
+        {
+            double* const b = line[i + TAPS - 1];  // b[-2 k + c] is channel c, k samples back
+
+            // Denormal protection
+            b[0] = left[i];
+            b[1] = right[i];
+            if (std::fabs(b[0]) < 1.18e-23) b[0] = ditherL * 1.18e-17;
+            if (std::fabs(b[1]) < 1.18e-23) b[1] = ditherR * 1.18e-17;
+
+            // Flip phase every other sample for spectral shaping
+            const double flip = phase ? -1.0 : 1.0;
+            phase = !phase;
+
+            // Base random noise, as unif01(), and the depth it sets
+            double dustSample[2], rDepth[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                dustSample[c] = 0.5 * dust[2 * i + c] + 0.5;
+                rDepth[c] = (dustSample[c] * rRange) + rOffset;
             }
 
-            if (gainR > 1.0) {
-                fR[count] = 1.0;
-                gainR -= 1.0;
-            } else {
-                fR[count] = gainR;
-                gainR = 0.0;
+            // Fractional delay blend: spread the depth over recent samples,
+            // a whole sample's weight each until the fraction that's left
+            double blend[2] = {0.0, 0.0};
+            for (int k = 0; k < TAPS; ++k)
+                for (int c = 0; c < 2; ++c)
+                    blend[c] += b[c - 2 * k] * std::max(std::min(rDepth[c] - k, 1.0), 0.0);
+
+            double out[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                // Modulate noise by slew rate (key to tape dust character!)
+                // Fast changes = less noise, slow/static = more dust
+                const double slewed = dustSample[c] * ((1.0 - std::fabs(b[c] - b[c - 2])) * xfuzz) * flip;
+                out[c] = slewed + blend[c] / rDepth[c];
+
+                // Wet/dry mix
+                if (mixed)
+                    out[c] = (out[c] * wet) + (b[c] * dry);
             }
 
-            fL[count] /= rDepthL;
-            fR[count] /= rDepthR;
-            inputSampleL += (bL[count] * fL[count]);
-            inputSampleR += (bR[count] * fR[count]);
-        }
+            // Simple PRNG dither (Airwindows style)
+            ditherL ^= ditherL << 13;
+            ditherL ^= ditherL >> 17;
+            ditherL ^= ditherL << 5;
+            ditherR ^= ditherR << 13;
+            ditherR ^= ditherR >> 17;
+            ditherR ^= ditherR << 5;
 
-        // Wet/dry mix
-        if (mix < 1.0) {
-            inputSampleL = (inputSampleL * mix) + (drySampleL * (1.0 - mix));
-            inputSampleR = (inputSampleR * mix) + (drySampleR * (1.0 - mix));
+            left[i] = static_cast<float>(out[0]);
+            right[i] = static_cast<float>(out[1]);
         }
 
-        // Simple PRNG dither (Airwindows style)
-        fpdL ^= fpdL << 13;
-        fpdL ^= fpdL >> 17;
-        fpdL ^= fpdL << 5;
-        fpdR ^= fpdR << 13;
-        fpdR ^= fpdR >> 17;
-        fpdR ^= fpdR << 5;
-
-        left = static_cast<float>(inputSampleL);
-        right = static_cast<float>(inputSampleR);
+        fpFlip = phase;
+        fpdL = ditherL;
+        fpdR = ditherR;
+        std::memcpy(history, line[n], sizeof(history));
     }
 
-private:
-    // Signal buffers (10 samples of history)
-    double bL[11]{};
-    double bR[11]{};
+    /** Zero mix: leave the audio be, keep the history and phase current */
+    void bypass(const float* left, const float* right, int numSamples)
+    {
+        const int keep = std::min(numSamples, TAPS - 1);
+        std::memmove(history, history[keep], sizeof(history[0]) * static_cast<size_t>(TAPS - 1 - keep));
+        for (int i = 0; i < keep; ++i)
+        {
+            history[TAPS - 1 - keep + i][0] = left[numSamples - keep + i];
+            history[TAPS - 1 - keep + i][1] = right[numSamples - keep + i];
+        }
+        if (numSamples % 2 != 0)
+            fpFlip = !fpFlip;
+    }
 
-    // Fractional gains for smooth blending
-    double fL[11]{};
-    double fR[11]{};
+    // The last TAPS - 1 input samples, oldest first, L and R
+    double history[TAPS - 1][2]{};
 
-    // Parameters
+    // Parameters, and the noise scaling range sets
     float range = 0.3f;  // 0-1, amount of tape dust
     float mix = 0.5f;    // 0-1, dry/wet
+    double rRange = 0.45;
+    double xfuzz = 0.45 * 0.002;
+    double rOffset = (0.45 * 0.4) + 1.0;
 
     // State
+    NoiseSource noise;   // The dust itself (was std::rand(): shared, locked, unseedable)
     bool fpFlip = false;
     uint32_t fpdL = 1;   // PRNG state
     uint32_t fpdR = 1;
@@ -0,0 +1,305 @@
+/**
+ * @file TapeGrains.h
+ * @brief Granular cloud read of the tape loop
+ *
+ * A cloud of short windowed grains, each reading the tape from its own
+ * place at its own pitch and pan, mixed into the playback next to the
+ * play heads. Grains start density times a second on average (each gap
+ * drawn between half and one and a half of the mean), at the exact sample
+ * the gap ends on, whatever the span boundaries; each one lasts the grain
+ * size and is shaped by a Hann window from one table every grain shares.
+ *
+ * Where a grain starts is the position (a fraction of the loop behind the
+ * record head, like a play head's offset) plus up to half the spray either
+ * way; its pitch is the pitch plus up to the pitch spread either way, and
+ * its pan up to the pan spread either way. Each grain's gain is scaled by
+ * 1 / sqrt(grains overlapping), so thickening the cloud keeps its level.
+ *
+ * The grains live in a fixed pool and read the existing tape through the
+ * engine's TapeReadHead (its interpolation, and its stretched sinc above
+ * 1x), so the cloud allocates nothing and holds no audio of its own. The
+ * cost is bounded by the budget: at most that many grains sound at once,
+ * and a grain due while the budget is full is skipped (getDropped()).
+ * Grains render in batches of BATCH: one pass wraps every read position
+ * in the batch, then each grain reads its block and adds it, windowed and
+ * panned, in loops the compiler vectorises.
+ *
+ *   grains.prepare(sampleRate);                            // prepare()
+ *   grains.setLevel(0.5f);                                 // 0: off
+ *   grains.render(readHead, tapeL, tapeR, writePos, transport, playL, playR, n, loop, 1.0f / TAPE_SCALE);
+ *
+ * render() leaves the tape alone: the cloud is heard, never recorded.
+ *
+ * @note No allocation or locks: real-time safe. The window table is
+ *       read-only data.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ConstexprTables.h"
+#include "Noise.h"
+#include "PitchTables.h"
+#include "TapeReadHead.h"
+
+class TapeGrains
+{
+public:
+    /** Grains in the pool: the largest budget */
+    static constexpr int MAX_GRAINS = 32;
+
+    /** Grains whose positions are wrapped in one pass */
+    static constexpr int BATCH = 8;
+
+    /** Longest span render() takes */
+    static constexpr int MAX_SPAN = 64;
+
+    static constexpr int WINDOW_POINTS = 512;
+    static constexpr size_t WINDOW_TABLE_BYTES = sizeof(float) * (WINDOW_POINTS + 1);
+
+    static constexpr float MIN_DENSITY = 1.0f;
+    static constexpr float MAX_DENSITY = 100.0f;
+    static constexpr float MIN_SIZE_SECONDS = 0.01f;
+    static constexpr float MAX_SIZE_SECONDS = 0.5f;
+    static constexpr float MAX_PITCH = 24.0f;  // Semitones either way: the read head's 4x
+
+    /** Drop every grain and restart the schedule at the given rate */
+    void prepare(double sr)
+    {
+        sampleRate = static_cast<float>(sr);
+        reset();
+    }
+
+    void reset()
+    {
+        numActive = 0;
+        untilNext = 0.0;
+    }
+
+    /** Cloud volume; 0 stops it, and the next grain starts as soon as it comes up */
+    void setLevel(float value)
+    {
+        level = std::clamp(value, 0.0f, 1.0f);
+        if (level <= 0.0f)
+            reset();
+    }
+
+    /** Grains started a second, on average */
+    void setDensity(float perSecond) { density = std::clamp(perSecond, MIN_DENSITY, MAX_DENSITY); }
+
+    /** Each grain's length, window and all */
+    void setSize(float seconds) { sizeSeconds = std::clamp(seconds, MIN_SIZE_SECONDS, MAX_SIZE_SECONDS); }
+
+    /** Where grains read, as a fraction of the loop behind the record head */
+    void setPosition(float fraction) { position = std::clamp(fraction, 0.0f, 1.0f); }
+
+    /** Random spread of the read position, as a fraction of the loop */
+    void setSpray(float fraction) { spray = std::clamp(fraction, 0.0f, 1.0f); }
+
+    /** Grain pitch, in semitones from the tape's */
+    void setPitch(float semitones) { pitch = std::clamp(semitones, -MAX_PITCH, MAX_PITCH); }
+
+    /** Random spread of the pitch, in semitones either way */
+    void setPitchSpread(float semitones) { pitchSpread = std::clamp(semitones, 0.0f, MAX_PITCH); }
+
+    /** Random spread of the pan, 0 (centre) to 1 (anywhere) */
+    void setPanSpread(float amount) { panSpread = std::clamp(amount, 0.0f, 1.0f); }
+
+    /** Most grains sounding at once (1 to MAX_GRAINS); a grain past it is skipped */
+    void setBudget(int grains) { budget = std::clamp(grains, 1, MAX_GRAINS); }
+    int getBudget() const { return budget; }
+
+    void setNoiseSeed(uint32_t seed) { rng.reseed(seed); }
+
+    int getNumActive() const { return numActive; }
+
+    /** Grains skipped because the budget was full, since construction */
+    uint64_t getDropped() const { return dropped; }
+
+    /** True if render() has anything to do */
+    bool isActive() const { return level > 0.0f; }
+
+    /**
+     * @brief Add the cloud's next n samples (n <= MAX_SPAN) to outL / outR
+     * @param head         The engine's read head, its loop already set
+     * @param spanStart    The record head's place at the span's first sample
+     * @param transport    Per sample, what the wobble and voice FM move every head by
+     * @param gain         Scale from tape units to the output's
+     */
+    void render(const TapeReadHead& head, const int16_t* tapeL, const int16_t* tapeR, size_t spanStart,
+                const float* transport, float* outL, float* outR, int n, size_t loopSamples, float gain)
+    {
+        n = std::min(n, MAX_SPAN);
+        const double loop = static_cast<double>(loopSamples);
+
+        if (level <= 0.0f)
+            return;
+
+        // Start every grain due in this span, at its sample
+        while (untilNext < n)
+        {
+            start(static_cast<int>(untilNext), static_cast<double>(spanStart), loop);
+            untilNext += (0.5 + static_cast<double>(rng.unif01())) * sampleRate / density;
+        }
+        untilNext -= n;
+
+        for (int first = 0; first < numActive; first += BATCH)
+            renderBatch(head, tapeL, tapeR, transport, outL, outR, first, std::min(BATCH, numActive - first), n,
+                        level * gain);
+
+        // Advance, and retire the grains that have finished
+        for (int g = 0; g < numActive;)
+        {
+            Grain& grain = grains[static_cast<size_t>(g)];
+            const int count = std::min(n - grain.delay, grain.length - grain.age);
+            grain.position = wrap(grain.position + static_cast<double>(grain.ratio) * count, loop);
+            grain.age += count;
+            grain.delay = 0;
+            if (grain.age >= grain.length)
+                grain = grains[static_cast<size_t>(--numActive)];
+            else
+                ++g;
+        }
+    }
+
+private:
+    struct Grain
+    {
+        double position = 0.0;  // Tape sample its next read starts from
+        float ratio = 1.0f;     // Tape read per sample
+        float gainL = 0.0f;
+        float gainR = 0.0f;
+        float windowStep = 0.0f;  // Window table points per sample
+        int length = 0;           // Samples
+        int age = 0;              // Samples played
+        int delay = 0;            // Samples into this span it starts (its first span only)
+    };
+
+    static double wrap(double p, double loop) { return p - loop * std::floor(p / loop); }
+
+    /** A grain from onset samples into the span, unless the budget is full */
+    void start(int onset, double spanStart, double loop)
+    {
+        // Draw the same numbers either way, so skipping doesn't reshuffle the cloud
+        const float where = rng.unifPM1();
+        const float detune = rng.unifPM1();
+        const float pan = rng.unifPM1() * panSpread;
+
+        if (numActive >= budget)
+        {
+            ++dropped;
+            return;
+        }
+
+        const double behind = static_cast<double>(position + 0.5f * spray * where) * loop;
+        const float length = std::max(sizeSeconds * sampleRate, 2.0f);
+        const float overlap = std::max(1.0f, density * sizeSeconds);
+        const float grainGain = 1.0f / std::sqrt(overlap);
+
+        Grain& grain = grains[static_cast<size_t>(numActive++)];
+        grain.position = wrap(spanStart + onset - behind, loop);
+        grain.ratio = std::clamp(PitchTables::get().semitonesToRatio(pitch + pitchSpread * detune),
+                                 1.0f / TapeReadHead::MAX_SPEED, TapeReadHead::MAX_SPEED);
+        grain.gainL = grainGain * std::min(1.0f, 1.0f - pan);
+        grain.gainR = grainGain * std::min(1.0f, 1.0f + pan);
+        grain.length = static_cast<int>(length);
+        grain.windowStep = static_cast<float>(WINDOW_POINTS) / static_cast<float>(grain.length);
+        grain.age = 0;
+        grain.delay = onset;
+    }
+
+    /** Grains [first, first + count): wrap all their positions in one pass, then read and mix each */
+    void renderBatch(const TapeReadHead& head, const int16_t* tapeL, const int16_t* tapeR, const float* transport,
+                     float* outL, float* outR, int first, int count, int n, float scale) const
+    {
+        float positions[BATCH * MAX_SPAN];
+        int starts[BATCH];
+        int lengths[BATCH];
+
+        int used = 0;
+        for (int b = 0; b < count; ++b)
+        {
+            const Grain& grain = grains[static_cast<size_t>(first + b)];
+            starts[b] = grain.delay;
+            lengths[b] = std::min(n - grain.delay, grain.length - grain.age);
+
+            const float from = static_cast<float>(grain.position);
+            float* p = positions + used;
+            const float* move = transport + grain.delay;
+            for (int i = 0; i < lengths[b]; ++i)
+                p[i] = from + grain.ratio * static_cast<float>(i) - move[i];
+            used += lengths[b];
+        }
+        head.wrapBlock(positions, used);
+
+        const auto& window = windowTable();
+        used = 0;
+        for (int b = 0; b < count; ++b)
+        {
+            const Grain& grain = grains[static_cast<size_t>(first + b)];
+            const int length = lengths[b];
+            const float* p = positions + used;
+            used += length;
+
+            float readL[MAX_SPAN] = {};
+            float readR[MAX_SPAN] = {};
+            head.readBlock(tapeL, p, 1.0f, readL, length, grain.ratio);
+            head.readBlock(tapeR, p, 1.0f, readR, length, grain.ratio);
+
+            float envelope[MAX_SPAN];
+            const float phase = static_cast<float>(grain.age) * grain.windowStep;
+            for (int i = 0; i < length; ++i)
+            {
+                const float x = std::min(phase + grain.windowStep * static_cast<float>(i),
+                                         static_cast<float>(WINDOW_POINTS));
+                const int index = std::min(static_cast<int>(x), WINDOW_POINTS - 1);
+                const float frac = x - static_cast<float>(index);
+                const float w0 = window[static_cast<size_t>(index)];
+                const float w1 = window[static_cast<size_t>(index + 1)];
+                envelope[i] = scale * (w0 + (w1 - w0) * frac);
+            }
+
+            float* l = outL + starts[b];
+            float* r = outR + starts[b];
+            for (int i = 0; i < length; ++i)
+            {
+                l[i] += readL[i] * envelope[i] * grain.gainL;
+                r[i] += readR[i] * envelope[i] * grain.gainR;
+            }
+        }
+    }
+
+    using WindowTable = std::array<float, WINDOW_POINTS + 1>;
+
+    /** Hann window over WINDOW_POINTS, zero at both ends, computed at compile time and shared */
+    static const WindowTable& windowTable()
+    {
+        static constexpr WindowTable table = ConstexprTables::make<float, WINDOW_POINTS + 1>([](size_t i) {
+            return 0.5 - 0.5 * ConstexprTables::cos(2.0 * ConstexprTables::PI * static_cast<double>(i) / WINDOW_POINTS);
+        });
+        return table;
+    }
+
+    std::array<Grain, MAX_GRAINS> grains{};
+    int numActive = 0;        // Sounding grains, grains[0, numActive)
+    double untilNext = 0.0;   // Samples from this span's start to the next grain
+    uint64_t dropped = 0;
+
+    float sampleRate = 44100.0f;
+    float level = 0.0f;
+    float density = 20.0f;
+    float sizeSeconds = 0.1f;
+    float position = 0.5f;
+    float spray = 0.1f;
+    float pitch = 0.0f;
+    float pitchSpread = 0.0f;
+    float panSpread = 0.5f;
+    int budget = MAX_GRAINS;
+
+    NoiseSource rng;
+};
@@ -13,15 +13,90 @@
  *   - Records incoming oscillator audio when note is held
  *   - Feedback causes layers to accumulate (like tape overdub)
  *   - Degradation (wobble, saturation, filtering, noise) applied each pass
+ *
+ * The Airwindows tape stage can run 2x or 4x oversampled (Oversampler.h,
+ * setOversampling()) so a hard drive doesn't alias. The tape is read
+ * with linear, Hermite or sinc interpolation (TapeReadHead.h,
+ * setTapeInterpolation()). The plugin saves the recorded loop with its
+ * state and streams it back in on load (TapeState.h, writeTape()).
+ *
+ * After the reverb, a convolution stage plays a loaded impulse response
+ * (Convolver.h): loadImpulse() from a background thread, setConvMix() to
+ * hear it.
+ *
+ * The delay, reverb, convolver and compressor each sleep once their input
+ * has been silent for longer than their tail (SilenceGate.h); isSilent()
+ * reports a block with nothing left ringing.
+ *
+ * With setLazyEffects() the delay's and the reverb's lines exist only
+ * while their mix is up (LazyEffect.h): the audio thread asks for them,
+ * serviceEffects() allocates and frees them off it.
+ *
+ * While the host plays, the sequencers follow its tempo and beat position
+ * (setTransport()) instead of the BPM knob.
+ *
+ * setRenderRate() runs the whole engine at a fixed internal rate whatever
+ * the host's (FixedRateRenderer.h): the cost per second, the tape's size
+ * and everything tuned in samples stay put at 96 or 192 kHz, and the
+ * output is resampled to the host's rate.
+ *
+ * setQualityTier() trades fidelity for speed (QualityTier.h): draft reads
+ * the tape linearly, drops the Airwindows stage's oversampling and thins
+ * the reverb and the grain cloud; high reads with sinc and oversamples 4x.
+ *
+ * setTapeSpeed() and setTapeReverse() move the record head's read through
+ * the tape at 0.25x to 4x, either way, while it records at 1x; each pass
+ * round the loop comes back shifted. Reads above 1x are band-limited
+ * (TapeReadHead's stretched sinc).
+ *
+ * Up to NUM_PLAY_HEADS more heads read the same tape, each at its own
+ * offset behind the record head, speed, pan and level (setHeadLevel() and
+ * the setters next to it). They're mixed into the playback before the
+ * degradation, so several echo heads cost one tape and one pass of the
+ * effects rather than one instance each. Only the record head feeds back.
+ *
+ * A grain cloud reads the tape too (TapeGrains.h, setGrainLevel() and the
+ * setters next to it): windowed grains from random places near a position
+ * behind the record head, at random pitches and pans, mixed in with the
+ * play heads. The grains come from a fixed pool, at most the quality
+ * tier's budget of them at once, and read the tape in place.
+ *
+ * getTapeSnapshot() streams the loop out as it was at one moment, from a
+ * background thread while recording goes on (TapeSnapshot.h).
+ *
+ * The web builds (web-dfam's Makefile) compile this engine as it is, with
+ * no sst on the include path: of the sst-backed core/dsp headers it may
+ * only include Oversampler.h and FixedRateRenderer.h, which
+ * web-dfam/src/dsp/tapeloop stands in for.
  */
 
 #pragma once
 
 #include <array>
 #include <vector>
+#include <cstdint>
 #include <cmath>
 #include <algorithm>
-#include <random>
+#include <type_traits>
+
+#include "ADSREnvelope.h"
+#include "Compressor.h"
+#include "Convolver.h"
+#include "LazyEffect.h"
+#include "MemoryReport.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "PitchTables.h"
+#include "QualityTier.h"
+#include "SilenceGate.h"
+#include "StereoDelay.h"
+#include "StepClock.h"
+#include "SynthParams.h"
+#include "TraceRing.h"
+#include "Denormals.h"
+#include "FastMath.h"
+#include "FixedRateRenderer.h"
+#include "Noise.h"
 
 /**
  * @brief Simple AD (Attack-Decay) envelope with smooth linear attack
@@ -102,213 +177,118 @@ private:
 };
 
 /**
- * @brief Full ADSR envelope with sustain stage
+ * @brief The tape character LFO, pan LFO and wobble, a span at a time
+ *
+ * Three phase accumulators side by side as lanes of one 4-wide bank (the
+ * fourth is spare, so a step is one SSE add). render() steps the bank over
+ * the span into the output buffers as phases, then shapes each buffer in
+ * its own loop: the sines, and the pan gains' equal-power sin / cos, are
+ * one branchless polynomial (within 1e-6). Nothing per sample calls
+ * std::sin or std::sqrt, and each shaping loop vectorizes.
  */
-class ADSREnvelope
+class TapeModulators
 {
 public:
-    enum Stage { IDLE, ATTACK, DECAY, SUSTAIN, RELEASE };
-
-    void setSampleRate(float sr) { sampleRate = sr; updateCoefficients(); }
-    void setAttack(float ms) { attackTime = std::max(1.0f, ms) / 1000.0f; updateCoefficients(); }
-    void setDecay(float ms) { decayTime = std::max(1.0f, ms) / 1000.0f; updateCoefficients(); }
-    void setSustain(float level) { sustainLevel = std::clamp(level, 0.0f, 1.0f); }
-    void setRelease(float ms) { releaseTime = std::max(1.0f, ms) / 1000.0f; updateCoefficients(); }
-
-    void trigger()
-    {
-        stage = ATTACK;
-        // Don't reset level - continue from current for click-free retrigger
-    }
-
-    void release()
-    {
-        if (stage != IDLE)
-            stage = RELEASE;
-    }
+    enum Lane { CHARACTER, PAN, WOBBLE, LANES = 4 };
 
-    float process()
+    void setSampleRate(float sr)
     {
-        switch (stage)
-        {
-            case ATTACK:
-                currentLevel += attackIncrement;
-                if (currentLevel >= 1.0f)
-                {
-                    currentLevel = 1.0f;
-                    stage = DECAY;
-                }
-                break;
-
-            case DECAY:
-                currentLevel += decayIncrement * (sustainLevel - currentLevel);
-                if (currentLevel <= sustainLevel + 0.001f)
-                {
-                    currentLevel = sustainLevel;
-                    stage = SUSTAIN;
-                }
-                break;
-
-            case SUSTAIN:
-                currentLevel = sustainLevel;
-                break;
-
-            case RELEASE:
-                currentLevel *= releaseCoef;
-                if (currentLevel < 0.0001f)
-                {
-                    currentLevel = 0.0f;
-                    stage = IDLE;
-                }
-                break;
-
-            case IDLE:
-            default:
-                currentLevel = 0.0f;
-                break;
-        }
-        return currentLevel;
+        sampleRate = sr;
+        for (int l = 0; l < LANES; ++l)
+            increment[l] = rate[l] / sampleRate;
     }
 
-    bool isActive() const { return stage != IDLE || currentLevel > 0.0001f; }
-    float getLevel() const { return currentLevel; }
-    Stage getStage() const { return stage; }
-
-private:
-    void updateCoefficients()
+    /** Lane rate in Hz; the two LFOs are held to 0.01-50 Hz */
+    void setRate(Lane lane, float hz)
     {
-        float attackSamples = attackTime * sampleRate;
-        attackIncrement = 1.0f / std::max(1.0f, attackSamples);
-
-        float decaySamples = decayTime * sampleRate;
-        decayIncrement = 4.0f / std::max(1.0f, decaySamples);
-
-        float releaseSamples = releaseTime * sampleRate;
-        releaseCoef = std::exp(-4.0f / std::max(1.0f, releaseSamples));
+        rate[lane] = lane == WOBBLE ? std::max(0.0f, hz) : std::clamp(hz, 0.01f, 50.0f);
+        increment[lane] = rate[lane] / sampleRate;
     }
 
-    float sampleRate = 44100.0f;
-    float attackTime = 0.01f;
-    float decayTime = 0.1f;
-    float sustainLevel = 0.7f;
-    float releaseTime = 0.3f;
-    float attackIncrement = 0.001f;
-    float decayIncrement = 0.01f;
-    float releaseCoef = 0.999f;
-    float currentLevel = 0.0f;
-    Stage stage = IDLE;
-};
-
-/**
- * @brief Simple LFO with multiple waveforms
- */
-class SimpleLFO
-{
-public:
-    SimpleLFO() = default;
-
-    void setSampleRate(float sr) { sampleRate = sr; }
-    void setRate(float hz) { rate = std::clamp(hz, 0.01f, 50.0f); }
+    /** Character LFO shape: 0 sine, 1 triangle, 2 saw up, 3 square */
     void setWaveform(int wf) { waveform = wf; }
 
-    void reset() { phase = 0.0f; }
+    void reset() { phase.fill(0.0f); }
 
-    float process()
+    /**
+     * @brief The span's modulation
+     * @param character Character LFO, -depth to +depth
+     * @param panLeft,panRight Equal-power gains for a pan LFO swinging by panDepth
+     * @param wobble Wobble sine, -1 to 1
+     */
+    void render(float* character, float* panLeft, float* panRight, float* wobble, int n,
+                float depth, float panDepth)
     {
-        float output = 0.0f;
+        for (int i = 0; i < n; ++i)
+        {
+            character[i] = phase[CHARACTER];
+            panLeft[i] = phase[PAN];
+            wobble[i] = phase[WOBBLE];
+            for (int l = 0; l < LANES; ++l)
+            {
+                phase[l] += increment[l];
+                phase[l] -= phase[l] >= 1.0f ? 1.0f : 0.0f;
+            }
+        }
 
         switch (waveform)
         {
-            case 0: // Sine
-                output = std::sin(phase * 6.283185f);
-                break;
-            case 1: // Triangle
-                output = 4.0f * std::abs(phase - 0.5f) - 1.0f;
-                break;
-            case 2: // Saw up
-                output = 2.0f * phase - 1.0f;
-                break;
-            case 3: // Square
-                output = phase < 0.5f ? 1.0f : -1.0f;
-                break;
-            default:
-                output = std::sin(phase * 6.283185f);
+        case 1:  // Triangle
+            for (int i = 0; i < n; ++i)
+                character[i] = (4.0f * std::abs(character[i] - 0.5f) - 1.0f) * depth;
+            break;
+        case 2:  // Saw up
+            for (int i = 0; i < n; ++i)
+                character[i] = (2.0f * character[i] - 1.0f) * depth;
+            break;
+        case 3:  // Square
+            for (int i = 0; i < n; ++i)
+                character[i] = character[i] < 0.5f ? depth : -depth;
+            break;
+        default:  // Sine
+            for (int i = 0; i < n; ++i)
+                character[i] = sine(character[i]) * depth;
+            break;
         }
 
-        phase += rate / sampleRate;
-        if (phase >= 1.0f) phase -= 1.0f;
-
-        return output;
-    }
-
-private:
-    float phase = 0.0f;
-    float rate = 1.0f;
-    int waveform = 0;
-    float sampleRate = 44100.0f;
-};
-
-/**
- * @brief Stereo delay with feedback
- */
-class StereoDelay
-{
-public:
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        bufferSize = static_cast<size_t>(sr * 4.0);  // 4 seconds max
-        bufferL.resize(bufferSize, 0.0f);
-        bufferR.resize(bufferSize, 0.0f);
-        writePos = 0;
-    }
-
-    void setTime(float seconds)
-    {
-        delayTime = std::clamp(seconds, 0.001f, 4.0f);
-        updateDelaySamples();
-    }
-
-    void setFeedback(float fb) { feedback = std::clamp(fb, 0.0f, 0.95f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
-    {
-        size_t readPos = (writePos + bufferSize - delaySamples) % bufferSize;
-
-        float delayedL = bufferL[readPos];
-        float delayedR = bufferR[readPos];
-
-        bufferL[writePos] = left + delayedL * feedback;
-        bufferR[writePos] = right + delayedR * feedback;
-
-        left = left * (1.0f - mix) + delayedL * mix;
-        right = right * (1.0f - mix) + delayedR * mix;
+        // Pan position 0-1 as a quarter turn: left cos, right sin
+        for (int i = 0; i < n; ++i)
+        {
+            const float turn = (1.0f + sine(panLeft[i]) * panDepth) * 0.125f;
+            panLeft[i] = sine(0.25f - turn);
+            panRight[i] = sine(turn);
+        }
 
-        writePos = (writePos + 1) % bufferSize;
+        for (int i = 0; i < n; ++i)
+            wobble[i] = sine(wobble[i]);
     }
 
 private:
-    void updateDelaySamples()
+    /** sin(2 pi p) for p in [-0.5, 1) */
+    static float sine(float p)
     {
-        delaySamples = static_cast<size_t>(delayTime * sampleRate);
-        if (delaySamples >= bufferSize)
-            delaySamples = bufferSize - 1;
+        // Into [-0.5, 0.5), then folded into [-0.25, 0.25] where the odd
+        // polynomial holds: sin(2 pi x) = sin(2 pi (+-0.5 - x))
+        float x = p >= 0.5f ? p - 1.0f : p;
+        const float half = x < 0.0f ? -0.5f : 0.5f;
+        x = std::abs(x) > 0.25f ? half - x : x;
+
+        const float r = 6.28318531f * x;
+        const float r2 = r * r;
+        return r * (0.999999999f + r2 * (-0.166666666f + r2 * (0.00833332958f
+                   + r2 * (-0.000198407323f + r2 * (2.75200455e-06f + r2 * -2.38122111e-08f)))));
     }
 
-    double sampleRate = 44100.0;
-    std::vector<float> bufferL;
-    std::vector<float> bufferR;
-    size_t bufferSize = 176400;
-    size_t writePos = 0;
-    size_t delaySamples = 22050;
-    float delayTime = 0.5f;
-    float feedback = 0.3f;
-    float mix = 0.0f;
+    std::array<float, LANES> phase{};
+    std::array<float, LANES> rate{1.0f, 0.5f, 0.5f, 0.0f};
+    std::array<float, LANES> increment{};
+    int waveform = 0;
+    float sampleRate = 44100.0f;
 };
 
-// Forward declare Galactic3Reverb (defined in separate header)
-#include "Galactic3Reverb.h"
+// Galactic3: the float, interleaved network, or the exact Airwindows one
+// in the reference build (ReferenceDsp.h)
+#include "Galactic3ReverbPacked.h"
 
 // TapeDust for authentic slew-dependent tape hiss
 #include "TapeDust.h"
@@ -316,69 +296,15 @@ private:
 // Airwindows Tape for saturation and head bump
 #include "AirwindowsTape.h"
 
-/**
- * @brief Simple compressor with dry/wet mix
- */
-class Compressor
-{
-public:
-    void prepare(double sr)
-    {
-        sampleRate = sr;
-        updateCoefficients();
-    }
-
-    void setThreshold(float db) { threshold = db; }
-    void setRatio(float r) { ratio = std::clamp(r, 1.0f, 20.0f); }
-    void setAttack(float ms) { attackMs = std::clamp(ms, 0.1f, 100.0f); updateCoefficients(); }
-    void setRelease(float ms) { releaseMs = std::clamp(ms, 10.0f, 1000.0f); updateCoefficients(); }
-    void setMakeupGain(float db) { makeupGain = std::pow(10.0f, db / 20.0f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
-
-    void process(float& left, float& right)
-    {
-        float dryL = left;
-        float dryR = right;
-
-        float inputLevel = std::max(std::abs(left), std::abs(right));
-        float inputDb = 20.0f * std::log10(inputLevel + 1e-6f);
-
-        float gainReduction = 0.0f;
-        if (inputDb > threshold)
-            gainReduction = (inputDb - threshold) * (1.0f - 1.0f / ratio);
-
-        float targetGain = std::pow(10.0f, -gainReduction / 20.0f);
-        if (targetGain < envelope)
-            envelope = attackCoef * envelope + (1.0f - attackCoef) * targetGain;
-        else
-            envelope = releaseCoef * envelope + (1.0f - releaseCoef) * targetGain;
-
-        float gain = envelope * makeupGain;
-        float wetL = left * gain;
-        float wetR = right * gain;
-
-        left = dryL * (1.0f - mix) + wetL * mix;
-        right = dryR * (1.0f - mix) + wetR * mix;
-    }
+// Half-band oversampling around the Airwindows stage
+#include "Oversampler.h"
 
-private:
-    void updateCoefficients()
-    {
-        attackCoef = std::exp(-1.0f / (attackMs * 0.001f * static_cast<float>(sampleRate)));
-        releaseCoef = std::exp(-1.0f / (releaseMs * 0.001f * static_cast<float>(sampleRate)));
-    }
+// Interpolated read from the 16-bit tape
+#include "TapeReadHead.h"
+#include "TapeSnapshot.h"
 
-    double sampleRate = 44100.0;
-    float threshold = -10.0f;
-    float ratio = 4.0f;
-    float attackMs = 10.0f;
-    float releaseMs = 100.0f;
-    float makeupGain = 1.0f;
-    float attackCoef = 0.0f;
-    float releaseCoef = 0.0f;
-    float envelope = 1.0f;
-    float mix = 1.0f;
-};
+// Granular cloud read of the same tape
+#include "TapeGrains.h"
 
 /**
  * @brief Simple band-limited oscillator using PolyBLEP
@@ -418,7 +344,7 @@ public:
         switch (waveform)
         {
             case 0: // Sine
-                output = static_cast<float>(std::sin(phase * 2.0 * M_PI));
+                output = FastMath::sinCycles(static_cast<float>(phase));
                 break;
 
             case 1: // Triangle
@@ -488,7 +414,8 @@ private:
  *
  * Each step has a MIDI pitch (note number) and gate (on/off).
  * Clock divides from 1/128 to 1 (whole note).
- * Used to sequence oscillator pitches in the TapeLoopEngine.
+ * Used to sequence oscillator pitches in the TapeLoopEngine, which renders
+ * in runs between steps (StepClock) and only retunes at a step.
  */
 class StepSequencer
 {
@@ -496,9 +423,9 @@ public:
     static constexpr int NUM_STEPS = 4;
     static constexpr int NUM_DIVISIONS = 16;  // Extended to include slower divisions
 
-    void setSampleRate(float sr) { sampleRate = sr; }
-    void setBPM(float bpm) { this->bpm = bpm; }
-    void setDivisionIndex(int idx) { divisionIndex = std::clamp(idx, 0, NUM_DIVISIONS - 1); }
+    void setSampleRate(float sr) { sampleRate = sr; updateStepLength(); }
+    void setBPM(float bpm) { this->bpm = bpm; updateStepLength(); }
+    void setDivisionIndex(int idx) { divisionIndex = std::clamp(idx, 0, NUM_DIVISIONS - 1); updateStepLength(); }
 
     void setStepPitch(int step, int midiNote)
     {
@@ -526,72 +453,80 @@ public:
 
     void reset()
     {
-        phase = 0.0f;
+        clock.reset();
         currentStep = 0;
     }
 
+    /** Clock and step to a host position in beats; the next step boundary plays the step it starts */
+    void syncTo(double beats)
+    {
+        const int64_t nextStep = clock.syncTo(beats * CLOCK_DIVISIONS[divisionIndex] / 4.0);
+        currentStep = static_cast<int>(((nextStep - 1) % NUM_STEPS + NUM_STEPS) % NUM_STEPS);
+    }
+
+    /** Longest run before the next step (see StepClock::nextRunLength) */
+    int nextRunLength() const { return clock.nextRunLength(); }
+
     /**
-     * @brief Process one sample and advance sequencer
-     * @param outMidiNote Output: MIDI note for current step
-     * @param outGate Output: gate state for current step
-     * @return true if step just changed (trigger point)
+     * @brief Move numSamples forward (at most nextRunLength())
+     * @return true if the run starts on a new step (trigger point)
      */
-    bool process(int& outMidiNote, bool& outGate)
-    {
-        bool stepped = false;
-
-        // Clock division values: 1/128 (fast) to 1/64 (very slow, 64 bars)
-        static constexpr float CLOCK_DIVISIONS[] = {
-            128.0f,   // 1/128 note
-            64.0f,    // 1/64 note
-            32.0f,    // 1/32 note
-            16.0f,    // 1/16 note
-            8.0f,     // 1/8 note
-            4.0f,     // 1/4 (quarter)
-            2.0f,     // 1/2 (half)
-            1.0f,     // 1 (whole = 1 bar)
-            0.5f,     // 2 bars
-            0.25f,    // 4 bars
-            0.125f,   // 8 bars
-            0.0625f,  // 16 bars
-            0.03125f, // 32 bars
-            0.015625f,// 64 bars
-            0.0078125f,// 128 bars (very slow)
-            0.00390625f // 256 bars (glacial)
-        };
-
-        // Calculate step duration in samples
-        float beatsPerSecond = bpm / 60.0f;
-        float stepsPerSecond = beatsPerSecond * CLOCK_DIVISIONS[divisionIndex] / 4.0f;
-        float phaseIncrement = stepsPerSecond / sampleRate;
+    bool advance(int numSamples)
+    {
+        if (!clock.advance(numSamples))
+            return false;
 
-        phase += phaseIncrement;
+        currentStep = (currentStep + 1) % NUM_STEPS;
+        return true;
+    }
 
-        if (phase >= 1.0f)
-        {
-            phase -= 1.0f;
-            currentStep = (currentStep + 1) % NUM_STEPS;
-            stepped = true;
-        }
+    /** MIDI note for the current step */
+    int getCurrentPitch() const { return stepPitches[currentStep]; }
 
-        outMidiNote = stepPitches[currentStep];
-        outGate = stepGates[currentStep];
-        return stepped;
-    }
+    /** Gate for the current step */
+    bool getCurrentGate() const { return stepGates[currentStep]; }
 
     /**
      * @brief Get frequency in Hz for a MIDI note
      */
     static float midiToFrequency(int midiNote)
     {
-        return 440.0f * std::pow(2.0f, (midiNote - 69) / 12.0f);
+        return PitchTables::get().midiToFrequency(static_cast<float>(midiNote));
     }
 
 private:
+    // Clock division values: 1/128 (fast) to 1/64 (very slow, 64 bars)
+    static constexpr float CLOCK_DIVISIONS[] = {
+        128.0f,   // 1/128 note
+        64.0f,    // 1/64 note
+        32.0f,    // 1/32 note
+        16.0f,    // 1/16 note
+        8.0f,     // 1/8 note
+        4.0f,     // 1/4 (quarter)
+        2.0f,     // 1/2 (half)
+        1.0f,     // 1 (whole = 1 bar)
+        0.5f,     // 2 bars
+        0.25f,    // 4 bars
+        0.125f,   // 8 bars
+        0.0625f,  // 16 bars
+        0.03125f, // 32 bars
+        0.015625f,// 64 bars
+        0.0078125f,// 128 bars (very slow)
+        0.00390625f // 256 bars (glacial)
+    };
+
+    void updateStepLength()
+    {
+        // Calculate step duration in samples
+        float beatsPerSecond = bpm / 60.0f;
+        float stepsPerSecond = beatsPerSecond * CLOCK_DIVISIONS[divisionIndex] / 4.0f;
+        clock.setSamplesPerStep(static_cast<double>(sampleRate) / stepsPerSecond);
+    }
+
     float sampleRate = 44100.0f;
     float bpm = 120.0f;
     int divisionIndex = 4;  // Default: 1/8 note
-    float phase = 0.0f;
+    StepClock clock;
     int currentStep = 0;
     int stepPitches[NUM_STEPS] = {60, 60, 60, 60};  // MIDI notes (C4 default)
     bool stepGates[NUM_STEPS] = {true, true, true, true};  // Gates on by default
@@ -620,16 +555,18 @@ public:
     /** Maximum sample rate supported */
     static constexpr int MAX_SAMPLE_RATE = 192000;
 
-    /** Maximum buffer size (12 seconds at 192kHz) */
-    static constexpr size_t MAX_BUFFER_SIZE = static_cast<size_t>(MAX_LOOP_SECONDS * MAX_SAMPLE_RATE);
+    /** Scale between float tape samples and the 16-bit buffer */
+    static constexpr float TAPE_SCALE = 32767.0f;
+
+    /** Samples per render pass: each stage runs over a span (see renderSpan()) */
+    static constexpr int TAPE_SPAN = 64;
+
+    /** Play heads besides the record head */
+    static constexpr int NUM_PLAY_HEADS = 3;
 
     TapeLoopEngine()
-        : rng(std::random_device{}())
-        , noiseDist(-1.0f, 1.0f)
     {
-        // Pre-allocate tape buffer
-        tapeBufferL.resize(MAX_BUFFER_SIZE, 0.0f);
-        tapeBufferR.resize(MAX_BUFFER_SIZE, 0.0f);
+        // Tape buffer is allocated in prepare() once the sample rate is known
     }
 
     ~TapeLoopEngine() = default;
@@ -640,12 +577,17 @@ public:
 
     /**
      * @brief Prepare the engine for playback
-     * @param sr Sample rate in Hz
+     * @param sr Host sample rate in Hz
      * @param maxBlockSize Maximum expected block size
      */
     void prepare(double sr, int maxBlockSize)
     {
+        // With a render rate set, everything below runs at it instead
+        fixedRate.prepare(sr, maxBlockSize, renderRate);
+        sr = fixedRate.getEngineRate();
         sampleRate = static_cast<float>(sr);
+        perfStats.prepare(sr);
+        updateTuneRatios();
 
         // Initialize oscillators with default frequency
         osc1.setFrequency(110.0, sr);  // A2
@@ -654,8 +596,9 @@ public:
         // Initialize envelope
         recordEnvelope.setSampleRate(sampleRate);
 
-        // Initialize tape character LFO
-        tapeCharLFO.setSampleRate(sampleRate);
+        // Character LFO, pan LFO and wobble
+        modulators.setSampleRate(sampleRate);
+        modulators.reset();
 
         // Initialize sequencers (one per oscillator)
         sequencer1.setSampleRate(sampleRate);
@@ -665,18 +608,28 @@ public:
         osc1ADSR.setSampleRate(sampleRate);
         osc2ADSR.setSampleRate(sampleRate);
 
-        // Initialize pan LFO
-        panLFO.setSampleRate(sampleRate);
-        panLFO.setWaveform(0);  // Sine wave for smooth panning
-
-        // Calculate buffer size for current sample rate
-        maxBufferSamples = static_cast<size_t>(MAX_LOOP_SECONDS * sampleRate);
+        // Size the tape for the current sample rate and max loop length.
+        // It only grows, so a lower rate reuses it, and re-preparing at the
+        // same length keeps the loop.
+        const size_t tapeSamples = static_cast<size_t>(std::ceil(maxLoopSeconds * sampleRate));
+        if (tapeBufferL.size() < tapeSamples)
+        {
+            tapeBufferL.assign(tapeSamples, 0);
+            tapeBufferR.assign(tapeSamples, 0);
+        }
+        else if (tapeSamples != maxBufferSamples)
+        {
+            std::fill_n(tapeBufferL.begin(), tapeSamples, int16_t{0});
+            std::fill_n(tapeBufferR.begin(), tapeSamples, int16_t{0});
+        }
+        maxBufferSamples = tapeSamples;
 
         // Reset read/write positions
         writePos = 0;
-
-        // Initialize wobble LFO phase
-        wobblePhase = 0.0f;
+        readDrift = 0.0;
+        for (auto& head : playHeads)
+            head.drift = 0.0;
+        grains.prepare(sr);
 
         // Initialize age filter state
         ageFilterStateL = 0.0f;
@@ -687,26 +640,73 @@ public:
         degradeFilterStateR = 0.0f;
 
         // Initialize effects
-        delay.prepare(sr);
-        reverb.prepare(sr);
+        delay.prepare(sr, lazyEffects);
+        reverb.prepare(sr, lazyEffects);
+        convolver.prepare(sr);
         compressor.prepare(sr);
         tapeDust.prepare(sr);
-        airwindowsTape.prepare(sr);
+        tapeOversampler.setFactor(tierOversampling());
+        airwindowsTape.prepare(sr * tapeOversampler.getFactor());
+        tapeOversampler.reset();
+        modelFadePos = MODEL_FADE;
+    }
+
+    /**
+     * @brief Run at @p hz whatever the host's rate, or at the host's (0)
+     *
+     * Takes effect at the next prepare(). Note offsets stay in host samples,
+     * and getLatencySamples() includes the resampler's.
+     */
+    void setRenderRate(double hz) { renderRate = std::max(0.0, hz); }
+
+    /**
+     * @brief Keep the delay's and reverb's lines only while they're on (LazyEffect.h)
+     *
+     * Takes effect at the next prepare(). For realtime use only: a lazy
+     * effect is silent for the moment its lines take to arrive, which an
+     * offline render would keep. needsEffectService() says when
+     * serviceEffects() has work.
+     */
+    void setLazyEffects(bool lazy) { lazyEffects = lazy; }
+
+    /** True if serviceEffects() has lines to allocate or free (audio thread, after renderBlock()) */
+    bool needsEffectService() const { return delay.needsService() || reverb.needsService(); }
 
-        (void)maxBlockSize;
+    /** Allocate the lines the effects asked for and free the ones they let go (not the audio thread) */
+    void serviceEffects()
+    {
+        delay.service();
+        reverb.service();
     }
+    double getRenderRate() const { return renderRate; }
+
+    /** Rate the engine runs at: the render rate if one is set, else the host's */
+    double getSampleRate() const { return fixedRate.getEngineRate(); }
 
     /**
      * @brief Release resources
      */
     void releaseResources()
     {
-        // Clear tape buffer
-        std::fill(tapeBufferL.begin(), tapeBufferL.end(), 0.0f);
-        std::fill(tapeBufferR.begin(), tapeBufferR.end(), 0.0f);
+        // Free the tape; prepare() allocates it again
+        tapeBufferL.clear();
+        tapeBufferL.shrink_to_fit();
+        tapeBufferR.clear();
+        tapeBufferR.shrink_to_fit();
+        maxBufferSamples = 0;
         writePos = 0;
     }
 
+    /**
+     * @brief Fix the noise so renders repeat exactly (default: clock-seeded)
+     */
+    void setNoiseSeed(uint32_t seed)
+    {
+        rng.reseed(NoiseSource::deriveSeed(seed, 0));
+        tapeDust.setNoiseSeed(NoiseSource::deriveSeed(seed, 1));
+        grains.setNoiseSeed(NoiseSource::deriveSeed(seed, 2));
+    }
+
     //==========================================================================
     // Note Handling
     //==========================================================================
@@ -715,12 +715,17 @@ public:
      * @brief Start recording into the tape loop
      * @param note MIDI note number (sets oscillator pitch)
      * @param velocity Note velocity
+     * @param sampleOffset Sample offset within current block
      *
      * For drone synth: NEVER reset oscillator phase - this causes clicks.
      * Oscillators run continuously; we just modulate their amplitude with envelope.
      */
-    void noteOn(int note, float velocity)
+    void noteOn(int note, float velocity, int sampleOffset = 0)
     {
+        sampleOffset = fixedRate.toEngineOffset(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
+
         bool wasRecording = isRecording;
         isRecording = true;
         currentVelocity = velocity;
@@ -735,7 +740,7 @@ public:
         }
 
         // Always update frequency for pitch changes
-        float baseFreq = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+        float baseFreq = PitchTables::get().midiToFrequency(static_cast<float>(note));
         updateOscillatorFrequencies(baseFreq);
 
         // Track active note for legato
@@ -745,9 +750,14 @@ public:
     /**
      * @brief Stop recording
      * Only release if this is the note that's currently playing
+     * @param sampleOffset Sample offset within current block
      */
-    void noteOff(int note)
+    void noteOff(int note, int sampleOffset = 0)
     {
+        sampleOffset = fixedRate.toEngineOffset(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
+
         // Only release if this was the active note (legato behavior)
         if (note == activeNote)
         {
@@ -761,9 +771,14 @@ public:
 
     /**
      * @brief Stop all immediately
+     * @param sampleOffset Sample offset within current block
      */
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
+        sampleOffset = fixedRate.toEngineOffset(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
         isRecording = false;
     }
 
@@ -772,8 +787,39 @@ public:
      */
     void clearTape()
     {
-        std::fill(tapeBufferL.begin(), tapeBufferL.end(), 0.0f);
-        std::fill(tapeBufferR.begin(), tapeBufferR.end(), 0.0f);
+        std::fill(tapeBufferL.begin(), tapeBufferL.end(), int16_t(0));
+        std::fill(tapeBufferR.begin(), tapeBufferR.end(), int16_t(0));
+    }
+
+    //==========================================================================
+    // Tape Access (saving and restoring the loop, see TapeState.h)
+    //==========================================================================
+
+    /** Samples in the loop at the current loop length (0 until prepared) */
+    size_t getLoopSamples() const
+    {
+        if (maxBufferSamples == 0)
+            return 0;
+        return std::clamp(static_cast<size_t>(loopLength * sampleRate), size_t(1), maxBufferSamples);
+    }
+
+    /** The 16-bit tape, getTapeBufferSize() samples per channel */
+    const int16_t* getTapeL() const { return tapeBufferL.data(); }
+    const int16_t* getTapeR() const { return tapeBufferR.data(); }
+    size_t getTapeWritePos() const { return writePos; }
+
+    /** Move the record / play head (wrapped to the tape) */
+    void setTapeWritePos(size_t pos) { writePos = maxBufferSamples > 0 ? pos % maxBufferSamples : 0; }
+
+    /** Overwrite tape from offset; whatever runs past the tape's end is dropped */
+    void writeTape(size_t offset, const int16_t* left, const int16_t* right, size_t n)
+    {
+        if (offset >= maxBufferSamples)
+            return;
+        n = std::min(n, maxBufferSamples - offset);
+        tapeSnapshot.overwrite(offset, n);
+        std::copy(left, left + n, tapeBufferL.begin() + static_cast<std::ptrdiff_t>(offset));
+        std::copy(right, right + n, tapeBufferR.begin() + static_cast<std::ptrdiff_t>(offset));
     }
 
     //==========================================================================
@@ -788,287 +834,120 @@ public:
      */
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        // Calculate loop length in samples
-        size_t loopSamples = static_cast<size_t>(loopLength * sampleRate);
-        loopSamples = std::clamp(loopSamples, size_t(1), maxBufferSamples);
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            // ================================================================
-            // TAPE CHARACTER LFO
-            // ================================================================
-            float lfoValue = tapeCharLFO.process();
-            float lfoMod = lfoValue * lfoDepth;
+        renderBlock(nullptr, nullptr, outputL, outputR, numSamples);
+    }
 
-            // Apply LFO to selected target
-            float modulatedSaturation = saturation;
-            float modulatedAge = tapeAge;
-            float modulatedWobbleDepth = wobbleDepth;
-            float modulatedDegrade = tapeDegrade;
+    /**
+     * @brief Render audio output, with external audio recorded alongside the oscillators
+     *
+     * The input joins the oscillators before the tape, at the record level
+     * and through the pan LFO as they are: it's recorded into the loop,
+     * modulates the read head through voice-to-loop FM and is heard at the
+     * dry level (another engine feeding this one, or a host's input with
+     * the engine as a tape loop effect).
+     *
+     * The input may be the output (a host's in-place buffer): each span's
+     * input is read before its output is written.
+     * @param inputL Left channel input (nullptr with inputR: no input)
+     * @param inputR Right channel input (may be inputL, for a mono input)
+     */
+    void renderBlock(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples)
+    {
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-            switch (lfoTarget)
+        // Straight through, or at the render rate between two resamplers
+        fixedRate.render(inputL, inputR, outputL, outputR, numSamples,
+            [this](const float* inL, const float* inR, float* outL, float* outR, int n)
             {
-                case 0: // Saturation
-                    modulatedSaturation = std::clamp(saturation + lfoMod * 0.5f, 0.0f, 1.0f);
-                    break;
-                case 1: // Age
-                    modulatedAge = std::clamp(tapeAge + lfoMod * 0.5f, 0.0f, 1.0f);
-                    break;
-                case 2: // Wobble
-                    modulatedWobbleDepth = std::clamp(wobbleDepth + lfoMod * 0.5f, 0.0f, 1.0f);
-                    break;
-                case 3: // Degrade
-                    modulatedDegrade = std::clamp(tapeDegrade + lfoMod * 0.5f, 0.0f, 1.0f);
-                    break;
-            }
+                renderEngineBlock(inL, inR, outL, outR, n);
+            });
+    }
 
-            // ================================================================
-            // SEQUENCERS (one per oscillator)
-            // ================================================================
-            int seq1MidiNote = 60, seq2MidiNote = 60;
-            bool seq1Gate = true, seq2Gate = true;
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
 
-            if (seqEnabled)
-            {
-                // Process sequencers - they return current step's pitch/gate
-                sequencer1.process(seq1MidiNote, seq1Gate);
-                sequencer2.process(seq2MidiNote, seq2Gate);
-
-                // Set oscillator frequencies from sequencer
-                float freq1 = StepSequencer::midiToFrequency(seq1MidiNote);
-                freq1 *= std::pow(2.0f, osc1Tune / 12.0f);
-                osc1.setFrequency(freq1, sampleRate);
-
-                float freq2 = StepSequencer::midiToFrequency(seq2MidiNote);
-                freq2 *= std::pow(2.0f, (osc2Tune + osc2Detune / 100.0f) / 12.0f);
-                osc2.setFrequency(freq2, sampleRate);
-            }
+    /** Render timeline for TraceDumper (see TraceRing.h - empty unless built with SYNTH_TRACE) */
+    TraceRing& getTrace() { return trace; }
 
-            // ================================================================
-            // ENVELOPES
-            // ================================================================
-            float envLevel = recordEnvelope.process();
-            float osc1EnvLevel = osc1ADSR.process();
-            float osc2EnvLevel = osc2ADSR.process();
+    /** Memory held by this instance, by component (see MemoryReport.h; not on the audio thread) */
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report(sizeof(*this));
+        report.addInline("reverb", sizeof(reverb));
+        report.addInline("trace ring", sizeof(trace));
+        report.addHeap("tape", MemoryReport::bytesOf(tapeBufferL) + MemoryReport::bytesOf(tapeBufferR));
+        report.addHeap("tape snapshot", tapeSnapshot.getHeapBytes());
+        report.addHeap("delay", delay.getHeapBytes());
+        report.addHeap("reverb lines", reverb.getHeapBytes());
+        report.addHeap("impulse response", convolver.getHeapBytes());
+        report.addHeap("compressor lookahead", compressor.getHeapBytes());
+        report.addHeap("render rate resampler", fixedRate.getHeapBytes());
+        report.addShared("pitch tables", sizeof(PitchTables));
+        report.addShared("sinc table", TapeReadHead::SINC_TABLE_BYTES);
+        report.addShared("grain window", TapeGrains::WINDOW_TABLE_BYTES);
+        return report;
+    }
 
-            // ================================================================
-            // PAN LFO (for stereo loop recording)
-            // ================================================================
-            float panLFOValue = panLFO.process();  // -1 to +1
-            float panAmount = panLFOValue * panDepth;  // Scale by depth
-            // Calculate stereo pan gains (constant power panning approximation)
-            float panLeft = std::sqrt(0.5f * (1.0f - panAmount));
-            float panRight = std::sqrt(0.5f * (1.0f + panAmount));
+    /** True if the last renderBlock() was all below -120 dB, with no effect tail still running */
+    bool isSilent() const { return silentBlock; }
 
-            // ================================================================
-            // OSCILLATORS (source material) with FM and ADSR
-            // ================================================================
-            float oscOutL = 0.0f;
-            float oscOutR = 0.0f;
-            float osc1Out = 0.0f;
-            float osc2Out = 0.0f;
+    /** True while the step sequencers clock themselves, gated steps still to come */
+    bool isRunning() const { return seqEnabled; }
 
-            // Sequencer plays automatically when enabled (no MIDI required)
-            // MIDI input still works for manual playing
-            bool shouldPlay = seqEnabled || isRecording || recordEnvelope.isActive() ||
-                              osc1ADSR.isActive() || osc2ADSR.isActive();
+    //==========================================================================
+    // Parameter Setters
+    //==========================================================================
 
-            if (shouldPlay)
-            {
-                // Apply sequencer gates (if sequencer enabled)
-                float osc1GateLevel = (!seqEnabled || seq1Gate) ? 1.0f : 0.0f;
-                float osc2GateLevel = (!seqEnabled || seq2Gate) ? 1.0f : 0.0f;
+    // Oscillator 1
+    void setOsc1Waveform(int waveform) { osc1Waveform = waveform; }
+    void setOsc1Tune(float semitones) { osc1Tune = semitones; updateOscillatorFrequencies(baseFrequency); }
+    void setOsc1Level(float level) { osc1Level = level; }
 
-                // Apply ADSR envelopes to oscillators
-                // When sequencer is enabled, use gate level; otherwise use ADSR
-                float osc1AmpMod = seqEnabled ? osc1GateLevel : (osc1GateLevel * osc1EnvLevel);
-                float osc2AmpMod = seqEnabled ? osc2GateLevel : (osc2GateLevel * osc2EnvLevel);
+    // Oscillator 2
+    void setOsc2Waveform(int waveform) { osc2Waveform = waveform; }
+    void setOsc2Tune(float semitones) { osc2Tune = semitones; updateOscillatorFrequencies(baseFrequency); }
+    void setOsc2Detune(float cents) { osc2Detune = cents; updateOscillatorFrequencies(baseFrequency); }
+    void setOsc2Level(float level) { osc2Level = level; }
 
-                // Generate oscillator 1 (carrier or modulator depending on FM)
-                osc1Out = osc1.process(osc1Waveform) * osc1Level * osc1AmpMod;
+    // Tape Loop
+    void setLoopLength(float seconds) { loopLength = std::clamp(seconds, 0.1f, maxLoopSeconds); }
 
-                // Calculate FM modulation from osc1 to osc2
-                float fmMod = osc1Out * fmAmount * 0.1f;  // Scale FM index
-
-                // Generate oscillator 2 with FM modulation
-                osc2Out = osc2.process(osc2Waveform, fmMod) * osc2Level * osc2AmpMod;
-
-                // When sequencer is playing, use full level; otherwise use envelope
-                float levelMod = seqEnabled ? recordLevel : (currentVelocity * recordLevel * envLevel);
-                float oscMono = (osc1Out + osc2Out) * levelMod;
-
-                // Apply pan LFO to create stereo output for recording
-                oscOutL = oscMono * panLeft;
-                oscOutR = oscMono * panRight;
-            }
-
-            // ================================================================
-            // TAPE LOOP - Read with wobble + VOICE FM
-            // ================================================================
-
-            // Calculate wobbled read position (wow/flutter effect)
-            wobblePhase += wobbleRate / sampleRate;
-            if (wobblePhase >= 1.0f) wobblePhase -= 1.0f;
-
-            float wobbleOffset = std::sin(wobblePhase * 6.283185f) * modulatedWobbleDepth * 100.0f;
-
-            // VOICE FM TO LOOP: oscillator output modulates tape read position
-            // This creates wild pitch-shifting effects - the voice "plays" the tape
-            // voiceLoopFM scales the oscillator output to samples offset (up to ~1000 samples)
-            float oscMono = (oscOutL + oscOutR) * 0.5f;  // Use mono for FM calculation
-            float voiceFMOffset = oscMono * voiceLoopFM * 1000.0f;
-
-            // Read position with wobble + voice FM (fractional for interpolation)
-            float readPosF = static_cast<float>(writePos) - wobbleOffset - voiceFMOffset;
-            while (readPosF < 0) readPosF += static_cast<float>(loopSamples);
-            while (readPosF >= static_cast<float>(loopSamples)) readPosF -= static_cast<float>(loopSamples);
-
-            // Linear interpolation for smooth playback
-            size_t readPos0 = static_cast<size_t>(readPosF) % loopSamples;
-            size_t readPos1 = (readPos0 + 1) % loopSamples;
-            float frac = readPosF - std::floor(readPosF);
-
-            float tapeL = tapeBufferL[readPos0] * (1.0f - frac) + tapeBufferL[readPos1] * frac;
-            float tapeR = tapeBufferR[readPos0] * (1.0f - frac) + tapeBufferR[readPos1] * frac;
-
-            // ================================================================
-            // TAPE DEGRADATION
-            // ================================================================
-
-            // Saturation (tanh soft clipping)
-            float satAmount = modulatedSaturation * 4.0f + 1.0f;
-            tapeL = std::tanh(tapeL * satAmount) / std::tanh(satAmount);
-            tapeR = std::tanh(tapeR * satAmount) / std::tanh(satAmount);
-
-            // Age filter (lowpass that simulates high frequency loss)
-            // Higher age = lower cutoff
-            float ageCutoff = 1.0f - (modulatedAge * 0.9f);  // 1.0 to 0.1
-            float ageCoeff = ageCutoff * ageCutoff;          // More aggressive curve
-
-            ageFilterStateL += ageCoeff * (tapeL - ageFilterStateL);
-            ageFilterStateR += ageCoeff * (tapeR - ageFilterStateR);
-
-            tapeL = ageFilterStateL;
-            tapeR = ageFilterStateR;
-
-            // ================================================================
-            // TAPE MODEL PROCESSING
-            // ================================================================
-            // 0 = Bypass, 1 = TapeDust only, 2 = Airwindows only, 3 = Both
-
-            if (tapeModel == 1 || tapeModel == 3)  // TapeDust
-            {
-                tapeDust.setRange(tapeHiss);
-                tapeDust.setMix(tapeHiss * 0.3f);
-                tapeDust.process(tapeL, tapeR);
-            }
-
-            if (tapeModel == 2 || tapeModel == 3)  // Airwindows Tape
-            {
-                airwindowsTape.process(tapeL, tapeR);
-            }
-
-            // ================================================================
-            // SELF-RE-RECORDING DEGRADATION
-            // ================================================================
-            // Simulate tape continuously re-recording itself:
-            // - Each pass loses high frequencies
-            // - Each pass adds subtle saturation
-            // - Higher degrade = faster quality loss
-
-            if (modulatedDegrade > 0.0f)
-            {
-                // Progressive lowpass - simulates magnetic medium losing highs
-                float degradeCoeff = 1.0f - (modulatedDegrade * 0.3f);  // 1.0 to 0.7
-                degradeFilterStateL += degradeCoeff * (tapeL - degradeFilterStateL);
-                degradeFilterStateR += degradeCoeff * (tapeR - degradeFilterStateR);
-
-                // Blend degraded signal based on degrade amount
-                float degradeMix = modulatedDegrade * 0.5f;
-                tapeL = tapeL * (1.0f - degradeMix) + degradeFilterStateL * degradeMix;
-                tapeR = tapeR * (1.0f - degradeMix) + degradeFilterStateR * degradeMix;
-
-                // Add subtle noise accumulation (tape noise floor rises)
-                float degradeNoise = noiseDist(rng) * modulatedDegrade * 0.005f;
-                tapeL += degradeNoise;
-                tapeR += degradeNoise;
-            }
-
-            // ================================================================
-            // TAPE LOOP - Write (overdub with feedback + voice FM + pan)
-            // ================================================================
-
-            // Reduce feedback based on degradation (tape wears out)
-            float effectiveFeedback = loopFeedback * (1.0f - modulatedDegrade * 0.15f);
-
-            // Read current tape content WITH voice FM offset (so FM gets "baked in")
-            // This creates the effect where playing modulates what gets recorded
-            float fmReadL = tapeBufferL[readPos0] * (1.0f - frac) + tapeBufferL[readPos1] * frac;
-            float fmReadR = tapeBufferR[readPos0] * (1.0f - frac) + tapeBufferR[readPos1] * frac;
-
-            // Mix feedback (from FM-modulated read position) and new stereo input with pan
-            float newL = fmReadL * effectiveFeedback + oscOutL;
-            float newR = fmReadR * effectiveFeedback + oscOutR;
-
-            // Soft limit to prevent runaway
-            newL = std::tanh(newL);
-            newR = std::tanh(newR);
-
-            tapeBufferL[writePos] = newL;
-            tapeBufferR[writePos] = newR;
-
-            // Advance write position
-            writePos = (writePos + 1) % loopSamples;
-
-            // ================================================================
-            // OUTPUT MIX
-            // ================================================================
-
-            float dryL = oscOutL * dryLevel;
-            float dryR = oscOutR * dryLevel;
-
-            float wetL = tapeL * loopOutputLevel;
-            float wetR = tapeR * loopOutputLevel;
-
-            float outL = (dryL + wetL) * masterLevel;
-            float outR = (dryR + wetR) * masterLevel;
-
-            // ================================================================
-            // EFFECTS CHAIN: Delay -> Reverb -> Compressor
-            // ================================================================
-
-            delay.process(outL, outR);
-            reverb.process(outL, outR);
-            compressor.process(outL, outR);
-
-            outputL[i] = outL;
-            outputR[i] = outR;
-        }
+    /**
+     * @brief Set the longest loop the tape can hold
+     * @param seconds Max loop length (0.1 to MAX_LOOP_SECONDS)
+     *
+     * Takes effect on the next prepare(), which sizes the tape buffer.
+     * Call before prepare() to keep memory down on hosts that never need
+     * a full minute of tape.
+     */
+    void setMaxLoopLength(float seconds)
+    {
+        maxLoopSeconds = std::clamp(seconds, 0.1f, MAX_LOOP_SECONDS);
+        loopLength = std::min(loopLength, maxLoopSeconds);
     }
+    float getMaxLoopLength() const { return maxLoopSeconds; }
 
-    //==========================================================================
-    // Parameter Setters
-    //==========================================================================
+    /** Tape length in samples per channel (0 until prepared) */
+    size_t getTapeBufferSize() const { return maxBufferSamples; }
 
-    // Oscillator 1
-    void setOsc1Waveform(int waveform) { osc1Waveform = waveform; }
-    void setOsc1Tune(float semitones) { osc1Tune = semitones; updateOscillatorFrequencies(baseFrequency); }
-    void setOsc1Level(float level) { osc1Level = level; }
+    /** The loop as it was at one moment, read out off the audio thread (see TapeSnapshot.h) */
+    TapeSnapshot& getTapeSnapshot() { return tapeSnapshot; }
 
-    // Oscillator 2
-    void setOsc2Waveform(int waveform) { osc2Waveform = waveform; }
-    void setOsc2Tune(float semitones) { osc2Tune = semitones; updateOscillatorFrequencies(baseFrequency); }
-    void setOsc2Detune(float cents) { osc2Detune = cents; updateOscillatorFrequencies(baseFrequency); }
-    void setOsc2Level(float level) { osc2Level = level; }
-
-    // Tape Loop
-    void setLoopLength(float seconds) { loopLength = std::clamp(seconds, 0.1f, MAX_LOOP_SECONDS); }
+    /**
+     * @brief Mark the snapshot's fence now, for when no block is coming to mark it
+     *
+     * Only while the audio thread is held off (under the callback lock).
+     */
+    void markTapeSnapshot()
+    {
+        tapeSnapshot.record(tapeBufferL.data(), tapeBufferR.data(), writePos, 0, getLoopSamples());
+    }
     void setLoopFeedback(float fb) { loopFeedback = std::clamp(fb, 0.0f, 0.99f); }
     void setRecordLevel(float level) { recordLevel = level; }
 
     // Tape Character
     void setSaturation(float sat) { saturation = sat; }
-    void setWobbleRate(float rate) { wobbleRate = rate; }
+    void setWobbleRate(float rate) { modulators.setRate(TapeModulators::WOBBLE, rate); }
     void setWobbleDepth(float depth) { wobbleDepth = depth; }
 
     // Tape Noise
@@ -1090,29 +969,188 @@ public:
     // Tape Degradation
     void setTapeDegrade(float degrade) { tapeDegrade = std::clamp(degrade, 0.0f, 1.0f); }
 
+    /**
+     * @brief Wear the tape when it's recorded instead of when it's played
+     *
+     * Off: saturation, the age lowpass and the re-recording loss colour the
+     * playback, and the tape keeps what was recorded. On: they are applied
+     * once to the feedback as each pass is re-recorded, so the tape itself
+     * holds the worn signal, every generation wears further, and playback
+     * is a plain read.
+     */
+    void setWearOnRecord(bool onRecord) { wearOnRecord = onRecord; }
+    bool getWearOnRecord() const { return wearOnRecord; }
+
     // Tape Model Selection
-    void setTapeModel(int model) { tapeModel = std::clamp(model, 0, 3); }
+    void setTapeModel(int model)
+    {
+        model = std::clamp(model, 0, 3);
+        if (model == tapeModel)
+            return;
+
+        // The oversampler only runs with the Airwindows stage; don't let it
+        // replay what it held when that was last switched off, and pick up
+        // a quality tier's factor that waited for it
+        if (usesAirwindows(model) && !usesAirwindows(tapeModel))
+        {
+            applyOversampling();
+            tapeOversampler.reset();
+        }
+
+        // Each stage the change switches fades over MODEL_FADE samples
+        fadeFromModel = tapeModel;
+        modelFadePos = 0;
+        tapeModel = model;
+    }
     void setTapeDrive(float drive) { tapeDrive = std::clamp(drive, 0.0f, 1.0f); airwindowsTape.setInputGain(drive); }
     void setTapeBump(float bump) { tapeBump = std::clamp(bump, 0.0f, 1.0f); airwindowsTape.setHeadBump(bump); }
 
+    /** Airwindows stage oversampling: 1 (off), 2 or 4, unless the quality tier overrides it */
+    void setOversampling(int factor)
+    {
+        oversampling = factor;
+        applyOversampling();
+    }
+
+    /** The factor running, the quality tier's if it overrides the parameter */
+    int getOversampling() const { return tapeOversampler.getFactor(); }
+
+    /**
+     * @brief Samples the output trails the notes by, for the host's delay compensation
+     *
+     * The sum of every stage in series that delays the signal: the
+     * Airwindows stage's oversampler while that stage is in use, and the
+     * compressor's lookahead; at a render rate, converted to host samples
+     * with the resampler's delay added.
+     */
+    int getLatencySamples() const
+    {
+        return fixedRate.toHostLatency((usesAirwindows(tapeModel) ? tapeOversampler.getLatency() : 0)
+                                       + compressor.getLatency());
+    }
+
+    /** Tape read interpolation: TapeReadHead::Linear, Hermite or Sinc, unless the quality tier overrides it */
+    void setTapeInterpolation(int mode)
+    {
+        tapeInterpolation = std::clamp(mode, 0, TapeReadHead::NumInterpolations - 1);
+        readHead.setInterpolation(forTier(quality, static_cast<int>(TapeReadHead::Linear), tapeInterpolation,
+                                          static_cast<int>(TapeReadHead::Sinc)));
+    }
+    int getTapeInterpolation() const { return tapeInterpolation; }
+
+    /** Record head's read speed through the tape, 0.25x to 4x (it always records at 1x) */
+    void setTapeSpeed(float speed) { tapeSpeed = std::clamp(speed, 0.25f, TapeReadHead::MAX_SPEED); }
+    void setTapeReverse(bool reverse) { tapeReverse = reverse; }
+
+    // Play heads (0 to NUM_PLAY_HEADS - 1); a head at zero level isn't read
+    void setHeadLevel(int head, float level)
+    {
+        if (auto* h = playHead(head))
+            h->level = std::clamp(level, 0.0f, 1.0f);
+    }
+
+    /** How far behind the record head, as a fraction of the loop */
+    void setHeadOffset(int head, float fraction)
+    {
+        if (auto* h = playHead(head))
+            h->offset = std::clamp(fraction, 0.0f, 1.0f);
+    }
+
+    /** Tape read per sample: 1 holds the offset, 2 plays an octave up, below 0 backwards */
+    void setHeadSpeed(int head, float speed)
+    {
+        if (auto* h = playHead(head))
+            h->speed = std::clamp(speed, -TapeReadHead::MAX_SPEED, TapeReadHead::MAX_SPEED);
+    }
+
+    /** Balance between the tape's channels, -1 (left) to 1 (right) */
+    void setHeadPan(int head, float pan)
+    {
+        if (auto* h = playHead(head))
+            h->pan = std::clamp(pan, -1.0f, 1.0f);
+    }
+
+    // Grain cloud (TapeGrains.h); off at zero level
+    void setGrainLevel(float level) { grains.setLevel(level); }
+    void setGrainDensity(float perSecond) { grains.setDensity(perSecond); }
+    void setGrainSize(float ms) { grains.setSize(ms * 0.001f); }
+
+    /** Where grains read, as a fraction of the loop behind the record head */
+    void setGrainPosition(float fraction) { grains.setPosition(fraction); }
+    void setGrainSpray(float fraction) { grains.setSpray(fraction); }
+    void setGrainPitch(float semitones) { grains.setPitch(semitones); }
+    void setGrainPitchSpread(float semitones) { grains.setPitchSpread(semitones); }
+    void setGrainPanSpread(float amount) { grains.setPanSpread(amount); }
+
+    const TapeGrains& getGrains() const { return grains; }
+
+    /**
+     * @brief Draft, normal or high (see QualityTier.h)
+     *
+     * Draft reads the tape linearly, runs the Airwindows stage without
+     * oversampling, steps the reverb's network at most every other sample
+     * and sounds a quarter of the grains; high reads with sinc and
+     * oversamples 4x. Normal leaves all of it to the parameters. A new oversampling factor restarts the
+     * stage's filters, so while the Airwindows stage is in use it waits
+     * for a silent block, the stage to be switched back on, or prepare().
+     */
+    void setQualityTier(QualityTier tier)
+    {
+        quality = tier;
+        setTapeInterpolation(tapeInterpolation);
+        reverb->setMinCycle(forTier(quality, 2, 1, 1));
+        grains.setBudget(forTier(quality, TapeGrains::MAX_GRAINS / 4, TapeGrains::MAX_GRAINS, TapeGrains::MAX_GRAINS));
+        if (!usesAirwindows(tapeModel))
+            applyOversampling();
+    }
+    QualityTier getQualityTier() const { return quality; }
+
     // Tape Character LFO
-    void setLFORate(float hz) { tapeCharLFO.setRate(hz); }
+    void setLFORate(float hz) { modulators.setRate(TapeModulators::CHARACTER, hz); }
     void setLFODepth(float depth) { lfoDepth = std::clamp(depth, 0.0f, 1.0f); }
-    void setLFOWaveform(int wf) { tapeCharLFO.setWaveform(wf); }
+    void setLFOWaveform(int wf) { modulators.setWaveform(wf); }
     void setLFOTarget(int target) { lfoTarget = std::clamp(target, 0, 3); }
 
     // Delay
-    void setDelayTime(float seconds) { delay.setTime(seconds); }
-    void setDelayFeedback(float fb) { delay.setFeedback(fb); }
-    void setDelayMix(float m) { delay.setMix(m); }
+    void setDelayTime(float seconds) { delay->setTime(seconds); }
+    void setDelayFeedback(float fb) { delay->setFeedback(fb); }
+    void setDelayMix(float m)
+    {
+        delay->setMix(m);
+        delay.setWanted(m > 0.0f);
+    }
 
     // Reverb (Galactic3 parameters)
-    void setReverbReplace(float r) { reverb.setReplace(r); }      // Replace (regeneration/feedback)
-    void setReverbBrightness(float b) { reverb.setBrightness(b); } // Brightness (lowpass filter)
-    void setReverbDetune(float d) { reverb.setDetune(d); }        // Detune (vibrato/drift)
-    void setReverbBigness(float b) { reverb.setBigness(b); }      // Bigness (undersampling)
-    void setReverbSize(float s) { reverb.setSize(s); }            // Size (delay network scaling)
-    void setReverbMix(float m) { reverb.setMix(m); }              // Mix (dry/wet)
+    void setReverbReplace(float r) { reverb->setReplace(r); }      // Replace (regeneration/feedback)
+    void setReverbBrightness(float b) { reverb->setBrightness(b); } // Brightness (lowpass filter)
+    void setReverbDetune(float d) { reverb->setDetune(d); }        // Detune (vibrato/drift)
+    void setReverbBigness(float b) { reverb->setBigness(b); }      // Bigness (undersampling)
+    void setReverbSize(float s) { reverb->setSize(s); }            // Size (delay network scaling)
+    void setReverbMix(float m)                                    // Mix (dry/wet)
+    {
+        reverb->setMix(m);
+        reverb.setWanted(m > 0.0f);
+    }
+
+    // Convolution (impulse response)
+    void setConvMix(float m) { convolver.setMix(m); }
+
+    /**
+     * @brief Load an impulse response for the convolver (see Convolver::loadImpulse)
+     *
+     * Resamples and transforms it on the calling thread, so call it from a
+     * background thread; the audio crossfades to it once it's ready.
+     */
+    void loadImpulse(const float* left, const float* right, size_t length, double rate)
+    {
+        convolver.loadImpulse(left, right, length, rate);
+    }
+
+    /** Drop the impulse response (not from the audio thread) */
+    void clearImpulse() { convolver.clearImpulse(); }
+
+    /** Loaded impulse response length at the engine's rate, 0 if none */
+    size_t getImpulseSamples() const { return convolver.getImpulseSamples(); }
 
     // Compressor
     void setCompThreshold(float db) { compressor.setThreshold(db); }
@@ -1121,11 +1159,32 @@ public:
     void setCompRelease(float ms) { compressor.setRelease(ms); }
     void setCompMakeup(float db) { compressor.setMakeupGain(db); }
     void setCompMix(float m) { compressor.setMix(m); }
+    void setCompLookahead(bool on) { compressor.setLookahead(on); }
 
     // Sequencers (dual - one per oscillator)
     void setSeqEnabled(bool enabled) { seqEnabled = enabled; }
     void setSeqBPM(float bpm) { sequencer1.setBPM(bpm); sequencer2.setBPM(bpm); }
 
+    /**
+     * @brief Follow the host's transport, from the next applySnapshot()
+     *
+     * Takes sst's modulators::Transport, or anything with the same status,
+     * tempo and hostTimeInBeats members (the web build has no sst headers).
+     * While the host plays, its tempo replaces the BPM knob and each block
+     * lines both sequencers up with its beat position, so steps land on the
+     * host's grid instead of drifting from it.
+     */
+    template <typename Transport>
+    void setTransport(const Transport& transport)
+    {
+        const bool playing = (transport.status & Transport::PLAYING) != 0;
+        if (playing != hostPlaying || (playing && transport.tempo != hostTempo))
+            hostTempoChanged = true;
+        hostPlaying = playing;
+        hostTempo = transport.tempo;
+        hostBeats = transport.hostTimeInBeats;
+    }
+
     // Sequencer 1 (controls Osc 1)
     void setSeq1Division(int divIdx) { sequencer1.setDivisionIndex(divIdx); }
     void setSeq1StepPitch(int step, int midiNote) { sequencer1.setStepPitch(step, midiNote); }
@@ -1146,21 +1205,819 @@ public:
     void setVoiceLoopFM(float amount) { voiceLoopFM = std::clamp(amount, 0.0f, 1.0f); }
 
     // ADSR Envelopes (per oscillator)
-    void setOsc1Attack(float ms) { osc1Attack = ms; osc1ADSR.setAttack(ms); }
-    void setOsc1Decay(float ms) { osc1Decay = ms; osc1ADSR.setDecay(ms); }
+    void setOsc1Attack(float ms) { osc1Attack = ms; osc1ADSR.setAttack(std::max(1.0f, ms) * 0.001f); }
+    void setOsc1Decay(float ms) { osc1Decay = ms; osc1ADSR.setDecay(std::max(1.0f, ms) * 0.001f); }
     void setOsc1Sustain(float level) { osc1Sustain = level; osc1ADSR.setSustain(level); }
-    void setOsc1Release(float ms) { osc1Release = ms; osc1ADSR.setRelease(ms); }
+    void setOsc1Release(float ms) { osc1Release = ms; osc1ADSR.setRelease(std::max(1.0f, ms) * 0.001f); }
 
-    void setOsc2Attack(float ms) { osc2Attack = ms; osc2ADSR.setAttack(ms); }
-    void setOsc2Decay(float ms) { osc2Decay = ms; osc2ADSR.setDecay(ms); }
+    void setOsc2Attack(float ms) { osc2Attack = ms; osc2ADSR.setAttack(std::max(1.0f, ms) * 0.001f); }
+    void setOsc2Decay(float ms) { osc2Decay = ms; osc2ADSR.setDecay(std::max(1.0f, ms) * 0.001f); }
     void setOsc2Sustain(float level) { osc2Sustain = level; osc2ADSR.setSustain(level); }
-    void setOsc2Release(float ms) { osc2Release = ms; osc2ADSR.setRelease(ms); }
+    void setOsc2Release(float ms) { osc2Release = ms; osc2ADSR.setRelease(std::max(1.0f, ms) * 0.001f); }
 
     // Pan LFO
-    void setPanSpeed(float hz) { panSpeed = hz; panLFO.setRate(hz); }
+    void setPanSpeed(float hz) { modulators.setRate(TapeModulators::PAN, hz); }
     void setPanDepth(float depth) { panDepth = std::clamp(depth, 0.0f, 1.0f); }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h). The three
+     * tuning parameters retune the oscillators once between them, and
+     * switching the sequencer does too: its steps leave the oscillators at
+     * their own pitches, which processBlock() used to overwrite every block.
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // Oscillators
+        if (p.changed(kOsc1Waveform)) setOsc1Waveform(p.index(kOsc1Waveform));
+        if (p.changed(kOsc1Level)) setOsc1Level(p[kOsc1Level]);
+        if (p.changed(kOsc2Waveform)) setOsc2Waveform(p.index(kOsc2Waveform));
+        if (p.changed(kOsc2Level)) setOsc2Level(p[kOsc2Level]);
+        if (p.changed(kOsc1Tune, kOsc2Tune, kOsc2Detune, kSeqEnabled))
+        {
+            osc1Tune = p[kOsc1Tune];
+            osc2Tune = p[kOsc2Tune];
+            osc2Detune = p[kOsc2Detune];
+            updateOscillatorFrequencies(baseFrequency);
+        }
+
+        // Tape Loop
+        if (p.changed(kLoopLength)) setLoopLength(p[kLoopLength]);
+        if (p.changed(kLoopFeedback)) setLoopFeedback(p[kLoopFeedback]);
+        if (p.changed(kRecordLevel)) setRecordLevel(p[kRecordLevel]);
+
+        // Tape Character
+        if (p.changed(kTapeSaturation)) setSaturation(p[kTapeSaturation]);
+        if (p.changed(kTapeWobbleRate)) setWobbleRate(p[kTapeWobbleRate]);
+        if (p.changed(kTapeWobbleDepth)) setWobbleDepth(p[kTapeWobbleDepth]);
+        if (p.changed(kTapeHiss)) setTapeHiss(p[kTapeHiss]);
+        if (p.changed(kTapeAge)) setTapeAge(p[kTapeAge]);
+        if (p.changed(kTapeDegrade)) setTapeDegrade(p[kTapeDegrade]);
+        if (p.changed(kTapeModel)) setTapeModel(p.index(kTapeModel));
+        if (p.changed(kTapeDrive)) setTapeDrive(p[kTapeDrive]);
+        if (p.changed(kTapeBump)) setTapeBump(p[kTapeBump]);
+        if (p.changed(kTapeOversampling))
+            setOversampling(1 << std::clamp(p.index(kTapeOversampling), 0, 2));
+        if (p.changed(kTapeInterpolation)) setTapeInterpolation(p.index(kTapeInterpolation));
+        if (p.changed(kTapeWearOnRecord)) setWearOnRecord(p.flag(kTapeWearOnRecord));
+        if (p.changed(kTapeSpeed)) setTapeSpeed(p[kTapeSpeed]);
+        if (p.changed(kTapeReverse)) setTapeReverse(p.flag(kTapeReverse));
+
+        // Record Envelope
+        if (p.changed(kRecAttack)) setRecAttack(p[kRecAttack]);
+        if (p.changed(kRecDecay)) setRecDecay(p[kRecDecay]);
+
+        // FM
+        if (p.changed(kFmAmount)) setFMAmount(p[kFmAmount]);
+
+        // Tape Character LFO
+        if (p.changed(kLfoRate)) setLFORate(p[kLfoRate]);
+        if (p.changed(kLfoDepth)) setLFODepth(p[kLfoDepth]);
+        if (p.changed(kLfoWaveform)) setLFOWaveform(p.index(kLfoWaveform));
+        if (p.changed(kLfoTarget)) setLFOTarget(p.index(kLfoTarget));
+
+        // Mix
+        if (p.changed(kDryLevel)) setDryLevel(p[kDryLevel]);
+        if (p.changed(kLoopLevel)) setLoopLevel(p[kLoopLevel]);
+        if (p.changed(kMasterLevel)) setMasterLevel(p[kMasterLevel]);
+
+        // Effects
+        if (p.changed(kDelayTime)) setDelayTime(p[kDelayTime]);
+        if (p.changed(kDelayFeedback)) setDelayFeedback(p[kDelayFeedback]);
+        if (p.changed(kDelayMix)) setDelayMix(p[kDelayMix]);
+
+        if (p.changed(kReverbReplace)) setReverbReplace(p[kReverbReplace]);
+        if (p.changed(kReverbBrightness)) setReverbBrightness(p[kReverbBrightness]);
+        if (p.changed(kReverbDetune)) setReverbDetune(p[kReverbDetune]);
+        if (p.changed(kReverbBigness)) setReverbBigness(p[kReverbBigness]);
+        if (p.changed(kReverbSize)) setReverbSize(p[kReverbSize]);
+        if (p.changed(kReverbMix)) setReverbMix(p[kReverbMix]);
+        if (p.changed(kConvMix)) setConvMix(p[kConvMix]);
+
+        if (p.changed(kCompThreshold)) setCompThreshold(p[kCompThreshold]);
+        if (p.changed(kCompRatio)) setCompRatio(p[kCompRatio]);
+        if (p.changed(kCompMix)) setCompMix(p[kCompMix]);
+        if (p.changed(kCompLookahead)) setCompLookahead(p.flag(kCompLookahead));
+
+        // Sequencers (dual)
+        if (p.changed(kSeqEnabled)) setSeqEnabled(p.flag(kSeqEnabled));
+        if (p.changed(kSeqBPM) || hostTempoChanged)
+            setSeqBPM(hostPlaying ? static_cast<float>(hostTempo) : p[kSeqBPM]);
+        hostTempoChanged = false;
+
+        if (p.changed(kSeq1Division)) setSeq1Division(p.index(kSeq1Division));
+        if (p.changed(kSeq2Division)) setSeq2Division(p.index(kSeq2Division));
+        for (int step = 0; step < 4; ++step)
+        {
+            if (p.changed(kSeq1Pitch1 + step)) setSeq1StepPitch(step, p.index(kSeq1Pitch1 + step));
+            if (p.changed(kSeq1Gate1 + step)) setSeq1StepGate(step, p.flag(kSeq1Gate1 + step));
+            if (p.changed(kSeq2Pitch1 + step)) setSeq2StepPitch(step, p.index(kSeq2Pitch1 + step));
+            if (p.changed(kSeq2Gate1 + step)) setSeq2StepGate(step, p.flag(kSeq2Gate1 + step));
+        }
+        if (hostPlaying && seqEnabled)
+        {
+            sequencer1.syncTo(hostBeats);
+            sequencer2.syncTo(hostBeats);
+        }
+
+        // Voice to Loop FM
+        if (p.changed(kVoiceLoopFM)) setVoiceLoopFM(p[kVoiceLoopFM]);
+
+        // ADSR Envelopes (per oscillator)
+        if (p.changed(kOsc1Attack)) setOsc1Attack(p[kOsc1Attack]);
+        if (p.changed(kOsc1Decay)) setOsc1Decay(p[kOsc1Decay]);
+        if (p.changed(kOsc1Sustain)) setOsc1Sustain(p[kOsc1Sustain]);
+        if (p.changed(kOsc1Release)) setOsc1Release(p[kOsc1Release]);
+
+        if (p.changed(kOsc2Attack)) setOsc2Attack(p[kOsc2Attack]);
+        if (p.changed(kOsc2Decay)) setOsc2Decay(p[kOsc2Decay]);
+        if (p.changed(kOsc2Sustain)) setOsc2Sustain(p[kOsc2Sustain]);
+        if (p.changed(kOsc2Release)) setOsc2Release(p[kOsc2Release]);
+
+        // Pan LFO
+        if (p.changed(kPanSpeed)) setPanSpeed(p[kPanSpeed]);
+        if (p.changed(kPanDepth)) setPanDepth(p[kPanDepth]);
+
+        // Play heads
+        for (int head = 0; head < NUM_PLAY_HEADS; ++head)
+        {
+            const int first = kHead1Level + head * (kHead2Level - kHead1Level);
+            if (p.changed(first)) setHeadLevel(head, p[first]);
+            if (p.changed(first + 1)) setHeadOffset(head, p[first + 1]);
+            if (p.changed(first + 2)) setHeadSpeed(head, p[first + 2]);
+            if (p.changed(first + 3)) setHeadPan(head, p[first + 3]);
+        }
+
+        // Grain cloud
+        if (p.changed(kGrainLevel)) setGrainLevel(p[kGrainLevel]);
+        if (p.changed(kGrainDensity)) setGrainDensity(p[kGrainDensity]);
+        if (p.changed(kGrainSize)) setGrainSize(p[kGrainSize]);
+        if (p.changed(kGrainPosition)) setGrainPosition(p[kGrainPosition]);
+        if (p.changed(kGrainSpray)) setGrainSpray(p[kGrainSpray]);
+        if (p.changed(kGrainPitch)) setGrainPitch(p[kGrainPitch]);
+        if (p.changed(kGrainPitchSpread)) setGrainPitchSpread(p[kGrainPitchSpread]);
+        if (p.changed(kGrainPanSpread)) setGrainPanSpread(p[kGrainPanSpread]);
+
+        // kRenderRate needs a prepare: the processor calls setRenderRate()
+    }
+
 private:
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /** One block at the engine's rate, split at queued MIDI events */
+    void renderEngineBlock(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples)
+    {
+        perfStats.beginBlock();
+        TraceRing::Scope blockScope(trace, "render", "renderBlock", numSamples);
+
+        // Nothing is ringing, so a quality tier's oversampling can't click
+        if (silentBlock && tapeOversampler.getFactor() != tierOversampling())
+            applyOversampling();
+        silentBlock = true;
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, inputL, inputR, outputL, outputR](int start, int count)
+            {
+                {
+                    PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+                    if (inputL != nullptr)
+                        renderSamples(inputL + start, inputR + start, outputL + start, outputR + start, count);
+                    else
+                        renderSamples(nullptr, nullptr, outputL + start, outputR + start, count);
+                }
+
+                PerfStats::ScopedStage stage(perfStats, PerfStats::Effects);
+                renderEffects(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, isRecording || recordEnvelope.isActive() ? 1 : 0);
+    }
+
+    /** Render one sub-block between MIDI events (inputL/inputR may be null) */
+    void renderSamples(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples)
+    {
+        // Calculate loop length in samples
+        if (maxBufferSamples == 0)
+        {
+            // Not prepared yet - no tape to play
+            std::fill(outputL, outputL + numSamples, 0.0f);
+            std::fill(outputR, outputR + numSamples, 0.0f);
+            return;
+        }
+
+        const size_t loopSamples = getLoopSamples();
+        for (int start = 0; start < numSamples; start += TAPE_SPAN)
+        {
+            const int n = std::min(numSamples - start, TAPE_SPAN);
+            if (inputL != nullptr)
+                renderSpan(inputL + start, inputR + start, outputL + start, outputR + start, n, loopSamples);
+            else
+                renderSpan(nullptr, nullptr, outputL + start, outputR + start, n, loopSamples);
+        }
+    }
+
+    /**
+     * @brief Up to TAPE_SPAN samples of the loop, one stage at a time
+     *
+     * Each stage runs over the whole span before the next starts, so its
+     * state stays in registers and the plain arithmetic can vectorize:
+     *   1. Source: the modulator bank (character LFO, pan LFO and wobble),
+     *      then sequencers, envelopes and oscillators, plus the external input
+     *   2. Tape: wobble, read and re-record (per sample through the buffer),
+     *      then the play heads' and the grain cloud's reads added to the
+     *      playback
+     *   3. Degradation: saturation, age filter, TapeDust, the Airwindows
+     *      stage (oversampled when set) and the re-recording loss
+     *   4. Output mix
+     * Only the source reaches the recording, so splitting the passes
+     * matches running them per sample.
+     *
+     * The tape and degradation stages are built per LFO target (and the
+     * degradation per tape model too), and picked from a table once per
+     * span, so their loops carry no per-sample switch.
+     */
+    void renderSpan(const float* inputL, const float* inputR, float* outputL, float* outputR,
+                    int numSamples, size_t loopSamples)
+    {
+        float sourceL[TAPE_SPAN];
+        float sourceR[TAPE_SPAN];
+        float lfoMod[TAPE_SPAN];
+        float panLeft[TAPE_SPAN];
+        float panRight[TAPE_SPAN];
+        float wobble[TAPE_SPAN];
+        float playL[TAPE_SPAN];
+        float playR[TAPE_SPAN];
+
+        {
+            TraceRing::Scope scope(trace, "voice", "source", numSamples);
+            modulators.render(lfoMod, panLeft, panRight, wobble, numSamples, lfoDepth, panDepth);
+            renderSource(sourceL, sourceR, panLeft, panRight, numSamples);
+            if (inputL != nullptr)
+            {
+                // Record level and the pan LFO, as the oscillators get; the
+                // quarter-turn gains are 1/sqrt(2) centred, so that's undone
+                const float gain = recordLevel * 1.41421356f;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    sourceL[i] += inputL[i] * gain * panLeft[i];
+                    sourceR[i] += inputR[i] * gain * panRight[i];
+                }
+            }
+        }
+        {
+            TraceRing::Scope scope(trace, "voice", "tape", numSamples);
+            (this->*tapeStage())(sourceL, sourceR, lfoMod, wobble, playL, playR, numSamples, loopSamples);
+        }
+        {
+            TraceRing::Scope scope(trace, "voice", "degradation", numSamples);
+            (this->*degradationStage())(playL, playR, lfoMod, numSamples);
+        }
+
+        // ================================================================
+        // OUTPUT MIX
+        // ================================================================
+        for (int i = 0; i < numSamples; ++i)
+        {
+            outputL[i] = (sourceL[i] * dryLevel + playL[i] * loopOutputLevel) * masterLevel;
+            outputR[i] = (sourceR[i] * dryLevel + playR[i] * loopOutputLevel) * masterLevel;
+        }
+    }
+
+    /** Tape models (setTapeModel) */
+    enum TapeModel { TAPE_BYPASS, TAPE_DUST, TAPE_AIRWINDOWS, TAPE_BOTH, NUM_TAPE_MODELS };
+
+    /** What the character LFO modulates (setLFOTarget) */
+    enum LfoTarget { LFO_SATURATION, LFO_AGE, LFO_WOBBLE, LFO_DEGRADE, NUM_LFO_TARGETS };
+
+    /** Samples a tape model change fades over */
+    static constexpr int MODEL_FADE = TAPE_SPAN;
+
+    static constexpr bool usesDust(int model) { return model == TAPE_DUST || model == TAPE_BOTH; }
+    static constexpr bool usesAirwindows(int model) { return model == TAPE_AIRWINDOWS || model == TAPE_BOTH; }
+
+    /** The Airwindows stage's oversampling for the parameter and the quality tier */
+    int tierOversampling() const { return forTier(quality, 1, oversampling, 4); }
+
+    void applyOversampling()
+    {
+        const int previous = tapeOversampler.getFactor();
+        tapeOversampler.setFactor(tierOversampling());
+        if (tapeOversampler.getFactor() != previous)
+            airwindowsTape.prepare(sampleRate * tapeOversampler.getFactor());
+    }
+
+    using TapeStage = void (TapeLoopEngine::*)(const float*, const float*, const float*, const float*, float*, float*,
+                                               int, size_t);
+    using DegradationStage = void (TapeLoopEngine::*)(float*, float*, const float*, int);
+    using ModelStage = void (TapeLoopEngine::*)(float*, float*, int);
+
+    /** renderTape() for the LFO target */
+    TapeStage tapeStage() const
+    {
+        static constexpr TapeStage STAGES[NUM_LFO_TARGETS] = {
+            &TapeLoopEngine::renderTape<LFO_SATURATION>, &TapeLoopEngine::renderTape<LFO_AGE>,
+            &TapeLoopEngine::renderTape<LFO_WOBBLE>, &TapeLoopEngine::renderTape<LFO_DEGRADE>};
+        return STAGES[lfoTarget];
+    }
+
+    /** renderDegradation() for each LFO target, for one tape model */
+    template <int MODEL>
+    static constexpr std::array<DegradationStage, NUM_LFO_TARGETS> degradationStages()
+    {
+        return {&TapeLoopEngine::renderDegradation<MODEL, LFO_SATURATION>,
+                &TapeLoopEngine::renderDegradation<MODEL, LFO_AGE>,
+                &TapeLoopEngine::renderDegradation<MODEL, LFO_WOBBLE>,
+                &TapeLoopEngine::renderDegradation<MODEL, LFO_DEGRADE>};
+    }
+
+    /** renderDegradation() for the tape model and LFO target */
+    DegradationStage degradationStage() const
+    {
+        static constexpr std::array<std::array<DegradationStage, NUM_LFO_TARGETS>, NUM_TAPE_MODELS> STAGES = {
+            degradationStages<TAPE_BYPASS>(), degradationStages<TAPE_DUST>(),
+            degradationStages<TAPE_AIRWINDOWS>(), degradationStages<TAPE_BOTH>()};
+        return STAGES[static_cast<size_t>(tapeModel)][static_cast<size_t>(lfoTarget)];
+    }
+
+    /** The character LFO's pull on one target (0-1); the others stay put */
+    template <int LFO, int TARGET>
+    static float lfoModulated(float value, [[maybe_unused]] float mod)
+    {
+        if constexpr (LFO == TARGET)
+            return std::clamp(value + mod * 0.5f, 0.0f, 1.0f);
+        else
+            return value;
+    }
+
+    /** Stage 1: the oscillators to record, panned by the span's pan LFO gains */
+    void renderSource(float* sourceL, float* sourceR, const float* panLeft, const float* panRight, int numSamples)
+    {
+        // Samples left before either sequencer can step again. Runs end with
+        // the span, so each span picks up new tuning from the setters
+        int seqRun = 0;
+        bool seq1Gate = true, seq2Gate = true;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // ================================================================
+            // SEQUENCERS (one per oscillator)
+            // ================================================================
+            if (seqEnabled)
+            {
+                // Pitch and gate only change on a step, so they're applied
+                // once at the start of each run up to the next boundary
+                if (seqRun == 0)
+                {
+                    seqRun = std::min({numSamples - i, sequencer1.nextRunLength(), sequencer2.nextRunLength()});
+                    sequencer1.advance(seqRun);
+                    sequencer2.advance(seqRun);
+
+                    seq1Gate = sequencer1.getCurrentGate();
+                    seq2Gate = sequencer2.getCurrentGate();
+
+                    // Set oscillator frequencies from sequencer
+                    float freq1 = StepSequencer::midiToFrequency(sequencer1.getCurrentPitch());
+                    freq1 *= osc1TuneRatio;
+                    osc1.setFrequency(freq1, sampleRate);
+
+                    float freq2 = StepSequencer::midiToFrequency(sequencer2.getCurrentPitch());
+                    freq2 *= osc2TuneRatio;
+                    osc2.setFrequency(freq2, sampleRate);
+                }
+                --seqRun;
+            }
+
+            // ================================================================
+            // ENVELOPES
+            // ================================================================
+            float envLevel = recordEnvelope.process();
+            float osc1EnvLevel = osc1ADSR.process();
+            float osc2EnvLevel = osc2ADSR.process();
+
+            // ================================================================
+            // OSCILLATORS (source material) with FM and ADSR
+            // ================================================================
+            float oscOutL = 0.0f;
+            float oscOutR = 0.0f;
+
+            // Sequencer plays automatically when enabled (no MIDI required)
+            // MIDI input still works for manual playing
+            bool shouldPlay = seqEnabled || isRecording || recordEnvelope.isActive() ||
+                              osc1ADSR.isActive() || osc2ADSR.isActive();
+
+            if (shouldPlay)
+            {
+                // Apply sequencer gates (if sequencer enabled)
+                float osc1GateLevel = (!seqEnabled || seq1Gate) ? 1.0f : 0.0f;
+                float osc2GateLevel = (!seqEnabled || seq2Gate) ? 1.0f : 0.0f;
+
+                // Apply ADSR envelopes to oscillators
+                // When sequencer is enabled, use gate level; otherwise use ADSR
+                float osc1AmpMod = seqEnabled ? osc1GateLevel : (osc1GateLevel * osc1EnvLevel);
+                float osc2AmpMod = seqEnabled ? osc2GateLevel : (osc2GateLevel * osc2EnvLevel);
+
+                // Generate oscillator 1 (carrier or modulator depending on FM)
+                float osc1Out = osc1.process(osc1Waveform) * osc1Level * osc1AmpMod;
+
+                // Calculate FM modulation from osc1 to osc2
+                float fmMod = osc1Out * fmAmount * 0.1f;  // Scale FM index
+
+                // Generate oscillator 2 with FM modulation
+                float osc2Out = osc2.process(osc2Waveform, fmMod) * osc2Level * osc2AmpMod;
+
+                // When sequencer is playing, use full level; otherwise use envelope
+                float levelMod = seqEnabled ? recordLevel : (currentVelocity * recordLevel * envLevel);
+                float oscMono = (osc1Out + osc2Out) * levelMod;
+
+                // Apply pan LFO to create stereo output for recording
+                oscOutL = oscMono * panLeft[i];
+                oscOutR = oscMono * panRight[i];
+            }
+
+            sourceL[i] = oscOutL;
+            sourceR[i] = oscOutR;
+        }
+    }
+
+    /** Stage 2: play the loop back and record the source over it */
+    template <int LFO>
+    void renderTape(const float* sourceL, const float* sourceR, const float* lfoMod, const float* wobble,
+                    float* playL, float* playR, int numSamples, size_t loopSamples)
+    {
+        // ================================================================
+        // TAPE LOOP - Read positions with wobble + VOICE FM, for the span
+        // ================================================================
+        float readPos[TAPE_SPAN];
+        float transport[TAPE_SPAN];  // Wobble and voice FM, which move every head
+        const size_t spanStart = writePos;
+        size_t pos = writePos;
+
+        // Off 1x the read drifts from the write by (1 - speed) a sample
+        const float speed = tapeReverse ? -tapeSpeed : tapeSpeed;
+        const float lag = static_cast<float>(readDrift);
+        const float lagPerSample = 1.0f - speed;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Wobbled read position (wow/flutter effect)
+            float modulatedWobbleDepth = lfoModulated<LFO, LFO_WOBBLE>(wobbleDepth, lfoMod[i]);
+            float wobbleOffset = wobble[i] * modulatedWobbleDepth * 100.0f;
+
+            // VOICE FM TO LOOP: oscillator output modulates tape read position
+            // This creates wild pitch-shifting effects - the voice "plays" the tape
+            // voiceLoopFM scales the oscillator output to samples offset (up to ~1000 samples)
+            float oscMono = (sourceL[i] + sourceR[i]) * 0.5f;  // Use mono for FM calculation
+            float voiceFMOffset = oscMono * voiceLoopFM * 1000.0f;
+
+            // Read position with wobble + voice FM (fractional for interpolation)
+            readPos[i] = static_cast<float>(pos) - wobbleOffset - voiceFMOffset
+                       - (lag + lagPerSample * static_cast<float>(i));
+            transport[i] = wobbleOffset + voiceFMOffset;
+            pos = (pos + 1) % loopSamples;
+        }
+        readHead.setLoop(loopSamples);
+        readHead.wrapBlock(readPos, numSamples);
+        if (speed != 1.0f)
+            readDrift = std::fmod(readDrift + static_cast<double>(lagPerSample) * numSamples,
+                                  static_cast<double>(loopSamples));
+
+        const int16_t* tapeL16 = tapeBufferL.data();
+        const int16_t* tapeR16 = tapeBufferR.data();
+
+        // A snapshot being read out keeps what this span is about to overwrite
+        tapeSnapshot.record(tapeL16, tapeR16, writePos, static_cast<size_t>(numSamples), loopSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // The FM-offset read is both the playback and the feedback, so
+            // playing modulates what gets recorded. Reads interleave with the
+            // writes: a short offset reads what this span just recorded.
+            float tapeL = readHead.read(tapeL16, readPos[i], speed) * (1.0f / TAPE_SCALE);
+            float tapeR = readHead.read(tapeR16, readPos[i], speed) * (1.0f / TAPE_SCALE);
+
+            playL[i] = tapeL;
+            playR[i] = tapeR;
+
+            // ================================================================
+            // TAPE LOOP - Write (overdub with feedback + voice FM + pan)
+            // ================================================================
+
+            // Reduce feedback based on degradation (tape wears out)
+            float effectiveFeedback = loopFeedback * (1.0f - lfoModulated<LFO, LFO_DEGRADE>(tapeDegrade, lfoMod[i]) * 0.15f);
+
+            // Wear on record: this generation's loss goes onto the tape
+            float feedbackL = tapeL;
+            float feedbackR = tapeR;
+            if (wearOnRecord)
+            {
+                wearSample<LFO>(feedbackL, feedbackR, lfoMod[i], true);
+                reRecordSample<LFO>(feedbackL, feedbackR, lfoMod[i]);
+            }
+
+            // Mix feedback and new stereo input with pan
+            float newL = feedbackL * effectiveFeedback + sourceL[i];
+            float newR = feedbackR * effectiveFeedback + sourceR[i];
+
+            // Soft limit to prevent runaway
+            newL = FastMath::tanh(newL);
+            newR = FastMath::tanh(newR);
+
+            // tanh keeps the value in range for the 16-bit tape
+            tapeBufferL[writePos] = static_cast<int16_t>(std::lrint(newL * TAPE_SCALE));
+            tapeBufferR[writePos] = static_cast<int16_t>(std::lrint(newR * TAPE_SCALE));
+
+            // Advance write position
+            writePos = (writePos + 1) % loopSamples;
+        }
+
+        renderPlayHeads(spanStart, transport, playL, playR, numSamples, loopSamples);
+        if (grains.isActive())
+            grains.render(readHead, tapeL16, tapeR16, spanStart, transport, playL, playR, numSamples, loopSamples,
+                          1.0f / TAPE_SCALE);
+    }
+
+    /**
+     * @brief The play heads' reads of the span, added to the record head's
+     *
+     * Every playing head's positions go into one array and are wrapped in
+     * one pass; then each head reads a block. They read after the span's
+     * writes, so a head with no offset hears what the record head just laid
+     * down.
+     */
+    void renderPlayHeads(size_t spanStart, const float* transport, float* playL, float* playR, int numSamples,
+                         size_t loopSamples)
+    {
+        float positions[NUM_PLAY_HEADS * TAPE_SPAN];
+        const PlayHead* playing[NUM_PLAY_HEADS];
+        int numPlaying = 0;
+        const double loop = static_cast<double>(loopSamples);
+
+        for (auto& head : playHeads)
+        {
+            if (head.level <= 0.0f)
+                continue;
+
+            // The head's place on the tape at the span's first sample
+            double start = static_cast<double>(spanStart) - head.offset * loop - head.drift;
+            start -= loop * std::floor(start / loop);
+            const float first = static_cast<float>(start);
+
+            float* p = positions + numPlaying * numSamples;
+            for (int i = 0; i < numSamples; ++i)
+                p[i] = first + head.speed * static_cast<float>(i) - transport[i];
+
+            // Off speed, the head drifts against the tape
+            head.drift = std::fmod(head.drift + (1.0 - head.speed) * numSamples, loop);
+            playing[numPlaying++] = &head;
+        }
+        if (numPlaying == 0)
+            return;
+
+        readHead.wrapBlock(positions, numPlaying * numSamples);
+        for (int h = 0; h < numPlaying; ++h)
+        {
+            const PlayHead& head = *playing[h];
+            const float* p = positions + h * numSamples;
+            const float gain = head.level * (1.0f / TAPE_SCALE);
+            readHead.readBlock(tapeBufferL.data(), p, gain * std::min(1.0f, 1.0f - head.pan), playL, numSamples,
+                               head.speed);
+            readHead.readBlock(tapeBufferR.data(), p, gain * std::min(1.0f, 1.0f + head.pan), playR, numSamples,
+                               head.speed);
+        }
+    }
+
+    /** Stage 3: everything the playback goes through on its way out, in place */
+    template <int MODEL, int LFO>
+    void renderDegradation(float* playL, float* playR, const float* lfoMod, int numSamples)
+    {
+        // ================================================================
+        // TAPE DEGRADATION (already on the tape when worn on record)
+        // ================================================================
+        if (!wearOnRecord)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                wearSample<LFO>(playL[i], playR[i], lfoMod[i], false);
+        }
+
+        // ================================================================
+        // TAPE MODEL PROCESSING
+        // ================================================================
+        // 0 = Bypass, 1 = TapeDust only, 2 = Airwindows only, 3 = Both
+
+        if (modelFadePos < MODEL_FADE)
+        {
+            fadeModelStage(usesDust(fadeFromModel), usesDust(MODEL), &TapeLoopEngine::runTapeDust,
+                           playL, playR, numSamples);
+            fadeModelStage(usesAirwindows(fadeFromModel), usesAirwindows(MODEL), &TapeLoopEngine::runAirwindows,
+                           playL, playR, numSamples);
+            modelFadePos += numSamples;
+        }
+        else
+        {
+            if constexpr (usesDust(MODEL))
+                runTapeDust(playL, playR, numSamples);
+            if constexpr (usesAirwindows(MODEL))
+                runAirwindows(playL, playR, numSamples);
+        }
+
+        // ================================================================
+        // SELF-RE-RECORDING DEGRADATION
+        // ================================================================
+        // Simulate tape continuously re-recording itself:
+        // - Each pass loses high frequencies
+        // - Each pass adds subtle saturation
+        // - Higher degrade = faster quality loss
+
+        if (!wearOnRecord)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                reRecordSample<LFO>(playL[i], playR[i], lfoMod[i]);
+        }
+    }
+
+    void runTapeDust(float* playL, float* playR, int numSamples)
+    {
+        tapeDust.setRange(tapeHiss);
+        tapeDust.setMix(tapeHiss * 0.3f);
+        tapeDust.processBlock(playL, playR, numSamples);
+    }
+
+    /** The Airwindows stage, oversampled when set */
+    void runAirwindows(float* playL, float* playR, int numSamples)
+    {
+        tapeOversampler.process(playL, playR, numSamples, [this](float* l, float* r, int n) {
+            airwindowsTape.processBlock(l, r, n);
+        });
+    }
+
+    /**
+     * @brief One tape model stage while a model change fades
+     *
+     * A stage the change switches on fades in from the dry signal, one it
+     * switches off fades out to it; either way it runs once, so its state
+     * carries on. Stages the change leaves alone run as usual.
+     */
+    void fadeModelStage(bool wasOn, bool isOn, ModelStage stage, float* playL, float* playR, int numSamples)
+    {
+        if (!wasOn && !isOn)
+            return;
+        if (wasOn == isOn)
+        {
+            (this->*stage)(playL, playR, numSamples);
+            return;
+        }
+
+        float dryL[TAPE_SPAN];
+        float dryR[TAPE_SPAN];
+        std::copy(playL, playL + numSamples, dryL);
+        std::copy(playR, playR + numSamples, dryR);
+        (this->*stage)(playL, playR, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = std::min(static_cast<float>(modelFadePos + i + 1) * (1.0f / MODEL_FADE), 1.0f);
+            const float wet = isOn ? in : 1.0f - in;
+            playL[i] = dryL[i] + (playL[i] - dryL[i]) * wet;
+            playR[i] = dryR[i] + (playR[i] - dryR[i]) * wet;
+        }
+    }
+
+    /**
+     * @brief Saturation and the age lowpass, on playback or on the feedback
+     *
+     * Playback saturation is normalised so full scale stays full scale,
+     * which lifts quiet signals. In the feedback that lift would be loop
+     * gain, so on record it's normalised to unity gain for small signals
+     * and only squashes the peaks.
+     */
+    template <int LFO>
+    void wearSample(float& l, float& r, float lfo, bool onRecord)
+    {
+        // Saturation (tanh soft clipping)
+        float satAmount = lfoModulated<LFO, LFO_SATURATION>(saturation, lfo) * 4.0f + 1.0f;
+        float satNorm = onRecord ? satAmount : FastMath::tanh(satAmount);
+        float tapeL = FastMath::tanh(l * satAmount) / satNorm;
+        float tapeR = FastMath::tanh(r * satAmount) / satNorm;
+
+        // Age filter (lowpass that simulates high frequency loss)
+        // Higher age = lower cutoff
+        float ageCutoff = 1.0f - (lfoModulated<LFO, LFO_AGE>(tapeAge, lfo) * 0.9f);  // 1.0 to 0.1
+        float ageCoeff = ageCutoff * ageCutoff;                            // More aggressive curve
+
+        ageFilterStateL += ageCoeff * (tapeL - ageFilterStateL);
+        ageFilterStateR += ageCoeff * (tapeR - ageFilterStateR);
+
+        l = ageFilterStateL;
+        r = ageFilterStateR;
+    }
+
+    /** Re-recording loss: the degrade lowpass and a rising noise floor */
+    template <int LFO>
+    void reRecordSample(float& l, float& r, float lfo)
+    {
+        const float modulatedDegrade = lfoModulated<LFO, LFO_DEGRADE>(tapeDegrade, lfo);
+        if (modulatedDegrade <= 0.0f)
+            return;
+
+        // Progressive lowpass - simulates magnetic medium losing highs
+        float degradeCoeff = 1.0f - (modulatedDegrade * 0.3f);  // 1.0 to 0.7
+        degradeFilterStateL += degradeCoeff * (l - degradeFilterStateL);
+        degradeFilterStateR += degradeCoeff * (r - degradeFilterStateR);
+
+        // Blend degraded signal based on degrade amount
+        float degradeMix = modulatedDegrade * 0.5f;
+        float tapeL = l * (1.0f - degradeMix) + degradeFilterStateL * degradeMix;
+        float tapeR = r * (1.0f - degradeMix) + degradeFilterStateR * degradeMix;
+
+        // Add subtle noise accumulation (tape noise floor rises)
+        float degradeNoise = rng.unifPM1() * modulatedDegrade * 0.005f;
+        l = tapeL + degradeNoise;
+        r = tapeR + degradeNoise;
+    }
+
+    /**
+     * @brief Effects chain: Delay -> Reverb -> Convolver -> Compressor, in place
+     *
+     * Runs over the sub-block after renderSamples(). Nothing from the effects
+     * is recorded back to tape, so this matches running them per sample.
+     * An effect whose input has been silent for its whole tail is skipped;
+     * one that runs may ring, so the next one hears it.
+     */
+    void renderEffects(float* outputL, float* outputR, int numSamples)
+    {
+        if (maxBufferSamples == 0)
+            return;
+
+        bool silent = Silence::isSilent(outputL, outputR, numSamples);
+
+        // Lazy effects without their lines pass the input through
+        const bool delayReady = delay.update(numSamples);
+        if (delayGate.process(silent, numSamples, delay->getTailSamples()) && delayReady)
+        {
+            TraceRing::Scope scope(trace, "effect", "delay", numSamples);
+            delay.process(outputL, outputR, numSamples);
+            silent = false;
+        }
+
+        const bool reverbReady = reverb.update(numSamples);
+        if (reverbGate.process(silent, numSamples, reverb->getTailSamples()) && reverbReady)
+        {
+            TraceRing::Scope scope(trace, "effect", "reverb", numSamples);
+            reverb.process(outputL, outputR, numSamples);
+            silent = false;
+        }
+
+        if (convolverGate.process(silent, numSamples, convolver.getTailSamples()))
+        {
+            TraceRing::Scope scope(trace, "effect", "convolver", numSamples);
+            convolver.processBlock(outputL, outputR, numSamples);
+            silent = false;
+        }
+
+        // Silence in is silence out: the compressor's tail is only its gain
+        // recovering, so it never wakes the output
+        if (compressorGate.process(silent, numSamples, compressor.getTailSamples()))
+        {
+            TraceRing::Scope scope(trace, "effect", "compressor", numSamples);
+            compressor.processBlock(outputL, outputR, numSamples);
+        }
+
+        silentBlock = silentBlock && silent;
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn:
+        {
+            TraceRing::Scope scope(trace, "midi", "noteOn", event.note);
+            noteOn(event.note, event.value);
+            break;
+        }
+        case MidiEvent::Type::NoteOff:
+        {
+            TraceRing::Scope scope(trace, "midi", "noteOff", event.note);
+            noteOff(event.note);
+            break;
+        }
+        case MidiEvent::Type::AllNotesOff:
+        {
+            TraceRing::Scope scope(trace, "midi", "allNotesOff");
+            allNotesOff();
+            break;
+        }
+        default: break;
+        }
+    }
+
     //==========================================================================
     // Internal Helpers
     //==========================================================================
@@ -1168,16 +2025,25 @@ private:
     void updateOscillatorFrequencies(float baseFreq)
     {
         baseFrequency = baseFreq;
+        updateTuneRatios();
 
         // Oscillator 1 with tune
-        double freq1 = baseFreq * std::pow(2.0f, osc1Tune / 12.0f);
+        double freq1 = baseFreq * osc1TuneRatio;
         osc1.setFrequency(freq1, sampleRate);
 
         // Oscillator 2 with tune and detune
-        double freq2 = baseFreq * std::pow(2.0f, (osc2Tune + osc2Detune / 100.0f) / 12.0f);
+        double freq2 = baseFreq * osc2TuneRatio;
         osc2.setFrequency(freq2, sampleRate);
     }
 
+    /** Cache the tune/detune ratios the sequencers apply every sample */
+    void updateTuneRatios()
+    {
+        const PitchTables& pitch = PitchTables::get();
+        osc1TuneRatio = pitch.semitonesToRatio(osc1Tune);
+        osc2TuneRatio = pitch.semitonesToRatio(osc2Tune + osc2Detune / 100.0f);
+    }
+
     //==========================================================================
     // Oscillators
     //==========================================================================
@@ -1189,16 +2055,38 @@ private:
     // Tape Buffer
     //==========================================================================
 
-    std::vector<float> tapeBufferL;
-    std::vector<float> tapeBufferR;
+    // Stored as 16-bit samples - half the memory of float, and the loop
+    // is tanh limited so it never leaves [-1, 1]
+    std::vector<int16_t> tapeBufferL;
+    std::vector<int16_t> tapeBufferR;
     size_t writePos = 0;
     size_t maxBufferSamples = 0;
+    float maxLoopSeconds = MAX_LOOP_SECONDS;
 
-    //==========================================================================
-    // Wobble LFO
-    //==========================================================================
+    TapeReadHead readHead;
+    TapeSnapshot tapeSnapshot;
+    float tapeSpeed = 1.0f;
+    bool tapeReverse = false;
+    double readDrift = 0.0;  // Samples the record head's read has fallen behind the write, off 1x
+
+    struct PlayHead
+    {
+        float level = 0.0f;
+        float offset = 0.5f;  // Fraction of the loop behind the record head
+        float speed = 1.0f;
+        float pan = 0.0f;
+        double drift = 0.0;   // Samples it has fallen behind its offset, off speed
+    };
+
+    std::array<PlayHead, NUM_PLAY_HEADS> playHeads{{{0.0f, 0.25f}, {0.0f, 0.5f}, {0.0f, 0.75f}}};
 
-    float wobblePhase = 0.0f;
+    PlayHead* playHead(int head)
+    {
+        return head >= 0 && head < NUM_PLAY_HEADS ? &playHeads[static_cast<size_t>(head)] : nullptr;
+    }
+
+    static_assert(TAPE_SPAN <= TapeGrains::MAX_SPAN, "a span must fit the grains' buffers");
+    TapeGrains grains;
 
     //==========================================================================
     // Age Filter State
@@ -1211,19 +2099,32 @@ private:
     // Noise Generator
     //==========================================================================
 
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> noiseDist;
+    NoiseSource rng;
 
     //==========================================================================
     // Engine State
     //==========================================================================
 
-    float sampleRate = 44100.0f;
+    float sampleRate = 44100.0f;  // The engine's: the render rate, if one is set
+
+    /** Resamples to the host's rate when the engine runs at a render rate */
+    FixedRateRenderer fixedRate;
+    double renderRate = 0.0;  // 0: the host's rate
+
     float baseFrequency = 110.0f;
     bool isRecording = false;
     float currentVelocity = 0.0f;
     int activeNote = -1;  // For legato/drone behavior
 
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
+    /** Stage timeline, drained by the processor's TraceDumper */
+    TraceRing trace;
+
     //==========================================================================
     // Parameters
     //==========================================================================
@@ -1239,6 +2140,10 @@ private:
     float osc2Detune = 7.0f;
     float osc2Level = 0.5f;
 
+    // 2^(tune / 12), from updateTuneRatios()
+    float osc1TuneRatio = 1.0f;
+    float osc2TuneRatio = 1.0f;
+
     // Tape Loop
     float loopLength = 4.0f;
     float loopFeedback = 0.85f;
@@ -1246,7 +2151,6 @@ private:
 
     // Tape Character
     float saturation = 0.3f;
-    float wobbleRate = 0.5f;
     float wobbleDepth = 0.2f;
 
     // Tape Noise
@@ -1268,14 +2172,19 @@ private:
     float tapeDegrade = 0.0f;
     float degradeFilterStateL = 0.0f;
     float degradeFilterStateR = 0.0f;
+    bool wearOnRecord = false;  // Degradation baked into the tape per generation
 
     // Tape Model Selection
     int tapeModel = 3;  // 0=bypass, 1=TapeDust, 2=Airwindows, 3=both
+    int fadeFromModel = 3;          // The model a change fades from...
+    int modelFadePos = MODEL_FADE;  // ...and how far it has got (MODEL_FADE: done)
     float tapeDrive = 0.5f;  // Airwindows input gain (0.5 = 0dB)
     float tapeBump = 0.0f;   // Airwindows head bump
 
+    // Character LFO, pan LFO and wobble, one bank
+    TapeModulators modulators;
+
     // Tape Character LFO
-    SimpleLFO tapeCharLFO;
     float lfoDepth = 0.0f;
     int lfoTarget = 0;  // 0=saturation, 1=age, 2=wobble, 3=degrade
 
@@ -1287,6 +2196,12 @@ private:
     StepSequencer sequencer2;  // Controls Osc 2
     bool seqEnabled = false;
 
+    // Host transport (setTransport)
+    bool hostPlaying = false;
+    bool hostTempoChanged = false;
+    double hostTempo = 120.0;
+    double hostBeats = 0.0;
+
     //==========================================================================
     // ADSR Envelopes (one per oscillator)
     //==========================================================================
@@ -1309,9 +2224,7 @@ private:
     // Pan LFO (for stereo loop recording)
     //==========================================================================
 
-    SimpleLFO panLFO;
-    float panSpeed = 0.5f;    // Hz
-    float panDepth = 0.0f;    // 0-1
+    float panDepth = 0.0f;    // 0-1 (the rate is in modulators)
 
     //==========================================================================
     // Voice to Loop FM
@@ -1323,9 +2236,24 @@ private:
     // Effects
     //==========================================================================
 
-    StereoDelay delay;
-    Galactic3Reverb reverb;
+    LazyEffect<StereoDelay> delay;
+    LazyEffect<std::conditional_t<ReferenceDsp::ENABLED, Galactic3Reverb, Galactic3ReverbPacked>> reverb;
+    bool lazyEffects = false;  // Next prepare(): lines only while on
+    Convolver convolver;
     Compressor compressor;
+
+    // Effect bypass once the input and the tail have died away
+    TailGate delayGate;
+    TailGate reverbGate;
+    TailGate convolverGate;
+    TailGate compressorGate;
+    bool silentBlock = true;  // Last renderBlock() was silent
     TapeDust tapeDust;  // Slew-dependent tape hiss
     AirwindowsTape airwindowsTape;  // Tape saturation and head bump
+    Oversampler tapeOversampler;    // Around airwindowsTape only
+
+    // The parameters the quality tier can override (setQualityTier)
+    QualityTier quality = QualityTier::Normal;
+    int tapeInterpolation = TapeReadHead::Linear;
+    int oversampling = 1;
 };
@@ -0,0 +1,305 @@
+/**
+ * @file TapeReadHead.h
+ * @brief Fractional read head for the 16-bit tape loop: linear, Hermite or sinc
+ *
+ * The tape loop is an arbitrary length (loop_length seconds of samples), so
+ * read positions can't be wrapped with a power-of-two mask. TapeReadHead
+ * wraps them without loops or branches instead: a whole block of positions
+ * is reduced with one floor() each, in a loop the compiler vectorises, and
+ * the integer tap indices are folded back with selects.
+ *
+ * Three interpolation orders, chosen with the Tape Interpolation parameter:
+ *
+ * - Linear: two taps. The loop's original read, and the default.
+ * - Hermite: four-point, third-order (Catmull-Rom). Flatter top end than
+ *   linear when the wobble or voice FM bends the pitch.
+ * - Sinc: twelve-tap windowed sinc over 256 fractional phases, the same
+ *   table sst-basic-blocks' SSESincDelayLine reads (SurgeSincTableProvider's
+ *   sinctable1X: Blackman window, 0.85 cutoff). SSESincDelayLine itself
+ *   needs its own power-of-two float ring and the web build doesn't vendor
+ *   sst, so the table is computed here, at compile time (ConstexprTables.h),
+ *   and read from the int16 tape.
+ *
+ * Taps are read straight from the tape when they don't straddle the loop
+ * point (nearly always), so the tap conversion and the dot product are
+ * fixed-length loops that compile to SIMD. Only reads across the loop point
+ * gather through wrapped indices.
+ *
+ *   head.setLoop(loopSamples);                  // Each block
+ *   head.wrapBlock(positions, n);                // n positions into [0, loop)
+ *   float s = head.read(tape, positions[i]);     // In tape units (int16 scale)
+ *
+ * Reads return tape units, not [-1, 1]: the caller scales once, as it
+ * already does for the write.
+ *
+ * readBlock() reads a whole block of wrapped positions into an accumulator,
+ * choosing the interpolation once for the block instead of per read. The
+ * engine's play heads use it. Their reads don't interleave with the writes.
+ *
+ * Varispeed: a head moving through the tape faster than 1x would alias
+ * whichever order reads it, so reads given a speed above 1 (either way)
+ * go through the sinc table stretched by the speed instead. The cutoff
+ * drops below the faster read's Nyquist, and the kernel widens to
+ * SINC_TAPS x speed taps (48 at MAX_SPEED). At 1x and below, the reads
+ * keep the chosen order and cost.
+ *
+ *   float s = head.read(tape, positions[i], speed);  // Speed -4 to 4
+ *
+ * @note No allocation: real-time safe. The sinc table is read-only data.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ConstexprTables.h"
+
+class TapeReadHead
+{
+public:
+    enum Interpolation
+    {
+        Linear = 0,
+        Hermite,
+        Sinc,
+        NumInterpolations
+    };
+
+    static constexpr int SINC_PHASES = 256;
+    static constexpr int SINC_TAPS = 12;
+
+    /** Fastest varispeed read, either way; the stretched kernel's widest */
+    static constexpr float MAX_SPEED = 4.0f;
+    static constexpr int MAX_SPEED_TAPS = SINC_TAPS * static_cast<int>(MAX_SPEED);
+
+    /** Bytes of the sinc kernel table every read head shares */
+    static constexpr size_t SINC_TABLE_BYTES = sizeof(float) * (SINC_PHASES + 1) * SINC_TAPS;
+
+    TapeReadHead() { setLoop(1); }
+
+    void setInterpolation(int mode) { interpolation = std::clamp(mode, 0, NumInterpolations - 1); }
+
+    int getInterpolation() const { return interpolation; }
+
+    /** Loop length in samples (at least 1) */
+    void setLoop(size_t loopSamples)
+    {
+        loop = static_cast<int64_t>(std::max<size_t>(loopSamples, 1));
+        loopF = static_cast<float>(loop);
+        invLoop = 1.0f / loopF;
+    }
+
+    /** Wrap n read positions into [0, loop) in place */
+    void wrapBlock(float* positions, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            float p = positions[i] - loopF * std::floor(positions[i] * invLoop);
+            // invLoop is rounded, so floor() can land one loop off at the edges
+            p = p >= loopF ? p - loopF : p;
+            p = p < 0.0f ? p + loopF : p;
+            p = p >= loopF ? 0.0f : p;  // -tiny + loop rounds up to loop
+            positions[i] = p;
+        }
+    }
+
+    /** Interpolated tape value at a wrapped position, in tape units */
+    float read(const int16_t* tape, float position) const
+    {
+        const float base = std::floor(position);
+        const float frac = position - base;
+        const int64_t i0 = static_cast<int64_t>(base);
+
+        switch (interpolation)
+        {
+            case Hermite: return readHermite(tape, i0, frac);
+            case Sinc: return readSinc(tape, i0, frac);
+            default: return readLinear(tape, i0, frac);
+        }
+    }
+
+    /** As read(), for a head moving speed samples of tape per sample: band-limited above 1x */
+    float read(const int16_t* tape, float position, float speed) const
+    {
+        const float stretch = std::min(std::abs(speed), MAX_SPEED);
+        if (stretch <= 1.0f)
+            return read(tape, position);
+
+        const float base = std::floor(position);
+        return readStretched(tape, static_cast<int64_t>(base), position - base, stretch);
+    }
+
+    /** Add gain times the tape at each of n wrapped positions to out, for a head at speed */
+    void readBlock(const int16_t* tape, const float* positions, float gain, float* out, int n,
+                   float speed = 1.0f) const
+    {
+        const float stretch = std::min(std::abs(speed), MAX_SPEED);
+        if (stretch > 1.0f)
+        {
+            accumulate<NumInterpolations>(tape, positions, gain, out, n, stretch);
+            return;
+        }
+
+        switch (interpolation)
+        {
+            case Hermite: accumulate<Hermite>(tape, positions, gain, out, n); break;
+            case Sinc: accumulate<Sinc>(tape, positions, gain, out, n); break;
+            default: accumulate<Linear>(tape, positions, gain, out, n); break;
+        }
+    }
+
+private:
+    /** MODE NumInterpolations: the stretched kernel */
+    template <int MODE>
+    void accumulate(const int16_t* tape, const float* positions, float gain, float* out, int n,
+                    [[maybe_unused]] float stretch = 1.0f) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const float base = std::floor(positions[i]);
+            const float frac = positions[i] - base;
+            const int64_t i0 = static_cast<int64_t>(base);
+
+            float s;
+            if constexpr (MODE == NumInterpolations)
+                s = readStretched(tape, i0, frac, stretch);
+            else if constexpr (MODE == Hermite)
+                s = readHermite(tape, i0, frac);
+            else if constexpr (MODE == Sinc)
+                s = readSinc(tape, i0, frac);
+            else
+                s = readLinear(tape, i0, frac);
+            out[i] += gain * s;
+        }
+    }
+
+    /** Fold an index at most one loop out of range back in */
+    int64_t fold(int64_t i) const
+    {
+        i = i < 0 ? i + loop : i;
+        return i >= loop ? i - loop : i;
+    }
+
+    /** Fetch taps [first, first + count) as floats, wrapping round the loop */
+    void gather(const int16_t* tape, int64_t first, int count, float* out) const
+    {
+        if (first >= 0 && first + count <= loop)
+        {
+            for (int k = 0; k < count; ++k)
+                out[k] = static_cast<float>(tape[first + k]);
+        }
+        else if (loop >= count)
+        {
+            for (int k = 0; k < count; ++k)
+                out[k] = static_cast<float>(tape[fold(first + k)]);
+        }
+        else
+        {
+            // A loop shorter than the kernel wraps more than once
+            for (int k = 0; k < count; ++k)
+                out[k] = static_cast<float>(tape[((first + k) % loop + loop) % loop]);
+        }
+    }
+
+    template <int Count>
+    void gather(const int16_t* tape, int64_t first, float* out) const
+    {
+        gather(tape, first, Count, out);
+    }
+
+    float readLinear(const int16_t* tape, int64_t i0, float frac) const
+    {
+        const float a = static_cast<float>(tape[i0]);
+        const float b = static_cast<float>(tape[fold(i0 + 1)]);
+        return a + (b - a) * frac;
+    }
+
+    float readHermite(const int16_t* tape, int64_t i0, float frac) const
+    {
+        float x[4];
+        gather<4>(tape, i0 - 1, x);
+
+        const float c1 = 0.5f * (x[2] - x[0]);
+        const float c2 = x[0] - 2.5f * x[1] + 2.0f * x[2] - 0.5f * x[3];
+        const float c3 = 0.5f * (x[3] - x[0]) + 1.5f * (x[1] - x[2]);
+        return ((c3 * frac + c2) * frac + c1) * frac + x[1];
+    }
+
+    float readSinc(const int16_t* tape, int64_t i0, float frac) const
+    {
+        // Tap k sits at i0 - 5 + k; row j is centred on i0 + j / SINC_PHASES
+        alignas(16) float x[SINC_TAPS];
+        gather<SINC_TAPS>(tape, i0 - (SINC_TAPS / 2 - 1), x);
+
+        const int phase = std::min(static_cast<int>(frac * SINC_PHASES), SINC_PHASES - 1);
+        const float* kernel = sincTable().data() + phase * SINC_TAPS;
+
+        float sum = 0.0f;
+        for (int k = 0; k < SINC_TAPS; ++k)
+            sum += x[k] * kernel[k];
+        return sum;
+    }
+
+    /**
+     * The sinc kernel stretched by stretch (1 to MAX_SPEED): tap k sits at
+     * i0 - half + 1 + k, and its weight is the table's at the tap's distance
+     * divided by stretch. The weights are normalised, so DC passes at unity
+     * whatever the phase rounding.
+     */
+    float readStretched(const int16_t* tape, int64_t i0, float frac, float stretch) const
+    {
+        const int half = static_cast<int>(std::ceil(static_cast<float>(SINC_TAPS / 2) * stretch));
+        const int taps = 2 * half;
+        alignas(16) float x[MAX_SPEED_TAPS];
+        gather(tape, i0 - (half - 1), taps, x);
+
+        const SincTable& table = sincTable();
+        const float scale = 1.0f / stretch;
+        float sum = 0.0f;
+        float norm = 0.0f;
+        for (int k = 0; k < taps; ++k)
+        {
+            // Table row j, column c holds the kernel at (SINC_TAPS / 2 - 1 - c) + j / SINC_PHASES
+            const float d = (static_cast<float>(half - 1 - k) + frac) * scale;
+            const float whole = std::floor(d);
+            const int column = SINC_TAPS / 2 - 1 - static_cast<int>(whole);
+            if (column < 0 || column >= SINC_TAPS)
+                continue;
+            const int phase = std::min(static_cast<int>((d - whole) * SINC_PHASES), SINC_PHASES - 1);
+            const float w = table[static_cast<size_t>(phase * SINC_TAPS + column)];
+            sum += x[k] * w;
+            norm += w;
+        }
+        return norm != 0.0f ? sum / norm : 0.0f;
+    }
+
+    using SincTable = std::array<float, (SINC_PHASES + 1) * SINC_TAPS>;
+
+    /** SurgeSincTableProvider::sinctable1X, computed at compile time and shared */
+    static const SincTable& sincTable()
+    {
+        static constexpr SincTable table = ConstexprTables::make<float, (SINC_PHASES + 1) * SINC_TAPS>([](size_t k) {
+            constexpr double PI = ConstexprTables::PI;
+            constexpr double CUTOFF = 0.85;
+            const int j = static_cast<int>(k) / SINC_TAPS;
+            const int i = static_cast<int>(k) % SINC_TAPS;
+            const double x = -i + SINC_TAPS / 2.0 + static_cast<double>(j) / SINC_PHASES - 1.0;
+            const double w = x - SINC_TAPS / 2;
+            const double window = 0.42 - 0.5 * ConstexprTables::cos(2.0 * PI * w / SINC_TAPS)
+                                + 0.08 * ConstexprTables::cos(4.0 * PI * w / SINC_TAPS);
+            const double arg = CUTOFF * x;
+            const double sinc = arg == 0.0 ? 1.0 : ConstexprTables::sin(PI * arg) / (PI * arg);
+            return window * CUTOFF * sinc;
+        });
+        return table;
+    }
+
+    int interpolation = Linear;
+    int64_t loop = 1;
+    float loopF = 1.0f;
+    float invLoop = 1.0f;
+};
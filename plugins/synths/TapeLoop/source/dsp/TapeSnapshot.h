@@ -0,0 +1,255 @@
+/**
+ * @file TapeSnapshot.h
+ * @brief Stream the loop out as it was at one moment while recording goes on
+ *
+ * Bouncing the tape copies up to a minute of stereo: too long to hold the
+ * audio thread, or the message thread, for. Instead the audio thread marks
+ * a fence (the write position at the start of a span) and carries on; a
+ * background thread reads the loop out from the fence forwards, oldest
+ * first, one segment at a time. The only segments copied are the ones the
+ * record head reaches before the reader has them: just before its first
+ * write into such a segment, the audio thread copies it whole into a pool
+ * set aside for that, and the reader takes the copy instead.
+ *
+ *   // Message thread, under the callback lock (prepare() allocates)
+ *   snapshot.prepare(engine.getTapeBufferSize());
+ *   snapshot.request();
+ *
+ *   // Audio thread: TapeLoopEngine calls record() before each span's writes
+ *
+ *   // Background thread
+ *   while (const size_t n = snapshot.readNext(left, right))  // SEGMENT_SAMPLES each
+ *       encode(left, right, n);
+ *   const bool whole = !snapshot.failed();
+ *   snapshot.finish();
+ *
+ * The reader checks a segment as a seqlock's reader does: it reads the
+ * tape, then whether the audio thread has copied the segment meanwhile,
+ * and if so takes the copy. The audio thread publishes a copy before its
+ * first write to the segment, and never waits for the reader.
+ *
+ * If the record head gets round to more unread segments than the pool
+ * holds (the reader a pool's worth of seconds behind), the snapshot fails
+ * rather than stall: failed() says so and readNext() stops.
+ *
+ * @note prepare() allocates; record() and readNext() don't.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+class TapeSnapshot
+{
+public:
+    /** Samples per segment: the copy-on-write unit and the read chunk */
+    static constexpr size_t SEGMENT_SAMPLES = 4096;
+
+    /** Default pool: 128 segments, about 11 s of recording at 48 kHz (2 MB) */
+    static constexpr size_t DEFAULT_POOL_SEGMENTS = 128;
+
+    /** Room for a tape of tapeSamples and poolSegments copies; only while idle */
+    void prepare(size_t tapeSamples, size_t poolSegments = DEFAULT_POOL_SEGMENTS)
+    {
+        const size_t segments = (tapeSamples + SEGMENT_SAMPLES - 1) / SEGMENT_SAMPLES;
+        if (segments > numSegments)
+        {
+            slots = std::make_unique<std::atomic<int32_t>[]>(segments);
+            numSegments = segments;
+        }
+        poolL.resize(poolSegments * SEGMENT_SAMPLES);
+        poolR.resize(poolSegments * SEGMENT_SAMPLES);
+        poolSize = poolSegments;
+    }
+
+    /** Take a snapshot at the audio thread's next span */
+    void request()
+    {
+        for (size_t s = 0; s < numSegments; ++s)
+            slots[s].store(PENDING, std::memory_order_relaxed);
+        nextSlot.store(0, std::memory_order_relaxed);
+        cursor = 0;
+        state.store(REQUESTED, std::memory_order_release);
+    }
+
+    /** True from request() until the fence is marked */
+    bool isRequested() const { return state.load(std::memory_order_acquire) == REQUESTED; }
+
+    /** True while a snapshot is being read out */
+    bool isActive() const { return state.load(std::memory_order_acquire) == ACTIVE; }
+
+    /** True if the record head outran the pool: what was read isn't the snapshot */
+    bool failed() const { return state.load(std::memory_order_acquire) == FAILED; }
+
+    /** Back to idle once the reader is done with it */
+    void finish() { state.store(IDLE, std::memory_order_release); }
+
+    /**
+     * @brief Audio thread: the record head is about to write n samples from writePos
+     *
+     * Marks the fence if a snapshot was requested, then copies any unread
+     * segment the writes reach.
+     */
+    void record(const int16_t* tapeL, const int16_t* tapeR, size_t writePos, size_t n, size_t loopSamples)
+    {
+        const int current = state.load(std::memory_order_acquire);
+        if (current == REQUESTED)
+        {
+            const size_t segments = (loopSamples + SEGMENT_SAMPLES - 1) / SEGMENT_SAMPLES;
+            if (loopSamples == 0 || segments > numSegments)
+            {
+                state.store(FAILED, std::memory_order_release);
+                return;
+            }
+            left = tapeL;
+            right = tapeR;
+            fence = writePos % loopSamples;
+            loop = loopSamples;
+            beforeWrite(writePos, n, loopSamples);
+
+            // The reader sees the fence, and the fence segment's copy, from here
+            int expected = REQUESTED;
+            state.compare_exchange_strong(expected, ACTIVE, std::memory_order_acq_rel);
+            return;
+        }
+        if (current == ACTIVE)
+            beforeWrite(writePos, n, loopSamples);
+    }
+
+    /** Audio thread: something other than the record head writes [first, first + n) (no wrapping) */
+    void overwrite(size_t first, size_t n)
+    {
+        if (state.load(std::memory_order_acquire) == ACTIVE)
+            beforeWrite(first, n, first + n);
+    }
+
+    /**
+     * @brief Background thread: the next chunk of the snapshot, oldest first
+     * @param outL, outR At least SEGMENT_SAMPLES each
+     * @return Samples written (0 when the loop is all read, or on failure)
+     */
+    size_t readNext(int16_t* outL, int16_t* outR)
+    {
+        if (!isActive() || cursor >= loop)
+            return 0;
+
+        // From the fence to the loop's end, then from its start to the fence
+        const size_t pos = (fence + cursor) % loop;
+        const size_t segment = pos / SEGMENT_SAMPLES;
+        const size_t offset = pos - segment * SEGMENT_SAMPLES;
+        size_t end = std::min((segment + 1) * SEGMENT_SAMPLES, loop);
+        if (pos < fence)
+            end = std::min(end, fence);
+        const size_t n = end - pos;
+
+        std::atomic<int32_t>& slot = slots[segment];
+        int32_t copy = slot.load(std::memory_order_acquire);
+        if (copy == PENDING)
+        {
+            std::memcpy(outL, left + pos, n * sizeof(int16_t));
+            std::memcpy(outR, right + pos, n * sizeof(int16_t));
+
+            // Copied while we read, or since: the read may be torn, the copy isn't.
+            // A whole segment read clean is done with; the writer won't copy it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            copy = slot.load(std::memory_order_acquire);
+            const bool whole = offset == 0 && (end == loop || end - pos == SEGMENT_SAMPLES);
+            if (copy == PENDING && whole)
+                slot.compare_exchange_strong(copy, READ, std::memory_order_acq_rel);
+        }
+        if (copy >= 0)
+        {
+            const size_t from = static_cast<size_t>(copy) * SEGMENT_SAMPLES + offset;
+            std::memcpy(outL, poolL.data() + from, n * sizeof(int16_t));
+            std::memcpy(outR, poolR.data() + from, n * sizeof(int16_t));
+        }
+
+        if (failed())
+            return 0;
+        cursor += n;
+        return n;
+    }
+
+    /** Samples in the snapshot (the loop at the fence) */
+    size_t getLength() const { return loop; }
+
+    /** Segments copied for this snapshot so far */
+    size_t getCopiedSegments() const { return static_cast<size_t>(nextSlot.load(std::memory_order_relaxed)); }
+
+    size_t getHeapBytes() const
+    {
+        return (poolL.capacity() + poolR.capacity()) * sizeof(int16_t) + numSegments * sizeof(std::atomic<int32_t>);
+    }
+
+private:
+    enum : int { IDLE, REQUESTED, ACTIVE, FAILED };
+
+    static constexpr int32_t PENDING = -1;  // Neither read nor copied
+    static constexpr int32_t READ = -2;     // Read whole: no copy needed
+                                            // 0 and up: the pool slot holding its copy
+
+    /** Copy the unread segments positions [first, first + n) reach, wrapping at wrap */
+    void beforeWrite(size_t first, size_t n, size_t wrap)
+    {
+        for (size_t i = 0; i < n;)
+        {
+            const size_t pos = (first + i) % wrap;
+            if (pos < loop)
+                copySegment(pos / SEGMENT_SAMPLES);
+
+            // On to the next segment, or round to the loop's start
+            const size_t next = std::min((pos / SEGMENT_SAMPLES + 1) * SEGMENT_SAMPLES, wrap);
+            i += next - pos;
+        }
+    }
+
+    void copySegment(size_t segment)
+    {
+        std::atomic<int32_t>& slot = slots[segment];
+        if (slot.load(std::memory_order_acquire) != PENDING)
+            return;
+        const int32_t free = nextSlot.load(std::memory_order_relaxed);
+        if (free >= static_cast<int32_t>(poolSize))
+        {
+            state.store(FAILED, std::memory_order_release);
+            return;
+        }
+
+        const size_t first = segment * SEGMENT_SAMPLES;
+        const size_t n = std::min(SEGMENT_SAMPLES, loop - first);
+        const size_t to = static_cast<size_t>(free) * SEGMENT_SAMPLES;
+        std::memcpy(poolL.data() + to, left + first, n * sizeof(int16_t));
+        std::memcpy(poolR.data() + to, right + first, n * sizeof(int16_t));
+
+        // The reader may have finished with it meanwhile; then the slot goes back
+        int32_t expected = PENDING;
+        if (slot.compare_exchange_strong(expected, free, std::memory_order_acq_rel))
+            nextSlot.store(free + 1, std::memory_order_relaxed);
+
+        // The copy is published before any write into the segment
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    std::atomic<int> state{IDLE};
+    std::unique_ptr<std::atomic<int32_t>[]> slots;
+    size_t numSegments = 0;
+
+    std::vector<int16_t> poolL;
+    std::vector<int16_t> poolR;
+    size_t poolSize = 0;
+    std::atomic<int32_t> nextSlot{0};  // Written by the audio thread
+
+    // Set with the fence, before ACTIVE is published
+    const int16_t* left = nullptr;
+    const int16_t* right = nullptr;
+    size_t fence = 0;
+    size_t loop = 0;
+
+    size_t cursor = 0;  // Reader: samples read out
+};
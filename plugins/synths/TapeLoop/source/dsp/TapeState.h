@@ -0,0 +1,384 @@
+/**
+ * @file TapeState.h
+ * @brief Save the recorded tape with the plugin state, and stream it back in
+ *
+ * The tape is already 16-bit (see TapeLoopEngine), so it's stored
+ * losslessly, FLAC-style: each chunk of CHUNK_SAMPLES is delta coded and
+ * Rice coded with the parameter that suits it best, and a channel that is
+ * silent for a whole chunk costs nothing. A quiet or partly recorded loop
+ * comes to a small fraction of its raw size, and an empty one to a few
+ * bytes per chunk.
+ *
+ * Chunks decode independently, so loading doesn't stall the audio thread:
+ * TapeStateReader::open() only checks the blob and indexes its chunks, and
+ * streamInto() decodes one chunk per call from processBlock(). It starts
+ * at the chunk under the saved write position and works forwards round the
+ * loop, several times faster than the head moves, so playback only ever
+ * meets restored tape.
+ *
+ *   // getStateInformation (copy the tape under the callback lock)
+ *   auto blob = TapeState::encode(tapeL, tapeR, samples, writePos, sampleRate);
+ *
+ *   // setStateInformation (under the callback lock: open() copies the blob)
+ *   tapeReader.open(blob.data(), blob.size());
+ *
+ *   // processBlock
+ *   if (tapeReader.pending())
+ *       tapeReader.streamInto(engine);  // engine.setTapeWritePos(), engine.writeTape()
+ *
+ * Layout (little-endian): "TAPE", u16 version, u16 0, u32 sample rate,
+ * u32 samples, u32 write position, u32 chunk samples, u32 chunk count;
+ * then per chunk: u32 payload bytes, u8 Rice k left, u8 Rice k right
+ * (SILENT: channel all zero, no bits), payload (left bits, then right).
+ *
+ * @note encode() and open() allocate: message thread only. streamInto()
+ *       doesn't allocate.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace TapeState
+{
+static constexpr uint16_t VERSION = 1;
+static constexpr size_t CHUNK_SAMPLES = 4096;
+static constexpr size_t HEADER_BYTES = 28;
+static constexpr size_t CHUNK_HEADER_BYTES = 6;
+static constexpr uint8_t SILENT = 0xFF;
+static constexpr uint8_t MAX_RICE_K = 17;  // Zigzagged 16-bit deltas fit in 17 bits
+
+namespace detail
+{
+inline void putU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (int b = 0; b < 4; ++b)
+        out.push_back(static_cast<uint8_t>(v >> (8 * b)));
+}
+
+inline uint32_t getU32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16
+           | static_cast<uint32_t>(p[3]) << 24;
+}
+
+/** Delta then zigzag: small steps either way become small unsigned values */
+inline uint32_t zigzagDelta(int16_t x, int16_t previous)
+{
+    const int32_t d = static_cast<int32_t>(x) - static_cast<int32_t>(previous);
+    return (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);
+}
+
+/** MSB-first bit packer for the Rice codes */
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<uint8_t>& o) : out(o) {}
+
+    void put(uint32_t bits, int count)
+    {
+        for (int b = count - 1; b >= 0; --b)
+            putBit((bits >> b) & 1u);
+    }
+
+    void putBit(uint32_t bit)
+    {
+        current = static_cast<uint8_t>(current << 1 | bit);
+        if (++used == 8)
+            flush();
+    }
+
+    void finish()
+    {
+        if (used > 0)
+        {
+            current = static_cast<uint8_t>(current << (8 - used));
+            flush();
+        }
+    }
+
+private:
+    void flush()
+    {
+        out.push_back(current);
+        current = 0;
+        used = 0;
+    }
+
+    std::vector<uint8_t>& out;
+    uint8_t current = 0;
+    int used = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t* d, size_t size) : data(d), bits(size * 8) {}
+
+    /** Next bit; past the end, 0 (and ok() turns false) */
+    uint32_t getBit()
+    {
+        if (position >= bits)
+        {
+            overrun = true;
+            return 0;
+        }
+        const uint32_t bit = (data[position >> 3] >> (7 - (position & 7))) & 1u;
+        ++position;
+        return bit;
+    }
+
+    uint32_t get(int count)
+    {
+        uint32_t v = 0;
+        for (int b = 0; b < count; ++b)
+            v = v << 1 | getBit();
+        return v;
+    }
+
+    bool ok() const { return !overrun; }
+
+private:
+    const uint8_t* data;
+    size_t bits;
+    size_t position = 0;
+    bool overrun = false;
+};
+
+/** Rice parameter for this channel's chunk (FLAC's estimate from the mean), or SILENT */
+inline uint8_t bestRiceK(const int16_t* x, size_t n)
+{
+    if (std::all_of(x, x + n, [](int16_t s) { return s == 0; }))
+        return SILENT;
+
+    uint64_t sum = 0;
+    int16_t previous = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        sum += zigzagDelta(x[i], previous);
+        previous = x[i];
+    }
+
+    // Largest k with 2^k below the mean
+    uint8_t k = 0;
+    while (k < MAX_RICE_K && (static_cast<uint64_t>(n) << (k + 1)) <= sum)
+        ++k;
+    return k;
+}
+
+inline void encodeChannel(BitWriter& bits, const int16_t* x, size_t n, uint8_t k)
+{
+    int16_t previous = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint32_t u = zigzagDelta(x[i], previous);
+        previous = x[i];
+        for (uint32_t q = u >> k; q > 0; --q)
+            bits.putBit(1);
+        bits.putBit(0);
+        bits.put(u & ((1u << k) - 1u), k);
+    }
+}
+
+inline bool decodeChannel(BitReader& bits, int16_t* x, size_t n, uint8_t k)
+{
+    if (k == SILENT)
+    {
+        std::fill(x, x + n, int16_t(0));
+        return true;
+    }
+    if (k > MAX_RICE_K)
+        return false;
+
+    int32_t previous = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32_t q = 0;
+        while (bits.getBit() == 1)
+        {
+            // No valid delta needs more than 2^17 ones
+            if (++q > (1u << MAX_RICE_K) || !bits.ok())
+                return false;
+        }
+        const uint32_t u = q << k | bits.get(k);
+        const int32_t d = static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1u);
+        previous += d;
+        x[i] = static_cast<int16_t>(previous);
+    }
+    return bits.ok();
+}
+} // namespace detail
+
+/**
+ * @brief Encode samples of stereo tape (from index 0) and the write position
+ */
+inline std::vector<uint8_t> encode(const int16_t* left, const int16_t* right, size_t samples,
+                                   size_t writePos, uint32_t sampleRate)
+{
+    using namespace detail;
+
+    const size_t chunks = (samples + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES;
+
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_BYTES + chunks * CHUNK_HEADER_BYTES);
+    out.insert(out.end(), {'T', 'A', 'P', 'E'});
+    out.push_back(static_cast<uint8_t>(VERSION & 0xFF));
+    out.push_back(static_cast<uint8_t>(VERSION >> 8));
+    out.push_back(0);
+    out.push_back(0);
+    putU32(out, sampleRate);
+    putU32(out, static_cast<uint32_t>(samples));
+    putU32(out, static_cast<uint32_t>(samples > 0 ? writePos % samples : 0));
+    putU32(out, static_cast<uint32_t>(CHUNK_SAMPLES));
+    putU32(out, static_cast<uint32_t>(chunks));
+
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        const size_t start = c * CHUNK_SAMPLES;
+        const size_t n = std::min(CHUNK_SAMPLES, samples - start);
+        const uint8_t kL = bestRiceK(left + start, n);
+        const uint8_t kR = bestRiceK(right + start, n);
+
+        const size_t header = out.size();
+        putU32(out, 0);  // Payload size, filled in below
+        out.push_back(kL);
+        out.push_back(kR);
+
+        BitWriter bits(out);
+        if (kL != SILENT)
+            encodeChannel(bits, left + start, n, kL);
+        if (kR != SILENT)
+            encodeChannel(bits, right + start, n, kR);
+        bits.finish();
+
+        const auto payload = static_cast<uint32_t>(out.size() - header - CHUNK_HEADER_BYTES);
+        for (int b = 0; b < 4; ++b)
+            out[header + static_cast<size_t>(b)] = static_cast<uint8_t>(payload >> (8 * b));
+    }
+    return out;
+}
+
+/**
+ * @brief Restores an encoded tape into an engine a chunk at a time
+ */
+class TapeStateReader
+{
+public:
+    /**
+     * @brief Check and index a blob from encode(); false (and nothing pending) if it isn't one
+     *
+     * Copies the blob, so the caller's buffer can go. Replaces any load
+     * still in progress.
+     */
+    bool open(const uint8_t* data, size_t size)
+    {
+        using namespace detail;
+        clear();
+
+        if (size < HEADER_BYTES || std::memcmp(data, "TAPE", 4) != 0)
+            return false;
+        if ((data[4] | data[5] << 8) != VERSION || getU32(data + 20) != CHUNK_SAMPLES)
+            return false;
+
+        sampleRate = getU32(data + 8);
+        samples = getU32(data + 12);
+        writePos = getU32(data + 16);
+        const size_t chunks = getU32(data + 24);
+        if (chunks != (samples + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES || (samples > 0 && writePos >= samples))
+            return false;
+
+        // Index the chunks, so loading can start anywhere on the loop
+        std::vector<size_t> offsets;
+        offsets.reserve(chunks);
+        size_t offset = HEADER_BYTES;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+            if (size - offset < CHUNK_HEADER_BYTES)
+                return false;
+            const size_t payload = getU32(data + offset);
+            if (size - offset - CHUNK_HEADER_BYTES < payload)
+                return false;
+            offsets.push_back(offset);
+            offset += CHUNK_HEADER_BYTES + payload;
+        }
+
+        blob.assign(data, data + size);
+        chunkOffsets = std::move(offsets);
+        firstChunk = samples > 0 ? writePos / CHUNK_SAMPLES : 0;
+        chunksDone = 0;
+        return true;
+    }
+
+    void clear()
+    {
+        blob.clear();
+        chunkOffsets.clear();
+        chunksDone = 0;
+        corrupt = false;
+        samples = 0;
+        writePos = 0;
+    }
+
+    /** True until every chunk has gone into the tape */
+    bool pending() const { return chunksDone < chunkOffsets.size(); }
+
+    /** True if a chunk failed to decode (it and the rest were left unwritten) */
+    bool failed() const { return corrupt; }
+
+    size_t getSamples() const { return samples; }
+    size_t getWritePos() const { return writePos; }
+    uint32_t getSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief Decode the next chunk into a tape
+     *
+     * Tape provides setTapeWritePos(size_t) (called before the first
+     * chunk) and writeTape(offset, left, right, n).
+     */
+    template <typename Tape>
+    void streamInto(Tape& tape)
+    {
+        using namespace detail;
+        if (!pending())
+            return;
+
+        if (chunksDone == 0)
+            tape.setTapeWritePos(writePos);
+
+        const size_t c = (firstChunk + chunksDone) % chunkOffsets.size();
+        const uint8_t* chunk = blob.data() + chunkOffsets[c];
+        const size_t start = c * CHUNK_SAMPLES;
+        const size_t n = std::min(CHUNK_SAMPLES, samples - start);
+
+        BitReader bits(chunk + CHUNK_HEADER_BYTES, getU32(chunk));
+        if (!decodeChannel(bits, left.data(), n, chunk[4]) || !decodeChannel(bits, right.data(), n, chunk[5]))
+        {
+            corrupt = true;
+            chunksDone = chunkOffsets.size();
+            return;
+        }
+
+        tape.writeTape(start, left.data(), right.data(), n);
+        ++chunksDone;
+    }
+
+private:
+    std::vector<uint8_t> blob;
+    std::vector<size_t> chunkOffsets;
+    size_t firstChunk = 0;
+    size_t chunksDone = 0;
+    bool corrupt = false;
+
+    uint32_t sampleRate = 0;
+    size_t samples = 0;
+    size_t writePos = 0;
+
+    std::array<int16_t, CHUNK_SAMPLES> left{};
+    std::array<int16_t, CHUNK_SAMPLES> right{};
+};
+} // namespace TapeState
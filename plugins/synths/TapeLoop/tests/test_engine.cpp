@@ -6,6 +6,25 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include "dsp/TapeLoopEngine.h"
+#include "dsp/TapeState.h"
+#include "PluginState.h"
+#include "AsyncPrepare.h"
+#include "RealtimeGuard.h"
+#include "TraceDumper.h"
+#include <sst/basic-blocks/modulators/Transport.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using Catch::Approx;
 
@@ -180,6 +199,91 @@ TEST_CASE("TapeLoopEngine audio rendering", "[engine]")
         // After clearing, should be very quiet (only hiss and possible residual from filters)
         REQUIRE(maxAbs < 0.25f);
     }
+    SECTION("External input is recorded onto the tape")
+    {
+        engine.setLoopLength(0.5f);
+        engine.setTapeHiss(0.0f);
+
+        std::array<float, 512> input{};
+        for (int i = 0; i < 512; ++i)
+            input[static_cast<size_t>(i)] = 0.5f * std::sin(6.283185f * 220.0f * static_cast<float>(i) / 44100.0f);
+
+        TapeLoopEngine dry;
+        dry.prepare(44100.0, 512);
+        dry.setLoopLength(0.5f);
+        dry.setTapeHiss(0.0f);
+        std::array<float, 512> dryLeft{}, dryRight{};
+
+        // Half a second of input, no notes
+        for (int block = 0; block < 44; ++block)
+        {
+            engine.renderBlock(input.data(), input.data(), left.data(), right.data(), 512);
+            dry.renderBlock(dryLeft.data(), dryRight.data(), 512);
+        }
+
+        // Input off, loop only: what played in comes back round
+        engine.setDryLevel(0.0f);
+        dry.setDryLevel(0.0f);
+        float withInput = 0.0f, without = 0.0f;
+        for (int block = 0; block < 10; ++block)
+        {
+            engine.renderBlock(left.data(), right.data(), 512);
+            dry.renderBlock(dryLeft.data(), dryRight.data(), 512);
+            for (int i = 0; i < 512; ++i)
+            {
+                withInput = std::max(withInput, std::abs(left[static_cast<size_t>(i)]));
+                without = std::max(without, std::abs(dryLeft[static_cast<size_t>(i)]));
+            }
+        }
+
+        REQUIRE(withInput > 0.05f);
+        REQUIRE(withInput > 10.0f * without);
+    }
+
+    SECTION("Input is read in place, at the record level")
+    {
+        std::array<float, 512> input{};
+        for (int i = 0; i < 512; ++i)
+            input[static_cast<size_t>(i)] = 0.5f * std::sin(6.283185f * 220.0f * static_cast<float>(i) / 44100.0f);
+
+        TapeLoopEngine inPlace;
+        inPlace.prepare(44100.0, 512);
+        engine.setNoiseSeed(7);
+        inPlace.setNoiseSeed(7);
+
+        // A host's buffer: the input in the output channels
+        std::array<float, 512> hostLeft{}, hostRight{};
+        for (int block = 0; block < 20; ++block)
+        {
+            hostLeft = input;
+            hostRight = input;
+            engine.renderBlock(input.data(), input.data(), left.data(), right.data(), 512);
+            inPlace.renderBlock(hostLeft.data(), hostRight.data(), hostLeft.data(), hostRight.data(), 512);
+            REQUIRE(hostLeft == left);
+            REQUIRE(hostRight == right);
+        }
+
+        // Dry only: the input is heard at the record level (the pan LFO centred)
+        TapeLoopEngine dry;
+        dry.prepare(44100.0, 512);
+        dry.setLoopLevel(0.0f);
+        dry.setMasterLevel(1.0f);
+        dry.setDryLevel(1.0f);
+        dry.setDelayMix(0.0f);
+        dry.setReverbMix(0.0f);
+        dry.setCompMix(0.0f);
+        const auto peak = [&](float recordLevel) {
+            dry.setRecordLevel(recordLevel);
+            dry.renderBlock(input.data(), input.data(), left.data(), right.data(), 512);
+            float p = 0.0f;
+            for (float x : left)
+                p = std::max(p, std::abs(x));
+            return p;
+        };
+        REQUIRE(peak(0.0f) < 1.0e-4f);
+        REQUIRE(peak(1.0f) == Catch::Approx(0.5f).margin(0.02f));
+        REQUIRE(peak(0.5f) == Catch::Approx(0.25f).margin(0.02f));
+    }
 }
 
 TEST_CASE("TapeLoopEngine tape degradation", "[engine]")
@@ -227,3 +331,1881 @@ TEST_CASE("TapeLoopEngine tape degradation", "[engine]")
         engine.noteOff(60);
     }
 }
+
+TEST_CASE("TapeLoopEngine tape buffer sizing", "[engine]")
+{
+    TapeLoopEngine engine;
+
+    SECTION("No tape until prepared")
+    {
+        REQUIRE(engine.getTapeBufferSize() == 0);
+
+        std::array<float, 64> left{};
+        std::array<float, 64> right{};
+        left.fill(1.0f);
+        right.fill(1.0f);
+        engine.noteOn(60, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 64);
+
+        for (int i = 0; i < 64; ++i)
+        {
+            REQUIRE(left[i] == 0.0f);
+            REQUIRE(right[i] == 0.0f);
+        }
+    }
+
+    SECTION("Sized from sample rate and max loop length")
+    {
+        engine.setMaxLoopLength(10.0f);
+        engine.prepare(48000.0, 512);
+        REQUIRE(engine.getTapeBufferSize() == 480000);
+
+        engine.prepare(96000.0, 512);
+        REQUIRE(engine.getTapeBufferSize() == 960000);
+
+        engine.releaseResources();
+        REQUIRE(engine.getTapeBufferSize() == 0);
+    }
+
+    SECTION("Loop length is clamped to the max")
+    {
+        engine.setMaxLoopLength(0.5f);
+        engine.setLoopLength(5.0f);
+        engine.prepare(44100.0, 512);
+        engine.noteOn(60, 1.0f);
+
+        std::array<float, 512> left{};
+        std::array<float, 512> right{};
+        for (int block = 0; block < 100; ++block)
+        {
+            engine.renderBlock(left.data(), right.data(), 512);
+            for (int i = 0; i < 512; ++i)
+                REQUIRE(std::isfinite(left[i]));
+        }
+
+        REQUIRE(engine.getMaxLoopLength() == Approx(0.5f));
+        REQUIRE(engine.getTapeBufferSize() == 22050);
+    }
+}
+
+TEST_CASE("TapeLoopEngine tape oversampling", "[engine]")
+{
+    TapeLoopEngine engine;
+    engine.prepare(48000.0, 512);
+
+    SECTION("Factor is off, 2x or 4x")
+    {
+        REQUIRE(engine.getOversampling() == 1);
+        engine.setOversampling(2);
+        REQUIRE(engine.getOversampling() == 2);
+        engine.setOversampling(3);
+        REQUIRE(engine.getOversampling() == 2);
+        engine.setOversampling(8);
+        REQUIRE(engine.getOversampling() == 4);
+        engine.setOversampling(0);
+        REQUIRE(engine.getOversampling() == 1);
+    }
+
+    SECTION("Hot Airwindows drive stays finite at any block size")
+    {
+        engine.setTapeModel(2);
+        engine.setTapeDrive(1.0f);
+        engine.setLoopFeedback(0.9f);
+
+        for (int factor : {2, 4})
+        {
+            engine.setOversampling(factor);
+            engine.clearTape();
+            engine.noteOn(48, 1.0f);
+
+            std::array<float, 512> left{};
+            std::array<float, 512> right{};
+            float peak = 0.0f;
+            for (int block = 0; block < 60; ++block)
+            {
+                // Odd sizes exercise the oversampler's partial groups
+                const int n = 37 + (block * 53) % 475;
+                engine.renderBlock(left.data(), right.data(), n);
+                for (int i = 0; i < n; ++i)
+                {
+                    REQUIRE(std::isfinite(left[i]));
+                    REQUIRE(std::isfinite(right[i]));
+                    peak = std::max(peak, std::abs(left[i]));
+                }
+            }
+            engine.noteOff(48);
+
+            REQUIRE(peak > 0.01f);
+            REQUIRE(peak < 10.0f);
+        }
+    }
+}
+
+TEST_CASE("TapeLoopEngine quality tiers override interpolation and oversampling", "[engine][quality]")
+{
+    TapeLoopEngine engine;
+    engine.prepare(48000.0, 512);
+    engine.setTapeInterpolation(TapeReadHead::Hermite);
+    engine.setOversampling(2);
+
+    SECTION("Normal leaves the parameters; draft and high override them")
+    {
+        engine.setTapeModel(1);  // Airwindows off: the factor changes at once
+        REQUIRE(engine.getQualityTier() == QualityTier::Normal);
+        REQUIRE(engine.getOversampling() == 2);
+
+        engine.setQualityTier(QualityTier::Draft);
+        REQUIRE(engine.getOversampling() == 1);
+        REQUIRE(engine.getTapeInterpolation() == TapeReadHead::Hermite);
+
+        engine.setQualityTier(QualityTier::High);
+        REQUIRE(engine.getOversampling() == 4);
+
+        engine.setQualityTier(QualityTier::Normal);
+        REQUIRE(engine.getOversampling() == 2);
+    }
+
+    SECTION("A new factor waits while the Airwindows stage is playing")
+    {
+        std::array<float, 512> left{};
+        std::array<float, 512> right{};
+        engine.setTapeModel(2);
+        engine.noteOn(48, 1.0f);
+        engine.renderBlock(left.data(), right.data(), 512);
+
+        engine.setQualityTier(QualityTier::High);
+        engine.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(engine.getOversampling() == 2);
+
+        // Switched back on
+        engine.setTapeModel(1);
+        engine.setTapeModel(2);
+        REQUIRE(engine.getOversampling() == 4);
+
+        // Or after a silent block
+        TapeLoopEngine quiet;
+        quiet.prepare(48000.0, 512);
+        quiet.setTapeModel(2);
+        quiet.setLoopLevel(0.0f);  // No tape noise floor either
+        quiet.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(quiet.isSilent());
+        quiet.setQualityTier(QualityTier::High);
+        quiet.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(quiet.getOversampling() == 4);
+    }
+
+    SECTION("Every tier renders, and switching doesn't allocate")
+    {
+        engine.setTapeModel(3);
+        engine.setReverbMix(0.5f);
+        engine.setReverbBigness(1.0f);
+        engine.noteOn(48, 1.0f);
+
+        std::array<float, 512> left{};
+        std::array<float, 512> right{};
+        float peak = 0.0f;
+        const auto rt = RealtimeGuard::check([&] {
+            for (int block = 0; block < 60; ++block)
+            {
+                engine.setQualityTier(qualityTierFromIndex(block % NUM_QUALITY_TIERS));
+                engine.renderBlock(left.data(), right.data(), 512);
+                for (int i = 0; i < 512; ++i)
+                {
+                    REQUIRE(std::isfinite(left[i]));
+                    peak = std::max(peak, std::abs(left[i]));
+                }
+            }
+        });
+
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(peak > 0.01f);
+        REQUIRE(peak < 10.0f);
+    }
+}
+
+TEST_CASE("TapeLoopEngine fades a tape model change in", "[engine]")
+{
+    // Two engines play the same loop; one switches the Airwindows stage on
+    std::array<TapeLoopEngine, 2> engines;
+    for (auto& engine : engines)
+    {
+        engine.prepare(48000.0, 512);
+        engine.setNoiseSeed(9);
+        engine.setTapeModel(0);
+        engine.setTapeDrive(1.0f);
+        engine.setLoopFeedback(0.8f);
+        engine.noteOn(57, 1.0f);
+    }
+
+    std::array<std::array<float, 256>, 2> left{}, right{};
+    for (int block = 0; block < 20; ++block)
+        for (size_t e = 0; e < 2; ++e)
+            engines[e].renderBlock(left[e].data(), right[e].data(), 256);
+
+    engines[1].setTapeModel(2);
+    for (size_t e = 0; e < 2; ++e)
+        engines[e].renderBlock(left[e].data(), right[e].data(), 256);
+
+    // The change starts near nothing and has its full effect a fade later
+    auto meanDifference = [&](int from, int to) {
+        double sum = 0.0;
+        for (int i = from; i < to; ++i)
+            sum += std::abs(left[1][static_cast<size_t>(i)] - left[0][static_cast<size_t>(i)]);
+        return sum / (to - from);
+    };
+    const double start = meanDifference(0, 4);
+    const double settled = meanDifference(128, 256);
+    REQUIRE(settled > 0.01);
+    REQUIRE(start < settled * 0.2);
+}
+
+TEST_CASE("TapeLoopEngine wear on record", "[engine]")
+{
+    // Record a note onto a short loop, release it, and measure what the
+    // loop still plays after several more passes
+    auto loopEnergy = [](bool wearOnRecord) {
+        TapeLoopEngine engine;
+        engine.prepare(48000.0, 512);
+        engine.setNoiseSeed(3);
+        engine.setTapeModel(0);
+        engine.setLoopLength(0.1f);
+        engine.setLoopFeedback(0.95f);
+        engine.setTapeAge(0.8f);
+        engine.setTapeDegrade(0.5f);
+        engine.setDryLevel(0.0f);
+        engine.setWearOnRecord(wearOnRecord);
+        REQUIRE(engine.getWearOnRecord() == wearOnRecord);
+
+        std::array<float, 480> left{};
+        std::array<float, 480> right{};
+        engine.noteOn(60, 1.0f);
+        for (int block = 0; block < 10; ++block)
+            engine.renderBlock(left.data(), right.data(), 480);
+        engine.noteOff(60);
+
+        double energy = 0.0;
+        for (int block = 0; block < 100; ++block)
+        {
+            engine.renderBlock(left.data(), right.data(), 480);
+            for (size_t i = 0; i < left.size(); ++i)
+            {
+                REQUIRE(std::isfinite(left[i]));
+                REQUIRE(std::isfinite(right[i]));
+                if (block >= 90)
+                    energy += left[i] * left[i] + right[i] * right[i];
+            }
+        }
+        return energy;
+    };
+
+    const double onPlayback = loopEnergy(false);
+    const double onRecord = loopEnergy(true);
+
+    // Worn on playback, every pass is the recording coloured once; worn on
+    // record, each generation loses its highs again and the loop fades
+    REQUIRE(onPlayback > 0.0);
+    REQUIRE(onRecord > 0.0);
+    REQUIRE(onRecord < onPlayback * 0.5);
+}
+
+TEST_CASE("TapeLoopEngine play heads read the tape without recording", "[engine]")
+{
+    // Two engines record the same note; one also plays it back through
+    // extra heads
+    auto render = [](TapeLoopEngine& engine, std::vector<float>& out) {
+        engine.prepare(48000.0, 512);
+        engine.setNoiseSeed(5);
+        engine.setLoopLength(0.25f);
+        engine.setDryLevel(0.0f);
+
+        std::array<float, 480> left{};
+        std::array<float, 480> right{};
+        engine.noteOn(57, 1.0f);
+        for (int block = 0; block < 60; ++block)
+        {
+            if (block == 20)
+                engine.noteOff(57);
+            engine.renderBlock(left.data(), right.data(), 480);
+            for (size_t i = 0; i < left.size(); ++i)
+            {
+                REQUIRE(std::isfinite(left[i]));
+                REQUIRE(std::isfinite(right[i]));
+            }
+            out.insert(out.end(), left.begin(), left.end());
+        }
+    };
+
+    TapeLoopEngine plain;
+    std::vector<float> plainOut;
+    render(plain, plainOut);
+
+    TapeLoopEngine heads;
+    heads.setHeadLevel(0, 0.8f);
+    heads.setHeadOffset(0, 0.3f);
+    heads.setHeadLevel(1, 0.5f);
+    heads.setHeadSpeed(1, -1.0f);
+    heads.setHeadPan(1, -1.0f);
+    heads.setHeadLevel(2, 0.5f);
+    heads.setHeadSpeed(2, 2.0f);
+    heads.setHeadPan(2, 0.7f);
+    std::vector<float> headsOut;
+    render(heads, headsOut);
+
+    // Only the record head feeds back, so the tape is the same
+    const size_t loop = plain.getLoopSamples();
+    REQUIRE(heads.getLoopSamples() == loop);
+    REQUIRE(std::equal(plain.getTapeL(), plain.getTapeL() + loop, heads.getTapeL()));
+    REQUIRE(std::equal(plain.getTapeR(), plain.getTapeR() + loop, heads.getTapeR()));
+    REQUIRE(heads.getTapeWritePos() == plain.getTapeWritePos());
+
+    // ...and the heads are heard
+    double difference = 0.0;
+    for (size_t i = 0; i < plainOut.size(); ++i)
+        difference += std::abs(headsOut[i] - plainOut[i]);
+    REQUIRE(difference > 1.0);
+
+    SECTION("Varispeed and reverse play heads and record head stay finite")
+    {
+        for (float speed : {0.25f, 3.3f, 4.0f})
+        {
+            for (bool reverse : {false, true})
+            {
+                TapeLoopEngine varispeed;
+                varispeed.setTapeSpeed(speed);
+                varispeed.setTapeReverse(reverse);
+                varispeed.setHeadLevel(0, 1.0f);
+                varispeed.setHeadSpeed(0, reverse ? speed : -speed);
+                std::vector<float> out;
+                render(varispeed, out);
+                REQUIRE(std::any_of(out.begin(), out.end(), [](float v) { return std::abs(v) > 0.01f; }));
+            }
+        }
+    }
+
+    SECTION("Heads at zero level change nothing")
+    {
+        TapeLoopEngine muted;
+        muted.setHeadOffset(0, 0.1f);
+        muted.setHeadSpeed(0, 0.5f);
+        std::vector<float> mutedOut;
+        render(muted, mutedOut);
+        REQUIRE(mutedOut == plainOut);
+    }
+}
+
+TEST_CASE("TapeLoopEngine grain cloud reads the tape without recording", "[engine][grains]")
+{
+    auto render = [](TapeLoopEngine& engine, std::vector<float>& out) {
+        engine.prepare(48000.0, 512);
+        engine.setNoiseSeed(5);
+        engine.setLoopLength(0.25f);
+        engine.setDryLevel(0.0f);
+
+        std::array<float, 480> left{};
+        std::array<float, 480> right{};
+        engine.noteOn(57, 1.0f);
+        for (int block = 0; block < 60; ++block)
+        {
+            if (block == 20)
+                engine.noteOff(57);
+            engine.renderBlock(left.data(), right.data(), 480);
+            for (size_t i = 0; i < left.size(); ++i)
+            {
+                REQUIRE(std::isfinite(left[i]));
+                REQUIRE(std::isfinite(right[i]));
+            }
+            out.insert(out.end(), left.begin(), left.end());
+        }
+    };
+
+    TapeLoopEngine plain;
+    std::vector<float> plainOut;
+    render(plain, plainOut);
+
+    TapeLoopEngine cloud;
+    cloud.setGrainLevel(1.0f);
+    cloud.setGrainDensity(60.0f);
+    cloud.setGrainSize(80.0f);
+    cloud.setGrainSpray(0.8f);
+    cloud.setGrainPitch(-5.0f);
+    cloud.setGrainPitchSpread(12.0f);
+    cloud.setGrainPanSpread(1.0f);
+    std::vector<float> cloudOut;
+    render(cloud, cloudOut);
+
+    // The grains aren't recorded, so the tape is the same...
+    const size_t loop = plain.getLoopSamples();
+    REQUIRE(std::equal(plain.getTapeL(), plain.getTapeL() + loop, cloud.getTapeL()));
+    REQUIRE(std::equal(plain.getTapeR(), plain.getTapeR() + loop, cloud.getTapeR()));
+
+    // ...and they are heard
+    double difference = 0.0;
+    for (size_t i = 0; i < plainOut.size(); ++i)
+        difference += std::abs(cloudOut[i] - plainOut[i]);
+    REQUIRE(difference > 1.0);
+
+    SECTION("A cloud at zero level changes nothing")
+    {
+        TapeLoopEngine muted;
+        muted.setGrainDensity(100.0f);
+        muted.setGrainSpray(1.0f);
+        std::vector<float> mutedOut;
+        render(muted, mutedOut);
+        REQUIRE(mutedOut == plainOut);
+    }
+
+    SECTION("Draft sounds a quarter of the grains")
+    {
+        REQUIRE(cloud.getGrains().getBudget() == TapeGrains::MAX_GRAINS);
+        cloud.setQualityTier(QualityTier::Draft);
+        REQUIRE(cloud.getGrains().getBudget() == TapeGrains::MAX_GRAINS / 4);
+    }
+}
+
+TEST_CASE("TapeGrains start on their sample and stay within the budget", "[grains]")
+{
+    constexpr size_t LOOP = 4800;
+    constexpr float GAIN = 1.0f / 32767.0f;
+    std::vector<int16_t> tapeL(LOOP);
+    std::vector<int16_t> tapeR(LOOP);
+    const std::array<float, TapeGrains::MAX_SPAN> transport{};
+
+    TapeReadHead head;
+    head.setLoop(LOOP);
+
+    // Renders samples in spans of span, the record head moving on with them
+    auto render = [&](TapeGrains& grains, int samples, int span, std::vector<float>& left, std::vector<float>& right,
+                      auto&& eachSpan) {
+        left.assign(static_cast<size_t>(samples), 0.0f);
+        right.assign(static_cast<size_t>(samples), 0.0f);
+        for (int done = 0; done < samples; done += span)
+        {
+            const int n = std::min(span, samples - done);
+            grains.render(head, tapeL.data(), tapeR.data(), static_cast<size_t>(done) % LOOP, transport.data(),
+                          left.data() + done, right.data() + done, n, LOOP, GAIN);
+            eachSpan();
+        }
+    };
+
+    TapeGrains grains;
+    grains.prepare(48000.0);
+    grains.setNoiseSeed(3);
+    grains.setLevel(1.0f);
+    std::vector<float> left, right;
+
+    SECTION("A grain is the tape under a Hann window")
+    {
+        std::fill(tapeL.begin(), tapeL.end(), int16_t{10000});
+        std::fill(tapeR.begin(), tapeR.end(), int16_t{10000});
+        grains.setDensity(1.0f);  // The next grain is at least half a second away
+        grains.setSize(0.01f);    // 480 samples
+        grains.setSpray(0.0f);
+        grains.setPanSpread(0.0f);
+        render(grains, 640, 64, left, right, [] {});
+
+        REQUIRE(left[0] == Approx(0.0f).margin(1e-6));
+        REQUIRE(left[240] == Approx(10000.0f * GAIN).epsilon(1e-3));
+        REQUIRE(left[120] == Approx(0.5f * 10000.0f * GAIN).epsilon(1e-2));
+        REQUIRE(right[240] == Approx(left[240]));
+        for (size_t i = 480; i < left.size(); ++i)
+            REQUIRE(left[i] == 0.0f);
+        REQUIRE(grains.getNumActive() == 0);
+    }
+
+    SECTION("Grains land on the same samples whatever the span size")
+    {
+        for (size_t i = 0; i < LOOP; ++i)
+        {
+            tapeL[i] = static_cast<int16_t>(12000.0 * std::sin(2.0 * 3.14159265358979 * 10.0 * i / LOOP));
+            tapeR[i] = static_cast<int16_t>(12000.0 * std::cos(2.0 * 3.14159265358979 * 10.0 * i / LOOP));
+        }
+        grains.setDensity(50.0f);
+        grains.setSize(0.05f);
+        grains.setSpray(0.5f);
+        grains.setPitchSpread(7.0f);
+        grains.setPanSpread(1.0f);
+
+        TapeGrains other = grains;
+        std::vector<float> otherLeft, otherRight;
+        render(grains, 9600, 64, left, right, [] {});
+        render(other, 9600, 7, otherLeft, otherRight, [] {});
+
+        REQUIRE(std::any_of(left.begin(), left.end(), [](float v) { return std::abs(v) > 0.05f; }));
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            REQUIRE(otherLeft[i] == Approx(left[i]).margin(1e-3));
+            REQUIRE(otherRight[i] == Approx(right[i]).margin(1e-3));
+        }
+    }
+
+    SECTION("The budget caps the grains sounding at once")
+    {
+        std::fill(tapeL.begin(), tapeL.end(), int16_t{1000});
+        grains.setDensity(100.0f);
+        grains.setSize(0.5f);  // 50 grains overlapping
+        grains.setBudget(4);
+        int most = 0;
+        render(grains, 48000, 64, left, right, [&] { most = std::max(most, grains.getNumActive()); });
+
+        REQUIRE(most == 4);
+        REQUIRE(grains.getDropped() > 0);
+
+        // Switching the cloud off stops it at once
+        grains.setLevel(0.0f);
+        REQUIRE(grains.getNumActive() == 0);
+        REQUIRE_FALSE(grains.isActive());
+    }
+}
+
+TEST_CASE("TapeLoopEngine effects sleep after their tail", "[engine]")
+{
+    TapeLoopEngine engine;
+    engine.prepare(48000.0, 512);
+    engine.setLoopLevel(0.0f);  // Only the dry signal reaches the effects
+    engine.setDelayTime(0.05f);
+    engine.setDelayFeedback(0.5f);
+    engine.setDelayMix(0.5f);
+    engine.setReverbReplace(1.0f);
+    engine.setReverbSize(0.0f);
+    engine.setReverbBigness(1.0f);
+    engine.setReverbMix(0.5f);
+
+    std::array<float, 512> left{};
+    std::array<float, 512> right{};
+    const auto peak = [&] {
+        float p = 0.0f;
+        for (size_t i = 0; i < left.size(); ++i)
+            p = std::max({p, std::abs(left[i]), std::abs(right[i])});
+        return p;
+    };
+
+    engine.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(engine.isSilent());
+
+    engine.noteOn(60, 1.0f);
+    for (int block = 0; block < 20; ++block)
+        engine.renderBlock(left.data(), right.data(), 512);
+    REQUIRE_FALSE(engine.isSilent());
+    engine.noteOff(60);
+
+    // The tails ring on after the note, then everything sleeps
+    int silentAfter = -1;
+    for (int block = 0; block < 1000 && silentAfter < 0; ++block)
+    {
+        engine.renderBlock(left.data(), right.data(), 512);
+        if (engine.isSilent())
+            silentAfter = block;
+    }
+
+    REQUIRE(silentAfter > 10);
+    REQUIRE(peak() < Silence::THRESHOLD);
+
+    for (int block = 0; block < 10; ++block)
+    {
+        engine.renderBlock(left.data(), right.data(), 512);
+        REQUIRE(engine.isSilent());
+        REQUIRE(peak() < Silence::THRESHOLD);
+    }
+
+    // A new note wakes them
+    engine.noteOn(60, 1.0f);
+    engine.renderBlock(left.data(), right.data(), 512);
+    REQUIRE_FALSE(engine.isSilent());
+}
+
+namespace
+{
+/** Run the same input through one effect per block and another per sample */
+template <typename Effect>
+void requireBlockMatchesPerSample(Effect& block, Effect& single)
+{
+    constexpr int N = 1000;
+    std::vector<float> blockL(N), blockR(N), singleL(N), singleR(N);
+    for (int i = 0; i < N; ++i)
+    {
+        blockL[i] = singleL[i] = 0.5f * std::sin(0.05f * static_cast<float>(i));
+        blockR[i] = singleR[i] = (i % 200 < 20) ? 0.8f : 0.0f;
+    }
+
+    // Uneven blocks, so runs split across buffer wraps
+    for (int start = 0, n = 7; start < N; start += n, n = n * 3 % 97 + 1)
+        block.processBlock(blockL.data() + start, blockR.data() + start, std::min(n, N - start));
+    for (int i = 0; i < N; ++i)
+        single.process(singleL[i], singleR[i]);
+
+    REQUIRE(blockL == singleL);
+    REQUIRE(blockR == singleR);
+}
+} // namespace
+
+TEST_CASE("TapeLoop sequencers follow the host transport", "[engine][transport]")
+{
+    SECTION("A synced step clock lands on the host's grid")
+    {
+        StepSequencer seq;
+        seq.setSampleRate(48000.0f);
+        seq.setBPM(120.0f);
+        seq.setDivisionIndex(3);  // 1/16: 4 steps per beat, 6000 samples each
+
+        // Exactly on step 5: it plays on the next sample
+        seq.syncTo(1.25);
+        REQUIRE(seq.nextRunLength() == 6000);
+        REQUIRE(seq.advance(1));
+        REQUIRE(seq.getCurrentStep() == 1);
+
+        // A fifth of a step before step 5: 1200 samples to go, then step 5
+        seq.syncTo(1.2);
+        REQUIRE(seq.nextRunLength() == 1200);
+        REQUIRE_FALSE(seq.advance(1200));
+        REQUIRE(seq.advance(1));
+        REQUIRE(seq.getCurrentStep() == 1);
+
+        // Positions a hair short of the step still count as on it
+        seq.syncTo(1.25 - 1e-12);
+        REQUIRE(seq.advance(1));
+        REQUIRE(seq.getCurrentStep() == 1);
+    }
+
+    SECTION("The host's tempo and position replace the BPM knob while it plays")
+    {
+        TapeLoopEngine engine;
+        engine.prepare(48000.0, 512);
+
+        SynthParams p;
+        p.update();
+        p.set(kSeqEnabled, 1.0f);
+        p.set(kSeqBPM, 90.0f);
+        p.set(kSeq1Division, 3.0f);
+        p.set(kSeq2Division, 5.0f);  // 1/4: one step per beat
+
+        sst::basic_blocks::modulators::Transport transport;
+        transport.status = sst::basic_blocks::modulators::Transport::PLAYING;
+        transport.tempo = 120.0;
+        transport.hostTimeInBeats = 2.5;  // Step 10 of seq 1, between steps 2 and 3 of seq 2
+        engine.setTransport(transport);
+        engine.applySnapshot(p);
+
+        // Each sequencer sits on the step before its next boundary
+        REQUIRE(engine.getSeq1CurrentStep() == (10 - 1) % 4);
+        REQUIRE(engine.getSeq2CurrentStep() == (3 - 1) % 4);
+
+        // The same position always gives the same steps, however the
+        // engine got there
+        std::vector<float> left(512), right(512);
+        for (int block = 0; block < 20; ++block)
+            engine.renderBlock(left.data(), right.data(), 512);
+        p.update();
+        engine.setTransport(transport);
+        engine.applySnapshot(p);
+        REQUIRE(engine.getSeq1CurrentStep() == (10 - 1) % 4);
+        REQUIRE(engine.getSeq2CurrentStep() == (3 - 1) % 4);
+    }
+}
+
+TEST_CASE("TapeLoop effects process a block as they do sample by sample", "[effects]")
+{
+    SECTION("StereoDelay, delay shorter than a block")
+    {
+        StereoDelay a, b;
+        for (auto* d : {&a, &b})
+        {
+            d->prepare(1000.0);  // 4000-sample buffer: the runs wrap
+            d->setTime(0.013f);
+            d->setFeedback(0.7f);
+            d->setMix(0.5f);
+        }
+        requireBlockMatchesPerSample(a, b);
+    }
+
+    SECTION("Compressor")
+    {
+        Compressor a, b;
+        for (auto* c : {&a, &b})
+        {
+            c->prepare(44100.0);
+            c->setThreshold(-20.0f);
+            c->setRatio(8.0f);
+            c->setMix(0.7f);
+        }
+        requireBlockMatchesPerSample(a, b);
+    }
+
+    SECTION("Galactic3Reverb")
+    {
+        auto a = std::make_unique<Galactic3Reverb>();
+        auto b = std::make_unique<Galactic3Reverb>();
+        a->prepare(44100.0);
+        b->prepare(44100.0);
+        requireBlockMatchesPerSample(*a, *b);
+    }
+
+    SECTION("Galactic3ReverbPacked")
+    {
+        auto a = std::make_unique<Galactic3ReverbPacked>();
+        auto b = std::make_unique<Galactic3ReverbPacked>();
+        a->prepare(44100.0);
+        b->prepare(44100.0);
+        requireBlockMatchesPerSample(*a, *b);
+    }
+
+    SECTION("AirwindowsTape")
+    {
+        AirwindowsTape a, b;
+        for (auto* t : {&a, &b})
+        {
+            t->prepare(44100.0);
+            t->setInputGain(0.8f);
+            t->setHeadBump(0.5f);
+        }
+        requireBlockMatchesPerSample(a, b);
+    }
+
+    SECTION("TapeDust")
+    {
+        TapeDust a, b;
+        for (auto* t : {&a, &b})
+        {
+            t->prepare(44100.0);
+            t->setRange(0.6f);
+            t->setMix(0.4f);
+            t->setNoiseSeed(5);
+        }
+        requireBlockMatchesPerSample(a, b);
+    }
+}
+
+TEST_CASE("StereoDelay taps between samples and follows the tempo", "[effects]")
+{
+    SECTION("A fractional delay splits an impulse over two samples")
+    {
+        StereoDelay delay;
+        delay.prepare(1000.0);
+        delay.setTime(0.01025f);
+        delay.setFeedback(0.0f);
+        delay.setMix(1.0f);
+
+        std::vector<float> left(64, 0.0f), right(64, 0.0f);
+        left[0] = right[0] = 1.0f;
+        delay.processBlock(left.data(), right.data(), 64);
+        REQUIRE(left[10] == Catch::Approx(0.75f).margin(1e-3f));
+        REQUIRE(left[11] == Catch::Approx(0.25f).margin(1e-3f));
+        REQUIRE(std::abs(left[9]) < 1e-6f);
+        REQUIRE(std::abs(left[12]) < 1e-6f);
+        REQUIRE(right == left);
+    }
+
+    SECTION("A synced delay stays on the beat at any rate")
+    {
+        StereoDelay delay;
+        delay.prepare(48000.0);
+        delay.setClockSyncTime(120.0f, 2.0f);
+        REQUIRE(delay.getDelaySamples() == Catch::Approx(12000.0f));
+        delay.prepare(96000.0);
+        REQUIRE(delay.getDelaySamples() == Catch::Approx(24000.0f));
+
+        // Lines are powers of two with room for the longest delay
+        REQUIRE(StereoDelay::capacityFor(48000.0) == 262144);
+        delay.setTime(4.0f);
+        REQUIRE(delay.getDelaySamples() == Catch::Approx(384000.0f));
+    }
+
+    SECTION("Lines come from an arena when one is given")
+    {
+        std::vector<float> region(StereoDelay::memoryNeeded(8000.0));
+        StereoDelay delay;
+        Arena exact(region.data(), region.size());
+        REQUIRE(delay.prepare(8000.0, exact));
+        REQUIRE(delay.getHeapBytes() == 0);
+
+        Arena tooSmall(region.data(), region.size() - Arena::ALIGN_FLOATS);
+        REQUIRE_FALSE(delay.prepare(8000.0, tooSmall));
+    }
+}
+
+TEST_CASE("Compact delay lines follow the float ones in half the memory", "[effects]")
+{
+    SECTION("Half floats round to nearest even and read back exactly")
+    {
+        SampleStorage::Float16 half;
+        const float values[] = {0.0f, 1.0f, -2.5f, 65504.0f, 6.1035156e-5f, 5.9604645e-8f};
+        for (float v : values)
+            REQUIRE(SampleStorage::Float16::load(half.store(v)) == v);
+        REQUIRE(half.store(1.0f + 1.0f / 4096.0f) == half.store(1.0f));  // Tie rounds to even
+        REQUIRE(SampleStorage::Float16::load(half.store(1.0e6f)) == 65504.0f);
+
+        std::vector<float> in(1000), out(1000);
+        std::vector<uint16_t> stored(1000);
+        for (size_t i = 0; i < in.size(); ++i)
+            in[i] = std::sin(0.01f * static_cast<float>(i)) * std::pow(10.0f, -static_cast<float>(i % 7));
+        half.store(in.data(), stored.data(), 1000);
+        SampleStorage::Float16::load(stored.data(), out.data(), 1000);
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            REQUIRE(stored[i] == half.store(in[i]));
+            REQUIRE(std::abs(out[i] - in[i]) <= std::abs(in[i]) / 2048.0f + 1.0e-7f);
+        }
+    }
+
+    SECTION("Dithered 16-bit keeps silence exact")
+    {
+        SampleStorage::Int16 pcm;
+        std::vector<float> quiet(5000, 1.0e-7f);
+        std::vector<int16_t> stored(5000, 1);
+        pcm.store(quiet.data(), stored.data(), 5000);
+        REQUIRE(std::all_of(stored.begin(), stored.end(), [](int16_t s) { return s == 0; }));
+        REQUIRE(SampleStorage::Int16::load(pcm.store(0.5f)) == Catch::Approx(0.5f).margin(2.0f / 32767.0f));
+    }
+
+    const auto renderAgainstFloat = [](auto& compact) {
+        StereoDelay reference;
+        reference.prepare(48000.0);
+        compact.prepare(48000.0);
+        reference.setTime(0.0173f);
+        reference.setFeedback(0.7f);
+        reference.setMix(0.5f);
+        compact.setTime(0.0173f);
+        compact.setFeedback(0.7f);
+        compact.setMix(0.5f);
+
+        double signal = 0.0, error = 0.0;
+        std::vector<float> l(256), r(256), refL(256), refR(256);
+        for (int block = 0; block < 100; ++block)
+        {
+            for (int i = 0; i < 256; ++i)
+                l[i] = r[i] = refL[i] = refR[i] = block < 10 ? 0.5f * std::sin(0.031f * (block * 256 + i)) : 0.0f;
+            compact.processBlock(l.data(), r.data(), 256);
+            reference.processBlock(refL.data(), refR.data(), 256);
+            for (int i = 0; i < 256; ++i)
+            {
+                signal += refL[i] * refL[i];
+                error += (l[i] - refL[i]) * (l[i] - refL[i]);
+            }
+        }
+        return 10.0 * std::log10(signal / error);
+    };
+
+    SECTION("A half-float delay tracks the float one in half the memory")
+    {
+        BasicStereoDelay<SampleStorage::Float16> delay;
+        REQUIRE(renderAgainstFloat(delay) > 60.0);
+        REQUIRE(2 * BasicStereoDelay<SampleStorage::Float16>::memoryNeeded(48000.0) == StereoDelay::memoryNeeded(48000.0));
+
+        std::vector<float> region(BasicStereoDelay<SampleStorage::Float16>::memoryNeeded(48000.0));
+        Arena arena(region.data(), region.size());
+        REQUIRE(delay.prepare(48000.0, arena));
+    }
+
+    SECTION("A 16-bit delay tracks the float one and goes silent")
+    {
+        BasicStereoDelay<SampleStorage::Int16> delay;
+        REQUIRE(renderAgainstFloat(delay) > 50.0);  // The dither recirculates with the feedback
+
+        std::vector<float> l(4096), r(4096);
+        for (int block = 0; block < 20; ++block)
+        {
+            std::fill(l.begin(), l.end(), 0.0f);
+            std::fill(r.begin(), r.end(), 0.0f);
+            delay.processBlock(l.data(), r.data(), 4096);
+        }
+        REQUIRE(Silence::isSilent(l.data(), r.data(), 4096));
+    }
+}
+
+TEST_CASE("AirwindowsTape's polynomial sin and asin track the library ones", "[effects]")
+{
+    for (double x = -40.0; x < 40.0; x += 0.00137)
+        REQUIRE(std::abs(AirwindowsTape::sine(x) - std::sin(x)) < 1.0e-10);
+    for (double x = -1.0; x <= 1.0; x += 0.0000913)
+        REQUIRE(std::abs(AirwindowsTape::arcsine(x) - std::asin(x)) < 2.0e-9);
+    REQUIRE(std::abs(AirwindowsTape::arcsine(1.0) - M_PI / 2) < 2.0e-9);
+    REQUIRE(std::abs(AirwindowsTape::arcsine(-1.0) + M_PI / 2) < 2.0e-9);
+}
+
+TEST_CASE("TapeDust passes audio untouched at zero mix", "[effects]")
+{
+    TapeDust dust;
+    dust.prepare(48000.0);
+    dust.setRange(0.8f);
+    dust.setMix(0.0f);
+    dust.setNoiseSeed(3);
+
+    std::vector<float> left(300), right(300);
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        left[i] = 0.3f * std::sin(0.01f * static_cast<float>(i));
+        right[i] = -left[i];
+    }
+    auto outL = left, outR = right;
+    dust.processBlock(outL.data(), outR.data(), static_cast<int>(outL.size()));
+    REQUIRE(outL == left);
+    REQUIRE(outR == right);
+
+    // Back on, the dust is there again
+    dust.setMix(0.5f);
+    dust.processBlock(outL.data(), outR.data(), static_cast<int>(outL.size()));
+    REQUIRE(outL != left);
+}
+
+TEST_CASE("Compressor holds its ratio with the log2-domain gain computer", "[effects]")
+{
+    SECTION("fastLog2 and fastExp2 are good to a hundredth of a dB")
+    {
+        for (float x = 1.0e-6f; x < 16.0f; x *= 1.01f)
+            REQUIRE(std::abs(Compressor::fastLog2(x) - std::log2(x)) < 0.001f);
+        for (float x = -30.0f; x < 4.0f; x += 0.01f)
+            REQUIRE(std::abs(Compressor::fastExp2(x) / std::exp2(x) - 1.0f) < 0.0002f);
+    }
+
+    SECTION("A steady sine comes out near threshold + (level - threshold) / ratio")
+    {
+        Compressor compressor;
+        compressor.prepare(48000.0);
+        compressor.setThreshold(-20.0f);
+        compressor.setRatio(4.0f);
+
+        // Full scale: -3 dB RMS in, so about -15.75 dB out
+        constexpr int N = 48000;
+        std::vector<float> left(N), right(N);
+        for (int i = 0; i < N; ++i)
+            left[i] = right[i] = std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / 48000.0f);
+        compressor.processBlock(left.data(), right.data(), N);
+
+        double power = 0.0;
+        for (int i = N / 2; i < N; ++i)
+            power += left[i] * left[i];
+        const double outDb = 10.0 * std::log10(power / (N / 2));
+        REQUIRE(outDb == Catch::Approx(-15.75).margin(1.0));
+    }
+}
+
+TEST_CASE("Galactic3ReverbPacked follows the exact Galactic3 within float rounding", "[effects]")
+{
+    // Half the delay-line memory
+    REQUIRE(sizeof(Galactic3ReverbPacked) < sizeof(Galactic3Reverb) / 2 + 1024);
+
+    auto run = [](float replace, float brightness, float detune, float bigness, float size) {
+        auto exact = std::make_unique<Galactic3Reverb>();
+        auto packed = std::make_unique<Galactic3ReverbPacked>();
+        exact->prepare(48000.0);
+        packed->prepare(48000.0);
+        exact->setReplace(replace);
+        packed->setReplace(replace);
+        exact->setBrightness(brightness);
+        packed->setBrightness(brightness);
+        exact->setDetune(detune);
+        packed->setDetune(detune);
+        exact->setBigness(bigness);
+        packed->setBigness(bigness);
+        exact->setSize(size);
+        packed->setSize(size);
+        REQUIRE(packed->getTailSamples() == exact->getTailSamples());
+
+        // A burst, then its tail, long enough for the vibrato to wrap
+        constexpr int BLOCK = 64;
+        double signal = 0.0, error = 0.0;
+        std::array<float, BLOCK> exactL{}, exactR{}, packedL{}, packedR{};
+        for (int block = 0; block < 48000 / BLOCK; ++block)
+        {
+            for (int i = 0; i < BLOCK; ++i)
+            {
+                const int n = block * BLOCK + i;
+                const float in = n < 2400 ? 0.5f * std::sin(0.031f * static_cast<float>(n)) : 0.0f;
+                exactL[i] = packedL[i] = in;
+                exactR[i] = packedR[i] = n < 2400 ? -in : 0.0f;
+            }
+            exact->processBlock(exactL.data(), exactR.data(), BLOCK);
+            packed->processBlock(packedL.data(), packedR.data(), BLOCK);
+            for (int i = 0; i < BLOCK; ++i)
+            {
+                signal += exactL[i] * exactL[i] + exactR[i] * exactR[i];
+                error += (packedL[i] - exactL[i]) * (packedL[i] - exactL[i]) +
+                         (packedR[i] - exactR[i]) * (packedR[i] - exactR[i]);
+            }
+        }
+        REQUIRE(signal > 1.0);
+        return 10.0 * std::log10(error / signal);
+    };
+
+    // Defaults, then long and dark, then short, bright and detuned
+    CHECK(run(0.5f, 0.5f, 0.5f, 0.5f, 0.5f) < -100.0);
+    CHECK(run(0.1f, 0.1f, 0.0f, 1.0f, 1.0f) < -100.0);
+    CHECK(run(0.8f, 1.0f, 1.0f, 0.1f, 0.0f) < -100.0);
+}
+
+TEST_CASE("Convolver matches direct convolution in any block size", "[effects]")
+{
+    // Head, five partitions and a short last one; left and right differ
+    constexpr size_t IR = 5 * Convolver::BLOCK + 60;
+    std::vector<float> irL(IR), irR(IR);
+    NoiseSource noise(7);
+    for (size_t i = 0; i < IR; ++i)
+    {
+        const float envelope = std::exp(-3.0f * static_cast<float>(i) / IR);
+        irL[i] = noise.unifPM1() * envelope;
+        irR[i] = noise.unifPM1() * envelope;
+    }
+    double energyL = 0.0, energyR = 0.0;
+    for (size_t i = 0; i < IR; ++i)
+    {
+        energyL += irL[i] * irL[i];
+        energyR += irR[i] * irR[i];
+    }
+    const double gain = 1.0 / std::sqrt(std::max(energyL, energyR));
+
+    constexpr int N = 4000;
+    std::vector<float> inL(N), inR(N);
+    for (int i = 0; i < N; ++i)
+    {
+        inL[i] = 0.5f * noise.unifPM1();
+        inR[i] = 0.5f * std::sin(0.05f * static_cast<float>(i));
+    }
+
+    auto render = [&](int blockSize, float mix) {
+        auto convolver = std::make_unique<Convolver>();
+        convolver->prepare(48000.0);
+        convolver->setMix(mix);
+        convolver->loadImpulse(irL.data(), irR.data(), IR, 48000.0);
+        REQUIRE(convolver->getImpulseSamples() == IR);
+        REQUIRE(convolver->getTailSamples() == 0);  // Not picked up yet
+
+        auto outL = inL, outR = inR;
+        for (int start = 0; start < N; start += blockSize)
+            convolver->processBlock(outL.data() + start, outR.data() + start, std::min(blockSize, N - start));
+        REQUIRE(convolver->getTailSamples() == static_cast<int64_t>(IR) + Convolver::BLOCK);
+        return std::make_pair(outL, outR);
+    };
+
+    SECTION("Past the first block's fade in, the wet signal is the convolution")
+    {
+        const auto [outL, outR] = render(Convolver::BLOCK, 1.0f);
+        double worst = 0.0;
+        for (int t = Convolver::BLOCK; t < N; ++t)
+        {
+            double wantL = 0.0, wantR = 0.0;
+            for (int m = 0; m < static_cast<int>(IR) && m <= t; ++m)
+            {
+                wantL += irL[static_cast<size_t>(m)] * inL[static_cast<size_t>(t - m)];
+                wantR += irR[static_cast<size_t>(m)] * inR[static_cast<size_t>(t - m)];
+            }
+            worst = std::max({worst, std::abs(outL[static_cast<size_t>(t)] - wantL * gain),
+                              std::abs(outR[static_cast<size_t>(t)] - wantR * gain)});
+        }
+        REQUIRE(worst < 1.0e-4);
+    }
+
+    SECTION("Blocks that straddle the partitions render the same")
+    {
+        const auto whole = render(Convolver::BLOCK, 0.4f);
+        for (int blockSize : {1, 37, 300, 512})
+        {
+            const auto split = render(blockSize, 0.4f);
+            for (int t = 0; t < N; ++t)
+            {
+                REQUIRE(split.first[static_cast<size_t>(t)] == Catch::Approx(whole.first[static_cast<size_t>(t)]).margin(1.0e-5));
+                REQUIRE(split.second[static_cast<size_t>(t)] == Catch::Approx(whole.second[static_cast<size_t>(t)]).margin(1.0e-5));
+            }
+        }
+    }
+
+    SECTION("At zero mix the audio passes untouched")
+    {
+        const auto [outL, outR] = render(100, 0.0f);
+        REQUIRE(outL == inL);
+        REQUIRE(outR == inR);
+    }
+
+    SECTION("A response at another rate is resampled to the engine's")
+    {
+        // A click 10 ms in, at 44.1 kHz, lands 10 ms in at 48 kHz
+        std::vector<float> click(882, 0.0f);
+        click[441] = 1.0f;
+        Convolver convolver;
+        convolver.prepare(48000.0);
+        convolver.setMix(1.0f);
+        convolver.loadImpulse(click.data(), nullptr, click.size(), 44100.0);
+
+        std::vector<float> left(2048, 0.0f), right(2048, 0.0f);
+        left[Convolver::BLOCK] = right[Convolver::BLOCK] = 1.0f;
+        convolver.processBlock(left.data(), right.data(), static_cast<int>(left.size()));
+        const auto peak = std::max_element(left.begin(), left.end(),
+                                           [](float a, float b) { return std::abs(a) < std::abs(b); });
+        REQUIRE(std::abs(static_cast<int>(peak - left.begin()) - (Convolver::BLOCK + 480)) <= 1);
+
+        // A mono response plays on both sides (to rounding: they share an FFT)
+        for (size_t i = 0; i < left.size(); ++i)
+            REQUIRE(right[i] == Catch::Approx(left[i]).margin(1.0e-6));
+    }
+}
+
+TEST_CASE("TapeReadHead wraps positions and interpolates the tape", "[readhead]")
+{
+    // A slow sine on a 1000-sample loop, in tape units
+    constexpr int LOOP = 1000;
+    std::vector<int16_t> tape(LOOP);
+    auto sine = [](double pos) { return 16000.0 * std::sin(2.0 * 3.14159265358979 * 5.0 * pos / LOOP); };
+    for (int i = 0; i < LOOP; ++i)
+        tape[static_cast<size_t>(i)] = static_cast<int16_t>(std::lrint(sine(i)));
+
+    TapeReadHead head;
+    head.setLoop(LOOP);
+
+    SECTION("Positions wrap into the loop from either side")
+    {
+        std::array<float, 6> positions{-0.25f, -1500.5f, 0.0f, 999.75f, 1000.0f, 2999.5f};
+        head.wrapBlock(positions.data(), static_cast<int>(positions.size()));
+        for (float p : positions)
+        {
+            REQUIRE(p >= 0.0f);
+            REQUIRE(p < static_cast<float>(LOOP));
+        }
+        REQUIRE(positions[0] == Catch::Approx(999.75f));
+        REQUIRE(positions[1] == Catch::Approx(499.5f));
+        REQUIRE(positions[4] == 0.0f);
+        REQUIRE(positions[5] == Catch::Approx(999.5f));
+    }
+
+    SECTION("Every order tracks the sine, across the loop point too")
+    {
+        for (int mode : {TapeReadHead::Linear, TapeReadHead::Hermite, TapeReadHead::Sinc})
+        {
+            head.setInterpolation(mode);
+            REQUIRE(head.getInterpolation() == mode);
+
+            float worst = 0.0f;
+            for (float p = 0.0f; p < LOOP; p += 0.37f)
+                worst = std::max(worst, std::abs(head.read(tape.data(), p) - static_cast<float>(sine(p))));
+
+            // Sinc trades a little low-frequency accuracy (256 phases, 0.85
+            // cutoff) for its flat, alias-free top end
+            const float limit = mode == TapeReadHead::Linear ? 4.0f : mode == TapeReadHead::Hermite ? 1.0f : 8.0f;
+            REQUIRE(worst < limit);
+        }
+    }
+
+    SECTION("Sample positions read the samples")
+    {
+        for (int mode : {TapeReadHead::Linear, TapeReadHead::Hermite})
+        {
+            head.setInterpolation(mode);
+            for (int i : {0, 1, 500, LOOP - 1})
+                REQUIRE(head.read(tape.data(), static_cast<float>(i)) == tape[static_cast<size_t>(i)]);
+        }
+    }
+
+    SECTION("A block read adds what read() returns, scaled")
+    {
+        std::array<float, 64> positions{};
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i] = 990.0f + 0.31f * static_cast<float>(i);  // Across the loop point
+        head.wrapBlock(positions.data(), static_cast<int>(positions.size()));
+
+        for (int mode : {TapeReadHead::Linear, TapeReadHead::Hermite, TapeReadHead::Sinc})
+        {
+            head.setInterpolation(mode);
+            std::array<float, 64> out;
+            out.fill(1.0f);
+            head.readBlock(tape.data(), positions.data(), 0.5f, out.data(), static_cast<int>(out.size()));
+            for (size_t i = 0; i < out.size(); ++i)
+                REQUIRE(out[i] == 1.0f + 0.5f * head.read(tape.data(), positions[i]));
+        }
+    }
+
+    SECTION("Fast reads are band-limited; 1x and slower read as before")
+    {
+        // Near Nyquist, a tone that a 4x read would alias down
+        std::vector<int16_t> high(LOOP);
+        for (int i = 0; i < LOOP; ++i)
+            high[static_cast<size_t>(i)] = static_cast<int16_t>(i % 2 == 0 ? 16000 : -16000);
+
+        for (float speed : {-4.0f, 2.5f, 4.0f})
+        {
+            float peak = 0.0f;
+            for (float p = 0.0f; p < LOOP; p += 1.37f)
+            {
+                peak = std::max(peak, std::abs(head.read(high.data(), p, speed)));
+                REQUIRE(head.read(tape.data(), p, speed) == Catch::Approx(sine(p)).margin(600.0));
+            }
+            REQUIRE(peak < 1600.0f);
+        }
+
+        for (float speed : {1.0f, 0.25f, -1.0f})
+        {
+            for (float p : {0.0f, 10.3f, 999.9f})
+                REQUIRE(head.read(tape.data(), p, speed) == head.read(tape.data(), p));
+        }
+    }
+
+    SECTION("Out-of-range modes clamp")
+    {
+        head.setInterpolation(7);
+        REQUIRE(head.getInterpolation() == TapeReadHead::Sinc);
+        head.setInterpolation(-1);
+        REQUIRE(head.getInterpolation() == TapeReadHead::Linear);
+    }
+}
+
+TEST_CASE("TapeState saves the tape and streams it back", "[state]")
+{
+    TapeLoopEngine source;
+    source.prepare(48000.0, 512);
+    source.setNoiseSeed(9);
+    source.setLoopLength(1.0f);
+    source.setLoopFeedback(0.9f);
+
+    // Record half a loop, so the tape has both music and silence
+    std::array<float, 480> left{};
+    std::array<float, 480> right{};
+    source.noteOn(57, 1.0f);
+    for (int block = 0; block < 50; ++block)
+        source.renderBlock(left.data(), right.data(), 480);
+    source.noteOff(57);
+
+    const size_t samples = source.getLoopSamples();
+    REQUIRE(samples == 48000);
+    const auto blob = TapeState::encode(source.getTapeL(), source.getTapeR(), samples,
+                                        source.getTapeWritePos(), 48000);
+
+    // Lossless, and well under the raw 16-bit size
+    REQUIRE(blob.size() < samples * 4 / 2);
+
+    TapeState::TapeStateReader reader;
+    REQUIRE(reader.open(blob.data(), blob.size()));
+    REQUIRE(reader.getSamples() == samples);
+    REQUIRE(reader.getSampleRate() == 48000);
+
+    TapeLoopEngine restored;
+    restored.prepare(48000.0, 512);
+    int calls = 0;
+    while (reader.pending())
+    {
+        reader.streamInto(restored);
+        ++calls;
+    }
+    REQUIRE_FALSE(reader.failed());
+    REQUIRE(calls == static_cast<int>((samples + TapeState::CHUNK_SAMPLES - 1) / TapeState::CHUNK_SAMPLES));
+    REQUIRE(restored.getTapeWritePos() == source.getTapeWritePos());
+    REQUIRE(std::equal(source.getTapeL(), source.getTapeL() + samples, restored.getTapeL()));
+    REQUIRE(std::equal(source.getTapeR(), source.getTapeR() + samples, restored.getTapeR()));
+
+    SECTION("An empty tape costs a few bytes per chunk")
+    {
+        TapeLoopEngine blank;
+        blank.prepare(48000.0, 512);
+        const auto empty = TapeState::encode(blank.getTapeL(), blank.getTapeR(), samples, 0, 48000);
+        REQUIRE(empty.size() == TapeState::HEADER_BYTES + 12 * TapeState::CHUNK_HEADER_BYTES);
+    }
+
+    SECTION("Damaged blobs are refused or stop cleanly")
+    {
+        REQUIRE_FALSE(reader.open(blob.data(), 10));
+        REQUIRE_FALSE(reader.pending());
+
+        auto truncated = blob;
+        truncated.resize(blob.size() / 2);
+        REQUIRE_FALSE(reader.open(truncated.data(), truncated.size()));
+
+        // Corrupt payloads must never write past the tape or hang
+        auto scrambled = blob;
+        for (size_t i = TapeState::HEADER_BYTES + TapeState::CHUNK_HEADER_BYTES; i < scrambled.size(); i += 7)
+            scrambled[i] = static_cast<uint8_t>(scrambled[i] * 31 + 17);
+        if (reader.open(scrambled.data(), scrambled.size()))
+        {
+            while (reader.pending())
+                reader.streamInto(restored);
+        }
+        REQUIRE_FALSE(reader.pending());
+    }
+}
+
+TEST_CASE("TapeSnapshot streams the loop as it was while recording goes on", "[state]")
+{
+    TapeLoopEngine engine;
+    engine.prepare(48000.0, 512);
+    engine.setNoiseSeed(9);
+    engine.setLoopLength(1.0f);
+    engine.setLoopFeedback(0.9f);
+
+    std::array<float, 480> left{};
+    std::array<float, 480> right{};
+    engine.noteOn(50, 1.0f);
+    for (int block = 0; block < 150; ++block)
+        engine.renderBlock(left.data(), right.data(), 480);
+
+    // The loop from the write position on, as the next block will find it
+    const size_t loop = engine.getLoopSamples();
+    auto expect = [&engine, loop](const int16_t* tape) {
+        std::vector<int16_t> rotated(loop);
+        for (size_t i = 0; i < loop; ++i)
+            rotated[i] = tape[(engine.getTapeWritePos() + i) % loop];
+        return rotated;
+    };
+    const std::vector<int16_t> expectL = expect(engine.getTapeL());
+    const std::vector<int16_t> expectR = expect(engine.getTapeR());
+
+    TapeSnapshot& snapshot = engine.getTapeSnapshot();
+    snapshot.prepare(engine.getTapeBufferSize());
+    snapshot.request();
+    REQUIRE(snapshot.isRequested());
+    engine.renderBlock(left.data(), right.data(), 480);
+    REQUIRE(snapshot.isActive());
+    REQUIRE(snapshot.getLength() == loop);
+
+    std::vector<int16_t> gotL, gotR;
+    std::array<int16_t, TapeSnapshot::SEGMENT_SAMPLES> chunkL{};
+    std::array<int16_t, TapeSnapshot::SEGMENT_SAMPLES> chunkR{};
+    auto readOne = [&] {
+        const size_t n = snapshot.readNext(chunkL.data(), chunkR.data());
+        gotL.insert(gotL.end(), chunkL.begin(), chunkL.begin() + static_cast<std::ptrdiff_t>(n));
+        gotR.insert(gotR.end(), chunkR.begin(), chunkR.begin() + static_cast<std::ptrdiff_t>(n));
+        return n;
+    };
+
+    SECTION("Segments the record head reaches first are copied; the rest are read from the tape")
+    {
+        // The head keeps a little ahead of the reader for a while, then the
+        // reader overtakes it
+        for (int block = 0; block < 4; ++block)
+        {
+            for (int i = 0; i < 10; ++i)
+                engine.renderBlock(left.data(), right.data(), 480);
+            readOne();
+        }
+        while (readOne() > 0)
+            engine.renderBlock(left.data(), right.data(), 480);
+
+        REQUIRE_FALSE(snapshot.failed());
+        REQUIRE(gotL == expectL);
+        REQUIRE(gotR == expectR);
+        REQUIRE(snapshot.getCopiedSegments() > 1);
+        REQUIRE(snapshot.getCopiedSegments() < loop / TapeSnapshot::SEGMENT_SAMPLES);
+        snapshot.finish();
+    }
+
+    SECTION("A reader on another thread gets the same while blocks render")
+    {
+        std::thread reader([&] {
+            while (readOne() > 0)
+                std::this_thread::yield();
+        });
+        for (int block = 0; block < 200 && snapshot.isActive(); ++block)
+            engine.renderBlock(left.data(), right.data(), 480);
+        reader.join();
+
+        REQUIRE_FALSE(snapshot.failed());
+        REQUIRE(gotL == expectL);
+        REQUIRE(gotR == expectR);
+        snapshot.finish();
+    }
+
+    SECTION("A record head that outruns the pool fails the snapshot instead of waiting")
+    {
+        snapshot.finish();
+        snapshot.prepare(engine.getTapeBufferSize(), 2);
+        snapshot.request();
+        for (int block = 0; block < 100; ++block)
+            engine.renderBlock(left.data(), right.data(), 480);
+
+        REQUIRE(snapshot.failed());
+        REQUIRE(readOne() == 0);
+        snapshot.finish();
+        REQUIRE_FALSE(snapshot.isActive());
+    }
+}
+
+TEST_CASE("PluginState round-trips parameters and chunks", "[state]")
+{
+    const std::vector<uint8_t> tape = {1, 2, 3, 4, 5};
+    const std::vector<uint8_t> other = {9, 9};
+
+    PluginState::Writer writer(3);
+    writer.addParameter(PluginState::idHash("loop_length"), 2.5f);
+    writer.addParameter(PluginState::idHash("loop_feedback"), 0.85f);
+    writer.addParameter(PluginState::idHash("seq_bpm"), 120.0f);
+    writer.addChunk(PluginState::tag("XTRA"), other.data(), other.size());
+    writer.addChunk(PluginState::tag("TAPE"), tape.data(), tape.size());
+    writer.addParameter(PluginState::idHash("late"), 1.0f);  // After a chunk: dropped
+
+    const auto& state = writer.data();
+    REQUIRE(state.size() == PluginState::HEADER_BYTES + 3 * PluginState::PARAMETER_BYTES
+                                + 2 * PluginState::CHUNK_HEADER_BYTES + other.size() + tape.size());
+    REQUIRE(PluginState::isState(state.data(), state.size()));
+
+    std::vector<std::pair<uint32_t, float>> parameters;
+    std::vector<uint8_t> tapeOut;
+    int chunks = 0;
+    auto onParameter = [&](uint32_t hash, float value) { parameters.emplace_back(hash, value); };
+    auto onChunk = [&](uint32_t chunkTag, const uint8_t* data, size_t size) {
+        ++chunks;
+        if (chunkTag == PluginState::tag("TAPE"))
+            tapeOut.assign(data, data + size);
+    };
+
+    REQUIRE(PluginState::read(state.data(), state.size(), onParameter, onChunk));
+    REQUIRE(parameters.size() == 3);
+    REQUIRE(parameters[0].first == PluginState::idHash("loop_length"));
+    REQUIRE(parameters[0].second == 2.5f);
+    REQUIRE(parameters[2].first == PluginState::idHash("seq_bpm"));
+    REQUIRE(parameters[2].second == 120.0f);
+    REQUIRE(chunks == 2);
+    REQUIRE(tapeOut == tape);
+
+    SECTION("A cut-short state reports what it has and fails")
+    {
+        parameters.clear();
+        chunks = 0;
+        REQUIRE_FALSE(PluginState::read(state.data(), state.size() - 1, onParameter, onChunk));
+        REQUIRE(parameters.size() == 3);
+        REQUIRE(chunks == 1);
+
+        parameters.clear();
+        REQUIRE_FALSE(PluginState::read(state.data(), PluginState::HEADER_BYTES + 4, onParameter, onChunk));
+        REQUIRE(parameters.empty());
+    }
+
+    SECTION("Older states aren't taken for one")
+    {
+        const char xml[] = "VC2!<?xml version=\"1.0\"?>";
+        REQUIRE_FALSE(PluginState::isState(xml, sizeof(xml)));
+        REQUIRE_FALSE(PluginState::isState(state.data(), 8));
+        REQUIRE_FALSE(PluginState::read(xml, sizeof(xml), onParameter, onChunk));
+    }
+
+    SECTION("A state from a newer build is refused whole")
+    {
+        REQUIRE(PluginState::getVersion(state.data(), state.size()) == PluginState::VERSION);
+        REQUIRE(PluginState::canRead(state.data(), state.size()));
+
+        auto newer = state;
+        newer[4] = static_cast<uint8_t>(PluginState::VERSION + 1);
+        REQUIRE(PluginState::isState(newer.data(), newer.size()));
+        REQUIRE_FALSE(PluginState::canRead(newer.data(), newer.size()));
+
+        parameters.clear();
+        chunks = 0;
+        REQUIRE_FALSE(PluginState::read(newer.data(), newer.size(), onParameter, onChunk));
+        REQUIRE(parameters.empty());
+        REQUIRE(chunks == 0);
+
+        newer[4] = 0;  // No version was ever 0
+        REQUIRE_FALSE(PluginState::canRead(newer.data(), newer.size()));
+    }
+}
+
+namespace
+{
+// The members PluginState::applyParameters() uses, named as juce's
+// AudioProcessorParameter and RangedAudioParameter name them
+struct StubParameter
+{
+    virtual ~StubParameter() = default;
+};
+
+struct StubRangedParameter : StubParameter
+{
+    struct ID
+    {
+        std::string id;
+        const char* toRawUTF8() const { return id.c_str(); }
+    };
+
+    StubRangedParameter(std::string id, float maxValue, float defaultValue)
+        : paramID{std::move(id)}, maxValue(maxValue), defaultValue(defaultValue)
+    {
+    }
+
+    float convertTo0to1(float plain) const { return plain / maxValue; }
+    float getDefaultValue() const { return defaultValue; }
+    void setValueNotifyingHost(float v) { value = v; }
+
+    ID paramID;
+    float maxValue;
+    float defaultValue;
+    float value = -1.0f;
+};
+} // namespace
+
+TEST_CASE("PluginState sets each parameter from its saved value or its default", "[state]")
+{
+    PluginState::Writer writer(4);
+    writer.addParameter(PluginState::idHash("loop_length"), 2.5f);
+    writer.addParameter(PluginState::idHash("seq_bpm"), 120.0f);
+    writer.addParameter(PluginState::idHash("loop_length"), 4.0f);  // A repeat: the first stands
+    writer.addParameter(PluginState::idHash("loop_feedback"), std::numeric_limits<float>::quiet_NaN());
+    writer.addParameter(PluginState::idHash("removed"), 1.0f);  // Not a parameter any more
+    const auto& state = writer.data();
+
+    PluginState::Values saved;
+    REQUIRE(PluginState::read(state.data(), state.size(), saved.collector(), [](uint32_t, const uint8_t*, size_t) {}));
+    REQUIRE(saved.size() == 4);
+    REQUIRE(saved.find(PluginState::idHash("missing")) == nullptr);
+    REQUIRE(saved.find(PluginState::idHash("loop_feedback")) == nullptr);  // Not finite
+    REQUIRE(*saved.find(PluginState::idHash("loop_length")) == 2.5f);
+
+    StubRangedParameter length("loop_length", 10.0f, 0.1f);
+    StubRangedParameter bpm("seq_bpm", 240.0f, 0.5f);
+    StubRangedParameter feedback("loop_feedback", 1.0f, 0.7f);
+    StubRangedParameter added("loop_added", 1.0f, 0.25f);
+    StubParameter unranged;
+    const std::vector<StubParameter*> parameters = {&length, &unranged, &bpm, &feedback, &added};
+
+    PluginState::applyParameters<StubRangedParameter>(saved, parameters);
+    REQUIRE(length.value == Approx(0.25f));
+    REQUIRE(bpm.value == Approx(0.5f));
+    REQUIRE(feedback.value == 0.7f);  // Unreadable: the default
+    REQUIRE(added.value == 0.25f);    // Newer than the state: the default
+}
+
+TEST_CASE("TapeLoopEngine prepares off the calling thread and reuses its tape", "[engine]")
+{
+    TapeLoopEngine engine;
+    AsyncPrepare preparer;
+
+    preparer.start([&engine] { engine.prepare(96000.0, 512); });
+    preparer.wait();
+    REQUIRE(preparer.isReady());
+    REQUIRE(engine.getTapeBufferSize() == static_cast<size_t>(96000 * TapeLoopEngine::MAX_LOOP_SECONDS));
+
+    // A lower rate fits in the tape already there
+    const int16_t* tape = engine.getTapeL();
+    preparer.start([&engine] { engine.prepare(48000.0, 512); });
+    preparer.wait();
+    REQUIRE(engine.getTapeL() == tape);
+    REQUIRE(engine.getTapeBufferSize() == static_cast<size_t>(48000 * TapeLoopEngine::MAX_LOOP_SECONDS));
+
+    std::array<float, 512> left{};
+    std::array<float, 512> right{};
+    engine.noteOn(60, 1.0f);
+    for (int block = 0; block < 20; ++block)
+        engine.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(std::all_of(left.begin(), left.end(), [](float s) { return std::isfinite(s); }));
+
+    preparer.reset();
+    REQUIRE_FALSE(preparer.isReady());
+
+    // Offline renders prepare where they're called
+    preparer.start([&engine] { engine.prepare(44100.0, 512); }, false);
+    REQUIRE(preparer.isReady());
+}
+
+TEST_CASE("TapeLoopEngine reports the latency of its stages", "[engine]")
+{
+    TapeLoopEngine engine;
+    engine.prepare(48000.0, 512);
+    REQUIRE(engine.getLatencySamples() == 0);
+
+    engine.setOversampling(2);
+    REQUIRE(engine.getLatencySamples() == Oversampler::LATENCY);
+
+    const int lookahead = static_cast<int>(std::round(Compressor::LOOKAHEAD_MS * 0.001 * 48000.0));
+    engine.setCompLookahead(true);
+    REQUIRE(engine.getLatencySamples() == Oversampler::LATENCY + lookahead);
+
+    // The oversampler only delays while the Airwindows stage is in use
+    engine.setTapeModel(1);
+    REQUIRE(engine.getLatencySamples() == lookahead);
+
+    SECTION("The compressor's lookahead delays dry and wet alike")
+    {
+        Compressor compressor;
+        compressor.prepare(48000.0);
+        compressor.setLookahead(true);
+        compressor.setThreshold(-40.0f);
+        REQUIRE(compressor.getLatency() == lookahead);
+
+        for (float mix : {0.0f, 1.0f})
+        {
+            compressor.setMix(mix);
+            compressor.setLookahead(false);
+            compressor.setLookahead(true);
+
+            std::vector<float> left(1024, 0.0f);
+            std::vector<float> right(1024, 0.0f);
+            left[100] = 1.0f;
+            compressor.processBlock(left.data(), right.data(), 1024);
+
+            const auto peak = std::max_element(left.begin(), left.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
+            REQUIRE(peak - left.begin() == 100 + lookahead);
+            REQUIRE(*peak > 0.0f);
+        }
+    }
+}
+
+TEST_CASE("TapeLoopEngine runs at its render rate whatever the host's", "[engine][rate]")
+{
+    // A sine drone straight to the output, to count its cycles
+    const auto drone = [](TapeLoopEngine& engine, double hostRate, int block) {
+        engine.setOsc1Waveform(0);
+        engine.setOsc2Level(0.0f);
+        engine.setLoopLevel(0.0f);
+        engine.setDryLevel(1.0f);
+        engine.noteOn(69, 1.0f);
+
+        std::vector<float> left(static_cast<size_t>(block)), right(static_cast<size_t>(block));
+        std::vector<float> out;
+        while (out.size() < static_cast<size_t>(hostRate))
+        {
+            engine.renderBlock(left.data(), right.data(), block);
+            out.insert(out.end(), left.begin(), left.end());
+        }
+        out.resize(static_cast<size_t>(hostRate));
+        return out;
+    };
+
+    const auto crossings = [](const std::vector<float>& x) {
+        int count = 0;
+        for (size_t i = x.size() / 2; i + 1 < x.size(); ++i)
+            count += (x[i] < 0.0f) != (x[i + 1] < 0.0f) ? 1 : 0;
+        return count;
+    };
+
+    TapeLoopEngine native;
+    native.prepare(48000.0, 512);
+    const auto reference = drone(native, 48000.0, 512);
+    REQUIRE(crossings(reference) > 400);
+
+    for (const double hostRate : {44100.0, 96000.0, 192000.0})
+    {
+        for (const int block : {1, 64, 1024})
+        {
+            TapeLoopEngine engine;
+            engine.setRenderRate(FixedRateRenderer::DEFAULT_RATE);
+            engine.prepare(hostRate, block);
+            REQUIRE(engine.getSampleRate() == FixedRateRenderer::DEFAULT_RATE);
+            REQUIRE(engine.getLoopSamples() == native.getLoopSamples());
+
+            // Same pitch, same level, at the host's rate
+            const auto out = drone(engine, hostRate, block);
+            REQUIRE(std::abs(crossings(out) - crossings(reference)) <= 2);
+
+            const auto peak = [](const std::vector<float>& x) {
+                return std::abs(*std::max_element(x.begin() + x.size() / 2, x.end(),
+                                                  [](float a, float b) { return std::abs(a) < std::abs(b); }));
+            };
+            REQUIRE(peak(out) == Approx(peak(reference)).margin(0.02));
+        }
+    }
+
+    SECTION("Offsets and latency are in host samples")
+    {
+        TapeLoopEngine engine;
+        engine.setRenderRate(48000.0);
+        engine.prepare(96000.0, 512);
+
+        const int resampler = engine.getLatencySamples();
+        REQUIRE(resampler > 0);
+        REQUIRE(resampler < 16);
+
+        engine.setCompLookahead(true);
+        const int lookahead = static_cast<int>(std::round(Compressor::LOOKAHEAD_MS * 0.001 * 48000.0));
+        REQUIRE(std::abs(engine.getLatencySamples() - (resampler + 2 * lookahead)) <= 1);
+    }
+
+    SECTION("No render rate, or the host's own, runs straight through")
+    {
+        TapeLoopEngine engine;
+        engine.prepare(96000.0, 512);
+        REQUIRE(engine.getSampleRate() == 96000.0);
+
+        engine.setRenderRate(96000.0);
+        engine.prepare(96000.0, 512);
+        REQUIRE(engine.getLatencySamples() == 0);
+    }
+
+    SECTION("Renders without allocating or locking")
+    {
+        TapeLoopEngine engine;
+        engine.setRenderRate(48000.0);
+        engine.prepare(192000.0, 512);
+
+        std::array<float, 512> left{}, right{}, input{};
+        const auto rt = RealtimeGuard::check([&] {
+            for (int i = 0; i < 100; ++i)
+            {
+                engine.noteOn(48 + (i % 12), 0.8f, i % 512);
+                engine.renderBlock(input.data(), input.data(), left.data(), right.data(), 512);
+            }
+        });
+
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.deallocations == 0);
+        REQUIRE(rt.locks == 0);
+    }
+}
+
+TEST_CASE("TapeLoopEngine renders without allocating or locking", "[engine][realtime]")
+{
+    TapeLoopEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+TEST_CASE("TapeLoopEngine traces its stages into a Chrome trace file", "[engine][trace]")
+{
+    TapeLoopEngine engine;
+    constexpr int bufferSize = 256;
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+    engine.prepare(48000.0, bufferSize);
+
+    const auto path = (std::filesystem::temp_directory_path() / "TapeLoop-trace-test.json").string();
+    {
+        TraceDumper dumper(path, "TapeLoop");
+        REQUIRE(dumper.isOpen());
+        dumper.addRing(engine.getTrace(), "audio");
+        dumper.start();
+
+        engine.noteOn(48, 0.8f);
+        for (int i = 0; i < 20; ++i)
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        dumper.stop();
+    }
+
+    std::ifstream in(path);
+    const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+
+    // A complete file whatever the build, with the stages in SYNTH_TRACE builds
+    REQUIRE(json.rfind("{\"traceEvents\":[", 0) == 0);
+    REQUIRE(json.find("]}") != std::string::npos);
+    REQUIRE(json.find("\"TapeLoop\"") != std::string::npos);
+
+    const bool hasStages = json.find("\"renderBlock\"") != std::string::npos
+                        && json.find("\"tape\"") != std::string::npos
+                        && json.find("\"degradation\"") != std::string::npos;
+    REQUIRE(hasStages == TraceRing::ENABLED);
+    REQUIRE(engine.getTrace().getDropped() == 0);
+}
+
+TEST_CASE("TraceRing keeps the oldest events when the reader falls behind", "[trace]")
+{
+    if constexpr (!TraceRing::ENABLED)
+        return;  // Nothing is recorded without SYNTH_TRACE
+
+    auto ring = std::make_unique<TraceRing>();
+    for (size_t i = 0; i < TraceRing::CAPACITY + 10; ++i)
+        ring->instant("test", "tick", static_cast<int>(i));
+
+    int expected = 0;
+    const size_t drained = ring->drain([&](const TraceRing::Event& e) { REQUIRE(e.arg == expected++); });
+    REQUIRE(drained == TraceRing::CAPACITY);
+    REQUIRE(ring->getDropped() == 10);
+}
+
+TEST_CASE("TapeLoopEngine stays within its memory budget", "[engine][memory]")
+{
+    // The tape dominates: 60 s of 16-bit stereo, so it scales with the rate
+    constexpr size_t BUDGET_48K = 16u << 20;
+    constexpr size_t BUDGET_192K = 64u << 20;
+
+    const auto reports = projectMemory<TapeLoopEngine>({48000.0, 192000.0});
+    const MemoryReport& at48k = reports[0].second;
+    const MemoryReport& at192k = reports[1].second;
+    INFO("48 kHz:\n" << at48k.toString() << "192 kHz:\n" << at192k.toString());
+
+    const size_t tape48k = static_cast<size_t>(60 * 48000) * 2 * sizeof(int16_t);
+    REQUIRE(at48k.getBytes("tape") == tape48k);
+    REQUIRE(at192k.getBytes("tape") == tape48k * 4);
+    REQUIRE(at48k.getBytes("delay") > 0);
+    REQUIRE(at48k.getStaticBytes() == sizeof(TapeLoopEngine));
+    REQUIRE(at48k.getStaticBytes() > at48k.getBytes("reverb"));
+    REQUIRE(at192k.getSharedBytes() == at48k.getSharedBytes());
+
+    CHECK(at48k.getInstanceBytes() <= BUDGET_48K);
+    CHECK(at192k.getInstanceBytes() <= BUDGET_192K);
+}
+
+TEST_CASE("Lazy effects hold their lines only while they're on", "[engine][memory]")
+{
+    constexpr double SR = 48000.0;
+    auto engine = std::make_unique<TapeLoopEngine>();
+    engine->setLazyEffects(true);
+    engine->setDelayMix(0.0f);
+    engine->setReverbMix(0.0f);
+    engine->prepare(SR, 512);
+
+    std::vector<float> left(512), right(512);
+    const auto render = [&](int blocks) {
+        for (int b = 0; b < blocks; ++b)
+            engine->renderBlock(left.data(), right.data(), 512);
+    };
+
+    render(4);
+    REQUIRE_FALSE(engine->needsEffectService());
+    REQUIRE(engine->memoryReport().getBytes("delay") == 0);
+    REQUIRE(engine->memoryReport().getBytes("reverb lines") == 0);
+
+    // Switched on: asked for on the audio thread, allocated off it, attached at the next block
+    engine->setDelayMix(0.5f);
+    engine->setReverbMix(0.3f);
+    render(1);
+    REQUIRE(engine->needsEffectService());
+    REQUIRE(engine->memoryReport().getBytes("delay") == 0);
+    engine->serviceEffects();
+    REQUIRE_FALSE(engine->needsEffectService());
+    render(1);
+    REQUIRE(engine->memoryReport().getBytes("delay") == StereoDelay::memoryNeeded(SR) * sizeof(float));
+    REQUIRE(engine->memoryReport().getBytes("reverb lines") > 0);
+
+    // Switched off: kept for a while in case it comes back, then let go
+    engine->setDelayMix(0.0f);
+    engine->setReverbMix(0.0f);
+    const int releaseBlocks = static_cast<int>(LazyEffect<StereoDelay>::RELEASE_SECONDS * SR / 512);
+    render(releaseBlocks - 2);
+    REQUIRE_FALSE(engine->needsEffectService());
+    render(4);
+    REQUIRE(engine->needsEffectService());
+    engine->serviceEffects();
+    REQUIRE_FALSE(engine->needsEffectService());
+    REQUIRE(engine->memoryReport().getBytes("delay") == 0);
+    REQUIRE(engine->memoryReport().getBytes("reverb lines") == 0);
+}
+
+TEST_CASE("A lazy delay fades in on a block that arrived late", "[effects]")
+{
+    constexpr double SR = 48000.0;
+    constexpr int N = 1024;
+    LazyEffect<StereoDelay> delay;
+    delay.prepare(SR, true);
+    delay->setTime(0.001f);
+    delay->setFeedback(0.0f);
+    delay->setMix(1.0f);
+    delay.setWanted(true);
+
+    std::vector<float> left(N, 1.0f), right(N, 1.0f);
+
+    // No lines yet: the input passes
+    REQUIRE_FALSE(delay.update(N));
+    REQUIRE(delay.needsService());
+    delay.service();
+    REQUIRE(delay.update(N));
+    REQUIRE(delay.isAttached());
+
+    // Fully wet from empty lines, the output ramps from the input down, then follows the delay
+    delay.process(left.data(), right.data(), N);
+    REQUIRE(left[0] == Catch::Approx(1.0f).margin(0.01f));
+    for (int i = 1; i < 48; ++i)
+        REQUIRE(left[i] <= left[i - 1]);
+    for (int i = LazyEffect<StereoDelay>::FADE_SAMPLES; i < N; ++i)
+        REQUIRE(left[i] == Catch::Approx(1.0f));
+}
@@ -41,10 +41,11 @@ const getNormalized = (paramId: string, rawValue: number): number => {
  * Main Tape Loop UI
  */
 const App: React.FC = () => {
-  const { isConnected, juceInfo, audioData } = useJUCEBridge({
-    enableAudioData: true,
-    audioChannel: 'master',
-  });
+  const { isConnected, juceInfo, audioData, impulseName, loadImpulse, clearImpulse, tapeExport, exportTape } =
+    useJUCEBridge({
+      enableAudioData: true,
+      audioChannel: 'master',
+    });
 
   const { paramValues, handleChange } = useParameters({
     parameters: PARAMETER_DEFINITIONS,
@@ -305,6 +306,10 @@ const App: React.FC = () => {
           value={getDenormalized('record_level', paramValues.record_level ?? 0.5)}
           onChange={(v) => handleChange('record_level', getNormalized('record_level', v))}
         />
+        <div style={styles.impulse}>
+          <button style={styles.impulseButton} onClick={exportTape}>EXPORT WAV</button>
+          <span style={styles.impulseName}>{tapeExport}</span>
+        </div>
       </SynthRow>
 
       {/* TAPE CHARACTER */}
@@ -482,6 +487,22 @@ const App: React.FC = () => {
         />
       </SynthRow>
 
+      {/* CONVOLUTION - loaded impulse response */}
+      <SynthRow label="CONVOLUTION">
+        <div style={styles.impulse}>
+          <button style={styles.impulseButton} onClick={loadImpulse}>LOAD IR</button>
+          <button style={styles.impulseButton} onClick={clearImpulse} disabled={!impulseName}>CLEAR</button>
+          <span style={styles.impulseName}>{impulseName || 'No impulse response'}</span>
+        </div>
+        <SynthKnob
+          label="MIX"
+          min={0}
+          max={1}
+          value={getDenormalized('conv_mix', paramValues.conv_mix ?? 0)}
+          onChange={(v) => handleChange('conv_mix', getNormalized('conv_mix', v))}
+        />
+      </SynthRow>
+
       {/* COMPRESSOR */}
       <SynthRow label="COMPRESSOR">
         <SynthKnob
@@ -505,6 +526,11 @@ const App: React.FC = () => {
           value={getDenormalized('comp_mix', paramValues.comp_mix ?? 0)}
           onChange={(v) => handleChange('comp_mix', getNormalized('comp_mix', v))}
         />
+        <SynthToggle
+          label="LOOKAHEAD"
+          value={(paramValues.comp_lookahead ?? 0) > 0.5}
+          onChange={(v: boolean) => handleChange('comp_lookahead', v ? 1 : 0)}
+        />
       </SynthRow>
 
       {/* VOICE FM TO LOOP */}
@@ -683,6 +709,26 @@ const styles: Record<string, React.CSSProperties> = {
     alignItems: 'center',
     gap: '8px',
   },
+  impulse: {
+    display: 'flex',
+    alignItems: 'center',
+    gap: '8px',
+  },
+  impulseButton: {
+    padding: '6px 12px',
+    background: '#222',
+    border: '1px solid #444',
+    borderRadius: '4px',
+    color: '#ff8844',
+    fontSize: '11px',
+    letterSpacing: '1px',
+    cursor: 'pointer',
+  },
+  impulseName: {
+    fontSize: '12px',
+    color: '#999',
+    minWidth: '140px',
+  },
   debug: {
     marginTop: '24px',
     padding: '12px',
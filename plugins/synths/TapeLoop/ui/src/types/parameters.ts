@@ -193,6 +193,51 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: 0,
   },
 
+  tape_oversampling: {
+    id: 'tape_oversampling',
+    name: 'Tape Oversampling',
+    min: 0,
+    max: 2,
+    default: 0,
+    step: 1,
+  },
+
+  tape_interpolation: {
+    id: 'tape_interpolation',
+    name: 'Tape Interpolation',
+    min: 0,
+    max: 2,
+    default: 0,
+    step: 1,
+  },
+
+  tape_wear_on_record: {
+    id: 'tape_wear_on_record',
+    name: 'Wear On Record',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
+
+  tape_speed: {
+    id: 'tape_speed',
+    name: 'Tape Speed',
+    min: 0.25,
+    max: 4,
+    default: 1,
+    unit: 'x',
+  },
+
+  tape_reverse: {
+    id: 'tape_reverse',
+    name: 'Tape Reverse',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
+
   // =========================================================================
   // RECORDING ENVELOPE
   // =========================================================================
@@ -375,6 +420,18 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: 0,
   },
 
+  // =========================================================================
+  // CONVOLUTION
+  // =========================================================================
+
+  conv_mix: {
+    id: 'conv_mix',
+    name: 'Convolution Mix',
+    min: 0,
+    max: 1,
+    default: 0,
+  },
+
   // =========================================================================
   // COMPRESSOR
   // =========================================================================
@@ -404,6 +461,15 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     default: 0,
   },
 
+  comp_lookahead: {
+    id: 'comp_lookahead',
+    name: 'Comp Lookahead',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
+
   // =========================================================================
   // SEQUENCERS (dual - one per oscillator)
   // =========================================================================
@@ -572,6 +638,194 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     max: 1,
     default: 0,
   },
+
+  // =========================================================================
+  // PLAY HEADS
+  // =========================================================================
+
+  head1_level: {
+    id: 'head1_level',
+    name: 'Head 1 Level',
+    min: 0,
+    max: 1,
+    default: 0,
+  },
+
+  head1_offset: {
+    id: 'head1_offset',
+    name: 'Head 1 Offset',
+    min: 0,
+    max: 1,
+    default: 0.25,
+  },
+
+  head1_speed: {
+    id: 'head1_speed',
+    name: 'Head 1 Speed',
+    min: -4,
+    max: 4,
+    default: 1,
+    unit: 'x',
+  },
+
+  head1_pan: {
+    id: 'head1_pan',
+    name: 'Head 1 Pan',
+    min: -1,
+    max: 1,
+    default: 0,
+  },
+
+  head2_level: {
+    id: 'head2_level',
+    name: 'Head 2 Level',
+    min: 0,
+    max: 1,
+    default: 0,
+  },
+
+  head2_offset: {
+    id: 'head2_offset',
+    name: 'Head 2 Offset',
+    min: 0,
+    max: 1,
+    default: 0.5,
+  },
+
+  head2_speed: {
+    id: 'head2_speed',
+    name: 'Head 2 Speed',
+    min: -4,
+    max: 4,
+    default: 1,
+    unit: 'x',
+  },
+
+  head2_pan: {
+    id: 'head2_pan',
+    name: 'Head 2 Pan',
+    min: -1,
+    max: 1,
+    default: 0,
+  },
+
+  head3_level: {
+    id: 'head3_level',
+    name: 'Head 3 Level',
+    min: 0,
+    max: 1,
+    default: 0,
+  },
+
+  head3_offset: {
+    id: 'head3_offset',
+    name: 'Head 3 Offset',
+    min: 0,
+    max: 1,
+    default: 0.75,
+  },
+
+  head3_speed: {
+    id: 'head3_speed',
+    name: 'Head 3 Speed',
+    min: -4,
+    max: 4,
+    default: 1,
+    unit: 'x',
+  },
+
+  head3_pan: {
+    id: 'head3_pan',
+    name: 'Head 3 Pan',
+    min: -1,
+    max: 1,
+    default: 0,
+  },
+
+  // =========================================================================
+  // GRAIN CLOUD
+  // =========================================================================
+
+  grain_level: {
+    id: 'grain_level',
+    name: 'Grain Level',
+    min: 0,
+    max: 1,
+    default: 0,
+  },
+
+  grain_density: {
+    id: 'grain_density',
+    name: 'Grain Density',
+    min: 1,
+    max: 100,
+    default: 20,
+    unit: 'Hz',
+  },
+
+  grain_size: {
+    id: 'grain_size',
+    name: 'Grain Size',
+    min: 10,
+    max: 500,
+    default: 100,
+    unit: 'ms',
+  },
+
+  grain_position: {
+    id: 'grain_position',
+    name: 'Grain Position',
+    min: 0,
+    max: 1,
+    default: 0.5,
+  },
+
+  grain_spray: {
+    id: 'grain_spray',
+    name: 'Grain Spray',
+    min: 0,
+    max: 1,
+    default: 0.1,
+  },
+
+  grain_pitch: {
+    id: 'grain_pitch',
+    name: 'Grain Pitch',
+    min: -24,
+    max: 24,
+    default: 0,
+    unit: 'st',
+  },
+
+  grain_pitch_spread: {
+    id: 'grain_pitch_spread',
+    name: 'Grain Pitch Spread',
+    min: 0,
+    max: 24,
+    default: 0,
+    unit: 'st',
+  },
+
+  grain_pan_spread: {
+    id: 'grain_pan_spread',
+    name: 'Grain Pan Spread',
+    min: 0,
+    max: 1,
+    default: 0.5,
+  },
+
+  // =========================================================================
+  // ENGINE
+  // =========================================================================
+
+  render_rate: {
+    id: 'render_rate',
+    name: 'Render Rate',
+    min: 0,
+    max: 1,
+    default: 0,
+    step: 1,
+  },
 };
 
 /**
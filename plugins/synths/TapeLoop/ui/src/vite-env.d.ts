@@ -28,8 +28,10 @@ declare global {
   interface Window {
     __JUCE__?: JUCE;
     onParameterUpdate?: (paramId: string, value: number) => void;
+    onParametersUpdate?: (values: Record<string, number>) => void;
     onStateUpdate?: (state: Record<string, number>) => void;
     onAudioData?: (samples: number[]) => void;
+    onAudioDataBase64?: (data: string) => void;
   }
 }
 
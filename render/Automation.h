@@ -0,0 +1,544 @@
+/**
+ * @file Automation.h
+ * @brief Parameter automation as breakpoint lanes: recorded live, played back per span
+ *
+ * A MIDI pattern carries a render's notes but not its knob moves, so a
+ * filter sweep in a demo was lost in every offline and browser bounce.
+ * Automation is the moves: one lane per parameter, each a sorted run of
+ * 8-byte breakpoints (frame, plain value) with straight lines between
+ * them. The lanes share one flat array of points, at one sample rate, on
+ * the timeline of the pattern they go with:
+ *
+ *   const Automation lanes = Automation::load("sweep.txt", 48000.0);
+ *   AutomationPlayer player;
+ *   player.setAutomation(lanes, params);   // Lanes to parameter indices, by ID
+ *   player.seek(frame);
+ *   player.evaluate(frame, [&](int param, float value) { ... });  // Each span
+ *
+ * AutomationPlayer evaluates every lane at the start of each span the host
+ * renders (at most its block size) and hands on only the values that
+ * moved. The engine's own parameter smoothing then ramps across the span,
+ * as it does for a DAW's per-block automation, so a sweep comes out the
+ * same in every render for one evaluation per lane per block.
+ *
+ * AutomationRecorder takes parameter changes as they are applied into a
+ * buffer sized up front, so recording allocates nothing on the audio
+ * thread. A point on the line between its neighbours (to within a
+ * millionth of the range, or a step for ints and choices, whose every
+ * point the host has rounded) is merged as it comes in, so a steady sweep
+ * takes a few points; a move after more than HOLD_SECONDS without one is
+ * kept as a step rather than a ramp from the last point.
+ *
+ * toBinary() / fromBinary() are the lanes behind a 16-byte header ("ASAU",
+ * version, sample rate, lane count): a 32-byte row per lane (parameter ID,
+ * NUL padded, then its first point and point count), then the points,
+ * little-endian, ready to hand to a WASM module in one copy. load() also
+ * takes text, one breakpoint per line: SECONDS PARAMETER VALUE, with '#'
+ * starting a comment. A lane holds its first value before its first point
+ * and its last after its last.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PresetFile.h"
+
+namespace render
+{
+
+/** One breakpoint: the binary record as well */
+struct AutomationPoint
+{
+    uint32_t frame = 0;  // Sample it lands on, from the pattern's start
+    float value = 0.0f;  // Plain value, as apvts holds it
+};
+
+static_assert(sizeof(AutomationPoint) == 8, "AutomationPoint is the 8-byte binary record");
+
+class Automation
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr size_t LANE_BYTES = 32;
+    static constexpr size_t MAX_ID_LENGTH = 23;  // A lane row's ID and its NUL
+
+    /** One parameter's breakpoints: data(lane)[0, count), sorted by frame */
+    struct Lane
+    {
+        std::string id;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    Automation() = default;
+    explicit Automation(double sampleRate) : rate(sampleRate) {}
+
+    /**
+     * @brief Add a lane for a parameter with none yet
+     * @throws std::logic_error on a bad ID, a second lane for it, or no or unsorted points
+     */
+    void addLane(const std::string& id, const std::vector<AutomationPoint>& lanePoints)
+    {
+        if (id.empty() || id.size() > MAX_ID_LENGTH)
+            throw std::logic_error("automation lane ID '" + id + "' is empty or too long");
+        if (findLane(id) != nullptr)
+            throw std::logic_error("automation has two lanes for '" + id + "'");
+        if (lanePoints.empty() || !std::is_sorted(lanePoints.begin(), lanePoints.end(), earlier))
+            throw std::logic_error("automation lane '" + id + "' has no points or they are out of order");
+
+        lanes.push_back({id, static_cast<uint32_t>(points.size()), static_cast<uint32_t>(lanePoints.size())});
+        points.insert(points.end(), lanePoints.begin(), lanePoints.end());
+    }
+
+    /**
+     * @brief Read automation, binary or text, at sampleRate
+     * @throws std::runtime_error if it is neither
+     */
+    static Automation load(const std::string& path, double sampleRate)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't open automation " + path);
+
+        const std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        if (isAutomation(data.data(), data.size()))
+            return fromBinary(data.data(), data.size(), path).resampled(sampleRate);
+        return fromText(std::string(data.begin(), data.end()), sampleRate, path);
+    }
+
+    /** @throws std::runtime_error on a line that isn't SECONDS PARAMETER VALUE */
+    static Automation fromText(const std::string& text, double sampleRate, const std::string& name = "automation")
+    {
+        std::vector<std::string> ids;
+        std::vector<std::vector<AutomationPoint>> lanePoints;
+
+        std::istringstream in(text);
+        std::string line;
+        for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+        {
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            double seconds = 0.0;
+            std::string id;
+            float value = 0.0f;
+            if (!(fields >> seconds))
+                continue;  // Blank or comment
+            if (!(fields >> id >> value) || seconds < 0.0 || !std::isfinite(value))
+                throw std::runtime_error(name + ":" + std::to_string(lineNumber) + ": expected SECONDS PARAMETER VALUE");
+
+            const auto at = std::find(ids.begin(), ids.end(), id);
+            const size_t lane = static_cast<size_t>(at - ids.begin());
+            if (at == ids.end())
+            {
+                ids.push_back(id);
+                lanePoints.emplace_back();
+            }
+            lanePoints[lane].push_back({toFrame(seconds * sampleRate), value});
+        }
+
+        Automation automation(sampleRate);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            // File order within a frame, so two points on one frame are a step
+            std::stable_sort(lanePoints[i].begin(), lanePoints[i].end(), earlier);
+            try
+            {
+                automation.addLane(ids[i], lanePoints[i]);
+            }
+            catch (const std::logic_error& e)
+            {
+                throw std::runtime_error(name + ": " + e.what());
+            }
+        }
+        return automation;
+    }
+
+    /** True if data starts with an automation header */
+    static bool isAutomation(const uint8_t* data, size_t size)
+    {
+        return size >= HEADER_BYTES && std::memcmp(data, "ASAU", 4) == 0;
+    }
+
+    /** The binary form: header, lane rows, then the points */
+    std::vector<uint8_t> toBinary() const
+    {
+        std::vector<uint8_t> out(HEADER_BYTES + lanes.size() * LANE_BYTES + points.size() * sizeof(AutomationPoint));
+        const uint32_t header[3] = {VERSION, static_cast<uint32_t>(std::lround(rate)),
+                                    static_cast<uint32_t>(lanes.size())};
+        std::memcpy(out.data(), "ASAU", 4);
+        std::memcpy(out.data() + 4, header, sizeof(header));
+
+        uint8_t* row = out.data() + HEADER_BYTES;
+        for (const Lane& lane : lanes)
+        {
+            std::memcpy(row, lane.id.data(), lane.id.size());  // addLane() left room for the NUL
+            const uint32_t span[2] = {lane.first, lane.count};
+            std::memcpy(row + LANE_BYTES - sizeof(span), span, sizeof(span));
+            row += LANE_BYTES;
+        }
+        if (!points.empty())
+            std::memcpy(row, points.data(), points.size() * sizeof(AutomationPoint));
+        return out;
+    }
+
+    /** @throws std::runtime_error on a bad header, a short file or a bad lane */
+    static Automation fromBinary(const uint8_t* data, size_t size, const std::string& name = "automation")
+    {
+        if (!isAutomation(data, size))
+            throw std::runtime_error(name + ": not automation");
+
+        uint32_t header[3];
+        std::memcpy(header, data + 4, sizeof(header));
+        if (header[0] != VERSION)
+            throw std::runtime_error(name + ": automation version " + std::to_string(header[0]) + " not supported");
+        if (header[1] == 0 || (size - HEADER_BYTES) / LANE_BYTES < header[2])
+            throw std::runtime_error(name + ": truncated");
+
+        const uint8_t* rows = data + HEADER_BYTES;
+        const uint8_t* pointData = rows + header[2] * LANE_BYTES;
+        const size_t available = (size - HEADER_BYTES - header[2] * LANE_BYTES) / sizeof(AutomationPoint);
+
+        Automation automation(header[1]);
+        for (uint32_t i = 0; i < header[2]; ++i)
+        {
+            const uint8_t* row = rows + i * LANE_BYTES;
+            uint32_t span[2];
+            std::memcpy(span, row + LANE_BYTES - sizeof(span), sizeof(span));
+            if (std::memchr(row, 0, MAX_ID_LENGTH + 1) == nullptr || span[0] > available || span[1] > available - span[0])
+                throw std::runtime_error(name + ": bad lane " + std::to_string(i));
+
+            std::vector<AutomationPoint> lanePoints(span[1]);
+            if (span[1] > 0)
+                std::memcpy(lanePoints.data(), pointData + span[0] * sizeof(AutomationPoint),
+                            span[1] * sizeof(AutomationPoint));
+            try
+            {
+                automation.addLane(reinterpret_cast<const char*>(row), lanePoints);
+            }
+            catch (const std::logic_error& e)
+            {
+                throw std::runtime_error(name + ": " + e.what());
+            }
+        }
+        return automation;
+    }
+
+    /** The same lanes stamped at another rate */
+    Automation resampled(double sampleRate) const
+    {
+        if (sampleRate == rate)
+            return *this;
+
+        Automation automation = *this;
+        automation.rate = sampleRate;
+        for (auto& p : automation.points)
+            p.frame = toFrame(static_cast<double>(p.frame) * sampleRate / rate);
+        return automation;
+    }
+
+    double getSampleRate() const { return rate; }
+    const std::vector<Lane>& getLanes() const { return lanes; }
+    const AutomationPoint* data(const Lane& lane) const { return points.data() + lane.first; }
+
+    /** Breakpoints in every lane */
+    size_t size() const { return points.size(); }
+    bool empty() const { return lanes.empty(); }
+
+    /** Frame of the last breakpoint in any lane (0 when empty) */
+    int64_t lastFrame() const
+    {
+        int64_t last = 0;
+        for (const Lane& lane : lanes)
+            last = std::max<int64_t>(last, points[lane.first + lane.count - 1].frame);
+        return last;
+    }
+
+private:
+    static_assert(std::endian::native == std::endian::little, "the binary form is the records as they are in memory");
+
+    static bool earlier(const AutomationPoint& a, const AutomationPoint& b) { return a.frame < b.frame; }
+
+    static uint32_t toFrame(double frame)
+    {
+        return static_cast<uint32_t>(std::clamp(std::llround(frame), 0LL, static_cast<long long>(UINT32_MAX)));
+    }
+
+    const Lane* findLane(const std::string& id) const
+    {
+        for (const Lane& lane : lanes)
+            if (lane.id == id)
+                return &lane;
+        return nullptr;
+    }
+
+    double rate = 48000.0;
+    std::vector<Lane> lanes;
+    std::vector<AutomationPoint> points;  // Every lane's, lane after lane
+};
+
+/**
+ * @brief Evaluates automation lanes at span starts; real-time safe but for setAutomation()
+ *
+ * Holds pointers to the points, not a copy: the automation must outlive it.
+ */
+class AutomationPlayer
+{
+public:
+    /**
+     * @brief Play automation's lanes onto params, matched by ID, from the start
+     * @return The IDs of lanes params doesn't have, which are skipped
+     */
+    std::vector<std::string> setAutomation(const Automation& automation, const std::vector<Param>& params)
+    {
+        std::vector<std::string> unknown;
+        tracks.clear();
+        for (const Automation::Lane& lane : automation.getLanes())
+        {
+            const auto at = std::find_if(params.begin(), params.end(), [&](const Param& p) { return p.id == lane.id; });
+            if (at == params.end())
+                unknown.push_back(lane.id);
+            else
+                tracks.push_back({automation.data(lane), lane.count, 0, static_cast<int>(at - params.begin())});
+        }
+        seek(0);
+        return unknown;
+    }
+
+    void clear() { tracks.clear(); }
+    bool empty() const { return tracks.empty(); }
+
+    /** Move to frame; the next evaluate() sends every lane's value */
+    void seek(int64_t frame)
+    {
+        for (Track& t : tracks)
+        {
+            t.next = static_cast<uint32_t>(std::upper_bound(t.points, t.points + t.count, frame,
+                                                            [](int64_t f, const AutomationPoint& p) {
+                                                                return f < static_cast<int64_t>(p.frame);
+                                                            })
+                                           - t.points);
+            t.sent = false;
+        }
+    }
+
+    /** True once every lane is past its last point and has sent its last value */
+    bool isFinished() const
+    {
+        return std::all_of(tracks.begin(), tracks.end(), [](const Track& t) { return t.sent && t.next >= t.count; });
+    }
+
+    /**
+     * @brief Each lane's value at frame (on or after the last evaluate() or seek())
+     * @param set Called as set(paramIndex, value) for each lane whose value moved
+     */
+    template <typename SetFn>
+    void evaluate(int64_t frame, SetFn&& set)
+    {
+        for (Track& t : tracks)
+        {
+            while (t.next < t.count && static_cast<int64_t>(t.points[t.next].frame) <= frame)
+                ++t.next;
+
+            float value;
+            if (t.next == 0)
+                value = t.points[0].value;
+            else if (t.next >= t.count)
+                value = t.points[t.count - 1].value;
+            else
+            {
+                // a.frame <= frame < b.frame
+                const AutomationPoint& a = t.points[t.next - 1];
+                const AutomationPoint& b = t.points[t.next];
+                const float x = static_cast<float>(frame - a.frame) / static_cast<float>(b.frame - a.frame);
+                value = a.value + (b.value - a.value) * x;
+            }
+
+            if (!t.sent || value != t.value)
+            {
+                set(t.param, value);
+                t.value = value;
+                t.sent = true;
+            }
+        }
+    }
+
+private:
+    struct Track
+    {
+        const AutomationPoint* points = nullptr;
+        uint32_t count = 0;
+        uint32_t next = 0;  // First point after the last frame evaluated
+        int param = 0;      // Index into the parameter table
+        float value = 0.0f; // Last value sent
+        bool sent = false;
+    };
+
+    std::vector<Track> tracks;
+};
+
+/**
+ * @brief Records parameter changes into breakpoint lanes; real-time safe but for prepare() and take()
+ *
+ * Frames only move forward within a take: a move stamped before its lane's
+ * last point lands on that point.
+ */
+class AutomationRecorder
+{
+public:
+    /** A move after this long without one is a step; sooner, a ramp from the last point */
+    static constexpr double HOLD_SECONDS = 0.05;
+
+    /** Room for maxPoints breakpoints over params; allocates, and drops any take */
+    void prepare(const std::vector<Param>& params, size_t maxPoints, double sampleRate)
+    {
+        recording = false;
+        entries.assign(maxPoints, Entry{});
+        ids.clear();
+        tolerances.clear();
+        for (const Param& p : params)
+        {
+            ids.push_back(p.id);
+            tolerances.push_back(std::max(MERGE_TOLERANCE * (p.max - p.min), p.interval >= 1.0f ? p.interval : 0.0f));
+        }
+        initial.assign(params.size(), 0.0f);
+        last.assign(params.size(), -1);
+        holdFrames = static_cast<uint32_t>(std::lround(HOLD_SECONDS * sampleRate));
+        used = 0;
+        dropped = 0;
+    }
+
+    /** Start a take at frame, every parameter at values[i] (in prepare()'s order); drops the last take */
+    void start(int64_t frame, const float* values)
+    {
+        std::copy(values, values + initial.size(), initial.begin());
+        std::fill(last.begin(), last.end(), -1);
+        startFrame = clampFrame(frame);
+        used = 0;
+        dropped = 0;
+        recording = !entries.empty();
+    }
+
+    void stop() { recording = false; }
+    bool isRecording() const { return recording; }
+
+    /** Breakpoints kept, and those lost for want of room */
+    size_t size() const { return used; }
+    uint64_t getDropped() const { return dropped; }
+
+    /** Parameter param took value at frame */
+    void record(int param, int64_t frame, float value) noexcept
+    {
+        if (!recording || param < 0 || param >= static_cast<int>(last.size()))
+            return;
+
+        const auto p = static_cast<size_t>(param);
+        if (last[p] < 0 && !push(param, startFrame, initial[p]))
+            return;  // The lane's first move: it held its value from the start
+
+        Entry& b = entries[static_cast<size_t>(last[p])];
+        const uint32_t f = std::max(clampFrame(frame), b.point.frame);
+        if (f == b.point.frame)
+        {
+            b.point.value = value;  // The later write on a frame wins
+            return;
+        }
+        if (value == b.point.value)
+            return;
+
+        if (f - b.point.frame > holdFrames)
+        {
+            // After a hold: step on this frame, rather than ramp from the last point
+            if (push(param, f, b.point.value))
+                push(param, f, value);
+            return;
+        }
+
+        // Within a ramp: b goes if it is on the line from the point before it to this one
+        if (b.previous >= 0)
+        {
+            const AutomationPoint& a = entries[static_cast<size_t>(b.previous)].point;
+            if (a.frame < b.point.frame)
+            {
+                const float x = static_cast<float>(b.point.frame - a.frame) / static_cast<float>(f - a.frame);
+                const float onLine = a.value + (value - a.value) * x;
+                if (std::abs(onLine - b.point.value) <= tolerances[p])
+                {
+                    b.point = {f, value};
+                    return;
+                }
+            }
+        }
+        push(param, f, value);
+    }
+
+    /** The take as lanes, at sampleRate, one per parameter that moved; allocates */
+    Automation take(double sampleRate) const
+    {
+        Automation automation(sampleRate);
+        std::vector<AutomationPoint> lanePoints;
+        for (size_t p = 0; p < last.size(); ++p)
+        {
+            lanePoints.clear();
+            for (int32_t e = last[p]; e >= 0; e = entries[static_cast<size_t>(e)].previous)
+                lanePoints.push_back(entries[static_cast<size_t>(e)].point);
+            if (lanePoints.empty())
+                continue;
+            std::reverse(lanePoints.begin(), lanePoints.end());
+            automation.addLane(ids[p], lanePoints);
+        }
+        return automation;
+    }
+
+private:
+    static constexpr float MERGE_TOLERANCE = 1.0e-6f;  // Of the parameter's range
+
+    struct Entry
+    {
+        AutomationPoint point;
+        int32_t previous = -1;  // The same parameter's entry before this one
+    };
+
+    static uint32_t clampFrame(int64_t frame)
+    {
+        return static_cast<uint32_t>(std::clamp<int64_t>(frame, 0, std::numeric_limits<uint32_t>::max()));
+    }
+
+    bool push(int param, uint32_t frame, float value) noexcept
+    {
+        if (used >= entries.size())
+        {
+            ++dropped;
+            return false;
+        }
+        const auto p = static_cast<size_t>(param);
+        entries[used] = {{frame, value}, last[p]};
+        last[p] = static_cast<int32_t>(used++);
+        return true;
+    }
+
+    std::vector<Entry> entries;   // prepare()'s room, used in order of arrival
+    std::vector<std::string> ids;
+    std::vector<float> tolerances;  // Per parameter, how far off the line a merged point may be
+    std::vector<float> initial;   // Every parameter's value at start()
+    std::vector<int32_t> last;    // Per parameter, its newest entry (-1: none)
+    size_t used = 0;
+    uint64_t dropped = 0;
+    uint32_t startFrame = 0;
+    uint32_t holdFrames = 2400;
+    bool recording = false;
+};
+
+} // namespace render
@@ -0,0 +1,35 @@
+/**
+ * @file EngineEntry.h
+ * @brief The entry point a render adapter ends with
+ *
+ *   AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "ModelD", parameters, applyParams)
+ *
+ * Natively that is main() for autosynth-render-<Plugin> (RenderHarness.h).
+ * In an engine library (AUTOSYNTH_ENGINE_ABI: the WASM modules and the
+ * shared libraries autosynth-batch loads) it is the makeEngineHost() that
+ * wasm_bindings.cpp exports (EngineHost.h), so one adapter serves all.
+ */
+
+#pragma once
+
+#ifdef AUTOSYNTH_ENGINE_ABI
+
+#include "EngineHost.h"
+
+#define AUTOSYNTH_ENGINE_ENTRY(Engine, name, parameters, apply)                                           \
+    std::unique_ptr<render::abi::EngineHost> render::abi::makeEngineHost()                                \
+    {                                                                                                      \
+        return std::make_unique<render::abi::Host<Engine, decltype(&apply)>>(name, parameters(), &apply);  \
+    }
+
+#else
+
+#include "RenderHarness.h"
+
+#define AUTOSYNTH_ENGINE_ENTRY(Engine, name, parameters, apply)                                           \
+    int main(int argc, char** argv)                                                                        \
+    {                                                                                                      \
+        return render::runMain<Engine>(argc, argv, name, parameters(), apply);                             \
+    }
+
+#endif
@@ -0,0 +1,483 @@
+/**
+ * @file EngineHost.h
+ * @brief Any render adapter's engine behind one C ABI
+ *
+ * Each engines/render_<Plugin>.cpp already lists its plugin's parameters
+ * and makes the processBlock() setter calls, with no JUCE. Built with
+ * AUTOSYNTH_ENGINE_ABI (see CMakeLists.txt), the same adapter becomes an
+ * engine library instead of an executable: a WASM module for the browser
+ * or a native shared library for autosynth-batch. EngineEntry.h defines
+ * makeEngineHost() in place of main(), and wasm_bindings.cpp exports it
+ * in the shape web-dfam's worklets already use:
+ *
+ *  - a flat parameter block of plain values (what apvts would hold), one
+ *    float per parameter in table order. The worklet writes it directly;
+ *    process() clamps and applies whatever changed before rendering.
+ *  - a table of ParamInfo rows (8 words) describing the block.
+ *  - queueEvents() with the event ring's five-word records
+ *    (web-dfam/public/event-ring.js). Each lands on its sample offset:
+ *    the block is split there, as RenderHarness does for MIDI files.
+ *  - loadPattern() with a whole MIDI pattern (MidiPattern.h's binary
+ *    form), which then plays on its frames from process() to process()
+ *    with nothing more sent: a bounce or a demo is one copy into the
+ *    module, and seekPattern() jumps in it.
+ *  - loadAutomation() with parameter automation (Automation.h's binary
+ *    form) on the pattern's timeline: every lane is evaluated at the start
+ *    of each span and written through the parameter block, so a sweep
+ *    plays back in the module as in an offline render.
+ *    recordAutomation() records block writes and parameter events into a
+ *    buffer sized when it starts; takeAutomation() hands the take back in
+ *    the same binary form.
+ *
+ * process() takes any frame count and renders in spans of at most the
+ * maxBlockSize given to init(), the size the engine was prepared with.
+ * Engines with a renderBlock(inL, inR, outL, outR, n) (TapeLoop) take
+ * audio input through the second process(): the input may be the output
+ * buffers themselves, so a worklet copies its input into the module once
+ * and gets the output back in the same place. Other engines ignore it.
+ *
+ * isSilent() lets a worklet stop calling process() while nothing can
+ * sound: the last call rendered silence, no event, parameter write,
+ * pattern event or automation move is waiting, and no sequencer is running. The worklet then
+ * outputs zeros itself until it next queues an event or writes the block.
+ *
+ * getPerfStats() reads the engine's PerfStats counters (stage cycles,
+ * blocks over budget, blocks per voice count) for autosynth-batch's
+ * metrics. They count only in a library built with SYNTH_PERF_STATS;
+ * otherwise every value, "enabled" first, reads 0.
+ */
+
+#pragma once
+
+#include "Automation.h"
+#include "MidiPattern.h"
+#include "PerfStats.h"
+#include "RenderHarness.h"
+#include "SilenceGate.h"
+
+#include <cstdint>
+
+namespace render::abi
+{
+
+/** Parameter table row: eight 32-bit words in a wasm32 build */
+struct ParamInfo
+{
+    const char* name;
+    float minValue;
+    float maxValue;
+    float defaultValue;
+    float interval;  // 0 = continuous, 1 = int / choice / bool
+    float skew;      // NormalisableRange skew, for knob curves
+    int32_t id;      // Index into the parameter block
+    int32_t reserved;
+};
+
+/** Event record types (web-dfam/src/audio/eventRing.ts, plus two for MIDI) */
+enum EventType : int32_t
+{
+    kEventParam = 0,      // id = parameter index, value = plain value
+    kEventNoteOn = 1,     // id = note, value = velocity 0-1
+    kEventNoteOff = 2,    // id = note
+    kEventPitchBend = 3,  // value = -1..1
+    kEventAllNotesOff = 4
+};
+
+/** Five words, the same as an event ring record */
+struct Event
+{
+    int32_t type;
+    int32_t id;
+    int32_t index;         // Unused (no per-step parameters)
+    float value;
+    int32_t sampleOffset;  // Frames into the next process() call
+};
+
+/** One engine instance, as wasm_bindings.cpp sees it */
+class EngineHost
+{
+public:
+    virtual ~EngineHost() = default;
+
+    /** Construct and prepare the engine, every parameter at its default */
+    virtual bool init(double sampleRate, int maxBlockSize) = 0;
+    virtual void process(float* outputL, float* outputR, int numSamples) = 0;
+
+    /** process() with audio input, which may be outputL/outputR (in place) */
+    virtual void process(const float* inputL, const float* inputR, float* outputL, float* outputR,
+                         int numSamples) = 0;
+
+    /** Queue events for the next process(); returns how many fit */
+    virtual int queueEvents(const Event* events, int count) = 0;
+
+    /** Play a MIDI pattern from its start, after init(); false if it isn't one */
+    virtual bool loadPattern(const uint8_t* data, int size) = 0;
+
+    /** Move the pattern and the automation to a frame; sounding notes stop, and so does recording */
+    virtual void seekPattern(int frame) = 0;
+
+    /** Play automation on the pattern's timeline from where it is, after init(); false if it isn't any */
+    virtual bool loadAutomation(const uint8_t* data, int size) = 0;
+
+    /** Start recording parameter changes with room for maxPoints breakpoints (allocates), or stop (0) */
+    virtual bool recordAutomation(int maxPoints) = 0;
+
+    /** Stop recording and keep the take in its binary form; returns its size in bytes (0: none) */
+    virtual int takeAutomation() = 0;
+
+    /** The take from the last takeAutomation() */
+    virtual const uint8_t* getAutomation() const = 0;
+
+    /** True if process() would render silence until the next event or parameter write */
+    virtual bool isSilent() const = 0;
+
+    /** The engine's PerfStats, all 0 for engines without them or with them compiled out */
+    virtual PerfStats::Snapshot getPerfStats() const = 0;
+
+    virtual float* getParamBlock() = 0;
+    virtual const ParamInfo* getParamTable() const = 0;
+    virtual int getParamCount() const = 0;
+    virtual const char* getName() const = 0;
+};
+
+/** A new, unprepared instance; defined by the adapter's AUTOSYNTH_ENGINE_ENTRY (EngineEntry.h) */
+std::unique_ptr<EngineHost> makeEngineHost();
+
+template <typename Engine, typename ApplyFn>
+class Host final : public EngineHost
+{
+public:
+    /** Events held for one process() call; more are refused */
+    static constexpr int MAX_EVENTS = 256;
+
+    Host(const char* name, std::vector<Param> parameters, ApplyFn apply)
+        : name(name), params(std::move(parameters)), values(params), apply(apply)
+    {
+        block.resize(params.size());
+        applied.resize(params.size());
+        table.reserve(params.size());
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            const Param& p = params[i];
+            table.push_back({p.id.c_str(), p.min, p.max, p.defaultValue, p.interval, p.skew,
+                             static_cast<int32_t>(i), 0});
+        }
+    }
+
+    bool init(double sampleRate, int maxBlockSize) override
+    {
+        maxBlock = std::clamp(maxBlockSize > 0 ? maxBlockSize : 128, 1, 8192);
+        rate = sampleRate;
+        pattern = {};
+        player.setPattern(nullptr, 0);
+        automation = {};
+        automationPlayer.clear();
+        recorder.stop();
+        taken.clear();
+        engine = std::make_unique<Engine>();
+        engine->prepare(sampleRate, maxBlock);
+
+        for (size_t i = 0; i < params.size(); ++i)
+            block[i] = params[i].defaultValue;
+        numPending = 0;
+        applyBlock(true);
+        return true;
+    }
+
+    /** True if the engine records or processes audio input */
+    static constexpr bool TAKES_INPUT =
+        requires(Engine& e, const float* in, float* out) { e.renderBlock(in, in, out, out, 1); };
+
+    /** Engines that say whether their last block was silent, tails included */
+    static constexpr bool REPORTS_SILENCE = requires(const Engine& e) { bool(e.isSilent()); };
+
+    /** Otherwise: no voices left and the output below -120 dB */
+    static constexpr bool COUNTS_VOICES = requires(const Engine& e) { int(e.getActiveVoiceCount()); };
+
+    void process(float* outputL, float* outputR, int numSamples) override
+    {
+        process(nullptr, nullptr, outputL, outputR, numSamples);
+    }
+
+    void process(const float* inputL, const float* inputR, float* outputL, float* outputR,
+                 int numSamples) override
+    {
+        if (!TAKES_INPUT || !engine)
+            inputL = inputR = nullptr;
+
+        // In place the input is still to be read
+        if (inputL == nullptr)
+        {
+            std::fill(outputL, outputL + numSamples, 0.0f);
+            std::fill(outputR, outputR + numSamples, 0.0f);
+        }
+        if (!engine)
+            return;
+
+        applyBlock(false);
+
+        // Split at each event and pattern event so it lands on its sample,
+        // and at maxBlock
+        int next = 0;
+        for (int done = 0; done < numSamples;)
+        {
+            for (; next < numPending && pending[next].sampleOffset <= done; ++next)
+                handle(pending[next]);
+            player.dispatchDue([this](const PatternEvent& e) { dispatch(*engine, toMidiEvent(e)); });
+            if (!automationPlayer.empty())
+                applyAutomation();
+
+            int until = std::min(numSamples, done + maxBlock);
+            if (next < numPending)
+                until = std::min(until, std::max(pending[next].sampleOffset, done + 1));
+            until = std::min(until, done + static_cast<int>(std::clamp<int64_t>(player.framesToNext(), 1, maxBlock)));
+
+            if constexpr (TAKES_INPUT)
+            {
+                if (inputL != nullptr)
+                    engine->renderBlock(inputL + done, inputR + done, outputL + done, outputR + done, until - done);
+                else
+                    engine->renderBlock(outputL + done, outputR + done, until - done);
+            }
+            else
+            {
+                engine->renderBlock(outputL + done, outputR + done, until - done);
+            }
+            player.advance(until - done);
+            done = until;
+        }
+
+        if constexpr (!REPORTS_SILENCE && COUNTS_VOICES)
+            outputSilent = Silence::isSilent(outputL, outputR, numSamples);
+
+        // Events past this call move to the next one
+        int kept = 0;
+        for (int i = next; i < numPending; ++i)
+        {
+            pending[kept] = pending[i];
+            pending[kept].sampleOffset = std::max(0, pending[kept].sampleOffset - numSamples);
+            ++kept;
+        }
+        numPending = kept;
+    }
+
+    int queueEvents(const Event* events, int count) override
+    {
+        int accepted = 0;
+        for (; accepted < count && numPending < MAX_EVENTS; ++accepted)
+        {
+            // Insert in offset order, after events at the same offset
+            Event e = events[accepted];
+            e.sampleOffset = std::max(0, e.sampleOffset);
+            int at = numPending;
+            while (at > 0 && pending[at - 1].sampleOffset > e.sampleOffset)
+            {
+                pending[at] = pending[at - 1];
+                --at;
+            }
+            pending[at] = e;
+            ++numPending;
+        }
+        return accepted;
+    }
+
+    bool loadPattern(const uint8_t* data, int size) override
+    {
+        if (!engine || data == nullptr || size <= 0)
+            return false;
+        try
+        {
+            pattern = MidiPattern::fromBinary(data, static_cast<size_t>(size)).resampled(rate);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        player.setPattern(pattern.data(), pattern.size());
+        automationPlayer.seek(0);
+        return true;
+    }
+
+    void seekPattern(int frame) override
+    {
+        if (!engine)
+            return;
+        dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::AllNotesOff, 0, 0.0f});
+        player.seek(std::max(0, frame));
+        automationPlayer.seek(player.getPosition());
+        recorder.stop();  // A take is one pass
+    }
+
+    bool loadAutomation(const uint8_t* data, int size) override
+    {
+        if (!engine || data == nullptr || size <= 0)
+            return false;
+        try
+        {
+            automation = Automation::fromBinary(data, static_cast<size_t>(size)).resampled(rate);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        automationPlayer.setAutomation(automation, params);  // Lanes for other engines are skipped
+        automationPlayer.seek(player.getPosition());
+        return true;
+    }
+
+    bool recordAutomation(int maxPoints) override
+    {
+        if (!engine)
+            return false;
+        recorder.stop();
+        if (maxPoints <= 0)
+            return true;
+        recorder.prepare(params, static_cast<size_t>(maxPoints), rate);
+        recorder.start(player.getPosition(), applied.data());
+        return true;
+    }
+
+    int takeAutomation() override
+    {
+        recorder.stop();
+        try
+        {
+            const Automation take = recorder.take(rate);
+            taken = take.empty() ? std::vector<uint8_t>{} : take.toBinary();
+        }
+        catch (const std::exception&)
+        {
+            taken.clear();
+        }
+        return static_cast<int>(taken.size());
+    }
+
+    const uint8_t* getAutomation() const override { return taken.data(); }
+
+    bool isSilent() const override
+    {
+        if (!engine || numPending > 0 || !player.isFinished() || !automationPlayer.isFinished() || block != applied)
+            return false;
+        if constexpr (requires(const Engine& e) { bool(e.isRunning()); })
+        {
+            if (engine->isRunning())
+                return false;  // Sequencer steps are still to come
+        }
+
+        if constexpr (REPORTS_SILENCE)
+            return engine->isSilent();
+        else if constexpr (COUNTS_VOICES)
+            return outputSilent && engine->getActiveVoiceCount() == 0;
+        else
+            return false;
+    }
+
+    PerfStats::Snapshot getPerfStats() const override
+    {
+        if constexpr (requires(const Engine& e) { e.getPerfStats().getSnapshot(); })
+        {
+            if (engine)
+                return engine->getPerfStats().getSnapshot();
+        }
+        return PerfStats::Snapshot{};
+    }
+
+    float* getParamBlock() override { return block.data(); }
+    const ParamInfo* getParamTable() const override { return table.data(); }
+    int getParamCount() const override { return static_cast<int>(params.size()); }
+    const char* getName() const override { return name; }
+
+private:
+    // Clamp changed slots and hand every value to the adapter, as one
+    // processBlock() would
+    void applyBlock(bool force)
+    {
+        bool changed = force;
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            if (!force && block[i] == applied[i])
+                continue;
+
+            const Param& p = params[i];
+            const float v = p.constrain(block[i]);
+            block[i] = applied[i] = v;
+            values.set(p.id, v);
+            changed = true;
+            if (recorder.isRecording())
+                recorder.record(static_cast<int>(i), player.getPosition(), v);
+        }
+        if (changed)
+            apply(*engine, values);
+    }
+
+    // The lanes' values at the span about to render, applied as block
+    // writes would be but not recorded
+    void applyAutomation()
+    {
+        bool moved = false;
+        automationPlayer.evaluate(player.getPosition(), [this, &moved](int i, float value) {
+            const Param& p = params[static_cast<size_t>(i)];
+            const float v = p.constrain(value);
+            block[static_cast<size_t>(i)] = applied[static_cast<size_t>(i)] = v;
+            values.set(p.id, v);
+            moved = true;
+        });
+        if (moved)
+            apply(*engine, values);
+    }
+
+    void handle(const Event& e)
+    {
+        switch (e.type)
+        {
+        case kEventParam:
+            if (e.id >= 0 && e.id < static_cast<int>(block.size()))
+            {
+                block[static_cast<size_t>(e.id)] = e.value;
+                applyBlock(false);
+            }
+            break;
+        case kEventNoteOn:
+            dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::NoteOn, e.id & 127, e.value});
+            break;
+        case kEventNoteOff:
+            dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::NoteOff, e.id & 127, 0.0f});
+            break;
+        case kEventPitchBend:
+            dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::PitchBend, 0, e.value});
+            break;
+        case kEventAllNotesOff:
+            dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::AllNotesOff, 0, 0.0f});
+            break;
+        default:
+            break;
+        }
+    }
+
+    const char* name;
+    std::vector<Param> params;
+    ParamValues values;
+    ApplyFn apply;
+    std::unique_ptr<Engine> engine;
+    int maxBlock = 128;
+    double rate = 48000.0;
+
+    std::vector<float> block;    // Written by the worklet
+    std::vector<float> applied;  // What the engine last got
+    std::vector<ParamInfo> table;
+
+    std::array<Event, MAX_EVENTS> pending{};
+    int numPending = 0;
+
+    MidiPattern pattern;  // loadPattern(), at the engine's rate
+    PatternPlayer player;
+
+    Automation automation;  // loadAutomation(), at the engine's rate
+    AutomationPlayer automationPlayer;
+    AutomationRecorder recorder;
+    std::vector<uint8_t> taken;  // takeAutomation()'s binary form
+
+    bool outputSilent = false;  // Last process() was silent (engines without isSilent())
+};
+
+} // namespace render::abi
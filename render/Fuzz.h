@@ -0,0 +1,252 @@
+/**
+ * @file Fuzz.h
+ * @brief Parameter fuzzing for CPU spikes and bad output (autosynth-render --fuzz)
+ *
+ * Each trial draws every parameter at random within the range the adapter
+ * declares (a quarter of the draws at either end of the range, where the
+ * cliffs are: resonance at 1, drive at its maximum, decay at 10 s),
+ * renders a few seconds of held chords (or the running sequencer) and
+ * times every renderBlock(). A trial fails on:
+ *
+ *   - a block costing more than --spike times the trial's median block
+ *     (re-rendered once to rule out the scheduler: it fails only if the
+ *     rerun spikes again at the same point)
+ *   - NaN or Inf in the output
+ *   - subnormal output samples (the engines flush denormals natively, so
+ *     these mean a path that escapes the flush, which a WASM build pays for)
+ *
+ * Trials are reproducible: trial t of --seed s always draws the same
+ * parameters and noise. A failure is written as a preset file,
+ * <out-dir>/fuzz_<Plugin>_<seed>_<trial>.json, that --preset renders like
+ * any other; its "fuzz" object records why it failed and how to rerun it:
+ *
+ *   autosynth-render-DFAM --fuzz 500 --seed 7 --out-dir fuzz/
+ *   autosynth-render-DFAM --fuzz-trial 123 --seed 7   # the same trial again
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Noise.h"
+#include "PresetFile.h"
+
+namespace render
+{
+
+/** One fuzz trial: the draw and what rendering it measured */
+struct FuzzResult
+{
+    int trial = 0;
+    uint32_t trialSeed = 0;
+    std::vector<float> normalised;  // One per parameter, in table order
+    double medianBlockUs = 0.0;
+    double worstBlockUs = 0.0;
+    long worstBlock = 0;  // Index of the slowest block
+    long nonFinite = 0;
+    long subnormal = 0;
+    bool spike = false;  // Confirmed by a second render
+
+    double spikeRatio() const { return medianBlockUs > 0.0 ? worstBlockUs / medianBlockUs : 0.0; }
+    bool failed() const { return spike || nonFinite > 0 || subnormal > 0; }
+};
+
+/** Trial t's parameters, normalised 0-1 (a quarter at 0 or 1) */
+inline std::vector<float> drawParameters(size_t count, uint32_t trialSeed)
+{
+    uint32_t state = trialSeed | 1u;
+    auto next = [&state] {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    };
+
+    std::vector<float> normalised(count);
+    for (auto& v : normalised)
+    {
+        const float pick = next();
+        const float value = next();
+        v = pick < 0.125f ? 0.0f : pick < 0.25f ? 1.0f : value;
+    }
+    return normalised;
+}
+
+/** The block times and output checks of one render of a draw */
+template <typename Engine, typename ApplyFn>
+void renderTrial(FuzzResult& result, const std::vector<Param>& params, ApplyFn& apply, double sampleRate,
+                 int blockSize, double seconds, std::vector<double>& times)
+{
+    using Clock = std::chrono::steady_clock;
+
+    ParamValues values(params);
+    for (size_t i = 0; i < params.size(); ++i)
+        values.set(params[i].id, params[i].fromNormalised(result.normalised[i]));
+
+    auto engine = std::make_unique<Engine>();
+    engine->prepare(sampleRate, blockSize);
+    if constexpr (requires { engine->setNoiseSeed(1u); })
+        engine->setNoiseSeed(result.trialSeed);
+    apply(*engine, values);
+    if constexpr (requires { engine->setRunning(true); })
+        engine->setRunning(true);
+
+    // A four-note chord held for 0.4 s of every 0.5 s: attacks, releases and steals
+    static constexpr int chord[] = {36, 43, 48, 52};
+    const long period = std::max<long>(1, std::lround(sampleRate * 0.5));
+    const long noteLength = std::lround(sampleRate * 0.4);
+    const long warmup = std::lround(sampleRate * 0.1);
+    const long total = warmup + std::max<long>(1, std::lround(sampleRate * seconds));
+
+    std::vector<float> left(static_cast<size_t>(blockSize));
+    std::vector<float> right(static_cast<size_t>(blockSize));
+    times.clear();
+    result.nonFinite = 0;
+    result.subnormal = 0;
+
+    for (long pos = 0; pos < total; pos += blockSize)
+    {
+        const int n = static_cast<int>(std::min<long>(blockSize, total - pos));
+        const long phase = pos % period;
+
+        auto t0 = Clock::now();
+        if constexpr (requires { engine->noteOn(60, 1.0f); engine->noteOff(60); })
+        {
+            if (phase < n)
+                for (int note : chord)
+                    engine->noteOn(note, 0.8f);
+            if (phase <= noteLength && noteLength < phase + n)
+                for (int note : chord)
+                    engine->noteOff(note);
+        }
+        std::fill(left.begin(), left.begin() + n, 0.0f);
+        std::fill(right.begin(), right.begin() + n, 0.0f);
+        engine->renderBlock(left.data(), right.data(), n);
+        auto t1 = Clock::now();
+
+        if (pos < warmup)
+            continue;
+
+        times.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        for (int i = 0; i < n; ++i)
+        {
+            for (float x : {left[static_cast<size_t>(i)], right[static_cast<size_t>(i)]})
+            {
+                if (!std::isfinite(x))
+                    ++result.nonFinite;
+                else if (std::fpclassify(x) == FP_SUBNORMAL)
+                    ++result.subnormal;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draw and render trial t, re-rendering once to confirm a spike
+ * @param spikeFactor A block over this multiple of the median is a spike
+ */
+template <typename Engine, typename ApplyFn>
+FuzzResult runFuzzTrial(int trial, uint32_t seed, const std::vector<Param>& params, ApplyFn& apply,
+                        double sampleRate, int blockSize, double seconds, double spikeFactor)
+{
+    // Blocks this cheap are all scheduler noise, whatever their ratio
+    static constexpr double MIN_SPIKE_US = 20.0;
+
+    FuzzResult result;
+    result.trial = trial;
+    result.trialSeed = NoiseSource::deriveSeed(seed, static_cast<uint32_t>(trial));
+    result.normalised = drawParameters(params.size(), result.trialSeed);
+
+    std::vector<double> times;
+    auto measure = [&] {
+        renderTrial<Engine>(result, params, apply, sampleRate, blockSize, seconds, times);
+        std::vector<double> sorted = times;
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<long>(sorted.size() / 2), sorted.end());
+        result.medianBlockUs = sorted[sorted.size() / 2];
+        const auto worst = std::max_element(times.begin(), times.end());
+        result.worstBlockUs = *worst;
+        result.worstBlock = static_cast<long>(worst - times.begin());
+        return result.worstBlockUs > spikeFactor * result.medianBlockUs && result.worstBlockUs > MIN_SPIKE_US;
+    };
+
+    // Scheduler stalls land anywhere; a spike the parameters cause lands in the same place again
+    if (measure())
+    {
+        const long first = result.worstBlock;
+        result.spike = measure() && std::abs(result.worstBlock - first) <= 2;
+    }
+    return result;
+}
+
+/** Write a failed trial as a preset that --preset can render */
+inline std::string writeFuzzFailure(const FuzzResult& r, const std::string& outDir, const std::string& name,
+                                    uint32_t seed, double sampleRate, int blockSize, const std::vector<Param>& params)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(outDir, ec);
+    const std::string path = (std::filesystem::path(outDir)
+                              / ("fuzz_" + name + "_" + std::to_string(seed) + "_" + std::to_string(r.trial) + ".json"))
+                                 .string();
+
+    std::ofstream out(path);
+    char line[256];
+    out << "{\n";
+    out << "  \"meta\": {\"name\": \"Fuzz " << name << " " << seed << "/" << r.trial
+        << "\", \"version\": \"1.0.0\", \"category\": \"Other\"},\n";
+    std::snprintf(line, sizeof(line),
+                  "  \"fuzz\": {\"seed\": %u, \"trial\": %d, \"sampleRate\": %.0f, \"blockSize\": %d, "
+                  "\"medianBlockUs\": %.3f, \"worstBlockUs\": %.3f, \"worstBlock\": %ld, \"spike\": %s, "
+                  "\"nonFinite\": %ld, \"subnormal\": %ld},\n",
+                  seed, r.trial, sampleRate, blockSize, r.medianBlockUs, r.worstBlockUs, r.worstBlock,
+                  r.spike ? "true" : "false", r.nonFinite, r.subnormal);
+    out << line;
+    out << "  \"parameters\": {\n";
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        std::snprintf(line, sizeof(line), "    \"%s\": %.9g%s\n", params[i].id.c_str(),
+                      static_cast<double>(r.normalised[i]), i + 1 < params.size() ? "," : "");
+        out << line;
+    }
+    out << "  }\n}\n";
+    return path;
+}
+
+/**
+ * @brief The --fuzz run: trials first..first + count - 1
+ * @return Process exit code: 0 if no trial failed
+ */
+template <typename Engine, typename ApplyFn>
+int runFuzz(int first, int count, uint32_t seed, double spikeFactor, double seconds, double sampleRate,
+            int blockSize, const std::string& outDir, const std::string& name, const std::vector<Param>& params,
+            ApplyFn& apply)
+{
+    int failures = 0;
+    for (int t = first; t < first + count; ++t)
+    {
+        const FuzzResult r = runFuzzTrial<Engine>(t, seed, params, apply, sampleRate, blockSize, seconds, spikeFactor);
+        if (!r.failed())
+            continue;
+
+        ++failures;
+        const std::string path = writeFuzzFailure(r, outDir, name, seed, sampleRate, blockSize, params);
+        std::printf("%s: trial %d:%s%s%s  worst block %.1f us = %.1fx median (block %ld), %ld non-finite, "
+                    "%ld subnormal -> %s\n",
+                    name.c_str(), t, r.spike ? " spike" : "", r.nonFinite > 0 ? " non-finite" : "",
+                    r.subnormal > 0 ? " subnormal" : "", r.worstBlockUs, r.spikeRatio(), r.worstBlock, r.nonFinite,
+                    r.subnormal, path.c_str());
+    }
+
+    std::printf("%s: %d fuzz trial(s) from seed %u, %d failed\n", name.c_str(), count, seed, failures);
+    return failures > 0 ? 1 : 0;
+}
+
+} // namespace render
@@ -0,0 +1,348 @@
+/**
+ * @file Metrics.h
+ * @brief autosynth-batch's render telemetry as an OpenMetrics text file
+ *
+ * Run as a fleet, the batch hosts should report how fast each engine
+ * really renders on real jobs, not just on a bench. With --metrics FILE,
+ * autosynth-batch keeps FILE in the OpenMetrics text format (which
+ * Prometheus scrapes) and rewrites it as every job starts and ends. The
+ * host is a command, not a server, so nothing listens: node_exporter's
+ * textfile collector, or any static file server, publishes FILE. Each
+ * write goes to FILE.tmp, renamed over FILE, so a scrape never reads half.
+ *
+ * Labelled by the job's ENGINE (a rack as written):
+ *
+ *   autosynth_batch_jobs_total{outcome}        rendered, cached or failed
+ *   autosynth_batch_audio_seconds_total        audio rendered (not cached)
+ *   autosynth_batch_render_seconds_total       wall time spent rendering it
+ *   autosynth_batch_realtime_factor            the two divided
+ *   autosynth_batch_block_seconds              histogram, each block's process()
+ *   autosynth_batch_blocks_over_budget_total   blocks slower than real time
+ *   autosynth_batch_job_resident_bytes         most resident memory at one of its jobs' ends
+ *
+ * And for the whole host: jobs queued and running, cache hits and misses
+ * (with --cache), and peak resident memory. Jobs share one process, so
+ * memory can't be split between them exactly; with --threads 1 the
+ * resident size at a job's end is that job's.
+ *
+ * From engine libraries built with SYNTH_PERF_STATS, the engines' own
+ * PerfStats counters (getPerfStats()) are added up by engine, per rack
+ * slot: autosynth_engine_blocks_over_budget_total, _stage_cycles_total by
+ * stage and _voice_blocks_total by active voice count. Without it they
+ * read 0 and are left out.
+ */
+
+#pragma once
+
+#include "PerfStats.h"
+#include "RenderHarness.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace render
+{
+
+/** Block render times, bucketed for a histogram */
+struct BlockTimes
+{
+    /** Bucket upper bounds, seconds; one more bucket, +Inf, takes the rest */
+    static constexpr std::array<double, 10> BOUNDS = {1.0e-5, 2.5e-5, 5.0e-5, 1.0e-4, 2.5e-4,
+                                                      5.0e-4, 1.0e-3, 2.5e-3, 5.0e-3, 1.0e-2};
+
+    std::array<uint64_t, BOUNDS.size() + 1> counts{};
+    double sum = 0.0;
+    uint64_t overBudget = 0;
+
+    /** One block that took seconds to render budget seconds of audio */
+    void add(double seconds, double budget)
+    {
+        size_t b = 0;
+        while (b < BOUNDS.size() && seconds > BOUNDS[b])
+            ++b;
+        ++counts[b];
+        sum += seconds;
+        if (seconds > budget)
+            ++overBudget;
+    }
+
+    void merge(const BlockTimes& other)
+    {
+        for (size_t b = 0; b < counts.size(); ++b)
+            counts[b] += other.counts[b];
+        sum += other.sum;
+        overBudget += other.overBudget;
+    }
+};
+
+/** What a job measured beside its JobResult */
+struct JobMetrics
+{
+    BlockTimes blocks;
+    std::vector<std::pair<std::string, PerfStats::Snapshot>> engines;  // Each rack slot's, in order
+};
+
+class MetricsFile
+{
+public:
+    /** Metrics for a batch of numJobs jobs, kept in path */
+    MetricsFile(std::string path, size_t numJobs) : path(std::move(path)), queued(numJobs) {}
+
+    /** Whether jobs go through a render cache (the cache metrics are left out otherwise) */
+    void setCaching(bool on) { caching = on; }
+
+    /** A job leaves the queue; rewrites the file. Throws std::runtime_error if it can't. */
+    void jobStarted()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued = queued > 0 ? queued - 1 : 0;
+        ++running;
+        write();
+    }
+
+    /** A job is done; rewrites the file. Throws std::runtime_error if it can't. */
+    void jobFinished(const std::string& engine, const JobResult& result, const JobMetrics& measured)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = running > 0 ? running - 1 : 0;
+
+        Engine& e = engines[engine];
+        if (!result.error.empty())
+            ++e.failed;
+        else if (result.cached)
+            ++e.cached;
+        else
+        {
+            ++e.rendered;
+            e.audioSeconds += result.audioSeconds;
+            e.renderSeconds += result.wallSeconds;
+        }
+        if (caching)
+            ++(result.cached ? cacheHits : cacheMisses);
+        e.blocks.merge(measured.blocks);
+        e.residentBytes = std::max(e.residentBytes, residentBytes());
+
+        for (const auto& [name, snap] : measured.engines)
+        {
+            if (!snap.enabled)
+                continue;
+            Counters& c = counters[name];
+            c.blocks += snap.blocks;
+            c.overBudget += snap.blocksOverBudget;
+            for (size_t s = 0; s < c.stageCycles.size(); ++s)
+                c.stageCycles[s] += snap.stageCycles[s];
+            for (size_t v = 0; v < c.voiceBlocks.size(); ++v)
+                c.voiceBlocks[v] += snap.voiceHistogram[v];
+        }
+        write();
+    }
+
+    /** Resident memory now, bytes (0 where it can't be read) */
+    static uint64_t residentBytes()
+    {
+#if defined(__linux__)
+        unsigned long long size = 0, resident = 0;
+        if (FILE* statm = std::fopen("/proc/self/statm", "r"))
+        {
+            if (std::fscanf(statm, "%llu %llu", &size, &resident) != 2)
+                resident = 0;
+            std::fclose(statm);
+        }
+        return static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    /** The most resident memory the process has had, bytes (0 where it can't be read) */
+    static uint64_t peakResidentBytes()
+    {
+#if defined(__linux__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+#endif
+        return 0;
+    }
+
+private:
+    struct Engine
+    {
+        uint64_t rendered = 0, cached = 0, failed = 0;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+        BlockTimes blocks;
+        uint64_t residentBytes = 0;
+    };
+
+    /** An engine's PerfStats, summed over its instances */
+    struct Counters
+    {
+        uint64_t blocks = 0;
+        uint64_t overBudget = 0;
+        std::array<uint64_t, PerfStats::NUM_STAGES> stageCycles{};
+        std::array<uint64_t, PerfStats::HISTOGRAM_SIZE> voiceBlocks{};
+    };
+
+    /** A label value, quoted, with \, " and newlines escaped */
+    static std::string quoted(const std::string& value)
+    {
+        std::string out = "\"";
+        for (char c : value)
+        {
+            if (c == '\\' || c == '"')
+                out += '\\';
+            out += c == '\n' ? std::string("\\n") : std::string(1, c);
+        }
+        return out + "\"";
+    }
+
+    static std::string number(double value)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.15g", value);
+        return text;
+    }
+
+    static std::string number(uint64_t value) { return std::to_string(value); }
+
+    /** The whole exposition, every family once, "# EOF" last (mutex held) */
+    std::string expose() const
+    {
+        std::string out;
+        const auto family = [&out](const char* name, const char* type, const char* help) {
+            out += std::string("# TYPE ") + name + " " + type + "\n# HELP " + name + " " + help + "\n";
+        };
+        const auto sample = [&out](const std::string& name, const std::string& labels, const std::string& value) {
+            out += name + (labels.empty() ? "" : "{" + labels + "}") + " " + value + "\n";
+        };
+
+        family("autosynth_batch_jobs_queued", "gauge", "Jobs not yet started");
+        sample("autosynth_batch_jobs_queued", "", number(static_cast<uint64_t>(queued)));
+        family("autosynth_batch_jobs_running", "gauge", "Jobs rendering now");
+        sample("autosynth_batch_jobs_running", "", number(static_cast<uint64_t>(running)));
+        family("autosynth_batch_peak_resident_bytes", "gauge", "Most resident memory the host has had");
+        sample("autosynth_batch_peak_resident_bytes", "", number(peakResidentBytes()));
+
+        if (caching)
+        {
+            family("autosynth_batch_cache_hits", "counter", "Jobs served from the render cache");
+            sample("autosynth_batch_cache_hits_total", "", number(cacheHits));
+            family("autosynth_batch_cache_misses", "counter", "Jobs the render cache didn't have");
+            sample("autosynth_batch_cache_misses_total", "", number(cacheMisses));
+        }
+
+        family("autosynth_batch_jobs", "counter", "Jobs finished, by outcome");
+        for (const auto& [name, e] : engines)
+        {
+            const std::string engine = "engine=" + quoted(name);
+            sample("autosynth_batch_jobs_total", engine + ",outcome=\"rendered\"", number(e.rendered));
+            sample("autosynth_batch_jobs_total", engine + ",outcome=\"cached\"", number(e.cached));
+            sample("autosynth_batch_jobs_total", engine + ",outcome=\"failed\"", number(e.failed));
+        }
+
+        family("autosynth_batch_audio_seconds", "counter", "Audio rendered, not counting cache hits");
+        for (const auto& [name, e] : engines)
+            sample("autosynth_batch_audio_seconds_total", "engine=" + quoted(name), number(e.audioSeconds));
+        family("autosynth_batch_render_seconds", "counter", "Wall time spent rendering that audio");
+        for (const auto& [name, e] : engines)
+            sample("autosynth_batch_render_seconds_total", "engine=" + quoted(name), number(e.renderSeconds));
+        family("autosynth_batch_realtime_factor", "gauge", "Audio seconds rendered per wall second");
+        for (const auto& [name, e] : engines)
+            sample("autosynth_batch_realtime_factor", "engine=" + quoted(name),
+                   number(e.renderSeconds > 0.0 ? e.audioSeconds / e.renderSeconds : 0.0));
+
+        family("autosynth_batch_block_seconds", "histogram", "Time to render one block");
+        for (const auto& [name, e] : engines)
+        {
+            const std::string engine = "engine=" + quoted(name);
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b < e.blocks.counts.size(); ++b)
+            {
+                cumulative += e.blocks.counts[b];
+                const std::string le = b < BlockTimes::BOUNDS.size() ? number(BlockTimes::BOUNDS[b]) : "+Inf";
+                sample("autosynth_batch_block_seconds_bucket", engine + ",le=" + quoted(le), number(cumulative));
+            }
+            sample("autosynth_batch_block_seconds_count", engine, number(cumulative));
+            sample("autosynth_batch_block_seconds_sum", engine, number(e.blocks.sum));
+        }
+        family("autosynth_batch_blocks_over_budget", "counter", "Blocks that took longer than the audio they hold");
+        for (const auto& [name, e] : engines)
+            sample("autosynth_batch_blocks_over_budget_total", "engine=" + quoted(name),
+                   number(e.blocks.overBudget));
+        family("autosynth_batch_job_resident_bytes", "gauge", "Most resident memory at the end of one of its jobs");
+        for (const auto& [name, e] : engines)
+            sample("autosynth_batch_job_resident_bytes", "engine=" + quoted(name), number(e.residentBytes));
+
+        if (!counters.empty())
+        {
+            family("autosynth_engine_blocks", "counter", "Blocks the engine timed (PerfStats)");
+            for (const auto& [name, c] : counters)
+                sample("autosynth_engine_blocks_total", "engine=" + quoted(name), number(c.blocks));
+            family("autosynth_engine_blocks_over_budget", "counter", "Blocks over budget by the engine's own clock");
+            for (const auto& [name, c] : counters)
+                sample("autosynth_engine_blocks_over_budget_total", "engine=" + quoted(name), number(c.overBudget));
+            family("autosynth_engine_stage_cycles", "counter", "CPU cycles per renderBlock() stage");
+            for (const auto& [name, c] : counters)
+                for (int s = 0; s < PerfStats::NUM_STAGES; ++s)
+                    sample("autosynth_engine_stage_cycles_total",
+                           "engine=" + quoted(name) + ",stage=" + quoted(PerfStats::getStageName(s)),
+                           number(c.stageCycles[static_cast<size_t>(s)]));
+            family("autosynth_engine_voice_blocks", "counter", "Blocks rendered with this many voices active");
+            for (const auto& [name, c] : counters)
+                for (int v = 0; v < PerfStats::HISTOGRAM_SIZE; ++v)
+                {
+                    const std::string voices =
+                        v + 1 < PerfStats::HISTOGRAM_SIZE ? std::to_string(v) : std::to_string(v) + "+";
+                    sample("autosynth_engine_voice_blocks_total", "engine=" + quoted(name) + ",voices=" + quoted(voices),
+                           number(c.voiceBlocks[static_cast<size_t>(v)]));
+                }
+        }
+
+        return out + "# EOF\n";
+    }
+
+    /** Replace the file with the metrics as they are (mutex held) */
+    void write() const
+    {
+        const std::string text = expose();
+        const std::string temp = path + ".tmp";
+        FILE* file = std::fopen(temp.c_str(), "wb");
+        if (file == nullptr)
+            throw std::runtime_error("can't write " + temp);
+        const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        if (std::fclose(file) != 0 || !written)
+            throw std::runtime_error("can't write " + temp);
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+            throw std::runtime_error("can't replace " + path + ": " + ec.message());
+    }
+
+    const std::string path;
+    mutable std::mutex mutex;
+    size_t queued = 0;
+    size_t running = 0;
+    bool caching = false;
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    std::map<std::string, Engine> engines;     // By the job's ENGINE
+    std::map<std::string, Counters> counters;  // By engine library
+};
+
+} // namespace render
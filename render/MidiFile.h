@@ -0,0 +1,264 @@
+/**
+ * @file MidiFile.h
+ * @brief Standard MIDI File reader for the offline renderer
+ *
+ * Reads type 0 and type 1 files (type 2 is read as type 1: all tracks
+ * together), follows the tempo map and running status, and flattens every
+ * track into one list of timed events. Only what the engines respond to is
+ * kept: note on / off, pitch bend, and All Notes Off / All Sound Off. All
+ * channels play the one engine, as the plugins run omni.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render
+{
+
+struct MidiEvent
+{
+    enum class Type { NoteOn, NoteOff, AllNotesOff, PitchBend };
+
+    double seconds = 0.0;
+    Type type = Type::NoteOn;
+    int note = 0;
+    float value = 0.0f;  // Velocity 0-1, or pitch bend -1..+1
+};
+
+class MidiFile
+{
+public:
+    /** Parse the file at path; throws std::runtime_error if it isn't a readable SMF */
+    static std::vector<MidiEvent> load(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't open MIDI file " + path);
+
+        std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        return parse(data, path);
+    }
+
+    static std::vector<MidiEvent> parse(const std::vector<uint8_t>& data, const std::string& name = "MIDI data")
+    {
+        Reader header{data, 0, data.size(), name};
+        if (header.tag() != "MThd")
+            throw std::runtime_error(name + ": not a Standard MIDI File");
+
+        const uint32_t headerLength = header.u32();
+        header.u16();  // Format: every track is merged whatever it says
+        const int numTracks = header.u16();
+        const int division = header.u16();
+        header.pos += headerLength - 6;
+
+        if (division == 0)
+            throw std::runtime_error(name + ": zero ticks per quarter note");
+
+        std::vector<TickEvent> events;
+        size_t pos = header.pos;
+
+        for (int t = 0; t < numTracks && pos + 8 <= data.size(); ++t)
+        {
+            Reader chunk{data, pos, data.size(), name};
+            const std::string tag = chunk.tag();
+            const size_t length = chunk.u32();
+            const size_t end = std::min(chunk.pos + length, data.size());
+
+            if (tag == "MTrk")
+                readTrack(Reader{data, chunk.pos, end, name}, events);
+            else
+                --t;  // Unknown chunks don't count as tracks
+
+            pos = end;
+        }
+
+        return toSeconds(events, division);
+    }
+
+private:
+    struct Reader
+    {
+        const std::vector<uint8_t>& data;
+        size_t pos;
+        size_t end;
+        const std::string& name;
+
+        bool atEnd() const { return pos >= end; }
+
+        uint8_t u8()
+        {
+            if (pos >= end)
+                throw std::runtime_error(name + ": truncated");
+            return data[pos++];
+        }
+
+        int u16()
+        {
+            const int hi = u8();
+            return (hi << 8) | u8();
+        }
+
+        uint32_t u32()
+        {
+            const uint32_t hi = static_cast<uint32_t>(u16());
+            return (hi << 16) | static_cast<uint32_t>(u16());
+        }
+
+        uint32_t varLen()
+        {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const uint8_t b = u8();
+                value = (value << 7) | (b & 0x7f);
+                if ((b & 0x80) == 0)
+                    break;
+            }
+            return value;
+        }
+
+        std::string tag()
+        {
+            std::string s(4, ' ');
+            for (auto& c : s)
+                c = static_cast<char>(u8());
+            return s;
+        }
+    };
+
+    /** An event still in ticks; tempo changes carry microseconds per quarter */
+    struct TickEvent
+    {
+        uint64_t tick = 0;
+        bool isTempo = false;
+        uint32_t tempo = 0;
+        MidiEvent event;
+    };
+
+    static void readTrack(Reader track, std::vector<TickEvent>& events)
+    {
+        uint64_t tick = 0;
+        uint8_t status = 0;
+
+        while (!track.atEnd())
+        {
+            tick += track.varLen();
+            uint8_t byte = track.u8();
+
+            if (byte == 0xff)
+            {
+                const uint8_t type = track.u8();
+                const uint32_t length = track.varLen();
+                if (type == 0x2f)
+                    return;  // End of track
+                if (type == 0x51 && length == 3)
+                {
+                    TickEvent e;
+                    e.tick = tick;
+                    e.isTempo = true;
+                    e.tempo = (static_cast<uint32_t>(track.u8()) << 16) | (static_cast<uint32_t>(track.u8()) << 8)
+                              | track.u8();
+                    events.push_back(e);
+                }
+                else
+                {
+                    track.pos += length;
+                }
+                continue;
+            }
+
+            if (byte == 0xf0 || byte == 0xf7)
+            {
+                track.pos += track.varLen();  // SysEx
+                continue;
+            }
+
+            // Running status: a data byte reuses the last channel status
+            uint8_t data1;
+            if (byte & 0x80)
+            {
+                status = byte;
+                data1 = track.u8();
+            }
+            else
+            {
+                if (status == 0)
+                    throw std::runtime_error(track.name + ": data byte without a status");
+                data1 = byte;
+            }
+
+            const uint8_t kind = status & 0xf0;
+            const bool twoBytes = kind != 0xc0 && kind != 0xd0;
+            const uint8_t data2 = twoBytes ? track.u8() : 0;
+
+            TickEvent e;
+            e.tick = tick;
+
+            if (kind == 0x90 && data2 > 0)
+                e.event = {0.0, MidiEvent::Type::NoteOn, data1, data2 / 127.0f};
+            else if (kind == 0x80 || kind == 0x90)
+                e.event = {0.0, MidiEvent::Type::NoteOff, data1, 0.0f};
+            else if (kind == 0xe0)
+                e.event = {0.0, MidiEvent::Type::PitchBend, 0, ((data2 << 7 | data1) - 8192) / 8192.0f};
+            else if (kind == 0xb0 && (data1 == 120 || data1 == 123))
+                e.event = {0.0, MidiEvent::Type::AllNotesOff, 0, 0.0f};
+            else
+                continue;
+
+            events.push_back(e);
+        }
+    }
+
+    /** Walk the merged events in tick order, converting through the tempo map */
+    static std::vector<MidiEvent> toSeconds(std::vector<TickEvent>& events, int division)
+    {
+        // Tempo changes first at equal ticks, so a note on the change uses the new tempo
+        std::stable_sort(events.begin(), events.end(), [](const TickEvent& a, const TickEvent& b) {
+            return a.tick != b.tick ? a.tick < b.tick : (a.isTempo && !b.isTempo);
+        });
+
+        // Negative division: SMPTE frames per second and ticks per frame, no tempo
+        double secondsPerTick = 0.0;
+        const bool smpte = (division & 0x8000) != 0;
+        if (smpte)
+        {
+            const int fps = 256 - ((division >> 8) & 0xff);
+            secondsPerTick = 1.0 / ((fps == 29 ? 29.97 : fps) * (division & 0xff));
+        }
+        else
+        {
+            secondsPerTick = 0.5 / division;  // 120 BPM until told otherwise
+        }
+
+        std::vector<MidiEvent> out;
+        out.reserve(events.size());
+        uint64_t lastTick = 0;
+        double seconds = 0.0;
+
+        for (const auto& e : events)
+        {
+            seconds += static_cast<double>(e.tick - lastTick) * secondsPerTick;
+            lastTick = e.tick;
+
+            if (e.isTempo)
+            {
+                if (!smpte && e.tempo > 0)
+                    secondsPerTick = e.tempo * 1.0e-6 / division;
+                continue;
+            }
+
+            out.push_back(e.event);
+            out.back().seconds = seconds;
+        }
+        return out;
+    }
+};
+
+} // namespace render
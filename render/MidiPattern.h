@@ -0,0 +1,256 @@
+/**
+ * @file MidiPattern.h
+ * @brief MIDI flattened once to a sorted, sample-stamped array, and a player for it
+ *
+ * MidiFile gives events in seconds; every renderer then converts each one
+ * to a sample on every block. A MidiPattern does that once: a flat array
+ * of 16-byte records, sorted by the frame each lands on, at one sample
+ * rate. PatternPlayer walks it with no allocation and seeks in O(log n),
+ * so the same pattern drives the offline renderer, autosynth-batch, the
+ * browser modules (EngineHost's loadPattern()) and anything else that
+ * plays MIDI without a host:
+ *
+ *   const MidiPattern pattern = MidiPattern::load("song.mid", 48000.0);
+ *   PatternPlayer player(pattern);
+ *   player.seek(48000 * 30);               // Start 30 s in
+ *   player.play(numSamples,
+ *       [&](const PatternEvent& e) { dispatch(engine, toMidiEvent(e)); },
+ *       [&](int start, int count) { engine.renderBlock(l + start, r + start, count); });
+ *
+ * toBinary() / fromBinary() are the same records behind a 16-byte header
+ * ("ASPT", version, sample rate, count), little-endian, ready to hand to
+ * a WASM module in one copy. load() takes either format; a pattern made
+ * at another rate is rescaled to the one asked for.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MidiFile.h"
+
+namespace render
+{
+
+/** One event, on its frame: the binary record as well */
+struct PatternEvent
+{
+    int64_t frame = 0;  // Sample it lands on, from the pattern's start
+    uint8_t type = 0;   // MidiEvent::Type
+    uint8_t note = 0;
+    uint16_t reserved = 0;
+    float value = 0.0f;  // Velocity 0-1, or pitch bend -1..+1
+};
+
+static_assert(sizeof(PatternEvent) == 16, "PatternEvent is the 16-byte binary record");
+
+inline MidiEvent toMidiEvent(const PatternEvent& e)
+{
+    return {0.0, static_cast<MidiEvent::Type>(e.type), e.note, e.value};
+}
+
+class MidiPattern
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 16;
+
+    MidiPattern() = default;
+
+    /** Events from MidiFile, stamped at sampleRate */
+    static MidiPattern fromEvents(const std::vector<MidiEvent>& events, double sampleRate)
+    {
+        MidiPattern pattern;
+        pattern.rate = sampleRate;
+        pattern.events.reserve(events.size());
+        for (const auto& e : events)
+        {
+            PatternEvent p;
+            p.frame = std::llround(e.seconds * sampleRate);
+            p.type = static_cast<uint8_t>(e.type);
+            p.note = static_cast<uint8_t>(e.note & 127);
+            p.value = e.value;
+            pattern.events.push_back(p);
+        }
+
+        // MidiFile's order already; stable so equal frames keep it
+        std::stable_sort(pattern.events.begin(), pattern.events.end(),
+                         [](const PatternEvent& a, const PatternEvent& b) { return a.frame < b.frame; });
+        return pattern;
+    }
+
+    /**
+     * @brief Read a pattern or a Standard MIDI File, at sampleRate
+     * @throws std::runtime_error if it is neither
+     */
+    static MidiPattern load(const std::string& path, double sampleRate)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't open MIDI file " + path);
+
+        const std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        if (isPattern(data.data(), data.size()))
+            return fromBinary(data.data(), data.size(), path).resampled(sampleRate);
+        return fromEvents(MidiFile::parse(data, path), sampleRate);
+    }
+
+    /** True if data starts with a pattern header */
+    static bool isPattern(const uint8_t* data, size_t size)
+    {
+        return size >= HEADER_BYTES && std::memcmp(data, "ASPT", 4) == 0;
+    }
+
+    /** The binary form: header, then the records */
+    std::vector<uint8_t> toBinary() const
+    {
+        std::vector<uint8_t> out(HEADER_BYTES + events.size() * sizeof(PatternEvent));
+        const uint32_t header[3] = {VERSION, static_cast<uint32_t>(std::lround(rate)),
+                                    static_cast<uint32_t>(events.size())};
+        std::memcpy(out.data(), "ASPT", 4);
+        std::memcpy(out.data() + 4, header, sizeof(header));
+        if (!events.empty())
+            std::memcpy(out.data() + HEADER_BYTES, events.data(), events.size() * sizeof(PatternEvent));
+        return out;
+    }
+
+    /** @throws std::runtime_error on a bad header, a short file or unsorted records */
+    static MidiPattern fromBinary(const uint8_t* data, size_t size, const std::string& name = "pattern")
+    {
+        if (!isPattern(data, size))
+            throw std::runtime_error(name + ": not a MIDI pattern");
+
+        uint32_t header[3];
+        std::memcpy(header, data + 4, sizeof(header));
+        if (header[0] != VERSION)
+            throw std::runtime_error(name + ": pattern version " + std::to_string(header[0]) + " not supported");
+        if (header[1] == 0 || (size - HEADER_BYTES) / sizeof(PatternEvent) < header[2])
+            throw std::runtime_error(name + ": truncated");
+
+        MidiPattern pattern;
+        pattern.rate = header[1];
+        pattern.events.resize(header[2]);
+        if (header[2] > 0)
+            std::memcpy(pattern.events.data(), data + HEADER_BYTES, header[2] * sizeof(PatternEvent));
+
+        const auto earlier = [](const PatternEvent& a, const PatternEvent& b) { return a.frame < b.frame; };
+        if (!std::is_sorted(pattern.events.begin(), pattern.events.end(), earlier))
+            throw std::runtime_error(name + ": events out of order");
+        return pattern;
+    }
+
+    /** The same events stamped at another rate */
+    MidiPattern resampled(double sampleRate) const
+    {
+        if (sampleRate == rate)
+            return *this;
+
+        MidiPattern pattern = *this;
+        pattern.rate = sampleRate;
+        for (auto& e : pattern.events)
+            e.frame = std::llround(static_cast<double>(e.frame) * sampleRate / rate);
+        return pattern;
+    }
+
+    double getSampleRate() const { return rate; }
+    const PatternEvent* data() const { return events.data(); }
+    size_t size() const { return events.size(); }
+    bool empty() const { return events.empty(); }
+
+    /** Frame of the last event (0 when empty) */
+    int64_t lastFrame() const { return events.empty() ? 0 : events.back().frame; }
+
+private:
+    static_assert(std::endian::native == std::endian::little, "the binary form is the records as they are in memory");
+
+    double rate = 48000.0;
+    std::vector<PatternEvent> events;
+};
+
+/**
+ * @brief Plays a pattern's events on their frames; real-time safe
+ *
+ * Holds a pointer to the events, not a copy: the pattern must outlive it.
+ */
+class PatternPlayer
+{
+public:
+    PatternPlayer() = default;
+    explicit PatternPlayer(const MidiPattern& pattern) { setPattern(pattern.data(), pattern.size()); }
+
+    /** Play these events (sorted by frame) from the start */
+    void setPattern(const PatternEvent* data, size_t count)
+    {
+        events = data;
+        numEvents = count;
+        seek(0);
+    }
+
+    /** Move to frame: the next event is the first at or after it */
+    void seek(int64_t frame)
+    {
+        position = frame;
+        next = static_cast<size_t>(
+            std::lower_bound(events, events + numEvents, frame,
+                             [](const PatternEvent& e, int64_t f) { return e.frame < f; })
+            - events);
+    }
+
+    int64_t getPosition() const { return position; }
+
+    /** True once every event has been dispatched */
+    bool isFinished() const { return next >= numEvents; }
+
+    /** Frames from the position to the next event (a large number when finished) */
+    int64_t framesToNext() const
+    {
+        return isFinished() ? std::numeric_limits<int64_t>::max() : std::max<int64_t>(0, events[next].frame - position);
+    }
+
+    /** Dispatch every event due at the current position (frame <= position) */
+    template <typename DispatchFn>
+    void dispatchDue(DispatchFn&& dispatch)
+    {
+        for (; next < numEvents && events[next].frame <= position; ++next)
+            dispatch(events[next]);
+    }
+
+    /** Move the position on without dispatching (after rendering that far) */
+    void advance(int numSamples) { position += numSamples; }
+
+    /**
+     * @brief Play numSamples frames from the position
+     * @param dispatch Called as dispatch(event) before the run it starts
+     * @param render Called as render(startSample, numSamples) for each run between events
+     */
+    template <typename DispatchFn, typename RenderFn>
+    void play(int numSamples, DispatchFn&& dispatch, RenderFn&& render)
+    {
+        for (int done = 0; done < numSamples;)
+        {
+            dispatchDue(dispatch);
+            const int n = static_cast<int>(std::clamp<int64_t>(framesToNext(), 1, numSamples - done));
+            render(done, n);
+            advance(n);
+            done += n;
+        }
+    }
+
+private:
+    const PatternEvent* events = nullptr;
+    size_t numEvents = 0;
+    size_t next = 0;
+    int64_t position = 0;
+};
+
+} // namespace render
@@ -0,0 +1,380 @@
+/**
+ * @file PresetFile.h
+ * @brief Preset JSON (templates/presets/preset-schema.json) to plain parameter values
+ *
+ * A preset stores each parameter normalised 0-1, keyed by parameter ID, the
+ * way the host sees it. Each render adapter lists its plugin's parameters
+ * with the same ranges as createParameterLayout(), and the values are
+ * converted back to what apvts.getRawParameterValue() would return:
+ * JUCE's NormalisableRange skew and interval snapping for floats, rounding
+ * for ints and choices, >= 0.5 for bools. Parameters the preset leaves out
+ * keep their defaults. "modulation" and "ui" are ignored: the engines have
+ * no routing the preset could drive.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace render
+{
+
+/** One plugin parameter, as declared in createParameterLayout() */
+struct Param
+{
+    std::string id;
+    float min = 0.0f;
+    float max = 1.0f;
+    float defaultValue = 0.0f;
+    float interval = 0.0f;  // NormalisableRange interval (0 = continuous)
+    float skew = 1.0f;      // NormalisableRange skew factor
+
+    /** AudioParameterBool */
+    static Param toggle(std::string id, bool defaultValue)
+    {
+        return {std::move(id), 0.0f, 1.0f, defaultValue ? 1.0f : 0.0f, 1.0f};
+    }
+
+    /** AudioParameterChoice with numChoices entries */
+    static Param choice(std::string id, int numChoices, int defaultIndex)
+    {
+        return {std::move(id), 0.0f, static_cast<float>(numChoices - 1), static_cast<float>(defaultIndex), 1.0f};
+    }
+
+    /** AudioParameterInt */
+    static Param integer(std::string id, int min, int max, int defaultValue)
+    {
+        return {std::move(id), static_cast<float>(min), static_cast<float>(max), static_cast<float>(defaultValue), 1.0f};
+    }
+
+    /** NormalisableRange::convertFrom0to1() followed by snapToLegalValue() */
+    float fromNormalised(float proportion) const
+    {
+        proportion = std::clamp(proportion, 0.0f, 1.0f);
+        if (skew != 1.0f && proportion > 0.0f)
+            proportion = std::exp(std::log(proportion) / skew);
+
+        float value = min + (max - min) * proportion;
+        if (interval > 0.0f)
+            value = min + interval * std::floor((value - min) / interval + 0.5f);
+        return std::clamp(value, min, max);
+    }
+
+    /** A plain value as apvts would hold it: clamped, whole for ints and choices (the default if not finite) */
+    float constrain(float value) const
+    {
+        if (!std::isfinite(value))
+            return defaultValue;
+        value = std::clamp(value, min, max);
+        return interval >= 1.0f ? std::round(value) : value;
+    }
+};
+
+/** A minimal JSON reader: enough for preset files */
+class Json
+{
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<Json> array;
+    std::vector<std::pair<std::string, Json>> object;
+
+    static Json parse(const std::string& text, const std::string& name)
+    {
+        Parser parser{text, 0, name};
+        Json value = parser.value();
+        parser.skipSpace();
+        if (parser.pos != text.size())
+            parser.fail("trailing characters");
+        return value;
+    }
+
+    /** Member of an object, or nullptr */
+    const Json* find(const std::string& key) const
+    {
+        for (const auto& [k, v] : object)
+            if (k == key)
+                return &v;
+        return nullptr;
+    }
+
+private:
+    struct Parser
+    {
+        const std::string& text;
+        size_t pos;
+        const std::string& name;
+
+        [[noreturn]] void fail(const std::string& what) const
+        {
+            throw std::runtime_error(name + ": " + what + " at offset " + std::to_string(pos));
+        }
+
+        void skipSpace()
+        {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+                ++pos;
+        }
+
+        bool consume(char c)
+        {
+            skipSpace();
+            if (pos < text.size() && text[pos] == c)
+            {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+
+        void expect(char c)
+        {
+            if (!consume(c))
+                fail(std::string("expected '") + c + "'");
+        }
+
+        bool literal(const char* word)
+        {
+            const size_t n = std::char_traits<char>::length(word);
+            if (text.compare(pos, n, word) != 0)
+                return false;
+            pos += n;
+            return true;
+        }
+
+        Json value()
+        {
+            skipSpace();
+            if (pos >= text.size())
+                fail("unexpected end");
+
+            Json v;
+            const char c = text[pos];
+
+            if (c == '{')
+            {
+                v.type = Type::Object;
+                ++pos;
+                if (consume('}'))
+                    return v;
+                do
+                {
+                    skipSpace();
+                    std::string key = str();
+                    expect(':');
+                    v.object.emplace_back(std::move(key), value());
+                } while (consume(','));
+                expect('}');
+            }
+            else if (c == '[')
+            {
+                v.type = Type::Array;
+                ++pos;
+                if (consume(']'))
+                    return v;
+                do
+                    v.array.push_back(value());
+                while (consume(','));
+                expect(']');
+            }
+            else if (c == '"')
+            {
+                v.type = Type::String;
+                v.string = str();
+            }
+            else if (literal("true"))
+            {
+                v.type = Type::Bool;
+                v.boolean = true;
+            }
+            else if (literal("false"))
+            {
+                v.type = Type::Bool;
+            }
+            else if (literal("null"))
+            {
+                v.type = Type::Null;
+            }
+            else
+            {
+                const char* start = text.c_str() + pos;
+                char* end = nullptr;
+                v.type = Type::Number;
+                v.number = std::strtod(start, &end);
+                if (end == start)
+                    fail("unexpected character");
+                pos += static_cast<size_t>(end - start);
+            }
+            return v;
+        }
+
+        /** A string; \u escapes outside ASCII come out as '?' (only names use them) */
+        std::string str()
+        {
+            if (pos >= text.size() || text[pos] != '"')
+                fail("expected a string");
+            ++pos;
+
+            std::string s;
+            while (pos < text.size() && text[pos] != '"')
+            {
+                char c = text[pos++];
+                if (c == '\\' && pos < text.size())
+                {
+                    c = text[pos++];
+                    switch (c)
+                    {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'u':
+                    {
+                        const long code = std::strtol(text.substr(pos, 4).c_str(), nullptr, 16);
+                        pos += 4;
+                        c = code < 0x80 ? static_cast<char>(code) : '?';
+                        break;
+                    }
+                    default: break;  // \" \\ \/
+                    }
+                }
+                s += c;
+            }
+            if (pos >= text.size())
+                fail("unterminated string");
+            ++pos;
+            return s;
+        }
+    };
+};
+
+/** Plain parameter values for one render, looked up by ID */
+class ParamValues
+{
+public:
+    /** Every parameter at its default */
+    explicit ParamValues(const std::vector<Param>& params)
+    {
+        for (const auto& p : params)
+            values[p.id] = p.defaultValue;
+    }
+
+    /** The value apvts.getRawParameterValue(id) would hold */
+    float operator[](const std::string& id) const
+    {
+        auto it = values.find(id);
+        if (it == values.end())
+            throw std::logic_error("render adapter reads unknown parameter '" + id + "'");
+        return it->second;
+    }
+
+    /** Choice / int parameters, as processBlock() casts them */
+    int index(const std::string& id) const { return static_cast<int>((*this)[id]); }
+
+    /** Bool parameters, as processBlock() tests them */
+    bool flag(const std::string& id) const { return (*this)[id] > 0.5f; }
+
+    void set(const std::string& id, float value) { values[id] = value; }
+
+    /** Every value by ID, in ID order */
+    const std::map<std::string, float>& all() const { return values; }
+
+private:
+    std::map<std::string, float> values;
+};
+
+/**
+ * @brief The engine's parameter snapshot holding these values
+ * @param ids The plugin's kParamIds table (dsp/SynthParams.h)
+ * @return A fresh snapshot: every value reads as changed, so applySnapshot() sets them all
+ */
+template <typename Snapshot, size_t N>
+Snapshot makeSnapshot(const ParamValues& values, const char* const (&ids)[N])
+{
+    static_assert(static_cast<int>(N) == Snapshot::SIZE, "ID table and snapshot disagree");
+    Snapshot snapshot;
+    for (size_t i = 0; i < N; ++i)
+        snapshot.set(static_cast<int>(i), values[ids[i]]);
+    return snapshot;
+}
+
+/** A loaded preset file */
+struct Preset
+{
+    std::string name;
+    std::vector<std::pair<std::string, float>> normalised;  // "parameters", in file order
+
+    static Preset load(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't open preset " + path);
+
+        const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        const Json root = Json::parse(text, path);
+        if (root.type != Json::Type::Object)
+            throw std::runtime_error(path + ": preset is not a JSON object");
+
+        Preset preset;
+        if (const Json* meta = root.find("meta"))
+            if (const Json* name = meta->find("name"); name && name->type == Json::Type::String)
+                preset.name = name->string;
+
+        const Json* params = root.find("parameters");
+        if (params == nullptr || params->type != Json::Type::Object)
+            throw std::runtime_error(path + ": no \"parameters\" object");
+
+        for (const auto& [id, value] : params->object)
+        {
+            if (value.type == Json::Type::Number)
+                preset.normalised.emplace_back(id, static_cast<float>(value.number));
+            else if (value.type == Json::Type::Bool)
+                preset.normalised.emplace_back(id, value.boolean ? 1.0f : 0.0f);
+            else
+                throw std::runtime_error(path + ": parameter '" + id + "' is not a number");
+        }
+        return preset;
+    }
+
+    /**
+     * @brief Plain values for params with this preset applied
+     * @param warnings Gets one line per ID the plugin doesn't have or value outside 0-1
+     */
+    ParamValues resolve(const std::vector<Param>& params, std::vector<std::string>& warnings) const
+    {
+        ParamValues values(params);
+
+        for (const auto& [id, proportion] : normalised)
+        {
+            auto it = std::find_if(params.begin(), params.end(), [&](const Param& p) { return p.id == id; });
+            if (it == params.end())
+            {
+                warnings.push_back("unknown parameter '" + id + "' ignored");
+                continue;
+            }
+            if (proportion < 0.0f || proportion > 1.0f)
+                warnings.push_back("parameter '" + id + "' outside 0-1, clamped");
+
+            values.set(id, it->fromNormalised(proportion));
+        }
+        return values;
+    }
+};
+
+} // namespace render
@@ -0,0 +1,239 @@
+/**
+ * @file RenderCache.h
+ * @brief Content-addressed cache of rendered WAVs
+ *
+ * The website's demos and the preset previews render the same audio every
+ * time a page or a build asks for it. With --cache DIR a job is first
+ * reduced to a key, a hash of everything its output depends on:
+ *
+ *   - the engine: its name and a hash of the binary that renders it (the
+ *     executable, or for autosynth-batch the library and the batch host),
+ *     so any rebuild that changes the DSP changes the key
+ *   - the preset as resolved: every parameter's plain value by ID, so
+ *     renaming a preset or editing its "ui" block doesn't re-render it,
+ *     and a quality or oversampling parameter is part of the key
+ *   - the MIDI as the pattern it plays (MidiPattern::toBinary())
+ *   - --rate, --block, --bits, --length, --tail and --seed
+ *
+ * DIR/ab/abcd....wav holds the render for key abcd...; next to it, a .meta
+ * line holds its length and peak for the summary. A hit is copied to the
+ * job's output by the kernel (copy_file, sendfile for stdout) without
+ * passing through the renderer. A miss renders into a temporary file in
+ * DIR, renamed into place once complete, so a concurrent or interrupted
+ * job never leaves half a WAV under a key, then is served the same way.
+ * Regenerating a catalog re-renders only the presets that changed.
+ *
+ * Nothing is evicted: delete DIR, or old files in it, to reclaim space.
+ * The hash is not cryptographic; it keys a cache of one's own renders.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AUTOSYNTH_RENDER_HAS_SENDFILE 1
+#endif
+
+namespace render
+{
+
+/** 128-bit hash of a byte stream: two 64-bit multiply-xor lanes, finalised apart */
+class CacheKey
+{
+public:
+    void add(const void* data, size_t bytes)
+    {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            a = (a ^ p[i]) * 0x100000001b3ull;         // FNV-1a
+            b = (b ^ p[i]) * 0x9e3779b97f4a7c15ull + 1;  // A second, unrelated multiplier
+        }
+    }
+
+    /** Strings go in with their length, so "ab" + "c" differs from "a" + "bc" */
+    void add(const std::string& s)
+    {
+        add(static_cast<uint64_t>(s.size()));
+        add(s.data(), s.size());
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void add(T value)
+    {
+        add(&value, sizeof(value));
+    }
+
+    /** 32 hex digits */
+    std::string hex() const
+    {
+        char text[33];
+        std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(mix(a)),
+                      static_cast<unsigned long long>(mix(b ^ 0x5851f42d4c957f2dull)));
+        return text;
+    }
+
+    /** The hash of a file's bytes; throws std::runtime_error if it can't be read */
+    static std::string ofFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can't read " + path);
+
+        CacheKey key;
+        std::vector<char> chunk(1 << 16);
+        while (in.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || in.gcount() > 0)
+            key.add(chunk.data(), static_cast<size_t>(in.gcount()));
+        return key.hex();
+    }
+
+    /** The running executable's hash (argv[0] where /proc/self/exe isn't there) */
+    static std::string ofSelf(const char* argv0)
+    {
+        std::error_code ec;
+        return ofFile(std::filesystem::exists("/proc/self/exe", ec) ? "/proc/self/exe" : argv0);
+    }
+
+private:
+    // splitmix64's finaliser, so every input bit reaches every output bit
+    static uint64_t mix(uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t a = 0xcbf29ce484222325ull;
+    uint64_t b = 0x6a09e667f3bcc909ull;
+};
+
+class RenderCache
+{
+public:
+    /** What the summary line needs from a render, kept beside it */
+    struct Entry
+    {
+        double audioSeconds = 0.0;
+        float peak = 0.0f;
+        long nonFinite = 0;
+    };
+
+    /** Cache in dir, created if need be; throws std::filesystem::filesystem_error */
+    explicit RenderCache(std::string dir) : root(std::move(dir)) { std::filesystem::create_directories(root); }
+
+    /** The cached WAV for key */
+    std::string pathFor(const std::string& key) const { return (directoryFor(key) / (key + ".wav")).string(); }
+
+    /** True, with its entry, if key has been rendered */
+    bool lookup(const std::string& key, Entry& entry) const
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(pathFor(key), ec))
+            return false;
+
+        std::FILE* meta = std::fopen(metaPathFor(key).c_str(), "r");
+        if (meta == nullptr)
+            return false;
+        const bool ok = std::fscanf(meta, "%lf %f %ld", &entry.audioSeconds, &entry.peak, &entry.nonFinite) == 3;
+        std::fclose(meta);
+        return ok;
+    }
+
+    /** A fresh file in the cache to render key into, before commit() */
+    std::string tempPathFor(const std::string& key) const
+    {
+        static std::atomic<uint64_t> counter{0};
+        std::filesystem::create_directories(directoryFor(key));
+        const size_t thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return (directoryFor(key)
+                / (key + ".tmp" + std::to_string(thread) + "-" + std::to_string(counter++)))
+            .string();
+    }
+
+    /** Move a finished render from tempPathFor() under key, with its entry */
+    void commit(const std::string& key, const std::string& tempPath, const Entry& entry) const
+    {
+        // The meta first: lookup() wants both, and the WAV appearing is the commit
+        const std::string metaTemp = tempPath + ".meta";
+        std::FILE* meta = std::fopen(metaTemp.c_str(), "w");
+        if (meta == nullptr)
+            throw std::runtime_error("can't write " + metaTemp);
+        std::fprintf(meta, "%.17g %.9g %ld\n", entry.audioSeconds, static_cast<double>(entry.peak), entry.nonFinite);
+        std::fclose(meta);
+
+        std::filesystem::rename(metaTemp, metaPathFor(key));
+        std::filesystem::rename(tempPath, pathFor(key));
+    }
+
+    /** Copy key's WAV to out, a file or "-" for stdout, in the kernel where it can */
+    void serve(const std::string& key, const std::string& out) const
+    {
+        const std::string cached = pathFor(key);
+        if (out == "-")
+        {
+            streamToStdout(cached);
+            return;
+        }
+
+        const std::filesystem::path outPath(out);
+        if (outPath.has_parent_path())
+            std::filesystem::create_directories(outPath.parent_path());
+        std::filesystem::copy_file(cached, outPath, std::filesystem::copy_options::overwrite_existing);
+    }
+
+private:
+    std::filesystem::path directoryFor(const std::string& key) const { return std::filesystem::path(root) / key.substr(0, 2); }
+    std::string metaPathFor(const std::string& key) const { return (directoryFor(key) / (key + ".meta")).string(); }
+
+    static void streamToStdout(const std::string& path)
+    {
+        std::fflush(stdout);
+#ifdef AUTOSYNTH_RENDER_HAS_SENDFILE
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("can't read " + path);
+        struct stat info{};
+        off_t offset = 0;
+        const bool sized = ::fstat(fd, &info) == 0;
+        while (sized && offset < info.st_size
+               && ::sendfile(STDOUT_FILENO, fd, &offset, static_cast<size_t>(info.st_size - offset)) > 0)
+        {
+        }
+        ::close(fd);
+        if (sized && offset >= info.st_size)
+            return;
+        // Not everything takes sendfile(); copy the rest through a buffer
+        const auto done = static_cast<std::streamoff>(offset);
+#else
+        const std::streamoff done = 0;
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in || !in.seekg(done))
+            throw std::runtime_error("can't read " + path);
+        std::vector<char> chunk(1 << 16);
+        while (in.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || in.gcount() > 0)
+            if (std::fwrite(chunk.data(), 1, static_cast<size_t>(in.gcount()), stdout) != static_cast<size_t>(in.gcount()))
+                throw std::runtime_error("can't write to stdout");
+        std::fflush(stdout);
+    }
+
+    std::string root;
+};
+
+} // namespace render
@@ -0,0 +1,709 @@
+/**
+ * @file RenderHarness.h
+ * @brief Headless offline renderer shared by every autosynth-render executable
+ *
+ * Renders MIDI files through a plugin's engine with a preset applied, to
+ * WAV, with no JUCE: each plugins/synths engine gets its own small
+ * executable (the engines all use the same class names in the global
+ * namespace, as in bench/), which lists the plugin's parameters and applies
+ * them the way its processBlock() does. This header does the rest.
+ *
+ * Jobs are a MIDI file, a preset and an output path. They run in parallel,
+ * one per thread, each with its own engine; every block is written out as
+ * it is rendered, so a job holds one block of audio however long it is.
+ * MIDI events land on their sample: the block is split at each event, as
+ * a host with sample-accurate automation would.
+ *
+ * --automation plays parameter automation (Automation.h) on the same
+ * timeline as the MIDI: each lane's value is applied at the start of every
+ * run the block is split into, as a host's per-block automation would be.
+ *
+ * A job renders to the later of the last MIDI event or automation point
+ * and --length, then sends note offs for anything still held (and stops
+ * the sequencer, for engines with setRunning()) and renders at most --tail
+ * seconds more. The tail stops early once the engine reports isSilent(),
+ * or, for engines without it, after a second of output below -120 dB.
+ *
+ * Usage:
+ *   autosynth-render-<Plugin> --midi song.mid --preset lead.json --out lead.wav
+ *   autosynth-render-<Plugin> --midi song.mid --preset a.json --preset b.json --out-dir renders/
+ *   autosynth-render-<Plugin> --jobs batch.txt
+ *
+ *   --midi FILE      MIDI file to play (repeatable; every MIDI x every preset)
+ *   --preset FILE    Preset JSON (repeatable; none = parameter defaults)
+ *   --automation F   Parameter automation for every job, binary or text
+ *                    (Automation.h)
+ *   --out FILE       Output WAV, for a single job
+ *   --out-dir DIR    Output directory, named <midi>_<preset>.wav (default .)
+ *   --jobs FILE      One job per line: MIDI PRESET OUT ('-' for no MIDI / preset)
+ *   --rate HZ        Sample rate (default 48000)
+ *   --block N        Block size passed to the engine (default 128)
+ *   --bits N         16, 24 or 32 (float) (default 24)
+ *   --length S       Render at least S seconds, for sequencer-driven engines
+ *   --tail S         At most S seconds after the end for release tails (default 5)
+ *   --threads N      Worker threads (default: all cores)
+ *   --seed N         Noise seed for engines with setNoiseSeed() (default 1, so
+ *                    renders are bit-identical from run to run)
+ *   --fuzz N         Instead of rendering: N random-parameter trials (Fuzz.h),
+ *                    failures written to --out-dir
+ *   --fuzz-trial T   Rerun fuzz trial T of --seed only
+ *   --spike X        Fuzz: a block over X times the median fails (default 8)
+ *   --to-pattern F   Instead of rendering: write the --midi file as a MIDI
+ *                    pattern at --rate (MidiPattern.h), for the browser
+ *                    modules' loadPattern() or a later --midi
+ *   --cache DIR      Keep renders in DIR by content (RenderCache.h) and copy
+ *                    a job's WAV from there when nothing it depends on changed
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Automation.h"
+#include "Fuzz.h"
+#include "MidiFile.h"
+#include "MidiPattern.h"
+#include "PresetFile.h"
+#include "RenderCache.h"
+#include "WavWriter.h"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define AUTOSYNTH_RENDER_HAS_MXCSR 1
+#endif
+
+namespace render
+{
+
+struct Options
+{
+    std::vector<std::string> midiFiles;
+    std::vector<std::string> presets;
+    std::string automation;  // Parameter automation for every job (empty: none)
+    std::string out;
+    std::string outDir = ".";
+    std::string jobsFile;
+    double sampleRate = 48000.0;
+    int blockSize = 128;
+    int bits = 24;
+    double length = 0.0;  // Minimum seconds before the tail
+    double tail = 5.0;    // Maximum seconds of tail
+    int threads = 0;      // 0 = hardware concurrency
+    uint32_t seed = 1;    // Noise seed, the same for every job
+    int fuzz = 0;         // Fuzz trials instead of jobs (0: render)
+    int fuzzTrial = -1;   // Only this trial (-1: trials 0..fuzz-1)
+    double spike = 8.0;   // Fuzz spike threshold, times the median block
+    std::string toPattern;  // Convert the MIDI file to a pattern here instead of rendering
+    std::string cacheDir;   // Content-addressed render cache (empty: none)
+};
+
+struct Job
+{
+    std::string midi;    // Empty: no MIDI
+    std::string preset;  // Empty: parameter defaults
+    std::string out;
+};
+
+/** What a job produced, for the summary line */
+struct JobResult
+{
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    float peak = 0.0f;
+    long nonFinite = 0;
+    std::vector<std::string> warnings;
+    std::string error;    // Empty on success
+    bool cached = false;  // Copied from the render cache, not rendered
+};
+
+/** Output below this for SILENT_HOLD_SECONDS ends the tail, for engines without isSilent() */
+inline constexpr float SILENCE_THRESHOLD = 1.0e-6f;
+inline constexpr double SILENT_HOLD_SECONDS = 1.0;
+
+inline void usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--midi FILE]... [--preset FILE]... [--out FILE | --out-dir DIR]\n"
+                 "       %*s [--jobs FILE] [--rate HZ] [--block N] [--bits 16|24|32]\n"
+                 "       %*s [--length S] [--tail S] [--threads N] [--seed N]\n"
+                 "       %*s [--fuzz N | --fuzz-trial T] [--spike X]\n"
+                 "       %*s [--automation FILE] [--to-pattern FILE] [--cache DIR]\n",
+                 program, static_cast<int>(std::strlen(program)), "", static_cast<int>(std::strlen(program)), "",
+                 static_cast<int>(std::strlen(program)), "", static_cast<int>(std::strlen(program)), "");
+}
+
+/** Parse the command line; returns false (after printing why) on a bad one */
+inline bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h")
+        {
+            usage(argv[0]);
+            return false;
+        }
+        if (!hasValue)
+        {
+            std::fprintf(stderr, "%s: %s needs a value\n", argv[0], arg.c_str());
+            return false;
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--midi")
+            options.midiFiles.push_back(value);
+        else if (arg == "--preset")
+            options.presets.push_back(value);
+        else if (arg == "--automation")
+            options.automation = value;
+        else if (arg == "--out")
+            options.out = value;
+        else if (arg == "--out-dir")
+            options.outDir = value;
+        else if (arg == "--jobs")
+            options.jobsFile = value;
+        else if (arg == "--rate")
+            options.sampleRate = std::clamp(std::atof(value), 8000.0, 384000.0);
+        else if (arg == "--block")
+            options.blockSize = std::clamp(std::atoi(value), 1, 8192);
+        else if (arg == "--bits")
+            options.bits = std::atoi(value);
+        else if (arg == "--length")
+            options.length = std::max(0.0, std::atof(value));
+        else if (arg == "--tail")
+            options.tail = std::max(0.0, std::atof(value));
+        else if (arg == "--threads")
+            options.threads = std::max(0, std::atoi(value));
+        else if (arg == "--seed")
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 0));
+        else if (arg == "--fuzz")
+            options.fuzz = std::max(0, std::atoi(value));
+        else if (arg == "--fuzz-trial")
+            options.fuzzTrial = std::max(0, std::atoi(value));
+        else if (arg == "--spike")
+            options.spike = std::max(1.0, std::atof(value));
+        else if (arg == "--to-pattern")
+            options.toPattern = value;
+        else if (arg == "--cache")
+            options.cacheDir = value;
+        else
+        {
+            std::fprintf(stderr, "%s: unknown option %s\n", argv[0], arg.c_str());
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (options.bits != 16 && options.bits != 24 && options.bits != 32)
+    {
+        std::fprintf(stderr, "%s: --bits must be 16, 24 or 32\n", argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/** File name without directory or extension */
+inline std::string stem(const std::string& path)
+{
+    return std::filesystem::path(path).stem().string();
+}
+
+/** The jobs the options describe; throws std::runtime_error on an unreadable jobs file */
+inline std::vector<Job> makeJobs(const Options& options, const std::string& name)
+{
+    std::vector<Job> jobs;
+
+    if (!options.jobsFile.empty())
+    {
+        std::ifstream in(options.jobsFile);
+        if (!in)
+            throw std::runtime_error("can't open jobs file " + options.jobsFile);
+
+        std::string line;
+        for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            Job job;
+            if (!(fields >> job.midi >> job.preset >> job.out))
+                throw std::runtime_error(options.jobsFile + ":" + std::to_string(lineNumber)
+                                         + ": expected MIDI PRESET OUT");
+            if (job.midi == "-")
+                job.midi.clear();
+            if (job.preset == "-")
+                job.preset.clear();
+            jobs.push_back(job);
+        }
+        return jobs;
+    }
+
+    std::vector<std::string> midis = options.midiFiles;
+    std::vector<std::string> presets = options.presets;
+    if (midis.empty())
+        midis.emplace_back();
+    if (presets.empty())
+        presets.emplace_back();
+
+    for (const auto& midi : midis)
+    {
+        for (const auto& preset : presets)
+        {
+            // Name by whatever varies, so a batch doesn't overwrite itself
+            std::string file;
+            if (options.midiFiles.size() > 1 || options.presets.empty())
+                file = midi.empty() ? name : stem(midi);
+            if (!preset.empty())
+                file += (file.empty() ? "" : "_") + stem(preset);
+
+            const std::string out = options.out.empty() ? (std::filesystem::path(options.outDir) / (file + ".wav")).string()
+                                                        : options.out;
+            jobs.push_back({midi, preset, out});
+        }
+    }
+
+    if (!options.out.empty() && jobs.size() > 1)
+        throw std::runtime_error("--out names one file but there are " + std::to_string(jobs.size())
+                                 + " jobs; use --out-dir");
+    return jobs;
+}
+
+/**
+ * @brief Flush denormals to zero, as the plugin hosts do
+ *
+ * Per thread: every worker sets its own MXCSR.
+ */
+class ScopedFlushDenormals
+{
+public:
+    ScopedFlushDenormals()
+    {
+#ifdef AUTOSYNTH_RENDER_HAS_MXCSR
+        saved = _mm_getcsr();
+        _mm_setcsr(saved | 0x8040);  // FTZ | DAZ
+#endif
+    }
+
+    ~ScopedFlushDenormals()
+    {
+#ifdef AUTOSYNTH_RENDER_HAS_MXCSR
+        _mm_setcsr(saved);
+#endif
+    }
+
+private:
+#ifdef AUTOSYNTH_RENDER_HAS_MXCSR
+    unsigned int saved = 0;
+#endif
+};
+
+/** Send one MIDI event to any engine, using whichever calls it has */
+template <typename Engine>
+void dispatch(Engine& engine, const MidiEvent& event)
+{
+    switch (event.type)
+    {
+    case MidiEvent::Type::NoteOn:
+        if constexpr (requires { engine.noteOn(60, 1.0f); })
+            engine.noteOn(event.note, event.value);
+        break;
+    case MidiEvent::Type::NoteOff:
+        if constexpr (requires { engine.noteOff(60); })
+            engine.noteOff(event.note);
+        break;
+    case MidiEvent::Type::AllNotesOff:
+        if constexpr (requires { engine.allNotesOff(); })
+            engine.allNotesOff();
+        break;
+    case MidiEvent::Type::PitchBend:
+        if constexpr (requires { engine.setPitchBend(0.0f); })
+            engine.setPitchBend(event.value);
+        break;
+    }
+}
+
+/**
+ * @brief A job's render cache key: everything its WAV depends on
+ * @param engine The engine's name and the hash of what renders it (CacheKey::ofSelf())
+ */
+inline std::string cacheKey(const std::string& engine, const MidiPattern& pattern, const ParamValues& values,
+                            const Options& options, const Automation& automation = {})
+{
+    CacheKey key;
+    key.add(engine);
+    for (const auto& [id, value] : values.all())
+    {
+        key.add(id);
+        key.add(value);
+    }
+    const std::vector<uint8_t> midi = pattern.toBinary();
+    key.add(midi.data(), midi.size());
+    if (!automation.empty())
+    {
+        const std::vector<uint8_t> lanes = automation.toBinary();
+        key.add(lanes.data(), lanes.size());
+    }
+    key.add(options.sampleRate);
+    key.add(options.blockSize);
+    key.add(options.bits);
+    key.add(options.length);
+    key.add(options.tail);
+    key.add(options.seed);
+    return key.hex();
+}
+
+/**
+ * @brief Serve a job from the cache if it's there
+ * @param target Set to where to render on a miss: a file in the cache, or job.out with no cache
+ * @return True if the job's WAV was copied from the cache
+ */
+inline bool serveCached(const RenderCache* cache, const std::string& key, const Job& job, JobResult& result,
+                        std::string& target)
+{
+    target = job.out;
+    if (cache == nullptr)
+        return false;
+
+    RenderCache::Entry entry;
+    if (!cache->lookup(key, entry))
+    {
+        target = cache->tempPathFor(key);
+        return false;
+    }
+    cache->serve(key, job.out);
+    result.audioSeconds = entry.audioSeconds;
+    result.peak = entry.peak;
+    result.nonFinite = entry.nonFinite;
+    result.cached = true;
+    return true;
+}
+
+/** After a render into target (serveCached()): keep it under key and copy it to the job's output */
+inline void storeCached(const RenderCache* cache, const std::string& key, const Job& job, const JobResult& result,
+                        const std::string& target)
+{
+    if (cache == nullptr)
+        return;
+    cache->commit(key, target, {result.audioSeconds, result.peak, result.nonFinite});
+    cache->serve(key, job.out);
+}
+
+/** A failed render's temporary file, if it went to the cache */
+inline void discardCached(const RenderCache* cache, const Job& job, const std::string& target)
+{
+    std::error_code ec;
+    if (cache != nullptr && !target.empty() && target != job.out)
+        std::filesystem::remove(target, ec);
+}
+
+/**
+ * @brief Render one job to its WAV file
+ * @param apply apply(engine, values): the plugin's processBlock() parameter updates
+ * @param cache Render cache, or null
+ * @param engine The engine's name and hash, for the cache key (cacheKey())
+ */
+template <typename Engine, typename ApplyFn>
+JobResult renderJob(const Job& job, const Options& options, const std::vector<Param>& params, ApplyFn& apply,
+                    const RenderCache* cache = nullptr, const std::string& engine = {})
+{
+    using Clock = std::chrono::steady_clock;
+    ScopedFlushDenormals noDenormals;
+    JobResult result;
+    const auto t0 = Clock::now();
+    std::string target;
+
+    try
+    {
+        const double rate = options.sampleRate;
+        const MidiPattern pattern = job.midi.empty() ? MidiPattern{} : MidiPattern::load(job.midi, rate);
+        const ParamValues values = job.preset.empty() ? ParamValues(params)
+                                                      : Preset::load(job.preset).resolve(params, result.warnings);
+        const Automation automation = options.automation.empty() ? Automation{}
+                                                                 : Automation::load(options.automation, rate);
+
+        const std::string key = cache != nullptr ? cacheKey(engine, pattern, values, options, automation) : std::string();
+        if (serveCached(cache, key, job, result, target))
+        {
+            result.wallSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            return result;
+        }
+
+        if constexpr (!requires(Engine& e) { e.noteOn(60, 1.0f); })
+            if (!pattern.empty())
+                result.warnings.push_back("engine has no MIDI input; notes ignored");
+
+        const int block = options.blockSize;
+        auto toSample = [rate](double seconds) { return static_cast<int64_t>(std::llround(seconds * rate)); };
+
+        const int64_t bodyEnd = std::max({pattern.lastFrame(), automation.lastFrame(), toSample(options.length)});
+        const int64_t end = bodyEnd + toSample(options.tail);
+        const int64_t silentHold = toSample(SILENT_HOLD_SECONDS);
+
+        if (end <= 0)
+            throw std::runtime_error("nothing to render: no MIDI events and no --length");
+
+        // The preset, then each lane's value at the start in place of its parameter's
+        ParamValues current = values;
+        AutomationPlayer lanes;
+        for (const auto& id : lanes.setAutomation(automation, params))
+            result.warnings.push_back("automation for unknown parameter '" + id + "' skipped");
+        bool moved = false;
+        auto automate = [&](int64_t frame) {
+            lanes.evaluate(frame, [&](int i, float value) {
+                const Param& p = params[static_cast<size_t>(i)];
+                current.set(p.id, p.constrain(value));
+                moved = true;
+            });
+        };
+        automate(0);
+
+        auto engine = std::make_unique<Engine>();
+        engine->prepare(rate, block);
+        if constexpr (requires { engine->setNoiseSeed(1u); })
+            engine->setNoiseSeed(options.seed);
+        apply(*engine, current);
+
+        std::filesystem::path outPath(target);
+        if (outPath.has_parent_path())
+            std::filesystem::create_directories(outPath.parent_path());
+        WavWriter wav(target, rate, options.bits);
+
+        std::vector<float> left(static_cast<size_t>(block));
+        std::vector<float> right(static_cast<size_t>(block));
+        std::array<int, 128> held{};
+        PatternPlayer player(pattern);
+        int64_t pos = 0;
+        int64_t silentFor = 0;
+        bool released = false;
+
+        while (pos < end)
+        {
+            const int n = static_cast<int>(std::min<int64_t>(block, end - pos));
+            std::fill(left.begin(), left.begin() + n, 0.0f);
+            std::fill(right.begin(), right.begin() + n, 0.0f);
+
+            // Split the block at each event so it lands on its sample
+            player.play(n,
+                [&](const PatternEvent& p) {
+                    const MidiEvent e = toMidiEvent(p);
+                    if (e.type == MidiEvent::Type::NoteOn)
+                        ++held[static_cast<size_t>(e.note)];
+                    else if (e.type == MidiEvent::Type::NoteOff)
+                        held[static_cast<size_t>(e.note)] = std::max(0, held[static_cast<size_t>(e.note)] - 1);
+                    else if (e.type == MidiEvent::Type::AllNotesOff)
+                        held.fill(0);
+                    dispatch(*engine, e);
+                },
+                [&](int start, int count) {
+                    if (!lanes.empty())
+                    {
+                        moved = false;
+                        automate(player.getPosition());
+                        if (moved)
+                            apply(*engine, current);
+                    }
+                    engine->renderBlock(left.data() + start, right.data() + start, count);
+                });
+
+            float peak = 0.0f;
+            for (int i = 0; i < n; ++i)
+            {
+                const float l = left[static_cast<size_t>(i)];
+                const float r = right[static_cast<size_t>(i)];
+                if (!std::isfinite(l) || !std::isfinite(r))
+                    ++result.nonFinite;
+                else
+                    peak = std::max(peak, std::max(std::abs(l), std::abs(r)));
+            }
+            result.peak = std::max(result.peak, peak);
+
+            wav.write(left.data(), right.data(), n);
+            pos += n;
+
+            if (!released && pos >= bodyEnd)
+            {
+                // Let go of hanging notes and the sequencer; what follows is
+                // tail. Note offs rather than All Notes Off, which some
+                // engines take as a hard stop
+                for (int note = 0; note < 128; ++note)
+                    if (held[static_cast<size_t>(note)] > 0)
+                        dispatch(*engine, MidiEvent{0.0, MidiEvent::Type::NoteOff, note, 0.0f});
+                if constexpr (requires { engine->setRunning(false); })
+                    engine->setRunning(false);
+                released = true;
+                continue;
+            }
+
+            if (released)
+            {
+                if constexpr (requires { engine->isSilent(); })
+                {
+                    if (engine->isSilent())
+                        break;
+                }
+                else
+                {
+                    silentFor = peak < SILENCE_THRESHOLD ? silentFor + n : 0;
+                    if (silentFor >= silentHold)
+                        break;
+                }
+            }
+        }
+
+        wav.close();
+        result.audioSeconds = static_cast<double>(wav.getFramesWritten()) / rate;
+        storeCached(cache, key, job, result, target);
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+        discardCached(cache, job, target);
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return result;
+}
+
+/** --to-pattern: the one --midi file as a pattern at --rate */
+inline int writePattern(const Options& options, const std::string& name)
+{
+    if (options.midiFiles.size() != 1)
+    {
+        std::fprintf(stderr, "%s: --to-pattern takes exactly one --midi\n", name.c_str());
+        return 2;
+    }
+
+    try
+    {
+        const MidiPattern pattern = MidiPattern::load(options.midiFiles[0], options.sampleRate);
+        const std::vector<uint8_t> data = pattern.toBinary();
+        std::ofstream out(options.toPattern, std::ios::binary);
+        if (!out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+            throw std::runtime_error("can't write " + options.toPattern);
+        std::printf("%s: %s  %zu events, %.2f s at %.0f Hz\n", name.c_str(), options.toPattern.c_str(), pattern.size(),
+                    static_cast<double>(pattern.lastFrame()) / options.sampleRate, options.sampleRate);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s: %s\n", name.c_str(), e.what());
+        return 1;
+    }
+}
+
+/**
+ * @brief Render entry point for one engine
+ * @param name Plugin name, for messages and default file names
+ * @param params The plugin's parameters, as createParameterLayout() declares them
+ * @param apply apply(engine, values): the parameter updates from processBlock()
+ * @return Process exit code: 0 if every job rendered
+ */
+template <typename Engine, typename ApplyFn>
+int runMain(int argc, char** argv, const std::string& name, const std::vector<Param>& params, ApplyFn apply)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    if (options.fuzz > 0 || options.fuzzTrial >= 0)
+    {
+        ScopedFlushDenormals noDenormals;
+        const double seconds = options.length > 0.0 ? options.length : 2.0;
+        const int first = options.fuzzTrial >= 0 ? options.fuzzTrial : 0;
+        const int count = options.fuzzTrial >= 0 ? 1 : options.fuzz;
+        return runFuzz<Engine>(first, count, options.seed, options.spike, seconds, options.sampleRate,
+                               options.blockSize, options.outDir, name, params, apply);
+    }
+
+    if (!options.toPattern.empty())
+        return writePattern(options, name);
+
+    std::vector<Job> jobs;
+    std::unique_ptr<RenderCache> cache;
+    std::string engine;
+    try
+    {
+        jobs = makeJobs(options, name);
+        if (!options.cacheDir.empty())
+        {
+            cache = std::make_unique<RenderCache>(options.cacheDir);
+            engine = name + "@" + CacheKey::ofSelf(argv[0]);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "%s: %s\n", name.c_str(), e.what());
+        return 2;
+    }
+
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int numThreads = std::clamp(options.threads > 0 ? options.threads : cores, 1, static_cast<int>(jobs.size()));
+
+    std::atomic<size_t> nextJob{0};
+    std::atomic<int> failures{0};
+    std::mutex printLock;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    auto worker = [&] {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++)
+        {
+            const JobResult r = renderJob<Engine>(jobs[j], options, params, apply, cache.get(), engine);
+            std::lock_guard<std::mutex> lock(printLock);
+
+            for (const auto& w : r.warnings)
+                std::fprintf(stderr, "%s: %s: warning: %s\n", name.c_str(), jobs[j].out.c_str(), w.c_str());
+
+            if (!r.error.empty())
+            {
+                std::fprintf(stderr, "%s: %s: %s\n", name.c_str(), jobs[j].out.c_str(), r.error.c_str());
+                ++failures;
+                continue;
+            }
+
+            const double peakDb = r.peak > 0.0f ? 20.0 * std::log10(static_cast<double>(r.peak)) : -INFINITY;
+            if (r.cached)
+                std::printf("%s: %s  %.2f s from the cache, peak %.1f dBFS\n", name.c_str(), jobs[j].out.c_str(),
+                            r.audioSeconds, peakDb);
+            else
+                std::printf("%s: %s  %.2f s in %.2f s (%.0fx real time), peak %.1f dBFS\n", name.c_str(),
+                            jobs[j].out.c_str(), r.audioSeconds, r.wallSeconds,
+                            r.wallSeconds > 0.0 ? r.audioSeconds / r.wallSeconds : 0.0, peakDb);
+            if (r.nonFinite > 0)
+                std::printf("%s: %s  warning: %ld non-finite samples\n", name.c_str(), jobs[j].out.c_str(), r.nonFinite);
+            if (r.peak > 1.0f && options.bits < 32)
+                std::printf("%s: %s  warning: clipped (use --bits 32 to keep the overs)\n", name.c_str(),
+                            jobs[j].out.c_str());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%s: %zu job(s) on %d thread(s) in %.2f s, %d failed\n", name.c_str(), jobs.size(), numThreads, wall,
+                failures.load());
+    return failures > 0 ? 1 : 0;
+}
+
+} // namespace render
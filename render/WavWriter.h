@@ -0,0 +1,184 @@
+/**
+ * @file WavWriter.h
+ * @brief Streaming stereo WAV writer
+ *
+ * Each block is converted and written as it is rendered, so memory use
+ * doesn't grow with the render length. The RIFF and data sizes are written
+ * as zero up front and patched in close(). 16- and 24-bit output is plain
+ * PCM (rounded and clipped, no dither); 32-bit is IEEE float, which needs
+ * the extended fmt chunk and a fact chunk.
+ *
+ * The path "-" streams to stdout, e.g. into an encoder or an HTTP response.
+ * A pipe can't be patched, so the sizes stay 0xffffffff ("until the end of
+ * the stream"), which sox, ffmpeg and browsers accept.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace render
+{
+
+class WavWriter
+{
+public:
+    /** Open path for writing; throws std::runtime_error if it can't */
+    WavWriter(const std::string& path, double sampleRate, int bitsPerSample)
+        : bits(bitsPerSample), path(path)
+    {
+        if (bits != 16 && bits != 24 && bits != 32)
+            throw std::runtime_error("unsupported bit depth " + std::to_string(bits) + " (16, 24 or 32)");
+
+        streaming = path == "-";
+        file = streaming ? stdout : std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            throw std::runtime_error("can't write " + path);
+
+        writeHeader(static_cast<uint32_t>(std::lround(sampleRate)));
+    }
+
+    ~WavWriter() { close(); }
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /** Append numFrames stereo frames */
+    void write(const float* left, const float* right, int numFrames)
+    {
+        const int bytes = bits / 8;
+        scratch.resize(static_cast<size_t>(numFrames) * 2 * static_cast<size_t>(bytes));
+        uint8_t* out = scratch.data();
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            out = put(out, left[i]);
+            out = put(out, right[i]);
+        }
+
+        if (std::fwrite(scratch.data(), 1, scratch.size(), file) != scratch.size())
+            throw std::runtime_error("write failed: " + path);
+        frames += static_cast<uint64_t>(numFrames);
+    }
+
+    uint64_t getFramesWritten() const { return frames; }
+
+    /** Patch the chunk sizes and close the file (the destructor calls this too) */
+    void close()
+    {
+        if (file == nullptr)
+            return;
+
+        if (streaming)
+        {
+            std::fflush(file);
+            file = nullptr;
+            return;
+        }
+
+        const uint64_t dataBytes = frames * 2 * static_cast<uint64_t>(bits / 8);
+        const uint32_t data32 = static_cast<uint32_t>(std::min<uint64_t>(dataBytes, 0xffffffffu - dataOffset));
+
+        patch(4, static_cast<uint32_t>(dataOffset - 8 + data32));
+        patch(dataOffset - 4, data32);
+        if (factOffset > 0)
+            patch(factOffset, static_cast<uint32_t>(std::min<uint64_t>(frames, 0xffffffffu)));
+
+        std::fclose(file);
+        file = nullptr;
+    }
+
+private:
+    uint8_t* put(uint8_t* out, float sample) const
+    {
+        if (bits == 32)
+        {
+            uint32_t raw;
+            std::memcpy(&raw, &sample, 4);
+            return putLE(out, raw, 4);
+        }
+
+        const double scale = bits == 16 ? 32767.0 : 8388607.0;
+        const double clipped = std::clamp(static_cast<double>(sample), -1.0, 1.0);
+        const auto value = static_cast<int32_t>(std::lrint(clipped * scale));
+        return putLE(out, static_cast<uint32_t>(value), bits / 8);
+    }
+
+    static uint8_t* putLE(uint8_t* out, uint32_t value, int bytes)
+    {
+        for (int b = 0; b < bytes; ++b)
+            *out++ = static_cast<uint8_t>(value >> (8 * b));
+        return out;
+    }
+
+    void writeHeader(uint32_t rate)
+    {
+        const bool isFloat = bits == 32;
+        const uint16_t channels = 2;
+        const uint16_t blockAlign = static_cast<uint16_t>(channels * bits / 8);
+
+        uint8_t h[64];
+        size_t size = 0;
+        auto tag = [&](const char* t) { std::memcpy(h + size, t, 4); size += 4; };
+        auto u16 = [&](uint32_t v) { putLE(h + size, v, 2); size += 2; };
+        auto u32 = [&](uint32_t v) { putLE(h + size, v, 4); size += 4; };
+
+        const uint32_t unknown = streaming ? 0xffffffffu : 0;
+
+        tag("RIFF");
+        u32(unknown);  // Patched in close()
+        tag("WAVE");
+
+        tag("fmt ");
+        u32(isFloat ? 18 : 16);
+        u16(isFloat ? 3 : 1);  // WAVE_FORMAT_IEEE_FLOAT / WAVE_FORMAT_PCM
+        u16(channels);
+        u32(rate);
+        u32(rate * blockAlign);
+        u16(blockAlign);
+        u16(static_cast<uint32_t>(bits));
+        if (isFloat)
+            u16(0);  // cbSize
+
+        if (isFloat)
+        {
+            tag("fact");
+            u32(4);
+            factOffset = static_cast<long>(size);
+            u32(unknown);  // Frame count, patched in close()
+        }
+
+        tag("data");
+        u32(unknown);
+        dataOffset = static_cast<long>(size);
+
+        if (std::fwrite(h, 1, size, file) != size)
+            throw std::runtime_error("write failed: " + path);
+    }
+
+    void patch(long offset, uint32_t value)
+    {
+        uint8_t bytes[4];
+        putLE(bytes, value, 4);
+        std::fseek(file, offset, SEEK_SET);
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    int bits;
+    std::string path;
+    std::FILE* file = nullptr;
+    bool streaming = false;  // stdout: no patching
+    long dataOffset = 0;
+    long factOffset = 0;
+    uint64_t frames = 0;
+    std::vector<uint8_t> scratch;
+};
+
+} // namespace render
@@ -0,0 +1,705 @@
+/**
+ * @file batch.cpp
+ * @brief autosynth-batch: render jobs for any mix of engines through their C ABI
+ *
+ * autosynth-render-<Plugin> links one engine in; this host instead loads
+ * the engine libraries (libautosynth-engine-<Plugin>, built from the same
+ * adapters and wasm_bindings.cpp as the browser modules) and runs jobs for
+ * any of them side by side on a thread pool, for preview services that
+ * render many engines at once. Each job gets its own engine instance from
+ * createEngine(), and every block is written out as it is rendered.
+ *
+ * Presets, MIDI and WAV output work as in RenderHarness.h; each job's MIDI
+ * goes into its engine once, as a pattern (loadPattern(), MidiPattern.h),
+ * and plays from there, as in the browser. Parameters are
+ * read from the library's table, so a preset is resolved without the
+ * adapter's source. --automation goes into every engine the same way
+ * (loadAutomation(), Automation.h), each playing the lanes it has
+ * parameters for. Through the ABI the host can't stop a sequencer, so
+ * the tail ends after --tail seconds or a second of silence.
+ *
+ * A job can also be a rack: several engines rendered together in one job,
+ * each its own library in this one process (the engines share class
+ * names, so they can't share a binary). '+' layers engines, their outputs
+ * summed; '>' chains them, each one's output into the next one's audio
+ * input (TapeLoop's tape). DFAM>TapeLoop+ModelD plays DFAM through
+ * TapeLoop, with ModelD alongside. Every engine in the rack plays the
+ * job's MIDI, and PRESET lists one preset per engine, comma separated.
+ *
+ * Where the build has them (x86), each engine also comes as an AVX2 + FMA
+ * library, libautosynth-engine-<Plugin>-avx2. At startup the host asks
+ * the CPU what it runs and loads that build if it can, the baseline
+ * otherwise; --isa baseline or avx2 overrides the choice. The two builds
+ * round differently (FMA), so a render's cache key follows the library.
+ *
+ * With --cache DIR, jobs are served from a content-addressed render cache
+ * when nothing they depend on has changed (RenderCache.h); an engine's key
+ * includes its library's hash and this host's.
+ *
+ * With --metrics FILE, the host keeps FILE in the OpenMetrics text format
+ * for Prometheus to scrape: real-time factor and block times by engine,
+ * cache hits, jobs queued and memory, plus the engines' own PerfStats
+ * counters where the libraries have them compiled in (Metrics.h).
+ *
+ * Usage:
+ *   autosynth-batch --jobs batch.txt [--lib-dir DIR] [--rate HZ] [--block N]
+ *                   [--bits 16|24|32] [--length S] [--tail S] [--threads N]
+ *                   [--cache DIR] [--isa auto|avx2|baseline] [--metrics FILE]
+ *                   [--automation FILE]
+ *
+ *   Jobs file, one per line: ENGINE MIDI PRESET OUT
+ *     ENGINE  plugin name (ModelD, DFAM, ...), or a rack (DFAM>TapeLoop+ModelD)
+ *     MIDI, PRESET  file, or '-' for none / parameter defaults; a rack's
+ *             PRESET is a comma-separated list, one per engine ('-' each)
+ *     OUT     WAV file, or '-' for stdout (at most one job)
+ */
+
+#include "EngineHost.h"
+#include "Metrics.h"
+
+#include <dlfcn.h>
+
+#include <map>
+
+#ifndef AUTOSYNTH_ENGINE_LIB_DIR
+#define AUTOSYNTH_ENGINE_LIB_DIR "."
+#endif
+#ifndef AUTOSYNTH_ENGINE_LIB_PREFIX
+#define AUTOSYNTH_ENGINE_LIB_PREFIX "lib"
+#endif
+#ifndef AUTOSYNTH_ENGINE_LIB_SUFFIX
+#define AUTOSYNTH_ENGINE_LIB_SUFFIX ".so"
+#endif
+
+namespace
+{
+using render::abi::EngineHost;
+using render::abi::Event;
+using render::abi::ParamInfo;
+
+/** One engine of a job's rack */
+struct RackSlot
+{
+    std::string engine;
+    std::string preset;      // Empty: parameter defaults
+    bool feedsNext = false;  // Its output goes into the next slot's input, not the mix
+};
+
+struct BatchJob
+{
+    std::string engine;  // As written: one plugin name, or a rack
+    std::vector<RackSlot> rack;
+    render::Job job;
+};
+
+/** Split text at sep */
+std::vector<std::string> split(const std::string& text, char sep)
+{
+    std::vector<std::string> parts;
+    std::istringstream in(text);
+    for (std::string part; std::getline(in, part, sep);)
+        parts.push_back(part);
+    return parts;
+}
+
+/** The ENGINE and PRESET fields as slots, in render order; throws std::runtime_error */
+std::vector<RackSlot> parseRack(const std::string& engines, const std::string& presets)
+{
+    std::vector<RackSlot> rack;
+    for (const std::string& layer : split(engines, '+'))
+    {
+        const std::vector<std::string> chain = split(layer, '>');
+        for (size_t i = 0; i < chain.size(); ++i)
+            rack.push_back({chain[i], {}, i + 1 < chain.size()});
+    }
+    for (const RackSlot& slot : rack)
+        if (slot.engine.empty())
+            throw std::runtime_error("empty engine name in " + engines);
+
+    if (presets != "-")
+    {
+        const std::vector<std::string> each = split(presets, ',');
+        if (each.size() != rack.size())
+            throw std::runtime_error("expected " + std::to_string(rack.size()) + " preset(s) for " + engines);
+        for (size_t i = 0; i < rack.size(); ++i)
+            rack[i].preset = each[i] == "-" ? std::string() : each[i];
+    }
+    return rack;
+}
+
+/** One loaded engine library and its exports */
+/** The instruction sets engine libraries are built for, beside the baseline */
+enum class Isa
+{
+    Auto,  // The best the CPU runs
+    Baseline,
+    Avx2
+};
+
+/** True if this CPU runs the AVX2 + FMA builds */
+bool cpuHasAvx2()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+/** The path of plugin's library in dir, for isa; throws std::runtime_error if a forced build is missing */
+std::string engineLibraryPath(const std::string& dir, const std::string& plugin, Isa isa)
+{
+    const auto file = [&](const std::string& suffix) {
+        return (std::filesystem::path(dir)
+                / (AUTOSYNTH_ENGINE_LIB_PREFIX "autosynth-engine-" + plugin + suffix + AUTOSYNTH_ENGINE_LIB_SUFFIX))
+            .string();
+    };
+    if (isa == Isa::Baseline || (isa == Isa::Auto && !cpuHasAvx2()))
+        return file("");
+
+    std::error_code ec;
+    const std::string avx2 = file("-avx2");
+    if (std::filesystem::exists(avx2, ec))
+        return avx2;
+    if (isa == Isa::Avx2)
+        throw std::runtime_error("no AVX2 build: " + avx2);
+    return file("");
+}
+
+class EngineLibrary
+{
+public:
+    /** Load plugin's library from dir, built for isa where there is one; throws std::runtime_error */
+    EngineLibrary(const std::string& dir, const std::string& plugin, Isa isa)
+        : path(engineLibraryPath(dir, plugin, isa))
+    {
+        handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr)
+            throw std::runtime_error("can't load " + path + ": " + dlerror());
+
+        bind(createEngine, "createEngine");
+        bind(destroyEngine, "destroyEngine");
+        bind(init, "init");
+        bind(process, "process");
+        bind(processInput, "processInput");
+        bind(queueEvents, "queueEvents");
+        bind(loadPattern, "loadPattern");
+        bind(getParamBlockPtr, "getParamBlockPtr");
+        bind(getParamTablePtr, "getParamTablePtr");
+        bind(getParamCount, "getParamCount");
+        getPerfStats = reinterpret_cast<decltype(getPerfStats)>(dlsym(handle, "getPerfStats"));  // Not in older builds
+        loadAutomation = reinterpret_cast<decltype(loadAutomation)>(dlsym(handle, "loadAutomation"));
+
+        // The table as render::Params, for resolving presets
+        const ParamInfo* table = getParamTablePtr();
+        for (int i = 0; i < getParamCount(); ++i)
+            params.push_back({table[i].name, table[i].minValue, table[i].maxValue, table[i].defaultValue,
+                              table[i].interval, table[i].skew});
+    }
+
+    ~EngineLibrary()
+    {
+        if (handle != nullptr)
+            dlclose(handle);
+    }
+
+    EngineLibrary(const EngineLibrary&) = delete;
+    EngineLibrary& operator=(const EngineLibrary&) = delete;
+
+    EngineHost* (*createEngine)() = nullptr;
+    void (*destroyEngine)(EngineHost*) = nullptr;
+    int (*init)(EngineHost*, int, int) = nullptr;
+    void (*process)(EngineHost*, float*, float*, int) = nullptr;
+    void (*processInput)(EngineHost*, const float*, const float*, float*, float*, int) = nullptr;
+    int (*queueEvents)(EngineHost*, const Event*, int) = nullptr;
+    int (*loadPattern)(EngineHost*, const uint8_t*, int) = nullptr;
+    float* (*getParamBlockPtr)(EngineHost*) = nullptr;
+    const ParamInfo* (*getParamTablePtr)() = nullptr;
+    int (*getParamCount)() = nullptr;
+    int (*getPerfStats)(EngineHost*, double*, int) = nullptr;  // Null if the library predates it
+    int (*loadAutomation)(EngineHost*, const uint8_t*, int) = nullptr;  // Likewise
+
+    const std::string path;
+    std::vector<render::Param> params;
+
+private:
+    template <typename Fn>
+    void bind(Fn& fn, const char* symbol)
+    {
+        fn = reinterpret_cast<Fn>(dlsym(handle, symbol));
+        if (fn == nullptr)
+            throw std::runtime_error(std::string("engine library has no ") + symbol);
+    }
+
+    void* handle = nullptr;
+};
+
+using Libraries = std::map<std::string, std::unique_ptr<EngineLibrary>>;
+
+/** A rack slot's engine instance, from its library */
+struct SlotEngine
+{
+    const EngineLibrary* lib;
+    std::unique_ptr<EngineHost, void (*)(EngineHost*)> host;
+};
+
+/** One block of a rack: chains render in place, slot to slot; the ends of chains sum into the mix */
+void renderRack(const std::vector<RackSlot>& rack, std::vector<SlotEngine>& engines, float* slotL, float* slotR,
+                float* mixL, float* mixR, int n)
+{
+    bool mixed = false;
+    for (size_t s = 0; s < rack.size(); ++s)
+    {
+        SlotEngine& slot = engines[s];
+        if (s > 0 && rack[s - 1].feedsNext)
+            slot.lib->processInput(slot.host.get(), slotL, slotR, slotL, slotR, n);  // The last slot's output
+        else
+            slot.lib->process(slot.host.get(), slotL, slotR, n);
+
+        if (rack[s].feedsNext)
+            continue;
+        for (int i = 0; i < n; ++i)
+        {
+            mixL[i] = mixed ? mixL[i] + slotL[i] : slotL[i];
+            mixR[i] = mixed ? mixR[i] + slotR[i] : slotR[i];
+        }
+        mixed = true;
+    }
+}
+
+/** An engine's PerfStats through the ABI; all 0 (not enabled) if its library can't say */
+PerfStats::Snapshot perfStatsOf(const SlotEngine& slot)
+{
+    PerfStats::Snapshot snap;
+    snap.enabled = false;
+    std::array<double, PerfStats::Snapshot::FLAT_SIZE> flat{};
+    const int size = static_cast<int>(flat.size());
+    if (slot.lib->getPerfStats == nullptr || slot.lib->getPerfStats(slot.host.get(), flat.data(), size) != size
+        || flat[0] == 0.0)
+        return snap;
+
+    // toFlat() order, after "enabled"
+    size_t i = 1;
+    snap.enabled = true;
+    snap.blocks = static_cast<uint64_t>(flat[i++]);
+    snap.blocksOverBudget = static_cast<uint64_t>(flat[i++]);
+    snap.lastBlockUs = flat[i++];
+    snap.worstBlockUs = flat[i++];
+    snap.averageLoad = flat[i++];
+    snap.blockCycles = static_cast<uint64_t>(flat[i++]);
+    for (uint64_t& c : snap.stageCycles)
+        c = static_cast<uint64_t>(flat[i++]);
+    for (uint64_t& n : snap.voiceHistogram)
+        n = static_cast<uint64_t>(flat[i++]);
+    return snap;
+}
+
+/**
+ * @param cache Render cache, or null
+ * @param engineKeys Each engine's name and hashes, for the cache key (render::cacheKey())
+ * @param measured Filled with the job's block times and its engines' PerfStats
+ */
+render::JobResult renderJob(const BatchJob& b, const Libraries& libraries, const render::Options& options,
+                            const render::RenderCache* cache, const std::map<std::string, std::string>& engineKeys,
+                            render::JobMetrics& measured)
+{
+    const render::Job& job = b.job;
+    using Clock = std::chrono::steady_clock;
+    render::ScopedFlushDenormals noDenormals;
+    render::JobResult result;
+    const auto t0 = Clock::now();
+    std::string target;
+
+    try
+    {
+        const double rate = options.sampleRate;
+        const render::MidiPattern pattern = job.midi.empty() ? render::MidiPattern{}
+                                                             : render::MidiPattern::load(job.midi, rate);
+        const render::Automation automation = options.automation.empty()
+                                                  ? render::Automation{}
+                                                  : render::Automation::load(options.automation, rate);
+
+        std::vector<render::ParamValues> values;
+        for (const RackSlot& slot : b.rack)
+        {
+            const EngineLibrary& lib = *libraries.at(slot.engine);
+            values.push_back(slot.preset.empty() ? render::ParamValues(lib.params)
+                                                 : render::Preset::load(slot.preset).resolve(lib.params,
+                                                                                             result.warnings));
+        }
+
+        std::string key;
+        if (cache != nullptr && b.rack.size() == 1)
+            key = render::cacheKey(engineKeys.at(b.rack[0].engine), pattern, values[0], options, automation);
+        else if (cache != nullptr)
+        {
+            // A rack: every engine's key in order, with how it's wired, and
+            // every slot's values under its own prefix
+            std::string rackKey;
+            render::ParamValues all(std::vector<render::Param>{});
+            for (size_t s = 0; s < b.rack.size(); ++s)
+            {
+                rackKey += engineKeys.at(b.rack[s].engine) + (b.rack[s].feedsNext ? ">" : "+");
+                for (const auto& [id, value] : values[s].all())
+                    all.set(std::to_string(s) + "/" + id, value);
+            }
+            key = render::cacheKey(rackKey, pattern, all, options, automation);
+        }
+        if (render::serveCached(cache, key, job, result, target))
+        {
+            result.wallSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+            return result;
+        }
+
+        const int block = options.blockSize;
+        auto toSample = [rate](double seconds) { return static_cast<int64_t>(std::llround(seconds * rate)); };
+
+        const int64_t bodyEnd = std::max({pattern.lastFrame(), automation.lastFrame(), toSample(options.length)});
+        const int64_t end = bodyEnd + toSample(options.tail);
+        const int64_t silentHold = toSample(render::SILENT_HOLD_SECONDS);
+        if (end <= 0)
+            throw std::runtime_error("nothing to render: no MIDI events and no --length");
+
+        const std::vector<uint8_t> binary = pattern.toBinary();
+        const std::vector<uint8_t> lanes = automation.empty() ? std::vector<uint8_t>{} : automation.toBinary();
+        std::vector<SlotEngine> engines;
+        for (size_t s = 0; s < b.rack.size(); ++s)
+        {
+            const EngineLibrary& lib = *libraries.at(b.rack[s].engine);
+            SlotEngine& slot = engines.emplace_back(SlotEngine{&lib, {lib.createEngine(), lib.destroyEngine}});
+            if (!slot.host || !lib.init(slot.host.get(), static_cast<int>(std::lround(rate)), block))
+                throw std::runtime_error(b.rack[s].engine + ": engine init failed");
+
+            float* paramBlock = lib.getParamBlockPtr(slot.host.get());
+            for (size_t i = 0; i < lib.params.size(); ++i)
+                paramBlock[i] = values[s][lib.params[i].id];
+
+            // The whole MIDI file in one call; the engine plays it on its frames
+            if (!pattern.empty() && !lib.loadPattern(slot.host.get(), binary.data(), static_cast<int>(binary.size())))
+                throw std::runtime_error(b.rack[s].engine + ": engine refused the MIDI pattern");
+            if (!lanes.empty()
+                && (lib.loadAutomation == nullptr
+                    || !lib.loadAutomation(slot.host.get(), lanes.data(), static_cast<int>(lanes.size()))))
+                throw std::runtime_error(b.rack[s].engine + ": engine library can't play automation");
+        }
+
+        // Notes the pattern leaves held once it has all played
+        std::array<int, 128> held{};
+        for (size_t i = 0; i < pattern.size(); ++i)
+        {
+            const render::PatternEvent& e = pattern.data()[i];
+            if (e.type == static_cast<uint8_t>(render::MidiEvent::Type::NoteOn))
+                ++held[e.note];
+            else if (e.type == static_cast<uint8_t>(render::MidiEvent::Type::NoteOff))
+                held[e.note] = std::max(0, held[e.note] - 1);
+            else if (e.type == static_cast<uint8_t>(render::MidiEvent::Type::AllNotesOff))
+                held.fill(0);
+        }
+
+        std::filesystem::path outPath(target);
+        if (outPath.has_parent_path())
+            std::filesystem::create_directories(outPath.parent_path());
+        render::WavWriter wav(target, rate, options.bits);
+
+        std::vector<float> left(static_cast<size_t>(block));
+        std::vector<float> right(static_cast<size_t>(block));
+        std::vector<float> slotL(b.rack.size() > 1 ? static_cast<size_t>(block) : 0);
+        std::vector<float> slotR(slotL.size());
+        std::vector<Event> pending;
+        int64_t pos = 0;
+        int64_t silentFor = 0;
+        bool released = false;
+
+        while (pos < end)
+        {
+            const int n = static_cast<int>(std::min<int64_t>(block, end - pos));
+            const auto blockStart = Clock::now();
+            if (engines.size() == 1)
+                engines[0].lib->process(engines[0].host.get(), left.data(), right.data(), n);
+            else
+                renderRack(b.rack, engines, slotL.data(), slotR.data(), left.data(), right.data(), n);
+            measured.blocks.add(std::chrono::duration<double>(Clock::now() - blockStart).count(), n / rate);
+
+            float peak = 0.0f;
+            for (int i = 0; i < n; ++i)
+            {
+                const float l = left[static_cast<size_t>(i)];
+                const float r = right[static_cast<size_t>(i)];
+                if (!std::isfinite(l) || !std::isfinite(r))
+                    ++result.nonFinite;
+                else
+                    peak = std::max(peak, std::max(std::abs(l), std::abs(r)));
+            }
+            result.peak = std::max(result.peak, peak);
+
+            wav.write(left.data(), right.data(), n);
+            pos += n;
+
+            if (!released && pos >= bodyEnd)
+            {
+                // Let go of hanging notes; what follows is tail
+                pending.clear();
+                for (int note = 0; note < 128; ++note)
+                    if (held[static_cast<size_t>(note)] > 0)
+                        pending.push_back({render::abi::kEventNoteOff, note, 0, 0.0f, 0});
+                for (SlotEngine& slot : engines)
+                    slot.lib->queueEvents(slot.host.get(), pending.data(), static_cast<int>(pending.size()));
+                released = true;
+                continue;
+            }
+
+            if (released)
+            {
+                silentFor = peak < render::SILENCE_THRESHOLD ? silentFor + n : 0;
+                if (silentFor >= silentHold)
+                    break;
+            }
+        }
+
+        for (size_t s = 0; s < engines.size(); ++s)
+            measured.engines.emplace_back(b.rack[s].engine, perfStatsOf(engines[s]));
+
+        wav.close();
+        result.audioSeconds = static_cast<double>(wav.getFramesWritten()) / rate;
+        render::storeCached(cache, key, job, result, target);
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+        render::discardCached(cache, job, target);
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return result;
+}
+
+void usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s --jobs FILE [--lib-dir DIR] [--rate HZ] [--block N] [--bits 16|24|32]\n"
+                 "       %*s [--length S] [--tail S] [--threads N] [--cache DIR] [--isa auto|avx2|baseline]\n"
+                 "       %*s [--metrics FILE] [--automation FILE]\n",
+                 program, static_cast<int>(std::strlen(program)), "", static_cast<int>(std::strlen(program)), "");
+}
+
+/** Parse the command line; returns false (after printing why) on a bad one */
+bool parseOptions(int argc, char** argv, render::Options& options, std::string& libDir, Isa& isa,
+                  std::string& metricsFile)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+        {
+            usage(argv[0]);
+            return false;
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--jobs")
+            options.jobsFile = value;
+        else if (arg == "--lib-dir")
+            libDir = value;
+        else if (arg == "--rate")
+            options.sampleRate = std::clamp(std::atof(value), 8000.0, 384000.0);
+        else if (arg == "--block")
+            options.blockSize = std::clamp(std::atoi(value), 1, 8192);
+        else if (arg == "--bits")
+            options.bits = std::atoi(value);
+        else if (arg == "--length")
+            options.length = std::max(0.0, std::atof(value));
+        else if (arg == "--tail")
+            options.tail = std::max(0.0, std::atof(value));
+        else if (arg == "--threads")
+            options.threads = std::max(0, std::atoi(value));
+        else if (arg == "--cache")
+            options.cacheDir = value;
+        else if (arg == "--isa" && (std::strcmp(value, "auto") == 0 || std::strcmp(value, "avx2") == 0
+                                    || std::strcmp(value, "baseline") == 0))
+            isa = value[0] == 'a' ? (value[1] == 'u' ? Isa::Auto : Isa::Avx2) : Isa::Baseline;
+        else if (arg == "--metrics")
+            metricsFile = value;
+        else if (arg == "--automation")
+            options.automation = value;
+        else
+        {
+            std::fprintf(stderr, "%s: unknown option %s\n", argv[0], arg.c_str());
+            usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (options.jobsFile.empty())
+    {
+        usage(argv[0]);
+        return false;
+    }
+    if (options.bits != 16 && options.bits != 24 && options.bits != 32)
+    {
+        std::fprintf(stderr, "%s: --bits must be 16, 24 or 32\n", argv[0]);
+        return false;
+    }
+    if (isa == Isa::Avx2 && !cpuHasAvx2())
+    {
+        std::fprintf(stderr, "%s: --isa avx2: this CPU has no AVX2 and FMA\n", argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/** The jobs file; throws std::runtime_error on an unreadable one */
+std::vector<BatchJob> loadJobs(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("can't open jobs file " + path);
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    int toStdout = 0;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        BatchJob b;
+        const std::string where = path + ":" + std::to_string(lineNumber) + ": ";
+        if (!(fields >> b.engine >> b.job.midi >> b.job.preset >> b.job.out))
+            throw std::runtime_error(where + "expected ENGINE MIDI PRESET OUT");
+        try
+        {
+            b.rack = parseRack(b.engine, b.job.preset);
+        }
+        catch (const std::runtime_error& e)
+        {
+            throw std::runtime_error(where + e.what());
+        }
+        if (b.job.midi == "-")
+            b.job.midi.clear();
+        if (b.job.preset == "-")
+            b.job.preset.clear();
+        if (b.job.out == "-" && ++toStdout > 1)
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": only one job can write to stdout");
+        jobs.push_back(b);
+    }
+    return jobs;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    render::Options options;
+    std::string libDir = AUTOSYNTH_ENGINE_LIB_DIR;
+    Isa isa = Isa::Auto;
+    std::string metricsFile;
+    if (!parseOptions(argc, argv, options, libDir, isa, metricsFile))
+        return 2;
+
+    // Load each engine once; every job for it shares the library
+    std::vector<BatchJob> jobs;
+    Libraries libraries;
+    std::unique_ptr<render::RenderCache> cache;
+    std::map<std::string, std::string> engineKeys;  // Engine -> name and hashes, for the cache
+    try
+    {
+        jobs = loadJobs(options.jobsFile);
+        for (const auto& b : jobs)
+            for (const RackSlot& slot : b.rack)
+                if (libraries.find(slot.engine) == libraries.end())
+                    libraries[slot.engine] = std::make_unique<EngineLibrary>(libDir, slot.engine, isa);
+
+        if (!options.cacheDir.empty())
+        {
+            cache = std::make_unique<render::RenderCache>(options.cacheDir);
+            const std::string host = render::CacheKey::ofSelf(argv[0]);
+            for (const auto& [engine, lib] : libraries)
+                engineKeys[engine] = engine + "@" + render::CacheKey::ofFile(lib->path) + "@" + host;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "autosynth-batch: %s\n", e.what());
+        return 2;
+    }
+    if (jobs.empty())
+        return 0;
+
+    // Progress goes to stderr: stdout may be carrying a WAV
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int numThreads = std::clamp(options.threads > 0 ? options.threads : cores, 1, static_cast<int>(jobs.size()));
+
+    std::atomic<size_t> nextJob{0};
+    std::atomic<int> failures{0};
+    std::mutex printLock;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // A metrics file that can't be written is reported, not fatal
+    std::unique_ptr<render::MetricsFile> metrics;
+    if (!metricsFile.empty())
+    {
+        metrics = std::make_unique<render::MetricsFile>(metricsFile, jobs.size());
+        metrics->setCaching(cache != nullptr);
+    }
+    auto record = [&](auto&& update) {
+        if (!metrics)
+            return;
+        try
+        {
+            update(*metrics);
+        }
+        catch (const std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(printLock);
+            std::fprintf(stderr, "autosynth-batch: metrics: %s\n", e.what());
+        }
+    };
+
+    auto worker = [&] {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++)
+        {
+            const BatchJob& b = jobs[j];
+            render::JobMetrics measured;
+            record([](render::MetricsFile& m) { m.jobStarted(); });
+            const render::JobResult r = renderJob(b, libraries, options, cache.get(), engineKeys, measured);
+            record([&](render::MetricsFile& m) { m.jobFinished(b.engine, r, measured); });
+            std::lock_guard<std::mutex> lock(printLock);
+
+            for (const auto& w : r.warnings)
+                std::fprintf(stderr, "%s: %s: warning: %s\n", b.engine.c_str(), b.job.out.c_str(), w.c_str());
+
+            if (!r.error.empty())
+            {
+                std::fprintf(stderr, "%s: %s: %s\n", b.engine.c_str(), b.job.out.c_str(), r.error.c_str());
+                ++failures;
+                continue;
+            }
+
+            const double peakDb = r.peak > 0.0f ? 20.0 * std::log10(static_cast<double>(r.peak)) : -INFINITY;
+            if (r.cached)
+                std::fprintf(stderr, "%s: %s  %.2f s from the cache, peak %.1f dBFS\n", b.engine.c_str(),
+                             b.job.out.c_str(), r.audioSeconds, peakDb);
+            else
+                std::fprintf(stderr, "%s: %s  %.2f s in %.2f s (%.0fx real time), peak %.1f dBFS\n", b.engine.c_str(),
+                             b.job.out.c_str(), r.audioSeconds, r.wallSeconds,
+                             r.wallSeconds > 0.0 ? r.audioSeconds / r.wallSeconds : 0.0, peakDb);
+            if (r.nonFinite > 0)
+                std::fprintf(stderr, "%s: %s  warning: %ld non-finite samples\n", b.engine.c_str(), b.job.out.c_str(),
+                             r.nonFinite);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const auto avx2 = std::count_if(libraries.begin(), libraries.end(),
+                                    [](const auto& lib) { return lib.second->path.find("-avx2") != std::string::npos; });
+    std::fprintf(stderr, "autosynth-batch: %zu job(s), %zu engine(s) (%zu AVX2) on %d thread(s) in %.2f s, %d failed\n",
+                 jobs.size(), libraries.size(), static_cast<size_t>(avx2), numThreads, wall, failures.load());
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+// autosynth-render adapter for A1115VCO: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("osc_waveform", 3, 1),
+        {"osc_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc_fine", -100.0f, 100.0f, 0.0f, 1.0f},
+        {"pulse_width", 0.05f, 0.95f, 0.5f, 0.01f},
+        {"sub_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"glide_time", 0.0f, 2.0f, 0.0f, 0.001f},
+        render::Param::toggle("mono_mode", false),
+        render::Param::choice("vco_fm_source", 3, 0),
+        {"vco_fm_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("vco_pwm_source", 3, 0),
+        {"vco_pwm_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"vcf_cutoff", 20.0f, 20000.0f, 5000.0f, 1.0f, 0.3f},
+        {"vcf_resonance", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("vcf_tracking", 3, 0),
+        render::Param::choice("vcf_mod_source", 3, 2),
+        {"vcf_mod_amount", -1.0f, 1.0f, 0.5f, 0.01f},
+        {"vcf_lfm_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("vca_mod_source", 3, 2),
+        {"vca_initial_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"lfo1_frequency", 0.0f, 1.0f, 0.5f, 0.01f},
+        render::Param::choice("lfo1_waveform", 3, 0),
+        render::Param::choice("lfo1_range", 3, 0),
+        {"lfo2_frequency", 0.0f, 1.0f, 0.5f, 0.01f},
+        render::Param::choice("lfo2_waveform", 3, 0),
+        render::Param::choice("lfo2_range", 3, 0),
+        {"amp_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"amp_decay", 0.001f, 5.0f, 0.1f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"amp_release", 0.001f, 5.0f, 0.3f, 0.001f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "A1115VCO", parameters, applyParams)
@@ -0,0 +1,87 @@
+// autosynth-render adapter for DFAM: parameter table and processBlock() updates
+//
+// The sequencer runs when the preset sets "running"; render it with --length.
+// MIDI notes trigger the voice directly, as in the plugin.
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    std::vector<render::Param> params = {
+        {"tempo", 20.0f, 300.0f, 120.0f, 1.0f},
+        render::Param::toggle("running", false),
+        render::Param::choice("clock_divider", 18, 8),
+        {"vco1_freq", 20.0f, 2000.0f, 110.0f, 1.0f, 0.3f},
+        render::Param::choice("vco1_wave", 4, 0),
+        {"vco1_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"vco2_freq", 20.0f, 2000.0f, 110.0f, 1.0f, 0.3f},
+        render::Param::choice("vco2_wave", 4, 0),
+        {"vco2_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"fm_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"noise_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"pitch_to_noise", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"pitch_to_decay", -1.0f, 1.0f, 0.0f, 0.01f},
+        {"filter_cutoff", 20.0f, 20000.0f, 5000.0f, 1.0f, 0.3f},
+        {"filter_reso", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"filter_env_amount", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"pitch_env_attack", 0.001f, 2.0f, 0.001f, 0.001f},
+        {"pitch_env_decay", 0.001f, 2.0f, 0.3f, 0.001f},
+        {"pitch_env_amount", 0.0f, 48.0f, 24.0f, 0.1f},
+        {"vcf_vca_attack", 0.001f, 2.0f, 0.001f, 0.001f},
+        {"vcf_vca_decay", 0.001f, 2.0f, 0.5f, 0.001f},
+    };
+
+    // Sequencer steps
+    for (int i = 0; i < 8; ++i)
+        params.push_back({"seq_pitch_" + std::to_string(i), -24.0f, 24.0f, 0.0f, 1.0f});
+    for (int i = 0; i < 8; ++i)
+        params.push_back({"seq_vel_" + std::to_string(i), 0.0f, 1.0f, 1.0f, 0.01f});
+
+    params.push_back(render::Param::choice("pitch_lfo_rate", 18, 8));
+    params.push_back({"pitch_lfo_amount", 0.0f, 24.0f, 12.0f, 0.1f});
+    for (int i = 0; i < 8; ++i)
+        params.push_back(render::Param::toggle("pitch_lfo_en_" + std::to_string(i), false));
+
+    params.push_back(render::Param::choice("vel_lfo_rate", 18, 8));
+    params.push_back({"vel_lfo_amount", 0.0f, 1.0f, 0.5f, 0.01f});
+    for (int i = 0; i < 8; ++i)
+        params.push_back(render::Param::toggle("vel_lfo_en_" + std::to_string(i), false));
+
+    params.insert(params.end(), {
+        render::Param::choice("filter_lfo_rate", 18, 8),
+        {"filter_lfo_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("filter_mode", 2, 0),
+        {"sat_drive", 1.0f, 20.0f, 1.0f, 0.1f},
+        {"sat_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("oversampling", 3, 0),
+        render::Param::choice("delay_time", 18, 5),
+        {"delay_feedback", 0.0f, 0.95f, 0.3f, 0.01f},
+        {"delay_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"reverb_decay", 0.1f, 10.0f, 2.0f, 0.1f},
+        {"reverb_damping", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"reverb_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("reverb_engine", 2, 0),
+        {"conv_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"comp_threshold", -60.0f, 0.0f, -10.0f, 0.1f},
+        {"comp_ratio", 1.0f, 20.0f, 4.0f, 0.1f},
+        {"comp_attack", 0.1f, 100.0f, 10.0f, 0.1f},
+        {"comp_release", 10.0f, 1000.0f, 100.0f, 1.0f},
+        {"comp_makeup", 0.0f, 24.0f, 0.0f, 0.1f},
+        {"comp_mix", 0.0f, 1.0f, 1.0f, 0.01f},
+        {"master_volume", -60.0f, 0.0f, -6.0f, 0.1f}
+    });
+    return params;
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "DFAM", parameters, applyParams)
@@ -0,0 +1,38 @@
+// autosynth-render adapter for FMDrone: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        {"carrier_ratio", 0.5f, 8.0f, 1.0f, 0.01f},
+        {"carrier_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"mod_ratio", 0.5f, 16.0f, 2.0f, 0.01f},
+        {"mod_depth", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"mod_feedback", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"mod_attack", 0.001f, 30.0f, 5.0f, 0.001f},
+        {"mod_decay", 0.001f, 30.0f, 10.0f, 0.001f},
+        {"mod_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"mod_release", 0.001f, 30.0f, 8.0f, 0.001f},
+        {"amp_attack", 0.001f, 30.0f, 3.0f, 0.001f},
+        {"amp_decay", 0.001f, 30.0f, 5.0f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 0.9f, 0.01f},
+        {"amp_release", 0.001f, 30.0f, 10.0f, 0.001f},
+        {"drift_rate", 0.01f, 2.0f, 0.1f, 0.01f},
+        {"drift_amount", 0.0f, 1.0f, 0.2f, 0.01f},
+        {"master_level", 0.0f, 1.0f, 0.7f, 0.01f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "FMDrone", parameters, applyParams)
@@ -0,0 +1,57 @@
+// autosynth-render adapter for FMDrums: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "DrumEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        {"kick_carrier_freq", 20.0f, 200.0f, 60.0f, 1.0f, 0.5f},
+        {"kick_mod_ratio", 0.5f, 16.0f, 1.0f, 0.1f, 0.5f},
+        {"kick_mod_depth", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"kick_pitch_decay", 1.0f, 500.0f, 50.0f, 1.0f, 0.5f},
+        {"kick_pitch_amount", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"kick_amp_decay", 1.0f, 2000.0f, 400.0f, 1.0f, 0.5f},
+        {"kick_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"kick_layer_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"kick_layer_tune", -24.0f, 24.0f, 0.0f, 0.01f},
+        {"snare_carrier_freq", 80.0f, 500.0f, 180.0f, 1.0f, 0.5f},
+        {"snare_mod_ratio", 0.5f, 16.0f, 2.4f, 0.1f, 0.5f},
+        {"snare_mod_depth", 0.0f, 1.0f, 0.6f, 0.01f},
+        {"snare_noise", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"snare_pitch_decay", 1.0f, 200.0f, 20.0f, 1.0f, 0.5f},
+        {"snare_amp_decay", 1.0f, 1000.0f, 200.0f, 1.0f, 0.5f},
+        {"snare_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"snare_layer_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"snare_layer_tune", -24.0f, 24.0f, 0.0f, 0.01f},
+        {"hat_carrier_freq", 200.0f, 2000.0f, 800.0f, 1.0f, 0.5f},
+        {"hat_mod_ratio", 0.5f, 16.0f, 7.1f, 0.1f, 0.5f},
+        {"hat_mod_depth", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"hat_noise", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"hat_amp_decay", 1.0f, 500.0f, 80.0f, 1.0f, 0.5f},
+        {"hat_level", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"hat_layer_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"hat_layer_tune", -24.0f, 24.0f, 0.0f, 0.01f},
+        {"perc_carrier_freq", 100.0f, 1000.0f, 400.0f, 1.0f, 0.5f},
+        {"perc_mod_ratio", 0.5f, 16.0f, 3.5f, 0.1f, 0.5f},
+        {"perc_mod_depth", 0.0f, 1.0f, 0.4f, 0.01f},
+        {"perc_pitch_decay", 1.0f, 300.0f, 30.0f, 1.0f, 0.5f},
+        {"perc_amp_decay", 1.0f, 1000.0f, 250.0f, 1.0f, 0.5f},
+        {"perc_level", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"perc_layer_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"perc_layer_tune", -24.0f, 24.0f, 0.0f, 0.01f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(DrumEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(DrumEngine, "FMDrums", parameters, applyParams)
@@ -0,0 +1,60 @@
+// autosynth-render adapter for ModelD: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("osc1_waveform", 4, 0),
+        render::Param::integer("osc1_octave", -2, 2, 0),
+        {"osc1_level", 0.0f, 1.0f, 1.0f, 0.01f},
+        render::Param::choice("osc2_waveform", 4, 0),
+        render::Param::integer("osc2_octave", -2, 2, 0),
+        {"osc2_detune", -1200.0f, 1200.0f, 0.0f, 1.0f},
+        {"osc2_level", 0.0f, 1.0f, 1.0f, 0.01f},
+        render::Param::toggle("osc2_sync", false),
+        render::Param::choice("osc3_waveform", 4, 0),
+        render::Param::integer("osc3_octave", -2, 2, 0),
+        {"osc3_detune", -1200.0f, 1200.0f, 0.0f, 1.0f},
+        {"osc3_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"noise_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"analog_drift", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"filter_cutoff", 20.0f, 20000.0f, 5000.0f, 1.0f, 0.3f},
+        {"filter_reso", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"filter_env_amount", -1.0f, 1.0f, 0.5f, 0.01f},
+        {"filter_kbd_track", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"amp_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"amp_decay", 0.001f, 5.0f, 0.1f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"amp_release", 0.001f, 5.0f, 0.3f, 0.001f},
+        {"filter_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"filter_decay", 0.001f, 5.0f, 0.2f, 0.001f},
+        {"filter_sustain", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"filter_release", 0.001f, 5.0f, 0.3f, 0.001f},
+        {"master_volume", -60.0f, 0.0f, -6.0f, 0.1f},
+        {"lfo_rate", 0.01f, 50.0f, 2.0f, 0.01f, 0.4f},
+        render::Param::choice("lfo_waveform", 5, 0),
+        {"lfo_pitch_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"lfo_filter_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("voice_steal", 3, 0),
+        render::Param::choice("voice_mode", 2, 0),
+        render::Param::choice("para_trigger", 2, 0),
+        render::Param::toggle("mpe", false),
+        render::Param::toggle("cpu_governor", false),
+        {"morph", 0.0f, 1.0f, 0.0f, 0.001f},
+        render::Param::choice("lfo_mode", 2, 0)
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "ModelD", parameters, applyParams)
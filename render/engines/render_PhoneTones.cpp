@@ -0,0 +1,38 @@
+// autosynth-render adapter for PhoneTones: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("tone_mode", 6, 0),
+        {"tone1_freq", 200.0f, 2000.0f, 440.0f, 1.0f, 0.5f},
+        {"tone2_freq", 200.0f, 2000.0f, 480.0f, 1.0f, 0.5f},
+        {"tone_mix", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"filter_low", 200.0f, 500.0f, 300.0f, 1.0f},
+        {"filter_high", 2500.0f, 4000.0f, 3400.0f, 1.0f},
+        {"filter_drive", 0.0f, 1.0f, 0.2f, 0.01f},
+        {"noise_level", 0.0f, 1.0f, 0.1f, 0.01f},
+        {"noise_crackle", 0.0f, 1.0f, 0.1f, 0.01f},
+        {"pattern_rate", 0.1f, 10.0f, 2.0f, 0.01f, 0.5f},
+        {"pattern_duty", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"amp_attack", 0.001f, 2.0f, 0.005f, 0.001f},
+        {"amp_decay", 0.001f, 2.0f, 0.1f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 1.0f, 0.01f},
+        {"amp_release", 0.001f, 2.0f, 0.05f, 0.001f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "PhoneTones", parameters, applyParams)
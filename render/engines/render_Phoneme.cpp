@@ -0,0 +1,37 @@
+// autosynth-render adapter for Phoneme: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("osc_waveform", 2, 0),
+        {"osc_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc_pw", 0.05f, 0.95f, 0.5f, 0.01f},
+        render::Param::choice("vowel", 5, 0),
+        {"formant_shift", -12.0f, 12.0f, 0.0f, 1.0f},
+        {"formant_spread", 0.5f, 2.0f, 1.0f, 0.01f},
+        {"vibrato_rate", 0.1f, 10.0f, 5.0f, 0.01f},
+        {"vibrato_depth", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"vowel_lfo_rate", 0.01f, 5.0f, 0.5f, 0.01f},
+        {"vowel_lfo_depth", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"amp_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"amp_decay", 0.001f, 5.0f, 0.1f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"amp_release", 0.001f, 5.0f, 0.3f, 0.001f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "Phoneme", parameters, applyParams)
@@ -0,0 +1,45 @@
+// autosynth-render adapter for SIDWave: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("osc1_wave", 4, 1),
+        {"osc1_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc1_pw", 0.05f, 0.95f, 0.5f, 0.01f},
+        {"osc1_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        render::Param::choice("osc2_wave", 4, 0),
+        {"osc2_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc2_pw", 0.05f, 0.95f, 0.5f, 0.01f},
+        {"osc2_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"osc2_ring", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("osc3_wave", 4, 2),
+        {"osc3_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc3_level", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"bit_depth", 4.0f, 16.0f, 8.0f, 1.0f},
+        {"sample_rate", 0.0f, 1.0f, 1.0f, 0.01f},
+        {"filter_cutoff", 20.0f, 20000.0f, 8000.0f, 1.0f, 0.3f},
+        {"filter_reso", 0.0f, 1.0f, 0.2f, 0.01f},
+        render::Param::choice("filter_type", 3, 0),
+        {"amp_attack", 0.001f, 2.0f, 0.01f, 0.001f},
+        {"amp_decay", 0.001f, 2.0f, 0.2f, 0.001f},
+        {"amp_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"amp_release", 0.001f, 2.0f, 0.3f, 0.001f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        render::Param::choice("engine_mode", 2, 0)
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SynthEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SynthEngine, "SIDWave", parameters, applyParams)
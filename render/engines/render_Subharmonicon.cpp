@@ -0,0 +1,70 @@
+// autosynth-render adapter for Subharmonicon: parameter table and processBlock() updates
+//
+// The engine takes no notes: it plays its sequencer when the preset sets
+// "seq_run", for --length seconds.
+
+#include "EngineEntry.h"
+#include "SynthEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        {"osc1_freq", 20.0f, 2000.0f, 220.0f, 1.0f, 0.3f},
+        {"osc1_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        render::Param::integer("osc1_wave", 0, 3, 0),
+        render::Param::integer("sub1a_div", 1, 16, 2),
+        {"sub1a_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        render::Param::integer("sub1b_div", 1, 16, 3),
+        {"sub1b_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"osc2_freq", 20.0f, 2000.0f, 220.0f, 1.0f, 0.3f},
+        {"osc2_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        render::Param::integer("osc2_wave", 0, 3, 0),
+        render::Param::integer("sub2a_div", 1, 16, 4),
+        {"sub2a_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        render::Param::integer("sub2b_div", 1, 16, 5),
+        {"sub2b_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"filter1_cutoff", 20.0f, 20000.0f, 2000.0f, 1.0f, 0.3f},
+        {"filter1_reso", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"filter1_env_amt", -1.0f, 1.0f, 0.5f, 0.01f},
+        {"vcf1_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"vcf1_decay", 0.001f, 5.0f, 0.5f, 0.001f},
+        {"vca1_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"vca1_decay", 0.001f, 5.0f, 0.5f, 0.001f},
+        {"filter2_cutoff", 20.0f, 20000.0f, 2000.0f, 1.0f, 0.3f},
+        {"filter2_reso", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"filter2_env_amt", -1.0f, 1.0f, 0.5f, 0.01f},
+        {"vcf2_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"vcf2_decay", 0.001f, 5.0f, 0.5f, 0.001f},
+        {"vca2_attack", 0.001f, 5.0f, 0.01f, 0.001f},
+        {"vca2_decay", 0.001f, 5.0f, 0.5f, 0.001f},
+        {"tempo", 20.0f, 300.0f, 120.0f, 1.0f},
+        {"rhythm1_div", 0.0f, 12.0f, 6.0f, 1.0f},
+        {"rhythm2_div", 0.0f, 12.0f, 7.0f, 1.0f},
+        {"rhythm3_div", 0.0f, 12.0f, 6.0f, 1.0f},
+        {"rhythm4_div", 0.0f, 12.0f, 7.0f, 1.0f},
+        render::Param::toggle("seq1_enable", true),
+        {"seq1_step1", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq1_step2", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq1_step3", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq1_step4", -24.0f, 24.0f, 0.0f, 1.0f},
+        render::Param::toggle("seq2_enable", true),
+        {"seq2_step1", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq2_step2", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq2_step3", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"seq2_step4", -24.0f, 24.0f, 0.0f, 1.0f},
+        render::Param::toggle("seq_run", false),
+        {"master_volume", 0.0f, 1.0f, 0.7f, 0.01f}
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(SubharmoniconEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(SubharmoniconEngine, "Subharmonicon", parameters, applyParams)
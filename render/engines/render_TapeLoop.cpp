@@ -0,0 +1,122 @@
+// autosynth-render adapter for TapeLoop: parameter table and processBlock() updates
+
+#include "EngineEntry.h"
+#include "TapeLoopEngine.h"
+
+namespace
+{
+// As declared in PluginProcessor::createParameterLayout()
+std::vector<render::Param> parameters()
+{
+    return {
+        render::Param::choice("osc1_waveform", 3, 0),
+        {"osc1_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc1_level", 0.0f, 1.0f, 0.7f, 0.01f},
+        render::Param::choice("osc2_waveform", 3, 0),
+        {"osc2_tune", -24.0f, 24.0f, 0.0f, 1.0f},
+        {"osc2_detune", -100.0f, 100.0f, 7.0f, 1.0f},
+        {"osc2_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"loop_length", 0.5f, 60.0f, 4.0f, 0.1f},
+        {"loop_feedback", 0.0f, 1.0f, 0.85f, 0.01f},
+        {"record_level", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"tape_saturation", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"tape_wobble_rate", 0.1f, 5.0f, 0.5f, 0.01f},
+        {"tape_wobble_depth", 0.0f, 1.0f, 0.2f, 0.01f},
+        {"tape_hiss", 0.0f, 1.0f, 0.1f, 0.01f},
+        {"tape_age", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"tape_degrade", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("tape_model", 4, 3),
+        {"tape_drive", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"tape_bump", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("tape_oversampling", 3, 0),
+        render::Param::choice("tape_interpolation", 3, 0),
+        render::Param::toggle("tape_wear_on_record", false),
+        {"tape_speed", 0.25f, 4.0f, 1.0f, 0.01f},
+        render::Param::toggle("tape_reverse", false),
+        {"rec_attack", 0.005f, 0.5f, 0.02f, 0.001f},
+        {"rec_decay", 0.01f, 5.0f, 0.5f, 0.01f},
+        {"fm_amount", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"lfo_rate", 0.1f, 20.0f, 1.0f, 0.01f},
+        {"lfo_depth", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::choice("lfo_waveform", 4, 0),
+        render::Param::choice("lfo_target", 4, 0),
+        {"dry_level", 0.0f, 1.0f, 0.3f, 0.01f},
+        {"loop_level", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"master_level", 0.0f, 1.0f, 0.8f, 0.01f},
+        {"delay_time", 0.01f, 2.0f, 0.5f, 0.01f},
+        {"delay_feedback", 0.0f, 0.95f, 0.3f, 0.01f},
+        {"delay_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"reverb_replace", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"reverb_brightness", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"reverb_detune", 0.0f, 1.0f, 0.2f, 0.01f},
+        {"reverb_bigness", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"reverb_size", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"reverb_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"conv_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"comp_threshold", -40.0f, 0.0f, -10.0f, 0.1f},
+        {"comp_ratio", 1.0f, 20.0f, 4.0f, 0.1f},
+        {"comp_mix", 0.0f, 1.0f, 0.0f, 0.01f},
+        render::Param::toggle("comp_lookahead", false),
+        render::Param::toggle("seq_enabled", false),
+        {"seq_bpm", 30.0f, 300.0f, 120.0f, 1.0f},
+        render::Param::choice("seq1_division", 16, 4),
+        render::Param::integer("seq1_pitch1", 36, 84, 60),
+        render::Param::integer("seq1_pitch2", 36, 84, 60),
+        render::Param::integer("seq1_pitch3", 36, 84, 60),
+        render::Param::integer("seq1_pitch4", 36, 84, 60),
+        render::Param::toggle("seq1_gate1", true),
+        render::Param::toggle("seq1_gate2", true),
+        render::Param::toggle("seq1_gate3", true),
+        render::Param::toggle("seq1_gate4", true),
+        render::Param::choice("seq2_division", 16, 4),
+        render::Param::integer("seq2_pitch1", 36, 84, 60),
+        render::Param::integer("seq2_pitch2", 36, 84, 60),
+        render::Param::integer("seq2_pitch3", 36, 84, 60),
+        render::Param::integer("seq2_pitch4", 36, 84, 60),
+        render::Param::toggle("seq2_gate1", true),
+        render::Param::toggle("seq2_gate2", true),
+        render::Param::toggle("seq2_gate3", true),
+        render::Param::toggle("seq2_gate4", true),
+        {"voice_loop_fm", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"osc1_attack", 1.0f, 5000.0f, 10.0f, 1.0f},
+        {"osc1_decay", 1.0f, 5000.0f, 100.0f, 1.0f},
+        {"osc1_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"osc1_release", 1.0f, 10000.0f, 300.0f, 1.0f},
+        {"osc2_attack", 1.0f, 5000.0f, 10.0f, 1.0f},
+        {"osc2_decay", 1.0f, 5000.0f, 100.0f, 1.0f},
+        {"osc2_sustain", 0.0f, 1.0f, 0.7f, 0.01f},
+        {"osc2_release", 1.0f, 10000.0f, 300.0f, 1.0f},
+        {"pan_speed", 0.01f, 10.0f, 0.5f, 0.01f},
+        {"pan_depth", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"head1_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"head1_offset", 0.0f, 1.0f, 0.25f, 0.01f},
+        {"head1_speed", -4.0f, 4.0f, 1.0f, 0.01f},
+        {"head1_pan", -1.0f, 1.0f, 0.0f, 0.01f},
+        {"head2_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"head2_offset", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"head2_speed", -4.0f, 4.0f, 1.0f, 0.01f},
+        {"head2_pan", -1.0f, 1.0f, 0.0f, 0.01f},
+        {"head3_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"head3_offset", 0.0f, 1.0f, 0.75f, 0.01f},
+        {"head3_speed", -4.0f, 4.0f, 1.0f, 0.01f},
+        {"head3_pan", -1.0f, 1.0f, 0.0f, 0.01f},
+        {"grain_level", 0.0f, 1.0f, 0.0f, 0.01f},
+        {"grain_density", 1.0f, 100.0f, 20.0f, 0.1f},
+        {"grain_size", 10.0f, 500.0f, 100.0f, 1.0f},
+        {"grain_position", 0.0f, 1.0f, 0.5f, 0.01f},
+        {"grain_spray", 0.0f, 1.0f, 0.1f, 0.01f},
+        {"grain_pitch", -24.0f, 24.0f, 0.0f, 0.01f},
+        {"grain_pitch_spread", 0.0f, 24.0f, 0.0f, 0.01f},
+        {"grain_pan_spread", 0.0f, 1.0f, 0.5f, 0.01f},
+        render::Param::choice("render_rate", 2, 0)
+    };
+}
+
+// The parameter updates from PluginProcessor::processBlock()
+void applyParams(TapeLoopEngine& engine, const render::ParamValues& p)
+{
+    engine.applySnapshot(render::makeSnapshot<SynthParams>(p, kParamIds));
+}
+} // namespace
+
+AUTOSYNTH_ENGINE_ENTRY(TapeLoopEngine, "TapeLoop", parameters, applyParams)
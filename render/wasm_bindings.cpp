@@ -0,0 +1,164 @@
+/**
+ * @file wasm_bindings.cpp
+ * @brief Plain C exports for any plugins/synths engine
+ *
+ * Linked with one engines/render_<Plugin>.cpp into an engine library (see
+ * CMakeLists.txt): <Plugin>.simd.wasm for an AudioWorklet
+ * (web-dfam/public/engine-processor.js), or a native shared library that
+ * autosynth-batch loads to render many engines at once on a server. The
+ * adapter supplies makeEngineHost(); everything here is the same for
+ * every engine.
+ *
+ * Engines are handles from createEngine(), so one library can run several
+ * at once, each on its own thread. The parameter table and name describe
+ * the engine type and don't need one.
+ */
+
+#include "EngineHost.h"
+
+#if defined(__EMSCRIPTEN__)
+#define AUTOSYNTH_EXPORT  // EXPORTED_FUNCTIONS in CMakeLists.txt
+#else
+#define AUTOSYNTH_EXPORT __attribute__((visibility("default")))
+#endif
+
+using render::abi::EngineHost;
+
+// Table and name, from an instance that is never prepared
+static const EngineHost& prototype()
+{
+    static const std::unique_ptr<EngineHost> host = render::abi::makeEngineHost();
+    return *host;
+}
+
+extern "C" {
+
+// A new engine, unprepared until init(). Null if out of memory.
+AUTOSYNTH_EXPORT EngineHost* createEngine()
+{
+    return render::abi::makeEngineHost().release();
+}
+
+AUTOSYNTH_EXPORT void destroyEngine(EngineHost* engine)
+{
+    delete engine;
+}
+
+// Prepare for the largest block process() will be asked for. Every
+// parameter is reset to its default. Returns 0 on failure.
+AUTOSYNTH_EXPORT int init(EngineHost* engine, int sampleRate, int maxBlockSize)
+{
+    return engine && engine->init(static_cast<double>(sampleRate), maxBlockSize) ? 1 : 0;
+}
+
+// Render any number of frames into planar output buffers
+AUTOSYNTH_EXPORT void process(EngineHost* engine, float* outputL, float* outputR, int numSamples)
+{
+    if (engine)
+        engine->process(outputL, outputR, numSamples);
+}
+
+// process() with planar audio input, for engines that take it (TapeLoop);
+// the input may be the output buffers, filled first, for one copy in
+AUTOSYNTH_EXPORT void processInput(EngineHost* engine, const float* inputL, const float* inputR, float* outputL,
+                                   float* outputR, int numSamples)
+{
+    if (engine)
+        engine->process(inputL, inputR, outputL, outputR, numSamples);
+}
+
+// Queue count five-word event records for the next process(); returns how
+// many were taken (the rest should be retried on the next call)
+AUTOSYNTH_EXPORT int queueEvents(EngineHost* engine, const render::abi::Event* events, int count)
+{
+    return engine ? engine->queueEvents(events, count) : 0;
+}
+
+// Play a MIDI pattern (MidiPattern.h's binary form, any sample rate) from
+// its start, alongside queued events. Returns 0 if it isn't one.
+AUTOSYNTH_EXPORT int loadPattern(EngineHost* engine, const uint8_t* data, int size)
+{
+    return engine && engine->loadPattern(data, size) ? 1 : 0;
+}
+
+// Jump the pattern and the automation to a frame; sounding notes stop,
+// and so does automation recording
+AUTOSYNTH_EXPORT void seekPattern(EngineHost* engine, int frame)
+{
+    if (engine)
+        engine->seekPattern(frame);
+}
+
+// Play parameter automation (Automation.h's binary form, any sample rate)
+// on the pattern's timeline, from where it is. Lanes for parameters the
+// engine doesn't have are skipped. Returns 0 if it isn't automation.
+AUTOSYNTH_EXPORT int loadAutomation(EngineHost* engine, const uint8_t* data, int size)
+{
+    return engine && engine->loadAutomation(data, size) ? 1 : 0;
+}
+
+// Record parameter block writes and parameter events from the pattern's
+// position, with room for maxPoints breakpoints (allocated here, so not
+// mid-bounce), or stop recording with 0
+AUTOSYNTH_EXPORT int recordAutomation(EngineHost* engine, int maxPoints)
+{
+    return engine && engine->recordAutomation(maxPoints) ? 1 : 0;
+}
+
+// Stop recording and keep the take, in the form loadAutomation() reads;
+// returns its size in bytes (0: nothing recorded), read from
+// getAutomationPtr()
+AUTOSYNTH_EXPORT int takeAutomation(EngineHost* engine)
+{
+    return engine ? engine->takeAutomation() : 0;
+}
+
+AUTOSYNTH_EXPORT const uint8_t* getAutomationPtr(EngineHost* engine)
+{
+    return engine ? engine->getAutomation() : nullptr;
+}
+
+// 1 while process() would only render silence: the worklet may output
+// zeros itself until it next queues an event or writes the parameter block
+AUTOSYNTH_EXPORT int isSilent(EngineHost* engine)
+{
+    return engine && engine->isSilent() ? 1 : 0;
+}
+
+// The engine's PerfStats::Snapshot as up to size doubles, in toFlat()
+// order ("enabled" first, 0 unless built with SYNTH_PERF_STATS); returns
+// how many there are in all (PerfStats::Snapshot::FLAT_SIZE)
+AUTOSYNTH_EXPORT int getPerfStats(EngineHost* engine, double* out, int size)
+{
+    double flat[PerfStats::Snapshot::FLAT_SIZE] = {};
+    if (engine)
+        engine->getPerfStats().toFlat(flat);
+    for (int i = 0; i < std::min(size, PerfStats::Snapshot::FLAT_SIZE); ++i)
+        out[i] = flat[i];
+    return PerfStats::Snapshot::FLAT_SIZE;
+}
+
+// Parameter block: one plain value per parameter, table order
+AUTOSYNTH_EXPORT float* getParamBlockPtr(EngineHost* engine)
+{
+    return engine ? engine->getParamBlock() : nullptr;
+}
+
+// Parameter table: getParamCount() ParamInfo rows (8 words each in WASM)
+AUTOSYNTH_EXPORT const render::abi::ParamInfo* getParamTablePtr()
+{
+    return prototype().getParamTable();
+}
+
+AUTOSYNTH_EXPORT int getParamCount()
+{
+    return prototype().getParamCount();
+}
+
+// Plugin name, NUL terminated
+AUTOSYNTH_EXPORT const char* getEngineName()
+{
+    return prototype().getName();
+}
+
+} // extern "C"
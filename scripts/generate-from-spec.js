@@ -1,262 +1,1175 @@
 #!/usr/bin/env node
 /**
  * @file generate-from-spec.js
- * @brief Generates Voice.h, parameters, and UI from synth-spec.json
+ * @brief Generates a specialized engine, parameters, and UI from synth-spec.json
  *
- * Usage: node generate-from-spec.js <spec.json> <output-dir>
+ * Usage: node generate-from-spec.js <spec.json> <output-dir> [--costs shootout_sst.json]
  *
  * This is the key efficiency win: instead of TODO comments that agents
  * must interpret, we generate working code from a validated spec.
+ *
+ * The generated engine is specialized to the spec, not a generic voice
+ * that chains whatever the spec names:
+ *
+ *   - The module graph is fixed at generation time. Each oscillator
+ *     chain and the filter stages are emitted as DspGraph types
+ *     (core/dsp/DspGraph.h over the template's GraphModules.h), so the
+ *     compiler inlines a voice's chain into one loop; nothing the spec
+ *     leaves out is compiled in. DspFeatures.h switches off the optional
+ *     GraphModules nodes (wavetable, waveguide, filter) and their headers.
+ *   - Voice state is SoA: one array per field and module across the
+ *     voices, and the filter runs four voices per SIMD register.
+ *   - Parameters are one table (SynthParams.h) carrying range, default,
+ *     smoothing time and modulation rate. Smoothed parameters get a
+ *     ParamSmoother lane with their own ramp time.
+ *   - Modulation targets a spec marks "modRate": "control" are worked out
+ *     once per ControlRamp::BLOCK_SIZE samples and ramped (filter
+ *     coefficients, detune ratios); "audio" targets run every sample.
+ *
+ * Spec features the graph can't build (effects, sync, some envelope
+ * types) are reported as warnings and listed in the generated header.
+ *
+ * A spec with a "budget" is costed before anything is written: per-module
+ * costs from templates/dsp-costs.json, or from a synth_shootout_sst run
+ * with --costs. Over budget, generation stops with the breakdown and the
+ * substitutions that would bring it down (control-rate modulation, fewer
+ * filter stages, fewer voices).
  */
 
-const fs = require('fs');
-const path = require('path');
-
-// SST include mappings
-const SST_INCLUDES = {
-  // Oscillators
-  DPWSawOscillator: 'sst/basic-blocks/dsp/DPWSawOscillator.h',
-  SinOscillator: 'sst/basic-blocks/dsp/SinOscillator.h',
-  PulseOscillator: 'sst/basic-blocks/dsp/PulseOscillator.h',
-  CorrelatedNoise: 'sst/basic-blocks/dsp/CorrelatedNoise.h',
-  WavetableOscillator: 'sst/basic-blocks/dsp/WavetableOscillator.h',
-  // Filters
-  CytomicSVF: 'sst/filters/CytomicSVF.h',
-  VintageLadder: 'sst/filters/VintageLadder.h',
-  K35Filter: 'sst/filters/K35Filter.h',
-  NonlinearFeedback: 'sst/filters/NonlinearFeedback.h',
-  DiodeLadder: 'sst/filters/DiodeLadder.h',
-  CombFilter: 'sst/filters/CombFilter.h',
-  // Modulators
-  ADSREnvelope: 'sst/basic-blocks/modulators/ADSREnvelope.h',
-  DAHDSREnvelope: 'sst/basic-blocks/modulators/DAHDSREnvelope.h',
-  SimpleLFO: 'sst/basic-blocks/modulators/SimpleLFO.h',
-  // Effects
-  Delay: 'sst/effects/Delay.h',
-  Reverb: 'sst/effects/Reverb.h',
-  Chorus: 'sst/effects/Chorus.h',
-  Phaser: 'sst/effects/Phaser.h',
-  Flanger: 'sst/effects/Flanger.h',
-  Distortion: 'sst/waveshapers/Waveshaper.h'
+import fs from 'fs';
+import path from 'path';
+
+// Oscillator components -> DPWOscillator shape (core/dsp/BandLimitedOscillator.h),
+// 'wavetable' for a WavetableOscillator (core/dsp/Wavetable.h) or 'waveguide'
+// for a plucked or bowed WaveguideString (core/dsp/Waveguide.h)
+const OSC_MODULES = {
+  DPWSawOscillator: 'OscShape::Saw',
+  SawOscillator: 'OscShape::Saw',
+  PulseOscillator: 'OscShape::Pulse',
+  DPWPulseOscillator: 'OscShape::Pulse',
+  TriangleOscillator: 'OscShape::Triangle',
+  SinOscillator: 'OscShape::Sine',
+  WavetableOscillator: 'wavetable',
+  StringResonator: 'waveguide',
+  Waveguide: 'waveguide'
+};
+
+// Waveguide excitations -> StringExcitation
+const EXCITATIONS = {
+  pluck: 'StringExcitation::Pluck',
+  bow: 'StringExcitation::Bow'
+};
+
+// Filter components: all run as the four-lane CytomicSVF (ladders as a two-pole cascade)
+const FILTER_MODULES = ['CytomicSVF', 'VintageLadder', 'DiodeLadder', 'K35Filter', 'NonlinearFeedback'];
+
+// Filter mode -> CytomicSVF mode and number of cascaded stages
+const FILTER_MODES = {
+  LP6: ['Lowpass', 1],
+  LP12: ['Lowpass', 1],
+  LP18: ['Lowpass', 2],
+  LP24: ['Lowpass', 2],
+  HP12: ['Highpass', 1],
+  HP24: ['Highpass', 2],
+  BP12: ['Bandpass', 1],
+  BP24: ['Bandpass', 2],
+  Notch: ['Notch', 1],
+  Peak: ['Peak', 1],
+  AllPass: ['Allpass', 1]
 };
 
-// SST namespace mappings
-const SST_NAMESPACES = {
-  DPWSawOscillator: 'sst::basic_blocks::dsp::DPWSawOscillator',
-  SinOscillator: 'sst::basic_blocks::dsp::SinOscillator',
-  PulseOscillator: 'sst::basic_blocks::dsp::PulseOscillator',
-  CorrelatedNoise: 'sst::basic_blocks::dsp::CorrelatedNoise',
-  VintageLadder: 'sst::filters::VintageLadder<float, 1>',
-  CytomicSVF: 'sst::filters::CytomicSVF',
-  K35Filter: 'sst::filters::K35Filter',
-  ADSREnvelope: 'sst::basic_blocks::modulators::ADSREnvelope',
-  DAHDSREnvelope: 'sst::basic_blocks::modulators::DAHDSREnvelope',
-  SimpleLFO: 'sst::basic_blocks::modulators::SimpleLFO'
+// LFO shape -> expression of the phase p (0-1)
+const LFO_SHAPES = {
+  sine: 'OscPhase::sine(p)',
+  triangle: 'OscPhase::triangle(p)',
+  saw: '2.0f * p - 1.0f',
+  square: '(p < 0.5f ? 1.0f : -1.0f)'
 };
 
+// Parameters glide unless they're switches, choices or envelope times
+const DEFAULT_SMOOTHING_MS = 20;
+
 function loadSpec(specPath) {
   const content = fs.readFileSync(specPath, 'utf8');
   return JSON.parse(content);
 }
 
-function collectIncludes(spec) {
-  const includes = new Set();
+//==============================================================================
+// Naming and literals
+//==============================================================================
+
+/** osc1_level -> Osc1Level */
+function pascal(id) {
+  return id.split('_').map(w => w.charAt(0).toUpperCase() + w.slice(1)).join('');
+}
 
-  // Oscillators
-  spec.voice.oscillators.forEach(osc => {
-    if (SST_INCLUDES[osc.sst]) includes.add(SST_INCLUDES[osc.sst]);
-    if (osc.preFx) {
-      osc.preFx.forEach(fx => {
-        if (SST_INCLUDES[fx.sst]) includes.add(SST_INCLUDES[fx.sst]);
-      });
+/** osc1_level -> osc1Level */
+function camel(id) {
+  const p = pascal(id);
+  return p.charAt(0).toLowerCase() + p.slice(1);
+}
+
+/** A C++ float literal */
+function f(x) {
+  const s = String(Number(x));
+  return (/[.e]/.test(s) ? s : `${s}.0`) + 'f';
+}
+
+function smoothingMs(p) {
+  if (p.smoothing !== undefined) return p.smoothing;
+  const stepped = p.scale === 'discrete' || ['toggle', 'select', 'adsr'].includes(p.control || 'knob');
+  return stepped ? 0 : DEFAULT_SMOOTHING_MS;
+}
+
+function modRate(p) {
+  return p.modRate || 'audio';
+}
+
+//==============================================================================
+// Module graph
+//==============================================================================
+
+/**
+ * Resolve the spec into the fixed graph the engine is generated from:
+ * which modules exist and which parameter drives each input.
+ */
+function buildGraph(spec) {
+  const warnings = [];
+  const byId = new Map(spec.parameters.map(p => [p.id, p]));
+  const used = new Set();
+  const find = (...ids) => {
+    const p = ids.filter(Boolean).map(id => byId.get(id)).find(Boolean) || null;
+    if (p) used.add(p.id);
+    return p;
+  };
+
+  // Engine-wide inputs the voices read every block, in declaration order
+  const inputs = [];
+  const input = (param, fallback, kind = 'linear') => {
+    if (!param) return { constant: fallback };
+    let existing = inputs.find(i => i.param.id === param.id);
+    if (!existing) {
+      existing = { name: camel(param.id), param, rate: modRate(param), kind, lfo: null };
+      inputs.push(existing);
     }
-  });
+    return existing;
+  };
+
+  const oscillators = [];
+  for (const osc of spec.voice.oscillators) {
+    const shape = OSC_MODULES[osc.sst];
+    if (!shape) {
+      warnings.push(`oscillator ${osc.id}: no specialized module for ${osc.sst || osc.component}, left out`);
+      continue;
+    }
+    const wavetable = shape === 'wavetable';
+    const waveguide = shape === 'waveguide';
+    const features = osc.features || [];
+    const generated = ['level', 'detune', ...(wavetable ? ['position'] : []), ...(waveguide ? ['decay', 'brightness'] : [])];
+    for (const feature of features.filter(x => !generated.includes(x)))
+      warnings.push(`oscillator ${osc.id}: feature "${feature}" is not generated`);
+
+    let drive = null;
+    for (const fx of osc.preFx || []) {
+      if (fx.sst === 'Distortion' && !drive)
+        drive = input(find(fx.id, `${fx.id}_drive`), 0);
+      else
+        warnings.push(`oscillator ${osc.id}: pre-effect ${fx.id} (${fx.sst}) is not generated`);
+    }
+
+    const detune = features.includes('detune') ? input(find(`${osc.id}_detune`), 0) : { constant: 0 };
+    if (wavetable && detune.param && detune.rate === 'audio')
+      warnings.push(`oscillator ${osc.id}: wavetable detune is applied per block (the mip level is picked per block)`);
+    if (waveguide && detune.param && detune.rate === 'audio')
+      warnings.push(`oscillator ${osc.id}: waveguide detune is applied per block (the line lengths are set per block)`);
+
+    const excitation = osc.excitation || 'pluck';
+    if (waveguide && !EXCITATIONS[excitation])
+      warnings.push(`oscillator ${osc.id}: excitation "${excitation}" runs as a pluck`);
+
+    oscillators.push({
+      id: osc.id,
+      sst: osc.sst,
+      shape,
+      wavetable,
+      table: osc.table || 'basic',
+      waveguide,
+      excitation: EXCITATIONS[excitation] ? excitation : 'pluck',
+      decay: waveguide && features.includes('decay') ? input(find(`${osc.id}_decay`), 2) : { constant: 2 },
+      brightness: waveguide && features.includes('brightness') ? input(find(`${osc.id}_brightness`), 0.5) : { constant: 0.5 },
+      level: features.includes('level') ? input(find(`${osc.id}_level`), 1) : { constant: 1 },
+      detune,
+      position: wavetable && features.includes('position') ? input(find(`${osc.id}_position`), 0) : { constant: 0 },
+      drive
+    });
+  }
+  if (oscillators.length === 0)
+    throw new Error('the spec has no oscillator the generator can build');
+
+  let filter = null;
+  for (const spec_ of spec.voice.filters || []) {
+    if (filter || !FILTER_MODULES.includes(spec_.sst)) {
+      warnings.push(`filter ${spec_.id}: ${filter ? 'only the first filter is generated' : `no module for ${spec_.sst}`}`);
+      continue;
+    }
+    const modeName = (spec_.modes || ['LP12'])[0];
+    const [mode, stages] = FILTER_MODES[modeName] || FILTER_MODES.LP12;
+    const cutoff = find(`${spec_.id}_cutoff`, 'filter_cutoff', 'cutoff');
+    if (!cutoff) {
+      warnings.push(`filter ${spec_.id}: no cutoff parameter, left out`);
+      continue;
+    }
+    if (spec_.sst !== 'CytomicSVF')
+      warnings.push(`filter ${spec_.id}: ${spec_.sst} runs as a ${stages}-stage CytomicSVF ${mode.toLowerCase()}`);
+
+    const cutoffInput = input(cutoff, 0, 'cutoff');
+    // Coefficients are worked out together, so the other filter inputs follow the cutoff's rate
+    const resoParam = find(`${spec_.id}_reso`, `${spec_.id}_resonance`, 'filter_reso', 'filter_resonance', 'resonance');
+    const reso = input(resoParam, 0);
+    const envAmount = spec_.envAmount ? input(find(`${spec_.id}_env`, `${spec_.id}_env_amount`, 'filter_env', 'filter_env_amount'), 0) : { constant: 0 };
+    const keyTrack = spec_.keyTracking ? input(find(`${spec_.id}_key`, `${spec_.id}_keytrack`, 'filter_key', 'filter_keytrack'), 0) : { constant: 0 };
+    for (const inp of [reso, envAmount, keyTrack])
+      if (inp.param) inp.rate = cutoffInput.rate;
+
+    filter = {
+      id: spec_.id,
+      sst: spec_.sst,
+      modeName,
+      mode,
+      stages,
+      cutoff: cutoffInput,
+      reso,
+      envAmount,
+      keyTrack
+    };
+  }
+
+  const envelopeParams = (env) => {
+    const prefixes = [env.id, env.target];
+    if (env.target === 'filter') prefixes.push('flt', 'filter_env');
+    const stage = (name, fallback) => {
+      const p = find(...prefixes.map(pre => `${pre}_${name}`));
+      return p ? { param: p } : { constant: fallback };
+    };
+    return {
+      id: env.id,
+      attack: stage('attack', 0.01),
+      decay: stage('decay', 0.1),
+      sustain: stage('sustain', env.type === 'AD' ? 0 : 0.7),
+      release: stage('release', 0.3)
+    };
+  };
+
+  let ampEnv = null;
+  let filterEnv = null;
+  for (const env of spec.voice.envelopes) {
+    if (env.type !== 'ADSR')
+      warnings.push(`envelope ${env.id}: ${env.type} runs as an ADSR`);
+    if (env.target === 'amp' && !ampEnv)
+      ampEnv = envelopeParams(env);
+    else if (env.target === 'filter' && filter && !filterEnv)
+      filterEnv = envelopeParams(env);
+    else
+      warnings.push(`envelope ${env.id}: target "${env.target}" is not generated`);
+  }
+  if (!ampEnv) {
+    warnings.push('no amp envelope: the voices use a default ADSR');
+    ampEnv = envelopeParams({ id: 'amp_env', target: 'amp', type: 'ADSR' });
+  }
+
+  let lfo = null;
+  const lfos = spec.voice.lfos || [];
+  for (const l of lfos) {
+    const single = lfos.length === 1;
+    const target = l.defaultTarget ? inputs.find(i => i.param.id === l.defaultTarget) : null;
+    if (lfo || !target) {
+      warnings.push(`lfo ${l.id}: ${lfo ? 'only the first LFO is generated' : 'its defaultTarget is not a voice input'}`);
+      continue;
+    }
+    const shapeName = (l.shapes || ['sine'])[0];
+    if (!LFO_SHAPES[shapeName])
+      warnings.push(`lfo ${l.id}: shape ${shapeName} runs as a sine`);
+    lfo = {
+      id: l.id,
+      shape: LFO_SHAPES[shapeName] || LFO_SHAPES.sine,
+      shapeName: LFO_SHAPES[shapeName] ? shapeName : 'sine',
+      rate: find(`${l.id}_rate`, single ? 'lfo_rate' : null),
+      depth: find(`${l.id}_depth`, single ? 'lfo_depth' : null),
+      target
+    };
+    target.lfo = lfo;
+  }
+
+  const master = find('master_volume', 'master_level', 'master_gain', 'volume');
+
+  for (const fx of spec.effects || [])
+    warnings.push(`effect ${fx.id} (${fx.sst || fx.component}) is not generated`);
+
+  const unused = spec.parameters.filter(p => !used.has(p.id)).map(p => p.id);
+
+  return {
+    voices: spec.meta.voices || 8,
+    oscillators,
+    filter,
+    ampEnv,
+    filterEnv,
+    lfo,
+    master,
+    inputs,
+    warnings,
+    unused
+  };
+}
 
-  // Filters
-  spec.voice.filters?.forEach(filter => {
-    if (SST_INCLUDES[filter.sst]) includes.add(SST_INCLUDES[filter.sst]);
+//==============================================================================
+// Cost budget
+//==============================================================================
+
+/**
+ * Per-module costs (templates/dsp-costs.json), with the kernels measured
+ * by synth_shootout_sst in place of the defaults when a shootout_sst.json
+ * is given: the mean over its runs at the budget's sample rate, or over
+ * all of them if it has none there.
+ */
+function loadCosts(shootoutPath, sampleRate) {
+  const table = JSON.parse(fs.readFileSync(new URL('../templates/dsp-costs.json', import.meta.url), 'utf8'));
+  const costs = Object.fromEntries(Object.entries(table.modules)
+    .map(([name, m]) => [name, m.nsPerVoiceSample ?? m.nsPerSample]));
+  if (shootoutPath) {
+    const shootout = JSON.parse(fs.readFileSync(shootoutPath, 'utf8'));
+    const runs = [...(shootout.filters || []), ...(shootout.oscillators || [])];
+    for (const [name, m] of Object.entries(table.modules)) {
+      const all = runs.filter(r => r.kernel === m.kernel);
+      const atRate = all.filter(r => r.sampleRate === sampleRate);
+      const use = atRate.length ? atRate : all;
+      if (use.length) costs[name] = use.reduce((sum, r) => sum + r.nsPerVoiceSample, 0) / use.length;
+    }
+  }
+  return { costs, blockSize: table.blockSize };
+}
+
+/**
+ * What one voice of the graph costs, module by module (ns per sample),
+ * and the substitutions that would make it cheaper.
+ */
+function estimateVoiceCost(graph, { costs, blockSize }) {
+  const items = [];
+  const savings = [];
+  const controlRate = (inp, module, what) => savings.push({
+    ns: costs[module] * (1 - 1 / blockSize),
+    text: `"modRate": "control" on ${inp.param.id} (${what} once per ${blockSize}-sample block)`
   });
 
-  // Always need envelopes and LFOs
-  includes.add(SST_INCLUDES.ADSREnvelope);
-  if (spec.voice.lfos?.length > 0) {
-    includes.add(SST_INCLUDES.SimpleLFO);
+  for (const o of graph.oscillators) {
+    const module = o.wavetable ? 'wavetable' : o.waveguide ? (o.excitation === 'bow' ? 'waveguideBow' : 'waveguidePluck') : 'oscillator';
+    items.push({ what: `${o.id} ${module}`, ns: costs[module] });
+    if (o.detune.param && o.detune.rate === 'audio' && !o.wavetable && !o.waveguide) {
+      items.push({ what: `${o.id} detune, every sample`, ns: costs.audioDetune });
+      controlRate(o.detune, 'audioDetune', 'retuned');
+    }
+    if (o.drive)
+      items.push({ what: `${o.id} soft clip`, ns: costs.softClip });
   }
 
-  // Effects
-  spec.effects?.forEach(fx => {
-    if (SST_INCLUDES[fx.sst]) includes.add(SST_INCLUDES[fx.sst]);
+  const { filter } = graph;
+  if (filter) {
+    items.push({ what: `${filter.id} x${filter.stages} svfStage`, ns: filter.stages * costs.svfStage });
+    const audio = filter.cutoff.rate === 'audio';
+    items.push({ what: `${filter.id} coefficients, ${audio ? 'every sample' : 'per block'}`, ns: costs.filterCoefficients / (audio ? 1 : blockSize) });
+    if (audio)
+      controlRate(filter.cutoff, 'filterCoefficients', 'coefficients');
+    if (filter.stages > 1)
+      savings.push({ ns: (filter.stages - 1) * costs.svfStage, text: `a 12 dB mode for ${filter.id} (${filter.modeName} runs ${filter.stages} stages)` });
+  }
+
+  items.push({ what: 'amp envelope', ns: costs.envelope });
+  if (graph.filterEnv)
+    items.push({ what: 'filter envelope', ns: costs.envelope });
+  items.push({ what: 'voice', ns: costs.voice });
+
+  return { items, savings, voiceNs: items.reduce((sum, i) => sum + i.ns, 0), engineNs: costs.engine };
+}
+
+/**
+ * Check the spec's budget: the cost of every voice sounding in every
+ * instance, as a share of one core. Returns the estimate, or throws
+ * with the breakdown and cheaper substitutions when it's over.
+ */
+function checkBudget(spec, graph, shootoutPath) {
+  const budget = spec.budget;
+  if (!budget) return null;
+  const voices = budget.voices || graph.voices;
+  const instances = budget.instances || 1;
+  const sampleRate = budget.sampleRate || 48000;
+
+  const estimate = estimateVoiceCost(graph, loadCosts(shootoutPath, sampleRate));
+  const percent = voiceNs => (voices * voiceNs + estimate.engineNs) * sampleRate * instances * 1e-7;
+  const pct = x => `${x.toFixed(1)}%`;
+  const cpu = percent(estimate.voiceNs);
+  const summary = `${pct(cpu)} of one core for ${voices} voices x ${instances} instance${instances > 1 ? 's' : ''} at ${sampleRate} Hz (budget ${pct(budget.cpuPercent)})`;
+  if (cpu <= budget.cpuPercent)
+    return { cpu, summary, ...estimate };
+
+  const breakdown = [...estimate.items].sort((a, b) => b.ns - a.ns)
+    .map(i => `    ${i.what.padEnd(36)} ${i.ns.toFixed(1)} ns`);
+  const substitutions = [...estimate.savings].sort((a, b) => b.ns - a.ns)
+    .map(s => `    ${s.text}: ${pct(percent(estimate.voiceNs - s.ns))}`);
+  const perVoice = (cpu - percent(0)) / voices;
+  const fit = Math.floor((budget.cpuPercent - percent(0)) / perVoice);
+  substitutions.push(fit >= 1
+    ? `    ${fit} voice${fit > 1 ? 's' : ''} instead of ${voices}: ${pct(percent(0) + fit * perVoice)}`
+    : '    not even one voice fits: raise the budget');
+
+  throw new Error([
+    `over budget: ${summary}`,
+    '  per voice and sample:',
+    ...breakdown,
+    '  cheaper:',
+    ...substitutions
+  ].join('\n'));
+}
+
+//==============================================================================
+// SynthParams.h
+//==============================================================================
+
+function generateSynthParamsH(spec) {
+  const width = Math.max(...spec.parameters.map(p => pascal(p.id).length)) + 1;
+  const rows = spec.parameters.map(p => {
+    const name = `${pascal(p.id)},`.padEnd(width + 1);
+    const rate = modRate(p) === 'control' ? 'Control' : 'Audio';
+    return `    X(${name}"${p.id}", ${f(p.min)}, ${f(p.max)}, ${f(p.default)}, ${f(smoothingMs(p))}, ${rate})`;
   });
 
-  return Array.from(includes);
+  return `/**
+ * @file SynthParams.h
+ * @brief ${spec.meta.name} parameter table: ids, ranges, smoothing and modulation rate
+ * @generated from synth-spec.json - DO NOT EDIT MANUALLY
+ *
+ * SYNTH_PARAMS has one entry per parameter, in the order of
+ * createParameterLayout() (Parameters.h). The ParamId enum, the APVTS ID
+ * table and kParamInfo all come from it.
+ *
+ * smoothingMs is the glide time for a new value (0 = steps). modRate is
+ * how often a modulated parameter reaches the DSP: Audio every sample,
+ * Control once per ControlRamp::BLOCK_SIZE samples, ramped.
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId, min, max, default, smoothingMs, modRate)
+#define SYNTH_PARAMS(X) \\
+${rows.join(' \\\n')}
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id, min, max, def, smoothingMs, rate) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id, min, max, def, smoothingMs, rate) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+enum class ModRate { Audio, Control };
+
+struct ParamInfo
+{
+    const char* id;
+    float min;
+    float max;
+    float defaultValue;
+    float smoothingMs;
+    ModRate modRate;
+};
+
+inline constexpr ParamInfo kParamInfo[kNumParams] = {
+#define SYNTH_PARAM_INFO(name, id, min, max, def, smoothingMs, rate) {id, min, max, def, smoothingMs, ModRate::rate},
+    SYNTH_PARAMS(SYNTH_PARAM_INFO)
+#undef SYNTH_PARAM_INFO
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
+`;
 }
 
-function generateVoiceH(spec) {
-  const includes = collectIncludes(spec);
-  const className = `${spec.meta.id}Voice`;
+//==============================================================================
+// Voice.h: the voice bank
+//==============================================================================
 
-  let code = `/**
+/**
+ * Inputs the voice graphs read sample by sample (VoiceSignals): levels,
+ * drive, wavetable position and audio-rate detune. Control-rate detune
+ * and the filter inputs are used once per block instead.
+ */
+function signalInputs(graph) {
+  const { oscillators } = graph;
+  const wanted = [];
+  for (const o of oscillators) {
+    if (o.drive && o.drive.param) wanted.push(o.drive);
+    if (o.level.param) wanted.push(o.level);
+    if (o.position.param) wanted.push(o.position);
+    if (o.detune.param && o.detune.rate === 'audio' && !o.wavetable && !o.waveguide) wanted.push(o.detune);
+  }
+  return graph.inputs.filter(i => wanted.includes(i));
+}
+
+/** The DspGraph type of one oscillator's chain */
+function oscChainType(o) {
+  const shape = o.shape;
+  const osc = o.wavetable
+    ? `GraphModules::Wavetable<${o.position.param ? `&VoiceSignals::${o.position.name}` : 'nullptr'}>`
+    : o.waveguide
+    ? `GraphModules::String<${EXCITATIONS[o.excitation]}>`
+    : o.detune.param && o.detune.rate === 'audio'
+      ? `GraphModules::DetunedOscillator<${shape}, &VoiceSignals::${o.detune.name}>`
+      : `GraphModules::Oscillator<${shape}>`;
+  const nodes = [osc];
+  if (o.drive && o.drive.param) nodes.push(`GraphModules::SoftClip<&VoiceSignals::${o.drive.name}>`);
+  if (o.level.param) nodes.push(`DspGraph::Gain<&VoiceSignals::${o.level.name}>`);
+  const indent = ' '.repeat(`using ${pascal(o.id)}Chain = DspGraph::Serial<`.length);
+  return `DspGraph::Serial<${nodes.join(`,\n${indent}`)}>`;
+}
+
+/**
+ * DspFeatures.h: which optional GraphModules nodes the graph uses. The
+ * ones it leaves out are compiled out, headers and lazily built tables
+ * (wavetable mips, the waveguide's sinc table) with them.
+ */
+function generateDspFeaturesH(spec, graph) {
+  const features = [
+    ['SYNTH_USES_WAVETABLE', graph.oscillators.some(o => o.wavetable), 'Wavetable.h, WavetableRegistry'],
+    ['SYNTH_USES_WAVEGUIDE', graph.oscillators.some(o => o.waveguide), 'Waveguide.h, SSESincDelayLine and its sinc table'],
+    ['SYNTH_USES_SVF', !!graph.filter, 'sst/filters/CytomicSVF.h']
+  ];
+  const width = Math.max(...features.map(([name]) => name.length)) + 1;
+
+  return `/**
+ * @file DspFeatures.h
+ * @brief ${spec.meta.name} - optional DSP modules its graph uses
+ * @generated from synth-spec.json - DO NOT EDIT MANUALLY
+ *
+ * GraphModules.h picks this up and compiles out the nodes, and the
+ * headers behind them, set to 0 here.
+ */
+
+#pragma once
+
+${features.map(([name, used, what]) => `#define ${name.padEnd(width)}${used ? 1 : 0}  // ${what}`).join('\n')}
+`;
+}
+
+function generateVoiceH(spec, graph) {
+  const { oscillators, filter, filterEnv } = graph;
+  const inputs = graph.inputs;
+  const signals = signalInputs(graph);
+
+  const inputFields = inputs.map(i => {
+    const what = `${i.param.name}${i.param.unit ? ` (${i.param.unit})` : ''}`;
+    return i.rate === 'audio'
+      ? `    std::array<float, BLOCK_SIZE> ${i.name}{};  // ${what}, per sample`
+      : `    float ${i.name} = ${f(i.param.default)};  // ${what}, block end`;
+  });
+
+  // Oscillator frequencies: once per block unless the detune runs at audio
+  // rate (wavetables and waveguides always per block, from the block's first sample)
+  const blockDetune = o => o.detune.param && (o.detune.rate === 'control' || o.wavetable || o.waveguide);
+  const detuneRatio = o => o.detune.constant !== undefined
+    ? (o.detune.constant === 0 ? null : f(Math.pow(2, o.detune.constant / 12)))
+    : blockDetune(o) ? `${o.id}Ratio` : null;
+  const blockRatios = oscillators.filter(blockDetune);
+  const wavetables = oscillators.map((o, k) => ({ o, k })).filter(({ o }) => o.wavetable);
+  const waveguides = oscillators.map((o, k) => ({ o, k })).filter(({ o }) => o.waveguide);
+  const blockValue = inp => inp.constant !== undefined ? f(inp.constant) : `in.${inp.name}${inp.rate === 'audio' ? '[0]' : ''}`;
+  const tableSource = o => o.table === 'basic'
+    ? 'WavetableRegistry::get().builtin(WavetableRegistry::Builtin::Basic)'
+    : `WavetableRegistry::get().load(${JSON.stringify(o.table)})`;
+
+  const chainTypes = oscillators.map(o => `using ${pascal(o.id)}Chain = ${oscChainType(o)};`);
+
+  const filterControl = filter && filter.cutoff.rate === 'control';
+  const scalar = inp => inp.constant !== undefined ? f(inp.constant) : `in.${inp.name}${filterControl ? '' : '[0]'}`;
+  const perSample = inp => inp.constant !== undefined ? f(inp.constant) : `in.${inp.name}[i]`;
+
+  let filterBlock = '';
+  if (filter) {
+    const keyOct = filter.keyTrack.constant === 0
+      ? '0.0f'
+      : `${scalar(filter.keyTrack)} * (static_cast<float>(note[v]) - 60.0f) * (1.0f / 12.0f)`;
+
+    if (filterControl) {
+      filterBlock = `
+            // ${filter.id}: coefficients once per block, ramped across it (control rate)
+            alignas(16) float hz[4] = {1000.0f, 1000.0f, 1000.0f, 1000.0f};
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int v = base + lane;
+                if (!active[v])
+                    continue;
+${filterEnv ? `                const float env = ${filterEnv.id}[v].advance(n);\n` : ''}                const float octaves = ${keyOct}${filterEnv ? ` + ${scalar(filter.envAmount)} * env * FILTER_ENV_OCTAVES` : ''};
+                hz[lane] = in.${filter.cutoff.name} * std::exp2(octaves);
+            }
+            setFilterCoefficients(q, SIMD_MM(load_ps)(hz), ${scalar(filter.reso)}, n);
+`;
+    } else {
+      filterBlock = `
+            // ${filter.id}: per-voice pitch offsets; the coefficients follow every sample (audio rate)
+            alignas(16) float keyOctaves[4] = {};
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int v = base + lane;
+                if (!active[v])
+                    continue;
+                keyOctaves[lane] = ${keyOct};
+${filterEnv ? `                ${filterEnv.id}[v].render(filterEnvLevel[lane].data(), n);\n` : ''}            }
+`;
+    }
+  }
+
+  const filterSample = !filter ? '' : (filterControl ? '' : `                alignas(16) float hz[4];
+                for (int lane = 0; lane < 4; ++lane)
+                    hz[lane] = in.${filter.cutoff.name}[i] * std::exp2(keyOctaves[lane]${filterEnv ? ` + ${perSample(filter.envAmount)} * filterEnvLevel[lane][i] * FILTER_ENV_OCTAVES` : ''});
+                setFilterCoefficients(q, SIMD_MM(load_ps)(hz), ${perSample(filter.reso)}, 0);
+`) + `                auto x = filters[q].process(SIMD_MM(load_ps)(mix[i]), signals, i);`;
+
+  const moduleList = [
+    ...oscillators.map(o => ` *   ${o.id.padEnd(10)} ${o.wavetable ? `WavetableOscillator, table ${o.table}${o.position.param ? ` morphed by ${o.position.param.id}` : ''}` : o.waveguide ? `WaveguideString, ${o.excitation === 'bow' ? 'bowed' : 'plucked'}, loss set per block` : `DPWOscillator, ${o.shape.replace('OscShape::', '').toLowerCase()}`}${o.drive ? `, into a soft clip (${o.drive.param ? o.drive.param.id : 'fixed'})` : ''}`),
+    filter ? ` *   ${filter.id.padEnd(10)} CytomicSVF ${filter.mode.toLowerCase()} x${filter.stages} (${filter.modeName}), four voices per register, ${filter.cutoff.rate} rate` : null,
+    ` *   ${graph.ampEnv.id.padEnd(10)} ADSREnvelope -> amp, every sample`,
+    filterEnv ? ` *   ${filterEnv.id.padEnd(10)} ADSREnvelope -> ${filter.id} cutoff, ${filter.cutoff.rate === 'control' ? 'once per block' : 'every sample'}` : null
+  ].filter(Boolean).join('\n');
+
+  return `/**
  * @file Voice.h
- * @brief ${spec.meta.name} - Single voice implementation
+ * @brief ${spec.meta.name} - voice bank specialized to its module graph
  * @generated from synth-spec.json - DO NOT EDIT MANUALLY
  *
  * Synthesis Type: ${spec.meta.type}
  * Inspiration: ${spec.meta.inspiration?.join(', ') || 'Original'}
+ *
+ * Module graph (fixed at generation time):
+${moduleList}
+ *
+ * The oscillator chains and the filter stages are DspGraph types
+ * (DspGraph.h), so each voice's chain compiles to one inlined loop body.
+ * Per-voice fields are SoA, one array each, indexed by voice. Voices
+ * render in groups of four, one SIMD lane each, in blocks of BLOCK_SIZE
+ * samples: each voice runs its source graph into its lane, the filter
+ * graph steps all four lanes at once, and the amp envelope scales the
+ * lanes before they're summed. Groups with no sounding voice are skipped.
+ *
+ * Engine-wide inputs (smoothed parameters, the LFO) arrive once per block
+ * in BlockInputs: per sample for audio-rate targets, as the block-end
+ * value for control-rate ones, which the bank ramps (ControlRate.h).
  */
 
 #pragma once
 
-#include <cmath>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 
-// SST Library Includes (auto-generated from spec)
-${includes.map(inc => `#include "${inc}"`).join('\n')}
+#include "ADSREnvelope.h"
+#include "ControlRate.h"
+#include "DspGraph.h"
+#include "GraphModules.h"
+#include "sst/basic-blocks/dsp/FastMath.h"
 
-class ${className}
+/** Engine-wide values for one block (see SynthEngine::renderControlBlock) */
+struct BlockInputs
 {
-public:
-    static constexpr int BLOCK_SIZE = 32;
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
 
-    ${className}() = default;
-    ~${className}() = default;
+${inputFields.length ? inputFields.join('\n') : '    // No engine-wide inputs'}
+};
+
+/** What the voice graphs read, per sample of the block */
+struct VoiceSignals
+{
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
 
+${signals.length ? signals.map(i => `    std::array<float, BLOCK_SIZE> ${i.name}{};`).join('\n') : '    // The graphs read no signals'}
+};
+
+// Module graph: one chain per oscillator, summed${filter ? `; ${filter.id}'s stages in series` : ''}
+${chainTypes.join('\n')}
+using SourceGraph = DspGraph::Sum<${oscillators.map(o => `${pascal(o.id)}Chain`).join(', ')}>;
+${filter ? `using FilterGraph = DspGraph::Serial<${Array(filter.stages).fill('GraphModules::SvfStage').join(', ')}>;\n` : ''}
+template <int MaxVoices>
+class VoiceBank
+{
+public:
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
+    static constexpr int QUADS = (MaxVoices + 3) / 4;
+    static constexpr int LANES = QUADS * 4;
+${filter ? `
+    /** Full-scale filter envelope sweep, in octaves */
+    static constexpr float FILTER_ENV_OCTAVES = 5.0f;
+` : ''}
     void prepare(double sampleRate)
     {
-        this->sampleRate = sampleRate;
+        this->sampleRate = static_cast<float>(sampleRate);
+${wavetables.map(({ o }) => `        const auto ${o.id}Table = ${tableSource(o)};  // Shared by every voice
+`).join('')}        for (int v = 0; v < LANES; ++v)
+        {
+            DspGraph::prepare(sources[v], sampleRate);
+${wavetables.map(({ o, k }) => `            DspGraph::node<${k}, 0>(sources[v]).setTable(${o.id}Table);
+`).join('')}            ${graph.ampEnv.id}[v].setSampleRate(this->sampleRate);
+${filterEnv ? `            ${filterEnv.id}[v].setSampleRate(this->sampleRate);\n` : ''}            kill(v);
+        }
+${filter ? `        for (auto& f : filters)
+            DspGraph::reset(f);
+` : ''}${signals.filter(i => i.rate === 'control').map(i => `        ${i.name}Ramp.reset(${f(i.param.default)});\n`).join('')}    }
 
-        // Initialize oscillators
-${spec.voice.oscillators.map(osc => `        ${osc.id}.init();`).join('\n')}
+    //==========================================================================
+    // Notes
+    //==========================================================================
 
-        // Initialize filters
-${spec.voice.filters?.map(f => `        ${f.id}.init();`) .join('\n') || '        // No filters'}
+    void noteOn(int v, int midiNote, float vel)
+    {
+        if (!active[v])
+            DspGraph::reset(sources[v]);
+        active[v] = true;
+        note[v] = midiNote;
+        velocity[v] = vel;
+        noteHz[v] = 440.0f * std::exp2((static_cast<float>(midiNote) - 69.0f) * (1.0f / 12.0f));
+        ${graph.ampEnv.id}[v].trigger();
+${filterEnv ? `        ${filterEnv.id}[v].trigger();\n` : ''}${filter ? '        snapFilter[v / 4] = true;\n' : ''}${waveguides.map(({ k }) => `        DspGraph::node<${k}, 0>(sources[v]).excite(vel);\n`).join('')}    }
+
+    void noteOff(int v)
+    {
+        ${graph.ampEnv.id}[v].release();
+${waveguides.map(({ k }) => `        DspGraph::node<${k}, 0>(sources[v]).release();\n`).join('')}${filterEnv ? `        ${filterEnv.id}[v].release();\n` : ''}    }
+
+    void kill(int v)
+    {
+        active[v] = false;
+        ${graph.ampEnv.id}[v].reset();
+${filterEnv ? `        ${filterEnv.id}[v].reset();\n` : ''}    }
 
-        // Initialize envelopes
-${spec.voice.envelopes.map(env => `        ${env.id}.setSampleRate(sampleRate);`).join('\n')}
+    bool isActive(int v) const { return active[v]; }
+    float getLevel(int v) const { return ${graph.ampEnv.id}[v].getLevel() * velocity[v]; }
 
-        // Initialize LFOs
-${spec.voice.lfos?.map(lfo => `        ${lfo.id}.setSampleRate(sampleRate);`).join('\n') || '        // No LFOs'}
-    }
+    //==========================================================================
+    // Envelopes (all voices)
+    //==========================================================================
 
-    void noteOn(int note, float vel)
+    void setAmpEnvelope(float a, float d, float s, float r)
+    {
+        for (auto& env : ${graph.ampEnv.id})
+            env.setADSR(a, d, s, r);
+    }
+${filterEnv ? `
+    void setFilterEnvelope(float a, float d, float s, float r)
+    {
+        for (auto& env : ${filterEnv.id})
+            env.setADSR(a, d, s, r);
+    }
+` : ''}
+    //==========================================================================
+    // Rendering
+    //==========================================================================
+
+    /**
+     * @brief Add n (<= BLOCK_SIZE) samples of every sounding voice to out
+     * @param finished Called with each voice whose release ended
+     */
+    template <typename Finished>
+    void renderBlock(const BlockInputs& in, float* out, int n, Finished&& finished)
     {
-        currentNote = note;
-        velocity = vel;
-        active = true;
-        releasing = false;
-        age = 0;
+${signals.length ? `        // The graphs' signals: audio-rate inputs as they come, control-rate ones ramped
+${signals.map(i => i.rate === 'audio'
+    ? `        std::copy(in.${i.name}.begin(), in.${i.name}.begin() + n, signals.${i.name}.begin());`
+    : `        ${i.name}Ramp.setTarget(in.${i.name}, n);
+        for (int i = 0; i < n; ++i)
+            signals.${i.name}[i] = ${i.name}Ramp.next();`).join('\n')}
 
-        float frequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+` : ''}${blockRatios.length ? `        // Control-rate detune: one ratio per block
+${blockRatios.map(o => `        const float ${o.id}Ratio = std::exp2(in.${o.detune.name}${o.detune.rate === 'audio' ? '[0]' : ''} * (1.0f / 12.0f));`).join('\n')}
 
-        // Set oscillator frequencies
-${spec.voice.oscillators.map(osc => `        ${osc.id}.setFrequency(frequency, sampleRate);`).join('\n')}
+` : ''}        for (int q = 0; q < QUADS; ++q)
+        {
+            const int base = q * 4;
+            if (!(active[base] || active[base + 1] || active[base + 2] || active[base + 3]))
+                continue;
+
+            // Source graph and amp envelope, voice by voice into its lane
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int v = base + lane;
+                if (!active[v])
+                {
+                    for (int i = 0; i < n; ++i)
+                        mix[i][lane] = amp[i][lane] = 0.0f;
+                    continue;
+                }
+
+                auto& source = sources[v];
+${waveguides.map(({ o, k }) => `                DspGraph::node<${k}, 0>(source).setLoss(${blockValue(o.decay)}, ${blockValue(o.brightness)});\n`).join('')}${oscillators.map((o, k) => `                DspGraph::node<${k}, 0>(source).setFrequency(noteHz[v]${detuneRatio(o) ? ` * ${detuneRatio(o)}` : ''});`).join('\n')}
+                for (int i = 0; i < n; ++i)
+                    mix[i][lane] = source.process(0.0f, signals, i);
+
+                ${graph.ampEnv.id}[v].render(envBuffer.data(), n);
+                for (int i = 0; i < n; ++i)
+                    amp[i][lane] = envBuffer[i] * velocity[v];
+            }
+${filterBlock}
+            // ${filter ? 'Filter graph and amp' : 'Amp'}, four voices at a time, then summed
+            for (int i = 0; i < n; ++i)
+            {
+${filter ? filterSample : '                auto x = SIMD_MM(load_ps)(mix[i]);'}
+                x = SIMD_MM(mul_ps)(x, SIMD_MM(load_ps)(amp[i]));
+                alignas(16) float lanes[4];
+                SIMD_MM(store_ps)(lanes, x);
+                out[i] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
 
-        // Trigger envelopes
-${spec.voice.envelopes.map(env => `        ${env.id}.attack();`).join('\n')}
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const int v = base + lane;
+                if (active[v] && !${graph.ampEnv.id}[v].isActive())
+                {
+                    active[v] = false;
+                    finished(v);
+                }
+            }
+        }
     }
 
-    void noteOff()
+private:
+${filter ? `    /**
+     * @brief Point group q's filter stages at four cutoffs
+     * @param rampSamples Ramp from the current coefficients over this many
+     *                    samples; 0 jumps (per-sample updates, new notes)
+     */
+    void setFilterCoefficients(int q, SIMD_M128 hz, float resonance, int rampSamples)
+    {
+        auto& svf = DspGraph::node<0>(filters[q]).svf;
+        const auto a1 = svf.a1, a2 = svf.a2, a3 = svf.a3;
+
+        const auto normalised = SIMD_MM(min_ps)(SIMD_MM(max_ps)(SIMD_MM(mul_ps)(hz, SIMD_MM(set1_ps)(1.0f / sampleRate)),
+                                                                SIMD_MM(set1_ps)(0.0f)),
+                                                SIMD_MM(set1_ps)(0.499f));
+        svf.g = sst::basic_blocks::dsp::fasttanSSE(SIMD_MM(mul_ps)(normalised, SIMD_MM(set1_ps)(3.14159265f)));
+        svf.k = SIMD_MM(set1_ps)(2.0f - 2.0f * std::clamp(resonance, 0.0f, 0.98f));
+        svf.setCoeffPostGK(sst::filters::CytomicSVF::Mode::${filter.mode}, SIMD_MM(set1_ps)(1.0f));
+
+        if (rampSamples > 0 && !snapFilter[q])
+        {
+            const auto perSample = SIMD_MM(set1_ps)(1.0f / static_cast<float>(rampSamples));
+            svf.da1 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(svf.a1, a1), perSample);
+            svf.da2 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(svf.a2, a2), perSample);
+            svf.da3 = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(svf.a3, a3), perSample);
+            svf.a1 = a1;
+            svf.a2 = a2;
+            svf.a3 = a3;
+        }
+        else
+        {
+            svf.da1 = svf.da2 = svf.da3 = SIMD_MM(setzero_ps)();
+        }
+        snapFilter[q] = false;
+${Array.from({ length: filter.stages - 1 }, (_, s) => `        DspGraph::node<${s + 1}>(filters[q]).svf.fetchCoeffs(svf);`).join('\n')}${filter.stages > 1 ? '\n' : ''}    }
+
+` : ''}    float sampleRate = 44100.0f;
+
+    // Per-voice fields, one array each
+    std::array<bool, LANES> active{};
+    std::array<int, LANES> note{};
+    std::array<float, LANES> velocity{};
+    std::array<float, LANES> noteHz{};
+
+    // Module state: a source graph per voice, a filter graph per group of four
+    std::array<SourceGraph, LANES> sources;
+    std::array<ADSREnvelope, LANES> ${graph.ampEnv.id};
+${filterEnv ? `    std::array<ADSREnvelope, LANES> ${filterEnv.id};\n` : ''}${filter ? `    std::array<FilterGraph, QUADS> filters;
+    std::array<bool, QUADS> snapFilter{};  // A new note: jump to the coefficients, don't ramp
+` : ''}
+    // Block scratch, sized at compile time: sample-major, so one load takes a sample of all four lanes
+    VoiceSignals signals;
+    alignas(16) float mix[BLOCK_SIZE][4] = {};
+    alignas(16) float amp[BLOCK_SIZE][4] = {};
+    std::array<float, BLOCK_SIZE> envBuffer{};
+${filterEnv && !filterControl ? '    std::array<std::array<float, BLOCK_SIZE>, 4> filterEnvLevel{};\n' : ''}${signals.filter(i => i.rate === 'control').map(i => `    ControlRamp ${i.name}Ramp;\n`).join('')}};
+`;
+}
+
+//==============================================================================
+// SynthEngine.h
+//==============================================================================
+
+function generateSynthEngineH(spec, graph) {
+  const { inputs, lfo, master } = graph;
+  // Smoother lanes only for what the engine reads while rendering
+  const read = new Set([...inputs.map(i => i.param.id), master?.id, lfo?.depth?.id].filter(Boolean));
+  const smoothed = spec.parameters.filter(p => smoothingMs(p) > 0 && read.has(p.id));
+  const lane = id => `Smooth${pascal(id)}`;
+  const isSmoothed = p => smoothed.some(s => s.id === p.id);
+  const value = p => isSmoothed(p) ? `smoothers.getValue(${lane(p.id)})` : `values[k${pascal(p.id)}]`;
+
+  const lfoAudio = lfo && lfo.target.rate === 'audio';
+  const lfoDepth = lfo ? (lfo.depth ? value(lfo.depth) : '1.0f') : '';
+
+  // How the LFO moves its target: octaves for a cutoff, else half the range either side
+  const lfoApply = (inp, v, l) => inp.kind === 'cutoff'
+    ? `${v} * std::exp2(${l} * LFO_OCTAVES)`
+    : `std::clamp(${v} + ${l} * ${f((inp.param.max - inp.param.min) * 0.5)}, ${f(inp.param.min)}, ${f(inp.param.max)})`;
+
+  const audioInputs = inputs.filter(i => i.rate === 'audio');
+  const controlInputs = inputs.filter(i => i.rate === 'control');
+
+  const fillAudio = audioInputs.map(i => {
+    const fill = isSmoothed(i.param)
+      ? `        smoothers.renderRamp(${lane(i.param.id)}, inputs.${i.name}.data(), n);`
+      : `        std::fill(inputs.${i.name}.begin(), inputs.${i.name}.begin() + n, values[k${pascal(i.param.id)}]);`;
+    if (i.lfo !== lfo || !lfo) return fill;
+    return `${fill}
+        for (int i = 0; i < n; ++i)
+            ${i.kind === 'cutoff' ? `inputs.${i.name}[i] *= std::exp2(lfoBuffer[i] * LFO_OCTAVES)` : `inputs.${i.name}[i] = ${lfoApply(i, `inputs.${i.name}[i]`, 'lfoBuffer[i]')}`};`;
+  });
+  const fillControl = controlInputs.map(i => {
+    const v = value(i.param);
+    return `        inputs.${i.name} = ${lfo && i.lfo === lfo ? lfoApply(i, v, 'lfoValue') : v};`;
+  });
+
+  const envSetter = (env, setter) => {
+    if (!env) return '';
+    const stage = s => env[s].param ? `values[k${pascal(env[s].param.id)}]` : f(env[s].constant);
+    return `        bank.${setter}(${['attack', 'decay', 'sustain', 'release'].map(stage).join(', ')});`;
+  };
+  const envParams = env => env ? ['attack', 'decay', 'sustain', 'release'].filter(s => env[s].param).map(s => env[s].param) : [];
+
+  const masterGain = master
+    ? (master.unit === 'dB' ? `std::pow(10.0f, v * 0.05f)` : 'v')
+    : null;
+
+  const notes = [
+    ...graph.warnings.map(w => ` *   - ${w}`),
+    ...(graph.unused.length ? [` *   - parameters not wired: ${graph.unused.join(', ')}`] : [])
+  ];
+
+  return `/**
+ * @file SynthEngine.h
+ * @brief ${spec.meta.name} engine: voice allocation, parameters, engine-wide modulation
+ * @generated from synth-spec.json - DO NOT EDIT MANUALLY
+ *
+ * Renders in ControlRamp::BLOCK_SIZE sub-blocks. Each one advances the
+ * parameter smoothers${lfo ? ` and ${lfo.id}` : ''}, fills BlockInputs (per sample for
+ * audio-rate targets, once for control-rate ones) and hands it to the
+ * voice bank. Notes and parameters apply at the start of renderBlock().
+ *
+ * processBlock():
+ *
+ *   params.update();
+ *   engine.applySnapshot(params);
+ *   engine.renderBlock(left, right, numSamples);
+${notes.length ? ` *
+ * Not generated from the spec:
+${notes.join('\n')}
+` : ''} */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "ParamSmoother.h"
+#include "SynthParams.h"
+#include "Voice.h"
+#include "VoiceAllocator.h"
+
+class SynthEngine
+{
+public:
+    static constexpr int MAX_VOICES = ${graph.voices};
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
+${lfo ? `
+    /** ${lfo.id} at full depth, in octaves of cutoff */
+    static constexpr float LFO_OCTAVES = 2.0f;
+` : ''}
+    SynthEngine()
     {
-        releasing = true;
+        for (int id = 0; id < kNumParams; ++id)
+            values[id] = kParamInfo[id].defaultValue;
+${smoothed.length ? `        for (int lane = 0; lane < NUM_SMOOTHED; ++lane)
+            smoothers.setRampTime(lane, kParamInfo[kSmoothedParams[lane]].smoothingMs);
+` : ''}    }
 
-        // Release envelopes
-${spec.voice.envelopes.map(env => `        ${env.id}.release();`).join('\n')}
+    void prepare(double sampleRate, int maxBlockSize)
+    {
+        this->sampleRate = sampleRate;
+        mix.assign(static_cast<size_t>(std::max(maxBlockSize, BLOCK_SIZE)), 0.0f);
+${smoothed.length ? '        smoothers.prepare(sampleRate);\n' : ''}        bank.prepare(sampleRate);
+        allocator.reset();
+        for (int id = 0; id < kNumParams; ++id)
+            setParameter(id, values[id]);
+${smoothed.length ? `        for (int lane = 0; lane < NUM_SMOOTHED; ++lane)
+            smoothers.reset(lane, values[static_cast<size_t>(kSmoothedParams[lane])]);
+` : ''}    }
+
+    //==========================================================================
+    // Notes
+    //==========================================================================
+
+    void noteOn(int note, float velocity)
+    {
+        const auto a = allocator.noteOn(note, [this](int v) { return bank.getLevel(v); });
+        if (a.stolen)
+            bank.kill(a.voice);
+        bank.noteOn(a.voice, note, velocity);
     }
 
-    void kill()
+    void noteOff(int note)
     {
-        active = false;
-        releasing = false;
-        currentNote = -1;
+        allocator.noteOff(note, [this](int v) { bank.noteOff(v); });
     }
 
-    void render(float* outputL, float* outputR, int numSamples)
+    void allNotesOff()
     {
-        if (!active)
-            return;
+        for (int note = 0; note < 128; ++note)
+            noteOff(note);
+    }
 
-        ++age;
+    //==========================================================================
+    // Parameters
+    //==========================================================================
 
-        int samplesRemaining = numSamples;
-        int offset = 0;
+    /** Apply one block's parameters, only those that moved */
+    void applySnapshot(const SynthParams& p)
+    {
+        for (int id = 0; id < kNumParams; ++id)
+            if (p.changed(id))
+                setParameter(id, p[id]);
+    }
 
-        while (samplesRemaining > 0)
+    /** Set one parameter (its plain value, in its own range) */
+    void setParameter(int id, float v)
+    {
+        v = std::clamp(v, kParamInfo[id].min, kParamInfo[id].max);
+        values[id] = v;
+${smoothed.length ? `        if (const int lane = smoothLane(id); lane >= 0)
+            smoothers.setTarget(lane, v);
+` : ''}
+        switch (id)
         {
-            int blockSize = std::min(samplesRemaining, BLOCK_SIZE);
-            renderBlock(outputL + offset, outputR + offset, blockSize);
-            offset += blockSize;
-            samplesRemaining -= blockSize;
+${[...new Set(envParams(graph.ampEnv).map(p => p.id))].map(id => `        case k${pascal(id)}:`).join('\n')}${envParams(graph.ampEnv).length ? `
+${envSetter(graph.ampEnv, 'setAmpEnvelope').replace(/^ {8}/, '            ')}
+            break;` : ''}${graph.filterEnv && envParams(graph.filterEnv).length ? `
+${envParams(graph.filterEnv).map(p => `        case k${pascal(p.id)}:`).join('\n')}
+${envSetter(graph.filterEnv, 'setFilterEnvelope').replace(/^ {8}/, '            ')}
+            break;` : ''}${lfo && lfo.rate ? `
+        case k${pascal(lfo.rate.id)}:
+            lfoPhase.increment = static_cast<float>(v / sampleRate);
+            break;` : ''}
+        default:
+            break;
         }
     }
 
-    bool isActive() const { return active; }
-    bool isReleasing() const { return releasing; }
-    int getNote() const { return currentNote; }
-    float getVelocity() const { return velocity; }
-    int getAge() const { return age; }
+    float getParameter(int id) const { return values[id]; }
 
-    // Parameter setters (generated from spec)
-${spec.parameters.map(p => `    void set_${p.id}(float v) { param_${p.id} = v; }`).join('\n')}
+    //==========================================================================
+    // Rendering
+    //==========================================================================
 
-private:
-    void renderBlock(float* outputL, float* outputR, int blockSize)
+    void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        for (int i = 0; i < blockSize; ++i)
-        {
-            // Process envelopes
-${spec.voice.envelopes.map(env => `            float ${env.id}_out = ${env.id}.process();`).join('\n')}
+        std::fill(mix.begin(), mix.begin() + numSamples, 0.0f);
+        for (int start = 0; start < numSamples; start += BLOCK_SIZE)
+            renderControlBlock(mix.data() + start, std::min(BLOCK_SIZE, numSamples - start));
 
-            // Check if voice finished
-            if (env1_out <= 0.0001f && releasing)
-            {
-                active = false;
-                return;
-            }
+        for (int i = 0; i < numSamples; ++i)
+            outputL[i] = outputR[i] = mix[i];
+    }
 
-            // Mix oscillators
-            float oscMix = 0.0f;
-${spec.voice.oscillators.map(osc => {
-  const levelParam = spec.parameters.find(p => p.id === `${osc.id}_level`);
-  if (levelParam) {
-    return `            oscMix += ${osc.id}.step() * param_${osc.id}_level;`;
-  }
-  return `            oscMix += ${osc.id}.step();`;
-}).join('\n')}
+    int getActiveVoiceCount() const
+    {
+        int count = 0;
+        for (int v = 0; v < MAX_VOICES; ++v)
+            count += bank.isActive(v) ? 1 : 0;
+        return count;
+    }
 
-${spec.voice.filters?.length > 0 ? `
-            // Process filter
-            float filterOut = ${spec.voice.filters[0].id}.process(oscMix);
-` : `            float filterOut = oscMix;`}
+private:
+${smoothed.length ? `    // Smoothed parameters: one ParamSmoother lane each
+    enum SmoothLane : int
+    {
+${smoothed.map(p => `        ${lane(p.id)},`).join('\n')}
+        NUM_SMOOTHED
+    };
 
-            // Apply amp envelope and velocity
-            float output = filterOut * env1_out * velocity;
+    static constexpr int kSmoothedParams[NUM_SMOOTHED] = {
+${smoothed.map(p => `        k${pascal(p.id)},`).join('\n')}
+    };
 
-            outputL[i] += output;
-            outputR[i] += output;
-        }
+    static int smoothLane(int id)
+    {
+        for (int lane = 0; lane < NUM_SMOOTHED; ++lane)
+            if (kSmoothedParams[lane] == id)
+                return lane;
+        return -1;
     }
 
-    // Voice state
-    bool active = false;
-    bool releasing = false;
-    int currentNote = -1;
-    float velocity = 0.0f;
-    int age = 0;
+` : ''}    /** One sub-block of at most BLOCK_SIZE samples */
+    void renderControlBlock(float* out, int n)
+    {
+${lfo ? (lfoAudio ? `        // ${lfo.id} (${lfo.shapeName}) every sample: it drives an audio-rate target
+        const float depth = ${lfoDepth};
+        for (int i = 0; i < n; ++i)
+        {
+            const float p = lfoPhase.next();
+            lfoBuffer[i] = depth * ${lfo.shape};
+        }
+
+` : `        // ${lfo.id} (${lfo.shapeName}) at the block end: it drives a control-rate target
+        lfoPhase.phase += lfoPhase.increment * static_cast<float>(n);
+        lfoPhase.phase -= std::floor(lfoPhase.phase);
+        const float lfoValue = [p = lfoPhase.phase] { return ${lfo.shape}; }() * ${lfoDepth};
+
+`) : ''}${fillAudio.length ? `        // Audio-rate inputs, per sample from this block's start
+${fillAudio.join('\n')}
+
+` : ''}${smoothed.length ? '        smoothers.advance(n);\n\n' : ''}${fillControl.length ? `        // Control-rate inputs: the block-end value, ramped by the voices
+${fillControl.join('\n')}
+
+` : ''}        bank.renderBlock(inputs, out, n, [this](int v) { allocator.voiceFinished(v); });
+${master ? `
+        // ${master.name}
+${isSmoothed(master) ? `        smoothers.renderRamp(${lane(master.id)}, gainBuffer.data(), n);
+        for (int i = 0; i < n; ++i)
+            out[i] *= ${masterGain.replace(/\bv\b/g, 'gainBuffer[i]')};` : `        const float v = values[k${pascal(master.id)}];
+        for (int i = 0; i < n; ++i)
+            out[i] *= ${masterGain};`}
+` : ''}    }
+
     double sampleRate = 44100.0;
 
-    // SST Components (generated from spec)
-${spec.voice.oscillators.map(osc => `    ${SST_NAMESPACES[osc.sst] || osc.sst} ${osc.id};`).join('\n')}
-${spec.voice.filters?.map(f => `    ${SST_NAMESPACES[f.sst] || f.sst} ${f.id};`).join('\n') || ''}
-${spec.voice.envelopes.map(env => `    ${SST_NAMESPACES.ADSREnvelope} ${env.id};`).join('\n')}
-${spec.voice.lfos?.map(lfo => `    ${SST_NAMESPACES.SimpleLFO} ${lfo.id};`).join('\n') || ''}
+    ${'VoiceBank<MAX_VOICES>'} bank;
+    VoiceAllocator<MAX_VOICES> allocator;
+    BlockInputs inputs;
 
-    // Parameters (generated from spec)
-${spec.parameters.map(p => `    float param_${p.id} = ${p.default}f;`).join('\n')}
+    std::array<float, kNumParams> values{};
+${smoothed.length ? '    ParamSmoother<NUM_SMOOTHED> smoothers;\n' : ''}${lfo ? `    OscPhase lfoPhase;\n${lfoAudio ? '    std::array<float, BLOCK_SIZE> lfoBuffer{};\n' : ''}` : ''}${master && isSmoothed(master) ? '    std::array<float, BLOCK_SIZE> gainBuffer{};\n' : ''}
+    std::vector<float> mix;  // Mono voice sum, sized in prepare()
 };
 `;
-
-  return code;
 }
 
+//==============================================================================
+// UI and JUCE parameters
+//==============================================================================
+
 function generateParametersTS(spec) {
   let code = `/**
  * @file parameters.ts
@@ -273,6 +1186,8 @@ export interface Parameter {
   unit: string;
   scale: 'linear' | 'log' | 'exp' | 'discrete';
   category: string;
+  smoothingMs: number;
+  modRate: 'audio' | 'control';
   cc?: number;
 }
 
@@ -285,7 +1200,9 @@ ${spec.parameters.map(p => `  ${p.id}: {
     default: ${p.default},
     unit: '${p.unit || ''}',
     scale: '${p.scale || 'linear'}',
-    category: '${p.category}'${p.cc ? `,\n    cc: ${p.cc}` : ''}
+    category: '${p.category}',
+    smoothingMs: ${smoothingMs(p)},
+    modRate: '${modRate(p)}'${p.cc ? `,\n    cc: ${p.cc}` : ''}
   }`).join(',\n')}
 };
 
@@ -342,11 +1259,21 @@ ${spec.parameters.map(p => {
 function main() {
   const args = process.argv.slice(2);
 
-  if (args.length < 2) {
-    console.log('Usage: node generate-from-spec.js <spec.json> <output-dir>');
+  let shootoutPath = null;
+  const costsAt = args.indexOf('--costs');
+  if (costsAt >= 0) {
+    shootoutPath = args[costsAt + 1];
+    args.splice(costsAt, 2);
+  }
+
+  if (args.length < 2 || (costsAt >= 0 && !shootoutPath)) {
+    console.log('Usage: node generate-from-spec.js <spec.json> <output-dir> [--costs shootout_sst.json]');
     console.log('');
     console.log('Generates:');
+    console.log('  - source/dsp/SynthParams.h');
+    console.log('  - source/dsp/DspFeatures.h');
     console.log('  - source/dsp/Voice.h');
+    console.log('  - source/dsp/SynthEngine.h');
     console.log('  - source/Parameters.h');
     console.log('  - ui/src/types/parameters.ts');
     process.exit(1);
@@ -358,6 +1285,18 @@ function main() {
   const spec = loadSpec(specPath);
 
   console.log(`Generating code for ${spec.meta.name}...`);
+  let graph;
+  let budget;
+  try {
+    graph = buildGraph(spec);
+    budget = checkBudget(spec, graph, shootoutPath);
+  } catch (e) {
+    console.error(`Error: ${e.message}`);
+    process.exit(1);
+  }
+  graph.warnings.forEach(w => console.warn(`  Warning: ${w}`));
+  if (budget)
+    console.log(`  Estimated CPU: ${budget.summary}`);
 
   // Ensure directories exist
   const dirs = [
@@ -368,23 +1307,24 @@ function main() {
   dirs.forEach(dir => fs.mkdirSync(dir, { recursive: true }));
 
   // Generate files
-  const voiceH = generateVoiceH(spec);
-  fs.writeFileSync(path.join(outputDir, 'source', 'dsp', 'Voice.h'), voiceH);
-  console.log('  Generated: source/dsp/Voice.h');
-
-  const paramsH = generateParametersCpp(spec);
-  fs.writeFileSync(path.join(outputDir, 'source', 'Parameters.h'), paramsH);
-  console.log('  Generated: source/Parameters.h');
-
-  const paramsTS = generateParametersTS(spec);
-  fs.writeFileSync(path.join(outputDir, 'ui', 'src', 'types', 'parameters.ts'), paramsTS);
-  console.log('  Generated: ui/src/types/parameters.ts');
+  const outputs = [
+    ['source/dsp/SynthParams.h', generateSynthParamsH(spec)],
+    ['source/dsp/DspFeatures.h', generateDspFeaturesH(spec, graph)],
+    ['source/dsp/Voice.h', generateVoiceH(spec, graph)],
+    ['source/dsp/SynthEngine.h', generateSynthEngineH(spec, graph)],
+    ['source/Parameters.h', generateParametersCpp(spec)],
+    ['ui/src/types/parameters.ts', generateParametersTS(spec)]
+  ];
+  for (const [file, code] of outputs) {
+    fs.writeFileSync(path.join(outputDir, ...file.split('/')), code);
+    console.log(`  Generated: ${file}`);
+  }
 
   console.log('');
   console.log('Code generation complete!');
   console.log('');
   console.log('Next steps:');
-  console.log('  1. Review generated Voice.h and add custom DSP logic');
+  console.log('  1. Wire the spec features listed as not generated (see SynthEngine.h)');
   console.log('  2. Build with: cmake -B build && cmake --build build');
   console.log('  3. Test with: ctest --test-dir build');
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Voice.h"
+#include "MidiEventQueue.h"
 #include <array>
 #include <cmath>
 
@@ -17,7 +18,15 @@
  *   10:    Filter envelope amount (-1 to 1)
  *   11-14: Filter ADSR (attack, decay, sustain, release)
  *   15-18: Amp ADSR (attack, decay, sustain, release)
+ *   19-74: Partial levels 9x through 64x (default 0: culled, free)
  *   127:   Master volume
+ *
+ * Voices read VoiceParams (Voice.h), the parameters already in Hz and
+ * linear gain; setParam() updates the field a change affects.
+ *
+ * Timestamped MIDI (pushEvent) is applied sample-accurately inside the
+ * next renderBlock(): the block is split at each event's offset (see
+ * MidiEventQueue.h in core/dsp).
  */
 class Engine {
 public:
@@ -45,6 +54,8 @@ public:
         AMP_DECAY = 16,
         AMP_SUSTAIN = 17,
         AMP_RELEASE = 18,
+        PARTIAL_9_LEVEL = 19,   // Through partial 64 at 74
+        PARTIAL_64_LEVEL = 74,
         MASTER_VOLUME = 127
     };
 
@@ -78,6 +89,10 @@ public:
 
         params[MASTER_VOLUME] = 0.7f;        // 70% master volume
 
+        for (int id = PARTIAL_1_LEVEL; id <= FILTER_ENV_AMOUNT; id++) {
+            updateVoiceParams(id);
+        }
+
         voiceActive.fill(false);
     }
 
@@ -118,6 +133,7 @@ public:
     void setParam(int id, float value) {
         if (id >= 0 && id < MAX_PARAMS) {
             params[id] = value;
+            updateVoiceParams(id);
 
             // Update all voices if envelope parameters changed
             if (id >= FILTER_ATTACK && id <= AMP_RELEASE) {
@@ -128,6 +144,16 @@ public:
         }
     }
 
+    /**
+     * Schedule an event at its sample offset into the next renderBlock().
+     * Applied right away if the queue is full.
+     */
+    void pushEvent(const MidiEvent& event) {
+        if (!eventQueue.push(event)) {
+            handleEvent(event);
+        }
+    }
+
     float getParam(int id) const {
         if (id >= 0 && id < MAX_PARAMS) {
             return params[id];
@@ -136,6 +162,35 @@ public:
     }
 
     void renderBlock(float* outL, float* outR, int numSamples) {
+        // Render up to each queued event, apply it, and carry on
+        eventQueue.process(numSamples,
+            [this, outL, outR](int start, int count) {
+                renderSpan(outL + start, outR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
+    }
+
+private:
+    void handleEvent(const MidiEvent& event) {
+        switch (event.type) {
+            case MidiEvent::Type::NoteOn:
+                noteOn(event.note, event.value);
+                break;
+            case MidiEvent::Type::NoteOff:
+                noteOff(event.note);
+                break;
+            case MidiEvent::Type::AllNotesOff:
+                for (int i = 0; i < MAX_VOICES; i++) {
+                    if (voiceActive[i]) voices[i].noteOff();
+                }
+                break;
+            default:
+                // No pitch bend, pressure or slide yet (see pitchBend())
+                break;
+        }
+    }
+
+    void renderSpan(float* outL, float* outR, int numSamples) {
         // Clear output buffers
         for (int i = 0; i < numSamples; i++) {
             outL[i] = 0.0f;
@@ -151,7 +206,7 @@ public:
 
             if (voiceActive[v]) {
                 for (int i = 0; i < numSamples; i++) {
-                    float sample = voices[v].process(params);
+                    float sample = voices[v].process(voiceParams);
                     outL[i] += sample;
                     outR[i] += sample;
                 }
@@ -166,7 +221,33 @@ public:
         }
     }
 
-private:
+    /** Re-derive the VoiceParams field parameter id feeds */
+    void updateVoiceParams(int id) {
+        if (id >= PARTIAL_1_LEVEL && id <= PARTIAL_8_LEVEL) {
+            voiceParams.partialGains[id - PARTIAL_1_LEVEL] = params[id] * 0.25f;  // Conservative scaling
+            voiceParams.partialsRevision++;
+            return;
+        }
+        if (id >= PARTIAL_9_LEVEL && id <= PARTIAL_64_LEVEL) {
+            voiceParams.partialGains[id - PARTIAL_9_LEVEL + 8] = params[id] * 0.25f;
+            voiceParams.partialsRevision++;
+            return;
+        }
+        switch (id) {
+            case FILTER_CUTOFF:
+                voiceParams.cutoffHz = 20.0f * std::pow(1000.0f, params[FILTER_CUTOFF]);
+                break;
+            case FILTER_RESONANCE:
+                voiceParams.resonance = params[FILTER_RESONANCE];
+                break;
+            case FILTER_ENV_AMOUNT:
+                voiceParams.envAmountHz = params[FILTER_ENV_AMOUNT] * 10000.0f;
+                break;
+            default:
+                break;
+        }
+    }
+
     void updateVoiceEnvelopes(Voice& voice) {
         // Update filter envelope
         voice.setFilterEnvelope(
@@ -189,4 +270,6 @@ private:
     std::array<Voice, MAX_VOICES> voices;
     std::array<bool, MAX_VOICES> voiceActive;
     std::array<float, MAX_PARAMS> params;
+    VoiceParams voiceParams;
+    MidiEventQueue eventQueue;
 };
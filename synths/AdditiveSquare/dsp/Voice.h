@@ -1,41 +1,56 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+
+#include "AdditiveBank.h"
 
 // SST Library includes
-#include "sst/basic-blocks/dsp/PulseOscillator.h"
 #include "sst/basic-blocks/modulators/ADSREnvelope.h"
 #include "sst/filters/VintageLadder.h"
 
+/**
+ * Voice parameters in the units the DSP uses, shared by all voices.
+ * Engine::setParam works them out when a value changes, so process()
+ * does no pow() or mapping per sample.
+ */
+struct VoiceParams {
+    static constexpr int NUM_PARTIALS = 64;
+
+    std::array<float, NUM_PARTIALS> partialGains{};  // Partial levels, normalisation folded in
+    uint32_t partialsRevision = 0;                   // Bumped when partialGains change
+    float cutoffHz = 632.0f;       // 20 Hz - 20 kHz (exponential)
+    float resonance = 0.3f;
+    float envAmountHz = 5000.0f;   // Full-scale filter envelope sweep (+/- 10 kHz)
+};
+
 /**
  * Single voice for Additive Square synthesizer
  *
  * Architecture:
- *   8 Square Wave Oscillators (1x, 2x, 3x, 4x, 5x, 6x, 7x, 8x fundamental)
- *   → SUM (with individual levels)
+ *   Up to 64 square-wave partials (1x, 2x, 3x, ... fundamental), summed
+ *   with individual levels in an AdditiveBank (silent and above-Nyquist
+ *   partials culled, the rest run eight at a time)
  *   → Vintage Ladder Filter
  *   → Amp Envelope
  *   → Output
  *
  * Uses SST libraries:
- * - sst::basic_blocks::dsp::PulseOscillator (square waves)
  * - sst::filters::VintageLadder (Moog-style filter)
  * - sst::basic_blocks::modulators::ADSREnvelope (envelopes)
  */
 class Voice {
 public:
-    static constexpr int NUM_PARTIALS = 8;
+    static constexpr int NUM_PARTIALS = VoiceParams::NUM_PARTIALS;
 
     Voice() = default;
 
     void init(float sr) {
         sampleRate = sr;
 
-        // Initialize all 8 square wave oscillators
-        for (int i = 0; i < NUM_PARTIALS; i++) {
-            partials[i].init();
-        }
+        bank.prepare(sr);
 
         // Initialize filter
         filter.init(sr);
@@ -47,6 +62,9 @@ public:
     }
 
     void noteOn(int midiNote, float vel) {
+        if (!active()) {
+            bank.reset();
+        }
         note = midiNote;
         velocity = vel;
         isActive = true;
@@ -54,11 +72,8 @@ public:
         // Convert MIDI note to frequency
         frequency = 440.0f * std::pow(2.0f, (midiNote - 69) / 12.0f);
 
-        // Set frequencies for all partials (1x, 2x, 3x, ... 8x fundamental)
-        for (int i = 0; i < NUM_PARTIALS; i++) {
-            float partialFreq = frequency * (i + 1);  // Integer multiples
-            partials[i].setRate(partialFreq / sampleRate);
-        }
+        // Partials at integer multiples; those above Nyquist drop out
+        bank.setFrequency(frequency);
 
         // Trigger envelopes
         filterEnv.attack();
@@ -80,41 +95,29 @@ public:
         return isActive && !ampEnv.isComplete();
     }
 
-    float process(const std::array<float, 128>& params) {
+    float process(const VoiceParams& params) {
         if (!active()) {
             isActive = false;
             return 0.0f;
         }
 
-        // Generate all 8 partials and sum with individual levels
-        float summed = 0.0f;
-        for (int i = 0; i < NUM_PARTIALS; i++) {
-            float level = params[i];  // params 0-7 are partial levels
-            float partialSample = partials[i].value();  // Get square wave sample
-            summed += partialSample * level;
-            partials[i].step();  // Advance oscillator
+        // Repack the live partials only when the levels changed
+        if (params.partialsRevision != partialsRevision) {
+            partialsRevision = params.partialsRevision;
+            bank.setLevels(params.partialGains);
         }
-
-        // Normalize by number of active partials to prevent clipping
-        summed *= 0.25f;  // Conservative scaling
+        float summed = bank.process();
 
         // Process filter envelope
         filterEnv.process();
         float filterEnvValue = filterEnv.output;
 
-        // Calculate filter cutoff with envelope modulation
-        float baseCutoff = params[8];  // 0-1 normalized
-        float filterRes = params[9];
-        float envAmount = params[10];   // -1 to 1
-
-        // Map cutoff to 20Hz - 20kHz (exponential)
-        float cutoffHz = 20.0f * std::pow(1000.0f, baseCutoff);  // 20Hz to 20kHz
-        float envModHz = envAmount * filterEnvValue * 10000.0f;
-        cutoffHz = std::clamp(cutoffHz + envModHz, 20.0f, 20000.0f);
+        // Cutoff with envelope modulation (the base is already in Hz)
+        float cutoffHz = std::clamp(params.cutoffHz + params.envAmountHz * filterEnvValue, 20.0f, 20000.0f);
 
         // Set filter parameters
         filter.setFrequency(cutoffHz);
-        filter.setResonance(filterRes);
+        filter.setResonance(params.resonance);
 
         // Process through filter
         float filtered = filter.process(summed, 0);  // Process left channel
@@ -150,8 +153,9 @@ private:
     float frequency = 440.0f;
     bool isActive = false;
 
-    // 8 square wave oscillators (partials at 1x, 2x, 3x, ... 8x fundamental)
-    std::array<sst::basic_blocks::dsp::PulseOscillator, NUM_PARTIALS> partials;
+    // Square-wave partials at 1x, 2x, 3x, ... the fundamental
+    AdditiveBank<NUM_PARTIALS> bank;
+    uint32_t partialsRevision = ~0u;  // partialGains last packed into bank
 
     // Filter (Moog-style ladder)
     sst::filters::VintageLadder<sst::filters::VintageLadder<>::LowPass> filter;
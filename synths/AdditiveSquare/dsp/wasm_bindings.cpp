@@ -1,5 +1,6 @@
 #include "Engine.h"
 #include <emscripten/emscripten.h>
+#include <cstdint>
 
 /**
  * WASM Bindings for Additive Square
@@ -14,6 +15,13 @@
 // Global engine instance
 static Engine* g_engine = nullptr;
 
+// Packed MIDI for pushEvents(), two 32-bit words per event:
+//   [0] sample offset into the next process() call
+//   [1] raw MIDI bytes: status | data1 << 8 | data2 << 16
+// The worklet writes a quantum's events here and hands them over in one call.
+static constexpr int EVENT_WORDS = 2;
+static uint32_t g_eventBuffer[MidiEventQueue::CAPACITY * EVENT_WORDS];
+
 extern "C" {
     /**
      * Initialize the DSP engine
@@ -105,6 +113,60 @@ extern "C" {
         g_engine->noteOff(note);
     }
 
+    /**
+     * Buffer for pushEvents(): getEventBufferCapacity() events of
+     * EVENT_WORDS words each, in WASM memory
+     */
+    EMSCRIPTEN_KEEPALIVE
+    uint32_t* getEventBuffer() {
+        return g_eventBuffer;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getEventBufferCapacity() {
+        return MidiEventQueue::CAPACITY;
+    }
+
+    /**
+     * Schedule a batch of timestamped MIDI for the next process() call
+     * One JS->WASM crossing per quantum instead of one per event; each
+     * event is applied at its sample offset inside renderBlock().
+     *
+     * @param packedEvents n events in the layout above (normally g_eventBuffer)
+     * @param n Number of events
+     */
+    EMSCRIPTEN_KEEPALIVE
+    void pushEvents(const uint32_t* packedEvents, int n) {
+        if (!g_engine) return;
+
+        for (int i = 0; i < n; i++) {
+            const uint32_t word = packedEvents[i * EVENT_WORDS + 1];
+            const int status = word & 0xF0;
+            const int data1 = (word >> 8) & 0x7F;
+            const int data2 = (word >> 16) & 0x7F;
+
+            MidiEvent event;
+            event.sampleOffset = static_cast<int>(packedEvents[i * EVENT_WORDS]);
+            event.channel = word & 0x0F;
+            event.note = data1;
+
+            if (status == 0x90 && data2 > 0) {
+                event.type = MidiEvent::Type::NoteOn;
+                event.value = data2 / 127.0f;
+            } else if (status == 0x80 || status == 0x90) {
+                event.type = MidiEvent::Type::NoteOff;
+            } else if (status == 0xB0 && (data1 == 120 || data1 == 123)) {
+                event.type = MidiEvent::Type::AllNotesOff;  // All sound / all notes off
+            } else if (status == 0xE0) {
+                event.type = MidiEvent::Type::PitchBend;
+                event.value = (((data2 << 7) | data1) - 8192) / 8192.0f;
+            } else {
+                continue;
+            }
+            g_engine->pushEvent(event);
+        }
+    }
+
     /**
      * Handle MIDI CC message
      * Optional: implement if you need MIDI CC parameter control
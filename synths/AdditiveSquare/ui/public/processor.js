@@ -7,8 +7,21 @@
  * - Runs on audio thread - must be real-time safe
  * - No console.log, no allocations, no blocking operations
  * - Communication with main thread via MessagePort only
+ *
+ * MIDI (noteOn, noteOff, midi messages) is not applied when it arrives.
+ * Each message may carry `time`, the AudioContext frame it should sound
+ * at (0 or missing: as soon as possible). Events wait in a preallocated
+ * pending list; every quantum the ones due are packed into the WASM event
+ * buffer and handed over with a single pushEvents() call, and the engine
+ * applies each at its sample offset (see dsp/wasm_bindings.cpp).
  */
 
+/** Events waiting for their quantum (more are applied late, not dropped) */
+const PENDING_CAPACITY = 1024;
+
+/** Words per packed event: [sample offset, status | data1 << 8 | data2 << 16] */
+const EVENT_WORDS = 2;
+
 class SynthProcessor extends AudioWorkletProcessor {
   constructor() {
     super();
@@ -24,6 +37,17 @@ class SynthProcessor extends AudioWorkletProcessor {
     this.wasmNoteOff = null;
     this.wasmMidiCC = null;
     this.wasmPitchBend = null;
+    this.wasmPushEvents = null;
+
+    // Timestamped MIDI not yet due: target frame and packed bytes
+    this.pendingFrames = new Float64Array(PENDING_CAPACITY);
+    this.pendingMidi = new Uint32Array(PENDING_CAPACITY);
+    this.pendingCount = 0;
+
+    // WASM-side batch for pushEvents()
+    this.eventBufferPtr = 0;
+    this.eventBufferCapacity = 0;
+    this.eventView = null;
 
     // Audio buffers
     this.outputLPtr = null;
@@ -37,7 +61,7 @@ class SynthProcessor extends AudioWorkletProcessor {
   async handleMessage(msg) {
     switch (msg.type) {
       case 'init':
-        await this.initWasm(msg.wasmModule, msg.sampleRate);
+        await this.initWasm(msg.wasmBytes, msg.wasmSimdBytes, msg.sampleRate);
         break;
 
       case 'setParameter':
@@ -47,25 +71,35 @@ class SynthProcessor extends AudioWorkletProcessor {
         break;
 
       case 'noteOn':
-        if (this.isInitialized && this.wasmNoteOn) {
-          this.wasmNoteOn(msg.note, msg.velocity);
-        }
+        this.queueMidi(msg.time, 0x90, msg.note, Math.max(1, Math.round(msg.velocity * 127)));
         break;
 
       case 'noteOff':
-        if (this.isInitialized && this.wasmNoteOff) {
-          this.wasmNoteOff(msg.note);
-        }
+        this.queueMidi(msg.time, 0x80, msg.note, 0);
         break;
 
       case 'midi':
-        this.handleMidi(msg.status, msg.data1, msg.data2);
+        this.queueMidi(msg.time, msg.status, msg.data1, msg.data2);
         break;
     }
   }
 
-  async initWasm(wasmModule, sampleRate) {
+  /**
+   * Pick the SIMD128 binary if this browser can validate it, else the
+   * scalar fallback. Both are built from the same source (see Makefile).
+   */
+  static selectWasmBinary(wasmBytes, wasmSimdBytes) {
+    if (wasmSimdBytes && WebAssembly.validate(wasmSimdBytes)) {
+      return { bytes: wasmSimdBytes, simd: true };
+    }
+    return { bytes: wasmBytes, simd: false };
+  }
+
+  async initWasm(wasmBytes, wasmSimdBytes, sampleRate) {
     try {
+      const { bytes, simd } = SynthProcessor.selectWasmBinary(wasmBytes, wasmSimdBytes);
+      const wasmModule = await WebAssembly.compile(bytes);
+
       // Instantiate WASM module
       const instance = await WebAssembly.instantiate(wasmModule, {
         env: {
@@ -83,6 +117,11 @@ class SynthProcessor extends AudioWorkletProcessor {
       this.wasmNoteOff = exports.noteOff;
       this.wasmMidiCC = exports.midiCC;
       this.wasmPitchBend = exports.pitchBend;
+      this.wasmPushEvents = exports.pushEvents || null;
+      if (this.wasmPushEvents) {
+        this.eventBufferPtr = exports.getEventBuffer();
+        this.eventBufferCapacity = exports.getEventBufferCapacity();
+      }
 
       // Allocate audio buffers in WASM memory
       const malloc = exports.malloc;
@@ -99,12 +138,61 @@ class SynthProcessor extends AudioWorkletProcessor {
       this.isInitialized = true;
 
       // Notify main thread
-      this.port.postMessage({ type: 'ready' });
+      this.port.postMessage({ type: 'ready', simd });
     } catch (error) {
       this.port.postMessage({ type: 'error', error: error.message });
     }
   }
 
+  /** Hold a MIDI message until the quantum its frame falls in */
+  queueMidi(time, status, data1, data2) {
+    if (!this.isInitialized) return;
+
+    // Builds without pushEvents(): apply now, quantized to the render quantum
+    if (!this.wasmPushEvents || this.pendingCount === PENDING_CAPACITY) {
+      this.handleMidi(status, data1, data2);
+      return;
+    }
+
+    const i = this.pendingCount++;
+    this.pendingFrames[i] = time > 0 ? time : 0;
+    this.pendingMidi[i] = (status & 0xFF) | ((data1 & 0x7F) << 8) | ((data2 & 0x7F) << 16);
+  }
+
+  /**
+   * Pack the events due before the end of this quantum into the WASM
+   * buffer (in arrival order) and push them in one call. Later ones stay.
+   */
+  flushEvents(numSamples) {
+    if (this.pendingCount === 0) return;
+
+    const memory = this.wasmInstance.exports.memory;
+    if (!this.eventView || this.eventView.buffer !== memory.buffer) {
+      this.eventView = new Uint32Array(memory.buffer, this.eventBufferPtr, this.eventBufferCapacity * EVENT_WORDS);
+    }
+
+    const blockStart = currentFrame;
+    let count = 0;
+    let kept = 0;
+    for (let i = 0; i < this.pendingCount; i++) {
+      const offset = this.pendingFrames[i] - blockStart;
+      if (offset < numSamples && count < this.eventBufferCapacity) {
+        this.eventView[count * EVENT_WORDS] = offset > 0 ? offset : 0;
+        this.eventView[count * EVENT_WORDS + 1] = this.pendingMidi[i];
+        count++;
+      } else {
+        this.pendingFrames[kept] = this.pendingFrames[i];
+        this.pendingMidi[kept] = this.pendingMidi[i];
+        kept++;
+      }
+    }
+    this.pendingCount = kept;
+
+    if (count > 0) {
+      this.wasmPushEvents(this.eventBufferPtr, count);
+    }
+  }
+
   handleMidi(status, data1, data2) {
     if (!this.isInitialized) return;
 
@@ -152,6 +240,9 @@ class SynthProcessor extends AudioWorkletProcessor {
     const output = outputs[0];
     const numSamples = output[0].length;
 
+    // This quantum's MIDI, applied at its sample offsets during process
+    this.flushEvents(numSamples);
+
     // Call WASM process function
     this.wasmProcess(this.outputLPtr, this.outputRPtr, numSamples);
 
@@ -33,6 +33,23 @@ export interface AudioEngineAPI {
   sendMidiOut: (status: number, data1: number, data2: number) => void;
 }
 
+/**
+ * Delay added to incoming MIDI so a burst keeps its spacing: events are
+ * scheduled this far behind their arrival and the worklet applies each at
+ * its sample offset. Anything already due plays at the next quantum.
+ */
+const MIDI_SCHEDULE_DELAY_S = 0.005;
+
+/** AudioContext frame to render a Web MIDI event at (timeStamp: performance.now() ms) */
+function midiTimeToFrame(ctx: AudioContext, timeStamp: number): number {
+  // contextTime is what's leaving the speakers now; rendering runs the
+  // output latency ahead of it
+  const { contextTime = 0, performanceTime = 0 } = ctx.getOutputTimestamp();
+  const latency = ctx.outputLatency || ctx.baseLatency;
+  const seconds = contextTime + (timeStamp - performanceTime) / 1000 + latency + MIDI_SCHEDULE_DELAY_S;
+  return Math.max(1, Math.round(seconds * ctx.sampleRate));
+}
+
 export const useAudioEngine = (): AudioEngineAPI => {
   const [isReady, setIsReady] = useState(false);
   const [midiInputs, setMidiInputs] = useState<MIDIDevice[]>([]);
@@ -57,12 +74,17 @@ export const useAudioEngine = (): AudioEngineAPI => {
         await ctx.resume();
       }
 
-      // 2. Load WASM module
-      const wasmResponse = await fetch('/synth.wasm');
+      // 2. Load WASM binaries (scalar + optional SIMD128 build).
+      // The worklet validates the SIMD binary and picks one.
+      const [wasmResponse, simdResponse] = await Promise.all([
+        fetch('/synth.wasm'),
+        fetch('/synth.simd.wasm').catch(() => null),
+      ]);
       if (!wasmResponse.ok) {
         throw new Error(`Failed to load WASM: ${wasmResponse.statusText}`);
       }
-      const wasmModule = await WebAssembly.compileStreaming(wasmResponse);
+      const wasmBytes = await wasmResponse.arrayBuffer();
+      const wasmSimdBytes = simdResponse?.ok ? await simdResponse.arrayBuffer() : null;
 
       // 3. Register AudioWorklet
       try {
@@ -83,11 +105,13 @@ export const useAudioEngine = (): AudioEngineAPI => {
       worklet.connect(ctx.destination);
 
       // 5. Initialize WASM in worklet
+      const transfer = wasmSimdBytes ? [wasmBytes, wasmSimdBytes] : [wasmBytes];
       worklet.port.postMessage({
         type: 'init',
-        wasmModule,
+        wasmBytes,
+        wasmSimdBytes,
         sampleRate: ctx.sampleRate,
-      });
+      }, transfer);
 
       // Wait for ready signal
       await new Promise<void>((resolve, reject) => {
@@ -127,6 +151,7 @@ export const useAudioEngine = (): AudioEngineAPI => {
                 status,
                 data1,
                 data2,
+                time: midiTimeToFrame(ctx, msg.timeStamp),
               });
             };
           });
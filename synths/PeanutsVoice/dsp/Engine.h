@@ -71,14 +71,10 @@ public:
             outR[i] = 0.0f;
         }
 
-        // Sum all active voices
+        // Sum all active voices (mono, into the left channel)
         for (int v = 0; v < MAX_VOICES; v++) {
             if (voiceActive[v]) {
-                for (int i = 0; i < numSamples; i++) {
-                    float sample = voices[v].process(params);
-                    outL[i] += sample;
-                    outR[i] += sample;
-                }
+                voices[v].render(outL, numSamples, params);
             }
         }
 
@@ -86,7 +82,7 @@ public:
         float masterGain = params[127];
         for (int i = 0; i < numSamples; i++) {
             outL[i] *= masterGain;
-            outR[i] *= masterGain;
+            outR[i] = outL[i];
         }
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
@@ -31,41 +32,100 @@
  * - F1, F2, F3 (three formant frequencies)
  * - Each is a resonant band-pass filter
  * - Vowel morphing: /a/ (ah) → /o/ (oh) → /u/ (oo)
+ *
+ * Voices render in BLOCK_SIZE blocks. The vowel position (and so the
+ * formant coefficients) is worked out once per block from the LFO and
+ * filter envelope at its end, and FormantBank slides the coefficients
+ * there across the block.
  */
 class Voice {
 public:
-    // Formant filter structure (one band-pass filter per formant)
-    struct FormantFilter {
-        float z1 = 0.0f, z2 = 0.0f;  // Input state
-        float y1 = 0.0f, y2 = 0.0f;  // Output state
-
-        float process(float input, float freq, float q, float sampleRate) {
-            float omega = 2.0f * M_PI * freq / sampleRate;
-            float alpha = std::sin(omega) / (2.0f * q);
-
-            // Band-pass filter coefficients
-            float b0 = alpha;
-            float b1 = 0.0f;
-            float b2 = -alpha;
-            float a0 = 1.0f + alpha;
-            float a1 = -2.0f * std::cos(omega);
-            float a2 = 1.0f - alpha;
-
-            // Direct Form I
-            float output = (b0 * input + b1 * z1 + b2 * z2 - a1 * y1 - a2 * y2) / a0;
-
-            // Update state
-            z2 = z1;
-            z1 = input;
-            y2 = y1;
-            y1 = output;
-
-            return output;
-        }
+    /**
+     * The three formant band-passes as one bank: lane k is formant k (lane 3 idle)
+     *
+     * They share their input, and an RBJ band-pass has b1 = 0 and b2 = -b0,
+     * so with the coefficients stored divided by a0 each lane's step is
+     *
+     *   y = b0 (x - x2) - a1 y1 - a2 y2
+     *
+     * setTargets() works out the coefficients (one sin and cos per formant)
+     * only when the vowel position or Q has moved; process() then slides
+     * from the last block's coefficients to the new ones across the block,
+     * stepping all lanes in one fixed-width loop the compiler vectorizes.
+     */
+    struct FormantBank {
+        static constexpr int LANES = 4;
+        using Lanes = std::array<float, LANES>;
 
         void reset() {
-            z1 = z2 = y1 = y2 = 0.0f;
+            x1 = x2 = 0.0f;
+            y1.fill(0.0f);
+            y2.fill(0.0f);
         }
+
+        /** Frequencies, Qs and output gains of the three formants; snap skips the slide */
+        void setTargets(const float* freq, const float* q, const float* gains, float sampleRate, bool snap) {
+            for (int k = 0; k < 3; k++) {
+                const float omega = 2.0f * static_cast<float>(M_PI) * freq[k] / sampleRate;
+                const float alpha = std::sin(omega) / (2.0f * q[k]);
+                const float a0Inv = 1.0f / (1.0f + alpha);
+                b0Target[k] = alpha * a0Inv;
+                a1Target[k] = -2.0f * std::cos(omega) * a0Inv;
+                a2Target[k] = (1.0f - alpha) * a0Inv;
+                gainTarget[k] = gains[k];
+            }
+            if (snap) {
+                b0 = b0Target;
+                a1 = a1Target;
+                a2 = a2Target;
+                gain = gainTarget;
+            }
+        }
+
+        /** Filter a block into out (the gain-weighted sum of the formants) */
+        void process(const float* in, float* out, int numSamples) {
+            const float step = 1.0f / static_cast<float>(numSamples);
+            Lanes db0, da1, da2, dgain;
+            for (int k = 0; k < LANES; k++) {
+                db0[k] = (b0Target[k] - b0[k]) * step;
+                da1[k] = (a1Target[k] - a1[k]) * step;
+                da2[k] = (a2Target[k] - a2[k]) * step;
+                dgain[k] = (gainTarget[k] - gain[k]) * step;
+            }
+
+            for (int i = 0; i < numSamples; i++) {
+                const float x = in[i];
+                const float dx = x - x2;
+                float sum = 0.0f;
+                for (int k = 0; k < LANES; k++) {
+                    b0[k] += db0[k];
+                    a1[k] += da1[k];
+                    a2[k] += da2[k];
+                    gain[k] += dgain[k];
+                    const float y = b0[k] * dx - a1[k] * y1[k] - a2[k] * y2[k];
+                    y2[k] = y1[k];
+                    y1[k] = y;
+                    sum += y * gain[k];
+                }
+                x2 = x1;
+                x1 = x;
+                out[i] = sum;
+            }
+
+            // Land exactly on the targets, whatever the rounding on the way
+            b0 = b0Target;
+            a1 = a1Target;
+            a2 = a2Target;
+            gain = gainTarget;
+        }
+
+        // Normalized coefficients, now and where this block slides to
+        Lanes b0{}, a1{}, a2{}, gain{};
+        Lanes b0Target{}, a1Target{}, a2Target{}, gainTarget{};
+
+        // Shared input history, per-lane output history
+        float x1 = 0.0f, x2 = 0.0f;
+        Lanes y1{}, y2{};
     };
 
     // Vowel formant definitions (adult male voice, Hz)
@@ -83,6 +143,8 @@ public:
     };
 
 public:
+    static constexpr int BLOCK_SIZE = 32;
+
     // Parameter IDs (matching the architecture doc)
     enum Params {
         OSC_WAVEFORM = 0,     // 0=saw, 1=pulse
@@ -120,12 +182,16 @@ public:
 
         // Initialize phase for simple formant implementation
         phase = 0.0f;
+
+        formants.reset();
+        lastVowelPos = -1.0f;
     }
 
     void noteOn(int midiNote, float vel) {
         note = midiNote;
         velocity = vel;
         isActive = true;
+        snapFormants = true;
 
         // Trigger envelopes
         filterEnv.attack();
@@ -149,17 +215,23 @@ public:
         return isActive;
     }
 
-    float process(const std::array<float, 128>& params) {
-        if (!isActive) {
-            return 0.0f;
+    /** Add numSamples of this voice to out */
+    void render(float* out, int numSamples, const std::array<float, 128>& params) {
+        while (isActive && numSamples > 0) {
+            const int n = std::min(numSamples, BLOCK_SIZE);
+            renderBlock(out, n, params);
+            out += n;
+            numSamples -= n;
         }
+    }
 
+private:
+    void renderBlock(float* out, int numSamples, const std::array<float, 128>& params) {
         // Get parameters
         float oscWaveform = params[OSC_WAVEFORM];
         float oscTune = params[OSC_TUNE] * 48.0f - 24.0f;  // -24 to +24 semitones
         float oscLevel = params[OSC_LEVEL];
         float drive = params[DRIVE];
-        float filterCutoff = params[FILTER_CUTOFF] * 7980.0f + 20.0f;  // 20-8000 Hz
         float filterRes = params[FILTER_RESONANCE];
         float lfoRate = params[LFO_RATE] * 9.9f + 0.1f;  // 0.1-10 Hz
         float lfoDepth = params[LFO_DEPTH];
@@ -179,37 +251,37 @@ public:
         float tunedNote = note + oscTune;
         float frequency = 440.0f * std::pow(2.0f, (tunedNote - 69.0f) / 12.0f);
 
-        // Generate oscillator
         sawOsc.setFrequency(frequency);
         pulseOsc.setFrequency(frequency);
+        pulseOsc.setPulseWidth(0.5f);  // Square wave for brass character
+        lfo.setRate(lfoRate);
 
-        float oscSample;
-        if (oscWaveform < 0.5f) {
-            oscSample = sawOsc.value();
-            sawOsc.step();
-        } else {
-            pulseOsc.setPulseWidth(0.5f);  // Square wave for brass character
-            oscSample = pulseOsc.value();
-            pulseOsc.step();
+        // Oscillator and waveshaper; the LFO and filter envelope step along
+        float shaped[BLOCK_SIZE];
+        float lfoValue = 0.0f;
+        float filterEnvValue = 0.0f;
+        for (int i = 0; i < numSamples; i++) {
+            float oscSample;
+            if (oscWaveform < 0.5f) {
+                oscSample = sawOsc.value();
+                sawOsc.step();
+            } else {
+                oscSample = pulseOsc.value();
+                pulseOsc.step();
+            }
+
+            // Waveshaper for brass harmonics (soft clipping)
+            float driven = oscSample * oscLevel * (1.0f + drive * 4.0f);
+            shaped[i] = tanhApprox(driven);
+
+            lfoValue = lfo.step();  // Returns -1 to +1
+            filterEnvValue = filterEnv.processForSampleRate(sampleRate);
         }
 
-        oscSample *= oscLevel;
-
-        // Waveshaper for brass harmonics (soft clipping)
-        float driven = oscSample * (1.0f + drive * 4.0f);
-        float shaped = tanhApprox(driven);
-
         // FORMANT FILTER BANK
         // Morph between vowel positions based on filter cutoff parameter
         float vowelPos = params[FILTER_FORMANT] * 4.0f;  // 0-4 (5 vowels)
 
-        // LFO modulation
-        lfo.setRate(lfoRate);
-        float lfoValue = lfo.step();  // Returns -1 to +1
-
-        // Filter envelope modulation
-        float filterEnvValue = filterEnv.processForSampleRate(sampleRate);
-
         // Modulate vowel position (creates "wah wah" effect)
         vowelPos += lfoValue * lfoDepth * 2.0f;       // LFO morphs between vowels
         vowelPos += filterEnvValue * 2.0f;            // Envelope also morphs vowels
@@ -217,51 +289,56 @@ public:
         // Clamp to valid vowel range
         vowelPos = std::max(0.0f, std::min(vowelPos, 3.999f));
 
-        // Interpolate between two adjacent vowels
-        int vowelIdx = static_cast<int>(vowelPos);
-        float vowelBlend = vowelPos - vowelIdx;
-        int nextVowelIdx = std::min(vowelIdx + 1, 4);
-
-        const Vowel& v1 = VOWELS[vowelIdx];
-        const Vowel& v2 = VOWELS[nextVowelIdx];
-
-        // Interpolated formant frequencies and gains
-        float f1 = v1.f1 + (v2.f1 - v1.f1) * vowelBlend;
-        float f2 = v1.f2 + (v2.f2 - v1.f2) * vowelBlend;
-        float f3 = v1.f3 + (v2.f3 - v1.f3) * vowelBlend;
-        float g1 = v1.g1 + (v2.g1 - v1.g1) * vowelBlend;
-        float g2 = v1.g2 + (v2.g2 - v1.g2) * vowelBlend;
-        float g3 = v1.g3 + (v2.g3 - v1.g3) * vowelBlend;
-
         // Q values for formant filters (higher Q = more resonant/vowel-like)
         float q = 5.0f + filterRes * 15.0f;  // Q from 5 to 20
 
-        // Process through 3-formant filter bank
-        float out1 = formant1.process(shaped, f1, q, sampleRate);
-        float out2 = formant2.process(shaped, f2, q * 0.7f, sampleRate);  // F2 less resonant
-        float out3 = formant3.process(shaped, f3, q * 0.5f, sampleRate);  // F3 even less
+        // New coefficients only when the wah has moved
+        if (snapFormants || vowelPos != lastVowelPos || q != lastQ) {
+            setFormantTargets(vowelPos, q);
+            lastVowelPos = vowelPos;
+            lastQ = q;
+        }
+        snapFormants = false;
 
-        // Mix formants with appropriate gains
-        float filtered = out1 * g1 + out2 * g2 + out3 * g3;
+        float filtered[BLOCK_SIZE];
+        formants.process(shaped, filtered, numSamples);
 
-        // Boost output (formant filters can be quiet)
-        filtered *= 2.0f;
+        for (int i = 0; i < numSamples; i++) {
+            // Amplitude envelope
+            float ampEnvValue = ampEnv.processForSampleRate(sampleRate);
 
-        // Amplitude envelope
-        float ampEnvValue = ampEnv.processForSampleRate(sampleRate);
+            // Check if amp envelope is done
+            if (ampEnvValue < 0.0001f && ampEnv.stage == ampEnv.s_eoc) {
+                isActive = false;
+                return;
+            }
 
-        // Check if amp envelope is done
-        if (ampEnvValue < 0.0001f && ampEnv.stage == ampEnv.s_eoc) {
-            isActive = false;
+            // Final output (formant filters can be quiet: boost by 2)
+            out[i] += filtered[i] * 2.0f * ampEnvValue * velocity * 0.5f;
         }
+    }
 
-        // Final output
-        float output = filtered * ampEnvValue * velocity * 0.5f;
+    /** Interpolate between two adjacent vowels and aim the formant bank there */
+    void setFormantTargets(float vowelPos, float q) {
+        int vowelIdx = static_cast<int>(vowelPos);
+        float vowelBlend = vowelPos - vowelIdx;
+        int nextVowelIdx = std::min(vowelIdx + 1, 4);
 
-        return output;
+        const Vowel& v1 = VOWELS[vowelIdx];
+        const Vowel& v2 = VOWELS[nextVowelIdx];
+
+        // Interpolated formant frequencies and gains; F2 and F3 less resonant
+        const float freqs[3] = {v1.f1 + (v2.f1 - v1.f1) * vowelBlend,
+                                v1.f2 + (v2.f2 - v1.f2) * vowelBlend,
+                                v1.f3 + (v2.f3 - v1.f3) * vowelBlend};
+        const float gains[3] = {v1.g1 + (v2.g1 - v1.g1) * vowelBlend,
+                                v1.g2 + (v2.g2 - v1.g2) * vowelBlend,
+                                v1.g3 + (v2.g3 - v1.g3) * vowelBlend};
+        const float qs[3] = {q, q * 0.7f, q * 0.5f};
+
+        formants.setTargets(freqs, qs, gains, sampleRate, snapFormants);
     }
 
-private:
     // Fast tanh approximation for waveshaping
     float tanhApprox(float x) {
         if (x < -3.0f) return -1.0f;
@@ -285,8 +362,10 @@ private:
     sst::basic_blocks::modulators::ADSREnvelope filterEnv;
     sst::basic_blocks::modulators::ADSREnvelope ampEnv;
 
-    // Formant filter bank (3 formants for vowel synthesis)
-    FormantFilter formant1;  // F1 (low frequency, primary vowel character)
-    FormantFilter formant2;  // F2 (mid frequency, vowel color)
-    FormantFilter formant3;  // F3 (high frequency, brightness)
+    // Formant filter bank (3 formants for vowel synthesis): F1 primary vowel
+    // character, F2 vowel color, F3 brightness
+    FormantBank formants;
+    float lastVowelPos = -1.0f;  // Where the bank's coefficients were last aimed
+    float lastQ = 0.0f;
+    bool snapFormants = true;    // First block of a note: no slide in
 };
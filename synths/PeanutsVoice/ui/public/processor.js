@@ -37,7 +37,7 @@ class SynthProcessor extends AudioWorkletProcessor {
   async handleMessage(msg) {
     switch (msg.type) {
       case 'init':
-        await this.initWasm(msg.wasmModule, msg.sampleRate);
+        await this.initWasm(msg.wasmBytes, msg.wasmSimdBytes, msg.sampleRate);
         break;
 
       case 'setParameter':
@@ -64,8 +64,22 @@ class SynthProcessor extends AudioWorkletProcessor {
     }
   }
 
-  async initWasm(wasmModule, sampleRate) {
+  /**
+   * Pick the SIMD128 binary if this browser can validate it, else the
+   * scalar fallback. Both are built from the same source (see Makefile).
+   */
+  static selectWasmBinary(wasmBytes, wasmSimdBytes) {
+    if (wasmSimdBytes && WebAssembly.validate(wasmSimdBytes)) {
+      return { bytes: wasmSimdBytes, simd: true };
+    }
+    return { bytes: wasmBytes, simd: false };
+  }
+
+  async initWasm(wasmBytes, wasmSimdBytes, sampleRate) {
     try {
+      const { bytes, simd } = SynthProcessor.selectWasmBinary(wasmBytes, wasmSimdBytes);
+      const wasmModule = await WebAssembly.compile(bytes);
+
       // Instantiate WASM module
       const instance = await WebAssembly.instantiate(wasmModule, {
         env: {
@@ -99,7 +113,7 @@ class SynthProcessor extends AudioWorkletProcessor {
       this.isInitialized = true;
 
       // Notify main thread
-      this.port.postMessage({ type: 'ready' });
+      this.port.postMessage({ type: 'ready', simd });
     } catch (error) {
       this.port.postMessage({ type: 'error', error: error.message });
     }
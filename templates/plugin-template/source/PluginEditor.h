@@ -19,6 +19,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "PluginProcessor.h"
+#include "EditorRefresh.h"
+#include "ParamChangeFlags.h"
 
 /**
  * @brief WebView-based plugin editor
@@ -45,18 +47,25 @@ private:
     //==========================================================================
     void timerCallback() override;
 
+    /** Match the timer to what's on screen; attaches the scope FIFO while it's wanted */
+    void updateRefreshRate();
+
     //==========================================================================
     // WebView bridge methods
     //==========================================================================
 
     /** Send parameter update to WebView */
-    void sendParameterToWebView(const juce::String& paramId, float value);
+    void sendChangedParametersToWebView();
 
     /** Send all parameters to WebView (for initial sync) */
     void sendAllParametersToWebView();
 
     /** Send audio data to WebView for visualization */
     void sendAudioDataToWebView();
+    juce::var getPerfStatsForWebView() const;
+
+    /** Send the engine state (voice count...) to WebView */
+    void sendEngineStateToWebView();
 
     /** Handle parameter change from WebView */
     void handleParameterFromWebView(const juce::String& paramId, float value);
@@ -76,19 +85,31 @@ private:
     std::unique_ptr<juce::WebBrowserComponent> webView;
 
     /** Parameter listener for automation */
+    /** Flags its parameter as changed; can run on the audio thread */
     struct ParameterListener : public juce::AudioProcessorValueTreeState::Listener
     {
         PluginEditor& editor;
-        explicit ParameterListener(PluginEditor& e) : editor(e) {}
-        void parameterChanged(const juce::String& paramId, float newValue) override
+        const int index;
+        ParameterListener(PluginEditor& e, int i) : editor(e), index(i) {}
+        void parameterChanged(const juce::String&, float) override
         {
-            editor.sendParameterToWebView(paramId, newValue);
+            if (!editor.ignoreParameterCallbacks)
+                editor.changedParameters.mark(index);
         }
     };
-    std::unique_ptr<ParameterListener> paramListener;
+    std::vector<std::unique_ptr<ParameterListener>> paramListeners;
+    juce::Array<juce::RangedAudioParameter*> listenedParameters;  // By listener index
+    ParamChangeFlags changedParameters;  // Sent by timerCallback()
 
     /** Flag to prevent feedback loops */
-    bool ignoreParameterCallbacks = false;
+    std::atomic<bool> ignoreParameterCallbacks{false};
+
+    /** Newest output samples sent to the oscilloscope per timer tick */
+    static constexpr int SCOPE_WINDOW = 1024;
+    std::array<float, SCOPE_WINDOW> scopeSamples{};
+
+    /** Timer rate, from the window and the web UI's live views */
+    EditorRefresh refresh;
 
     //==========================================================================
     // Constants
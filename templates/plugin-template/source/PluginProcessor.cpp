@@ -5,6 +5,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "PluginState.h"
 
 //==============================================================================
 // Constructor / Destructor
@@ -15,10 +16,13 @@ PluginProcessor::PluginProcessor()
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true))
     , apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    // TODO: Cache parameter pointers for lock-free audio thread access
-    // Example:
-    // filterCutoffParam = apvts.getRawParameterValue("filter_cutoff");
-    // filterResoParam = apvts.getRawParameterValue("filter_reso");
+    // Cache parameter pointers for lock-free audio thread access
+    for (int i = 0; i < kNumParams; ++i)
+    {
+        auto* value = apvts.getRawParameterValue(kParamIds[i]);
+        jassert(value != nullptr);  // SynthParams.h out of step with createParameterLayout()
+        params.bind(i, value);
+    }
 }
 
 PluginProcessor::~PluginProcessor()
@@ -160,6 +164,53 @@ juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParam
         juce::AudioParameterFloatAttributes().withLabel("s")
     ));
 
+    // =========================================================================
+    // ARPEGGIATOR / CHORD MEMORY
+    // =========================================================================
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"arp_mode", 1},
+        "Arp Mode",
+        juce::StringArray{"Off", "Up", "Down", "Up/Down", "As Played", "Random"},
+        0  // Default: Off
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"arp_rate", 1},
+        "Arp Rate",
+        juce::StringArray{"1/4", "1/8", "1/8T", "1/16", "1/16T", "1/32"},
+        3  // Default: 1/16
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID{"arp_octaves", 1},
+        "Arp Octaves",
+        1, 4,
+        1
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"arp_gate", 1},
+        "Arp Gate",
+        juce::NormalisableRange<float>(0.01f, 1.0f, 0.01f),
+        0.5f
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID{"arp_tempo", 1},
+        "Arp Tempo",
+        juce::NormalisableRange<float>(20.0f, 300.0f, 0.1f),
+        120.0f,
+        juce::AudioParameterFloatAttributes().withLabel("BPM")
+    ));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID{"chord_shape", 1},
+        "Chord",
+        juce::StringArray{"Off", "Major", "Minor", "Sus4", "Maj7", "Min7", "Fifths", "Memory"},
+        0  // Default: Off
+    ));
+
     // =========================================================================
     // MASTER
     // =========================================================================
@@ -187,8 +238,8 @@ void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     // Prepare synth engine
     synthEngine.prepare(sampleRate, samplesPerBlock);
 
-    // Clear visualization buffer
-    std::fill(visualizationBuffer.begin(), visualizationBuffer.end(), 0.0f);
+    // Re-send every parameter to the freshly prepared engine
+    params.markAllChanged();
 }
 
 void PluginProcessor::releaseResources()
@@ -196,6 +247,35 @@ void PluginProcessor::releaseResources()
     synthEngine.releaseResources();
 }
 
+//==============================================================================
+// Host Transport
+//==============================================================================
+
+void PluginProcessor::updateTransport()
+{
+    using Transport = SynthEngine::Transport;
+    transport.status = Transport::STOPPED;
+
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return;
+    const auto position = playHead->getPosition();
+    if (!position)
+        return;
+
+    if (const auto bpm = position->getBpm())
+        transport.tempo = *bpm;
+
+    // Without a beat position there is no grid to follow, so count it as stopped
+    if (const auto ppq = position->getPpqPosition())
+    {
+        transport.hostTimeInBeats = *ppq;
+        transport.timeInBeats = *ppq;
+        if (position->getIsPlaying())
+            transport.status |= Transport::PLAYING;
+    }
+}
+
 //==============================================================================
 // Process Block
 //==============================================================================
@@ -213,10 +293,16 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     auto* rightChannel = buffer.getWritePointer(1);
     const int numSamples = buffer.getNumSamples();
 
-    // TODO: Read parameters (lock-free via atomics)
-    // Example:
-    // float cutoff = filterCutoffParam->load();
-    // float reso = filterResoParam->load();
+    // Read parameters (lock-free via atomics)
+    params.update();
+
+    // On-screen keyboard notes join the host's at their offsets (UiNoteFifo.h)
+    uiNotes.drain(juce::Time::getMillisecondCounterHiRes() * 0.001, getSampleRate(), numSamples,
+                  [&midiMessages](const UiNoteFifo::Note& n, int offset) {
+                      midiMessages.addEvent(n.isNoteOn ? juce::MidiMessage::noteOn(1, n.note, n.velocity)
+                                                       : juce::MidiMessage::noteOff(1, n.note),
+                                            offset);
+                  });
 
     // Handle MIDI messages
     for (const auto metadata : midiMessages)
@@ -236,29 +322,46 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer,
         }
         else if (message.isAllNotesOff())
         {
-            synthEngine.allNotesOff();
+            synthEngine.allNotesOff(samplePosition);
         }
         else if (message.isPitchWheel())
         {
             float pitchBend = (message.getPitchWheelValue() - 8192) / 8192.0f;
-            synthEngine.setPitchBend(pitchBend);
+            synthEngine.setPitchBend(pitchBend, samplePosition);
+        }
+        else if (message.isControllerOfType(1))
+        {
+            // Mod wheel; applied from the next sub-block
+            synthEngine.setModWheel(message.getControllerValue() / 127.0f);
         }
     }
 
-    // TODO: Update synth engine parameters
-    // Example:
-    // synthEngine.setFilterCutoff(cutoff);
-    // synthEngine.setFilterResonance(reso);
+    // Update synth engine parameters (only the ones that changed); the
+    // arp follows the host's transport while it plays
+    updateTransport();
+    synthEngine.setTransport(transport);
+    synthEngine.applySnapshot(params);
+
+    // Stages like the voice inserts delay the output: keep the host's delay
+    // compensation in step
+    if (const int latency = synthEngine.getLatencySamples(); latency != getLatencySamples())
+        setLatencySamples(latency);
 
     // Render audio
     synthEngine.renderBlock(leftChannel, rightChannel, numSamples);
 
-    // Copy to visualization buffer (for UI oscilloscope)
-    int copySize = std::min(numSamples, static_cast<int>(visualizationBuffer.size()));
-    for (int i = 0; i < copySize; ++i)
-    {
-        visualizationBuffer[i] = leftChannel[i];
-    }
+    // Nothing audible and nothing ringing: mark the buffer cleared so hosts
+    // and wrappers that check hasBeenCleared() can skip it
+    if (synthEngine.isSilent())
+        buffer.clear();
+
+    // Feed the UI oscilloscope (lock-free; only while an editor shows it)
+    if (scopeFifo.hasConsumer())
+        scopeFifo.push(leftChannel, numSamples);
+
+    // The editor reads engine state from here, never from the engine
+    editorState.write() = synthEngine.getEditorState();
+    editorState.publish();
 }
 
 //==============================================================================
@@ -276,18 +379,43 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 
 void PluginProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter's plain value by ID hash (see core/dsp/PluginState.h)
+    const auto& parameters = getParameters();
+    PluginState::Writer state(static_cast<size_t>(parameters.size()));
+    for (auto* parameter : parameters)
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.addParameter(PluginState::idHash(ranged->paramID.toRawUTF8()),
+                               ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    destData.replaceAll(state.data().data(), state.data().size());
 }
 
 void PluginProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    const auto size = static_cast<size_t>(std::max(sizeInBytes, 0));
+    if (!PluginState::isState(data, size))
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        // Saved before the binary state: XML
+        std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+        if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        {
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        }
+        return;
     }
+
+    // Saved by a newer build: keep what's loaded rather than reset it
+    if (!PluginState::canRead(data, size))
+        return;
+
+    PluginState::Values saved;
+    PluginState::read(data, size, saved.collector(),
+        [](uint32_t, const uint8_t*, size_t) {});
+
+    // A parameter the state doesn't have goes back to its default, as with the XML
+    PluginState::applyParameters<juce::RangedAudioParameter>(saved, getParameters());
 }
 
 //==============================================================================
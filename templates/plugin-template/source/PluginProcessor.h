@@ -15,6 +15,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/SynthEngine.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
+#include "StatePublisher.h"
 
 /**
  * @brief Main audio processor class
@@ -63,8 +66,17 @@ public:
     /** Audio parameter value tree state - use for UI binding */
     juce::AudioProcessorValueTreeState apvts;
 
-    /** Get current audio output for visualization */
-    const std::array<float, 512>& getVisualizationBuffer() const { return visualizationBuffer; }
+    /** Output samples for the editor's oscilloscope (pulled on the message thread) */
+    ScopeFifo& getScopeFifo() { return scopeFifo; }
+
+    /** On-screen keyboard notes for processBlock() (pushed on the message thread) */
+    UiNoteFifo& getUiNoteFifo() { return uiNotes; }
+
+    /** Engine CPU counters for the editor's getPerfStats (see core/dsp/PerfStats.h) */
+    const PerfStats& getPerfStats() const { return synthEngine.getPerfStats(); }
+
+    /** The engine as of the newest block (editor timer only; see core/dsp/StatePublisher.h) */
+    SynthEngine::EditorState getEditorState() { return editorState.read(); }
 
 private:
     /** Create the parameter layout - called once in constructor */
@@ -78,13 +90,20 @@ private:
     SynthEngine synthEngine;
 
     //==========================================================================
-    // Cached Parameters (for lock-free audio thread access)
+    // Parameters
     //==========================================================================
 
-    // TODO: Add cached parameter pointers
-    // Example:
-    // std::atomic<float>* filterCutoffParam = nullptr;
-    // std::atomic<float>* filterResoParam = nullptr;
+    /** Every parameter, read once per block (lock-free; see core/dsp/ParamSnapshot.h) */
+    SynthParams params;
+
+    /** Engine state for the editor, published at the end of each block */
+    StatePublisher<SynthEngine::EditorState> editorState;
+
+    /** The host's transport this block, from the play head (see updateTransport) */
+    SynthEngine::Transport transport;
+
+    /** Read the play head into transport (audio thread) */
+    void updateTransport();
 
     //==========================================================================
     // State
@@ -93,8 +112,11 @@ private:
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    /** Buffer for UI visualization */
-    std::array<float, 512> visualizationBuffer{};
+    /** Audio thread -> UI oscilloscope samples */
+    ScopeFifo scopeFifo;
+
+    /** UI keyboard -> audio thread notes */
+    UiNoteFifo uiNotes;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -0,0 +1,185 @@
+/**
+ * @file GraphModules.h
+ * @brief DspGraph nodes for the generated voices: oscillators, shaper, filter stage
+ *
+ * The building blocks generate-from-spec.js wires into a voice's graph
+ * (see core/dsp/DspGraph.h). Each wraps the same DSP the hand-written
+ * voices use, so a generated synth sounds like one built by hand:
+ *
+ *   Oscillator<Shape>                DPWOscillator, frequency set per block
+ *   DetunedOscillator<Shape, Signal>  ... retuned every sample by Signal (semitones)
+ *   Wavetable<Position>              WavetableOscillator (Wavetable.h), frame morph by
+ *                                    Position (0-1; nullptr for the first frame)
+ *   String<Excitation>               WaveguideString (Waveguide.h), plucked or bowed from
+ *                                    excite() / release(), loss set per block
+ *   SoftClip<Signal>                 Cubic soft clip, blended in by Signal (0-1)
+ *   SvfStage                         One CytomicSVF stage, four voices per register,
+ *                                    with a per-sample coefficient ramp
+ *
+ * A generated synth's DspFeatures.h sets SYNTH_USES_WAVETABLE,
+ * SYNTH_USES_WAVEGUIDE and SYNTH_USES_SVF to what its graph uses; the
+ * nodes set to 0 aren't compiled, and neither are their headers or the
+ * tables those build. Without a DspFeatures.h every node is available.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#if __has_include("DspFeatures.h")
+#include "DspFeatures.h"
+#endif
+
+#ifndef SYNTH_USES_WAVETABLE
+#define SYNTH_USES_WAVETABLE 1
+#endif
+#ifndef SYNTH_USES_WAVEGUIDE
+#define SYNTH_USES_WAVEGUIDE 1
+#endif
+#ifndef SYNTH_USES_SVF
+#define SYNTH_USES_SVF 1
+#endif
+
+#include "BandLimitedOscillator.h"
+#if SYNTH_USES_WAVEGUIDE
+#include "Waveguide.h"
+#endif
+#if SYNTH_USES_WAVETABLE
+#include "Wavetable.h"
+#endif
+#if SYNTH_USES_SVF
+#include "sst/filters/CytomicSVF.h"
+#endif
+
+namespace GraphModules
+{
+
+template <OscShape Shape>
+struct Oscillator
+{
+    DPWOscillator osc;
+    float baseHz = 440.0f;
+
+    void prepare(double sampleRate)
+    {
+        osc.prepare(sampleRate);
+        osc.setShape(Shape);
+    }
+
+    void reset() { osc.reset(); }
+
+    void setFrequency(float hz)
+    {
+        baseHz = hz;
+        osc.setFrequency(hz);
+    }
+
+    template <typename T, typename Ctx>
+    T process(T, const Ctx&, int)
+    {
+        return osc.process();
+    }
+};
+
+template <OscShape Shape, auto Detune>
+struct DetunedOscillator : Oscillator<Shape>
+{
+    template <typename T, typename Ctx>
+    T process(T, const Ctx& ctx, int i)
+    {
+        this->osc.setFrequency(this->baseHz * std::exp2((ctx.*Detune)[i] * (1.0f / 12.0f)));
+        return this->osc.process();
+    }
+};
+
+#if SYNTH_USES_WAVETABLE
+template <auto Position>
+struct Wavetable
+{
+    WavetableOscillator osc;
+
+    void prepare(double sampleRate) { osc.prepare(sampleRate); }
+    void reset() { osc.reset(); }
+
+    /** A shared table from WavetableRegistry, set at prepare */
+    void setTable(std::shared_ptr<const ::Wavetable> table) { osc.setTable(std::move(table)); }
+    void setFrequency(float hz) { osc.setFrequency(hz); }
+
+    template <typename T, typename Ctx>
+    T process(T, const Ctx& ctx, int i)
+    {
+        if constexpr (Position == nullptr)
+            return osc.process(0.0f);
+        else
+            return osc.process((ctx.*Position)[i]);
+    }
+};
+#endif
+
+#if SYNTH_USES_WAVEGUIDE
+template <StringExcitation Excitation>
+struct String
+{
+    WaveguideString string;
+
+    void prepare(double sampleRate)
+    {
+        string.prepare(sampleRate);
+        string.setExcitation(Excitation);
+    }
+
+    void reset() { string.reset(0); }
+    void setFrequency(float hz) { string.setFrequency(0, hz); }
+    void setLoss(float decaySeconds, float brightness) { string.setLoss(decaySeconds, brightness); }
+
+    /** Note on: pluck, or set the bow down */
+    void excite(float velocity) { string.excite(0, velocity); }
+
+    /** Note off: lift the bow */
+    void release() { string.release(0); }
+
+    template <typename T, typename Ctx>
+    T process(T, const Ctx&, int)
+    {
+        return string.process();
+    }
+};
+#endif
+
+template <auto Amount>
+struct SoftClip
+{
+    template <typename T, typename Ctx>
+    T process(T x, const Ctx& ctx, int i)
+    {
+        const float amount = (ctx.*Amount)[i];
+        const float c = std::clamp(x * (1.0f + 4.0f * amount), -1.5f, 1.5f);
+        return x + amount * (c - c * c * c * (4.0f / 27.0f) - x);
+    }
+};
+
+#if SYNTH_USES_SVF
+struct SvfStage
+{
+    sst::filters::CytomicSVF svf;
+
+    void reset()
+    {
+        svf.ic1eq = svf.ic2eq = SIMD_MM(setzero_ps)();
+        svf.da1 = svf.da2 = svf.da3 = SIMD_MM(setzero_ps)();
+    }
+
+    template <typename Ctx>
+    SIMD_M128 process(SIMD_M128 x, const Ctx&, int)
+    {
+        const auto y = sst::filters::CytomicSVF::stepSSE(svf, x);
+        svf.a1 = SIMD_MM(add_ps)(svf.a1, svf.da1);
+        svf.a2 = SIMD_MM(add_ps)(svf.a2, svf.da2);
+        svf.a3 = SIMD_MM(add_ps)(svf.a3, svf.da3);
+        return y;
+    }
+};
+#endif
+
+} // namespace GraphModules
@@ -0,0 +1,177 @@
+/**
+ * @file ModRouting.h
+ * @brief Modulation routing table on sst-basic-blocks' FixedMatrix
+ *
+ * Each route adds source * depth to a target. Sources are engine-wide values
+ * (mod wheel, pitch bend, global LFOs) written once per block; targets are
+ * offsets the voices add to their own settings (semitones, octaves, gain).
+ *
+ * The routing is resolved into flat pointer arrays when it changes, not while
+ * rendering: resolve() runs FixedMatrix::prepare, which allocates, so call it
+ * from prepare() or while processing is suspended. After that, process()
+ * runs only the routes that are set, once per block, and get() is a single
+ * load. With no routes at all, process() returns straight away and every
+ * target reads 0.
+ *
+ * setDepth() only changes the depth the resolved route already points at,
+ * so it is safe on the audio thread between blocks.
+ *
+ * Typical use in an engine's render loop:
+ *
+ *   modRouting.setSource(ModSource::ModWheel, modWheel);
+ *   modRouting.process();
+ *   const float pitch = modRouting.get(ModTarget::Pitch);
+ *   for (auto& voice : voices)
+ *       voice.setModulation(pitch, ...);
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "sst/basic-blocks/mod-matrix/ModMatrix.h"
+
+#include "ControlRate.h"
+
+// TODO: Add your synth's sources (LFOs, mod envelopes, aftertouch) and
+// targets here - both enums must end with their NUM_ entry
+enum class ModSource : int
+{
+    ModWheel = 0,   // CC1, 0..1
+    PitchBend,      // -1..1
+    NUM_SOURCES
+};
+
+enum class ModTarget : int
+{
+    Pitch = 0,      // Semitones
+    FilterCutoff,   // Octaves
+    Amp,            // Gain offset, 0 = unchanged
+    NUM_TARGETS
+};
+
+/** FixedMatrix traits: the enums above, no curves or payloads */
+struct ModMatrixConfig
+{
+    using SourceIdentifier = ModSource;
+    using TargetIdentifier = ModTarget;
+    using CurveIdentifier = int;
+    using RoutingExtraPayload = int;
+
+    static constexpr bool IsFixedMatrix{true};
+    static constexpr size_t FixedMatrixSize{8};
+    static constexpr bool ProvidesNonZeroTargetBases{false};
+};
+
+class ModRouting
+{
+public:
+    static constexpr int NUM_SLOTS = static_cast<int>(ModMatrixConfig::FixedMatrixSize);
+    static constexpr int NUM_SOURCES = static_cast<int>(ModSource::NUM_SOURCES);
+    static constexpr int NUM_TARGETS = static_cast<int>(ModTarget::NUM_TARGETS);
+
+    ModRouting()
+    {
+        for (int s = 0; s < NUM_SOURCES; ++s)
+            matrix.bindSourceValue(static_cast<ModSource>(s), sources[static_cast<size_t>(s)]);
+        for (int t = 0; t < NUM_TARGETS; ++t)
+            matrix.bindTargetBaseValue(static_cast<ModTarget>(t), bases[static_cast<size_t>(t)]);
+        resolve();
+    }
+
+    // The matrix holds references to the source and base arrays
+    ModRouting(const ModRouting&) = delete;
+    ModRouting& operator=(const ModRouting&) = delete;
+
+    //==========================================================================
+    // Configuration (not real-time safe: resolve() allocates)
+    //==========================================================================
+
+    /** Route source to target in a slot (0..NUM_SLOTS-1); takes effect on resolve() */
+    void setRoute(int slot, ModSource source, ModTarget target, float depth)
+    {
+        if (slot < 0 || slot >= NUM_SLOTS)
+            return;
+        table.updateRoutingAt(static_cast<size_t>(slot), source, target, depth);
+        dirty = true;
+    }
+
+    /** Empty a slot; takes effect on resolve() */
+    void clearRoute(int slot)
+    {
+        if (slot < 0 || slot >= NUM_SLOTS)
+            return;
+        table.routes[static_cast<size_t>(slot)] = {};
+        dirty = true;
+    }
+
+    /** Rebuild the flat route and target arrays from the table */
+    void resolve(double sampleRate = 48000.0, int blockSize = ControlRamp::BLOCK_SIZE)
+    {
+        // prepare() only rewrites as many entries as there are routes, so
+        // clear the rest or a removed route would keep running
+        for (auto& rv : matrix.routingValuePointers)
+            rv = {};
+        matrix.prepare(table, sampleRate, blockSize);
+
+        activeRoutes = 0;
+        for (const auto& r : table.routes)
+        {
+            if (r.source.has_value() && r.target.has_value())
+                ++activeRoutes;
+        }
+
+        for (int t = 0; t < NUM_TARGETS; ++t)
+            targets[static_cast<size_t>(t)] = matrix.getTargetValuePointer(static_cast<ModTarget>(t));
+
+        dirty = false;
+    }
+
+    /** True after setRoute() / clearRoute() until the next resolve() */
+    bool needsResolve() const { return dirty; }
+
+    int getActiveRouteCount() const { return activeRoutes; }
+
+    //==========================================================================
+    // Audio thread
+    //==========================================================================
+
+    /** Change a resolved route's depth; no resolve() needed */
+    void setDepth(int slot, float depth)
+    {
+        if (slot >= 0 && slot < NUM_SLOTS)
+            table.updateDepthAt(static_cast<size_t>(slot), depth);
+    }
+
+    void setSource(ModSource source, float value)
+    {
+        sources[static_cast<size_t>(source)] = value;
+    }
+
+    /** Sum every route into its target (once per block) */
+    void process()
+    {
+        if (activeRoutes > 0)
+            matrix.process();
+    }
+
+    /** Summed offset for a target as of the last process() */
+    float get(ModTarget target) const
+    {
+        return *targets[static_cast<size_t>(target)];
+    }
+
+private:
+    using Matrix = sst::basic_blocks::mod_matrix::FixedMatrix<ModMatrixConfig>;
+
+    Matrix matrix;
+    Matrix::RoutingTable table;
+
+    std::array<float, NUM_SOURCES> sources{};
+    std::array<float, NUM_TARGETS> bases{};  // Always 0: targets are offsets
+    std::array<const float*, NUM_TARGETS> targets{};
+
+    int activeRoutes = 0;
+    bool dirty = false;
+};
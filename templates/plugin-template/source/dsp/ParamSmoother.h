@@ -0,0 +1,221 @@
+/**
+ * @file ParamSmoother.h
+ * @brief Linear ramps for continuous parameters, advanced four at a time
+ *
+ * Parameters reach the engine once per block (see ParamSnapshot.h), so a
+ * fast automation sweep on cutoff or volume arrives as a staircase and
+ * zippers. Smoothing every parameter every sample would cost more than the
+ * voices. A ParamSmoother holds one lane per smoothed parameter and keeps
+ * an active set of the lanes that are moving, the way sst-basic-blocks'
+ * LagCollection does (which needs sst-cpputils, not vendored here). Settled
+ * lanes cost nothing. Moving lanes are stored in groups of four and
+ * advanced in one SIMD register per group with a LinearLag-style ramp:
+ * constant speed, landing exactly on the target.
+ *
+ *   // Setter (once per block, from applySnapshot)
+ *   smoothers.setTarget(SmoothCutoff, cutoffHz);
+ *
+ *   // Per sub-block
+ *   updateParam(params.filterCutoff, smoothers.getValue(SmoothCutoff));  // block rate
+ *   smoothers.renderRamp(SmoothGain, gainRamp, n);                        // per sample
+ *   ...
+ *   smoothers.advance(n);
+ *
+ * Lanes start out unprimed, and reset() makes them unprimed again: their
+ * next setTarget() jumps instead of ramping, so a parameter's first value
+ * (the preset or the default) doesn't fade in.
+ *
+ * Every lane glides over prepare()'s ramp time unless setRampTime() gives
+ * it its own (a spec's per-parameter smoothing, see generate-from-spec.js).
+ *
+ * @note No allocation after construction: real-time safe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+template <int NumLanes>
+class ParamSmoother
+{
+public:
+    static constexpr int SIZE = NumLanes;
+
+    /** Default glide time for a parameter jump */
+    static constexpr float DEFAULT_RAMP_MS = 20.0f;
+
+    /**
+     * @brief Set the ramp length from the sample rate
+     *
+     * Moving lanes land on their targets, so nothing ramps at the old rate.
+     */
+    void prepare(double sampleRate, float rampMs = DEFAULT_RAMP_MS)
+    {
+        rate = static_cast<float>(sampleRate);
+        defaultRampMs = rampMs;
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            updateRampSamples(lane);
+            land(lane);
+        }
+        numActive = 0;
+        inActive.fill(false);
+    }
+
+    /** Give one lane its own ramp time (0 = prepare()'s); takes effect from the next target */
+    void setRampTime(int lane, float rampMs)
+    {
+        laneRampMs[idx(lane)] = rampMs;
+        updateRampSamples(lane);
+    }
+
+    /** Jump to value and stop ramping; the next setTarget() jumps too */
+    void reset(int lane, float value)
+    {
+        target[idx(lane)] = value;
+        land(lane);
+        primed[idx(lane)] = false;
+    }
+
+    /** Ramp to target over the ramp time (or jump, if the lane is unprimed) */
+    void setTarget(int lane, float value)
+    {
+        const size_t i = idx(lane);
+        if (!primed[i])
+        {
+            primed[i] = true;
+            target[i] = value;
+            land(lane);
+            return;
+        }
+        if (value == target[i])
+            return;
+
+        target[i] = value;
+        remaining[i] = rampSamples[i];
+        increment[i] = (value - current[i]) / rampSamples[i];
+        activate(lane / 4);
+    }
+
+    /** Value at the start of the next sub-block */
+    float getValue(int lane) const { return current[idx(lane)]; }
+
+    float getTarget(int lane) const { return target[idx(lane)]; }
+
+    bool isMoving(int lane) const { return remaining[idx(lane)] > 0.0f; }
+
+    /** True if any lane is still ramping */
+    bool anyMoving() const { return numActive > 0; }
+
+    /**
+     * @brief Write a lane's per-sample values for the next n samples
+     *
+     * Doesn't move the lane: call advance(n) once every consumer has read
+     * this sub-block.
+     */
+    void renderRamp(int lane, float* out, int n) const
+    {
+        const size_t i = idx(lane);
+        const int ramping = std::min(n, static_cast<int>(remaining[i]));
+        for (int s = 0; s < ramping; ++s)
+            out[s] = current[i] + increment[i] * static_cast<float>(s);
+        std::fill(out + ramping, out + n, target[i]);
+    }
+
+    /** Move every ramping lane n samples on; settled lanes leave the active set */
+    void advance(int n)
+    {
+        const auto steps = SIMD_MM(set1_ps)(static_cast<float>(n));
+        const auto zero = SIMD_MM(setzero_ps)();
+
+        for (int k = numActive - 1; k >= 0; --k)
+        {
+            const int base = activeGroups[static_cast<size_t>(k)] * 4;
+            auto v = SIMD_MM(load_ps)(current.data() + base);
+            auto inc = SIMD_MM(load_ps)(increment.data() + base);
+            auto rem = SIMD_MM(load_ps)(remaining.data() + base);
+            const auto tgt = SIMD_MM(load_ps)(target.data() + base);
+
+            const auto taken = SIMD_MM(min_ps)(rem, steps);
+            v = SIMD_MM(add_ps)(v, SIMD_MM(mul_ps)(inc, taken));
+            rem = SIMD_MM(sub_ps)(rem, taken);
+
+            // Finished lanes snap to the target, so rounding never leaves them short
+            const auto done = SIMD_MM(cmple_ps)(rem, zero);
+            v = SIMD_MM(or_ps)(SIMD_MM(and_ps)(done, tgt), SIMD_MM(andnot_ps)(done, v));
+            inc = SIMD_MM(andnot_ps)(done, inc);
+
+            SIMD_MM(store_ps)(current.data() + base, v);
+            SIMD_MM(store_ps)(increment.data() + base, inc);
+            SIMD_MM(store_ps)(remaining.data() + base, rem);
+
+            if (SIMD_MM(movemask_ps)(done) == 0xF)
+                deactivate(k);
+        }
+    }
+
+private:
+    static constexpr int GROUPS = (NumLanes + 3) / 4;
+    static constexpr int PADDED = GROUPS * 4;
+
+    static size_t idx(int lane) { return static_cast<size_t>(lane); }
+
+    void updateRampSamples(int lane)
+    {
+        const float ms = laneRampMs[idx(lane)] > 0.0f ? laneRampMs[idx(lane)] : defaultRampMs;
+        rampSamples[idx(lane)] = std::max(1.0f, std::round(rate * ms * 0.001f));
+    }
+
+    void land(int lane)
+    {
+        const size_t i = idx(lane);
+        current[i] = target[i];
+        increment[i] = 0.0f;
+        remaining[i] = 0.0f;
+    }
+
+    void activate(int group)
+    {
+        if (inActive[static_cast<size_t>(group)])
+            return;
+        inActive[static_cast<size_t>(group)] = true;
+        activeGroups[static_cast<size_t>(numActive++)] = group;
+    }
+
+    /** Swap-remove slot k of the active list */
+    void deactivate(int k)
+    {
+        inActive[static_cast<size_t>(activeGroups[static_cast<size_t>(k)])] = false;
+        activeGroups[static_cast<size_t>(k)] = activeGroups[static_cast<size_t>(--numActive)];
+    }
+
+    // Lane state, four lanes per SIMD register (padding lanes stay settled)
+    alignas(16) std::array<float, PADDED> current{};
+    alignas(16) std::array<float, PADDED> target{};
+    alignas(16) std::array<float, PADDED> increment{};
+    alignas(16) std::array<float, PADDED> remaining{};
+
+    std::array<bool, NumLanes> primed{};
+
+    // Groups with at least one ramping lane
+    std::array<int, GROUPS> activeGroups{};
+    std::array<bool, GROUPS> inActive{};
+    int numActive = 0;
+
+    float rate = 44100.0f;
+    float defaultRampMs = DEFAULT_RAMP_MS;
+    std::array<float, NumLanes> laneRampMs{};  // 0 = defaultRampMs
+    std::array<float, NumLanes> rampSamples = filled(882.0f);  // 20 ms at 44.1 kHz until prepare()
+
+    static constexpr std::array<float, NumLanes> filled(float v)
+    {
+        std::array<float, NumLanes> a{};
+        for (auto& x : a)
+            x = v;
+        return a;
+    }
+};
@@ -0,0 +1,235 @@
+/**
+ * @file PatchModules.h
+ * @brief PatchGraph modules: oscillator, filter, VCA, mixer and voice-effect insert for user patches
+ *
+ * The runtime counterpart of GraphModules.h, for a patch the user wires
+ * while it plays (see core/dsp/PatchGraph.h):
+ *
+ *   Oscillator   DPWOscillator; input 0 offsets its pitch (semitones),
+ *                followed per sample only while it's patched
+ *   Filter       CytomicSVF, low / band / high pass; input 0 is the signal,
+ *                input 1 offsets the cutoff (octaves), read once per block
+ *   Vca          Input 0 times input 1 (gain; unity while unpatched)
+ *   Mixer        Input 0 plus input 1
+ *   Insert       One sst voice-effects unit (VoiceEffects.h) on input 0,
+ *                VoiceInsertChain::LATENCY samples late
+ *
+ * An unpatched input reads as silence, except where noted.
+ *
+ * The editor sets frequencies, cutoffs and insert parameters on modules
+ * the audio thread is playing, so those setters only store to atomics;
+ * process() picks the values up at the start of its next block.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "BandLimitedOscillator.h"
+#include "PitchTables.h"
+#include "VoiceEffects.h"
+#include "sst/filters/CytomicSVF.h"
+
+namespace PatchModules
+{
+
+struct Oscillator
+{
+    static constexpr int INPUTS = 1;
+    static constexpr int OUTPUTS = 1;
+
+    explicit Oscillator(OscShape shape = OscShape::Saw, float hz = 440.0f) : shape(shape), baseHz(hz) {}
+
+    void prepare(double sampleRate, int)
+    {
+        osc.prepare(sampleRate);
+        osc.setShape(shape);
+        playingHz = baseHz.load(std::memory_order_relaxed);
+        osc.setFrequency(playingHz);
+    }
+
+    /** Any thread; takes effect at the next block */
+    void setFrequency(float hz) { baseHz.store(hz, std::memory_order_relaxed); }
+
+    void process(const float* const* in, float* const* out, int numSamples)
+    {
+        const float hz = baseHz.load(std::memory_order_relaxed);
+        if (in[0] == nullptr)
+        {
+            if (hz != playingHz)
+            {
+                playingHz = hz;
+                osc.setFrequency(hz);
+            }
+            for (int i = 0; i < numSamples; ++i)
+                out[0][i] = osc.process();
+            return;
+        }
+
+        playingHz = -1.0f;  // Retuned per sample: set it again once unpatched
+        const auto& pitch = PitchTables::get();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            osc.setFrequency(hz * pitch.semitonesToRatio(in[0][i]));
+            out[0][i] = osc.process();
+        }
+    }
+
+    DPWOscillator osc;
+    OscShape shape;
+    std::atomic<float> baseHz;
+    float playingHz = 0.0f;  // The unpatched frequency osc is set to (audio thread)
+};
+
+struct Filter
+{
+    static constexpr int INPUTS = 2;
+    static constexpr int OUTPUTS = 1;
+
+    using Mode = sst::filters::CytomicSVF::Mode;
+
+    explicit Filter(Mode mode = Mode::Lowpass, float cutoffHz = 2000.0f, float resonance = 0.0f)
+        : mode(mode), cutoffHz(cutoffHz), resonance(resonance)
+    {
+    }
+
+    void prepare(double sampleRate, int)
+    {
+        srInv = static_cast<float>(1.0 / sampleRate);
+        nyquistHz = static_cast<float>(sampleRate * 0.5);
+        svf.init();
+    }
+
+    /** Any thread; takes effect at the next block */
+    void setCutoff(float hz) { cutoffHz.store(hz, std::memory_order_relaxed); }
+
+    /** 0-1, any thread */
+    void setResonance(float r) { resonance.store(r, std::memory_order_relaxed); }
+
+    void process(const float* const* in, float* const* out, int numSamples)
+    {
+        float hz = cutoffHz.load(std::memory_order_relaxed);
+        if (in[1] != nullptr)
+            hz *= PitchTables::get().octavesToRatio(in[1][0]);
+        svf.setCoeff(mode, std::clamp(hz, 10.0f, nyquistHz), resonance.load(std::memory_order_relaxed), srInv);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float l = in[0] != nullptr ? in[0][i] : 0.0f;
+            float r = 0.0f;
+            sst::filters::CytomicSVF::step(svf, l, r);
+            out[0][i] = l;
+        }
+    }
+
+    sst::filters::CytomicSVF svf;
+    Mode mode;
+    std::atomic<float> cutoffHz;
+    std::atomic<float> resonance;
+    float srInv = 1.0f / 48000.0f;
+    float nyquistHz = 24000.0f;
+};
+
+struct Vca
+{
+    static constexpr int INPUTS = 2;
+    static constexpr int OUTPUTS = 1;
+
+    void process(const float* const* in, float* const* out, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float x = in[0] != nullptr ? in[0][i] : 0.0f;
+            out[0][i] = in[1] != nullptr ? x * in[1][i] : x;
+        }
+    }
+};
+
+struct Mixer
+{
+    static constexpr int INPUTS = 2;
+    static constexpr int OUTPUTS = 1;
+
+    void process(const float* const* in, float* const* out, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            out[0][i] = (in[0] != nullptr ? in[0][i] : 0.0f) + (in[1] != nullptr ? in[1][i] : 0.0f);
+    }
+};
+
+/**
+ * @brief One voice-effects unit, its type fixed when it's added
+ *
+ * Parameters are the unit's own (VoiceInsert::setParam()); unset ones keep
+ * its defaults. The unit is mono here: its right channel runs on a copy of
+ * the input and is dropped.
+ */
+struct Insert
+{
+    static constexpr int INPUTS = 1;
+    static constexpr int OUTPUTS = 1;
+
+    explicit Insert(VoiceInsert::Type type = VoiceInsert::BitCrusher)
+    {
+        settings[0].type = type;
+        for (auto& p : params)
+            p.store(std::numeric_limits<float>::quiet_NaN(), std::memory_order_relaxed);
+    }
+
+    void prepare(double sampleRate, int blockSize)
+    {
+        right.assign(static_cast<size_t>(blockSize), 0.0f);
+        chain.prepare(sampleRate);
+        applyParams();
+        chain.apply(settings);
+    }
+
+    /** Any thread; takes effect at the next block. NaN puts the default back */
+    void setParam(int idx, float value)
+    {
+        if (idx >= 0 && idx < VoiceEffectConfig::MAX_FLOAT_PARAMS)
+            params[static_cast<size_t>(idx)].store(value, std::memory_order_relaxed);
+    }
+
+    void process(const float* const* in, float* const* out, int numSamples)
+    {
+        if (applyParams())
+            chain.apply(settings);
+        if (in[0] != nullptr)
+            std::copy(in[0], in[0] + numSamples, out[0]);
+        else
+            std::fill(out[0], out[0] + numSamples, 0.0f);
+        std::copy(out[0], out[0] + numSamples, right.begin());
+        chain.process(out[0], right.data(), numSamples, 0.0f);
+    }
+
+    /** Take the parameters set since the last block; true if any moved */
+    bool applyParams()
+    {
+        bool changed = false;
+        auto& s = settings[0].params;
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            const float v = params[i].load(std::memory_order_relaxed);
+            // Unset is NaN, which never equals itself
+            if (v != s[i] && !(std::isnan(v) && std::isnan(s[i])))
+            {
+                s[i] = v;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    VoiceInsertChain<1> chain;
+    std::array<VoiceInsertSettings, 1> settings{};
+    std::array<std::atomic<float>, VoiceEffectConfig::MAX_FLOAT_PARAMS> params;
+    std::vector<float> right;  // The unit's unused channel, blockSize long
+};
+
+} // namespace PatchModules
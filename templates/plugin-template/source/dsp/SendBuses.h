@@ -0,0 +1,114 @@
+/**
+ * @file SendBuses.h
+ * @brief Aux send buses: voices share a few effects instead of each running its own
+ *
+ * A reverb or a delay per voice costs its processing times the polyphony
+ * and its memory (Reverb2 alone is ~14 MB) times the voices. Space and
+ * echo are linear, so a voice can send to an effect instead: each voice
+ * adds its output, scaled by its own send level, into a bus, and the
+ * bus's effect runs once over the sum. The cost is per bus, whatever the
+ * polyphony.
+ *
+ *   SendBuses<2, 8192> sends;                    // Member of SynthEngine
+ *
+ *   sends.begin();                               // Each sub-block
+ *   sends.add(bus, voiceL, voiceR, n, level);    // Each voice, bus with level > 0
+ *   if (sends.gate(bus, n, effectTail)) {        // Fed, or its tail still rings
+ *       effect.processBlock(sends.left(bus), sends.right(bus), n);  // Wet only
+ *       sends.returnTo(bus, mixL, mixR, n);
+ *   }
+ *
+ * The buffers are allocated with the owner, so nothing here allocates. A
+ * bus nobody sent to this block isn't cleared until gate() finds its
+ * effect's tail still needs input (silence), and then it's cleared once;
+ * a bus asleep costs nothing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "SilenceGate.h"
+
+template <int NUM_BUSES, int MAX_SAMPLES>
+class SendBuses
+{
+public:
+    static constexpr int NUM = NUM_BUSES;
+
+    /** Start a sub-block: every bus empty until add() */
+    void begin() { fed.fill(false); }
+
+    /** Add a voice's output, times level, into bus */
+    void add(int bus, const float* left, const float* right, int numSamples, float level)
+    {
+        float* const l = busL[static_cast<size_t>(bus)].data();
+        float* const r = busR[static_cast<size_t>(bus)].data();
+        if (!fed[static_cast<size_t>(bus)])
+        {
+            // The first send writes rather than adds, so the bus needs no clear
+            for (int i = 0; i < numSamples; ++i)
+            {
+                l[i] = left[i] * level;
+                r[i] = right[i] * level;
+            }
+            fed[static_cast<size_t>(bus)] = true;
+            return;
+        }
+        for (int i = 0; i < numSamples; ++i)
+        {
+            l[i] += left[i] * level;
+            r[i] += right[i] * level;
+        }
+    }
+
+    /**
+     * @brief True if bus's effect has to process this sub-block
+     * @param tailSamples The effect's tail (TailGate); it runs that long after the last send
+     *
+     * An unfed bus whose effect runs is cleared first, so it processes silence.
+     */
+    bool gate(int bus, int numSamples, int64_t tailSamples)
+    {
+        const size_t b = static_cast<size_t>(bus);
+        if (!gates[b].process(!fed[b], numSamples, tailSamples))
+            return false;
+        if (!fed[b])
+        {
+            std::fill(busL[b].begin(), busL[b].begin() + numSamples, 0.0f);
+            std::fill(busR[b].begin(), busR[b].begin() + numSamples, 0.0f);
+        }
+        return true;
+    }
+
+    float* left(int bus) { return busL[static_cast<size_t>(bus)].data(); }
+    float* right(int bus) { return busR[static_cast<size_t>(bus)].data(); }
+
+    /** Mix bus, after its effect, into the output */
+    void returnTo(int bus, float* outputL, float* outputR, int numSamples, float gain = 1.0f) const
+    {
+        const float* const l = busL[static_cast<size_t>(bus)].data();
+        const float* const r = busR[static_cast<size_t>(bus)].data();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            outputL[i] += l[i] * gain;
+            outputR[i] += r[i] * gain;
+        }
+    }
+
+    /** Every bus asleep, for effects whose state has just been cleared */
+    void reset()
+    {
+        fed.fill(false);
+        for (auto& g : gates)
+            g.reset();
+    }
+
+private:
+    alignas(16) std::array<std::array<float, MAX_SAMPLES>, NUM_BUSES> busL{};
+    alignas(16) std::array<std::array<float, MAX_SAMPLES>, NUM_BUSES> busR{};
+    std::array<bool, NUM_BUSES> fed{};
+    std::array<TailGate, NUM_BUSES> gates;
+};
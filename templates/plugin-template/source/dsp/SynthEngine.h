@@ -10,7 +10,25 @@
  * - Provides parameters to voices
  *
  * Signal Flow:
- *   MIDI -> Voice Manager -> [Voice Pool] -> [Mix] -> [Effects] -> Output
+ *   MIDI -> [Chord Memory / Arpeggiator] -> Voice Manager -> [Voice Pool] -> [Mix] -> [Effects] -> Output
+ *                                                               |                ^
+ *                                                               +-> [Send Buses] +
+ *
+ * The voice manager is a VoiceAllocator (free list, release order, note
+ * map): note on and off cost the same at any polyphony. Sounding voices
+ * are kept on an index list, so a block walks only those and never reads
+ * an idle voice; each Voice keeps the state it touches per sample at its
+ * front (see Voice.h).
+ *
+ * Keys pass through a ChordMemory, then with the arp on go to the
+ * Arpeggiator instead of the voices (see core/dsp/Arpeggiator.h). Its
+ * steps split the render at their own samples, on the tempo knob's clock
+ * or the host's beat position (setTransport()).
+ *
+ * Space and echo that should follow each voice go on send buses
+ * (SendBuses.h): every voice adds its output, at its own send level, into
+ * a bus, and the bus's effect (processSendBus()) runs once over the sum.
+ * With every send at 0 the voices render straight into the mix, as before.
  *
  * @note This class is called from the audio thread - no allocations allowed
  */
@@ -20,11 +38,27 @@
 #include <array>
 #include <algorithm>
 #include "Voice.h"
-
-// SST Effects (uncomment when needed)
-// #include "sst/effects/Reverb.h"
+#include "ActiveVoiceList.h"
+#include "Arpeggiator.h"
+#include "MidiEventQueue.h"
+#include "PerfStats.h"
+#include "ModRouting.h"
+#include "SilenceGate.h"
+#include "SendBuses.h"
+#include "ParamSmoother.h"
+#include "ReleaseCull.h"
+#include "SynthParams.h"
+#include "VoiceAllocator.h"
+#include "Denormals.h"
+#include <sst/basic-blocks/modulators/Transport.h>
+
+// SST Effects (uncomment when needed), hosted through SSTEffect.h
+// #include "SSTEffect.h"
+// #include "sst/effects/Reverb2.h"
 // #include "sst/effects/Delay.h"
-// #include "sst/effects/Chorus.h"
+
+// Granular (synth-spec.granular-example.json): Clouds-style grain cloud
+// #include "GranularEngine.h"
 
 /**
  * @brief Main synthesizer engine
@@ -44,7 +78,36 @@ public:
     /** Block size for internal processing */
     static constexpr int BLOCK_SIZE = 64;
 
-    SynthEngine() = default;
+    /** Shared effects the voices send to */
+    static constexpr int NUM_SEND_BUSES = VoiceParams::SEND_BUSES;
+
+    using Transport = sst::basic_blocks::modulators::Transport;
+
+    /**
+     * Continuous parameters that glide rather than step (see ParamSmoother.h)
+     * TODO: Add a lane per continuous parameter your synth smooths
+     */
+    enum SmoothedParam
+    {
+        SmoothMasterGain,    // Per sample, in renderVoices()
+        SmoothUnisonDetune,  // Per sub-block, through VoiceParams
+        // SmoothFilterCutoff,
+        NUM_SMOOTHED
+    };
+
+    SynthEngine()
+    {
+        // Default route: pitch bend +/-2 semitones
+        modRouting.setRoute(0, ModSource::PitchBend, ModTarget::Pitch, 2.0f);
+        modRouting.resolve();
+
+        smoothers.reset(SmoothMasterGain, masterGain);
+        releaseCull.setMasterGain(masterGain);
+        smoothers.reset(SmoothUnisonDetune, params.unisonDetune);
+
+        arp.setChordMemory(&chords);
+    }
+
     ~SynthEngine() = default;
 
     //==========================================================================
@@ -60,6 +123,11 @@ public:
     {
         this->sampleRate = sampleRate;
         this->maxBlockSize = maxBlockSize;
+        perfStats.prepare(sampleRate);
+        smoothers.prepare(sampleRate);
+        modRouting.resolve(sampleRate, Voice::BLOCK_SIZE);
+        arp.prepare(sampleRate);
+        chords.reset();
 
         // Prepare all voices
         for (auto& voice : voices)
@@ -75,6 +143,7 @@ public:
         // Clear buffers
         std::fill(mixBufferL.begin(), mixBufferL.end(), 0.0f);
         std::fill(mixBufferR.begin(), mixBufferR.end(), 0.0f);
+        sendBuses.reset();
     }
 
     /**
@@ -97,7 +166,8 @@ public:
      */
     void noteOn(int note, float velocity, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset); // TODO: Implement sample-accurate timing
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOn, sampleOffset, note, velocity}))
+            return;
 
         if (velocity <= 0.0f)
         {
@@ -105,11 +175,11 @@ public:
             return;
         }
 
-        Voice* voice = findFreeVoice(note);
-        if (voice)
-        {
-            voice->noteOn(note, velocity);
-        }
+        // The arp plays its own notes from renderArp()
+        if (arpOn)
+            arp.noteOn(note, velocity);
+        else
+            chords.noteOn(note, [this, velocity](int n) { startVoice(n, velocity); });
     }
 
     /**
@@ -119,37 +189,86 @@ public:
      */
     void noteOff(int note, int sampleOffset = 0)
     {
-        juce::ignoreUnused(sampleOffset);
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::NoteOff, sampleOffset, note}))
+            return;
 
-        for (auto& voice : voices)
-        {
-            if (voice.isActive() && voice.getNote() == note && !voice.isReleasing())
-            {
-                voice.noteOff();
-                // Don't break - release all voices playing this note
-            }
-        }
+        if (arpOn)
+            arp.noteOff(note, [this](int n, float) { releaseVoice(n); });
+        else
+            chords.noteOff(note, [this](int n) { releaseVoice(n); });
     }
 
     /**
      * @brief Stop all notes immediately
+     * @param sampleOffset Sample offset within current block
      */
-    void allNotesOff()
+    void allNotesOff(int sampleOffset = 0)
     {
-        for (auto& voice : voices)
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::AllNotesOff, sampleOffset}))
+            return;
+
+        for (int v : active)
         {
-            voice.kill();
+            voices[v].kill();
         }
+        allocator.reset();
+        active.clear();
+        arp.reset();
+        chords.reset();
     }
 
     /**
      * @brief Set pitch bend amount
      * @param bend Pitch bend value (-1.0 to 1.0)
+     * @param sampleOffset Sample offset within current block
+     */
+    void setPitchBend(float bend, int sampleOffset = 0)
+    {
+        if (sampleOffset > 0 && eventQueue.push({MidiEvent::Type::PitchBend, sampleOffset, 0, bend}))
+            return;
+
+        pitchBend = bend;  // Reaches the voices through the PitchBend route
+    }
+
+    /**
+     * @brief Set the mod wheel (CC1)
+     * @param value Wheel position (0.0-1.0)
+     */
+    void setModWheel(float value)
+    {
+        modWheel = value;
+    }
+
+    //==========================================================================
+    // Modulation Routing (see ModRouting.h)
+    //==========================================================================
+
+    /**
+     * @brief Route a modulation source to a target
+     * @param slot Matrix slot (0 to ModRouting::NUM_SLOTS - 1)
+     * @param depth Target units per unit of source (semitones, octaves, gain)
+     *
+     * Re-resolves the routing table, which allocates: call with processing
+     * suspended or before prepare(). setModDepth() is the real-time way to
+     * change an existing route.
      */
-    void setPitchBend(float bend)
+    void setModRoute(int slot, ModSource source, ModTarget target, float depth)
+    {
+        modRouting.setRoute(slot, source, target, depth);
+        modRouting.resolve(sampleRate, Voice::BLOCK_SIZE);
+    }
+
+    /** Empty a matrix slot (not real-time safe, like setModRoute) */
+    void clearModRoute(int slot)
+    {
+        modRouting.clearRoute(slot);
+        modRouting.resolve(sampleRate, Voice::BLOCK_SIZE);
+    }
+
+    /** Change the depth of an existing route (audio thread safe) */
+    void setModDepth(int slot, float depth)
     {
-        pitchBend = bend;
-        // TODO: Apply pitch bend to all active voices
+        modRouting.setDepth(slot, depth);
     }
 
     //==========================================================================
@@ -164,134 +283,462 @@ public:
      */
     void renderBlock(float* outputL, float* outputR, int numSamples)
     {
-        // Clear mix buffers
-        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
-        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+        ScopedFlushDenormals noDenormals;  // FTZ whatever the caller set (see Denormals.h)
 
-        // Render all active voices
-        for (auto& voice : voices)
-        {
-            if (voice.isActive())
+        perfStats.beginBlock();
+        silentBlock = true;
+
+        // Split the block at queued MIDI events so they land on their sample
+        eventQueue.process(numSamples,
+            [this, outputL, outputR](int start, int count)
             {
-                // TODO: Update voice parameters before rendering
-                // voice.setFilterCutoff(filterCutoff);
-                // voice.setFilterResonance(filterResonance);
+                renderSteps(outputL + start, outputR + start, count);
+            },
+            [this](const MidiEvent& event) { handleEvent(event); });
 
-                voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
-            }
-        }
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, getActiveVoiceCount());
+    }
 
-        // ====================================================================
-        // GLOBAL EFFECTS
-        // TODO: Add effects processing
-        // ====================================================================
+    //==========================================================================
+    // Parameter Setters
+    //==========================================================================
 
-        // TODO: Apply effects
-        // Example:
-        // if (reverbEnabled) {
-        //     reverb.process(mixBufferL.data(), mixBufferR.data(), numSamples);
-        // }
+    // TODO: Add parameter setters for your synth
+    // Voice parameters go through updateParam() so voices only re-derive
+    // coefficients when something actually changed. Continuous ones glide:
+    // the setter sets a smoother target and renderVoices() feeds the
+    // moving value to updateParam() each sub-block.
 
-        // Apply master volume
-        float gain = masterGain;
-        for (int i = 0; i < numSamples; ++i)
+    void setMasterVolume(float volumeDb)
+    {
+        if (volumeDb != masterVolumeDb)
         {
-            outputL[i] = mixBufferL[i] * gain;
-            outputR[i] = mixBufferR[i] * gain;
+            // Convert dB to linear gain
+            masterVolumeDb = volumeDb;
+            masterGain = std::pow(10.0f, volumeDb / 20.0f);
+            releaseCull.setMasterGain(masterGain);
         }
+        smoothers.setTarget(SmoothMasterGain, masterGain);  // The first call jumps
+    }
+
+    /**
+     * @brief Free releasing voices once they fall under this level at the output
+     * @param db Re full scale (ReleaseCull::DEFAULT_DB unless set; -inf: only when they idle)
+     */
+    void setCullThreshold(float db) { releaseCull.setThreshold(db); }
+    float getCullThreshold() const { return releaseCull.getThreshold(); }
+
+    void setUnisonVoices(int voices) { updateParam(params.unisonVoices, voices); }
+
+    /** Which voice a note steals when all are busy: 0 Oldest, 1 Quietest, 2 Same Note */
+    void setVoiceSteal(int policy) { allocator.setStealPolicy(static_cast<VoiceAllocator<MAX_VOICES>::StealPolicy>(std::clamp(policy, 0, 2))); }
+
+    void setUnisonDetune(float cents)
+    {
+        smoothers.setTarget(SmoothUnisonDetune, cents);
+        updateParam(params.unisonDetune, smoothers.getValue(SmoothUnisonDetune));
+    }
+
+    /** Voice drive, 0 (off) to 1; each voice oversamples it as far as its note needs */
+    void setDrive(float amount) { updateParam(params.drive, std::clamp(amount, 0.0f, 1.0f)); }
+
+    /** Per-voice insert slot unit (VoiceInsert::Type) */
+    void setInsertType(int slot, int type)
+    {
+        if (slot >= 0 && slot < VoiceParams::INSERT_SLOTS)
+            updateParam(params.inserts[static_cast<size_t>(slot)].type, type);
+    }
+
+    /** Insert parameter idx in the slot's unit's own units (its paramAt(idx)) */
+    void setInsertParam(int slot, int idx, float value)
+    {
+        if (slot >= 0 && slot < VoiceParams::INSERT_SLOTS && idx >= 0 && idx < VoiceEffectConfig::MAX_FLOAT_PARAMS)
+            updateParam(params.inserts[static_cast<size_t>(slot)].params[static_cast<size_t>(idx)], value);
+    }
+
+    void setInsertIntParam(int slot, int idx, int value)
+    {
+        if (slot >= 0 && slot < VoiceParams::INSERT_SLOTS && idx >= 0 && idx < VoiceEffectConfig::MAX_INT_PARAMS)
+            updateParam(params.inserts[static_cast<size_t>(slot)].intParams[static_cast<size_t>(idx)], value);
+    }
+
+    /** How much every voice sends to a bus's effect (0-1; the voice may scale it) */
+    void setSendLevel(int bus, float level)
+    {
+        if (bus >= 0 && bus < NUM_SEND_BUSES)
+            updateParam(params.sends[static_cast<size_t>(bus)], std::clamp(level, 0.0f, 1.0f));
     }
 
     //==========================================================================
-    // Parameter Setters
+    // Arpeggiator and Chord Memory (see core/dsp/Arpeggiator.h)
     //==========================================================================
 
-    // TODO: Add parameter setters for your synth
-    // These should store values that get passed to voices in renderBlock
+    /** 0 Off, 1 Up, 2 Down, 3 Up/Down, 4 As Played, 5 Random */
+    void setArpMode(int choice)
+    {
+        const bool on = choice > 0;
+        if (on != arpOn)
+        {
+            // Whatever the other path started stops; keys still down play again when pressed
+            arp.stop([this](int n, float) { releaseVoice(n); });
+            chords.releaseAll([this](int n) { releaseVoice(n); });
+            arpOn = on;
+        }
+        if (on)
+            arp.setMode(static_cast<Arpeggiator::Mode>(std::min(choice - 1, 4)));
+    }
 
-    void setMasterVolume(float volumeDb)
+    /** Step length: 0 1/4, 1 1/8, 2 1/8T, 3 1/16, 4 1/16T, 5 1/32 */
+    void setArpRate(int choice)
     {
-        // Convert dB to linear gain
-        masterGain = std::pow(10.0f, volumeDb / 20.0f);
+        static constexpr std::array<double, 6> stepsPerBeat{1.0, 2.0, 3.0, 4.0, 6.0, 8.0};
+        arp.setStepsPerBeat(stepsPerBeat[static_cast<size_t>(std::clamp(choice, 0, 5))]);
     }
 
-    // void setFilterCutoff(float cutoffHz) { filterCutoff = cutoffHz; }
-    // void setFilterResonance(float reso) { filterResonance = reso; }
+    void setArpOctaves(int octaves) { arp.setOctaves(octaves); }
+
+    /** Note length, a fraction of the step */
+    void setArpGate(float fraction) { arp.setGate(fraction); }
+
+    /** The arp's tempo when the host isn't playing */
+    void setTempo(float bpm) { arp.setTempo(bpm); }
+
+    /** 0 Off, 1 Major, 2 Minor, 3 Sus4, 4 Maj7, 5 Min7, 6 Fifths, 7 Memory */
+    void setChordShape(int choice)
+    {
+        chords.setShape(static_cast<ChordMemory::Shape>(std::clamp(choice, 0, 7)));
+        arp.chordChanged();
+    }
+
+    /** Learn the chord the Memory shape plays, from its notes (audio thread) */
+    void memorizeChord(const int* notes, int count)
+    {
+        chords.memorize(notes, count);
+        arp.chordChanged();
+    }
+
+    /**
+     * @brief Follow the host's transport, from the next applySnapshot()
+     *
+     * While the host plays, its tempo stands in for the tempo knob and each
+     * block lines the arp's steps up with the host's beat position. With
+     * the host stopped the arp runs on its own clock, from the first key.
+     */
+    void setTransport(const Transport& transport)
+    {
+        const bool playing = (transport.status & Transport::PLAYING) != 0;
+        if (playing != hostPlaying || (playing && transport.tempo != hostTempo))
+            hostTempoChanged = true;
+        hostPlaying = playing;
+        hostTempo = transport.tempo;
+        hostBeats = transport.hostTimeInBeats;
+    }
+
+    // void setFilterCutoff(float cutoffHz) { smoothers.setTarget(SmoothFilterCutoff, cutoffHz); }
+    // void setFilterResonance(float reso) { updateParam(params.filterResonance, reso); }
     // void setReverbMix(float mix) { reverbMix = mix; }
 
+    /**
+     * @brief Apply one block's parameters, calling only the setters whose inputs moved
+     *
+     * The processor's per-block entry point (see SynthParams.h). Setters
+     * that take several parameters re-run when any of them changed.
+     */
+    void applySnapshot(const SynthParams& p)
+    {
+        // TODO: One line per parameter (or group) in SynthParams.h
+        // Example:
+        // if (p.changed(kFilterCutoff)) setFilterCutoff(p[kFilterCutoff]);
+        // if (p.changed(kAmpAttack, kAmpDecay, kAmpSustain, kAmpRelease))
+        //     setAmpEnvelope(p[kAmpAttack], p[kAmpDecay], p[kAmpSustain], p[kAmpRelease]);
+
+        // Arp: the host's tempo and position while it plays (setTransport)
+        if (p.changed(kArpTempo) || hostTempoChanged) setTempo(hostPlaying ? static_cast<float>(hostTempo) : p[kArpTempo]);
+        hostTempoChanged = false;
+        if (p.changed(kArpMode)) setArpMode(p.index(kArpMode));
+        if (p.changed(kArpRate)) setArpRate(p.index(kArpRate));
+        if (p.changed(kArpOctaves)) setArpOctaves(p.index(kArpOctaves));
+        if (p.changed(kArpGate)) setArpGate(p[kArpGate]);
+        if (p.changed(kChordShape)) setChordShape(p.index(kChordShape));
+        if (hostPlaying)
+            arp.syncTo(hostBeats);
+        else
+            arp.freeRun();
+
+        // Master
+        if (p.changed(kMasterVolume)) setMasterVolume(p[kMasterVolume]);
+    }
+
+    /** Current parameter revision (changes whenever any voice parameter changes) */
+    uint32_t getParamRevision() const { return paramRevision; }
+
     //==========================================================================
     // State Queries
     //==========================================================================
 
-    int getActiveVoiceCount() const
+    int getActiveVoiceCount() const { return active.size(); }
+
+    /** What the editor shows, copied once per block (see core/dsp/StatePublisher.h) */
+    struct EditorState
     {
-        int count = 0;
-        for (const auto& voice : voices)
-        {
-            if (voice.isActive())
-                ++count;
-        }
-        return count;
+        int activeVoices = 0;
+    };
+
+    EditorState getEditorState() const { return {getActiveVoiceCount()}; }
+
+    /** CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
+    /** True if nothing sounded (no voice, no effect tail) during the last renderBlock() */
+    bool isSilent() const { return silentBlock; }
+
+    /**
+     * @brief Samples the output trails the notes by, for the host's delay compensation
+     *
+     * The sum of every stage in series that delays the signal; add any
+     * stage's getLatency() here as you put it in (an Oversampler's, say).
+     */
+    int getLatencySamples() const
+    {
+        // The drive's oversampler is as late at 1x as at 4x (Voice::getLatency())
+        return (params.drive > 0.0f ? Oversampler::LATENCY : 0)
+             + VoiceInsertChain<VoiceParams::INSERT_SLOTS>::latencyFor(params.inserts);
     }
 
 private:
     //==========================================================================
-    // Voice Management
+    // Rendering
     //==========================================================================
 
-    /**
-     * @brief Find a free voice or steal one
-     * @param note The note to be played (used for note stealing priority)
-     * @return Pointer to available voice, or nullptr if none available
-     */
-    Voice* findFreeVoice(int note)
+    /** Render one sub-block between MIDI events, split at the arp's steps and gate ends */
+    void renderSteps(float* outputL, float* outputR, int numSamples)
     {
-        // First, look for an inactive voice
-        for (auto& voice : voices)
+        if (!arpOn)
         {
-            if (!voice.isActive())
-            {
-                return &voice;
-            }
+            renderVoices(outputL, outputR, numSamples);
+            return;
         }
 
-        // No free voice - use voice stealing
+        for (int i = 0; i < numSamples;)
+        {
+            const int n = arp.next(numSamples - i, [this](int note, float velocity) {
+                if (velocity > 0.0f)
+                    startVoice(note, velocity);
+                else
+                    releaseVoice(note);
+            });
+            renderVoices(outputL + i, outputR + i, n);
+            i += n;
+        }
+    }
 
-        // Strategy 1: Steal oldest voice in release phase
-        Voice* oldest = nullptr;
-        int oldestAge = -1;
+    /** Render one run of samples, no note starting or stopping inside it */
+    void renderVoices(float* outputL, float* outputR, int numSamples)
+    {
+        // Clear mix buffers
+        std::fill(mixBufferL.begin(), mixBufferL.begin() + numSamples, 0.0f);
+        std::fill(mixBufferR.begin(), mixBufferR.begin() + numSamples, 0.0f);
+
+        // Smoothed voice parameters move once per sub-block; an unchanged
+        // value costs one compare (updateParam)
+        updateParam(params.unisonDetune, smoothers.getValue(SmoothUnisonDetune));
+        // updateParam(params.filterCutoff, smoothers.getValue(SmoothFilterCutoff));
 
-        for (auto& voice : voices)
         {
-            if (voice.isReleasing() && voice.getAge() > oldestAge)
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            // Global modulation, once per sub-block; no routes = no work
+            modRouting.setSource(ModSource::PitchBend, pitchBend);
+            modRouting.setSource(ModSource::ModWheel, modWheel);
+            modRouting.process();
+            const float pitchMod = modRouting.get(ModTarget::Pitch);
+            const float cutoffMod = modRouting.get(ModTarget::FilterCutoff);
+            const float ampMod = modRouting.get(ModTarget::Amp);
+
+            // Releases too quiet to hear give their voices back first
+            releaseCull.process(active, voices, [this](int v)
             {
-                oldest = &voice;
-                oldestAge = voice.getAge();
-            }
+                voices[v].kill();
+                allocator.voiceFinished(v);
+            });
+
+            silentBlock = silentBlock && active.isEmpty();
+
+            // With a send up each voice renders on its own, to be mixed and sent
+            const bool sending = std::any_of(params.sends.begin(), params.sends.end(), [](float s) { return s > 0.0f; });
+            sendBuses.begin();
+
+            // Render the sounding voices
+            active.update([&](int v)
+            {
+                Voice& voice = voices[v];
+
+                // Re-derives coefficients only if a setter ran since the last block
+                voice.applyParams(params, paramRevision);
+                voice.setModulation(pitchMod, cutoffMod, ampMod);
+
+                if (sending)
+                    renderVoiceWithSends(voice, numSamples);
+                else
+                    voice.render(mixBufferL.data(), mixBufferR.data(), numSamples);
+
+                // Its release ended: back on the free list, off this one
+                if (!voice.isActive())
+                    allocator.voiceFinished(v);
+                return voice.isActive();
+            });
         }
 
-        if (oldest)
         {
-            oldest->kill();
-            return oldest;
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Effects);
+
+            // ================================================================
+            // GLOBAL EFFECTS
+            // TODO: Add effects processing
+            // ================================================================
+
+            // Send buses: each effect once over what the voices sent it,
+            // asleep once the sends have stopped and its tail has run out
+            for (int bus = 0; bus < NUM_SEND_BUSES; ++bus)
+            {
+                if (sendBuses.gate(bus, numSamples, sendTailSamples(bus))
+                    && processSendBus(bus, sendBuses.left(bus), sendBuses.right(bus), numSamples))
+                {
+                    sendBuses.returnTo(bus, mixBufferL.data(), mixBufferR.data(), numSamples);
+                    silentBlock = false;
+                }
+            }
+
+            // TODO: Apply effects, each behind a TailGate (SilenceGate.h) so
+            // it sleeps once its input and its tail have died away
+            // Example:
+            // bool silent = Silence::isSilent(mixBufferL.data(), mixBufferR.data(), numSamples);
+            // if (reverbEnabled && reverbGate.process(silent, numSamples, reverb.getTailSamples())) {
+            //     reverb.process(mixBufferL.data(), mixBufferR.data(), numSamples);
+            //     silentBlock = silent = false;  // Its tail is still audible
+            // }
         }
 
-        // Strategy 2: Steal oldest playing voice
-        for (auto& voice : voices)
         {
-            if (voice.getAge() > oldestAge)
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+
+            // Apply master volume, ramping while it glides to a new setting
+            if (smoothers.isMoving(SmoothMasterGain))
             {
-                oldest = &voice;
-                oldestAge = voice.getAge();
+                smoothers.renderRamp(SmoothMasterGain, gainRamp.data(), numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    outputL[i] = mixBufferL[i] * gainRamp[i];
+                    outputR[i] = mixBufferR[i] * gainRamp[i];
+                }
             }
+            else
+            {
+                float gain = smoothers.getValue(SmoothMasterGain);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    outputL[i] = mixBufferL[i] * gain;
+                    outputR[i] = mixBufferR[i] * gain;
+                }
+            }
+        }
+
+        smoothers.advance(numSamples);
+    }
+
+    /** Render a voice on its own, then into the mix and every bus it sends to */
+    void renderVoiceWithSends(Voice& voice, int numSamples)
+    {
+        std::fill(voiceBufferL.begin(), voiceBufferL.begin() + numSamples, 0.0f);
+        std::fill(voiceBufferR.begin(), voiceBufferR.begin() + numSamples, 0.0f);
+        voice.render(voiceBufferL.data(), voiceBufferR.data(), numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            mixBufferL[i] += voiceBufferL[i];
+            mixBufferR[i] += voiceBufferR[i];
+        }
+        for (int bus = 0; bus < NUM_SEND_BUSES; ++bus)
+        {
+            const float level = voice.getSendLevel(bus);
+            if (level > 0.0f)
+                sendBuses.add(bus, voiceBufferL.data(), voiceBufferR.data(), numSamples, level);
+        }
+    }
+
+    /**
+     * @brief Run a bus's effect over its buffer, in place and wet only
+     * @return False if the bus has no effect, so what was sent to it is dropped
+     */
+    bool processSendBus(int bus, [[maybe_unused]] float* left, [[maybe_unused]] float* right,
+                        [[maybe_unused]] int numSamples)
+    {
+        switch (bus)
+        {
+        // TODO: One shared effect per bus (SSTEffect.h), its mix at 1
+        // Example:
+        // case 0: reverb.processBlock(left, right, numSamples); return true;
+        // case 1: delay.processBlock(left, right, numSamples); return true;
+        default: return false;
         }
+    }
 
-        if (oldest)
+    /** How long a bus's effect rings after its last send (TailGate) */
+    int64_t sendTailSamples(int bus) const
+    {
+        switch (bus)
         {
-            oldest->kill();
-            return oldest;
+        // TODO: The effect's tail, e.g. its decay time
+        // case 0: return static_cast<int64_t>(reverbDecaySeconds * sampleRate);
+        default: return 0;
         }
+    }
+
+    /** Give a note a voice: the chord memory's and the arp's notes land here */
+    void startVoice(int note, float velocity)
+    {
+        const auto slot = allocator.noteOn(note, [this](int v) { return voices[v].getLevel(); });
+        Voice& voice = voices[slot.voice];
+        if (slot.stolen)
+            voice.kill();
 
-        return nullptr;
+        // Idle voices skip applyParams in renderBlock, so catch up first
+        voice.applyParams(params, paramRevision);
+        voice.noteOn(note, velocity);
+        active.add(slot.voice);  // A stolen voice is listed already
+    }
+
+    /** Release every voice holding this note, not just the newest */
+    void releaseVoice(int note)
+    {
+        allocator.noteOff(note, [this](int v) { voices[v].noteOff(); });
+    }
+
+    /** Apply a queued MIDI event at the start of its sub-block */
+    void handleEvent(const MidiEvent& event)
+    {
+        switch (event.type)
+        {
+        case MidiEvent::Type::NoteOn: noteOn(event.note, event.value); break;
+        case MidiEvent::Type::NoteOff: noteOff(event.note); break;
+        case MidiEvent::Type::AllNotesOff: allNotesOff(); break;
+        case MidiEvent::Type::PitchBend: setPitchBend(event.value); break;
+        default: break;
+        }
+    }
+
+    /**
+     * @brief Store a parameter and bump the revision if it actually changed
+     */
+    template <typename T>
+    void updateParam(T& field, T value)
+    {
+        if (field != value)
+        {
+            field = value;
+            ++paramRevision;
+        }
     }
 
     //==========================================================================
@@ -300,12 +747,24 @@ private:
 
     std::array<Voice, MAX_VOICES> voices;
 
+    /** Which voice plays which note, and which goes next */
+    VoiceAllocator<MAX_VOICES> allocator;
+
+    /** The sounding voices: the only ones rendered or counted */
+    ActiveVoiceList<MAX_VOICES> active;
+
     //==========================================================================
     // Mix Buffers (pre-allocated for real-time safety)
     //==========================================================================
 
     std::array<float, 8192> mixBufferL{};
     std::array<float, 8192> mixBufferR{};
+    std::array<float, 8192> gainRamp{};  // Master gain per sample while it glides
+    std::array<float, 8192> voiceBufferL{};  // One voice's output, while it sends
+    std::array<float, 8192> voiceBufferR{};
+
+    /** Voices' sends, summed per bus for the shared effects */
+    SendBuses<NUM_SEND_BUSES, 8192> sendBuses;
 
     //==========================================================================
     // Engine State
@@ -314,15 +773,46 @@ private:
     double sampleRate = 44100.0;
     int maxBlockSize = 512;
     float pitchBend = 0.0f;
-    float masterGain = 0.5f;  // -6dB default
+    float modWheel = 0.0f;
+    float masterGain = 0.5f;  // -6dB default; the target, see smoothers
+    float masterVolumeDb = -6.0206f;  // 20 * log10(masterGain)
+    ReleaseCull releaseCull;  // Knows masterGain (setMasterVolume())
+    bool silentBlock = true;  // No voice sounded in the last renderBlock()
+
+    /** MIDI events scheduled later in the current block */
+    MidiEventQueue eventQueue;
+
+    /** Keys -> chords -> (arp steps) -> startVoice() */
+    ChordMemory chords;
+    Arpeggiator arp;
+    bool arpOn = false;
+
+    // Host transport (setTransport)
+    bool hostPlaying = false;
+    bool hostTempoChanged = false;
+    double hostTempo = 120.0;
+    double hostBeats = 0.0;
+
+    /** Per-block CPU counters, read by the editor */
+    PerfStats perfStats;
+
+    /** Global sources -> voice offsets, resolved when the routing changes */
+    ModRouting modRouting;
 
     //==========================================================================
     // Global Parameters
     // TODO: Add parameters for your synth
     //==========================================================================
 
-    // float filterCutoff = 5000.0f;
-    // float filterResonance = 0.0f;
+    /** Snapshot applied to voices; see Voice::applyParams */
+    VoiceParams params;
+
+    /** Starts at 1 so freshly constructed voices (revision 0) always sync */
+    uint32_t paramRevision = 1;
+
+    /** Ramps for the SmoothedParam lanes */
+    ParamSmoother<NUM_SMOOTHED> smoothers;
+
     // float reverbMix = 0.0f;
     // bool reverbEnabled = false;
 
@@ -331,7 +821,9 @@ private:
     // TODO: Uncomment and configure for your architecture
     //==========================================================================
 
-    // sst::effects::Reverb reverb;
-    // sst::effects::Delay delay;
-    // sst::effects::Chorus chorus;
+    // SSTEffect<sst::effects::reverb2::Reverb2> reverb;  // prepare(), setParam(), processBlock()
+    // TailGate reverbGate;
+    // SSTEffect<sst::effects::delay::Delay> delay;
+    // On a send bus (processSendBus()) an effect needs no gate of its own
+    // GranularEngine grains;  // prepare(), setPosition()/setDensity()..., process()
 };
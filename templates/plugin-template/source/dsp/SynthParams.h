@@ -0,0 +1,58 @@
+/**
+ * @file SynthParams.h
+ * @brief Parameter list: the ParamId enum and the APVTS ID table
+ *
+ * SYNTH_PARAMS has one entry per parameter in
+ * PluginProcessor::createParameterLayout(), in the same order. The ParamId
+ * enum (kName) and the kParamIds string table are both generated from it,
+ * so an index can't point at the wrong ID. Adding a parameter is a line
+ * here, next to its createParameterLayout() entry, plus its setter call in
+ * SynthEngine::applySnapshot().
+ */
+
+#pragma once
+
+#include "ParamSnapshot.h"
+
+// X(enumName, parameterId)
+// TODO: Keep in step with createParameterLayout()
+#define SYNTH_PARAMS(X) \
+    X(Osc1Waveform,    "osc1_waveform") \
+    X(Osc1Level,       "osc1_level") \
+    X(Osc1Tune,        "osc1_tune") \
+    X(FilterCutoff,    "filter_cutoff") \
+    X(FilterReso,      "filter_reso") \
+    X(FilterEnvAmount, "filter_env_amount") \
+    X(AmpAttack,       "amp_attack") \
+    X(AmpDecay,        "amp_decay") \
+    X(AmpSustain,      "amp_sustain") \
+    X(AmpRelease,      "amp_release") \
+    X(FilterAttack,    "filter_attack") \
+    X(FilterDecay,     "filter_decay") \
+    X(FilterSustain,   "filter_sustain") \
+    X(FilterRelease,   "filter_release") \
+    X(ArpMode,         "arp_mode") \
+    X(ArpRate,         "arp_rate") \
+    X(ArpOctaves,      "arp_octaves") \
+    X(ArpGate,         "arp_gate") \
+    X(ArpTempo,        "arp_tempo") \
+    X(ChordShape,      "chord_shape") \
+    X(MasterVolume,    "master_volume")
+
+enum ParamId : int
+{
+#define SYNTH_PARAM_ENUM(name, id) k##name,
+    SYNTH_PARAMS(SYNTH_PARAM_ENUM)
+#undef SYNTH_PARAM_ENUM
+    kNumParams
+};
+
+/** APVTS parameter ID of each ParamId */
+inline constexpr const char* kParamIds[kNumParams] = {
+#define SYNTH_PARAM_ID(name, id) id,
+    SYNTH_PARAMS(SYNTH_PARAM_ID)
+#undef SYNTH_PARAM_ID
+};
+
+/** One block's parameter values for applySnapshot() */
+using SynthParams = ParamSnapshot<kNumParams>;
@@ -0,0 +1,183 @@
+/**
+ * @file UnisonOscillator.h
+ * @brief Up to four detuned saws in one SIMD register (supersaw-style unison)
+ *
+ * Each unison copy is one lane of a 4-wide DPW saw (the cubic integrated
+ * saw from sst-basic-blocks' DPWSawOscillator, differentiated twice), so
+ * one to four copies cost the same. Detune spread and the stereo pan law
+ * come from sst's UnisonSetup, the slow random pitch wander from its
+ * DriftLFO, both as Surge uses them.
+ *
+ * Detune and drift are applied once per render() call; the phase
+ * increments ramp linearly across the call, so pitch changes between
+ * blocks don't step.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "sst/basic-blocks/simd/setup.h"
+#include "sst/basic-blocks/mechanics/simd-ops.h"
+#include "sst/basic-blocks/dsp/OscillatorDriftUnisonCharacter.h"
+
+#include "PitchTables.h"
+
+class UnisonOscillator
+{
+public:
+    /** Copies per oscillator: one SSE register */
+    static constexpr int MAX_VOICES = 4;
+
+    UnisonOscillator() { setVoices(1); }
+
+    void prepare(double sr)
+    {
+        sampleRateInv = 1.0f / static_cast<float>(sr);
+        for (int v = 0; v < MAX_VOICES; ++v)
+            drift[static_cast<size_t>(v)].init(v > 0);
+        reset();
+    }
+
+    /** Restart every copy (note on); copies start spread so they don't phase */
+    void reset()
+    {
+        for (int v = 0; v < MAX_VOICES; ++v)
+        {
+            phase[v] = static_cast<float>(v) / MAX_VOICES;
+            increment[v] = 0.0f;
+        }
+        snap = true;
+    }
+
+    /** Number of unison copies (1-4) */
+    void setVoices(int n)
+    {
+        n = std::clamp(n, 1, MAX_VOICES);
+        if (n == voices)
+            return;
+        voices = n;
+
+        const sst::basic_blocks::dsp::UnisonSetup<float> setup(n);
+        for (int v = 0; v < MAX_VOICES; ++v)
+        {
+            if (v < n)
+            {
+                spread[static_cast<size_t>(v)] = setup.detune(v);
+                setup.attenuatedPanLaw(v, panL[v], panR[v]);
+            }
+            else
+            {
+                // Unused lanes still run, silently
+                spread[static_cast<size_t>(v)] = 0.0f;
+                panL[v] = 0.0f;
+                panR[v] = 0.0f;
+            }
+        }
+    }
+
+    /** Detune of the outermost copies, in cents either side */
+    void setDetune(float cents) { detuneCents = cents; }
+
+    /** Random pitch wander, in cents (0 = off) */
+    void setDrift(float cents) { driftCents = cents; }
+
+    void setFrequency(float freqHz) { frequency = freqHz; }
+
+    int getVoices() const { return voices; }
+
+    /**
+     * @brief Render n samples of the unison stack (overwrites the buffers)
+     * @param n Samples, at most one block
+     */
+    void render(float* left, float* right, int n)
+    {
+        const auto& tables = PitchTables::get();
+        const float baseInc = std::min(frequency * sampleRateInv, 0.45f);
+
+        alignas(16) float target[MAX_VOICES];
+        for (int v = 0; v < MAX_VOICES; ++v)
+        {
+            auto& lfo = drift[static_cast<size_t>(v)];
+            const float wander = driftCents != 0.0f ? lfo.next() * driftCents : 0.0f;
+            const float cents = spread[static_cast<size_t>(v)] * detuneCents + wander;
+            target[v] = baseInc * tables.centsToRatio(cents);
+        }
+
+        if (snap)
+        {
+            std::copy(target, target + MAX_VOICES, increment);
+            snap = false;
+        }
+
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto zero = SIMD_MM(setzero_ps)();
+        const auto two = SIMD_MM(set1_ps)(2.0f);
+        const auto three = SIMD_MM(set1_ps)(3.0f);
+        const auto sixth = SIMD_MM(set1_ps)(1.0f / 6.0f);
+        const auto gainL = SIMD_MM(load_ps)(panL);
+        const auto gainR = SIMD_MM(load_ps)(panR);
+
+        auto ph = SIMD_MM(load_ps)(phase);
+        auto dp = SIMD_MM(load_ps)(increment);
+        const auto ddp = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(load_ps)(target), dp),
+                                         SIMD_MM(set1_ps)(1.0f / static_cast<float>(std::max(n, 1))));
+
+        for (int i = 0; i < n; ++i)
+        {
+            // Naive saw away from the wrap; within 3 steps of it, the second
+            // difference of the integrated saw (x^3 - x) / 6
+            const auto naive = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, ph), one);
+            const auto y0 = integratedSaw(ph, one, zero, two, sixth);
+            const auto yNext = integratedSaw(SIMD_MM(add_ps)(ph, dp), one, zero, two, sixth);
+            const auto yPrev = integratedSaw(SIMD_MM(sub_ps)(ph, dp), one, zero, two, sixth);
+            const auto curvature = SIMD_MM(sub_ps)(SIMD_MM(add_ps)(yNext, yPrev), SIMD_MM(mul_ps)(two, y0));
+            const auto dpw = SIMD_MM(div_ps)(curvature, SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(4.0f), SIMD_MM(mul_ps)(dp, dp)));
+
+            const auto edge = SIMD_MM(mul_ps)(three, dp);
+            const auto nearWrap = SIMD_MM(or_ps)(SIMD_MM(cmplt_ps)(ph, edge),
+                                                 SIMD_MM(cmpgt_ps)(ph, SIMD_MM(sub_ps)(one, edge)));
+            const auto out = SIMD_MM(or_ps)(SIMD_MM(and_ps)(nearWrap, dpw), SIMD_MM(andnot_ps)(nearWrap, naive));
+
+            left[i] = sst::basic_blocks::mechanics::sum_ps_to_float(SIMD_MM(mul_ps)(out, gainL));
+            right[i] = sst::basic_blocks::mechanics::sum_ps_to_float(SIMD_MM(mul_ps)(out, gainR));
+
+            ph = wrap(SIMD_MM(add_ps)(ph, dp), one, zero);
+            dp = SIMD_MM(add_ps)(dp, ddp);
+        }
+
+        SIMD_MM(store_ps)(phase, ph);
+        std::copy(target, target + MAX_VOICES, increment);
+    }
+
+private:
+    /** Phase back into [0, 1) - it never moves more than one step outside */
+    static SIMD_M128 wrap(SIMD_M128 p, SIMD_M128 one, SIMD_M128 zero)
+    {
+        p = SIMD_MM(sub_ps)(p, SIMD_MM(and_ps)(SIMD_MM(cmpge_ps)(p, one), one));
+        return SIMD_MM(add_ps)(p, SIMD_MM(and_ps)(SIMD_MM(cmplt_ps)(p, zero), one));
+    }
+
+    /** (x^3 - x) / 6 with x = 2 * wrap(p) - 1 */
+    static SIMD_M128 integratedSaw(SIMD_M128 p, SIMD_M128 one, SIMD_M128 zero, SIMD_M128 two,
+                                   SIMD_M128 sixth)
+    {
+        const auto x = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, wrap(p, one, zero)), one);
+        return SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(x, x), one), x), sixth);
+    }
+
+    alignas(16) float phase[MAX_VOICES]{};
+    alignas(16) float increment[MAX_VOICES]{};
+    alignas(16) float panL[MAX_VOICES]{};
+    alignas(16) float panR[MAX_VOICES]{};
+    std::array<float, MAX_VOICES> spread{};
+    std::array<sst::basic_blocks::dsp::DriftLFO, MAX_VOICES> drift{};
+
+    float sampleRateInv = 1.0f / 44100.0f;
+    float frequency = 440.0f;
+    float detuneCents = 10.0f;
+    float driftCents = 0.0f;
+    int voices = 0;
+    bool snap = true;
+};
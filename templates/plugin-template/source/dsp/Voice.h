@@ -6,11 +6,19 @@
  * a single note. Multiple voices enable polyphony.
  *
  * Signal Flow:
- *   Oscillators -> [Mix] -> Filter -> Amp Envelope -> Output
+ *   Oscillators -> [Mix] -> Filter -> Amp Envelope -> Drive -> Inserts -> Output
+ *
+ * The drive (tanh, off at 0) runs oversampled only as far as the note
+ * needs: the factor is picked at note on and raised if a bend takes the
+ * note higher (Oversampler::factorFor()). Its oversampler keeps a
+ * constant latency, so voices at different factors stay in time.
  *
  * SST Dependencies:
- *   - sst/basic-blocks/dsp/DPWSawOscillator.h (or other oscillator types)
+ *   - UnisonOscillator.h (sst DPW saw + UnisonSetup / DriftLFO, 1-4 copies)
+ *   - BandLimitedOscillator.h (sst elliptic BLEP or DPW saw / pulse / triangle / sine)
  *   - sst/filters/CytomicSVF.h (or VintageLadder, etc.)
+ *   - Oversampler.h (sst HalfRateFilter, 2x / 4x around a driven stage)
+ *   - VoiceEffects.h (sst voice-effects insert slots: shaper, crusher, ring mod, EQ)
  *   - sst/basic-blocks/modulators/ADSREnvelope.h
  *
  * @note All DSP algorithms come from SST libraries - never write custom DSP
@@ -20,16 +28,52 @@
 
 #include <cmath>
 #include <array>
+#include <algorithm>
+#include <cstdint>
+
+#include "ControlRate.h"
+#include "FastMath.h"
+#include "Oversampler.h"
+#include "PitchTables.h"
+#include "UnisonOscillator.h"
+#include "VoiceEffects.h"
 
 // ============================================================================
 // SST Library Includes
 // TODO: Uncomment and adjust based on your architecture
 // ============================================================================
 
-// #include "sst/basic-blocks/dsp/DPWSawOscillator.h"
+// #include "BandLimitedOscillator.h"
 // #include "sst/basic-blocks/modulators/ADSREnvelope.h"
 // #include "sst/filters/CytomicSVF.h"
 
+/**
+ * @brief Global parameter snapshot shared by all voices
+ *
+ * Owned by SynthEngine. Engine setters bump a revision number whenever a
+ * field changes, and Voice::applyParams() only re-derives coefficients when
+ * that revision differs from the one it last applied.
+ */
+struct VoiceParams
+{
+    static constexpr int INSERT_SLOTS = 2;
+    static constexpr int SEND_BUSES = 2;  // Shared effects the voices feed (SendBuses.h)
+
+    // TODO: Add the parameters your voices need
+    // float filterCutoff = 5000.0f;
+    // float filterResonance = 0.0f;
+    int unisonVoices = 1;         // Oscillator copies (1-4)
+    float unisonDetune = 10.0f;   // Cents either side
+    float masterLevel = 1.0f;
+    float drive = 0.0f;           // 0 (off) to 1 (about tanh(8x))
+
+    // Per-voice inserts (VoiceEffects.h), all Off by default
+    std::array<VoiceInsertSettings, INSERT_SLOTS> inserts{};
+
+    // Send level into each bus's shared effect, 0 = none
+    std::array<float, SEND_BUSES> sends{};
+};
+
 /**
  * @brief Single synthesizer voice
  *
@@ -41,12 +85,17 @@
  * Thread Safety:
  * - Voice methods are called from audio thread only
  * - No allocations in render path
+ *
+ * Layout: members are split into hot state (touched every sample) and cold
+ * configuration, hot first and cache-line aligned, so the engine's walk
+ * over sounding voices doesn't drag settings and insert buffers through
+ * the cache.
  */
-class Voice
+class alignas(64) Voice
 {
 public:
-    // Block size for internal processing
-    static constexpr int BLOCK_SIZE = 32;
+    // Block size for internal processing; modulators run once per block
+    static constexpr int BLOCK_SIZE = ControlRamp::BLOCK_SIZE;
 
     Voice() = default;
     ~Voice() = default;
@@ -63,9 +112,15 @@ public:
     {
         this->sampleRate = sampleRate;
 
+        osc.prepare(sampleRate);
+        inserts.prepare(sampleRate);
+
+        // Delayed the same at every factor, so the latency never moves
+        driveOversampler.setConstantLatency(true);
+        driveOversampler.reset();
+
         // TODO: Initialize SST components
         // Example:
-        // osc1.init();
         // filter.init();
         // ampEnv.setSampleRate(sampleRate);
     }
@@ -85,23 +140,28 @@ public:
         velocity = vel;
         active = true;
         releasing = false;
-        age = 0;
 
-        // Calculate oscillator frequency
-        float frequency = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
-        phaseIncrement = frequency / static_cast<float>(sampleRate);
+        // Calculate oscillator frequency (PitchTables.h also has
+        // semitonesToRatio() etc. for per-sample pitch modulation)
+        noteFrequency = PitchTables::get().midiToFrequency(static_cast<float>(note));
 
-        // TODO: Set oscillator frequency
-        // Example:
-        // osc1.setFrequency(phaseIncrement);
+        // Oversample the drive only as far as this note needs; a filter
+        // or envelope inside the driven stage would be prepared at
+        // sampleRate * driveOversampler.getFactor() here when adapt() is true
+        driveOversampler.adapt(sampleRate, noteFrequency * pitchRatio, drive);
 
         // TODO: Trigger envelopes
         // Example:
         // ampEnv.attack();
         // filterEnv.attack();
 
+        // Start at the current modulation rather than ramping from the last note
+        ampRamp.reset(ampGain);
+
         // Reset phase for clean attack
-        phase = 0.0f;
+        osc.reset();
+        driveOversampler.reset();
+        inserts.reset();
     }
 
     /**
@@ -142,8 +202,6 @@ public:
         if (!active)
             return;
 
-        ++age; // Track voice age for stealing
-
         // Process in blocks for efficiency
         int samplesRemaining = numSamples;
         int offset = 0;
@@ -165,12 +223,92 @@ public:
     bool isReleasing() const { return releasing; }
     int getNote() const { return currentNote; }
     float getVelocity() const { return velocity; }
-    int getAge() const { return age; }
+
+    /**
+     * Loudness now, for the Quietest steal policy and the release cull:
+     * envelope x velocity x the gains after it, the drive's at its small-signal slope
+     */
+    float getLevel() const
+    {
+        return envLevel * velocity * masterLevel * ampGain * (drive > 0.0f ? driveGain : 1.0f);
+    }
+
+    /** The drive's oversampling factor for the current note (1, 2 or 4) */
+    int getDriveOversampling() const { return driveOversampler.getFactor(); }
+
+    /** Samples the voice's output is delayed by, before the inserts (the same at every factor) */
+    int getLatency() const { return drive > 0.0f ? driveOversampler.getLatency() : 0; }
+
+    /**
+     * @brief How much of this voice goes to a send bus's effect
+     *
+     * TODO: Scale per voice if your synth wants to (velocity, key, a mod
+     * route); it costs a multiply per voice, where an effect per voice
+     * would cost the effect.
+     */
+    float getSendLevel(int bus) const { return sendLevels[static_cast<size_t>(bus)]; }
 
     //==========================================================================
     // Parameter Setters (call from audio thread)
     //==========================================================================
 
+    /**
+     * @brief Apply the engine's parameter snapshot if it has changed
+     * @param p Current global parameters
+     * @param revision Engine parameter revision
+     *
+     * Put expensive derivations (pow, tan, envelope rates) here rather than
+     * in per-block setters so unchanged parameters cost one compare.
+     */
+    void applyParams(const VoiceParams& p, uint32_t revision)
+    {
+        if (revision == appliedRevision)
+            return;
+
+        appliedRevision = revision;
+        masterLevel = p.masterLevel;
+        osc.setVoices(p.unisonVoices);
+        osc.setDetune(p.unisonDetune);
+        inserts.apply(p.inserts);
+        sendLevels = p.sends;
+
+        if (p.drive != drive)
+        {
+            // Switched on: start from an empty delay line
+            if (drive <= 0.0f)
+                driveOversampler.reset();
+            drive = p.drive;
+            driveOversampler.raiseFactor(Oversampler::factorFor(sampleRate, noteFrequency * pitchRatio, drive));
+            driveGain = 1.0f + 7.0f * drive;
+        }
+
+        // TODO: Derive coefficients from the snapshot
+        // Example:
+        // setFilterCutoff(p.filterCutoff);
+        // setFilterResonance(p.filterResonance);
+    }
+
+    /**
+     * @brief Set the mod matrix offsets (once per engine sub-block)
+     * @param pitchSemitones Pitch offset in semitones
+     * @param cutoffOctaves Filter cutoff offset in octaves
+     * @param ampOffset Gain offset (0 = unchanged, -1 = silent)
+     */
+    void setModulation(float pitchSemitones, float cutoffOctaves, float ampOffset)
+    {
+        const float ratio = PitchTables::get().semitonesToRatio(pitchSemitones);
+        if (ratio != pitchRatio)
+        {
+            // Bent higher than the note's factor covers: raise it (and
+            // leave it raised until the next note, see raiseFactor())
+            pitchRatio = ratio;
+            if (drive > 0.0f)
+                driveOversampler.raiseFactor(Oversampler::factorFor(sampleRate, noteFrequency * pitchRatio, drive));
+        }
+        cutoffModOctaves = cutoffOctaves;
+        ampGain = std::max(0.0f, 1.0f + ampOffset);
+    }
+
     // TODO: Add parameter setters for your voice
     // Example:
     // void setFilterCutoff(float cutoffHz) { targetCutoff = cutoffHz; }
@@ -182,34 +320,43 @@ private:
      */
     void renderBlock(float* outputL, float* outputR, int blockSize)
     {
-        for (int i = 0; i < blockSize; ++i)
-        {
-            // ================================================================
-            // OSCILLATOR
-            // TODO: Replace with SST oscillator
-            // ================================================================
+        // Ramp the mod matrix offsets across the block (the oscillator
+        // ramps its own pitch between blocks)
+        ampRamp.setTarget(ampGain, blockSize);
 
-            // Simple placeholder saw wave
-            float oscOut = phase * 2.0f - 1.0f;
-            phase += phaseIncrement;
-            if (phase >= 1.0f)
-                phase -= 1.0f;
+        // ================================================================
+        // OSCILLATOR
+        // One to four unison copies, all in one SIMD register
+        // ================================================================
 
-            // TODO: Use SST oscillator instead
-            // Example:
-            // float oscOut = osc1.step();
+        alignas(16) float oscL[BLOCK_SIZE];
+        alignas(16) float oscR[BLOCK_SIZE];
+        osc.setFrequency(noteFrequency * pitchRatio);
+        osc.render(oscL, oscR, blockSize);
 
+        // TODO: Step LFOs / mod envelopes once here and ramp what they drive
+        // Example:
+        // cutoffRamp.setTarget(targetCutoff * PitchTables::get().octavesToRatio(
+        //     cutoffModOctaves + lfo.advance(blockSize)), blockSize);
+
+        alignas(16) float voiceL[BLOCK_SIZE];
+        alignas(16) float voiceR[BLOCK_SIZE];
+        int rendered = blockSize;
+
+        for (int i = 0; i < blockSize; ++i)
+        {
             // ================================================================
             // FILTER
             // TODO: Add SST filter
             // ================================================================
 
-            float filterOut = oscOut; // Bypass for now
+            float filterL = oscL[i]; // Bypass for now
+            float filterR = oscR[i];
 
             // TODO: Process through SST filter
             // Example:
             // filter.setCoeff(CytomicSVF::LP, cutoff, resonance, sampleRate);
-            // float filterOut = filter.process(oscOut);
+            // filter.processBlockStep(filterL, filterR);
 
             // ================================================================
             // ENVELOPE
@@ -227,16 +374,47 @@ private:
             if (envOut <= 0.0f && releasing)
             {
                 active = false;
-                return;
+                rendered = i;
+                break;
             }
 
-            // ================================================================
-            // OUTPUT
-            // ================================================================
+            float gain = envOut * velocity * masterLevel * ampRamp.next();
+            voiceL[i] = filterL * gain;
+            voiceR[i] = filterR * gain;
+        }
+
+        // ================================================================
+        // DRIVE
+        // tanh at the factor the note picked; LATENCY samples late at any
+        // factor while it is on
+        // ================================================================
 
-            float output = filterOut * envOut * velocity;
-            outputL[i] += output;
-            outputR[i] += output;
+        if (drive > 0.0f)
+        {
+            driveOversampler.process(voiceL, voiceR, rendered, [gain = driveGain](float* l, float* r, int n) {
+                for (int i = 0; i < n; ++i)
+                {
+                    l[i] = FastMath::tanh(l[i] * gain);
+                    r[i] = FastMath::tanh(r[i] * gain);
+                }
+            });
+        }
+
+        // ================================================================
+        // INSERTS
+        // Whole VoiceEffectConfig blocks; no work while every slot is Off
+        // ================================================================
+
+        inserts.process(voiceL, voiceR, rendered, static_cast<float>(currentNote - 69));
+
+        // ================================================================
+        // OUTPUT
+        // ================================================================
+
+        for (int i = 0; i < rendered; ++i)
+        {
+            outputL[i] += voiceL[i];
+            outputR[i] += voiceR[i];
         }
     }
 
@@ -267,35 +445,57 @@ private:
     }
 
     //==========================================================================
-    // Voice State
+    // Hot State
+    // Everything renderBlock() reads or writes, kept together at the front of
+    // the voice so a block pulls a few cache lines, not the whole object.
+    // Put per-sample DSP state (filters, envelopes) here.
     //==========================================================================
 
     bool active = false;
     bool releasing = false;
-    int currentNote = -1;
     float velocity = 0.0f;
-    int age = 0;  // For voice stealing (older voices get stolen first)
+    float masterLevel = 1.0f;
+
+    // Envelope state (placeholder - replace with SST)
+    float envLevel = 0.0f;
+    double sampleRate = 44100.0;
+
+    // Oscillator
+    float noteFrequency = 440.0f;
+    float pitchRatio = 1.0f;  // Mod matrix pitch offset
+    UnisonOscillator osc;
+
+    // Mod matrix gain offset (see ModRouting.h), ramped per block
+    float ampGain = 1.0f;
+    ControlRamp ampRamp;
 
     //==========================================================================
-    // DSP State
+    // Cold Configuration
+    // Read per note or per parameter change, not per sample
     //==========================================================================
 
-    double sampleRate = 44100.0;
+    uint32_t appliedRevision = 0;  // Engine revision last applied (0 = never)
+    int currentNote = -1;
+    float cutoffModOctaves = 0.0f;  // Mod matrix cutoff offset
+    std::array<float, VoiceParams::SEND_BUSES> sendLevels{};
 
-    // Oscillator state (placeholder - replace with SST)
-    float phase = 0.0f;
-    float phaseIncrement = 0.0f;
+    // Drive stage (see renderBlock); the oversampler is large and
+    // untouched while the drive is off
+    float drive = 0.0f;
+    float driveGain = 1.0f;
+    Oversampler driveOversampler;
 
-    // Envelope state (placeholder - replace with SST)
-    float envLevel = 0.0f;
+    // Insert slots, after the amp so their queue drains to silence. Large,
+    // and untouched while every slot is Off, so they go last
+    VoiceInsertChain<VoiceParams::INSERT_SLOTS> inserts;
 
     //==========================================================================
     // SST Components
-    // TODO: Uncomment and configure for your architecture
+    // TODO: Uncomment and configure for your architecture (per-sample DSP
+    // belongs with the hot state above)
     //==========================================================================
 
-    // sst::basic_blocks::dsp::DPWSawOscillator osc1;
-    // sst::basic_blocks::dsp::DPWSawOscillator osc2;
+    // BlepOscillator osc2;  // BandLimitedOscillator.h
     // sst::filters::CytomicSVF filter;
     // sst::basic_blocks::modulators::ADSREnvelope ampEnv;
     // sst::basic_blocks::modulators::ADSREnvelope filterEnv;
@@ -306,4 +506,5 @@ private:
 
     // float targetCutoff = 5000.0f;
     // float targetResonance = 0.0f;
+    // ControlRamp cutoffRamp;
 };
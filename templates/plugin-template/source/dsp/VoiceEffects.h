@@ -0,0 +1,394 @@
+/**
+ * @file VoiceEffects.h
+ * @brief Per-voice insert slots hosting sst voice-effects units
+ *
+ * sst-effects' voice effects (sst/voice-effects) are small, block-processed
+ * units meant to run once per voice: WaveShaper, BitCrusher, RingMod,
+ * EqNBandParametric and friends. Like the global effects (SSTEffect.h) they
+ * are templates over a config that supplies parameter storage, sample rate
+ * and tuning; VoiceEffectConfig is that adapter.
+ *
+ * VoiceInsert is one slot: it holds any of the hosted units by value (a
+ * std::variant, so a voice's slots are allocated with the voice and
+ * switching unit never allocates). VoiceInsertChain is a voice's fixed row
+ * of slots, run in order:
+ *
+ *   VoiceInsertChain<2> inserts;                  // Member of Voice
+ *
+ *   inserts.prepare(sampleRate);                  // Voice::prepare
+ *   inserts.apply(params.inserts);                // Voice::applyParams
+ *   inserts.reset();                              // Voice::noteOn
+ *   inserts.process(left, right, n, note - 69);   // After the voice's amp
+ *
+ * Units process fixed blocks of VoiceEffectConfig::blockSize samples. The
+ * chain queues the voice's output and returns each block once it's full, so
+ * with any slot in use the voice is exactly LATENCY samples late. Voice
+ * blocks that are a multiple of blockSize (ControlRamp::BLOCK_SIZE is)
+ * flow straight through the queue in whole blocks.
+ *
+ * Bypassed slots (Off) cost nothing, and a chain with every slot off returns
+ * before touching the queue: no copy and no latency.
+ *
+ * Parameters are in the unit's own units (paramAt(i) / intParamAt(i)
+ * describe them); any left unset (NaN / UNSET_INT in VoiceInsertSettings)
+ * keep the unit's default.
+ *
+ * @note WaveShaper needs sst-waveshapers. Where it isn't checked out the
+ *       WaveShaper slot type behaves as Off.
+ * @note prepare() reads each unit's parameter defaults, which allocates.
+ *       Everything else, switching a slot's unit included, is real-time
+ *       safe: the hosted units don't check out pool memory.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+#include "sst/voice-effects/distortion/BitCrusher.h"
+#include "sst/voice-effects/eq/EqNBandParametric.h"
+#include "sst/voice-effects/modulation/RingMod.h"
+
+#if __has_include("sst/waveshapers.h")
+#include "sst/voice-effects/waveshaper/WaveShaper.h"
+#define VOICE_EFFECTS_HAS_WAVESHAPER 1
+#else
+#define VOICE_EFFECTS_HAS_WAVESHAPER 0
+#endif
+
+/**
+ * @brief The VFXConfig every VoiceInsert uses
+ */
+struct VoiceEffectConfig
+{
+    static constexpr int blockSize = 16;
+    static constexpr int MAX_FLOAT_PARAMS = 12;
+    static constexpr int MAX_INT_PARAMS = 4;
+
+    struct BaseClass
+    {
+        // The unit reads its parameters from here (getFloatParam / getIntParam)
+        std::array<float, MAX_FLOAT_PARAMS> floats{};
+        std::array<int, MAX_INT_PARAMS> ints{};
+        float rate = 48000.0f;
+        float rateInv = 1.0f / 48000.0f;
+    };
+
+    static void setFloatParam(BaseClass* b, size_t i, float f) { b->floats[i] = f; }
+    static float getFloatParam(const BaseClass* b, size_t i) { return b->floats[i]; }
+    static void setIntParam(BaseClass* b, size_t i, int v) { b->ints[i] = v; }
+    static int getIntParam(const BaseClass* b, size_t i) { return b->ints[i]; }
+
+    static float dbToLinear(const BaseClass*, float db) { return std::pow(10.0f, db / 20.0f); }
+    static float equalNoteToPitch(const BaseClass*, float note) { return std::pow(2.0f, note / 12.0f); }
+
+    static float getSampleRate(const BaseClass* b) { return b->rate; }
+    static float getSampleRateInv(const BaseClass* b) { return b->rateInv; }
+
+    // Only delay-line units check out pool memory and none are hosted here
+    static void preReservePool(BaseClass*, size_t) {}
+    static uint8_t* checkoutBlock(BaseClass*, size_t) { return nullptr; }
+    static void returnBlock(BaseClass*, uint8_t*, size_t) {}
+};
+
+/**
+ * @brief What one insert slot runs, as carried in a voice parameter snapshot
+ */
+struct VoiceInsertSettings
+{
+    static constexpr int UNSET_INT = INT_MIN;
+
+    int type = 0;  // VoiceInsert::Type
+    std::array<float, VoiceEffectConfig::MAX_FLOAT_PARAMS> params = unsetParams();
+    std::array<int, VoiceEffectConfig::MAX_INT_PARAMS> intParams = unsetIntParams();
+
+    static std::array<float, VoiceEffectConfig::MAX_FLOAT_PARAMS> unsetParams()
+    {
+        std::array<float, VoiceEffectConfig::MAX_FLOAT_PARAMS> a;
+        a.fill(std::numeric_limits<float>::quiet_NaN());
+        return a;
+    }
+
+    static std::array<int, VoiceEffectConfig::MAX_INT_PARAMS> unsetIntParams()
+    {
+        std::array<int, VoiceEffectConfig::MAX_INT_PARAMS> a;
+        a.fill(UNSET_INT);
+        return a;
+    }
+};
+
+/**
+ * @brief One insert slot: Off or one voice-effects unit, processed a block at a time
+ */
+class VoiceInsert
+{
+public:
+    enum Type
+    {
+        Off = 0,
+        WaveShaper,
+        BitCrusher,
+        RingMod,
+        Eq3Band,
+        NumTypes
+    };
+
+    static constexpr int BLOCK = VoiceEffectConfig::blockSize;
+
+    using BitCrusherFX = sst::voice_effects::distortion::BitCrusher<VoiceEffectConfig>;
+    using RingModFX = sst::voice_effects::modulation::RingMod<VoiceEffectConfig>;
+    using Eq3BandFX = sst::voice_effects::eq::EqNBandParametric<VoiceEffectConfig, 3>;
+#if VOICE_EFFECTS_HAS_WAVESHAPER
+    using WaveShaperFX = sst::voice_effects::waveshaper::WaveShaper<VoiceEffectConfig>;
+#else
+    struct WaveShaperFX
+    {
+    };
+#endif
+
+    void prepare(double sampleRate)
+    {
+        // Read every unit's defaults now, off the audio thread
+        defaults<WaveShaperFX>();
+        defaults<BitCrusherFX>();
+        defaults<RingModFX>();
+        defaults<Eq3BandFX>();
+
+        this->sampleRate = static_cast<float>(sampleRate);
+        const int t = type;
+        type = -1;
+        setType(t);
+    }
+
+    /** The unit a slot set to t runs: WaveShaper is Off without sst-waveshapers */
+    static int effectiveType(int t)
+    {
+        t = std::clamp(t, 0, NumTypes - 1);
+        return !VOICE_EFFECTS_HAS_WAVESHAPER && t == WaveShaper ? static_cast<int>(Off) : t;
+    }
+
+    /** Switch unit; a new unit starts from its defaults and silence */
+    void setType(int newType)
+    {
+        newType = effectiveType(newType);
+        if (newType == type)
+            return;
+        type = newType;
+
+        switch (type)
+        {
+#if VOICE_EFFECTS_HAS_WAVESHAPER
+            case WaveShaper: start<WaveShaperFX>(); break;
+#endif
+            case BitCrusher: start<BitCrusherFX>(); break;
+            case RingMod: start<RingModFX>(); break;
+            case Eq3Band: start<Eq3BandFX>(); break;
+            default: unit.emplace<std::monostate>(); break;
+        }
+    }
+
+    int getType() const { return type; }
+    bool isBypassed() const { return type == Off; }
+
+    /** Set float parameter idx (the unit's enum) in the unit's own units */
+    void setParam(int idx, float value)
+    {
+        visitUnit([&](auto& fx) {
+            using FX = std::decay_t<decltype(fx)>;
+            if (idx >= 0 && idx < FX::numFloatParams)
+                fx.setFloatParam(idx, std::isnan(value) ? defaults<FX>().floats[static_cast<size_t>(idx)] : value);
+        });
+    }
+
+    void setIntParam(int idx, int value)
+    {
+        visitUnit([&](auto& fx) {
+            using FX = std::decay_t<decltype(fx)>;
+            if (idx >= 0 && idx < FX::numIntParams)
+                fx.setIntParam(idx, value == VoiceInsertSettings::UNSET_INT
+                                        ? defaults<FX>().ints[static_cast<size_t>(idx)] : value);
+        });
+    }
+
+    /** Take the slot's type and every parameter from a snapshot */
+    void apply(const VoiceInsertSettings& s)
+    {
+        setType(s.type);
+        for (int i = 0; i < VoiceEffectConfig::MAX_FLOAT_PARAMS; ++i)
+            setParam(i, s.params[static_cast<size_t>(i)]);
+        for (int i = 0; i < VoiceEffectConfig::MAX_INT_PARAMS; ++i)
+            setIntParam(i, s.intParams[static_cast<size_t>(i)]);
+    }
+
+    /** Clear the unit's state (filters, phases) but keep its parameters */
+    void reset()
+    {
+        visitUnit([&](auto& fx) {
+            using FX = std::decay_t<decltype(fx)>;
+            const VoiceEffectConfig::BaseClass params = fx;
+            unit.emplace<FX>();
+            auto& fresh = std::get<FX>(unit);
+            static_cast<VoiceEffectConfig::BaseClass&>(fresh) = params;
+            init(fresh);
+        });
+    }
+
+    /** Process one BLOCK of stereo in place; pitch is semitones from A440 */
+    void process(float* left, float* right, float pitch)
+    {
+        visitUnit([&](auto& fx) { fx.processStereo(left, right, left, right, pitch); });
+    }
+
+    template <typename FX>
+    FX* get() { return std::get_if<FX>(&unit); }
+
+private:
+    template <typename FX>
+    void start()
+    {
+        unit.emplace<FX>();
+        auto& fx = std::get<FX>(unit);
+        static_assert(FX::numFloatParams <= VoiceEffectConfig::MAX_FLOAT_PARAMS);
+        static_assert(FX::numIntParams <= VoiceEffectConfig::MAX_INT_PARAMS);
+        static_cast<VoiceEffectConfig::BaseClass&>(fx) = defaults<FX>();
+        init(fx);
+    }
+
+    /**
+     * The unit's parameter defaults. paramAt() builds names and format maps
+     * (it allocates), so it's read once per unit type, not per slot change.
+     */
+    template <typename FX>
+    static const VoiceEffectConfig::BaseClass& defaults()
+    {
+        static const VoiceEffectConfig::BaseClass d = [] {
+            VoiceEffectConfig::BaseClass b;
+            if constexpr (std::is_base_of_v<VoiceEffectConfig::BaseClass, FX>)
+            {
+                FX fx;
+                for (int i = 0; i < FX::numFloatParams; ++i)
+                    b.floats[static_cast<size_t>(i)] = fx.paramAt(i).defaultVal;
+                for (int i = 0; i < FX::numIntParams; ++i)
+                    b.ints[static_cast<size_t>(i)] = static_cast<int>(fx.intParamAt(i).defaultVal);
+            }
+            return b;
+        }();
+        return d;
+    }
+
+    template <typename FX>
+    void init(FX& fx)
+    {
+        fx.rate = sampleRate;
+        fx.rateInv = 1.0f / sampleRate;
+        if constexpr (requires { fx.initVoiceEffect(); })
+            fx.initVoiceEffect();
+    }
+
+    /** Call f with the active unit; Off (and a missing WaveShaper) does nothing */
+    template <typename F>
+    void visitUnit(F&& f)
+    {
+        std::visit([&](auto& u) {
+            using U = std::decay_t<decltype(u)>;
+            if constexpr (!std::is_same_v<U, std::monostate>
+                          && std::is_base_of_v<VoiceEffectConfig::BaseClass, U>)
+                f(u);
+        }, unit);
+    }
+
+    std::variant<std::monostate, WaveShaperFX, BitCrusherFX, RingModFX, Eq3BandFX> unit;
+    int type = Off;
+    float sampleRate = 48000.0f;
+};
+
+/**
+ * @brief A voice's row of insert slots, any block size in
+ */
+template <int SLOTS>
+class VoiceInsertChain
+{
+public:
+    static constexpr int BLOCK = VoiceInsert::BLOCK;
+    static constexpr int LATENCY = BLOCK;  // While any slot is in use
+
+    void prepare(double sampleRate)
+    {
+        for (auto& s : slots)
+            s.prepare(sampleRate);
+        reset();
+    }
+
+    void apply(const std::array<VoiceInsertSettings, SLOTS>& settings)
+    {
+        for (int i = 0; i < SLOTS; ++i)
+            slots[static_cast<size_t>(i)].apply(settings[static_cast<size_t>(i)]);
+    }
+
+    /** Start a note from silence */
+    void reset()
+    {
+        for (auto& s : slots)
+            s.reset();
+        queueL.fill(0.0f);
+        queueR.fill(0.0f);
+        filled = 0;
+    }
+
+    bool isBypassed() const
+    {
+        return std::all_of(slots.begin(), slots.end(), [](const VoiceInsert& s) { return s.isBypassed(); });
+    }
+
+    VoiceInsert& slot(int i) { return slots[static_cast<size_t>(i)]; }
+
+    /** Samples a chain with these settings delays its voice by */
+    static int latencyFor(const std::array<VoiceInsertSettings, SLOTS>& settings)
+    {
+        const bool inUse = std::any_of(settings.begin(), settings.end(), [](const VoiceInsertSettings& s) {
+            return VoiceInsert::effectiveType(s.type) != VoiceInsert::Off;
+        });
+        return inUse ? LATENCY : 0;
+    }
+
+    /** Process in place; with any slot in use the output trails by LATENCY samples */
+    void process(float* left, float* right, int numSamples, float pitch)
+    {
+        if (isBypassed())
+            return;
+
+        // The queue holds the last processed block's output from 'filled'
+        // on: hand that out and take the new input in its place
+        while (numSamples > 0)
+        {
+            const int n = std::min(numSamples, BLOCK - filled);
+            std::swap_ranges(left, left + n, queueL.begin() + filled);
+            std::swap_ranges(right, right + n, queueR.begin() + filled);
+            left += n;
+            right += n;
+            numSamples -= n;
+
+            filled += n;
+            if (filled == BLOCK)
+            {
+                for (auto& s : slots)
+                    s.process(queueL.data(), queueR.data(), pitch);
+                filled = 0;
+            }
+        }
+    }
+
+private:
+    std::array<VoiceInsert, SLOTS> slots;
+
+    alignas(16) std::array<float, BLOCK> queueL{};
+    alignas(16) std::array<float, BLOCK> queueR{};
+    int filled = 0;
+};
@@ -7,15 +7,55 @@
  * - Polyphony and voice allocation
  * - Voice stealing
  * - Audio output
+ * - Modulation routing
+ * - Effect tail gating
+ * - Per-voice drive oversampling
+ * - Sequencer step clock
+ * - Per-block parameter snapshot
+ * - Parameter smoothing
+ * - Seeded noise
+ * - Active voice list
+ * - Compile-time DSP graphs
+ * - Wavetables
+ * - Waveguide strings
  */
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
+#include <limits>
 #include <array>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <thread>
 
-// TODO: Include your synth engine implementation
-// #include "dsp/SynthEngine.h"
+#include "dsp/SynthEngine.h"
+#include "RealtimeGuard.h"
+#include "ScopeFifo.h"
+#include "UiNoteFifo.h"
+#include "StatePublisher.h"
+#include "UIResourceCache.h"
+#include "PerfStats.h"
+#include "dsp/ModRouting.h"
+#include "SilenceGate.h"
+#include "StepClock.h"
+#include "Arpeggiator.h"
+#include "ParamSnapshot.h"
+#include "dsp/ParamSmoother.h"
+#include "Noise.h"
+#include "ActiveVoiceList.h"
+#include "dsp/SSTEffect.h"
+#include "dsp/VoiceEffects.h"
+#include "dsp/GranularEngine.h"
+#include "dsp/GraphModules.h"
+#include "DspGraph.h"
+#include "PatchGraph.h"
+#include "dsp/PatchModules.h"
+#include "Waveguide.h"
+#include "Wavetable.h"
+#include "sst/effects/Reverb2.h"
 
 using Catch::Approx;
 
@@ -254,3 +294,1863 @@ TEST_CASE("SynthEngine stress test", "[engine][stress]")
         REQUIRE(true); // Placeholder
     }
 }
+
+TEST_CASE("SynthEngine renders without allocating or locking", "[engine][realtime]")
+{
+    SynthEngine engine;
+    constexpr int bufferSize = 512;
+
+    std::array<float, bufferSize> leftBuffer{};
+    std::array<float, bufferSize> rightBuffer{};
+
+    engine.prepare(48000.0, bufferSize);
+
+    // Notes, releases and steals between blocks, as the processor does
+    const auto rt = RealtimeGuard::check([&] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const int note = 36 + (i % 24);
+            if (i % 3 == 2)
+                engine.noteOff(note - 2);
+            else
+                engine.noteOn(note, 0.8f);
+            engine.renderBlock(leftBuffer.data(), rightBuffer.data(), bufferSize);
+        }
+    });
+
+    REQUIRE(rt.allocations == 0);
+    REQUIRE(rt.deallocations == 0);
+    REQUIRE(rt.locks == 0);
+}
+
+// ============================================================================
+// Oscilloscope FIFO
+// ============================================================================
+
+TEST_CASE("ScopeFifo hands the newest samples to the UI", "[scope]")
+{
+    ScopeFifo fifo;
+    std::array<float, 256> block{};
+    std::array<float, ScopeFifo::CAPACITY> out{};
+
+    SECTION("Empty FIFO pulls nothing")
+    {
+        REQUIRE(fifo.pullLatest(out.data(), 64) == 0);
+    }
+
+    SECTION("Pull returns the latest window, oldest first")
+    {
+        for (int i = 0; i < 256; ++i)
+            block[static_cast<size_t>(i)] = static_cast<float>(i);
+
+        REQUIRE(fifo.push(block.data(), 256) == 256);
+        REQUIRE(fifo.getNumReady() == 256);
+
+        REQUIRE(fifo.pullLatest(out.data(), 64) == 64);
+        REQUIRE(out[0] == 192.0f);
+        REQUIRE(out[63] == 255.0f);
+
+        // Older samples were discarded along with the pull
+        REQUIRE(fifo.getNumReady() == 0);
+    }
+
+    SECTION("A full FIFO drops new samples instead of blocking")
+    {
+        int written = 0;
+        for (int i = 0; i < 2 * ScopeFifo::CAPACITY / 256; ++i)
+            written += fifo.push(block.data(), 256);
+
+        REQUIRE(written == ScopeFifo::CAPACITY - 1);
+
+        // Draining makes room again
+        fifo.pullLatest(out.data(), 16);
+        REQUIRE(fifo.push(block.data(), 256) == 256);
+    }
+
+    SECTION("Indices wrap around the ring")
+    {
+        for (int n = 0; n < 100; ++n)
+        {
+            for (int i = 0; i < 256; ++i)
+                block[static_cast<size_t>(i)] = static_cast<float>(n * 256 + i);
+
+            fifo.push(block.data(), 256);
+            REQUIRE(fifo.pullLatest(out.data(), 8) == 8);
+            REQUIRE(out[7] == static_cast<float>(n * 256 + 255));
+        }
+    }
+}
+
+// ============================================================================
+// On-screen keyboard FIFO
+// ============================================================================
+
+TEST_CASE("UiNoteFifo places keyboard notes in the next block", "[midi]")
+{
+    constexpr double SR = 48000.0;
+    constexpr int BLOCK = 480;  // 10 ms
+    UiNoteFifo fifo;
+
+    std::vector<std::pair<UiNoteFifo::Note, int>> drained;
+    auto drain = [&](double now) {
+        drained.clear();
+        fifo.drain(now, SR, BLOCK, [&](const UiNoteFifo::Note& n, int offset) { drained.emplace_back(n, offset); });
+    };
+
+    SECTION("Notes keep their spacing from the previous block's start")
+    {
+        drain(1.000);
+        REQUIRE(fifo.push(60, 0.8f, true, 1.0025));
+        REQUIRE(fifo.push(60, 0.5f, false, 1.0050));
+        REQUIRE_FALSE(fifo.isEmpty());
+
+        drain(1.010);
+        REQUIRE(drained.size() == 2);
+        REQUIRE(drained[0].first.note == 60);
+        REQUIRE(drained[0].first.isNoteOn);
+        REQUIRE(drained[0].first.velocity == 0.8f);
+        REQUIRE(drained[0].second == 120);
+        REQUIRE_FALSE(drained[1].first.isNoteOn);
+        REQUIRE(drained[1].first.velocity == 0.0f);
+        REQUIRE(drained[1].second == 240);
+        REQUIRE(fifo.isEmpty());
+    }
+
+    SECTION("Offsets stay inside the block")
+    {
+        drain(1.000);
+        fifo.push(61, 1.0f, true, 0.5);    // Long before: the host stalled
+        fifo.push(62, 1.0f, true, 1.020);  // Clock skew past the block
+        drain(1.010);
+        REQUIRE(drained.size() == 2);
+        REQUIRE(drained[0].second == 0);
+        REQUIRE(drained[1].second == BLOCK - 1);
+    }
+
+    SECTION("A full FIFO drops new notes instead of blocking")
+    {
+        int pushed = 0;
+        for (int i = 0; i < 2 * UiNoteFifo::CAPACITY; ++i)
+            pushed += fifo.push(i & 127, 1.0f, true, 1.0) ? 1 : 0;
+        REQUIRE(pushed == UiNoteFifo::CAPACITY - 1);
+
+        drain(1.0);
+        REQUIRE(static_cast<int>(drained.size()) == UiNoteFifo::CAPACITY - 1);
+        REQUIRE(fifo.push(60, 1.0f, true, 1.0));
+    }
+
+    SECTION("Draining allocates nothing and takes no lock")
+    {
+        fifo.push(60, 1.0f, true, 0.0);
+        int count = 0;
+        const auto rt = RealtimeGuard::check([&] {
+            fifo.drain(0.01, SR, BLOCK, [&](const UiNoteFifo::Note&, int) { ++count; });
+        });
+        REQUIRE(count == 1);
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.locks == 0);
+    }
+}
+
+TEST_CASE("StatePublisher hands the editor whole, newest snapshots", "[state]")
+{
+    struct State
+    {
+        int a = 0;
+        int b = 0;
+    };
+    StatePublisher<State> publisher;
+
+    SECTION("Nothing published reads the default")
+    {
+        REQUIRE(publisher.read().a == 0);
+    }
+
+    SECTION("Reads see the newest publish, and keep it until the next")
+    {
+        for (int i = 1; i <= 3; ++i)
+        {
+            publisher.write() = {i, -i};
+            publisher.publish();
+        }
+        REQUIRE(publisher.read().a == 3);
+        REQUIRE(publisher.read().b == -3);
+        REQUIRE(publisher.read().a == 3);
+
+        publisher.write() = {4, -4};
+        publisher.publish();
+        REQUIRE(publisher.read().a == 4);
+    }
+
+    SECTION("A reader on another thread never sees a torn or older snapshot")
+    {
+        constexpr int N = 200000;
+        std::thread writer([&] {
+            for (int i = 1; i <= N; ++i)
+            {
+                auto& s = publisher.write();
+                s.a = i;
+                s.b = -i;
+                publisher.publish();
+            }
+        });
+
+        int last = 0;
+        bool whole = true, ordered = true;
+        while (last < N)
+        {
+            const State& s = publisher.read();
+            whole = whole && s.b == -s.a;
+            ordered = ordered && s.a >= last;
+            last = s.a;
+        }
+        writer.join();
+
+        REQUIRE(whole);
+        REQUIRE(ordered);
+    }
+}
+
+TEST_CASE("UIResourceCache serves embedded files, inflating each once", "[ui]")
+{
+    const std::string html = "<html></html>";
+    const std::string packed = "packed";
+    int inflates = 0;
+
+    // Stand-in for gzip: "inflates" to the HTML
+    UIResourceCache cache({{"index.html.gz", packed.data(), packed.size()}, {"app.css", "a{}", 3}},
+                          [&](const void*, size_t) {
+                              ++inflates;
+                              const auto* b = reinterpret_cast<const std::byte*>(html.data());
+                              return std::vector<std::byte>(b, b + html.size());
+                          });
+
+    SECTION("Root and query strings find index.html, served under its own name")
+    {
+        const auto* file = cache.find("/");
+        REQUIRE(file != nullptr);
+        REQUIRE(file->bytes.size() == html.size());
+        REQUIRE(file->mimeType == "text/html");
+        REQUIRE(cache.find("index.html?v=2#top") == file);
+        REQUIRE(cache.find("index.html.gz") == nullptr);
+        REQUIRE(inflates == 1);
+    }
+
+    SECTION("Plain files are served as they are")
+    {
+        const auto* file = cache.find("/app.css");
+        REQUIRE(file != nullptr);
+        REQUIRE(file->bytes.size() == 3);
+        REQUIRE(file->mimeType == "text/css");
+        REQUIRE(inflates == 0);
+    }
+
+    SECTION("Unknown paths find nothing")
+    {
+        REQUIRE(cache.find("missing.js") == nullptr);
+        REQUIRE(UIResourceCache::mimeTypeFor("x.bin") == "application/octet-stream");
+    }
+}
+
+TEST_CASE("PerfStats counts blocks, stages and voices", "[perf]")
+{
+    PerfStats stats;
+    stats.prepare(48000.0);
+
+    for (int b = 0; b < 8; ++b)
+    {
+        stats.beginBlock();
+        {
+            PerfStats::ScopedStage stage(stats, PerfStats::Voices);
+            volatile float sink = 0.0f;
+            for (int i = 0; i < 1000; ++i)
+                sink = sink + 1.0f;
+        }
+        stats.endBlock(256, 2);
+    }
+
+    const auto snap = stats.getSnapshot();
+    REQUIRE(snap.enabled == PerfStats::ENABLED);
+
+    if constexpr (PerfStats::ENABLED)
+    {
+        REQUIRE(snap.blocks == 8);
+        REQUIRE(snap.voiceHistogram[2] == 8);
+        REQUIRE(snap.stageCycles[PerfStats::Voices] > 0);
+        REQUIRE(snap.stageCycles[PerfStats::Voices] <= snap.blockCycles);
+        REQUIRE(snap.worstBlockUs >= snap.lastBlockUs);
+    }
+    else
+    {
+        // Compiled out: nothing is counted
+        REQUIRE(snap.blocks == 0);
+    }
+}
+
+TEST_CASE("ModRouting sums routes into targets", "[modmatrix]")
+{
+    ModRouting mod;
+    REQUIRE(mod.getActiveRouteCount() == 0);
+
+    SECTION("No routes leave every target at 0")
+    {
+        mod.setSource(ModSource::ModWheel, 1.0f);
+        mod.process();
+        REQUIRE(mod.get(ModTarget::Pitch) == 0.0f);
+        REQUIRE(mod.get(ModTarget::Amp) == 0.0f);
+    }
+
+    SECTION("Routes to one target add up")
+    {
+        mod.setRoute(0, ModSource::PitchBend, ModTarget::Pitch, 2.0f);
+        mod.setRoute(3, ModSource::ModWheel, ModTarget::Pitch, 0.5f);
+        mod.setRoute(5, ModSource::ModWheel, ModTarget::FilterCutoff, -1.0f);
+        REQUIRE(mod.needsResolve());
+        mod.resolve();
+        REQUIRE(mod.getActiveRouteCount() == 3);
+
+        mod.setSource(ModSource::PitchBend, -0.5f);
+        mod.setSource(ModSource::ModWheel, 1.0f);
+        mod.process();
+        REQUIRE(mod.get(ModTarget::Pitch) == Approx(-0.5f));
+        REQUIRE(mod.get(ModTarget::FilterCutoff) == Approx(-1.0f));
+        REQUIRE(mod.get(ModTarget::Amp) == 0.0f);
+
+        // Depth changes apply without resolving
+        mod.setDepth(3, 1.0f);
+        mod.process();
+        REQUIRE(mod.get(ModTarget::Pitch) == Approx(0.0f));
+    }
+
+    SECTION("Cleared routes stop contributing")
+    {
+        mod.setRoute(0, ModSource::ModWheel, ModTarget::Amp, 1.0f);
+        mod.setRoute(1, ModSource::PitchBend, ModTarget::Amp, 1.0f);
+        mod.resolve();
+        mod.clearRoute(1);
+        mod.resolve();
+        REQUIRE(mod.getActiveRouteCount() == 1);
+
+        mod.setSource(ModSource::ModWheel, 0.25f);
+        mod.setSource(ModSource::PitchBend, 1.0f);
+        mod.process();
+        REQUIRE(mod.get(ModTarget::Amp) == Approx(0.25f));
+    }
+}
+
+TEST_CASE("TailGate sleeps an effect once its tail has run out", "[silence]")
+{
+    SECTION("Tail models")
+    {
+        // One dry pass, then 20 halvings to get under -120 dB
+        REQUIRE(Silence::feedbackTail(100.0, 0.5) == 2100);
+        REQUIRE(Silence::feedbackTail(100.0, 0.0) == 100);
+        REQUIRE(Silence::feedbackTail(100.0, 1.0) == Silence::INFINITE_TAIL);
+        REQUIRE(Silence::decayTail(0.9) == 133);
+    }
+
+    SECTION("Silence detection")
+    {
+        std::array<float, 64> left{};
+        std::array<float, 64> right{};
+        left[10] = 0.5f * Silence::THRESHOLD;
+        REQUIRE(Silence::isSilent(left.data(), right.data(), 64));
+        right[63] = -2.0f * Silence::THRESHOLD;
+        REQUIRE_FALSE(Silence::isSilent(left.data(), right.data(), 64));
+    }
+
+    TailGate gate;
+
+    SECTION("Starts asleep, wakes on input, runs out the tail")
+    {
+        REQUIRE_FALSE(gate.process(true, 64, 1000));
+        REQUIRE(gate.process(false, 64, 1000));
+
+        int blocks = 0;
+        while (gate.process(true, 64, 1000))
+            ++blocks;
+        REQUIRE(blocks == 16);  // 1024 silent samples cover the 1000-sample tail
+        REQUIRE_FALSE(gate.process(true, 64, 1000));
+    }
+
+    SECTION("A longer tail keeps a ringing effect awake")
+    {
+        gate.process(false, 64, 1000);
+        for (int b = 0; b < 10; ++b)
+            gate.process(true, 64, 1000);
+
+        // Feedback turned up mid-tail
+        REQUIRE(gate.process(true, 64, 100000));
+        REQUIRE(gate.process(true, 64, Silence::INFINITE_TAIL));
+
+        gate.reset();
+        REQUIRE_FALSE(gate.process(true, 64, Silence::INFINITE_TAIL));
+    }
+}
+
+TEST_CASE("StepClock finds step boundaries ahead of the render", "[sequencer]")
+{
+    // Reference: the per-sample counter StepClock replaces
+    auto perSampleSteps = [](double samplesPerStep, int numSamples)
+    {
+        std::vector<int> steps;
+        double count = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            count += 1.0;
+            if (count >= samplesPerStep)
+            {
+                count -= samplesPerStep;
+                steps.push_back(i);
+            }
+        }
+        return steps;
+    };
+
+    SECTION("Runs step on the same samples as counting one at a time")
+    {
+        for (double samplesPerStep : {1.0, 7.0, 100.5, 6486.486})
+        {
+            StepClock clock;
+            clock.setSamplesPerStep(samplesPerStep);
+
+            std::vector<int> steps;
+            int i = 0;
+            while (i < 40000)
+            {
+                bool stepped = false;
+                const int n = clock.next(std::min(40000 - i, 64), stepped);
+                REQUIRE(n >= 1);
+                if (stepped)
+                    steps.push_back(i);
+                i += n;
+            }
+            REQUIRE(steps == perSampleSteps(samplesPerStep, 40000));
+        }
+    }
+
+    SECTION("Two clocks share runs")
+    {
+        StepClock a, b;
+        a.setSamplesPerStep(30.0);
+        b.setSamplesPerStep(45.5);
+
+        std::vector<int> stepsA, stepsB;
+        for (int i = 0; i < 1000;)
+        {
+            const int n = std::min({1000 - i, a.nextRunLength(), b.nextRunLength()});
+            if (a.advance(n))
+                stepsA.push_back(i);
+            if (b.advance(n))
+                stepsB.push_back(i);
+            i += n;
+        }
+        REQUIRE(stepsA == perSampleSteps(30.0, 1000));
+        REQUIRE(stepsB == perSampleSteps(45.5, 1000));
+    }
+
+    SECTION("A shorter step mid-way catches up on the next sample")
+    {
+        StepClock clock;
+        clock.setSamplesPerStep(1000.0);
+        clock.advance(500);
+
+        clock.setSamplesPerStep(100.0);
+        REQUIRE(clock.nextRunLength() == 1);
+        REQUIRE(clock.advance(1));
+
+        // After a reset the 100th sample is the step, and starts the next run
+        clock.reset();
+        REQUIRE(clock.nextRunLength() == 99);
+    }
+
+    SECTION("Steps of varying length, queued one ahead")
+    {
+        // Gaps of 10, 3, 7, 3, 7, ... samples: a run starting on a step
+        // must stop at the queued step, not the one just finished
+        StepClock clock;
+        clock.setSamplesPerStep(10.0);
+        clock.setNextStep(3.0);
+
+        std::vector<int> steps;
+        int gap = 3;
+        for (int i = 0; i < 60;)
+        {
+            bool stepped = false;
+            const int n = clock.next(64, stepped);
+            if (stepped)
+            {
+                steps.push_back(i);
+                gap = gap == 3 ? 7 : 3;
+                clock.setNextStep(gap);
+            }
+            i += n;
+        }
+        REQUIRE(steps == std::vector<int>{9, 12, 19, 22, 29, 32, 39, 42, 49, 52, 59});
+    }
+}
+
+TEST_CASE("Arpeggiator plays its steps on their own samples", "[arp]")
+{
+    struct Note
+    {
+        int sample;
+        int note;
+        bool on;
+    };
+
+    // 4800 Hz, 120 BPM, sixteenths: 600 samples a step
+    auto run = [](Arpeggiator& arp, int numSamples, int chunk) {
+        std::vector<Note> notes;
+        for (int i = 0; i < numSamples;)
+        {
+            const int end = std::min(numSamples, i + chunk);
+            while (i < end)
+            {
+                const int n = arp.next(end - i, [&](int note, float velocity) {
+                    notes.push_back({i, note, velocity > 0.0f});
+                });
+                REQUIRE(n >= 1);
+                i += n;
+            }
+        }
+        return notes;
+    };
+
+    auto onsets = [](const std::vector<Note>& notes) {
+        std::vector<int> pitches;
+        for (const auto& n : notes)
+        {
+            if (n.on)
+                pitches.push_back(n.note);
+        }
+        return pitches;
+    };
+
+    Arpeggiator arp;
+    arp.prepare(4800.0);
+    arp.setTempo(120.0);
+    arp.setStepsPerBeat(4.0);
+    arp.setGate(0.5f);
+
+    SECTION("The first key plays at once; steps and gate ends land on their samples at any block size")
+    {
+        for (int chunk : {1, 17, 64, 512})
+        {
+            arp.reset();
+            arp.noteOn(67, 0.8f);
+            arp.noteOn(60, 0.8f);
+            arp.noteOn(64, 0.8f);
+
+            const auto notes = run(arp, 2400, chunk);
+            REQUIRE(notes.size() == 8);
+            for (size_t k = 0; k < notes.size(); ++k)
+            {
+                REQUIRE(notes[k].sample == static_cast<int>(k) * 300);
+                REQUIRE(notes[k].on == (k % 2 == 0));
+            }
+            REQUIRE(onsets(notes) == std::vector<int>{60, 64, 67, 60});
+        }
+    }
+
+    SECTION("Modes and octaves order the pattern")
+    {
+        arp.noteOn(64, 0.8f);
+        arp.noteOn(60, 0.8f);
+
+        arp.setMode(Arpeggiator::Mode::AsPlayed);
+        REQUIRE(onsets(run(arp, 2400, 64)) == std::vector<int>{64, 60, 64, 60});
+
+        arp.setMode(Arpeggiator::Mode::Up);
+        arp.setOctaves(2);
+        REQUIRE(arp.getPatternLength() == 4);
+        arp.stop([](int, float) {});
+        arp.noteOn(60, 0.8f);
+        arp.noteOn(64, 0.8f);
+        REQUIRE(onsets(run(arp, 3600, 64)) == std::vector<int>{60, 64, 72, 76, 60, 64});
+
+        arp.setMode(Arpeggiator::Mode::UpDown);
+        arp.stop([](int, float) {});
+        arp.noteOn(60, 0.8f);
+        arp.noteOn(64, 0.8f);
+        REQUIRE(onsets(run(arp, 4200, 64)) == std::vector<int>{60, 64, 72, 76, 72, 64, 60});
+    }
+
+    SECTION("Letting the last key go releases the sounding note")
+    {
+        arp.noteOn(60, 0.8f);
+        run(arp, 100, 64);
+        REQUIRE(arp.getPlayingNote() == 60);
+
+        int released = -1;
+        arp.noteOff(60, [&](int note, float velocity) {
+            if (velocity == 0.0f)
+                released = note;
+        });
+        REQUIRE(released == 60);
+        REQUIRE_FALSE(arp.isRunning());
+    }
+
+    SECTION("Following the host, a key waits for the next step on its grid")
+    {
+        arp.syncTo(0.55);  // 2.2 steps in: the next starts 480 samples on
+        arp.noteOn(60, 0.8f);
+        const auto notes = run(arp, 1200, 64);
+        REQUIRE(notes.size() >= 1);
+        REQUIRE(notes[0].sample == 480);
+        REQUIRE(notes[0].on);
+    }
+
+    SECTION("Chords expand each key")
+    {
+        ChordMemory chords;
+        chords.setShape(ChordMemory::Shape::Minor);
+        arp.setChordMemory(&chords);
+        arp.noteOn(60, 0.8f);
+        REQUIRE(onsets(run(arp, 1800, 64)) == std::vector<int>{60, 63, 67});
+    }
+}
+
+TEST_CASE("ChordMemory releases the notes each key started", "[arp]")
+{
+    ChordMemory chords;
+    std::vector<int> started, released;
+    auto start = [&](int n) { started.push_back(n); };
+    auto release = [&](int n) { released.push_back(n); };
+
+    chords.noteOn(60, start);
+    REQUIRE(started == std::vector<int>{60});
+
+    chords.setShape(ChordMemory::Shape::Major7);
+    chords.noteOn(62, start);
+    REQUIRE(started == std::vector<int>{60, 62, 66, 69, 73});
+
+    // A shape change while keys are down still lets go of what they started
+    chords.setShape(ChordMemory::Shape::Off);
+    chords.noteOff(62, release);
+    REQUIRE(released == std::vector<int>{62, 66, 69, 73});
+
+    SECTION("Memory plays a learned chord from any key")
+    {
+        const int learned[] = {69, 62, 65, 65};
+        chords.memorize(learned, 4);
+        chords.setShape(ChordMemory::Shape::Memory);
+
+        std::array<int, ChordMemory::MAX_NOTES> notes{};
+        REQUIRE(chords.expand(48, notes.data()) == 3);
+        REQUIRE(notes[0] == 48);
+        REQUIRE(notes[1] == 51);
+        REQUIRE(notes[2] == 55);
+    }
+
+    SECTION("Notes past 127 are dropped")
+    {
+        chords.setShape(ChordMemory::Shape::Fifths);
+        std::array<int, ChordMemory::MAX_NOTES> notes{};
+        REQUIRE(chords.expand(120, notes.data()) == 2);
+    }
+}
+
+TEST_CASE("SynthEngine arpeggiates held keys ahead of its voices", "[arp][engine]")
+{
+    SynthEngine engine;
+    engine.prepare(48000.0, 512);
+    engine.setTempo(120.0f);
+    engine.setArpRate(3);  // Sixteenths: 6000 samples
+    engine.setArpMode(1);
+
+    std::array<float, 512> left{}, right{};
+    engine.noteOn(60, 0.8f);
+    engine.noteOn(64, 0.8f);
+
+    engine.renderBlock(left.data(), right.data(), 64);
+    REQUIRE(engine.getActiveVoiceCount() == 1);
+
+    // The second step starts a second voice while the first releases
+    for (int i = 64; i < 6000 + 64; i += 512)
+        engine.renderBlock(left.data(), right.data(), std::min(512, 6000 + 64 - i));
+    REQUIRE(engine.getActiveVoiceCount() == 2);
+
+    SECTION("The arp renders without allocating or locking")
+    {
+        const auto rt = RealtimeGuard::check([&] {
+            for (int i = 0; i < 100; ++i)
+                engine.renderBlock(left.data(), right.data(), 512);
+        });
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.locks == 0);
+    }
+
+    SECTION("Turning it off stops its notes")
+    {
+        engine.setArpMode(0);
+        engine.allNotesOff();
+        engine.noteOn(60, 0.8f);
+        REQUIRE(engine.getActiveVoiceCount() == 1);
+    }
+}
+
+TEST_CASE("ParamSnapshot reports only the parameters that moved", "[params]")
+{
+    // 70 parameters spans two words of change bits
+    std::array<std::atomic<float>, 70> apvtsValues;
+    for (auto& v : apvtsValues)
+        v.store(0.5f);
+
+    ParamSnapshot<70> params;
+    for (int i = 0; i < 70; ++i)
+        params.bind(i, &apvtsValues[static_cast<size_t>(i)]);
+
+    SECTION("The first update reports everything")
+    {
+        params.update();
+        REQUIRE(params.anyChanged());
+        for (int i = 0; i < 70; ++i)
+        {
+            REQUIRE(params.changed(i));
+            REQUIRE(params[i] == 0.5f);
+        }
+    }
+
+    SECTION("Later updates report only the values that changed")
+    {
+        params.update();
+        params.update();
+        REQUIRE_FALSE(params.anyChanged());
+
+        apvtsValues[3].store(0.25f);
+        apvtsValues[66].store(1.0f);
+        params.update();
+        REQUIRE(params.anyChanged());
+        REQUIRE(params.changed(3));
+        REQUIRE(params.changed(66));
+        REQUIRE(params.changed(0, 1, 66));
+        REQUIRE_FALSE(params.changed(0, 1, 2));
+        REQUIRE_FALSE(params.changed(65));
+        REQUIRE(params[3] == 0.25f);
+        REQUIRE(params[66] == 1.0f);
+
+        // Storing the same value again is not a change
+        apvtsValues[3].store(0.25f);
+        params.update();
+        REQUIRE_FALSE(params.anyChanged());
+    }
+
+    SECTION("markAllChanged re-reports everything once")
+    {
+        params.update();
+        params.markAllChanged();
+        params.update();
+        REQUIRE(params.changed(0));
+        REQUIRE(params.changed(69));
+
+        params.update();
+        REQUIRE_FALSE(params.anyChanged());
+    }
+
+    SECTION("Choice and bool views match processBlock's casts")
+    {
+        apvtsValues[0].store(2.0f);
+        apvtsValues[1].store(1.0f);
+        params.update();
+        REQUIRE(params.index(0) == 2);
+        REQUIRE(params.flag(1));
+        REQUIRE_FALSE(params.flag(2));
+    }
+
+    SECTION("set() marks unbound values")
+    {
+        ParamSnapshot<4> offline;
+        offline.update();
+        REQUIRE(offline.changed(2));  // first block: everything
+        offline.update();
+        REQUIRE_FALSE(offline.anyChanged());
+        offline.set(2, 0.0f);
+        REQUIRE_FALSE(offline.changed(2));
+        offline.set(2, 3.0f);
+        REQUIRE(offline.changed(2));
+        REQUIRE(offline[2] == 3.0f);
+    }
+}
+
+TEST_CASE("ParamSmoother ramps only the lanes that move", "[params][smoothing]")
+{
+    // Six lanes: one full SIMD group and a partial one
+    ParamSmoother<6> smoothers;
+    smoothers.prepare(1000.0, 10.0f);  // 10-sample ramps
+    for (int lane = 0; lane < 6; ++lane)
+        smoothers.setTarget(lane, 1.0f);
+
+    SECTION("The first target jumps")
+    {
+        REQUIRE_FALSE(smoothers.anyMoving());
+        for (int lane = 0; lane < 6; ++lane)
+            REQUIRE(smoothers.getValue(lane) == 1.0f);
+    }
+
+    SECTION("A new target ramps linearly and lands exactly")
+    {
+        smoothers.setTarget(5, 2.0f);
+        REQUIRE(smoothers.isMoving(5));
+        REQUIRE_FALSE(smoothers.isMoving(0));
+
+        std::array<float, 16> ramp{};
+        smoothers.renderRamp(5, ramp.data(), 16);
+        REQUIRE(ramp[0] == Approx(1.0f));
+        REQUIRE(ramp[5] == Approx(1.5f));
+        REQUIRE(ramp[9] == Approx(1.9f));
+        REQUIRE(ramp[10] == 2.0f);
+        REQUIRE(ramp[15] == 2.0f);
+
+        smoothers.advance(4);
+        REQUIRE(smoothers.getValue(5) == Approx(1.4f));
+        REQUIRE(smoothers.getValue(4) == 1.0f);
+
+        smoothers.advance(64);
+        REQUIRE(smoothers.getValue(5) == 2.0f);
+        REQUIRE_FALSE(smoothers.anyMoving());
+    }
+
+    SECTION("Lanes in different groups move independently")
+    {
+        smoothers.setTarget(1, 0.0f);
+        smoothers.advance(5);
+        smoothers.setTarget(4, 3.0f);
+        smoothers.advance(5);
+
+        REQUIRE(smoothers.getValue(1) == 0.0f);
+        REQUIRE_FALSE(smoothers.isMoving(1));
+        REQUIRE(smoothers.getValue(4) == Approx(2.0f));
+        REQUIRE(smoothers.isMoving(4));
+
+        smoothers.advance(5);
+        REQUIRE(smoothers.getValue(4) == 3.0f);
+        REQUIRE_FALSE(smoothers.anyMoving());
+    }
+
+    SECTION("Retargeting mid-ramp starts from where the lane is")
+    {
+        smoothers.setTarget(0, 2.0f);
+        smoothers.advance(5);
+        smoothers.setTarget(0, 0.5f);
+        REQUIRE(smoothers.getValue(0) == Approx(1.5f));
+        smoothers.advance(10);
+        REQUIRE(smoothers.getValue(0) == 0.5f);
+    }
+
+    SECTION("reset() jumps, and so does the next target")
+    {
+        smoothers.setTarget(2, 4.0f);
+        smoothers.reset(2, 0.0f);
+        REQUIRE(smoothers.getValue(2) == 0.0f);
+        smoothers.setTarget(2, 0.75f);
+        REQUIRE(smoothers.getValue(2) == 0.75f);
+        REQUIRE_FALSE(smoothers.isMoving(2));
+    }
+
+    SECTION("A lane can have its own ramp time")
+    {
+        smoothers.setRampTime(1, 2.0f);  // 2 samples
+        smoothers.setTarget(1, 3.0f);
+        smoothers.setTarget(0, 3.0f);
+        smoothers.advance(2);
+        REQUIRE(smoothers.getValue(1) == 3.0f);
+        REQUIRE(smoothers.getValue(0) == Approx(1.4f));
+
+        smoothers.prepare(2000.0, 10.0f);  // Own time survives a new rate: 4 samples
+        smoothers.setTarget(1, 1.0f);
+        smoothers.advance(2);
+        REQUIRE(smoothers.getValue(1) == Approx(2.0f));
+    }
+
+    SECTION("prepare() lands every ramp")
+    {
+        smoothers.setTarget(3, 5.0f);
+        smoothers.prepare(48000.0);
+        REQUIRE(smoothers.getValue(3) == 5.0f);
+        REQUIRE_FALSE(smoothers.anyMoving());
+    }
+}
+
+TEST_CASE("ActiveVoiceList keeps the sounding voices packed", "[voices]")
+{
+    ActiveVoiceList<8> active;
+    auto listed = [&]
+    {
+        std::vector<int> v(active.begin(), active.end());
+        std::sort(v.begin(), v.end());
+        return v;
+    };
+
+    active.add(3);
+    active.add(5);
+    active.add(3);  // Already there
+    active.add(0);
+    REQUIRE(active.size() == 3);
+    REQUIRE(listed() == std::vector<int>{0, 3, 5});
+
+    SECTION("update() drops the voices it's told finished")
+    {
+        int visited = 0;
+        active.update([&](int v) { ++visited; return v != 3; });
+        REQUIRE(visited == 3);
+        REQUIRE(listed() == std::vector<int>{0, 5});
+        REQUIRE_FALSE(active.contains(3));
+
+        active.add(3);
+        REQUIRE(active.contains(3));
+    }
+
+    SECTION("remove() and clear()")
+    {
+        active.remove(5);
+        active.remove(7);  // Not there
+        REQUIRE(listed() == std::vector<int>{0, 3});
+
+        active.clear();
+        REQUIRE(active.isEmpty());
+        REQUIRE_FALSE(active.contains(0));
+    }
+
+    SECTION("Full")
+    {
+        for (int v = 0; v < 8; ++v)
+            active.add(v);
+        REQUIRE(active.isFull());
+    }
+}
+
+TEST_CASE("NoiseSource is bounded and repeats for a seed", "[noise]")
+{
+    std::array<float, 67> a{};
+    std::array<float, 67> b{};
+
+    SECTION("Same seed, same noise, block fill or one at a time")
+    {
+        NoiseSource blockFill(42);
+        NoiseSource single(42);
+        blockFill.fillPM1(a.data(), static_cast<int>(a.size()));
+        for (auto& x : b)
+            x = single.unifPM1();
+        REQUIRE(a == b);
+    }
+
+    SECTION("A block fill carries on after single samples")
+    {
+        NoiseSource mixed(42);
+        NoiseSource single(42);
+        a[0] = mixed.unifPM1();
+        mixed.fillPM1(a.data() + 1, 5);
+        a[6] = mixed.unifPM1();
+        mixed.fillPM1(a.data() + 7, static_cast<int>(a.size()) - 7);
+        for (auto& x : b)
+            x = single.unifPM1();
+        REQUIRE(a == b);
+    }
+
+    SECTION("Values stay in [-1, 1) with roughly zero mean")
+    {
+        NoiseSource noise(7);
+        double sum = 0.0;
+        for (int i = 0; i < 48000; ++i)
+        {
+            const float x = noise.unifPM1();
+            REQUIRE(x >= -1.0f);
+            REQUIRE(x < 1.0f);
+            sum += x;
+        }
+        REQUIRE(std::abs(sum / 48000.0) < 0.02);
+    }
+
+    SECTION("Derived seeds decorrelate sources under one engine seed")
+    {
+        NoiseSource first(NoiseSource::deriveSeed(1, 0));
+        NoiseSource second(NoiseSource::deriveSeed(1, 1));
+        double dot = 0.0;
+        for (int i = 0; i < 48000; ++i)
+            dot += first.unifPM1() * second.unifPM1();
+        REQUIRE(std::abs(dot / 48000.0) < 0.01);
+    }
+
+    SECTION("reseed() restarts the sequence")
+    {
+        NoiseSource noise(3);
+        noise.fillPM1(a.data(), static_cast<int>(a.size()));
+        noise.reseed(3);
+        noise.fillPM1(b.data(), static_cast<int>(b.size()));
+        REQUIRE(a == b);
+    }
+}
+
+TEST_CASE("SSTEffect hosts an sst-effects effect at any block size", "[effects]")
+{
+    using Host = SSTEffect<sst::effects::reverb2::Reverb2>;
+    using R2 = Host::FX;
+
+    auto impulseResponse = [](const std::vector<int>& blockSizes) {
+        auto reverb = std::make_unique<Host>();
+        reverb->setParam(R2::rev2_decay_time, 0.0f);  // 2^0 = 1 s
+        reverb->setParam(R2::rev2_mix, 1.0f);
+        reverb->prepare(48000.0);
+        REQUIRE(reverb->isPrepared());
+
+        std::vector<float> left(24000, 0.0f), right(24000, 0.0f);
+        left[0] = right[0] = 1.0f;
+        size_t pos = 0;
+        for (size_t b = 0; pos < left.size(); ++b)
+        {
+            const int n = std::min(blockSizes[b % blockSizes.size()], static_cast<int>(left.size() - pos));
+            reverb->processBlock(left.data() + pos, right.data() + pos, n);
+            pos += static_cast<size_t>(n);
+        }
+        return left;
+    };
+
+    const auto fixed = impulseResponse({Host::BLOCK});
+    const auto ragged = impulseResponse({1, 7, 64, 3, 512, 33});
+
+    // The block size never changes what comes out, only when it's computed
+    REQUIRE(fixed == ragged);
+
+    // Nothing before the latency, then a tail
+    for (int i = 0; i < Host::LATENCY; ++i)
+        REQUIRE(fixed[static_cast<size_t>(i)] == 0.0f);
+
+    double energy = 0.0;
+    for (float s : fixed)
+    {
+        REQUIRE(std::isfinite(s));
+        energy += s * s;
+    }
+    REQUIRE(energy > 1.0e-4);
+}
+
+TEST_CASE("SendBuses sum the voices' sends and run each effect once", "[effects][sends]")
+{
+    auto buses = std::make_unique<SendBuses<2, 256>>();
+    std::array<float, 64> a{}, b{};
+    std::fill(a.begin(), a.end(), 1.0f);
+    std::fill(b.begin(), b.end(), 0.5f);
+
+    // Two voices into bus 0 at their own levels, nothing into bus 1
+    buses->begin();
+    buses->add(0, a.data(), a.data(), 64, 0.5f);
+    buses->add(0, b.data(), b.data(), 64, 0.25f);
+    REQUIRE(buses->gate(0, 64, 128));
+    REQUIRE_FALSE(buses->gate(1, 64, 128));
+    REQUIRE(buses->left(0)[0] == Approx(0.625f));
+    REQUIRE(buses->right(0)[63] == Approx(0.625f));
+
+    std::array<float, 64> outL{}, outR{};
+    buses->returnTo(0, outL.data(), outR.data(), 64, 2.0f);
+    REQUIRE(outL[10] == Approx(1.25f));
+
+    // Sends stop: silence in, for as long as the tail, then asleep
+    int awake = 0;
+    for (int block = 0; block < 10; ++block)
+    {
+        buses->begin();
+        if (buses->gate(0, 64, 128))
+        {
+            ++awake;
+            REQUIRE(isBufferSilent(buses->left(0), 64));
+        }
+    }
+    REQUIRE(awake == 2);
+}
+
+TEST_CASE("SynthEngine's sends leave the dry mix as it was", "[engine][sends]")
+{
+    // The template's buses have no effect yet, so what's sent is dropped
+    // and the voices' own path through the send buffers must match the
+    // direct one sample for sample
+    auto render = [](float send) {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 256);
+        engine->setSendLevel(0, send);
+        engine->setSendLevel(1, send * 0.5f);
+        engine->noteOn(60, 0.8f);
+        engine->noteOn(67, 0.6f);
+
+        std::vector<float> left(2048), right(2048);
+        for (size_t pos = 0; pos < left.size(); pos += 256)
+            engine->renderBlock(left.data() + pos, right.data() + pos, 256);
+        return left;
+    };
+
+    const auto dry = render(0.0f);
+    REQUIRE_FALSE(isBufferSilent(dry.data(), static_cast<int>(dry.size())));
+    REQUIRE(render(0.7f) == dry);
+}
+
+TEST_CASE("SynthEngine frees releasing voices under the cull threshold", "[engine][voices]")
+{
+    auto blocksToFree = [](float cullDb, float drive) {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(48000.0, 256);
+        engine->setDrive(drive);
+        engine->setCullThreshold(cullDb);
+        REQUIRE(engine->getCullThreshold() == cullDb);
+
+        std::vector<float> left(256), right(256);
+        engine->noteOn(60, 0.8f);
+        for (int b = 0; b < 10; ++b)
+            engine->renderBlock(left.data(), right.data(), 256);
+
+        engine->noteOff(60);
+        int blocks = 0;
+        while (engine->getActiveVoiceCount() > 0 && blocks < 1000)
+        {
+            engine->renderBlock(left.data(), right.data(), 256);
+            ++blocks;
+        }
+        return blocks;
+    };
+
+    const float never = -std::numeric_limits<float>::infinity();
+    const int idle = blocksToFree(never, 0.0f);
+
+    // The placeholder's 300 ms release is 56 blocks; at -20 dB out of a
+    // -6 dB master the voice goes with a quarter of its level left
+    REQUIRE(idle >= 56);
+    REQUIRE(blocksToFree(-20.0f, 0.0f) < idle * 85 / 100);
+    REQUIRE(blocksToFree(ReleaseCull::DEFAULT_DB, 0.0f) <= idle);
+
+    // The drive's gain counts: the same threshold holds the voice longer
+    REQUIRE(blocksToFree(-20.0f, 1.0f) > blocksToFree(-20.0f, 0.0f));
+}
+
+TEST_CASE("Voices oversample their drive only as far as the note needs", "[engine][voice][oversampling]")
+{
+    constexpr double sampleRate = 48000.0;
+
+    auto voice = std::make_unique<Voice>();
+    voice->prepare(sampleRate);
+    VoiceParams params;
+    params.drive = 1.0f;
+    voice->applyParams(params, 2);
+    voice->setModulation(0.0f, 0.0f, 0.0f);
+
+    std::vector<float> left(4096), right(4096);
+    auto render = [&](int n) {
+        std::fill(left.begin(), left.begin() + n, 0.0f);
+        std::fill(right.begin(), right.begin() + n, 0.0f);
+        voice->render(left.data(), right.data(), n);
+        return isBufferValid(left.data(), n) && !isBufferSilent(left.data(), n);
+    };
+
+    SECTION("The factor follows the note at note on, the latency doesn't")
+    {
+        voice->noteOn(45, 0.8f);  // 110 Hz: its harmonics stay in band
+        REQUIRE(voice->getDriveOversampling() == 1);
+        REQUIRE(voice->getLatency() == Oversampler::LATENCY);
+        REQUIRE(render(512));
+
+        voice->noteOn(100, 0.8f);  // 2.6 kHz
+        REQUIRE(voice->getDriveOversampling() == 2);
+        REQUIRE(voice->getLatency() == Oversampler::LATENCY);
+
+        voice->noteOn(115, 0.8f);  // 6.3 kHz
+        REQUIRE(voice->getDriveOversampling() == 4);
+        REQUIRE(voice->getLatency() == Oversampler::LATENCY);
+        REQUIRE(render(512));
+
+        voice->noteOn(45, 0.8f);
+        REQUIRE(voice->getDriveOversampling() == 1);
+    }
+
+    SECTION("A bend up raises the factor under the note, and it stays up until the next")
+    {
+        voice->noteOn(90, 0.8f);  // 1.48 kHz x 15 stays under Nyquist
+        REQUIRE(voice->getDriveOversampling() == 1);
+        REQUIRE(render(700));
+
+        voice->setModulation(2.0f, 0.0f, 0.0f);  // 1.66 kHz doesn't
+        REQUIRE(voice->getDriveOversampling() == 2);
+        REQUIRE(voice->getLatency() == Oversampler::LATENCY);
+        REQUIRE(render(700));
+
+        voice->setModulation(0.0f, 0.0f, 0.0f);
+        REQUIRE(voice->getDriveOversampling() == 2);
+        REQUIRE(render(700));
+
+        voice->noteOn(90, 0.8f);
+        REQUIRE(voice->getDriveOversampling() == 1);
+    }
+
+    SECTION("Off, the drive neither oversamples nor delays")
+    {
+        params.drive = 0.0f;
+        voice->applyParams(params, 3);
+        voice->noteOn(115, 0.8f);
+        REQUIRE(voice->getDriveOversampling() == 1);
+        REQUIRE(voice->getLatency() == 0);
+    }
+
+    SECTION("The engine reports one latency for every note and bend")
+    {
+        auto engine = std::make_unique<SynthEngine>();
+        engine->prepare(sampleRate, 256);
+        REQUIRE(engine->getLatencySamples() == 0);
+        engine->setDrive(1.0f);
+        const int latency = engine->getLatencySamples();
+        REQUIRE(latency == Oversampler::LATENCY);
+
+        std::vector<float> outL(256), outR(256);
+        for (int note : {45, 90, 115})
+        {
+            engine->noteOn(note, 0.8f);
+            engine->renderBlock(outL.data(), outR.data(), 256);
+            REQUIRE(engine->getLatencySamples() == latency);
+        }
+        engine->setPitchBend(1.0f);
+        engine->renderBlock(outL.data(), outR.data(), 256);
+        REQUIRE(isBufferValid(outL.data(), 256));
+        REQUIRE(engine->getLatencySamples() == latency);
+    }
+}
+
+TEST_CASE("VoiceInsertChain runs voice-effects units in whole blocks", "[effects][voice]")
+{
+    using Chain = VoiceInsertChain<2>;
+
+    auto sine = [](size_t n) {
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = 0.5f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / 48000.0f);
+        return v;
+    };
+
+    auto run = [&](Chain& chain, const std::vector<int>& blockSizes) {
+        auto left = sine(4800), right = sine(4800);
+        size_t pos = 0;
+        for (size_t b = 0; pos < left.size(); ++b)
+        {
+            const int n = std::min(blockSizes[b % blockSizes.size()], static_cast<int>(left.size() - pos));
+            chain.process(left.data() + pos, right.data() + pos, n, 0.0f);
+            pos += static_cast<size_t>(n);
+        }
+        return left;
+    };
+
+    SECTION("Every slot off passes the voice straight through")
+    {
+        Chain chain;
+        chain.prepare(48000.0);
+        REQUIRE(chain.isBypassed());
+        REQUIRE(run(chain, {7, 32}) == sine(4800));
+        REQUIRE(Chain::latencyFor({}) == 0);
+    }
+
+    SECTION("Units run at their block size, whatever the voice's")
+    {
+        std::array<VoiceInsertSettings, 2> settings{};
+        settings[0].type = VoiceInsert::BitCrusher;
+        settings[0].params[VoiceInsert::BitCrusherFX::fpBitdepth] = 0.25f;  // 4 bits
+        settings[1].type = VoiceInsert::RingMod;
+        REQUIRE(Chain::latencyFor(settings) == Chain::LATENCY);
+
+        Chain fixed, ragged;
+        for (Chain* c : {&fixed, &ragged})
+        {
+            c->prepare(48000.0);
+            c->apply(settings);
+            REQUIRE_FALSE(c->isBypassed());
+        }
+
+        const auto a = run(fixed, {Chain::BLOCK});
+        const auto b = run(ragged, {1, 5, 32, 3, 100});
+        REQUIRE(a == b);
+
+        // LATENCY samples of silence, then a processed (changed) signal
+        for (int i = 0; i < Chain::LATENCY; ++i)
+            REQUIRE(a[static_cast<size_t>(i)] == 0.0f);
+
+        const auto dry = sine(4800);
+        double diff = 0.0;
+        for (size_t i = Chain::LATENCY; i < a.size(); ++i)
+        {
+            REQUIRE(std::isfinite(a[i]));
+            diff += std::abs(a[i] - dry[i - Chain::LATENCY]);
+        }
+        REQUIRE(diff > 1.0);
+
+        // reset() starts the next note from silence with the same settings
+        fixed.reset();
+        REQUIRE(run(fixed, {Chain::BLOCK}) == a);
+    }
+}
+
+TEST_CASE("GranularEngine plays a bounded, reproducible cloud", "[effects][granular]")
+{
+    constexpr int N = 48000;
+    auto tone = [](std::vector<float>& l, std::vector<float>& r) {
+        for (size_t i = 0; i < l.size(); ++i)
+            l[i] = r[i] = 0.5f * std::sin(2.0f * 3.14159265f * 330.0f * static_cast<float>(i) / 48000.0f);
+    };
+
+    auto render = [&](GranularEngine& g, std::vector<float>& l, std::vector<float>& r, int& maxActive) {
+        maxActive = 0;
+        for (size_t pos = 0; pos < l.size(); pos += 100)
+        {
+            const int n = static_cast<int>(std::min<size_t>(100, l.size() - pos));
+            g.process(l.data() + pos, r.data() + pos, n);
+            maxActive = std::max(maxActive, g.getActiveGrains());
+        }
+    };
+
+    SECTION("Dense clouds stay within the grain budget")
+    {
+        GranularEngine g;
+        g.prepare(48000.0);
+        g.setDensity(1.0f);      // 200 grains/s
+        g.setSize(0.5f);         // 100 ms: 20 would overlap
+        g.setPosition(0.0f);
+        g.setGrainBudget(8);
+        g.setMix(1.0f);
+
+        std::vector<float> l(N), r(N);
+        tone(l, r);
+        int maxActive = 0;
+        render(g, l, r, maxActive);
+        REQUIRE(maxActive == 8);
+
+        double energy = 0.0;
+        for (float s : l)
+        {
+            REQUIRE(std::isfinite(s));
+            energy += s * s;
+        }
+        REQUIRE(energy > 1.0);
+    }
+
+    SECTION("A seed gives the same cloud every time")
+    {
+        std::vector<float> a(N), b(N), ra(N), rb(N);
+        for (auto* out : {&a, &b})
+        {
+            GranularEngine g;
+            g.prepare(48000.0);
+            g.setNoiseSeed(7);
+            g.setPosition(0.1f);
+            g.setPitch(7.0f);
+            g.setTexture(0.2f);
+            auto& right = out == &a ? ra : rb;
+            tone(*out, right);
+            int maxActive = 0;
+            render(g, *out, right, maxActive);
+            REQUIRE(maxActive <= GranularEngine::DEFAULT_GRAIN_BUDGET);
+        }
+        REQUIRE(a == b);
+        REQUIRE(ra == rb);
+    }
+
+    SECTION("Freeze keeps replaying the buffer after the input stops")
+    {
+        for (bool frozen : {false, true})
+        {
+            GranularEngine g;
+            g.prepare(48000.0);
+            g.setMix(1.0f);
+            g.setPosition(0.0f);
+            g.setSize(0.3f);
+
+            std::vector<float> l(N), r(N);
+            tone(l, r);
+            int maxActive = 0;
+            render(g, l, r, maxActive);
+
+            g.setFreeze(frozen);
+            std::vector<float> silentL(N, 0.0f), silentR(N, 0.0f);
+            render(g, silentL, silentR, maxActive);
+
+            double tail = 0.0;
+            for (size_t i = N / 2; i < silentL.size(); ++i)
+                tail += silentL[i] * silentL[i];
+            if (frozen)
+                REQUIRE(tail > 1.0);
+            else
+                REQUIRE(tail == 0.0);
+        }
+    }
+
+    SECTION("Dry only passes the input untouched")
+    {
+        GranularEngine g;
+        g.prepare(48000.0);
+        g.setMix(0.0f);
+        std::vector<float> l(N), r(N), dry(N), dryR(N);
+        tone(l, r);
+        tone(dry, dryR);
+        int maxActive = 0;
+        render(g, l, r, maxActive);
+        REQUIRE(l == dry);
+    }
+}
+
+namespace
+{
+struct GraphSignals
+{
+    std::array<float, 64> level{};
+    std::array<float, 64> drive{};
+};
+
+using Osc1 = DspGraph::Serial<GraphModules::Oscillator<OscShape::Saw>, GraphModules::SoftClip<&GraphSignals::drive>,
+                              DspGraph::Gain<&GraphSignals::level>>;
+using Osc2 = DspGraph::Serial<GraphModules::Oscillator<OscShape::Pulse>, DspGraph::When<false, DspGraph::Gain<&GraphSignals::level>>>;
+using Source = DspGraph::Sum<Osc1, Osc2>;
+} // namespace
+
+TEST_CASE("DspGraph chains its nodes at compile time", "[graph]")
+{
+    GraphSignals signals;
+    for (int i = 0; i < 64; ++i)
+    {
+        signals.level[i] = 0.5f + 0.005f * static_cast<float>(i);
+        signals.drive[i] = 0.3f;
+    }
+
+    SECTION("Disabled nodes are gone")
+    {
+        STATIC_REQUIRE(std::is_same_v<DspGraph::When<false, DspGraph::Gain<&GraphSignals::level>>, DspGraph::Skip>);
+        STATIC_REQUIRE(DspGraph::liveNodes<Osc1> == 3);
+        STATIC_REQUIRE(DspGraph::liveNodes<Source> == 4);
+        STATIC_REQUIRE(sizeof(Osc2) == sizeof(GraphModules::Oscillator<OscShape::Pulse>));
+    }
+
+    SECTION("A graph renders what the chain of its modules would")
+    {
+        Source source;
+        DspGraph::prepare(source, 48000.0);
+        DspGraph::node<0, 0>(source).setFrequency(220.0f);
+        DspGraph::node<1, 0>(source).setFrequency(330.0f);
+
+        DPWOscillator saw, pulse;
+        saw.prepare(48000.0);
+        saw.setShape(OscShape::Saw);
+        saw.setFrequency(220.0f);
+        pulse.prepare(48000.0);
+        pulse.setShape(OscShape::Pulse);
+        pulse.setFrequency(330.0f);
+        GraphModules::SoftClip<&GraphSignals::drive> clip;
+
+        std::array<float, 64> out{};
+        DspGraph::render(source, signals, out.data(), 64);
+        for (int i = 0; i < 64; ++i)
+        {
+            const float expected = clip.process(saw.process(), signals, i) * signals.level[i] + pulse.process();
+            REQUIRE(out[i] == Catch::Approx(expected).margin(1.0e-6));
+        }
+    }
+
+    SECTION("Processing graphs run in place")
+    {
+        DspGraph::Serial<DspGraph::Gain<&GraphSignals::level>, DspGraph::Gain<&GraphSignals::drive>> gains;
+        std::array<float, 64> io;
+        io.fill(1.0f);
+        DspGraph::process(gains, signals, io.data(), 64);
+        for (int i = 0; i < 64; ++i)
+            REQUIRE(io[i] == Catch::Approx(signals.level[i] * 0.3f));
+    }
+}
+
+namespace
+{
+struct PatchConstant
+{
+    static constexpr int INPUTS = 0;
+    static constexpr int OUTPUTS = 1;
+    float value = 1.0f;
+
+    void process(const float* const*, float* const* out, int numSamples) { std::fill(out[0], out[0] + numSamples, value); }
+};
+} // namespace
+
+TEST_CASE("PatchGraph compiles a patch into a block schedule", "[graph][patch]")
+{
+    SECTION("A chain runs in order and passes its slots on")
+    {
+        PatchGraph::Patch patch(48000.0, 16);
+        const int gain = patch.add<PatchConstant>();
+        int last = patch.add<PatchModules::Oscillator>(OscShape::Saw, 220.0f);
+        for (int i = 0; i < 3; ++i)
+        {
+            const int vca = patch.add<PatchModules::Vca>();
+            REQUIRE(patch.connect(last, 0, vca, 0));
+            REQUIRE(patch.connect(gain, 0, vca, 1));
+            last = vca;
+        }
+        patch.get<PatchConstant>(gain)->value = 0.5f;
+        patch.add<PatchModules::Oscillator>();  // Reaches nothing
+        REQUIRE(patch.setOutput(last, 0));
+        REQUIRE_FALSE(patch.connect(last, 1, gain, 0));
+
+        auto schedule = patch.compile();
+        REQUIRE(schedule->getNumSteps() == 5);
+        REQUIRE(schedule->getNumSlots() == 3);  // The gain's, and two the chain takes turns with
+        REQUIRE(schedule->getNumFeedbackCables() == 0);
+
+        DPWOscillator reference;
+        reference.prepare(48000.0);
+        reference.setShape(OscShape::Saw);
+        reference.setFrequency(220.0f);
+        std::array<float, 16> out{};
+        schedule->run(out.data(), 16);
+        for (float x : out)
+            REQUIRE(x == Catch::Approx(reference.process() * 0.125f).margin(1.0e-6));
+    }
+
+    SECTION("A loop is closed a block late")
+    {
+        PatchGraph::Patch patch(48000.0, 4);
+        const int one = patch.add<PatchConstant>();
+        const int sum = patch.add<PatchModules::Mixer>();
+        patch.connect(one, 0, sum, 0);
+        patch.connect(sum, 0, sum, 1);  // Counts blocks
+        patch.setOutput(sum, 0);
+
+        PatchGraph::Player player;
+        player.load(patch.compile());
+        std::array<float, 12> out{};
+        player.render(out.data(), 12);
+        for (int i = 0; i < 12; ++i)
+            REQUIRE(out[static_cast<size_t>(i)] == static_cast<float>(1 + i / 4));
+    }
+
+    SECTION("A new schedule takes over between blocks and keeps the modules' state")
+    {
+        PatchGraph::Patch patch(48000.0, 32);
+        const int osc = patch.add<PatchModules::Oscillator>(OscShape::Saw, 330.0f);
+        patch.setOutput(osc, 0);
+
+        PatchGraph::Player player;
+        player.load(patch.compile());
+        std::array<float, 64> first{}, second{};
+        player.render(first.data(), 64);
+
+        const int vca = patch.add<PatchModules::Vca>();  // Unity gain while unpatched
+        patch.connect(osc, 0, vca, 0);
+        patch.setOutput(vca, 0);
+        player.load(patch.compile());
+
+        const auto rt = RealtimeGuard::check([&] { player.render(second.data(), 64); });
+        REQUIRE(rt.allocations == 0);
+        REQUIRE(rt.deallocations == 0);
+        REQUIRE(rt.locks == 0);
+
+        DPWOscillator reference;
+        reference.prepare(48000.0);
+        reference.setShape(OscShape::Saw);
+        reference.setFrequency(330.0f);
+        for (float x : first)
+            REQUIRE(x == Catch::Approx(reference.process()).margin(1.0e-6));
+        for (float x : second)
+            REQUIRE(x == Catch::Approx(reference.process()).margin(1.0e-6));
+
+        patch.remove(vca);  // Its output goes with it
+        player.load(patch.compile());
+        player.render(second.data(), 64);
+        for (float x : second)
+            REQUIRE(x == 0.0f);
+    }
+
+    SECTION("Setters on a playing module take effect at its next block")
+    {
+        PatchGraph::Patch patch(48000.0, 32);
+        const int osc = patch.add<PatchModules::Oscillator>(OscShape::Saw, 330.0f);
+        patch.setOutput(osc, 0);
+
+        PatchGraph::Player player;
+        player.load(patch.compile());
+        std::array<float, 32> out{};
+        player.render(out.data(), 32);
+
+        DPWOscillator reference;
+        reference.prepare(48000.0);
+        reference.setShape(OscShape::Saw);
+        reference.setFrequency(330.0f);
+        for (int i = 0; i < 32; ++i)
+            reference.process();
+
+        patch.get<PatchModules::Oscillator>(osc)->setFrequency(550.0f);
+        reference.setFrequency(550.0f);
+        player.render(out.data(), 32);
+        for (float x : out)
+            REQUIRE(x == Catch::Approx(reference.process()).margin(1.0e-6));
+    }
+
+    SECTION("A filter follows its cutoff and the octaves patched into it")
+    {
+        auto rms = [](PatchModules::Filter::Mode mode, float cutoff, float octaves) {
+            PatchGraph::Patch patch(48000.0, 32);
+            const int osc = patch.add<PatchModules::Oscillator>(OscShape::Sine, 4000.0f);
+            const int filter = patch.add<PatchModules::Filter>(mode, cutoff);
+            const int offset = patch.add<PatchConstant>();
+            patch.get<PatchConstant>(offset)->value = octaves;
+            patch.connect(osc, 0, filter, 0);
+            patch.connect(offset, 0, filter, 1);
+            patch.setOutput(filter, 0);
+
+            auto schedule = patch.compile();
+            std::vector<float> out(4800);
+            for (size_t i = 0; i < out.size(); i += 32)
+                schedule->run(out.data() + i, 32);
+            double sum = 0.0;
+            for (size_t i = 2400; i < out.size(); ++i)
+                sum += out[i] * out[i];
+            return std::sqrt(sum / 2400.0);
+        };
+
+        const double open = rms(PatchModules::Filter::Mode::Lowpass, 20000.0f, 0.0f);
+        REQUIRE(open == Catch::Approx(std::sqrt(0.5)).epsilon(0.1));
+        REQUIRE(rms(PatchModules::Filter::Mode::Lowpass, 250.0f, 0.0f) < open * 0.01);
+        REQUIRE(rms(PatchModules::Filter::Mode::Lowpass, 250.0f, 6.0f) > open * 0.5);  // 16 kHz
+        REQUIRE(rms(PatchModules::Filter::Mode::Highpass, 250.0f, 0.0f) > open * 0.9);
+    }
+
+    SECTION("An insert runs its voice effect a chain's latency late")
+    {
+        auto render = [](VoiceInsert::Type type) {
+            PatchGraph::Patch patch(48000.0, 24);  // Not a multiple of the unit's block
+            const int osc = patch.add<PatchModules::Oscillator>(OscShape::Sine, 440.0f);
+            const int insert = patch.add<PatchModules::Insert>(type);
+            patch.connect(osc, 0, insert, 0);
+            patch.setOutput(insert, 0);
+
+            PatchGraph::Player player;
+            player.load(patch.compile());
+            std::vector<float> out(480);
+            for (size_t i = 0; i < out.size(); i += 24)
+                player.render(out.data() + i, 24);
+            return out;
+        };
+
+        const auto dry = render(VoiceInsert::Off);
+        REQUIRE(dry[1] != 0.0f);
+
+        const auto crushed = render(VoiceInsert::BitCrusher);
+        REQUIRE(isBufferValid(crushed.data(), 480));
+        for (int i = 0; i < VoiceInsertChain<1>::LATENCY; ++i)
+            REQUIRE(crushed[static_cast<size_t>(i)] == 0.0f);
+        REQUIRE_FALSE(isBufferSilent(crushed.data(), 480));
+
+        const auto ringMod = render(VoiceInsert::RingMod);
+        double difference = 0.0;
+        for (size_t i = VoiceInsertChain<1>::LATENCY; i < dry.size(); ++i)
+            difference += std::abs(ringMod[i] - dry[i - VoiceInsertChain<1>::LATENCY]);
+        REQUIRE(difference > 1.0);
+    }
+}
+
+TEST_CASE("Wavetables are band-limited, shared and morph between frames", "[wavetable]")
+{
+    auto& registry = WavetableRegistry::get();
+    const auto basic = registry.builtin(WavetableRegistry::Builtin::Basic);
+    REQUIRE(basic != nullptr);
+    REQUIRE(basic->getFrameCount() == 4);
+
+    SECTION("Every request gets the same table")
+    {
+        REQUIRE(registry.builtin(WavetableRegistry::Builtin::Basic) == basic);
+    }
+
+    SECTION("The mip level keeps the top harmonic under Nyquist")
+    {
+        for (float hz : {30.0f, 440.0f, 3000.0f, 15000.0f})
+        {
+            const float increment = hz / 48000.0f;
+            const int level = Wavetable::levelFor(increment);
+            if (level < Wavetable::LEVELS - 1)
+                REQUIRE(static_cast<float>(Wavetable::MAX_HARMONICS >> level) * increment <= 0.5f);
+
+            // The saw frame at that level: nothing above its harmonic limit
+            const int size = Wavetable::levelSize(level);
+            const float* saw = basic->frame(level, 2);
+            double above = 0.0;
+            for (int h = (Wavetable::MAX_HARMONICS >> level) + 1; h < size / 2; ++h)
+            {
+                double re = 0.0, im = 0.0;
+                for (int i = 0; i < size; ++i)
+                {
+                    re += saw[i] * std::cos(2.0 * 3.141592653589793 * h * i / size);
+                    im += saw[i] * std::sin(2.0 * 3.141592653589793 * h * i / size);
+                }
+                above += re * re + im * im;
+            }
+            REQUIRE(above < 1.0e-6);
+        }
+    }
+
+    SECTION("Position morphs from the first frame to the last")
+    {
+        WavetableOscillator osc;
+        osc.prepare(48000.0);
+        osc.setTable(basic);
+        osc.setFrequency(100.0f);
+        float peakSine = 0.0f;
+        for (int i = 0; i < 480; ++i)
+            peakSine = std::max(peakSine, std::abs(osc.process(0.0f)));
+        REQUIRE(peakSine == Catch::Approx(1.0f).margin(0.01f));
+
+        // The square's flat tops sit at +/-1 away from its edges
+        osc.reset(0.25f);
+        REQUIRE(osc.process(1.0f) == Catch::Approx(1.0f).margin(0.05f));
+    }
+
+    SECTION("Four lanes play what four oscillators would")
+    {
+        WavetableOscillatorQuad quad;
+        quad.prepare(48000.0);
+        quad.setTable(basic);
+        std::array<WavetableOscillator, 4> single;
+        const float hz[4] = {55.0f, 440.0f, 2500.0f, 9000.0f};
+        alignas(16) const float position[4] = {0.0f, 0.4f, 0.8f, 1.0f};
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            single[lane].prepare(48000.0);
+            single[lane].setTable(basic);
+            single[lane].setFrequency(hz[lane]);
+            quad.setFrequency(lane, hz[lane]);
+        }
+        for (int i = 0; i < 1000; ++i)
+        {
+            alignas(16) float out[4];
+            SIMD_MM(store_ps)(out, quad.process(SIMD_MM(load_ps)(position)));
+            for (int lane = 0; lane < 4; ++lane)
+                REQUIRE(out[lane] == Catch::Approx(single[lane].process(position[lane])).margin(1.0e-6));
+        }
+    }
+
+    SECTION("Tables survive a trip through an .awt file")
+    {
+        std::vector<float> frames(2 * 256);
+        for (int i = 0; i < 512; ++i)
+            frames[i] = 0.8f * std::sin(2.0f * 3.14159265f * static_cast<float>((i % 256) * (1 + i / 256)) / 256.0f);
+        const std::string path = "wavetable_test.awt";
+        REQUIRE(Wavetable::saveFile(path, frames.data(), 256, 2));
+
+        const auto loaded = registry.load(path);
+        REQUIRE(loaded != nullptr);
+        REQUIRE(loaded->getFrameCount() == 2);
+        REQUIRE(registry.load(path) == loaded);
+        const float* second = loaded->frame(0, 1);
+        for (int i = 0; i < Wavetable::levelSize(0); ++i)
+            REQUIRE(second[i] == Catch::Approx(0.8f * std::sin(2.0f * 3.14159265f * 2.0f * static_cast<float>(i) / Wavetable::levelSize(0))).margin(1.0e-3));
+        std::remove(path.c_str());
+
+        REQUIRE(registry.load("no/such/table.awt") == nullptr);
+    }
+}
+
+TEST_CASE("Waveguide strings play in tune, ring down and sustain under the bow", "[waveguide]")
+{
+    constexpr float sr = 48000.0f;
+
+    // Period from the autocorrelation peak near the expected one, refined by a parabola
+    auto measureHz = [&](const std::vector<float>& y, float expectedHz) {
+        const int start = static_cast<int>(y.size()) / 2;
+        const int minLag = static_cast<int>(sr / expectedHz * 0.8f);
+        const int maxLag = static_cast<int>(sr / expectedHz * 1.25f);
+        std::vector<double> c(static_cast<size_t>(maxLag + 2), 0.0);
+        for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+            for (int i = start; i < start + 4000; ++i)
+                c[static_cast<size_t>(lag)] += y[static_cast<size_t>(i)] * y[static_cast<size_t>(i + lag)];
+        int best = minLag;
+        for (int lag = minLag; lag <= maxLag; ++lag)
+            if (c[static_cast<size_t>(lag)] > c[static_cast<size_t>(best)])
+                best = lag;
+        const double l = c[static_cast<size_t>(best - 1)], m = c[static_cast<size_t>(best)], r = c[static_cast<size_t>(best + 1)];
+        return sr / static_cast<float>(best + 0.5 * (l - r) / (l - 2.0 * m + r));
+    };
+
+    auto rms = [](const std::vector<float>& y, size_t from, size_t to) {
+        double sum = 0.0;
+        for (size_t i = from; i < to; ++i)
+            sum += y[i] * y[i];
+        return std::sqrt(sum / static_cast<double>(to - from));
+    };
+
+    SECTION("Plucked and bowed strings sound at their frequency")
+    {
+        for (auto excitation : {StringExcitation::Pluck, StringExcitation::Bow})
+        {
+            for (float hz : {55.0f, 220.0f, 1000.0f})
+            {
+                auto string = std::make_unique<WaveguideString>();
+                string->prepare(sr);
+                string->reseed(1);
+                string->setExcitation(excitation);
+                string->setLoss(4.0f, 0.5f);
+                string->setFrequency(0, hz);
+                string->excite(0, 1.0f);
+
+                std::vector<float> y(24000);
+                for (auto& s : y)
+                    s = string->process();
+                const float cents = 1200.0f * std::log2(measureHz(y, hz) / hz);
+                INFO((excitation == StringExcitation::Pluck ? "pluck " : "bow ") << hz << " Hz: " << cents << " cents");
+                REQUIRE(std::abs(cents) < 3.0f);
+            }
+        }
+    }
+
+    SECTION("A pluck rings down; a bow sustains until it lifts")
+    {
+        auto string = std::make_unique<WaveguideString>();
+        string->prepare(sr);
+        string->reseed(7);
+        string->setLoss(0.5f, 0.8f);
+        string->setFrequency(0, 220.0f);
+        string->excite(0, 1.0f);
+        std::vector<float> y(48000);
+        for (auto& s : y)
+            s = string->process();
+        const double early = rms(y, 2400, 4800), late = rms(y, 26400, 28800);
+        REQUIRE(early > 0.01);
+        REQUIRE(late < early * 0.01);  // At least 40 dB down half a second later
+
+        string->reset(0);
+        string->setExcitation(StringExcitation::Bow);
+        string->excite(0, 0.8f);
+        for (auto& s : y)
+            s = string->process();
+        REQUIRE(rms(y, 24000, 48000) > 0.05);
+        REQUIRE(rms(y, 24000, 48000) == Catch::Approx(rms(y, 12000, 24000)).epsilon(0.2));
+
+        string->release(0);
+        for (auto& s : y)
+            s = string->process();
+        REQUIRE(rms(y, 24000, 48000) < 0.001);
+        for (float s : y)
+            REQUIRE(std::isfinite(s));
+    }
+
+    SECTION("Four lanes play what four strings would")
+    {
+        auto quad = std::make_unique<WaveguideQuad>();
+        auto single = std::make_unique<std::array<WaveguideString, 4>>();
+        const float hz[4] = {82.4f, 196.0f, 523.3f, 1318.5f};
+        quad->prepare(sr);
+        quad->setExcitation(StringExcitation::Bow);
+        quad->setLoss(3.0f, 0.3f);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            auto& s = (*single)[static_cast<size_t>(lane)];
+            s.prepare(sr);
+            s.setExcitation(StringExcitation::Bow);
+            s.setLoss(3.0f, 0.3f);
+            s.setFrequency(0, hz[lane]);
+            s.excite(0, 0.7f);
+            quad->setFrequency(lane, hz[lane]);
+            quad->excite(lane, 0.7f);
+        }
+        for (int i = 0; i < 4800; ++i)
+        {
+            float out[4];
+            quad->process(out);
+            for (int lane = 0; lane < 4; ++lane)
+                REQUIRE(out[lane] == Catch::Approx((*single)[static_cast<size_t>(lane)].process()).margin(1.0e-5));
+        }
+    }
+}
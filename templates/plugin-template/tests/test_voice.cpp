@@ -7,15 +7,22 @@
  * - Note on/off behavior
  * - Audio output validity
  * - Envelope behavior
+ * - Band-limited and unison oscillators
+ * - Oversampling around nonlinear stages
  */
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
 #include <array>
+#include <vector>
 
 // TODO: Include your voice implementation
 // #include "dsp/Voice.h"
+#include "BandLimitedOscillator.h"
+#include "Oversampler.h"
+#include "dsp/UnisonOscillator.h"
+#include "sst/basic-blocks/dsp/DPWSawPulseOscillator.h"
 
 using Catch::Approx;
 
@@ -64,6 +71,23 @@ int countZeroCrossings(const float* buffer, int numSamples)
     return crossings;
 }
 
+/**
+ * Amplitude of one frequency component (Goertzel)
+ */
+double toneAmplitude(const float* buffer, int numSamples, double freq, double sampleRate)
+{
+    const double w = 2.0 * M_PI * freq / sampleRate;
+    const double coeff = 2.0 * std::cos(w);
+    double s1 = 0.0, s2 = 0.0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double s = buffer[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return 2.0 * std::sqrt(s1 * s1 + s2 * s2 - coeff * s1 * s2) / numSamples;
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -255,3 +279,239 @@ TEST_CASE("Voice envelope behavior", "[voice][envelope]")
         REQUIRE(true); // Placeholder
     }
 }
+
+// ============================================================================
+// Oscillators
+// ============================================================================
+
+namespace {
+
+/**
+ * 4.7 kHz saw at 48 kHz: returns the fundamental and the 3.7 kHz alias of
+ * harmonic 11 (51.7 kHz), with the naive saw's alias for reference
+ */
+template <typename Osc>
+void measureAliasing(Osc& osc, double& fundamental, double& alias, double& naiveAlias)
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 9600;  // 0.2 s, a whole number of periods
+    constexpr double freq = 4700.0;
+
+    osc.prepare(sampleRate);
+    osc.setFrequency(static_cast<float>(freq));
+
+    std::array<float, numSamples> out{}, naive{};
+    double phase = 0.0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        out[static_cast<size_t>(i)] = osc.process();
+        naive[static_cast<size_t>(i)] = static_cast<float>(2.0 * phase - 1.0);
+        phase += freq / sampleRate;
+        phase -= std::floor(phase);
+    }
+
+    REQUIRE(isBufferValid(out.data(), numSamples));
+    fundamental = toneAmplitude(out.data(), numSamples, freq, sampleRate);
+    alias = toneAmplitude(out.data(), numSamples, 3700.0, sampleRate);
+    naiveAlias = toneAmplitude(naive.data(), numSamples, 3700.0, sampleRate);
+}
+
+/** Peak of every shape once past its start-up transient */
+template <typename Osc>
+void checkShapesBounded(Osc& osc)
+{
+    for (int shape = 0; shape < 4; ++shape)
+    {
+        osc.setShape(shape);
+        for (int i = 0; i < 256; ++i)
+            osc.process();
+
+        float peak = 0.0f;
+        for (int i = 0; i < 4800; ++i)
+            peak = std::max(peak, std::abs(osc.process()));
+        REQUIRE(peak > 0.5f);
+        REQUIRE(peak < 1.5f);
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("Band-limited oscillators keep aliases out of the audio band", "[voice][oscillator]")
+{
+    double fundamental = 0.0, alias = 0.0, naiveAlias = 0.0;
+
+    SECTION("Elliptic BLEP")
+    {
+        BlepOscillator osc;
+        measureAliasing(osc, fundamental, alias, naiveAlias);
+        REQUIRE(fundamental == Approx(2.0 / M_PI).epsilon(0.1));
+        REQUIRE(alias < naiveAlias * 0.1);
+        checkShapesBounded(osc);
+    }
+
+    SECTION("DPW")
+    {
+        DPWOscillator osc;
+        measureAliasing(osc, fundamental, alias, naiveAlias);
+        REQUIRE(fundamental == Approx(2.0 / M_PI).epsilon(0.1));
+        REQUIRE(alias < naiveAlias * 0.1);
+        checkShapesBounded(osc);
+    }
+}
+
+TEST_CASE("UnisonOscillator stacks detuned DPW saws", "[voice][oscillator]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 32;
+    constexpr int numBlocks = 64;
+
+    UnisonOscillator osc;
+    osc.prepare(sampleRate);
+    osc.setFrequency(220.0f);
+
+    std::array<float, blockSize * numBlocks> left{}, right{};
+
+    SECTION("One voice is sst's DPW saw, centred")
+    {
+        sst::basic_blocks::dsp::DPWSawOscillator<sst::basic_blocks::dsp::NoSmoothingStrategy> ref;
+        ref.retrigger();
+        ref.setFrequency(220.0, 1.0 / sampleRate);
+
+        for (int b = 0; b < numBlocks; ++b)
+            osc.render(left.data() + b * blockSize, right.data() + b * blockSize, blockSize);
+
+        // Two periods, before float phase accumulation drifts from the
+        // double-precision reference
+        for (size_t i = 0; i < 440; ++i)
+        {
+            const float expected = static_cast<float>(ref.step());
+            REQUIRE(left[i] == Approx(expected).margin(2e-3));
+            REQUIRE(right[i] == left[i]);
+        }
+    }
+
+    SECTION("Four voices spread across the stereo field")
+    {
+        osc.setVoices(4);
+        osc.setDetune(20.0f);
+
+        for (int b = 0; b < numBlocks; ++b)
+            osc.render(left.data() + b * blockSize, right.data() + b * blockSize, blockSize);
+
+        REQUIRE(isBufferValid(left.data(), static_cast<int>(left.size())));
+        REQUIRE(isBufferValid(right.data(), static_cast<int>(right.size())));
+
+        float peak = 0.0f;
+        double difference = 0.0;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            peak = std::max(peak, std::abs(left[i]));
+            difference += std::abs(left[i] - right[i]);
+        }
+
+        // Attenuated by 1 / sqrt(4) per copy
+        REQUIRE(peak < 2.5f);
+        REQUIRE(difference > 1.0);
+    }
+}
+
+TEST_CASE("Oversampler keeps a driven stage's aliases out", "[voice][oversampling]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 48000;
+    constexpr int skip = 4800;  // Past the filters' settling
+
+    // A 7 kHz sine through tanh(8x): the 5th and 7th harmonics (35 and 49 kHz)
+    // fold to 13 and 1 kHz at the base rate
+    auto drive = [&](int factor, std::vector<float>& out)
+    {
+        Oversampler oversampler;
+        oversampler.setFactor(factor);
+        out.resize(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            out[static_cast<size_t>(i)] = static_cast<float>(std::sin(2.0 * M_PI * 7000.0 * i / sampleRate));
+
+        // Uneven block sizes, as a host might send
+        for (int i = 0, b = 0; i < numSamples; ++b)
+        {
+            const int n = std::min(numSamples - i, 1 + (b * 37) % 160);
+            oversampler.processMono(out.data() + i, n, [](float* x, int m) {
+                for (int j = 0; j < m; ++j)
+                    x[j] = std::tanh(8.0f * x[j]);
+            });
+            i += n;
+        }
+    };
+
+    auto alias = [&](const std::vector<float>& out, double freq) {
+        return toneAmplitude(out.data() + skip, numSamples - skip, freq, sampleRate);
+    };
+
+    std::vector<float> base, x2, x4;
+    drive(1, base);
+    drive(2, x2);
+    drive(4, x4);
+
+    SECTION("The fundamental and in-band harmonics come through unchanged")
+    {
+        const double fundamental = alias(base, 7000.0);
+        REQUIRE(alias(x2, 7000.0) == Approx(fundamental).epsilon(0.01));
+        REQUIRE(alias(x4, 7000.0) == Approx(fundamental).epsilon(0.01));
+        REQUIRE(alias(x2, 21000.0) == Approx(alias(base, 21000.0)).epsilon(0.01));
+    }
+
+    SECTION("Folded harmonics sit 70 dB under the fundamental")
+    {
+        const double floor = alias(base, 7000.0) * 3e-4;
+        REQUIRE(alias(base, 13000.0) > 0.1);
+        REQUIRE(alias(base, 1000.0) > 0.1);
+        REQUIRE(alias(x2, 13000.0) < floor);
+        REQUIRE(alias(x2, 1000.0) < floor);
+        REQUIRE(alias(x4, 13000.0) < floor);
+        REQUIRE(alias(x4, 1000.0) < floor);
+    }
+
+    SECTION("Off is a straight pass-through")
+    {
+        Oversampler oversampler;
+        REQUIRE(oversampler.getFactor() == 1);
+        REQUIRE(oversampler.getLatency() == 0);
+
+        std::array<float, 64> x{};
+        x[3] = 1.0f;
+        oversampler.processMono(x.data(), 64, [](float*, int) {});
+        REQUIRE(x[3] == 1.0f);
+
+        oversampler.setFactor(3);
+        REQUIRE(oversampler.getFactor() == 2);
+        REQUIRE(oversampler.getLatency() == Oversampler::LATENCY);
+    }
+
+    SECTION("Each note gets only the factor its harmonics need")
+    {
+        REQUIRE(Oversampler::factorFor(sampleRate, 7000.0f, 0.0f) == 1);  // Nothing to fold
+        REQUIRE(Oversampler::factorFor(sampleRate, 110.0f, 1.0f) == 1);
+        REQUIRE(Oversampler::factorFor(sampleRate, 2000.0f, 1.0f) == 2);
+        REQUIRE(Oversampler::factorFor(sampleRate, 7000.0f, 1.0f) == 4);
+        REQUIRE(Oversampler::factorFor(sampleRate, 7000.0f, 0.3f) == 2);
+
+        Oversampler oversampler;
+        REQUIRE(oversampler.adapt(sampleRate, 7000.0f, 1.0f));
+        REQUIRE(oversampler.getFactor() == 4);
+        REQUIRE_FALSE(oversampler.adapt(sampleRate, 6000.0f, 1.0f));
+    }
+
+    SECTION("With constant latency, 1x is as late as the oversampled path")
+    {
+        Oversampler oversampler;
+        oversampler.setConstantLatency(true);
+        REQUIRE(oversampler.getLatency() == Oversampler::LATENCY);
+
+        std::array<float, 64> x{};
+        x[3] = 1.0f;
+        for (int i = 0; i < 64; i += 5)  // Blocks that don't fill a granule
+            oversampler.processMono(x.data() + i, std::min(5, 64 - i), [](float*, int) {});
+        for (int i = 0; i < 64; ++i)
+            REQUIRE(x[static_cast<size_t>(i)] == (i == 3 + Oversampler::LATENCY ? 1.0f : 0.0f));
+    }
+}
@@ -7,7 +7,7 @@
  *
  * Communication Flow:
  *   React -> JUCE: window.__JUCE__.backend.emitEvent("__juce__invoke", ...)
- *   JUCE -> React: window.onParameterUpdate(), window.onAudioData(), etc.
+ *   JUCE -> React: window.onParametersUpdate(), window.onAudioData(), etc.
  *
  * IMPORTANT: JUCE 8 native functions registered with withNativeFunction()
  * are NOT directly accessible on window.__JUCE__.backend. They must be
@@ -41,13 +41,24 @@ declare global {
     };
     /** Called by JUCE when a parameter changes */
     onParameterUpdate?: (paramId: string, value: number) => void;
+    /** Called by JUCE once per UI tick with every parameter that changed */
+    onParametersUpdate?: (values: Record<string, number>) => void;
     /** Called by JUCE with all parameter state */
     onStateUpdate?: (state: Record<string, number>) => void;
     /** Called by JUCE with audio visualization data */
     onAudioData?: (samples: number[]) => void;
+    /** Called by JUCE with base64 Float32 scope samples (see decodeScopeSamples) */
+    onAudioDataBase64?: (data: string) => void;
+    /** Called by JUCE once per UI tick with the engine's state */
+    onEngineState?: (state: EngineState) => void;
   }
 }
 
+/**
+ * Views that show live engine data; the editor ticks fast only while one is on screen
+ */
+export type LiveView = 'scope' | 'spectrum' | 'meters' | 'sequencer';
+
 /**
  * Hook configuration options
  */
@@ -58,6 +69,8 @@ export interface UseJUCEBridgeOptions {
   audioChannel?: 'lead' | 'drum' | 'sub' | 'master';
   /** Enable preset management */
   enablePresets?: boolean;
+  /** Live views on screen (default: ["scope"] with enableAudioData, else none) */
+  liveViews?: LiveView[];
 }
 
 /**
@@ -70,6 +83,13 @@ export interface JUCEInfo {
   bufferSize?: number;
 }
 
+/**
+ * Engine state sent once per UI tick (SynthEngine::EditorState)
+ */
+export interface EngineState {
+  activeVoices: number;
+}
+
 /**
  * Hook return type
  */
@@ -80,6 +100,8 @@ export interface UseJUCEBridgeReturn {
   juceInfo: JUCEInfo;
   /** Latest audio data samples for visualization */
   audioData: number[];
+  /** Latest engine state (active voices...) */
+  engineState: EngineState;
   /** Send parameter value to JUCE */
   setParameter: (paramId: string, value: number) => void;
   /** Request all parameters from JUCE */
@@ -101,6 +123,14 @@ const isJUCEWebView = (): boolean => {
   return typeof window !== 'undefined' && window.__JUCE__ !== undefined;
 };
 
+/**
+ * Decode scope samples sent by the editor: base64 of little-endian Float32
+ */
+const decodeScopeSamples = (data: string): number[] => {
+  const bytes = Uint8Array.from(atob(data), (c) => c.charCodeAt(0));
+  return Array.from(new Float32Array(bytes.buffer, 0, bytes.length >> 2));
+};
+
 /**
  * React hook for JUCE WebView integration
  *
@@ -118,11 +148,12 @@ const isJUCEWebView = (): boolean => {
  * ```
  */
 export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridgeReturn {
-  const { enableAudioData = false } = options;
+  const { enableAudioData = false, liveViews = enableAudioData ? ['scope'] : [] } = options;
 
   const [isConnected, setIsConnected] = useState(false);
   const [juceInfo, setJuceInfo] = useState<JUCEInfo>({});
   const [audioData, setAudioData] = useState<number[]>([]);
+  const [engineState, setEngineState] = useState<EngineState>({ activeVoices: 0 });
 
   // Callback refs for JUCE -> React communication
   const parameterCallbackRef = useRef<((paramId: string, value: number) => void) | null>(null);
@@ -150,6 +181,13 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Batched updates: everything the editor saw change since its last tick
+    window.onParametersUpdate = (values: Record<string, number>) => {
+      for (const [paramId, value] of Object.entries(values)) {
+        window.onParameterUpdate?.(paramId, value);
+      }
+    };
+
     // Full state update handler
     window.onStateUpdate = (state: Record<string, number>) => {
       if (stateCallbackRef.current) {
@@ -157,17 +195,28 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
       }
     };
 
+    // Engine state handler
+    window.onEngineState = (state: EngineState) => {
+      setEngineState(state);
+    };
+
     // Audio data handler
     if (enableAudioData) {
       window.onAudioData = (samples: number[]) => {
         setAudioData(samples);
       };
+      window.onAudioDataBase64 = (data: string) => {
+        setAudioData(decodeScopeSamples(data));
+      };
     }
 
     return () => {
       window.onParameterUpdate = undefined;
+      window.onParametersUpdate = undefined;
       window.onStateUpdate = undefined;
       window.onAudioData = undefined;
+      window.onAudioDataBase64 = undefined;
+      window.onEngineState = undefined;
     };
   }, [isConnected, enableAudioData]);
 
@@ -182,6 +231,21 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     });
   }, [isConnected]);
 
+  // Tell the editor which live views are on screen (none while the page is
+  // hidden), so it only ticks fast and feeds the scope while they are
+  const liveViewKey = liveViews.join(',');
+  useEffect(() => {
+    if (!isConnected || liveViewKey === '') return;
+    const views = liveViewKey.split(',');
+    const report = () => callNativeFunction("setLiveViews", document.hidden ? [] : views);
+    report();
+    document.addEventListener('visibilitychange', report);
+    return () => {
+      document.removeEventListener('visibilitychange', report);
+      callNativeFunction("setLiveViews", []);
+    };
+  }, [isConnected, liveViewKey, callNativeFunction]);
+
   // Send parameter to JUCE
   const setParameter = useCallback((paramId: string, value: number) => {
     if (!isConnected) return;
@@ -221,6 +285,7 @@ export function useJUCEBridge(options: UseJUCEBridgeOptions = {}): UseJUCEBridge
     isConnected,
     juceInfo,
     audioData,
+    engineState,
     setParameter,
     requestState,
     noteOn,
@@ -166,6 +166,63 @@ export const PARAMETER_DEFINITIONS: ParameterMap = {
     unit: 's',
   },
 
+  // =========================================================================
+  // ARPEGGIATOR / CHORD MEMORY
+  // =========================================================================
+
+  arp_mode: {
+    id: 'arp_mode',
+    name: 'Arp Mode',
+    min: 0,
+    max: 5,
+    default: 0,
+    step: 1,
+  },
+
+  arp_rate: {
+    id: 'arp_rate',
+    name: 'Arp Rate',
+    min: 0,
+    max: 5,
+    default: 3,
+    step: 1,
+  },
+
+  arp_octaves: {
+    id: 'arp_octaves',
+    name: 'Arp Octaves',
+    min: 1,
+    max: 4,
+    default: 1,
+    step: 1,
+  },
+
+  arp_gate: {
+    id: 'arp_gate',
+    name: 'Arp Gate',
+    min: 0.01,
+    max: 1,
+    default: 0.5,
+  },
+
+  arp_tempo: {
+    id: 'arp_tempo',
+    name: 'Arp Tempo',
+    min: 20,
+    max: 300,
+    default: 120,
+    unit: 'BPM',
+  },
+
+  chord_shape: {
+    id: 'chord_shape',
+    name: 'Chord',
+    min: 0,
+    max: 7,
+    default: 0,
+    step: 1,
+  },
+
   // =========================================================================
   // MASTER
   // =========================================================================
@@ -191,7 +248,9 @@ export function getParametersByCategory(category: ParameterCategory): ParameterD
       'amp_attack', 'amp_decay', 'amp_sustain', 'amp_release',
       'filter_attack', 'filter_decay', 'filter_sustain', 'filter_release',
     ],
-    [ParameterCategory.MODULATION]: [],
+    [ParameterCategory.MODULATION]: [
+      'arp_mode', 'arp_rate', 'arp_octaves', 'arp_gate', 'arp_tempo', 'chord_shape',
+    ],
     [ParameterCategory.EFFECTS]: [],
     [ParameterCategory.MASTER]: ['master_volume'],
   };
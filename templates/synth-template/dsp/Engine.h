@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Voice.h"
+#include "VoiceAllocator.h"
+#include "ActiveVoiceList.h"
+#include "PerfStats.h"
+// #include "GranularEngine.h"  // Clouds-style grain cloud for granular specs
+#include <algorithm>
 #include <array>
 #include <cmath>
 
@@ -9,6 +14,14 @@
  *
  * This engine manages voice allocation, parameter routing, and master processing.
  * Uses SST/Airwindows/ChowDSP libraries for all DSP operations.
+ *
+ * Voices come from a VoiceAllocator (free list, release order, steal
+ * policy) and render from an ActiveVoiceList: a released voice keeps
+ * rendering until its envelope finishes, then goes back on the free list.
+ * Note on, note off and the render loop never scan the whole pool.
+ *
+ * Voices read VoiceParams (Voice.h), not the raw parameter array:
+ * setParam() converts a changed value to Hz / gain / coefficients once.
  */
 class Engine {
 public:
@@ -17,43 +30,47 @@ public:
 
     Engine() {
         params.fill(0.5f);  // Initialize all params to midpoint
-        voiceActive.fill(false);
     }
 
     void prepare(float sr) {
         sampleRate = sr;
+        perfStats.prepare(sr);
         for (auto& voice : voices) {
             voice.init(sr);
         }
     }
 
     void noteOn(int note, float velocity) {
-        // Simple voice stealing: find first inactive voice
-        for (int i = 0; i < MAX_VOICES; i++) {
-            if (!voiceActive[i]) {
-                voices[i].noteOn(note, velocity);
-                voiceActive[i] = true;
-                return;
-            }
+        const auto slot = allocator.noteOn(note, [this](int v) { return voices[v].getLevel(); });
+        if (slot.stolen) {
+            voices[slot.voice].kill();
         }
-
-        // All voices active, steal oldest (voice 0)
-        voices[0].noteOn(note, velocity);
-        voiceActive[0] = true;
+        voices[slot.voice].noteOn(note, velocity);
+        active.add(slot.voice);  // A stolen voice is listed already
     }
 
+    /** Release every voice holding note; they sound until their release ends */
     void noteOff(int note) {
-        for (int i = 0; i < MAX_VOICES; i++) {
-            if (voiceActive[i] && voices[i].getNote() == note) {
-                voices[i].noteOff();
-                voiceActive[i] = false;
-            }
+        allocator.noteOff(note, [this](int v) { voices[v].noteOff(); });
+    }
+
+    void allNotesOff() {
+        for (int v : active) {
+            voices[v].kill();
         }
+        allocator.reset();
+        active.clear();
+    }
+
+    /** Which voice a note steals when all are busy: 0 Oldest, 1 Quietest, 2 Same Note */
+    void setVoiceSteal(int policy) {
+        allocator.setStealPolicy(static_cast<VoiceAllocator<MAX_VOICES>::StealPolicy>(std::clamp(policy, 0, 2)));
     }
 
     void setParam(int id, float value) {
         if (id >= 0 && id < MAX_PARAMS) {
             params[id] = value;
+            updateVoiceParams(id);
         }
     }
 
@@ -65,34 +82,69 @@ public:
     }
 
     void renderBlock(float* outL, float* outR, int numSamples) {
+        perfStats.beginBlock();
+
         // Clear output buffers
         for (int i = 0; i < numSamples; i++) {
             outL[i] = 0.0f;
             outR[i] = 0.0f;
         }
 
-        // Sum all active voices
-        for (int v = 0; v < MAX_VOICES; v++) {
-            if (voiceActive[v]) {
+        // Sum the sounding voices, held and releasing
+        const int activeVoices = active.size();
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+            active.update([&](int v) {
+                Voice& voice = voices[v];
                 for (int i = 0; i < numSamples; i++) {
-                    float sample = voices[v].process(params);
+                    float sample = voice.process(voiceParams);
                     outL[i] += sample;
                     outR[i] += sample;
                 }
-            }
+
+                // Its release ended: back on the free list, off this one
+                if (!voice.active()) {
+                    allocator.voiceFinished(v);
+                }
+                return voice.active();
+            });
         }
 
         // Master gain (param 127 reserved for master volume)
-        float masterGain = params[127];
-        for (int i = 0; i < numSamples; i++) {
-            outL[i] *= masterGain;
-            outR[i] *= masterGain;
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Master);
+            float masterGain = params[127];
+            for (int i = 0; i < numSamples; i++) {
+                outL[i] *= masterGain;
+                outR[i] *= masterGain;
+            }
         }
+
+        perfStats.endBlock(numSamples, activeVoices);
     }
 
+    /** CPU counters (see PerfStats.h - empty unless built with PERF_STATS=1) */
+    const PerfStats& getPerfStats() const { return perfStats; }
+
 private:
+    /** Re-derive the VoiceParams field parameter id feeds (not per sample) */
+    void updateVoiceParams(int id) {
+        switch (id) {
+            // TODO: Map parameters to voice fields, e.g.
+            // case FILTER_CUTOFF:
+            //     voiceParams.cutoffHz = 20.0f * std::pow(1000.0f, params[FILTER_CUTOFF]);
+            //     break;
+            default:
+                break;
+        }
+    }
+
     float sampleRate = 48000.0f;
     std::array<Voice, MAX_VOICES> voices;
-    std::array<bool, MAX_VOICES> voiceActive;
+    VoiceAllocator<MAX_VOICES> allocator;
+    ActiveVoiceList<MAX_VOICES> active;
     std::array<float, MAX_PARAMS> params;
+    VoiceParams voiceParams;
+    PerfStats perfStats;
+    // GranularEngine grains;  // prepare(sr) in prepare(), process(outL, outR, n) after the voices
 };
@@ -3,10 +3,27 @@
 #include <array>
 #include <cmath>
 
+#include "PitchTables.h"
+
 // TODO: Include SST/Airwindows/ChowDSP libraries as needed
 // #include "sst/basic-blocks/dsp/DPWSawOscillator.h"
 // #include "sst/filters/VintageLadder.h"
 // #include "sst/basic-blocks/modulators/ADSREnvelope.h"
+// #include "Waveguide.h"  // Plucked / bowed strings for physical specs
+
+/**
+ * Voice parameters in the units the DSP uses (Hz, linear gain,
+ * coefficients), shared by all voices. Engine::setParam works a field out
+ * when its parameter changes, so process() never maps raw 0-1 values or
+ * calls pow()/exp() per sample.
+ */
+struct VoiceParams {
+    float level = 0.3f;  // Linear gain
+
+    // TODO: Add fields for the voice's controls, e.g.
+    // float cutoffHz = 632.0f;      // 20 * pow(1000, params[FILTER_CUTOFF])
+    // float resonance = 0.3f;
+};
 
 /**
  * Single voice implementation for {{SYNTH_NAME}}
@@ -34,9 +51,12 @@ public:
         note = midiNote;
         velocity = vel;
         isActive = true;
+        releasing = false;
+        releaseGain = 1.0f;
 
-        // Convert MIDI note to frequency
-        frequency = 440.0f * std::pow(2.0f, (midiNote - 69) / 12.0f);
+        // Convert MIDI note to frequency (PitchTables.h also has
+        // semitonesToRatio() etc. for per-sample pitch modulation)
+        frequency = PitchTables::get().midiToFrequency(static_cast<float>(midiNote));
 
         // TODO: Trigger envelopes
         // filterEnv.trigger();
@@ -46,22 +66,36 @@ public:
         // osc.setFrequency(frequency);
     }
 
+    /** Start the release; the voice keeps rendering until active() goes false */
     void noteOff() {
-        isActive = false;
-        // TODO: Release envelopes
+        releasing = true;
+        // TODO: Release envelopes (and drop the placeholder fade)
         // filterEnv.release();
         // ampEnv.release();
     }
 
+    /** Silence at once (stolen, all notes off) */
+    void kill() {
+        isActive = false;
+        releasing = false;
+        // ampEnv.reset();
+    }
+
     int getNote() const {
         return note;
     }
 
+    /** True until the release has finished (ampEnv.isActive() once there's an envelope) */
     bool active() const {
         return isActive;
     }
 
-    float process(const std::array<float, 128>& params) {
+    /** Current output level, for the Quietest steal policy (ampEnv level * velocity) */
+    float getLevel() const {
+        return isActive ? velocity * releaseGain : 0.0f;
+    }
+
+    float process(const VoiceParams& params) {
         if (!isActive) {
             return 0.0f;
         }
@@ -71,18 +105,26 @@ public:
         // Example:
         // float oscSample = osc.process();
         // float envValue = filterEnv.process(sampleRate);
-        // float cutoff = params[CUTOFF_PARAM] * (1.0f + envValue);
+        // float cutoff = params.cutoffHz * (1.0f + envValue);
         // filter.setCutoff(cutoff);
         // float filtered = filter.process(oscSample);
         // float amp = ampEnv.process(sampleRate);
         // return filtered * amp * velocity;
 
-        // Placeholder: simple sine oscillator
+        // Placeholder: simple sine oscillator with a 100 ms release fade
         float sample = std::sin(phase * 2.0f * M_PI);
         phase += frequency / sampleRate;
         if (phase >= 1.0f) phase -= 1.0f;
 
-        return sample * velocity * 0.3f;
+        if (releasing) {
+            releaseGain -= 10.0f / sampleRate;
+            if (releaseGain <= 0.0f) {
+                kill();
+                return 0.0f;
+            }
+        }
+
+        return sample * velocity * releaseGain * params.level;
     }
 
 private:
@@ -91,7 +133,9 @@ private:
     float velocity = 0.0f;
     float frequency = 440.0f;
     float phase = 0.0f;
+    float releaseGain = 1.0f;
     bool isActive = false;
+    bool releasing = false;
 
     // TODO: Add SST/Airwindows/ChowDSP components
     // sst::basic_blocks::dsp::DPWSawOscillator osc;
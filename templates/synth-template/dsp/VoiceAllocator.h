@@ -0,0 +1,228 @@
+/**
+ * @file VoiceAllocator.h
+ * @brief Constant-time voice allocation: free list, release order, note map
+ *
+ * Keeps the engine's voice bookkeeping out of the voices. Every voice is on
+ * exactly one intrusive list, kept in the order voices joined it:
+ *
+ *   free      idle, ready to take a note
+ *   held      playing, key down (oldest first)
+ *   released  in their release tail (oldest release first)
+ *
+ * and, while it has a note, on that note's chain in a 128-entry note map,
+ * so noteOff() finds its voices without scanning the pool. A note on takes
+ * the first free voice; with none free it steals by the StealPolicy:
+ *
+ *   Oldest    the longest-released voice, else the longest-held
+ *   Quietest  the voice with the lowest level (the caller's envelope level)
+ *   SameNote  a voice already on this note, even with voices free (a
+ *             repeated key retriggers its voice instead of stacking);
+ *             else as Oldest
+ *
+ * Age is list order, so it's exact to the event, not counted per block.
+ * Only Quietest looks at more than a list head, and only when stealing.
+ *
+ *   auto a = allocator.noteOn(note, [&](int v) { return voices[v].getLevel(); });
+ *   if (a.stolen) voices[a.voice].kill();
+ *   voices[a.voice].noteOn(note, velocity);
+ *
+ *   allocator.noteOff(note, [&](int v) { voices[v].noteOff(); });
+ *   allocator.voiceFinished(v);      // The engine saw voice v go idle
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+template <int MAX_VOICES>
+class VoiceAllocator
+{
+public:
+    enum class StealPolicy { Oldest, Quietest, SameNote };
+
+    static constexpr int NOTES = 128;
+
+    struct Allocation
+    {
+        int voice;
+        bool stolen;  // The voice was sounding: kill it before the new note
+    };
+
+    VoiceAllocator() { reset(); }
+
+    /** Every voice free, no notes */
+    void reset()
+    {
+        for (auto& l : lists)
+            l.head = l.tail = NONE;
+        noteHead.fill(NONE);
+        for (int v = 0; v < MAX_VOICES; ++v)
+        {
+            noteOf[v] = NONE;
+            noteNext[v] = notePrev[v] = NONE;
+            state[v] = Free;
+            append(Free, v);
+        }
+    }
+
+    void setStealPolicy(StealPolicy p) { policy = p; }
+    StealPolicy getStealPolicy() const { return policy; }
+
+    /**
+     * @brief A voice for note
+     * @param levelOf int voice -> float level, read only by the Quietest policy
+     */
+    template <typename LevelOf>
+    Allocation noteOn(int note, LevelOf&& levelOf)
+    {
+        note &= NOTES - 1;
+
+        int v = NONE;
+        if (policy == StealPolicy::SameNote)
+            v = noteHead[note];
+        if (v == NONE)
+            v = lists[Free].head;
+
+        const bool stolen = v == NONE || state[v] != Free;
+        if (v == NONE)
+            v = policy == StealPolicy::Quietest ? quietest(levelOf) : oldest();
+
+        unlink(state[v], v);
+        unlinkNote(v);
+        state[v] = Held;
+        append(Held, v);
+        linkNote(note, v);
+        return {v, stolen};
+    }
+
+    /** Release note's held voices: release(int voice) for each */
+    template <typename Release>
+    void noteOff(int note, Release&& release)
+    {
+        for (int v = noteHead[note & (NOTES - 1)]; v != NONE; v = noteNext[v])
+        {
+            if (state[v] != Held)
+                continue;
+            release(v);
+            unlink(Held, v);
+            state[v] = Released;
+            append(Released, v);
+        }
+    }
+
+    /** Voice v went idle on its own (its release ended); no-op if it's already free */
+    void voiceFinished(int v)
+    {
+        if (state[v] == Free)
+            return;
+        unlink(state[v], v);
+        unlinkNote(v);
+        state[v] = Free;
+        append(Free, v);
+    }
+
+    bool isHeld(int v) const { return state[v] == Held; }
+    bool isFree(int v) const { return state[v] == Free; }
+
+    /** The voice most recently given note, or -1 */
+    int voiceForNote(int note) const { return noteHead[note & (NOTES - 1)]; }
+
+private:
+    static constexpr int NONE = -1;
+
+    enum ListId : uint8_t { Free, Held, Released, NUM_LISTS };
+
+    struct List
+    {
+        int head = NONE;
+        int tail = NONE;
+    };
+
+    int oldest() const
+    {
+        return lists[Released].head != NONE ? lists[Released].head : lists[Held].head;
+    }
+
+    template <typename LevelOf>
+    int quietest(LevelOf& levelOf) const
+    {
+        int best = NONE;
+        float bestLevel = 0.0f;
+        for (int list : {Released, Held})
+        {
+            for (int v = lists[list].head; v != NONE; v = next[v])
+            {
+                const float level = levelOf(v);
+                if (best == NONE || level < bestLevel)
+                {
+                    best = v;
+                    bestLevel = level;
+                }
+            }
+        }
+        return best;
+    }
+
+    void append(int list, int v)
+    {
+        auto& l = lists[list];
+        prev[v] = l.tail;
+        next[v] = NONE;
+        if (l.tail != NONE)
+            next[l.tail] = v;
+        else
+            l.head = v;
+        l.tail = v;
+    }
+
+    void unlink(int list, int v)
+    {
+        auto& l = lists[list];
+        if (prev[v] != NONE)
+            next[prev[v]] = next[v];
+        else
+            l.head = next[v];
+        if (next[v] != NONE)
+            prev[next[v]] = prev[v];
+        else
+            l.tail = prev[v];
+    }
+
+    /** Newest voice first on its note's chain */
+    void linkNote(int note, int v)
+    {
+        noteOf[v] = note;
+        notePrev[v] = NONE;
+        noteNext[v] = noteHead[note];
+        if (noteHead[note] != NONE)
+            notePrev[noteHead[note]] = v;
+        noteHead[note] = v;
+    }
+
+    void unlinkNote(int v)
+    {
+        const int note = noteOf[v];
+        if (note == NONE)
+            return;
+        if (notePrev[v] != NONE)
+            noteNext[notePrev[v]] = noteNext[v];
+        else
+            noteHead[note] = noteNext[v];
+        if (noteNext[v] != NONE)
+            notePrev[noteNext[v]] = notePrev[v];
+        noteOf[v] = noteNext[v] = notePrev[v] = NONE;
+    }
+
+    StealPolicy policy = StealPolicy::Oldest;
+
+    std::array<List, NUM_LISTS> lists{};
+    std::array<int, MAX_VOICES> next{};
+    std::array<int, MAX_VOICES> prev{};
+    std::array<uint8_t, MAX_VOICES> state{};
+
+    std::array<int, NOTES> noteHead{};
+    std::array<int, MAX_VOICES> noteOf{};
+    std::array<int, MAX_VOICES> noteNext{};
+    std::array<int, MAX_VOICES> notePrev{};
+};
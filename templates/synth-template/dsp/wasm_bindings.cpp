@@ -105,6 +105,17 @@ extern "C" {
         g_engine->noteOff(note);
     }
 
+    /**
+     * Choose which voice a note steals when all are busy
+     *
+     * @param policy 0 Oldest, 1 Quietest, 2 Same Note (retrigger a repeated key)
+     */
+    EMSCRIPTEN_KEEPALIVE
+    void setVoiceSteal(int policy) {
+        if (!g_engine) return;
+        g_engine->setVoiceSteal(policy);
+    }
+
     /**
      * Handle MIDI CC message
      * Optional: implement if you need MIDI CC parameter control
@@ -115,6 +126,10 @@ extern "C" {
     EMSCRIPTEN_KEEPALIVE
     void midiCC(int cc, int value) {
         if (!g_engine) return;
+        if (cc == 123) {  // All Notes Off
+            g_engine->allNotesOff();
+            return;
+        }
         // Map MIDI CC to parameters
         // Example: g_engine->setParam(cc, value / 127.0f);
     }
@@ -131,6 +146,26 @@ extern "C" {
         // Implement pitch bend handling
     }
 
+    /**
+     * Get the engine's CPU counters
+     * Everything reads 0 (including "enabled") unless built with
+     * make PERF_STATS=1
+     *
+     * @return Pointer to getPerfStatsSize() doubles in PerfStats::Snapshot::toFlat()
+     *         order, valid until the next call
+     */
+    EMSCRIPTEN_KEEPALIVE
+    const double* getPerfStats() {
+        static double flat[PerfStats::Snapshot::FLAT_SIZE] = {};
+        if (g_engine) g_engine->getPerfStats().getSnapshot().toFlat(flat);
+        return flat;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getPerfStatsSize() {
+        return PerfStats::Snapshot::FLAT_SIZE;
+    }
+
     /**
      * Clean up and release resources
      * Called when AudioWorklet is destroyed
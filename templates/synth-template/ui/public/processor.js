@@ -37,7 +37,7 @@ class SynthProcessor extends AudioWorkletProcessor {
   async handleMessage(msg) {
     switch (msg.type) {
       case 'init':
-        await this.initWasm(msg.wasmModule, msg.sampleRate);
+        await this.initWasm(msg.wasmBytes, msg.wasmSimdBytes, msg.sampleRate);
         break;
 
       case 'setParameter':
@@ -61,11 +61,31 @@ class SynthProcessor extends AudioWorkletProcessor {
       case 'midi':
         this.handleMidi(msg.status, msg.data1, msg.data2);
         break;
+
+      case 'getPerfStats':
+        if (this.isInitialized) {
+          this.port.postMessage({ type: 'perfStats', ...this.readPerfStats() });
+        }
+        break;
     }
   }
 
-  async initWasm(wasmModule, sampleRate) {
+  /**
+   * Pick the SIMD128 binary if this browser can validate it, else the
+   * scalar fallback. Both are built from the same source (see Makefile).
+   */
+  static selectWasmBinary(wasmBytes, wasmSimdBytes) {
+    if (wasmSimdBytes && WebAssembly.validate(wasmSimdBytes)) {
+      return { bytes: wasmSimdBytes, simd: true };
+    }
+    return { bytes: wasmBytes, simd: false };
+  }
+
+  async initWasm(wasmBytes, wasmSimdBytes, sampleRate) {
     try {
+      const { bytes, simd } = SynthProcessor.selectWasmBinary(wasmBytes, wasmSimdBytes);
+      const wasmModule = await WebAssembly.compile(bytes);
+
       // Instantiate WASM module
       const instance = await WebAssembly.instantiate(wasmModule, {
         env: {
@@ -83,6 +103,9 @@ class SynthProcessor extends AudioWorkletProcessor {
       this.wasmNoteOff = exports.noteOff;
       this.wasmMidiCC = exports.midiCC;
       this.wasmPitchBend = exports.pitchBend;
+      this.wasmGetPerfStats = exports.getPerfStats;
+      this.wasmGetPerfStatsSize = exports.getPerfStatsSize;
+      this.wasmMemory = exports.memory;
 
       // Allocate audio buffers in WASM memory
       const malloc = exports.malloc;
@@ -99,12 +122,40 @@ class SynthProcessor extends AudioWorkletProcessor {
       this.isInitialized = true;
 
       // Notify main thread
-      this.port.postMessage({ type: 'ready' });
+      this.port.postMessage({ type: 'ready', simd });
     } catch (error) {
       this.port.postMessage({ type: 'error', error: error.message });
     }
   }
 
+  /**
+   * Decode the getPerfStats export (dsp/PerfStats.h, Snapshot::toFlat()
+   * order) into the same shape as the JUCE plugins' getPerfStats. Only
+   * filled in when built with make wasm PERF_STATS=1.
+   */
+  readPerfStats() {
+    const stats = { enabled: false, blocks: 0, blocksOverBudget: 0, lastBlockUs: 0,
+                    worstBlockUs: 0, averageLoad: 0, stageShare: {}, voiceHistogram: [] };
+    if (!this.wasmGetPerfStats || !this.wasmMemory) return stats;
+
+    const flat = new Float64Array(this.wasmMemory.buffer, this.wasmGetPerfStats(), this.wasmGetPerfStatsSize());
+    if (flat[0] === 0) return stats;
+
+    const stageNames = ['voices', 'filter', 'effects', 'master'];
+    stageNames.forEach((name, s) => {
+      stats.stageShare[name] = flat[6] > 0 ? flat[7 + s] / flat[6] : 0;
+    });
+
+    stats.enabled = true;
+    stats.blocks = flat[1];
+    stats.blocksOverBudget = flat[2];
+    stats.lastBlockUs = flat[3];
+    stats.worstBlockUs = flat[4];
+    stats.averageLoad = flat[5];
+    stats.voiceHistogram = Array.from(flat.subarray(7 + stageNames.length));
+    return stats;
+  }
+
   handleMidi(status, data1, data2) {
     if (!this.isInitialized) return;
 
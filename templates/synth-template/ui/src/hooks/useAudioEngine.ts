@@ -57,12 +57,17 @@ export const useAudioEngine = (): AudioEngineAPI => {
         await ctx.resume();
       }
 
-      // 2. Load WASM module
-      const wasmResponse = await fetch('/synth.wasm');
+      // 2. Load WASM binaries (scalar + optional SIMD128 build).
+      // The worklet validates the SIMD binary and picks one.
+      const [wasmResponse, simdResponse] = await Promise.all([
+        fetch('/synth.wasm'),
+        fetch('/synth.simd.wasm').catch(() => null),
+      ]);
       if (!wasmResponse.ok) {
         throw new Error(`Failed to load WASM: ${wasmResponse.statusText}`);
       }
-      const wasmModule = await WebAssembly.compileStreaming(wasmResponse);
+      const wasmBytes = await wasmResponse.arrayBuffer();
+      const wasmSimdBytes = simdResponse?.ok ? await simdResponse.arrayBuffer() : null;
 
       // 3. Register AudioWorklet
       try {
@@ -83,11 +88,13 @@ export const useAudioEngine = (): AudioEngineAPI => {
       worklet.connect(ctx.destination);
 
       // 5. Initialize WASM in worklet
+      const transfer = wasmSimdBytes ? [wasmBytes, wasmSimdBytes] : [wasmBytes];
       worklet.port.postMessage({
         type: 'init',
-        wasmModule,
+        wasmBytes,
+        wasmSimdBytes,
         sampleRate: ctx.sampleRate,
-      });
+      }, transfer);
 
       // Wait for ready signal
       await new Promise<void>((resolve, reject) => {
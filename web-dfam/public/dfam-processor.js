@@ -3,18 +3,81 @@
  * Runs the WASM DSP in the audio thread
  */
 
+import { EventRingReader, RECORD_BYTES } from './event-ring.js';
+import { MeterTapWriter } from './meter-tap.js';
+import { perfNow, readPerfStats } from './perf-stats.js';
+
+/** Web Audio render quantum in frames */
+const QUANTUM_FRAMES = 128;
+
+/** Most ring events applied per render (the rest wait for the next one) */
+const EVENT_BATCH_CAPACITY = 256;
+
+/** Words per ParamInfo row (src/dsp/dfam_params.h) */
+const PARAM_INFO_WORDS = 8;
+
+/**
+ * Import keys of the current build, used only if the main thread couldn't
+ * read the glue. Exports have no fallback - their letters move with every
+ * change to the export list.
+ */
+const DEFAULT_IMPORT_NAMES = {
+  a: '_abort',
+  b: '___cxa_throw',
+  c: '_getentropy',
+  d: '_emscripten_memcpy_js',
+};
+
 class DFAMProcessor extends AudioWorkletProcessor {
   constructor() {
     super();
     this.wasmReady = false;
     this.wasmExports = null;
+    this.wasm = null;  // C export name -> function, resolved from the glue's name map
     this.memory = null;
     this.outputPtrL = 0;
     this.outputPtrR = 0;
     this.heapF32 = null;
+    this.heapBuffer = null;
+
+    // Render-ahead ring: the engine renders renderQuanta quanta per call
+    // into planar L/R buffers in the WASM heap, and process() copies one
+    // quantum out of a cached view per callback. The sequencer runs inside
+    // the engine, so a deeper ring only delays knob changes (4 quanta is
+    // ~12 ms at 44.1 kHz).
+    this.renderQuanta = 4;
+    this.ringFrames = 0;
+    this.readFrame = 0;
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+
+    // SharedArrayBuffer event ring from the UI; null falls back to 'param'
+    // messages through the port
+    this.eventRing = null;
+    this.eventBatchPtr = 0;
+    this.applyParams = null;
+    this.heapI32 = null;
+
+    // Flat parameter block in the WASM heap plus the table describing it
+    // (name -> { id, offset, slots, min, max, defaultValue, smoothing })
+    this.paramBlockPtr = 0;
+    this.paramTable = {};
+    this.paramIdsPtr = 0;
+    this.paramValuesPtr = 0;
+    this.paramSlotCount = 0;
+
+    // SharedArrayBuffer the UI reads meters and the step from; null falls
+    // back to posting 'step' messages
+    this.meterTap = null;
+    this.metersPtr = 0;
+
     this.currentStep = 0;
     this.frameCount = 0;
 
+    // The module reported silence (sequencer stopped, tails done): render
+    // zeros without calling it until the next parameter change
+    this.idle = false;
+
     this.port.onmessage = (event) => {
       this.handleMessage(event.data);
     };
@@ -22,89 +85,191 @@ class DFAMProcessor extends AudioWorkletProcessor {
 
   handleMessage(data) {
     if (data.type === 'init') {
-      this.initWasm(data.wasmBytes, data.sampleRate);
+      if (data.renderQuanta > 0) {
+        this.renderQuanta = Math.floor(data.renderQuanta);
+      }
+      this.initWasm(data, data.sampleRate, data.eventRing, data.wasmNames);
     } else if (data.type === 'param' && this.wasmReady) {
       this.setParam(data.name, data.value);
+    } else if (data.type === 'preset' && this.wasmReady) {
+      this.setPreset(data.values);
+    } else if (data.type === 'getPerfStats' && this.wasmReady) {
+      const stats = readPerfStats(this.memory, this.wasm.getPerfStats, this.wasm.getPerfStatsSize);
+      this.port.postMessage({ type: 'perfStats', ...stats });
+    }
+  }
+
+  /**
+   * The module the main thread compiled (src/audio/wasmModule.ts), or
+   * compile raw bytes here: the SIMD128 build if this browser validates
+   * it, otherwise the scalar fallback
+   */
+  static async compileWasm(source) {
+    if (source.wasmModule) {
+      return { wasmModule: source.wasmModule, simd: !!source.simd };
+    }
+    if (source.wasmSimdBytes && WebAssembly.validate(source.wasmSimdBytes)) {
+      return { wasmModule: await WebAssembly.compile(source.wasmSimdBytes), simd: true };
     }
+    return { wasmModule: await WebAssembly.compile(source.wasmBytes), simd: false };
   }
 
-  async initWasm(wasmBytes, sr) {
+  async initWasm(source, sr, eventRing, wasmNames) {
     try {
+      if (!wasmNames || !wasmNames.exports) {
+        throw new Error('No WASM export name map (is dfam.js being served?)');
+      }
+
+      this.ringFrames = QUANTUM_FRAMES * this.renderQuanta;
+      this.readFrame = this.ringFrames;  // Render on the first callback
+
+      const { wasmModule, simd } = await DFAMProcessor.compileWasm(source);
+      console.log('[Worklet] Using', simd ? 'SIMD128' : 'scalar', 'WASM build');
+
       // Create a reference for use in imports (before we have exports)
       const self = this;
 
-      // Create the imports that the WASM module needs
-      // The import module name is "a" with keys a, b, c, d, e
-      const imports = {
-        a: {
-          a: () => { // _abort
-            console.error('[Worklet] WASM abort called');
-            throw new Error('abort');
-          },
-          b: (ptr, type, destructor) => { // ___cxa_throw
-            console.error('[Worklet] C++ exception thrown');
-            throw new Error('C++ exception');
-          },
-          c: (buffer, size) => { // _getentropy
-            if (!self.memory) return -1;
-            const view = new Uint8Array(self.memory.buffer, buffer, size);
-            for (let i = 0; i < size; i++) {
-              view[i] = Math.floor(Math.random() * 256);
-            }
-            return 0;
-          },
-          d: (dest, src, num) => { // _emscripten_memcpy_js
-            if (!self.memory) return;
-            const heap = new Uint8Array(self.memory.buffer);
-            heap.copyWithin(dest, src, src + num);
-          },
-          e: (requestedSize) => { // _emscripten_resize_heap
-            // Don't support growing in worklet
-            return 0;
-          },
-        }
+      // Runtime functions the WASM module imports, by their glue names
+      const runtime = {
+        _abort: () => {
+          console.error('[Worklet] WASM abort called');
+          throw new Error('abort');
+        },
+        // Release builds have no exceptions (see RELEASE_FLAGS); older ones import this
+        ___cxa_throw: (ptr, type, destructor) => {
+          console.error('[Worklet] C++ exception thrown');
+          throw new Error('C++ exception');
+        },
+        _getentropy: (buffer, size) => {
+          if (!self.memory) return -1;
+          const view = new Uint8Array(self.memory.buffer, buffer, size);
+          for (let i = 0; i < size; i++) {
+            view[i] = Math.floor(Math.random() * 256);
+          }
+          return 0;
+        },
+        _emscripten_memcpy_js: (dest, src, num) => {
+          if (!self.memory) return;
+          const heap = new Uint8Array(self.memory.buffer);
+          heap.copyWithin(dest, src, src + num);
+        },
+        // dfam.wasm is built without memory growth (everything init needs is
+        // static, see the Makefile); refuse if an older build asks
+        _emscripten_resize_heap: (requestedSize) => {
+          return 0;
+        },
+        // Only imported by PERF_STATS=1 builds (PerfStats' wall clock)
+        _emscripten_get_now: perfNow,
       };
 
-      console.log('[Worklet] Compiling WASM...');
-      // Compile and instantiate the WASM module
-      const wasmModule = await WebAssembly.compile(wasmBytes);
+      // The import module name is "a"; its keys are minified too
+      const importNames = Object.keys(wasmNames.imports || {}).length > 0
+        ? wasmNames.imports : DEFAULT_IMPORT_NAMES;
+      const moduleImports = {};
+      for (const [key, name] of Object.entries(importNames)) {
+        if (!runtime[name]) throw new Error('Unsupported WASM import ' + name);
+        moduleImports[key] = runtime[name];
+      }
+      const imports = { a: moduleImports };
+
+      console.log('[Worklet] Instantiating WASM...');
       const instance = await WebAssembly.instantiate(wasmModule, imports);
 
       this.wasmExports = instance.exports;
 
-      // Memory is exported at 'f'
-      this.memory = this.wasmExports.f;
-      if (!this.memory) {
-        throw new Error('No memory export found');
+      // Resolve the exports we use by their C names
+      const wasm = {};
+      for (const name of ['memory', 'init', 'process', 'getCurrentStep', 'malloc',
+                          'setParams', 'applyParams', 'getParamBlockPtr',
+                          'getParamSlotCount', 'getParamTablePtr', 'getParamCount']) {
+        const key = wasmNames.exports[name];
+        if (!key || !this.wasmExports[key]) {
+          throw new Error('Missing WASM export ' + name);
+        }
+        wasm[name] = this.wasmExports[key];
       }
+      // Optional: older builds don't export the CPU counters, meters or silence
+      for (const name of ['getPerfStats', 'getPerfStatsSize', 'getMeters', 'getMetersSize', 'isSilent']) {
+        const key = wasmNames.exports[name];
+        wasm[name] = key ? this.wasmExports[key] || null : null;
+      }
+      this.wasm = wasm;
+
+      this.memory = wasm.memory;
       console.log('[Worklet] Memory acquired, buffer size:', this.memory.buffer.byteLength);
 
-      // Call __wasm_call_ctors if it exists (export 'g')
-      if (this.wasmExports.g) {
+      const ctors = this.wasmExports[wasmNames.exports.__wasm_call_ctors];
+      if (ctors) {
         console.log('[Worklet] Calling __wasm_call_ctors...');
-        this.wasmExports.g();
+        ctors();
       }
 
       // Update heap view
       this.updateHeapViews();
 
-      // Initialize the synth engine (_init is export 'h')
+      // Initialize the synth engine (also loads the table defaults)
       console.log('[Worklet] Initializing synth at', sr, 'Hz...');
-      this.wasmExports.h(sr);
+      if (!wasm.init(sr, this.ringFrames)) {
+        throw new Error('Sample rate ' + sr + ' Hz is above what dfam.wasm was built for');
+      }
 
-      // Allocate output buffers (128 samples * 4 bytes per float)
-      // _malloc is export 'V'
-      const bufferSize = 128 * 4;
-      this.outputPtrL = this.wasmExports.V(bufferSize);
-      this.outputPtrR = this.wasmExports.V(bufferSize);
+      // Allocate the planar output ring (ringFrames floats per channel)
+      const bufferSize = this.ringFrames * 4;
+      this.outputPtrL = wasm.malloc(bufferSize);
+      this.outputPtrR = wasm.malloc(bufferSize);
       console.log('[Worklet] Output buffers allocated at:', this.outputPtrL, this.outputPtrR);
 
       if (this.outputPtrL === 0 || this.outputPtrR === 0) {
         throw new Error('Failed to allocate output buffers');
       }
 
+      // Parameter block and scratch arrays for whole-preset setParams()
+      this.paramBlockPtr = wasm.getParamBlockPtr();
+      this.paramSlotCount = wasm.getParamSlotCount();
+      this.paramIdsPtr = wasm.malloc(this.paramSlotCount * 4);
+      this.paramValuesPtr = wasm.malloc(this.paramSlotCount * 4);
+      if (this.paramIdsPtr === 0 || this.paramValuesPtr === 0) {
+        throw new Error('Failed to allocate parameter scratch');
+      }
+
+      this.updateHeapViews();
+      this.paramTable = this.readParamTable();
+
+      if (eventRing) {
+        this.eventBatchPtr = wasm.malloc(EVENT_BATCH_CAPACITY * RECORD_BYTES);
+        if (this.eventBatchPtr !== 0) {
+          this.eventRing = new EventRingReader(eventRing);
+          this.applyParams = wasm.applyParams;
+        }
+      }
+      console.log('[Worklet] Parameter path:', this.eventRing ? 'event ring' : 'port messages');
+
+      if (source.meters && wasm.getMeters && wasm.getMetersSize) {
+        try {
+          this.meterTap = new MeterTapWriter(source.meters, wasm.getMetersSize());
+          this.metersPtr = wasm.getMeters();
+        } catch (err) {
+          console.warn('[Worklet] Meter tap disabled:', err.message);
+          this.meterTap = null;
+        }
+      }
+
+      this.updateHeapViews();
+
+      // The UI builds its ring writer's name -> ID map from this
+      const paramIds = {};
+      for (const [name, info] of Object.entries(this.paramTable)) {
+        paramIds[name] = info.id;
+      }
+
       this.wasmReady = true;
-      this.port.postMessage({ type: 'ready' });
+      this.port.postMessage({
+        type: 'ready',
+        eventRing: this.eventRing !== null,
+        meters: this.meterTap !== null,
+        paramIds,
+        params: this.paramTable,
+      });
       console.log('[Worklet] WASM initialized successfully!');
     } catch (error) {
       console.error('[Worklet] WASM init failed:', error);
@@ -112,83 +277,181 @@ class DFAMProcessor extends AudioWorkletProcessor {
     }
   }
 
+  /** Read the ParamInfo rows (dfam_params.h) out of the heap */
+  readParamTable() {
+    const table = {};
+    const count = this.wasm.getParamCount();
+    const base = this.wasm.getParamTablePtr() >> 2;
+    const bytes = new Uint8Array(this.heapBuffer);
+
+    for (let i = 0; i < count; i++) {
+      const row = base + i * PARAM_INFO_WORDS;
+
+      // Names are ASCII C strings (no TextDecoder in the worklet scope)
+      let name = '';
+      for (let p = this.heapI32[row]; bytes[p] !== 0; p++) {
+        name += String.fromCharCode(bytes[p]);
+      }
+
+      table[name] = {
+        minValue: this.heapF32[row + 1],
+        maxValue: this.heapF32[row + 2],
+        defaultValue: this.heapF32[row + 3],
+        smoothing: this.heapI32[row + 4],
+        slots: this.heapI32[row + 5],
+        offset: this.heapI32[row + 6],
+        id: this.heapI32[row + 7],
+      };
+    }
+    return table;
+  }
+
+  /**
+   * Parameter block slot for a UI name ('tempo', 'seqPitch_3'), or -1
+   */
+  paramSlot(name) {
+    let info = this.paramTable[name];
+    let index = 0;
+    if (!info) {
+      const split = name.lastIndexOf('_');
+      if (split < 0) return -1;
+      info = this.paramTable[name.slice(0, split)];
+      index = parseInt(name.slice(split + 1), 10);
+      if (!info || !(index >= 0 && index < info.slots)) return -1;
+    }
+    return info.offset + index;
+  }
+
+  /**
+   * Rebuild the heap views. Only needed at init and after the WASM memory
+   * grows (growth detaches the old ArrayBuffer), so process() never
+   * allocates views on the steady-state path.
+   */
   updateHeapViews() {
-    if (this.memory) {
-      this.heapF32 = new Float32Array(this.memory.buffer);
+    if (!this.memory) return;
+
+    this.heapBuffer = this.memory.buffer;
+    this.heapF32 = new Float32Array(this.heapBuffer);
+    this.heapI32 = new Int32Array(this.heapBuffer);
+
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+    if (this.outputPtrL === 0 || this.outputPtrR === 0) return;
+
+    const offsetL = this.outputPtrL >> 2; // Divide by 4 to get float index
+    const offsetR = this.outputPtrR >> 2;
+    for (let q = 0; q < this.renderQuanta; q++) {
+      const start = q * QUANTUM_FRAMES;
+      this.ringViewsL.push(this.heapF32.subarray(offsetL + start, offsetL + start + QUANTUM_FRAMES));
+      this.ringViewsR.push(this.heapF32.subarray(offsetR + start, offsetR + start + QUANTUM_FRAMES));
     }
   }
 
+  /**
+   * Write one parameter straight into the engine's parameter block; the
+   * engine picks the change up at the start of the next render.
+   */
   setParam(name, value) {
-    if (!this.wasmExports) return;
-
-    // Map parameter names to WASM exports
-    // Based on the compiled WASM export names:
-    // h=init, i=process, j=setRunning, k=isRunning, l=setTempo, m=setClockDivider
-    // n=setStepPitch, o=setStepVelocity, p=getCurrentStep
-    // q=setVCO1Frequency, r=setVCO2Frequency, s=setVCO1Level, t=setVCO2Level
-    // u=setVCO1Waveform, v=setVCO2Waveform, w=setFMAmount, x=setNoiseLevel
-    // y=setFilterCutoff, z=setFilterResonance, A=setFilterEnvAmount, B=setFilterMode
-    // C=setFilterLfoRate, D=setFilterLfoClockSync, E=setFilterLfoAmount
-    // F=setPitchEnvAttack, G=setPitchEnvDecay, H=setPitchEnvAmount
-    // I=setVCFVCAEnvAttack, J=setVCFVCAEnvDecay
-    // K=setSaturatorDrive, L=setSaturatorMix
-    // M=setDelayTime, N=setDelayClockSync, O=setDelayFeedback, P=setDelayMix
-    // Q=setReverbDecay, R=setReverbDamping, S=setReverbMix
-    // T=setMasterVolume
-
-    const e = this.wasmExports;
-    try {
-      switch (name) {
-        case 'running': e.j(value > 0.5 ? 1 : 0); break;
-        case 'tempo': e.l(value); break;
-        case 'clockDivider': e.m(value); break;
-        case 'vco1Freq': e.q(value); break;
-        case 'vco1Wave': e.u(Math.round(value)); break;
-        case 'vco1Level': e.s(value); break;
-        case 'vco2Freq': e.r(value); break;
-        case 'vco2Wave': e.v(Math.round(value)); break;
-        case 'vco2Level': e.t(value); break;
-        case 'fmAmount': e.w(value); break;
-        case 'noiseLevel': e.x(value); break;
-        case 'filterCutoff': e.y(value); break;
-        case 'filterReso': e.z(value); break;
-        case 'filterEnvAmount': e.A(value); break;
-        case 'filterMode': e.B(Math.round(value)); break;
-        case 'filterLfoRate': e.C(value); break;
-        case 'filterLfoClockSync': e.D(value); break;
-        case 'filterLfoAmount': e.E(value); break;
-        case 'pitchEnvAttack': e.F(value); break;
-        case 'pitchEnvDecay': e.G(value); break;
-        case 'pitchEnvAmount': e.H(value); break;
-        case 'vcfVcaAttack': e.I(value); break;
-        case 'vcfVcaDecay': e.J(value); break;
-        case 'satDrive': e.K(value); break;
-        case 'satMix': e.L(value); break;
-        case 'delayTime': e.M(value); break;
-        case 'delayClockSync': e.N(value); break;
-        case 'delayFeedback': e.O(value); break;
-        case 'delayMix': e.P(value); break;
-        case 'reverbDecay': e.Q(value); break;
-        case 'reverbDamping': e.R(value); break;
-        case 'reverbMix': e.S(value); break;
-        case 'masterVolume': e.T(value); break;
-        default:
-          if (name.startsWith('seqPitch_')) {
-            const step = parseInt(name.split('_')[1]);
-            e.n(step, value);
-          } else if (name.startsWith('seqVel_')) {
-            const step = parseInt(name.split('_')[1]);
-            e.o(step, value);
-          }
-          break;
+    const slot = this.paramSlot(name);
+    if (slot < 0) return;
+
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.updateHeapViews();
+    }
+    this.heapF32[(this.paramBlockPtr >> 2) + slot] = Number(value);
+    this.idle = false;
+  }
+
+  /**
+   * Apply a whole set of parameters ({ name: value }) with one setParams()
+   * call instead of a message per parameter.
+   */
+  setPreset(values) {
+    if (!values) return;
+
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.updateHeapViews();
+    }
+
+    const ids = this.paramIdsPtr >> 2;
+    const vals = this.paramValuesPtr >> 2;
+    let n = 0;
+    for (const [name, value] of Object.entries(values)) {
+      const slot = this.paramSlot(name);
+      if (slot < 0 || n >= this.paramSlotCount) continue;
+      this.heapI32[ids + n] = slot;
+      this.heapF32[vals + n] = Number(value);
+      n++;
+    }
+
+    if (n > 0) {
+      this.wasm.setParams(this.paramValuesPtr, this.paramIdsPtr, n);
+      this.idle = false;
+    }
+  }
+
+  /**
+   * Apply events from the ring that fall inside the next block, then
+   * render it. Events are stamped in context frames; the block starts at
+   * this quantum's currentFrame. While idle with nothing new the block is
+   * zeros and the module isn't called; the meters keep their last
+   * (silent) reading.
+   */
+  renderRing(frames) {
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.updateHeapViews();
+    }
+    if (this.eventRing) {
+      const count = this.eventRing.drainInto(
+        this.heapI32, this.heapF32, this.eventBatchPtr,
+        EVENT_BATCH_CAPACITY, currentFrame | 0, frames);
+      if (count > 0) {
+        this.applyParams(this.eventBatchPtr, count);
+        this.idle = false;
       }
-    } catch (err) {
-      console.error('[Worklet] setParam error:', name, value, err);
+    }
+
+    if (this.idle) {
+      this.heapF32.fill(0, this.outputPtrL >> 2, (this.outputPtrL >> 2) + frames);
+      this.heapF32.fill(0, this.outputPtrR >> 2, (this.outputPtrR >> 2) + frames);
+      return;
+    }
+
+    this.wasm.process(this.outputPtrL, this.outputPtrR, frames);
+    this.idle = this.wasm.isSilent !== null && this.wasm.isSilent() !== 0;
+
+    if (this.meterTap) {
+      if (this.memory.buffer !== this.heapBuffer) {
+        this.updateHeapViews();
+      }
+      this.meterTap.publish(this.heapI32, this.metersPtr);
     }
   }
 
+  /**
+   * Other quantum sizes: render straight through, no ring, in chunks of
+   * at most ringFrames (the output buffer). The WASM process() takes any
+   * count (src/dsp/FixedBlockRenderer.h).
+   */
+  renderDirect(outputL, outputR, numSamples) {
+    for (let done = 0; done < numSamples;) {
+      const count = Math.min(numSamples - done, this.ringFrames);
+      this.renderRing(count);
+      if (this.memory.buffer !== this.heapBuffer) {
+        this.updateHeapViews();
+      }
+      const offsetL = this.outputPtrL >> 2;
+      const offsetR = this.outputPtrR >> 2;
+      outputL.set(this.heapF32.subarray(offsetL, offsetL + count), done);
+      outputR.set(this.heapF32.subarray(offsetR, offsetR + count), done);
+      done += count;
+    }
+    // Anything left in the ring is stale now
+    this.readFrame = this.ringFrames;
+  }
+
   process(inputs, outputs, parameters) {
-    if (!this.wasmReady || !this.wasmExports || !this.heapF32) {
+    if (!this.wasmReady || !this.wasm || !this.heapF32) {
       return true;
     }
 
@@ -200,28 +463,31 @@ class DFAMProcessor extends AudioWorkletProcessor {
     const numSamples = outputL.length;
 
     try {
-      // Update heap view in case memory grew
-      if (this.memory.buffer.byteLength !== this.heapF32.buffer.byteLength) {
-        this.updateHeapViews();
-      }
-
-      // Call WASM process function: _process (export 'i')
-      this.wasmExports.i(this.outputPtrL, this.outputPtrR, numSamples);
+      if (numSamples === QUANTUM_FRAMES) {
+        // Render the next batch of quanta once the ring has been played out
+        if (this.readFrame >= this.ringFrames) {
+          this.renderRing(this.ringFrames);
+          this.readFrame = 0;
+        }
 
-      // Copy from WASM heap to output buffers
-      const offsetL = this.outputPtrL >> 2; // Divide by 4 to get float index
-      const offsetR = this.outputPtrR >> 2;
+        // Views are only rebuilt if the memory grew
+        if (this.memory.buffer !== this.heapBuffer) {
+          this.updateHeapViews();
+        }
 
-      for (let i = 0; i < numSamples; i++) {
-        outputL[i] = this.heapF32[offsetL + i];
-        outputR[i] = this.heapF32[offsetR + i];
+        const quantum = this.readFrame / QUANTUM_FRAMES;
+        outputL.set(this.ringViewsL[quantum]);
+        outputR.set(this.ringViewsR[quantum]);
+        this.readFrame += QUANTUM_FRAMES;
+      } else {
+        this.renderDirect(outputL, outputR, numSamples);
       }
 
-      // Periodically report current step
+      // Without the meter tap, periodically report the current step
       this.frameCount += numSamples;
-      if (this.frameCount >= 4410) { // ~10 times per second at 44.1kHz
+      if (!this.meterTap && this.frameCount >= 4410) { // ~10 times per second at 44.1kHz
         this.frameCount = 0;
-        const newStep = this.wasmExports.p(); // _getCurrentStep
+        const newStep = this.wasm.getCurrentStep();
         if (newStep !== this.currentStep) {
           this.currentStep = newStep;
           this.port.postMessage({ type: 'step', step: newStep });
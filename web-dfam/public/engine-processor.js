@@ -0,0 +1,348 @@
+/**
+ * Engine AudioWorklet Processor
+ *
+ * Runs any plugins/synths engine built by the render tree's autosynth-wasm
+ * target (render/wasm_bindings.cpp): every module has the same exports, so
+ * this one processor serves the whole catalog. The main thread compiles
+ * the module (src/audio/engineNode.ts) and sends it with the glue's name
+ * map, as for dfam-processor.js.
+ *
+ * Parameters are plain values written straight into the module's
+ * parameter block; notes and timed parameter changes go through
+ * queueEvents(), from the SharedArrayBuffer event ring when the page is
+ * cross-origin isolated, else from port messages.
+ *
+ * Parameter automation (render/Automation.h) goes into the module whole
+ * and plays from there; a recording is made in the module and sent back
+ * as the same bytes, for a later bounce to load.
+ *
+ * While the module reports isSilent() (nothing sounding, no sequencer
+ * running) and nothing new arrives, the worklet outputs zeros without
+ * calling into it; the next event, parameter write or connected input
+ * wakes it.
+ */
+
+import { EventRingReader, RECORD_BYTES, RECORD_WORDS } from './event-ring.js';
+
+/** Events handed to the module per render (the rest wait a quantum) */
+const EVENT_BATCH_CAPACITY = 256;
+
+/** Words per ParamInfo row (render/EngineHost.h) */
+const PARAM_INFO_WORDS = 8;
+
+/** Event types (render/EngineHost.h) */
+const EVENT_NOTE_ON = 1;
+const EVENT_NOTE_OFF = 2;
+const EVENT_PITCH_BEND = 3;
+const EVENT_ALL_NOTES_OFF = 4;
+
+/** Largest block the worklet asks for: one render quantum, or a larger one */
+const MAX_BLOCK_FRAMES = 1024;
+
+class EngineProcessor extends AudioWorkletProcessor {
+  constructor() {
+    super();
+    this.wasmReady = false;
+    this.wasm = null;  // C export name -> function, resolved from the glue's name map
+    this.memory = null;
+    this.heapBuffer = null;
+    this.heapF32 = null;
+    this.heapI32 = null;
+    this.outputPtrL = 0;
+    this.outputPtrR = 0;
+    this.eventBatchPtr = 0;
+    this.automationPtr = 0;  // Scratch for loadAutomation(), kept at the largest size loaded
+    this.automationCapacity = 0;
+    this.engine = 0;  // Handle from createEngine()
+    this.idle = false;  // Module reported silence; render zeros until something arrives
+
+    this.eventRing = null;
+    this.paramBlockPtr = 0;
+    this.paramTable = {};
+
+    // Events from port messages, sent with the next render
+    this.portEvents = [];
+
+    this.port.onmessage = (event) => {
+      this.handleMessage(event.data);
+    };
+  }
+
+  handleMessage(data) {
+    if (data.type === 'init') {
+      this.initWasm(data);
+    } else if (!this.wasmReady) {
+      return;
+    } else if (data.type === 'param') {
+      const info = this.paramTable[data.name];
+      if (this.memory.buffer !== this.heapBuffer) this.updateHeapViews();
+      if (info) this.heapF32[(this.paramBlockPtr >> 2) + info.id] = Number(data.value);
+      this.idle = false;
+    } else if (data.type === 'noteOn') {
+      this.portEvents.push([EVENT_NOTE_ON, data.note, data.velocity ?? 1]);
+    } else if (data.type === 'noteOff') {
+      this.portEvents.push([EVENT_NOTE_OFF, data.note, 0]);
+    } else if (data.type === 'pitchBend') {
+      this.portEvents.push([EVENT_PITCH_BEND, 0, data.value]);
+    } else if (data.type === 'allNotesOff') {
+      this.portEvents.push([EVENT_ALL_NOTES_OFF, 0, 0]);
+    } else if (data.type === 'loadAutomation') {
+      this.loadAutomation(new Uint8Array(data.bytes));
+    } else if (data.type === 'recordAutomation') {
+      if (this.wasm.recordAutomation) this.wasm.recordAutomation(this.engine, data.maxPoints | 0);
+    } else if (data.type === 'takeAutomation') {
+      this.takeAutomation();
+    }
+  }
+
+  /** Copy automation bytes into the module and play them there */
+  loadAutomation(bytes) {
+    if (!this.wasm.loadAutomation) return;
+    // The module exports no free(): keep one buffer, grown when a load needs more
+    if (bytes.length > this.automationCapacity) {
+      this.automationPtr = this.wasm.malloc(bytes.length);
+      this.automationCapacity = this.automationPtr ? bytes.length : 0;
+    }
+    if (!this.automationPtr) return;
+    new Uint8Array(this.memory.buffer).set(bytes, this.automationPtr);
+    this.wasm.loadAutomation(this.engine, this.automationPtr, bytes.length);
+    this.idle = false;
+  }
+
+  /** Stop recording and send the take's bytes back (null if nothing moved) */
+  takeAutomation() {
+    let bytes = null;
+    const size = this.wasm.takeAutomation ? this.wasm.takeAutomation(this.engine) : 0;
+    if (size > 0) {
+      const ptr = this.wasm.getAutomationPtr(this.engine);
+      bytes = new Uint8Array(this.memory.buffer, ptr, size).slice().buffer;
+    }
+    this.port.postMessage({ type: 'automation', bytes }, bytes ? [bytes] : []);
+  }
+
+  /**
+   * Runtime imports by their glue names. Engines differ in what libc they
+   * pull in; anything not listed traps if it is ever called.
+   */
+  runtimeImports() {
+    const self = this;
+    return {
+      _abort: () => {
+        throw new Error('[Engine] WASM abort called');
+      },
+      ___cxa_throw: () => {
+        throw new Error('[Engine] C++ exception');
+      },
+      _getentropy: (buffer, size) => {
+        const view = new Uint8Array(self.memory.buffer, buffer, size);
+        for (let i = 0; i < size; i++) view[i] = Math.floor(Math.random() * 256);
+        return 0;
+      },
+      _emscripten_memcpy_js: (dest, src, num) => {
+        new Uint8Array(self.memory.buffer).copyWithin(dest, src, src + num);
+      },
+      // Engines allocate in prepare(), so the heap may grow
+      _emscripten_resize_heap: (requestedSize) => {
+        const pages = Math.ceil((requestedSize - self.memory.buffer.byteLength) / 65536);
+        try {
+          self.memory.grow(pages);
+          return 1;
+        } catch (err) {
+          return 0;
+        }
+      },
+      _emscripten_get_now: () => currentTime * 1000,
+      _fd_write: () => 0,
+      _fd_close: () => 0,
+      _fd_seek: () => 0,
+    };
+  }
+
+  async initWasm(data) {
+    try {
+      const { wasmModule, wasmNames, sampleRate } = data;
+      if (!wasmModule || !wasmNames || !wasmNames.exports) {
+        throw new Error('init needs a compiled module and its name map');
+      }
+
+      const runtime = this.runtimeImports();
+      const moduleImports = {};
+      for (const [key, name] of Object.entries(wasmNames.imports || {})) {
+        moduleImports[key] = runtime[name] || (() => {
+          throw new Error('[Engine] Unsupported WASM import ' + name);
+        });
+      }
+
+      const instance = await WebAssembly.instantiate(wasmModule, { a: moduleImports });
+      const wasm = {};
+      for (const name of ['memory', 'createEngine', 'init', 'process', 'queueEvents', 'getParamBlockPtr',
+                          'getParamTablePtr', 'getParamCount', 'getEngineName', 'malloc']) {
+        const key = wasmNames.exports[name];
+        if (!key || !instance.exports[key]) {
+          throw new Error('Missing WASM export ' + name);
+        }
+        wasm[name] = instance.exports[key];
+      }
+      // Older modules have no input path, silence report or automation
+      for (const name of ['processInput', 'isSilent', 'loadAutomation', 'recordAutomation', 'takeAutomation',
+                          'getAutomationPtr']) {
+        wasm[name] = instance.exports[wasmNames.exports[name]] || null;
+      }
+      this.wasm = wasm;
+      this.memory = wasm.memory;
+
+      const ctors = instance.exports[wasmNames.exports.__wasm_call_ctors];
+      if (ctors) ctors();
+
+      this.engine = wasm.createEngine();
+      if (!this.engine || !wasm.init(this.engine, sampleRate, MAX_BLOCK_FRAMES)) {
+        throw new Error('Engine init failed at ' + sampleRate + ' Hz');
+      }
+
+      this.outputPtrL = wasm.malloc(MAX_BLOCK_FRAMES * 4);
+      this.outputPtrR = wasm.malloc(MAX_BLOCK_FRAMES * 4);
+      this.eventBatchPtr = wasm.malloc(EVENT_BATCH_CAPACITY * RECORD_BYTES);
+      if (!this.outputPtrL || !this.outputPtrR || !this.eventBatchPtr) {
+        throw new Error('Failed to allocate engine buffers');
+      }
+
+      this.updateHeapViews();
+      this.paramBlockPtr = wasm.getParamBlockPtr(this.engine);
+      this.paramTable = this.readParamTable();
+      const name = this.readString(wasm.getEngineName());
+
+      if (data.eventRing) {
+        this.eventRing = new EventRingReader(data.eventRing);
+      }
+
+      const paramIds = {};
+      for (const [paramName, info] of Object.entries(this.paramTable)) {
+        paramIds[paramName] = info.id;
+      }
+
+      this.wasmReady = true;
+      this.port.postMessage({
+        type: 'ready',
+        name,
+        eventRing: this.eventRing !== null,
+        paramIds,
+        params: this.paramTable,
+      });
+    } catch (error) {
+      console.error('[Engine] WASM init failed:', error);
+      this.port.postMessage({ type: 'error', message: error.message });
+    }
+  }
+
+  updateHeapViews() {
+    this.heapBuffer = this.memory.buffer;
+    this.heapF32 = new Float32Array(this.heapBuffer);
+    this.heapI32 = new Int32Array(this.heapBuffer);
+  }
+
+  /** ASCII C string (no TextDecoder in the worklet scope) */
+  readString(ptr) {
+    const bytes = new Uint8Array(this.heapBuffer);
+    let s = '';
+    for (let p = ptr; bytes[p] !== 0; p++) s += String.fromCharCode(bytes[p]);
+    return s;
+  }
+
+  /** The ParamInfo rows (render/EngineHost.h) by name */
+  readParamTable() {
+    const table = {};
+    const count = this.wasm.getParamCount();
+    const base = this.wasm.getParamTablePtr() >> 2;
+
+    for (let i = 0; i < count; i++) {
+      const row = base + i * PARAM_INFO_WORDS;
+      table[this.readString(this.heapI32[row])] = {
+        minValue: this.heapF32[row + 1],
+        maxValue: this.heapF32[row + 2],
+        defaultValue: this.heapF32[row + 3],
+        interval: this.heapF32[row + 4],
+        skew: this.heapF32[row + 5],
+        id: this.heapI32[row + 6],
+      };
+    }
+    return table;
+  }
+
+  /** Hand the events for frames starting at context frame blockStart to the module; returns how many */
+  queueEvents(blockStart, frames) {
+    let count = 0;
+    if (this.eventRing) {
+      count = this.eventRing.drainInto(this.heapI32, this.heapF32, this.eventBatchPtr,
+                                       EVENT_BATCH_CAPACITY, blockStart | 0, frames);
+    }
+
+    // Port messages land at the start of the block
+    let out = (this.eventBatchPtr >> 2) + count * RECORD_WORDS;
+    while (this.portEvents.length > 0 && count < EVENT_BATCH_CAPACITY) {
+      const [type, id, value] = this.portEvents.shift();
+      this.heapI32[out] = type;
+      this.heapI32[out + 1] = id;
+      this.heapI32[out + 2] = 0;
+      this.heapF32[out + 3] = value;
+      this.heapI32[out + 4] = 0;
+      out += RECORD_WORDS;
+      count++;
+    }
+
+    if (count > 0) this.wasm.queueEvents(this.engine, this.eventBatchPtr, count);
+    return count;
+  }
+
+  process(inputs, outputs, parameters) {
+    if (!this.wasmReady) return true;
+
+    const output = outputs[0];
+    if (!output || output.length < 2) return true;
+
+    const outputL = output[0];
+    const outputR = output[1];
+
+    // Connected input goes into the output buffers and is processed in
+    // place (render/EngineHost.h); a mono input feeds both sides
+    const input = inputs[0];
+    const inputL = this.wasm.processInput && input && input.length > 0 ? input[0] : null;
+    const inputR = inputL && input.length > 1 ? input[1] : inputL;
+
+    try {
+      for (let done = 0; done < outputL.length;) {
+        const frames = Math.min(outputL.length - done, MAX_BLOCK_FRAMES);
+        if (this.memory.buffer !== this.heapBuffer) this.updateHeapViews();
+
+        if (this.queueEvents(currentFrame + done, frames) > 0 || inputL) this.idle = false;
+        if (this.idle) {
+          outputL.fill(0, done, done + frames);
+          outputR.fill(0, done, done + frames);
+          done += frames;
+          continue;
+        }
+
+        if (inputL) {
+          this.heapF32.set(inputL.subarray(done, done + frames), this.outputPtrL >> 2);
+          this.heapF32.set(inputR.subarray(done, done + frames), this.outputPtrR >> 2);
+          this.wasm.processInput(this.engine, this.outputPtrL, this.outputPtrR,
+                                 this.outputPtrL, this.outputPtrR, frames);
+        } else {
+          this.wasm.process(this.engine, this.outputPtrL, this.outputPtrR, frames);
+        }
+
+        // process() may have grown the heap
+        if (this.memory.buffer !== this.heapBuffer) this.updateHeapViews();
+        outputL.set(this.heapF32.subarray(this.outputPtrL >> 2, (this.outputPtrL >> 2) + frames), done);
+        outputR.set(this.heapF32.subarray(this.outputPtrR >> 2, (this.outputPtrR >> 2) + frames), done);
+        this.idle = this.wasm.isSilent !== null && this.wasm.isSilent(this.engine) !== 0;
+        done += frames;
+      }
+    } catch (err) {
+      console.error('[Engine] process error:', err);
+    }
+
+    return true;
+  }
+}
+
+registerProcessor('engine-processor', EngineProcessor);
@@ -0,0 +1,84 @@
+/**
+ * Event Ring - worklet side
+ *
+ * Single-producer/single-consumer ring in a SharedArrayBuffer. The UI
+ * thread writes parameter changes and MIDI events (src/audio/eventRing.ts);
+ * the worklet drains them before rendering and hands them to the WASM
+ * applyParams(ptr, count) export in one call.
+ *
+ * Layout (keep in sync with src/audio/eventRing.ts):
+ *   Int32 [0]  write index (records, producer owned)
+ *   Int32 [1]  read index (records, consumer owned)
+ *   Int32 [2..3] reserved
+ *   Then CAPACITY records of RECORD_WORDS 32-bit words:
+ *     [0] type  (EVENT_PARAM, EVENT_NOTE_ON, EVENT_NOTE_OFF; the multi-engine
+ *               module keeps the engine handle in bits 8 and up)
+ *     [1] id    (param ID, or MIDI note)
+ *     [2] index (step index for per-step params, else 0)
+ *     [3] value (Float32: param value or velocity)
+ *     [4] time  (context frame to apply at, 0 = as soon as possible)
+ *
+ * The WASM ParamEvent struct uses the same five words, except that word 4
+ * holds the sample offset within the rendered block instead of a time.
+ */
+
+export const EVENT_PARAM = 0;
+export const EVENT_NOTE_ON = 1;
+export const EVENT_NOTE_OFF = 2;
+
+export const HEADER_WORDS = 4;
+export const RECORD_WORDS = 5;
+export const RECORD_BYTES = RECORD_WORDS * 4;
+
+export class EventRingReader {
+  constructor(sab) {
+    this.i32 = new Int32Array(sab);
+    this.f32 = new Float32Array(sab);
+    this.capacity = (this.i32.length - HEADER_WORDS) / RECORD_WORDS;
+  }
+
+  /**
+   * Move pending events into a WASM ParamEvent array.
+   *
+   * Events stamped at or past blockEnd stay queued for a later block.
+   * Returns the number of events written (at most maxEvents).
+   *
+   * @param {Int32Array} heapI32 WASM heap view
+   * @param {Float32Array} heapF32 WASM heap view (same buffer)
+   * @param {number} ptr Byte address of the ParamEvent array
+   * @param {number} maxEvents Capacity of that array
+   * @param {number} blockStart Context frame of the block's first sample
+   * @param {number} blockFrames Length of the block being rendered
+   */
+  drainInto(heapI32, heapF32, ptr, maxEvents, blockStart, blockFrames) {
+    const i32 = this.i32;
+    const f32 = this.f32;
+    const write = Atomics.load(i32, 0);
+    let read = Atomics.load(i32, 1);
+    let count = 0;
+    let out = ptr >> 2;
+
+    while (read !== write && count < maxEvents) {
+      const src = HEADER_WORDS + read * RECORD_WORDS;
+      const time = i32[src + 4];
+
+      // Frame difference is wrap safe in 32-bit arithmetic
+      let offset = time === 0 ? 0 : (time - blockStart) | 0;
+      if (offset >= blockFrames) break;
+      if (offset < 0) offset = 0;
+
+      heapI32[out] = i32[src];
+      heapI32[out + 1] = i32[src + 1];
+      heapI32[out + 2] = i32[src + 2];
+      heapF32[out + 3] = f32[src + 3];
+      heapI32[out + 4] = offset;
+      out += RECORD_WORDS;
+      count++;
+
+      read = read + 1 === this.capacity ? 0 : read + 1;
+    }
+
+    Atomics.store(i32, 1, read);
+    return count;
+  }
+}
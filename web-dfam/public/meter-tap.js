@@ -0,0 +1,44 @@
+/**
+ * Meter Tap - worklet side
+ *
+ * Publishes the engine's MeterBlock (src/dsp/Meters.h) into a
+ * SharedArrayBuffer from the UI, which reads it on requestAnimationFrame
+ * (src/audio/meters.ts). Replaces posting 'step' messages from the audio
+ * thread. The block is copied as words after each render; a sequence
+ * counter around the copy lets the reader retry a torn read.
+ *
+ * Layout (keep in sync with src/audio/meters.ts):
+ *   Int32 [0]  sequence (odd while the worklet is copying)
+ *   Int32 [1..3] reserved
+ *   Then the MeterBlock words: blocks, scopeWrite, step, running,
+ *   peakL, peakR, rmsL, rmsR (Float32), then SCOPE_SIZE Float32 samples
+ */
+
+export const HEADER_WORDS = 4;
+
+export class MeterTapWriter {
+  /**
+   * @param {SharedArrayBuffer} sab Buffer from the UI
+   * @param {number} blockBytes getMetersSize() from the WASM module
+   */
+  constructor(sab, blockBytes) {
+    this.i32 = new Int32Array(sab);
+    this.words = blockBytes >> 2;
+    if (this.i32.length < HEADER_WORDS + this.words) {
+      throw new Error('Meter buffer too small for the WASM MeterBlock');
+    }
+  }
+
+  /**
+   * Copy the MeterBlock at ptr out of the WASM heap
+   *
+   * @param {Int32Array} heapI32 WASM heap view
+   * @param {number} ptr Byte address of the MeterBlock
+   */
+  publish(heapI32, ptr) {
+    const start = ptr >> 2;
+    Atomics.add(this.i32, 0, 1);
+    this.i32.set(heapI32.subarray(start, start + this.words), HEADER_WORDS);
+    Atomics.add(this.i32, 0, 1);
+  }
+}
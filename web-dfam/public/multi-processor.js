@@ -0,0 +1,311 @@
+/**
+ * Multi-engine AudioWorklet Processor
+ * Runs several WASM engines and their routing graph (src/dsp/multi) in one
+ * audio node, e.g. DFAM recorded onto a TapeLoop with no cross-node copies.
+ *
+ * Port messages:
+ *   init           { wasmModule, simd, wasmNames, sampleRate, eventRing?, renderQuanta? }
+ *                  (or wasmBytes/wasmSimdBytes to compile here)
+ *   createEngine   { engineType, requestId }  -> engineCreated { id, engineType, requestId }
+ *                  (engineType: 0 = DFAM, 1 = TapeLoop, see src/dsp/multi/engines.h)
+ *   destroyEngine  { id }
+ *   connect        { source, dest, gain }     (dest -1 = master)
+ *   disconnect     { source, dest }
+ *   event          { engine, kind, id, index, value }  (no event ring)
+ *   getPerfStats   { id }                     -> perfStats { id, ... }
+ *
+ * Event ring records carry the engine handle in their type word:
+ * type = kind | handle << ENGINE_SHIFT (src/audio/eventRing.ts).
+ */
+
+import { EventRingReader, RECORD_BYTES } from './event-ring.js';
+import { perfNow, readPerfStats } from './perf-stats.js';
+
+/** Web Audio render quantum in frames */
+const QUANTUM_FRAMES = 128;
+
+/** Most ring events applied per render (the rest wait for the next one) */
+const EVENT_BATCH_CAPACITY = 256;
+
+/** Engine handle position in an event's type word (multi/wasm_bindings.cpp) */
+const ENGINE_SHIFT = 8;
+
+class MultiProcessor extends AudioWorkletProcessor {
+  constructor() {
+    super();
+    this.wasmReady = false;
+    this.wasm = null;  // C export name -> function, resolved from the glue's name map
+    this.memory = null;
+    this.outputPtrL = 0;
+    this.outputPtrR = 0;
+    this.heapF32 = null;
+    this.heapI32 = null;
+    this.heapBuffer = null;
+
+    // Render-ahead ring, as in dfam-processor.js. Kept shallow because a
+    // TapeLoop in the graph may be played live (2 quanta is ~6 ms at 44.1 kHz).
+    this.renderQuanta = 2;
+    this.ringFrames = 0;
+    this.readFrame = 0;
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+
+    // SharedArrayBuffer event ring; null falls back to 'event' messages
+    this.eventRing = null;
+    this.eventBatchPtr = 0;
+
+    this.port.onmessage = (event) => {
+      this.handleMessage(event.data);
+    };
+  }
+
+  handleMessage(data) {
+    if (data.type === 'init') {
+      if (data.renderQuanta > 0) {
+        this.renderQuanta = Math.floor(data.renderQuanta);
+      }
+      this.initWasm(data, data.sampleRate, data.eventRing, data.wasmNames);
+      return;
+    }
+    if (!this.wasmReady) return;
+
+    switch (data.type) {
+      case 'createEngine': {
+        const id = this.wasm.createEngine(data.engineType);
+        this.updateHeapViews();  // Engines allocate; the heap may have grown
+        this.port.postMessage({ type: 'engineCreated', id, engineType: data.engineType, requestId: data.requestId });
+        break;
+      }
+      case 'destroyEngine':
+        this.wasm.destroyEngine(data.id);
+        break;
+      case 'connect':
+        this.wasm.connect(data.source, data.dest, data.gain ?? 1);
+        break;
+      case 'disconnect':
+        this.wasm.disconnect(data.source, data.dest);
+        break;
+      case 'event':
+        this.applyEvent(data.engine, data.kind, data.id, data.index || 0, Number(data.value));
+        break;
+      case 'getPerfStats': {
+        const stats = readPerfStats(this.memory, () => this.wasm.getPerfStats(data.id), this.wasm.getPerfStatsSize);
+        this.port.postMessage({ type: 'perfStats', id: data.id, ...stats });
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  /**
+   * The module the main thread compiled (src/audio/wasmModule.ts), or
+   * compile raw bytes here: the SIMD128 build if this browser validates
+   * it, otherwise the scalar fallback
+   */
+  static async compileWasm(source) {
+    if (source.wasmModule) {
+      return { wasmModule: source.wasmModule, simd: !!source.simd };
+    }
+    if (source.wasmSimdBytes && WebAssembly.validate(source.wasmSimdBytes)) {
+      return { wasmModule: await WebAssembly.compile(source.wasmSimdBytes), simd: true };
+    }
+    return { wasmModule: await WebAssembly.compile(source.wasmBytes), simd: false };
+  }
+
+  async initWasm(source, sr, eventRing, wasmNames) {
+    try {
+      if (!wasmNames || !wasmNames.exports) {
+        throw new Error('No WASM export name map (is multi.js being served?)');
+      }
+
+      this.ringFrames = QUANTUM_FRAMES * this.renderQuanta;
+      this.readFrame = this.ringFrames;  // Render on the first callback
+
+      const { wasmModule, simd } = await MultiProcessor.compileWasm(source);
+      console.log('[Worklet] Using', simd ? 'SIMD128' : 'scalar', 'multi-engine WASM build');
+
+      const self = this;
+
+      // Runtime functions the WASM module imports, by their glue names
+      const runtime = {
+        _abort: () => {
+          throw new Error('abort');
+        },
+        // Release builds have no exceptions (see RELEASE_FLAGS); older ones import this
+        ___cxa_throw: () => {
+          throw new Error('C++ exception');
+        },
+        _getentropy: (buffer, size) => {
+          if (!self.memory) return -1;
+          const view = new Uint8Array(self.memory.buffer, buffer, size);
+          for (let i = 0; i < size; i++) {
+            view[i] = Math.floor(Math.random() * 256);
+          }
+          return 0;
+        },
+        _emscripten_memcpy_js: (dest, src, num) => {
+          if (!self.memory) return;
+          new Uint8Array(self.memory.buffer).copyWithin(dest, src, src + num);
+        },
+        // Don't support growing in the worklet
+        _emscripten_resize_heap: () => 0,
+        // Only imported by PERF_STATS=1 builds (PerfStats' wall clock)
+        _emscripten_get_now: perfNow,
+      };
+
+      // The import module name is "a"; its keys are minified too
+      const moduleImports = {};
+      for (const [key, name] of Object.entries(wasmNames.imports || {})) {
+        if (!runtime[name]) throw new Error('Unsupported WASM import ' + name);
+        moduleImports[key] = runtime[name];
+      }
+
+      const instance = await WebAssembly.instantiate(wasmModule, { a: moduleImports });
+      const exports = instance.exports;
+
+      // Resolve the exports we use by their C names
+      const wasm = {};
+      for (const name of ['memory', 'init', 'createEngine', 'destroyEngine', 'connect', 'disconnect',
+                          'processGraph', 'applyParams', 'getPerfStats', 'getPerfStatsSize', 'malloc']) {
+        const key = wasmNames.exports[name];
+        if (!key || !exports[key]) {
+          throw new Error('Missing WASM export ' + name);
+        }
+        wasm[name] = exports[key];
+      }
+      this.wasm = wasm;
+      this.memory = wasm.memory;
+
+      const ctors = exports[wasmNames.exports.__wasm_call_ctors];
+      if (ctors) ctors();
+
+      wasm.init(sr, this.ringFrames);
+
+      // Planar output ring, and the event batch (ring drains and 'event' messages)
+      this.outputPtrL = wasm.malloc(this.ringFrames * 4);
+      this.outputPtrR = wasm.malloc(this.ringFrames * 4);
+      this.eventBatchPtr = wasm.malloc(EVENT_BATCH_CAPACITY * RECORD_BYTES);
+      if (this.outputPtrL === 0 || this.outputPtrR === 0 || this.eventBatchPtr === 0) {
+        throw new Error('Failed to allocate output buffers');
+      }
+
+      if (eventRing) {
+        this.eventRing = new EventRingReader(eventRing);
+      }
+      this.updateHeapViews();
+
+      this.wasmReady = true;
+      this.port.postMessage({ type: 'ready', eventRing: this.eventRing !== null });
+    } catch (error) {
+      console.error('[Worklet] WASM init failed:', error);
+      this.port.postMessage({ type: 'error', message: error.message });
+    }
+  }
+
+  /** Rebuild the heap views (at init and after the memory grows) */
+  updateHeapViews() {
+    if (!this.memory) return;
+
+    this.heapBuffer = this.memory.buffer;
+    this.heapF32 = new Float32Array(this.heapBuffer);
+    this.heapI32 = new Int32Array(this.heapBuffer);
+
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+    const offsetL = this.outputPtrL >> 2;
+    const offsetR = this.outputPtrR >> 2;
+    for (let q = 0; q < this.renderQuanta; q++) {
+      const start = q * QUANTUM_FRAMES;
+      this.ringViewsL.push(this.heapF32.subarray(offsetL + start, offsetL + start + QUANTUM_FRAMES));
+      this.ringViewsR.push(this.heapF32.subarray(offsetR + start, offsetR + start + QUANTUM_FRAMES));
+    }
+  }
+
+  /** Apply one event to one engine at the start of the next block */
+  applyEvent(engine, kind, id, index, value) {
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.updateHeapViews();
+    }
+    const p = this.eventBatchPtr >> 2;
+    this.heapI32[p] = kind | (engine << ENGINE_SHIFT);
+    this.heapI32[p + 1] = id;
+    this.heapI32[p + 2] = index;
+    this.heapF32[p + 3] = value;
+    this.heapI32[p + 4] = 0;
+    this.wasm.applyParams(this.eventBatchPtr, 1);
+  }
+
+  /** Apply the ring's events for the next block, then render the graph into the ring */
+  renderRing(frames) {
+    if (this.memory.buffer !== this.heapBuffer) {
+      this.updateHeapViews();
+    }
+    if (this.eventRing) {
+      const count = this.eventRing.drainInto(
+        this.heapI32, this.heapF32, this.eventBatchPtr,
+        EVENT_BATCH_CAPACITY, currentFrame | 0, frames);
+      if (count > 0) {
+        this.wasm.applyParams(this.eventBatchPtr, count);
+      }
+    }
+    this.wasm.processGraph(this.outputPtrL, this.outputPtrR, frames);
+  }
+
+  /**
+   * Other quantum sizes: render straight through, no ring, in chunks of
+   * at most ringFrames (the output buffer). The WASM process() takes any
+   * count (src/dsp/FixedBlockRenderer.h).
+   */
+  renderDirect(outputL, outputR, numSamples) {
+    for (let done = 0; done < numSamples;) {
+      const count = Math.min(numSamples - done, this.ringFrames);
+      this.renderRing(count);
+      if (this.memory.buffer !== this.heapBuffer) {
+        this.updateHeapViews();
+      }
+      const offsetL = this.outputPtrL >> 2;
+      const offsetR = this.outputPtrR >> 2;
+      outputL.set(this.heapF32.subarray(offsetL, offsetL + count), done);
+      outputR.set(this.heapF32.subarray(offsetR, offsetR + count), done);
+      done += count;
+    }
+    // Anything left in the ring is stale now
+    this.readFrame = this.ringFrames;
+  }
+
+  process(inputs, outputs) {
+    if (!this.wasmReady) return true;
+
+    const output = outputs[0];
+    if (!output || output.length < 2) return true;
+
+    const outputL = output[0];
+    const outputR = output[1];
+    const numSamples = outputL.length;
+
+    try {
+      if (numSamples === QUANTUM_FRAMES) {
+        if (this.readFrame >= this.ringFrames) {
+          this.renderRing(this.ringFrames);
+          this.readFrame = 0;
+        }
+        if (this.memory.buffer !== this.heapBuffer) {
+          this.updateHeapViews();
+        }
+        const quantum = this.readFrame / QUANTUM_FRAMES;
+        outputL.set(this.ringViewsL[quantum]);
+        outputR.set(this.ringViewsR[quantum]);
+        this.readFrame += QUANTUM_FRAMES;
+      } else {
+        this.renderDirect(outputL, outputR, numSamples);
+      }
+    } catch (err) {
+      console.error('[Worklet] process error:', err);
+    }
+
+    return true;
+  }
+}
+
+registerProcessor('multi-processor', MultiProcessor);
@@ -0,0 +1,60 @@
+/**
+ * Perf Stats - worklet side
+ *
+ * Decodes the WASM getPerfStats() export: PerfStats::Snapshot::toFlat()
+ * doubles (core/dsp/PerfStats.h) into the same object the plugins'
+ * getPerfStats native function returns.
+ *
+ * Layout (keep in sync with PerfStats.h):
+ *   [0] enabled  [1] blocks  [2] blocksOverBudget  [3] lastBlockUs
+ *   [4] worstBlockUs  [5] averageLoad  [6] blockCycles
+ *   Then one cycle count per stage, then the voice histogram.
+ */
+
+export const PERF_STAGE_NAMES = ['voices', 'filter', 'effects', 'master'];
+export const PERF_HISTOGRAM_SIZE = 17;
+
+const PERF_HEADER_SIZE = 7;
+
+/** Wall clock for the emscripten_get_now import of PERF_STATS=1 builds */
+export function perfNow() {
+  return globalThis.performance ? performance.now() : Date.now();
+}
+
+/**
+ * Read the counters. getPerfStats / getPerfStatsSize may be missing
+ * (older builds); everything is 0 unless built with PERF_STATS=1.
+ */
+export function readPerfStats(memory, getPerfStats, getPerfStatsSize) {
+  const stats = {
+    enabled: false,
+    blocks: 0,
+    blocksOverBudget: 0,
+    lastBlockUs: 0,
+    worstBlockUs: 0,
+    averageLoad: 0,
+    stageShare: {},
+    voiceHistogram: [],
+  };
+  if (!memory || !getPerfStats || !getPerfStatsSize) return stats;
+
+  const flat = new Float64Array(memory.buffer, getPerfStats(), getPerfStatsSize());
+  if (flat[0] === 0) return stats;
+
+  stats.enabled = true;
+  stats.blocks = flat[1];
+  stats.blocksOverBudget = flat[2];
+  stats.lastBlockUs = flat[3];
+  stats.worstBlockUs = flat[4];
+  stats.averageLoad = flat[5];
+
+  // Cycle counts only mean something relative to each other, so send shares
+  const blockCycles = flat[6];
+  PERF_STAGE_NAMES.forEach((name, s) => {
+    stats.stageShare[name] = blockCycles > 0 ? flat[PERF_HEADER_SIZE + s] / blockCycles : 0;
+  });
+
+  const histogramStart = PERF_HEADER_SIZE + PERF_STAGE_NAMES.length;
+  stats.voiceHistogram = Array.from(flat.subarray(histogramStart, histogramStart + PERF_HISTOGRAM_SIZE));
+  return stats;
+}
@@ -5,6 +5,15 @@
  * Full-featured TapeLoop with Airwindows, Galactic3 reverb, ADSR, and more.
  */
 
+import { EventRingReader, RECORD_BYTES } from './event-ring.js';
+import { perfNow, readPerfStats } from './perf-stats.js';
+
+/** Web Audio render quantum in frames */
+const QUANTUM_FRAMES = 128;
+
+/** Most ring events applied per render (the rest wait for the next one) */
+const EVENT_BATCH_CAPACITY = 256;
+
 class TapeLoopProcessor extends AudioWorkletProcessor {
   constructor() {
     super();
@@ -14,6 +23,25 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
     this.outputPtrL = 0;
     this.outputPtrR = 0;
     this.heapF32 = null;
+    this.heapBuffer = null;
+
+    // Render-ahead ring: the engine renders renderQuanta quanta per call
+    // into planar L/R buffers in the WASM heap, and process() copies one
+    // quantum out of a cached view per callback. Kept shallow because
+    // notes are played live through the port (2 quanta is ~6 ms at 44.1 kHz).
+    this.renderQuanta = 2;
+    this.ringFrames = 0;
+    this.readFrame = 0;
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+
+    // SharedArrayBuffer event ring from the UI; null falls back to 'param'
+    // messages through the port
+    this.eventRing = null;
+    this.eventBatchPtr = 0;
+    this.applyParams = null;
+    this.heapI32 = null;
+
     this.seq1Step = 0;
     this.seq2Step = 0;
     this.frameCount = 0;
@@ -25,7 +53,10 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
 
   handleMessage(data) {
     if (data.type === 'init') {
-      this.initWasm(data.wasmBytes, data.sampleRate);
+      if (data.renderQuanta > 0) {
+        this.renderQuanta = Math.floor(data.renderQuanta);
+      }
+      this.initWasm(data, data.sampleRate, data.eventRing);
     } else if (data.type === 'param' && this.wasmReady) {
       this.setParam(data.name, data.value);
     } else if (data.type === 'noteOn' && this.wasmReady) {
@@ -34,11 +65,35 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
       this.wasmExports.noteOff(data.note);
     } else if (data.type === 'clearTape' && this.wasmReady) {
       this.wasmExports.clearTape();
+    } else if (data.type === 'getPerfStats' && this.wasmReady) {
+      const stats = readPerfStats(this.memory, this.wasmExports.getPerfStats, this.wasmExports.getPerfStatsSize);
+      this.port.postMessage({ type: 'perfStats', ...stats });
+    }
+  }
+
+  /**
+   * The module the main thread compiled (src/audio/wasmModule.ts), or
+   * compile raw bytes here: the SIMD128 build if this browser validates
+   * it, otherwise the scalar fallback
+   */
+  static async compileWasm(source) {
+    if (source.wasmModule) {
+      return { wasmModule: source.wasmModule, simd: !!source.simd };
+    }
+    if (source.wasmSimdBytes && WebAssembly.validate(source.wasmSimdBytes)) {
+      return { wasmModule: await WebAssembly.compile(source.wasmSimdBytes), simd: true };
     }
+    return { wasmModule: await WebAssembly.compile(source.wasmBytes), simd: false };
   }
 
-  async initWasm(wasmBytes, sr) {
+  async initWasm(source, sr, eventRing) {
     try {
+      this.ringFrames = QUANTUM_FRAMES * this.renderQuanta;
+      this.readFrame = this.ringFrames;  // Render on the first callback
+
+      const { wasmModule, simd } = await TapeLoopProcessor.compileWasm(source);
+      console.log('[TapeLoop] Using', simd ? 'SIMD128' : 'scalar', 'WASM build');
+
       const self = this;
 
       // WASM imports for emscripten with WASI stubs
@@ -60,11 +115,12 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
             console.log('[TapeLoop] Memory grew');
             self.updateHeapViews();
           },
+          // Only imported by PERF_STATS=1 builds (PerfStats' wall clock)
+          emscripten_get_now: perfNow,
         }
       };
 
-      console.log('[TapeLoop] Compiling WASM...');
-      const wasmModule = await WebAssembly.compile(wasmBytes);
+      console.log('[TapeLoop] Instantiating WASM...');
       const instance = await WebAssembly.instantiate(wasmModule, imports);
 
       this.wasmExports = instance.exports;
@@ -86,10 +142,10 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
 
       // Initialize the synth engine
       console.log('[TapeLoop] Initializing synth at', sr, 'Hz...');
-      this.wasmExports.init(sr);
+      this.wasmExports.init(sr, this.ringFrames);
 
-      // Allocate output buffers (128 samples * 4 bytes per float)
-      const bufferSize = 128 * 4;
+      // Allocate the planar output ring (ringFrames floats per channel)
+      const bufferSize = this.ringFrames * 4;
       this.outputPtrL = this.wasmExports.malloc(bufferSize);
       this.outputPtrR = this.wasmExports.malloc(bufferSize);
       console.log('[TapeLoop] Output buffers allocated at:', this.outputPtrL, this.outputPtrR);
@@ -98,8 +154,20 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
         throw new Error('Failed to allocate output buffers');
       }
 
+      const applyParams = this.wasmExports.applyParams;
+      if (eventRing && applyParams) {
+        this.eventBatchPtr = this.wasmExports.malloc(EVENT_BATCH_CAPACITY * RECORD_BYTES);
+        if (this.eventBatchPtr !== 0) {
+          this.eventRing = new EventRingReader(eventRing);
+          this.applyParams = applyParams;
+        }
+      }
+      console.log('[TapeLoop] Parameter path:', this.eventRing ? 'event ring' : 'port messages');
+
+      this.updateHeapViews();
+
       this.wasmReady = true;
-      this.port.postMessage({ type: 'ready' });
+      this.port.postMessage({ type: 'ready', eventRing: this.eventRing !== null });
       console.log('[TapeLoop] WASM initialized successfully!');
     } catch (error) {
       console.error('[TapeLoop] WASM init failed:', error);
@@ -107,9 +175,28 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
     }
   }
 
+  /**
+   * Rebuild the heap views. Only needed at init and after the WASM memory
+   * grows (growth detaches the old ArrayBuffer), so process() never
+   * allocates views on the steady-state path.
+   */
   updateHeapViews() {
-    if (this.memory) {
-      this.heapF32 = new Float32Array(this.memory.buffer);
+    if (!this.memory) return;
+
+    this.heapBuffer = this.memory.buffer;
+    this.heapF32 = new Float32Array(this.heapBuffer);
+    this.heapI32 = new Int32Array(this.heapBuffer);
+
+    this.ringViewsL = [];
+    this.ringViewsR = [];
+    if (this.outputPtrL === 0 || this.outputPtrR === 0) return;
+
+    const offsetL = this.outputPtrL >> 2; // Divide by 4 to get float index
+    const offsetR = this.outputPtrR >> 2;
+    for (let q = 0; q < this.renderQuanta; q++) {
+      const start = q * QUANTUM_FRAMES;
+      this.ringViewsL.push(this.heapF32.subarray(offsetL + start, offsetL + start + QUANTUM_FRAMES));
+      this.ringViewsR.push(this.heapF32.subarray(offsetR + start, offsetR + start + QUANTUM_FRAMES));
     }
   }
 
@@ -234,6 +321,48 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
     }
   }
 
+  /**
+   * Apply events from the ring that fall inside the next block, then
+   * render it. Events are stamped in context frames; the block starts at
+   * this quantum's currentFrame.
+   */
+  renderRing(frames) {
+    if (this.eventRing) {
+      if (this.memory.buffer !== this.heapBuffer) {
+        this.updateHeapViews();
+      }
+      const count = this.eventRing.drainInto(
+        this.heapI32, this.heapF32, this.eventBatchPtr,
+        EVENT_BATCH_CAPACITY, currentFrame | 0, frames);
+      if (count > 0) {
+        this.applyParams(this.eventBatchPtr, count);
+      }
+    }
+    this.wasmExports.process(this.outputPtrL, this.outputPtrR, frames);
+  }
+
+  /**
+   * Other quantum sizes: render straight through, no ring, in chunks of
+   * at most ringFrames (the output buffer). The WASM process() takes any
+   * count (src/dsp/FixedBlockRenderer.h).
+   */
+  renderDirect(outputL, outputR, numSamples) {
+    for (let done = 0; done < numSamples;) {
+      const count = Math.min(numSamples - done, this.ringFrames);
+      this.renderRing(count);
+      if (this.memory.buffer !== this.heapBuffer) {
+        this.updateHeapViews();
+      }
+      const offsetL = this.outputPtrL >> 2;
+      const offsetR = this.outputPtrR >> 2;
+      outputL.set(this.heapF32.subarray(offsetL, offsetL + count), done);
+      outputR.set(this.heapF32.subarray(offsetR, offsetR + count), done);
+      done += count;
+    }
+    // Anything left in the ring is stale now
+    this.readFrame = this.ringFrames;
+  }
+
   process(inputs, outputs, parameters) {
     if (!this.wasmReady || !this.wasmExports || !this.heapF32) {
       return true;
@@ -247,21 +376,24 @@ class TapeLoopProcessor extends AudioWorkletProcessor {
     const numSamples = outputL.length;
 
     try {
-      // Update heap view in case memory grew
-      if (this.memory.buffer.byteLength !== this.heapF32.buffer.byteLength) {
-        this.updateHeapViews();
-      }
-
-      // Call WASM process function
-      this.wasmExports.process(this.outputPtrL, this.outputPtrR, numSamples);
+      if (numSamples === QUANTUM_FRAMES) {
+        // Render the next batch of quanta once the ring has been played out
+        if (this.readFrame >= this.ringFrames) {
+          this.renderRing(this.ringFrames);
+          this.readFrame = 0;
+        }
 
-      // Copy from WASM heap to output buffers
-      const offsetL = this.outputPtrL >> 2;
-      const offsetR = this.outputPtrR >> 2;
+        // Views are only rebuilt if the memory grew
+        if (this.memory.buffer !== this.heapBuffer) {
+          this.updateHeapViews();
+        }
 
-      for (let i = 0; i < numSamples; i++) {
-        outputL[i] = this.heapF32[offsetL + i];
-        outputR[i] = this.heapF32[offsetR + i];
+        const quantum = this.readFrame / QUANTUM_FRAMES;
+        outputL.set(this.ringViewsL[quantum]);
+        outputR.set(this.ringViewsR[quantum]);
+        this.readFrame += QUANTUM_FRAMES;
+      } else {
+        this.renderDirect(outputL, outputR, numSamples);
       }
 
       // Periodically report sequencer steps
@@ -0,0 +1,164 @@
+/**
+ * @file bounce.ts
+ * @brief Render a DFAM pattern to a WAV file faster than real time
+ *
+ * Loads the pthreads build (make offline -> public/dfam-offline.js) on the
+ * main thread. Each bounce renders on one of the module's worker threads
+ * over shared memory (src/dsp/offline_render.h), so the page and the live
+ * worklet keep running; this side only polls progress and copies the
+ * result out. Needs a cross-origin isolated page, like the event ring.
+ */
+
+import { canUseEventRing } from './eventRing';
+
+/** ParamInfo row size in 32-bit words (src/dsp/dfam_params.h) */
+const PARAM_INFO_WORDS = 8;
+
+/** How often to poll a running bounce */
+const POLL_INTERVAL_MS = 50;
+
+/** Subset of the Emscripten module that bounce() uses */
+interface OfflineModule {
+  HEAPF32: Float32Array;
+  HEAP32: Int32Array;
+  HEAPU8: Uint8Array;
+  _createBounce(sampleRate: number): number;
+  _getBounceParamBlockPtr(job: number): number;
+  _startBounce(job: number, numFrames: number): number;
+  _getBounceFramesDone(job: number): number;
+  _getBounceLeft(job: number): number;
+  _getBounceRight(job: number): number;
+  _releaseBounce(job: number): void;
+  _getParamTablePtr(): number;
+  _getParamCount(): number;
+}
+
+export interface BounceOptions {
+  /** Length of the render */
+  seconds: number;
+  sampleRate?: number;
+  /** Param values by name; per-step params use `${name}_${step}` */
+  params?: Readonly<Record<string, number>>;
+  /** Called with 0..1 while rendering */
+  onProgress?: (fraction: number) => void;
+  signal?: AbortSignal;
+}
+
+/** True when the page can load the shared-memory offline module */
+export function canBounce(): boolean {
+  return canUseEventRing();
+}
+
+let modulePromise: Promise<OfflineModule> | null = null;
+
+function loadOfflineModule(): Promise<OfflineModule> {
+  if (!modulePromise) {
+    const url = '/dfam-offline.js';
+    modulePromise = import(/* @vite-ignore */ url).then(
+      (glue: { default: () => Promise<OfflineModule> }) => glue.default());
+  }
+  return modulePromise;
+}
+
+/** Name -> first slot in the parameter block, from the module's table */
+function readParamSlots(m: OfflineModule): Map<string, { offset: number; slots: number }> {
+  const slots = new Map<string, { offset: number; slots: number }>();
+  const base = m._getParamTablePtr() >> 2;
+  const count = m._getParamCount();
+
+  for (let i = 0; i < count; i++) {
+    const row = base + i * PARAM_INFO_WORDS;
+    let name = '';
+    for (let p = m.HEAP32[row]; m.HEAPU8[p] !== 0; p++) {
+      name += String.fromCharCode(m.HEAPU8[p]);
+    }
+    slots.set(name, { offset: m.HEAP32[row + 6], slots: m.HEAP32[row + 5] });
+  }
+  return slots;
+}
+
+/** Resolve a param name ("tempo", "seqPitch_3") to its slot, or -1 */
+function slotFor(table: Map<string, { offset: number; slots: number }>, name: string): number {
+  const direct = table.get(name);
+  if (direct) return direct.offset;
+
+  const split = name.lastIndexOf('_');
+  if (split < 0) return -1;
+  const info = table.get(name.slice(0, split));
+  const step = Number(name.slice(split + 1));
+  if (!info || !Number.isInteger(step) || step < 0 || step >= info.slots) return -1;
+  return info.offset + step;
+}
+
+/** Render the pattern in `params` from step one and return it as a 16-bit stereo WAV */
+export async function bouncePattern(options: BounceOptions): Promise<Blob> {
+  if (!canBounce()) {
+    throw new Error('Bouncing needs a cross-origin isolated page (SharedArrayBuffer)');
+  }
+
+  const sampleRate = options.sampleRate ?? 44100;
+  const numFrames = Math.max(1, Math.round(options.seconds * sampleRate));
+  const m = await loadOfflineModule();
+
+  const job = m._createBounce(sampleRate);
+  if (job < 0) throw new Error('Too many bounces running');
+
+  try {
+    const table = readParamSlots(m);
+    const block = m._getBounceParamBlockPtr(job) >> 2;
+    for (const [name, value] of Object.entries(options.params ?? {})) {
+      const slot = slotFor(table, name);
+      if (slot >= 0) m.HEAPF32[block + slot] = value;
+    }
+
+    if (!m._startBounce(job, numFrames)) throw new Error('Bounce failed to start');
+
+    // The worker renders; poll until it's done, reporting progress
+    for (;;) {
+      if (options.signal?.aborted) throw new DOMException('Bounce aborted', 'AbortError');
+      const done = m._getBounceFramesDone(job);
+      options.onProgress?.(done / numFrames);
+      if (done >= numFrames) break;
+      await new Promise((resolve) => setTimeout(resolve, POLL_INTERVAL_MS));
+    }
+
+    // Views taken after rendering: the buffers were allocated by startBounce
+    const left = m.HEAPF32.subarray(m._getBounceLeft(job) >> 2, (m._getBounceLeft(job) >> 2) + numFrames);
+    const right = m.HEAPF32.subarray(m._getBounceRight(job) >> 2, (m._getBounceRight(job) >> 2) + numFrames);
+    return encodeWav(left, right, sampleRate);
+  } finally {
+    m._releaseBounce(job);
+  }
+}
+
+/** Interleave and encode planar float audio as 16-bit PCM WAV */
+function encodeWav(left: Float32Array, right: Float32Array, sampleRate: number): Blob {
+  const frames = left.length;
+  const dataBytes = frames * 4;
+  const view = new DataView(new ArrayBuffer(44 + dataBytes));
+
+  const tag = (offset: number, s: string) => {
+    for (let i = 0; i < 4; i++) view.setUint8(offset + i, s.charCodeAt(i));
+  };
+  tag(0, 'RIFF');
+  view.setUint32(4, 36 + dataBytes, true);
+  tag(8, 'WAVE');
+  tag(12, 'fmt ');
+  view.setUint32(16, 16, true);
+  view.setUint16(20, 1, true);              // PCM
+  view.setUint16(22, 2, true);              // Channels
+  view.setUint32(24, sampleRate, true);
+  view.setUint32(28, sampleRate * 4, true); // Byte rate
+  view.setUint16(32, 4, true);              // Block align
+  view.setUint16(34, 16, true);             // Bits per sample
+  tag(36, 'data');
+  view.setUint32(40, dataBytes, true);
+
+  let offset = 44;
+  for (let i = 0; i < frames; i++) {
+    view.setInt16(offset, Math.round(Math.max(-1, Math.min(1, left[i])) * 32767), true);
+    view.setInt16(offset + 2, Math.round(Math.max(-1, Math.min(1, right[i])) * 32767), true);
+    offset += 4;
+  }
+  return new Blob([view.buffer], { type: 'audio/wav' });
+}
@@ -0,0 +1,138 @@
+/**
+ * @file engineNode.ts
+ * @brief Any plugins/synths engine as an AudioWorkletNode
+ *
+ * `make engines` builds every engine the render tree has an adapter for
+ * (render/engines/render_<Plugin>.cpp) into public/engines/<Plugin>.simd.*,
+ * all with the same C exports, and public/engine-processor.js runs any of
+ * them. Parameters use the plugin's IDs and plain values, as in its
+ * createParameterLayout().
+ *
+ * Parameter automation (render/Automation.h's binary form) is loaded into
+ * the module whole and played there, and the module can record one: start
+ * with recordAutomation() and collect it with takeAutomation().
+ *
+ * The SST headers the engines use need SSE, which WASM only offers through
+ * SIMD128, so there is no scalar fallback: check canUseEngines() first.
+ */
+
+import { EventRingWriter, canUseEventRing, contextTimeToFrame } from './eventRing';
+import { fetchWasmNameMap } from './wasmGlue';
+import { loadWasmModule, supportsSimd } from './wasmModule';
+
+/** A row of the module's parameter table (render/EngineHost.h) */
+export interface EngineParamInfo {
+  id: number;
+  minValue: number;
+  maxValue: number;
+  defaultValue: number;
+  /** 0 = continuous, 1 = int / choice / bool */
+  interval: number;
+  skew: number;
+}
+
+export interface EngineNode {
+  node: AudioWorkletNode;
+  name: string;
+  params: Readonly<Record<string, EngineParamInfo>>;
+  setParam(id: string, value: number): void;
+  /** time is an AudioContext time; 0 = as soon as possible */
+  noteOn(note: number, velocity: number, time?: number): void;
+  noteOff(note: number, time?: number): void;
+  /** Play automation from the engine's current position (the bytes are transferred) */
+  loadAutomation(bytes: ArrayBuffer): void;
+  /** Record parameter changes into room for maxPoints breakpoints; 0 stops */
+  recordAutomation(maxPoints: number): void;
+  /** Stop recording; the take, or null if nothing moved */
+  takeAutomation(): Promise<ArrayBuffer | null>;
+}
+
+/** True when this browser can run the engine modules (WASM SIMD128) */
+export function canUseEngines(): boolean {
+  return supportsSimd();
+}
+
+const registered = new WeakSet<BaseAudioContext>();
+
+/** Load public/engines/<plugin>.simd.wasm and start it in a worklet on ctx */
+export async function createEngineNode(ctx: AudioContext, plugin: string): Promise<EngineNode> {
+  if (!canUseEngines()) throw new Error('Engine modules need WebAssembly SIMD128');
+
+  if (!registered.has(ctx)) {
+    await ctx.audioWorklet.addModule('/engine-processor.js');
+    registered.add(ctx);
+  }
+
+  const [wasm, wasmNames] = await Promise.all([
+    loadWasmModule(`engines/${plugin}`),
+    fetchWasmNameMap(`/engines/${plugin}.simd.js`),
+  ]);
+  if (!wasmNames) throw new Error(`Failed to load /engines/${plugin}.simd.js export names`);
+
+  const eventRing = canUseEventRing() ? new EventRingWriter({}) : null;
+  // Anything connected to the input is recorded by engines that take
+  // audio (TapeLoop as a tape loop effect); the others ignore it
+  const node = new AudioWorkletNode(ctx, 'engine-processor', {
+    numberOfInputs: 1,
+    numberOfOutputs: 1,
+    outputChannelCount: [2],
+  });
+
+  const ready = new Promise<{ name: string; eventRing: boolean; paramIds: Record<string, number>;
+                              params: Record<string, EngineParamInfo> }>((resolve, reject) => {
+    node.port.onmessage = (event) => {
+      if (event.data.type === 'ready') resolve(event.data);
+      else if (event.data.type === 'error') reject(new Error(event.data.message));
+    };
+  });
+
+  node.port.postMessage({
+    type: 'init',
+    wasmModule: wasm.module,
+    sampleRate: ctx.sampleRate,
+    eventRing: eventRing?.buffer ?? null,
+    wasmNames,
+  });
+
+  const info = await ready;
+  const ring = info.eventRing ? eventRing : null;
+  ring?.setParamIds(info.paramIds);
+
+  const toFrame = (time: number) => (time > 0 ? contextTimeToFrame(ctx, time) : 0);
+
+  // Takes come back in the order they were asked for
+  const takes: ((bytes: ArrayBuffer | null) => void)[] = [];
+  node.port.onmessage = (event) => {
+    if (event.data.type === 'automation') takes.shift()?.(event.data.bytes);
+  };
+
+  return {
+    node,
+    name: info.name,
+    params: info.params,
+    setParam(id, value) {
+      if (ring?.pushParam(id, value)) return;
+      node.port.postMessage({ type: 'param', name: id, value });
+    },
+    noteOn(note, velocity, time = 0) {
+      if (ring?.pushNoteOn(note, velocity, toFrame(time))) return;
+      node.port.postMessage({ type: 'noteOn', note, velocity });
+    },
+    noteOff(note, time = 0) {
+      if (ring?.pushNoteOff(note, toFrame(time))) return;
+      node.port.postMessage({ type: 'noteOff', note });
+    },
+    loadAutomation(bytes) {
+      node.port.postMessage({ type: 'loadAutomation', bytes }, [bytes]);
+    },
+    recordAutomation(maxPoints) {
+      node.port.postMessage({ type: 'recordAutomation', maxPoints });
+    },
+    takeAutomation() {
+      return new Promise((resolve) => {
+        takes.push(resolve);
+        node.port.postMessage({ type: 'takeAutomation' });
+      });
+    },
+  };
+}
@@ -0,0 +1,113 @@
+/**
+ * @file eventRing.ts
+ * @brief UI-side writer for the SharedArrayBuffer event ring
+ *
+ * Parameter changes and MIDI events go through a lock-free SPSC ring
+ * instead of port.postMessage, so automation doesn't queue up behind
+ * main-thread work. The worklet drains it before each render
+ * (public/event-ring.js) and forwards a batch to the WASM applyParams().
+ *
+ * Layout (keep in sync with public/event-ring.js):
+ *   Int32 [0]  write index (records, producer owned)
+ *   Int32 [1]  read index (records, consumer owned)
+ *   Int32 [2..3] reserved
+ *   Then CAPACITY records of [type, id, index, value (f32), time]
+ *
+ * For the multi-engine module the type word also names the engine:
+ * type = kind | engine << ENGINE_SHIFT. Single-engine modules use engine 0.
+ */
+
+export const EVENT_PARAM = 0;
+export const EVENT_NOTE_ON = 1;
+export const EVENT_NOTE_OFF = 2;
+
+/** Engine handle position in the type word (src/dsp/multi/wasm_bindings.cpp) */
+export const ENGINE_SHIFT = 8;
+
+const HEADER_WORDS = 4;
+const RECORD_WORDS = 5;
+
+/** Default ring size in records - several seconds of dense automation */
+const DEFAULT_CAPACITY = 1024;
+
+/** Param name to ID table; per-step params use `${name}_${step}` */
+export type ParamIdTable = Readonly<Record<string, number>>;
+
+/** True when the page is cross-origin isolated and can share memory */
+export function canUseEventRing(): boolean {
+  return typeof SharedArrayBuffer !== 'undefined' && globalThis.crossOriginIsolated === true;
+}
+
+export class EventRingWriter {
+  readonly buffer: SharedArrayBuffer;
+  private readonly i32: Int32Array;
+  private readonly f32: Float32Array;
+  private readonly capacity: number;
+
+  constructor(private paramIds: ParamIdTable, capacity: number = DEFAULT_CAPACITY) {
+    this.capacity = capacity;
+    this.buffer = new SharedArrayBuffer((HEADER_WORDS + capacity * RECORD_WORDS) * 4);
+    this.i32 = new Int32Array(this.buffer);
+    this.f32 = new Float32Array(this.buffer);
+  }
+
+  /**
+   * Replace the name to ID map, e.g. with the table the worklet read out
+   * of the WASM module once it was ready
+   */
+  setParamIds(paramIds: ParamIdTable): void {
+    this.paramIds = paramIds;
+  }
+
+  /**
+   * Queue a parameter change by UI name (e.g. 'tempo', 'seqPitch_3')
+   * @return false if the name is unknown or the ring is full
+   */
+  pushParam(name: string, value: number | boolean, time: number = 0, engine: number = 0): boolean {
+    let id = this.paramIds[name];
+    let index = 0;
+
+    if (id === undefined) {
+      const split = name.lastIndexOf('_');
+      if (split < 0) return false;
+      id = this.paramIds[name.slice(0, split)];
+      index = parseInt(name.slice(split + 1), 10);
+      if (id === undefined || Number.isNaN(index)) return false;
+    }
+
+    return this.push(EVENT_PARAM | (engine << ENGINE_SHIFT), id, index, Number(value), time);
+  }
+
+  /** Queue a note on; time is a context frame (0 = as soon as possible) */
+  pushNoteOn(note: number, velocity: number, time: number = 0, engine: number = 0): boolean {
+    return this.push(EVENT_NOTE_ON | (engine << ENGINE_SHIFT), note, 0, velocity, time);
+  }
+
+  /** Queue a note off; time is a context frame (0 = as soon as possible) */
+  pushNoteOff(note: number, time: number = 0, engine: number = 0): boolean {
+    return this.push(EVENT_NOTE_OFF | (engine << ENGINE_SHIFT), note, 0, 0, time);
+  }
+
+  private push(type: number, id: number, index: number, value: number, time: number): boolean {
+    const write = Atomics.load(this.i32, 0);
+    const next = write + 1 === this.capacity ? 0 : write + 1;
+    if (next === Atomics.load(this.i32, 1)) return false;  // Full
+
+    const dst = HEADER_WORDS + write * RECORD_WORDS;
+    this.i32[dst] = type;
+    this.i32[dst + 1] = id;
+    this.i32[dst + 2] = index;
+    this.f32[dst + 3] = value;
+    this.i32[dst + 4] = time | 0;
+
+    // Publish the record after its contents
+    Atomics.store(this.i32, 0, next);
+    return true;
+  }
+}
+
+/** Convert an AudioContext time (seconds) to a ring timestamp */
+export function contextTimeToFrame(ctx: BaseAudioContext, seconds: number): number {
+  // 0 is reserved for "as soon as possible"
+  return Math.max(1, Math.round(seconds * ctx.sampleRate)) | 0;
+}
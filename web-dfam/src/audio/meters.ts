@@ -0,0 +1,109 @@
+/**
+ * @file meters.ts
+ * @brief UI-side reader for the engine's meter tap
+ *
+ * The WASM engine computes peak/RMS, a decimated scope and the sequencer
+ * step after every render (src/dsp/Meters.h); the worklet copies that
+ * block into this SharedArrayBuffer (public/meter-tap.js). Read it once
+ * per requestAnimationFrame - nothing is posted from the audio thread.
+ *
+ * Layout (keep in sync with public/meter-tap.js):
+ *   Int32 [0]  sequence (odd while the worklet is copying)
+ *   Int32 [1..3] reserved
+ *   Then MeterBlock: blocks, scopeWrite, step, running,
+ *   peakL, peakR, rmsL, rmsR (Float32), scope[SCOPE_SIZE] (Float32)
+ */
+
+import { canUseEventRing } from './eventRing';
+
+const HEADER_WORDS = 4;
+const BLOCK_HEADER_WORDS = 8;
+
+/** MeterBlock::SCOPE_SIZE */
+export const SCOPE_SIZE = 512;
+
+/** Meters::SCOPE_DECIMATION: the scope runs at a quarter of the sample rate */
+export const SCOPE_DECIMATION = 4;
+
+/** Torn reads to retry before keeping the previous snapshot */
+const MAX_READ_ATTEMPTS = 4;
+
+export interface MeterSnapshot {
+  /** Renders metered so far; unchanged means the audio thread is idle */
+  blocks: number;
+  step: number;
+  running: boolean;
+  peakL: number;
+  peakR: number;
+  rmsL: number;
+  rmsR: number;
+  /** Mono scope, oldest sample first */
+  scope: Float32Array;
+}
+
+/** Same requirement as the event ring: a cross-origin isolated page */
+export function canUseMeterTap(): boolean {
+  return canUseEventRing();
+}
+
+export class MeterTapReader {
+  readonly buffer: SharedArrayBuffer;
+  private readonly i32: Int32Array;
+  private readonly copy: Int32Array;
+  private readonly copyF32: Float32Array;
+  private readonly snapshot: MeterSnapshot = {
+    blocks: 0,
+    step: 0,
+    running: false,
+    peakL: 0,
+    peakR: 0,
+    rmsL: 0,
+    rmsR: 0,
+    scope: new Float32Array(SCOPE_SIZE),
+  };
+
+  /** A new tap, or another reader of an existing one's buffer (a worker) */
+  constructor(buffer?: SharedArrayBuffer) {
+    const words = BLOCK_HEADER_WORDS + SCOPE_SIZE;
+    this.buffer = buffer ?? new SharedArrayBuffer((HEADER_WORDS + words) * 4);
+    this.i32 = new Int32Array(this.buffer);
+    this.copy = new Int32Array(words);
+    this.copyF32 = new Float32Array(this.copy.buffer);
+  }
+
+  /**
+   * The latest block. The returned object (and its scope array) is reused
+   * by the next read(); copy anything that must outlive the frame.
+   */
+  read(): MeterSnapshot {
+    for (let attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+      const before = Atomics.load(this.i32, 0);
+      if (before & 1) continue;
+      this.copy.set(this.i32.subarray(HEADER_WORDS, HEADER_WORDS + this.copy.length));
+      if (Atomics.load(this.i32, 0) === before) {
+        this.unpack();
+        break;
+      }
+    }
+    return this.snapshot;
+  }
+
+  private unpack(): void {
+    const c = this.copy;
+    const f = this.copyF32;
+    const s = this.snapshot;
+    s.blocks = c[0] >>> 0;
+    s.step = c[2];
+    s.running = c[3] !== 0;
+    s.peakL = f[4];
+    s.peakR = f[5];
+    s.rmsL = f[6];
+    s.rmsR = f[7];
+
+    // Unroll the ring so the scope reads oldest to newest
+    const write = c[1];
+    const tail = SCOPE_SIZE - write;
+    s.scope.set(f.subarray(BLOCK_HEADER_WORDS + write, BLOCK_HEADER_WORDS + SCOPE_SIZE), 0);
+    s.scope.set(f.subarray(BLOCK_HEADER_WORDS, BLOCK_HEADER_WORDS + write), tail);
+  }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file spectrum.ts
+ * @brief UI side of the spectrum worker (src/audio/spectrumWorker.ts)
+ *
+ * The FFTs run in a Web Worker that reads the meter tap itself, so
+ * neither the audio worklet nor the UI thread does any analysis. The UI
+ * just keeps the newest frame the worker posts and reads it on its own
+ * animation frame:
+ *
+ *   const spectrum = new SpectrumClient(meterTap.buffer, ctx.sampleRate);
+ *   const bands = spectrum.read();   // dB, low to high, or null so far
+ *   spectrum.terminate();
+ *
+ * Needs the meter tap, so a cross-origin isolated page.
+ */
+
+/** Bands posted per frame, log spaced from MIN_HZ to the scope's Nyquist */
+export const NUM_BANDS = 64;
+export const MIN_HZ = 20;
+export const FLOOR_DB = -100;
+export const FALL_DB_PER_SECOND = 48;
+
+export class SpectrumClient {
+  private readonly worker: Worker;
+  private bands: Float32Array | null = null;
+  private top = 0;
+
+  constructor(meters: SharedArrayBuffer, sampleRate: number, framesPerSecond = 30) {
+    this.worker = new Worker(new URL('./spectrumWorker.ts', import.meta.url), { type: 'module' });
+    this.worker.onmessage = (event: MessageEvent) => {
+      if (event.data.type === 'spectrum') {
+        this.bands = event.data.bands;
+        this.top = event.data.maxHz;
+      }
+    };
+    this.worker.postMessage({ type: 'start', meters, sampleRate, framesPerSecond });
+  }
+
+  /** The newest band levels in dB, or null before the first frame */
+  read(): Float32Array | null {
+    return this.bands;
+  }
+
+  /** Frequency of the top band's upper edge */
+  get maxHz(): number {
+    return this.top;
+  }
+
+  terminate(): void {
+    this.worker.postMessage({ type: 'stop' });
+    this.worker.terminate();
+  }
+}
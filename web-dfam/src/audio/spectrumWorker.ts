@@ -0,0 +1,106 @@
+/**
+ * @file spectrumWorker.ts
+ * @brief Web Worker: spectrum of the meter tap's scope, off the UI thread
+ *
+ * The browser counterpart of core/dsp/SpectrumAnalyzer.h. It reads the
+ * same shared meter block the UI does (src/audio/meters.ts) at the frame
+ * rate, Hann-windows the scope, FFTs it and posts NUM_BANDS log-spaced
+ * band levels in dB (relative to a full-scale sine) back as a transferred
+ * Float32Array. The scope is decimated, so the bands stop at its Nyquist.
+ *
+ * Messages in:  { type: 'start', meters, sampleRate, framesPerSecond }, { type: 'stop' }
+ * Messages out: { type: 'spectrum', bands: Float32Array, maxHz }
+ */
+
+import { MeterTapReader, SCOPE_DECIMATION, SCOPE_SIZE } from './meters';
+import { FALL_DB_PER_SECOND, FLOOR_DB, MIN_HZ, NUM_BANDS } from './spectrum';
+
+const hann = new Float32Array(SCOPE_SIZE);
+for (let i = 0; i < SCOPE_SIZE; i++) {
+  hann[i] = 0.5 - 0.5 * Math.cos((2 * Math.PI * i) / SCOPE_SIZE);
+}
+
+const re = new Float32Array(SCOPE_SIZE);
+const im = new Float32Array(SCOPE_SIZE);
+const levels = new Float32Array(NUM_BANDS).fill(FLOOR_DB);
+
+/** In-place radix-2 complex FFT, unscaled */
+function fft(real: Float32Array, imag: Float32Array): void {
+  const n = real.length;
+  for (let i = 1, j = 0; i < n; i++) {
+    let bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      [real[i], real[j]] = [real[j], real[i]];
+      [imag[i], imag[j]] = [imag[j], imag[i]];
+    }
+  }
+  for (let half = 1; half < n; half <<= 1) {
+    const step = -Math.PI / half;
+    for (let k = 0; k < half; k++) {
+      const wr = Math.cos(step * k);
+      const wi = Math.sin(step * k);
+      for (let a = k; a < n; a += 2 * half) {
+        const b = a + half;
+        const tr = real[b] * wr - imag[b] * wi;
+        const ti = real[b] * wi + imag[b] * wr;
+        real[b] = real[a] - tr;
+        imag[b] = imag[a] - ti;
+        real[a] += tr;
+        imag[a] += ti;
+      }
+    }
+  }
+}
+
+let timer = 0;
+
+function start(meters: SharedArrayBuffer, sampleRate: number, framesPerSecond: number): void {
+  const tap = new MeterTapReader(meters);
+  const scopeRate = sampleRate / SCOPE_DECIMATION;
+  const maxHz = scopeRate / 2;
+  const binHz = scopeRate / SCOPE_SIZE;
+  const fall = FALL_DB_PER_SECOND / framesPerSecond;
+  let lastBlocks = -1;
+
+  timer = setInterval(() => {
+    const snapshot = tap.read();
+    if (snapshot.blocks === lastBlocks) return;  // Audio idle: keep the last frame
+    lastBlocks = snapshot.blocks;
+
+    for (let i = 0; i < SCOPE_SIZE; i++) {
+      re[i] = snapshot.scope[i] * hann[i];
+      im[i] = 0;
+    }
+    fft(re, im);
+
+    // Loudest bin in each band; bands narrower than a bin take the nearest
+    const bands = new Float32Array(NUM_BANDS);
+    const scale = 4 / SCOPE_SIZE;  // A full-scale sine peaks at SCOPE_SIZE / 4
+    for (let b = 0; b < NUM_BANDS; b++) {
+      const low = MIN_HZ * Math.pow(maxHz / MIN_HZ, b / NUM_BANDS);
+      const high = MIN_HZ * Math.pow(maxHz / MIN_HZ, (b + 1) / NUM_BANDS);
+      const first = Math.min(Math.round(low / binHz), SCOPE_SIZE / 2);
+      const last = Math.max(first, Math.min(Math.floor(high / binHz), SCOPE_SIZE / 2));
+      let level = 0;
+      for (let k = first; k <= last; k++) {
+        level = Math.max(level, scale * Math.hypot(re[k], im[k]));
+      }
+      const db = level > 0 ? Math.max(FLOOR_DB, 20 * Math.log10(level)) : FLOOR_DB;
+      levels[b] = Math.max(db, levels[b] - fall, FLOOR_DB);
+      bands[b] = levels[b];
+    }
+    self.postMessage({ type: 'spectrum', bands, maxHz }, { transfer: [bands.buffer] });
+  }, 1000 / framesPerSecond) as unknown as number;
+}
+
+self.onmessage = (event: MessageEvent) => {
+  const data = event.data;
+  if (data.type === 'start') {
+    clearInterval(timer);
+    start(data.meters, data.sampleRate, data.framesPerSecond);
+  } else if (data.type === 'stop') {
+    clearInterval(timer);
+  }
+};
@@ -0,0 +1,53 @@
+/**
+ * @file wasmGlue.ts
+ * @brief Read minified WASM import/export names from Emscripten glue
+ *
+ * The worklets instantiate the raw .wasm themselves (the glue can't run in
+ * AudioWorkletGlobalScope), but an -O3 build minifies every import and
+ * export name and the letters shift whenever the export list changes. The
+ * glue still spells out the mapping, so the main thread reads it from
+ * there and sends it along with the binary.
+ */
+
+export interface WasmNameMap {
+  /** C export name (no leading underscore) -> minified export */
+  exports: Record<string, string>;
+  /** Minified import key -> runtime function name (e.g. '_abort') */
+  imports: Record<string, string>;
+}
+
+export function parseWasmGlue(glue: string): WasmNameMap {
+  const exports: Record<string, string> = {};
+  const imports: Record<string, string> = {};
+
+  for (const m of glue.matchAll(/Module\["_(\w+)"\]=wasmExports\["(\w+)"\]/g)) {
+    exports[m[1]] = m[2];
+  }
+
+  const memory = glue.match(/wasmMemory=wasmExports\["(\w+)"\]/);
+  if (memory) exports.memory = memory[1];
+
+  const ctors = glue.match(/addOnInit\(wasmExports\["(\w+)"\]\)/);
+  if (ctors) exports.__wasm_call_ctors = ctors[1];
+
+  const importBlock = glue.match(/wasmImports=\{([^}]*)\}/);
+  if (importBlock) {
+    for (const entry of importBlock[1].split(',')) {
+      const [key, name] = entry.split(':');
+      if (key && name) imports[key.trim()] = name.trim();
+    }
+  }
+
+  return { exports, imports };
+}
+
+/** Fetch and parse a glue file; null if it can't be loaded */
+export async function fetchWasmNameMap(url: string): Promise<WasmNameMap | null> {
+  try {
+    const response = await fetch(url);
+    if (!response.ok) return null;
+    return parseWasmGlue(await response.text());
+  } catch {
+    return null;
+  }
+}
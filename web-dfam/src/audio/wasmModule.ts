@@ -0,0 +1,118 @@
+/**
+ * @file wasmModule.ts
+ * @brief Compile the worklet's WASM on the main thread, streaming and cached
+ *
+ * The worklets used to receive raw bytes and run WebAssembly.compile on
+ * the audio thread at every page load. Instead the main thread picks the
+ * SIMD128 or scalar build, compiles it with compileStreaming while it
+ * downloads, and posts the WebAssembly.Module to the worklet, which only
+ * instantiates it.
+ *
+ * Compiled modules are kept in IndexedDB, keyed by URL and the server's
+ * ETag / Last-Modified, so a reload skips compilation entirely. Browsers
+ * that refuse to store a Module (DataCloneError) still benefit from their
+ * own code cache for compileStreaming responses.
+ */
+
+/** Smallest module using SIMD128 (i8x16.popcnt), for feature detection */
+const SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11,
+]);
+
+const DB_NAME = 'autosynth-wasm';
+const STORE_NAME = 'modules';
+
+export interface CompiledWasm {
+  module: WebAssembly.Module;
+  simd: boolean;
+  /** Came out of IndexedDB without compiling */
+  cached: boolean;
+}
+
+export function supportsSimd(): boolean {
+  return WebAssembly.validate(SIMD_PROBE);
+}
+
+function openCache(): Promise<IDBDatabase | null> {
+  if (typeof indexedDB === 'undefined') return Promise.resolve(null);
+  return new Promise((resolve) => {
+    const request = indexedDB.open(DB_NAME, 1);
+    request.onupgradeneeded = () => request.result.createObjectStore(STORE_NAME);
+    request.onsuccess = () => resolve(request.result);
+    request.onerror = () => resolve(null);
+  });
+}
+
+function cacheGet(db: IDBDatabase, key: string): Promise<WebAssembly.Module | null> {
+  return new Promise((resolve) => {
+    const request = db.transaction(STORE_NAME).objectStore(STORE_NAME).get(key);
+    request.onsuccess = () => resolve(request.result instanceof WebAssembly.Module ? request.result : null);
+    request.onerror = () => resolve(null);
+  });
+}
+
+/** Store the module under key, dropping older versions of the same URL */
+function cachePut(db: IDBDatabase, key: string, module: WebAssembly.Module): void {
+  try {
+    const store = db.transaction(STORE_NAME, 'readwrite').objectStore(STORE_NAME);
+    const prefix = key.slice(0, key.indexOf('#') + 1);
+    store.openCursor().onsuccess = (event) => {
+      const cursor = (event.target as IDBRequest<IDBCursorWithValue | null>).result;
+      if (!cursor) return;
+      if (String(cursor.key).startsWith(prefix) && cursor.key !== key) cursor.delete();
+      cursor.continue();
+    };
+    store.put(module, key);
+  } catch {
+    // Module storage unsupported (DataCloneError); rely on the browser's code cache
+  }
+}
+
+/** URL plus the server's version of it, or null if the file isn't there */
+async function versionKey(url: string): Promise<string | null> {
+  try {
+    const response = await fetch(url, { method: 'HEAD', cache: 'no-cache' });
+    if (!response.ok) return null;
+    const version = response.headers.get('ETag') ?? response.headers.get('Last-Modified') ?? '';
+    return `${url}#${version}`;
+  } catch {
+    return null;
+  }
+}
+
+async function compile(url: string): Promise<WebAssembly.Module> {
+  if (WebAssembly.compileStreaming) {
+    try {
+      return await WebAssembly.compileStreaming(fetch(url));
+    } catch {
+      // Served without application/wasm; compile from the bytes instead
+    }
+  }
+  const response = await fetch(url);
+  if (!response.ok) throw new Error(`Failed to fetch ${url}: ${response.status}`);
+  return WebAssembly.compile(await response.arrayBuffer());
+}
+
+/**
+ * The compiled module for `name` (e.g. 'dfam' -> /dfam.simd.wasm or
+ * /dfam.wasm), from the cache when the file hasn't changed
+ */
+export async function loadWasmModule(name: string): Promise<CompiledWasm> {
+  let simd = supportsSimd();
+  let key = simd ? await versionKey(`/${name}.simd.wasm`) : null;
+  if (!key) {
+    simd = false;
+    key = await versionKey(`/${name}.wasm`);
+  }
+  const url = simd ? `/${name}.simd.wasm` : `/${name}.wasm`;
+
+  const db = await openCache();
+  if (db && key) {
+    const module = await cacheGet(db, key);
+    if (module) return { module, simd, cached: true };
+  }
+
+  const module = await compile(url);
+  if (db && key) cachePut(db, key, module);
+  return { module, simd, cached: false };
+}
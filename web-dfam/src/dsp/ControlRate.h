@@ -0,0 +1,54 @@
+/**
+ * @file ControlRate.h
+ * @brief Control-rate modulation: run modulators once per block, ramp what they drive
+ *
+ * Same interface as the plugins' ControlRate.h, which wraps sst-basic-blocks'
+ * lipol. The web build has core/dsp but not the sst libraries (see
+ * Makefile and Dockerfile), so the ramp is written out here.
+ *
+ * Voices step their slower modulators once per ControlRamp::BLOCK_SIZE
+ * samples and ramp the targets (pitch ratio, filter coefficient) linearly
+ * across the block. Each ramp lands exactly on the block-end value, so there
+ * are no steps, and the modulation lags by at most one block.
+ */
+
+#pragma once
+
+class ControlRamp {
+public:
+    /** Samples per control block */
+    static constexpr int BLOCK_SIZE = 32;
+
+    /** Jump straight to value (note on, voice reset) */
+    void reset(float value) noexcept {
+        value_ = value;
+        target = value;
+        increment = 0.0f;
+    }
+
+    /**
+     * @brief Ramp from the previous target to target over the next n samples
+     *
+     * Call once per control block, after the previous block's n next() calls.
+     */
+    void setTarget(float newTarget, int n = BLOCK_SIZE) noexcept {
+        value_ = target;
+        target = newTarget;
+        increment = (target - value_) / static_cast<float>(n);
+    }
+
+    /** Value for this sample, then step towards the target */
+    float next() noexcept {
+        const float value = value_;
+        value_ += increment;
+        return value;
+    }
+
+    float getValue() const noexcept { return value_; }
+    float getTarget() const noexcept { return target; }
+
+private:
+    float value_ = 0.0f;
+    float target = 0.0f;
+    float increment = 0.0f;
+};
@@ -0,0 +1,72 @@
+/**
+ * @file FixedBlockRenderer.h
+ * @brief Serve any process() size from an engine that renders whole blocks
+ *
+ * The engines' inner loops run in ControlRamp::BLOCK_SIZE spans; a caller
+ * asking for 128 frames (today's render quantum), 441 (a native wrapper)
+ * or anything else shouldn't break those spans up or need a different
+ * prepare(). process() hands the engine only multiples of BLOCK: whole
+ * blocks go straight into the caller's buffer, and a ragged tail is taken
+ * from one block rendered into a small FIFO, whose rest starts the next
+ * call. Nothing is allocated and no latency is added: the FIFO only ever
+ * holds audio rendered ahead of time, never behind it.
+ *
+ * Events applied before a call land up to BLOCK - 1 frames later than
+ * they would without the FIFO, when a previous call left some audio in
+ * it. Callers that always ask for multiples of BLOCK never see that.
+ *
+ *   FixedBlockRenderer<ControlRamp::BLOCK_SIZE> blocks;
+ *   blocks.process(outL, outR, numSamples, [&](float* l, float* r, int n) {
+ *       engine.renderBlock(l, r, n);    // n is a multiple of BLOCK
+ *   });
+ */
+
+#pragma once
+
+#include <algorithm>
+
+template <int BLOCK>
+class FixedBlockRenderer {
+public:
+    static_assert(BLOCK > 0, "Block size must be positive");
+
+    template <typename Render>
+    void process(float* outputL, float* outputR, int numSamples, Render&& render) {
+        int done = 0;
+
+        // Audio left over from the last call's tail block
+        if (readPos < BLOCK) {
+            const int n = std::min(BLOCK - readPos, numSamples);
+            std::copy(fifoL + readPos, fifoL + readPos + n, outputL);
+            std::copy(fifoR + readPos, fifoR + readPos + n, outputR);
+            readPos += n;
+            done = n;
+        }
+
+        // Whole blocks straight into the output
+        const int whole = (numSamples - done) / BLOCK * BLOCK;
+        if (whole > 0) {
+            render(outputL + done, outputR + done, whole);
+            done += whole;
+        }
+
+        // The tail: render one more block and keep what isn't used
+        if (done < numSamples) {
+            render(fifoL, fifoR, BLOCK);
+            readPos = numSamples - done;
+            std::copy(fifoL, fifoL + readPos, outputL + done);
+            std::copy(fifoR, fifoR + readPos, outputR + done);
+        }
+    }
+
+    // Drop buffered audio (after a reset or re-prepare)
+    void reset() { readPos = BLOCK; }
+
+    // Frames rendered ahead and waiting in the FIFO
+    int getBuffered() const { return BLOCK - readPos; }
+
+private:
+    float fifoL[BLOCK] = {};
+    float fifoR[BLOCK] = {};
+    int readPos = BLOCK;  // BLOCK = empty
+};
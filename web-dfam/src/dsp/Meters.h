@@ -0,0 +1,108 @@
+/**
+ * @file Meters.h
+ * @brief Peak/RMS meters, a decimated scope and sequencer state for the UI
+ *
+ * The engine fills a MeterBlock after every process() call: a flat run of
+ * 32-bit words at a fixed address in WASM memory, so the worklet can copy
+ * it into a SharedArrayBuffer in one set() (public/meter-tap.js) and the
+ * UI can read it on requestAnimationFrame (src/audio/meters.ts). Nothing
+ * is posted from the audio thread and nothing here allocates.
+ *
+ * Peaks fall back at PEAK_FALLOFF_DB per second after a hit, like a VU
+ * peak meter; RMS is a one-pole average of the squared signal. The scope
+ * keeps the last SCOPE_SIZE mono samples at SCOPE_DECIMATION : 1 (about
+ * 46 ms at 44.1 kHz), oldest at scopeWrite.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Word layout shared with public/meter-tap.js and src/audio/meters.ts
+struct MeterBlock {
+    static constexpr int HEADER_WORDS = 8;
+    static constexpr int SCOPE_SIZE = 512;
+
+    uint32_t blocks = 0;    // process() calls metered so far (wraps)
+    int32_t scopeWrite = 0; // Next scope slot to write = oldest sample
+    int32_t step = 0;       // Sequencer step
+    int32_t running = 0;    // Sequencer running (0/1)
+    float peakL = 0.0f;     // Linear, with falloff
+    float peakR = 0.0f;
+    float rmsL = 0.0f;      // Linear
+    float rmsR = 0.0f;
+    float scope[SCOPE_SIZE] = {};
+};
+
+static_assert(sizeof(MeterBlock) == (MeterBlock::HEADER_WORDS + MeterBlock::SCOPE_SIZE) * 4,
+              "MeterBlock must stay a flat run of 32-bit words");
+
+class Meters {
+public:
+    static constexpr int SCOPE_DECIMATION = 4;
+    static constexpr float PEAK_FALLOFF_DB = 20.0f;  // Per second
+    static constexpr float RMS_TIME = 0.3f;          // Seconds
+
+    void prepare(double sampleRate) {
+        sr = static_cast<float>(sampleRate);
+        block = MeterBlock{};
+        meanSquareL = meanSquareR = 0.0f;
+        decimSum = 0.0f;
+        decimCount = 0;
+    }
+
+    // Meter one rendered span (any length)
+    void process(const float* left, const float* right, int numSamples) {
+        if (numSamples <= 0) return;
+
+        float peakL = 0.0f, peakR = 0.0f;
+        float sumL = 0.0f, sumR = 0.0f;
+        for (int i = 0; i < numSamples; ++i) {
+            const float l = left[i];
+            const float r = right[i];
+            peakL = std::max(peakL, std::fabs(l));
+            peakR = std::max(peakR, std::fabs(r));
+            sumL += l * l;
+            sumR += r * r;
+
+            decimSum += l + r;
+            if (++decimCount == SCOPE_DECIMATION) {
+                block.scope[block.scopeWrite] = decimSum * (0.5f / SCOPE_DECIMATION);
+                block.scopeWrite = (block.scopeWrite + 1) % MeterBlock::SCOPE_SIZE;
+                decimSum = 0.0f;
+                decimCount = 0;
+            }
+        }
+
+        const float seconds = numSamples / sr;
+        const float falloff = std::pow(10.0f, -PEAK_FALLOFF_DB * seconds / 20.0f);
+        block.peakL = std::max(peakL, block.peakL * falloff);
+        block.peakR = std::max(peakR, block.peakR * falloff);
+
+        // One-pole on the span's mean square, time-constant independent of span length
+        const float keep = std::exp(-seconds / RMS_TIME);
+        meanSquareL = sumL / numSamples + keep * (meanSquareL - sumL / numSamples);
+        meanSquareR = sumR / numSamples + keep * (meanSquareR - sumR / numSamples);
+        block.rmsL = std::sqrt(meanSquareL);
+        block.rmsR = std::sqrt(meanSquareR);
+
+        ++block.blocks;
+    }
+
+    void setSequencer(int step, bool running) {
+        block.step = step;
+        block.running = running ? 1 : 0;
+    }
+
+    const MeterBlock& getBlock() const { return block; }
+
+private:
+    MeterBlock block;
+    float sr = 44100.0f;
+    float meanSquareL = 0.0f;
+    float meanSquareR = 0.0f;
+    float decimSum = 0.0f;
+    int decimCount = 0;
+};
@@ -4,14 +4,43 @@
  *
  * A percussion synthesizer inspired by the Moog DFAM.
  * No JUCE or SST dependencies - compatible with Emscripten.
+ *
+ * The pitch envelope and filter cutoff run at control rate (ControlRate.h);
+ * the VCF/VCA envelope stays per sample because it is the VCA.
+ *
+ * setQualityTier() (QualityTier.h) sets that control block: 64 samples in
+ * draft, 8 in high. High also band-limits the saw and square with polyBLEP
+ * from the next trigger, which restarts the VCOs anyway; draft's ladder
+ * filter swaps tanh for a rational approximation.
+ *
+ * The delay and reverb lines come from an Arena (Arena.h): memoryNeeded()
+ * gives the floats an engine takes at a sample rate, and prepare() either
+ * takes them from the caller's arena or allocates them once itself.
+ * Both keep half floats (SampleStorage.h), which halves the static arena
+ * dfam.wasm reserves; the plugin's lines stay float.
  */
 
 #pragma once
 
 #include <cmath>
-#include <random>
 #include <array>
 #include <algorithm>
+#include <vector>
+
+#include "ADEnvelope.h"
+#include "Arena.h"
+#include "ControlRate.h"
+#include "PerfStats.h"
+#include "PitchTables.h"
+#include "PolyBlepOscillator.h"
+#include "QualityTier.h"
+#include "SilenceGate.h"
+#include "StepClock.h"
+#include "Denormals.h"
+#include "FdnReverb.h"
+#include "LFO.h"
+#include "Noise.h"
+#include "StereoDelay.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -19,232 +48,44 @@
 
 namespace dfam {
 
-/**
- * @brief White noise generator
- */
-class NoiseGenerator {
-public:
-    float process() {
-        return distribution(generator);
-    }
-
-private:
-    std::mt19937 generator{std::random_device{}()};
-    std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
-};
-
-/**
- * @brief Simple LFO with multiple waveforms
- */
-class LFO {
-public:
-    enum Waveform { SINE, TRIANGLE, SAW, SQUARE };
-
-    void prepare(double sr) {
-        sampleRate = sr;
-        phase = 0.0;
-        updatePhaseIncrement();
-    }
-
-    void setRate(float hz) {
-        rate = std::clamp(hz, 0.01f, 20.0f);
-        updatePhaseIncrement();
-    }
-
-    void setClockSyncRate(float bpm, float divider) {
-        float beatsPerSecond = bpm / 60.0f;
-        float cyclesPerSecond = beatsPerSecond * divider;
-        phaseIncrement = cyclesPerSecond / sampleRate;
-    }
-
-    void setWaveform(Waveform w) { waveform = w; }
-    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
-
-    float getValue() const {
-        return computeValue(phase);
-    }
-
-    float process() {
-        float output = computeValue(phase);
-        phase += phaseIncrement;
-        if (phase >= 1.0) phase -= 1.0;
-        return output;
-    }
-
-    void reset() { phase = 0.0; }
-
-private:
-    void updatePhaseIncrement() {
-        phaseIncrement = rate / sampleRate;
-    }
-
-    float computeValue(double p) const {
-        switch (waveform) {
-            case SINE:
-                return std::sin(2.0f * static_cast<float>(M_PI) * static_cast<float>(p));
-            case TRIANGLE:
-                return 4.0f * std::abs(static_cast<float>(p) - 0.5f) - 1.0f;
-            case SAW:
-                return 2.0f * static_cast<float>(p) - 1.0f;
-            case SQUARE:
-                return p < 0.5 ? 1.0f : -1.0f;
-            default:
-                return 0.0f;
-        }
-    }
-
-    double sampleRate = 44100.0;
-    double phase = 0.0;
-    double phaseIncrement = 0.0;
-    float rate = 1.0f;
-    Waveform waveform = SINE;
-};
-
-/**
- * @brief Oscillator with multiple waveforms
- */
-class Oscillator {
-public:
-    enum Waveform { SAW, SQUARE, TRIANGLE, SINE };
-
-    void prepare(double sr) {
-        sampleRate = sr;
-        phase = 0.0;
-    }
-
-    void setFrequency(float freq) {
-        frequency = std::clamp(freq, 20.0f, 20000.0f);
-        phaseIncrement = frequency / sampleRate;
-    }
-
-    void setWaveform(Waveform w) { waveform = w; }
-    void setWaveform(int w) { waveform = static_cast<Waveform>(std::clamp(w, 0, 3)); }
-
-    void resetPhase() { phase = 0.0; }
-
-    float process() {
-        float output = 0.0f;
-
-        switch (waveform) {
-            case SAW:
-                output = 2.0f * static_cast<float>(phase) - 1.0f;
-                break;
-            case SQUARE:
-                output = phase < 0.5 ? 1.0f : -1.0f;
-                break;
-            case TRIANGLE:
-                output = 4.0f * std::abs(static_cast<float>(phase) - 0.5f) - 1.0f;
-                break;
-            case SINE:
-                output = std::sin(2.0f * static_cast<float>(M_PI) * static_cast<float>(phase));
-                break;
-        }
-
-        phase += phaseIncrement;
-        if (phase >= 1.0) phase -= 1.0;
-
-        return output;
-    }
-
-private:
-    double sampleRate = 44100.0;
-    double phase = 0.0;
-    double phaseIncrement = 0.0;
-    float frequency = 440.0f;
-    Waveform waveform = SAW;
-};
-
-/**
- * @brief AD (Attack/Decay) envelope with exponential curves
- */
-class ADEnvelope {
-public:
-    enum Stage { IDLE, ATTACK, DECAY };
-
-    void prepare(double sr) {
-        sampleRate = sr;
-        updateCoefficients();
-    }
-
-    void setAttack(float seconds) {
-        attackTime = std::max(0.001f, seconds);
-        updateCoefficients();
-    }
-
-    void setDecay(float seconds) {
-        decayTime = std::max(0.001f, seconds);
-        updateCoefficients();
-    }
-
-    void trigger() {
-        stage = ATTACK;
-        if (value < 0.001f) value = 0.0f;
-    }
-
-    float process() {
-        switch (stage) {
-            case ATTACK:
-                value += attackCoef * (1.0f - value);
-                if (value >= 0.999f) {
-                    value = 1.0f;
-                    stage = DECAY;
-                }
-                break;
-
-            case DECAY:
-                value *= decayCoef;
-                if (value <= 0.001f) {
-                    value = 0.0f;
-                    stage = IDLE;
-                }
-                break;
-
-            case IDLE:
-            default:
-                break;
-        }
-        return value;
-    }
-
-    bool isActive() const { return stage != IDLE; }
-
-private:
-    void updateCoefficients() {
-        float attackSamples = attackTime * static_cast<float>(sampleRate);
-        attackCoef = 1.0f - std::exp(-4.0f / attackSamples);
-
-        float decaySamples = decayTime * static_cast<float>(sampleRate);
-        decayCoef = std::exp(-4.0f / decaySamples);
-    }
-
-    double sampleRate = 44100.0;
-    float attackTime = 0.01f;
-    float decayTime = 0.5f;
-    float attackCoef = 0.001f;
-    float decayCoef = 0.9999f;
-    float value = 0.0f;
-    Stage stage = IDLE;
-};
-
 /**
  * @brief Simple ladder filter (LP/HP)
+ *
+ * Each stage is stage += g * (tanh(in) - tanh(stage)). A stage's tanh after
+ * its update is both the next stage's input tanh and its own for the next
+ * sample, so it is evaluated once and kept: five tanh a sample instead of
+ * eight, with the same arithmetic. The stages depend on each other within
+ * the sample, so there is nothing to spread across SIMD lanes.
+ *
+ * RATIONAL swaps std::tanh for a [7/6] Pade approximant (the one in
+ * sst-basic-blocks' FastMath.h, which this build doesn't include): a few
+ * multiplies and one divide, within 1e-4 of tanh up to where it's clamped.
  */
 class LadderFilter {
 public:
     enum Mode { LOWPASS, HIGHPASS };
+    enum Accuracy { EXACT, RATIONAL };
 
     void prepare(double sr) {
         sampleRate = sr;
+        gRamp.reset(computeG());
         reset();
     }
 
     void reset() {
-        for (int i = 0; i < 4; ++i) stage[i] = 0.0f;
+        for (int i = 0; i < 4; ++i) stage[i] = tanhStage[i] = 0.0f;
     }
 
+    // Jump straight to freq
     void setCutoff(float freq) {
         cutoff = std::clamp(freq, 20.0f, 20000.0f);
-        updateCoefficients();
+        gRamp.reset(computeG());
+    }
+
+    // Glide to freq over the next n process() calls (control rate)
+    void glideCutoff(float freq, int n) {
+        cutoff = std::clamp(freq, 20.0f, 20000.0f);
+        gRamp.setTarget(computeG(), n);
     }
 
     void setResonance(float res) {
@@ -254,13 +95,41 @@ public:
     void setMode(Mode m) { mode = m; }
     void setMode(int m) { mode = static_cast<Mode>(std::clamp(m, 0, 1)); }
 
+    // The stages carry over; their kept tanh is redone with the new function
+    void setAccuracy(Accuracy a) {
+        if (a == accuracy) return;
+        accuracy = a;
+        for (int i = 0; i < 4; ++i)
+            tanhStage[i] = accuracy == RATIONAL ? rationalTanh(stage[i]) : std::tanh(stage[i]);
+    }
+
+    Accuracy getAccuracy() const { return accuracy; }
+
     float process(float input) {
+        return accuracy == RATIONAL ? processStages<true>(input) : processStages<false>(input);
+    }
+
+    // tanh to within 1e-4, exactly +-1 from |x| = 4.97
+    static float rationalTanh(float x) {
+        x = std::clamp(x, -4.97f, 4.97f);
+        const float x2 = x * x;
+        const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+        const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2));
+        return std::clamp(num / den, -1.0f, 1.0f);
+    }
+
+private:
+    template <bool RATIONAL_TANH>
+    float processStages(float input) {
+        const auto saturate = [](float x) { return RATIONAL_TANH ? rationalTanh(x) : std::tanh(x); };
+
+        const float g = gRamp.next();
         float feedback = resonance * 4.0f * (stage[3] - 0.5f * input);
-        float x = input - feedback;
+        float tanhIn = saturate(input - feedback + Denormals::BIAS);  // Keeps the stages out of denormals
 
         for (int i = 0; i < 4; ++i) {
-            stage[i] += g * (std::tanh(x) - std::tanh(stage[i]));
-            x = stage[i];
+            stage[i] += g * (tanhIn - tanhStage[i]);
+            tanhStage[i] = tanhIn = saturate(stage[i]);
         }
 
         if (mode == HIGHPASS)
@@ -268,19 +137,20 @@ public:
         return stage[3];
     }
 
-private:
-    void updateCoefficients() {
+    float computeG() const {
         float fc = cutoff / static_cast<float>(sampleRate);
-        g = std::tan(static_cast<float>(M_PI) * std::min(fc, 0.49f));
-        g = g / (1.0f + g);
+        float g = std::tan(static_cast<float>(M_PI) * std::min(fc, 0.49f));
+        return g / (1.0f + g);
     }
 
     double sampleRate = 44100.0;
     float cutoff = 5000.0f;
     float resonance = 0.0f;
-    float g = 0.0f;
+    ControlRamp gRamp;  // One-pole coefficient, linear between control blocks
     float stage[4] = {0, 0, 0, 0};
+    float tanhStage[4] = {0, 0, 0, 0};  // tanh (or its approximant) of each stage
     Mode mode = LOWPASS;
+    Accuracy accuracy = EXACT;
 };
 
 /**
@@ -302,140 +172,19 @@ private:
 };
 
 /**
- * @brief Stereo delay with tempo sync
- */
-class StereoDelay {
-public:
-    void prepare(double sr) {
-        sampleRate = sr;
-        bufferSize = static_cast<size_t>(sr * 4.0);
-        bufferL.resize(bufferSize, 0.0f);
-        bufferR.resize(bufferSize, 0.0f);
-        writePos = 0;
-    }
-
-    void setTime(float seconds) {
-        delaySamples = static_cast<size_t>(std::clamp(seconds, 0.001f, 4.0f) * sampleRate);
-        if (delaySamples >= bufferSize) delaySamples = bufferSize - 1;
-    }
-
-    void setClockSyncTime(float bpm, float divider) {
-        float secondsPerBeat = 60.0f / bpm;
-        float syncedTime = secondsPerBeat / divider;
-        setTime(syncedTime);
-    }
-
-    void setFeedback(float fb) { feedback = std::clamp(fb, 0.0f, 0.95f); }
-    void setMix(float m) { mix = std::clamp(m, 0.0f, 1.0f); }
-
-    void process(float& left, float& right) {
-        size_t readPos = (writePos + bufferSize - delaySamples) % bufferSize;
-
-        float delayedL = bufferL[readPos];
-        float delayedR = bufferR[readPos];
-
-        bufferL[writePos] = left + delayedL * feedback;
-        bufferR[writePos] = right + delayedR * feedback;
-
-        left = left * (1.0f - mix) + delayedL * mix;
-        right = right * (1.0f - mix) + delayedR * mix;
-
-        writePos = (writePos + 1) % bufferSize;
-    }
-
-private:
-    double sampleRate = 44100.0;
-    std::vector<float> bufferL;
-    std::vector<float> bufferR;
-    size_t bufferSize = 176400;
-    size_t writePos = 0;
-    size_t delaySamples = 22050;
-    float feedback = 0.3f;
-    float mix = 0.0f;
-};
-
-/**
- * @brief Simple Schroeder reverb
+ * @brief The shared FDN reverb (FdnReverb.h) with DFAM's mix curve
+ *
+ * The plugin's DFAM runs sst-effects' Reverb2 by default (SSTEffect.h);
+ * the web build doesn't vendor sst, so it runs the FDN the plugin offers
+ * as its other reverb engine.
  */
-class Reverb {
+class Reverb : public BasicFdnReverb<SampleStorage::Float16> {
 public:
-    void prepare(double sr) {
-        sampleRate = sr;
-
-        for (int i = 0; i < 4; ++i) {
-            apDelays[i].resize(static_cast<size_t>(sr * apTimes[i]), 0.0f);
-            apPos[i] = 0;
-        }
-
-        for (int i = 0; i < 8; ++i) {
-            combDelays[i].resize(static_cast<size_t>(sr * combTimes[i]), 0.0f);
-            combPos[i] = 0;
-            combFilters[i] = 0.0f;
-        }
-    }
-
-    void setDecay(float d) { decay = std::clamp(d, 0.1f, 10.0f); }
-    void setDamping(float d) { damping = std::clamp(d, 0.0f, 1.0f); }
-
+    // 4th power curve for a very gradual onset, as the plugin's reverb mix
     void setMix(float m) {
         float linear = std::clamp(m, 0.0f, 1.0f);
-        mix = linear * linear * linear * linear;
+        BasicFdnReverb::setMix(linear * linear * linear * linear);
     }
-
-    void process(float& left, float& right) {
-        float input = (left + right) * 0.5f;
-
-        float diffused = input;
-        for (int i = 0; i < 4; ++i)
-            diffused = processAllpass(i, diffused);
-
-        float reverbL = 0.0f;
-        float reverbR = 0.0f;
-        float combGain = std::pow(0.001f, 1.0f / (decay * static_cast<float>(sampleRate)));
-
-        for (int i = 0; i < 4; ++i)
-            reverbL += processComb(i, diffused, combGain);
-        for (int i = 4; i < 8; ++i)
-            reverbR += processComb(i, diffused, combGain);
-
-        reverbL *= 0.25f;
-        reverbR *= 0.25f;
-
-        left = left * (1.0f - mix) + reverbL * mix;
-        right = right * (1.0f - mix) + reverbR * mix;
-    }
-
-private:
-    float processAllpass(int idx, float input) {
-        float delayed = apDelays[idx][apPos[idx]];
-        float output = -input + delayed;
-        apDelays[idx][apPos[idx]] = input + delayed * 0.5f;
-        apPos[idx] = (apPos[idx] + 1) % apDelays[idx].size();
-        return output;
-    }
-
-    float processComb(int idx, float input, float gain) {
-        float delayed = combDelays[idx][combPos[idx]];
-        combFilters[idx] = delayed * (1.0f - damping) + combFilters[idx] * damping;
-        combDelays[idx][combPos[idx]] = input + combFilters[idx] * gain;
-        combPos[idx] = (combPos[idx] + 1) % combDelays[idx].size();
-        return delayed;
-    }
-
-    double sampleRate = 44100.0;
-    float decay = 2.0f;
-    float mix = 0.0f;
-    float damping = 0.5f;
-
-    float apTimes[4] = {0.0051f, 0.0076f, 0.01f, 0.0123f};
-    std::vector<float> apDelays[4];
-    size_t apPos[4] = {0, 0, 0, 0};
-
-    float combTimes[8] = {0.0297f, 0.0371f, 0.0411f, 0.0437f,
-                          0.0299f, 0.0373f, 0.0413f, 0.0439f};
-    std::vector<float> combDelays[8];
-    size_t combPos[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    float combFilters[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 };
 
 /**
@@ -443,24 +192,32 @@ private:
  */
 class Voice {
 public:
+    // The longest control block (the draft tier's)
+    static constexpr int MAX_CONTROL_BLOCK = 2 * ControlRamp::BLOCK_SIZE;
+
     void prepare(double sr) {
         sampleRate = sr;
-        vco1.prepare(sr);
-        vco2.prepare(sr);
+        vco1.setSampleRate(static_cast<float>(sr));
+        vco2.setSampleRate(static_cast<float>(sr));
         filter.prepare(sr);
-        pitchEnv.prepare(sr);
-        vcfVcaEnv.prepare(sr);
+        pitchEnv.setSampleRate(sr);
+        vcfVcaEnv.setSampleRate(sr);
 
         pitchEnv.setAttack(0.001f);
         pitchEnv.setDecay(0.3f);
         vcfVcaEnv.setAttack(0.001f);
         vcfVcaEnv.setDecay(0.5f);
+
+        filter.setCutoff(filterCutoff);
+        pitchRamp.reset(PitchTables::get().semitonesToRatio(pitchOffset));
     }
 
     void trigger(float vel = 1.0f) {
         velocity = vel;
-        vco1.resetPhase();
-        vco2.resetPhase();
+        vco1.setBandLimited(bandLimited);
+        vco2.setBandLimited(bandLimited);
+        vco1.reset();
+        vco2.reset();
         pitchEnv.trigger();
         vcfVcaEnv.trigger();
         antiClickRamp = 0.0f;
@@ -468,53 +225,67 @@ public:
     }
 
     void render(float* outputL, float* outputR, int numSamples) {
-        for (int i = 0; i < numSamples; ++i) {
-            float pitchEnvValue = pitchEnv.process();
-            float vcfVcaEnvValue = vcfVcaEnv.process();
+        const PitchTables& pitch = PitchTables::get();
+
+        for (int start = 0; start < numSamples; start += controlBlock) {
+            const int n = std::min(numSamples - start, controlBlock);
+
+            // VCF/VCA envelope per sample (it's the VCA); its block-end
+            // value sets the cutoff target
+            float vcfVcaEnvValues[MAX_CONTROL_BLOCK];
+            for (int i = 0; i < n; ++i)
+                vcfVcaEnvValues[i] = vcfVcaEnv.process();
 
-            float vco1Freq = vco1BaseFreq * std::pow(2.0f, (pitchEnvValue * pitchEnvAmount + pitchOffset) / 12.0f);
-            float vco2Freq = vco2BaseFreq * std::pow(2.0f, (pitchEnvValue * pitchEnvAmount + pitchOffset) / 12.0f);
+            // Pitch envelope and cutoff once per block, ramped across it
+            // (same pitch offset for both VCOs)
+            pitchRamp.setTarget(pitch.semitonesToRatio(pitchEnv.advance(n) * pitchEnvAmount + pitchOffset), n);
+            filter.glideCutoff(filterCutoff + vcfVcaEnvValues[n - 1] * filterEnvAmount * 10000.0f, n);
 
-            vco1.setFrequency(vco1Freq);
-            float vco1Out = vco1.process();
+            float noiseBlock[MAX_CONTROL_BLOCK];
+            noise.fillPM1(noiseBlock, n);
 
-            float fmMod = vco1Out * fmAmount * vco2Freq;
-            vco2.setFrequency(vco2Freq + fmMod);
-            float vco2Out = vco2.process();
+            for (int i = 0; i < n; ++i) {
+                float pitchRatio = pitchRamp.next();
+                float vco1Freq = vco1BaseFreq * pitchRatio;
+                float vco2Freq = vco2BaseFreq * pitchRatio;
 
-            float noiseOut = noise.process();
+                vco1.setFrequency(std::clamp(vco1Freq, 20.0f, 20000.0f));
+                float vco1Out = vco1.process();
 
-            float mix = vco1Out * vco1Level + vco2Out * vco2Level + noiseOut * noiseLevel;
+                float fmMod = vco1Out * fmAmount * vco2Freq;
+                vco2.setFrequency(std::clamp(vco2Freq + fmMod, 20.0f, 20000.0f));
+                float vco2Out = vco2.process();
 
-            float filterMod = filterCutoff + vcfVcaEnvValue * filterEnvAmount * 10000.0f;
-            filter.setCutoff(std::clamp(filterMod, 20.0f, 20000.0f));
-            float filtered = filter.process(mix);
+                float mix = vco1Out * vco1Level + vco2Out * vco2Level + noiseBlock[i] * noiseLevel;
 
-            float output = filtered * vcfVcaEnvValue * velocity * masterLevel;
+                float filtered = filter.process(mix);
 
-            if (antiClickActive) {
-                antiClickRamp += antiClickIncrement;
-                if (antiClickRamp >= 1.0f) {
-                    antiClickRamp = 1.0f;
-                    antiClickActive = false;
+                float output = filtered * vcfVcaEnvValues[i] * velocity * masterLevel;
+
+                if (antiClickActive) {
+                    antiClickRamp += antiClickIncrement;
+                    if (antiClickRamp >= 1.0f) {
+                        antiClickRamp = 1.0f;
+                        antiClickActive = false;
+                    }
+                    output *= antiClickRamp;
                 }
-                output *= antiClickRamp;
-            }
 
-            outputL[i] += output;
-            outputR[i] += output;
+                outputL[start + i] += output;
+                outputR[start + i] += output;
+            }
         }
     }
 
     // VCO1
     void setVCO1Frequency(float freq) { vco1BaseFreq = freq; }
     void setVCO1Level(float level) { vco1Level = level; }
-    void setVCO1Waveform(int w) { vco1.setWaveform(w); }
+    void setVCO1Waveform(int w) { vco1.setWaveform(vcoWaveform(w)); }
 
     // VCO2
     void setVCO2Frequency(float freq) { vco2BaseFreq = freq; }
     void setVCO2Level(float level) { vco2Level = level; }
-    void setVCO2Waveform(int w) { vco2.setWaveform(w); }
+    void setVCO2Waveform(int w) { vco2.setWaveform(vcoWaveform(w)); }
 
     // FM
     void setFMAmount(float amount) { fmAmount = amount; }
@@ -523,7 +294,7 @@ public:
     void setNoiseLevel(float level) { noiseLevel = level; }
 
     // Filter
-    void setFilterCutoff(float freq) { filterCutoff = freq; filter.setCutoff(freq); }
+    void setFilterCutoff(float freq) { filterCutoff = freq; }  // Picked up at the next control block
     void setFilterResonance(float res) { filter.setResonance(res); }
     void setFilterEnvAmount(float amount) { filterEnvAmount = amount; }
     void setFilterMode(int mode) { filter.setMode(mode); }
@@ -541,15 +312,39 @@ public:
 
     bool isActive() const { return vcfVcaEnv.isActive(); }
 
+    // Pitch envelope and cutoff every 64 samples in draft, 32 in normal,
+    // 8 in high; high's polyBLEP VCOs take over at the next trigger, and
+    // draft's ladder uses the rational tanh
+    void setQualityTier(QualityTier tier) {
+        controlBlock = forTier(tier, MAX_CONTROL_BLOCK, ControlRamp::BLOCK_SIZE, ControlRamp::BLOCK_SIZE / 4);
+        pitchEnv.setControlBlock(controlBlock);
+        bandLimited = tier == QualityTier::High;
+        filter.setAccuracy(tier == QualityTier::Draft ? LadderFilter::RATIONAL : LadderFilter::EXACT);
+    }
+
+    int getControlBlock() const { return controlBlock; }
+
 private:
+    // The VCO waveform parameter's order: saw, square, triangle, sine
+    static PolyBlepOscillator::Waveform vcoWaveform(int w) {
+        using W = PolyBlepOscillator::Waveform;
+        static constexpr W ORDER[] = {W::Saw, W::Pulse, W::Triangle, W::Sine};
+        return ORDER[std::clamp(w, 0, 3)];
+    }
+
     double sampleRate = 44100.0;
 
-    Oscillator vco1;
-    Oscillator vco2;
-    NoiseGenerator noise;
+    // Naive, or polyBLEP in the high tier from the next trigger, which
+    // restarts them anyway
+    PolyBlepOscillator vco1;
+    PolyBlepOscillator vco2;
+    bool bandLimited = false;
+    NoiseSource noise;
     LadderFilter filter;
     ADEnvelope pitchEnv;
     ADEnvelope vcfVcaEnv;
+    ControlRamp pitchRamp;  // Pitch envelope + offset as a frequency ratio
+    int controlBlock = ControlRamp::BLOCK_SIZE;
 
     float vco1BaseFreq = 110.0f;
     float vco2BaseFreq = 110.0f;
@@ -620,57 +415,104 @@ private:
  */
 class SynthEngine {
 public:
-    void prepare(double sr, int blockSize) {
+    using Delay = BasicStereoDelay<SampleStorage::Float16>;
+
+    // Floats prepare() takes from an arena at this sample rate
+    static constexpr size_t memoryNeeded(double sr) {
+        return Delay::memoryNeeded(sr) + Reverb::memoryNeeded(sr);
+    }
+
+    // Take the delay lines from arena; false if it's short
+    bool prepare(double sr, int blockSize, Arena& arena) {
         sampleRate = sr;
+        perfStats.prepare(sr);
         voice.prepare(sr);
         pitchLfo.prepare(sr);
         filterLfo.prepare(sr);
-        delay.prepare(sr);
-        reverb.prepare(sr);
+        const bool ok = delay.prepare(sr, arena) && reverb.prepare(sr, arena);
         saturator.setDrive(1.0f);
         updateClockRate();
         sequencer.reset();
+        return ok;
+    }
+
+    // Allocate the delay lines in one block owned by the engine
+    void prepare(double sr, int blockSize) {
+        ownedMemory.assign(memoryNeeded(sr), 0.0f);
+        Arena arena(ownedMemory.data(), ownedMemory.size(), true);
+        prepare(sr, blockSize, arena);
     }
 
     void renderBlock(float* outputL, float* outputR, int numSamples) {
-        std::fill(outputL, outputL + numSamples, 0.0f);
-        std::fill(outputR, outputR + numSamples, 0.0f);
-
-        for (int i = 0; i < numSamples; ++i) {
-            pitchLfo.process();
-            float filterLfoValue = filterLfo.process();
-
-            float modulatedCutoff = filterCutoffBase + filterLfoValue * filterLfoAmount * 5000.0f;
-            modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
-            voice.setFilterCutoff(modulatedCutoff);
-
-            if (running) {
-                clockAccumulator += 1.0;
-                if (clockAccumulator >= samplesPerStep) {
-                    clockAccumulator -= samplesPerStep;
-                    processSequencerStep();
+        perfStats.beginBlock();
+
+        // Voice pass, then the effects over the whole block (nothing feeds
+        // back into the voice, so this matches a per-sample chain)
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Voices);
+
+            std::fill(outputL, outputL + numSamples, 0.0f);
+            std::fill(outputR, outputR + numSamples, 0.0f);
+
+            // Spans of up to one control block; the step clock ends each
+            // span before the next step, so triggers stay sample accurate
+            int i = 0;
+            while (i < numSamples) {
+                int n = std::min(voice.getControlBlock(), numSamples - i);
+
+                if (running) {
+                    bool stepped = false;
+                    n = stepClock.next(n, stepped);
+                    if (stepped) processSequencerStep();
                 }
+
+                pitchLfo.advance(n);
+                float filterLfoValue = filterLfo.advance(n);
+
+                // The voice glides to the modulated cutoff over the span
+                float modulatedCutoff = filterCutoffBase + filterLfoValue * filterLfoAmount * 5000.0f;
+                modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
+                voice.setFilterCutoff(modulatedCutoff);
+
+                voice.render(outputL + i, outputR + i, n);
+                i += n;
             }
+        }
 
-            float outL = 0.0f;
-            float outR = 0.0f;
-            voice.render(&outL, &outR, 1);
+        {
+            PerfStats::ScopedStage stage(perfStats, PerfStats::Effects);
 
-            outL = saturator.process(outL);
-            outR = saturator.process(outR);
+            for (int i = 0; i < numSamples; ++i) {
+                outputL[i] = saturator.process(outputL[i]);
+                outputR[i] = saturator.process(outputR[i]);
+            }
 
-            delay.process(outL, outR);
-            reverb.process(outL, outR);
+            delay.processBlock(outputL, outputR, numSamples);
+            reverb.processBlock(outputL, outputR, numSamples);
 
-            outputL[i] = outL * masterGain;
-            outputR[i] = outR * masterGain;
+            for (int i = 0; i < numSamples; ++i) {
+                outputL[i] *= masterGain;
+                outputR[i] *= masterGain;
+            }
         }
+
+        // Silent once the voice is done and the output has stayed below
+        // -120 dB for longer than the delay and reverb could still echo
+        const bool outputSilent = !voice.isActive() && Silence::isSilent(outputL, outputR, numSamples);
+        silentBlock = !tailGate.process(outputSilent, numSamples,
+                                        std::max(delay.getTailSamples(), reverb.getTailSamples()));
+
+        if constexpr (PerfStats::ENABLED)
+            perfStats.endBlock(numSamples, voice.isActive() ? 1 : 0);
     }
 
+    // CPU counters (see PerfStats.h - empty unless built with SYNTH_PERF_STATS)
+    const PerfStats& getPerfStats() const { return perfStats; }
+
     // Transport
     void setRunning(bool run) {
         if (run && !running) {
-            clockAccumulator = 0.0;
+            stepClock.reset();
             sequencer.reset();
             processSequencerStep();
         }
@@ -679,6 +521,17 @@ public:
 
     bool isRunning() const { return running; }
 
+    // True if the last renderBlock() was silent with no voice or effect tail left
+    bool isSilent() const { return silentBlock; }
+
+    // Quality (QualityTier.h): the voice's control block and VCOs
+    void setQualityTier(QualityTier tier) {
+        quality = tier;
+        voice.setQualityTier(tier);
+    }
+
+    QualityTier getQualityTier() const { return quality; }
+
     void setTempo(float bpm) {
         tempo = std::clamp(bpm, 20.0f, 300.0f);
         updateClockRate();
@@ -714,7 +567,7 @@ public:
     void setFilterMode(int mode) { voice.setFilterMode(mode); }
 
     // Filter LFO
-    void setFilterLfoRate(float hz) { filterLfo.setRate(hz); }
+    void setFilterLfoRate(float hz) { filterLfo.setRate(std::clamp(hz, 0.01f, 20.0f)); }
     void setFilterLfoClockSync(float divider) { filterLfo.setClockSyncRate(tempo, divider); }
     void setFilterLfoAmount(float amount) { filterLfoAmount = std::clamp(amount, 0.0f, 1.0f); }
 
@@ -744,7 +597,7 @@ public:
 private:
     void updateClockRate() {
         float stepsPerSecond = (tempo / 60.0f) * 4.0f * clockDivider;
-        samplesPerStep = sampleRate / stepsPerSecond;
+        stepClock.setSamplesPerStep(sampleRate / stepsPerSecond);
     }
 
     void processSequencerStep() {
@@ -773,16 +626,21 @@ private:
     std::array<bool, 8> pitchLfoEnabled = {false, false, false, false, false, false, false, false};
 
     Saturator saturator;
-    StereoDelay delay;
+    Delay delay;
     Reverb reverb;
+    std::vector<float> ownedMemory;  // Delay lines when prepare() has no arena
+    TailGate tailGate;        // Output silent for the effects' whole tail
+    bool silentBlock = false;
 
     bool running = false;
     float tempo = 120.0f;
     float clockDivider = 1.0f;
-    double samplesPerStep = 1000.0;
-    double clockAccumulator = 0.0;
+    StepClock stepClock;
 
     float masterGain = 0.5f;
+    QualityTier quality = QualityTier::Normal;
+
+    PerfStats perfStats;
 };
 
 } // namespace dfam
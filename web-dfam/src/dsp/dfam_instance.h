@@ -0,0 +1,161 @@
+/**
+ * @file dfam_instance.h
+ * @brief One DFAM engine with its own flat parameter block
+ *
+ * The engine plus the block described by dfam_params.h: setParam() writes
+ * a slot and applies it, process() first applies slots written straight
+ * into getParamBlock(). dfam.wasm (wasm_bindings.cpp) holds one instance;
+ * the multi-engine module (multi/) one per createEngine(). process() takes
+ * any number of frames; the engine always renders whole control blocks
+ * (FixedBlockRenderer.h). Each call also updates the UI meters (Meters.h).
+ */
+
+#pragma once
+
+#include "FixedBlockRenderer.h"
+#include "Meters.h"
+#include "dfam_dsp.h"
+#include "dfam_params.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dfam {
+
+class Instance {
+public:
+    // Prepare the engine and reset every slot to its table default. The
+    // engine must be fresh (a new Instance), as prepare() doesn't clear it.
+    void init(int sampleRate, int maxBlockSize) {
+        engine.prepare(static_cast<double>(sampleRate), maxBlockSize > 0 ? maxBlockSize : 128);
+        meters.prepare(static_cast<double>(sampleRate));
+        resetParams();
+    }
+
+    // As above, with the engine's delay lines taken from arena (see
+    // SynthEngine::memoryNeeded). False if the arena is too small.
+    bool init(int sampleRate, int maxBlockSize, Arena& arena) {
+        if (!engine.prepare(static_cast<double>(sampleRate), maxBlockSize > 0 ? maxBlockSize : 128, arena))
+            return false;
+        meters.prepare(static_cast<double>(sampleRate));
+        resetParams();
+        return true;
+    }
+
+    void process(float* outputL, float* outputR, int numSamples) {
+        syncParamBlock();
+        blocks.process(outputL, outputR, numSamples, [this](float* l, float* r, int n) {
+            engine.renderBlock(l, r, n);
+        });
+        meters.process(outputL, outputR, numSamples);
+        meters.setSequencer(engine.getCurrentStep(), engine.isRunning());
+    }
+
+    // Write a slot and apply it right away
+    void setParam(int slot, float value) {
+        const int id = paramForSlot(slot);
+        if (id < 0) return;
+        paramBlock[slot] = normaliseParam(id, value);
+        applySlot(slot);
+    }
+
+    // kNumParamSlots floats, slot = table offset + step
+    float* getParamBlock() { return paramBlock; }
+
+    // Apply slots written directly into the block
+    void syncParamBlock() {
+        for (int slot = 0; slot < kNumParamSlots; ++slot) {
+            if (paramBlock[slot] != appliedBlock[slot]) {
+                paramBlock[slot] = normaliseParam(paramForSlot(slot), paramBlock[slot]);
+                applySlot(slot);
+            }
+        }
+    }
+
+    // Levels, scope and step as of the last process() call
+    const MeterBlock& getMeters() const { return meters.getBlock(); }
+
+    SynthEngine& getEngine() { return engine; }
+    const SynthEngine& getEngine() const { return engine; }
+
+private:
+    void resetParams() {
+        for (const ParamInfo& info : kParamTable) {
+            for (int i = 0; i < info.slots; ++i) {
+                paramBlock[info.offset + i] = info.defaultValue;
+                applySlot(info.offset + i);
+            }
+        }
+    }
+
+    // Clamp to the table range and round stepped params
+    static float normaliseParam(int id, float value) {
+        const ParamInfo& info = kParamTable[id];
+        value = std::clamp(value, info.minValue, info.maxValue);
+        if (info.smoothing == kSmoothStepped) value = std::round(value);
+        return value;
+    }
+
+    // Push one slot's value into the engine
+    void applySlot(int slot) {
+        const int id = paramForSlot(slot);
+        if (id < 0) return;
+
+        const float v = paramBlock[slot];
+        const int iv = static_cast<int>(v);
+        const int step = slot - kParamTable[id].offset;
+        appliedBlock[slot] = v;
+
+        SynthEngine& e = engine;
+        switch (id) {
+            case kRunning:            e.setRunning(iv != 0); break;
+            case kTempo:              e.setTempo(v); break;
+            case kClockDivider:       e.setClockDivider(v); break;
+            case kVCO1Freq:           e.setVCO1Frequency(v); break;
+            case kVCO1Wave:           e.setVCO1Waveform(iv); break;
+            case kVCO1Level:          e.setVCO1Level(v); break;
+            case kVCO2Freq:           e.setVCO2Frequency(v); break;
+            case kVCO2Wave:           e.setVCO2Waveform(iv); break;
+            case kVCO2Level:          e.setVCO2Level(v); break;
+            case kFMAmount:           e.setFMAmount(v); break;
+            case kNoiseLevel:         e.setNoiseLevel(v); break;
+            case kFilterCutoff:       e.setFilterCutoff(v); break;
+            case kFilterReso:         e.setFilterResonance(v); break;
+            case kFilterEnvAmount:    e.setFilterEnvAmount(v); break;
+            case kFilterMode:         e.setFilterMode(iv); break;
+            case kFilterLfoRate:      e.setFilterLfoRate(v); break;
+            // Clock sync dividers of 0 mean free running (keep the rate/time)
+            case kFilterLfoClockSync: if (v > 0.0f) e.setFilterLfoClockSync(v); break;
+            case kFilterLfoAmount:    e.setFilterLfoAmount(v); break;
+            case kPitchEnvAttack:     e.setPitchEnvAttack(v); break;
+            case kPitchEnvDecay:      e.setPitchEnvDecay(v); break;
+            case kPitchEnvAmount:     e.setPitchEnvAmount(v); break;
+            case kVCFVCAAttack:       e.setVCFVCAEnvAttack(v); break;
+            case kVCFVCADecay:        e.setVCFVCAEnvDecay(v); break;
+            case kSatDrive:           e.setSaturatorDrive(v); break;
+            case kSatMix:             e.setSaturatorMix(v); break;
+            case kDelayTime:          e.setDelayTime(v); break;
+            case kDelayClockSync:     if (v > 0.0f) e.setDelayClockSync(v); break;
+            case kDelayFeedback:      e.setDelayFeedback(v); break;
+            case kDelayMix:           e.setDelayMix(v); break;
+            case kReverbDecay:        e.setReverbDecay(v); break;
+            case kReverbDamping:      e.setReverbDamping(v); break;
+            case kReverbMix:          e.setReverbMix(v); break;
+            case kMasterVolume:       e.setMasterVolume(v); break;
+            case kSeqPitch:           e.setStepPitch(step, v); break;
+            case kSeqVel:             e.setStepVelocity(step, v); break;
+            default: break;
+        }
+    }
+
+    SynthEngine engine;
+    FixedBlockRenderer<ControlRamp::BLOCK_SIZE> blocks;
+    Meters meters;
+
+    // The worklet may write paramBlock directly; process() applies
+    // whatever differs from appliedBlock
+    float paramBlock[kNumParamSlots] = {};
+    float appliedBlock[kNumParamSlots] = {};
+};
+
+} // namespace dfam
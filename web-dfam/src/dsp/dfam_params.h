@@ -0,0 +1,135 @@
+/**
+ * @file dfam_params.h
+ * @brief DFAM parameter table shared by the WASM bindings and the worklet
+ *
+ * Every engine parameter is listed once in DFAM_PARAMS. The ParamId enum,
+ * the ParamInfo table and each parameter's slot offset in the flat
+ * parameter block are all generated from it, so adding a parameter is a
+ * one-line change here plus its case in dfam_instance.h applySlot().
+ *
+ * The parameter block is one float per slot. Per-step parameters take one
+ * slot per step: slot = offset + step. The worklet reads the table through
+ * getParamTablePtr() and hands the UI name -> ID map to the main thread, so
+ * nothing on the JS side hardcodes IDs or slots.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dfam {
+
+/** How a parameter value is applied to the engine */
+enum ParamSmoothing : int32_t {
+    kSmoothBlock = 0,    // Continuous, applied at the next block boundary
+    kSmoothStepped = 1,  // Rounded to the nearest integer (waveforms, modes, switches)
+};
+
+constexpr int kNumSequencerSteps = 8;
+
+// X(enumName, uiName, min, max, default, smoothing, slots)
+#define DFAM_PARAMS(X) \
+    X(Running,            "running",            0.0f,     1.0f,     0.0f,    kSmoothStepped, 1) \
+    X(Tempo,              "tempo",              20.0f,    300.0f,   120.0f,  kSmoothBlock,   1) \
+    X(ClockDivider,       "clockDivider",       0.0625f,  8.0f,     1.0f,    kSmoothBlock,   1) \
+    X(VCO1Freq,           "vco1Freq",           20.0f,    2000.0f,  110.0f,  kSmoothBlock,   1) \
+    X(VCO1Wave,           "vco1Wave",           0.0f,     3.0f,     0.0f,    kSmoothStepped, 1) \
+    X(VCO1Level,          "vco1Level",          0.0f,     1.0f,     0.5f,    kSmoothBlock,   1) \
+    X(VCO2Freq,           "vco2Freq",           20.0f,    2000.0f,  110.0f,  kSmoothBlock,   1) \
+    X(VCO2Wave,           "vco2Wave",           0.0f,     3.0f,     0.0f,    kSmoothStepped, 1) \
+    X(VCO2Level,          "vco2Level",          0.0f,     1.0f,     0.5f,    kSmoothBlock,   1) \
+    X(FMAmount,           "fmAmount",           0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(NoiseLevel,         "noiseLevel",         0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(FilterCutoff,       "filterCutoff",       20.0f,    20000.0f, 5000.0f, kSmoothBlock,   1) \
+    X(FilterReso,         "filterReso",         0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(FilterEnvAmount,    "filterEnvAmount",    0.0f,     1.0f,     0.5f,    kSmoothBlock,   1) \
+    X(FilterMode,         "filterMode",         0.0f,     1.0f,     0.0f,    kSmoothStepped, 1) \
+    X(FilterLfoRate,      "filterLfoRate",      0.01f,    20.0f,    1.0f,    kSmoothBlock,   1) \
+    X(FilterLfoClockSync, "filterLfoClockSync", 0.0f,     8.0f,     0.0f,    kSmoothBlock,   1) \
+    X(FilterLfoAmount,    "filterLfoAmount",    0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(PitchEnvAttack,     "pitchEnvAttack",     0.001f,   2.0f,     0.001f,  kSmoothBlock,   1) \
+    X(PitchEnvDecay,      "pitchEnvDecay",      0.001f,   2.0f,     0.3f,    kSmoothBlock,   1) \
+    X(PitchEnvAmount,     "pitchEnvAmount",     0.0f,     48.0f,    24.0f,   kSmoothBlock,   1) \
+    X(VCFVCAAttack,       "vcfVcaAttack",       0.001f,   2.0f,     0.001f,  kSmoothBlock,   1) \
+    X(VCFVCADecay,        "vcfVcaDecay",        0.001f,   2.0f,     0.5f,    kSmoothBlock,   1) \
+    X(SatDrive,           "satDrive",           1.0f,     20.0f,    1.0f,    kSmoothBlock,   1) \
+    X(SatMix,             "satMix",             0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(DelayTime,          "delayTime",          0.01f,    2.0f,     0.5f,    kSmoothBlock,   1) \
+    X(DelayClockSync,     "delayClockSync",     0.0f,     8.0f,     0.0f,    kSmoothBlock,   1) \
+    X(DelayFeedback,      "delayFeedback",      0.0f,     0.95f,    0.3f,    kSmoothBlock,   1) \
+    X(DelayMix,           "delayMix",           0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(ReverbDecay,        "reverbDecay",        0.1f,     10.0f,    2.0f,    kSmoothBlock,   1) \
+    X(ReverbDamping,      "reverbDamping",      0.0f,     1.0f,     0.5f,    kSmoothBlock,   1) \
+    X(ReverbMix,          "reverbMix",          0.0f,     1.0f,     0.0f,    kSmoothBlock,   1) \
+    X(MasterVolume,       "masterVolume",       -60.0f,   0.0f,     -6.0f,   kSmoothBlock,   1) \
+    X(SeqPitch,           "seqPitch",           -24.0f,   24.0f,    0.0f,    kSmoothBlock,   kNumSequencerSteps) \
+    X(SeqVel,             "seqVel",             0.0f,     1.0f,     1.0f,    kSmoothBlock,   kNumSequencerSteps)
+
+enum ParamId : int32_t {
+#define DFAM_PARAM_ENUM(id, name, mn, mx, def, smooth, slots) k##id,
+    DFAM_PARAMS(DFAM_PARAM_ENUM)
+#undef DFAM_PARAM_ENUM
+    kNumParams
+};
+
+/**
+ * @brief One row of the parameter table
+ *
+ * Plain 32-bit fields only, so the worklet can read the table straight out
+ * of WASM memory (8 words per row, name is a heap pointer to a C string).
+ */
+struct ParamInfo {
+    const char* name;
+    float minValue;
+    float maxValue;
+    float defaultValue;
+    int32_t smoothing;   // ParamSmoothing
+    int32_t slots;       // 1, or the step count for per-step params
+    int32_t offset;      // First slot in the parameter block
+    int32_t id;          // ParamId
+};
+
+namespace detail {
+constexpr int kParamSlots[] = {
+#define DFAM_PARAM_SLOTS(id, name, mn, mx, def, smooth, slots) slots,
+    DFAM_PARAMS(DFAM_PARAM_SLOTS)
+#undef DFAM_PARAM_SLOTS
+};
+
+constexpr int32_t slotOffset(int id) {
+    int32_t offset = 0;
+    for (int i = 0; i < id; ++i) offset += kParamSlots[i];
+    return offset;
+}
+} // namespace detail
+
+/** Total floats in the parameter block */
+constexpr int kNumParamSlots = detail::slotOffset(kNumParams);
+
+constexpr ParamInfo kParamTable[kNumParams] = {
+#define DFAM_PARAM_INFO(id, name, mn, mx, def, smooth, slots) \
+    { name, mn, mx, def, smooth, slots, detail::slotOffset(k##id), k##id },
+    DFAM_PARAMS(DFAM_PARAM_INFO)
+#undef DFAM_PARAM_INFO
+};
+
+static_assert(sizeof(void*) != 4 || sizeof(ParamInfo) == 32,
+              "ParamInfo must stay 8 words on wasm32 (the worklet reads it directly)");
+
+/** Parameter block slot for a param and step, or -1 if out of range */
+constexpr int paramSlot(int id, int index = 0) {
+    if (id < 0 || id >= kNumParams) return -1;
+    if (index < 0 || index >= kParamTable[id].slots) return -1;
+    return kParamTable[id].offset + index;
+}
+
+/** ParamId that owns a slot, or -1 */
+constexpr int paramForSlot(int slot) {
+    for (int id = 0; id < kNumParams; ++id) {
+        if (slot >= kParamTable[id].offset && slot < kParamTable[id].offset + kParamTable[id].slots)
+            return id;
+    }
+    return -1;
+}
+
+} // namespace dfam
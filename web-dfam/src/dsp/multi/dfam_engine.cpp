@@ -0,0 +1,51 @@
+/**
+ * @file dfam_engine.cpp
+ * @brief DFAM behind the multi-engine interface
+ */
+
+#include "engines.h"
+#include "../dfam_instance.h"
+
+namespace multi {
+namespace {
+
+class DFAMEngine final : public Engine {
+public:
+    void init(int sampleRate, int maxBlockSize) override {
+        instance.init(sampleRate, maxBlockSize);
+    }
+
+    // DFAM is a sound source: it takes no audio in
+    void process(const float*, const float*, float* outputL, float* outputR, int numSamples) override {
+        instance.process(outputL, outputR, numSamples);
+    }
+
+    // Parameters only; the sequencer plays the notes
+    void applyEvent(int kind, int id, int index, float value, int) override {
+        if (kind == kEventParam) instance.setParam(dfam::paramSlot(id, index), value);
+    }
+
+    float* getParamBlock() override { return instance.getParamBlock(); }
+    int getParamSlotCount() const override { return dfam::kNumParamSlots; }
+
+    int getCurrentStep(int) const override { return instance.getEngine().getCurrentStep(); }
+
+    void setQualityTier(int tier) override {
+        instance.getEngine().setQualityTier(qualityTierFromIndex(tier));
+    }
+
+    void getPerfStats(double* flat) const override {
+        instance.getEngine().getPerfStats().getSnapshot().toFlat(flat);
+    }
+
+private:
+    dfam::Instance instance;
+};
+
+} // namespace
+
+Engine* createDFAMEngine() {
+    return new DFAMEngine();
+}
+
+} // namespace multi
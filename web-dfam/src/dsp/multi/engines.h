@@ -0,0 +1,68 @@
+/**
+ * @file engines.h
+ * @brief Engines the multi-engine module can host, behind one interface
+ *
+ * Each engine lives in its own translation unit (dfam_engine.cpp,
+ * tapeloop_engine.cpp): each finds its own stand-ins for the sst-backed
+ * core/dsp headers (ControlRate.h, Oversampler.h, ...) ahead of core/dsp
+ * on its include path. This header includes neither, so the graph and
+ * the bindings only see the interface.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace multi {
+
+// Keep in sync with public/multi-processor.js
+enum EngineType : int32_t {
+    kEngineDFAM = 0,
+    kEngineTapeLoop = 1,
+    kNumEngineTypes
+};
+
+// Event kinds, as in the event ring (public/event-ring.js)
+enum EventKind : int32_t {
+    kEventParam = 0,
+    kEventNoteOn = 1,
+    kEventNoteOff = 2,
+};
+
+class Engine {
+public:
+    virtual ~Engine() = default;
+
+    // Called once, right after creation
+    virtual void init(int sampleRate, int maxBlockSize) = 0;
+
+    // Render numSamples into output. inputL/inputR are null when nothing
+    // is routed in; engines that take no input ignore them.
+    virtual void process(const float* inputL, const float* inputR,
+                         float* outputL, float* outputR, int numSamples) = 0;
+
+    // True if process() does something with its input
+    virtual bool takesInput() const { return false; }
+
+    // One event-ring record: a parameter (id, index = step) or a note
+    // (id = MIDI note, value = velocity) at sampleOffset into the next block
+    virtual void applyEvent(int kind, int id, int index, float value, int sampleOffset) = 0;
+
+    // The engine's flat parameter block, for engines that have one
+    virtual float* getParamBlock() { return nullptr; }
+    virtual int getParamSlotCount() const { return 0; }
+
+    virtual int getCurrentStep(int sequencer) const = 0;
+
+    // Render quality: 0 draft, 1 normal, 2 high (QualityTier.h)
+    virtual void setQualityTier(int) {}
+
+    // PerfStats::Snapshot::toFlat() into flat
+    virtual void getPerfStats(double* flat) const = 0;
+};
+
+// New engines of each type (dfam_engine.cpp, tapeloop_engine.cpp)
+Engine* createDFAMEngine();
+Engine* createTapeLoopEngine();
+
+} // namespace multi
@@ -0,0 +1,195 @@
+/**
+ * @file mix_graph.h
+ * @brief Engine instances by handle, and the routes that mix them
+ *
+ * createEngine() returns a handle (a slot index). A route takes one
+ * engine's output, times a gain, to another engine's input or to the
+ * master bus, so a chain like DFAM -> TapeLoop renders in one call with no
+ * copies between audio nodes:
+ *
+ *   int dfam = graph.createEngine(kEngineDFAM);
+ *   int tape = graph.createEngine(kEngineTapeLoop);
+ *   graph.connect(dfam, tape, 1.0f);
+ *   graph.connect(tape, MixGraph::kMaster, 1.0f);
+ *   graph.render(outL, outR, n);
+ *
+ * The graph is feed-forward: engines render in handle order and a route
+ * must go to a higher handle (or the master), so create engines in signal
+ * order. Every engine renders each block, routed or not, so sequencers
+ * keep time. A bus is written by its first route and added to by the
+ * rest; with nothing routed in, an engine gets no input and the master is
+ * silence.
+ */
+
+#pragma once
+
+#include "engines.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace multi {
+
+class MixGraph {
+public:
+    static constexpr int kMaxEngines = 8;
+    static constexpr int kMaxRoutes = 32;
+    static constexpr int kMaster = -1;
+
+    // Drop every engine and route; new engines render up to maxBlockSize
+    // samples per call (longer blocks are split)
+    void init(int sampleRate, int maxBlockSize) {
+        this->sampleRate = sampleRate;
+        this->maxBlockSize = maxBlockSize > 0 ? maxBlockSize : 128;
+        for (auto& slot : slots) slot = Slot();
+        numRoutes = 0;
+        inputL.assign(static_cast<size_t>(this->maxBlockSize), 0.0f);
+        inputR.assign(static_cast<size_t>(this->maxBlockSize), 0.0f);
+    }
+
+    // A new engine of the given type: its handle, or -1 if the type is
+    // unknown or every slot is taken. Allocates.
+    int createEngine(int type) {
+        int id = 0;
+        while (id < kMaxEngines && slots[id].engine) ++id;
+        if (id == kMaxEngines) return -1;
+
+        Engine* engine = nullptr;
+        switch (type) {
+            case kEngineDFAM:     engine = createDFAMEngine(); break;
+            case kEngineTapeLoop: engine = createTapeLoopEngine(); break;
+            default: return -1;
+        }
+
+        Slot& slot = slots[id];
+        slot.engine.reset(engine);
+        slot.engine->init(sampleRate, maxBlockSize);
+        slot.outputL.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+        slot.outputR.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+        return id;
+    }
+
+    // Remove an engine and every route to or from it
+    void destroyEngine(int id) {
+        if (!isEngine(id)) return;
+        slots[id] = Slot();
+
+        int kept = 0;
+        for (int r = 0; r < numRoutes; ++r) {
+            if (routes[r].source != id && routes[r].dest != id) routes[kept++] = routes[r];
+        }
+        numRoutes = kept;
+    }
+
+    // Route source's output to dest (an engine taking input, or kMaster),
+    // or change the gain of an existing route. False if the route isn't
+    // feed-forward or the route table is full.
+    bool connect(int source, int dest, float gain) {
+        if (!isEngine(source)) return false;
+        if (dest != kMaster && (!isEngine(dest) || dest <= source || !slots[dest].engine->takesInput()))
+            return false;
+
+        for (int r = 0; r < numRoutes; ++r) {
+            if (routes[r].source == source && routes[r].dest == dest) {
+                routes[r].gain = gain;
+                return true;
+            }
+        }
+        if (numRoutes == kMaxRoutes) return false;
+        routes[numRoutes++] = {source, dest, gain};
+        return true;
+    }
+
+    void disconnect(int source, int dest) {
+        for (int r = 0; r < numRoutes; ++r) {
+            if (routes[r].source == source && routes[r].dest == dest) {
+                routes[r] = routes[--numRoutes];
+                return;
+            }
+        }
+    }
+
+    bool isEngine(int id) const { return id >= 0 && id < kMaxEngines && slots[id].engine != nullptr; }
+    Engine* getEngine(int id) { return isEngine(id) ? slots[id].engine.get() : nullptr; }
+
+    // Render every engine and mix the master bus into output
+    void render(float* outputL, float* outputR, int numSamples) {
+        for (int start = 0; start < numSamples; start += maxBlockSize) {
+            const int n = std::min(numSamples - start, maxBlockSize);
+            renderChunk(outputL + start, outputR + start, n);
+        }
+    }
+
+    // Render one engine on its own, with no input
+    void renderEngine(int id, float* outputL, float* outputR, int numSamples) {
+        if (!isEngine(id)) return;
+        slots[id].engine->process(nullptr, nullptr, outputL, outputR, numSamples);
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<Engine> engine;
+        std::vector<float> outputL, outputR;
+    };
+
+    struct Route {
+        int source;
+        int dest;  // Engine, or kMaster
+        float gain;
+    };
+
+    void renderChunk(float* outputL, float* outputR, int n) {
+        for (int id = 0; id < kMaxEngines; ++id) {
+            Slot& slot = slots[id];
+            if (!slot.engine) continue;
+
+            const bool routedIn = mixRoutes(id, inputL.data(), inputR.data(), n);
+            slot.engine->process(routedIn ? inputL.data() : nullptr, routedIn ? inputR.data() : nullptr,
+                                 slot.outputL.data(), slot.outputR.data(), n);
+        }
+
+        if (!mixRoutes(kMaster, outputL, outputR, n)) {
+            std::fill(outputL, outputL + n, 0.0f);
+            std::fill(outputR, outputR + n, 0.0f);
+        }
+    }
+
+    // Mix the routes into dest into busL/busR; false if there are none
+    bool mixRoutes(int dest, float* busL, float* busR, int n) const {
+        bool written = false;
+        for (int r = 0; r < numRoutes; ++r) {
+            const Route& route = routes[r];
+            if (route.dest != dest) continue;
+
+            const float* srcL = slots[route.source].outputL.data();
+            const float* srcR = slots[route.source].outputR.data();
+            const float g = route.gain;
+            if (written) {
+                for (int i = 0; i < n; ++i) {
+                    busL[i] += srcL[i] * g;
+                    busR[i] += srcR[i] * g;
+                }
+            } else {
+                for (int i = 0; i < n; ++i) {
+                    busL[i] = srcL[i] * g;
+                    busR[i] = srcR[i] * g;
+                }
+                written = true;
+            }
+        }
+        return written;
+    }
+
+    int sampleRate = 44100;
+    int maxBlockSize = 128;
+
+    std::array<Slot, kMaxEngines> slots;
+    std::array<Route, kMaxRoutes> routes{};
+    int numRoutes = 0;
+
+    std::vector<float> inputL, inputR;  // The bus into the engine rendering
+};
+
+} // namespace multi
@@ -0,0 +1,60 @@
+/**
+ * @file tapeloop_engine.cpp
+ * @brief TapeLoop behind the multi-engine interface
+ *
+ * Audio routed in is recorded onto the loop with the oscillators (see
+ * TapeLoopEngine::renderBlock), so a DFAM feeding it plays onto the tape.
+ */
+
+#include "engines.h"
+#include "TapeLoopEngine.h"
+#include "tapeloop_params.h"
+
+namespace multi {
+namespace {
+
+class TapeLoopHost final : public Engine {
+public:
+    void init(int sampleRate, int maxBlockSize) override {
+        // The web UI tops out at 10 s, so don't reserve a full minute of tape
+        engine.setMaxLoopLength(10.0f);
+        engine.prepare(static_cast<double>(sampleRate), maxBlockSize > 0 ? maxBlockSize : 128);
+    }
+
+    void process(const float* inputL, const float* inputR,
+                 float* outputL, float* outputR, int numSamples) override {
+        engine.renderBlock(inputL, inputR, outputL, outputR, numSamples);
+    }
+
+    bool takesInput() const override { return true; }
+
+    void applyEvent(int kind, int id, int index, float value, int sampleOffset) override {
+        switch (kind) {
+            case kEventNoteOn:  engine.noteOn(id, value, sampleOffset); break;
+            case kEventNoteOff: engine.noteOff(id, sampleOffset); break;
+            case kEventParam:   applyWebParam(engine, id, index, value); break;
+            default: break;
+        }
+    }
+
+    int getCurrentStep(int sequencer) const override {
+        return sequencer == 0 ? engine.getSeq1CurrentStep() : engine.getSeq2CurrentStep();
+    }
+
+    void setQualityTier(int tier) override { engine.setQualityTier(qualityTierFromIndex(tier)); }
+
+    void getPerfStats(double* flat) const override {
+        engine.getPerfStats().getSnapshot().toFlat(flat);
+    }
+
+private:
+    TapeLoopEngine engine;
+};
+
+} // namespace
+
+Engine* createTapeLoopEngine() {
+    return new TapeLoopHost();
+}
+
+} // namespace multi
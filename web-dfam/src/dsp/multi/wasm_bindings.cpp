@@ -0,0 +1,120 @@
+/**
+ * @file wasm_bindings.cpp
+ * @brief Plain C exports for the multi-engine module (AudioWorklet compatible)
+ *
+ * One module, one heap and one worklet for several engines: createEngine()
+ * hands back a handle, process() renders one engine on its own and
+ * processGraph() renders them all through the routes in mix_graph.h (e.g.
+ * DFAM recorded onto a TapeLoop). The shared code is linked once.
+ */
+
+#include "mix_graph.h"
+#include "PerfStats.h"
+
+#include <cstdint>
+
+static multi::MixGraph* g_graph = nullptr;
+
+// Batched events from the worklet's SharedArrayBuffer ring
+// (public/event-ring.js). Five 32-bit words, matching the ring records;
+// the type word also carries the engine handle it's for.
+struct ParamEvent {
+    static constexpr int32_t ENGINE_SHIFT = 8;  // type = kind | handle << 8
+
+    int32_t type;
+    int32_t id;            // Engine parameter ID, or MIDI note for note events
+    int32_t index;         // Step for per-step params
+    float value;           // Param value, or velocity
+    int32_t sampleOffset;  // Offset into the next process() block
+};
+
+extern "C" {
+
+// Start an empty graph. maxBlockSize is the largest block the worklet
+// will ask process() for (0 = one render quantum).
+void init(int sampleRate, int maxBlockSize) {
+    if (g_graph) delete g_graph;
+    g_graph = new multi::MixGraph();
+    g_graph->init(sampleRate, maxBlockSize);
+}
+
+// A new engine of type multi::EngineType, or -1
+int createEngine(int type) {
+    return g_graph ? g_graph->createEngine(type) : -1;
+}
+
+void destroyEngine(int id) {
+    if (g_graph) g_graph->destroyEngine(id);
+}
+
+// Route source to dest (-1 = master) at gain; 0 if the route isn't allowed
+int connect(int source, int dest, float gain) {
+    return g_graph && g_graph->connect(source, dest, gain) ? 1 : 0;
+}
+
+void disconnect(int source, int dest) {
+    if (g_graph) g_graph->disconnect(source, dest);
+}
+
+// Render one engine, bypassing the graph (don't also run it through processGraph)
+void process(int id, float* outputL, float* outputR, int numSamples) {
+    if (g_graph) g_graph->renderEngine(id, outputL, outputR, numSamples);
+}
+
+// Render every engine and write the master bus
+void processGraph(float* outputL, float* outputR, int numSamples) {
+    if (g_graph) g_graph->render(outputL, outputR, numSamples);
+}
+
+// Apply a batch of events drained from the event ring, each to the engine
+// in its type word. Notes keep their sample offset.
+void applyParams(const ParamEvent* events, int count) {
+    if (!g_graph) return;
+
+    for (int i = 0; i < count; ++i) {
+        const ParamEvent& e = events[i];
+        multi::Engine* engine = g_graph->getEngine(e.type >> ParamEvent::ENGINE_SHIFT);
+        if (engine) {
+            const int kind = e.type & ((1 << ParamEvent::ENGINE_SHIFT) - 1);
+            engine->applyEvent(kind, e.id, e.index, e.value, e.sampleOffset);
+        }
+    }
+}
+
+// An engine's flat parameter block (DFAM, see dfam_params.h), or null
+float* getParamBlockPtr(int id) {
+    multi::Engine* engine = g_graph ? g_graph->getEngine(id) : nullptr;
+    return engine ? engine->getParamBlock() : nullptr;
+}
+
+int getParamSlotCount(int id) {
+    multi::Engine* engine = g_graph ? g_graph->getEngine(id) : nullptr;
+    return engine ? engine->getParamSlotCount() : 0;
+}
+
+// Current step of an engine's sequencer (TapeLoop has two: 0 and 1)
+int getCurrentStep(int id, int sequencer) {
+    multi::Engine* engine = g_graph ? g_graph->getEngine(id) : nullptr;
+    return engine ? engine->getCurrentStep(sequencer) : 0;
+}
+
+// An engine's render quality: 0 draft, 1 normal, 2 high
+void setQualityTier(int id, int tier) {
+    multi::Engine* engine = g_graph ? g_graph->getEngine(id) : nullptr;
+    if (engine) engine->setQualityTier(tier);
+}
+
+// An engine's CPU counters, PerfStats::Snapshot::toFlat() order (all 0
+// unless built with PERF_STATS=1). Read it before the next call.
+const double* getPerfStats(int id) {
+    static double flat[PerfStats::Snapshot::FLAT_SIZE] = {};
+    multi::Engine* engine = g_graph ? g_graph->getEngine(id) : nullptr;
+    if (engine) engine->getPerfStats(flat);
+    return flat;
+}
+
+int getPerfStatsSize() {
+    return PerfStats::Snapshot::FLAT_SIZE;
+}
+
+} // extern "C"
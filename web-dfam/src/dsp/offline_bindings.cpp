@@ -0,0 +1,86 @@
+/**
+ * @file offline_bindings.cpp
+ * @brief Plain C exports for offline DFAM bounces (pthreads build)
+ *
+ * Built by `make offline` with -pthread: the module's memory is a shared
+ * WebAssembly.Memory and each bounce renders on a pooled worker thread
+ * (see offline_render.h). Needs a cross-origin isolated page. Loaded on
+ * the main thread by src/audio/bounce.ts, not by a worklet.
+ */
+
+#include "offline_render.h"
+
+#include <array>
+#include <memory>
+
+// Bounces that can run at once (keep <= PTHREAD_POOL_SIZE in the Makefile)
+static constexpr int kMaxBounces = 4;
+
+static std::array<std::unique_ptr<dfam::OfflineRender>, kMaxBounces> g_bounces;
+
+static dfam::OfflineRender* bounce(int job) {
+    return job >= 0 && job < kMaxBounces ? g_bounces[job].get() : nullptr;
+}
+
+extern "C" {
+
+// A new bounce at the table defaults: its handle, or -1 if all are taken
+int createBounce(int sampleRate) {
+    for (int job = 0; job < kMaxBounces; ++job) {
+        if (!g_bounces[job]) {
+            g_bounces[job] = std::make_unique<dfam::OfflineRender>(sampleRate);
+            return job;
+        }
+    }
+    return -1;
+}
+
+// The bounce's parameter block (dfam_params.h slots), to fill before startBounce()
+float* getBounceParamBlockPtr(int job) {
+    dfam::OfflineRender* b = bounce(job);
+    return b ? b->getParamBlock() : nullptr;
+}
+
+// 0 draft, 1 normal (the default), 2 high (QualityTier.h), before startBounce(). 0 on failure.
+int setBounceQualityTier(int job, int tier) {
+    dfam::OfflineRender* b = bounce(job);
+    return b && b->setQualityTier(qualityTierFromIndex(tier)) ? 1 : 0;
+}
+
+// Render numFrames on a worker thread; returns at once. 0 on failure.
+int startBounce(int job, int numFrames) {
+    dfam::OfflineRender* b = bounce(job);
+    return b && b->start(numFrames) ? 1 : 0;
+}
+
+int getBounceFramesDone(int job) {
+    dfam::OfflineRender* b = bounce(job);
+    return b ? b->getFramesDone() : 0;
+}
+
+// Planar output, valid up to getBounceFramesDone()
+const float* getBounceLeft(int job) {
+    dfam::OfflineRender* b = bounce(job);
+    return b ? b->getLeft() : nullptr;
+}
+
+const float* getBounceRight(int job) {
+    dfam::OfflineRender* b = bounce(job);
+    return b ? b->getRight() : nullptr;
+}
+
+// Stop the bounce if it's still running and free it
+void releaseBounce(int job) {
+    if (bounce(job)) g_bounces[job].reset();
+}
+
+// Parameter table: kNumParams ParamInfo rows (8 words each), as in dfam.wasm
+const dfam::ParamInfo* getParamTablePtr() {
+    return dfam::kParamTable;
+}
+
+int getParamCount() {
+    return dfam::kNumParams;
+}
+
+} // extern "C"
@@ -0,0 +1,106 @@
+/**
+ * @file offline_render.h
+ * @brief Render a DFAM pattern into a buffer on its own thread ("bounce")
+ *
+ * Each job owns a fresh engine and renders it as fast as it can, block by
+ * block, into preallocated planar buffers. In the pthreads build (make
+ * offline) the thread is a Web Worker sharing the module's memory, so the
+ * page and the audio worklet keep running while a pattern bounces and the
+ * main thread only polls getFramesDone().
+ *
+ * One pattern's timeline can't be split across threads: the sequencer,
+ * delay and reverb carry state from each block into the next. A bounce is
+ * one thread, at many times real time; separate bounces (several patterns,
+ * or stems with different mutes) run side by side on the pool.
+ *
+ *   OfflineRender job(sampleRate);
+ *   job.getParamBlock()[slot] = value;    // Before start() only
+ *   job.setQualityTier(QualityTier::High);
+ *   job.start(numFrames);
+ *   while (job.getFramesDone() < numFrames) ...
+ *   job.getLeft(), job.getRight()
+ */
+
+#pragma once
+
+#include "dfam_instance.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace dfam {
+
+class OfflineRender {
+public:
+    static constexpr int kBlockSize = 512;
+
+    // A job at the table defaults
+    explicit OfflineRender(int sampleRate) { instance.init(sampleRate, kBlockSize); }
+    ~OfflineRender() { cancel(); }
+
+    OfflineRender(const OfflineRender&) = delete;
+    OfflineRender& operator=(const OfflineRender&) = delete;
+
+    // The pattern to bounce (dfam_params.h slots); write it before start()
+    float* getParamBlock() { return instance.getParamBlock(); }
+
+    // Render quality (QualityTier.h); set it before start()
+    bool setQualityTier(QualityTier tier) {
+        if (thread.joinable()) return false;
+        instance.getEngine().setQualityTier(tier);
+        return true;
+    }
+
+    // Allocate numFrames of output and start rendering. False if the job
+    // already started. Allocates and spawns a thread.
+    bool start(int numFrames) {
+        if (thread.joinable() || numFrames <= 0) return false;
+        totalFrames = numFrames;
+        left.assign(static_cast<size_t>(numFrames), 0.0f);
+        right.assign(static_cast<size_t>(numFrames), 0.0f);
+        thread = std::thread([this] { run(); });
+        return true;
+    }
+
+    // Stop early and join the thread; the frames so far stay valid
+    void cancel() {
+        cancelled.store(true, std::memory_order_relaxed);
+        if (thread.joinable()) thread.join();
+    }
+
+    // Frames rendered so far; the buffers are complete up to here
+    int getFramesDone() const { return framesDone.load(std::memory_order_acquire); }
+    int getNumFrames() const { return totalFrames; }
+
+    const float* getLeft() const { return left.data(); }
+    const float* getRight() const { return right.data(); }
+
+private:
+    void run() {
+        // Apply the pattern stopped, then start it: it plays from step one
+        // with every parameter in place
+        const int runningSlot = paramSlot(kRunning);
+        instance.getParamBlock()[runningSlot] = 0.0f;
+        instance.syncParamBlock();
+        instance.setParam(runningSlot, 1.0f);
+
+        for (int pos = 0; pos < totalFrames; pos += kBlockSize) {
+            if (cancelled.load(std::memory_order_relaxed)) return;
+            const int n = std::min(kBlockSize, totalFrames - pos);
+            instance.process(left.data() + pos, right.data() + pos, n);
+            framesDone.store(pos + n, std::memory_order_release);
+        }
+    }
+
+    Instance instance;
+    std::vector<float> left, right;
+    int totalFrames = 0;
+
+    std::thread thread;
+    std::atomic<int> framesDone{0};
+    std::atomic<bool> cancelled{false};
+};
+
+} // namespace dfam
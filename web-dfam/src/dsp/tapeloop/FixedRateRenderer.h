@@ -0,0 +1,47 @@
+/**
+ * @file FixedRateRenderer.h
+ * @brief Render rate for the engine: always the AudioContext's here
+ *
+ * Same interface as core/dsp/FixedRateRenderer.h, which runs the engine at
+ * a fixed internal rate through sst's LanczosResampler. The web build doesn't
+ * have the sst libraries (see docker-compose.yml), and the page already picks the
+ * context's rate, so this one always renders at the rate prepare() is
+ * given: a render rate is accepted and ignored, and render() calls the
+ * engine straight through.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+class FixedRateRenderer {
+public:
+    static constexpr double DEFAULT_RATE = 48000.0;
+
+    void prepare(double hostRate, int maxHostBlock, double /*engineRate*/)
+    {
+        rate = hostRate;
+        maxEngineBlock = maxHostBlock;
+    }
+
+    void reset() {}
+
+    bool isActive() const { return false; }
+    double getEngineRate() const { return rate; }
+    int getMaxEngineBlock() const { return maxEngineBlock; }
+    size_t getHeapBytes() const { return 0; }
+
+    int toEngineOffset(int hostOffset) const { return hostOffset; }
+    int toHostLatency(int engineLatency) const { return engineLatency; }
+
+    template <typename RenderFn>
+    void render(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples,
+                RenderFn&& render)
+    {
+        render(inputL, inputR, outputL, outputR, numSamples);
+    }
+
+private:
+    double rate = 44100.0;
+    int maxEngineBlock = 0;
+};
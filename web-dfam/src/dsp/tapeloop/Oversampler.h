@@ -0,0 +1,200 @@
+/**
+ * @file Oversampler.h
+ * @brief 2x / 4x oversampling around a nonlinear stage
+ *
+ * Same interface as the plugins' Oversampler.h, which runs sst-filters'
+ * HalfRateFilter. The web build doesn't have the sst libraries (see
+ * docker-compose.yml), so the same half-band IIR (two cascades of second-order allpasses, with
+ * Surge's coefficients) is written out here in scalar form.
+ *
+ *   Factor 2: base -> 2x (12th-order steep half-band) -> stage -> base
+ *   Factor 4: base -> 2x -> 4x (8th-order soft half-band) -> stage -> 2x -> base
+ *
+ * Samples go through one at a time, so unlike the plugins' SIMD version
+ * there is no grouping delay: LATENCY is 0 and only the filters' own phase
+ * delay remains. Factor 1 calls the stage in place.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+class Oversampler {
+public:
+    static constexpr int MAX_FACTOR = 4;
+
+    /** Base-rate samples per pass */
+    static constexpr int CHUNK = 64;
+
+    /** Delay through the oversampled path, in base-rate samples */
+    static constexpr int LATENCY = 0;
+
+    /** Ring-down of the half-band pairs, with headroom (about 1100 measured at 4x) */
+    static constexpr int TAIL = 2048;
+
+    Oversampler() { reset(); }
+
+    /** 1 (off), 2 or 4; anything else rounds down to one of those */
+    void setFactor(int f) {
+        f = f >= 4 ? 4 : (f >= 2 ? 2 : 1);
+        if (f == factor)
+            return;
+        factor = f;
+        reset();
+    }
+
+    int getFactor() const { return factor; }
+    int getLatency() const { return LATENCY; }
+
+    /** Base-rate samples for the filters to ring out below -120 dB after full scale in */
+    int getTailSamples() const { return factor > 1 ? TAIL : 0; }
+
+    /** Clear the filters (silence in, silence out) */
+    void reset() {
+        up2.reset();
+        down2.reset();
+        up4.reset();
+        down4.reset();
+    }
+
+    /**
+     * @brief Run stage(l, r, n) over the block at the oversampled rate, in place
+     * @param right May be nullptr for a mono stage (which then ignores r)
+     */
+    template <typename Stage>
+    void process(float* left, float* right, int numSamples, Stage&& stage) {
+        if (factor == 1) {
+            stage(left, right, numSamples);
+            return;
+        }
+
+        for (int i = 0; i < numSamples; i += CHUNK) {
+            const int n = std::min(numSamples - i, CHUNK);
+            float* l = left + i;
+            float* r = right ? right + i : nullptr;
+
+            for (int k = 0; k < n; ++k)
+                up2.upsample(l[k], r ? r[k] : 0.0f, upL + 2 * k, upR + 2 * k);
+
+            if (factor == 4) {
+                for (int k = 0; k < 2 * n; ++k)
+                    up4.upsample(upL[k], upR[k], up4L + 2 * k, up4R + 2 * k);
+                stage(up4L, up4R, 4 * n);
+                for (int k = 0; k < 2 * n; ++k)
+                    down4.downsample(up4L + 2 * k, up4R + 2 * k, upL[k], upR[k]);
+            } else {
+                stage(upL, upR, 2 * n);
+            }
+
+            for (int k = 0; k < n; ++k) {
+                float outR;
+                down2.downsample(upL + 2 * k, upR + 2 * k, l[k], outR);
+                if (r)
+                    r[k] = outR;
+            }
+        }
+    }
+
+    /** Mono convenience: stage(x, n) */
+    template <typename Stage>
+    void processMono(float* samples, int numSamples, Stage&& stage) {
+        process(samples, nullptr, numSamples, [&stage](float* l, float*, int n) { stage(l, n); });
+    }
+
+private:
+    /**
+     * Stereo half-band filter: out[t] = A(in)[t] + B(in)[t - 1], where A and
+     * B are cascades of allpasses in z^-2, run at the higher rate
+     */
+    class HalfBand {
+    public:
+        static constexpr int MAX_M = 6;
+
+        HalfBand(const float* a, const float* b, int m) : numStages(m) {
+            std::copy(a, a + m, coeffA);
+            std::copy(b, b + m, coeffB);
+            reset();
+        }
+
+        void reset() {
+            for (auto& c : channels)
+                c = {};
+        }
+
+        /** One base-rate sample in, two at the higher rate out (unity gain) */
+        void upsample(float inL, float inR, float* outL, float* outR) {
+            outL[0] = channels[0].step(inL, coeffA, coeffB, numStages);
+            outL[1] = channels[0].step(0.0f, coeffA, coeffB, numStages);
+            outR[0] = channels[1].step(inR, coeffA, coeffB, numStages);
+            outR[1] = channels[1].step(0.0f, coeffA, coeffB, numStages);
+        }
+
+        /** Two higher-rate samples in, one base-rate sample out */
+        void downsample(const float* inL, const float* inR, float& outL, float& outR) {
+            channels[0].step(inL[0], coeffA, coeffB, numStages);
+            outL = 0.5f * channels[0].step(inL[1], coeffA, coeffB, numStages);
+            channels[1].step(inR[0], coeffA, coeffB, numStages);
+            outR = 0.5f * channels[1].step(inR[1], coeffA, coeffB, numStages);
+        }
+
+    private:
+        struct Allpass {
+            float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+
+            float process(float x, float a) {
+                const float y = x2 + (x - y2) * a;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                return y;
+            }
+        };
+
+        struct Channel {
+            Allpass a[MAX_M];
+            Allpass b[MAX_M];
+            float lastB = 0.0f;
+
+            float step(float x, const float* ca, const float* cb, int m) {
+                float ya = x, yb = x;
+                for (int j = 0; j < m; ++j) {
+                    ya = a[j].process(ya, ca[j]);
+                    yb = b[j].process(yb, cb[j]);
+                }
+                const float out = ya + lastB;
+                lastB = yb;
+                return out;
+            }
+        };
+
+        float coeffA[MAX_M] = {};
+        float coeffB[MAX_M] = {};
+        int numStages;
+        Channel channels[2];
+    };
+
+    // HalfRateFilter(6, true): rejection 104 dB, transition band 0.01
+    static constexpr float STEEP_A[6] = {0.036681502163648017f, 0.2746317593794541f, 0.56109896978791948f,
+                                         0.769741833862266f, 0.8922608180038789f, 0.962094548378084f};
+    static constexpr float STEEP_B[6] = {0.13654762463195771f, 0.42313861743656667f, 0.6775400499741616f,
+                                         0.839889624849638f, 0.9315419599631839f, 0.9878163707328971f};
+
+    // HalfRateFilter(4, false): rejection 106 dB, transition band 0.05
+    static constexpr float SOFT_A[4] = {0.03583278843106211f, 0.2720401433964576f, 0.5720571972357003f,
+                                        0.827124761997324f};
+    static constexpr float SOFT_B[4] = {0.1340901419430669f, 0.4243248712718685f, 0.7062921421386394f,
+                                        0.9415030941737551f};
+
+    HalfBand up2{STEEP_A, STEEP_B, 6};
+    HalfBand down2{STEEP_A, STEEP_B, 6};
+    HalfBand up4{SOFT_A, SOFT_B, 4};
+    HalfBand down4{SOFT_A, SOFT_B, 4};
+
+    float upL[CHUNK * 2] = {};
+    float upR[CHUNK * 2] = {};
+    float up4L[CHUNK * 4] = {};
+    float up4R[CHUNK * 4] = {};
+
+    int factor = 1;
+};
@@ -0,0 +1,160 @@
+/**
+ * @file tapeloop_params.h
+ * @brief The web UI's TapeLoop parameter IDs, and applying one to an engine
+ *
+ * Shared by tapeloop.wasm (wasm_bindings.cpp) and the multi-engine module
+ * (../multi/), so both apply event-ring parameters the same way.
+ */
+
+#pragma once
+
+#include "TapeLoopEngine.h"
+
+#include <cmath>
+#include <cstdint>
+
+// Keep in sync with src/synths/tapeloop/paramIds.ts. Scoped: the
+// engine's own ParamId (SynthParams.h) numbers the plugin's parameters.
+namespace WebParam {
+enum Id : int32_t {
+    kOsc1Wave = 0,
+    kOsc1Tune,
+    kOsc1Level,
+    kOsc1Attack,
+    kOsc1Decay,
+    kOsc1Sustain,
+    kOsc1Release,
+    kOsc2Wave,
+    kOsc2Tune,
+    kOsc2Detune,
+    kOsc2Level,
+    kOsc2Attack,
+    kOsc2Decay,
+    kOsc2Sustain,
+    kOsc2Release,
+    kFmAmount,
+    kLoopLength,
+    kLoopFeedback,
+    kRecordLevel,
+    kSaturation,
+    kWobbleRate,
+    kWobbleDepth,
+    kTapeHiss,
+    kTapeAge,
+    kTapeDegrade,
+    kTapeModel,
+    kTapeDrive,
+    kTapeBump,
+    kLfoRate,
+    kLfoDepth,
+    kLfoWaveform,
+    kLfoTarget,
+    kDryLevel,
+    kLoopLevel,
+    kMasterLevel,
+    kRecAttack,
+    kRecDecay,
+    kDelayTime,
+    kDelayFeedback,
+    kDelayMix,
+    kReverbReplace,
+    kReverbBrightness,
+    kReverbDetune,
+    kReverbBigness,
+    kReverbSize,
+    kReverbMix,
+    kReverbDecay,
+    kReverbDamping,
+    kCompThreshold,
+    kCompRatio,
+    kCompAttack,
+    kCompRelease,
+    kCompMakeup,
+    kCompMix,
+    kSeqEnabled,
+    kSeqBPM,
+    kSeq1Division,
+    kSeq2Division,
+    kVoiceLoopFM,
+    kPanSpeed,
+    kPanDepth,
+    kSeq1Pitch,
+    kSeq1Gate,
+    kSeq2Pitch,
+    kSeq2Gate,
+};
+} // namespace WebParam
+
+// Apply one parameter event's value (index is the step for per-step params)
+inline void applyWebParam(TapeLoopEngine& e, int id, int index, float v) {
+    const int iv = static_cast<int>(std::lround(v));
+    switch (id) {
+        case WebParam::kOsc1Wave:             e.setOsc1Waveform(iv); break;
+        case WebParam::kOsc1Tune:             e.setOsc1Tune(v); break;
+        case WebParam::kOsc1Level:            e.setOsc1Level(v); break;
+        case WebParam::kOsc1Attack:           e.setOsc1Attack(v); break;
+        case WebParam::kOsc1Decay:            e.setOsc1Decay(v); break;
+        case WebParam::kOsc1Sustain:          e.setOsc1Sustain(v); break;
+        case WebParam::kOsc1Release:          e.setOsc1Release(v); break;
+        case WebParam::kOsc2Wave:             e.setOsc2Waveform(iv); break;
+        case WebParam::kOsc2Tune:             e.setOsc2Tune(v); break;
+        case WebParam::kOsc2Detune:           e.setOsc2Detune(v); break;
+        case WebParam::kOsc2Level:            e.setOsc2Level(v); break;
+        case WebParam::kOsc2Attack:           e.setOsc2Attack(v); break;
+        case WebParam::kOsc2Decay:            e.setOsc2Decay(v); break;
+        case WebParam::kOsc2Sustain:          e.setOsc2Sustain(v); break;
+        case WebParam::kOsc2Release:          e.setOsc2Release(v); break;
+        case WebParam::kFmAmount:             e.setFMAmount(v); break;
+        case WebParam::kLoopLength:           e.setLoopLength(v); break;
+        case WebParam::kLoopFeedback:         e.setLoopFeedback(v); break;
+        case WebParam::kRecordLevel:          e.setRecordLevel(v); break;
+        case WebParam::kSaturation:           e.setSaturation(v); break;
+        case WebParam::kWobbleRate:           e.setWobbleRate(v); break;
+        case WebParam::kWobbleDepth:          e.setWobbleDepth(v); break;
+        case WebParam::kTapeHiss:             e.setTapeHiss(v); break;
+        case WebParam::kTapeAge:              e.setTapeAge(v); break;
+        case WebParam::kTapeDegrade:          e.setTapeDegrade(v); break;
+        case WebParam::kTapeModel:            e.setTapeModel(iv); break;
+        case WebParam::kTapeDrive:            e.setTapeDrive(v); break;
+        case WebParam::kTapeBump:             e.setTapeBump(v); break;
+        case WebParam::kLfoRate:              e.setLFORate(v); break;
+        case WebParam::kLfoDepth:             e.setLFODepth(v); break;
+        case WebParam::kLfoWaveform:          e.setLFOWaveform(iv); break;
+        case WebParam::kLfoTarget:            e.setLFOTarget(iv); break;
+        case WebParam::kDryLevel:             e.setDryLevel(v); break;
+        case WebParam::kLoopLevel:            e.setLoopLevel(v); break;
+        case WebParam::kMasterLevel:          e.setMasterLevel(v); break;
+        case WebParam::kRecAttack:            e.setRecAttack(v); break;
+        case WebParam::kRecDecay:             e.setRecDecay(v); break;
+        case WebParam::kDelayTime:            e.setDelayTime(v); break;
+        case WebParam::kDelayFeedback:        e.setDelayFeedback(v); break;
+        case WebParam::kDelayMix:             e.setDelayMix(v); break;
+        case WebParam::kReverbReplace:        e.setReverbReplace(v); break;
+        case WebParam::kReverbBrightness:     e.setReverbBrightness(v); break;
+        case WebParam::kReverbDetune:         e.setReverbDetune(v); break;
+        case WebParam::kReverbBigness:        e.setReverbBigness(v); break;
+        case WebParam::kReverbSize:           e.setReverbSize(v); break;
+        case WebParam::kReverbMix:            e.setReverbMix(v); break;
+        case WebParam::kReverbDecay:          e.setReverbReplace(v); break;
+        case WebParam::kReverbDamping:        e.setReverbBrightness(1.0f - v); break;
+        case WebParam::kCompThreshold:        e.setCompThreshold(v); break;
+        case WebParam::kCompRatio:            e.setCompRatio(v); break;
+        case WebParam::kCompAttack:           e.setCompAttack(v); break;
+        case WebParam::kCompRelease:          e.setCompRelease(v); break;
+        case WebParam::kCompMakeup:           e.setCompMakeup(v); break;
+        case WebParam::kCompMix:              e.setCompMix(v); break;
+        case WebParam::kSeqEnabled:           e.setSeqEnabled(v != 0.0f); break;
+        case WebParam::kSeqBPM:               e.setSeqBPM(v); break;
+        case WebParam::kSeq1Division:         e.setSeq1Division(iv); break;
+        case WebParam::kSeq2Division:         e.setSeq2Division(iv); break;
+        case WebParam::kVoiceLoopFM:          e.setVoiceLoopFM(v); break;
+        case WebParam::kPanSpeed:             e.setPanSpeed(v); break;
+        case WebParam::kPanDepth:             e.setPanDepth(v); break;
+        case WebParam::kSeq1Pitch:            e.setSeq1StepPitch(index, iv); break;
+        case WebParam::kSeq1Gate:             e.setSeq1StepGate(index, v != 0.0f); break;
+        case WebParam::kSeq2Pitch:            e.setSeq2StepPitch(index, iv); break;
+        case WebParam::kSeq2Gate:             e.setSeq2StepGate(index, v != 0.0f); break;
+        default: break;
+    }
+
+}
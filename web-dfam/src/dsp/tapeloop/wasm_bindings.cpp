@@ -7,20 +7,46 @@
  */
 
 #include "TapeLoopEngine.h"
+#include "tapeloop_params.h"
+#include "../FixedBlockRenderer.h"
+
+#include <cstdint>
 
 static TapeLoopEngine* g_engine = nullptr;
 
+// process() takes any size; the engine renders whole tape spans
+static FixedBlockRenderer<TapeLoopEngine::TAPE_SPAN> g_blocks;
+
+// Batched events from the worklet's SharedArrayBuffer ring
+// (public/event-ring.js). Five 32-bit words, matching the ring records.
+struct ParamEvent {
+    enum Type : int32_t { Param = 0, NoteOn = 1, NoteOff = 2 };
+
+    int32_t type;
+    int32_t id;            // WebParam::Id, or MIDI note for note events
+    int32_t index;         // Step for per-step params
+    float value;           // Param value, or velocity
+    int32_t sampleOffset;  // Offset into the next process() block
+};
+
 extern "C" {
 
-void init(int sampleRate) {
+// maxBlockSize is the largest block the worklet will ask process() for
+// (0 = one render quantum)
+void init(int sampleRate, int maxBlockSize) {
     if (g_engine) delete g_engine;
     g_engine = new TapeLoopEngine();
-    g_engine->prepare(static_cast<double>(sampleRate), 128);
+    // The web UI tops out at 10 s, so don't reserve a full minute of tape
+    g_engine->setMaxLoopLength(10.0f);
+    g_engine->prepare(static_cast<double>(sampleRate), maxBlockSize > 0 ? maxBlockSize : 128);
+    g_blocks.reset();
 }
 
 void process(float* outputL, float* outputR, int numSamples) {
     if (!g_engine) return;
-    g_engine->renderBlock(outputL, outputR, numSamples);
+    g_blocks.process(outputL, outputR, numSamples, [](float* l, float* r, int n) {
+        g_engine->renderBlock(l, r, n);
+    });
 }
 
 void noteOn(int note, float velocity) {
@@ -35,6 +61,20 @@ void clearTape() {
     if (g_engine) g_engine->clearTape();
 }
 
+// Engine CPU counters, PerfStats::Snapshot::toFlat() order. Everything
+// reads 0 (including the leading "enabled") unless built with
+// PERF_STATS=1. Returns a pointer into WASM memory; read it as
+// Float64Array(memory.buffer, ptr, FLAT_SIZE) before the next call.
+const double* getPerfStats() {
+    static double flat[PerfStats::Snapshot::FLAT_SIZE] = {};
+    if (g_engine) g_engine->getPerfStats().getSnapshot().toFlat(flat);
+    return flat;
+}
+
+int getPerfStatsSize() {
+    return PerfStats::Snapshot::FLAT_SIZE;
+}
+
 // Oscillator 1
 void setOsc1Waveform(int w) { if (g_engine) g_engine->setOsc1Waveform(w); }
 void setOsc1Tune(float semitones) { if (g_engine) g_engine->setOsc1Tune(semitones); }
@@ -140,8 +180,32 @@ void setVoiceLoopFM(float amount) { if (g_engine) g_engine->setVoiceLoopFM(amoun
 void setPanSpeed(float hz) { if (g_engine) g_engine->setPanSpeed(hz); }
 void setPanDepth(float depth) { if (g_engine) g_engine->setPanDepth(depth); }
 
+// Render quality: 0 draft, 1 normal, 2 high (QualityTier.h)
+void setQualityTier(int tier) { if (g_engine) g_engine->setQualityTier(qualityTierFromIndex(tier)); }
+
 // Getters
 int getSeq1CurrentStep() { return g_engine ? g_engine->getSeq1CurrentStep() : 0; }
 int getSeq2CurrentStep() { return g_engine ? g_engine->getSeq2CurrentStep() : 0; }
 
+// Apply a batch of events drained from the event ring. Notes keep their
+// sample offset so they land inside the next process() block.
+void applyParams(const ParamEvent* events, int count) {
+    if (!g_engine) return;
+
+    for (int i = 0; i < count; ++i) {
+        const ParamEvent& e = events[i];
+
+        if (e.type == ParamEvent::NoteOn) {
+            g_engine->noteOn(e.id, e.value, e.sampleOffset);
+            continue;
+        }
+        if (e.type == ParamEvent::NoteOff) {
+            g_engine->noteOff(e.id, e.sampleOffset);
+            continue;
+        }
+
+        applyWebParam(*g_engine, e.id, e.index, e.value);
+    }
+}
+
 } // extern "C"
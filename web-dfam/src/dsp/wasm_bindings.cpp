@@ -2,183 +2,149 @@
  * @file wasm_bindings.cpp
  * @brief Plain C exports for DFAM DSP (AudioWorklet compatible)
  *
- * Uses extern "C" exports instead of Embind for direct WASM usage in AudioWorklet
+ * Uses extern "C" exports instead of Embind for direct WASM usage in AudioWorklet.
+ * Parameters go through the flat table in dfam_params.h rather than one
+ * export per setter: setParams() for batches, applyParams() for the event
+ * ring, or direct writes into getParamBlockPtr().
  */
 
-#include "dfam_dsp.h"
+#include "dfam_instance.h"
 
-// Global engine instance
-static dfam::SynthEngine* g_engine = nullptr;
+#include <cstdint>
+#include <iterator>
+#include <new>
 
-extern "C" {
+// Highest sample rate init() accepts; the delay arena is sized for it
+static constexpr double kMaxSampleRate = 96000.0;
 
-// Initialize the engine
-void init(int sampleRate) {
-    if (g_engine) delete g_engine;
-    g_engine = new dfam::SynthEngine();
-    g_engine->prepare(static_cast<double>(sampleRate), 128);
-}
+// Everything init() needs lives in static memory, sized at build time:
+// the instance itself and its delay lines. Nothing is allocated at init,
+// so a worklet that can't grow the heap can't run out halfway through.
+alignas(dfam::Instance) static unsigned char g_instanceStorage[sizeof(dfam::Instance)];
+alignas(16) static float g_arena[dfam::SynthEngine::memoryNeeded(kMaxSampleRate)];
 
-// Process audio block - takes pointers to output buffers
-void process(float* outputL, float* outputR, int numSamples) {
-    if (!g_engine) return;
-    g_engine->renderBlock(outputL, outputR, numSamples);
-}
+// Global engine instance (engine plus parameter block, see dfam_instance.h)
+static dfam::Instance* g_instance = nullptr;
 
-// Transport
-void setRunning(int running) {
-    if (g_engine) g_engine->setRunning(running != 0);
-}
+// Batched parameter events from the worklet's SharedArrayBuffer ring
+// (public/event-ring.js). Five 32-bit words, matching the ring records.
+struct ParamEvent {
+    int32_t type;          // 0 = param (DFAM has no note events)
+    int32_t id;            // dfam::ParamId
+    int32_t index;         // Step for per-step params
+    float value;
+    int32_t sampleOffset;  // Unused - params apply at block start
+};
 
-int isRunning() {
-    return g_engine ? (g_engine->isRunning() ? 1 : 0) : 0;
-}
+extern "C" {
 
-void setTempo(float bpm) {
-    if (g_engine) g_engine->setTempo(bpm);
+// Initialize the engine. The worklet renders several quanta per call, so
+// it passes the largest block it will ask process() for (0 = one quantum).
+// Every slot is reset to its table default and pushed to the engine.
+// Returns 0 (and leaves no engine) above kMaxSampleRate.
+int init(int sampleRate, int maxBlockSize) {
+    if (g_instance) g_instance->~Instance();
+    g_instance = new (g_instanceStorage) dfam::Instance();
+
+    // g_arena is zero until the first init has used it
+    static bool arenaUsed = false;
+    Arena arena(g_arena, std::size(g_arena), !arenaUsed);
+    arenaUsed = true;
+    if (!g_instance->init(sampleRate, maxBlockSize, arena)) {
+        g_instance->~Instance();
+        g_instance = nullptr;
+        return 0;
+    }
+    return 1;
 }
 
-void setClockDivider(float divider) {
-    if (g_engine) g_engine->setClockDivider(divider);
+// Process audio block - takes pointers to output buffers
+void process(float* outputL, float* outputR, int numSamples) {
+    if (!g_instance) return;
+    g_instance->process(outputL, outputR, numSamples);
 }
 
-// Sequencer
-void setStepPitch(int step, float semitones) {
-    if (g_engine) g_engine->setStepPitch(step, semitones);
+int isRunning() {
+    return g_instance ? (g_instance->getEngine().isRunning() ? 1 : 0) : 0;
 }
 
-void setStepVelocity(int step, float velocity) {
-    if (g_engine) g_engine->setStepVelocity(step, velocity);
+// 1 while process() would only render silence: the sequencer is stopped
+// and nothing is left sounding. The worklet may output zeros itself until
+// the next parameter change.
+int isSilent() {
+    if (!g_instance) return 0;
+    const dfam::SynthEngine& engine = g_instance->getEngine();
+    return !engine.isRunning() && engine.isSilent() ? 1 : 0;
 }
 
 int getCurrentStep() {
-    return g_engine ? g_engine->getCurrentStep() : 0;
+    return g_instance ? g_instance->getEngine().getCurrentStep() : 0;
 }
 
-// VCO
-void setVCO1Frequency(float freq) {
-    if (g_engine) g_engine->setVCO1Frequency(freq);
+// Render quality, not a preset parameter: 0 draft, 1 normal, 2 high (QualityTier.h)
+void setQualityTier(int tier) {
+    if (g_instance) g_instance->getEngine().setQualityTier(qualityTierFromIndex(tier));
 }
 
-void setVCO2Frequency(float freq) {
-    if (g_engine) g_engine->setVCO2Frequency(freq);
+// Meters, scope and sequencer state (MeterBlock in Meters.h), updated by
+// every process(). A fixed address for the life of the module: the worklet
+// copies it into the UI's SharedArrayBuffer after each render.
+const MeterBlock* getMeters() {
+    static const MeterBlock empty{};
+    return g_instance ? &g_instance->getMeters() : &empty;
 }
 
-void setVCO1Level(float level) {
-    if (g_engine) g_engine->setVCO1Level(level);
+int getMetersSize() {
+    return static_cast<int>(sizeof(MeterBlock));
 }
 
-void setVCO2Level(float level) {
-    if (g_engine) g_engine->setVCO2Level(level);
+// Engine CPU counters, PerfStats::Snapshot::toFlat() order. Everything
+// reads 0 (including the leading "enabled") unless built with
+// PERF_STATS=1. Returns a pointer into WASM memory; read it as
+// Float64Array(memory.buffer, ptr, FLAT_SIZE) before the next call.
+const double* getPerfStats() {
+    static double flat[PerfStats::Snapshot::FLAT_SIZE] = {};
+    if (g_instance) g_instance->getEngine().getPerfStats().getSnapshot().toFlat(flat);
+    return flat;
 }
 
-void setVCO1Waveform(int w) {
-    if (g_engine) g_engine->setVCO1Waveform(w);
+int getPerfStatsSize() {
+    return PerfStats::Snapshot::FLAT_SIZE;
 }
 
-void setVCO2Waveform(int w) {
-    if (g_engine) g_engine->setVCO2Waveform(w);
+// Parameter block: kNumParamSlots floats, slot = table offset + step
+float* getParamBlockPtr() {
+    return g_instance ? g_instance->getParamBlock() : nullptr;
 }
 
-void setFMAmount(float amount) {
-    if (g_engine) g_engine->setFMAmount(amount);
+int getParamSlotCount() {
+    return dfam::kNumParamSlots;
 }
 
-void setNoiseLevel(float level) {
-    if (g_engine) g_engine->setNoiseLevel(level);
+// Parameter table: kNumParams ParamInfo rows (8 words each)
+const dfam::ParamInfo* getParamTablePtr() {
+    return dfam::kParamTable;
 }
 
-// Filter
-void setFilterCutoff(float freq) {
-    if (g_engine) g_engine->setFilterCutoff(freq);
+int getParamCount() {
+    return dfam::kNumParams;
 }
 
-void setFilterResonance(float res) {
-    if (g_engine) g_engine->setFilterResonance(res);
+// Set n slots in one call (a whole preset, or a single knob)
+void setParams(const float* values, const int* ids, int n) {
+    if (!g_instance) return;
+    for (int i = 0; i < n; ++i) g_instance->setParam(ids[i], values[i]);
 }
 
-void setFilterEnvAmount(float amount) {
-    if (g_engine) g_engine->setFilterEnvAmount(amount);
-}
-
-void setFilterMode(int mode) {
-    if (g_engine) g_engine->setFilterMode(mode);
-}
-
-// Filter LFO
-void setFilterLfoRate(float hz) {
-    if (g_engine) g_engine->setFilterLfoRate(hz);
-}
-
-void setFilterLfoClockSync(float divider) {
-    if (g_engine) g_engine->setFilterLfoClockSync(divider);
-}
-
-void setFilterLfoAmount(float amount) {
-    if (g_engine) g_engine->setFilterLfoAmount(amount);
-}
-
-// Envelopes
-void setPitchEnvAttack(float t) {
-    if (g_engine) g_engine->setPitchEnvAttack(t);
-}
-
-void setPitchEnvDecay(float t) {
-    if (g_engine) g_engine->setPitchEnvDecay(t);
-}
-
-void setPitchEnvAmount(float semitones) {
-    if (g_engine) g_engine->setPitchEnvAmount(semitones);
-}
-
-void setVCFVCAEnvAttack(float t) {
-    if (g_engine) g_engine->setVCFVCAEnvAttack(t);
-}
-
-void setVCFVCAEnvDecay(float t) {
-    if (g_engine) g_engine->setVCFVCAEnvDecay(t);
-}
-
-// Effects
-void setSaturatorDrive(float drive) {
-    if (g_engine) g_engine->setSaturatorDrive(drive);
-}
-
-void setSaturatorMix(float mix) {
-    if (g_engine) g_engine->setSaturatorMix(mix);
-}
-
-void setDelayTime(float seconds) {
-    if (g_engine) g_engine->setDelayTime(seconds);
-}
-
-void setDelayClockSync(float divider) {
-    if (g_engine) g_engine->setDelayClockSync(divider);
-}
-
-void setDelayFeedback(float fb) {
-    if (g_engine) g_engine->setDelayFeedback(fb);
-}
-
-void setDelayMix(float mix) {
-    if (g_engine) g_engine->setDelayMix(mix);
-}
-
-void setReverbDecay(float decay) {
-    if (g_engine) g_engine->setReverbDecay(decay);
-}
-
-void setReverbDamping(float damping) {
-    if (g_engine) g_engine->setReverbDamping(damping);
-}
-
-void setReverbMix(float mix) {
-    if (g_engine) g_engine->setReverbMix(mix);
-}
+// Apply a batch of parameter events drained from the event ring
+void applyParams(const ParamEvent* events, int count) {
+    if (!g_instance) return;
 
-// Master
-void setMasterVolume(float volumeDb) {
-    if (g_engine) g_engine->setMasterVolume(volumeDb);
+    for (int i = 0; i < count; ++i) {
+        const ParamEvent& e = events[i];
+        if (e.type != 0) continue;
+        g_instance->setParam(dfam::paramSlot(e.id, e.index), e.value);
+    }
 }
 
 } // extern "C"
@@ -106,7 +106,7 @@ interface DFAMSynthProps {
 }
 
 const DFAMSynth: React.FC<DFAMSynthProps> = ({ onBack }) => {
-  const { isReady, isPlaying, currentStep, error, initialize, setParam, setPlaying } = useAudioEngine();
+  const { isReady, isPlaying, currentStep, error, initialize, setParam, setParams: sendParams, setPlaying } = useAudioEngine();
   const [params, setParams] = useState<SynthParams>(defaultParams);
   const [isStarted, setIsStarted] = useState(false);
 
@@ -149,19 +149,21 @@ const DFAMSynth: React.FC<DFAMSynthProps> = ({ onBack }) => {
     setParam(`seqVel_${step}`, value);
   }, [setParam]);
 
-  // Send initial params when ready
+  // Send initial params when ready, as one batch
   useEffect(() => {
     if (isReady) {
+      const values: Record<string, number> = {};
       Object.entries(params).forEach(([key, value]) => {
         if (key === 'seqPitch' || key === 'seqVel') return;
         if (key === 'clockDivider') {
-          setParam('clockDivider', CLOCK_DIVIDER_VALUES[value as number] ?? 1);
+          values.clockDivider = CLOCK_DIVIDER_VALUES[value as number] ?? 1;
         } else {
-          setParam(key, value as number);
+          values[key] = value as number;
         }
       });
-      params.seqPitch.forEach((v, i) => setParam(`seqPitch_${i}`, v));
-      params.seqVel.forEach((v, i) => setParam(`seqVel_${i}`, v));
+      params.seqPitch.forEach((v, i) => { values[`seqPitch_${i}`] = v; });
+      params.seqVel.forEach((v, i) => { values[`seqVel_${i}`] = v; });
+      sendParams(values);
     }
   }, [isReady]);
 
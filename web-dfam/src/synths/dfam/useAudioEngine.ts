@@ -6,6 +6,11 @@
  */
 
 import { useEffect, useRef, useState, useCallback } from 'react';
+import { EventRingWriter, canUseEventRing } from '../../audio/eventRing';
+import { MeterSnapshot, MeterTapReader, canUseMeterTap } from '../../audio/meters';
+import { SpectrumClient } from '../../audio/spectrum';
+import { fetchWasmNameMap } from '../../audio/wasmGlue';
+import { loadWasmModule } from '../../audio/wasmModule';
 
 interface AudioEngineState {
   isReady: boolean;
@@ -14,6 +19,18 @@ interface AudioEngineState {
   error: string | null;
 }
 
+/** Engine CPU counters (src/dsp/PerfStats.h); all 0 unless built with PERF_STATS=1 */
+export interface PerfStats {
+  enabled: boolean;
+  blocks: number;
+  blocksOverBudget: number;
+  lastBlockUs: number;
+  worstBlockUs: number;
+  averageLoad: number;
+  stageShare: Record<string, number>;
+  voiceHistogram: number[];
+}
+
 export function useAudioEngine() {
   const [state, setState] = useState<AudioEngineState>({
     isReady: false,
@@ -25,6 +42,11 @@ export function useAudioEngine() {
   const audioContextRef = useRef<AudioContext | null>(null);
   const workletNodeRef = useRef<AudioWorkletNode | null>(null);
   const isInitializedRef = useRef(false);
+  const eventRingRef = useRef<EventRingWriter | null>(null);
+  const perfStatsResolversRef = useRef<((stats: PerfStats) => void)[]>([]);
+  const meterTapRef = useRef<MeterTapReader | null>(null);
+  const meterFrameRef = useRef(0);
+  const spectrumRef = useRef<SpectrumClient | null>(null);
 
   const initialize = useCallback(async () => {
     if (isInitializedRef.current) return;
@@ -45,14 +67,27 @@ export function useAudioEngine() {
       // Register the AudioWorklet processor
       await ctx.audioWorklet.addModule('/dfam-processor.js');
 
-      console.log('Fetching WASM binary...');
-      // Fetch the WASM binary
-      const wasmResponse = await fetch('/dfam.wasm');
-      if (!wasmResponse.ok) {
-        throw new Error(`Failed to fetch WASM: ${wasmResponse.status}`);
+      // Compile the SIMD128 or scalar build here, streaming (or take it
+      // from the cache); the worklet only instantiates it
+      const wasm = await loadWasmModule('dfam');
+      console.log('WASM module', wasm.cached ? 'from cache' : 'compiled', wasm.simd ? '(SIMD128)' : '(scalar)');
+
+      // The worklet instantiates the raw wasm, so it needs the minified
+      // import/export names from the Emscripten glue
+      const wasmNames = await fetchWasmNameMap('/dfam.js');
+      if (!wasmNames) {
+        throw new Error('Failed to load /dfam.js export names');
       }
-      const wasmBytes = await wasmResponse.arrayBuffer();
-      console.log('WASM binary loaded:', wasmBytes.byteLength, 'bytes');
+
+      // Parameters go through a SharedArrayBuffer ring when the page is
+      // cross-origin isolated; otherwise they fall back to port messages.
+      // Param IDs come from the WASM table in the ready message.
+      const eventRing = canUseEventRing() ? new EventRingWriter({}) : null;
+
+      // Meters, scope and the current step come back the same way: the
+      // worklet copies them into shared memory after each render and the
+      // step is picked up on animation frames instead of 'step' messages
+      const meterTap = canUseMeterTap() ? new MeterTapReader() : null;
 
       // Create the AudioWorklet node
       const workletNode = new AudioWorkletNode(ctx, 'dfam-processor', {
@@ -66,7 +101,23 @@ export function useAudioEngine() {
       workletNode.port.onmessage = (event) => {
         const data = event.data;
         if (data.type === 'ready') {
-          console.log('AudioWorklet WASM ready!');
+          console.log('AudioWorklet WASM ready!', data.eventRing ? '(event ring)' : '(port messages)');
+          if (data.eventRing && eventRing) {
+            eventRing.setParamIds(data.paramIds);
+            eventRingRef.current = eventRing;
+          }
+          if (data.meters && meterTap) {
+            meterTapRef.current = meterTap;
+            const poll = () => {
+              const step = meterTap.read().step;
+              setState(s => s.currentStep !== step ? { ...s, currentStep: step } : s);
+              meterFrameRef.current = requestAnimationFrame(poll);
+            };
+            meterFrameRef.current = requestAnimationFrame(poll);
+
+            // The spectrum's FFTs run in a worker reading the same tap
+            spectrumRef.current = new SpectrumClient(meterTap.buffer, ctx.sampleRate);
+          }
           isInitializedRef.current = true;
           setState(s => ({ ...s, isReady: true }));
         } else if (data.type === 'error') {
@@ -74,19 +125,27 @@ export function useAudioEngine() {
           setState(s => ({ ...s, error: data.message }));
         } else if (data.type === 'step') {
           setState(s => s.currentStep !== data.step ? { ...s, currentStep: data.step } : s);
+        } else if (data.type === 'perfStats') {
+          const resolvers = perfStatsResolversRef.current;
+          perfStatsResolversRef.current = [];
+          resolvers.forEach(resolve => resolve(data as PerfStats));
         }
       };
 
       // Connect to destination
       workletNode.connect(ctx.destination);
 
-      // Send the WASM binary to the worklet
+      // Send the compiled module to the worklet
       console.log('Sending WASM to worklet...');
       workletNode.port.postMessage({
         type: 'init',
-        wasmBytes: wasmBytes,
+        wasmModule: wasm.module,
+        simd: wasm.simd,
         sampleRate: ctx.sampleRate,
-      }, [wasmBytes]); // Transfer ownership for performance
+        eventRing: eventRing?.buffer ?? null,
+        meters: meterTap?.buffer ?? null,
+        wasmNames,
+      });
 
       console.log('Audio engine initialization started...');
     } catch (error) {
@@ -96,6 +155,8 @@ export function useAudioEngine() {
   }, []);
 
   const setParam = useCallback((name: string, value: number) => {
+    if (eventRingRef.current?.pushParam(name, value)) return;
+
     const workletNode = workletNodeRef.current;
     if (!workletNode) return;
 
@@ -106,6 +167,40 @@ export function useAudioEngine() {
     });
   }, []);
 
+  /** Set many parameters at once ({ name: value }), e.g. a whole preset */
+  const setParams = useCallback((values: Record<string, number>) => {
+    workletNodeRef.current?.port.postMessage({ type: 'preset', values });
+  }, []);
+
+  /** Ask the worklet for the engine's CPU counters (null before init) */
+  const getPerfStats = useCallback((): Promise<PerfStats | null> => {
+    const workletNode = workletNodeRef.current;
+    if (!workletNode || !isInitializedRef.current) return Promise.resolve(null);
+
+    return new Promise(resolve => {
+      perfStatsResolversRef.current.push(resolve);
+      workletNode.port.postMessage({ type: 'getPerfStats' });
+    });
+  }, []);
+
+  /**
+   * Latest levels, scope and step for a visualiser's own animation frame,
+   * or null without the meter tap (page not cross-origin isolated). The
+   * snapshot is reused by the next call.
+   */
+  const readMeters = useCallback((): MeterSnapshot | null => {
+    return meterTapRef.current?.read() ?? null;
+  }, []);
+
+  /**
+   * Newest output spectrum (dB per band, log spaced from 20 Hz; see
+   * src/audio/spectrum.ts), or null without the meter tap or before the
+   * worker's first frame
+   */
+  const readSpectrum = useCallback((): Float32Array | null => {
+    return spectrumRef.current?.read() ?? null;
+  }, []);
+
   const setPlaying = useCallback((playing: boolean) => {
     if (audioContextRef.current?.state === 'suspended') {
       audioContextRef.current.resume();
@@ -116,6 +211,8 @@ export function useAudioEngine() {
 
   useEffect(() => {
     return () => {
+      cancelAnimationFrame(meterFrameRef.current);
+      spectrumRef.current?.terminate();
       if (workletNodeRef.current) {
         workletNodeRef.current.disconnect();
       }
@@ -129,6 +226,10 @@ export function useAudioEngine() {
     ...state,
     initialize,
     setParam,
+    setParams,
     setPlaying,
+    getPerfStats,
+    readMeters,
+    readSpectrum,
   };
 }
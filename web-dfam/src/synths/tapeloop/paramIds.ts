@@ -0,0 +1,79 @@
+/**
+ * @file paramIds.ts
+ * @brief TapeLoop parameter IDs for the event ring
+ *
+ * UI parameter names mapped to the ParamId enum in
+ * src/dsp/tapeloop/tapeloop_params.h - keep the two in sync. Per-step
+ * params (seq1Pitch_N, seq1Gate_N, seq2Pitch_N and seq2Gate_N) use the
+ * base name and carry the step as the event index.
+ */
+
+import type { ParamIdTable } from '../../audio/eventRing';
+
+export const PARAM_IDS: ParamIdTable = {
+  osc1Wave: 0,
+  osc1Tune: 1,
+  osc1Level: 2,
+  osc1Attack: 3,
+  osc1Decay: 4,
+  osc1Sustain: 5,
+  osc1Release: 6,
+  osc2Wave: 7,
+  osc2Tune: 8,
+  osc2Detune: 9,
+  osc2Level: 10,
+  osc2Attack: 11,
+  osc2Decay: 12,
+  osc2Sustain: 13,
+  osc2Release: 14,
+  fmAmount: 15,
+  loopLength: 16,
+  loopFeedback: 17,
+  recordLevel: 18,
+  saturation: 19,
+  wobbleRate: 20,
+  wobbleDepth: 21,
+  tapeHiss: 22,
+  tapeAge: 23,
+  tapeDegrade: 24,
+  tapeModel: 25,
+  tapeDrive: 26,
+  tapeBump: 27,
+  lfoRate: 28,
+  lfoDepth: 29,
+  lfoWaveform: 30,
+  lfoTarget: 31,
+  dryLevel: 32,
+  loopLevel: 33,
+  masterLevel: 34,
+  recAttack: 35,
+  recDecay: 36,
+  delayTime: 37,
+  delayFeedback: 38,
+  delayMix: 39,
+  reverbReplace: 40,
+  reverbBrightness: 41,
+  reverbDetune: 42,
+  reverbBigness: 43,
+  reverbSize: 44,
+  reverbMix: 45,
+  reverbDecay: 46,
+  reverbDamping: 47,
+  compThreshold: 48,
+  compRatio: 49,
+  compAttack: 50,
+  compRelease: 51,
+  compMakeup: 52,
+  compMix: 53,
+  seqEnabled: 54,
+  seqBPM: 55,
+  seq1Division: 56,
+  seq2Division: 57,
+  voiceLoopFM: 58,
+  panSpeed: 59,
+  panDepth: 60,
+  seq1Pitch: 61,
+  seq1Gate: 62,
+  seq2Pitch: 63,
+  seq2Gate: 64,
+};
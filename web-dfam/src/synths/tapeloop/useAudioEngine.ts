@@ -4,6 +4,14 @@
  */
 
 import { useEffect, useRef, useState, useCallback } from 'react';
+import { EventRingWriter, canUseEventRing, contextTimeToFrame } from '../../audio/eventRing';
+import { loadWasmModule } from '../../audio/wasmModule';
+import { PARAM_IDS } from './paramIds';
+
+/** Ring timestamp for an optional AudioContext time (0 = right away) */
+function ringTime(ctx: AudioContext | null, when?: number): number {
+  return when !== undefined && ctx ? contextTimeToFrame(ctx, when) : 0;
+}
 
 interface AudioEngineState {
   isReady: boolean;
@@ -23,6 +31,7 @@ export function useAudioEngine() {
   const audioContextRef = useRef<AudioContext | null>(null);
   const workletNodeRef = useRef<AudioWorkletNode | null>(null);
   const isInitializedRef = useRef(false);
+  const eventRingRef = useRef<EventRingWriter | null>(null);
 
   const initialize = useCallback(async () => {
     if (isInitializedRef.current) return;
@@ -40,13 +49,14 @@ export function useAudioEngine() {
       console.log('[TapeLoop] Loading AudioWorklet module...');
       await ctx.audioWorklet.addModule('/tapeloop-processor.js');
 
-      console.log('[TapeLoop] Fetching WASM binary...');
-      const wasmResponse = await fetch('/tapeloop.wasm');
-      if (!wasmResponse.ok) {
-        throw new Error(`Failed to fetch WASM: ${wasmResponse.status}`);
-      }
-      const wasmBytes = await wasmResponse.arrayBuffer();
-      console.log('[TapeLoop] WASM binary loaded:', wasmBytes.byteLength, 'bytes');
+      // Compile the SIMD128 or scalar build here, streaming (or take it
+      // from the cache); the worklet only instantiates it
+      const wasm = await loadWasmModule('tapeloop');
+      console.log('[TapeLoop] WASM module', wasm.cached ? 'from cache' : 'compiled', wasm.simd ? '(SIMD128)' : '(scalar)');
+
+      // Params and notes go through a SharedArrayBuffer ring when the page
+      // is cross-origin isolated; otherwise they fall back to port messages
+      const eventRing = canUseEventRing() ? new EventRingWriter(PARAM_IDS) : null;
 
       const workletNode = new AudioWorkletNode(ctx, 'tapeloop-processor', {
         numberOfInputs: 0,
@@ -58,7 +68,8 @@ export function useAudioEngine() {
       workletNode.port.onmessage = (event) => {
         const data = event.data;
         if (data.type === 'ready') {
-          console.log('[TapeLoop] AudioWorklet WASM ready!');
+          console.log('[TapeLoop] AudioWorklet WASM ready!', data.eventRing ? '(event ring)' : '(port messages)');
+          eventRingRef.current = data.eventRing ? eventRing : null;
           isInitializedRef.current = true;
           setState(s => ({ ...s, isReady: true }));
         } else if (data.type === 'error') {
@@ -76,9 +87,11 @@ export function useAudioEngine() {
       console.log('[TapeLoop] Sending WASM to worklet...');
       workletNode.port.postMessage({
         type: 'init',
-        wasmBytes: wasmBytes,
+        wasmModule: wasm.module,
+        simd: wasm.simd,
         sampleRate: ctx.sampleRate,
-      }, [wasmBytes]);
+        eventRing: eventRing?.buffer ?? null,
+      });
 
       console.log('[TapeLoop] Audio engine initialization started...');
     } catch (error) {
@@ -88,6 +101,8 @@ export function useAudioEngine() {
   }, []);
 
   const setParam = useCallback((name: string, value: number | boolean) => {
+    if (eventRingRef.current?.pushParam(name, value)) return;
+
     const workletNode = workletNodeRef.current;
     if (!workletNode) return;
 
@@ -98,16 +113,22 @@ export function useAudioEngine() {
     });
   }, []);
 
-  const noteOn = useCallback((note: number, velocity: number = 1.0) => {
+  // `when` is an AudioContext time in seconds; omit it to play right away.
+  // Timed notes need the event ring - the port fallback plays them on arrival.
+  const noteOn = useCallback((note: number, velocity: number = 1.0, when?: number) => {
     if (audioContextRef.current?.state === 'suspended') {
       audioContextRef.current.resume();
     }
+    if (eventRingRef.current?.pushNoteOn(note, velocity, ringTime(audioContextRef.current, when))) return;
+
     const workletNode = workletNodeRef.current;
     if (!workletNode) return;
     workletNode.port.postMessage({ type: 'noteOn', note, velocity });
   }, []);
 
-  const noteOff = useCallback((note: number) => {
+  const noteOff = useCallback((note: number, when?: number) => {
+    if (eventRingRef.current?.pushNoteOff(note, ringTime(audioContextRef.current, when))) return;
+
     const workletNode = workletNodeRef.current;
     if (!workletNode) return;
     workletNode.port.postMessage({ type: 'noteOff', note });